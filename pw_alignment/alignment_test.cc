@@ -0,0 +1,81 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_alignment/alignment.h"
+
+#include <atomic>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw {
+namespace {
+
+TEST(CacheLinePadded, StartsOnACacheLine) {
+  static_assert(alignof(CacheLinePadded<uint8_t>) == kCacheLineSize);
+  static_assert(sizeof(CacheLinePadded<uint8_t>) == kCacheLineSize);
+  static_assert(sizeof(CacheLinePadded<uint8_t[kCacheLineSize + 1]>) ==
+                2 * kCacheLineSize);
+
+  CacheLinePadded<std::atomic<uint32_t>> counters[3];
+  for (auto& counter : counters) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&counter.value) % kCacheLineSize,
+              0u);
+  }
+}
+
+TEST(CacheLinePadded, Unpadded) {
+  static_assert(sizeof(CacheLinePadded<uint32_t, false>) == sizeof(uint32_t));
+  static_assert(alignof(CacheLinePadded<uint32_t, false>) ==
+                alignof(uint32_t));
+}
+
+TEST(CacheLinePadded, ForwardsToValue) {
+  struct Point {
+    constexpr Point(int x_value, int y_value) : x(x_value), y(y_value) {}
+    int x;
+    int y;
+  };
+
+  CacheLinePadded<Point> point(1, 2);
+  EXPECT_EQ(point->x, 1);
+  EXPECT_EQ((*point).y, 2);
+
+  // Arrays of padded values initialize like arrays of values.
+  CacheLinePadded<std::atomic<uint32_t>> counters[2] = {7u};
+  counters[1]->fetch_add(3);
+  EXPECT_EQ(counters[0]->load(), 7u);
+  EXPECT_EQ(counters[1]->load(), 3u);
+
+  const CacheLinePadded<Point> copy = point;
+  EXPECT_EQ(copy->y, 2);
+}
+
+struct PW_CACHELINE_ALIGNED AlignedStruct {
+  uint8_t byte;
+};
+
+struct MaybePadded {
+  uint8_t first;
+  PW_CACHELINE_ALIGNED_IF_PADDED uint8_t second;
+};
+
+TEST(CacheLineAligned, Macros) {
+  static_assert(alignof(AlignedStruct) == kCacheLineSize);
+  static_assert(sizeof(MaybePadded) ==
+                (kCacheLinePadding ? 2 * kCacheLineSize : 2));
+}
+
+}  // namespace
+}  // namespace pw
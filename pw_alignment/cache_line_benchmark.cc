@@ -0,0 +1,75 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures the cost of false sharing: threads increment their own counters,
+// first packed next to each other, then each on its own cache line with
+// pw::CacheLinePadded. On a multi-core host, the packed counters are typically
+// several times slower.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "pw_alignment/alignment.h"
+#include "pw_log/log.h"
+
+namespace {
+
+constexpr size_t kThreads = 4;
+constexpr uint32_t kIncrements = 10'000'000;
+
+template <typename Counter>
+double NanosecondsPerIncrement(std::array<Counter, kThreads>& counters) {
+  const auto start = std::chrono::steady_clock::now();
+
+  std::array<std::thread, kThreads> threads;
+  for (size_t i = 0; i < kThreads; ++i) {
+    threads[i] = std::thread([&counter = counters[i]] {
+      std::atomic<uint32_t>& value = counter;
+      for (uint32_t j = 0; j < kIncrements; ++j) {
+        value.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / kIncrements;
+}
+
+// Converts to the counter, so both layouts share the benchmark loop.
+struct PaddedCounter : pw::CacheLinePadded<std::atomic<uint32_t>> {
+  operator std::atomic<uint32_t>&() { return value; }
+};
+
+}  // namespace
+
+int main() {
+  std::array<std::atomic<uint32_t>, kThreads> packed{};
+  std::array<PaddedCounter, kThreads> padded{};
+
+  PW_LOG_INFO("%u threads, %u relaxed increments each",
+              static_cast<unsigned>(kThreads),
+              static_cast<unsigned>(kIncrements));
+  PW_LOG_INFO("Packed counters: %.2f ns per increment",
+              NanosecondsPerIncrement(packed));
+  PW_LOG_INFO("Padded counters: %.2f ns per increment",
+              NanosecondsPerIncrement(padded));
+  return 0;
+}
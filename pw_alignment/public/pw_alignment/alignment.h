@@ -18,8 +18,24 @@
 // be removed and we could just inline the using statements.
 
 #include <atomic>
+#include <cstddef>
 #include <limits>
 #include <type_traits>
+#include <utility>
+
+#include "pw_alignment/config.h"
+
+// Aligns a type, variable or member to the start of a cache line.
+#define PW_CACHELINE_ALIGNED alignas(PW_ALIGNMENT_CACHE_LINE_SIZE)
+
+// Expands to PW_CACHELINE_ALIGNED if PW_ALIGNMENT_CACHE_LINE_PADDING is
+// enabled, and to nothing otherwise. Modules use it on members that are written
+// by a different thread than the members before them.
+#if PW_ALIGNMENT_CACHE_LINE_PADDING
+#define PW_CACHELINE_ALIGNED_IF_PADDED PW_CACHELINE_ALIGNED
+#else
+#define PW_CACHELINE_ALIGNED_IF_PADDED
+#endif  // PW_ALIGNMENT_CACHE_LINE_PADDING
 
 namespace pw {
 
@@ -82,4 +98,38 @@ struct [[gnu::aligned(bit_ceil(sizeof(T)))]] NaturallyAligned : public T {
 template <typename T>
 using AlignedAtomic = std::atomic<NaturallyAligned<T>>;
 
+inline constexpr size_t kCacheLineSize = PW_ALIGNMENT_CACHE_LINE_SIZE;
+
+inline constexpr bool kCacheLinePadding = PW_ALIGNMENT_CACHE_LINE_PADDING != 0;
+
+// Holds a value on cache lines of its own: the wrapper starts on a cache line
+// and its size is a multiple of the cache line size, so neighboring objects,
+// including other elements of an array, never share a line with the value.
+//
+// If kPadded is false, the wrapper has the same size and alignment as T, which
+// lets code pad conditionally, e.g. with pw::kCacheLinePadding.
+//
+// Example usage:
+//
+//   // Each core increments its own counter without invalidating the others.
+//   pw::CacheLinePadded<std::atomic<uint32_t>> per_core_counts[kCores];
+//
+//   per_core_counts[core]->fetch_add(1, std::memory_order_relaxed);
+//
+template <typename T, bool kPadded = true>
+struct alignas(kPadded ? kCacheLineSize : alignof(T)) CacheLinePadded {
+  // Constructs the value from the arguments.
+  template <typename... Args,
+            typename = std::enable_if_t<std::is_constructible_v<T, Args...>>>
+  constexpr CacheLinePadded(Args&&... args)
+      : value(std::forward<Args>(args)...) {}
+
+  constexpr T& operator*() { return value; }
+  constexpr const T& operator*() const { return value; }
+  constexpr T* operator->() { return &value; }
+  constexpr const T* operator->() const { return &value; }
+
+  T value;
+};
+
 }  // namespace pw
@@ -0,0 +1,35 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// The size of a cache line, in bytes. Objects written by different threads or
+// cores should be at least this far apart to avoid false sharing. Defaults to
+// 64, which is right for most x86-64 and Arm application processors. Some
+// targets, such as Apple arm64 CPUs, prefetch pairs of lines and benefit from
+// 128.
+#ifndef PW_ALIGNMENT_CACHE_LINE_SIZE
+#define PW_ALIGNMENT_CACHE_LINE_SIZE 64
+#endif  // PW_ALIGNMENT_CACHE_LINE_SIZE
+
+// Whether Pigweed modules keep data that different threads or cores write
+// concurrently, such as locks and the data they guard, on separate cache
+// lines. This increases the size of the affected objects, so it defaults to
+// off. Enable it on multi-core targets with data caches, such as host builds.
+#ifndef PW_ALIGNMENT_CACHE_LINE_PADDING
+#define PW_ALIGNMENT_CACHE_LINE_PADDING 0
+#endif  // PW_ALIGNMENT_CACHE_LINE_PADDING
+
+static_assert((PW_ALIGNMENT_CACHE_LINE_SIZE &
+               (PW_ALIGNMENT_CACHE_LINE_SIZE - 1)) == 0,
+              "PW_ALIGNMENT_CACHE_LINE_SIZE must be a power of two");
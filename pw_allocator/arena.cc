@@ -0,0 +1,60 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/arena.h"
+
+#include <cstdint>
+
+#include "pw_assert/check.h"
+
+namespace pw::allocator {
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+  PW_DCHECK(alignment != 0 && (alignment & (alignment - 1)) == 0,
+            "Alignment must be a power of two");
+
+  uintptr_t base = reinterpret_cast<uintptr_t>(buffer_.data());
+  uintptr_t current = base + offset_;
+  uintptr_t aligned = (current + alignment - 1) & ~(uintptr_t(alignment) - 1);
+  size_t padding = aligned - current;
+
+  if (padding > remaining() || size > remaining() - padding) {
+    return nullptr;
+  }
+
+  offset_ += padding + size;
+  return buffer_.data() + (aligned - base);
+}
+
+bool Arena::Resize(void* ptr, size_t old_size, size_t new_size) {
+  std::byte* start = static_cast<std::byte*>(ptr);
+  if (start + old_size != buffer_.data() + offset_) {
+    return new_size <= old_size;
+  }
+
+  const size_t start_offset = offset_ - old_size;
+  if (new_size > buffer_.size() - start_offset) {
+    return false;
+  }
+
+  offset_ = start_offset + new_size;
+  return true;
+}
+
+void Arena::Rewind(Marker marker) {
+  PW_DCHECK_UINT_LE(marker.offset_, offset_, "Marker is from a later scope");
+  offset_ = marker.offset_;
+}
+
+}  // namespace pw::allocator
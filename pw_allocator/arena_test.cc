@@ -0,0 +1,135 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/arena.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+namespace {
+
+TEST(Arena, AllocationsAreContiguous) {
+  alignas(8) std::byte buffer[64];
+  Arena arena(buffer);
+
+  void* first = arena.Allocate(8, 8);
+  void* second = arena.Allocate(8, 8);
+  EXPECT_EQ(first, &buffer[0]);
+  EXPECT_EQ(second, &buffer[8]);
+  EXPECT_EQ(arena.used(), 16u);
+}
+
+TEST(Arena, AllocationsAreAligned) {
+  alignas(16) std::byte buffer[64];
+  Arena arena(buffer);
+
+  ASSERT_NE(arena.Allocate(1, 1), nullptr);
+  void* aligned = arena.Allocate(4, 16);
+  EXPECT_EQ(aligned, &buffer[16]);
+  EXPECT_EQ(arena.used(), 20u);
+}
+
+TEST(Arena, ReturnsNullWhenFull) {
+  alignas(8) std::byte buffer[32];
+  Arena arena(buffer);
+
+  EXPECT_NE(arena.Allocate(30, 1), nullptr);
+  EXPECT_EQ(arena.Allocate(4, 1), nullptr);
+  EXPECT_EQ(arena.Allocate(1, 4), nullptr);
+  EXPECT_NE(arena.Allocate(2, 1), nullptr);
+  EXPECT_EQ(arena.remaining(), 0u);
+  EXPECT_TRUE(arena.AllocateBuffer(1).empty());
+}
+
+TEST(Arena, RewindReleasesLaterAllocations) {
+  alignas(8) std::byte buffer[64];
+  Arena arena(buffer);
+
+  ASSERT_NE(arena.Allocate(8, 8), nullptr);
+  Arena::Marker marker = arena.GetMarker();
+  void* temporary = arena.Allocate(16, 8);
+  ASSERT_NE(temporary, nullptr);
+
+  arena.Rewind(marker);
+  EXPECT_EQ(arena.used(), 8u);
+  EXPECT_EQ(arena.Allocate(16, 8), temporary);
+}
+
+TEST(Arena, ScopeRewindsOnExit) {
+  alignas(8) std::byte buffer[64];
+  Arena arena(buffer);
+
+  {
+    Arena::Scope scope(arena);
+    ByteSpan scratch = arena.AllocateBuffer(40);
+    EXPECT_EQ(scratch.size(), 40u);
+    {
+      Arena::Scope inner(arena);
+      EXPECT_FALSE(arena.AllocateBuffer(20).empty());
+    }
+    EXPECT_EQ(arena.used(), 40u);
+  }
+  EXPECT_EQ(arena.used(), 0u);
+}
+
+TEST(Arena, ResizeLastAllocation) {
+  alignas(8) std::byte buffer[64];
+  Arena arena(buffer);
+
+  void* ptr = arena.Allocate(16, 8);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(arena.Resize(ptr, 16, 40));
+  EXPECT_EQ(arena.used(), 40u);
+  EXPECT_TRUE(arena.Resize(ptr, 40, 8));
+  EXPECT_EQ(arena.used(), 8u);
+  EXPECT_FALSE(arena.Resize(ptr, 8, 65));
+  EXPECT_EQ(arena.used(), 8u);
+}
+
+TEST(Arena, ResizeEarlierAllocation) {
+  alignas(8) std::byte buffer[64];
+  Arena arena(buffer);
+
+  void* first = arena.Allocate(16, 8);
+  ASSERT_NE(arena.Allocate(8, 8), nullptr);
+  EXPECT_FALSE(arena.Resize(first, 16, 24));
+  EXPECT_TRUE(arena.Resize(first, 16, 8));
+  EXPECT_EQ(arena.used(), 24u);
+}
+
+TEST(Arena, NewConstructsObjects) {
+  struct Point {
+    int x;
+    int y;
+  };
+  alignas(8) std::byte buffer[64];
+  Arena arena(buffer);
+
+  Point* point = arena.New<Point>(Point{1, 2});
+  ASSERT_NE(point, nullptr);
+  EXPECT_EQ(point->x, 1);
+  EXPECT_EQ(point->y, 2);
+
+  span<uint32_t> values = arena.NewArray<uint32_t>(4);
+  ASSERT_EQ(values.size(), 4u);
+  for (uint32_t value : values) {
+    EXPECT_EQ(value, 0u);
+  }
+  EXPECT_TRUE(arena.NewArray<uint32_t>(100).empty());
+}
+
+}  // namespace
+}  // namespace pw::allocator
@@ -0,0 +1,140 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/block_pool.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::allocator {
+namespace {
+
+TEST(BlockPool, AllocatesEveryBlockOnce) {
+  alignas(std::max_align_t) std::byte buffer[256];
+  BlockPool pool(buffer, 32);
+
+  ASSERT_EQ(pool.capacity(), 256u / 32u);
+
+  void* blocks[8];
+  for (void*& block : blocks) {
+    block = pool.Allocate();
+    ASSERT_NE(block, nullptr);
+    EXPECT_TRUE(pool.Contains(block));
+  }
+  EXPECT_EQ(pool.available(), 0u);
+  EXPECT_EQ(pool.Allocate(), nullptr);
+
+  for (size_t i = 0; i < 8; ++i) {
+    for (size_t j = i + 1; j < 8; ++j) {
+      EXPECT_NE(blocks[i], blocks[j]);
+    }
+  }
+}
+
+TEST(BlockPool, FreedBlockIsReusedFirst) {
+  alignas(std::max_align_t) std::byte buffer[256];
+  BlockPool pool(buffer, 32);
+
+  void* first = pool.Allocate();
+  void* second = pool.Allocate();
+  pool.Free(first);
+  EXPECT_EQ(pool.Allocate(), first);
+  pool.Free(second);
+  EXPECT_EQ(pool.available(), pool.capacity() - 1);
+}
+
+TEST(BlockPool, RoundsBlocksUpToAlignment) {
+  alignas(8) std::byte buffer[64];
+  BlockPool pool(ByteSpan(buffer).subspan(1), 5, 8);
+
+  EXPECT_EQ(pool.block_size(), 8u);
+  void* block = pool.Allocate();
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % 8, 0u);
+}
+
+TEST(BlockPool, TracksMetrics) {
+  alignas(std::max_align_t) std::byte buffer[64];
+  BlockPool pool(buffer, 32);
+
+  void* a = pool.Allocate();
+  void* b = pool.Allocate();
+  EXPECT_EQ(pool.Allocate(), nullptr);
+  pool.Free(a);
+  pool.Free(b);
+
+  uint32_t values[4] = {};
+  size_t i = 0;
+  for (const metric::Metric& metric : pool.metrics().metrics()) {
+    values[i++] = metric.as_int();
+  }
+  ASSERT_EQ(i, 4u);
+  // Metrics are listed most recently added first.
+  EXPECT_EQ(values[0], 1u);  // failures
+  EXPECT_EQ(values[1], 2u);  // allocations
+  EXPECT_EQ(values[2], 2u);  // peak_in_use
+  EXPECT_EQ(values[3], 0u);  // in_use
+}
+
+TEST(LockFreeBlockPool, AllocateAndFree) {
+  alignas(std::max_align_t) std::byte buffer[128];
+  LockFreeBlockPool pool(buffer, 16);
+
+  void* a = pool.Allocate();
+  void* b = pool.Allocate();
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_NE(a, b);
+  pool.Free(a);
+  EXPECT_EQ(pool.Allocate(), a);
+  pool.Free(a);
+  pool.Free(b);
+  EXPECT_EQ(pool.available(), pool.capacity());
+}
+
+struct Object {
+  Object(int a, int b) : sum(a + b) {}
+  ~Object() { destroyed += 1; }
+
+  int sum;
+  static int destroyed;
+};
+
+int Object::destroyed = 0;
+
+TEST(FixedBlockPool, ConstructsAndDestroysObjects) {
+  FixedBlockPool<Object, 2> pool;
+
+  Object* first = pool.New(1, 2);
+  Object* second = pool.New(3, 4);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(first->sum, 3);
+  EXPECT_EQ(second->sum, 7);
+  EXPECT_EQ(pool.New(5, 6), nullptr);
+
+  pool.Delete(first);
+  pool.Delete(second);
+  EXPECT_EQ(Object::destroyed, 2);
+  EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST(FixedBytePool, ProvidesRequestedBlocks) {
+  FixedBytePool<24, 4> pool;
+  EXPECT_EQ(pool.capacity(), 4u);
+  EXPECT_GE(pool.block_size(), 24u);
+}
+
+}  // namespace
+}  // namespace pw::allocator
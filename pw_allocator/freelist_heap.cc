@@ -14,6 +14,7 @@
 
 #include "pw_allocator/freelist_heap.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "pw_assert/check.h"
@@ -21,7 +22,9 @@
 
 namespace pw::allocator {
 
-FreeListHeap::FreeListHeap(span<std::byte> region, FreeList& freelist)
+template <typename FreeListType>
+BasicFreeListHeap<FreeListType>::BasicFreeListHeap(span<std::byte> region,
+                                                   FreeListType& freelist)
     : freelist_(freelist), heap_stats_() {
   Block* block;
   PW_CHECK_OK(
@@ -35,7 +38,8 @@ FreeListHeap::FreeListHeap(span<std::byte> region, FreeList& freelist)
   heap_stats_.total_bytes = region.size();
 }
 
-void* FreeListHeap::Allocate(size_t size) {
+template <typename FreeListType>
+void* BasicFreeListHeap<FreeListType>::Allocate(size_t size) {
   // Find a chunk in the freelist. Split it if needed, then return
 
   auto chunk = freelist_.FindChunk(size);
@@ -67,7 +71,8 @@ void* FreeListHeap::Allocate(size_t size) {
   return chunk_block->UsableSpace();
 }
 
-void FreeListHeap::Free(void* ptr) {
+template <typename FreeListType>
+void BasicFreeListHeap<FreeListType>::Free(void* ptr) {
   std::byte* bytes = static_cast<std::byte*>(ptr);
 
   if (bytes < region_.data() || bytes >= region_.data() + region_.size()) {
@@ -121,7 +126,8 @@ void FreeListHeap::Free(void* ptr) {
 
 // Follows constract of the C standard realloc() function
 // If ptr is free'd, will return nullptr.
-void* FreeListHeap::Realloc(void* ptr, size_t size) {
+template <typename FreeListType>
+void* BasicFreeListHeap<FreeListType>::Realloc(void* ptr, size_t size) {
   if (size == 0) {
     Free(ptr);
     return nullptr;
@@ -145,12 +151,45 @@ void* FreeListHeap::Realloc(void* ptr, size_t size) {
   }
   size_t old_size = chunk_block->InnerSize();
 
-  // Do nothing and return ptr if the required memory size is smaller than
-  // the current size.
-  // TODO(keir): Currently do not support shrink of memory chunk.
-  if (old_size >= size) {
+  // Resize the block in place if possible: grow it by merging with the next
+  // block if that is free and large enough, and shrink it by splitting off
+  // its end. Blocks can only be split and merged while they are free.
+  chunk_block->MarkFree();
+  if (old_size < size && !chunk_block->Last()) {
+    Block* next = chunk_block->Next();
+    if (!next->Used() && old_size + next->OuterSize() >= size) {
+      freelist_.RemoveChunk(BlockToSpan(next))
+          .IgnoreError();  // TODO(b/242598609): Handle Status properly
+      chunk_block->MergeNext()
+          .IgnoreError();  // TODO(b/242598609): Handle Status properly
+    }
+  }
+
+  if (chunk_block->InnerSize() >= size) {
+    // If the remainder is too small to hold a block, the block keeps it.
+    Block* leftover;
+    if (chunk_block->Split(size, &leftover).ok()) {
+      if (!leftover->Last() && !leftover->Next()->Used()) {
+        freelist_.RemoveChunk(BlockToSpan(leftover->Next()))
+            .IgnoreError();  // TODO(b/242598609): Handle Status properly
+        leftover->MergeNext()
+            .IgnoreError();  // TODO(b/242598609): Handle Status properly
+      }
+      freelist_.AddChunk(BlockToSpan(leftover))
+          .IgnoreError();  // TODO(b/242598609): Handle Status properly
+    }
+    chunk_block->MarkUsed();
+
+    const size_t new_size = chunk_block->InnerSize();
+    heap_stats_.bytes_allocated += new_size;
+    heap_stats_.bytes_allocated -= old_size;
+    heap_stats_.cumulative_allocated += new_size;
+    heap_stats_.cumulative_freed += old_size;
+    heap_stats_.total_allocate_calls += 1;
+    heap_stats_.total_free_calls += 1;
     return ptr;
   }
+  chunk_block->MarkUsed();
 
   void* new_ptr = Allocate(size);
   // Don't invalidate ptr if Allocate(size) fails to initilize the memory.
@@ -163,7 +202,8 @@ void* FreeListHeap::Realloc(void* ptr, size_t size) {
   return new_ptr;
 }
 
-void* FreeListHeap::Calloc(size_t num, size_t size) {
+template <typename FreeListType>
+void* BasicFreeListHeap<FreeListType>::Calloc(size_t num, size_t size) {
   void* ptr = Allocate(num * size);
   if (ptr != nullptr) {
     memset(ptr, 0, num * size);
@@ -171,7 +211,8 @@ void* FreeListHeap::Calloc(size_t num, size_t size) {
   return ptr;
 }
 
-void FreeListHeap::LogHeapStats() {
+template <typename FreeListType>
+void BasicFreeListHeap<FreeListType>::LogHeapStats() {
   PW_LOG_INFO(" ");
   PW_LOG_INFO("    The current heap information: ");
   PW_LOG_INFO("          The total heap size is %u bytes.",
@@ -192,10 +233,47 @@ void FreeListHeap::LogHeapStats() {
   PW_LOG_INFO(" ");
 }
 
+template <typename FreeListType>
+size_t BasicFreeListHeap<FreeListType>::LargestFreeBlockSize() const {
+  size_t largest = 0;
+  // Block::Init places the first block at the start of the region.
+  auto* block = reinterpret_cast<Block*>(region_.data());
+  while (true) {
+    if (!block->Used()) {
+      largest = std::max(largest, block->InnerSize());
+    }
+    if (block->Last()) {
+      break;
+    }
+    block = block->Next();
+  }
+  return largest;
+}
+
+template <typename FreeListType>
+size_t BasicFreeListHeap<FreeListType>::FreeBytes() const {
+  size_t free_bytes = 0;
+  auto* block = reinterpret_cast<Block*>(region_.data());
+  while (true) {
+    if (!block->Used()) {
+      free_bytes += block->InnerSize();
+    }
+    if (block->Last()) {
+      break;
+    }
+    block = block->Next();
+  }
+  return free_bytes;
+}
+
 // TODO(keir): Add stack tracing to locate which call to the heap operation
 // caused the corruption.
-void FreeListHeap::InvalidFreeCrash() {
+template <typename FreeListType>
+void BasicFreeListHeap<FreeListType>::InvalidFreeCrash() {
   PW_DCHECK(false, "You tried to free an invalid pointer!");
 }
 
+template class BasicFreeListHeap<FreeList>;
+template class BasicFreeListHeap<TlsfFreeList>;
+
 }  // namespace pw::allocator
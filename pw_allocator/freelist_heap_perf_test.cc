@@ -0,0 +1,63 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+
+#include "pw_allocator/freelist_heap.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t kHeapSize = 8192;
+constexpr size_t kLiveAllocations = 16;
+
+// Allocates and frees a block of the given size while a number of other
+// blocks are live, so the freelist holds several chunks to search.
+template <typename Heap>
+void AllocateFreeTest(perf_test::State& state, size_t size) {
+  alignas(std::max_align_t) std::array<std::byte, kHeapSize> buffer;
+  Heap heap(buffer);
+
+  std::array<void*, kLiveAllocations> live;
+  for (size_t i = 0; i < live.size(); ++i) {
+    live[i] = heap.Allocate(16 + 24 * i);
+  }
+  for (size_t i = 0; i < live.size(); i += 2) {
+    heap.Free(live[i]);
+  }
+
+  while (state.KeepRunning()) {
+    heap.Free(heap.Allocate(size));
+  }
+
+  for (size_t i = 1; i < live.size(); i += 2) {
+    heap.Free(live[i]);
+  }
+}
+
+void FreeListHeapAllocateFree(perf_test::State& state, size_t size) {
+  AllocateFreeTest<FreeListHeapBuffer<>>(state, size);
+}
+
+void TlsfFreeListHeapAllocateFree(perf_test::State& state, size_t size) {
+  AllocateFreeTest<TlsfFreeListHeapBuffer<>>(state, size);
+}
+
+PW_PERF_TEST_RANGE(FreeListHeap, FreeListHeapAllocateFree, 16, 1024, 4);
+PW_PERF_TEST_RANGE(TlsfFreeListHeap, TlsfFreeListHeapAllocateFree, 16, 1024, 4);
+
+}  // namespace
+}  // namespace pw::allocator
@@ -14,6 +14,8 @@
 
 #include "pw_allocator/freelist_heap.h"
 
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "pw_span/span.h"
 
@@ -206,10 +208,71 @@ TEST(FreeListHeap, ReallocSmallerSize) {
   void* ptr1 = allocator.Allocate(kAllocSize);
   void* ptr2 = allocator.Realloc(ptr1, kNewAllocSize);
 
-  // For smaller sizes, Realloc will not shrink the block.
+  // For smaller sizes, Realloc shrinks the block in place.
   EXPECT_EQ(ptr1, ptr2);
 }
 
+TEST(FreeListHeap, ReallocSmallerSizeFreesRemainder) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 512;
+  constexpr size_t kNewAllocSize = 64;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+
+  std::byte* ptr1 = static_cast<std::byte*>(allocator.Allocate(kAllocSize));
+  void* ptr2 = allocator.Allocate(kAllocSize);
+  ASSERT_NE(ptr2, nullptr);
+  ASSERT_EQ(allocator.Realloc(ptr1, kNewAllocSize), ptr1);
+
+  // The space given up by the first block is reused before ptr2.
+  std::byte* ptr3 =
+      static_cast<std::byte*>(allocator.Allocate(kAllocSize - 2 * 64));
+  ASSERT_NE(ptr3, nullptr);
+  EXPECT_GT(ptr3, ptr1);
+  EXPECT_LT(ptr3, ptr2);
+}
+
+TEST(FreeListHeap, ReallocGrowsIntoFreeNextBlock) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 256;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+
+  void* ptr1 = allocator.Allocate(kAllocSize);
+  void* ptr2 = allocator.Allocate(kAllocSize);
+  void* ptr3 = allocator.Allocate(kAllocSize);
+  ASSERT_NE(ptr3, nullptr);
+  std::memset(ptr1, 0x5a, kAllocSize);
+
+  // The block after ptr1 is free, so ptr1 grows without moving.
+  allocator.Free(ptr2);
+  ASSERT_EQ(allocator.Realloc(ptr1, 2 * kAllocSize), ptr1);
+  for (size_t i = 0; i < kAllocSize; ++i) {
+    EXPECT_EQ(static_cast<std::byte*>(ptr1)[i], std::byte{0x5a});
+  }
+
+  // The block after ptr1 is now in use, so growing it further moves it.
+  void* ptr4 = allocator.Realloc(ptr1, 4 * kAllocSize);
+  ASSERT_NE(ptr4, nullptr);
+  EXPECT_NE(ptr4, ptr1);
+  EXPECT_EQ(static_cast<std::byte*>(ptr4)[0], std::byte{0x5a});
+}
+
+TEST(FreeListHeap, ReallocInPlaceKeepsStats) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  FreeListHeapBuffer allocator(buf);
+
+  void* ptr = allocator.Allocate(512);
+  ASSERT_EQ(allocator.Realloc(ptr, 1024), ptr);
+  ASSERT_EQ(allocator.Realloc(ptr, 128), ptr);
+  allocator.Free(ptr);
+  EXPECT_EQ(allocator.heap_stats().bytes_allocated, 0u);
+}
+
 TEST(FreeListHeap, ReallocTooLarge) {
   constexpr size_t N = 2048;
   constexpr size_t kAllocSize = 512;
@@ -273,4 +336,54 @@ TEST(FreeListHeap, CallocTooLarge) {
 
   EXPECT_EQ(allocator.Calloc(1, kAllocSize), nullptr);
 }
+
+TEST(TlsfFreeListHeap, CanFreeAndRealloc) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 512;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfFreeListHeapBuffer allocator(buf);
+
+  void* ptr1 = allocator.Allocate(kAllocSize);
+  ASSERT_NE(ptr1, nullptr);
+  allocator.Free(ptr1);
+  void* ptr2 = allocator.Allocate(kAllocSize);
+
+  EXPECT_EQ(ptr1, ptr2);
+}
+
+TEST(TlsfFreeListHeap, ReturnsNullWhenFull) {
+  constexpr size_t N = 2048;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfFreeListHeapBuffer allocator(buf);
+
+  EXPECT_NE(
+      allocator.Allocate(N - sizeof(Block) - 2 * PW_ALLOCATOR_POISON_OFFSET),
+      nullptr);
+  EXPECT_EQ(allocator.Allocate(1), nullptr);
+}
+
+TEST(TlsfFreeListHeap, MergesFreedNeighbours) {
+  constexpr size_t N = 2048;
+  constexpr size_t kAllocSize = 256;
+  alignas(Block) std::byte buf[N] = {std::byte(0)};
+
+  TlsfFreeListHeapBuffer allocator(buf);
+
+  void* ptrs[4];
+  for (void*& ptr : ptrs) {
+    ptr = allocator.Allocate(kAllocSize);
+    ASSERT_NE(ptr, nullptr);
+  }
+  allocator.Free(ptrs[1]);
+  allocator.Free(ptrs[3]);
+  allocator.Free(ptrs[2]);
+
+  // The three freed blocks and the remainder coalesce back into one chunk.
+  void* big = allocator.Allocate(3 * kAllocSize);
+  EXPECT_EQ(big, ptrs[1]);
+  EXPECT_EQ(allocator.heap_stats().total_free_calls, 3u);
+}
+
 }  // namespace pw::allocator
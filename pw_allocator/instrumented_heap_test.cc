@@ -0,0 +1,152 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/instrumented_heap.h"
+
+#include "gtest/gtest.h"
+#include "pw_allocator/freelist_heap.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::allocator {
+namespace {
+
+#define METRIC_TOKEN(name) \
+  PW_TOKENIZE_STRING_MASK_EXPR("metrics", _PW_METRIC_TOKEN_MASK, name)
+
+uint32_t GetMetric(const metric::Group& group, metric::Token token) {
+  for (const metric::Metric& metric : group.metrics()) {
+    if (metric.name() == token) {
+      return metric.as_int();
+    }
+  }
+  ADD_FAILURE();
+  return 0;
+}
+
+metric::Group& Histogram(metric::Group& group) {
+  return group.children().front();
+}
+
+class InstrumentedHeapTest : public ::testing::Test {
+ protected:
+  InstrumentedHeapTest()
+      : heap_(buffer_), instrumented_(heap_, PW_TOKENIZE_STRING_EXPR("test")) {}
+
+  alignas(Block) std::byte buffer_[2048] = {};
+  FreeListHeapBuffer<> heap_;
+  InstrumentedHeap<FreeListHeapBuffer<>> instrumented_;
+};
+
+TEST_F(InstrumentedHeapTest, TracksBytesAndHighWaterMark) {
+  const metric::Group& group = instrumented_.metrics();
+
+  void* a = instrumented_.Allocate(100);
+  void* b = instrumented_.Allocate(200);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  uint32_t peak = GetMetric(group, METRIC_TOKEN("bytes_allocated"));
+  EXPECT_GE(peak, 300u);
+
+  instrumented_.Free(a);
+  EXPECT_LT(GetMetric(group, METRIC_TOKEN("bytes_allocated")), peak);
+  EXPECT_EQ(GetMetric(group, METRIC_TOKEN("peak_bytes_allocated")), peak);
+
+  instrumented_.Free(b);
+  EXPECT_EQ(GetMetric(group, METRIC_TOKEN("bytes_allocated")), 0u);
+  EXPECT_EQ(GetMetric(group, METRIC_TOKEN("allocations")), 2u);
+  EXPECT_EQ(GetMetric(group, METRIC_TOKEN("frees")), 2u);
+}
+
+TEST_F(InstrumentedHeapTest, CountsFailures) {
+  EXPECT_EQ(instrumented_.Allocate(4096), nullptr);
+  EXPECT_EQ(
+      GetMetric(instrumented_.metrics(), METRIC_TOKEN("failed_allocations")),
+      1u);
+}
+
+TEST_F(InstrumentedHeapTest, RecordsSizeHistogram) {
+  instrumented_.Free(instrumented_.Allocate(8));
+  instrumented_.Free(instrumented_.Allocate(16));
+  instrumented_.Free(instrumented_.Allocate(100));
+  instrumented_.Free(instrumented_.Calloc(2, 1000));
+
+  metric::Group& histogram = Histogram(instrumented_.metrics());
+  EXPECT_EQ(GetMetric(histogram, METRIC_TOKEN("le_16")), 2u);
+  EXPECT_EQ(GetMetric(histogram, METRIC_TOKEN("le_128")), 1u);
+  EXPECT_EQ(GetMetric(histogram, METRIC_TOKEN("gt_1024")), 1u);
+  EXPECT_EQ(GetMetric(histogram, METRIC_TOKEN("le_32")), 0u);
+}
+
+TEST_F(InstrumentedHeapTest, ReportsFragmentation) {
+  void* ptrs[4];
+  for (void*& ptr : ptrs) {
+    ptr = instrumented_.Allocate(256);
+    ASSERT_NE(ptr, nullptr);
+  }
+  instrumented_.UpdateFragmentationMetrics();
+  uint32_t largest_before = GetMetric(instrumented_.metrics(),
+                                      METRIC_TOKEN("largest_free_block"));
+  EXPECT_EQ(largest_before, heap_.LargestFreeBlockSize());
+
+  // Freeing alternate blocks leaves holes that cannot be merged.
+  instrumented_.Free(ptrs[0]);
+  instrumented_.Free(ptrs[2]);
+  instrumented_.UpdateFragmentationMetrics();
+  EXPECT_GT(GetMetric(instrumented_.metrics(),
+                      METRIC_TOKEN("fragmentation_percent")),
+            0u);
+}
+
+TEST_F(InstrumentedHeapTest, SingleFreeBlockIsNotFragmented) {
+  instrumented_.UpdateFragmentationMetrics();
+  EXPECT_EQ(GetMetric(instrumented_.metrics(),
+                      METRIC_TOKEN("fragmentation_percent")),
+            0u);
+
+  // The headers of the allocated blocks are not free memory, so the one free
+  // block after them is all of it.
+  void* a = instrumented_.Allocate(256);
+  void* b = instrumented_.Allocate(256);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  instrumented_.UpdateFragmentationMetrics();
+  EXPECT_EQ(GetMetric(instrumented_.metrics(),
+                      METRIC_TOKEN("fragmentation_percent")),
+            0u);
+
+  // Freeing everything merges the heap back into one block.
+  instrumented_.Free(a);
+  instrumented_.Free(b);
+  instrumented_.UpdateFragmentationMetrics();
+  EXPECT_EQ(GetMetric(instrumented_.metrics(),
+                      METRIC_TOKEN("fragmentation_percent")),
+            0u);
+  EXPECT_EQ(GetMetric(instrumented_.metrics(),
+                      METRIC_TOKEN("largest_free_block")),
+            heap_.FreeBytes());
+}
+
+TEST_F(InstrumentedHeapTest, ReallocKeepsAccounting) {
+  void* ptr = instrumented_.Allocate(32);
+  ptr = instrumented_.Realloc(ptr, 512);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_GE(GetMetric(instrumented_.metrics(), METRIC_TOKEN("bytes_allocated")),
+            512u);
+  instrumented_.Free(ptr);
+  EXPECT_EQ(GetMetric(instrumented_.metrics(), METRIC_TOKEN("bytes_allocated")),
+            0u);
+}
+
+}  // namespace
+}  // namespace pw::allocator
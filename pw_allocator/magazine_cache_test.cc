@@ -0,0 +1,101 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/magazine_cache.h"
+
+#include "gtest/gtest.h"
+#include "pw_allocator/freelist_heap.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t kHeapSize = 4096;
+
+class MagazineCacheTest : public ::testing::Test {
+ protected:
+  MagazineCacheTest() : heap_(buffer_) {}
+
+  alignas(Block) std::byte buffer_[kHeapSize] = {};
+  FreeListHeapBuffer<> heap_;
+};
+
+TEST_F(MagazineCacheTest, FreedSmallBlockIsReused) {
+  MagazineCache<FreeListHeapBuffer<>> cache(heap_);
+
+  void* ptr1 = cache.Allocate(24);
+  ASSERT_NE(ptr1, nullptr);
+  cache.Free(ptr1);
+
+  EXPECT_EQ(cache.cached_blocks(), 1u);
+  EXPECT_EQ(heap_.heap_stats().total_free_calls, 0u);
+
+  void* ptr2 = cache.Allocate(30);
+  EXPECT_EQ(ptr1, ptr2);
+  EXPECT_EQ(cache.cached_blocks(), 0u);
+  EXPECT_EQ(heap_.heap_stats().total_allocate_calls, 1u);
+}
+
+TEST_F(MagazineCacheTest, LargeAllocationsBypassCache) {
+  MagazineCache<FreeListHeapBuffer<>> cache(heap_);
+
+  void* ptr = cache.Allocate(1024);
+  ASSERT_NE(ptr, nullptr);
+  cache.Free(ptr);
+
+  EXPECT_EQ(cache.cached_blocks(), 0u);
+  EXPECT_EQ(heap_.heap_stats().total_free_calls, 1u);
+}
+
+TEST_F(MagazineCacheTest, FullMagazineFreesToHeap) {
+  constexpr size_t kCapacity = 2;
+  MagazineCache<FreeListHeapBuffer<>, 4, kCapacity> cache(heap_);
+
+  void* ptrs[kCapacity + 1];
+  for (void*& ptr : ptrs) {
+    ptr = cache.Allocate(16);
+    ASSERT_NE(ptr, nullptr);
+  }
+  for (void* ptr : ptrs) {
+    cache.Free(ptr);
+  }
+
+  EXPECT_EQ(cache.cached_blocks(), kCapacity);
+  EXPECT_EQ(heap_.heap_stats().total_free_calls, 1u);
+}
+
+TEST_F(MagazineCacheTest, FlushReturnsBlocksToHeap) {
+  {
+    MagazineCache<FreeListHeapBuffer<>> cache(heap_);
+    cache.Free(cache.Allocate(16));
+    cache.Free(cache.Allocate(100));
+    EXPECT_EQ(cache.cached_blocks(), 2u);
+    cache.Flush();
+    EXPECT_EQ(cache.cached_blocks(), 0u);
+    cache.Free(cache.Allocate(64));
+  }
+  EXPECT_EQ(heap_.heap_stats().bytes_allocated, 0u);
+  EXPECT_EQ(heap_.heap_stats().total_free_calls, 3u);
+}
+
+TEST_F(MagazineCacheTest, WorksWithTlsfHeap) {
+  TlsfFreeListHeapBuffer<> heap(buffer_);
+  MagazineCache<TlsfFreeListHeapBuffer<>> cache(heap);
+
+  void* ptr1 = cache.Allocate(40);
+  cache.Free(ptr1);
+  EXPECT_EQ(cache.Allocate(64), ptr1);
+}
+
+}  // namespace
+}  // namespace pw::allocator
@@ -0,0 +1,131 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pw_bytes/span.h"
+
+namespace pw::allocator {
+
+/// Monotonic ("bump") allocator over a caller-provided buffer.
+///
+/// Each allocation advances a single offset into the buffer, so allocating is
+/// a pointer increment. Allocations cannot be freed individually; instead,
+/// capture a `Marker` and later `Rewind` to it to release everything allocated
+/// since, or use an `Arena::Scope` to do so automatically.
+///
+/// Objects created with `New` are not destroyed when the arena is rewound, so
+/// only trivially destructible types may be created that way.
+///
+/// `AllocateBuffer` returns a `ByteSpan`, so an arena can directly supply the
+/// scratch buffers taken by APIs such as `pw::protobuf::StreamEncoder`.
+class Arena {
+ public:
+  /// Position in the arena to rewind to.
+  class Marker {
+   private:
+    friend class Arena;
+    constexpr explicit Marker(size_t offset) : offset_(offset) {}
+    size_t offset_;
+  };
+
+  /// RAII helper that rewinds the arena to where it was when the scope was
+  /// created.
+  class Scope {
+   public:
+    explicit Scope(Arena& arena) : arena_(arena), marker_(arena.GetMarker()) {}
+    ~Scope() { arena_.Rewind(marker_); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    Arena& arena_;
+    Marker marker_;
+  };
+
+  constexpr explicit Arena(ByteSpan buffer) : buffer_(buffer), offset_(0) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /// Returns `size` bytes aligned to `alignment`, or nullptr if the arena does
+  /// not have enough space left. `alignment` must be a power of two.
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /// Returns a buffer of `size` bytes, or an empty span if the arena does not
+  /// have enough space left.
+  ByteSpan AllocateBuffer(size_t size, size_t alignment = 1) {
+    void* ptr = Allocate(size, alignment);
+    if (ptr == nullptr) {
+      return ByteSpan();
+    }
+    return ByteSpan(static_cast<std::byte*>(ptr), size);
+  }
+
+  /// Constructs a `T` in the arena, returning nullptr if there is no space.
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Arena never runs destructors");
+    void* ptr = Allocate(sizeof(T), alignof(T));
+    return ptr == nullptr ? nullptr : new (ptr) T(std::forward<Args>(args)...);
+  }
+
+  /// Allocates and value-initializes an array of `count` `T`s.
+  template <typename T>
+  span<T> NewArray(size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Arena never runs destructors");
+    if (count > buffer_.size() / sizeof(T)) {
+      return span<T>();
+    }
+    void* ptr = Allocate(sizeof(T) * count, alignof(T));
+    if (ptr == nullptr) {
+      return span<T>();
+    }
+    T* array = new (ptr) T[count]();
+    return span<T>(array, count);
+  }
+
+  /// Changes the size of an allocation in place. Only the most recent
+  /// allocation can grow or give memory back to the arena; shrinking any other
+  /// allocation succeeds but does not free anything.
+  ///
+  /// @returns true if the allocation at `ptr` is now `new_size` bytes.
+  bool Resize(void* ptr, size_t old_size, size_t new_size);
+
+  Marker GetMarker() const { return Marker(offset_); }
+
+  /// Releases everything allocated since `marker` was taken. Markers taken
+  /// after `marker` are invalidated.
+  void Rewind(Marker marker);
+
+  /// Releases every allocation.
+  void Reset() { offset_ = 0; }
+
+  size_t used() const { return offset_; }
+  size_t remaining() const { return buffer_.size() - offset_; }
+  size_t capacity() const { return buffer_.size(); }
+
+ private:
+  ByteSpan buffer_;
+  size_t offset_;
+};
+
+}  // namespace pw::allocator
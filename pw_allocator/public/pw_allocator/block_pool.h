@@ -0,0 +1,298 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
+#include "pw_metric/metric.h"
+
+namespace pw::allocator {
+
+/// Pool of equally sized blocks carved out of a caller-provided buffer.
+///
+/// Free blocks form an intrusive stack: each free block stores the index of
+/// the next one, so the pool has no per-block overhead, and `Allocate` and
+/// `Free` are a single push or pop.
+///
+/// With `kLockFree` set, the stack head is a `std::atomic` updated with
+/// compare-and-swap, tagged with a generation count to avoid ABA races, so
+/// blocks may be allocated and freed concurrently from threads and interrupt
+/// handlers. This requires lock-free 32-bit atomics on the target.
+///
+/// The pool keeps `pw_metric` metrics in a group that can be added to a
+/// parent group with `parent.Add(pool.metrics())`. In lock-free mode, updating
+/// metrics from an interrupt is not safe, so the hot path only maintains
+/// atomic counters; call `UpdateMetrics` before dumping to refresh them.
+template <bool kLockFree = false>
+class BasicBlockPool {
+ public:
+  /// The maximum number of blocks a single pool can manage.
+  static constexpr size_t kMaxBlocks = 0xfffe;
+
+  /// Creates a pool of `block_size`-byte blocks using as much of `buffer` as
+  /// possible. Blocks are aligned to `alignment`, and are at least big enough
+  /// to hold the free stack link.
+  BasicBlockPool(ByteSpan buffer,
+                 size_t block_size,
+                 size_t alignment = alignof(std::max_align_t))
+      : block_size_(RoundUp(std::max(block_size, sizeof(Link)), alignment)) {
+    PW_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    auto addr = reinterpret_cast<uintptr_t>(buffer.data());
+    size_t skip = RoundUp(addr, alignment) - addr;
+    skip = std::min(skip, buffer.size());
+    begin_ = buffer.data() + skip;
+    num_blocks_ = std::min((buffer.size() - skip) / block_size_, kMaxBlocks);
+
+    // Thread every block onto the free stack, lowest address first.
+    for (size_t i = 0; i < num_blocks_; ++i) {
+      LinkAt(i) = static_cast<Link>(i + 1 < num_blocks_ ? i + 1 : kEmpty);
+    }
+    StoreHead(num_blocks_ == 0 ? kEmpty : 0);
+  }
+
+  BasicBlockPool(const BasicBlockPool&) = delete;
+  BasicBlockPool& operator=(const BasicBlockPool&) = delete;
+
+  /// Returns a free block, or nullptr if the pool is exhausted.
+  void* Allocate() {
+    size_t index = Pop();
+    if (index == kEmpty) {
+      Add(failures_, 1);
+      UpdateMetricsIfSingleThreaded();
+      return nullptr;
+    }
+    uint32_t in_use = Add(in_use_, 1);
+    if constexpr (kLockFree) {
+      uint32_t peak = peak_in_use_.load(std::memory_order_relaxed);
+      while (in_use > peak && !peak_in_use_.compare_exchange_weak(
+                                  peak, in_use, std::memory_order_relaxed)) {
+      }
+    } else {
+      peak_in_use_ = std::max(peak_in_use_, in_use);
+    }
+    Add(allocations_, 1);
+    UpdateMetricsIfSingleThreaded();
+    return begin_ + index * block_size_;
+  }
+
+  /// Returns a block obtained from `Allocate` to the pool.
+  void Free(void* ptr) {
+    if (ptr == nullptr) {
+      return;
+    }
+    PW_ASSERT(Contains(ptr));
+    size_t offset = static_cast<size_t>(static_cast<std::byte*>(ptr) - begin_);
+    PW_ASSERT(offset % block_size_ == 0);
+    Push(offset / block_size_);
+    Add(in_use_, static_cast<uint32_t>(-1));
+    UpdateMetricsIfSingleThreaded();
+  }
+
+  /// Returns whether `ptr` points into this pool's blocks.
+  bool Contains(const void* ptr) const {
+    auto* bytes = static_cast<const std::byte*>(ptr);
+    return bytes >= begin_ && bytes < begin_ + num_blocks_ * block_size_;
+  }
+
+  size_t block_size() const { return block_size_; }
+  size_t capacity() const { return num_blocks_; }
+  size_t available() const {
+    return num_blocks_ - Load(in_use_);
+  }
+
+  /// Copies the pool's counters into its metrics. This happens on every
+  /// operation unless the pool is lock-free.
+  void UpdateMetrics() {
+    in_use_metric_.Set(Load(in_use_));
+    peak_in_use_metric_.Set(Load(peak_in_use_));
+    allocations_metric_.Set(Load(allocations_));
+    failures_metric_.Set(Load(failures_));
+  }
+
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  using Link = uint16_t;
+  static constexpr size_t kEmpty = 0xffff;
+  static constexpr uint32_t kIndexMask = 0xffff;
+  static constexpr uint32_t kTagIncrement = 0x10000;
+
+  // Atomics are only used in lock-free mode, so that single-threaded pools do
+  // not require atomic support from the target.
+  using Word = std::conditional_t<kLockFree, std::atomic<uint32_t>, uint32_t>;
+
+  // Adds `amount` to `counter`, returning the new value.
+  static uint32_t Add(Word& counter, uint32_t amount) {
+    if constexpr (kLockFree) {
+      return counter.fetch_add(amount, std::memory_order_relaxed) + amount;
+    } else {
+      return counter += amount;
+    }
+  }
+
+  static uint32_t Load(const Word& counter) {
+    if constexpr (kLockFree) {
+      return counter.load(std::memory_order_relaxed);
+    } else {
+      return counter;
+    }
+  }
+
+  static constexpr size_t RoundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  Link& LinkAt(size_t index) {
+    return *std::launder(
+        reinterpret_cast<Link*>(begin_ + index * block_size_));
+  }
+
+  void StoreHead(uint32_t value) {
+    if constexpr (kLockFree) {
+      head_.store(value, std::memory_order_release);
+    } else {
+      head_ = value;
+    }
+  }
+
+  size_t Pop() {
+    if constexpr (kLockFree) {
+      uint32_t old_head = head_.load(std::memory_order_acquire);
+      uint32_t new_head;
+      do {
+        size_t index = old_head & kIndexMask;
+        if (index == kEmpty) {
+          return kEmpty;
+        }
+        new_head = ((old_head & ~kIndexMask) + kTagIncrement) | LinkAt(index);
+      } while (!head_.compare_exchange_weak(old_head,
+                                            new_head,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire));
+      return old_head & kIndexMask;
+    } else {
+      size_t index = head_;
+      if (index != kEmpty) {
+        head_ = LinkAt(index);
+      }
+      return index;
+    }
+  }
+
+  void Push(size_t index) {
+    if constexpr (kLockFree) {
+      uint32_t old_head = head_.load(std::memory_order_relaxed);
+      uint32_t new_head;
+      do {
+        LinkAt(index) = static_cast<Link>(old_head & kIndexMask);
+        new_head = ((old_head & ~kIndexMask) + kTagIncrement) |
+                   static_cast<uint32_t>(index);
+      } while (!head_.compare_exchange_weak(old_head,
+                                            new_head,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed));
+    } else {
+      LinkAt(index) = static_cast<Link>(head_);
+      head_ = static_cast<uint32_t>(index);
+    }
+  }
+
+  void UpdateMetricsIfSingleThreaded() {
+    if constexpr (!kLockFree) {
+      UpdateMetrics();
+    }
+  }
+
+  std::byte* begin_;
+  size_t block_size_;
+  size_t num_blocks_;
+  Word head_;
+
+  Word in_use_{0};
+  Word peak_in_use_{0};
+  Word allocations_{0};
+  Word failures_{0};
+
+  PW_METRIC_GROUP(metrics_, "pw::allocator::BlockPool");
+  PW_METRIC(metrics_, in_use_metric_, "in_use", 0u);
+  PW_METRIC(metrics_, peak_in_use_metric_, "peak_in_use", 0u);
+  PW_METRIC(metrics_, allocations_metric_, "allocations", 0u);
+  PW_METRIC(metrics_, failures_metric_, "failures", 0u);
+};
+
+using BlockPool = BasicBlockPool<false>;
+using LockFreeBlockPool = BasicBlockPool<true>;
+
+/// Byte-sized pool that owns storage for `kNumBlocks` blocks of `kBlockSize`
+/// bytes each.
+template <size_t kBlockSize,
+          size_t kNumBlocks,
+          bool kLockFree = false,
+          size_t kAlignment = alignof(std::max_align_t)>
+class FixedBytePool : public BasicBlockPool<kLockFree> {
+ public:
+  static_assert(kNumBlocks <= BasicBlockPool<kLockFree>::kMaxBlocks);
+
+  FixedBytePool()
+      : BasicBlockPool<kLockFree>(storage_, kBlockSize, kAlignment) {}
+
+ private:
+  static constexpr size_t kStride =
+      (std::max(kBlockSize, sizeof(uint16_t)) + kAlignment - 1) / kAlignment *
+      kAlignment;
+
+  alignas(kAlignment) std::byte storage_[kStride * kNumBlocks];
+};
+
+/// Typed pool of `kNumBlocks` objects of type `T`.
+///
+/// @code{.cpp}
+///   pw::allocator::FixedBlockPool<CallContext, 8> pool;
+///   CallContext* context = pool.New(channel_id);
+///   ...
+///   pool.Delete(context);
+/// @endcode
+template <typename T, size_t kNumBlocks, bool kLockFree = false>
+class FixedBlockPool
+    : public FixedBytePool<sizeof(T), kNumBlocks, kLockFree, alignof(T)> {
+ public:
+  /// Constructs a `T` in a free block, or returns nullptr if the pool is
+  /// exhausted.
+  template <typename... Args>
+  T* New(Args&&... args) {
+    void* ptr = this->Allocate();
+    if (ptr == nullptr) {
+      return nullptr;
+    }
+    return new (ptr) T(std::forward<Args>(args)...);
+  }
+
+  /// Destroys an object created by `New` and returns its block to the pool.
+  void Delete(T* object) {
+    if (object != nullptr) {
+      object->~T();
+      this->Free(object);
+    }
+  }
+};
+
+}  // namespace pw::allocator
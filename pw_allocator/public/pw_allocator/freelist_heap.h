@@ -18,14 +18,22 @@
 
 #include "pw_allocator/block.h"
 #include "pw_allocator/freelist.h"
+#include "pw_allocator/tlsf_freelist.h"
 #include "pw_span/span.h"
 
 namespace pw::allocator {
 
-class FreeListHeap {
+/// Heap built from `Block`s, which tracks free blocks using a freelist.
+///
+/// @tparam FreeListType The freelist implementation, either `FreeList` or
+/// `TlsfFreeList`. Both expose `AddChunk`, `FindChunk` and `RemoveChunk`.
+template <typename FreeListType>
+class BasicFreeListHeap {
  public:
   template <size_t kNumBuckets>
   friend class FreeListHeapBuffer;
+  template <size_t kNumFirstLevelClasses>
+  friend class TlsfFreeListHeapBuffer;
   struct HeapStats {
     size_t total_bytes;
     size_t bytes_allocated;
@@ -34,7 +42,7 @@ class FreeListHeap {
     size_t total_allocate_calls;
     size_t total_free_calls;
   };
-  FreeListHeap(span<std::byte> region, FreeList& freelist);
+  BasicFreeListHeap(span<std::byte> region, FreeListType& freelist);
 
   void* Allocate(size_t size);
   void Free(void* ptr);
@@ -43,6 +51,12 @@ class FreeListHeap {
 
   void LogHeapStats();
 
+  /// Walks the heap and returns the inner size of the largest free block.
+  size_t LargestFreeBlockSize() const;
+
+  /// Walks the heap and returns the total inner size of the free blocks.
+  size_t FreeBytes() const;
+
  private:
   span<std::byte> BlockToSpan(Block* block) {
     return span<std::byte>(block->UsableSpace(), block->InnerSize());
@@ -51,10 +65,16 @@ class FreeListHeap {
   void InvalidFreeCrash();
 
   span<std::byte> region_;
-  FreeList& freelist_;
+  FreeListType& freelist_;
   HeapStats heap_stats_;
 };
 
+extern template class BasicFreeListHeap<FreeList>;
+extern template class BasicFreeListHeap<TlsfFreeList>;
+
+using FreeListHeap = BasicFreeListHeap<FreeList>;
+using TlsfFreeListHeap = BasicFreeListHeap<TlsfFreeList>;
+
 template <size_t kNumBuckets = 6>
 class FreeListHeapBuffer {
  public:
@@ -75,9 +95,41 @@ class FreeListHeapBuffer {
 
   void LogHeapStats() { heap_.LogHeapStats(); }
 
+  size_t LargestFreeBlockSize() const { return heap_.LargestFreeBlockSize(); }
+
+  size_t FreeBytes() const { return heap_.FreeBytes(); }
+
  private:
   FreeListBuffer<kNumBuckets> freelist_;
   FreeListHeap heap_;
 };
 
+/// Drop-in replacement for `FreeListHeapBuffer` whose freelist is a
+/// `TlsfFreeList`, so allocations and frees take constant time regardless of
+/// how many chunks are free.
+template <size_t kNumFirstLevelClasses = 12>
+class TlsfFreeListHeapBuffer {
+ public:
+  TlsfFreeListHeapBuffer(span<std::byte> region) : heap_(region, freelist_) {}
+
+  void* Allocate(size_t size) { return heap_.Allocate(size); }
+  void Free(void* ptr) { heap_.Free(ptr); }
+  void* Realloc(void* ptr, size_t size) { return heap_.Realloc(ptr, size); }
+  void* Calloc(size_t num, size_t size) { return heap_.Calloc(num, size); }
+
+  const TlsfFreeListHeap::HeapStats& heap_stats() const {
+    return heap_.heap_stats_;
+  }
+
+  void LogHeapStats() { heap_.LogHeapStats(); }
+
+  size_t LargestFreeBlockSize() const { return heap_.LargestFreeBlockSize(); }
+
+  size_t FreeBytes() const { return heap_.FreeBytes(); }
+
+ private:
+  TlsfFreeListBuffer<kNumFirstLevelClasses> freelist_;
+  TlsfFreeListHeap heap_;
+};
+
 }  // namespace pw::allocator
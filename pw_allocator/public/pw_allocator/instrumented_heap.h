@@ -0,0 +1,190 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/block.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/metric.h"
+
+namespace pw::allocator {
+
+/// Wraps a `Block`-based heap, such as `FreeListHeapBuffer` or
+/// `TlsfFreeListHeapBuffer`, and records how it is used as `pw_metric`
+/// metrics:
+///
+/// - `bytes_allocated` and `peak_bytes_allocated`: current and high-water mark
+///   of the inner size of live blocks.
+/// - `allocations`, `frees` and `failed_allocations`: call counts.
+/// - `max_allocate_us` and `total_allocate_us`: time spent in the wrapped
+///   heap's `Allocate`.
+/// - `size_histogram`: the number of allocation requests in each power-of-two
+///   size class, from `le_16` up to `gt_1024`.
+/// - `largest_free_block` and `fragmentation_percent`: refreshed by
+///   `UpdateFragmentationMetrics`, since they require walking the heap.
+///
+/// Give each subsystem's heap its own group name, and add the group to the
+/// metrics served by `MetricService` with `parent.Add(heap.metrics())`.
+template <typename Heap>
+class InstrumentedHeap {
+ public:
+  /// @param heap The heap to forward allocations to.
+  /// @param name Token for the metric group, e.g. from `PW_TOKENIZE_STRING_EXPR`.
+  InstrumentedHeap(Heap& heap, metric::Token name)
+      : heap_(heap), metrics_(name) {
+    metrics_.Add(size_histogram_);
+  }
+
+  void* Allocate(size_t size) {
+    RecordRequest(size);
+    auto start = chrono::SystemClock::now();
+    void* ptr = heap_.Allocate(size);
+    RecordLatency(chrono::SystemClock::now() - start);
+    RecordAllocation(ptr);
+    return ptr;
+  }
+
+  void Free(void* ptr) {
+    if (ptr == nullptr) {
+      return;
+    }
+    RecordFree(ptr);
+    heap_.Free(ptr);
+  }
+
+  void* Realloc(void* ptr, size_t size) {
+    if (ptr != nullptr) {
+      RecordFree(ptr);
+    }
+    RecordRequest(size);
+    void* new_ptr = heap_.Realloc(ptr, size);
+    if (new_ptr == nullptr && ptr != nullptr && size != 0) {
+      // The original block is untouched when a realloc fails.
+      RecordAllocation(ptr);
+      failed_allocations_.Increment();
+      return nullptr;
+    }
+    if (size != 0) {
+      RecordAllocation(new_ptr);
+    }
+    return new_ptr;
+  }
+
+  void* Calloc(size_t num, size_t size) {
+    RecordRequest(num * size);
+    auto start = chrono::SystemClock::now();
+    void* ptr = heap_.Calloc(num, size);
+    RecordLatency(chrono::SystemClock::now() - start);
+    RecordAllocation(ptr);
+    return ptr;
+  }
+
+  /// Walks the heap to update `largest_free_block` and
+  /// `fragmentation_percent`. Fragmentation is the share of the free blocks'
+  /// inner size that is not part of the largest free block, so block headers
+  /// do not count as free memory.
+  void UpdateFragmentationMetrics() {
+    size_t largest = heap_.LargestFreeBlockSize();
+    size_t free_bytes = heap_.FreeBytes();
+    largest_free_block_.Set(static_cast<uint32_t>(largest));
+    uint32_t fragmentation = 0;
+    if (free_bytes > 0 && largest < free_bytes) {
+      fragmentation =
+          static_cast<uint32_t>((free_bytes - largest) * 100 / free_bytes);
+    }
+    fragmentation_percent_.Set(fragmentation);
+  }
+
+  metric::Group& metrics() { return metrics_; }
+
+  Heap& heap() { return heap_; }
+
+ private:
+  static size_t InnerSize(void* ptr) {
+    return Block::FromUsableSpace(static_cast<std::byte*>(ptr))->InnerSize();
+  }
+
+  void RecordRequest(size_t size) {
+    if (size <= 16) {
+      le_16_.Increment();
+    } else if (size <= 32) {
+      le_32_.Increment();
+    } else if (size <= 64) {
+      le_64_.Increment();
+    } else if (size <= 128) {
+      le_128_.Increment();
+    } else if (size <= 256) {
+      le_256_.Increment();
+    } else if (size <= 512) {
+      le_512_.Increment();
+    } else if (size <= 1024) {
+      le_1024_.Increment();
+    } else {
+      gt_1024_.Increment();
+    }
+  }
+
+  void RecordLatency(chrono::SystemClock::duration elapsed) {
+    auto us = static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    total_allocate_us_.Increment(us);
+    max_allocate_us_.Set(std::max(max_allocate_us_.value(), us));
+  }
+
+  void RecordAllocation(void* ptr) {
+    if (ptr == nullptr) {
+      failed_allocations_.Increment();
+      return;
+    }
+    allocations_.Increment();
+    bytes_allocated_.Increment(static_cast<uint32_t>(InnerSize(ptr)));
+    peak_bytes_allocated_.Set(
+        std::max(peak_bytes_allocated_.value(), bytes_allocated_.value()));
+  }
+
+  void RecordFree(void* ptr) {
+    frees_.Increment();
+    bytes_allocated_.Set(bytes_allocated_.value() -
+                         static_cast<uint32_t>(InnerSize(ptr)));
+  }
+
+  Heap& heap_;
+
+  metric::Group metrics_;
+  PW_METRIC(metrics_, bytes_allocated_, "bytes_allocated", 0u);
+  PW_METRIC(metrics_, peak_bytes_allocated_, "peak_bytes_allocated", 0u);
+  PW_METRIC(metrics_, allocations_, "allocations", 0u);
+  PW_METRIC(metrics_, frees_, "frees", 0u);
+  PW_METRIC(metrics_, failed_allocations_, "failed_allocations", 0u);
+  PW_METRIC(metrics_, max_allocate_us_, "max_allocate_us", 0u);
+  PW_METRIC(metrics_, total_allocate_us_, "total_allocate_us", 0u);
+  PW_METRIC(metrics_, largest_free_block_, "largest_free_block", 0u);
+  PW_METRIC(metrics_, fragmentation_percent_, "fragmentation_percent", 0u);
+
+  PW_METRIC_GROUP(size_histogram_, "size_histogram");
+  PW_METRIC(size_histogram_, le_16_, "le_16", 0u);
+  PW_METRIC(size_histogram_, le_32_, "le_32", 0u);
+  PW_METRIC(size_histogram_, le_64_, "le_64", 0u);
+  PW_METRIC(size_histogram_, le_128_, "le_128", 0u);
+  PW_METRIC(size_histogram_, le_256_, "le_256", 0u);
+  PW_METRIC(size_histogram_, le_512_, "le_512", 0u);
+  PW_METRIC(size_histogram_, le_1024_, "le_1024", 0u);
+  PW_METRIC(size_histogram_, gt_1024_, "gt_1024", 0u);
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,154 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_allocator/block.h"
+
+namespace pw::allocator {
+
+/// Front-end cache of small blocks for a `Block`-based heap such as
+/// `FreeListHeapBuffer` or `TlsfFreeListHeapBuffer`.
+///
+/// Small allocations are rounded up to one of `kNumSizeClasses` power-of-two
+/// size classes, starting at `kMinSizeClass` bytes. When such a block is
+/// freed, it is pushed onto that class's magazine instead of being returned to
+/// the heap, and the next allocation of that class pops it again without
+/// touching the heap. Each magazine holds at most `kMagazineCapacity` blocks;
+/// frees beyond that, and all larger allocations, go straight to the heap.
+///
+/// Cached blocks remain allocated as far as the heap is concerned. Use
+/// `Flush` (or destroy the cache) to hand them back.
+///
+/// A cache is not thread safe. It is intended to be owned by a single thread
+/// or core, e.g. as a `thread_local`, so that the common small-object path
+/// does not contend with other threads for the heap.
+template <typename Heap,
+          size_t kNumSizeClasses = 4,
+          size_t kMagazineCapacity = 8,
+          size_t kMinSizeClass = 16>
+class MagazineCache {
+ public:
+  static_assert(kNumSizeClasses > 0);
+  static_assert(kMinSizeClass >= sizeof(void*),
+                "Cached blocks must be able to hold a list link");
+  static_assert((kMinSizeClass & (kMinSizeClass - 1)) == 0,
+                "Size classes must be powers of two");
+
+  static constexpr size_t kMaxSizeClass = kMinSizeClass
+                                          << (kNumSizeClasses - 1);
+
+  constexpr explicit MagazineCache(Heap& heap) : heap_(heap), magazines_{} {}
+
+  MagazineCache(const MagazineCache&) = delete;
+  MagazineCache& operator=(const MagazineCache&) = delete;
+
+  ~MagazineCache() { Flush(); }
+
+  void* Allocate(size_t size) {
+    if (size == 0 || size > kMaxSizeClass) {
+      return heap_.Allocate(size);
+    }
+    size_t index = ClassForRequest(size);
+    Magazine& magazine = magazines_[index];
+    if (magazine.head != nullptr) {
+      Node* node = magazine.head;
+      magazine.head = node->next;
+      magazine.count -= 1;
+      return node;
+    }
+    return heap_.Allocate(SizeOfClass(index));
+  }
+
+  void Free(void* ptr) {
+    if (ptr == nullptr) {
+      return;
+    }
+    size_t inner_size =
+        Block::FromUsableSpace(static_cast<std::byte*>(ptr))->InnerSize();
+    if (inner_size < kMinSizeClass || inner_size >= 2 * kMaxSizeClass) {
+      heap_.Free(ptr);
+      return;
+    }
+    Magazine& magazine = magazines_[ClassForBlock(inner_size)];
+    if (magazine.count == kMagazineCapacity) {
+      heap_.Free(ptr);
+      return;
+    }
+    Node* node = static_cast<Node*>(ptr);
+    node->next = magazine.head;
+    magazine.head = node;
+    magazine.count += 1;
+  }
+
+  /// Returns every cached block to the heap.
+  void Flush() {
+    for (Magazine& magazine : magazines_) {
+      while (magazine.head != nullptr) {
+        Node* node = magazine.head;
+        magazine.head = node->next;
+        heap_.Free(node);
+      }
+      magazine.count = 0;
+    }
+  }
+
+  /// Returns the number of blocks currently held by the cache.
+  size_t cached_blocks() const {
+    size_t total = 0;
+    for (const Magazine& magazine : magazines_) {
+      total += magazine.count;
+    }
+    return total;
+  }
+
+ private:
+  struct Node {
+    Node* next;
+  };
+
+  struct Magazine {
+    Node* head;
+    size_t count;
+  };
+
+  static constexpr size_t SizeOfClass(size_t index) {
+    return kMinSizeClass << index;
+  }
+
+  // Smallest class that can satisfy a request of `size` bytes.
+  static constexpr size_t ClassForRequest(size_t size) {
+    size_t index = 0;
+    while (SizeOfClass(index) < size) {
+      ++index;
+    }
+    return index;
+  }
+
+  // Largest class that a block of `inner_size` bytes can be used for.
+  static constexpr size_t ClassForBlock(size_t inner_size) {
+    size_t index = kNumSizeClasses - 1;
+    while (SizeOfClass(index) > inner_size) {
+      --index;
+    }
+    return index;
+  }
+
+  Heap& heap_;
+  std::array<Magazine, kNumSizeClasses> magazines_;
+};
+
+}  // namespace pw::allocator
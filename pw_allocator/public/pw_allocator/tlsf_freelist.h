@@ -0,0 +1,158 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw::allocator {
+
+template <size_t kNumFirstLevelClasses>
+class TlsfFreeListBuffer;
+
+/// Two-level segregated fit (TLSF) freelist. This offers the same interface as
+/// `FreeList`, but finds, adds and removes chunks in constant time.
+///
+/// Chunks are sorted into bins by size. The first level splits sizes by powers
+/// of two, and the second level linearly subdivides each power of two into
+/// `kNumSecondLevelClasses` bins. A bitmap per level records which bins are
+/// non-empty, so locating a suitable bin is a couple of count-zero
+/// instructions rather than a walk over the buckets.
+///
+/// First-level class 0 holds chunks smaller than `kSmallChunkSize`, in bins
+/// that are `1 << kAlignmentBits` bytes wide. Class `i > 0` holds chunks in
+/// `[2^(i + 4), 2^(i + 5))`. The final bin of the last class also holds every
+/// chunk which is too large for any class; it is the only bin which may need
+/// to be walked when searching.
+///
+/// `FindChunk` rounds the request up to the next bin boundary so that any
+/// chunk in the selected bin is large enough ("good fit"). If that fails, the
+/// request's own bin is searched before giving up, so an allocation only fails
+/// when no chunk is large enough.
+///
+/// Each chunk is used as a doubly-linked list node, so chunks must be at least
+/// `sizeof(TlsfFreeList.FreeListNode)` bytes and aligned to a pointer boundary.
+///
+/// Like `FreeList`, this class is split into the logic, `TlsfFreeList`, and the
+/// storage for its bins, `TlsfFreeListBuffer`.
+class TlsfFreeList {
+ public:
+  static constexpr size_t kAlignmentBits = 2;
+  static constexpr size_t kSecondLevelBits = 3;
+  static constexpr size_t kNumSecondLevelClasses = size_t(1)
+                                                   << kSecondLevelBits;
+  static constexpr size_t kSmallChunkSize = size_t(1)
+                                            << (kSecondLevelBits +
+                                                kAlignmentBits);
+
+  TlsfFreeList(const TlsfFreeList& other) = delete;
+  TlsfFreeList(TlsfFreeList&& other) = delete;
+  TlsfFreeList& operator=(const TlsfFreeList& other) = delete;
+  TlsfFreeList& operator=(TlsfFreeList&& other) = delete;
+
+  /// Adds a chunk to this freelist.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The chunk was added successfully.
+  /// * @pw_status{OUT_OF_RANGE} - The chunk could not be added for size
+  ///   reasons (e.g. the chunk is too small to store the `FreeListNode`).
+  Status AddChunk(span<std::byte> chunk);
+
+  /// Finds an eligible chunk for an allocation of size `size`.
+  ///
+  /// @returns
+  /// * On success - A span representing the chunk.
+  /// * On failure (e.g. there were no chunks available for that allocation) -
+  ///   A span with a size of 0.
+  span<std::byte> FindChunk(size_t size) const;
+
+  /// Removes a chunk from this freelist.
+  ///
+  /// Membership is checked using the chunk's own links, so `chunk` must either
+  /// have been added to this freelist or be too small to hold a node.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The chunk was removed successfully.
+  /// * @pw_status{NOT_FOUND} - The chunk could not be found in this freelist.
+  Status RemoveChunk(span<std::byte> chunk);
+
+ private:
+  template <size_t kNumFirstLevelClasses>
+  friend class TlsfFreeListBuffer;
+
+  struct FreeListNode {
+    FreeListNode* prev;
+    FreeListNode* next;
+    size_t size;
+  };
+
+  using SecondLevelBitmap = uint8_t;
+  static_assert(sizeof(SecondLevelBitmap) * 8 == kNumSecondLevelClasses);
+
+  constexpr TlsfFreeList(span<FreeListNode*> bins,
+                         span<SecondLevelBitmap> second_level_bitmaps)
+      : bins_(bins),
+        second_level_bitmaps_(second_level_bitmaps),
+        first_level_bitmap_(0) {}
+
+  // Returns the index into bins_ of the bin that a chunk of `size` bytes is
+  // stored in.
+  size_t BinIndexForSize(size_t size) const;
+
+  // Returns the index of the first non-empty bin at or above `index`, or
+  // bins_.size() if there is none.
+  size_t FindNonEmptyBin(size_t index) const;
+
+  // Returns the first chunk in the bin at `index` with at least `size` bytes.
+  span<std::byte> FindChunkInBin(size_t index, size_t size) const;
+
+  size_t num_first_level_classes() const {
+    return second_level_bitmaps_.size();
+  }
+
+  span<FreeListNode*> bins_;
+  span<SecondLevelBitmap> second_level_bitmaps_;
+  uint32_t first_level_bitmap_;
+};
+
+/// Holder for `TlsfFreeList`'s storage.
+///
+/// @tparam kNumFirstLevelClasses Number of power-of-two size classes. Chunks
+/// of up to `2^(kNumFirstLevelClasses + 4) - 1` bytes are binned exactly; the
+/// default covers chunks of up to 64 KiB.
+template <size_t kNumFirstLevelClasses = 12>
+class TlsfFreeListBuffer : public TlsfFreeList {
+ public:
+  static_assert(kNumFirstLevelClasses > 0);
+  static_assert(kNumFirstLevelClasses <= 32,
+                "The first level bitmap holds at most 32 classes");
+
+  // As with FreeListBuffer, the base class only stores spans over the storage
+  // below, so it is safe to construct it first.
+  TlsfFreeListBuffer()
+      : TlsfFreeList(bins_, second_level_bitmaps_),
+        bins_{},
+        second_level_bitmaps_{} {}
+
+ private:
+  std::array<FreeListNode*, kNumFirstLevelClasses * kNumSecondLevelClasses>
+      bins_;
+  std::array<SecondLevelBitmap, kNumFirstLevelClasses> second_level_bitmaps_;
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,184 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_freelist.h"
+
+#include <limits>
+
+#include "lib/stdcompat/bit.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t kFirstLevelShift =
+    TlsfFreeList::kSecondLevelBits + TlsfFreeList::kAlignmentBits;
+
+// Index of the most significant set bit. `value` must be non-zero.
+size_t MostSignificantBit(size_t value) {
+  return static_cast<size_t>(std::numeric_limits<size_t>::digits - 1 -
+                             cpp20::countl_zero(value));
+}
+
+// Rounds `size` up so that every chunk in the bin the result maps to is at
+// least `size` bytes.
+size_t RoundUpToBinBoundary(size_t size) {
+  size_t round = (size_t(1) << TlsfFreeList::kAlignmentBits) - 1;
+  if (size >= TlsfFreeList::kSmallChunkSize) {
+    round = (size_t(1) << (MostSignificantBit(size) -
+                           TlsfFreeList::kSecondLevelBits)) -
+            1;
+  }
+  if (size > std::numeric_limits<size_t>::max() - round) {
+    return std::numeric_limits<size_t>::max();
+  }
+  return size + round;
+}
+
+}  // namespace
+
+Status TlsfFreeList::AddChunk(span<std::byte> chunk) {
+  // Check that the size is enough to actually store what we need
+  if (chunk.size() < sizeof(FreeListNode)) {
+    return Status::OutOfRange();
+  }
+
+  auto* node = reinterpret_cast<FreeListNode*>(chunk.data());
+  size_t index = BinIndexForSize(chunk.size());
+
+  // Add it to the head of the correct list.
+  node->size = chunk.size();
+  node->prev = nullptr;
+  node->next = bins_[index];
+  if (node->next != nullptr) {
+    node->next->prev = node;
+  }
+  bins_[index] = node;
+
+  size_t first_level = index / kNumSecondLevelClasses;
+  size_t second_level = index % kNumSecondLevelClasses;
+  second_level_bitmaps_[first_level] |=
+      static_cast<SecondLevelBitmap>(1u << second_level);
+  first_level_bitmap_ |= uint32_t(1) << first_level;
+
+  return OkStatus();
+}
+
+span<std::byte> TlsfFreeList::FindChunk(size_t size) const {
+  if (size == 0) {
+    return span<std::byte>();
+  }
+
+  // Any chunk in a bin at or above the rounded up size is large enough, except
+  // for the overflow bin at the very end, which FindChunkInBin walks.
+  size_t index = FindNonEmptyBin(BinIndexForSize(RoundUpToBinBoundary(size)));
+  if (index < bins_.size()) {
+    span<std::byte> chunk = FindChunkInBin(index, size);
+    if (chunk.data() != nullptr) {
+      return chunk;
+    }
+  }
+
+  // The request's own bin may still hold a chunk that is large enough.
+  return FindChunkInBin(BinIndexForSize(size), size);
+}
+
+Status TlsfFreeList::RemoveChunk(span<std::byte> chunk) {
+  if (chunk.size() < sizeof(FreeListNode)) {
+    return Status::NotFound();
+  }
+
+  auto* node = reinterpret_cast<FreeListNode*>(chunk.data());
+  size_t index = BinIndexForSize(chunk.size());
+
+  // Validate the node against its neighbours before unlinking it.
+  if (node->size != chunk.size()) {
+    return Status::NotFound();
+  }
+  if (node->prev == nullptr ? bins_[index] != node : node->prev->next != node) {
+    return Status::NotFound();
+  }
+
+  if (node->prev == nullptr) {
+    bins_[index] = node->next;
+  } else {
+    node->prev->next = node->next;
+  }
+  if (node->next != nullptr) {
+    node->next->prev = node->prev;
+  }
+
+  if (bins_[index] == nullptr) {
+    size_t first_level = index / kNumSecondLevelClasses;
+    size_t second_level = index % kNumSecondLevelClasses;
+    second_level_bitmaps_[first_level] &=
+        static_cast<SecondLevelBitmap>(~(1u << second_level));
+    if (second_level_bitmaps_[first_level] == 0) {
+      first_level_bitmap_ &= ~(uint32_t(1) << first_level);
+    }
+  }
+
+  return OkStatus();
+}
+
+size_t TlsfFreeList::BinIndexForSize(size_t size) const {
+  size_t first_level = 0;
+  size_t second_level = size >> kAlignmentBits;
+  if (size >= kSmallChunkSize) {
+    size_t msb = MostSignificantBit(size);
+    first_level = msb - kFirstLevelShift + 1;
+    second_level = (size >> (msb - kSecondLevelBits)) - kNumSecondLevelClasses;
+  }
+
+  // Oversized chunks all share the last bin.
+  if (first_level >= num_first_level_classes()) {
+    return bins_.size() - 1;
+  }
+  return first_level * kNumSecondLevelClasses + second_level;
+}
+
+size_t TlsfFreeList::FindNonEmptyBin(size_t index) const {
+  size_t first_level = index / kNumSecondLevelClasses;
+  size_t second_level = index % kNumSecondLevelClasses;
+
+  // Look for a non-empty bin in the same first level class first.
+  unsigned int second_level_map = second_level_bitmaps_[first_level] &
+                                  (~0u << second_level);
+  if (second_level_map == 0) {
+    // Otherwise take the smallest non-empty first level class above it.
+    if (first_level + 1 >= num_first_level_classes()) {
+      return bins_.size();
+    }
+    uint32_t first_level_map =
+        first_level_bitmap_ & (~uint32_t(0) << (first_level + 1));
+    if (first_level_map == 0) {
+      return bins_.size();
+    }
+    first_level = static_cast<size_t>(cpp20::countr_zero(first_level_map));
+    second_level_map = second_level_bitmaps_[first_level];
+  }
+
+  second_level = static_cast<size_t>(cpp20::countr_zero(second_level_map));
+  return first_level * kNumSecondLevelClasses + second_level;
+}
+
+span<std::byte> TlsfFreeList::FindChunkInBin(size_t index, size_t size) const {
+  for (FreeListNode* node = bins_[index]; node != nullptr; node = node->next) {
+    if (node->size >= size) {
+      return span<std::byte>(reinterpret_cast<std::byte*>(node), node->size);
+    }
+  }
+  return span<std::byte>();
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,157 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_freelist.h"
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+using std::byte;
+
+namespace pw::allocator {
+namespace {
+
+// Chunks must be able to hold a node, which is three words.
+alignas(void*) byte storage1[4096];
+alignas(void*) byte storage2[4096];
+alignas(void*) byte storage3[4096];
+
+TEST(TlsfFreeList, EmptyListHasNoMembers) {
+  TlsfFreeListBuffer<> list;
+
+  auto item = list.FindChunk(4);
+  EXPECT_EQ(item.size(), static_cast<size_t>(0));
+  item = list.FindChunk(128);
+  EXPECT_EQ(item.size(), static_cast<size_t>(0));
+}
+
+TEST(TlsfFreeList, RejectsChunkTooSmallForNode) {
+  TlsfFreeListBuffer<> list;
+  EXPECT_EQ(list.AddChunk(span(storage1, sizeof(void*))),
+            Status::OutOfRange());
+}
+
+TEST(TlsfFreeList, CanRetrieveAddedMember) {
+  TlsfFreeListBuffer<> list;
+  constexpr size_t kN = 512;
+
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage1, kN)));
+
+  auto item = list.FindChunk(kN);
+  EXPECT_EQ(item.size(), kN);
+  EXPECT_EQ(item.data(), storage1);
+}
+
+TEST(TlsfFreeList, CanRetrieveAddedMemberForSmallerSize) {
+  TlsfFreeListBuffer<> list;
+  constexpr size_t kN = 512;
+
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage1, kN)));
+  auto item = list.FindChunk(kN / 2);
+  EXPECT_EQ(item.size(), kN);
+  EXPECT_EQ(item.data(), storage1);
+}
+
+TEST(TlsfFreeList, CanRemoveItem) {
+  TlsfFreeListBuffer<> list;
+  constexpr size_t kN = 512;
+
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage1, kN)));
+  EXPECT_EQ(OkStatus(), list.RemoveChunk(span(storage1, kN)));
+
+  auto item = list.FindChunk(kN);
+  EXPECT_EQ(item.size(), static_cast<size_t>(0));
+}
+
+TEST(TlsfFreeList, FindReturnsChunkFromSmallestSuitableBin) {
+  TlsfFreeListBuffer<> list;
+  constexpr size_t kN1 = 512;
+  constexpr size_t kN2 = 1024;
+
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage1, kN1)));
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage2, kN2)));
+
+  auto chunk = list.FindChunk(kN1 / 2);
+  EXPECT_EQ(chunk.data(), storage1);
+
+  chunk = list.FindChunk(kN1);
+  EXPECT_EQ(chunk.data(), storage1);
+
+  chunk = list.FindChunk(kN1 + 1);
+  EXPECT_EQ(chunk.data(), storage2);
+}
+
+TEST(TlsfFreeList, FindFallsBackToRequestedBin) {
+  // 520 and 540 share a second level bin, so a request for 530 bytes rounds
+  // up past the bin. It should still be satisfied by the 540 byte chunk.
+  TlsfFreeListBuffer<> list;
+
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage2, 540)));
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage1, 520)));
+
+  auto chunk = list.FindChunk(530);
+  EXPECT_EQ(chunk.data(), storage2);
+  EXPECT_EQ(chunk.size(), 540u);
+
+  EXPECT_EQ(list.FindChunk(541).size(), 0u);
+}
+
+TEST(TlsfFreeList, OversizedChunksAreFound) {
+  TlsfFreeListBuffer<1> list;  // Only covers chunks of up to 31 bytes.
+
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage1, 1024)));
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage2, 4096)));
+
+  EXPECT_EQ(list.FindChunk(2048).data(), storage2);
+  EXPECT_NE(list.FindChunk(8).size(), 0u);
+  EXPECT_EQ(list.FindChunk(4097).size(), 0u);
+}
+
+TEST(TlsfFreeList, RemoveUnknownChunkReturnsNotFound) {
+  TlsfFreeListBuffer<> list;
+  constexpr size_t kN = 512;
+
+  std::fill(std::begin(storage2), std::end(storage2), byte(0));
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage1, kN)));
+  EXPECT_EQ(list.RemoveChunk(span(storage2, kN)), Status::NotFound());
+  EXPECT_EQ(list.RemoveChunk(span(storage1, kN / 2)), Status::NotFound());
+}
+
+TEST(TlsfFreeList, CanRemoveFromMiddleOfBin) {
+  TlsfFreeListBuffer<> list;
+  constexpr size_t kN = 512;
+
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage1, kN)));
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage2, kN)));
+  ASSERT_EQ(OkStatus(), list.AddChunk(span(storage3, kN)));
+
+  ASSERT_EQ(OkStatus(), list.RemoveChunk(span(storage2, kN)));
+
+  auto chunk1 = list.FindChunk(kN);
+  ASSERT_EQ(OkStatus(), list.RemoveChunk(chunk1));
+  auto chunk2 = list.FindChunk(kN);
+  ASSERT_EQ(OkStatus(), list.RemoveChunk(chunk2));
+
+  // Ordering of the chunks doesn't matter
+  EXPECT_NE(chunk1.data(), chunk2.data());
+  EXPECT_NE(chunk1.data(), storage2);
+  EXPECT_NE(chunk2.data(), storage2);
+  EXPECT_EQ(list.FindChunk(1).size(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::allocator
@@ -0,0 +1,211 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+
+#include "pw_analog/analog_input.h"
+#include "pw_analog/microvolt_input.h"
+#include "pw_function/function.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/try.h"
+
+namespace pw::analog {
+
+// Interface for continuously sampling one ADC channel into blocks of samples,
+// for sample rates that are too high to read one sample at a time with
+// AnalogInput.
+//
+// The backend fills a caller-provided buffer that holds two blocks, typically
+// with circular DMA, and calls BlockComplete() each time one of the blocks is
+// full, such as from the DMA half-transfer and transfer-complete interrupts.
+// While the callback processes one block, the backend fills the other one.
+//
+// Blocks may optionally be decimated by averaging groups of samples before
+// they are passed to the callback, which also reduces noise. Decimation is
+// done in place in the completed block.
+//
+// The callback runs in the context that the backend calls BlockComplete()
+// from, which may be an interrupt. It must finish before the other block is
+// complete; blocks that complete while the callback is running are dropped
+// and counted. To process blocks in a thread or a pw_async task, copy them
+// out or signal the thread from the callback.
+//
+// Start() and Stop() must not be called concurrently.
+class SampledInput {
+ public:
+  using Limits = AnalogInput::Limits;
+
+  // Receives each block of samples. The samples may be modified in place,
+  // for example by ConvertToMicrovolts(), and are only valid during the call.
+  using BlockCallback = Function<void(span<int32_t> samples)>;
+
+  struct Config {
+    // Rate at which the ADC is sampled, before decimation.
+    uint32_t sample_rate_hz;
+
+    // Number of samples in each block, before decimation. The buffer passed
+    // to Start() must hold two blocks.
+    size_t block_size;
+
+    // Number of consecutive samples that are averaged into one. Must evenly
+    // divide block_size.
+    size_t decimation = 1;
+  };
+
+  virtual ~SampledInput() = default;
+
+  // Starts sampling into buffer and calling callback with each block.
+  //
+  // Returns:
+  //   OK - Sampling started.
+  //   INVALID_ARGUMENT - The buffer or configuration is invalid.
+  //   FAILED_PRECONDITION - Sampling is already running.
+  //   Other statuses left up to the implementer.
+  Status Start(const Config& config,
+               span<int32_t> buffer,
+               BlockCallback&& callback) {
+    if (running_) {
+      return Status::FailedPrecondition();
+    }
+    if (config.sample_rate_hz == 0u || config.block_size == 0u ||
+        config.decimation == 0u ||
+        config.block_size % config.decimation != 0u ||
+        buffer.size() < 2 * config.block_size) {
+      return Status::InvalidArgument();
+    }
+    block_size_ = config.block_size;
+    decimation_ = config.decimation;
+    buffer_ = buffer.first(2 * config.block_size);
+    callback_ = std::move(callback);
+    dropped_blocks_.store(0, std::memory_order_relaxed);
+
+    if (Status status = DoStart(config.sample_rate_hz, buffer_); !status.ok()) {
+      callback_ = nullptr;
+      return status;
+    }
+    running_ = true;
+    return OkStatus();
+  }
+
+  // Stops sampling. No callbacks are made after Stop() returns.
+  Status Stop() {
+    if (!running_) {
+      return OkStatus();
+    }
+    PW_TRY(DoStop());
+    running_ = false;
+    callback_ = nullptr;
+    return OkStatus();
+  }
+
+  bool running() const { return running_; }
+
+  // Number of blocks that were dropped because the previous block was still
+  // being processed since sampling started.
+  uint32_t dropped_blocks() const {
+    return dropped_blocks_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the range of the ADC samples.
+  // These values do not change at run time.
+  virtual Limits GetLimits() const = 0;
+
+ protected:
+  // Called by the backend when block 0 or 1 of the buffer is full. The
+  // backend must keep filling the other block.
+  void BlockComplete(size_t index) {
+    if (in_callback_.exchange(true, std::memory_order_acquire)) {
+      dropped_blocks_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    span<int32_t> block = Decimate(buffer_.subspan(index * block_size_,
+                                                   block_size_));
+    callback_(block);
+    in_callback_.store(false, std::memory_order_release);
+  }
+
+ private:
+  // Starts sampling at sample_rate_hz into buffer, which holds two blocks, and
+  // calling BlockComplete() when each block is full.
+  virtual Status DoStart(uint32_t sample_rate_hz, span<int32_t> buffer) = 0;
+
+  // Stops sampling. BlockComplete() must not be called after this returns.
+  virtual Status DoStop() = 0;
+
+  // Averages each group of decimation_ samples into the start of the block.
+  span<int32_t> Decimate(span<int32_t> block) const {
+    if (decimation_ == 1u) {
+      return block;
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < block.size(); i += decimation_) {
+      int64_t sum = 0;
+      for (size_t j = i; j < i + decimation_; ++j) {
+        sum += block[j];
+      }
+      block[count++] =
+          static_cast<int32_t>(sum / static_cast<int64_t>(decimation_));
+    }
+    return block.first(count);
+  }
+
+  span<int32_t> buffer_;
+  size_t block_size_ = 0;
+  size_t decimation_ = 1;
+  BlockCallback callback_;
+  bool running_ = false;
+  std::atomic<bool> in_callback_{false};
+  std::atomic<uint32_t> dropped_blocks_{0};
+};
+
+// Converts a block of samples to microvolts in place, as MicrovoltInput does
+// for single samples. The references are checked once per block rather than
+// once per sample.
+//
+// Returns:
+//   OK - The samples were converted.
+//   INVALID_ARGUMENT - The limits are equal.
+//   INTERNAL - The reference voltage difference does not fit in an int32_t.
+inline Status ConvertToMicrovolts(span<int32_t> samples,
+                                  AnalogInput::Limits limits,
+                                  MicrovoltInput::References references) {
+  const int64_t reference_diff =
+      static_cast<int64_t>(references.max_voltage_uv) -
+      static_cast<int64_t>(references.min_voltage_uv);
+  if (std::abs(reference_diff) > std::numeric_limits<int32_t>::max()) {
+    return Status::Internal();
+  }
+  const int64_t limits_diff =
+      static_cast<int64_t>(limits.max) - static_cast<int64_t>(limits.min);
+  if (limits_diff == 0) {
+    return Status::InvalidArgument();
+  }
+
+  for (int32_t& sample : samples) {
+    sample = static_cast<int32_t>(
+        ((static_cast<int64_t>(sample) - limits.min) * reference_diff) /
+            limits_diff +
+        references.min_voltage_uv);
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::analog
@@ -0,0 +1,194 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_analog/sampled_input.h"
+
+#include <array>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_containers/vector.h"
+
+namespace pw {
+namespace analog {
+namespace {
+
+constexpr int32_t kLimitsMax = 4096;
+constexpr int32_t kLimitsMin = 0;
+
+// Fake sampled input that fills blocks with consecutive values when Fill() is
+// called, as a DMA controller would.
+class TestSampledInput : public SampledInput {
+ public:
+  void Fill() {
+    span<int32_t> block = buffer_.subspan(next_block_ * buffer_.size() / 2,
+                                          buffer_.size() / 2);
+    for (int32_t& sample : block) {
+      sample = next_sample_++;
+    }
+    const size_t index = next_block_;
+    next_block_ ^= 1;
+    BlockComplete(index);
+  }
+
+  Limits GetLimits() const override {
+    return {.min = kLimitsMin, .max = kLimitsMax};
+  }
+
+  uint32_t sample_rate_hz = 0;
+  bool stopped = false;
+  int blocks = 0;
+
+ private:
+  Status DoStart(uint32_t rate_hz, span<int32_t> buffer) override {
+    sample_rate_hz = rate_hz;
+    buffer_ = buffer;
+    next_block_ = 0;
+    return OkStatus();
+  }
+
+  Status DoStop() override {
+    stopped = true;
+    return OkStatus();
+  }
+
+  span<int32_t> buffer_;
+  size_t next_block_ = 0;
+  int32_t next_sample_ = 0;
+};
+
+TEST(SampledInputTest, InvalidConfig) {
+  TestSampledInput input;
+  std::array<int32_t, 8> buffer;
+  auto callback = [](span<int32_t>) {};
+  EXPECT_EQ(input.Start({.sample_rate_hz = 0, .block_size = 4}, buffer,
+                        callback),
+            Status::InvalidArgument());
+  EXPECT_EQ(input.Start({.sample_rate_hz = 1000, .block_size = 5}, buffer,
+                        callback),
+            Status::InvalidArgument());
+  EXPECT_EQ(input.Start({.sample_rate_hz = 1000,
+                         .block_size = 4,
+                         .decimation = 3},
+                        buffer,
+                        callback),
+            Status::InvalidArgument());
+  EXPECT_FALSE(input.running());
+}
+
+TEST(SampledInputTest, AlternatesBlocks) {
+  TestSampledInput input;
+  std::array<int32_t, 8> buffer;
+  Vector<int32_t, 12> received;
+  ASSERT_EQ(input.Start({.sample_rate_hz = 50000, .block_size = 4},
+                        buffer,
+                        [&received](span<int32_t> samples) {
+                          EXPECT_EQ(samples.size(), 4u);
+                          received.insert(
+                              received.end(), samples.begin(), samples.end());
+                        }),
+            OkStatus());
+  EXPECT_EQ(input.sample_rate_hz, 50000u);
+  EXPECT_EQ(input.Start({.sample_rate_hz = 50000, .block_size = 4},
+                        buffer,
+                        [](span<int32_t>) {}),
+            Status::FailedPrecondition());
+
+  input.Fill();
+  input.Fill();
+  input.Fill();
+  ASSERT_EQ(received.size(), 12u);
+  for (int32_t i = 0; i < 12; ++i) {
+    EXPECT_EQ(received[i], i);
+  }
+
+  EXPECT_EQ(input.Stop(), OkStatus());
+  EXPECT_TRUE(input.stopped);
+  EXPECT_FALSE(input.running());
+}
+
+TEST(SampledInputTest, Decimation) {
+  TestSampledInput input;
+  std::array<int32_t, 16> buffer;
+  Vector<int32_t, 4> received;
+  ASSERT_EQ(input.Start({.sample_rate_hz = 1000,
+                         .block_size = 8,
+                         .decimation = 4},
+                        buffer,
+                        [&received](span<int32_t> samples) {
+                          received.insert(
+                              received.end(), samples.begin(), samples.end());
+                        }),
+            OkStatus());
+  input.Fill();
+  input.Fill();
+  ASSERT_EQ(received.size(), 4u);
+  EXPECT_EQ(received[0], 1);  // (0 + 1 + 2 + 3) / 4
+  EXPECT_EQ(received[1], 5);
+  EXPECT_EQ(received[2], 9);
+  EXPECT_EQ(received[3], 13);
+}
+
+TEST(SampledInputTest, DropsBlocksWhileProcessing) {
+  TestSampledInput input;
+  std::array<int32_t, 4> buffer;
+  ASSERT_EQ(input.Start({.sample_rate_hz = 1000, .block_size = 2},
+                        buffer,
+                        [&input](span<int32_t>) {
+                          // Complete the next block while this one is still
+                          // being processed.
+                          input.blocks += 1;
+                          if (input.blocks == 1) {
+                            input.Fill();
+                          }
+                        }),
+            OkStatus());
+  input.Fill();
+  EXPECT_EQ(input.blocks, 1);
+  EXPECT_EQ(input.dropped_blocks(), 1u);
+
+  input.Fill();
+  EXPECT_EQ(input.blocks, 2);
+  EXPECT_EQ(input.dropped_blocks(), 1u);
+}
+
+TEST(SampledInputTest, ConvertToMicrovolts) {
+  std::array<int32_t, 3> samples = {kLimitsMin, kLimitsMax / 2, kLimitsMax};
+  ASSERT_EQ(ConvertToMicrovolts(samples,
+                                {.min = kLimitsMin, .max = kLimitsMax},
+                                {.max_voltage_uv = 1800000,
+                                 .min_voltage_uv = -1800000}),
+            OkStatus());
+  EXPECT_EQ(samples[0], -1800000);
+  EXPECT_EQ(samples[1], 0);
+  EXPECT_EQ(samples[2], 1800000);
+}
+
+TEST(SampledInputTest, ConvertToMicrovoltsInvalidReferences) {
+  std::array<int32_t, 1> samples = {0};
+  EXPECT_EQ(ConvertToMicrovolts(samples,
+                                {.min = kLimitsMin, .max = kLimitsMax},
+                                {.max_voltage_uv =
+                                     std::numeric_limits<int32_t>::max(),
+                                 .min_voltage_uv = -1}),
+            Status::Internal());
+  EXPECT_EQ(ConvertToMicrovolts(samples,
+                                {.min = kLimitsMax, .max = kLimitsMax},
+                                {.max_voltage_uv = 1, .min_voltage_uv = 0}),
+            Status::InvalidArgument());
+}
+
+}  // namespace
+}  // namespace analog
+}  // namespace pw
@@ -0,0 +1,88 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <cstdint>
+
+#include "pw_assert_tokenized/config.h"
+#include "pw_assert_tokenized/crash_record.h"
+#include "pw_assert_tokenized/handler.h"
+#include "pw_preprocessor/compiler.h"
+
+namespace pw::assert_tokenized {
+namespace {
+
+PW_KEEP_IN_SECTION(PW_ASSERT_TOKENIZED_CRASH_RECORD_SECTION)
+persistent_ram::Persistent<CrashRecord> persistent_crash_record;
+
+// The handlers pass their own return address, which is in the failed assert's
+// caller.
+[[noreturn]] void RecordAndCrash(CrashRecord::Kind kind,
+                                 uint32_t token,
+                                 int line_number,
+                                 const void* return_address,
+                                 uint32_t value_count = 0,
+                                 uint32_t value_a = 0,
+                                 uint32_t value_b = 0) {
+  persistent_crash_record.emplace(CrashRecord{
+      kind,
+      token,
+      line_number,
+      value_count,
+      static_cast<uint64_t>(reinterpret_cast<uintptr_t>(return_address)),
+      {value_a, value_b},
+  });
+  PW_ASSERT_TOKENIZED_CRASH_RECORD_ACTION();
+  PW_UNREACHABLE;
+}
+
+}  // namespace
+
+persistent_ram::Persistent<CrashRecord>& crash_record() {
+  return persistent_crash_record;
+}
+
+}  // namespace pw::assert_tokenized
+
+using pw::assert_tokenized::CrashRecord;
+using pw::assert_tokenized::RecordAndCrash;
+
+extern "C" void pw_assert_tokenized_HandleAssertFailure(
+    uint32_t tokenized_file_name, int line_number) {
+  RecordAndCrash(CrashRecord::Kind::kAssert,
+                 tokenized_file_name,
+                 line_number,
+                 __builtin_return_address(0));
+}
+
+extern "C" void pw_assert_tokenized_HandleCheckFailure(
+    uint32_t tokenized_message, int line_number) {
+  RecordAndCrash(CrashRecord::Kind::kCheck,
+                 tokenized_message,
+                 line_number,
+                 __builtin_return_address(0));
+}
+
+extern "C" void pw_assert_tokenized_HandleCheckFailureWithValues(
+    uint32_t tokenized_message,
+    int line_number,
+    uint32_t value_a,
+    uint32_t value_b) {
+  RecordAndCrash(CrashRecord::Kind::kCheck,
+                 tokenized_message,
+                 line_number,
+                 __builtin_return_address(0),
+                 2,
+                 value_a,
+                 value_b);
+}
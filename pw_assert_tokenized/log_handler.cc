@@ -76,3 +76,13 @@ extern "C" void pw_assert_tokenized_HandleCheckFailure(
       token_buffer.size());
   PW_UNREACHABLE;
 }
+
+extern "C" void pw_assert_tokenized_HandleCheckFailureWithValues(
+    uint32_t tokenized_message,
+    int line_number,
+    uint32_t /* value_a */,
+    uint32_t /* value_b */) {
+  // The message has no arguments to decode the values with, so only the
+  // message is logged.
+  pw_assert_tokenized_HandleCheckFailure(tokenized_message, line_number);
+}
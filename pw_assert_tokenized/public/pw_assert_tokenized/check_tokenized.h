@@ -13,6 +13,17 @@
 // the License.
 #pragma once
 
+#ifdef __cplusplus
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#else
+#include <stdint.h>
+#include <string.h>
+#endif  // __cplusplus
+
+#include "pw_assert/config.h"
+#include "pw_assert_tokenized/config.h"
 #include "pw_assert_tokenized/handler.h"
 #include "pw_log_tokenized/config.h"
 #include "pw_tokenizer/tokenize.h"
@@ -29,6 +40,77 @@
 #define PW_HANDLE_ASSERT_FAILURE(condition_string, message, ...) \
   _PW_ASSERT_TOKENIZED_TO_HANDLER(condition_string ", " message)
 
+#if PW_ASSERT_CAPTURE_VALUES && PW_ASSERT_TOKENIZED_CAPTURE_VALUES
+
+// The compared values are ints, unsigned ints, pointers, or floats. Floats are
+// passed as their bits rather than converted.
+#ifdef __cplusplus
+
+namespace pw::assert_tokenized::internal {
+
+template <typename T>
+uint32_t ValueBits(T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    const float as_float = static_cast<float>(value);
+    uint32_t bits;
+    std::memcpy(&bits, &as_float, sizeof(bits));
+    return bits;
+  } else if constexpr (std::is_pointer_v<T>) {
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value));
+  } else {
+    return static_cast<uint32_t>(value);
+  }
+}
+
+}  // namespace pw::assert_tokenized::internal
+
+#define _PW_ASSERT_TOKENIZED_VALUE(value) \
+  ::pw::assert_tokenized::internal::ValueBits(value)
+
+#else
+
+static inline uint32_t _pw_assert_tokenized_FloatBits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// The inner _Generic keeps the float branch valid when value is a pointer.
+#define _PW_ASSERT_TOKENIZED_VALUE(value)                                 \
+  _Generic((value),                                                       \
+      float: _pw_assert_tokenized_FloatBits(                              \
+               _Generic((value), float: (value), default: 0.0f)),         \
+      default: (uint32_t)(uintptr_t)(value))
+
+#endif  // __cplusplus
+
+#define _PW_ASSERT_TOKENIZED_TO_HANDLER_WITH_VALUES(str, value_a, value_b) \
+  do {                                                                     \
+    const uint32_t token = PW_TOKENIZE_STRING(                             \
+        PW_LOG_TOKENIZED_FORMAT_STRING("Check failure: " str));            \
+    pw_assert_tokenized_HandleCheckFailureWithValues(                      \
+        token,                                                             \
+        __LINE__,                                                          \
+        _PW_ASSERT_TOKENIZED_VALUE(value_a),                               \
+        _PW_ASSERT_TOKENIZED_VALUE(value_b));                              \
+  } while (0)
+
+#define PW_HANDLE_ASSERT_BINARY_COMPARE_FAILURE(arg_a_str,             \
+                                                arg_a_val,             \
+                                                comparison_op_str,     \
+                                                arg_b_str,             \
+                                                arg_b_val,             \
+                                                type_fmt,              \
+                                                message,               \
+                                                ...)                   \
+  _PW_ASSERT_TOKENIZED_TO_HANDLER_WITH_VALUES(                         \
+      arg_a_str " " comparison_op_str " " arg_b_str ", " message       \
+          #__VA_ARGS__,                                                \
+      arg_a_val,                                                       \
+      arg_b_val)
+
+#else
+
 #define PW_HANDLE_ASSERT_BINARY_COMPARE_FAILURE(arg_a_str,         \
                                                 arg_a_val,         \
                                                 comparison_op_str, \
@@ -39,3 +121,5 @@
                                                 ...)               \
   _PW_ASSERT_TOKENIZED_TO_HANDLER(                                 \
       arg_a_str " " comparison_op_str " " arg_b_str ", " message #__VA_ARGS__)
+
+#endif  // PW_ASSERT_CAPTURE_VALUES && PW_ASSERT_TOKENIZED_CAPTURE_VALUES
@@ -0,0 +1,35 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Whether failed PW_CHECK_*() comparisons pass the two compared values to
+// pw_assert_tokenized_HandleCheckFailureWithValues(). The values are usually in
+// registers already, but this may add a few instructions to every comparison
+// call site. Has no effect if PW_ASSERT_CAPTURE_VALUES is disabled.
+#ifndef PW_ASSERT_TOKENIZED_CAPTURE_VALUES
+#define PW_ASSERT_TOKENIZED_CAPTURE_VALUES 0
+#endif  // PW_ASSERT_TOKENIZED_CAPTURE_VALUES
+
+// The linker section of the crash record handler's persistent record. The
+// section must not be initialized or cleared at boot.
+#ifndef PW_ASSERT_TOKENIZED_CRASH_RECORD_SECTION
+#define PW_ASSERT_TOKENIZED_CRASH_RECORD_SECTION ".noinit"
+#endif  // PW_ASSERT_TOKENIZED_CRASH_RECORD_SECTION
+
+// What the crash record handler does after storing the record. The default
+// executes an undefined instruction, which enters the CPU exception handler,
+// so the failure is captured by the same snapshot path as a fault.
+#ifndef PW_ASSERT_TOKENIZED_CRASH_RECORD_ACTION
+#define PW_ASSERT_TOKENIZED_CRASH_RECORD_ACTION() __builtin_trap()
+#endif  // PW_ASSERT_TOKENIZED_CRASH_RECORD_ACTION
@@ -0,0 +1,52 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_persistent_ram/persistent.h"
+
+namespace pw::assert_tokenized {
+
+/// An assert failure, as stored by the crash record handler.
+struct CrashRecord {
+  enum class Kind : uint32_t {
+    /// `PW_ASSERT()`. The token is of the file name.
+    kAssert = 0,
+    /// `PW_CHECK*()` or `PW_CRASH()`. The token is of the message.
+    kCheck = 1,
+  };
+
+  static constexpr size_t kMaxValues = 2;
+
+  Kind kind;
+  uint32_t token;
+  int32_t line;
+  /// The number of values of `values` that were captured.
+  uint32_t value_count;
+  /// The return address of the handler call, just after the failed assert.
+  uint64_t pc;
+  /// The raw bits of the compared values of a failed `PW_CHECK_*()`, if
+  /// `PW_ASSERT_TOKENIZED_CAPTURE_VALUES` is enabled.
+  std::array<uint32_t, kMaxValues> values;
+};
+
+/// Returns the record of the last assert failure in persistent RAM. After a
+/// reboot, `has_value()` is true if the crash record handler stored a failure;
+/// add it to the crash snapshot, then `Invalidate()` it.
+persistent_ram::Persistent<CrashRecord>& crash_record();
+
+}  // namespace pw::assert_tokenized
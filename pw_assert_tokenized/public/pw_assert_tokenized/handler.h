@@ -26,4 +26,13 @@ PW_NO_RETURN void pw_assert_tokenized_HandleAssertFailure(
 PW_NO_RETURN void pw_assert_tokenized_HandleCheckFailure(
     uint32_t tokenized_message, int line_number);
 
+// Called instead of pw_assert_tokenized_HandleCheckFailure() for failed
+// PW_CHECK_*() comparisons if PW_ASSERT_TOKENIZED_CAPTURE_VALUES is enabled.
+// The values are the raw bits of the compared values, truncated to 32 bits.
+PW_NO_RETURN void pw_assert_tokenized_HandleCheckFailureWithValues(
+    uint32_t tokenized_message,
+    int line_number,
+    uint32_t value_a,
+    uint32_t value_b);
+
 PW_EXTERN_C_END
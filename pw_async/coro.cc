@@ -0,0 +1,47 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async/coro.h"
+
+namespace pw::async::internal {
+namespace {
+
+// Each frame is preceded by a pointer to the pool it came from, so that the
+// promise's operator delete, which only receives the frame, can free it.
+// The header is padded to keep the frame maximally aligned.
+constexpr size_t kHeaderSize =
+    (sizeof(allocator::BlockPool*) + alignof(std::max_align_t) - 1) /
+    alignof(std::max_align_t) * alignof(std::max_align_t);
+
+}  // namespace
+
+void* AllocateCoroFrame(allocator::BlockPool& frames, size_t size) {
+  if (frames.block_size() < kHeaderSize ||
+      size > frames.block_size() - kHeaderSize) {
+    return nullptr;
+  }
+  auto* block = static_cast<std::byte*>(frames.Allocate());
+  if (block == nullptr) {
+    return nullptr;
+  }
+  *reinterpret_cast<allocator::BlockPool**>(block) = &frames;
+  return block + kHeaderSize;
+}
+
+void FreeCoroFrame(void* frame) {
+  auto* block = static_cast<std::byte*>(frame) - kHeaderSize;
+  (*reinterpret_cast<allocator::BlockPool**>(block))->Free(block);
+}
+
+}  // namespace pw::async::internal
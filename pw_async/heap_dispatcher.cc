@@ -14,53 +14,81 @@
 
 #include "pw_async/heap_dispatcher.h"
 
+#include <new>
+
 #include "pw_async/task.h"
-#include "pw_result/result.h"
 
 namespace pw::async {
 
-namespace {
-
 // TODO(b/277793223): Optimize to avoid double virtual indirection and double
 // allocation.  In situations in which pw::Function is large enough and the
 // captures are small enough, we could eliminate this by reshaping the task as
 // just a pw::Function.
-struct TaskAndFunction {
-  static Result<TaskAndFunction*> New(TaskFunction&& task) {
+HeapDispatcher::TaskAndFunction* HeapDispatcher::Allocate() {
+  void* storage = nullptr;
+  if (pool_ != nullptr) {
+    storage = pool_->Allocate();
+    if (storage == nullptr && exhaustion_ == PoolExhaustion::kFail) {
+      return nullptr;
+    }
+  }
+  if (storage == nullptr) {
     // std::nothrow causes new to return a nullptr on failure instead of
     // throwing.
-    TaskAndFunction* t = new (std::nothrow) TaskAndFunction();
-    if (!t) {
-      return Status::ResourceExhausted();
+    storage = ::operator new(sizeof(TaskAndFunction), std::nothrow);
+    if (storage == nullptr) {
+      return nullptr;
     }
-    t->func = std::move(task);
-
-    // Closure captures must not include references, as that would be UB due to
-    // the `delete` at the end of the function. See
-    // https://reviews.llvm.org/D48239.
-    t->task.set_function([t](Context& ctx, Status status) {
-      t->func(ctx, status);
+    heap_allocations_.fetch_add(1, std::memory_order_relaxed);
+  }
 
-      // Delete must appear at the very end of this closure to avoid
-      // use-after-free of captures or Context.task.
-      delete t;
-    });
+  const uint32_t outstanding =
+      outstanding_.fetch_add(1, std::memory_order_relaxed) + 1;
+  uint32_t peak = peak_outstanding_.load(std::memory_order_relaxed);
+  while (outstanding > peak &&
+         !peak_outstanding_.compare_exchange_weak(
+             peak, outstanding, std::memory_order_relaxed)) {
+  }
+  return new (storage) TaskAndFunction(*this);
+}
 
-    return t;
+void HeapDispatcher::Release(TaskAndFunction* task) {
+  task->~TaskAndFunction();
+  if (pool_ != nullptr && pool_->Contains(task)) {
+    pool_->Free(task);
+  } else {
+    ::operator delete(task);
   }
-  Task task;
-  TaskFunction func;
-};
-}  // namespace
+  outstanding_.fetch_sub(1, std::memory_order_relaxed);
+}
 
 Status HeapDispatcher::PostAt(TaskFunction&& task_func,
                               chrono::SystemClock::time_point time) {
-  Result<TaskAndFunction*> result = TaskAndFunction::New(std::move(task_func));
-  if (!result.ok()) {
-    return result.status();
+  TaskAndFunction* t = Allocate();
+  if (t == nullptr) {
+    return Status::ResourceExhausted();
   }
-  dispatcher_.PostAt((*result)->task, time);
+  t->func = std::move(task_func);
+
+  // Closure captures must not include references, as that would be UB due to
+  // the release at the end of the function. See
+  // https://reviews.llvm.org/D48239.
+  t->task.set_function([t](Context& ctx, Status status) {
+    t->func(ctx, status);
+
+    // Release must appear at the very end of this closure to avoid
+    // use-after-free of captures or Context.task.
+    t->dispatcher.Release(t);
+  });
+
+  dispatcher_.PostAt(t->task, time);
   return Status();
 }
 
+void HeapDispatcher::UpdateMetrics() {
+  outstanding_metric_.Set(outstanding_tasks());
+  peak_outstanding_metric_.Set(peak_outstanding_tasks());
+  heap_allocations_metric_.Set(heap_allocations());
+}
+
 }  // namespace pw::async
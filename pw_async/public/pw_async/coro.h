@@ -0,0 +1,367 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "pw_allocator/block_pool.h"
+#include "pw_assert/assert.h"
+#include "pw_async/dispatcher.h"
+#include "pw_async/task.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_status/status.h"
+#include "pw_sync/thread_notification.h"
+
+namespace pw::async {
+
+template <typename T>
+class Coro;
+
+/// Awaitable that resumes a coroutine on a `Dispatcher` at a given time.
+///
+/// `co_await` yields `OK`, or `CANCELLED` if the dispatcher cancelled the
+/// wake-up task.
+class SleepAwaitable {
+ public:
+  SleepAwaitable(Dispatcher& dispatcher,
+                 chrono::SystemClock::time_point wake_time)
+      : dispatcher_(dispatcher),
+        wake_time_(wake_time),
+        task_([this](Context&, Status status) {
+          status_ = status;
+          waiter_.resume();
+        }) {}
+
+  SleepAwaitable(const SleepAwaitable&) = delete;
+  SleepAwaitable& operator=(const SleepAwaitable&) = delete;
+
+  ~SleepAwaitable() { dispatcher_.Cancel(task_); }
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> waiter) {
+    waiter_ = waiter;
+    dispatcher_.PostAt(task_, wake_time_);
+  }
+  Status await_resume() const noexcept { return status_; }
+
+ private:
+  Dispatcher& dispatcher_;
+  chrono::SystemClock::time_point wake_time_;
+  std::coroutine_handle<> waiter_;
+  Status status_;
+  Task task_;
+};
+
+/// Awaitable that resumes a coroutine once a `sync::ThreadNotification` is
+/// released.
+///
+/// `ThreadNotification` has no hook to wake a dispatcher, so the notification
+/// is polled with `try_acquire()` from a dispatcher task every
+/// `poll_interval`. No thread blocks while waiting. `co_await` yields `OK`
+/// once the notification was acquired, or `CANCELLED` if the dispatcher
+/// cancelled the polling task.
+class NotificationAwaitable {
+ public:
+  NotificationAwaitable(Dispatcher& dispatcher,
+                        sync::ThreadNotification& notification,
+                        chrono::SystemClock::duration poll_interval)
+      : dispatcher_(dispatcher),
+        notification_(notification),
+        poll_interval_(poll_interval),
+        task_([this](Context&, Status status) { Poll(status); }) {}
+
+  NotificationAwaitable(const NotificationAwaitable&) = delete;
+  NotificationAwaitable& operator=(const NotificationAwaitable&) = delete;
+
+  ~NotificationAwaitable() { dispatcher_.Cancel(task_); }
+
+  bool await_ready() { return notification_.try_acquire(); }
+  void await_suspend(std::coroutine_handle<> waiter) {
+    waiter_ = waiter;
+    dispatcher_.PostAfter(task_, poll_interval_);
+  }
+  Status await_resume() const noexcept { return status_; }
+
+ private:
+  void Poll(Status status) {
+    if (status.ok() && !notification_.try_acquire()) {
+      dispatcher_.PostAfter(task_, poll_interval_);
+      return;
+    }
+    status_ = status;
+    waiter_.resume();
+  }
+
+  Dispatcher& dispatcher_;
+  sync::ThreadNotification& notification_;
+  chrono::SystemClock::duration poll_interval_;
+  std::coroutine_handle<> waiter_;
+  Status status_;
+  Task task_;
+};
+
+/// Runs `Coro` coroutines on a `Dispatcher`, allocating their frames from a
+/// `pw::allocator::BlockPool`.
+///
+/// Every coroutine function takes a `CoroContext&` as its first parameter; the
+/// frame is allocated from that context's pool. The pool's blocks must be
+/// large enough for the largest coroutine frame plus a pointer-sized header.
+/// The pool is not locked, so coroutines sharing a context must be created on
+/// one thread, normally the dispatcher's.
+///
+/// @code{.cpp}
+///   pw::async::Coro<pw::Status> EraseThenWrite(pw::async::CoroContext& ctx,
+///                                              Flash& flash) {
+///     PW_CO_TRY(flash.StartErase());
+///     PW_CO_TRY(co_await ctx.SleepFor(kEraseTime));
+///     co_return flash.Write(data);
+///   }
+///
+///   ctx.Spawn(EraseThenWrite(ctx, flash));
+/// @endcode
+class CoroContext {
+ public:
+  CoroContext(Dispatcher& dispatcher, allocator::BlockPool& frames)
+      : dispatcher_(dispatcher), frames_(frames) {}
+
+  CoroContext(const CoroContext&) = delete;
+  CoroContext& operator=(const CoroContext&) = delete;
+
+  Dispatcher& dispatcher() const { return dispatcher_; }
+  allocator::BlockPool& frames() const { return frames_; }
+
+  /// Starts `coro` from a dispatcher task and runs it to completion, freeing
+  /// its frame when it returns. The result is discarded. If the dispatcher
+  /// cancels the starting task, the coroutine is destroyed without running.
+  ///
+  /// @returns `RESOURCE_EXHAUSTED` if the coroutine's frame could not be
+  /// allocated.
+  template <typename T>
+  Status Spawn(Coro<T>&& coro);
+
+  /// Returns an awaitable that resumes the coroutine after `delay`.
+  SleepAwaitable SleepFor(chrono::SystemClock::duration delay) {
+    return SleepAwaitable(dispatcher_, dispatcher_.now() + delay);
+  }
+
+  /// Returns an awaitable that resumes the coroutine at `wake_time`.
+  SleepAwaitable SleepUntil(chrono::SystemClock::time_point wake_time) {
+    return SleepAwaitable(dispatcher_, wake_time);
+  }
+
+  /// Returns an awaitable that resumes the coroutine once `notification` is
+  /// released, checking it every `poll_interval`.
+  NotificationAwaitable WaitFor(sync::ThreadNotification& notification,
+                                chrono::SystemClock::duration poll_interval) {
+    return NotificationAwaitable(dispatcher_, notification, poll_interval);
+  }
+
+ private:
+  Dispatcher& dispatcher_;
+  allocator::BlockPool& frames_;
+};
+
+namespace internal {
+
+/// Allocates a coroutine frame of `size` bytes from `frames`, or returns
+/// nullptr if the pool is exhausted or its blocks are too small.
+void* AllocateCoroFrame(allocator::BlockPool& frames, size_t size);
+
+/// Frees a frame returned by `AllocateCoroFrame`.
+void FreeCoroFrame(void* frame);
+
+// Promise state shared by all `Coro` result types.
+class CoroPromiseBase {
+ public:
+  // Frames come from the pool of the `CoroContext` passed as the coroutine's
+  // first argument. Coroutines without one fail to compile.
+  template <typename... Args>
+  static void* operator new(size_t size,
+                            CoroContext& context,
+                            Args&&...) noexcept {
+    return AllocateCoroFrame(context.frames(), size);
+  }
+  static void* operator new(size_t) = delete;
+  static void operator delete(void* frame) noexcept { FreeCoroFrame(frame); }
+
+  // Resumes the awaiting coroutine, if any, when this one returns. Detached
+  // coroutines free their own frame.
+  class FinalAwaiter {
+   public:
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<Promise> handle) noexcept {
+      CoroPromiseBase& promise = handle.promise();
+      if (promise.continuation_) {
+        return promise.continuation_;
+      }
+      if (promise.detached_) {
+        handle.destroy();
+      }
+      return std::noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+  };
+
+  CoroPromiseBase()
+      : start_task_([this](Context&, Status status) {
+          if (status.ok()) {
+            self_.resume();
+          } else {
+            self_.destroy();
+          }
+        }) {}
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+  void unhandled_exception() const { PW_ASSERT(false); }
+
+  void set_continuation(std::coroutine_handle<> continuation) {
+    continuation_ = continuation;
+  }
+
+  // Hands ownership of the frame to the coroutine and starts it from a task.
+  void Detach(Dispatcher& dispatcher) {
+    detached_ = true;
+    dispatcher.Post(start_task_);
+  }
+
+ protected:
+  void set_self(std::coroutine_handle<> self) { self_ = self; }
+
+ private:
+  std::coroutine_handle<> self_;
+  std::coroutine_handle<> continuation_;
+  bool detached_ = false;
+  Task start_task_;
+};
+
+template <typename T>
+class CoroPromise final : public CoroPromiseBase {
+ public:
+  Coro<T> get_return_object() noexcept {
+    auto handle = std::coroutine_handle<CoroPromise>::from_promise(*this);
+    set_self(handle);
+    return Coro<T>(handle);
+  }
+
+  static Coro<T> get_return_object_on_allocation_failure() noexcept {
+    return Coro<T>();
+  }
+
+  void return_value(T value) { result_ = std::move(value); }
+
+  T& result() { return result_; }
+
+ private:
+  T result_ = T(Status::Unknown());
+};
+
+}  // namespace internal
+
+/// A coroutine returning `T` that runs on a `Dispatcher`.
+///
+/// `T` must be constructible from a `Status`, e.g. `Status` or `Result<U>`.
+/// Coroutines start suspended. A `Coro` is either awaited from another
+/// coroutine with `co_await`, which runs it inline and yields its result, or
+/// started with `CoroContext::Spawn`.
+///
+/// If the frame could not be allocated, the `Coro` is not `ok()`, and awaiting
+/// it yields `RESOURCE_EXHAUSTED`.
+template <typename T>
+class [[nodiscard]] Coro {
+ public:
+  static_assert(std::is_constructible_v<T, Status>,
+                "Coro results must be constructible from a Status");
+
+  using promise_type = internal::CoroPromise<T>;
+
+  /// Creates a `Coro` without a frame.
+  Coro() = default;
+
+  Coro(const Coro&) = delete;
+  Coro& operator=(const Coro&) = delete;
+
+  Coro(Coro&& other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  Coro& operator=(Coro&& other) noexcept {
+    Destroy();
+    handle_ = std::exchange(other.handle_, nullptr);
+    return *this;
+  }
+
+  ~Coro() { Destroy(); }
+
+  /// True if the coroutine's frame was allocated.
+  bool ok() const { return static_cast<bool>(handle_); }
+
+  class Awaiter {
+   public:
+    explicit Awaiter(std::coroutine_handle<promise_type> handle)
+        : handle_(handle) {}
+
+    bool await_ready() const noexcept { return !handle_; }
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<> waiter) noexcept {
+      handle_.promise().set_continuation(waiter);
+      return handle_;
+    }
+    T await_resume() {
+      if (!handle_) {
+        return T(Status::ResourceExhausted());
+      }
+      return std::move(handle_.promise().result());
+    }
+
+   private:
+    std::coroutine_handle<promise_type> handle_;
+  };
+
+  /// Runs the coroutine until it returns, then yields its result.
+  Awaiter operator co_await() && { return Awaiter(handle_); }
+
+ private:
+  friend promise_type;
+  friend class CoroContext;
+
+  explicit Coro(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> Release() {
+    return std::exchange(handle_, nullptr);
+  }
+
+  void Destroy() {
+    if (handle_) {
+      handle_.destroy();
+      handle_ = nullptr;
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename T>
+Status CoroContext::Spawn(Coro<T>&& coro) {
+  if (!coro.ok()) {
+    return Status::ResourceExhausted();
+  }
+  coro.Release().promise().Detach(dispatcher_);
+  return OkStatus();
+}
+
+}  // namespace pw::async
@@ -0,0 +1,271 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+#include "pw_async/coro.h"
+#include "pw_async/dispatcher.h"
+#include "pw_async/task.h"
+#include "pw_containers/inline_queue.h"
+#include "pw_function/function.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::async {
+namespace internal {
+
+// Resumes a suspended coroutine from a dispatcher task once an event has
+// arrived. Events may arrive on any thread, before or after the coroutine
+// suspends.
+class CoroWaker {
+ public:
+  explicit CoroWaker(Dispatcher& dispatcher)
+      : dispatcher_(dispatcher),
+        task_([this](Context&, Status status) { Wake(status); }) {}
+
+  CoroWaker(const CoroWaker&) = delete;
+  CoroWaker& operator=(const CoroWaker&) = delete;
+
+  ~CoroWaker() { dispatcher_.Cancel(task_); }
+
+  // Records `waiter` unless an event is already pending, in which case the
+  // caller must not suspend.
+  bool Suspend(std::coroutine_handle<> waiter) PW_LOCKS_EXCLUDED(lock_) {
+    std::lock_guard lock(lock_);
+    if (pending_) {
+      return false;
+    }
+    waiter_ = waiter;
+    return true;
+  }
+
+  // Posts the waiting coroutine, if any, to be resumed.
+  void Notify() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    pending_ = true;
+    if (waiter_) {
+      dispatcher_.Post(task_);
+    }
+  }
+
+  // Clears the pending event once the coroutine has consumed it.
+  void Consume() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_) { pending_ = false; }
+
+  bool pending() const PW_EXCLUSIVE_LOCKS_REQUIRED(lock_) { return pending_; }
+
+  // Guards the owner's event state as well as the waker's.
+  sync::InterruptSpinLock& lock() PW_LOCK_RETURNED(lock_) { return lock_; }
+
+  // Status of the last wake-up task; `CANCELLED` if the dispatcher dropped it.
+  Status wake_status() const { return wake_status_; }
+
+ private:
+  void Wake(Status status) {
+    wake_status_ = status;
+    std::coroutine_handle<> waiter;
+    {
+      std::lock_guard lock(lock_);
+      waiter = std::exchange(waiter_, nullptr);
+    }
+    if (waiter) {
+      waiter.resume();
+    }
+  }
+
+  Dispatcher& dispatcher_;
+  Task task_;
+  sync::InterruptSpinLock lock_;
+  std::coroutine_handle<> waiter_ PW_GUARDED_BY(lock_);
+  bool pending_ PW_GUARDED_BY(lock_) = false;
+  Status wake_status_;
+};
+
+}  // namespace internal
+
+/// Awaitable result of a unary or client streaming RPC.
+///
+/// Pass `OnCompleted()` and `OnError()` as the call's callbacks, then
+/// `co_await` the `RpcResponse` to get the response. The callbacks may run on
+/// any thread; the coroutine is resumed on the dispatcher. Declare the
+/// `RpcResponse` before the call object so the call, and with it the
+/// callbacks, is released first.
+///
+/// @code{.cpp}
+///   pw::async::RpcResponse<pwpb::Config::Message> response(ctx);
+///   auto call = client.GetConfig(request, response.OnCompleted(),
+///                                response.OnError());
+///   PW_CO_TRY_ASSIGN(pwpb::Config::Message config, co_await response);
+/// @endcode
+///
+/// `co_await` yields the response if the RPC completed with `OK`, and
+/// otherwise the error. Each `RpcResponse` receives one result.
+template <typename Response>
+class RpcResponse {
+ public:
+  explicit RpcResponse(CoroContext& context) : waker_(context.dispatcher()) {}
+
+  /// Returns an `on_completed` callback for the call.
+  Function<void(const Response&, Status)> OnCompleted() {
+    return [this](const Response& response, Status status) {
+      if (status.ok()) {
+        Complete(response);
+      } else {
+        Complete(status);
+      }
+    };
+  }
+
+  /// Returns an `on_error` callback for the call.
+  Function<void(Status)> OnError() {
+    return [this](Status status) { Complete(status); };
+  }
+
+  bool await_ready() {
+    std::lock_guard lock(waker_.lock());
+    return waker_.pending();
+  }
+  bool await_suspend(std::coroutine_handle<> waiter) {
+    return waker_.Suspend(waiter);
+  }
+  Result<Response> await_resume() {
+    if (!waker_.wake_status().ok()) {
+      return waker_.wake_status();
+    }
+    std::lock_guard lock(waker_.lock());
+    return std::move(result_);
+  }
+
+ private:
+  void Complete(Result<Response> result) {
+    std::lock_guard lock(waker_.lock());
+    if (waker_.pending()) {
+      return;
+    }
+    result_ = std::move(result);
+    waker_.Notify();
+  }
+
+  internal::CoroWaker waker_;
+  Result<Response> result_;
+};
+
+/// Awaitable sequence of responses from a server or bidirectional streaming
+/// RPC.
+///
+/// Pass `OnNext()`, `OnCompleted()` and `OnError()` as the call's callbacks.
+/// Each `co_await` yields the next response, queued in order. Once the stream
+/// has ended and every response has been read, it yields `OUT_OF_RANGE` if the
+/// RPC completed with `OK`, or the RPC's error otherwise.
+///
+/// Up to `kCapacity` responses are buffered. Responses that arrive while the
+/// buffer is full are dropped and counted by `dropped()`.
+///
+/// @code{.cpp}
+///   pw::async::RpcStream<pwpb::LogEntry::Message, 4> logs(ctx);
+///   auto call = client.Listen(request, logs.OnNext(), logs.OnCompleted(),
+///                             logs.OnError());
+///   while (true) {
+///     pw::Result<pwpb::LogEntry::Message> entry = co_await logs;
+///     if (!entry.ok()) {
+///       break;
+///     }
+///     Print(*entry);
+///   }
+/// @endcode
+template <typename Response, size_t kCapacity>
+class RpcStream {
+ public:
+  explicit RpcStream(CoroContext& context) : waker_(context.dispatcher()) {}
+
+  /// Returns an `on_next` callback for the call.
+  Function<void(const Response&)> OnNext() {
+    return [this](const Response& response) { Push(response); };
+  }
+
+  /// Returns an `on_completed` callback for the call.
+  Function<void(Status)> OnCompleted() {
+    return [this](Status status) { Finish(status.ok() ? Status::OutOfRange()
+                                                      : status); };
+  }
+
+  /// Returns an `on_error` callback for the call.
+  Function<void(Status)> OnError() {
+    return [this](Status status) { Finish(status); };
+  }
+
+  /// Number of responses dropped because the buffer was full.
+  size_t dropped() {
+    std::lock_guard lock(waker_.lock());
+    return dropped_;
+  }
+
+  bool await_ready() {
+    std::lock_guard lock(waker_.lock());
+    return waker_.pending();
+  }
+  bool await_suspend(std::coroutine_handle<> waiter) {
+    return waker_.Suspend(waiter);
+  }
+  Result<Response> await_resume() {
+    if (!waker_.wake_status().ok()) {
+      return waker_.wake_status();
+    }
+    std::lock_guard lock(waker_.lock());
+    if (responses_.empty()) {
+      return final_status_;
+    }
+    Result<Response> response(std::move(responses_.front()));
+    responses_.pop();
+    if (responses_.empty() && final_status_.ok()) {
+      waker_.Consume();
+    }
+    return response;
+  }
+
+ private:
+  void Push(const Response& response) {
+    std::lock_guard lock(waker_.lock());
+    if (!final_status_.ok()) {
+      return;
+    }
+    if (responses_.full()) {
+      dropped_ += 1;
+      return;
+    }
+    responses_.push(response);
+    waker_.Notify();
+  }
+
+  void Finish(Status status) {
+    std::lock_guard lock(waker_.lock());
+    if (!final_status_.ok()) {
+      return;
+    }
+    final_status_ = status;
+    waker_.Notify();
+  }
+
+  internal::CoroWaker waker_;
+  InlineQueue<Response, kCapacity> responses_;
+  // OK while the stream is open, otherwise the status to yield once drained.
+  Status final_status_;
+  size_t dropped_ = 0;
+};
+
+}  // namespace pw::async
@@ -13,16 +13,52 @@
 // the License.
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/block_pool.h"
 #include "pw_async/function_dispatcher.h"
+#include "pw_async/task.h"
+#include "pw_metric/metric.h"
 
 namespace pw::async {
 
 /// HeapDispatcher wraps an existing Dispatcher and allocates Task objects on
 /// the heap before posting them to the existing Dispatcher. After Tasks run,
 /// they are automatically freed.
+///
+/// To avoid heap churn, tasks may instead be allocated from a
+/// `pw::allocator::LockFreeBlockPool` with blocks of at least `kTaskSize`
+/// bytes, such as a `HeapDispatcher::TaskPool`. When the pool is exhausted,
+/// tasks are allocated from the heap, or posting fails with
+/// `RESOURCE_EXHAUSTED` if the dispatcher was created with
+/// `PoolExhaustion::kFail`.
+///
+/// @code{.cpp}
+///   pw::async::HeapDispatcher::TaskPool<16> task_pool;
+///   pw::async::HeapDispatcher dispatcher(basic_dispatcher, task_pool);
+/// @endcode
+///
+/// The dispatcher's metrics count outstanding tasks, the peak number of
+/// outstanding tasks, and the tasks allocated from the heap. Call
+/// `UpdateMetrics()` before dumping them. Tasks refer to the `HeapDispatcher`
+/// that posted them, so it must outlive them.
 class HeapDispatcher final : public FunctionDispatcher {
  public:
+  /// What to do when the task pool is exhausted.
+  enum class PoolExhaustion {
+    kUseHeap,  // Allocate the task from the heap.
+    kFail,     // Return RESOURCE_EXHAUSTED from Post*().
+  };
+
   HeapDispatcher(Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+  HeapDispatcher(Dispatcher& dispatcher,
+                 allocator::LockFreeBlockPool& task_pool,
+                 PoolExhaustion exhaustion = PoolExhaustion::kUseHeap)
+      : dispatcher_(dispatcher), pool_(&task_pool), exhaustion_(exhaustion) {}
+
   ~HeapDispatcher() override = default;
 
   // FunctionDispatcher overrides:
@@ -41,8 +77,63 @@ class HeapDispatcher final : public FunctionDispatcher {
     return dispatcher_.now();
   }
 
+  /// Returns the number of tasks posted that have not run yet.
+  uint32_t outstanding_tasks() const {
+    return outstanding_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the largest number of tasks that were outstanding at once.
+  uint32_t peak_outstanding_tasks() const {
+    return peak_outstanding_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the number of tasks allocated from the heap.
+  uint32_t heap_allocations() const {
+    return heap_allocations_.load(std::memory_order_relaxed);
+  }
+
+  /// Copies the dispatcher's counters into its metrics.
+  void UpdateMetrics();
+
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  struct TaskAndFunction {
+    explicit TaskAndFunction(HeapDispatcher& owner) : dispatcher(owner) {}
+
+    Task task;
+    TaskFunction func;
+    HeapDispatcher& dispatcher;
+  };
+
+  TaskAndFunction* Allocate();
+  void Release(TaskAndFunction* task);
+
+ public:
+  /// The size and alignment of the blocks of a task pool.
+  static constexpr size_t kTaskSize = sizeof(TaskAndFunction);
+  static constexpr size_t kTaskAlignment = alignof(TaskAndFunction);
+
+  /// A pool that holds `kTasks` tasks.
+  template <size_t kTasks>
+  using TaskPool =
+      allocator::FixedBytePool<kTaskSize, kTasks, true, kTaskAlignment>;
+
  private:
   Dispatcher& dispatcher_;
+  allocator::LockFreeBlockPool* const pool_ = nullptr;
+  const PoolExhaustion exhaustion_ = PoolExhaustion::kUseHeap;
+
+  // Tasks may be posted from any thread, and are freed on the dispatcher's
+  // thread.
+  std::atomic<uint32_t> outstanding_{0};
+  std::atomic<uint32_t> peak_outstanding_{0};
+  std::atomic<uint32_t> heap_allocations_{0};
+
+  PW_METRIC_GROUP(metrics_, "pw::async::HeapDispatcher");
+  PW_METRIC(metrics_, outstanding_metric_, "outstanding_tasks", 0u);
+  PW_METRIC(metrics_, peak_outstanding_metric_, "peak_outstanding_tasks", 0u);
+  PW_METRIC(metrics_, heap_allocations_metric_, "heap_allocations", 0u);
 };
 
 }  // namespace pw::async
@@ -0,0 +1,187 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async/coro.h"
+
+#include "gtest/gtest.h"
+#include "pw_allocator/block_pool.h"
+#include "pw_async/coro_rpc.h"
+#include "pw_async/fake_dispatcher_fixture.h"
+#include "pw_result/result.h"
+#include "pw_status/try.h"
+#include "pw_sync/thread_notification.h"
+
+using namespace std::chrono_literals;
+
+namespace pw::async {
+namespace {
+
+class CoroTest : public test::FakeDispatcherFixture {
+ protected:
+  CoroTest() : context_(dispatcher(), frames_) {}
+
+  allocator::FixedBytePool<512, 4> frames_;
+  CoroContext context_;
+};
+
+Coro<Result<int>> AddOne(CoroContext&, int value) { co_return value + 1; }
+
+Coro<Status> AddTwice(CoroContext& ctx, int value, int& out) {
+  Result<int> once = co_await AddOne(ctx, value);
+  if (!once.ok()) {
+    co_return once.status();
+  }
+  Result<int> twice = co_await AddOne(ctx, *once);
+  out = twice.value_or(-1);
+  co_return twice.status();
+}
+
+TEST_F(CoroTest, SpawnRunsOnDispatcher) {
+  int out = 0;
+  ASSERT_EQ(OkStatus(), context_.Spawn(AddTwice(context_, 1, out)));
+  EXPECT_EQ(out, 0);
+  RunUntilIdle();
+  EXPECT_EQ(out, 3);
+  EXPECT_EQ(frames_.available(), frames_.capacity());
+}
+
+TEST_F(CoroTest, SpawnFailsWhenFramesAreExhausted) {
+  int out = 0;
+  Coro<Status> held[4] = {AddTwice(context_, 0, out),
+                          AddTwice(context_, 0, out),
+                          AddTwice(context_, 0, out),
+                          AddTwice(context_, 0, out)};
+  Coro<Status> extra = AddTwice(context_, 0, out);
+  EXPECT_TRUE(held[3].ok());
+  EXPECT_FALSE(extra.ok());
+  EXPECT_EQ(Status::ResourceExhausted(), context_.Spawn(std::move(extra)));
+}
+
+TEST_F(CoroTest, AwaitingUnallocatedCoroYieldsResourceExhausted) {
+  int out = 0;
+  Coro<Status> held[3] = {AddTwice(context_, 0, out),
+                          AddTwice(context_, 0, out),
+                          AddTwice(context_, 0, out)};
+  // The fourth frame is AddTwice's own; AddOne's frame cannot be allocated.
+  ASSERT_EQ(OkStatus(), context_.Spawn(AddTwice(context_, 5, out)));
+  RunUntilIdle();
+  EXPECT_EQ(out, 0);
+  EXPECT_TRUE(held[0].ok());
+}
+
+Coro<Status> SleepTwice(CoroContext& ctx, int& wakes) {
+  PW_CO_TRY(co_await ctx.SleepFor(10ms));
+  ++wakes;
+  PW_CO_TRY(co_await ctx.SleepFor(10ms));
+  ++wakes;
+  co_return OkStatus();
+}
+
+TEST_F(CoroTest, SleepResumesAfterDelay) {
+  int wakes = 0;
+  ASSERT_EQ(OkStatus(), context_.Spawn(SleepTwice(context_, wakes)));
+  RunFor(5ms);
+  EXPECT_EQ(wakes, 0);
+  RunFor(10ms);
+  EXPECT_EQ(wakes, 1);
+  RunFor(10ms);
+  EXPECT_EQ(wakes, 2);
+  EXPECT_EQ(frames_.available(), frames_.capacity());
+}
+
+Coro<Status> WaitForNotification(CoroContext& ctx,
+                                 sync::ThreadNotification& notification,
+                                 bool& done) {
+  PW_CO_TRY(co_await ctx.WaitFor(notification, 1ms));
+  done = true;
+  co_return OkStatus();
+}
+
+TEST_F(CoroTest, WaitForResumesOnceNotificationIsReleased) {
+  sync::ThreadNotification notification;
+  bool done = false;
+  ASSERT_EQ(OkStatus(),
+            context_.Spawn(WaitForNotification(context_, notification, done)));
+  RunFor(10ms);
+  EXPECT_FALSE(done);
+  notification.release();
+  RunFor(2ms);
+  EXPECT_TRUE(done);
+}
+
+Coro<Status> AwaitResponse(CoroContext&,
+                           RpcResponse<int>& response,
+                           Result<int>& out) {
+  out = co_await response;
+  co_return out.status();
+}
+
+TEST_F(CoroTest, RpcResponseResumesWithResult) {
+  RpcResponse<int> response(context_);
+  Function<void(const int&, Status)> on_completed = response.OnCompleted();
+  Result<int> out = Status::Unknown();
+  ASSERT_EQ(OkStatus(),
+            context_.Spawn(AwaitResponse(context_, response, out)));
+  RunUntilIdle();
+  EXPECT_EQ(Status::Unknown(), out.status());
+
+  on_completed(42, OkStatus());
+  RunUntilIdle();
+  ASSERT_TRUE(out.ok());
+  EXPECT_EQ(*out, 42);
+}
+
+TEST_F(CoroTest, RpcResponseCompletedBeforeAwaitDoesNotSuspend) {
+  RpcResponse<int> response(context_);
+  response.OnError()(Status::Unavailable());
+  Result<int> out = Status::Unknown();
+  ASSERT_EQ(OkStatus(),
+            context_.Spawn(AwaitResponse(context_, response, out)));
+  RunUntilIdle();
+  EXPECT_EQ(Status::Unavailable(), out.status());
+}
+
+Coro<Status> SumStream(CoroContext&, RpcStream<int, 2>& stream, int& sum) {
+  while (true) {
+    Result<int> value = co_await stream;
+    if (!value.ok()) {
+      co_return value.status();
+    }
+    sum += *value;
+  }
+}
+
+TEST_F(CoroTest, RpcStreamYieldsResponsesThenEnd) {
+  RpcStream<int, 2> stream(context_);
+  Function<void(const int&)> on_next = stream.OnNext();
+  int sum = 0;
+  ASSERT_EQ(OkStatus(), context_.Spawn(SumStream(context_, stream, sum)));
+  RunUntilIdle();
+
+  on_next(1);
+  on_next(2);
+  on_next(4);  // Dropped: the buffer holds two responses.
+  RunUntilIdle();
+  EXPECT_EQ(sum, 3);
+  EXPECT_EQ(stream.dropped(), 1u);
+
+  on_next(8);
+  stream.OnCompleted()(OkStatus());
+  RunUntilIdle();
+  EXPECT_EQ(sum, 11);
+  EXPECT_EQ(frames_.available(), frames_.capacity());
+}
+
+}  // namespace
+}  // namespace pw::async
@@ -82,7 +82,7 @@ void BasicDispatcher::ExecuteDueTasks() {
   while (!task_queue_.empty() && task_queue_.front().due_time_ <= now() &&
          !stop_requested_) {
     backend::NativeTask& task = task_queue_.front();
-    task_queue_.pop_front();
+    task_queue_.Pop();
 
     lock_.unlock();
     Context ctx{this, &task.task_};
@@ -100,7 +100,7 @@ void BasicDispatcher::RequestStop() {
 void BasicDispatcher::DrainTaskQueue() {
   while (!task_queue_.empty()) {
     backend::NativeTask& task = task_queue_.front();
-    task_queue_.pop_front();
+    task_queue_.Pop();
 
     lock_.unlock();
     Context ctx{this, &task.task_};
@@ -117,19 +117,13 @@ void BasicDispatcher::PostAt(Task& task, chrono::SystemClock::time_point time) {
 
 bool BasicDispatcher::Cancel(Task& task) {
   std::lock_guard lock(lock_);
-  return task_queue_.remove(task.native_type());
+  return task_queue_.Remove(task.native_type());
 }
 
 void BasicDispatcher::PostTaskInternal(
     backend::NativeTask& task, chrono::SystemClock::time_point time_due) {
-  task.due_time_ = time_due;
-  auto it_front = task_queue_.begin();
-  auto it_behind = task_queue_.before_begin();
-  while (it_front != task_queue_.end() && time_due > it_front->due_time_) {
-    ++it_front;
-    ++it_behind;
-  }
-  task_queue_.insert_after(it_behind, task);
+  task_queue_.Remove(task);
+  task_queue_.Push(task, time_due);
   timed_notification_.release();
 }
 
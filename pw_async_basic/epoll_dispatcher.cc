@@ -0,0 +1,217 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async_basic/epoll_dispatcher.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::async {
+
+EpollDispatcher::EpollDispatcher()
+    : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)),
+      wake_fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+  PW_CHECK_INT_GE(epoll_fd_, 0, "Failed to create epoll instance");
+  PW_CHECK_INT_GE(wake_fd_, 0, "Failed to create eventfd");
+
+  // The wake event is identified by a pointer to wake_fd_, which cannot be the
+  // address of an FdWatcher.
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.ptr = &wake_fd_;
+  PW_CHECK_INT_EQ(epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event), 0);
+}
+
+EpollDispatcher::~EpollDispatcher() {
+  RequestStop();
+  lock_.lock();
+  DrainTaskQueue();
+  lock_.unlock();
+  close(wake_fd_);
+  close(epoll_fd_);
+}
+
+Status EpollDispatcher::Watch(int fd, FdWatcher& watcher) {
+  if (watcher.fd_ != -1) {
+    return Status::FailedPrecondition();
+  }
+
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.ptr = &watcher;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+    return errno == EEXIST ? Status::AlreadyExists()
+                           : Status::InvalidArgument();
+  }
+  watcher.fd_ = fd;
+  return OkStatus();
+}
+
+void EpollDispatcher::Unwatch(FdWatcher& watcher) {
+  if (watcher.fd_ == -1) {
+    return;
+  }
+  // This fails if the file descriptor was already closed, which removes it
+  // from the epoll instance.
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, watcher.fd_, nullptr);
+  watcher.fd_ = -1;
+
+  // Drop any events for this watcher that were returned by the epoll_wait()
+  // call that is being handled, since the watcher may be destroyed after this.
+  for (int i = 0; i < event_count_; ++i) {
+    if (events_[i].data.ptr == &watcher) {
+      events_[i].data.ptr = nullptr;
+    }
+  }
+}
+
+void EpollDispatcher::Run() {
+  lock_.lock();
+  while (!stop_requested_) {
+    WaitForEvents(chrono::SystemClock::time_point::max());
+    ExecuteDueTasks();
+  }
+  DrainTaskQueue();
+  lock_.unlock();
+}
+
+void EpollDispatcher::RunUntilIdle() {
+  lock_.lock();
+  WaitForEvents(chrono::SystemClock::time_point::min());
+  ExecuteDueTasks();
+  if (stop_requested_) {
+    DrainTaskQueue();
+  }
+  lock_.unlock();
+}
+
+void EpollDispatcher::RunUntil(chrono::SystemClock::time_point end_time) {
+  lock_.lock();
+  while (now() < end_time && !stop_requested_) {
+    WaitForEvents(end_time);
+    ExecuteDueTasks();
+  }
+  if (stop_requested_) {
+    DrainTaskQueue();
+  }
+  lock_.unlock();
+}
+
+void EpollDispatcher::RunFor(chrono::SystemClock::duration duration) {
+  RunUntil(now() + duration);
+}
+
+void EpollDispatcher::RequestStop() {
+  {
+    std::lock_guard lock(lock_);
+    stop_requested_ = true;
+  }
+  Wake();
+}
+
+chrono::SystemClock::time_point EpollDispatcher::NextWakeTime(
+    chrono::SystemClock::time_point limit) {
+  if (!task_queue_.empty() && task_queue_.front().due_time_ < limit) {
+    return task_queue_.front().due_time_;
+  }
+  return limit;
+}
+
+void EpollDispatcher::WaitForEvents(chrono::SystemClock::time_point deadline) {
+  const chrono::SystemClock::time_point wake_time = NextWakeTime(deadline);
+  int timeout_ms = -1;
+  if (wake_time != chrono::SystemClock::time_point::max()) {
+    const auto delay = std::chrono::ceil<std::chrono::milliseconds>(
+        wake_time - std::min(wake_time, now()));
+    timeout_ms = static_cast<int>(
+        std::min<std::chrono::milliseconds::rep>(delay.count(), INT_MAX));
+  }
+
+  lock_.unlock();
+
+  event_count_ = epoll_wait(epoll_fd_, events_.data(), kMaxEvents, timeout_ms);
+  for (int i = 0; i < event_count_; ++i) {
+    void* const target = events_[i].data.ptr;
+    if (target == &wake_fd_) {
+      uint64_t count;
+      // The eventfd is non-blocking, so this only clears pending wakeups.
+      [[maybe_unused]] ssize_t result = read(wake_fd_, &count, sizeof(count));
+    } else if (target != nullptr) {
+      static_cast<FdWatcher*>(target)->on_readable_();
+    }
+  }
+  event_count_ = 0;
+
+  lock_.lock();
+}
+
+void EpollDispatcher::Wake() {
+  const uint64_t count = 1;
+  [[maybe_unused]] ssize_t result = write(wake_fd_, &count, sizeof(count));
+}
+
+void EpollDispatcher::ExecuteDueTasks() {
+  while (!task_queue_.empty() && task_queue_.front().due_time_ <= now() &&
+         !stop_requested_) {
+    backend::NativeTask& task = task_queue_.front();
+    task_queue_.Pop();
+
+    lock_.unlock();
+    Context ctx{this, &task.task_};
+    task(ctx, OkStatus());
+    lock_.lock();
+  }
+}
+
+void EpollDispatcher::DrainTaskQueue() {
+  while (!task_queue_.empty()) {
+    backend::NativeTask& task = task_queue_.front();
+    task_queue_.Pop();
+
+    lock_.unlock();
+    Context ctx{this, &task.task_};
+    task(ctx, Status::Cancelled());
+    lock_.lock();
+  }
+}
+
+void EpollDispatcher::PostAt(Task& task, chrono::SystemClock::time_point time) {
+  {
+    std::lock_guard lock(lock_);
+    PostTaskInternal(task.native_type(), time);
+  }
+  Wake();
+}
+
+bool EpollDispatcher::Cancel(Task& task) {
+  std::lock_guard lock(lock_);
+  return task_queue_.Remove(task.native_type());
+}
+
+void EpollDispatcher::PostTaskInternal(
+    backend::NativeTask& task, chrono::SystemClock::time_point time_due) {
+  task_queue_.Remove(task);
+  task_queue_.Push(task, time_due);
+}
+
+}  // namespace pw::async
@@ -0,0 +1,210 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async_basic/epoll_dispatcher.h"
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "pw_assert/check.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+#define ASSERT_OK(status) ASSERT_EQ(OkStatus(), status)
+#define ASSERT_CANCELLED(status) ASSERT_EQ(Status::Cancelled(), status)
+
+using namespace std::chrono_literals;
+
+namespace pw::async {
+namespace {
+
+class Pipe {
+ public:
+  Pipe() { PW_CHECK_INT_EQ(pipe(fds_), 0); }
+  ~Pipe() {
+    close(fds_[0]);
+    close(fds_[1]);
+  }
+
+  int read_fd() const { return fds_[0]; }
+
+  void WriteByte() {
+    const char c = 'x';
+    ASSERT_EQ(write(fds_[1], &c, 1), 1);
+  }
+
+  void ReadByte() {
+    char c;
+    ASSERT_EQ(read(fds_[0], &c, 1), 1);
+  }
+
+ private:
+  int fds_[2];
+};
+
+TEST(EpollDispatcher, RunUntilIdleRunsTasks) {
+  EpollDispatcher dispatcher;
+
+  int count = 0;
+  Task task([&count]([[maybe_unused]] Context& c, Status status) {
+    ASSERT_OK(status);
+    ++count;
+  });
+  dispatcher.Post(task);
+  dispatcher.RunUntilIdle();
+  EXPECT_EQ(count, 1);
+
+  dispatcher.PostAfter(task, 1h);
+  dispatcher.RunUntilIdle();
+  EXPECT_EQ(count, 1);
+  EXPECT_TRUE(dispatcher.Cancel(task));
+}
+
+TEST(EpollDispatcher, RunForRunsDelayedTasks) {
+  EpollDispatcher dispatcher;
+
+  int count = 0;
+  Task task([&count]([[maybe_unused]] Context& c, Status status) {
+    ASSERT_OK(status);
+    ++count;
+  });
+  dispatcher.PostAfter(task, 5ms);
+  dispatcher.RunFor(50ms);
+  EXPECT_EQ(count, 1);
+}
+
+TEST(EpollDispatcher, WatcherCalledWhileReadable) {
+  EpollDispatcher dispatcher;
+  Pipe pipe;
+
+  int count = 0;
+  FdWatcher watcher([&count] { ++count; });
+  ASSERT_OK(dispatcher.Watch(pipe.read_fd(), watcher));
+  EXPECT_EQ(watcher.fd(), pipe.read_fd());
+
+  dispatcher.RunUntilIdle();
+  EXPECT_EQ(count, 0);
+
+  // Watches are level-triggered, so the watcher is called until the data is
+  // read.
+  pipe.WriteByte();
+  dispatcher.RunUntilIdle();
+  EXPECT_EQ(count, 1);
+  dispatcher.RunUntilIdle();
+  EXPECT_EQ(count, 2);
+
+  pipe.ReadByte();
+  dispatcher.RunUntilIdle();
+  EXPECT_EQ(count, 2);
+
+  dispatcher.Unwatch(watcher);
+  EXPECT_EQ(watcher.fd(), -1);
+  pipe.WriteByte();
+  dispatcher.RunUntilIdle();
+  EXPECT_EQ(count, 2);
+}
+
+TEST(EpollDispatcher, WatchErrors) {
+  EpollDispatcher dispatcher;
+  Pipe pipe;
+
+  FdWatcher watcher([] {});
+  FdWatcher other_watcher([] {});
+  EXPECT_EQ(dispatcher.Watch(-1, watcher), Status::InvalidArgument());
+  ASSERT_OK(dispatcher.Watch(pipe.read_fd(), watcher));
+  EXPECT_EQ(dispatcher.Watch(pipe.read_fd(), watcher),
+            Status::FailedPrecondition());
+  EXPECT_EQ(dispatcher.Watch(pipe.read_fd(), other_watcher),
+            Status::AlreadyExists());
+  dispatcher.Unwatch(watcher);
+}
+
+TEST(EpollDispatcher, UnwatchFromWatcherSkipsPendingEvents) {
+  EpollDispatcher dispatcher;
+  Pipe pipe_a;
+  Pipe pipe_b;
+
+  // Lambdas can only capture one pointer without allocating, so the state
+  // shared by the watchers is grouped in a struct.
+  struct Watchers {
+    EpollDispatcher& dispatcher;
+    int count = 0;
+    FdWatcher* a = nullptr;
+    FdWatcher* b = nullptr;
+
+    // Whichever watcher runs first unwatches both, so only one is called even
+    // though both file descriptors are ready.
+    void UnwatchAll() {
+      ++count;
+      dispatcher.Unwatch(*a);
+      dispatcher.Unwatch(*b);
+    }
+  } watchers{dispatcher};
+
+  FdWatcher watcher_a([&watchers] { watchers.UnwatchAll(); });
+  FdWatcher watcher_b([&watchers] { watchers.UnwatchAll(); });
+  watchers.a = &watcher_a;
+  watchers.b = &watcher_b;
+  ASSERT_OK(dispatcher.Watch(pipe_a.read_fd(), watcher_a));
+  ASSERT_OK(dispatcher.Watch(pipe_b.read_fd(), watcher_b));
+
+  pipe_a.WriteByte();
+  pipe_b.WriteByte();
+  dispatcher.RunUntilIdle();
+  EXPECT_EQ(watchers.count, 1);
+}
+
+TEST(EpollDispatcher, RunOnThread) {
+  EpollDispatcher dispatcher;
+  thread::Thread work_thread(thread::stl::Options(), dispatcher);
+
+  // Posting a task wakes the dispatcher thread.
+  sync::ThreadNotification task_ran;
+  Task task([&task_ran]([[maybe_unused]] Context& c, Status status) {
+    ASSERT_OK(status);
+    task_ran.release();
+  });
+  dispatcher.Post(task);
+  task_ran.acquire();
+
+  // A watched file descriptor becoming readable wakes the dispatcher thread.
+  struct {
+    Pipe pipe;
+    sync::ThreadNotification called;
+  } readable;
+  FdWatcher watcher([&readable] {
+    readable.pipe.ReadByte();
+    readable.called.release();
+  });
+  ASSERT_OK(dispatcher.Watch(readable.pipe.read_fd(), watcher));
+  readable.pipe.WriteByte();
+  readable.called.acquire();
+
+  // Tasks that are still waiting are cancelled when the dispatcher stops.
+  int cancelled = 0;
+  Task delayed_task([&cancelled]([[maybe_unused]] Context& c, Status status) {
+    ASSERT_CANCELLED(status);
+    ++cancelled;
+  });
+  dispatcher.PostAfter(delayed_task, 1h);
+
+  dispatcher.RequestStop();
+  work_thread.join();
+  dispatcher.Unwatch(watcher);
+  EXPECT_EQ(cancelled, 1);
+}
+
+}  // namespace
+}  // namespace pw::async
@@ -66,5 +66,94 @@ TEST_F(HeapDispatcherTest, TaskFunctionIsDestroyedAfterBeingCalled) {
   EXPECT_TRUE(flag);
 }
 
+TEST_F(HeapDispatcherTest, AllocatesTasksFromPool) {
+  HeapDispatcher::TaskPool<2> task_pool;
+  HeapDispatcher heap_dispatcher(dispatcher(), task_pool);
+
+  int count = 0;
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(heap_dispatcher.Post(
+                  [&count](Context& /*ctx*/, Status /*status*/) { ++count; }),
+              OkStatus());
+  }
+  EXPECT_EQ(task_pool.available(), 0u);
+  EXPECT_EQ(heap_dispatcher.outstanding_tasks(), 2u);
+
+  RunUntilIdle();
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(task_pool.available(), 2u);
+  EXPECT_EQ(heap_dispatcher.outstanding_tasks(), 0u);
+  EXPECT_EQ(heap_dispatcher.peak_outstanding_tasks(), 2u);
+  EXPECT_EQ(heap_dispatcher.heap_allocations(), 0u);
+}
+
+TEST_F(HeapDispatcherTest, UsesHeapWhenPoolIsExhausted) {
+  HeapDispatcher::TaskPool<1> task_pool;
+  HeapDispatcher heap_dispatcher(dispatcher(), task_pool);
+
+  int count = 0;
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(heap_dispatcher.Post(
+                  [&count](Context& /*ctx*/, Status /*status*/) { ++count; }),
+              OkStatus());
+  }
+  EXPECT_EQ(heap_dispatcher.heap_allocations(), 2u);
+
+  RunUntilIdle();
+  EXPECT_EQ(count, 3);
+  EXPECT_EQ(task_pool.available(), 1u);
+  EXPECT_EQ(heap_dispatcher.outstanding_tasks(), 0u);
+  EXPECT_EQ(heap_dispatcher.peak_outstanding_tasks(), 3u);
+}
+
+TEST_F(HeapDispatcherTest, FailsWhenPoolIsExhausted) {
+  HeapDispatcher::TaskPool<1> task_pool;
+  HeapDispatcher heap_dispatcher(
+      dispatcher(), task_pool, HeapDispatcher::PoolExhaustion::kFail);
+
+  int count = 0;
+  EXPECT_EQ(heap_dispatcher.Post(
+                [&count](Context& /*ctx*/, Status /*status*/) { ++count; }),
+            OkStatus());
+  EXPECT_EQ(heap_dispatcher.Post(
+                [&count](Context& /*ctx*/, Status /*status*/) { ++count; }),
+            Status::ResourceExhausted());
+
+  RunUntilIdle();
+  EXPECT_EQ(count, 1);
+  EXPECT_EQ(heap_dispatcher.heap_allocations(), 0u);
+
+  // The task's block was returned to the pool, so posting works again.
+  EXPECT_EQ(heap_dispatcher.Post(
+                [&count](Context& /*ctx*/, Status /*status*/) { ++count; }),
+            OkStatus());
+  RunUntilIdle();
+  EXPECT_EQ(count, 2);
+}
+
+TEST_F(HeapDispatcherTest, PooledTaskFunctionIsDestroyedAfterBeingCalled) {
+  HeapDispatcher::TaskPool<1> task_pool;
+  HeapDispatcher heap_dispatcher(dispatcher(), task_pool);
+
+  bool flag = false;
+  Status status =
+      heap_dispatcher.Post([checker = DestructionChecker(&flag)](
+                               Context& /*ctx*/, Status /*status*/) {});
+  EXPECT_TRUE(status.ok());
+  EXPECT_FALSE(flag);
+  RunUntilIdle();
+  EXPECT_TRUE(flag);
+}
+
+TEST_F(HeapDispatcherTest, UpdateMetrics) {
+  HeapDispatcher heap_dispatcher(dispatcher());
+  EXPECT_EQ(heap_dispatcher.Post([](Context& /*ctx*/, Status /*status*/) {}),
+            OkStatus());
+  heap_dispatcher.UpdateMetrics();
+  EXPECT_EQ(heap_dispatcher.metrics().metrics().size(), 3u);
+  RunUntilIdle();
+  EXPECT_EQ(heap_dispatcher.heap_allocations(), 1u);
+}
+
 }  // namespace
 }  // namespace pw::async
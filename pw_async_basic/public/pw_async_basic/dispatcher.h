@@ -15,6 +15,7 @@
 
 #include "pw_async/dispatcher.h"
 #include "pw_async/task.h"
+#include "pw_async_basic/task_queue.h"
 #include "pw_sync/interrupt_spin_lock.h"
 #include "pw_sync/lock_annotations.h"
 #include "pw_sync/timed_thread_notification.h"
@@ -62,8 +63,8 @@ class BasicDispatcher final : public Dispatcher, public thread::ThreadCore {
   }
 
  private:
-  // Insert |task| into task_queue_ maintaining its min-heap property, keyed by
-  // |time_due|.
+  // Insert |task| into task_queue_, keyed by |time_due|. A task that is
+  // already queued is rescheduled.
   void PostTaskInternal(backend::NativeTask& task,
                         chrono::SystemClock::time_point time_due)
       PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
@@ -82,8 +83,8 @@ class BasicDispatcher final : public Dispatcher, public thread::ThreadCore {
   sync::InterruptSpinLock lock_;
   sync::TimedThreadNotification timed_notification_;
   bool stop_requested_ PW_GUARDED_BY(lock_) = false;
-  // A priority queue of scheduled Tasks sorted by earliest due times first.
-  IntrusiveList<backend::NativeTask> task_queue_ PW_GUARDED_BY(lock_);
+  // A priority queue of scheduled Tasks with the earliest due time first.
+  backend::TaskQueue task_queue_ PW_GUARDED_BY(lock_);
 };
 
 }  // namespace pw::async
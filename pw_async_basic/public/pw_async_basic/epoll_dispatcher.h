@@ -0,0 +1,160 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <sys/epoll.h>
+
+#include <array>
+#include <utility>
+
+#include "pw_async/dispatcher.h"
+#include "pw_async/task.h"
+#include "pw_async_basic/task_queue.h"
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_thread/thread_core.h"
+
+namespace pw::async {
+
+class EpollDispatcher;
+
+/// A caller-owned watch on a file descriptor, which calls a function on the
+/// `EpollDispatcher` thread each time the file descriptor is readable.
+///
+/// Watches are level-triggered: if the function does not read all available
+/// data, it is called again on the next iteration of the dispatch loop. A
+/// file descriptor is also readable once its peer has hung up.
+class FdWatcher {
+ public:
+  explicit FdWatcher(Function<void()>&& on_readable)
+      : on_readable_(std::move(on_readable)) {}
+
+  FdWatcher(const FdWatcher&) = delete;
+  FdWatcher& operator=(const FdWatcher&) = delete;
+
+  /// Returns the watched file descriptor, or -1 if it is not being watched.
+  int fd() const { return fd_; }
+
+ private:
+  friend class EpollDispatcher;
+
+  Function<void()> on_readable_;
+  int fd_ = -1;
+};
+
+/// `EpollDispatcher` is a `Dispatcher` for Linux that also waits for file
+/// descriptors, such as sockets, to become readable. This allows one thread to
+/// service many connections along with timed tasks, rather than dedicating a
+/// blocking read thread to each connection.
+///
+/// Tasks and `FdWatcher` functions all run on the thread that runs the
+/// dispatcher. `Post`, `Cancel`, `Watch`, and `RequestStop` may be called from
+/// any thread.
+class EpollDispatcher final : public Dispatcher, public thread::ThreadCore {
+ public:
+  EpollDispatcher();
+  ~EpollDispatcher() override;
+
+  EpollDispatcher(const EpollDispatcher&) = delete;
+  EpollDispatcher& operator=(const EpollDispatcher&) = delete;
+
+  /// Starts calling `watcher` when `fd` is readable. `fd` must remain open and
+  /// `watcher` must remain valid until `Unwatch` is called.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The file descriptor is being watched.
+  /// * @pw_status{FAILED_PRECONDITION} - `watcher` is already in use.
+  /// * @pw_status{ALREADY_EXISTS} - `fd` is already being watched.
+  /// * @pw_status{INVALID_ARGUMENT} - `fd` cannot be watched with epoll.
+  Status Watch(int fd, FdWatcher& watcher);
+
+  /// Stops watching the file descriptor. `watcher` is not called again once
+  /// this returns.
+  ///
+  /// This must be called on the dispatcher thread, such as from a task or a
+  /// watcher function, or while the dispatcher is not running.
+  void Unwatch(FdWatcher& watcher);
+
+  /// Execute all runnable tasks and ready watchers and return without waiting.
+  void RunUntilIdle() PW_LOCKS_EXCLUDED(lock_);
+
+  /// Run the dispatcher until Now() has reached `end_time`, executing all tasks
+  /// that come due and watchers that become ready before then.
+  void RunUntil(chrono::SystemClock::time_point end_time)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  /// Run the dispatcher until `duration` has elapsed.
+  void RunFor(chrono::SystemClock::duration duration) PW_LOCKS_EXCLUDED(lock_);
+
+  /// Stop processing tasks and watchers. Waiting tasks are dequeued and their
+  /// TaskFunctions called with a PW_STATUS_CANCELLED status, as in
+  /// `BasicDispatcher::RequestStop`.
+  void RequestStop() PW_LOCKS_EXCLUDED(lock_);
+
+  // ThreadCore overrides:
+
+  /// Run the dispatcher until RequestStop() is called.
+  void Run() override PW_LOCKS_EXCLUDED(lock_);
+
+  // Dispatcher overrides:
+  void PostAt(Task& task, chrono::SystemClock::time_point time) override
+      PW_LOCKS_EXCLUDED(lock_);
+  bool Cancel(Task& task) override PW_LOCKS_EXCLUDED(lock_);
+
+  // VirtualSystemClock overrides:
+  chrono::SystemClock::time_point now() override {
+    return chrono::SystemClock::now();
+  }
+
+ private:
+  // The most file descriptor events handled per epoll_wait() call.
+  static constexpr int kMaxEvents = 32;
+
+  // Waits until a watched file descriptor is ready, the dispatcher is woken,
+  // or `deadline` passes, running the functions of ready watchers. The lock is
+  // released while waiting and while the functions run.
+  void WaitForEvents(chrono::SystemClock::time_point deadline)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Returns when the dispatch loop must wake up to run the next task, or
+  // `limit` if that is earlier.
+  chrono::SystemClock::time_point NextWakeTime(
+      chrono::SystemClock::time_point limit) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Interrupts a running epoll_wait() call.
+  void Wake();
+
+  void PostTaskInternal(backend::NativeTask& task,
+                        chrono::SystemClock::time_point time_due)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void ExecuteDueTasks() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void DrainTaskQueue() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  int epoll_fd_;
+  int wake_fd_;
+
+  // Events returned by the last epoll_wait() call. Only accessed on the
+  // dispatcher thread.
+  std::array<epoll_event, kMaxEvents> events_;
+  int event_count_ = 0;
+
+  sync::InterruptSpinLock lock_;
+  bool stop_requested_ PW_GUARDED_BY(lock_) = false;
+  // A priority queue of scheduled Tasks with the earliest due time first.
+  backend::TaskQueue task_queue_ PW_GUARDED_BY(lock_);
+};
+
+}  // namespace pw::async
@@ -15,7 +15,7 @@
 
 #include "pw_async/dispatcher.h"
 #include "pw_async/task.h"
-#include "pw_containers/intrusive_list.h"
+#include "pw_async_basic/task_queue.h"
 
 namespace pw::async::test::backend {
 
@@ -43,8 +43,8 @@ class NativeFakeDispatcher final {
   chrono::SystemClock::time_point now() { return now_; }
 
  private:
-  // Insert |task| into task_queue_ maintaining its min-heap property, keyed by
-  // |time_due|.
+  // Insert |task| into task_queue_, keyed by |time_due|. A task that is
+  // already queued is only moved if |time_due| is earlier.
   void PostTaskInternal(::pw::async::backend::NativeTask& task,
                         chrono::SystemClock::time_point time_due);
 
@@ -58,8 +58,8 @@ class NativeFakeDispatcher final {
   Dispatcher& dispatcher_;
   bool stop_requested_ = false;
 
-  // A priority queue of scheduled tasks sorted by earliest due times first.
-  IntrusiveList<::pw::async::backend::NativeTask> task_queue_;
+  // A priority queue of scheduled tasks with the earliest due time first.
+  ::pw::async::backend::TaskQueue task_queue_;
 
   // Tracks the current time as viewed by the test dispatcher.
   chrono::SystemClock::time_point now_;
@@ -15,11 +15,14 @@
 
 #include "pw_async/context.h"
 #include "pw_async/task_function.h"
+#include <cstdint>
+
 #include "pw_chrono/system_clock.h"
-#include "pw_containers/intrusive_list.h"
 
 namespace pw::async {
 class BasicDispatcher;
+class EpollDispatcher;
+class ThreadPoolDispatcher;
 namespace test::backend {
 class NativeFakeDispatcher;
 }
@@ -27,23 +30,27 @@ class NativeFakeDispatcher;
 
 namespace pw::async::backend {
 
+class TaskQueue;
+
 // Task backend for BasicDispatcher.
-class NativeTask final : public IntrusiveList<NativeTask>::Item {
+class NativeTask final {
  private:
   friend class ::pw::async::Task;
   friend class ::pw::async::BasicDispatcher;
+  friend class ::pw::async::EpollDispatcher;
+  friend class ::pw::async::ThreadPoolDispatcher;
   friend class ::pw::async::test::backend::NativeFakeDispatcher;
+  friend class TaskQueue;
 
   NativeTask(::pw::async::Task& task) : task_(task) {}
+  NativeTask(const NativeTask&) = delete;
+  NativeTask& operator=(const NativeTask&) = delete;
   explicit NativeTask(::pw::async::Task& task, TaskFunction&& f)
       : func_(std::move(f)), task_(task) {}
   void operator()(Context& ctx, Status status) { func_(ctx, status); }
   void set_function(TaskFunction&& f) { func_ = std::move(f); }
 
   pw::chrono::SystemClock::time_point due_time() const { return due_time_; }
-  void set_due_time(chrono::SystemClock::time_point due_time) {
-    due_time_ = due_time;
-  }
 
   TaskFunction func_ = nullptr;
   // task_ is placed after func_ to take advantage of the padding that would
@@ -52,6 +59,16 @@ class NativeTask final : public IntrusiveList<NativeTask>::Item {
   // padding would be added here, which is just enough for a pointer.
   Task& task_;
   pw::chrono::SystemClock::time_point due_time_;
+
+  // TaskQueue links. heap_queue_ is the queue that holds the task, if any.
+  // heap_prev_ is the parent for a first child and the previous sibling
+  // otherwise, and is null for the root. heap_sequence_ orders tasks with the
+  // same due time.
+  TaskQueue* heap_queue_ = nullptr;
+  NativeTask* heap_prev_ = nullptr;
+  NativeTask* heap_next_ = nullptr;
+  NativeTask* heap_child_ = nullptr;
+  uint32_t heap_sequence_ = 0;
 };
 
 using NativeTaskHandle = NativeTask&;
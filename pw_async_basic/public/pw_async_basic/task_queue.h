@@ -0,0 +1,98 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_async_basic/task.h"
+#include "pw_chrono/system_clock.h"
+
+namespace pw::async::backend {
+
+/// A priority queue of `NativeTask`s ordered by due time, for the
+/// `pw_async_basic` dispatchers.
+///
+/// The queue is an intrusive pairing heap, so it needs no storage beyond the
+/// links in each `NativeTask`. `Push` is O(1), and `Pop` and `Remove` are
+/// amortized O(log n), so posting and cancelling stay cheap with hundreds of
+/// pending timeouts. Tasks with the same due time are popped in the order they
+/// were pushed.
+///
+/// `TaskQueue` is not thread safe.
+class TaskQueue {
+ public:
+  constexpr TaskQueue() = default;
+
+  TaskQueue(const TaskQueue&) = delete;
+  TaskQueue& operator=(const TaskQueue&) = delete;
+
+  bool empty() const { return root_ == nullptr; }
+
+  /// Returns the task that is due first.
+  ///
+  /// @pre The queue must not be empty.
+  NativeTask& front() const { return *root_; }
+
+  /// Adds a task with the given due time.
+  ///
+  /// @pre The task must not be in a queue.
+  void Push(NativeTask& task, chrono::SystemClock::time_point due_time);
+
+  /// Removes the task that is due first.
+  ///
+  /// @pre The queue must not be empty.
+  void Pop();
+
+  /// Removes a task from the queue. Returns false if it is not in the queue.
+  bool Remove(NativeTask& task);
+
+  /// Returns true if the task is in this queue.
+  bool Contains(const NativeTask& task) const {
+    return task.heap_queue_ == this;
+  }
+
+  /// Returns the queue that holds the task, or null if it is not queued.
+  static TaskQueue* QueueOf(const NativeTask& task) {
+    return task.heap_queue_;
+  }
+
+ private:
+  // Returns true if a is due before b. Ties go to the task pushed first.
+  static bool IsBefore(const NativeTask& a, const NativeTask& b) {
+    if (a.due_time_ != b.due_time_) {
+      return a.due_time_ < b.due_time_;
+    }
+    // Compare sequence numbers with wraparound.
+    return static_cast<int32_t>(a.heap_sequence_ - b.heap_sequence_) < 0;
+  }
+
+  // Combines two heaps and returns the new root. Neither root may have
+  // siblings.
+  static NativeTask* Meld(NativeTask* a, NativeTask* b);
+
+  // Combines a list of sibling heaps, as left when their parent is removed.
+  static NativeTask* MeldSiblings(NativeTask* first);
+
+  static void Unlink(NativeTask& task) {
+    task.heap_queue_ = nullptr;
+    task.heap_prev_ = nullptr;
+    task.heap_next_ = nullptr;
+    task.heap_child_ = nullptr;
+  }
+
+  NativeTask* root_ = nullptr;
+  uint32_t next_sequence_ = 0;
+};
+
+}  // namespace pw::async::backend
@@ -0,0 +1,160 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_async/dispatcher.h"
+#include "pw_async/task.h"
+#include "pw_async_basic/task_queue.h"
+#include "pw_span/span.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/timed_thread_notification.h"
+#include "pw_thread/thread_core.h"
+
+namespace pw::async {
+
+/// `ThreadPoolDispatcher` is a `Dispatcher` that runs tasks on several worker
+/// threads, so CPU-heavy tasks do not hold up the rest.
+///
+/// Each worker has its own queues of tasks, ordered by due time. A task posted
+/// with `Post`, `PostAfter`, or `PostAt` is given to an idle worker if there is
+/// one, or else to the workers in turn. Workers run their own due tasks first
+/// and steal due tasks from other workers when they run out. A task may
+/// instead be pinned to a worker by passing the worker's index, in which case
+/// only that worker runs it. Tasks are never run before they are due.
+///
+/// Unpinned tasks may run concurrently, so tasks that share state must be
+/// synchronized or pinned to the same worker. Tasks pinned to one worker run in
+/// due time order, and tasks with the same due time run in the order they were
+/// posted.
+///
+/// The caller provides the workers and runs each on its own thread:
+///
+/// @code{.cpp}
+///   std::array<pw::async::ThreadPoolDispatcher::Worker, 4> workers;
+///   pw::async::ThreadPoolDispatcher dispatcher(workers);
+///   for (auto& worker : workers) {
+///     pw::thread::Thread(options, worker).detach();
+///   }
+/// @endcode
+///
+/// `Post`, `Cancel`, and `RequestStop` may be called from any thread.
+class ThreadPoolDispatcher final : public Dispatcher {
+ public:
+  /// Runs tasks for a `ThreadPoolDispatcher` on a thread.
+  class Worker final : public thread::ThreadCore {
+   public:
+    Worker() = default;
+
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+
+   private:
+    friend class ThreadPoolDispatcher;
+
+    // Runs tasks until RequestStop() is called. Tasks still queued for this
+    // worker are then cancelled.
+    void Run() override;
+
+    ThreadPoolDispatcher* dispatcher_ = nullptr;
+    sync::TimedThreadNotification notification_;
+
+    // These members are guarded by the dispatcher's lock. Tasks in shared_ may
+    // be stolen by other workers; tasks in pinned_ may not.
+    backend::TaskQueue shared_;
+    backend::TaskQueue pinned_;
+    bool idle_ = false;
+  };
+
+  /// @param workers The workers that run tasks. There must be at least one.
+  explicit ThreadPoolDispatcher(span<Worker> workers);
+
+  /// Cancels all queued tasks. Worker threads must have returned before the
+  /// dispatcher is destroyed.
+  ~ThreadPoolDispatcher() override;
+
+  ThreadPoolDispatcher(const ThreadPoolDispatcher&) = delete;
+  ThreadPoolDispatcher& operator=(const ThreadPoolDispatcher&) = delete;
+
+  size_t worker_count() const { return workers_.size(); }
+
+  /// Stops all workers. Each worker finishes the task it is running, calls
+  /// the TaskFunctions of its queued tasks with a PW_STATUS_CANCELLED status,
+  /// and returns from `Run`.
+  void RequestStop() PW_LOCKS_EXCLUDED(lock_);
+
+  using Dispatcher::Post;
+  using Dispatcher::PostAfter;
+
+  /// Posts `task` to run only on the worker at index `worker`.
+  void Post(Task& task, size_t worker) { PostAt(task, now(), worker); }
+
+  /// Posts `task` to run after `delay`, only on the worker at index `worker`.
+  void PostAfter(Task& task,
+                 chrono::SystemClock::duration delay,
+                 size_t worker) {
+    PostAt(task, now() + delay, worker);
+  }
+
+  /// Posts `task` to run at `time`, only on the worker at index `worker`.
+  void PostAt(Task& task, chrono::SystemClock::time_point time, size_t worker)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Dispatcher overrides:
+  void PostAt(Task& task, chrono::SystemClock::time_point time) override
+      PW_LOCKS_EXCLUDED(lock_);
+  bool Cancel(Task& task) override PW_LOCKS_EXCLUDED(lock_);
+
+  // VirtualSystemClock overrides:
+  chrono::SystemClock::time_point now() override {
+    return chrono::SystemClock::now();
+  }
+
+ private:
+  // Queues |task| to run at |time_due| on |worker|. A task that is already
+  // queued is rescheduled.
+  void PostTaskInternal(backend::NativeTask& task,
+                        chrono::SystemClock::time_point time_due,
+                        Worker& worker,
+                        bool pinned) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Returns the worker that should run an unpinned task.
+  Worker& NextWorker() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  void RunWorker(Worker& worker) PW_LOCKS_EXCLUDED(lock_);
+
+  // Dequeues the task that |worker| should run next, or returns null if none
+  // are due.
+  backend::NativeTask* TakeDueTask(Worker& worker)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Returns when |worker| must wake up to run or steal the next task.
+  chrono::SystemClock::time_point NextWakeTime(const Worker& worker)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Dequeues each task in |queue| and calls its TaskFunction with a
+  // PW_STATUS_CANCELLED status.
+  void DrainTaskQueue(backend::TaskQueue& queue)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  span<Worker> workers_;
+  sync::InterruptSpinLock lock_;
+  bool stop_requested_ PW_GUARDED_BY(lock_) = false;
+  // The worker that is given the next unpinned task if none are idle.
+  size_t next_worker_ PW_GUARDED_BY(lock_) = 0;
+};
+
+}  // namespace pw::async
@@ -0,0 +1,117 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async_basic/task_queue.h"
+
+namespace pw::async::backend {
+
+void TaskQueue::Push(NativeTask& task,
+                     chrono::SystemClock::time_point due_time) {
+  task.due_time_ = due_time;
+  task.heap_sequence_ = next_sequence_++;
+  Unlink(task);
+  task.heap_queue_ = this;
+  root_ = root_ == nullptr ? &task : Meld(root_, &task);
+}
+
+void TaskQueue::Pop() {
+  NativeTask& task = *root_;
+  root_ = MeldSiblings(task.heap_child_);
+  Unlink(task);
+}
+
+bool TaskQueue::Remove(NativeTask& task) {
+  if (!Contains(task)) {
+    return false;
+  }
+  if (&task == root_) {
+    Pop();
+    return true;
+  }
+
+  // Detach the subtree rooted at the task. heap_prev_ is its parent if it is
+  // the first child, and its previous sibling otherwise.
+  if (task.heap_prev_->heap_child_ == &task) {
+    task.heap_prev_->heap_child_ = task.heap_next_;
+  } else {
+    task.heap_prev_->heap_next_ = task.heap_next_;
+  }
+  if (task.heap_next_ != nullptr) {
+    task.heap_next_->heap_prev_ = task.heap_prev_;
+  }
+
+  if (NativeTask* children = MeldSiblings(task.heap_child_);
+      children != nullptr) {
+    root_ = Meld(root_, children);
+  }
+  Unlink(task);
+  return true;
+}
+
+NativeTask* TaskQueue::Meld(NativeTask* a, NativeTask* b) {
+  if (IsBefore(*b, *a)) {
+    NativeTask* swap = a;
+    a = b;
+    b = swap;
+  }
+
+  // b becomes the first child of a.
+  b->heap_prev_ = a;
+  b->heap_next_ = a->heap_child_;
+  if (a->heap_child_ != nullptr) {
+    a->heap_child_->heap_prev_ = b;
+  }
+  a->heap_child_ = b;
+  return a;
+}
+
+NativeTask* TaskQueue::MeldSiblings(NativeTask* first) {
+  if (first == nullptr) {
+    return nullptr;
+  }
+
+  // First pass: meld the siblings in pairs from left to right. The results are
+  // kept in a list linked through heap_next_, in reverse order.
+  NativeTask* pairs = nullptr;
+  while (first != nullptr) {
+    NativeTask* a = first;
+    NativeTask* b = a->heap_next_;
+    first = b == nullptr ? nullptr : b->heap_next_;
+
+    a->heap_prev_ = nullptr;
+    a->heap_next_ = nullptr;
+    NativeTask* melded = a;
+    if (b != nullptr) {
+      b->heap_prev_ = nullptr;
+      b->heap_next_ = nullptr;
+      melded = Meld(a, b);
+    }
+    melded->heap_next_ = pairs;
+    pairs = melded;
+  }
+
+  // Second pass: meld the pairs from right to left into a single heap.
+  NativeTask* root = pairs;
+  NativeTask* rest = root->heap_next_;
+  root->heap_next_ = nullptr;
+  while (rest != nullptr) {
+    NativeTask* next = rest->heap_next_;
+    rest->heap_next_ = nullptr;
+    root = Meld(root, rest);
+    rest = next;
+  }
+  return root;
+}
+
+}  // namespace pw::async::backend
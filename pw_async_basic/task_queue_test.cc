@@ -0,0 +1,160 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_async_basic/task_queue.h"
+
+#include <array>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_async/task.h"
+
+using namespace std::chrono_literals;
+
+namespace pw::async::backend {
+namespace {
+
+using chrono::SystemClock;
+
+constexpr SystemClock::time_point kStart{};
+
+class TaskQueueTest : public ::testing::Test {
+ protected:
+  NativeTask& task(size_t index) { return tasks_[index].native_type(); }
+
+  // Returns the index of the task at the front of the queue.
+  size_t Front() {
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+      if (&queue_.front() == &task(i)) {
+        return i;
+      }
+    }
+    return tasks_.size();
+  }
+
+  // Pops and returns the index of the task at the front of the queue.
+  size_t PopFront() {
+    size_t index = Front();
+    queue_.Pop();
+    return index;
+  }
+
+  std::array<Task, 16> tasks_;
+  TaskQueue queue_;
+};
+
+TEST_F(TaskQueueTest, Empty) {
+  EXPECT_TRUE(queue_.empty());
+  EXPECT_FALSE(queue_.Contains(task(0)));
+  EXPECT_FALSE(queue_.Remove(task(0)));
+}
+
+TEST_F(TaskQueueTest, PopsInDueTimeOrder) {
+  constexpr std::array<int, 8> kDelays = {5, 1, 7, 3, 0, 6, 2, 4};
+  for (size_t i = 0; i < kDelays.size(); ++i) {
+    queue_.Push(task(i), kStart + std::chrono::seconds(kDelays[i]));
+  }
+
+  for (int delay = 0; delay < 8; ++delay) {
+    ASSERT_FALSE(queue_.empty());
+    EXPECT_EQ(kDelays[PopFront()], delay);
+  }
+  EXPECT_TRUE(queue_.empty());
+}
+
+TEST_F(TaskQueueTest, EqualDueTimesPopInPushOrder) {
+  for (size_t i = 0; i < 10; ++i) {
+    queue_.Push(task(i), kStart + 1s);
+  }
+  queue_.Push(task(10), kStart);
+
+  EXPECT_EQ(PopFront(), 10u);
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(PopFront(), i);
+  }
+  EXPECT_TRUE(queue_.empty());
+}
+
+TEST_F(TaskQueueTest, RemoveFront) {
+  queue_.Push(task(0), kStart + 2s);
+  queue_.Push(task(1), kStart + 1s);
+  queue_.Push(task(2), kStart + 3s);
+
+  EXPECT_TRUE(queue_.Remove(task(1)));
+  EXPECT_FALSE(queue_.Contains(task(1)));
+  EXPECT_FALSE(queue_.Remove(task(1)));
+
+  EXPECT_EQ(PopFront(), 0u);
+  EXPECT_EQ(PopFront(), 2u);
+  EXPECT_TRUE(queue_.empty());
+}
+
+TEST_F(TaskQueueTest, RemoveFromMiddle) {
+  // Push in an interleaved order to build a heap with several levels.
+  std::array<size_t, 16> delays;
+  for (size_t i = 0; i < tasks_.size(); ++i) {
+    delays[i] = (i * 7) % tasks_.size();
+    queue_.Push(task(i),
+                kStart + std::chrono::seconds(static_cast<int>(delays[i])));
+  }
+  // Pop one task to meld the root's children into a deeper heap.
+  EXPECT_EQ(PopFront(), 0u);
+
+  for (size_t i : {3, 9, 14, 1, 6}) {
+    ASSERT_TRUE(queue_.Contains(task(i)));
+    EXPECT_TRUE(queue_.Remove(task(i)));
+    EXPECT_FALSE(queue_.Contains(task(i)));
+  }
+
+  size_t last = 0;
+  size_t count = 0;
+  while (!queue_.empty()) {
+    const size_t delay = delays[PopFront()];
+    EXPECT_LT(last, delay);
+    last = delay;
+    ++count;
+  }
+  EXPECT_EQ(count, tasks_.size() - 6);
+}
+
+TEST_F(TaskQueueTest, ContainsOnlyTasksInThisQueue) {
+  TaskQueue other;
+  queue_.Push(task(0), kStart);
+  other.Push(task(1), kStart);
+  other.Push(task(2), kStart + 1s);
+
+  EXPECT_TRUE(queue_.Contains(task(0)));
+  EXPECT_FALSE(queue_.Contains(task(2)));
+  EXPECT_EQ(TaskQueue::QueueOf(task(2)), &other);
+  EXPECT_FALSE(queue_.Remove(task(2)));
+  EXPECT_TRUE(other.Remove(task(2)));
+  EXPECT_EQ(TaskQueue::QueueOf(task(2)), nullptr);
+}
+
+TEST_F(TaskQueueTest, TasksCanBeRequeued) {
+  queue_.Push(task(0), kStart + 1s);
+  queue_.Push(task(1), kStart + 2s);
+  EXPECT_EQ(PopFront(), 0u);
+  EXPECT_FALSE(queue_.Contains(task(0)));
+
+  queue_.Push(task(0), kStart + 3s);
+  EXPECT_TRUE(queue_.Remove(task(1)));
+  queue_.Push(task(1), kStart + 4s);
+
+  EXPECT_EQ(PopFront(), 0u);
+  EXPECT_EQ(PopFront(), 1u);
+  EXPECT_TRUE(queue_.empty());
+}
+
+}  // namespace
+}  // namespace pw::async::backend
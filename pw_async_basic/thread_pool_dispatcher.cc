@@ -0,0 +1,204 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async_basic/thread_pool_dispatcher.h"
+
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+using namespace std::chrono_literals;
+
+namespace pw::async {
+namespace {
+
+constexpr chrono::SystemClock::duration kSleepDuration = 5s;
+
+}  // namespace
+
+void ThreadPoolDispatcher::Worker::Run() { dispatcher_->RunWorker(*this); }
+
+ThreadPoolDispatcher::ThreadPoolDispatcher(span<Worker> workers)
+    : workers_(workers) {
+  PW_CHECK(!workers_.empty(), "ThreadPoolDispatcher needs a worker");
+  for (Worker& worker : workers_) {
+    PW_CHECK(worker.dispatcher_ == nullptr,
+             "Workers cannot be shared between dispatchers");
+    worker.dispatcher_ = this;
+  }
+}
+
+ThreadPoolDispatcher::~ThreadPoolDispatcher() {
+  RequestStop();
+  lock_.lock();
+  for (Worker& worker : workers_) {
+    DrainTaskQueue(worker.pinned_);
+    DrainTaskQueue(worker.shared_);
+    worker.dispatcher_ = nullptr;
+  }
+  lock_.unlock();
+}
+
+void ThreadPoolDispatcher::RequestStop() {
+  std::lock_guard lock(lock_);
+  stop_requested_ = true;
+  for (Worker& worker : workers_) {
+    worker.notification_.release();
+  }
+}
+
+void ThreadPoolDispatcher::PostAt(Task& task,
+                                  chrono::SystemClock::time_point time) {
+  std::lock_guard lock(lock_);
+  PostTaskInternal(task.native_type(), time, NextWorker(), false);
+}
+
+void ThreadPoolDispatcher::PostAt(Task& task,
+                                  chrono::SystemClock::time_point time,
+                                  size_t worker) {
+  PW_CHECK_UINT_LT(worker, workers_.size());
+  std::lock_guard lock(lock_);
+  PostTaskInternal(task.native_type(), time, workers_[worker], true);
+}
+
+bool ThreadPoolDispatcher::Cancel(Task& task) {
+  std::lock_guard lock(lock_);
+  // A task is only posted to one dispatcher, so any queue that holds it
+  // belongs to this one.
+  backend::TaskQueue* queue = backend::TaskQueue::QueueOf(task.native_type());
+  return queue != nullptr && queue->Remove(task.native_type());
+}
+
+void ThreadPoolDispatcher::PostTaskInternal(
+    backend::NativeTask& task,
+    chrono::SystemClock::time_point time_due,
+    Worker& worker,
+    bool pinned) {
+  if (backend::TaskQueue* queue = backend::TaskQueue::QueueOf(task);
+      queue != nullptr) {
+    queue->Remove(task);
+  }
+  (pinned ? worker.pinned_ : worker.shared_).Push(task, time_due);
+
+  // An idle worker recomputes when to wake up. Any idle worker may steal an
+  // unpinned task, so wake one if the chosen worker is busy.
+  if (worker.idle_ || pinned) {
+    worker.notification_.release();
+    return;
+  }
+  for (Worker& other : workers_) {
+    if (other.idle_) {
+      other.notification_.release();
+      return;
+    }
+  }
+}
+
+ThreadPoolDispatcher::Worker& ThreadPoolDispatcher::NextWorker() {
+  for (Worker& worker : workers_) {
+    if (worker.idle_ && worker.shared_.empty() && worker.pinned_.empty()) {
+      return worker;
+    }
+  }
+  Worker& worker = workers_[next_worker_];
+  next_worker_ = (next_worker_ + 1) % workers_.size();
+  return worker;
+}
+
+void ThreadPoolDispatcher::RunWorker(Worker& worker) {
+  lock_.lock();
+  while (!stop_requested_) {
+    backend::NativeTask* task = TakeDueTask(worker);
+    if (task == nullptr) {
+      // Sleep until a task may be due or the worker is notified of a new
+      // task or a stop request.
+      const chrono::SystemClock::time_point wake_time = NextWakeTime(worker);
+      worker.idle_ = true;
+      lock_.unlock();
+      worker.notification_.try_acquire_until(wake_time);
+      lock_.lock();
+      worker.idle_ = false;
+      continue;
+    }
+
+    lock_.unlock();
+    Context ctx{this, &task->task_};
+    (*task)(ctx, OkStatus());
+    lock_.lock();
+  }
+  DrainTaskQueue(worker.pinned_);
+  DrainTaskQueue(worker.shared_);
+  lock_.unlock();
+}
+
+backend::NativeTask* ThreadPoolDispatcher::TakeDueTask(Worker& worker) {
+  const chrono::SystemClock::time_point current_time = now();
+
+  // Run the worker's own tasks first, earliest due time first.
+  backend::TaskQueue* queue = nullptr;
+  for (backend::TaskQueue* own : {&worker.pinned_, &worker.shared_}) {
+    if (!own->empty() && own->front().due_time_ <= current_time &&
+        (queue == nullptr ||
+         own->front().due_time_ < queue->front().due_time_)) {
+      queue = own;
+    }
+  }
+
+  // Otherwise, steal the most overdue task from another worker.
+  if (queue == nullptr) {
+    for (Worker& other : workers_) {
+      backend::TaskQueue& shared = other.shared_;
+      if (!shared.empty() && shared.front().due_time_ <= current_time &&
+          (queue == nullptr ||
+           shared.front().due_time_ < queue->front().due_time_)) {
+        queue = &shared;
+      }
+    }
+  }
+
+  if (queue == nullptr) {
+    return nullptr;
+  }
+  backend::NativeTask& task = queue->front();
+  queue->Pop();
+  return &task;
+}
+
+chrono::SystemClock::time_point ThreadPoolDispatcher::NextWakeTime(
+    const Worker& worker) {
+  chrono::SystemClock::time_point wake_time = now() + kSleepDuration;
+  if (!worker.pinned_.empty() && worker.pinned_.front().due_time_ < wake_time) {
+    wake_time = worker.pinned_.front().due_time_;
+  }
+  for (const Worker& other : workers_) {
+    if (!other.shared_.empty() && other.shared_.front().due_time_ < wake_time) {
+      wake_time = other.shared_.front().due_time_;
+    }
+  }
+  return wake_time;
+}
+
+void ThreadPoolDispatcher::DrainTaskQueue(backend::TaskQueue& queue) {
+  while (!queue.empty()) {
+    backend::NativeTask& task = queue.front();
+    queue.Pop();
+
+    lock_.unlock();
+    Context ctx{this, &task.task_};
+    task(ctx, Status::Cancelled());
+    lock_.lock();
+  }
+}
+
+}  // namespace pw::async
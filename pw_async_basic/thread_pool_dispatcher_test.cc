@@ -0,0 +1,223 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_async_basic/thread_pool_dispatcher.h"
+
+#include <array>
+#include <atomic>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/id.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/yield.h"
+#include "pw_thread_stl/options.h"
+
+#define ASSERT_OK(status) ASSERT_EQ(OkStatus(), status)
+#define ASSERT_CANCELLED(status) ASSERT_EQ(Status::Cancelled(), status)
+
+using namespace std::chrono_literals;
+
+namespace pw::async {
+namespace {
+
+constexpr size_t kWorkers = 3;
+
+class ThreadPoolDispatcherTest : public ::testing::Test {
+ protected:
+  ThreadPoolDispatcherTest() : dispatcher_(workers_) {}
+
+  void StartWorkers() {
+    for (size_t i = 0; i < kWorkers; ++i) {
+      threads_[i].emplace(thread::stl::Options(), workers_[i]);
+    }
+  }
+
+  void StopWorkers() {
+    dispatcher_.RequestStop();
+    for (auto& thread : threads_) {
+      if (thread.has_value()) {
+        thread->join();
+        thread.reset();
+      }
+    }
+  }
+
+  // Tests must stop the workers before their tasks go out of scope.
+  void TearDown() override { StopWorkers(); }
+
+  std::array<ThreadPoolDispatcher::Worker, kWorkers> workers_;
+  ThreadPoolDispatcher dispatcher_;
+  std::array<std::optional<thread::Thread>, kWorkers> threads_;
+};
+
+// Lambdas can only capture one pointer without allocating, so the state shared
+// between tasks and tests is grouped into a struct.
+struct TestPrimitives {
+  std::atomic<int> count = 0;
+  std::atomic<int> running = 0;
+  sync::ThreadNotification notification;
+  sync::ThreadNotification started;
+  sync::ThreadNotification release;
+};
+
+TEST_F(ThreadPoolDispatcherTest, TasksRunConcurrently) {
+  StartWorkers();
+
+  // Each task waits until all of them are running, which only finishes if
+  // every worker runs a task at the same time.
+  TestPrimitives tp;
+  auto wait_for_all = [&tp]([[maybe_unused]] Context& c, Status status) {
+    ASSERT_OK(status);
+    tp.running.fetch_add(1);
+    while (tp.running.load() < static_cast<int>(kWorkers)) {
+      this_thread::yield();
+    }
+    if (tp.count.fetch_add(1) + 1 == static_cast<int>(kWorkers)) {
+      tp.notification.release();
+    }
+  };
+
+  std::array<std::optional<Task>, kWorkers> tasks;
+  for (auto& task : tasks) {
+    task.emplace(wait_for_all);
+    dispatcher_.Post(*task);
+  }
+
+  tp.notification.acquire();
+  EXPECT_EQ(tp.count.load(), static_cast<int>(kWorkers));
+  StopWorkers();
+}
+
+TEST_F(ThreadPoolDispatcherTest, UnpinnedTasksAreStolenFromBusyWorker) {
+  StartWorkers();
+
+  // Keep worker 0 busy so that the tasks given to it must be stolen.
+  TestPrimitives tp;
+  Task blocker([&tp]([[maybe_unused]] Context& c, Status status) {
+    ASSERT_OK(status);
+    tp.started.release();
+    tp.release.acquire();
+  });
+  dispatcher_.Post(blocker, 0);
+  tp.started.acquire();
+
+  constexpr int kTasks = 10;
+  auto inc_count = [&tp]([[maybe_unused]] Context& c, Status status) {
+    ASSERT_OK(status);
+    if (tp.count.fetch_add(1) + 1 == kTasks) {
+      tp.notification.release();
+    }
+  };
+  std::array<std::optional<Task>, kTasks> tasks;
+  for (auto& task : tasks) {
+    task.emplace(inc_count);
+    dispatcher_.Post(*task);
+  }
+
+  tp.notification.acquire();
+  EXPECT_EQ(tp.count.load(), kTasks);
+  tp.release.release();
+  StopWorkers();
+}
+
+struct PinnedState {
+  std::array<thread::Id, 4> ids;
+  std::array<Task*, 4> order{};
+  int count = 0;
+  sync::ThreadNotification notification;
+};
+
+TEST_F(ThreadPoolDispatcherTest, PinnedTasksRunOnOneWorkerInDueTimeOrder) {
+  StartWorkers();
+
+  PinnedState state;
+  auto record = [&state](Context& c, Status status) {
+    ASSERT_OK(status);
+    state.ids[state.count] = this_thread::get_id();
+    state.order[state.count] = c.task;
+    if (++state.count == 4) {
+      state.notification.release();
+    }
+  };
+
+  Task task0(record), task1(record), task2(record), task3(record);
+  dispatcher_.PostAfter(task0, 30ms, 2);
+  dispatcher_.PostAfter(task1, 10ms, 2);
+  dispatcher_.PostAfter(task2, 20ms, 2);
+  dispatcher_.PostAfter(task3, 20ms, 2);
+
+  state.notification.acquire();
+  EXPECT_EQ(state.order[0], &task1);
+  EXPECT_EQ(state.order[1], &task2);
+  EXPECT_EQ(state.order[2], &task3);
+  EXPECT_EQ(state.order[3], &task0);
+  for (const thread::Id& id : state.ids) {
+    EXPECT_EQ(id, state.ids[0]);
+  }
+  StopWorkers();
+}
+
+TEST_F(ThreadPoolDispatcherTest, CancelledTaskDoesNotRun) {
+  StartWorkers();
+
+  TestPrimitives tp;
+  Task cancelled([&tp]([[maybe_unused]] Context& c, Status) { ++tp.count; });
+  Task pinned([&tp]([[maybe_unused]] Context& c, Status) { ++tp.count; });
+  dispatcher_.PostAfter(cancelled, 1h);
+  dispatcher_.PostAfter(pinned, 1h, 1);
+
+  EXPECT_TRUE(dispatcher_.Cancel(cancelled));
+  EXPECT_TRUE(dispatcher_.Cancel(pinned));
+  EXPECT_FALSE(dispatcher_.Cancel(cancelled));
+
+  StopWorkers();
+  EXPECT_EQ(tp.count.load(), 0);
+}
+
+TEST_F(ThreadPoolDispatcherTest, RequestStopCancelsQueuedTasks) {
+  StartWorkers();
+
+  TestPrimitives tp;
+  auto inc_count = [&tp]([[maybe_unused]] Context& c, Status status) {
+    ASSERT_CANCELLED(status);
+    ++tp.count;
+  };
+  Task task0(inc_count), task1(inc_count), task2(inc_count);
+  dispatcher_.PostAfter(task0, 1h);
+  dispatcher_.PostAfter(task1, 1h, 0);
+  dispatcher_.PostAfter(task2, 1h, 2);
+
+  StopWorkers();
+  EXPECT_EQ(tp.count.load(), 3);
+}
+
+TEST(ThreadPoolDispatcher, DestructorCancelsQueuedTasks) {
+  int count = 0;
+  auto inc_count = [&count]([[maybe_unused]] Context& c, Status status) {
+    ASSERT_CANCELLED(status);
+    ++count;
+  };
+  Task task0(inc_count), task1(inc_count);
+  {
+    std::array<ThreadPoolDispatcher::Worker, 2> workers;
+    ThreadPoolDispatcher dispatcher(workers);
+    dispatcher.Post(task0);
+    dispatcher.PostAfter(task1, 1h, 1);
+  }
+  EXPECT_EQ(count, 2);
+}
+
+}  // namespace
+}  // namespace pw::async
@@ -15,9 +15,23 @@
 #include "pw_base64/base64.h"
 
 #include <cstdint>
+#include <cstring>
 
 #include "pw_assert/check.h"
 
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PW_BASE64_NEON 1
+#define PW_BASE64_X86_SIMD 0
+#elif defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PW_BASE64_NEON 0
+#define PW_BASE64_X86_SIMD 1
+#else
+#define PW_BASE64_NEON 0
+#define PW_BASE64_X86_SIMD 0
+#endif
+
 namespace pw::base64 {
 namespace {
 
@@ -84,13 +98,9 @@ constexpr uint8_t Byte2(uint8_t bits2, uint8_t bits3) {
   return static_cast<uint8_t>((bits2 & 0b000011) << 6) | bits3;
 }
 
-}  // namespace
-
-extern "C" void pw_Base64Encode(const void* binary_data,
-                                const size_t binary_size_bytes,
-                                char* output) {
-  const uint8_t* bytes = static_cast<const uint8_t*>(binary_data);
-
+void EncodeScalar(const uint8_t* bytes,
+                  size_t binary_size_bytes,
+                  char* output) {
   // Encode groups of 3 source bytes into 4 output characters.
   size_t remaining = binary_size_bytes;
   for (; remaining >= 3u; remaining -= 3u, bytes += 3) {
@@ -115,15 +125,11 @@ extern "C" void pw_Base64Encode(const void* binary_data,
   }
 }
 
-extern "C" size_t pw_Base64Decode(const char* base64,
-                                  size_t base64_size_bytes,
-                                  void* output) {
-  // If too small, can't be valid input, due to likely missing padding
-  if (base64_size_bytes < 4) {
-    return 0;
-  }
-
-  uint8_t* binary = static_cast<uint8_t*>(output);
+// Decodes 4-character groups without checking for padding. Returns a pointer
+// past the last decoded byte.
+uint8_t* DecodeScalar(const char* base64,
+                      size_t base64_size_bytes,
+                      uint8_t* binary) {
   for (size_t ch = 0; ch < base64_size_bytes; ch += kEncodedGroupSize) {
     const uint8_t char0 = CharToBits(base64[ch + 0]);
     const uint8_t char1 = CharToBits(base64[ch + 1]);
@@ -134,22 +140,20 @@ extern "C" size_t pw_Base64Decode(const char* base64,
     *binary++ = Byte1(char1, char2);
     *binary++ = Byte2(char2, char3);
   }
+  return binary;
+}
 
-  size_t pad = 0;
+size_t PaddingSize(const char* base64, size_t base64_size_bytes) {
   if (base64[base64_size_bytes - 2] == kPadding) {
-    pad = 2;
-  } else if (base64[base64_size_bytes - 1] == kPadding) {
-    pad = 1;
+    return 2;
   }
-
-  return static_cast<size_t>(binary - static_cast<uint8_t*>(output)) - pad;
-}
-
-extern "C" bool pw_Base64IsValid(const char* base64_data, size_t base64_size) {
-  if (base64_size % kEncodedGroupSize != 0) {
-    return false;
+  if (base64[base64_size_bytes - 1] == kPadding) {
+    return 1;
   }
+  return 0;
+}
 
+bool IsValidScalar(const char* base64_data, size_t base64_size) {
   for (size_t i = 0; i < base64_size; ++i) {
     if (base64_data[i] < kMinValidChar || base64_data[i] > kMaxValidChar ||
         CharToBits(base64_data[i]) == kX /* invalid char */) {
@@ -159,6 +163,495 @@ extern "C" bool pw_Base64IsValid(const char* base64_data, size_t base64_size) {
   return true;
 }
 
+// The SIMD implementations below handle the bulk of long inputs and return how
+// much of the input they processed. The scalar code handles the rest,
+// including the final group, which may be padded. Decoding always leaves at
+// least the final group to the scalar code, so padding never reaches SIMD
+// registers.
+//
+// Like the scalar code, the SIMD decoders accept the standard (+/) and URL-safe
+// (-_) alphabets and decode '=' as 0. They do not validate their input, but the
+// same character classification is used to validate in IsValidSimd.
+
+#if PW_BASE64_NEON
+
+// Returns 0xFF for each character in [lo, hi].
+inline uint8x16_t InRange(uint8x16_t chars, uint8_t lo, uint8_t hi) {
+  return vandq_u8(vcgeq_u8(chars, vdupq_n_u8(lo)),
+                  vcleq_u8(chars, vdupq_n_u8(hi)));
+}
+
+// Classifies 16 characters. Returns their 6-bit values and sets valid to 0xFF
+// for each valid character.
+inline uint8x16_t CharsToBits(uint8x16_t chars, uint8x16_t& valid) {
+  const uint8x16_t upper = InRange(chars, 'A', 'Z');
+  const uint8x16_t lower = InRange(chars, 'a', 'z');
+  const uint8x16_t digit = InRange(chars, '0', '9');
+  const uint8x16_t is_62 = vorrq_u8(vceqq_u8(chars, vdupq_n_u8('+')),
+                                    vceqq_u8(chars, vdupq_n_u8('-')));
+  const uint8x16_t is_63 = vorrq_u8(vceqq_u8(chars, vdupq_n_u8('/')),
+                                    vceqq_u8(chars, vdupq_n_u8('_')));
+
+  // Letters and digits are contiguous, so they are decoded by adding an offset.
+  const uint8x16_t offset = vorrq_u8(
+      vandq_u8(upper, vdupq_n_u8(static_cast<uint8_t>(-'A'))),
+      vorrq_u8(vandq_u8(lower, vdupq_n_u8(static_cast<uint8_t>(26 - 'a'))),
+               vandq_u8(digit, vdupq_n_u8(static_cast<uint8_t>(52 - '0')))));
+  const uint8x16_t alphanumeric = vorrq_u8(upper, vorrq_u8(lower, digit));
+
+  valid = vorrq_u8(vorrq_u8(alphanumeric, vceqq_u8(chars, vdupq_n_u8('='))),
+                   vorrq_u8(is_62, is_63));
+  return vorrq_u8(vandq_u8(vaddq_u8(chars, offset), alphanumeric),
+                  vorrq_u8(vandq_u8(is_62, vdupq_n_u8(62)),
+                           vandq_u8(is_63, vdupq_n_u8(63))));
+}
+
+// Encodes 48 bytes into 64 characters per iteration.
+size_t EncodeSimd(const uint8_t* bytes, size_t size_bytes, char* output) {
+  const uint8_t* table = reinterpret_cast<const uint8_t*>(kEncodeTable);
+  const uint8x16x4_t lookup = {{vld1q_u8(table),
+                                vld1q_u8(table + 16),
+                                vld1q_u8(table + 32),
+                                vld1q_u8(table + 48)}};
+  const uint8x16_t low_6_bits = vdupq_n_u8(0b111111);
+
+  size_t done = 0;
+  for (; size_bytes - done >= 48u; done += 48u, output += 64) {
+    const uint8x16x3_t in = vld3q_u8(bytes + done);
+
+    uint8x16x4_t out;
+    out.val[0] = vshrq_n_u8(in.val[0], 2);
+    out.val[1] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)),
+        low_6_bits);
+    out.val[2] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)),
+        low_6_bits);
+    out.val[3] = vandq_u8(in.val[2], low_6_bits);
+
+    for (uint8x16_t& value : out.val) {
+      value = vqtbl4q_u8(lookup, value);
+    }
+    vst4q_u8(reinterpret_cast<uint8_t*>(output), out);
+  }
+  return done;
+}
+
+// Decodes 64 characters into 48 bytes per iteration.
+size_t DecodeSimd(const char* base64, size_t size_bytes, uint8_t* binary) {
+  size_t done = 0;
+  for (; size_bytes - done >= 64u + kEncodedGroupSize; done += 64u) {
+    const uint8x16x4_t in =
+        vld4q_u8(reinterpret_cast<const uint8_t*>(base64) + done);
+    uint8x16_t valid;
+    const uint8x16_t bits0 = CharsToBits(in.val[0], valid);
+    const uint8x16_t bits1 = CharsToBits(in.val[1], valid);
+    const uint8x16_t bits2 = CharsToBits(in.val[2], valid);
+    const uint8x16_t bits3 = CharsToBits(in.val[3], valid);
+
+    uint8x16x3_t out;
+    out.val[0] = vorrq_u8(vshlq_n_u8(bits0, 2), vshrq_n_u8(bits1, 4));
+    out.val[1] = vorrq_u8(vshlq_n_u8(bits1, 4), vshrq_n_u8(bits2, 2));
+    out.val[2] = vorrq_u8(vshlq_n_u8(bits2, 6), bits3);
+    vst3q_u8(binary, out);
+    binary += 48;
+  }
+  return done;
+}
+
+// Returns the number of leading characters, in multiples of 16, that were
+// checked and are all valid.
+size_t IsValidSimd(const char* base64, size_t size_bytes) {
+  size_t done = 0;
+  for (; size_bytes - done >= 16u; done += 16u) {
+    uint8x16_t valid;
+    CharsToBits(vld1q_u8(reinterpret_cast<const uint8_t*>(base64) + done),
+                valid);
+    if (vminvq_u8(valid) != 0xFFu) {
+      break;
+    }
+  }
+  return done;
+}
+
+#elif PW_BASE64_X86_SIMD
+
+#define PW_BASE64_SSSE3_TARGET __attribute__((target("ssse3")))
+#define PW_BASE64_AVX2_TARGET __attribute__((target("avx2")))
+
+bool CpuSupportsSsse3() {
+  static const bool supported = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+  }();
+  return supported;
+}
+
+bool CpuSupportsAvx2() {
+  static const bool supported = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+  }();
+  return supported;
+}
+
+// The 128-bit and 256-bit implementations follow the same steps, described in
+// "Faster Base64 Encoding and Decoding Using AVX2 Instructions" by Muła and
+// Lemire. The 256-bit versions operate on two independent 128-bit lanes.
+
+// Returns 0xFF for each character in [lo, hi]. Characters above 0x7F are
+// negative, so they never match.
+PW_BASE64_SSSE3_TARGET inline __m128i InRange(__m128i chars, char lo, char hi) {
+  return _mm_and_si128(
+      _mm_cmpgt_epi8(chars, _mm_set1_epi8(static_cast<char>(lo - 1))),
+      _mm_cmplt_epi8(chars, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+PW_BASE64_AVX2_TARGET inline __m256i InRange(__m256i chars, char lo, char hi) {
+  return _mm256_and_si256(
+      _mm256_cmpgt_epi8(chars, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+      _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), chars));
+}
+
+// Classifies 16 characters. Returns their 6-bit values and sets valid to 0xFF
+// for each valid character.
+PW_BASE64_SSSE3_TARGET inline __m128i CharsToBits(__m128i chars,
+                                                  __m128i& valid) {
+  const __m128i upper = InRange(chars, 'A', 'Z');
+  const __m128i lower = InRange(chars, 'a', 'z');
+  const __m128i digit = InRange(chars, '0', '9');
+  const __m128i is_62 = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('+')),
+                                     _mm_cmpeq_epi8(chars, _mm_set1_epi8('-')));
+  const __m128i is_63 = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('/')),
+                                     _mm_cmpeq_epi8(chars, _mm_set1_epi8('_')));
+
+  // Letters and digits are contiguous, so they are decoded by adding an offset.
+  const __m128i offset = _mm_or_si128(
+      _mm_and_si128(upper, _mm_set1_epi8(static_cast<char>(-'A'))),
+      _mm_or_si128(
+          _mm_and_si128(lower, _mm_set1_epi8(static_cast<char>(26 - 'a'))),
+          _mm_and_si128(digit, _mm_set1_epi8(static_cast<char>(52 - '0')))));
+  const __m128i alphanumeric = _mm_or_si128(upper, _mm_or_si128(lower, digit));
+
+  valid = _mm_or_si128(
+      _mm_or_si128(alphanumeric, _mm_cmpeq_epi8(chars, _mm_set1_epi8('='))),
+      _mm_or_si128(is_62, is_63));
+  return _mm_or_si128(
+      _mm_and_si128(_mm_add_epi8(chars, offset), alphanumeric),
+      _mm_or_si128(_mm_and_si128(is_62, _mm_set1_epi8(62)),
+                   _mm_and_si128(is_63, _mm_set1_epi8(63))));
+}
+
+PW_BASE64_AVX2_TARGET inline __m256i CharsToBits(__m256i chars,
+                                                 __m256i& valid) {
+  const __m256i upper = InRange(chars, 'A', 'Z');
+  const __m256i lower = InRange(chars, 'a', 'z');
+  const __m256i digit = InRange(chars, '0', '9');
+  const __m256i is_62 =
+      _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('+')),
+                      _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('-')));
+  const __m256i is_63 =
+      _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/')),
+                      _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('_')));
+
+  const __m256i offset = _mm256_or_si256(
+      _mm256_and_si256(upper, _mm256_set1_epi8(static_cast<char>(-'A'))),
+      _mm256_or_si256(
+          _mm256_and_si256(lower,
+                           _mm256_set1_epi8(static_cast<char>(26 - 'a'))),
+          _mm256_and_si256(digit,
+                           _mm256_set1_epi8(static_cast<char>(52 - '0')))));
+  const __m256i alphanumeric =
+      _mm256_or_si256(upper, _mm256_or_si256(lower, digit));
+
+  valid = _mm256_or_si256(
+      _mm256_or_si256(alphanumeric,
+                      _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('='))),
+      _mm256_or_si256(is_62, is_63));
+  return _mm256_or_si256(
+      _mm256_and_si256(_mm256_add_epi8(chars, offset), alphanumeric),
+      _mm256_or_si256(_mm256_and_si256(is_62, _mm256_set1_epi8(62)),
+                      _mm256_and_si256(is_63, _mm256_set1_epi8(63))));
+}
+
+// Splits each 3-byte group, duplicated into a 32-bit lane as [b1, b0, b2, b1],
+// into four 6-bit indices.
+PW_BASE64_SSSE3_TARGET inline __m128i ToIndices(__m128i in) {
+  const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(t1, t3);
+}
+
+PW_BASE64_AVX2_TARGET inline __m256i ToIndices(__m256i in) {
+  const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+  const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+  const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+  const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+  return _mm256_or_si256(t1, t3);
+}
+
+// Maps 6-bit indices to characters by adding a per-range offset, which is
+// looked up from a reduced index: 0-25 -> 13, 26-51 -> 0, 52-61 -> 1-10,
+// 62 -> 11, 63 -> 12.
+PW_BASE64_SSSE3_TARGET inline __m128i IndicesToChars(__m128i indices) {
+  const __m128i offsets = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, kChar62 - 62, kChar63 - 63, 'A',
+      0, 0);
+  __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  const __m128i is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  reduced = _mm_or_si128(reduced, _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+  return _mm_add_epi8(_mm_shuffle_epi8(offsets, reduced), indices);
+}
+
+PW_BASE64_AVX2_TARGET inline __m256i IndicesToChars(__m256i indices) {
+  const __m256i offsets = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, kChar62 - 62, kChar63 - 63, 'A',
+      0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, kChar62 - 62,
+      kChar63 - 63, 'A', 0, 0);
+  __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+  const __m256i is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+  reduced = _mm256_or_si256(reduced,
+                            _mm256_and_si256(is_upper, _mm256_set1_epi8(13)));
+  return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, reduced), indices);
+}
+
+// Packs four 6-bit values in each 32-bit lane into 3 bytes at the start of
+// each 128-bit lane.
+PW_BASE64_SSSE3_TARGET inline __m128i PackBits(__m128i bits) {
+  const __m128i merged = _mm_maddubs_epi16(bits, _mm_set1_epi32(0x01400140));
+  const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+  return _mm_shuffle_epi8(
+      packed,
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+PW_BASE64_AVX2_TARGET inline __m256i PackBits(__m256i bits) {
+  const __m256i merged =
+      _mm256_maddubs_epi16(bits, _mm256_set1_epi32(0x01400140));
+  const __m256i packed =
+      _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+  return _mm256_shuffle_epi8(
+      packed,
+      _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                       2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+// Encodes 12 bytes into 16 characters per iteration. Reads 16 bytes at a time.
+PW_BASE64_SSSE3_TARGET size_t EncodeSsse3(const uint8_t* bytes,
+                                          size_t size_bytes,
+                                          char* output) {
+  const __m128i shuffle =
+      _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  size_t done = 0;
+  for (; size_bytes - done >= 16u; done += 12u, output += 16) {
+    const __m128i in = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + done)),
+        shuffle);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+                     IndicesToChars(ToIndices(in)));
+  }
+  return done;
+}
+
+// Encodes 24 bytes into 32 characters per iteration, then finishes with SSSE3.
+PW_BASE64_AVX2_TARGET size_t EncodeAvx2(const uint8_t* bytes,
+                                        size_t size_bytes,
+                                        char* output) {
+  const __m256i shuffle =
+      _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                       1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  size_t done = 0;
+  for (; size_bytes - done >= 28u; done += 24u, output += 32) {
+    const __m128i low =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + done));
+    const __m128i high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + done + 12));
+    const __m256i in = _mm256_shuffle_epi8(
+        _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1),
+        shuffle);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output),
+                        IndicesToChars(ToIndices(in)));
+  }
+  return done + EncodeSsse3(bytes + done, size_bytes - done, output);
+}
+
+PW_BASE64_SSSE3_TARGET size_t DecodeSsse3(const char* base64,
+                                          size_t size_bytes,
+                                          uint8_t* binary) {
+  size_t done = 0;
+  for (; size_bytes - done >= 16u + kEncodedGroupSize; done += 16u) {
+    __m128i valid;
+    const __m128i out = PackBits(CharsToBits(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(base64 + done)),
+        valid));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(binary), out);
+    const int last_bytes = _mm_cvtsi128_si32(_mm_srli_si128(out, 8));
+    std::memcpy(binary + 8, &last_bytes, 4);
+    binary += 12;
+  }
+  return done;
+}
+
+PW_BASE64_AVX2_TARGET size_t DecodeAvx2(const char* base64,
+                                        size_t size_bytes,
+                                        uint8_t* binary) {
+  size_t done = 0;
+  for (; size_bytes - done >= 32u + kEncodedGroupSize; done += 32u) {
+    __m256i valid;
+    __m256i out = PackBits(CharsToBits(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base64 + done)),
+        valid));
+    // Move the 12 bytes from each lane into the low 24 bytes.
+    out = _mm256_permutevar8x32_epi32(
+        out, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(binary),
+                     _mm256_castsi256_si128(out));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(binary + 16),
+                     _mm256_extracti128_si256(out, 1));
+    binary += 24;
+  }
+  return done + DecodeSsse3(base64 + done, size_bytes - done, binary);
+}
+
+PW_BASE64_SSSE3_TARGET size_t IsValidSsse3(const char* base64,
+                                           size_t size_bytes) {
+  size_t done = 0;
+  for (; size_bytes - done >= 16u; done += 16u) {
+    __m128i valid;
+    CharsToBits(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(base64 + done)),
+        valid);
+    if (_mm_movemask_epi8(valid) != 0xFFFF) {
+      break;
+    }
+  }
+  return done;
+}
+
+PW_BASE64_AVX2_TARGET size_t IsValidAvx2(const char* base64,
+                                         size_t size_bytes) {
+  size_t done = 0;
+  for (; size_bytes - done >= 32u; done += 32u) {
+    __m256i valid;
+    CharsToBits(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base64 + done)),
+        valid);
+    if (_mm256_movemask_epi8(valid) != -1) {
+      return done;
+    }
+  }
+  return done + IsValidSsse3(base64 + done, size_bytes - done);
+}
+
+size_t EncodeSimd(const uint8_t* bytes, size_t size_bytes, char* output) {
+  if (CpuSupportsAvx2()) {
+    return EncodeAvx2(bytes, size_bytes, output);
+  }
+  if (CpuSupportsSsse3()) {
+    return EncodeSsse3(bytes, size_bytes, output);
+  }
+  return 0;
+}
+
+size_t DecodeSimd(const char* base64, size_t size_bytes, uint8_t* binary) {
+  if (CpuSupportsAvx2()) {
+    return DecodeAvx2(base64, size_bytes, binary);
+  }
+  if (CpuSupportsSsse3()) {
+    return DecodeSsse3(base64, size_bytes, binary);
+  }
+  return 0;
+}
+
+size_t IsValidSimd(const char* base64, size_t size_bytes) {
+  if (CpuSupportsAvx2()) {
+    return IsValidAvx2(base64, size_bytes);
+  }
+  if (CpuSupportsSsse3()) {
+    return IsValidSsse3(base64, size_bytes);
+  }
+  return 0;
+}
+
+#else
+
+size_t EncodeSimd(const uint8_t*, size_t, char*) { return 0; }
+
+size_t DecodeSimd(const char*, size_t, uint8_t*) { return 0; }
+
+size_t IsValidSimd(const char*, size_t) { return 0; }
+
+#endif  // PW_BASE64_NEON
+
+}  // namespace
+
+extern "C" void pw_Base64Encode(const void* binary_data,
+                                const size_t binary_size_bytes,
+                                char* output) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(binary_data);
+  const size_t simd_bytes = EncodeSimd(bytes, binary_size_bytes, output);
+  EncodeScalar(bytes + simd_bytes,
+               binary_size_bytes - simd_bytes,
+               output + simd_bytes / 3 * 4);
+}
+
+extern "C" size_t pw_Base64Decode(const char* base64,
+                                  size_t base64_size_bytes,
+                                  void* output) {
+  // If too small, can't be valid input, due to likely missing padding
+  if (base64_size_bytes < 4) {
+    return 0;
+  }
+
+  uint8_t* binary = static_cast<uint8_t*>(output);
+  const size_t simd_chars = DecodeSimd(base64, base64_size_bytes, binary);
+  binary = DecodeScalar(base64 + simd_chars,
+                        base64_size_bytes - simd_chars,
+                        binary + simd_chars / 4 * 3);
+
+  return static_cast<size_t>(binary - static_cast<uint8_t*>(output)) -
+         PaddingSize(base64, base64_size_bytes);
+}
+
+extern "C" bool pw_Base64IsValid(const char* base64_data, size_t base64_size) {
+  if (base64_size % kEncodedGroupSize != 0) {
+    return false;
+  }
+
+  const size_t simd_chars = IsValidSimd(base64_data, base64_size);
+  return IsValidScalar(base64_data + simd_chars, base64_size - simd_chars);
+}
+
+extern "C" void _pw_base64_InternalEncodeScalar(const void* binary_data,
+                                                size_t binary_size_bytes,
+                                                char* output) {
+  EncodeScalar(
+      static_cast<const uint8_t*>(binary_data), binary_size_bytes, output);
+}
+
+extern "C" size_t _pw_base64_InternalDecodeScalar(const char* base64,
+                                                  size_t base64_size_bytes,
+                                                  void* output) {
+  if (base64_size_bytes < 4) {
+    return 0;
+  }
+  uint8_t* const binary = static_cast<uint8_t*>(output);
+  return static_cast<size_t>(
+             DecodeScalar(base64, base64_size_bytes, binary) - binary) -
+         PaddingSize(base64, base64_size_bytes);
+}
+
+extern "C" bool _pw_base64_InternalIsValidScalar(const char* base64_data,
+                                                 size_t base64_size) {
+  return base64_size % kEncodedGroupSize == 0 &&
+         IsValidScalar(base64_data, base64_size);
+}
+
 size_t Encode(span<const std::byte> binary, span<char> output_buffer) {
   const size_t required_size = EncodedSize(binary.size_bytes());
   if (output_buffer.size_bytes() < required_size) {
@@ -0,0 +1,98 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "pw_base64/base64.h"
+#include "pw_bytes/array.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+
+namespace pw::base64 {
+namespace {
+
+// Short data, like a tokenized log, and long data, like a bulk transfer.
+constexpr auto kShortBytes = bytes::Initialized<24>([](size_t i) { return i; });
+constexpr auto kLongBytes =
+    bytes::Initialized<1200>([](size_t i) { return i * 7; });
+
+template <size_t kSize>
+std::array<char, EncodedSize(kSize)> EncodedData(
+    const std::array<std::byte, kSize>& data) {
+  std::array<char, EncodedSize(kSize)> encoded;
+  Encode(data, encoded.data());
+  return encoded;
+}
+
+const auto kShortEncoded = EncodedData(kShortBytes);
+const auto kLongEncoded = EncodedData(kLongBytes);
+
+std::array<char, EncodedSize(1200)> encode_output;
+std::array<std::byte, 1200> decode_output;
+
+void EncodeTest(perf_test::State& state, span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    pw_Base64Encode(data.data(), data.size(), encode_output.data());
+  }
+}
+
+void EncodeScalarTest(perf_test::State& state, span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    _pw_base64_InternalEncodeScalar(
+        data.data(), data.size(), encode_output.data());
+  }
+}
+
+void DecodeTest(perf_test::State& state, span<const char> base64) {
+  while (state.KeepRunning()) {
+    pw_Base64Decode(base64.data(), base64.size(), decode_output.data());
+  }
+}
+
+void DecodeScalarTest(perf_test::State& state, span<const char> base64) {
+  while (state.KeepRunning()) {
+    _pw_base64_InternalDecodeScalar(
+        base64.data(), base64.size(), decode_output.data());
+  }
+}
+
+void IsValidTest(perf_test::State& state, span<const char> base64) {
+  while (state.KeepRunning()) {
+    pw_Base64IsValid(base64.data(), base64.size());
+  }
+}
+
+void IsValidScalarTest(perf_test::State& state, span<const char> base64) {
+  while (state.KeepRunning()) {
+    _pw_base64_InternalIsValidScalar(base64.data(), base64.size());
+  }
+}
+
+PW_PERF_TEST(EncodeShort, EncodeTest, kShortBytes);
+PW_PERF_TEST(EncodeScalarShort, EncodeScalarTest, kShortBytes);
+PW_PERF_TEST(EncodeLong, EncodeTest, kLongBytes);
+PW_PERF_TEST(EncodeScalarLong, EncodeScalarTest, kLongBytes);
+
+PW_PERF_TEST(DecodeShort, DecodeTest, kShortEncoded);
+PW_PERF_TEST(DecodeScalarShort, DecodeScalarTest, kShortEncoded);
+PW_PERF_TEST(DecodeLong, DecodeTest, kLongEncoded);
+PW_PERF_TEST(DecodeScalarLong, DecodeScalarTest, kLongEncoded);
+
+PW_PERF_TEST(IsValidLong, IsValidTest, kLongEncoded);
+PW_PERF_TEST(IsValidScalarLong, IsValidScalarTest, kLongEncoded);
+
+}  // namespace
+}  // namespace pw::base64
@@ -14,6 +14,8 @@
 
 #include "pw_base64/base64.h"
 
+#include <array>
+#include <cstdint>
 #include <cstring>
 
 #include "gtest/gtest.h"
@@ -393,6 +395,104 @@ bool pw_Base64CallIsValid(const char* base64_data, size_t base64_size);
 
 constexpr const char kBase64[] = "aaaabbbbcc#%";
 
+// Long inputs are processed with SIMD instructions on some platforms. Compare
+// against the scalar implementation for every size and alignment up to a few
+// SIMD blocks, so that every block and tail combination is covered.
+constexpr size_t kLongDataSize = 300;
+
+std::array<std::byte, kLongDataSize> LongData() {
+  std::array<std::byte, kLongDataSize> data{};
+  uint32_t state = 0x12345678;
+  for (std::byte& b : data) {
+    state = state * 1103515245u + 12345u;
+    b = static_cast<std::byte>(state >> 24);
+  }
+  return data;
+}
+
+TEST(Base64, Encode_LongData_MatchesScalar) {
+  const auto data = LongData();
+  char expected[EncodedSize(kLongDataSize)];
+  char actual[EncodedSize(kLongDataSize)];
+
+  for (size_t offset = 0; offset < 4; ++offset) {
+    for (size_t size = 0; size <= kLongDataSize - offset; ++size) {
+      _pw_base64_InternalEncodeScalar(data.data() + offset, size, expected);
+      std::memset(actual, '?', sizeof(actual));
+      Encode(span(data).subspan(offset, size), actual);
+      ASSERT_EQ(0, std::memcmp(expected, actual, EncodedSize(size)));
+      if (EncodedSize(size) < sizeof(actual)) {
+        EXPECT_EQ(actual[EncodedSize(size)], '?');  // No overrun
+      }
+    }
+  }
+}
+
+TEST(Base64, Decode_LongData_RoundTrip) {
+  const auto data = LongData();
+  char encoded[EncodedSize(kLongDataSize)];
+  std::byte decoded[MaxDecodedSize(EncodedSize(kLongDataSize)) + 1];
+
+  for (size_t size = 0; size <= kLongDataSize; ++size) {
+    const std::string_view base64(encoded, EncodedSize(size));
+    Encode(span(data).first(size), encoded);
+    ASSERT_TRUE(IsValid(base64));
+
+    std::memset(decoded, 0xAA, sizeof(decoded));
+    ASSERT_EQ(size, Decode(base64, decoded));
+    ASSERT_EQ(0, std::memcmp(data.data(), decoded, size));
+    // The output may be written up to MaxDecodedSize(), but not past it.
+    EXPECT_EQ(decoded[MaxDecodedSize(base64.size())], std::byte{0xAA});
+
+    ASSERT_EQ(
+        size,
+        _pw_base64_InternalDecodeScalar(base64.data(), base64.size(), decoded));
+    ASSERT_EQ(0, std::memcmp(data.data(), decoded, size));
+  }
+}
+
+TEST(Base64, Decode_LongData_UrlSafe) {
+  const auto data = LongData();
+  char encoded[EncodedSize(kLongDataSize)];
+  Encode(data, encoded);
+  for (char& c : encoded) {
+    c = c == '+' ? '-' : c == '/' ? '_' : c;
+  }
+
+  std::byte decoded[kLongDataSize];
+  const std::string_view base64(encoded, sizeof(encoded));
+  ASSERT_TRUE(IsValid(base64));
+  ASSERT_EQ(kLongDataSize, Decode(base64, decoded));
+  EXPECT_EQ(0, std::memcmp(data.data(), decoded, kLongDataSize));
+}
+
+TEST(Base64, Decode_LongData_InPlace) {
+  const auto data = LongData();
+  char buffer[EncodedSize(kLongDataSize)];
+  Encode(data, buffer);
+  ASSERT_EQ(kLongDataSize, Decode(std::string_view(buffer, sizeof(buffer)),
+                                  reinterpret_cast<std::byte*>(buffer)));
+  EXPECT_EQ(0, std::memcmp(data.data(), buffer, kLongDataSize));
+}
+
+TEST(Base64, IsValid_LongData_InvalidCharacterAnywhere) {
+  const auto data = LongData();
+  char encoded[EncodedSize(kLongDataSize)];
+  Encode(data, encoded);
+  const std::string_view base64(encoded, sizeof(encoded));
+
+  for (char invalid : {'\0', '!', '.', '@', '[', '`', '{', '\x80', '\xff'}) {
+    for (size_t i = 0; i < sizeof(encoded); ++i) {
+      const char original = encoded[i];
+      encoded[i] = invalid;
+      ASSERT_FALSE(IsValid(base64));
+      ASSERT_FALSE(_pw_base64_InternalIsValidScalar(encoded, sizeof(encoded)));
+      encoded[i] = original;
+    }
+  }
+  EXPECT_TRUE(IsValid(base64));
+}
+
 // Ensure that the C API works correctly from a C-only context.
 TEST(Base64, IsValid_Ok) {
   EXPECT_TRUE(IsValid(std::string_view(kBase64, 4)));
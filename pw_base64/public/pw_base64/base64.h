@@ -59,6 +59,18 @@ size_t pw_Base64Decode(const char* base64,
 // Equivalent to pw::base64::IsValid().
 bool pw_Base64IsValid(const char* base64_data, size_t base64_size);
 
+// The functions above use SIMD instructions for long inputs when they are
+// available (SSSE3 or AVX2 on x86-64, NEON on AArch64). These always use the
+// portable scalar code. They are provided for tests and benchmarks.
+void _pw_base64_InternalEncodeScalar(const void* binary_data,
+                                     size_t binary_size_bytes,
+                                     char* output);
+size_t _pw_base64_InternalDecodeScalar(const char* base64,
+                                       size_t base64_size_bytes,
+                                       void* output);
+bool _pw_base64_InternalIsValidScalar(const char* base64_data,
+                                      size_t base64_size);
+
 // C++ API, which uses the C functions internally.
 #ifdef __cplusplus
 }  // extern "C"
@@ -0,0 +1,174 @@
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Pairs the size of each variant of a module with its measured speed.
+
+Sizes come from the .binary_sizes.json output of pw_size_report targets.
+Speeds come from the output of perf tests built with
+pw_perf_test:json_perf_handler_main, one JSON object per line, captured from a
+run on the same target. Lines which are not JSON objects, such as logs, are
+ignored.
+"""
+
+import argparse
+from dataclasses import dataclass
+import json
+import logging
+from pathlib import Path
+import sys
+from typing import Dict, Iterable, List, Optional, Sequence, Tuple
+
+import pw_cli.log
+
+_LOG = logging.getLogger(__package__)
+
+
+@dataclass(frozen=True)
+class Speed:
+    """The median duration of one perf test case."""
+
+    median: int
+    unit: str
+
+
+@dataclass(frozen=True)
+class Row:
+    """One variant in the report."""
+
+    label: str
+    size: int
+    speed: Optional[Speed]
+
+
+def binary_size(sizes: Dict[str, int], region: Optional[str]) -> int:
+    """Sums the sizes of a binary's labels, or only those of one region.
+
+    Keys in .binary_sizes.json are "<binary> <label>".
+    """
+    if region is None:
+        return sum(sizes.values())
+
+    matches = [
+        size
+        for key, size in sizes.items()
+        if key.rsplit(' ', 1)[-1] == region
+    ]
+    if not matches:
+        labels = sorted({key.rsplit(' ', 1)[-1] for key in sizes})
+        raise ValueError(
+            f'No "{region}" size in the report; it has {", ".join(labels)}'
+        )
+    return sum(matches)
+
+
+def parse_perf_results(lines: Iterable[str]) -> Dict[str, Speed]:
+    """Reads perf test results keyed by "name" or "name/parameter"."""
+    results: Dict[str, Speed] = {}
+    for line in lines:
+        line = line.strip()
+        if not line.startswith('{'):
+            continue
+        try:
+            entry = json.loads(line)
+            name = entry['name']
+            if entry.get('parameter') is not None:
+                name = f'{name}/{entry["parameter"]}'
+            results[name] = Speed(median=entry['median'], unit=entry['unit'])
+        except (json.JSONDecodeError, KeyError, TypeError):
+            continue
+    return results
+
+
+def format_table(rows: Sequence[Row]) -> str:
+    """Formats the rows as a ReST simple table."""
+    cells: List[Tuple[str, str, str]] = [('Variant', 'Bytes', 'Time / op')]
+    for row in rows:
+        speed = (
+            f'{row.speed.median} {row.speed.unit}'
+            if row.speed is not None
+            else 'n/a'
+        )
+        cells.append((row.label, f'{row.size:,}', speed))
+
+    widths = [max(len(cell[i]) for cell in cells) for i in range(3)]
+    border = '  '.join('=' * width for width in widths)
+
+    def format_row(cell: Tuple[str, str, str]) -> str:
+        return (
+            f'{cell[0]:<{widths[0]}}  {cell[1]:>{widths[1]}}  '
+            f'{cell[2]:>{widths[2]}}'
+        ).rstrip()
+
+    lines = [border, format_row(cells[0]), border]
+    lines += [format_row(cell) for cell in cells[1:]]
+    lines.append(border)
+    return '\n'.join(lines) + '\n'
+
+
+def _parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        '--perf-results',
+        type=Path,
+        required=True,
+        help='Output of the perf tests, one JSON result per line',
+    )
+    parser.add_argument(
+        '--variant',
+        nargs=3,
+        action='append',
+        required=True,
+        metavar=('LABEL', 'BINARY_SIZES_JSON', 'PERF_TEST'),
+        help='A variant, its size report JSON, and the perf test timing it',
+    )
+    parser.add_argument(
+        '--region',
+        help='Only count this label of the size reports, such as FLASH',
+    )
+    parser.add_argument(
+        '--output', type=Path, required=True, help='Output ReST table'
+    )
+    return parser.parse_args()
+
+
+def main(
+    perf_results: Path,
+    variant: List[List[str]],
+    region: Optional[str],
+    output: Path,
+) -> int:
+    with perf_results.open() as file:
+        speeds = parse_perf_results(file)
+
+    rows: List[Row] = []
+    for label, sizes_json, perf_test in variant:
+        try:
+            size = binary_size(json.loads(Path(sizes_json).read_text()), region)
+        except (OSError, ValueError) as error:
+            _LOG.error('%s: %s', label, error)
+            return 1
+
+        speed = speeds.get(perf_test)
+        if speed is None:
+            _LOG.warning('%s: no result for perf test %s', label, perf_test)
+        rows.append(Row(label, size, speed))
+
+    table = format_table(rows)
+    output.write_text(table)
+    print(table, end='')
+    return 0
+
+
+if __name__ == '__main__':
+    pw_cli.log.install()
+    sys.exit(main(**vars(_parse_args())))
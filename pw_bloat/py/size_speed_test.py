@@ -0,0 +1,80 @@
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for the size and speed report."""
+
+import unittest
+
+from pw_bloat.size_speed import (
+    Row,
+    Speed,
+    binary_size,
+    format_table,
+    parse_perf_results,
+)
+
+_SIZES = {
+    'out/crc32_8bit.elf FLASH': 1200,
+    'out/crc32_8bit.elf RAM': 64,
+}
+
+
+class SizeSpeedTest(unittest.TestCase):
+    """Tests pairing size reports with perf test results."""
+
+    def test_binary_size_total(self):
+        self.assertEqual(binary_size(_SIZES, None), 1264)
+
+    def test_binary_size_region(self):
+        self.assertEqual(binary_size(_SIZES, 'FLASH'), 1200)
+        with self.assertRaises(ValueError):
+            binary_size(_SIZES, 'ROM')
+
+    def test_parse_perf_results(self):
+        results = parse_perf_results(
+            [
+                'INF  Running perf tests',
+                '{"name": "Crc32_8Bit", "unit": "cycles", "median": 900}',
+                '{"name": "Crc32", "parameter": 4, "unit": "ns", '
+                '"median": 12}',
+                '{"name": "Broken"',
+            ]
+        )
+        self.assertEqual(
+            results,
+            {
+                'Crc32_8Bit': Speed(median=900, unit='cycles'),
+                'Crc32/4': Speed(median=12, unit='ns'),
+            },
+        )
+
+    def test_format_table(self):
+        table = format_table(
+            [
+                Row('8-bit table', 1200, Speed(median=900, unit='cycles')),
+                Row('1-bit', 80, None),
+            ]
+        )
+        self.assertEqual(
+            table,
+            '===========  =====  ==========\n'
+            'Variant      Bytes   Time / op\n'
+            '===========  =====  ==========\n'
+            '8-bit table  1,200  900 cycles\n'
+            '1-bit           80         n/a\n'
+            '===========  =====  ==========\n',
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,38 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_blob_store/async_flash_writer.h"
+
+namespace pw::blob_store {
+
+Status AsyncFlashWriter::DoStartWrite(kvs::FlashPartition& partition,
+                                      kvs::FlashPartition::Address address,
+                                      ConstByteSpan data) {
+  if (!partition.writable()) {
+    return Status::PermissionDenied();
+  }
+  return flash_.StartWrite(partition.PartitionToFlashAddress(address),
+                           data,
+                           [this](StatusWithSize result) {
+                             result_ = result.status();
+                             done_.release();
+                           });
+}
+
+Status AsyncFlashWriter::DoWaitForWrite() {
+  done_.acquire();
+  return result_;
+}
+
+}  // namespace pw::blob_store
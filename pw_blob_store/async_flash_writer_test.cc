@@ -0,0 +1,220 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_blob_store/async_flash_writer.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_blob_store/blob_store.h"
+#include "pw_kvs/async_flash_memory.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/test_key_value_store.h"
+#include "pw_random/xor_shift.h"
+#include "pw_span/span.h"
+
+namespace pw::blob_store {
+namespace {
+
+constexpr size_t kSectorSize = 1024;
+constexpr size_t kSectorCount = 4;
+constexpr size_t kAlignment = 16;
+constexpr size_t kFlashWriteSize = 256;
+
+// Async flash that holds each write until the test completes it. Erases and
+// reads complete as soon as they start.
+class FakeAsyncFlashMemory : public kvs::AsyncFlashMemory {
+ public:
+  FakeAsyncFlashMemory()
+      : AsyncFlashMemory(kSectorSize, kSectorCount, kAlignment),
+        memory_(kAlignment) {}
+
+  Status Enable() override { return OkStatus(); }
+  Status Disable() override { return OkStatus(); }
+  bool IsEnabled() const override { return true; }
+
+  void set_complete_writes_immediately(bool complete) {
+    complete_writes_immediately_ = complete;
+  }
+
+  bool write_pending() const { return pending_write_.has_value(); }
+
+  // Programs the pending write and reports status to its callback. The data
+  // is only programmed if status is OK.
+  void CompleteWrite(Status status = OkStatus()) {
+    ASSERT_TRUE(pending_write_.has_value());
+    PendingWrite write = std::move(*pending_write_);
+    pending_write_.reset();
+    if (!status.ok()) {
+      write.done(StatusWithSize(status, 0));
+      return;
+    }
+    write.done(memory_.Write(write.address, write.data));
+  }
+
+  kvs::FakeFlashMemory& memory() { return memory_; }
+
+ private:
+  struct PendingWrite {
+    Address address;
+    span<const std::byte> data;
+    Callback done;
+  };
+
+  Status DoStartErase(Address address,
+                      size_t num_sectors,
+                      Callback&& done) override {
+    done(StatusWithSize(memory_.Erase(address, num_sectors), 0));
+    return OkStatus();
+  }
+
+  Status DoStartRead(Address address,
+                     span<std::byte> output,
+                     Callback&& done) override {
+    done(memory_.Read(address, output));
+    return OkStatus();
+  }
+
+  Status DoStartWrite(Address address,
+                      span<const std::byte> data,
+                      Callback&& done) override {
+    if (pending_write_.has_value()) {
+      return Status::Unavailable();
+    }
+    pending_write_ = PendingWrite{address, data, std::move(done)};
+    if (complete_writes_immediately_) {
+      CompleteWrite();
+    }
+    return OkStatus();
+  }
+
+  kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> memory_;
+  std::optional<PendingWrite> pending_write_;
+  bool complete_writes_immediately_ = false;
+};
+
+class AsyncFlashWriterTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kBufferSize = 2 * kFlashWriteSize;
+
+  AsyncFlashWriterTest()
+      : partition_(&flash_),
+        async_writer_(flash_),
+        blob_("Blob", partition_, &checksum_, kvs::TestKvs(), kFlashWriteSize) {
+    random::XorShiftStarRng64 rng(0x2468ace0);
+    rng.Get(source_buffer_);
+    blob_.set_async_writer(&async_writer_);
+  }
+
+  void VerifyBlob(ConstByteSpan expected) {
+    BlobStore::BlobReader reader(blob_);
+    ASSERT_EQ(OkStatus(), reader.Open());
+    std::array<std::byte, kSectorSize * kSectorCount> read_buffer;
+    Result<ByteSpan> result = reader.Read(read_buffer);
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(result.value().size_bytes(), expected.size_bytes());
+    EXPECT_EQ(0,
+              std::memcmp(result.value().data(),
+                          expected.data(),
+                          expected.size_bytes()));
+    EXPECT_EQ(OkStatus(), reader.Close());
+  }
+
+  FakeAsyncFlashMemory flash_;
+  kvs::FlashPartition partition_;
+  AsyncFlashWriter async_writer_;
+  kvs::ChecksumCrc16 checksum_;
+  BlobStoreBuffer<kBufferSize> blob_;
+  std::array<std::byte, kSectorSize * kSectorCount> source_buffer_;
+};
+
+TEST_F(AsyncFlashWriterTest, WriteReturnsBeforeProgramming) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  BlobStore::BlobWriterWithBuffer writer(blob_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+
+  const ConstByteSpan chunk = span(source_buffer_).first(kFlashWriteSize);
+  ASSERT_EQ(OkStatus(), writer.Write(chunk));
+  ASSERT_TRUE(flash_.write_pending());
+  EXPECT_NE(0,
+            std::memcmp(flash_.memory().buffer().data(),
+                        chunk.data(),
+                        chunk.size_bytes()));
+
+  flash_.CompleteWrite();
+  EXPECT_EQ(OkStatus(), writer.Close());
+  VerifyBlob(chunk);
+}
+
+TEST_F(AsyncFlashWriterTest, WholeBlobInOneWrite) {
+  flash_.set_complete_writes_immediately(true);
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  BlobStore::BlobWriterWithBuffer writer(blob_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(), writer.Write(source_buffer_));
+  EXPECT_EQ(OkStatus(), writer.Close());
+  VerifyBlob(source_buffer_);
+}
+
+TEST_F(AsyncFlashWriterTest, UnalignedWritesWithVerification) {
+  flash_.set_complete_writes_immediately(true);
+  blob_.set_write_verification(BlobStore::WriteVerification::kAfterEachWrite);
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  BlobStore::BlobWriterWithBuffer writer(blob_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+
+  // End on a partial chunk, which is padded and written by Close().
+  const ConstByteSpan data = span(source_buffer_).first(3000);
+  ConstByteSpan remaining = data;
+  while (!remaining.empty()) {
+    const size_t write_size = std::min<size_t>(remaining.size_bytes(), 100);
+    ASSERT_EQ(OkStatus(), writer.Write(remaining.first(write_size)));
+    remaining = remaining.subspan(write_size);
+  }
+  EXPECT_EQ(OkStatus(), writer.Close());
+  VerifyBlob(data);
+}
+
+TEST_F(AsyncFlashWriterTest, FailedWriteFailsClose) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  BlobStore::BlobWriterWithBuffer writer(blob_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+
+  ASSERT_EQ(OkStatus(),
+            writer.Write(span(source_buffer_).first(kFlashWriteSize)));
+  flash_.CompleteWrite(Status::Internal());
+  EXPECT_EQ(Status::DataLoss(), writer.Close());
+  EXPECT_FALSE(blob_.HasData());
+}
+
+TEST_F(AsyncFlashWriterTest, ProgramBufferReducesDeferredWriteSpace) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  BlobStore::DeferredWriterWithBuffer writer(blob_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  EXPECT_EQ(writer.ConservativeWriteLimit(), kBufferSize - kFlashWriteSize);
+  EXPECT_EQ(OkStatus(), writer.Close());
+
+  blob_.set_async_writer(nullptr);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  EXPECT_EQ(writer.ConservativeWriteLimit(), kBufferSize);
+  EXPECT_EQ(OkStatus(), writer.Close());
+}
+
+}  // namespace
+}  // namespace pw::blob_store
@@ -372,17 +372,74 @@ Status BlobStore::CommitToFlash(ConstByteSpan source, size_t data_bytes) {
   }
 
   flash_erased_ = false;
-  StatusWithSize result = partition_.Write(flash_address_, source);
+
+  // When erasing ahead, only wait for the sectors this write touches. The
+  // eraser keeps going through the rest of the partition in the background.
+  Status status;
+  if (erasing_ahead_) {
+    status = eraser_->WaitUntilErased(flash_address_ + source.size_bytes());
+  }
+  if (status.ok()) {
+    if (async_writer_ != nullptr) {
+      status = StartAsyncWrites(source);
+    } else {
+      status = partition_.Write(flash_address_, source).status();
+      if (status.ok() &&
+          write_verification_ == WriteVerification::kAfterEachWrite) {
+        status = VerifyFlashContents(flash_address_, source);
+      }
+    }
+  }
   flash_address_ += data_bytes;
   if (checksum_algo_ != nullptr) {
     checksum_algo_->Update(source.first(data_bytes));
   }
 
-  if (!result.status().ok()) {
+  if (!status.ok()) {
     valid_data_ = false;
   }
 
-  return result.status();
+  return status;
+}
+
+Status BlobStore::StartAsyncWrites(ConstByteSpan source) {
+  kvs::FlashPartition::Address address = flash_address_;
+  while (!source.empty()) {
+    // The program buffer is reused for each chunk, so the previous write must
+    // finish before the next chunk is copied in.
+    PW_TRY(FinishAsyncWrite());
+
+    const size_t chunk_size =
+        std::min(source.size_bytes(), program_buffer_.size_bytes());
+    std::memcpy(program_buffer_.data(), source.data(), chunk_size);
+    PW_TRY(async_writer_->StartWrite(
+        partition_, address, program_buffer_.first(chunk_size)));
+
+    async_write_pending_ = true;
+    async_write_address_ = address;
+    async_write_size_ = chunk_size;
+    address += chunk_size;
+    source = source.subspan(chunk_size);
+  }
+  return OkStatus();
+}
+
+Status BlobStore::FinishAsyncWrite() {
+  if (!async_write_pending_) {
+    return OkStatus();
+  }
+  async_write_pending_ = false;
+
+  Status status = async_writer_->WaitForWrite();
+  if (status.ok() &&
+      write_verification_ == WriteVerification::kAfterEachWrite) {
+    status = VerifyFlashContents(async_write_address_,
+                                 program_buffer_.first(async_write_size_));
+  }
+  if (!status.ok()) {
+    valid_data_ = false;
+  }
+  return status;
 }
 
 // Needs to be in .cc file since PW_CHECK doesn't like being in .h files.
@@ -456,7 +513,13 @@ Status BlobStore::Erase() {
     Invalidate().IgnoreError();  // TODO(b/242598609): Handle Status properly
   }
 
-  PW_TRY(partition_.Erase());
+  StopEraseAhead();
+
+  if (eraser_ != nullptr && eraser_->StartErase(partition_).ok()) {
+    erasing_ahead_ = true;
+  } else {
+    PW_TRY(partition_.Erase());
+  }
 
   flash_erased_ = true;
 
@@ -466,7 +529,53 @@ Status BlobStore::Erase() {
   return OkStatus();
 }
 
+void BlobStore::set_eraser(Eraser* eraser) {
+  PW_CHECK(!writer_open_);
+  StopEraseAhead();
+  eraser_ = eraser;
+}
+
+void BlobStore::set_async_writer(AsyncWriter* async_writer) {
+  PW_CHECK(!writer_open_);
+  FinishAsyncWrite().IgnoreError();
+
+  // Give the program buffer back to the write buffer before splitting it off
+  // again, so the writer can be changed more than once.
+  write_buffer_ = ByteSpan(write_buffer_.data(),
+                           write_buffer_.size_bytes() +
+                               program_buffer_.size_bytes());
+  program_buffer_ = ByteSpan();
+  async_writer_ = async_writer;
+  if (async_writer_ == nullptr) {
+    return;
+  }
+
+  PW_CHECK_UINT_GE(write_buffer_.size_bytes(), 2 * flash_write_size_bytes_);
+  program_buffer_ = write_buffer_.last(flash_write_size_bytes_);
+  write_buffer_ = write_buffer_.first(write_buffer_.size_bytes() -
+                                      flash_write_size_bytes_);
+}
+
+void BlobStore::set_write_verification(WriteVerification verification) {
+  PW_CHECK(!writer_open_);
+  write_verification_ = verification;
+}
+
+void BlobStore::StopEraseAhead() {
+  if (!erasing_ahead_) {
+    return;
+  }
+  eraser_->StopErase();
+  erasing_ahead_ = false;
+
+  // The erase may not have reached the end of the partition.
+  flash_erased_ = false;
+}
+
 Status BlobStore::Invalidate() {
+  // A write still in progress would land in the next blob.
+  FinishAsyncWrite().IgnoreError();
+
   // Blob data is considered valid if the flash is erased. Even though
   // there are 0 bytes written, they are valid.
   valid_data_ = flash_erased_;
@@ -534,6 +643,24 @@ Status BlobStore::CalculateChecksumFromFlash(size_t bytes_to_check) {
   return OkStatus();
 }
 
+Status BlobStore::VerifyFlashContents(kvs::FlashPartition::Address address,
+                                      ConstByteSpan expected) {
+  constexpr size_t kReadBufferSizeBytes = 32;
+  std::array<std::byte, kReadBufferSizeBytes> buffer;
+  while (!expected.empty()) {
+    const size_t read_size = std::min(expected.size_bytes(), buffer.size());
+    PW_TRY(partition_.Read(address, span(buffer).first(read_size)));
+
+    if (std::memcmp(buffer.data(), expected.data(), read_size) != 0) {
+      PW_LOG_ERROR("Blob data read back from flash does not match write");
+      return Status::DataLoss();
+    }
+    address += read_size;
+    expected = expected.subspan(read_size);
+  }
+  return OkStatus();
+}
+
 Status BlobStore::BlobWriter::SetFileName(std::string_view file_name) {
   if (!open_) {
     return Status::FailedPrecondition();
@@ -570,7 +697,8 @@ Status BlobStore::BlobWriter::Open() {
 // Validates and commits BlobStore metadata to KVS.
 //
 // 1. Finalize checksum calculation.
-// 2. Check the calculated checksum against data actually committed to flash.
+// 2. Check the calculated checksum against data actually committed to flash,
+//    if the write verification mode is kOnClose.
 // 3. Build the metadata header into the metadata buffer, placing it before the
 //    staged file name (if any).
 // 4. Commit the metadata to KVS.
@@ -585,8 +713,10 @@ Status BlobStore::BlobWriter::WriteMetadata() {
   }
 
   // Check the in-memory checksum against the data that was actually committed
-  // to flash.
-  if (!store_.ValidateChecksum(store_.flash_address_, calculated_checksum)
+  // to flash. The other verification modes check data as it is written, or not
+  // at all.
+  if (store_.write_verification_ == WriteVerification::kOnClose &&
+      !store_.ValidateChecksum(store_.flash_address_, calculated_checksum)
            .ok()) {
     PW_CHECK_OK(store_.Invalidate());
     return Status::DataLoss();
@@ -663,6 +793,11 @@ Status BlobStore::BlobWriter::Close() {
     }
     PW_DCHECK(store_.WriteBufferEmpty());
 
+    // The metadata marks the blob as valid, so the blob data must be in flash
+    // before it is written, even if the partition caches writes.
+    PW_TRY(store_.FinishAsyncWrite());
+    PW_TRY(store_.partition_.Flush());
+
     if (!WriteMetadata().ok()) {
       return Status::DataLoss();
     }
@@ -670,7 +805,10 @@ Status BlobStore::BlobWriter::Close() {
     return OkStatus();
   };
 
-  const Status status = do_close_write();
+  Status status = do_close_write();
+
+  // If the close failed partway, a write may still be in progress.
+  status.Update(store_.FinishAsyncWrite());
   store_.writer_open_ = false;
 
   if (!status.ok()) {
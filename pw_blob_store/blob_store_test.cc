@@ -846,5 +846,121 @@ TEST_F(BlobStoreTest, MultipleWrites) {
   WriteTestBlock();
 }
 
+// Partition that counts bytes read and can corrupt data as it is written.
+class ReadCountingPartition : public kvs::FlashPartition {
+ public:
+  using kvs::FlashPartition::FlashPartition;
+
+  StatusWithSize Read(Address address, span<std::byte> output) override {
+    bytes_read += output.size_bytes();
+    return kvs::FlashPartition::Read(address, output);
+  }
+
+  StatusWithSize Write(Address address, span<const std::byte> data) override {
+    if (!corrupt_writes) {
+      return kvs::FlashPartition::Write(address, data);
+    }
+    // Flip a bit in the first byte, but report success.
+    std::array<std::byte, 256> corrupted;
+    const span<std::byte> copy = span(corrupted).first(data.size_bytes());
+    std::memcpy(copy.data(), data.data(), data.size_bytes());
+    copy[0] ^= std::byte{0x01};
+    return kvs::FlashPartition::Write(address, copy);
+  }
+
+  size_t bytes_read = 0;
+  bool corrupt_writes = false;
+};
+
+class BlobStoreWriteVerificationTest : public BlobStoreTest {
+ protected:
+  static constexpr size_t kBufferSize = 256;
+
+  BlobStoreWriteVerificationTest()
+      : counting_partition_(&flash_),
+        blob_(kBlobTitle,
+              counting_partition_,
+              &checksum_,
+              kvs::TestKvs(),
+              kBufferSize) {
+    InitSourceBufferToRandom(0x5eed);
+  }
+
+  // Writes the source buffer to the blob in chunks of kBufferSize.
+  Status WriteBlob() {
+    BlobStore::BlobWriterWithBuffer writer(blob_);
+    PW_TRY(writer.Open());
+    ConstByteSpan data = source_buffer_;
+    while (!data.empty()) {
+      if (Status status = writer.Write(data.first(kBufferSize));
+          !status.ok()) {
+        writer.Close().IgnoreError();
+        return status;
+      }
+      data = data.subspan(kBufferSize);
+    }
+    return writer.Close();
+  }
+
+  ReadCountingPartition counting_partition_;
+  kvs::ChecksumCrc16 checksum_;
+  BlobStoreBuffer<kBufferSize> blob_;
+};
+
+TEST_F(BlobStoreWriteVerificationTest, OnClose_ReadsBackWholeBlobAtClose) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  counting_partition_.bytes_read = 0;
+
+  EXPECT_EQ(OkStatus(), WriteBlob());
+  EXPECT_EQ(counting_partition_.bytes_read, kBlobDataSize);
+  VerifyFlash(flash_.buffer());
+}
+
+TEST_F(BlobStoreWriteVerificationTest, OnClose_CorruptionFailsClose) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  counting_partition_.corrupt_writes = true;
+
+  EXPECT_EQ(Status::DataLoss(), WriteBlob());
+  EXPECT_FALSE(blob_.HasData());
+}
+
+TEST_F(BlobStoreWriteVerificationTest, AfterEachWrite_ReadsEachWriteOnce) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  blob_.set_write_verification(BlobStore::WriteVerification::kAfterEachWrite);
+  counting_partition_.bytes_read = 0;
+
+  EXPECT_EQ(OkStatus(), WriteBlob());
+  EXPECT_EQ(counting_partition_.bytes_read, kBlobDataSize);
+  VerifyFlash(flash_.buffer());
+}
+
+TEST_F(BlobStoreWriteVerificationTest, AfterEachWrite_CorruptionFailsWrite) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  blob_.set_write_verification(BlobStore::WriteVerification::kAfterEachWrite);
+  counting_partition_.corrupt_writes = true;
+
+  BlobStore::BlobWriterWithBuffer writer(blob_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  EXPECT_EQ(Status::DataLoss(),
+            writer.Write(span(source_buffer_).first(kBufferSize)));
+  EXPECT_EQ(Status::DataLoss(), writer.Close());
+  EXPECT_FALSE(blob_.HasData());
+}
+
+TEST_F(BlobStoreWriteVerificationTest, None_DoesNotReadBack) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  blob_.set_write_verification(BlobStore::WriteVerification::kNone);
+  counting_partition_.bytes_read = 0;
+
+  EXPECT_EQ(OkStatus(), WriteBlob());
+  EXPECT_EQ(counting_partition_.bytes_read, 0u);
+
+  // The blob is still verified when it is loaded.
+  BlobStoreBuffer<kBufferSize> reloaded(
+      kBlobTitle, counting_partition_, &checksum_, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), reloaded.Init());
+  EXPECT_TRUE(reloaded.HasData());
+}
+
 }  // namespace
 }  // namespace pw::blob_store
@@ -0,0 +1,49 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_blob_store/blob_store.h"
+#include "pw_bytes/span.h"
+#include "pw_kvs/async_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_status/status.h"
+#include "pw_sync/thread_notification.h"
+
+namespace pw::blob_store {
+
+// BlobStore::AsyncWriter that programs a kvs::AsyncFlashMemory. The flash must
+// be the memory that the BlobStore's partition is on.
+//
+// Writes are started with AsyncFlashMemory::StartWrite(), so they fail with
+// UNAVAILABLE if the flash is busy with an operation it cannot run alongside a
+// write.
+class AsyncFlashWriter final : public BlobStore::AsyncWriter {
+ public:
+  explicit AsyncFlashWriter(kvs::AsyncFlashMemory& flash) : flash_(flash) {}
+
+  AsyncFlashWriter(const AsyncFlashWriter&) = delete;
+  AsyncFlashWriter& operator=(const AsyncFlashWriter&) = delete;
+
+ private:
+  Status DoStartWrite(kvs::FlashPartition& partition,
+                      kvs::FlashPartition::Address address,
+                      ConstByteSpan data) override;
+  Status DoWaitForWrite() override;
+
+  kvs::AsyncFlashMemory& flash_;
+  sync::ThreadNotification done_;
+  Status result_;
+};
+
+}  // namespace pw::blob_store
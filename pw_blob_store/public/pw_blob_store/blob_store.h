@@ -55,6 +55,93 @@ namespace pw::blob_store {
 //  3) BlobReader::Close().
 class BlobStore {
  public:
+  // Erases the blob partition one sector at a time, in the background, instead
+  // of all at once when a blob write starts. Sectors are erased in order from
+  // the start of the partition, so writes only wait if they catch up with the
+  // eraser. See pw_blob_store/work_queue_eraser.h for an Eraser that runs on a
+  // pw::work_queue::WorkQueue.
+  //
+  // The flash driver must allow a sector to be erased while other sectors of
+  // the partition are read or written.
+  class Eraser {
+   public:
+    virtual ~Eraser() = default;
+
+    // Starts erasing the partition from its first sector. Returns:
+    //
+    // OK - the erase was started.
+    // [error status] - the erase could not be started. BlobStore erases the
+    //     whole partition itself instead.
+    Status StartErase(kvs::FlashPartition& partition) {
+      return DoStartErase(partition);
+    }
+
+    // Blocks until the first size_bytes of the partition are erased. Returns:
+    //
+    // OK - the requested bytes are erased.
+    // [error status] - a flash erase failed, or the erase was stopped.
+    Status WaitUntilErased(size_t size_bytes) {
+      return DoWaitUntilErased(size_bytes);
+    }
+
+    // Stops the erase in progress, if any. Blocks until the sector that is
+    // being erased is done.
+    void StopErase() { DoStopErase(); }
+
+   private:
+    virtual Status DoStartErase(kvs::FlashPartition& partition) = 0;
+    virtual Status DoWaitUntilErased(size_t size_bytes) = 0;
+    virtual void DoStopErase() = 0;
+  };
+
+  // Programs flash without waiting for the write to finish, so the next chunk
+  // of a blob can be buffered while the previous one is programmed. See
+  // pw_blob_store/async_flash_writer.h for an AsyncWriter that uses a
+  // kvs::AsyncFlashMemory.
+  //
+  // BlobStore has at most one write in progress. Each successful StartWrite()
+  // is followed by exactly one WaitForWrite() before the next StartWrite().
+  class AsyncWriter {
+   public:
+    virtual ~AsyncWriter() = default;
+
+    // Starts writing data to the partition. data remains valid until
+    // WaitForWrite() returns. Returns:
+    //
+    // OK - the write was started.
+    // [error status] - the write could not be started.
+    Status StartWrite(kvs::FlashPartition& partition,
+                      kvs::FlashPartition::Address address,
+                      ConstByteSpan data) {
+      return DoStartWrite(partition, address, data);
+    }
+
+    // Blocks until the write started by StartWrite() finishes, and returns its
+    // result.
+    Status WaitForWrite() { return DoWaitForWrite(); }
+
+   private:
+    virtual Status DoStartWrite(kvs::FlashPartition& partition,
+                                kvs::FlashPartition::Address address,
+                                ConstByteSpan data) = 0;
+    virtual Status DoWaitForWrite() = 0;
+  };
+
+  // How data committed to flash is checked against the checksum, which is
+  // calculated from the data as it is written.
+  enum class WriteVerification {
+    // Read back the whole blob and recalculate its checksum when the writer is
+    // closed. This is the default.
+    kOnClose,
+
+    // Read back each chunk right after it is written and compare it to the
+    // data that was written. Closing a writer does not read the blob again.
+    kAfterEachWrite,
+
+    // Trust the flash driver to report failed writes. Nothing is read back.
+    kNone,
+  };
+
   // Implement the stream::Writer and erase interface for a BlobStore. If not
   // already erased, the Write will do any needed erase.
   //
@@ -357,15 +444,23 @@ class BlobStore {
         checksum_algo_(checksum_algo),
         kvs_(kvs),
         write_buffer_(write_buffer),
+        program_buffer_(),
         flash_write_size_bytes_(flash_write_size_bytes),
         initialized_(false),
         valid_data_(false),
         flash_erased_(false),
+        erasing_ahead_(false),
         writer_open_(false),
         readers_open_(0),
         write_address_(0),
         flash_address_(0),
-        file_name_length_(0) {}
+        file_name_length_(0),
+        eraser_(nullptr),
+        write_verification_(WriteVerification::kOnClose),
+        async_writer_(nullptr),
+        async_write_pending_(false),
+        async_write_address_(0),
+        async_write_size_(0) {}
 
   BlobStore(const BlobStore&) = delete;
   BlobStore& operator=(const BlobStore&) = delete;
@@ -390,6 +485,29 @@ class BlobStore {
   // false -  Blob is either invalid or does not have any data bytes
   bool HasData() const { return (valid_data_ && ReadableDataBytes() > 0); }
 
+  // Use eraser to erase the partition ahead of the writer when a new blob is
+  // started, rather than erasing the whole partition before the first write.
+  // Pass nullptr to go back to erasing the whole partition. The eraser must
+  // remain valid until it is replaced. Must not be called while a writer is
+  // open.
+  void set_eraser(Eraser* eraser);
+
+  // Selects how written data is verified. Must not be called while a writer is
+  // open.
+  void set_write_verification(WriteVerification verification);
+
+  // Programs flash with async_writer, so writers return once a chunk is copied
+  // out of the write buffer rather than once it is programmed. The last
+  // flash_write_size_bytes of the write buffer are set aside to hold the chunk
+  // being programmed, which leaves less room for deferred writes. Writes still
+  // in progress are finished by BlobWriter::Close().
+  //
+  // Pass nullptr to go back to blocking writes. Must not be called while a
+  // writer is open.
+  //
+  // Precondition: The write buffer is at least twice flash_write_size_bytes.
+  void set_async_writer(AsyncWriter* async_writer);
+
  private:
   Status LoadMetadata();
 
@@ -517,6 +635,9 @@ class BlobStore {
 
   Status Erase();
 
+  // Stops the background erase of the partition, if one is running.
+  void StopEraseAhead();
+
   Status Invalidate();
 
   void ResetChecksum() {
@@ -530,6 +651,19 @@ class BlobStore {
 
   Status CalculateChecksumFromFlash(size_t bytes_to_check);
 
+  // Copies source to the program buffer one chunk at a time and starts writing
+  // each chunk with async_writer_.
+  Status StartAsyncWrites(ConstByteSpan source);
+
+  // Waits for the write in progress on async_writer_, if any, and verifies it
+  // if the verification mode is kAfterEachWrite.
+  Status FinishAsyncWrite();
+
+  // Reads back data just written to flash and compares it to the source.
+  // Returns DATA_LOSS if they differ.
+  Status VerifyFlashContents(kvs::FlashPartition::Address address,
+                             ConstByteSpan expected);
+
   const std::string_view MetadataKey() const { return name_; }
 
   // Copies the file name of the stored data to `dest`, and returns the number
@@ -551,6 +685,10 @@ class BlobStore {
   sync::Borrowable<kvs::KeyValueStore> kvs_;
   ByteSpan write_buffer_;
 
+  // Holds the chunk being programmed by async_writer_. Split off from the end
+  // of the write buffer when an AsyncWriter is set.
+  ByteSpan program_buffer_;
+
   // Size in bytes of flash write operations. This should be chosen to balance
   // optimal write size and required buffer size. Must be GE flash write
   // alignment, LE flash sector size.
@@ -568,9 +706,14 @@ class BlobStore {
   // soon as blob is erased. Even when bytes written is still 0, they are valid.
   bool valid_data_;
 
-  // Blob partition is currently erased and ready to write a new blob.
+  // Blob partition is currently erased and ready to write a new blob. When
+  // erasing_ahead_ is set, the erase may still be in progress.
   bool flash_erased_;
 
+  // The partition is being erased by eraser_ rather than having been erased up
+  // front. Writes must wait for the eraser before programming flash.
+  bool erasing_ahead_;
+
   // BlobWriter instance is currently open
   bool writer_open_;
 
@@ -587,6 +730,17 @@ class BlobStore {
 
   // Length of the stored blob's filename.
   size_t file_name_length_;
+
+  // Optional background eraser, used in place of erasing the whole partition.
+  Eraser* eraser_;
+
+  WriteVerification write_verification_;
+
+  // Optional non-blocking flash writer, and the write it has in progress.
+  AsyncWriter* async_writer_;
+  bool async_write_pending_;
+  kvs::FlashPartition::Address async_write_address_;
+  size_t async_write_size_;
 };
 
 // Creates a BlobStore with the buffer of kBufferSizeBytes.
@@ -0,0 +1,73 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_blob_store/blob_store.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::blob_store {
+
+// BlobStore::Eraser that erases one sector per work item on a WorkQueue. Each
+// work item queues the next, so other work on the queue is not held up for the
+// length of a whole partition erase.
+//
+// Only one BlobStore may use a WorkQueueEraser at a time. The eraser must
+// outlive the work it queues; the destructor stops any erase in progress.
+class WorkQueueEraser final : public BlobStore::Eraser {
+ public:
+  explicit WorkQueueEraser(work_queue::WorkQueue& work_queue)
+      : work_queue_(work_queue) {}
+
+  WorkQueueEraser(const WorkQueueEraser&) = delete;
+  WorkQueueEraser& operator=(const WorkQueueEraser&) = delete;
+
+  ~WorkQueueEraser() override { StopErase(); }
+
+  // Number of sectors erased since the erase was started.
+  size_t erased_sectors() const PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  Status DoStartErase(kvs::FlashPartition& partition) override
+      PW_LOCKS_EXCLUDED(lock_);
+  Status DoWaitUntilErased(size_t size_bytes) override
+      PW_LOCKS_EXCLUDED(lock_);
+  void DoStopErase() override PW_LOCKS_EXCLUDED(lock_);
+
+  // Work item that erases the next sector and queues itself again.
+  void EraseNextSector() PW_LOCKS_EXCLUDED(lock_);
+
+  // Queues EraseNextSector. Stops the erase if the work cannot be queued.
+  void QueueNextSector() PW_LOCKS_EXCLUDED(lock_);
+
+  work_queue::WorkQueue& work_queue_;
+
+  // Released each time a sector is erased or the erase ends.
+  sync::ThreadNotification progress_;
+
+  mutable sync::InterruptSpinLock lock_;
+  kvs::FlashPartition* partition_ PW_GUARDED_BY(lock_) = nullptr;
+  size_t erased_sectors_ PW_GUARDED_BY(lock_) = 0;
+  Status status_ PW_GUARDED_BY(lock_);
+  bool running_ PW_GUARDED_BY(lock_) = false;
+  bool stop_requested_ PW_GUARDED_BY(lock_) = false;
+};
+
+}  // namespace pw::blob_store
@@ -0,0 +1,135 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_blob_store/work_queue_eraser.h"
+
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::blob_store {
+
+size_t WorkQueueEraser::erased_sectors() const {
+  std::lock_guard lock(lock_);
+  return erased_sectors_;
+}
+
+Status WorkQueueEraser::DoStartErase(kvs::FlashPartition& partition) {
+  {
+    std::lock_guard lock(lock_);
+    PW_CHECK(!running_, "An erase is already in progress");
+    partition_ = &partition;
+    erased_sectors_ = 0;
+    status_ = OkStatus();
+    running_ = true;
+    stop_requested_ = false;
+  }
+
+  if (Status status = work_queue_.PushWork([this] { EraseNextSector(); });
+      !status.ok()) {
+    std::lock_guard lock(lock_);
+    running_ = false;
+    return status;
+  }
+  return OkStatus();
+}
+
+Status WorkQueueEraser::DoWaitUntilErased(size_t size_bytes) {
+  while (true) {
+    {
+      std::lock_guard lock(lock_);
+      if (partition_ == nullptr) {
+        return Status::FailedPrecondition();
+      }
+      if (erased_sectors_ * partition_->sector_size_bytes() >= size_bytes) {
+        return OkStatus();
+      }
+      if (!status_.ok()) {
+        return status_;
+      }
+      if (!running_) {
+        return Status::Cancelled();
+      }
+    }
+    progress_.acquire();
+  }
+}
+
+void WorkQueueEraser::DoStopErase() {
+  {
+    std::lock_guard lock(lock_);
+    if (!running_) {
+      return;
+    }
+    stop_requested_ = true;
+  }
+
+  while (true) {
+    progress_.acquire();
+    std::lock_guard lock(lock_);
+    if (!running_) {
+      return;
+    }
+  }
+}
+
+void WorkQueueEraser::EraseNextSector() {
+  kvs::FlashPartition* partition;
+  size_t sector;
+  {
+    std::lock_guard lock(lock_);
+    if (stop_requested_) {
+      running_ = false;
+      progress_.release();
+      return;
+    }
+    partition = partition_;
+    sector = erased_sectors_;
+  }
+
+  const Status status =
+      partition->Erase(sector * partition->sector_size_bytes(), 1);
+
+  {
+    std::lock_guard lock(lock_);
+    if (status.ok()) {
+      erased_sectors_ += 1;
+    } else {
+      status_ = status;
+    }
+    // Release while holding the lock so the eraser cannot be destroyed by a
+    // waiter between ending the erase and notifying.
+    if (!status.ok() || stop_requested_ ||
+        erased_sectors_ == partition->sector_count()) {
+      running_ = false;
+      progress_.release();
+      return;
+    }
+    progress_.release();
+  }
+
+  QueueNextSector();
+}
+
+void WorkQueueEraser::QueueNextSector() {
+  if (Status status = work_queue_.PushWork([this] { EraseNextSector(); });
+      !status.ok()) {
+    std::lock_guard lock(lock_);
+    status_ = status;
+    running_ = false;
+    progress_.release();
+  }
+}
+
+}  // namespace pw::blob_store
@@ -0,0 +1,195 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_blob_store/work_queue_eraser.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_blob_store/blob_store.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/test_key_value_store.h"
+#include "pw_random/xor_shift.h"
+#include "pw_span/span.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_thread/thread.h"
+#include "pw_work_queue/test_thread.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::blob_store {
+namespace {
+
+constexpr size_t kSectorSize = 1024;
+constexpr size_t kSectorCount = 4;
+
+// Fake flash where each sector erase waits for the test to allow it.
+class GatedFlashMemory
+    : public kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> {
+ public:
+  GatedFlashMemory() : FakeFlashMemoryBuffer(16) {
+    std::memset(buffer().data(), 0x5a, buffer().size());
+  }
+
+  Status Erase(Address address, size_t num_sectors) override {
+    for (size_t i = 0; i < num_sectors; ++i) {
+      erases_allowed.acquire();
+    }
+    if (!erase_status.ok()) {
+      return erase_status;
+    }
+    return FakeFlashMemoryBuffer::Erase(address, num_sectors);
+  }
+
+  sync::CountingSemaphore erases_allowed;
+  Status erase_status;
+};
+
+class WorkQueueEraserTest : public ::testing::Test {
+ protected:
+  WorkQueueEraserTest()
+      : partition_(&flash_),
+        work_thread_(work_queue::test::WorkQueueThreadOptions(), work_queue_),
+        eraser_(work_queue_),
+        blob_("Blob", partition_, &checksum_, kvs::TestKvs(), kBufferSize) {
+    random::XorShiftStarRng64 rng(0x76543210);
+    rng.Get(source_buffer_);
+    blob_.set_eraser(&eraser_);
+  }
+
+  ~WorkQueueEraserTest() override {
+    // Let any erase still in progress finish before shutting down.
+    flash_.erases_allowed.release(kSectorCount * 2);
+    eraser_.StopErase();
+    work_queue_.RequestStop();
+    work_thread_.join();
+  }
+
+  void VerifyBlob(ConstByteSpan expected) {
+    BlobStore::BlobReader reader(blob_);
+    ASSERT_EQ(OkStatus(), reader.Open());
+    Result<ConstByteSpan> result = reader.GetMemoryMappedBlob();
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(result.value().size_bytes(), expected.size_bytes());
+    EXPECT_EQ(0,
+              std::memcmp(result.value().data(),
+                          expected.data(),
+                          expected.size_bytes()));
+    EXPECT_EQ(OkStatus(), reader.Close());
+  }
+
+  static constexpr size_t kBufferSize = 256;
+  static constexpr size_t kMetadataBufferSize =
+      BlobStore::BlobWriter::RequiredMetadataBufferSize(0);
+
+  GatedFlashMemory flash_;
+  kvs::FlashPartition partition_;
+  work_queue::WorkQueueWithBuffer<4> work_queue_;
+  thread::Thread work_thread_;
+  WorkQueueEraser eraser_;
+  kvs::ChecksumCrc16 checksum_;
+  BlobStoreBuffer<kBufferSize> blob_;
+  std::array<std::byte, kMetadataBufferSize> metadata_buffer_;
+  std::array<std::byte, kSectorSize * kSectorCount> source_buffer_;
+};
+
+TEST_F(WorkQueueEraserTest, EraseDoesNotWaitForFlash) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  BlobStore::BlobWriter writer(blob_, metadata_buffer_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+
+  // No sector erases are allowed yet, so this would block if the partition
+  // were erased synchronously.
+  EXPECT_EQ(OkStatus(), writer.Erase());
+  EXPECT_EQ(eraser_.erased_sectors(), 0u);
+
+  flash_.erases_allowed.release(kSectorCount);
+  EXPECT_EQ(OkStatus(), writer.Write(source_buffer_));
+  EXPECT_EQ(OkStatus(), writer.Close());
+  VerifyBlob(source_buffer_);
+}
+
+TEST_F(WorkQueueEraserTest, WriteWaitsOnlyForSectorsItUses) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  BlobStore::BlobWriter writer(blob_, metadata_buffer_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+
+  flash_.erases_allowed.release();
+  ASSERT_EQ(OkStatus(), writer.Write(span(source_buffer_).first(kSectorSize)));
+
+  // The write only needed the first sector; the eraser is blocked on the
+  // second.
+  EXPECT_EQ(eraser_.erased_sectors(), 1u);
+
+  flash_.erases_allowed.release(kSectorCount - 1);
+  ASSERT_EQ(OkStatus(),
+            writer.Write(span(source_buffer_).subspan(kSectorSize)));
+  EXPECT_EQ(eraser_.erased_sectors(), kSectorCount);
+  EXPECT_EQ(OkStatus(), writer.Close());
+  VerifyBlob(source_buffer_);
+}
+
+TEST_F(WorkQueueEraserTest, NewBlobErasesAgain) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  flash_.erases_allowed.release(2 * kSectorCount);
+
+  const ConstByteSpan first = span(source_buffer_).first(3 * kSectorSize);
+  {
+    BlobStore::BlobWriter writer(blob_, metadata_buffer_);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.Write(first));
+    ASSERT_EQ(OkStatus(), writer.Close());
+  }
+  VerifyBlob(first);
+
+  const ConstByteSpan second = span(source_buffer_).last(2 * kSectorSize);
+  {
+    BlobStore::BlobWriter writer(blob_, metadata_buffer_);
+    ASSERT_EQ(OkStatus(), writer.Open());
+    ASSERT_EQ(OkStatus(), writer.Write(second));
+    ASSERT_EQ(OkStatus(), writer.Close());
+  }
+  VerifyBlob(second);
+}
+
+TEST_F(WorkQueueEraserTest, EraseErrorFailsWrite) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  BlobStore::BlobWriter writer(blob_, metadata_buffer_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+
+  flash_.erase_status = Status::Internal();
+  flash_.erases_allowed.release();
+  EXPECT_EQ(Status::DataLoss(), writer.Write(source_buffer_));
+  EXPECT_EQ(Status::DataLoss(), writer.Close());
+  EXPECT_FALSE(blob_.HasData());
+}
+
+TEST_F(WorkQueueEraserTest, ErasesSynchronouslyIfWorkCannotBeQueued) {
+  ASSERT_EQ(OkStatus(), blob_.Init());
+  work_queue_.RequestStop();
+  flash_.erases_allowed.release(kSectorCount);
+
+  BlobStore::BlobWriter writer(blob_, metadata_buffer_);
+  ASSERT_EQ(OkStatus(), writer.Open());
+  ASSERT_EQ(OkStatus(), writer.Write(source_buffer_));
+  EXPECT_EQ(eraser_.erased_sectors(), 0u);
+  EXPECT_EQ(OkStatus(), writer.Close());
+  VerifyBlob(source_buffer_);
+}
+
+}  // namespace
+}  // namespace pw::blob_store
@@ -13,10 +13,14 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
+
 #include "pw_bluetooth_hci/packet.h"
 #include "pw_bytes/bit.h"
 #include "pw_bytes/span.h"
 #include "pw_function/function.h"
+#include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
 
 namespace pw::bluetooth_hci {
@@ -59,4 +63,60 @@ using DecodedPacketCallback = Function<void(const Packet& packet)>;
 StatusWithSize DecodeHciUartData(ConstByteSpan data,
                                  const DecodedPacketCallback& packet_callback);
 
+// Reassembles HCI packets from a stream of HCI UART Transport Layer data that
+// arrives in arbitrary chunks, such as from UART reads or DMA transfers.
+//
+// Packets entirely within a chunk are decoded in place, so the packets passed
+// to the callback refer to the caller's data. Only a packet split across
+// chunks is copied into the reassembler's buffer, and is passed to the
+// callback from there. The callback is invoked for every complete packet in a
+// chunk before Process() returns.
+//
+// The buffer must be able to hold the largest packet expected, including its
+// packet indicator and header: e.g. 1 + AsyncDataPacket::kHeaderSizeBytes +
+// the controller's maximum ACL data length.
+class UartReassembler {
+ public:
+  explicit constexpr UartReassembler(ByteSpan buffer)
+      : buffer_(buffer), pending_bytes_(0), discard_bytes_(0) {}
+
+  UartReassembler(const UartReassembler&) = delete;
+  UartReassembler& operator=(const UartReassembler&) = delete;
+
+  // Processes a chunk of data, invoking the callback for each complete packet.
+  // Always consumes all of the data.
+  //
+  // Returns:
+  // OK - All data was processed.
+  // DATA_LOSS - Invalid packet indicators were skipped to regain
+  //             synchronization.
+  // RESOURCE_EXHAUSTED - A packet larger than the buffer was dropped.
+  Status Process(ConstByteSpan data,
+                 const DecodedPacketCallback& packet_callback);
+
+  // Discards any partially received packet.
+  void Clear() {
+    pending_bytes_ = 0;
+    discard_bytes_ = 0;
+  }
+
+  // The number of bytes of a partially received packet held in the buffer.
+  size_t pending_bytes() const { return pending_bytes_; }
+
+ private:
+  ByteSpan buffer_;
+  size_t pending_bytes_;
+  size_t discard_bytes_;
+};
+
+// UartReassembler with its own buffer.
+template <size_t kBufferSizeBytes>
+class UartReassemblerBuffer : public UartReassembler {
+ public:
+  constexpr UartReassemblerBuffer() : UartReassembler(buffer_), buffer_{} {}
+
+ private:
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+};
+
 }  // namespace pw::bluetooth_hci
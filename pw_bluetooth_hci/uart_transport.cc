@@ -13,7 +13,52 @@
 // the License.
 #include "pw_bluetooth_hci/uart_transport.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace pw::bluetooth_hci {
+namespace {
+
+// Returns the size of the packet indicator and HCI packet starting at frame[0],
+// or the number of bytes needed to read its length if its header is
+// incomplete. frame must start with a valid packet indicator.
+size_t RequiredFrameSizeBytes(ConstByteSpan frame) {
+  size_t header_size_bytes = 0;
+  size_t length_byte_offset = 0;
+  bool two_byte_length = false;
+  switch (frame[0]) {
+    case kUartCommandPacketIndicator:
+      header_size_bytes = CommandPacket::kHeaderSizeBytes;
+      length_byte_offset = 2;
+      break;
+    case kUartAsyncDataPacketIndicator:
+      header_size_bytes = AsyncDataPacket::kHeaderSizeBytes;
+      length_byte_offset = 2;
+      two_byte_length = true;
+      break;
+    case kUartSyncDataPacketIndicator:
+      header_size_bytes = SyncDataPacket::kHeaderSizeBytes;
+      length_byte_offset = 2;
+      break;
+    case kUartEventPacketIndicator:
+    default:
+      header_size_bytes = EventPacket::kHeaderSizeBytes;
+      length_byte_offset = 1;
+      break;
+  }
+
+  const ConstByteSpan header = frame.subspan(1);
+  if (header.size() < header_size_bytes) {
+    return 1 + header_size_bytes;
+  }
+  size_t length = static_cast<uint8_t>(header[length_byte_offset]);
+  if (two_byte_length) {
+    length |= static_cast<size_t>(header[length_byte_offset + 1]) << 8;
+  }
+  return 1 + header_size_bytes + length;
+}
+
+}  // namespace
 
 StatusWithSize DecodeHciUartData(ConstByteSpan data,
                                  const DecodedPacketCallback& packet_callback) {
@@ -95,4 +140,58 @@ StatusWithSize DecodeHciUartData(ConstByteSpan data,
   return StatusWithSize(bytes_consumed);
 }
 
+Status UartReassembler::Process(ConstByteSpan data,
+                                const DecodedPacketCallback& packet_callback) {
+  Status status;
+  while (!data.empty()) {
+    // Drop the rest of a packet that didn't fit in the buffer.
+    if (discard_bytes_ > 0) {
+      const size_t discarded = std::min(discard_bytes_, data.size());
+      data = data.subspan(discarded);
+      discard_bytes_ -= discarded;
+      continue;
+    }
+
+    // Decode complete packets in place, resynchronizing past invalid packet
+    // indicators.
+    if (pending_bytes_ == 0) {
+      const StatusWithSize result = DecodeHciUartData(data, packet_callback);
+      data = data.subspan(result.size());
+      if (!result.ok()) {
+        status = Status::DataLoss();
+        continue;
+      }
+      if (data.empty()) {
+        break;
+      }
+    }
+
+    // The data starts with a partial packet, or the rest of one. Copy only
+    // enough to learn its size, then enough to complete it.
+    const size_t required_bytes =
+        pending_bytes_ == 0
+            ? 1
+            : RequiredFrameSizeBytes(buffer_.first(pending_bytes_));
+    if (required_bytes > buffer_.size()) {
+      discard_bytes_ = required_bytes - pending_bytes_;
+      pending_bytes_ = 0;
+      status = Status::ResourceExhausted();
+      continue;
+    }
+    const size_t copied =
+        std::min(required_bytes - pending_bytes_, data.size());
+    std::memcpy(buffer_.data() + pending_bytes_, data.data(), copied);
+    pending_bytes_ += copied;
+    data = data.subspan(copied);
+
+    const ConstByteSpan frame = buffer_.first(pending_bytes_);
+    if (pending_bytes_ == required_bytes &&
+        RequiredFrameSizeBytes(frame) == pending_bytes_) {
+      DecodeHciUartData(frame, packet_callback).IgnoreError();
+      pending_bytes_ = 0;
+    }
+  }
+  return status;
+}
+
 }  // namespace pw::bluetooth_hci
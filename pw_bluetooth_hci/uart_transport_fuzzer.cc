@@ -12,6 +12,7 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <algorithm>
 #include <cstddef>
 
 #include "pw_bluetooth_hci/packet.h"
@@ -113,6 +114,20 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
   const StatusWithSize result =
       DecodeHciUartData(as_bytes(span(data, size)), packet_callback);
   result.status().IgnoreError();
+
+  // Also stream the data through the reassembler in chunks whose size comes
+  // from the first byte, so packets are split at varying offsets.
+  if (size > 0) {
+    UartReassemblerBuffer<512> reassembler;
+    const size_t chunk_size = data[0] % 64 + 1;
+    ConstByteSpan remaining = as_bytes(span(data, size)).subspan(1);
+    while (!remaining.empty()) {
+      const ConstByteSpan chunk =
+          remaining.first(std::min(chunk_size, remaining.size()));
+      remaining = remaining.subspan(chunk.size());
+      reassembler.Process(chunk, packet_callback).IgnoreError();
+    }
+  }
   return 0;
 }
 
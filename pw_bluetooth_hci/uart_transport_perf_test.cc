@@ -0,0 +1,76 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "pw_bluetooth_hci/packet.h"
+#include "pw_bluetooth_hci/uart_transport.h"
+#include "pw_bytes/byte_builder.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::bluetooth_hci {
+namespace {
+
+// Mixed ACL data and event traffic, as during LE audio streaming.
+ByteBuffer<2048> MakeUartStream() {
+  std::array<std::byte, 251> payload{};
+  std::array<std::byte, 260> packet_buffer;
+  ByteBuffer<2048> stream;
+  while (stream.size() + 2 * packet_buffer.size() < stream.max_size()) {
+    stream.push_back(kUartAsyncDataPacketIndicator);
+    stream.append(
+        AsyncDataPacket(0x001, payload).Encode(packet_buffer).value());
+    stream.push_back(kUartEventPacketIndicator);
+    stream.append(EventPacket(0x13, span(payload).first(5))
+                      .Encode(packet_buffer)
+                      .value());
+  }
+  return stream;
+}
+
+// Decodes a buffer of whole packets with DecodeHciUartData().
+void DecodeWholeBuffer(perf_test::State& state) {
+  const ByteBuffer<2048> stream = MakeUartStream();
+  size_t packets = 0;
+  while (state.KeepRunning()) {
+    DecodeHciUartData(stream, [&packets](const Packet&) { ++packets; })
+        .IgnoreError();
+  }
+}
+
+// Feeds the same data to a UartReassembler in chunks of chunk_size bytes, as
+// from a UART driver.
+void ReassembleChunks(perf_test::State& state, int64_t chunk_size) {
+  const ByteBuffer<2048> stream = MakeUartStream();
+  UartReassemblerBuffer<260> reassembler;
+  size_t packets = 0;
+  while (state.KeepRunning()) {
+    ConstByteSpan data(stream);
+    while (!data.empty()) {
+      const ConstByteSpan chunk =
+          data.first(std::min(static_cast<size_t>(chunk_size), data.size()));
+      data = data.subspan(chunk.size());
+      reassembler.Process(chunk, [&packets](const Packet&) { ++packets; })
+          .IgnoreError();
+    }
+  }
+}
+
+PW_PERF_TEST(DecodeWholeBuffer, DecodeWholeBuffer);
+PW_PERF_TEST_RANGE(ReassembleChunks, ReassembleChunks, 16, 1024, 4);
+
+}  // namespace
+}  // namespace pw::bluetooth_hci
@@ -14,6 +14,9 @@
 
 #include "pw_bluetooth_hci/uart_transport.h"
 
+#include <algorithm>
+#include <array>
+
 #include "gtest/gtest.h"
 #include "pw_bluetooth_hci/packet.h"
 #include "pw_bytes/byte_builder.h"
@@ -405,5 +408,117 @@ TEST_F(UartTransportTest, LotsOfEventPackets) {
   EXPECT_EQ(event_packet_count, expected_packet_count);
 }
 
+class UartReassemblerTest : public UartTransportTest {
+ protected:
+  // Appends an ACL data packet and an event packet with payloads of the given
+  // size to the UART buffer.
+  void AppendPackets(size_t payload_size_bytes) {
+    std::array<std::byte, 64> payload;
+    for (size_t i = 0; i < payload.size(); ++i) {
+      payload[i] = static_cast<std::byte>(i);
+    }
+    const ConstByteSpan data = span(payload).first(payload_size_bytes);
+
+    std::array<std::byte, 128> packet_buffer;
+    Result<ConstByteSpan> encoded =
+        AsyncDataPacket(0x123u, data).Encode(packet_buffer);
+    ASSERT_EQ(encoded.status(), OkStatus());
+    uart_buffer_.push_back(kUartAsyncDataPacketIndicator);
+    uart_buffer_.append(*encoded);
+
+    encoded = EventPacket(0x0Eu, data).Encode(packet_buffer);
+    ASSERT_EQ(encoded.status(), OkStatus());
+    uart_buffer_.push_back(kUartEventPacketIndicator);
+    uart_buffer_.append(*encoded);
+    ASSERT_EQ(uart_buffer_.status(), OkStatus());
+  }
+
+  UartReassemblerBuffer<80> reassembler_;
+};
+
+TEST_F(UartReassemblerTest, ReassemblesAnyChunkSize) {
+  AppendPackets(0);
+  AppendPackets(7);
+  AppendPackets(64);
+
+  for (size_t chunk_size = 1; chunk_size <= uart_buffer_.size();
+       ++chunk_size) {
+    struct {
+      size_t packets = 0;
+      size_t bytes = 0;
+    } decoded;
+    ConstByteSpan data(uart_buffer_);
+    while (!data.empty()) {
+      const ConstByteSpan chunk = data.first(std::min(chunk_size, data.size()));
+      data = data.subspan(chunk.size());
+      EXPECT_EQ(reassembler_.Process(chunk,
+                                     [&decoded](const Packet& packet) {
+                                       ++decoded.packets;
+                                       decoded.bytes += packet.size_bytes();
+                                     }),
+                OkStatus());
+    }
+    EXPECT_EQ(decoded.packets, 6u);
+    EXPECT_EQ(decoded.bytes, uart_buffer_.size() - decoded.packets);
+    EXPECT_EQ(reassembler_.pending_bytes(), 0u);
+  }
+}
+
+TEST_F(UartReassemblerTest, DecodesWholePacketsInPlace) {
+  AppendPackets(7);
+  const ConstByteSpan data(uart_buffer_);
+
+  // Counts packets whose payload is within the data.
+  struct {
+    ConstByteSpan data;
+    size_t in_place_packets = 0;
+  } decoded{data};
+  EXPECT_EQ(reassembler_.Process(
+                data,
+                [&decoded](const Packet& packet) {
+                  const ConstByteSpan payload =
+                      packet.type() == Packet::Type::kEventPacket
+                          ? packet.event_packet().parameters()
+                          : packet.async_data_packet().data();
+                  if (payload.data() >= decoded.data.data() &&
+                      payload.data() + payload.size() <=
+                          decoded.data.data() + decoded.data.size()) {
+                    ++decoded.in_place_packets;
+                  }
+                }),
+            OkStatus());
+  EXPECT_EQ(decoded.in_place_packets, 2u);
+}
+
+TEST_F(UartReassemblerTest, ResynchronizesAfterInvalidIndicator) {
+  uart_buffer_.push_back(kInvalidPacketIndicator);
+  AppendPackets(3);
+
+  size_t packet_count = 0;
+  EXPECT_EQ(reassembler_.Process(uart_buffer_,
+                                 [&packet_count](const Packet&) {
+                                   ++packet_count;
+                                 }),
+            Status::DataLoss());
+  EXPECT_EQ(packet_count, 2u);
+}
+
+TEST_F(UartReassemblerTest, DropsPacketLargerThanBuffer) {
+  UartReassemblerBuffer<16> small_reassembler;
+  AppendPackets(32);  // Too large.
+  AppendPackets(2);
+
+  // Feed the data in two chunks so the large packets must be buffered.
+  const ConstByteSpan data(uart_buffer_);
+  size_t packet_count = 0;
+  auto count_packets = [&packet_count](const Packet&) { ++packet_count; };
+  EXPECT_EQ(small_reassembler.Process(data.first(3), count_packets),
+            OkStatus());
+  EXPECT_EQ(small_reassembler.Process(data.subspan(3), count_packets),
+            Status::ResourceExhausted());
+  // Only the event packet that arrived whole and the last two are decoded.
+  EXPECT_EQ(packet_count, 3u);
+}
+
 }  // namespace
 }  // namespace pw::bluetooth_hci
@@ -52,8 +52,8 @@
 //     3.7. pw_boot_PostMain()
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
-#include <string.h>
 
 #include "pw_boot/boot.h"
 #include "pw_boot_cortex_m/boot.h"
@@ -71,6 +71,10 @@
 #error "Your selected Cortex-M arch is not yet supported by this module."
 #endif
 
+#if PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES && _PW_ARCH_ARM_V6M
+#error "ARMv6-M cores don't have the DWT cycle counter needed to measure boot."
+#endif
+
 // Extern symbols provided by linker script.
 // These symbols tell us where various memory sections start and end.
 extern uint8_t _pw_static_init_ram_start;
@@ -82,20 +86,107 @@ extern uint8_t _pw_zero_init_ram_end;
 // Functions called as part of firmware initialization.
 void __libc_init_array(void);
 
+#if PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
+
+uint32_t pw_boot_static_memory_init_cycles;
+uint32_t pw_boot_pre_main_cycles;
+
+#define DEMCR (*(volatile uint32_t*)0xE000EDFCu)
+#define DEMCR_TRCENA 0x01000000u
+#define DWT_CTRL (*(volatile uint32_t*)0xE0001000u)
+#define DWT_CTRL_CYCCNTENA 0x00000001u
+#define DWT_CYCCNT (*(volatile uint32_t*)0xE0001004u)
+
+static void StartCycleCounter(void) {
+  DEMCR |= DEMCR_TRCENA;
+  DWT_CYCCNT = 0;
+  DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+}
+
+#endif  // PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
+
+// The loops below must not be turned back into calls to memcpy and memset,
+// which are often byte-at-a-time in C libraries built for size.
+#if defined(__clang__)
+#define PW_BOOT_NO_BUILTIN_LOOPS __attribute__((no_builtin("memcpy", "memset")))
+#elif defined(__GNUC__)
+#define PW_BOOT_NO_BUILTIN_LOOPS \
+  __attribute__((optimize("no-tree-loop-distribute-patterns")))
+#else
+#define PW_BOOT_NO_BUILTIN_LOOPS
+#endif  // defined(__clang__)
+
+static bool IsWordAligned(const void* address) {
+  return ((uintptr_t)address & (sizeof(uint32_t) - 1)) == 0u;
+}
+
+// Copies [src, src + (dst_end - dst)) to [dst, dst_end). The linker script
+// word aligns the sections, so this copies four words per iteration, which
+// ARMv7-M and ARMv8-M Mainline cores do with a single LDM and STM.
+PW_BOOT_NO_BUILTIN_LOOPS static void CopyRam(uint8_t* dst,
+                                             const uint8_t* src,
+                                             const uint8_t* dst_end) {
+  if (IsWordAligned(dst) && IsWordAligned(src)) {
+    uint32_t* dst_word = (uint32_t*)dst;
+    const uint32_t* src_word = (const uint32_t*)src;
+    while ((size_t)(dst_end - (const uint8_t*)dst_word) >=
+           4 * sizeof(uint32_t)) {
+      const uint32_t w0 = src_word[0];
+      const uint32_t w1 = src_word[1];
+      const uint32_t w2 = src_word[2];
+      const uint32_t w3 = src_word[3];
+      dst_word[0] = w0;
+      dst_word[1] = w1;
+      dst_word[2] = w2;
+      dst_word[3] = w3;
+      dst_word += 4;
+      src_word += 4;
+    }
+    dst = (uint8_t*)dst_word;
+    src = (const uint8_t*)src_word;
+  }
+  while (dst < dst_end) {
+    *dst++ = *src++;
+  }
+}
+
+// Zeroes [dst, dst_end) four words per iteration, which ARMv7-M and ARMv8-M
+// Mainline cores do with a single STM.
+PW_BOOT_NO_BUILTIN_LOOPS static void ZeroRam(uint8_t* dst,
+                                             const uint8_t* dst_end) {
+  if (IsWordAligned(dst)) {
+    uint32_t* dst_word = (uint32_t*)dst;
+    while ((size_t)(dst_end - (const uint8_t*)dst_word) >=
+           4 * sizeof(uint32_t)) {
+      dst_word[0] = 0u;
+      dst_word[1] = 0u;
+      dst_word[2] = 0u;
+      dst_word[3] = 0u;
+      dst_word += 4;
+    }
+    dst = (uint8_t*)dst_word;
+  }
+  while (dst < dst_end) {
+    *dst++ = 0u;
+  }
+}
+
 // WARNING: Be EXTREMELY careful when running code before this function
 // completes. The context before this function violates the C spec
 // (Section 6.7.8, paragraph 10 for example, which requires uninitialized static
 // values to be zero-initialized).
 void StaticMemoryInit(void) {
   // Static-init RAM (load static values into ram, .data section init).
-  memcpy(&_pw_static_init_ram_start,
-         &_pw_static_init_flash_start,
-         &_pw_static_init_ram_end - &_pw_static_init_ram_start);
+  CopyRam(&_pw_static_init_ram_start,
+          &_pw_static_init_flash_start,
+          &_pw_static_init_ram_end);
 
   // Zero-init RAM (.bss section init).
-  memset(&_pw_zero_init_ram_start,
-         0,
-         &_pw_zero_init_ram_end - &_pw_zero_init_ram_start);
+  ZeroRam(&_pw_zero_init_ram_start, &_pw_zero_init_ram_end);
+}
+
+void pw_boot_LazyZeroInit(void) {
+  ZeroRam(&pw_boot_lazy_zero_init_low_addr, &pw_boot_lazy_zero_init_high_addr);
 }
 
 // WARNING: This code is run immediately upon boot, and performs initialization
@@ -121,6 +212,10 @@ void pw_boot_Entry(void) {
   // not safe to run handlers until after this function returns.
   asm volatile("cpsid i");
 
+#if PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
+  StartCycleCounter();
+#endif  // PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
+
 #if _PW_ARCH_ARM_V8M_MAINLINE || _PW_ARCH_ARM_V8_1M_MAINLINE
   // Set VTOR to the location of the vector table.
   //
@@ -153,7 +248,14 @@ void pw_boot_Entry(void) {
   // example, which requires uninitialized static values to be
   // zero-initialized). Be EXTREMELY careful when running code before this
   // function finishes static memory initialization.
+#if PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
+  const uint32_t static_memory_init_start = DWT_CYCCNT;
   StaticMemoryInit();
+  // Stored after static memory init, which would otherwise zero it.
+  pw_boot_static_memory_init_cycles = DWT_CYCCNT - static_memory_init_start;
+#else
+  StaticMemoryInit();
+#endif  // PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
 
   // Reenable interrupts.
   //
@@ -172,6 +274,10 @@ void pw_boot_Entry(void) {
   // project, or application is expected to implement it.
   pw_boot_PreMainInit();
 
+#if PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
+  pw_boot_pre_main_cycles = DWT_CYCCNT;
+#endif  // PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
+
   // Run main.
   main();
 
@@ -43,6 +43,7 @@
 
 #include <stdint.h>
 
+#include "pw_boot_cortex_m/internal/config.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_preprocessor/util.h"
 
@@ -75,4 +76,36 @@ extern uint8_t pw_boot_heap_high_addr;
 // can be used to set VTOR (vector table offset register) by the bootloader.
 extern uint8_t pw_boot_vector_table_addr;
 
+// pw_boot_lazy_zero_init_[low/high]_addr indicate the range of the variables
+// declared with PW_BOOT_LAZY_ZERO_INIT. They are weak so that custom linker
+// scripts may leave out the section, in which case both are null.
+extern uint8_t pw_boot_lazy_zero_init_low_addr PW_WEAK;
+extern uint8_t pw_boot_lazy_zero_init_high_addr PW_WEAK;
+
+// Declares a variable that pw_boot_Entry() does not zero, which makes boot
+// faster for large buffers. Variables declared with this must not have an
+// initializer or a constructor, and must not be used until
+// pw_boot_LazyZeroInit() (or a DMA transfer covering the range above) has
+// zeroed them.
+//
+// Example:
+//   PW_BOOT_LAZY_ZERO_INIT static uint8_t frame_buffer[128 * 1024];
+#define PW_BOOT_LAZY_ZERO_INIT PW_PLACE_IN_SECTION(".pw_boot_lazy_zero_init")
+
+// Zeroes the variables declared with PW_BOOT_LAZY_ZERO_INIT.
+void pw_boot_LazyZeroInit(void);
+
+#if PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
+
+// The number of CPU cycles that pw_boot_Entry() took to initialize static
+// memory (.data and .bss).
+extern uint32_t pw_boot_static_memory_init_cycles;
+
+// The number of CPU cycles from the start of pw_boot_Entry() until main() was
+// called, which includes static memory initialization, static constructors,
+// and the pw_boot hooks.
+extern uint32_t pw_boot_pre_main_cycles;
+
+#endif  // PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
+
 PW_EXTERN_C_END
@@ -0,0 +1,22 @@
+// Copyright 2019 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Whether pw_boot_Entry() counts the CPU cycles spent in boot with the DWT
+// cycle counter, and stores them in pw_boot_static_memory_init_cycles and
+// pw_boot_pre_main_cycles. This enables the DWT and trace (DEMCR.TRCENA), so it
+// is off by default. ARMv6-M cores don't have the cycle counter.
+#ifndef PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
+#define PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES 0
+#endif  // PW_BOOT_CORTEX_M_MEASURE_BOOT_CYCLES
@@ -0,0 +1,217 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_bytes/bit_stream.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace pw::bytes {
+namespace {
+
+// Eight values of any width fill a whole number of bytes.
+constexpr size_t kGroupSize = 8;
+
+void StoreLittleEndian32(std::byte* output, uint32_t value) {
+  value = ConvertOrderTo(endian::little, value);
+  std::memcpy(output, &value, sizeof(value));
+}
+
+// Packs one group of 8 values into kBits bytes. Since kBits is a constant, the
+// loop is fully unrolled into straight-line shifts and stores.
+template <unsigned kBits>
+void PackGroup(const uint16_t* values, std::byte* output) {
+  constexpr uint32_t kMask = (1u << kBits) - 1;
+  uint64_t accumulator = 0;
+  unsigned count = 0;
+
+  for (size_t i = 0; i < kGroupSize; ++i) {
+    accumulator |= uint64_t{values[i] & kMask} << count;
+    count += kBits;
+    if (count >= 32u) {
+      StoreLittleEndian32(output, static_cast<uint32_t>(accumulator));
+      output += 4;
+      accumulator >>= 32;
+      count -= 32;
+    }
+  }
+  for (; count > 0u; count -= 8) {
+    *output++ = static_cast<std::byte>(accumulator);
+    accumulator >>= 8;
+  }
+}
+
+uint32_t LoadLittleEndian32(const std::byte* input) {
+  return ReadInOrder<uint32_t>(endian::little, input);
+}
+
+// Unpacks one group of 8 values from kBits bytes. Each value is extracted from
+// an independent 32-bit load at a constant offset, so the loads and shifts can
+// run in parallel. May read up to 3 bytes past the group.
+template <unsigned kBits>
+void UnpackGroupFast(const std::byte* input, uint16_t* values) {
+  constexpr uint32_t kMask = (1u << kBits) - 1;
+  for (size_t i = 0; i < kGroupSize; ++i) {
+    const size_t bit = i * kBits;
+    values[i] = static_cast<uint16_t>(
+        (LoadLittleEndian32(input + bit / 8) >> (bit % 8)) & kMask);
+  }
+}
+
+// Unpacks one group of 8 values from kBits bytes, reading no further.
+template <unsigned kBits>
+void UnpackGroup(const std::byte* input, uint16_t* values) {
+  constexpr uint32_t kMask = (1u << kBits) - 1;
+  uint64_t accumulator = 0;
+  unsigned count = 0;
+
+  for (size_t i = 0; i < kGroupSize; ++i) {
+    while (count < kBits) {
+      accumulator |= uint64_t{std::to_integer<uint8_t>(*input++)} << count;
+      count += 8;
+    }
+    values[i] = static_cast<uint16_t>(accumulator & kMask);
+    accumulator >>= kBits;
+    count -= kBits;
+  }
+}
+
+template <unsigned kBits>
+void PackGroups(const uint16_t* values, size_t groups, std::byte* output) {
+  for (size_t i = 0; i < groups; ++i) {
+    PackGroup<kBits>(values + i * kGroupSize, output + i * kBits);
+  }
+}
+
+template <unsigned kBits>
+void UnpackGroups(ConstByteSpan input, size_t groups, uint16_t* values) {
+  // Use the fast path while it cannot read past the end of the input.
+  const size_t fast_groups =
+      input.size() < 3u ? 0 : std::min(groups, (input.size() - 3) / kBits);
+  size_t i = 0;
+  for (; i < fast_groups; ++i) {
+    UnpackGroupFast<kBits>(input.data() + i * kBits, values + i * kGroupSize);
+  }
+  for (; i < groups; ++i) {
+    UnpackGroup<kBits>(input.data() + i * kBits, values + i * kGroupSize);
+  }
+}
+
+using PackFunction = void (*)(const uint16_t*, size_t, std::byte*);
+using UnpackFunction = void (*)(ConstByteSpan, size_t, uint16_t*);
+
+// Tables of the specialized functions, indexed by the bit width minus 1.
+template <size_t... kIndex>
+constexpr std::array<PackFunction, sizeof...(kIndex)> PackTable(
+    std::index_sequence<kIndex...>) {
+  return {&PackGroups<kIndex + 1>...};
+}
+
+template <size_t... kIndex>
+constexpr std::array<UnpackFunction, sizeof...(kIndex)> UnpackTable(
+    std::index_sequence<kIndex...>) {
+  return {&UnpackGroups<kIndex + 1>...};
+}
+
+constexpr size_t kMaxBits = 16;
+constexpr auto kPackFunctions =
+    PackTable(std::make_index_sequence<kMaxBits>());
+constexpr auto kUnpackFunctions =
+    UnpackTable(std::make_index_sequence<kMaxBits>());
+
+}  // namespace
+
+StatusWithSize BitWriter::Flush() {
+  std::byte* const output =
+      buffer_.data() + (bits_written_ - accumulator_bits_) / 8;
+  const size_t bytes = (accumulator_bits_ + 7u) / 8;
+  for (size_t i = 0; i < bytes; ++i) {
+    output[i] = static_cast<std::byte>(accumulator_ >> (i * 8));
+  }
+  accumulator_ = 0;
+  accumulator_bits_ = 0;
+  bits_written_ = size() * 8;
+  return StatusWithSize(status_, size());
+}
+
+void BitReader::Refill() {
+  if (remaining_bytes_ >= sizeof(uint64_t)) {
+    // Load 8 bytes at once and keep as many whole bytes as fit. Bits above the
+    // kept bytes are the same bits that the next refill loads, so leaving them
+    // in the accumulator is harmless.
+    const uint64_t word = ReadInOrder<uint64_t>(endian::little, next_);
+    accumulator_ |= word << accumulator_bits_;
+    const size_t bytes = (63u - accumulator_bits_) / 8;
+    next_ += bytes;
+    remaining_bytes_ -= bytes;
+    accumulator_bits_ += static_cast<uint_fast8_t>(bytes * 8);
+    return;
+  }
+
+  while (accumulator_bits_ <= 56u && remaining_bytes_ > 0u) {
+    accumulator_ |= uint64_t{std::to_integer<uint8_t>(*next_)}
+                    << accumulator_bits_;
+    next_ += 1;
+    remaining_bytes_ -= 1;
+    accumulator_bits_ += 8;
+  }
+}
+
+StatusWithSize PackBits(span<const uint16_t> values,
+                        uint_fast8_t bits,
+                        ByteSpan output) {
+  if (bits == 0u || bits > kMaxBits) {
+    return StatusWithSize::InvalidArgument();
+  }
+  const size_t output_size = (values.size() * bits + 7) / 8;
+  if (output_size > output.size()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  const size_t groups = values.size() / kGroupSize;
+  kPackFunctions[bits - 1](values.data(), groups, output.data());
+
+  // Pack the last few values one at a time.
+  BitWriter writer(output.subspan(groups * bits));
+  for (uint16_t value : values.subspan(groups * kGroupSize)) {
+    writer.Write(value, bits);
+  }
+  writer.Flush();
+  return StatusWithSize(output_size);
+}
+
+Status UnpackBits(ConstByteSpan input,
+                  uint_fast8_t bits,
+                  span<uint16_t> values) {
+  if (bits == 0u || bits > kMaxBits) {
+    return Status::InvalidArgument();
+  }
+  if ((values.size() * bits + 7) / 8 > input.size()) {
+    return Status::OutOfRange();
+  }
+
+  const size_t groups = values.size() / kGroupSize;
+  kUnpackFunctions[bits - 1](input, groups, values.data());
+
+  BitReader reader(input.subspan(groups * bits));
+  for (uint16_t& value : values.subspan(groups * kGroupSize)) {
+    uint32_t field = 0;
+    static_cast<void>(reader.Read(bits, field));
+    value = static_cast<uint16_t>(field);
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::bytes
@@ -0,0 +1,195 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_bytes/bit_stream.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::bytes {
+namespace {
+
+// Simple deterministic values to pack, with bits above any field width set.
+uint16_t TestValue(size_t i) {
+  return static_cast<uint16_t>(i * 40503u + 0x8001u);
+}
+
+TEST(BitWriter, LeastSignificantBitFirst) {
+  std::array<std::byte, 3> buffer = {};
+  BitWriter writer(buffer);
+  writer.Write(0b101, 3).Write(0b11110, 5).Write(0xABC, 12);
+  EXPECT_EQ(20u, writer.bits_written());
+
+  const StatusWithSize result = writer.Flush();
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(3u, result.size());
+  EXPECT_EQ(buffer, (Array<0b11110'101, 0xBC, 0x0A>()));
+}
+
+TEST(BitWriter, IgnoresHighBits) {
+  std::array<std::byte, 1> buffer = {};
+  BitWriter writer(buffer);
+  writer.Write(0xFFFFFFF0, 4).Write(0xFFFFFFFF, 4);
+  writer.Flush();
+  EXPECT_EQ(buffer, (Array<0xF0>()));
+}
+
+TEST(BitWriter, ByteAlignedWordsAreLittleEndian) {
+  std::array<std::byte, 7> buffer = {};
+  BitWriter writer(buffer);
+  writer.Write(0x11223344, 32).Write(0xAABB, 16).Write(0xCC, 8);
+  EXPECT_EQ(7u, writer.Flush().size());
+  EXPECT_EQ(buffer, (Array<0x44, 0x33, 0x22, 0x11, 0xBB, 0xAA, 0xCC>()));
+}
+
+TEST(BitWriter, Exhausted_WritesNothing) {
+  std::array<std::byte, 2> buffer = {};
+  BitWriter writer(buffer);
+  writer.Write(0x1FF, 9);
+  writer.Write(0xFF, 8);
+  EXPECT_EQ(Status::ResourceExhausted(), writer.status());
+  EXPECT_EQ(9u, writer.bits_written());
+
+  writer.clear_status();
+  writer.Write(0x7F, 7);
+  EXPECT_EQ(OkStatus(), writer.status());
+  EXPECT_EQ(2u, writer.Flush().size());
+  EXPECT_EQ(buffer, (Array<0xFF, 0xFF>()));
+}
+
+TEST(BitWriter, AlignToByte) {
+  std::array<std::byte, 2> buffer = {};
+  BitWriter writer(buffer);
+  writer.WriteBit(true).AlignToByte().WriteBit(true);
+  EXPECT_EQ(9u, writer.bits_written());
+  writer.Flush();
+  EXPECT_EQ(buffer, (Array<0x01, 0x01>()));
+}
+
+TEST(BitReader, ReadsBitWriterOutput) {
+  std::array<std::byte, 64> buffer = {};
+  BitWriter writer(buffer);
+  for (size_t i = 0; i < 32; ++i) {
+    writer.Write(TestValue(i), static_cast<uint_fast8_t>(i % 16 + 1));
+  }
+  ASSERT_EQ(OkStatus(), writer.Flush().status());
+
+  BitReader reader(ConstByteSpan(buffer).first(writer.size()));
+  for (size_t i = 0; i < 32; ++i) {
+    const auto bits = static_cast<uint_fast8_t>(i % 16 + 1);
+    uint32_t value = 0;
+    ASSERT_TRUE(reader.Read(bits, value));
+    EXPECT_EQ(TestValue(i) & ((1u << bits) - 1), value);
+  }
+  EXPECT_LT(reader.bits_remaining(), 8u);
+}
+
+TEST(BitReader, Read32Bits) {
+  constexpr auto kBuffer = Array<0xF0, 0x44, 0x33, 0x22, 0x11>();
+  BitReader reader(kBuffer);
+  uint32_t value = 0;
+  ASSERT_TRUE(reader.Read(4, value));
+  EXPECT_EQ(0x0u, value);
+  ASSERT_TRUE(reader.Read(32, value));
+  EXPECT_EQ(0x1223344Fu, value);
+  EXPECT_EQ(4u, reader.bits_remaining());
+}
+
+TEST(BitReader, NotEnoughBits) {
+  constexpr auto kBuffer = Array<0xAB>();
+  BitReader reader(kBuffer);
+  uint32_t value = 7;
+  EXPECT_FALSE(reader.Read(9, value));
+  EXPECT_EQ(7u, value);
+
+  ASSERT_TRUE(reader.Read(8, value));
+  EXPECT_EQ(0xABu, value);
+
+  bool bit = false;
+  EXPECT_FALSE(reader.ReadBit(bit));
+}
+
+TEST(BitReader, AlignToByte) {
+  constexpr auto kBuffer = Array<0xFF, 0x5A>();
+  BitReader reader(kBuffer);
+  bool bit = false;
+  ASSERT_TRUE(reader.ReadBit(bit));
+  EXPECT_TRUE(bit);
+
+  reader.AlignToByte();
+  EXPECT_EQ(8u, reader.bits_remaining());
+
+  uint32_t value = 0;
+  ASSERT_TRUE(reader.Read(8, value));
+  EXPECT_EQ(0x5Au, value);
+}
+
+TEST(PackBits, InvalidWidth) {
+  constexpr uint16_t kValues[] = {1};
+  std::array<std::byte, 4> buffer = {};
+  EXPECT_EQ(Status::InvalidArgument(), PackBits(kValues, 0, buffer).status());
+  EXPECT_EQ(Status::InvalidArgument(), PackBits(kValues, 17, buffer).status());
+
+  uint16_t values[1] = {};
+  EXPECT_EQ(Status::InvalidArgument(), UnpackBits(buffer, 0, values));
+  EXPECT_EQ(Status::InvalidArgument(), UnpackBits(buffer, 17, values));
+}
+
+TEST(PackBits, BufferTooSmall) {
+  constexpr uint16_t kValues[9] = {};
+  std::array<std::byte, 4> buffer = {};
+  EXPECT_EQ(Status::ResourceExhausted(), PackBits(kValues, 4, buffer).status());
+  EXPECT_EQ(OkStatus(), PackBits(span(kValues).first(8), 4, buffer).status());
+
+  uint16_t values[9] = {};
+  EXPECT_EQ(Status::OutOfRange(), UnpackBits(buffer, 4, values));
+}
+
+TEST(PackBits, MatchesBitWriter_AllWidths) {
+  // 8 groups of 8 plus 5 more, to cover both the group and the tail paths.
+  constexpr size_t kCount = 69;
+  std::array<uint16_t, kCount> values;
+  for (size_t i = 0; i < kCount; ++i) {
+    values[i] = TestValue(i);
+  }
+
+  for (uint_fast8_t bits = 1; bits <= 16; ++bits) {
+    std::array<std::byte, kCount * 2> expected = {};
+    BitWriter writer(expected);
+    for (uint16_t value : values) {
+      writer.Write(value, bits);
+    }
+    const size_t size = writer.Flush().size();
+
+    std::array<std::byte, kCount * 2> packed = {};
+    const StatusWithSize result = PackBits(values, bits, packed);
+    EXPECT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(size, result.size());
+    EXPECT_EQ(expected, packed);
+
+    std::array<uint16_t, kCount> unpacked = {};
+    EXPECT_EQ(OkStatus(),
+              UnpackBits(ConstByteSpan(packed).first(size), bits, unpacked));
+    for (size_t i = 0; i < kCount; ++i) {
+      EXPECT_EQ(values[i] & ((1u << bits) - 1), unpacked[i]);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace pw::bytes
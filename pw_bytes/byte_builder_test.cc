@@ -16,6 +16,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 #include "gtest/gtest.h"
 
@@ -502,6 +503,56 @@ TEST(ByteBuffer, Putting64ByteInts_Exhausted_kBigEndian) {
   EXPECT_EQ(Status::ResourceExhausted(), bb.status());
 }
 
+TEST(ByteBuffer, PutArray_16Bit_kLittleEndian) {
+  constexpr uint16_t kSamples[] = {0x0102, 0xF3F4, 0x0506};
+  ByteBuffer<6> bb;
+  bb.PutArray<uint16_t>(kSamples);
+
+  EXPECT_EQ(OkStatus(), bb.status());
+  ASSERT_EQ(6u, bb.size());
+  EXPECT_EQ(byte{0x02}, bb.data()[0]);
+  EXPECT_EQ(byte{0x01}, bb.data()[1]);
+  EXPECT_EQ(byte{0xF4}, bb.data()[2]);
+  EXPECT_EQ(byte{0xF3}, bb.data()[3]);
+  EXPECT_EQ(byte{0x06}, bb.data()[4]);
+  EXPECT_EQ(byte{0x05}, bb.data()[5]);
+}
+
+TEST(ByteBuffer, PutArray_MatchesPutInt32_kBigEndian) {
+  constexpr int32_t kSamples[] = {-114743374, 0x0C90739E, 0, -1};
+  ByteBuffer<16> expected;
+  for (int32_t sample : kSamples) {
+    expected.PutInt32(sample, endian::big);
+  }
+
+  ByteBuffer<16> bb;
+  bb.PutArray<int32_t>(kSamples, endian::big);
+
+  EXPECT_EQ(OkStatus(), bb.status());
+  ASSERT_EQ(expected.size(), bb.size());
+  EXPECT_EQ(0, std::memcmp(expected.data(), bb.data(), bb.size()));
+}
+
+TEST(ByteBuffer, PutArray_Exhausted_AppendsNothing) {
+  constexpr uint64_t kSamples[] = {1, 2};
+  ByteBuffer<20> bb;
+  bb.PutUint8(0x03);
+  bb.PutArray<uint64_t>(kSamples);
+  EXPECT_EQ(OkStatus(), bb.status());
+  EXPECT_EQ(17u, bb.size());
+
+  bb.PutArray<uint64_t>(kSamples);
+  EXPECT_EQ(Status::ResourceExhausted(), bb.status());
+  EXPECT_EQ(17u, bb.size());
+}
+
+TEST(ByteBuffer, PutArray_Empty) {
+  ByteBuffer<4> bb;
+  bb.PutArray(span<const uint32_t>());
+  EXPECT_EQ(OkStatus(), bb.status());
+  EXPECT_TRUE(bb.empty());
+}
+
 TEST(ByteBuffer, PuttingInts_MixedTypes_MixedEndian) {
   ByteBuffer<16> bb;
   bb.PutUint8(0x03);
@@ -296,5 +296,74 @@ TEST(ReadInOrder, PartialBigEndian) {
   EXPECT_EQ(0x01020304, ReadInOrder<int32_t>(endian::big, buffer.data(), 100));
 }
 
+TEST(CopyArrayInOrder, 16Bit_Little) {
+  constexpr uint16_t kValues[] = {0x1122, 0x3344, 0xAABB};
+  std::array<std::byte, 6> buffer = {};
+  CopyArrayInOrder<uint16_t>(endian::little, kValues, buffer.data());
+  EXPECT_EQ(buffer, (Array<0x22, 0x11, 0x44, 0x33, 0xBB, 0xAA>()));
+}
+
+TEST(CopyArrayInOrder, 32Bit_Big) {
+  constexpr int32_t kValues[] = {0x11223344, -2};
+  std::array<std::byte, 8> buffer = {};
+  CopyArrayInOrder<int32_t>(endian::big, kValues, buffer.data());
+  EXPECT_EQ(buffer, (Array<0x11, 0x22, 0x33, 0x44, 0xFF, 0xFF, 0xFF, 0xFE>()));
+}
+
+TEST(CopyArrayInOrder, 8Bit_IgnoresOrder) {
+  constexpr uint8_t kValues[] = {1, 2, 3};
+  std::array<std::byte, 3> buffer = {};
+  CopyArrayInOrder<uint8_t>(endian::big, kValues, buffer.data());
+  EXPECT_EQ(buffer, (Array<1, 2, 3>()));
+}
+
+TEST(ReadArrayInOrder, 16Bit_Big) {
+  uint16_t values[4] = {};
+  EXPECT_TRUE(ReadArrayInOrder<uint16_t>(
+      endian::big, as_bytes(span(kNumber, 8)), values));
+  EXPECT_EQ(values[0], 0x1122u);
+  EXPECT_EQ(values[1], 0x3344u);
+  EXPECT_EQ(values[2], 0xAABBu);
+  EXPECT_EQ(values[3], 0xCCDDu);
+}
+
+TEST(ReadArrayInOrder, 32Bit_Little) {
+  int32_t values[2] = {};
+  EXPECT_TRUE(ReadArrayInOrder<int32_t>(
+      endian::little, as_bytes(span(kNumber, 8)), values));
+  EXPECT_EQ(values[0], 0x44332211);
+  EXPECT_EQ(values[1], static_cast<int32_t>(0xDDCCBBAA));
+}
+
+TEST(ReadArrayInOrder, 64Bit_Big) {
+  uint64_t values[1] = {};
+  EXPECT_TRUE(ReadArrayInOrder<uint64_t>(
+      endian::big, as_bytes(span(kNumber, 8)), values));
+  EXPECT_EQ(values[0], 0x11223344AABBCCDDu);
+}
+
+TEST(ReadArrayInOrder, BoundsChecking_TooSmall) {
+  constexpr auto buffer = Array<1, 2, 3, 4, 5>();
+  uint16_t values[3] = {7, 7, 7};
+  EXPECT_FALSE(ReadArrayInOrder<uint16_t>(endian::little, buffer, values));
+  EXPECT_EQ(values[0], 7u);
+  EXPECT_EQ(values[1], 7u);
+  EXPECT_EQ(values[2], 7u);
+}
+
+TEST(ReadArrayInOrder, RoundTrip) {
+  constexpr uint32_t kValues[] = {0, 1, 0x80000000, 0xDEADBEEF, 0xFFFFFFFF};
+  std::array<std::byte, sizeof(kValues)> buffer = {};
+  uint32_t values[5] = {};
+
+  for (endian order : {endian::little, endian::big}) {
+    CopyArrayInOrder<uint32_t>(order, kValues, buffer.data());
+    EXPECT_TRUE(ReadArrayInOrder<uint32_t>(order, buffer, values));
+    for (size_t i = 0; i < 5; ++i) {
+      EXPECT_EQ(values[i], kValues[i]);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace pw::bytes
@@ -0,0 +1,203 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Utilities for packing values of arbitrary bit widths into byte buffers.
+//
+// All functions in this file use the same layout: values are packed starting
+// from the least significant bit of each byte, and the low bits of a value
+// come first. This is the layout used by DEFLATE and by little-endian
+// bitfields, so a value that is a multiple of 8 bits wide at a byte-aligned
+// position is stored in little endian order.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_bytes/endian.h"
+#include "pw_bytes/span.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::bytes {
+
+// BitWriter writes values of 1 to 32 bits to a fixed-size buffer. Bits are
+// collected in a 64-bit accumulator and stored to the buffer 32 bits at a time,
+// so each Write is a few shifts and, at most, one store.
+//
+// Like ByteBuilder, BitWriter never overflows. If a value does not fit in the
+// buffer, it is not written and the status is set to RESOURCE_EXHAUSTED. Call
+// Flush() after the last Write to store the final partial byte.
+class BitWriter {
+ public:
+  constexpr explicit BitWriter(ByteSpan buffer) : buffer_(buffer) {}
+
+  BitWriter(const BitWriter&) = delete;
+  BitWriter& operator=(const BitWriter&) = delete;
+
+  // Writes the low `bits` bits of value. Higher bits are ignored. bits must be
+  // between 0 and 32.
+  BitWriter& Write(uint32_t value, uint_fast8_t bits) {
+    if (!status_.ok()) {
+      return *this;
+    }
+    if (bits > buffer_.size() * 8 - bits_written_) {
+      status_ = Status::ResourceExhausted();
+      return *this;
+    }
+
+    const uint64_t mask = (uint64_t{1} << bits) - 1;
+    accumulator_ |= (value & mask) << accumulator_bits_;
+    accumulator_bits_ += bits;
+    bits_written_ += bits;
+
+    if (accumulator_bits_ >= 32u) {
+      StoreWord();
+    }
+    return *this;
+  }
+
+  // Writes a single bit.
+  BitWriter& WriteBit(bool bit) { return Write(bit ? 1u : 0u, 1); }
+
+  // Pads the output with 0 bits up to the next byte boundary.
+  BitWriter& AlignToByte() {
+    return Write(0, static_cast<uint_fast8_t>((8 - bits_written_ % 8) % 8));
+  }
+
+  // Stores any buffered bits, padding the final byte with 0 bits. Returns the
+  // number of bytes used and the status. Writes may continue after a Flush;
+  // they start at the next byte boundary.
+  StatusWithSize Flush();
+
+  // The number of bits written so far.
+  size_t bits_written() const { return bits_written_; }
+
+  // The number of bytes used in the buffer, including a final partial byte.
+  size_t size() const { return (bits_written_ + 7) / 8; }
+
+  // The status of the writer: OK, or RESOURCE_EXHAUSTED if a value did not fit.
+  // Remains non-OK until cleared with clear_status().
+  Status status() const { return status_; }
+
+  bool ok() const { return status_.ok(); }
+
+  void clear_status() { status_ = OkStatus(); }
+
+ private:
+  void StoreWord() {
+    const uint32_t word =
+        ConvertOrderTo(endian::little, static_cast<uint32_t>(accumulator_));
+    std::memcpy(buffer_.data() + (bits_written_ - accumulator_bits_) / 8,
+                &word,
+                sizeof(word));
+    accumulator_ >>= 32;
+    accumulator_bits_ -= 32;
+  }
+
+  const ByteSpan buffer_;
+  uint64_t accumulator_ = 0;
+  uint_fast8_t accumulator_bits_ = 0;
+  size_t bits_written_ = 0;
+  Status status_;
+};
+
+// BitReader reads values of 1 to 32 bits from a buffer written by BitWriter or
+// PackBits. When at least 8 bytes remain, the accumulator is refilled with a
+// single 64-bit load.
+class BitReader {
+ public:
+  constexpr explicit BitReader(ConstByteSpan buffer)
+      : next_(buffer.data()), remaining_bytes_(buffer.size()) {}
+
+  BitReader(const BitReader&) = delete;
+  BitReader& operator=(const BitReader&) = delete;
+
+  // Reads `bits` bits into value. bits must be between 0 and 32. Returns false,
+  // leaving value unchanged, if fewer than `bits` bits remain.
+  [[nodiscard]] bool Read(uint_fast8_t bits, uint32_t& value) {
+    if (bits > bits_remaining()) {
+      return false;
+    }
+    if (accumulator_bits_ < bits) {
+      Refill();
+    }
+
+    const uint64_t mask = (uint64_t{1} << bits) - 1;
+    value = static_cast<uint32_t>(accumulator_ & mask);
+    accumulator_ >>= bits;
+    accumulator_bits_ -= bits;
+    return true;
+  }
+
+  // Reads a single bit.
+  [[nodiscard]] bool ReadBit(bool& bit) {
+    uint32_t value;
+    if (!Read(1, value)) {
+      return false;
+    }
+    bit = value != 0u;
+    return true;
+  }
+
+  // Skips bits up to the next byte boundary.
+  void AlignToByte() {
+    uint32_t unused;
+    static_cast<void>(Read(accumulator_bits_ % 8, unused));
+  }
+
+  // The number of bits left to read.
+  size_t bits_remaining() const {
+    return remaining_bytes_ * 8 + accumulator_bits_;
+  }
+
+ private:
+  void Refill();
+
+  const std::byte* next_;
+  size_t remaining_bytes_;
+  uint64_t accumulator_ = 0;
+  uint_fast8_t accumulator_bits_ = 0;
+};
+
+// Packs values into bits-wide fields. bits must be between 1 and 16; bits
+// above the field width are ignored. The output is identical to calling
+// BitWriter::Write for each value, followed by Flush.
+//
+// Values are processed in groups of 8, which fill exactly `bits` bytes. The
+// code for each group is specialized for each width, so it is straight-line
+// shifts and stores with no per-value branches. Returns the number of bytes
+// written, which is (values.size() * bits + 7) / 8, and:
+//
+//   OK - all values were packed
+//   INVALID_ARGUMENT - bits is not between 1 and 16
+//   RESOURCE_EXHAUSTED - the output buffer is too small; nothing was written
+//
+StatusWithSize PackBits(span<const uint16_t> values,
+                        uint_fast8_t bits,
+                        ByteSpan output);
+
+// Unpacks bits-wide fields into values, the reverse of PackBits. Fills every
+// element of values. Returns:
+//
+//   OK - all values were unpacked
+//   INVALID_ARGUMENT - bits is not between 1 and 16
+//   OUT_OF_RANGE - input is too small to fill values; nothing was read
+//
+Status UnpackBits(ConstByteSpan input,
+                  uint_fast8_t bits,
+                  span<uint16_t> values);
+
+}  // namespace pw::bytes
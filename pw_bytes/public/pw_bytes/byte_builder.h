@@ -17,6 +17,7 @@
 #include <array>
 #include <cstddef>
 #include <cstring>
+#include <type_traits>
 
 #include "pw_bytes/bit.h"
 #include "pw_bytes/endian.h"
@@ -323,6 +324,26 @@ class ByteBuilder {
     return PutUint64(static_cast<uint64_t>(value), order);
   }
 
+  // Appends an array of integers with the specified endianness. The buffer
+  // space is checked once for the whole array; if it does not fit, nothing is
+  // appended and the status is set to RESOURCE_EXHAUSTED. This is much faster
+  // than calling PutUint16 etc. for each value.
+  //
+  // T must be specified when passing a container other than a span:
+  //
+  //   bb.PutArray<int16_t>(samples, endian::big);
+  //
+  template <typename T>
+  ByteBuilder& PutArray(span<const T> values, endian order = endian::little) {
+    static_assert(std::is_integral_v<T>,
+                  "PutArray only supports arrays of integers");
+    std::byte* const append_destination = buffer_.data() + size_;
+    if (ResizeForAppend(values.size_bytes()) != 0u) {
+      bytes::CopyArrayInOrder(order, values, append_destination);
+    }
+    return *this;
+  }
+
  protected:
   // Functions to support ByteBuffer copies.
   constexpr ByteBuilder(const ByteSpan& buffer, const ByteBuilder& other)
@@ -202,4 +202,47 @@ template <typename T>
   return true;
 }
 
+// Copies an array of values to a buffer with the specified endianness. When
+// the order matches the system's, this is a single memcpy. Otherwise, the bytes
+// of each value are reversed in a simple loop, which compilers vectorize.
+//
+// The buffer **MUST** be at least values.size_bytes() large!
+template <typename T>
+void CopyArrayInOrder(endian order, span<const T> values, void* buffer) {
+  std::byte* const destination = static_cast<std::byte*>(buffer);
+  if (order == endian::native || sizeof(T) == 1u) {
+    std::copy_n(reinterpret_cast<const std::byte*>(values.data()),
+                values.size_bytes(),
+                destination);
+    return;
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    const T value = internal::ReverseBytes(values[i]);
+    std::memcpy(destination + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+// Reads an array of values with the specified endianness from the buffer, with
+// a single bounds check. Returns true if successful, false if the buffer is too
+// small to fill values, in which case values is unchanged.
+template <typename T>
+[[nodiscard]] bool ReadArrayInOrder(endian order,
+                                    ConstByteSpan buffer,
+                                    span<T> values) {
+  static_assert(!std::is_const_v<T>);
+  if (buffer.size() < values.size_bytes()) {
+    return false;
+  }
+
+  std::copy_n(buffer.data(),
+              values.size_bytes(),
+              reinterpret_cast<std::byte*>(values.data()));
+  if (order != endian::native) {
+    for (T& value : values) {
+      value = internal::ReverseBytes(value);
+    }
+  }
+  return true;
+}
+
 }  // namespace pw::bytes
@@ -14,6 +14,8 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
+
 namespace pw::checksum {
 namespace {
 
@@ -52,19 +54,77 @@ constexpr uint16_t kCrc16CcittTable[256]{
     0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,  // 256
 };
 
-}  // namespace
+// Generates the tables for the slicing implementations. Table k holds the CRC
+// of each byte value followed by k zero bytes, so several bytes of data can be
+// processed with independent lookups.
+template <size_t kTables>
+constexpr std::array<std::array<uint16_t, 256>, kTables>
+GenerateSlicingTables() {
+  std::array<std::array<uint16_t, 256>, kTables> tables{};
+  for (size_t i = 0; i < 256; i++) {
+    tables[0][i] = kCrc16CcittTable[i];
+  }
+  for (size_t k = 1; k < kTables; k++) {
+    for (size_t i = 0; i < 256; i++) {
+      const uint16_t previous = tables[k - 1][i];
+      tables[k][i] = static_cast<uint16_t>(
+          (previous << 8) ^ tables[0][(previous >> 8) & 0xffu]);
+    }
+  }
+  return tables;
+}
 
-extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
-                                           size_t size_bytes,
-                                           uint16_t value) {
-  const uint8_t* const array = static_cast<const uint8_t*>(data);
+constexpr std::array<std::array<uint16_t, 256>, 8> kCrc16CcittSlicingTables =
+    GenerateSlicingTables<8>();
 
+uint16_t EightBit(const uint8_t* data, size_t size_bytes, uint16_t value) {
   for (size_t i = 0; i < size_bytes; ++i) {
-    value = kCrc16CcittTable[((value >> 8u) ^ array[i]) & 0xffu] ^
+    value = kCrc16CcittTable[((value >> 8u) ^ data[i]) & 0xffu] ^
             static_cast<uint16_t>(value << 8u);
   }
-
   return value;
 }
 
+// Processes kSlices bytes per iteration. The CRC only overlaps the first two
+// bytes of each slice, so the remaining bytes are looked up directly.
+template <size_t kSlices>
+uint16_t Slicing(const uint8_t* data, size_t size_bytes, uint16_t value) {
+  const auto& t = kCrc16CcittSlicingTables;
+  while (size_bytes >= kSlices) {
+    uint16_t next = t[kSlices - 1][data[0] ^ (value >> 8)] ^
+                    t[kSlices - 2][data[1] ^ (value & 0xffu)];
+    for (size_t i = 2; i < kSlices; ++i) {
+      next ^= t[kSlices - 1 - i][data[i]];
+    }
+    value = next;
+    data += kSlices;
+    size_bytes -= kSlices;
+  }
+  return EightBit(data, size_bytes, value);
+}
+
+}  // namespace
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittEightBit(const void* data,
+                                                            size_t size_bytes,
+                                                            uint16_t value) {
+  return EightBit(static_cast<const uint8_t*>(data), size_bytes, value);
+}
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittSlicingBy4(
+    const void* data, size_t size_bytes, uint16_t value) {
+  return Slicing<4>(static_cast<const uint8_t*>(data), size_bytes, value);
+}
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittSlicingBy8(
+    const void* data, size_t size_bytes, uint16_t value) {
+  return Slicing<8>(static_cast<const uint8_t*>(data), size_bytes, value);
+}
+
+extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
+                                           size_t size_bytes,
+                                           uint16_t value) {
+  return _pw_checksum_InternalCrc16Ccitt(data, size_bytes, value);
+}
+
 }  // namespace pw::checksum
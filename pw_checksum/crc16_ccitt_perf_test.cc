@@ -33,5 +33,40 @@ PW_PERF_TEST_SIMPLE(CcittCalculationString,
                     Crc16Ccitt::Calculate,
                     as_bytes(span(kString)));
 
+void Crc16CcittEightBitTest(perf_test::State& state,
+                            span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc16CcittEightBit::Calculate(data);
+  }
+}
+
+void Crc16CcittSlicingBy4Test(perf_test::State& state,
+                              span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc16CcittSlicingBy4::Calculate(data);
+  }
+}
+
+void Crc16CcittSlicingBy8Test(perf_test::State& state,
+                              span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc16CcittSlicingBy8::Calculate(data);
+  }
+}
+
+PW_PERF_TEST(CcittEightBitStringTest,
+             Crc16CcittEightBitTest,
+             as_bytes(span(kString)));
+PW_PERF_TEST(CcittSlicingBy4StringTest,
+             Crc16CcittSlicingBy4Test,
+             as_bytes(span(kString)));
+PW_PERF_TEST(CcittSlicingBy8StringTest,
+             Crc16CcittSlicingBy8Test,
+             as_bytes(span(kString)));
+
+PW_PERF_TEST(CcittEightBitBytesTest, Crc16CcittEightBitTest, kBytes);
+PW_PERF_TEST(CcittSlicingBy4BytesTest, Crc16CcittSlicingBy4Test, kBytes);
+PW_PERF_TEST(CcittSlicingBy8BytesTest, Crc16CcittSlicingBy8Test, kBytes);
+
 }  // namespace
 }  // namespace pw::checksum
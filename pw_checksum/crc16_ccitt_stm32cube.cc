@@ -0,0 +1,87 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Implements _pw_checksum_InternalCrc16CcittHardware with the CRC peripheral of
+// STM32 parts that have a programmable polynomial.
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include "pw_checksum/crc16_ccitt.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "stm32cube/stm32cube.h"
+
+#if !defined(CRC_POL_POL)
+#error "The CRC peripheral of this part does not support 16-bit polynomials"
+#endif  // !defined(CRC_POL_POL)
+
+namespace pw::checksum {
+namespace {
+
+constexpr uint32_t kCrc16CcittPolynomial = 0x1021;
+
+// Bytes processed per critical section, to bound the time other users of the
+// peripheral, and interrupts, wait.
+constexpr size_t kChunkSizeBytes = 256;
+
+sync::InterruptSpinLock crc_lock;
+bool crc_clock_enabled = false;
+
+uint16_t Crc16CcittChunk(const uint8_t* data,
+                         size_t size_bytes,
+                         uint16_t value) {
+  CRC->POL = kCrc16CcittPolynomial;
+  CRC->CR = CRC_CR_POLYSIZE_0;  // 16-bit polynomial, no bit reversal.
+  CRC->INIT = value;
+  CRC->CR |= CRC_CR_RESET;
+
+  // The peripheral shifts in words most significant byte first.
+  while (size_bytes >= sizeof(uint32_t)) {
+    uint32_t word;
+    std::memcpy(&word, data, sizeof(word));
+    CRC->DR = __builtin_bswap32(word);
+    data += sizeof(uint32_t);
+    size_bytes -= sizeof(uint32_t);
+  }
+  for (size_t i = 0; i < size_bytes; ++i) {
+    *reinterpret_cast<volatile uint8_t*>(&CRC->DR) = data[i];
+  }
+  return static_cast<uint16_t>(CRC->DR);
+}
+
+}  // namespace
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittHardware(const void* data,
+                                                            size_t size_bytes,
+                                                            uint16_t value) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+  while (size_bytes > 0u) {
+    const size_t chunk = std::min(size_bytes, kChunkSizeBytes);
+    {
+      std::lock_guard lock(crc_lock);
+      if (!crc_clock_enabled) {
+        __HAL_RCC_CRC_CLK_ENABLE();
+        crc_clock_enabled = true;
+      }
+      value = Crc16CcittChunk(bytes, chunk, value);
+    }
+    bytes += chunk;
+    size_bytes -= chunk;
+  }
+  return value;
+}
+
+}  // namespace pw::checksum
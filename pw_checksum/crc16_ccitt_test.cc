@@ -14,6 +14,7 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
 #include <string_view>
 
 #include "gtest/gtest.h"
@@ -67,6 +68,51 @@ TEST(Crc16Class, String) {
   EXPECT_EQ(crc16.value(), kStringCrc);
 }
 
+template <typename CrcVariant>
+void TestKnownValues() {
+  EXPECT_EQ(CrcVariant::Calculate(span<std::byte>()),
+            CrcVariant::kInitialValue);
+  EXPECT_EQ(CrcVariant::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(CrcVariant::Calculate(as_bytes(span(kString))), kStringCrc);
+
+  CrcVariant crc16;
+  crc16.Update(as_bytes(span(kString)).first(13));
+  crc16.Update(as_bytes(span(kString)).subspan(13));
+  EXPECT_EQ(crc16.value(), kStringCrc);
+}
+
+TEST(Crc16Class, Variants) {
+  TestKnownValues<Crc16CcittEightBit>();
+  TestKnownValues<Crc16CcittSlicingBy4>();
+  TestKnownValues<Crc16CcittSlicingBy8>();
+}
+
+template <typename CrcVariant>
+void TestMatchesEightBit() {
+  // Use enough data to reach the wide loops of the slicing implementations,
+  // and check every offset and tail length around their block sizes.
+  std::array<std::byte, 300> data;
+  uint32_t seed = 1;
+  for (std::byte& b : data) {
+    seed = seed * 1664525u + 1013904223u;
+    b = static_cast<std::byte>(seed >> 24);
+  }
+
+  for (size_t offset = 0; offset < 16; ++offset) {
+    for (size_t size = 0; size + offset <= data.size(); size += 7) {
+      span<const std::byte> chunk = span(data).subspan(offset, size);
+      EXPECT_EQ(CrcVariant::Calculate(chunk),
+                Crc16CcittEightBit::Calculate(chunk));
+    }
+  }
+}
+
+TEST(Crc16Class, MatchesEightBit) {
+  TestMatchesEightBit<Crc16Ccitt>();
+  TestMatchesEightBit<Crc16CcittSlicingBy4>();
+  TestMatchesEightBit<Crc16CcittSlicingBy8>();
+}
+
 extern "C" uint16_t CallChecksumCrc16Ccitt(const void* data, size_t size_bytes);
 
 TEST(Crc16FromC, Buffer) {
@@ -14,6 +14,24 @@
 
 #include "pw_checksum/crc32.h"
 
+#include <array>
+#include <cstring>
+
+#include "pw_checksum/internal/crc32_slicing.h"
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define PW_CHECKSUM_CRC32_ARM_INSTRUCTIONS 1
+#define PW_CHECKSUM_CRC32_X86_PCLMUL 0
+#elif defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PW_CHECKSUM_CRC32_ARM_INSTRUCTIONS 0
+#define PW_CHECKSUM_CRC32_X86_PCLMUL 1
+#else
+#define PW_CHECKSUM_CRC32_ARM_INSTRUCTIONS 0
+#define PW_CHECKSUM_CRC32_X86_PCLMUL 0
+#endif
+
 namespace pw::checksum {
 namespace {
 
@@ -51,8 +69,128 @@ constexpr std::array<uint32_t, (1 << kBits)> GenerateCrc32Table() {
 // https://en.wikipedia.org/wiki/Cyclic_redundancy_check#Polynomial_representations_of_cyclic_redundancy_checks
 constexpr uint32_t kCrc32Polynomial = 0xEDB88320;
 
+// Generates the tables for a slicing-by-8 CRC32 implementation. Table k holds
+// the CRC of each byte value followed by k zero bytes, so eight bytes of data
+// can be processed with eight independent lookups.
+template <uint32_t kPolynomial>
+constexpr std::array<std::array<uint32_t, 256>, 8>
+GenerateCrc32SlicingTables() {
+  std::array<std::array<uint32_t, 256>, 8> tables{};
+  tables[0] = GenerateCrc32Table<8, kPolynomial>();
+  for (size_t k = 1; k < tables.size(); k++) {
+    for (size_t i = 0; i < 256; i++) {
+      const uint32_t previous = tables[k - 1][i];
+      tables[k][i] = (previous >> 8) ^ tables[0][previous & 0xFFu];
+    }
+  }
+  return tables;
+}
+
+constexpr uint32_t LoadLittleEndian32(const uint8_t* bytes) {
+  return static_cast<uint32_t>(bytes[0]) |
+         (static_cast<uint32_t>(bytes[1]) << 8) |
+         (static_cast<uint32_t>(bytes[2]) << 16) |
+         (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+#if PW_CHECKSUM_CRC32_X86_PCLMUL
+
+#define PW_CHECKSUM_CRC32_PCLMUL_TARGET __attribute__((target("pclmul,sse4.1")))
+
+PW_CHECKSUM_CRC32_PCLMUL_TARGET inline __m128i Load128(const uint8_t* bytes) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+}
+
+// Multiplies both halves of value by the folding constants and adds next.
+PW_CHECKSUM_CRC32_PCLMUL_TARGET inline __m128i Fold128(__m128i value,
+                                                       __m128i constants,
+                                                       __m128i next) {
+  __m128i low = _mm_clmulepi64_si128(value, constants, 0x00);
+  __m128i high = _mm_clmulepi64_si128(value, constants, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(high, low), next);
+}
+
+// Folds 16-byte blocks with carry-less multiplication, as described in "Fast
+// CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" by
+// Gopal et al. The constants are the bit-reflected ones from that paper.
+// size_bytes must be a multiple of 16 and at least 64.
+PW_CHECKSUM_CRC32_PCLMUL_TARGET uint32_t Crc32Pclmul(const uint8_t* data,
+                                                     size_t size_bytes,
+                                                     uint32_t state) {
+  alignas(16) static constexpr uint64_t kK1K2[] = {0x154442bd4, 0x1c6e41596};
+  alignas(16) static constexpr uint64_t kK3K4[] = {0x1751997d0, 0x0ccaa009e};
+  alignas(16) static constexpr uint64_t kK5K0[] = {0x163cd6124, 0x000000000};
+  alignas(16) static constexpr uint64_t kPoly[] = {0x1db710641, 0x1f7011641};
+
+  // Fold four blocks at a time in parallel.
+  __m128i x1 = _mm_xor_si128(Load128(data),
+                             _mm_cvtsi32_si128(static_cast<int>(state)));
+  __m128i x2 = Load128(data + 16);
+  __m128i x3 = Load128(data + 32);
+  __m128i x4 = Load128(data + 48);
+  data += 64;
+  size_bytes -= 64;
+
+  __m128i constants = _mm_load_si128(reinterpret_cast<const __m128i*>(kK1K2));
+  while (size_bytes >= 64) {
+    x1 = Fold128(x1, constants, Load128(data));
+    x2 = Fold128(x2, constants, Load128(data + 16));
+    x3 = Fold128(x3, constants, Load128(data + 32));
+    x4 = Fold128(x4, constants, Load128(data + 48));
+    data += 64;
+    size_bytes -= 64;
+  }
+
+  // Fold the four blocks into one, then fold in any remaining blocks.
+  constants = _mm_load_si128(reinterpret_cast<const __m128i*>(kK3K4));
+  x1 = Fold128(x1, constants, x2);
+  x1 = Fold128(x1, constants, x3);
+  x1 = Fold128(x1, constants, x4);
+
+  while (size_bytes >= 16) {
+    x1 = Fold128(x1, constants, Load128(data));
+    data += 16;
+    size_bytes -= 16;
+  }
+
+  // Fold 128 bits to 64 bits.
+  const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2 = _mm_clmulepi64_si128(x1, constants, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+  constants = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(kK5K0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), constants, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits.
+  constants = _mm_load_si128(reinterpret_cast<const __m128i*>(kPoly));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), constants, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), constants, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+bool CpuSupportsPclmul() {
+  static const bool supported = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+  }();
+  return supported;
+}
+
+#endif  // PW_CHECKSUM_CRC32_X86_PCLMUL
+
 }  // namespace
 
+namespace internal {
+
+constexpr std::array<std::array<uint32_t, 256>, 8> kCrc32SlicingTables =
+    GenerateCrc32SlicingTables<kCrc32Polynomial>();
+
+}  // namespace internal
+
 extern "C" uint32_t _pw_checksum_InternalCrc32EightBit(const void* data,
                                                        size_t size_bytes,
                                                        uint32_t state) {
@@ -95,4 +233,51 @@ extern "C" uint32_t _pw_checksum_InternalCrc32OneBit(const void* data,
   return state;
 }
 
+extern "C" uint32_t _pw_checksum_InternalCrc32SlicingBy8(const void* data,
+                                                         size_t size_bytes,
+                                                         uint32_t state) {
+  const uint8_t* data_bytes = static_cast<const uint8_t*>(data);
+
+  for (; size_bytes >= 8; size_bytes -= 8, data_bytes += 8) {
+    state = internal::Crc32SlicingBy8Update(state,
+                                            LoadLittleEndian32(data_bytes),
+                                            LoadLittleEndian32(data_bytes + 4));
+  }
+
+  for (size_t i = 0; i < size_bytes; ++i) {
+    state = internal::Crc32SlicingBy8Update(state, data_bytes[i]);
+  }
+
+  return state;
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32Hardware(const void* data,
+                                                       size_t size_bytes,
+                                                       uint32_t state) {
+#if PW_CHECKSUM_CRC32_ARM_INSTRUCTIONS
+  const uint8_t* data_bytes = static_cast<const uint8_t*>(data);
+
+  for (; size_bytes >= 8; size_bytes -= 8, data_bytes += 8) {
+    uint64_t word;
+    std::memcpy(&word, data_bytes, sizeof(word));
+    state = __crc32d(state, word);
+  }
+  for (; size_bytes > 0; --size_bytes, ++data_bytes) {
+    state = __crc32b(state, *data_bytes);
+  }
+  return state;
+#else
+#if PW_CHECKSUM_CRC32_X86_PCLMUL
+  // Short inputs are not worth the setup and final reduction.
+  if (size_bytes >= 64 && CpuSupportsPclmul()) {
+    const size_t folded_bytes = size_bytes & ~size_t{15};
+    state = Crc32Pclmul(static_cast<const uint8_t*>(data), folded_bytes, state);
+    data = static_cast<const uint8_t*>(data) + folded_bytes;
+    size_bytes -= folded_bytes;
+  }
+#endif  // PW_CHECKSUM_CRC32_X86_PCLMUL
+  return _pw_checksum_InternalCrc32SlicingBy8(data, size_bytes, state);
+#endif  // PW_CHECKSUM_CRC32_ARM_INSTRUCTIONS
+}
+
 }  // namespace pw::checksum
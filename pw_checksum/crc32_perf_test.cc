@@ -46,13 +46,31 @@ void Crc32EightBitTest(perf_test::State& state, span<const std::byte> data) {
   }
 }
 
+void Crc32SlicingBy8Test(perf_test::State& state, span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc32SlicingBy8::Calculate(data);
+  }
+}
+
+void Crc32HardwareTest(perf_test::State& state, span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc32Hardware::Calculate(data);
+  }
+}
+
 PW_PERF_TEST(CrcOneBitStringTest, Crc32OneBitTest, as_bytes(span(kString)));
 PW_PERF_TEST(CrcFourBitStringTest, Crc32FourBitTest, as_bytes(span(kString)));
 PW_PERF_TEST(CrcEightBitStringTest, Crc32EightBitTest, as_bytes(span(kString)));
+PW_PERF_TEST(CrcSlicingBy8StringTest,
+             Crc32SlicingBy8Test,
+             as_bytes(span(kString)));
+PW_PERF_TEST(CrcHardwareStringTest, Crc32HardwareTest, as_bytes(span(kString)));
 
 PW_PERF_TEST(CrcOneBitBytesTest, Crc32OneBitTest, kBytes);
 PW_PERF_TEST(CrcFourBitBytesTest, Crc32FourBitTest, kBytes);
 PW_PERF_TEST(CrcEightBitBytesTest, Crc32EightBitTest, kBytes);
+PW_PERF_TEST(CrcSlicingBy8BytesTest, Crc32SlicingBy8Test, kBytes);
+PW_PERF_TEST(CrcHardwareBytesTest, Crc32HardwareTest, kBytes);
 
 }  // namespace
 }  // namespace pw::checksum
@@ -13,6 +13,7 @@
 // the License.
 #include "pw_checksum/crc32.h"
 
+#include <array>
 #include <string_view>
 
 #include "gtest/gtest.h"
@@ -46,6 +47,10 @@ TEST(Crc32, Empty) {
   EXPECT_EQ(Crc32FourBit::Calculate(span<std::byte>()),
             PW_CHECKSUM_EMPTY_CRC32);
   EXPECT_EQ(Crc32OneBit::Calculate(span<std::byte>()), PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32SlicingBy8::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32Hardware::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
 }
 
 TEST(Crc32, Buffer) {
@@ -53,6 +58,8 @@ TEST(Crc32, Buffer) {
   EXPECT_EQ(Crc32EightBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
   EXPECT_EQ(Crc32FourBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
   EXPECT_EQ(Crc32OneBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32SlicingBy8::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32Hardware::Calculate(as_bytes(span(kBytes))), kBufferCrc);
 }
 
 TEST(Crc32, String) {
@@ -60,6 +67,8 @@ TEST(Crc32, String) {
   EXPECT_EQ(Crc32EightBit::Calculate(as_bytes(span(kString))), kStringCrc);
   EXPECT_EQ(Crc32FourBit::Calculate(as_bytes(span(kString))), kStringCrc);
   EXPECT_EQ(Crc32OneBit::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32SlicingBy8::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32Hardware::Calculate(as_bytes(span(kString))), kStringCrc);
 }
 
 template <typename CrcVariant>
@@ -76,6 +85,8 @@ TEST(Crc32Class, ByteByByte) {
   TestByByte<Crc32EightBit>();
   TestByByte<Crc32FourBit>();
   TestByByte<Crc32OneBit>();
+  TestByByte<Crc32SlicingBy8>();
+  TestByByte<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -90,6 +101,8 @@ TEST(Crc32Class, Buffer) {
   TestBuffer<Crc32EightBit>();
   TestBuffer<Crc32FourBit>();
   TestBuffer<Crc32OneBit>();
+  TestBuffer<Crc32SlicingBy8>();
+  TestBuffer<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -105,6 +118,8 @@ TEST(Crc32Class, BufferAppend) {
   TestBufferAppend<Crc32EightBit>();
   TestBufferAppend<Crc32FourBit>();
   TestBufferAppend<Crc32OneBit>();
+  TestBufferAppend<Crc32SlicingBy8>();
+  TestBufferAppend<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -119,6 +134,34 @@ TEST(Crc32Class, String) {
   TestString<Crc32EightBit>();
   TestString<Crc32FourBit>();
   TestString<Crc32OneBit>();
+  TestString<Crc32SlicingBy8>();
+  TestString<Crc32Hardware>();
+}
+
+template <typename CrcVariant>
+void TestMatchesEightBit() {
+  // Use enough data to reach the wide loops of the faster implementations, and
+  // check every offset and tail length around their block sizes.
+  std::array<std::byte, 300> data;
+  uint32_t seed = 1;
+  for (std::byte& b : data) {
+    seed = seed * 1664525u + 1013904223u;
+    b = static_cast<std::byte>(seed >> 24);
+  }
+
+  for (size_t offset = 0; offset < 16; ++offset) {
+    for (size_t size = 0; size + offset <= data.size(); size += 7) {
+      span<const std::byte> chunk = span(data).subspan(offset, size);
+      EXPECT_EQ(CrcVariant::Calculate(chunk), Crc32EightBit::Calculate(chunk));
+    }
+  }
+}
+
+TEST(Crc32Class, MatchesEightBit) {
+  TestMatchesEightBit<Crc32>();
+  TestMatchesEightBit<Crc32FourBit>();
+  TestMatchesEightBit<Crc32SlicingBy8>();
+  TestMatchesEightBit<Crc32Hardware>();
 }
 
 extern "C" uint32_t CallChecksumCrc32(const void* data, size_t size_bytes);
@@ -23,15 +23,50 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "pw_checksum/internal/config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
-// C API for calculating the CRC-16-CCITT of an array of data.
+// C API for calculating the CRC-16-CCITT of an array of data. Uses the
+// implementation selected by PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL.
 uint16_t pw_checksum_Crc16Ccitt(const void* data,
                                 size_t size_bytes,
                                 uint16_t initial_value);
 
+// Internal implementations of the CRC-16-CCITT. Use the Crc16Ccitt classes
+// instead of calling these directly.
+uint16_t _pw_checksum_InternalCrc16CcittEightBit(const void* data,
+                                                 size_t size_bytes,
+                                                 uint16_t value);
+uint16_t _pw_checksum_InternalCrc16CcittSlicingBy4(const void* data,
+                                                   size_t size_bytes,
+                                                   uint16_t value);
+uint16_t _pw_checksum_InternalCrc16CcittSlicingBy8(const void* data,
+                                                   size_t size_bytes,
+                                                   uint16_t value);
+
+// Uses a CRC peripheral. pw_checksum does not define this function; link a
+// backend such as pw_checksum:crc16_ccitt_stm32cube to use it.
+uint16_t _pw_checksum_InternalCrc16CcittHardware(const void* data,
+                                                 size_t size_bytes,
+                                                 uint16_t value);
+
+#if PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL == PW_CHECKSUM_CRC16_CCITT_8BITS
+#define _pw_checksum_InternalCrc16Ccitt _pw_checksum_InternalCrc16CcittEightBit
+#elif PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL == \
+    PW_CHECKSUM_CRC16_CCITT_SLICING_BY_4
+#define _pw_checksum_InternalCrc16Ccitt \
+  _pw_checksum_InternalCrc16CcittSlicingBy4
+#elif PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL == \
+    PW_CHECKSUM_CRC16_CCITT_SLICING_BY_8
+#define _pw_checksum_InternalCrc16Ccitt \
+  _pw_checksum_InternalCrc16CcittSlicingBy8
+#elif PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL == PW_CHECKSUM_CRC16_CCITT_HARDWARE
+#define _pw_checksum_InternalCrc16Ccitt _pw_checksum_InternalCrc16CcittHardware
+#endif
+
 #ifdef __cplusplus
 }  // extern "C"
 
@@ -40,8 +75,10 @@ uint16_t pw_checksum_Crc16Ccitt(const void* data,
 
 namespace pw::checksum {
 
-// Calculates the CRC-16-CCITT for all data passed to Update.
-class Crc16Ccitt {
+// Calculates the CRC-16-CCITT for all data passed to Update, with the given
+// implementation.
+template <uint16_t (*kCrc16Function)(const void*, size_t, uint16_t)>
+class Crc16CcittImpl {
  public:
   static constexpr uint16_t kInitialValue = 0xFFFF;
 
@@ -50,8 +87,7 @@ class Crc16Ccitt {
   // Crc16Ccitt class or pass the previous value as the initial_value argument.
   static uint16_t Calculate(span<const std::byte> data,
                             uint16_t initial_value = kInitialValue) {
-    return pw_checksum_Crc16Ccitt(
-        data.data(), data.size_bytes(), initial_value);
+    return kCrc16Function(data.data(), data.size_bytes(), initial_value);
   }
 
   static uint16_t Calculate(std::byte data,
@@ -59,7 +95,7 @@ class Crc16Ccitt {
     return Calculate(ConstByteSpan(&data, 1), initial_value);
   }
 
-  constexpr Crc16Ccitt() : value_(kInitialValue) {}
+  constexpr Crc16CcittImpl() : value_(kInitialValue) {}
 
   void Update(span<const std::byte> data) { value_ = Calculate(data, value_); }
 
@@ -75,6 +111,16 @@ class Crc16Ccitt {
   uint16_t value_;
 };
 
+using Crc16Ccitt = Crc16CcittImpl<_pw_checksum_InternalCrc16Ccitt>;
+using Crc16CcittEightBit =
+    Crc16CcittImpl<_pw_checksum_InternalCrc16CcittEightBit>;
+using Crc16CcittSlicingBy4 =
+    Crc16CcittImpl<_pw_checksum_InternalCrc16CcittSlicingBy4>;
+using Crc16CcittSlicingBy8 =
+    Crc16CcittImpl<_pw_checksum_InternalCrc16CcittSlicingBy8>;
+using Crc16CcittHardware =
+    Crc16CcittImpl<_pw_checksum_InternalCrc16CcittHardware>;
+
 }  // namespace pw::checksum
 
 #endif  // __cplusplus
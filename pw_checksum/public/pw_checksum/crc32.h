@@ -45,6 +45,15 @@ uint32_t _pw_checksum_InternalCrc32FourBit(const void* data,
 uint32_t _pw_checksum_InternalCrc32OneBit(const void* data,
                                           size_t size_bytes,
                                           uint32_t state);
+uint32_t _pw_checksum_InternalCrc32SlicingBy8(const void* data,
+                                              size_t size_bytes,
+                                              uint32_t state);
+
+// Uses the CPU's CRC32 instructions when available, and otherwise falls back
+// to slicing-by-8.
+uint32_t _pw_checksum_InternalCrc32Hardware(const void* data,
+                                            size_t size_bytes,
+                                            uint32_t state);
 
 #if PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_8BITS
 #define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32EightBit
@@ -52,6 +61,10 @@ uint32_t _pw_checksum_InternalCrc32OneBit(const void* data,
 #define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32FourBit
 #elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS
 #define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32OneBit
+#elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICING_BY_8
+#define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32SlicingBy8
+#elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_HARDWARE
+#define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32Hardware
 #endif
 
 // Calculates the CRC32 for the provided data.
@@ -116,6 +129,8 @@ using Crc32 = Crc32Impl<_pw_checksum_InternalCrc32>;
 using Crc32EightBit = Crc32Impl<_pw_checksum_InternalCrc32EightBit>;
 using Crc32FourBit = Crc32Impl<_pw_checksum_InternalCrc32FourBit>;
 using Crc32OneBit = Crc32Impl<_pw_checksum_InternalCrc32OneBit>;
+using Crc32SlicingBy8 = Crc32Impl<_pw_checksum_InternalCrc32SlicingBy8>;
+using Crc32Hardware = Crc32Impl<_pw_checksum_InternalCrc32Hardware>;
 
 }  // namespace pw::checksum
 
@@ -17,6 +17,8 @@
 #define PW_CHECKSUM_CRC32_8BITS 8
 #define PW_CHECKSUM_CRC32_4BITS 4
 #define PW_CHECKSUM_CRC32_1BITS 1
+#define PW_CHECKSUM_CRC32_SLICING_BY_8 64
+#define PW_CHECKSUM_CRC32_HARDWARE 65
 
 #ifndef PW_CHECKSUM_CRC32_DEFAULT_IMPL
 #define PW_CHECKSUM_CRC32_DEFAULT_IMPL PW_CHECKSUM_CRC32_8BITS
@@ -25,5 +27,28 @@
 #ifdef __cplusplus
 static_assert(PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_8BITS ||
               PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_4BITS ||
-              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS);
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC32_SLICING_BY_8 ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_HARDWARE);
+#endif  // __cplusplus
+
+#define PW_CHECKSUM_CRC16_CCITT_8BITS 8
+#define PW_CHECKSUM_CRC16_CCITT_SLICING_BY_4 32
+#define PW_CHECKSUM_CRC16_CCITT_SLICING_BY_8 64
+#define PW_CHECKSUM_CRC16_CCITT_HARDWARE 65
+
+#ifndef PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL
+#define PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL PW_CHECKSUM_CRC16_CCITT_8BITS
+#endif  // PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL
+
+#ifdef __cplusplus
+static_assert(PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC16_CCITT_8BITS ||
+              PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC16_CCITT_SLICING_BY_4 ||
+              PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC16_CCITT_SLICING_BY_8 ||
+              PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC16_CCITT_HARDWARE);
 #endif  // __cplusplus
@@ -0,0 +1,48 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pw::checksum::internal {
+
+// Tables for the slicing-by-8 CRC32. Table k holds the CRC of each byte value
+// followed by k zero bytes. Defined in crc32.cc.
+//
+// These are exposed so that code that already reads each byte of its data,
+// such as an encoder scanning for bytes to escape, can update a CRC32 in the
+// same pass. Otherwise, use the Crc32 classes.
+extern const std::array<std::array<uint32_t, 256>, 8> kCrc32SlicingTables;
+
+// Updates a CRC32 state (not a finalized CRC32 value) with eight bytes of
+// data, given as two words loaded in little-endian order.
+inline uint32_t Crc32SlicingBy8Update(uint32_t state,
+                                      uint32_t low,
+                                      uint32_t high) {
+  const auto& t = kCrc32SlicingTables;
+  low ^= state;
+  return t[7][low & 0xFFu] ^ t[6][(low >> 8) & 0xFFu] ^
+         t[5][(low >> 16) & 0xFFu] ^ t[4][low >> 24] ^ t[3][high & 0xFFu] ^
+         t[2][(high >> 8) & 0xFFu] ^ t[1][(high >> 16) & 0xFFu] ^
+         t[0][high >> 24];
+}
+
+// Updates a CRC32 state with a single byte.
+inline uint32_t Crc32SlicingBy8Update(uint32_t state, uint8_t byte) {
+  return kCrc32SlicingTables[0][(state ^ byte) & 0xFFu] ^ (state >> 8);
+}
+
+}  // namespace pw::checksum::internal
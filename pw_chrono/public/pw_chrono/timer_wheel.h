@@ -0,0 +1,203 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_function/function.h"
+#include "pw_span/span.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::chrono {
+
+// A hierarchical timing wheel, which drives any number of software timers from
+// a single hardware timer, such as one compare channel of a free running
+// counter.
+//
+// Scheduling and cancelling a timer take constant time, regardless of how many
+// timers are scheduled. Each level of the wheel has 64 slots, and each slot of
+// a level spans 64 times as many ticks as a slot of the level below it. Timers
+// are placed in the level that matches how far away their deadline is, and move
+// down a level each time the wheel reaches their slot. A wheel with N levels
+// schedules deadlines up to 64^N ticks ahead directly. Timers further out are
+// kept in an overflow list, which is only scanned once every 64^N ticks.
+//
+// The wheel does not read a clock or program hardware itself. The driver of the
+// hardware timer calls Advance() from its interrupt or thread, and programs the
+// next compare from NextExpiration(). When a newly scheduled timer expires
+// before the programmed compare, the wheel calls the wakeup callback. For
+// example:
+//
+//   pw::chrono::TimerWheelBuffer<4> timer_wheel(
+//       pw::chrono::SystemClock::now(),
+//       [](pw::chrono::SystemClock::time_point next) { SetCompare(next); });
+//
+//   void TimerCompareIsr() {
+//     timer_wheel.Advance(pw::chrono::SystemClock::now());
+//     if (auto next = timer_wheel.NextExpiration(); next.has_value()) {
+//       SetCompare(*next);
+//     }
+//   }
+//
+// This code is thread & IRQ safe. Advance() must only be called from one
+// context at a time.
+class TimerWheel {
+ public:
+  static constexpr size_t kSlotsPerLevel = 64;
+
+  // A one-shot software timer that is scheduled on a TimerWheel. Its API
+  // mirrors pw::chrono::SystemTimer.
+  class Timer {
+   public:
+    // Invoked by TimerWheel::Advance() once the deadline passes.
+    //
+    // The callback is invoked without the wheel's lock held, so it may
+    // reschedule its own timer, for example to implement a periodic timer.
+    using ExpiryCallback =
+        Function<void(SystemClock::time_point expired_deadline)>;
+
+    explicit Timer(ExpiryCallback&& callback)
+        : callback_(std::move(callback)) {}
+
+    // Cancels the timer, if scheduled. The callback must not be in progress.
+    ~Timer();
+
+    Timer(const Timer&) = delete;
+    Timer(Timer&&) = delete;
+    Timer& operator=(const Timer&) = delete;
+    Timer& operator=(Timer&&) = delete;
+
+   private:
+    friend class TimerWheel;
+
+    ExpiryCallback callback_;
+
+    // The following are guarded by the lock of the wheel the timer is
+    // scheduled on.
+    TimerWheel* wheel_ = nullptr;  // Set while the timer is scheduled.
+    Timer* next_ = nullptr;
+    Timer** prev_next_ = nullptr;  // Points at the pointer to this timer.
+    int64_t deadline_ = 0;
+    uint16_t list_ = 0;
+  };
+
+  // The slots of one level of the wheel.
+  struct Level {
+    uint64_t occupied = 0;  // Bit i is set if slots[i] is not empty.
+    std::array<Timer*, kSlotsPerLevel> slots{};
+  };
+
+  // Invoked when a timer is scheduled to expire before the previous
+  // NextExpiration(), with the new NextExpiration(). The wheel's lock is held,
+  // so the callback must not use the wheel.
+  using WakeupCallback = Function<void(SystemClock::time_point next)>;
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Schedules the timer to expire at the deadline, cancelling its previous
+  // deadline if it is scheduled. Deadlines that are not after the wheel's
+  // current time expire on the next call to Advance().
+  //
+  // Precondition: The timer is not scheduled on another wheel.
+  void InvokeAt(Timer& timer, SystemClock::time_point deadline)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Schedules the timer to expire after the delay from SystemClock::now().
+  void InvokeAfter(Timer& timer, SystemClock::duration delay)
+      PW_LOCKS_EXCLUDED(lock_) {
+    InvokeAt(timer, SystemClock::now() + delay);
+  }
+
+  // Cancels the timer if it is scheduled on this wheel. A callback that is in
+  // progress runs to completion.
+  void Cancel(Timer& timer) PW_LOCKS_EXCLUDED(lock_);
+
+  // Advances the wheel's current time to now, invoking the callbacks of the
+  // timers that expired. The wheel advances tick by tick, so a timer is not
+  // invoked before timers with earlier deadlines, unless it was scheduled
+  // after its deadline passed. Time never goes backwards, so an earlier now
+  // does not change the wheel's current time.
+  void Advance(SystemClock::time_point now) PW_LOCKS_EXCLUDED(lock_);
+
+  // Returns when Advance() needs to be called next, or std::nullopt if no
+  // timers are scheduled. This takes time proportional to the number of
+  // levels, not to the number of timers, so it is cheap enough to call before
+  // entering a tickless idle state.
+  //
+  // The result is never later than the earliest deadline. It may be earlier,
+  // when timers have to move down a level of the wheel, in which case Advance()
+  // invokes no callbacks and NextExpiration() returns a later time.
+  std::optional<SystemClock::time_point> NextExpiration()
+      PW_LOCKS_EXCLUDED(lock_);
+
+ protected:
+  // Constructs a wheel with one level per element of levels, whose current time
+  // is start.
+  TimerWheel(span<Level> levels,
+             SystemClock::time_point start,
+             WakeupCallback&& wakeup);
+
+ private:
+  static constexpr uint16_t kDueList = UINT16_MAX;
+  static constexpr uint16_t kOverflowList = UINT16_MAX - 1;
+
+  // Adds the timer to the list matching its deadline.
+  void Insert(Timer& timer) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Moves the timers in the slots that start at the current time to their
+  // lists for the current time.
+  void Expire() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Moves all timers in a list to their lists for the current time.
+  void Reinsert(Timer*& list) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  void Link(Timer& timer, uint16_t list) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void Unlink(Timer& timer) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  Timer*& ListHead(uint16_t list) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Returns the tick at which the wheel has to process slots or expire timers
+  // next.
+  std::optional<int64_t> NextEventTick() const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  sync::InterruptSpinLock lock_;
+  const span<Level> levels_ PW_GUARDED_BY(lock_);
+  int64_t now_ PW_GUARDED_BY(lock_);
+  Timer* due_ PW_GUARDED_BY(lock_) = nullptr;
+  Timer* overflow_ PW_GUARDED_BY(lock_) = nullptr;
+  WakeupCallback wakeup_;
+};
+
+// A TimerWheel with kLevels levels. Each level takes 64 pointers and 8 bytes.
+template <size_t kLevels>
+class TimerWheelBuffer : public TimerWheel {
+ public:
+  static_assert(kLevels > 0u && kLevels <= 10u,
+                "The deadlines of all levels must fit in 63 bits");
+
+  explicit TimerWheelBuffer(SystemClock::time_point start,
+                            WakeupCallback&& wakeup = nullptr)
+      : TimerWheel(levels_, start, std::move(wakeup)) {}
+
+ private:
+  std::array<Level, kLevels> levels_{};
+};
+
+}  // namespace pw::chrono
@@ -0,0 +1,240 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/timer_wheel.h"
+
+#include <mutex>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_assert/check.h"
+
+namespace pw::chrono {
+namespace {
+
+constexpr uint32_t kSlotBits = 6;
+constexpr uint64_t kSlotMask = TimerWheel::kSlotsPerLevel - 1;
+
+static_assert(TimerWheel::kSlotsPerLevel == uint64_t{1} << kSlotBits);
+
+int64_t Ticks(SystemClock::time_point time) {
+  return time.time_since_epoch().count();
+}
+
+SystemClock::time_point TimePoint(int64_t ticks) {
+  return SystemClock::time_point(SystemClock::duration(ticks));
+}
+
+// Returns the number of bits of a tick that the levels of a wheel cover.
+uint32_t WheelBits(size_t levels) {
+  return static_cast<uint32_t>(levels) * kSlotBits;
+}
+
+// Returns the first tick of the aligned block of 2^bits ticks holding tick.
+int64_t BlockStart(int64_t tick, uint32_t bits) {
+  return static_cast<int64_t>((static_cast<uint64_t>(tick) >> bits) << bits);
+}
+
+}  // namespace
+
+TimerWheel::Timer::~Timer() {
+  if (wheel_ != nullptr) {
+    wheel_->Cancel(*this);
+  }
+}
+
+TimerWheel::TimerWheel(span<Level> levels,
+                       SystemClock::time_point start,
+                       WakeupCallback&& wakeup)
+    : levels_(levels), now_(Ticks(start)), wakeup_(std::move(wakeup)) {
+  PW_CHECK(!levels.empty() && levels.size() * kSlotBits < 64);
+}
+
+void TimerWheel::InvokeAt(Timer& timer, SystemClock::time_point deadline) {
+  std::lock_guard lock(lock_);
+  if (timer.wheel_ != nullptr) {
+    PW_DCHECK_PTR_EQ(timer.wheel_, this);
+    Unlink(timer);
+  }
+  const std::optional<int64_t> previous = NextEventTick();
+  timer.wheel_ = this;
+  timer.deadline_ = Ticks(deadline);
+  Insert(timer);
+
+  const int64_t next = NextEventTick().value();
+  if (wakeup_ != nullptr && (!previous.has_value() || next < *previous)) {
+    wakeup_(TimePoint(next));
+  }
+}
+
+void TimerWheel::Cancel(Timer& timer) {
+  std::lock_guard lock(lock_);
+  if (timer.wheel_ == this) {
+    Unlink(timer);
+    timer.wheel_ = nullptr;
+  }
+}
+
+void TimerWheel::Advance(SystemClock::time_point now) {
+  const int64_t target = Ticks(now);
+  while (true) {
+    Timer* timer;
+    int64_t deadline;
+    {
+      std::lock_guard lock(lock_);
+      while (due_ == nullptr) {
+        const std::optional<int64_t> next = NextEventTick();
+        if (!next.has_value() || *next > target) {
+          now_ = std::max(now_, target);
+          return;
+        }
+        now_ = *next;
+        Expire();
+      }
+      timer = due_;
+      Unlink(*timer);
+      timer->wheel_ = nullptr;
+      deadline = timer->deadline_;
+    }
+    // Invoke the callback without the lock, so it can reschedule the timer.
+    timer->callback_(TimePoint(deadline));
+  }
+}
+
+std::optional<SystemClock::time_point> TimerWheel::NextExpiration() {
+  std::lock_guard lock(lock_);
+  const std::optional<int64_t> next = NextEventTick();
+  if (!next.has_value()) {
+    return std::nullopt;
+  }
+  return TimePoint(*next);
+}
+
+void TimerWheel::Insert(Timer& timer) {
+  if (timer.deadline_ <= now_) {
+    Link(timer, kDueList);
+    return;
+  }
+
+  // Place the timer in the level of the most significant slot digit in which
+  // its deadline differs from the current time. The wheel reaches the slot
+  // before the digits above it change.
+  const uint64_t diff = static_cast<uint64_t>(timer.deadline_) ^
+                        static_cast<uint64_t>(now_);
+  const uint32_t level =
+      static_cast<uint32_t>(63 - cpp20::countl_zero(diff)) / kSlotBits;
+  if (level >= levels_.size()) {
+    Link(timer, kOverflowList);
+    return;
+  }
+  const uint64_t slot =
+      (static_cast<uint64_t>(timer.deadline_) >> (level * kSlotBits)) &
+      kSlotMask;
+  Link(timer, static_cast<uint16_t>(level * kSlotsPerLevel + slot));
+}
+
+void TimerWheel::Expire() {
+  const uint64_t now = static_cast<uint64_t>(now_);
+  const uint32_t wheel_bits = WheelBits(levels_.size());
+  if ((now & ((uint64_t{1} << wheel_bits) - 1)) == 0u) {
+    Reinsert(overflow_);
+  }
+
+  // Every occupied slot of a level comes after the current slot of that level,
+  // so the slots to process start exactly at the current time.
+  for (size_t level = levels_.size(); level-- > 0;) {
+    const uint32_t shift = static_cast<uint32_t>(level) * kSlotBits;
+    if ((now & ((uint64_t{1} << shift) - 1)) != 0u) {
+      continue;
+    }
+    const uint64_t slot = (now >> shift) & kSlotMask;
+    if ((levels_[level].occupied & (uint64_t{1} << slot)) != 0u) {
+      levels_[level].occupied &= ~(uint64_t{1} << slot);
+      Reinsert(levels_[level].slots[slot]);
+    }
+  }
+}
+
+void TimerWheel::Reinsert(Timer*& list) {
+  Timer* timer = list;
+  list = nullptr;
+  while (timer != nullptr) {
+    Timer* next = timer->next_;
+    Insert(*timer);
+    timer = next;
+  }
+}
+
+void TimerWheel::Link(Timer& timer, uint16_t list) {
+  Timer*& head = ListHead(list);
+  timer.next_ = head;
+  if (head != nullptr) {
+    head->prev_next_ = &timer.next_;
+  }
+  head = &timer;
+  timer.prev_next_ = &head;
+  timer.list_ = list;
+  if (list < levels_.size() * kSlotsPerLevel) {
+    levels_[list / kSlotsPerLevel].occupied |= uint64_t{1}
+                                               << (list % kSlotsPerLevel);
+  }
+}
+
+void TimerWheel::Unlink(Timer& timer) {
+  *timer.prev_next_ = timer.next_;
+  if (timer.next_ != nullptr) {
+    timer.next_->prev_next_ = timer.prev_next_;
+  }
+  const uint16_t list = timer.list_;
+  if (list < levels_.size() * kSlotsPerLevel && ListHead(list) == nullptr) {
+    levels_[list / kSlotsPerLevel].occupied &=
+        ~(uint64_t{1} << (list % kSlotsPerLevel));
+  }
+}
+
+TimerWheel::Timer*& TimerWheel::ListHead(uint16_t list) {
+  if (list == kDueList) {
+    return due_;
+  }
+  if (list == kOverflowList) {
+    return overflow_;
+  }
+  return levels_[list / kSlotsPerLevel].slots[list % kSlotsPerLevel];
+}
+
+std::optional<int64_t> TimerWheel::NextEventTick() const {
+  if (due_ != nullptr) {
+    return now_;
+  }
+
+  // The occupied slots of a level all start after the slots of the levels
+  // below it, so the first occupied level holds the next event.
+  for (size_t level = 0; level < levels_.size(); ++level) {
+    const uint64_t occupied = levels_[level].occupied;
+    if (occupied == 0u) {
+      continue;
+    }
+    const uint32_t shift = static_cast<uint32_t>(level) * kSlotBits;
+    const int64_t slot = cpp20::countr_zero(occupied);
+    return BlockStart(now_, shift + kSlotBits) + (slot << shift);
+  }
+
+  // Overflowed timers are reinserted when the top level wraps around.
+  if (overflow_ != nullptr) {
+    const uint32_t wheel_bits = WheelBits(levels_.size());
+    return BlockStart(now_, wheel_bits) + (int64_t{1} << wheel_bits);
+  }
+  return std::nullopt;
+}
+
+}  // namespace pw::chrono
@@ -0,0 +1,264 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/timer_wheel.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
+
+namespace pw::chrono {
+namespace {
+
+SystemClock::time_point Tick(int64_t ticks) {
+  return SystemClock::time_point(SystemClock::duration(ticks));
+}
+
+// Records the deadlines a timer expired at.
+class RecordingTimer {
+ public:
+  RecordingTimer()
+      : timer([this](SystemClock::time_point expired_deadline) {
+          expirations += 1;
+          last_deadline = expired_deadline;
+        }) {}
+
+  TimerWheel::Timer timer;
+  int expirations = 0;
+  std::optional<SystemClock::time_point> last_deadline;
+};
+
+TEST(TimerWheel, ExpiresAtDeadline) {
+  TimerWheelBuffer<4> wheel(Tick(0));
+  RecordingTimer timer;
+  wheel.InvokeAt(timer.timer, Tick(10));
+
+  wheel.Advance(Tick(9));
+  EXPECT_EQ(timer.expirations, 0);
+  wheel.Advance(Tick(12));
+  EXPECT_EQ(timer.expirations, 1);
+  EXPECT_EQ(timer.last_deadline, Tick(10));
+
+  wheel.Advance(Tick(100));
+  EXPECT_EQ(timer.expirations, 1);
+  EXPECT_EQ(wheel.NextExpiration(), std::nullopt);
+}
+
+TEST(TimerWheel, DeadlinesOnHigherLevels) {
+  TimerWheelBuffer<4> wheel(Tick(5));
+  std::array<RecordingTimer, 3> timers;
+  constexpr std::array<int64_t, 3> kDeadlines = {70, 5000, 300000};
+  for (size_t i = 0; i < timers.size(); ++i) {
+    wheel.InvokeAt(timers[i].timer, Tick(kDeadlines[i]));
+  }
+
+  for (size_t i = 0; i < timers.size(); ++i) {
+    wheel.Advance(Tick(kDeadlines[i] - 1));
+    EXPECT_EQ(timers[i].expirations, 0);
+    wheel.Advance(Tick(kDeadlines[i]));
+    EXPECT_EQ(timers[i].expirations, 1);
+    EXPECT_EQ(timers[i].last_deadline, Tick(kDeadlines[i]));
+  }
+}
+
+TEST(TimerWheel, NextExpiration) {
+  TimerWheelBuffer<4> wheel(Tick(0));
+  EXPECT_EQ(wheel.NextExpiration(), std::nullopt);
+
+  RecordingTimer timer;
+  wheel.InvokeAt(timer.timer, Tick(10));
+  EXPECT_EQ(wheel.NextExpiration(), Tick(10));
+
+  // A deadline on a higher level reports the start of its slot, which is
+  // refined once the timer moves down.
+  wheel.InvokeAt(timer.timer, Tick(1000));
+  EXPECT_EQ(wheel.NextExpiration(), Tick(960));
+  wheel.Advance(Tick(960));
+  EXPECT_EQ(timer.expirations, 0);
+  EXPECT_EQ(wheel.NextExpiration(), Tick(1000));
+}
+
+TEST(TimerWheel, AdvancingToNextExpiration) {
+  TimerWheelBuffer<4> wheel(Tick(0));
+  std::array<RecordingTimer, 8> timers;
+  int64_t deadline = 3;
+  for (RecordingTimer& timer : timers) {
+    wheel.InvokeAt(timer.timer, Tick(deadline));
+    deadline = deadline * 7 + 1;
+  }
+
+  int wakeups = 0;
+  while (std::optional<SystemClock::time_point> next = wheel.NextExpiration()) {
+    wheel.Advance(*next);
+    wakeups += 1;
+  }
+  for (RecordingTimer& timer : timers) {
+    EXPECT_EQ(timer.expirations, 1);
+  }
+  // Each timer takes at most one wakeup per level.
+  EXPECT_LE(wakeups, static_cast<int>(timers.size() * 4));
+}
+
+TEST(TimerWheel, Cancel) {
+  TimerWheelBuffer<4> wheel(Tick(0));
+  RecordingTimer timer;
+  wheel.InvokeAt(timer.timer, Tick(100));
+  wheel.Cancel(timer.timer);
+  EXPECT_EQ(wheel.NextExpiration(), std::nullopt);
+
+  wheel.Advance(Tick(200));
+  EXPECT_EQ(timer.expirations, 0);
+
+  // Cancelling an unscheduled timer does nothing.
+  wheel.Cancel(timer.timer);
+}
+
+TEST(TimerWheel, RescheduleReplacesDeadline) {
+  TimerWheelBuffer<4> wheel(Tick(0));
+  RecordingTimer timer;
+  wheel.InvokeAt(timer.timer, Tick(100));
+  wheel.InvokeAt(timer.timer, Tick(20));
+
+  wheel.Advance(Tick(200));
+  EXPECT_EQ(timer.expirations, 1);
+  EXPECT_EQ(timer.last_deadline, Tick(20));
+}
+
+TEST(TimerWheel, PastDeadlineExpiresOnNextAdvance) {
+  TimerWheelBuffer<4> wheel(Tick(50));
+  RecordingTimer timer;
+  wheel.InvokeAt(timer.timer, Tick(40));
+  EXPECT_EQ(wheel.NextExpiration(), Tick(50));
+
+  wheel.Advance(Tick(50));
+  EXPECT_EQ(timer.expirations, 1);
+  EXPECT_EQ(timer.last_deadline, Tick(40));
+}
+
+// Reschedules itself every 10 ticks.
+class PeriodicTimer {
+ public:
+  explicit PeriodicTimer(TimerWheel& wheel)
+      : wheel_(wheel),
+        timer_([this](SystemClock::time_point expired_deadline) {
+          expirations += 1;
+          wheel_.InvokeAt(timer_, expired_deadline + SystemClock::duration(10));
+        }) {
+    wheel_.InvokeAt(timer_, Tick(10));
+  }
+
+  ~PeriodicTimer() { wheel_.Cancel(timer_); }
+
+  int expirations = 0;
+
+ private:
+  TimerWheel& wheel_;
+  TimerWheel::Timer timer_;
+};
+
+TEST(TimerWheel, PeriodicTimer) {
+  TimerWheelBuffer<4> wheel(Tick(0));
+  PeriodicTimer timer(wheel);
+
+  wheel.Advance(Tick(105));
+  EXPECT_EQ(timer.expirations, 10);
+  EXPECT_EQ(wheel.NextExpiration(), Tick(110));
+}
+
+TEST(TimerWheel, DeadlineBeyondLevels) {
+  // Two levels cover 4096 ticks.
+  TimerWheelBuffer<2> wheel(Tick(100));
+  RecordingTimer timer;
+  wheel.InvokeAt(timer.timer, Tick(10000));
+  EXPECT_EQ(wheel.NextExpiration(), Tick(4096));
+
+  wheel.Advance(Tick(9999));
+  EXPECT_EQ(timer.expirations, 0);
+  EXPECT_EQ(wheel.NextExpiration(), Tick(10000));
+  wheel.Advance(Tick(10000));
+  EXPECT_EQ(timer.expirations, 1);
+}
+
+TEST(TimerWheel, WakeupForEarlierDeadline) {
+  std::optional<SystemClock::time_point> wakeup;
+  TimerWheelBuffer<4> wheel(
+      Tick(0), [&](SystemClock::time_point next) { wakeup = next; });
+  std::array<RecordingTimer, 3> timers;
+
+  wheel.InvokeAt(timers[0].timer, Tick(30));
+  EXPECT_EQ(wakeup, Tick(30));
+
+  wakeup.reset();
+  wheel.InvokeAt(timers[1].timer, Tick(40));
+  EXPECT_EQ(wakeup, std::nullopt);
+
+  wheel.InvokeAt(timers[2].timer, Tick(20));
+  EXPECT_EQ(wakeup, Tick(20));
+
+  wheel.Cancel(timers[0].timer);
+  wheel.Cancel(timers[1].timer);
+  wheel.Cancel(timers[2].timer);
+}
+
+TEST(TimerWheel, DestroyingTimerCancelsIt) {
+  TimerWheelBuffer<4> wheel(Tick(0));
+  {
+    RecordingTimer timer;
+    wheel.InvokeAt(timer.timer, Tick(10));
+  }
+  EXPECT_EQ(wheel.NextExpiration(), std::nullopt);
+  wheel.Advance(Tick(20));
+}
+
+TEST(TimerWheel, ManyTimers) {
+  TimerWheelBuffer<3> wheel(Tick(0));
+  std::array<RecordingTimer, 500> timers;
+  std::array<int64_t, 500> deadlines;
+
+  // Spread the deadlines over all levels and the overflow list.
+  uint32_t random = 1;
+  for (size_t i = 0; i < timers.size(); ++i) {
+    random = random * 1103515245u + 12345u;
+    deadlines[i] = static_cast<int64_t>(random % 600000u);
+    wheel.InvokeAt(timers[i].timer, Tick(deadlines[i]));
+  }
+  for (size_t i = 0; i < timers.size(); i += 3) {
+    wheel.Cancel(timers[i].timer);
+  }
+
+  int64_t now = 0;
+  while (now < 600000) {
+    random = random * 1103515245u + 12345u;
+    const int64_t previous = now;
+    now += static_cast<int64_t>(random % 5000u);
+    wheel.Advance(Tick(now));
+    for (size_t i = 0; i < timers.size(); ++i) {
+      const bool cancelled = i % 3 == 0;
+      if (cancelled || deadlines[i] > now) {
+        ASSERT_EQ(timers[i].expirations, 0);
+      } else {
+        ASSERT_EQ(timers[i].expirations, 1);
+        if (deadlines[i] > previous) {
+          ASSERT_EQ(timers[i].last_deadline, Tick(deadlines[i]));
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace pw::chrono
@@ -0,0 +1,75 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono_freertos/high_resolution_clock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+#include "pw_sync/interrupt_spin_lock.h"
+
+namespace pw::chrono::freertos {
+namespace {
+
+sync::InterruptSpinLock high_resolution_clock_interrupt_spin_lock;
+
+// The SystemClock tick whose start was recorded, and the counter at its start.
+int64_t tick_start_tick_count = -1;
+uint32_t tick_start_cycles = 0;
+
+uint32_t ReadCounter() {
+  return PW_CHRONO_FREERTOS_CFG_HIGH_RESOLUTION_COUNTER();
+}
+
+}  // namespace
+
+HighResolutionClock::time_point HighResolutionClock::now() noexcept {
+  std::lock_guard lock(high_resolution_clock_interrupt_spin_lock);
+  const int64_t tick_count = SystemClock::now().time_since_epoch().count();
+  const uint32_t cycles = ReadCounter();
+
+  // The tick hook was not called for this tick, so it started no later than
+  // now.
+  if (tick_count != tick_start_tick_count) {
+    tick_start_tick_count = tick_count;
+    tick_start_cycles = cycles;
+  }
+
+  // Cap the cycles at one tick, in case the tick interrupt is pending or the
+  // counter ran ahead of the tick.
+  const int64_t cycles_in_tick =
+      std::min<int64_t>(static_cast<uint32_t>(cycles - tick_start_cycles),
+                        kCyclesPerTick - 1);
+  return time_point(duration(tick_count * kCyclesPerTick + cycles_in_tick));
+}
+
+void HighResolutionClockTickHook() {
+  std::lock_guard lock(high_resolution_clock_interrupt_spin_lock);
+  tick_start_tick_count = SystemClock::now().time_since_epoch().count();
+  tick_start_cycles = ReadCounter();
+}
+
+void EnableCycleCounter() {
+  volatile uint32_t& demcr = *reinterpret_cast<volatile uint32_t*>(0xE000EDFCu);
+  volatile uint32_t& dwt_ctrl =
+      *reinterpret_cast<volatile uint32_t*>(0xE0001000u);
+  constexpr uint32_t kDemcrTraceEnable = 1u << 24;
+  constexpr uint32_t kDwtCtrlCycleCounterEnable = 1u << 0;
+
+  demcr = demcr | kDemcrTraceEnable;
+  dwt_ctrl = dwt_ctrl | kDwtCtrlCycleCounterEnable;
+}
+
+}  // namespace pw::chrono::freertos
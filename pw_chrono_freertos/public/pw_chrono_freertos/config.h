@@ -29,3 +29,19 @@
 static_assert((PW_CHRONO_FREERTOS_CFG_MAX_TIMEOUT > 0) &&
                   (PW_CHRONO_FREERTOS_CFG_MAX_TIMEOUT <= portMAX_DELAY),
               "Invalid MAX timeout configuration");
+
+// The frequency of the counter that HighResolutionClock interpolates the
+// FreeRTOS tick with. It must be a multiple of configTICK_RATE_HZ. Defaults to
+// the CPU clock, which drives the Cortex-M DWT cycle counter.
+#ifndef PW_CHRONO_FREERTOS_CFG_HIGH_RESOLUTION_CLOCK_HZ
+#define PW_CHRONO_FREERTOS_CFG_HIGH_RESOLUTION_CLOCK_HZ configCPU_CLOCK_HZ
+#endif  // PW_CHRONO_FREERTOS_CFG_HIGH_RESOLUTION_CLOCK_HZ
+
+// Reads the free running, 32 bit, up counting counter that HighResolutionClock
+// interpolates the FreeRTOS tick with. Defaults to the Cortex-M DWT cycle
+// counter (DWT_CYCCNT), which must be enabled with
+// pw::chrono::freertos::EnableCycleCounter().
+#ifndef PW_CHRONO_FREERTOS_CFG_HIGH_RESOLUTION_COUNTER
+#define PW_CHRONO_FREERTOS_CFG_HIGH_RESOLUTION_COUNTER() \
+  (*reinterpret_cast<volatile uint32_t*>(0xE0001004u))
+#endif  // PW_CHRONO_FREERTOS_CFG_HIGH_RESOLUTION_COUNTER
@@ -0,0 +1,87 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+#include "pw_chrono/epoch.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_chrono_freertos/config.h"
+
+namespace pw::chrono::freertos {
+
+// A clock with the resolution of a hardware counter, such as the Cortex-M DWT
+// cycle counter, that stays in step with the FreeRTOS tick based SystemClock.
+//
+// The time is the SystemClock tick count, plus the counter cycles since the
+// tick started. The cycles are capped at one tick, so the clock stays monotonic
+// and follows SystemClock when the counter stops, for example while the core
+// sleeps in tickless idle, and when ticks are stepped after waking up. The
+// counter only has to count up between two ticks, so its wrap around does not
+// matter.
+//
+// The start of each tick is recorded by HighResolutionClockTickHook(), which
+// must be called from the FreeRTOS tick hook for the interpolation to be
+// accurate. Without it, the first read in each tick is taken as its start.
+//
+// The SystemClock keeps its FreeRTOS tick period, since the FreeRTOS backends
+// of other modules convert SystemClock durations to FreeRTOS ticks directly.
+// This clock is meant for timestamps, such as those of tracing and latency
+// measurements, and can be converted to SystemClock time with
+// std::chrono::floor.
+//
+// This clock meets the PigweedClock requirements.
+struct HighResolutionClock {
+  using rep = int64_t;
+  using period = std::ratio<1, PW_CHRONO_FREERTOS_CFG_HIGH_RESOLUTION_CLOCK_HZ>;
+  using duration = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<HighResolutionClock>;
+
+  static constexpr Epoch epoch = SystemClock::epoch;
+  static constexpr bool is_monotonic = true;
+  static constexpr bool is_steady = false;
+  static constexpr bool is_free_running = SystemClock::is_free_running;
+  static constexpr bool is_stopped_in_halting_debug_mode = true;
+  static constexpr bool is_always_enabled = true;
+  static constexpr bool is_nmi_safe = false;
+
+  // The length of a SystemClock tick in counter cycles.
+  static constexpr rep kCyclesPerTick =
+      PW_CHRONO_FREERTOS_CFG_HIGH_RESOLUTION_CLOCK_HZ / configTICK_RATE_HZ;
+
+  static_assert(PW_CHRONO_FREERTOS_CFG_HIGH_RESOLUTION_CLOCK_HZ %
+                        configTICK_RATE_HZ ==
+                    0,
+                "The counter frequency must be a multiple of the tick rate");
+  static_assert(std::ratio_equal_v<
+                    std::ratio_multiply<period, std::ratio<kCyclesPerTick>>,
+                    SystemClock::period>,
+                "The SystemClock period must be the FreeRTOS tick period");
+
+  // This is thread and IRQ safe.
+  static time_point now() noexcept;
+};
+
+// Records the start of the current tick. Call this from
+// vApplicationTickHook(), which requires configUSE_TICK_HOOK.
+void HighResolutionClockTickHook();
+
+// Enables the Cortex-M DWT cycle counter, which HighResolutionClock reads by
+// default. Call this once during initialization, before using the clock. This
+// is only available on Armv7-M and Armv8-M Mainline cores.
+void EnableCycleCounter();
+
+}  // namespace pw::chrono::freertos
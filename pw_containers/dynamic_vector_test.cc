@@ -0,0 +1,227 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/dynamic_vector.h"
+
+#include <array>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_allocator/freelist_heap.h"
+#include "pw_containers_private/test_helpers.h"
+
+namespace pw {
+namespace {
+
+using containers::test::Counter;
+
+class DynamicVectorTest : public ::testing::Test {
+ protected:
+  DynamicVectorTest() : heap_(buffer_) {}
+
+  // Returns the size of the largest free block, which shrinks while the heap
+  // has allocations.
+  size_t LargestFree() const { return heap_.LargestFreeBlockSize(); }
+
+  alignas(std::max_align_t) std::array<std::byte, 2048> buffer_{};
+  allocator::FreeListHeapBuffer<> heap_;
+};
+
+// Fills a vector through the generic interface.
+void AppendCounting(DynamicVector<int>& vector, int count) {
+  for (int i = 0; i < count; ++i) {
+    vector.push_back(i);
+  }
+}
+
+TEST_F(DynamicVectorTest, StaysInlineUpToInlineCapacity) {
+  DynamicVector<int, 4> vector(heap_);
+  const size_t free_before = LargestFree();
+
+  AppendCounting(vector, 4);
+
+  EXPECT_EQ(vector.size(), 4u);
+  EXPECT_EQ(vector.capacity(), 4u);
+  EXPECT_FALSE(vector.on_heap());
+  EXPECT_EQ(LargestFree(), free_before);
+}
+
+TEST_F(DynamicVectorTest, GrowsThroughGenericDynamicVector) {
+  DynamicVector<int, 4> vector(heap_);
+
+  AppendCounting(vector, 100);
+
+  ASSERT_EQ(vector.size(), 100u);
+  EXPECT_TRUE(vector.on_heap());
+  EXPECT_GE(vector.capacity(), 100u);
+  EXPECT_FALSE(vector.full());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(vector[static_cast<unsigned short>(i)], i);
+  }
+}
+
+TEST_F(DynamicVectorTest, InsertGrows) {
+  DynamicVector<int, 2> vector(heap_, {1, 4});
+  DynamicVector<int>& generic = vector;
+
+  generic.insert(generic.begin() + 1, {2, 3});
+  generic.insert(generic.end(), 2, 5);
+  generic.insert(generic.begin(), 0);
+
+  ASSERT_EQ(vector.size(), 7u);
+  EXPECT_EQ(vector, (DynamicVector<int, 7>(heap_, {0, 1, 2, 3, 4, 5, 5})));
+}
+
+TEST_F(DynamicVectorTest, PushBackOwnElementWhileGrowing) {
+  DynamicVector<int, 2> vector(heap_, {7, 8});
+
+  vector.push_back(vector.front());
+  vector.push_back(vector.back());
+
+  EXPECT_EQ(vector, (DynamicVector<int, 4>(heap_, {7, 8, 7, 7})));
+}
+
+TEST_F(DynamicVectorTest, ResizeGrows) {
+  DynamicVector<int, 2> vector(heap_);
+
+  vector.resize(50, 3);
+
+  ASSERT_EQ(vector.size(), 50u);
+  EXPECT_EQ(vector[49], 3);
+}
+
+TEST_F(DynamicVectorTest, ExhaustedHeapBehavesLikeFullVector) {
+  DynamicVector<std::byte, 4> vector(heap_);
+
+  for (size_t i = 0; i < buffer_.size() * 2; ++i) {
+    vector.push_back(std::byte{1});
+  }
+
+  EXPECT_LT(vector.size(), buffer_.size());
+  EXPECT_EQ(vector.size(), vector.capacity());
+  EXPECT_FALSE(vector.reserve(buffer_.size()));
+}
+
+TEST_F(DynamicVectorTest, ReserveAndShrinkToFit) {
+  DynamicVector<int, 4> vector(heap_);
+  const size_t free_before = LargestFree();
+
+  ASSERT_TRUE(vector.reserve(32));
+  EXPECT_GE(vector.capacity(), 32u);
+  EXPECT_TRUE(vector.on_heap());
+  AppendCounting(vector, 3);
+
+  vector.shrink_to_fit();
+
+  EXPECT_FALSE(vector.on_heap());
+  EXPECT_EQ(vector.capacity(), 4u);
+  EXPECT_EQ(vector, (DynamicVector<int, 3>(heap_, {0, 1, 2})));
+  EXPECT_EQ(LargestFree(), free_before);
+}
+
+TEST_F(DynamicVectorTest, DestructorFreesHeapStorage) {
+  const size_t free_before = LargestFree();
+  {
+    DynamicVector<int, 1> vector(heap_);
+    AppendCounting(vector, 20);
+    EXPECT_LT(LargestFree(), free_before);
+  }
+  EXPECT_EQ(LargestFree(), free_before);
+}
+
+TEST_F(DynamicVectorTest, ElementsAreMovedAndDestroyed) {
+  Counter::Reset();
+  {
+    DynamicVector<Counter, 2> vector(heap_);
+    for (int i = 0; i < 10; ++i) {
+      vector.emplace_back(i);
+    }
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(vector[static_cast<unsigned short>(i)].value, i);
+    }
+    EXPECT_EQ(Counter::created, 10);
+    EXPECT_GT(Counter::moved, 0);
+  }
+  EXPECT_EQ(Counter::created + Counter::moved, Counter::destroyed);
+}
+
+TEST_F(DynamicVectorTest, MoveTakesHeapStorage) {
+  DynamicVector<int, 2> original(heap_);
+  AppendCounting(original, 10);
+  const int* data = original.data();
+
+  DynamicVector<int, 2> moved(std::move(original));
+
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(moved.size(), 10u);
+  EXPECT_TRUE(original.empty());  // NOLINT(bugprone-use-after-move)
+  EXPECT_FALSE(original.on_heap());
+
+  DynamicVector<int, 2> assigned(heap_, {1});
+  assigned = std::move(moved);
+  EXPECT_EQ(assigned.data(), data);
+  EXPECT_EQ(assigned.size(), 10u);
+}
+
+TEST_F(DynamicVectorTest, MoveInlineElements) {
+  DynamicVector<int, 4> original(heap_, {1, 2, 3});
+
+  DynamicVector<int, 4> moved(std::move(original));
+
+  EXPECT_FALSE(moved.on_heap());
+  EXPECT_EQ(moved, (DynamicVector<int, 3>(heap_, {1, 2, 3})));
+}
+
+TEST_F(DynamicVectorTest, Copy) {
+  DynamicVector<int, 2> original(heap_);
+  AppendCounting(original, 5);
+
+  DynamicVector<int, 2> copy(original);
+  EXPECT_EQ(copy, original);
+  EXPECT_NE(copy.data(), original.data());
+
+  DynamicVector<int, 2> assigned(heap_);
+  assigned = original;
+  EXPECT_EQ(assigned, original);
+}
+
+TEST_F(DynamicVectorTest, EraseAndInsertInMiddle) {
+  DynamicVector<int, 2> vector(heap_, {0, 1, 2, 3, 4});
+
+  auto next = vector.erase(vector.begin() + 1, vector.begin() + 3);
+  EXPECT_EQ(*next, 3);
+  EXPECT_EQ(vector, (DynamicVector<int, 3>(heap_, {0, 3, 4})));
+
+  vector.emplace(vector.begin() + 1, 9);
+  EXPECT_EQ(vector, (DynamicVector<int, 4>(heap_, {0, 9, 3, 4})));
+}
+
+TEST_F(DynamicVectorTest, InsertDestroysMovedElements) {
+  Counter::Reset();
+  {
+    DynamicVector<Counter, 2> vector(heap_);
+    for (int i = 0; i < 6; ++i) {
+      vector.emplace_back(i);
+    }
+    vector.insert(vector.begin() + 2, 3, Counter(7));
+    ASSERT_EQ(vector.size(), 9u);
+    EXPECT_EQ(vector[1].value, 1);
+    EXPECT_EQ(vector[4].value, 7);
+    EXPECT_EQ(vector[5].value, 2);
+  }
+  EXPECT_EQ(Counter::created + Counter::moved, Counter::destroyed);
+}
+
+}  // namespace
+}  // namespace pw
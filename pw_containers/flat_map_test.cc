@@ -14,6 +14,7 @@
 
 #include "pw_containers/flat_map.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -34,6 +35,26 @@ constexpr FlatMap<int, char, 5> kOddMap({{
 
 }  // namespace
 
+TEST(FlatMap, MakeFlatMapSortsItems) {
+  constexpr auto kMap = MakeFlatMap<int, char>({
+      {100, 'e'},
+      {-3, 'a'},
+      {50, 'd'},
+      {0, 'b'},
+      {1, 'c'},
+  });
+  static_assert(kMap.size() == 5);
+  static_assert(kMap.begin()->first == -3);
+  static_assert((kMap.end() - 1)->first == 100);
+
+  EXPECT_TRUE(std::is_sorted(
+      kMap.begin(), kMap.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+      }));
+  EXPECT_EQ(kMap.at(-3), 'a');
+  EXPECT_FALSE(kMap.contains(2));
+}
+
 TEST(FlatMap, PairEquality) {
   Pair<char, int> p1{'a', 1};
   Pair<char, int> p2{'a', 1};
@@ -0,0 +1,128 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "pw_containers/flat_map.h"
+#include "pw_containers/inline_hash_map.h"
+#include "pw_containers/perfect_hash_map.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::containers {
+namespace {
+
+// Keys resemble session or route identifiers: sparse and not sequential.
+constexpr size_t kEntries = 32;
+
+constexpr uint32_t Key(size_t i) {
+  return static_cast<uint32_t>(i * 2654435761u) >> 8;
+}
+
+constexpr std::array<Pair<uint32_t, uint32_t>, kEntries> FlatMapItems() {
+  std::array<Pair<uint32_t, uint32_t>, kEntries> items{};
+  for (size_t i = 0; i < kEntries; ++i) {
+    items[i] = {Key(i), static_cast<uint32_t>(i)};
+  }
+  return items;
+}
+
+const FlatMap<uint32_t, uint32_t, kEntries> flat_map(FlatMapItems());
+
+const PerfectHashMap<uint32_t, uint32_t, kEntries> perfect_hash_map(
+    FlatMapItems());
+
+const InlineHashMap<uint32_t, uint32_t, kEntries> inline_hash_map = [] {
+  InlineHashMap<uint32_t, uint32_t, kEntries> map;
+  for (size_t i = 0; i < kEntries; ++i) {
+    map[Key(i)] = static_cast<uint32_t>(i);
+  }
+  return map;
+}();
+
+const std::unordered_map<uint32_t, uint32_t> unordered_map = [] {
+  std::unordered_map<uint32_t, uint32_t> map;
+  for (size_t i = 0; i < kEntries; ++i) {
+    map[Key(i)] = static_cast<uint32_t>(i);
+  }
+  return map;
+}();
+
+volatile uint32_t sink;
+
+template <typename Map>
+void LookupTest(perf_test::State& state, const Map& map) {
+  while (state.KeepRunning()) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < kEntries; ++i) {
+      sum += map.find(Key(i))->second;
+    }
+    sink = sum;
+  }
+}
+
+template <typename Map>
+void MissTest(perf_test::State& state, const Map& map) {
+  while (state.KeepRunning()) {
+    size_t found = 0;
+    for (size_t i = kEntries; i < 2 * kEntries; ++i) {
+      found += map.contains(Key(i)) ? 1 : 0;
+    }
+    sink = static_cast<uint32_t>(found);
+  }
+}
+
+void UnorderedMapMissTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    size_t found = 0;
+    for (size_t i = kEntries; i < 2 * kEntries; ++i) {
+      found += unordered_map.count(Key(i));
+    }
+    sink = static_cast<uint32_t>(found);
+  }
+}
+
+template <typename Map>
+void InsertEraseTest(perf_test::State& state) {
+  Map map;
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kEntries; ++i) {
+      map[Key(i)] = static_cast<uint32_t>(i);
+    }
+    for (size_t i = 0; i < kEntries; ++i) {
+      map.erase(Key(i));
+    }
+  }
+}
+
+using InlineMap = InlineHashMap<uint32_t, uint32_t, kEntries>;
+using UnorderedMap = std::unordered_map<uint32_t, uint32_t>;
+
+PW_PERF_TEST(FlatMapLookup, LookupTest, flat_map);
+PW_PERF_TEST(InlineHashMapLookup, LookupTest, inline_hash_map);
+PW_PERF_TEST(PerfectHashMapLookup, LookupTest, perfect_hash_map);
+PW_PERF_TEST(UnorderedMapLookup, LookupTest, unordered_map);
+
+PW_PERF_TEST(FlatMapMiss, MissTest, flat_map);
+PW_PERF_TEST(InlineHashMapMiss, MissTest, inline_hash_map);
+PW_PERF_TEST(PerfectHashMapMiss, MissTest, perfect_hash_map);
+PW_PERF_TEST(UnorderedMapMiss, UnorderedMapMissTest);
+
+PW_PERF_TEST(InlineHashMapInsertErase, InsertEraseTest<InlineMap>);
+PW_PERF_TEST(UnorderedMapInsertErase, InsertEraseTest<UnorderedMap>);
+
+}  // namespace
+}  // namespace pw::containers
@@ -0,0 +1,231 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/inline_hash_map.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_containers_private/test_helpers.h"
+
+namespace pw {
+namespace {
+
+using containers::test::Counter;
+
+// Sends every key to the same slot, so all entries form a single cluster.
+struct CollidingHash {
+  size_t operator()(int) const { return 0; }
+};
+
+// Sends each key to a chosen home slot: keys with the same value modulo 100
+// share a home slot.
+struct ModHundredHash {
+  size_t operator()(int key) const { return static_cast<size_t>(key % 100); }
+};
+
+TEST(InlineHashMap, Empty) {
+  InlineHashMap<int, int, 4> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.size(), 0u);
+  EXPECT_EQ(map.max_size(), 4u);
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.find(1), map.end());
+  EXPECT_FALSE(map.contains(1));
+  EXPECT_EQ(map.erase(1), 0u);
+}
+
+TEST(InlineHashMap, InsertAndFind) {
+  InlineHashMap<uint32_t, char, 8> map;
+  auto [it, inserted] = map.insert({7, 'a'});
+  ASSERT_TRUE(inserted);
+  EXPECT_EQ(it->first, 7u);
+  EXPECT_EQ(it->second, 'a');
+
+  EXPECT_TRUE(map.try_emplace(9, 'b').second);
+  EXPECT_EQ(map.size(), 2u);
+
+  // Inserting an existing key returns the existing entry.
+  auto [existing, inserted_again] = map.try_emplace(7, 'z');
+  EXPECT_FALSE(inserted_again);
+  EXPECT_EQ(existing->second, 'a');
+  EXPECT_EQ(map.size(), 2u);
+
+  EXPECT_EQ(map.at(7), 'a');
+  EXPECT_EQ(map.find(9)->second, 'b');
+  EXPECT_EQ(map.count(9), 1u);
+  EXPECT_EQ(map.count(8), 0u);
+}
+
+TEST(InlineHashMap, InitializerList) {
+  const InlineHashMap<int, int, 4> map = {{1, 10}, {2, 20}, {3, 30}};
+  EXPECT_EQ(map.size(), 3u);
+  EXPECT_EQ(map.at(1), 10);
+  EXPECT_EQ(map.at(2), 20);
+  EXPECT_EQ(map.at(3), 30);
+}
+
+TEST(InlineHashMap, SubscriptOperator) {
+  InlineHashMap<int, int, 4> map;
+  map[3] = 5;
+  map[3] += 1;
+  EXPECT_EQ(map[3], 6);
+  EXPECT_EQ(map[4], 0);
+  EXPECT_EQ(map.size(), 2u);
+}
+
+TEST(InlineHashMap, Full) {
+  InlineHashMap<int, int, 3> map;
+  EXPECT_TRUE(map.insert({1, 1}).second);
+  EXPECT_TRUE(map.insert({2, 2}).second);
+  EXPECT_TRUE(map.insert({3, 3}).second);
+  EXPECT_TRUE(map.full());
+
+  auto [it, inserted] = map.insert({4, 4});
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it, map.end());
+
+  // Existing keys are still found when the map is full.
+  EXPECT_EQ(map.try_emplace(2, 0).first->second, 2);
+
+  EXPECT_EQ(map.erase(1), 1u);
+  EXPECT_TRUE(map.insert({4, 4}).second);
+}
+
+TEST(InlineHashMap, Iterate) {
+  InlineHashMap<int, int, 16> map;
+  for (int i = 0; i < 16; ++i) {
+    map[i] = i * 2;
+  }
+
+  int sum = 0;
+  size_t count = 0;
+  for (const auto& [key, value] : map) {
+    EXPECT_EQ(value, key * 2);
+    sum += key;
+    ++count;
+  }
+  EXPECT_EQ(count, 16u);
+  EXPECT_EQ(sum, 15 * 16 / 2);
+
+  for (auto& entry : map) {
+    entry.second = -entry.first;
+  }
+
+  const auto& const_map = map;
+  InlineHashMap<int, int, 16>::const_iterator it = map.begin();
+  EXPECT_EQ(it, const_map.cbegin());
+  for (; it != const_map.end(); ++it) {
+    EXPECT_EQ(it->second, -it->first);
+  }
+}
+
+TEST(InlineHashMap, Collisions) {
+  InlineHashMap<int, int, 8, CollidingHash> map;
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(map.insert({i, i}).second);
+  }
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(map.at(i), i);
+  }
+  EXPECT_FALSE(map.contains(8));
+
+  // Erase from the middle of the cluster and check that the entries after it
+  // are still reachable.
+  EXPECT_EQ(map.erase(3), 1u);
+  EXPECT_EQ(map.erase(0), 1u);
+  EXPECT_FALSE(map.contains(3));
+  EXPECT_FALSE(map.contains(0));
+  for (int i : {1, 2, 4, 5, 6, 7}) {
+    EXPECT_EQ(map.at(i), i);
+  }
+  EXPECT_EQ(map.size(), 6u);
+}
+
+TEST(InlineHashMap, InterleavedClusters) {
+  InlineHashMap<int, int, 12, ModHundredHash> map;
+
+  // Insert keys with different home slots in an order that makes their probe
+  // sequences overlap.
+  for (int key : {1, 101, 2, 201, 102, 3, 301, 202, 4, 103, 401, 5}) {
+    ASSERT_TRUE(map.insert({key, key}).second);
+  }
+  for (int key : {1, 101, 2, 201, 102, 3, 301, 202, 4, 103, 401, 5}) {
+    EXPECT_EQ(map.at(key), key);
+  }
+
+  for (int key : {101, 2, 301, 4}) {
+    EXPECT_EQ(map.erase(key), 1u);
+  }
+  for (int key : {1, 201, 102, 3, 202, 103, 401, 5}) {
+    EXPECT_EQ(map.at(key), key);
+  }
+  for (int key : {101, 2, 301, 4}) {
+    EXPECT_FALSE(map.contains(key));
+  }
+}
+
+TEST(InlineHashMap, ChurnKeepsEntriesReachable) {
+  InlineHashMap<uint32_t, uint32_t, 32> map;
+  for (uint32_t round = 0; round < 64; ++round) {
+    // Keep the map full with a sliding window of keys.
+    for (uint32_t key = round; key < round + 32; key += 1) {
+      map[key * 8] = key;
+    }
+    ASSERT_TRUE(map.full());
+    for (uint32_t key = round; key < round + 32; ++key) {
+      ASSERT_EQ(map.at(key * 8), key);
+    }
+    ASSERT_EQ(map.erase(round * 8), 1u);
+  }
+}
+
+TEST(InlineHashMap, Copy) {
+  InlineHashMap<int, int, 4> map = {{1, 10}, {2, 20}};
+  InlineHashMap<int, int, 4> copy(map);
+  map.erase(1);
+
+  EXPECT_EQ(copy.size(), 2u);
+  EXPECT_EQ(copy.at(1), 10);
+  EXPECT_EQ(copy.at(2), 20);
+
+  copy = map;
+  EXPECT_EQ(copy.size(), 1u);
+  EXPECT_FALSE(copy.contains(1));
+  EXPECT_EQ(copy.at(2), 20);
+}
+
+TEST(InlineHashMap, ConstructsAndDestroysValues) {
+  Counter::Reset();
+  {
+    InlineHashMap<int, Counter, 8, CollidingHash> map;
+    for (int i = 0; i < 8; ++i) {
+      map.try_emplace(i, i);
+    }
+    EXPECT_EQ(Counter::created, 8);
+
+    map.erase(0);
+    EXPECT_EQ(Counter::created + Counter::moved - Counter::destroyed, 7);
+
+    map.clear();
+    EXPECT_EQ(Counter::created + Counter::moved - Counter::destroyed, 0);
+
+    map.try_emplace(1, 1);
+  }
+  EXPECT_EQ(Counter::created + Counter::moved - Counter::destroyed, 0);
+}
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,72 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_doubly_linked_list.h"
+
+#include "pw_assert/check.h"
+
+namespace pw::intrusive_doubly_linked_list_impl {
+
+Item::Item(Item&& other) : Item() { *this = std::move(other); }
+
+Item& Item::operator=(Item&& other) {
+  if (this == &other) {
+    return *this;
+  }
+  // Remove `this` object from its current list.
+  unlist();
+  // If `other` is listed, put `this` in its place.
+  if (!other.unlisted()) {
+    prev_ = other.prev_;
+    next_ = other.next_;
+    prev_->next_ = this;
+    next_->prev_ = this;
+    other.prev_ = &other;
+    other.next_ = &other;
+  }
+  return *this;
+}
+
+void List::insert(Item* pos, Item& item) {
+  PW_CHECK(item.unlisted(),
+           "Cannot add an item to a pw::IntrusiveDoublyLinkedList that is "
+           "already in a list");
+  item.prev_ = pos->prev_;
+  item.next_ = pos;
+  pos->prev_->next_ = &item;
+  pos->prev_ = &item;
+}
+
+void List::clear() {
+  while (!empty()) {
+    erase(*begin());
+  }
+}
+
+size_t List::size() const {
+  size_t total = 0;
+  for (const Item* item = begin(); item != end(); item = item->next_) {
+    total++;
+  }
+  return total;
+}
+
+void CountedList::clear() {
+  while (!empty()) {
+    // Only CountedItems are ever inserted into a CountedList.
+    erase(static_cast<CountedItem&>(*begin()));
+  }
+}
+
+}  // namespace pw::intrusive_doubly_linked_list_impl
@@ -0,0 +1,396 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_doubly_linked_list.h"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "pw_compilation_testing/negative_compilation.h"
+#include "pw_containers/vector.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public IntrusiveDoublyLinkedList<TestItem>::Item {
+ public:
+  TestItem() : number_(0) {}
+  TestItem(int number) : number_(number) {}
+
+  int GetNumber() const { return number_; }
+
+  // Add equality comparison to ensure comparisons are done by identity rather
+  // than equality for the remove function.
+  bool operator==(const TestItem& other) const {
+    return number_ == other.number_;
+  }
+
+ private:
+  int number_;
+};
+
+class CountedTestItem
+    : public IntrusiveDoublyLinkedList<CountedTestItem, true>::Item {
+ public:
+  CountedTestItem() : number_(0) {}
+  CountedTestItem(int number) : number_(number) {}
+
+  int GetNumber() const { return number_; }
+
+ private:
+  int number_;
+};
+
+using CountedList = IntrusiveDoublyLinkedList<CountedTestItem, true>;
+
+TEST(IntrusiveDoublyLinkedList, Construct_InitializerList_Multiple) {
+  TestItem one(1);
+  TestItem two(2);
+  TestItem thr(3);
+
+  IntrusiveDoublyLinkedList<TestItem> list({&one, &two, &thr});
+  auto it = list.begin();
+  EXPECT_EQ(&one, &(*it++));
+  EXPECT_EQ(&two, &(*it++));
+  EXPECT_EQ(&thr, &(*it++));
+  EXPECT_EQ(list.end(), it);
+}
+
+TEST(IntrusiveDoublyLinkedList, Construct_ObjectIterator_Multiple) {
+  std::array<TestItem, 3> array{{{1}, {2}, {3}}};
+
+  IntrusiveDoublyLinkedList<TestItem> list(array.begin(), array.end());
+  auto it = list.begin();
+  EXPECT_EQ(&array[0], &(*it++));
+  EXPECT_EQ(&array[1], &(*it++));
+  EXPECT_EQ(&array[2], &(*it++));
+  EXPECT_EQ(list.end(), it);
+}
+
+TEST(IntrusiveDoublyLinkedList, Assign_ReplacesPriorContents) {
+  std::array<TestItem, 3> array{{{0}, {100}, {200}}};
+  IntrusiveDoublyLinkedList<TestItem> list(array.begin(), array.end());
+
+  list.assign(array.begin() + 1, array.begin() + 2);
+
+  auto it = list.begin();
+  EXPECT_EQ(&array[1], &(*it++));
+  EXPECT_EQ(list.end(), it);
+  EXPECT_TRUE(array[0].unlisted());
+  EXPECT_TRUE(array[2].unlisted());
+}
+
+TEST(IntrusiveDoublyLinkedList, PushFrontAndBack) {
+  TestItem item1(1);
+  TestItem item2(2);
+  TestItem item3(3);
+
+  IntrusiveDoublyLinkedList<TestItem> list;
+  EXPECT_TRUE(list.empty());
+  list.push_back(item2);
+  list.push_front(item1);
+  list.push_back(item3);
+  EXPECT_FALSE(list.empty());
+
+  EXPECT_EQ(&item1, &list.front());
+  EXPECT_EQ(&item3, &list.back());
+
+  int loop_count = 0;
+  for (auto& test_item : list) {
+    loop_count++;
+    EXPECT_EQ(loop_count, test_item.GetNumber());
+  }
+  EXPECT_EQ(loop_count, 3);
+}
+
+TEST(IntrusiveDoublyLinkedList, Insert) {
+  TestItem item1(1);
+  TestItem item2(2);
+  TestItem item3(3);
+
+  IntrusiveDoublyLinkedList<TestItem> list({&item1, &item3});
+  auto it = list.insert(++list.begin(), item2);
+  EXPECT_EQ(&item2, &(*it));
+
+  it = list.begin();
+  EXPECT_EQ(1, (*it++).GetNumber());
+  EXPECT_EQ(2, (*it++).GetNumber());
+  EXPECT_EQ(3, (*it++).GetNumber());
+  EXPECT_EQ(list.end(), it);
+}
+
+TEST(IntrusiveDoublyLinkedList, Insert_AtEnd) {
+  TestItem item1(1);
+  TestItem item2(2);
+
+  IntrusiveDoublyLinkedList<TestItem> list({&item1});
+  list.insert(list.end(), item2);
+  EXPECT_EQ(&item2, &list.back());
+}
+
+TEST(IntrusiveDoublyLinkedList, IterateBackwards) {
+  std::array<TestItem, 3> array{{{1}, {2}, {3}}};
+  IntrusiveDoublyLinkedList<TestItem> list(array.begin(), array.end());
+
+  auto it = list.end();
+  EXPECT_EQ(3, (*--it).GetNumber());
+  EXPECT_EQ(2, (*--it).GetNumber());
+  EXPECT_EQ(1, (*--it).GetNumber());
+  EXPECT_EQ(list.begin(), it);
+
+  int expected = 3;
+  for (auto rit = list.rbegin(); rit != list.rend(); ++rit) {
+    EXPECT_EQ(expected--, rit->GetNumber());
+  }
+  EXPECT_EQ(0, expected);
+}
+
+TEST(IntrusiveDoublyLinkedList, ConstIteratorRead) {
+  std::array<TestItem, 2> array{{{1}, {2}}};
+  const IntrusiveDoublyLinkedList<TestItem> list(array.begin(), array.end());
+
+  auto it = list.cbegin();
+  EXPECT_EQ(1, (*it++).GetNumber());
+  EXPECT_EQ(2, (*it++).GetNumber());
+  EXPECT_EQ(list.cend(), it);
+  EXPECT_EQ(2, list.crbegin()->GetNumber());
+  EXPECT_EQ(1, list.front().GetNumber());
+  EXPECT_EQ(2, list.back().GetNumber());
+}
+
+#if PW_NC_TEST(CannotModifyThroughConstIterator)
+PW_NC_EXPECT("function is not marked const|discards qualifiers");
+
+class ModifiableItem
+    : public IntrusiveDoublyLinkedList<ModifiableItem>::Item {
+ public:
+  void Modify() {}
+};
+
+TEST(IntrusiveDoublyLinkedList, ConstIteratorModify) {
+  ModifiableItem item;
+  const IntrusiveDoublyLinkedList<ModifiableItem> list({&item});
+  list.begin()->Modify();
+}
+
+#endif  // PW_NC_TEST
+
+TEST(IntrusiveDoublyLinkedList, PopFrontAndBack) {
+  TestItem item1(1);
+  TestItem item2(2);
+  TestItem item3(3);
+
+  IntrusiveDoublyLinkedList<TestItem> list({&item1, &item2, &item3});
+  list.pop_front();
+  EXPECT_TRUE(item1.unlisted());
+  list.pop_back();
+  EXPECT_TRUE(item3.unlisted());
+  EXPECT_EQ(&item2, &list.front());
+  EXPECT_EQ(&item2, &list.back());
+
+  list.pop_back();
+  EXPECT_TRUE(list.empty());
+}
+
+TEST(IntrusiveDoublyLinkedList, Erase) {
+  TestItem item1(1);
+  TestItem item2(2);
+  TestItem item3(3);
+
+  IntrusiveDoublyLinkedList<TestItem> list({&item1, &item2, &item3});
+  auto it = list.erase(++list.begin());
+  EXPECT_EQ(&item3, &(*it));
+  EXPECT_TRUE(item2.unlisted());
+
+  it = list.erase(it);
+  EXPECT_EQ(list.end(), it);
+  EXPECT_EQ(&item1, &list.back());
+}
+
+TEST(IntrusiveDoublyLinkedList, Remove) {
+  TestItem item1(1);
+  TestItem item2(1);
+  TestItem item3(1);
+
+  IntrusiveDoublyLinkedList<TestItem> list({&item1, &item2, &item3});
+
+  // Items compare equal, so this checks that removal is by identity.
+  EXPECT_TRUE(list.remove(item2));
+  EXPECT_FALSE(list.remove(item2));
+
+  auto it = list.begin();
+  EXPECT_EQ(&item1, &(*it++));
+  EXPECT_EQ(&item3, &(*it++));
+  EXPECT_EQ(list.end(), it);
+
+  EXPECT_TRUE(list.remove(item3));
+  EXPECT_TRUE(list.remove(item1));
+  EXPECT_TRUE(list.empty());
+}
+
+TEST(IntrusiveDoublyLinkedList, Clear_ReinsertClearedItems) {
+  std::array<TestItem, 3> array{{{0}, {1}, {2}}};
+  IntrusiveDoublyLinkedList<TestItem> list(array.begin(), array.end());
+
+  list.clear();
+  EXPECT_TRUE(list.empty());
+  for (const TestItem& item : array) {
+    EXPECT_TRUE(item.unlisted());
+  }
+
+  list.assign(array.begin(), array.end());
+  EXPECT_EQ(3u, list.size());
+}
+
+TEST(IntrusiveDoublyLinkedList, ItemsRemoveThemselvesFromListsWhenDestructed) {
+  TestItem a, b;
+  IntrusiveDoublyLinkedList<TestItem> list;
+  list.push_back(a);
+  list.push_back(b);
+
+  {
+    TestItem x, y;
+    list.push_front(x);
+    list.insert(++list.begin(), y);
+    EXPECT_EQ(4u, list.size());
+  }
+
+  auto it = list.begin();
+  EXPECT_EQ(&a, &(*it++));
+  EXPECT_EQ(&b, &(*it++));
+  EXPECT_EQ(list.end(), it);
+  EXPECT_EQ(&b, &list.back());
+}
+
+TEST(IntrusiveDoublyLinkedList, MoveListedItems) {
+  TestItem item1(1);
+  TestItem item2(2);
+  TestItem item3(3);
+
+  IntrusiveDoublyLinkedList<TestItem> list = {&item1, &item2, &item3};
+
+  Vector<TestItem, 3> vector;
+  vector.emplace_back(std::move(item2));
+  vector.emplace_back(std::move(item1));
+  vector.emplace_back(std::move(item3));
+
+  auto iter = list.begin();
+  EXPECT_EQ((*iter++).GetNumber(), 1);
+  EXPECT_EQ((*iter++).GetNumber(), 2);
+  EXPECT_EQ((*iter++).GetNumber(), 3);
+  EXPECT_EQ(iter, list.end());
+  EXPECT_EQ(&vector[1], &list.front());
+  EXPECT_EQ(&vector[2], &list.back());
+}
+
+TEST(IntrusiveDoublyLinkedList, Counted_Size) {
+  CountedList list;
+  EXPECT_EQ(0u, list.size());
+
+  CountedTestItem one(1);
+  CountedTestItem two(2);
+  list.push_back(one);
+  list.push_front(two);
+  EXPECT_EQ(2u, list.size());
+
+  {
+    CountedTestItem thr(3);
+    list.insert(list.end(), thr);
+    EXPECT_EQ(3u, list.size());
+  }
+  EXPECT_EQ(2u, list.size());
+
+  EXPECT_TRUE(list.remove(one));
+  EXPECT_FALSE(list.remove(one));
+  EXPECT_EQ(1u, list.size());
+
+  list.pop_back();
+  EXPECT_EQ(0u, list.size());
+  EXPECT_TRUE(list.empty());
+}
+
+TEST(IntrusiveDoublyLinkedList, Counted_EraseAndClear) {
+  std::array<CountedTestItem, 4> array{{{0}, {1}, {2}, {3}}};
+  CountedList list(array.begin(), array.end());
+  EXPECT_EQ(4u, list.size());
+
+  auto it = list.erase(list.begin());
+  EXPECT_EQ(1, it->GetNumber());
+  EXPECT_EQ(3u, list.size());
+
+  array[2].unlist();
+  EXPECT_EQ(2u, list.size());
+
+  list.clear();
+  EXPECT_EQ(0u, list.size());
+
+  list.assign(array.begin(), array.begin() + 2);
+  EXPECT_EQ(2u, list.size());
+}
+
+TEST(IntrusiveDoublyLinkedList, Counted_MoveKeepsSize) {
+  CountedList list;
+  CountedTestItem item1(1);
+  list.push_back(item1);
+
+  CountedTestItem item2(std::move(item1));
+  EXPECT_TRUE(item1.unlisted());
+  EXPECT_EQ(1u, list.size());
+  EXPECT_EQ(&item2, &list.front());
+
+  // Moving an unlisted item over a listed one removes the listed one.
+  item2 = std::move(item1);
+  EXPECT_EQ(0u, list.size());
+  EXPECT_TRUE(list.empty());
+}
+
+TEST(IntrusiveDoublyLinkedList, Counted_ItemInAnotherList) {
+  CountedList list1;
+  CountedList list2;
+  CountedTestItem item1(1);
+  CountedTestItem item2(2);
+  list1.push_back(item1);
+  list2.push_back(item2);
+
+  // Removing an item through its own list's counter keeps both sizes right.
+  item2.unlist();
+  EXPECT_EQ(1u, list1.size());
+  EXPECT_EQ(0u, list2.size());
+
+  list2.push_back(item2);
+  EXPECT_EQ(1u, list2.size());
+}
+
+#if PW_NC_TEST(IncompatibileItemType)
+PW_NC_EXPECT("IntrusiveDoublyLinkedList items must be derived from");
+
+struct Foo {};
+
+class BadItem : public IntrusiveDoublyLinkedList<Foo>::Item {};
+
+[[maybe_unused]] IntrusiveDoublyLinkedList<BadItem> incompatible_item_type;
+
+#elif PW_NC_TEST(DoesNotInheritFromItem)
+PW_NC_EXPECT("IntrusiveDoublyLinkedList items must be derived from");
+
+struct NotAnItem {};
+
+[[maybe_unused]] IntrusiveDoublyLinkedList<NotAnItem> list;
+
+#endif  // PW_NC_TEST
+
+}  // namespace
+}  // namespace pw
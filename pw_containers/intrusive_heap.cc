@@ -0,0 +1,163 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_heap.h"
+
+#include "pw_assert/check.h"
+
+namespace pw::intrusive_heap_impl {
+
+Item::~Item() {
+  PW_CHECK(unlisted(),
+           "A pw::IntrusiveHeap item must be removed before it is destroyed");
+}
+
+void Heap::clear() {
+  // Unlink items bottom up, so each item is visited once.
+  Item* item = root_;
+  while (item != nullptr) {
+    if (item->left_ != nullptr) {
+      item = item->left_;
+    } else if (item->right_ != nullptr) {
+      item = item->right_;
+    } else {
+      Item* parent = item->parent_;
+      if (parent != nullptr) {
+        if (parent->left_ == item) {
+          parent->left_ = nullptr;
+        } else {
+          parent->right_ = nullptr;
+        }
+      }
+      item->Reset();
+      item = parent;
+    }
+  }
+  root_ = nullptr;
+  size_ = 0;
+}
+
+void Heap::Append(Item& item) {
+  PW_CHECK(
+      item.unlisted(),
+      "Cannot add an item to a pw::IntrusiveHeap that is already in a heap");
+  size_ += 1;
+  item.left_ = nullptr;
+  item.right_ = nullptr;
+  if (size_ == 1) {
+    item.parent_ = nullptr;
+    root_ = &item;
+    return;
+  }
+  Item* parent = ItemAt(size_ / 2);
+  if (size_ % 2 == 0) {
+    parent->left_ = &item;
+  } else {
+    parent->right_ = &item;
+  }
+  item.parent_ = parent;
+}
+
+Item* Heap::RemoveAndFill(Item& item) {
+  // Detach the last item first, so it is never one of its own neighbours.
+  Item* last = ItemAt(size_);
+  if (last->parent_ == nullptr) {
+    root_ = nullptr;
+  } else if (last->parent_->right_ == last) {
+    last->parent_->right_ = nullptr;
+  } else {
+    last->parent_->left_ = nullptr;
+  }
+  size_ -= 1;
+
+  if (last == &item) {
+    item.Reset();
+    return nullptr;
+  }
+
+  last->parent_ = item.parent_;
+  last->left_ = item.left_;
+  last->right_ = item.right_;
+  if (last->left_ != nullptr) {
+    last->left_->parent_ = last;
+  }
+  if (last->right_ != nullptr) {
+    last->right_->parent_ = last;
+  }
+  if (item.parent_ == nullptr) {
+    root_ = last;
+  } else if (item.parent_->left_ == &item) {
+    item.parent_->left_ = last;
+  } else {
+    item.parent_->right_ = last;
+  }
+  item.Reset();
+  return last;
+}
+
+void Heap::SwapWithParent(Item& child) {
+  Item* parent = child.parent_;
+  Item* grandparent = parent->parent_;
+  Item* child_left = child.left_;
+  Item* child_right = child.right_;
+
+  if (parent->left_ == &child) {
+    child.left_ = parent;
+    child.right_ = parent->right_;
+    if (child.right_ != nullptr) {
+      child.right_->parent_ = &child;
+    }
+  } else {
+    child.right_ = parent;
+    child.left_ = parent->left_;
+    if (child.left_ != nullptr) {
+      child.left_->parent_ = &child;
+    }
+  }
+
+  parent->left_ = child_left;
+  parent->right_ = child_right;
+  if (child_left != nullptr) {
+    child_left->parent_ = parent;
+  }
+  if (child_right != nullptr) {
+    child_right->parent_ = parent;
+  }
+
+  parent->parent_ = &child;
+  child.parent_ = grandparent;
+  if (grandparent == nullptr) {
+    root_ = &child;
+  } else if (grandparent->left_ == parent) {
+    grandparent->left_ = &child;
+  } else {
+    grandparent->right_ = &child;
+  }
+}
+
+Item* Heap::ItemAt(size_t position) const {
+  // The bits of the position after its leading one spell out the path from
+  // the root: 0 for left and 1 for right.
+  size_t bit = 1;
+  while (bit <= position / 2) {
+    bit <<= 1;
+  }
+  Item* item = root_;
+  for (bit >>= 1; bit != 0; bit >>= 1) {
+    item = (position & bit) != 0 ? item->right_ : item->left_;
+  }
+  return item;
+}
+
+}  // namespace pw::intrusive_heap_impl
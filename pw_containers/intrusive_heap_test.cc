@@ -0,0 +1,255 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_heap.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "gtest/gtest.h"
+#include "pw_compilation_testing/negative_compilation.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public IntrusiveHeap<TestItem>::Item {
+ public:
+  TestItem() : number_(0) {}
+  TestItem(int number) : number_(number) {}
+
+  int GetNumber() const { return number_; }
+  void SetNumber(int number) { number_ = number; }
+
+  bool operator<(const TestItem& other) const {
+    return number_ < other.number_;
+  }
+  bool operator>(const TestItem& other) const {
+    return number_ > other.number_;
+  }
+
+ private:
+  int number_;
+};
+
+// Numbers items with a fixed permutation of 0 to N - 1.
+template <size_t kSize>
+void Shuffle(std::array<TestItem, kSize>& items) {
+  static_assert(kSize % 7 != 0);
+  for (size_t i = 0; i < kSize; ++i) {
+    items[i].SetNumber(static_cast<int>((i * 7) % kSize));
+  }
+}
+
+TEST(IntrusiveHeap, Empty) {
+  IntrusiveHeap<TestItem> heap;
+  EXPECT_TRUE(heap.empty());
+  EXPECT_EQ(0u, heap.size());
+}
+
+TEST(IntrusiveHeap, PushAndPop_MaxFirst) {
+  std::array<TestItem, 50> items;
+  Shuffle(items);
+  IntrusiveHeap<TestItem> heap;
+  for (TestItem& item : items) {
+    heap.push(item);
+  }
+  EXPECT_EQ(50u, heap.size());
+
+  for (int expected = 49; expected >= 0; --expected) {
+    ASSERT_FALSE(heap.empty());
+    EXPECT_EQ(expected, heap.top().GetNumber());
+    heap.pop();
+  }
+  EXPECT_TRUE(heap.empty());
+  for (const TestItem& item : items) {
+    EXPECT_TRUE(item.unlisted());
+  }
+}
+
+TEST(IntrusiveHeap, CustomCompare_MinFirst) {
+  std::array<TestItem, 20> items;
+  Shuffle(items);
+  IntrusiveHeap<TestItem, std::greater<TestItem>> heap;
+  for (TestItem& item : items) {
+    heap.push(item);
+  }
+  for (int expected = 0; expected < 20; ++expected) {
+    EXPECT_EQ(expected, heap.top().GetNumber());
+    heap.pop();
+  }
+}
+
+TEST(IntrusiveHeap, DuplicatePriorities) {
+  std::array<TestItem, 6> items{{{1}, {3}, {1}, {3}, {2}, {1}}};
+  IntrusiveHeap<TestItem> heap;
+  for (TestItem& item : items) {
+    heap.push(item);
+  }
+  for (int expected : {3, 3, 2, 1, 1, 1}) {
+    EXPECT_EQ(expected, heap.top().GetNumber());
+    heap.pop();
+  }
+}
+
+TEST(IntrusiveHeap, Remove) {
+  std::array<TestItem, 30> items;
+  Shuffle(items);
+  IntrusiveHeap<TestItem> heap;
+  for (TestItem& item : items) {
+    heap.push(item);
+  }
+
+  // Remove every third item, from the middle, leaves, and top of the heap.
+  for (TestItem& item : items) {
+    if (item.GetNumber() % 3 == 0) {
+      EXPECT_TRUE(heap.remove(item));
+      EXPECT_TRUE(item.unlisted());
+      EXPECT_FALSE(heap.remove(item));
+    }
+  }
+  EXPECT_EQ(20u, heap.size());
+
+  for (int expected = 29; expected >= 0; --expected) {
+    if (expected % 3 != 0) {
+      EXPECT_EQ(expected, heap.top().GetNumber());
+      heap.pop();
+    }
+  }
+  EXPECT_TRUE(heap.empty());
+}
+
+TEST(IntrusiveHeap, Remove_Last) {
+  TestItem one(1);
+  TestItem two(2);
+  IntrusiveHeap<TestItem> heap;
+  heap.push(two);
+  heap.push(one);
+
+  EXPECT_TRUE(heap.remove(one));
+  EXPECT_EQ(&two, &heap.top());
+  EXPECT_TRUE(heap.remove(two));
+  EXPECT_TRUE(heap.empty());
+}
+
+TEST(IntrusiveHeap, Update) {
+  std::array<TestItem, 16> items;
+  Shuffle(items);
+  IntrusiveHeap<TestItem> heap;
+  for (TestItem& item : items) {
+    heap.push(item);
+  }
+
+  // Raise the lowest item to the top, and lower the top item to the bottom.
+  TestItem& lowest = items[0];
+  ASSERT_EQ(0, lowest.GetNumber());
+  lowest.SetNumber(100);
+  heap.update(lowest);
+  EXPECT_EQ(&lowest, &heap.top());
+
+  lowest.SetNumber(-1);
+  heap.update(lowest);
+  EXPECT_EQ(15, heap.top().GetNumber());
+
+  for (int expected = 15; expected >= -1; --expected) {
+    if (expected == 0) {
+      continue;
+    }
+    EXPECT_EQ(expected, heap.top().GetNumber());
+    heap.pop();
+  }
+  EXPECT_TRUE(heap.empty());
+}
+
+TEST(IntrusiveHeap, Clear) {
+  std::array<TestItem, 10> items;
+  Shuffle(items);
+  IntrusiveHeap<TestItem> heap;
+  for (TestItem& item : items) {
+    heap.push(item);
+  }
+
+  heap.clear();
+  EXPECT_TRUE(heap.empty());
+  EXPECT_EQ(0u, heap.size());
+  for (TestItem& item : items) {
+    EXPECT_TRUE(item.unlisted());
+    heap.push(item);
+  }
+  EXPECT_EQ(10u, heap.size());
+  heap.clear();
+}
+
+TEST(IntrusiveHeap, DestroyingHeapRemovesItems) {
+  std::array<TestItem, 5> items;
+  Shuffle(items);
+  {
+    IntrusiveHeap<TestItem> heap;
+    for (TestItem& item : items) {
+      heap.push(item);
+    }
+  }
+  for (const TestItem& item : items) {
+    EXPECT_TRUE(item.unlisted());
+  }
+}
+
+TEST(IntrusiveHeap, InterleavedOperations) {
+  std::array<TestItem, 64> items;
+  Shuffle(items);
+  IntrusiveHeap<TestItem> heap;
+
+  // Push items in batches and pop half of each batch, checking that the top
+  // is always the greatest item in the heap.
+  size_t next = 0;
+  while (next < items.size()) {
+    for (size_t i = 0; i < 8 && next < items.size(); ++i) {
+      heap.push(items[next++]);
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      int greatest = -1;
+      for (const TestItem& item : items) {
+        if (!item.unlisted() && item.GetNumber() > greatest) {
+          greatest = item.GetNumber();
+        }
+      }
+      EXPECT_EQ(greatest, heap.top().GetNumber());
+      heap.pop();
+    }
+  }
+  EXPECT_EQ(32u, heap.size());
+  heap.clear();
+}
+
+#if PW_NC_TEST(IncompatibileItemType)
+PW_NC_EXPECT("IntrusiveHeap items must be derived from IntrusiveHeap<T>::Item");
+
+struct Foo {};
+
+class BadItem : public IntrusiveHeap<Foo>::Item {};
+
+[[maybe_unused]] IntrusiveHeap<BadItem> derived_from_incompatible_item_type;
+
+#elif PW_NC_TEST(DoesNotInheritFromItem)
+PW_NC_EXPECT("IntrusiveHeap items must be derived from IntrusiveHeap<T>::Item");
+
+struct NotAnItem {};
+
+[[maybe_unused]] IntrusiveHeap<NotAnItem> heap;
+
+#endif  // PW_NC_TEST
+
+}  // namespace
+}  // namespace pw
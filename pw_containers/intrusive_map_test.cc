@@ -0,0 +1,134 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_map.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_containers/intrusive_set.h"
+
+namespace pw {
+namespace {
+
+class Session : public IntrusiveMap<uint32_t, Session>::Item {
+ public:
+  Session(uint32_t id, std::string_view name) : id_(id), name_(name) {}
+
+  uint32_t key() const { return id_; }
+  std::string_view name() const { return name_; }
+
+ private:
+  uint32_t id_;
+  std::string_view name_;
+};
+
+class NamedSession : public IntrusiveMap<std::string_view, NamedSession>::Item {
+ public:
+  NamedSession(std::string_view name) : name_(name) {}
+
+  const std::string_view& key() const { return name_; }
+
+  bool operator<(const NamedSession& other) const {
+    return name_ < other.name_;
+  }
+
+ private:
+  std::string_view name_;
+};
+
+TEST(IntrusiveMap, InsertAndFind) {
+  Session a(3, "a");
+  Session b(1, "b");
+  Session c(2, "c");
+  IntrusiveMap<uint32_t, Session> map({&a, &b, &c});
+  EXPECT_EQ(3u, map.size());
+
+  EXPECT_EQ(&b, &(*map.find(1)));
+  EXPECT_EQ(&c, &(*map.find(2)));
+  EXPECT_EQ(&a, &(*map.find(3)));
+  EXPECT_EQ(map.end(), map.find(4));
+  EXPECT_EQ(1u, map.count(2));
+
+  uint32_t expected = 1;
+  for (const Session& session : map) {
+    EXPECT_EQ(expected++, session.key());
+  }
+  map.clear();
+}
+
+TEST(IntrusiveMap, Insert_DuplicateKey) {
+  Session first(7, "first");
+  Session second(7, "second");
+  IntrusiveMap<uint32_t, Session> map;
+
+  EXPECT_TRUE(map.insert(first).second);
+  auto result = map.insert(second);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ("first", result.first->name());
+  map.clear();
+}
+
+TEST(IntrusiveMap, EraseByKey) {
+  Session a(10, "a");
+  Session b(20, "b");
+  IntrusiveMap<uint32_t, Session> map({&a, &b});
+
+  EXPECT_EQ(1u, map.erase(10));
+  EXPECT_EQ(0u, map.erase(10));
+  EXPECT_TRUE(a.unlisted());
+  EXPECT_EQ(&b, &(*map.begin()));
+  map.clear();
+}
+
+TEST(IntrusiveMap, Bounds) {
+  Session a(10, "a");
+  Session b(20, "b");
+  Session c(30, "c");
+  const IntrusiveMap<uint32_t, Session> map({&a, &b, &c});
+
+  EXPECT_EQ(&b, &(*map.lower_bound(15)));
+  EXPECT_EQ(&b, &(*map.lower_bound(20)));
+  EXPECT_EQ(&c, &(*map.upper_bound(20)));
+  EXPECT_EQ(map.end(), map.upper_bound(30));
+}
+
+TEST(IntrusiveMap, ReferenceKey) {
+  NamedSession b("bravo");
+  NamedSession a("alpha");
+  IntrusiveMap<std::string_view, NamedSession> map({&b, &a});
+
+  EXPECT_EQ(&a, &(*map.find("alpha")));
+  EXPECT_EQ(&a, &(*map.begin()));
+  map.clear();
+}
+
+TEST(IntrusiveMap, ItemsCanBeUsedInSets) {
+  NamedSession b("bravo");
+  NamedSession a("alpha");
+  IntrusiveSet<NamedSession> set({&b, &a});
+
+  EXPECT_EQ(&a, &(*set.begin()));
+  set.clear();
+
+  IntrusiveMap<std::string_view, NamedSession> map({&a});
+  EXPECT_EQ(&a, &(*map.find("alpha")));
+  map.clear();
+}
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,165 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares keeping items ordered in a sorted IntrusiveList, which is the usual
+// pattern for timers and free blocks, with IntrusiveHeap and IntrusiveSet.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_containers/intrusive_heap.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_containers/intrusive_set.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::containers {
+namespace {
+
+constexpr size_t kItems = 64;
+
+// Deadlines arrive out of order, as they do for timers with different periods.
+constexpr uint32_t Deadline(size_t i) {
+  return static_cast<uint32_t>(i * 2654435761u) >> 8;
+}
+
+class ListTimer : public IntrusiveList<ListTimer>::Item {
+ public:
+  uint32_t deadline = 0;
+};
+
+class HeapTimer : public IntrusiveHeap<HeapTimer>::Item {
+ public:
+  uint32_t deadline = 0;
+};
+
+class SetTimer : public IntrusiveSet<SetTimer>::Item {
+ public:
+  uint32_t deadline = 0;
+
+  bool operator<(const SetTimer& other) const {
+    return deadline < other.deadline;
+  }
+};
+
+struct LaterDeadline {
+  bool operator()(const HeapTimer& lhs, const HeapTimer& rhs) const {
+    return lhs.deadline > rhs.deadline;
+  }
+};
+
+template <typename Timer, size_t kSize>
+void SetDeadlines(std::array<Timer, kSize>& timers) {
+  for (size_t i = 0; i < kSize; ++i) {
+    timers[i].deadline = Deadline(i);
+  }
+}
+
+std::array<ListTimer, kItems> list_timers;
+std::array<HeapTimer, kItems> heap_timers;
+std::array<SetTimer, kItems> set_timers;
+
+volatile uint32_t sink;
+
+// Inserts every timer in order, then expires them earliest first.
+void SortedListTest(perf_test::State& state) {
+  SetDeadlines(list_timers);
+  IntrusiveList<ListTimer> list;
+  while (state.KeepRunning()) {
+    for (ListTimer& timer : list_timers) {
+      auto prev = list.before_begin();
+      for (auto it = list.begin();
+           it != list.end() && it->deadline <= timer.deadline;
+           ++it) {
+        prev = it;
+      }
+      list.insert_after(prev, timer);
+    }
+    uint32_t last = 0;
+    while (!list.empty()) {
+      last = list.front().deadline;
+      list.pop_front();
+    }
+    sink = last;
+  }
+}
+
+void HeapTest(perf_test::State& state) {
+  SetDeadlines(heap_timers);
+  IntrusiveHeap<HeapTimer, LaterDeadline> heap;
+  while (state.KeepRunning()) {
+    for (HeapTimer& timer : heap_timers) {
+      heap.push(timer);
+    }
+    uint32_t last = 0;
+    while (!heap.empty()) {
+      last = heap.top().deadline;
+      heap.pop();
+    }
+    sink = last;
+  }
+}
+
+void SetTest(perf_test::State& state) {
+  SetDeadlines(set_timers);
+  IntrusiveSet<SetTimer> set;
+  while (state.KeepRunning()) {
+    for (SetTimer& timer : set_timers) {
+      set.insert(timer);
+    }
+    uint32_t last = 0;
+    while (!set.empty()) {
+      last = set.begin()->deadline;
+      set.erase(set.begin());
+    }
+    sink = last;
+  }
+}
+
+// Cancels timers in the middle of the queue, as when requests complete early.
+void SortedListCancelTest(perf_test::State& state) {
+  SetDeadlines(list_timers);
+  IntrusiveList<ListTimer> list;
+  while (state.KeepRunning()) {
+    for (ListTimer& timer : list_timers) {
+      list.push_front(timer);
+    }
+    for (ListTimer& timer : list_timers) {
+      list.remove(timer);
+    }
+  }
+}
+
+void HeapCancelTest(perf_test::State& state) {
+  SetDeadlines(heap_timers);
+  IntrusiveHeap<HeapTimer, LaterDeadline> heap;
+  while (state.KeepRunning()) {
+    for (HeapTimer& timer : heap_timers) {
+      heap.push(timer);
+    }
+    for (HeapTimer& timer : heap_timers) {
+      heap.remove(timer);
+    }
+  }
+}
+
+PW_PERF_TEST(SortedIntrusiveListOrdering, SortedListTest);
+PW_PERF_TEST(IntrusiveHeapOrdering, HeapTest);
+PW_PERF_TEST(IntrusiveSetOrdering, SetTest);
+
+PW_PERF_TEST(SortedIntrusiveListCancel, SortedListCancelTest);
+PW_PERF_TEST(IntrusiveHeapCancel, HeapCancelTest);
+
+}  // namespace
+}  // namespace pw::containers
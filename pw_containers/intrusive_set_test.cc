@@ -0,0 +1,247 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_set.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "gtest/gtest.h"
+#include "pw_compilation_testing/negative_compilation.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public IntrusiveSet<TestItem>::Item {
+ public:
+  TestItem() : number_(0) {}
+  TestItem(int number) : number_(number) {}
+
+  int GetNumber() const { return number_; }
+  void SetNumber(int number) { number_ = number; }
+
+  bool operator<(const TestItem& other) const {
+    return number_ < other.number_;
+  }
+  bool operator>(const TestItem& other) const {
+    return number_ > other.number_;
+  }
+
+ private:
+  int number_;
+};
+
+// Numbers items with a fixed permutation of 0 to N - 1.
+template <size_t kSize>
+void Shuffle(std::array<TestItem, kSize>& items) {
+  static_assert(kSize % 7 != 0);
+  for (size_t i = 0; i < kSize; ++i) {
+    items[i].SetNumber(static_cast<int>((i * 7) % kSize));
+  }
+}
+
+TEST(IntrusiveSet, Empty) {
+  IntrusiveSet<TestItem> set;
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(0u, set.size());
+  EXPECT_EQ(set.begin(), set.end());
+  EXPECT_EQ(set.rbegin(), set.rend());
+}
+
+TEST(IntrusiveSet, Construct_InitializerList) {
+  TestItem two(2);
+  TestItem one(1);
+  TestItem three(3);
+  IntrusiveSet<TestItem> set({&two, &one, &three});
+
+  auto it = set.begin();
+  EXPECT_EQ(&one, &(*it++));
+  EXPECT_EQ(&two, &(*it++));
+  EXPECT_EQ(&three, &(*it++));
+  EXPECT_EQ(set.end(), it);
+  set.clear();
+}
+
+TEST(IntrusiveSet, InsertIteratesInOrder) {
+  std::array<TestItem, 50> items;
+  Shuffle(items);
+  IntrusiveSet<TestItem> set(items.begin(), items.end());
+  EXPECT_EQ(50u, set.size());
+
+  int expected = 0;
+  for (const TestItem& item : set) {
+    EXPECT_EQ(expected++, item.GetNumber());
+  }
+  EXPECT_EQ(50, expected);
+
+  for (auto it = set.rbegin(); it != set.rend(); ++it) {
+    EXPECT_EQ(--expected, it->GetNumber());
+  }
+  EXPECT_EQ(0, expected);
+}
+
+TEST(IntrusiveSet, Insert_Duplicate) {
+  TestItem item(1);
+  TestItem duplicate(1);
+  IntrusiveSet<TestItem> set;
+
+  auto result = set.insert(item);
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(&item, &(*result.first));
+
+  result = set.insert(duplicate);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(&item, &(*result.first));
+  EXPECT_TRUE(duplicate.unlisted());
+  EXPECT_EQ(1u, set.size());
+  set.clear();
+}
+
+TEST(IntrusiveSet, FindAndBounds) {
+  std::array<TestItem, 5> items{{{10}, {20}, {30}, {40}, {50}}};
+  const IntrusiveSet<TestItem> set(items.begin(), items.end());
+
+  EXPECT_EQ(&items[2], &(*set.find(TestItem(30))));
+  EXPECT_EQ(set.end(), set.find(TestItem(35)));
+  EXPECT_EQ(1u, set.count(TestItem(50)));
+  EXPECT_EQ(0u, set.count(TestItem(55)));
+
+  EXPECT_EQ(&items[2], &(*set.lower_bound(TestItem(30))));
+  EXPECT_EQ(&items[3], &(*set.lower_bound(TestItem(31))));
+  EXPECT_EQ(&items[0], &(*set.lower_bound(TestItem(0))));
+  EXPECT_EQ(set.end(), set.lower_bound(TestItem(51)));
+
+  EXPECT_EQ(&items[3], &(*set.upper_bound(TestItem(30))));
+  EXPECT_EQ(set.end(), set.upper_bound(TestItem(50)));
+}
+
+TEST(IntrusiveSet, Erase) {
+  std::array<TestItem, 20> items;
+  Shuffle(items);
+  IntrusiveSet<TestItem> set(items.begin(), items.end());
+
+  // Erase by iterator, by key, from the ends, and from the middle.
+  auto it = set.erase(set.begin());
+  EXPECT_EQ(1, it->GetNumber());
+  EXPECT_EQ(set.end(), set.erase(--set.end()));
+  EXPECT_EQ(1u, set.erase(TestItem(10)));
+  EXPECT_EQ(0u, set.erase(TestItem(10)));
+  EXPECT_EQ(17u, set.size());
+
+  int expected = 1;
+  for (const TestItem& item : set) {
+    if (expected == 10) {
+      ++expected;
+    }
+    EXPECT_EQ(expected++, item.GetNumber());
+  }
+  EXPECT_EQ(19, expected);
+
+  for (const TestItem& item : items) {
+    const int number = item.GetNumber();
+    EXPECT_EQ(number == 0 || number == 10 || number == 19, item.unlisted());
+  }
+}
+
+TEST(IntrusiveSet, CustomCompare) {
+  std::array<TestItem, 10> items;
+  Shuffle(items);
+  IntrusiveSet<TestItem, std::greater<TestItem>> set(items.begin(),
+                                                      items.end());
+  int expected = 9;
+  for (const TestItem& item : set) {
+    EXPECT_EQ(expected--, item.GetNumber());
+  }
+  EXPECT_EQ(-1, expected);
+}
+
+TEST(IntrusiveSet, DestroyingSetRemovesItems) {
+  std::array<TestItem, 10> items;
+  Shuffle(items);
+  {
+    IntrusiveSet<TestItem> set(items.begin(), items.end());
+  }
+  for (const TestItem& item : items) {
+    EXPECT_TRUE(item.unlisted());
+  }
+}
+
+TEST(IntrusiveSet, InsertAndEraseMany) {
+  // Mix insertions and removals to exercise all of the rebalancing cases.
+  constexpr size_t kItems = 127;
+  std::array<TestItem, kItems> items;
+  for (size_t i = 0; i < kItems; ++i) {
+    items[i].SetNumber(static_cast<int>(i));
+  }
+  IntrusiveSet<TestItem> set;
+
+  uint32_t state = 1;
+  auto next_index = [&state]() {
+    state = state * 1664525u + 1013904223u;
+    return (state >> 8) % kItems;
+  };
+
+  for (int round = 0; round < 2000; ++round) {
+    TestItem& item = items[next_index()];
+    if (item.unlisted()) {
+      EXPECT_TRUE(set.insert(item).second);
+    } else {
+      EXPECT_EQ(1u, set.erase(item));
+    }
+
+    size_t listed = 0;
+    for (const TestItem& i : items) {
+      listed += i.unlisted() ? 0 : 1;
+    }
+    ASSERT_EQ(listed, set.size());
+
+    int previous = -1;
+    size_t count = 0;
+    for (const TestItem& i : set) {
+      ASSERT_LT(previous, i.GetNumber());
+      ASSERT_FALSE(i.unlisted());
+      previous = i.GetNumber();
+      ++count;
+    }
+    ASSERT_EQ(listed, count);
+  }
+  set.clear();
+}
+
+#if PW_NC_TEST(IncompatibileItemType)
+PW_NC_EXPECT("IntrusiveSet and IntrusiveMap items must be derived from");
+
+struct Foo {
+  bool operator<(const Foo&) const { return false; }
+};
+
+class BadItem : public IntrusiveSet<Foo>::Item {};
+
+[[maybe_unused]] IntrusiveSet<BadItem> derived_from_incompatible_item_type;
+
+#elif PW_NC_TEST(DoesNotInheritFromItem)
+PW_NC_EXPECT("IntrusiveSet and IntrusiveMap items must be derived from");
+
+struct NotAnItem {
+  bool operator<(const NotAnItem&) const { return false; }
+};
+
+[[maybe_unused]] IntrusiveSet<NotAnItem> set;
+
+#endif  // PW_NC_TEST
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,311 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/internal/intrusive_tree_impl.h"
+
+#include <utility>
+
+#include "pw_assert/check.h"
+
+namespace pw::intrusive_tree_impl {
+
+Item::~Item() {
+  // The sentinel, which has no parent, is never in a tree.
+  PW_CHECK(unlisted() || parent_ == nullptr,
+           "A pw::IntrusiveSet or pw::IntrusiveMap item must be removed "
+           "before it is destroyed");
+}
+
+Item* Item::next() const {
+  const Item* item = this;
+  if (item->right_ != nullptr) {
+    item = item->right_;
+    while (item->left_ != nullptr) {
+      item = item->left_;
+    }
+    return const_cast<Item*>(item);
+  }
+  // Climb until coming up from a left child. The root is the sentinel's left
+  // child, so this stops at the sentinel after the last item.
+  Item* parent = item->parent_;
+  while (parent->right_ == item) {
+    item = parent;
+    parent = parent->parent_;
+  }
+  return parent;
+}
+
+Item* Item::previous() const {
+  const Item* item = this;
+  if (item->parent_ == nullptr) {
+    // This is the sentinel. Its predecessor is the last item.
+    item = item->left_;
+    while (item->right_ != nullptr) {
+      item = item->right_;
+    }
+    return const_cast<Item*>(item);
+  }
+  if (item->left_ != nullptr) {
+    item = item->left_;
+    while (item->right_ != nullptr) {
+      item = item->right_;
+    }
+    return const_cast<Item*>(item);
+  }
+  Item* parent = item->parent_;
+  while (parent->left_ == item) {
+    item = parent;
+    parent = parent->parent_;
+  }
+  return parent;
+}
+
+Item* Tree::begin() const {
+  Item* item = root();
+  if (item == nullptr) {
+    return end();
+  }
+  while (item->left_ != nullptr) {
+    item = item->left_;
+  }
+  return item;
+}
+
+void Tree::InsertAt(Item* parent, bool left, Item& item) {
+  PW_CHECK(item.unlisted(),
+           "Cannot add an item to a pw::IntrusiveSet or pw::IntrusiveMap that "
+           "is already in one");
+  item.parent_ = parent;
+  item.left_ = nullptr;
+  item.right_ = nullptr;
+  item.red_ = true;
+  if (left) {
+    parent->left_ = &item;
+  } else {
+    parent->right_ = &item;
+  }
+  size_ += 1;
+
+  // Restore the red-black properties. Only a red item with a red parent can
+  // violate them. Since the root is black, a red parent always has a parent.
+  Item* current = &item;
+  while (current != root() && current->parent_->red_) {
+    Item* current_parent = current->parent_;
+    Item* grandparent = current_parent->parent_;
+    if (current_parent == grandparent->left_) {
+      Item* uncle = grandparent->right_;
+      if (IsRed(uncle)) {
+        current_parent->red_ = false;
+        uncle->red_ = false;
+        grandparent->red_ = true;
+        current = grandparent;
+        continue;
+      }
+      if (current == current_parent->right_) {
+        RotateLeft(current_parent);
+        current = current_parent;
+        current_parent = current->parent_;
+      }
+      current_parent->red_ = false;
+      grandparent->red_ = true;
+      RotateRight(grandparent);
+    } else {
+      Item* uncle = grandparent->left_;
+      if (IsRed(uncle)) {
+        current_parent->red_ = false;
+        uncle->red_ = false;
+        grandparent->red_ = true;
+        current = grandparent;
+        continue;
+      }
+      if (current == current_parent->left_) {
+        RotateRight(current_parent);
+        current = current_parent;
+        current_parent = current->parent_;
+      }
+      current_parent->red_ = false;
+      grandparent->red_ = true;
+      RotateLeft(grandparent);
+    }
+  }
+  root()->red_ = false;
+}
+
+void Tree::erase(Item& item) {
+  // `removed` is the item whose position is unlinked: `item` itself if it has
+  // at most one child, or otherwise its successor, which takes its place.
+  // `child` replaces `removed`, and may be null, so its parent is tracked too.
+  Item* removed = &item;
+  Item* child;
+  Item* child_parent;
+  if (removed->left_ == nullptr) {
+    child = removed->right_;
+  } else if (removed->right_ == nullptr) {
+    child = removed->left_;
+  } else {
+    removed = removed->right_;
+    while (removed->left_ != nullptr) {
+      removed = removed->left_;
+    }
+    child = removed->right_;
+  }
+
+  if (removed != &item) {
+    // Move the successor into the item's position.
+    item.left_->parent_ = removed;
+    removed->left_ = item.left_;
+    if (removed != item.right_) {
+      child_parent = removed->parent_;
+      if (child != nullptr) {
+        child->parent_ = removed->parent_;
+      }
+      removed->parent_->left_ = child;
+      removed->right_ = item.right_;
+      item.right_->parent_ = removed;
+    } else {
+      child_parent = removed;
+    }
+    ReplaceChild(item.parent_, &item, removed);
+    removed->parent_ = item.parent_;
+    // The successor takes the item's color, so the color that was removed from
+    // the tree is the successor's original one.
+    std::swap(removed->red_, item.red_);
+  } else {
+    child_parent = item.parent_;
+    if (child != nullptr) {
+      child->parent_ = item.parent_;
+    }
+    ReplaceChild(item.parent_, &item, child);
+  }
+
+  // Removing a black position leaves its subtree one black item short. Push
+  // the deficit up the tree until it can be absorbed.
+  if (!item.red_) {
+    while (child != root() && !IsRed(child)) {
+      if (child == child_parent->left_) {
+        Item* sibling = child_parent->right_;
+        if (sibling->red_) {
+          sibling->red_ = false;
+          child_parent->red_ = true;
+          RotateLeft(child_parent);
+          sibling = child_parent->right_;
+        }
+        if (!IsRed(sibling->left_) && !IsRed(sibling->right_)) {
+          sibling->red_ = true;
+          child = child_parent;
+          child_parent = child_parent->parent_;
+        } else {
+          if (!IsRed(sibling->right_)) {
+            sibling->left_->red_ = false;
+            sibling->red_ = true;
+            RotateRight(sibling);
+            sibling = child_parent->right_;
+          }
+          sibling->red_ = child_parent->red_;
+          child_parent->red_ = false;
+          if (sibling->right_ != nullptr) {
+            sibling->right_->red_ = false;
+          }
+          RotateLeft(child_parent);
+          break;
+        }
+      } else {
+        Item* sibling = child_parent->left_;
+        if (sibling->red_) {
+          sibling->red_ = false;
+          child_parent->red_ = true;
+          RotateRight(child_parent);
+          sibling = child_parent->left_;
+        }
+        if (!IsRed(sibling->left_) && !IsRed(sibling->right_)) {
+          sibling->red_ = true;
+          child = child_parent;
+          child_parent = child_parent->parent_;
+        } else {
+          if (!IsRed(sibling->left_)) {
+            sibling->right_->red_ = false;
+            sibling->red_ = true;
+            RotateLeft(sibling);
+            sibling = child_parent->left_;
+          }
+          sibling->red_ = child_parent->red_;
+          child_parent->red_ = false;
+          if (sibling->left_ != nullptr) {
+            sibling->left_->red_ = false;
+          }
+          RotateRight(child_parent);
+          break;
+        }
+      }
+    }
+    if (child != nullptr) {
+      child->red_ = false;
+    }
+  }
+
+  item.Reset();
+  size_ -= 1;
+}
+
+void Tree::clear() {
+  // Unlink items bottom up, so each item is visited once.
+  Item* item = root();
+  while (item != nullptr && item != &sentinel_) {
+    if (item->left_ != nullptr) {
+      item = item->left_;
+    } else if (item->right_ != nullptr) {
+      item = item->right_;
+    } else {
+      Item* parent = item->parent_;
+      ReplaceChild(parent, item, nullptr);
+      item->Reset();
+      item = parent;
+    }
+  }
+  size_ = 0;
+}
+
+void Tree::RotateLeft(Item* item) {
+  Item* pivot = item->right_;
+  item->right_ = pivot->left_;
+  if (pivot->left_ != nullptr) {
+    pivot->left_->parent_ = item;
+  }
+  pivot->parent_ = item->parent_;
+  ReplaceChild(item->parent_, item, pivot);
+  pivot->left_ = item;
+  item->parent_ = pivot;
+}
+
+void Tree::RotateRight(Item* item) {
+  Item* pivot = item->left_;
+  item->left_ = pivot->right_;
+  if (pivot->right_ != nullptr) {
+    pivot->right_->parent_ = item;
+  }
+  pivot->parent_ = item->parent_;
+  ReplaceChild(item->parent_, item, pivot);
+  pivot->right_ = item;
+  item->parent_ = pivot;
+}
+
+void Tree::ReplaceChild(Item* parent, Item* old_child, Item* new_child) {
+  if (parent->left_ == old_child) {
+    parent->left_ = new_child;
+  } else {
+    parent->right_ = new_child;
+  }
+}
+
+}  // namespace pw::intrusive_tree_impl
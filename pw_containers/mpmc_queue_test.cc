@@ -0,0 +1,114 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/mpmc_queue.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_containers_private/test_helpers.h"
+
+namespace pw::containers {
+namespace {
+
+using test::Counter;
+using test::MoveOnly;
+
+TEST(MpmcQueue, Empty) {
+  MpmcQueue<int, 4> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.size(), 0u);
+  EXPECT_EQ(queue.max_size(), 4u);
+  EXPECT_EQ(queue.try_pop(), std::nullopt);
+}
+
+TEST(MpmcQueue, PushAndPopInOrder) {
+  MpmcQueue<uint32_t, 4> queue;
+  EXPECT_TRUE(queue.try_push(1));
+  EXPECT_TRUE(queue.try_push(2));
+  EXPECT_TRUE(queue.try_emplace(3u));
+  EXPECT_FALSE(queue.empty());
+  EXPECT_EQ(queue.size(), 3u);
+
+  EXPECT_EQ(queue.try_pop(), 1u);
+  EXPECT_EQ(queue.try_pop(), 2u);
+  EXPECT_EQ(queue.try_pop(), 3u);
+  EXPECT_EQ(queue.try_pop(), std::nullopt);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpmcQueue, Full) {
+  MpmcQueue<int, 4> queue;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.try_push(i));
+  }
+  EXPECT_FALSE(queue.try_push(4));
+  EXPECT_EQ(queue.size(), 4u);
+
+  EXPECT_EQ(queue.try_pop(), 0);
+  EXPECT_TRUE(queue.try_push(4));
+  EXPECT_FALSE(queue.try_push(5));
+}
+
+TEST(MpmcQueue, WrapsAround) {
+  MpmcQueue<uint32_t, 4> queue;
+  uint32_t pushed = 0;
+  uint32_t popped = 0;
+  for (int round = 0; round < 50; ++round) {
+    // Push and pop different numbers of items so that the queue's start moves
+    // through every slot.
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(queue.try_push(pushed++));
+    }
+    for (int i = 0; i < 2; ++i) {
+      ASSERT_EQ(queue.try_pop(), popped++);
+    }
+    while (queue.size() > 1u) {
+      ASSERT_EQ(queue.try_pop(), popped++);
+    }
+  }
+  EXPECT_EQ(queue.try_pop(), popped++);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpmcQueue, MoveOnlyItems) {
+  MpmcQueue<MoveOnly, 2> queue;
+  EXPECT_TRUE(queue.try_emplace(7));
+  EXPECT_TRUE(queue.try_push(MoveOnly(8)));
+
+  std::optional<MoveOnly> first = queue.try_pop();
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(first->value, 7);
+  std::optional<MoveOnly> second = queue.try_pop();
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(second->value, 8);
+}
+
+TEST(MpmcQueue, DestroysRemainingItems) {
+  Counter::Reset();
+  {
+    MpmcQueue<Counter, 4> queue;
+    for (int i = 0; i < 4; ++i) {
+      queue.try_emplace(i);
+    }
+    EXPECT_EQ(Counter::created, 4);
+    EXPECT_EQ(queue.try_pop()->value, 0);
+  }
+  EXPECT_EQ(Counter::created + Counter::moved, Counter::destroyed);
+}
+
+}  // namespace
+}  // namespace pw::containers
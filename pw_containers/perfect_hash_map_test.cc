@@ -0,0 +1,125 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/perfect_hash_map.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+namespace pw::containers {
+namespace {
+
+constexpr auto kRegisters = MakePerfectHashMap<uint16_t, std::string_view>({
+    {0x0010, "CTRL"},
+    {0x0014, "STATUS"},
+    {0x0100, "FIFO"},
+    {0x0004, "ID"},
+    {0xfff0, "DEBUG"},
+});
+
+static_assert(kRegisters.size() == 5);
+static_assert(kRegisters.at(0x0014) == "STATUS");
+static_assert(kRegisters.contains(0xfff0));
+static_assert(!kRegisters.contains(0x0011));
+
+enum class Command : uint8_t {
+  kReset = 1,
+  kRead = 2,
+  kWrite = 3,
+  kErase = 0x80,
+};
+
+constexpr auto kCommandNames = MakePerfectHashMap<Command, std::string_view>({
+    {Command::kErase, "erase"},
+    {Command::kRead, "read"},
+    {Command::kReset, "reset"},
+    {Command::kWrite, "write"},
+});
+
+// A larger table, built at compile time from computed keys.
+constexpr size_t kLargeSize = 200;
+
+constexpr std::array<Pair<int32_t, int32_t>, kLargeSize> LargeItems() {
+  std::array<Pair<int32_t, int32_t>, kLargeSize> items{};
+  for (size_t i = 0; i < kLargeSize; ++i) {
+    const auto key = static_cast<int32_t>(i * i * 7919) - 100000;
+    items[i] = {key, static_cast<int32_t>(i)};
+  }
+  return items;
+}
+
+constexpr PerfectHashMap<int32_t, int32_t, kLargeSize> kLarge(LargeItems());
+
+TEST(PerfectHashMap, Find) {
+  auto it = kRegisters.find(0x0100);
+  ASSERT_NE(it, kRegisters.end());
+  EXPECT_EQ(it->first, 0x0100);
+  EXPECT_EQ(it->second, "FIFO");
+
+  EXPECT_EQ(kRegisters.find(0x0101), kRegisters.end());
+  EXPECT_EQ(kRegisters.find(0), kRegisters.end());
+}
+
+TEST(PerfectHashMap, At) {
+  EXPECT_EQ(kRegisters.at(0x0010), "CTRL");
+  EXPECT_EQ(kRegisters.at(0x0004), "ID");
+  EXPECT_EQ(kRegisters.at(0xfff0), "DEBUG");
+}
+
+TEST(PerfectHashMap, EnumKeys) {
+  EXPECT_EQ(kCommandNames.at(Command::kReset), "reset");
+  EXPECT_EQ(kCommandNames.at(Command::kErase), "erase");
+  EXPECT_FALSE(kCommandNames.contains(static_cast<Command>(4)));
+}
+
+TEST(PerfectHashMap, IterateVisitsEveryEntryOnce) {
+  std::array<bool, kLargeSize> seen{};
+  for (const auto& item : kLarge) {
+    ASSERT_GE(item.second, 0);
+    ASSERT_LT(static_cast<size_t>(item.second), kLargeSize);
+    EXPECT_FALSE(seen[static_cast<size_t>(item.second)]);
+    seen[static_cast<size_t>(item.second)] = true;
+  }
+}
+
+TEST(PerfectHashMap, LargeMap) {
+  constexpr auto kItems = LargeItems();
+  for (const auto& item : kItems) {
+    ASSERT_TRUE(kLarge.contains(item.first));
+    EXPECT_EQ(kLarge.at(item.first), item.second);
+    EXPECT_FALSE(kLarge.contains(item.first + 1));
+  }
+}
+
+TEST(PerfectHashMap, BuiltAtRunTime) {
+  std::array<Pair<uint32_t, char>, 3> items = {{{7, 'a'}, {70, 'b'}, {1, 'c'}}};
+  const PerfectHashMap<uint32_t, char, 3> map(items);
+  EXPECT_EQ(map.at(7), 'a');
+  EXPECT_EQ(map.at(70), 'b');
+  EXPECT_EQ(map.at(1), 'c');
+  EXPECT_FALSE(map.contains(0));
+}
+
+TEST(PerfectHashMap, SingleEntry) {
+  constexpr auto kSingle = MakePerfectHashMap<int, int>({{42, 1}});
+  EXPECT_EQ(kSingle.at(42), 1);
+  EXPECT_FALSE(kSingle.contains(0));
+}
+
+}  // namespace
+}  // namespace pw::containers
@@ -0,0 +1,671 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pw_assert/assert.h"
+#include "pw_containers/vector.h"
+
+namespace pw {
+namespace dynamic_vector_impl {
+
+// Refers to a heap of any type with the pw_allocator heap interface:
+// `void* Allocate(size_t)` and `void Free(void*)`, such as
+// `pw::allocator::FreeListHeapBuffer` or `pw::allocator::InstrumentedHeap`.
+class HeapRef {
+ public:
+  template <typename Heap,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::remove_const_t<Heap>, HeapRef>>>
+  explicit constexpr HeapRef(Heap& heap)
+      : heap_(&heap), allocate_(&Allocate<Heap>), free_(&Free<Heap>) {}
+
+  void* Allocate(size_t size) const { return allocate_(heap_, size); }
+  void Free(void* ptr) const { free_(heap_, ptr); }
+
+ private:
+  template <typename Heap>
+  static void* Allocate(void* heap, size_t size) {
+    return static_cast<Heap*>(heap)->Allocate(size);
+  }
+
+  template <typename Heap>
+  static void Free(void* heap, void* ptr) {
+    static_cast<Heap*>(heap)->Free(ptr);
+  }
+
+  void* heap_;
+  void* (*allocate_)(void*, size_t);
+  void (*free_)(void*, void*);
+};
+
+// Heaps are accepted by type so that DynamicVector constructors do not hide
+// the copy constructor.
+template <typename Heap, typename = void>
+struct IsHeap : std::false_type {};
+
+template <typename Heap>
+struct IsHeap<
+    Heap,
+    std::void_t<decltype(std::declval<Heap&>().Allocate(size_t{}))>>
+    : std::true_type {};
+
+template <typename Heap>
+using EnableIfHeap = std::enable_if_t<IsHeap<Heap>::value>;
+
+}  // namespace dynamic_vector_impl
+
+// DynamicVector is a vector that stores up to kInlineCapacity elements in the
+// object itself and moves them to a heap when it needs more room. It has the
+// same interface as pw::Vector, plus reserve() and shrink_to_fit().
+//
+// Like pw::Vector, all DynamicVectors inherit from the generic
+// DynamicVector<T>, so they can be used through a DynamicVector<T> reference
+// without knowing their inline capacity. A DynamicVector is not a
+// pw::Vector<T>: fixed-size vectors always keep their elements in the object,
+// which lets them find their elements without checking where they are.
+//
+// The heap may be any pw_allocator heap, such as FreeListHeapBuffer, or any
+// other type with `void* Allocate(size_t)` and `void Free(void*)` methods. It
+// must outlive the vector. Allocations must be aligned for T.
+//
+// As with std::vector, growing moves the elements, so it invalidates iterators
+// and references to them. Unlike std::vector, an element of the vector must
+// not be passed to insert(), though push_back() and emplace_back() are safe.
+//
+// If the heap is exhausted, adding elements fails in the same way as for a
+// full pw::Vector.
+//
+// Usage:
+//
+//   pw::allocator::FreeListHeapBuffer<> heap(buffer);
+//   pw::DynamicVector<Sample, 16> samples(heap);
+//   CollectSamples(samples);  // Takes a pw::DynamicVector<Sample>&.
+//
+template <typename T, size_t kInlineCapacity = vector_impl::kGeneric>
+class DynamicVector : public DynamicVector<T, vector_impl::kGeneric> {
+ private:
+  using Base = DynamicVector<T, vector_impl::kGeneric>;
+
+ public:
+  using typename Base::value_type;
+  using typename Base::size_type;
+  using typename Base::difference_type;
+  using typename Base::reference;
+  using typename Base::const_reference;
+  using typename Base::pointer;
+  using typename Base::const_pointer;
+  using typename Base::iterator;
+  using typename Base::const_iterator;
+  using typename Base::reverse_iterator;
+  using typename Base::const_reverse_iterator;
+
+  template <typename Heap,
+            typename = dynamic_vector_impl::EnableIfHeap<Heap>>
+  explicit DynamicVector(Heap& heap) noexcept
+      : Base(dynamic_vector_impl::HeapRef(heap), kInlineCapacity) {}
+
+  template <typename Heap,
+            typename = dynamic_vector_impl::EnableIfHeap<Heap>>
+  DynamicVector(Heap& heap, size_type count, const T& value)
+      : DynamicVector(heap) {
+    this->assign(count, value);
+  }
+
+  template <typename Heap,
+            typename = dynamic_vector_impl::EnableIfHeap<Heap>>
+  DynamicVector(Heap& heap, std::initializer_list<T> list)
+      : DynamicVector(heap) {
+    this->assign(list);
+  }
+
+  // Copies use the same heap as the original.
+  DynamicVector(const DynamicVector& other)
+      : Base(other.heap(), kInlineCapacity) {
+    this->assign(other.begin(), other.end());
+  }
+
+  // Moves take over the other vector's heap storage, if it has any, and
+  // otherwise move its elements. The vector then uses the other's heap.
+  DynamicVector(DynamicVector&& other) noexcept
+      : Base(other.heap(), kInlineCapacity) {
+    Base::operator=(std::move(other));
+  }
+
+  DynamicVector& operator=(const DynamicVector& other) {
+    Base::operator=(other);
+    return *this;
+  }
+
+  DynamicVector& operator=(DynamicVector&& other) noexcept {
+    Base::operator=(std::move(other));
+    return *this;
+  }
+
+  DynamicVector& operator=(std::initializer_list<T> list) {
+    this->assign(list);
+    return *this;
+  }
+
+  // All other vector methods are implemented on the DynamicVector<T> base
+  // class.
+
+ private:
+  friend class DynamicVector<T, vector_impl::kGeneric>;
+
+  // Provides access to the inline storage as an array of T.
+  pointer inline_data() { return reinterpret_cast<T*>(&inline_storage_); }
+  const_pointer inline_data() const {
+    return reinterpret_cast<const T*>(&inline_storage_);
+  }
+
+  // As in Vector, elements are constructed in place with placement new, and
+  // the alignas specifier keeps a zero-length array aligned the same as an
+  // array with elements.
+  alignas(T) std::array<std::aligned_storage_t<sizeof(T), alignof(T)>,
+                        kInlineCapacity> inline_storage_;
+};
+
+// Defines the generic DynamicVector<T> specialization, which serves as the base
+// class for DynamicVector<T> of any inline capacity. Except for constructors,
+// all DynamicVector methods are implemented on this class.
+template <typename T>
+class DynamicVector<T, vector_impl::kGeneric> {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  // A DynamicVector<T> cannot be constructed directly. Instead, construct a
+  // DynamicVector<T, kInlineCapacity>.
+
+  ~DynamicVector() {
+    clear();
+    Release();
+  }
+
+  // Assign
+
+  DynamicVector& operator=(const DynamicVector& other) {
+    assign(other.begin(), other.end());
+    return *this;
+  }
+
+  DynamicVector& operator=(DynamicVector&& other) noexcept;
+
+  DynamicVector& operator=(std::initializer_list<T> list) {
+    assign(list);
+    return *this;
+  }
+
+  void assign(size_type count, const T& value) {
+    clear();
+    resize(count, value);
+  }
+
+  template <
+      typename Iterator,
+      typename...,
+      typename = std::enable_if_t<vector_impl::IsIterator<Iterator>::value>>
+  void assign(Iterator first, Iterator last) {
+    clear();
+    insert(end(), first, last);
+  }
+
+  void assign(std::initializer_list<T> list) {
+    assign(list.begin(), list.end());
+  }
+
+  // Access
+
+  reference at(size_type index) {
+    PW_ASSERT(index < size());
+    return data()[index];
+  }
+  const_reference at(size_type index) const {
+    PW_ASSERT(index < size());
+    return data()[index];
+  }
+
+  reference operator[](size_type index) {
+    PW_DASSERT(index < size());
+    return data()[index];
+  }
+  const_reference operator[](size_type index) const {
+    PW_DASSERT(index < size());
+    return data()[index];
+  }
+
+  reference front() { return data()[0]; }
+  const_reference front() const { return data()[0]; }
+
+  reference back() { return data()[size() - 1]; }
+  const_reference back() const { return data()[size() - 1]; }
+
+  T* data() noexcept { return data_; }
+  const T* data() const noexcept { return data_; }
+
+  // Iterate
+
+  iterator begin() noexcept { return data(); }
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator cbegin() const noexcept { return data(); }
+
+  iterator end() noexcept { return data() + size(); }
+  const_iterator end() const noexcept { return data() + size(); }
+  const_iterator cend() const noexcept { return data() + size(); }
+
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const { return reverse_iterator(end()); }
+  const_reverse_iterator crbegin() const noexcept {
+    return reverse_iterator(cend());
+  }
+
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const { return reverse_iterator(begin()); }
+  const_reverse_iterator crend() const noexcept {
+    return reverse_iterator(cbegin());
+  }
+
+  // Size
+
+  [[nodiscard]] bool empty() const noexcept { return size() == 0u; }
+
+  // True if the vector cannot hold more elements without growing.
+  [[nodiscard]] bool full() const noexcept { return size() == capacity(); }
+
+  size_t size() const noexcept { return size_; }
+
+  size_t max_size() const noexcept {
+    return std::numeric_limits<size_t>::max() / sizeof(T);
+  }
+
+  // Returns the number of elements the vector can hold without growing.
+  size_t capacity() const noexcept { return capacity_; }
+
+  // Ensures there is room for at least new_capacity elements, so that adding
+  // up to that many does not allocate. Returns false if the memory could not
+  // be allocated.
+  bool reserve(size_t new_capacity) {
+    return new_capacity <= capacity() ||
+           (new_capacity <= max_size() && Reallocate(new_capacity));
+  }
+
+  // Frees unused heap storage, moving the elements back into the object if
+  // they fit.
+  void shrink_to_fit() {
+    if (on_heap() && size() < capacity()) {
+      static_cast<void>(Reallocate(size()));
+    }
+  }
+
+  // Returns whether the elements are stored on the heap.
+  bool on_heap() const { return data() != inline_data(); }
+
+  // Modify
+
+  void clear() noexcept {
+    std::destroy(begin(), end());
+    size_ = 0;
+  }
+
+  iterator insert(const_iterator index, size_type count, const T& value);
+
+  iterator insert(const_iterator index, const T& value) {
+    return insert(index, 1, value);
+  }
+
+  iterator insert(const_iterator index, T&& value) {
+    return emplace(index, std::move(value));
+  }
+
+  template <
+      typename Iterator,
+      int&... ExplicitArgumentBarrier,
+      typename = std::enable_if_t<vector_impl::IsIterator<Iterator>::value>>
+  iterator insert(const_iterator index, Iterator first, Iterator last) {
+    return InsertFrom(index, first, last);
+  }
+
+  iterator insert(const_iterator index, std::initializer_list<T> list) {
+    return insert(index, list.begin(), list.end());
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator index, Args&&... args);
+
+  iterator erase(const_iterator first, const_iterator last);
+
+  iterator erase(const_iterator index) { return erase(index, index + 1); }
+
+  void push_back(const T& value) { emplace_back(value); }
+
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args);
+
+  void pop_back() {
+    if (!empty()) {
+      std::destroy_at(&back());
+      size_ -= 1;
+    }
+  }
+
+  void resize(size_t new_size) { resize(new_size, T()); }
+
+  void resize(size_t new_size, const T& value);
+
+ protected:
+  DynamicVector(dynamic_vector_impl::HeapRef heap,
+                size_t inline_capacity) noexcept
+      : heap_(heap),
+        data_(inline_data()),
+        size_(0),
+        capacity_(inline_capacity),
+        inline_capacity_(inline_capacity) {}
+
+  const dynamic_vector_impl::HeapRef& heap() const { return heap_; }
+
+ private:
+  // The inline storage is not part of the generic vector class. As in Vector,
+  // it is found by down-casting to a DynamicVector with a known capacity, since
+  // it starts at the same offset for every capacity.
+  T* inline_data() {
+    return static_cast<DynamicVector<T, 0>*>(this)->inline_data();
+  }
+  const T* inline_data() const {
+    return static_cast<const DynamicVector<T, 0>*>(this)->inline_data();
+  }
+
+  // Returns whether count more elements fit, growing the vector if needed and
+  // possible.
+  bool HasRoomFor(size_t count);
+
+  // Moves the elements to storage for new_capacity elements, which is inline
+  // if they fit. Returns false and leaves the vector unchanged if the storage
+  // could not be allocated.
+  bool Reallocate(size_t new_capacity);
+
+  // Frees the heap storage of an empty vector.
+  void Release();
+
+  template <typename Iterator>
+  iterator InsertFrom(const_iterator index, Iterator first, Iterator last);
+
+  // Moves the elements from index on back by count, leaving count
+  // uninitialized elements at index, and returns a pointer to them. Returns
+  // nullptr if the vector cannot grow to fit them.
+  T* MakeRoom(const_iterator index, size_t count);
+
+  dynamic_vector_impl::HeapRef heap_;
+  T* data_;
+  size_t size_;
+  size_t capacity_;
+  const size_t inline_capacity_;
+};
+
+// Compare
+
+template <typename T, size_t kLhsSize, size_t kRhsSize>
+bool operator==(const DynamicVector<T, kLhsSize>& lhs,
+                const DynamicVector<T, kRhsSize>& rhs) {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, size_t kLhsSize, size_t kRhsSize>
+bool operator!=(const DynamicVector<T, kLhsSize>& lhs,
+                const DynamicVector<T, kRhsSize>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, size_t kLhsSize, size_t kRhsSize>
+bool operator<(const DynamicVector<T, kLhsSize>& lhs,
+               const DynamicVector<T, kRhsSize>& rhs) {
+  return std::lexicographical_compare(
+      lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, size_t kLhsSize, size_t kRhsSize>
+bool operator<=(const DynamicVector<T, kLhsSize>& lhs,
+                const DynamicVector<T, kRhsSize>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, size_t kLhsSize, size_t kRhsSize>
+bool operator>(const DynamicVector<T, kLhsSize>& lhs,
+               const DynamicVector<T, kRhsSize>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, size_t kLhsSize, size_t kRhsSize>
+bool operator>=(const DynamicVector<T, kLhsSize>& lhs,
+                const DynamicVector<T, kRhsSize>& rhs) {
+  return !(lhs < rhs);
+}
+
+// Function implementations
+
+template <typename T>
+DynamicVector<T>& DynamicVector<T, vector_impl::kGeneric>::operator=(
+    DynamicVector&& other) noexcept {
+  clear();
+  Release();
+  heap_ = other.heap_;
+
+  if (other.on_heap()) {
+    data_ = other.data_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    other.data_ = other.inline_data();
+    other.size_ = 0;
+    other.capacity_ = other.inline_capacity_;
+  } else {
+    for (auto&& item : other) {
+      emplace_back(std::move(item));
+    }
+    other.clear();
+  }
+  return *this;
+}
+
+template <typename T>
+typename DynamicVector<T>::iterator DynamicVector<T>::insert(
+    const_iterator index, size_type count, const T& value) {
+  T* insertion_point = MakeRoom(index, count);
+  if (insertion_point == nullptr) {
+    return end();
+  }
+  std::uninitialized_fill_n(insertion_point, count, value);
+  size_ += count;
+
+  // Return an iterator pointing to the first element inserted.
+  return insertion_point;
+}
+
+template <typename T>
+template <typename... Args>
+typename DynamicVector<T>::iterator DynamicVector<T>::emplace(
+    const_iterator index, Args&&... args) {
+  // The arguments may refer to an element, which making room would move, so
+  // construct the new element first.
+  T value(std::forward<Args>(args)...);
+  T* insertion_point = MakeRoom(index, 1);
+  if (insertion_point == nullptr) {
+    return end();
+  }
+  new (insertion_point) T(std::move(value));
+  size_ += 1;
+  return insertion_point;
+}
+
+template <typename T>
+typename DynamicVector<T>::iterator DynamicVector<T>::erase(
+    const_iterator first, const_iterator last) {
+  iterator destination = begin() + std::distance(cbegin(), first);
+  iterator source = begin() + std::distance(cbegin(), last);
+  if (first == last) {
+    return source;
+  }
+
+  iterator new_end = std::move(source, end(), destination);
+  std::destroy(new_end, end());
+  size_ = static_cast<size_t>(std::distance(begin(), new_end));
+
+  // Return an iterator following the last removed element.
+  return destination;
+}
+
+template <typename T>
+template <typename... Args>
+void DynamicVector<T, vector_impl::kGeneric>::emplace_back(Args&&... args) {
+  if (size() < capacity()) {
+    new (end()) T(std::forward<Args>(args)...);
+    size_ += 1;
+    return;
+  }
+
+  // The arguments may refer to an element, which growing would move, so
+  // construct the new element first.
+  T value(std::forward<Args>(args)...);
+  if (HasRoomFor(1)) {
+    new (end()) T(std::move(value));
+    size_ += 1;
+  }
+}
+
+template <typename T>
+void DynamicVector<T, vector_impl::kGeneric>::resize(size_t new_size,
+                                                     const T& value) {
+  if (size() < new_size) {
+    // If the vector cannot grow enough, fill the capacity it has.
+    static_cast<void>(HasRoomFor(new_size - size()));
+    new_size = std::min(new_size, capacity());
+    std::uninitialized_fill(end(), begin() + new_size, value);
+    size_ = new_size;
+  } else {
+    while (size() > new_size) {
+      pop_back();
+    }
+  }
+}
+
+template <typename T>
+bool DynamicVector<T, vector_impl::kGeneric>::HasRoomFor(size_t count) {
+  if (count <= capacity() - size()) {
+    return true;
+  }
+  if (count > max_size() - size()) {
+    return false;
+  }
+  // Double the capacity, so adding n elements one at a time moves each element
+  // a constant number of times on average.
+  return Reallocate(std::max(size() + count, capacity() * 2));
+}
+
+template <typename T>
+bool DynamicVector<T, vector_impl::kGeneric>::Reallocate(size_t new_capacity) {
+  T* new_data = inline_data();
+  if (new_capacity > inline_capacity_) {
+    new_data = static_cast<T*>(heap_.Allocate(new_capacity * sizeof(T)));
+    if (new_data == nullptr) {
+      return false;
+    }
+    if (reinterpret_cast<uintptr_t>(new_data) % alignof(T) != 0u) {
+      heap_.Free(new_data);
+      return false;
+    }
+  } else {
+    new_capacity = inline_capacity_;
+  }
+
+  std::uninitialized_move(begin(), end(), new_data);
+  std::destroy(begin(), end());
+  if (on_heap()) {
+    heap_.Free(data_);
+  }
+  data_ = new_data;
+  capacity_ = new_capacity;
+  return true;
+}
+
+template <typename T>
+void DynamicVector<T, vector_impl::kGeneric>::Release() {
+  if (on_heap()) {
+    heap_.Free(data_);
+    data_ = inline_data();
+    capacity_ = inline_capacity_;
+  }
+}
+
+template <typename T>
+template <typename Iterator>
+typename DynamicVector<T>::iterator
+DynamicVector<T, vector_impl::kGeneric>::InsertFrom(const_iterator index,
+                                                    Iterator first,
+                                                    Iterator last) {
+  const auto count = static_cast<size_t>(std::distance(first, last));
+  T* insertion_point = MakeRoom(index, count);
+  if (insertion_point == nullptr) {
+    return end();
+  }
+  std::uninitialized_copy(first, last, insertion_point);
+  size_ += count;
+
+  // Return an iterator pointing to the first element inserted.
+  return insertion_point;
+}
+
+template <typename T>
+T* DynamicVector<T, vector_impl::kGeneric>::MakeRoom(const_iterator index,
+                                                     size_t count) {
+  PW_DASSERT(index >= cbegin());
+  PW_DASSERT(index <= cend());
+
+  const auto offset = std::distance(cbegin(), index);
+  const bool has_room = HasRoomFor(count);
+  PW_DASSERT(has_room);
+  if (!has_room) {
+    return nullptr;
+  }
+
+  T* insertion_point = begin() + offset;
+  for (iterator item = end(); item != insertion_point;) {
+    --item;
+    new (item + count) T(std::move(*item));
+    std::destroy_at(item);
+  }
+  return insertion_point;
+}
+
+}  // namespace pw
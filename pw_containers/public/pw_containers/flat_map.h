@@ -270,4 +270,32 @@ class FlatMap {
   std::array<value_type, kArraySize> items_;
 };
 
+/// Creates a `FlatMap` from a list of key-value pairs, sorting them and
+/// checking that no key appears more than once.
+///
+/// When the result initializes a `constexpr` variable, the sort and the check
+/// happen at compile time, and duplicate keys are a compilation error:
+///
+/// @code{.cpp}
+///   constexpr auto kCommands = pw::containers::MakeFlatMap<uint8_t, Handler>({
+///       {0x10, HandleReset},
+///       {0x02, HandleRead},
+///       {0x03, HandleWrite},
+///   });
+/// @endcode
+///
+/// @pre Keys must be unique.
+template <typename Key, typename Value, size_t kArraySize>
+constexpr FlatMap<Key, Value, kArraySize> MakeFlatMap(
+    const Pair<Key, Value> (&items)[kArraySize]) {
+  std::array<Pair<Key, Value>, kArraySize> array{};
+  for (size_t i = 0; i < kArraySize; ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      PW_ASSERT(items[i].first != items[j].first);  // Keys must be unique.
+    }
+    array[i] = items[i];
+  }
+  return FlatMap<Key, Value, kArraySize>(array);
+}
+
 }  // namespace pw::containers
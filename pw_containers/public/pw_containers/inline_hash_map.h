@@ -0,0 +1,400 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "pw_assert/assert.h"
+#include "pw_containers/internal/raw_storage.h"
+
+namespace pw {
+namespace containers::internal {
+
+// Returns the smallest power of two that is greater than or equal to value.
+constexpr size_t NextPowerOfTwo(size_t value) {
+  size_t power = 1;
+  while (power < value) {
+    power <<= 1;
+  }
+  return power;
+}
+
+// Returns log2 of a power of two.
+constexpr size_t Log2(size_t power_of_two) {
+  size_t log = 0;
+  while (power_of_two > 1) {
+    power_of_two >>= 1;
+    ++log;
+  }
+  return log;
+}
+
+}  // namespace containers::internal
+
+/// The `InlineHashMap` class is similar to the STL's `std::unordered_map`,
+/// except it is backed by a fixed-size buffer and never allocates. Maps must
+/// be declared with an explicit maximum size (e.g.
+/// `InlineHashMap<uint32_t, Route, 32>`).
+///
+/// Entries are stored in an open-addressed table using Robin Hood linear
+/// probing. The table has a power-of-two number of slots and is kept at most
+/// 7/8 full, so lookups, insertions, and removals take a constant number of
+/// probes on average. Erased entries are removed with backward-shift deletion,
+/// so there are no tombstones and performance does not degrade over time.
+///
+/// Unlike `std::unordered_map`:
+///
+/// - Inserting into a full map fails instead of growing. `insert()` and
+///   `try_emplace()` return `{end(), false}`, and `operator[]` asserts.
+/// - Any insertion or erasure may move other entries, invalidating all
+///   iterators, pointers, and references into the map.
+/// - `Hash` and `KeyEqual` must be default-constructible and stateless.
+/// - Keys must be copy-constructible, since entries are relocated within the
+///   table.
+///
+/// The key's hash is scrambled before it is reduced to a slot index, so hashes
+/// that only differ in a few bits, like those `std::hash` returns for integers
+/// and aligned pointers, still spread across the table.
+template <typename Key,
+          typename Value,
+          size_t kCapacity,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class InlineHashMap {
+ private:
+  template <typename MapType, typename ValueType>
+  class Iterator;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = Iterator<InlineHashMap, value_type>;
+  using const_iterator = Iterator<const InlineHashMap, const value_type>;
+
+  constexpr InlineHashMap() noexcept = default;
+
+  InlineHashMap(std::initializer_list<value_type> list) {
+    for (const value_type& item : list) {
+      insert(item);
+    }
+  }
+
+  InlineHashMap(const InlineHashMap& other) { CopyFrom(other); }
+
+  InlineHashMap& operator=(const InlineHashMap& other) {
+    if (&other != this) {
+      clear();
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  ~InlineHashMap() { clear(); }
+
+  // Iterators
+
+  iterator begin() noexcept { return iterator(this, NextOccupied(0)); }
+  const_iterator begin() const noexcept { return cbegin(); }
+  const_iterator cbegin() const noexcept {
+    return const_iterator(this, NextOccupied(0));
+  }
+
+  iterator end() noexcept { return iterator(this, kSlots); }
+  const_iterator end() const noexcept { return cend(); }
+  const_iterator cend() const noexcept { return const_iterator(this, kSlots); }
+
+  // Capacity
+
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0u; }
+  size_type size() const noexcept { return size_; }
+  static constexpr size_type max_size() noexcept { return kCapacity; }
+  [[nodiscard]] bool full() const noexcept { return size_ == kCapacity; }
+
+  // Modifiers
+
+  void clear() noexcept {
+    for (size_t slot = 0; slot < kSlots; ++slot) {
+      if (distances_[slot] != 0) {
+        Slot(slot).~value_type();
+        distances_[slot] = 0;
+      }
+    }
+    size_ = 0;
+  }
+
+  /// Inserts a copy of `value` if its key is not already in the map.
+  ///
+  /// @returns An iterator to the entry with the key, and whether it was
+  /// inserted. If the key is absent and the map is full, returns
+  /// `{end(), false}`.
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  /// Inserts an entry constructed from `args` if `key` is not already in the
+  /// map. If `key` is present, `args` are not used.
+  ///
+  /// @returns An iterator to the entry with the key, and whether it was
+  /// inserted. If the key is absent and the map is full, returns
+  /// `{end(), false}`.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    size_t slot = HomeSlot(key);
+    Distance distance = 1;
+    for (; distances_[slot] >= distance; ++distance) {
+      if (key_equal()(Slot(slot).first, key)) {
+        return {iterator(this, slot), false};
+      }
+      slot = NextSlot(slot);
+    }
+
+    if (full()) {
+      return {end(), false};
+    }
+
+    // `slot` is the first slot that is either empty or holds an entry closer
+    // to its home slot than the new entry would be. Insert the entry there,
+    // moving the rest of the cluster down by one to keep it ordered.
+    ShiftClusterForward(slot);
+    new (&Slot(slot))
+        value_type(std::piecewise_construct,
+                   std::forward_as_tuple(key),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+    distances_[slot] = distance;
+    ++size_;
+    return {iterator(this, slot), true};
+  }
+
+  /// Removes the entry with `key`, if present.
+  ///
+  /// @returns The number of entries removed (0 or 1).
+  size_type erase(const key_type& key) {
+    size_t slot = FindSlot(key);
+    if (slot == kSlots) {
+      return 0;
+    }
+
+    Slot(slot).~value_type();
+
+    // Move following entries that are not in their home slot back by one, so
+    // that no lookup has to probe past the removed entry.
+    for (size_t next = NextSlot(slot); distances_[next] > 1;
+         slot = next, next = NextSlot(next)) {
+      new (&Slot(slot)) value_type(std::move(Slot(next)));
+      Slot(next).~value_type();
+      distances_[slot] = static_cast<Distance>(distances_[next] - 1);
+    }
+    distances_[slot] = 0;
+    --size_;
+    return 1;
+  }
+
+  // Lookup
+
+  /// Returns the value for `key`, inserting a value-initialized one if the key
+  /// is not present.
+  ///
+  /// @pre The key must be present or the map must not be full.
+  mapped_type& operator[](const key_type& key) {
+    iterator it = try_emplace(key).first;
+    PW_ASSERT(it != end());
+    return it->second;
+  }
+
+  /// Returns the value for `key`.
+  ///
+  /// @pre The key must be present.
+  mapped_type& at(const key_type& key) {
+    const size_t slot = FindSlot(key);
+    PW_ASSERT(slot != kSlots);
+    return Slot(slot).second;
+  }
+
+  /// Returns the value for `key`.
+  ///
+  /// @pre The key must be present.
+  const mapped_type& at(const key_type& key) const {
+    const size_t slot = FindSlot(key);
+    PW_ASSERT(slot != kSlots);
+    return Slot(slot).second;
+  }
+
+  iterator find(const key_type& key) { return iterator(this, FindSlot(key)); }
+
+  const_iterator find(const key_type& key) const {
+    return const_iterator(this, FindSlot(key));
+  }
+
+  size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+  bool contains(const key_type& key) const { return FindSlot(key) != kSlots; }
+
+ private:
+  // Slots are kept at most 7/8 full so that probe sequences stay short. There
+  // is always at least one empty slot, which terminates every probe sequence.
+  static constexpr size_t kSlots = containers::internal::NextPowerOfTwo(
+      kCapacity + kCapacity / 7 + 1);
+
+  static_assert(kCapacity > 0, "InlineHashMap must have a nonzero capacity");
+  static_assert(kSlots <= UINT16_MAX, "InlineHashMap capacity is too large");
+
+  // Each slot records one more than the distance of its entry from the entry's
+  // home slot, or 0 if the slot is empty. The distance is less than kSlots,
+  // so small tables use a byte per slot.
+  using Distance = std::conditional_t<(kSlots <= UINT8_MAX), uint8_t, uint16_t>;
+
+  static constexpr size_t kHashShift =
+      64 - containers::internal::Log2(kSlots);
+
+  template <typename MapType, typename ValueType>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = InlineHashMap::value_type;
+    using difference_type = InlineHashMap::difference_type;
+    using pointer = ValueType*;
+    using reference = ValueType&;
+
+    constexpr Iterator() = default;
+
+    // Allow converting a non-const iterator to a const iterator.
+    template <typename OtherMapType,
+              typename OtherValueType,
+              typename = std::enable_if_t<std::is_const_v<MapType> &&
+                                          !std::is_const_v<OtherMapType>>>
+    constexpr Iterator(const Iterator<OtherMapType, OtherValueType>& other)
+        : map_(other.map_), slot_(other.slot_) {}
+
+    reference operator*() const { return map_->Slot(slot_); }
+    pointer operator->() const { return &map_->Slot(slot_); }
+
+    Iterator& operator++() {
+      slot_ = map_->NextOccupied(slot_ + 1);
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator original = *this;
+      operator++();
+      return original;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return map_ == other.map_ && slot_ == other.slot_;
+    }
+
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class InlineHashMap;
+    template <typename, typename>
+    friend class Iterator;
+
+    constexpr Iterator(MapType* map, size_t slot) : map_(map), slot_(slot) {}
+
+    MapType* map_ = nullptr;
+    size_t slot_ = 0;
+  };
+
+  // Returns the slot that key hashes to, using Fibonacci hashing to mix the
+  // bits of the hash before taking the top bits as the slot index.
+  static size_t HomeSlot(const key_type& key) {
+    const uint64_t hash =
+        static_cast<uint64_t>(hasher()(key)) * UINT64_C(0x9E3779B97F4A7C15);
+    return static_cast<size_t>(hash >> kHashShift);
+  }
+
+  static constexpr size_t NextSlot(size_t slot) {
+    return (slot + 1) & (kSlots - 1);
+  }
+
+  static constexpr size_t PreviousSlot(size_t slot) {
+    return (slot - 1) & (kSlots - 1);
+  }
+
+  // Returns the slot holding key, or kSlots if it is not present.
+  size_t FindSlot(const key_type& key) const {
+    size_t slot = HomeSlot(key);
+    // Entries in a cluster are ordered by home slot, so the search can stop
+    // at the first entry that is closer to its home than key would be.
+    for (Distance distance = 1; distances_[slot] >= distance; ++distance) {
+      if (key_equal()(Slot(slot).first, key)) {
+        return slot;
+      }
+      slot = NextSlot(slot);
+    }
+    return kSlots;
+  }
+
+  // Returns the first occupied slot at or after slot, or kSlots.
+  size_t NextOccupied(size_t slot) const {
+    while (slot < kSlots && distances_[slot] == 0) {
+      ++slot;
+    }
+    return slot;
+  }
+
+  // Moves the entries from slot up to the next empty slot forward by one.
+  void ShiftClusterForward(size_t slot) {
+    size_t empty = slot;
+    while (distances_[empty] != 0) {
+      empty = NextSlot(empty);
+    }
+    for (size_t dest = empty; dest != slot; dest = PreviousSlot(dest)) {
+      const size_t source = PreviousSlot(dest);
+      new (&Slot(dest)) value_type(std::move(Slot(source)));
+      Slot(source).~value_type();
+      distances_[dest] = static_cast<Distance>(distances_[source] + 1);
+    }
+    distances_[slot] = 0;
+  }
+
+  // Copies the entries of a map with the same layout slot by slot.
+  void CopyFrom(const InlineHashMap& other) {
+    for (size_t slot = 0; slot < kSlots; ++slot) {
+      if (other.distances_[slot] != 0) {
+        new (&Slot(slot)) value_type(other.Slot(slot));
+      }
+    }
+    distances_ = other.distances_;
+    size_ = other.size_;
+  }
+
+  value_type& Slot(size_t slot) { return slots_.data()[slot]; }
+  const value_type& Slot(size_t slot) const { return slots_.data()[slot]; }
+
+  containers::internal::RawStorage<value_type, kSlots> slots_;
+  std::array<Distance, kSlots> distances_{};
+  size_type size_ = 0;
+};
+
+}  // namespace pw
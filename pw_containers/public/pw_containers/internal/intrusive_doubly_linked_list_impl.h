@@ -0,0 +1,348 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace pw {
+
+template <typename, bool>
+class IntrusiveDoublyLinkedList;
+
+namespace intrusive_doubly_linked_list_impl {
+
+template <typename T, typename I>
+class Iterator {
+ public:
+  using difference_type = std::ptrdiff_t;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using iterator_category = std::bidirectional_iterator_tag;
+
+  constexpr explicit Iterator() : item_(nullptr) {}
+
+  constexpr Iterator& operator++() {
+    item_ = static_cast<I*>(item_->next_);
+    return *this;
+  }
+
+  constexpr Iterator operator++(int) {
+    Iterator previous_value(item_);
+    operator++();
+    return previous_value;
+  }
+
+  constexpr Iterator& operator--() {
+    item_ = static_cast<I*>(item_->prev_);
+    return *this;
+  }
+
+  constexpr Iterator operator--(int) {
+    Iterator previous_value(item_);
+    operator--();
+    return previous_value;
+  }
+
+  constexpr const T& operator*() const { return *static_cast<T*>(item_); }
+  constexpr T& operator*() { return *static_cast<T*>(item_); }
+
+  constexpr const T* operator->() const { return static_cast<T*>(item_); }
+  constexpr T* operator->() { return static_cast<T*>(item_); }
+
+  template <typename U, typename J>
+  constexpr bool operator==(const Iterator<U, J>& rhs) const {
+    return item_ == rhs.item_;
+  }
+
+  template <typename U, typename J>
+  constexpr bool operator!=(const Iterator<U, J>& rhs) const {
+    return item_ != rhs.item_;
+  }
+
+ private:
+  template <typename, typename>
+  friend class Iterator;
+
+  template <typename, bool>
+  friend class ::pw::IntrusiveDoublyLinkedList;
+
+  // Only allow IntrusiveDoublyLinkedList to create iterators that point to
+  // something.
+  constexpr explicit Iterator(I* item) : item_{item} {}
+
+  I* item_;
+};
+
+class Item {
+ public:
+  /// Items are not copyable.
+  Item(const Item&) = delete;
+
+  /// Items are not copyable.
+  Item& operator=(const Item&) = delete;
+
+  /// Returns whether this object is not part of a list.
+  ///
+  /// This is O(1) whether the object is in a list or not.
+  bool unlisted() const { return this == next_; }
+
+  /// Unlinks this from the list it is a part of, if any.
+  ///
+  /// This is O(1).
+  void unlist() {
+    prev_->next_ = next_;
+    next_->prev_ = prev_;
+
+    // Retain the invariant that unlisted items are self-cycles.
+    prev_ = this;
+    next_ = this;
+  }
+
+ protected:
+  /// Default constructor.
+  ///
+  /// Unlisted items are self-cycles in both directions.
+  constexpr Item() : prev_(this), next_(this) {}
+
+  /// Destructor.
+  ///
+  /// This is O(1).
+  ~Item() { unlist(); }
+
+  /// Move constructor. See the move assignment operator.
+  Item(Item&& other);
+
+  /// Move assignment operator.
+  ///
+  /// This will unlist the current object, and replace other with this object
+  /// in the list that contained it. This is O(1).
+  Item& operator=(Item&& other);
+
+ private:
+  friend class List;
+
+  template <typename T, typename I>
+  friend class Iterator;
+
+  // Unlisted items must be self-cycles (prev_ == next_ == this).
+  Item* prev_;
+  Item* next_;
+};
+
+/// An item that also tracks the size of the list it is in, so that lists can
+/// report their size in O(1) even as items remove themselves.
+class CountedItem : public Item {
+ public:
+  /// Unlinks this from the list it is a part of, if any, and updates that
+  /// list's size.
+  ///
+  /// This is O(1).
+  void unlist() {
+    if (list_size_ != nullptr) {
+      *list_size_ -= 1;
+      list_size_ = nullptr;
+    }
+    Item::unlist();
+  }
+
+ protected:
+  constexpr CountedItem() = default;
+
+  ~CountedItem() { unlist(); }
+
+  CountedItem(CountedItem&& other) : CountedItem() {
+    *this = std::move(other);
+  }
+
+  /// Replaces other with this object in the list that contained it. The list's
+  /// size is unchanged. This is O(1).
+  CountedItem& operator=(CountedItem&& other) {
+    if (this != &other) {
+      unlist();
+      list_size_ = other.list_size_;
+      other.list_size_ = nullptr;
+      Item::operator=(std::move(other));
+    }
+    return *this;
+  }
+
+ private:
+  friend class CountedList;
+
+  // The size of the list this item is in, or null if it is unlisted.
+  size_t* list_size_ = nullptr;
+};
+
+class List {
+ public:
+  constexpr List() = default;
+
+  template <typename Iterator>
+  List(Iterator first, Iterator last) : List() {
+    AssignFromIterator(first, last);
+  }
+
+  // Intrusive lists cannot be copied, since each Item can only be in one list.
+  List(const List&) = delete;
+  List& operator=(const List&) = delete;
+
+  template <typename Iterator>
+  void assign(Iterator first, Iterator last) {
+    clear();
+    AssignFromIterator(first, last);
+  }
+
+  bool empty() const noexcept { return begin() == end(); }
+
+  /// Inserts an item into a list before `pos`.
+  ///
+  /// This is O(1). The ownership of the item is not changed.
+  static void insert(Item* pos, Item& item);
+
+  /// Removes an item from the list that contains it.
+  ///
+  /// This is O(1). The item is not destroyed.
+  static void erase(Item& item) { item.unlist(); }
+
+  /// Removes an item if it is listed. The item must be in this list or in no
+  /// list. Returns whether the item was removed.
+  ///
+  /// This is O(1).
+  static bool remove(Item& item) {
+    if (item.unlisted()) {
+      return false;
+    }
+    item.unlist();
+    return true;
+  }
+
+  void clear();
+
+  /// Returns a pointer to the first item.
+  constexpr Item* begin() noexcept { return head_.next_; }
+  constexpr const Item* begin() const noexcept { return head_.next_; }
+
+  /// Returns a pointer to the last item.
+  constexpr Item* before_end() noexcept { return head_.prev_; }
+  constexpr const Item* before_end() const noexcept { return head_.prev_; }
+
+  /// Returns a pointer to the sentinel item.
+  constexpr Item* end() noexcept { return &head_; }
+  constexpr const Item* end() const noexcept { return &head_; }
+
+  /// Returns the number of items in the list by walking it.
+  ///
+  /// This is O(n), where "n" is the number of items in the list.
+  size_t size() const;
+
+ private:
+  /// Adds items to the end of the list from the provided range.
+  ///
+  /// This is O(n), where "n" is the number of items in the range.
+  template <typename Iterator>
+  void AssignFromIterator(Iterator first, Iterator last);
+
+  // As in IntrusiveList, the sentinel is an Item, so end() is unique for each
+  // list and inserting at either end needs no special cases.
+  Item head_;
+};
+
+/// A List of CountedItems that keeps its size.
+class CountedList : public List {
+ public:
+  constexpr CountedList() = default;
+
+  template <typename Iterator>
+  CountedList(Iterator first, Iterator last) : CountedList() {
+    AssignFromIterator(first, last);
+  }
+
+  template <typename Iterator>
+  void assign(Iterator first, Iterator last) {
+    clear();
+    AssignFromIterator(first, last);
+  }
+
+  void insert(Item* pos, CountedItem& item) {
+    List::insert(pos, item);
+    item.list_size_ = &size_;
+    size_ += 1;
+  }
+
+  static void erase(CountedItem& item) { item.unlist(); }
+
+  static bool remove(CountedItem& item) {
+    if (item.unlisted()) {
+      return false;
+    }
+    item.unlist();
+    return true;
+  }
+
+  void clear();
+
+  /// Returns the number of items in the list. This is O(1).
+  constexpr size_t size() const { return size_; }
+
+ private:
+  template <typename Iterator>
+  void AssignFromIterator(Iterator first, Iterator last);
+
+  size_t size_ = 0;
+};
+
+template <typename Iterator>
+void List::AssignFromIterator(Iterator first, Iterator last) {
+  for (Iterator it = first; it != last; ++it) {
+    if constexpr (std::is_pointer<std::remove_reference_t<decltype(*it)>>()) {
+      insert(end(), **it);
+    } else {
+      insert(end(), *it);
+    }
+  }
+}
+
+template <typename Iterator>
+void CountedList::AssignFromIterator(Iterator first, Iterator last) {
+  for (Iterator it = first; it != last; ++it) {
+    if constexpr (std::is_pointer<std::remove_reference_t<decltype(*it)>>()) {
+      insert(end(), **it);
+    } else {
+      insert(end(), *it);
+    }
+  }
+}
+
+// Gets the element type from an Item. This is used to check that an
+// IntrusiveDoublyLinkedList element class inherits from Item, either directly
+// or through another class.
+template <typename T, bool kIsItem = std::is_base_of<Item, T>()>
+struct GetListElementTypeFromItem {
+  using Type = void;
+};
+
+template <typename T>
+struct GetListElementTypeFromItem<T, true> {
+  using Type = typename T::PwIntrusiveDoublyLinkedListElementType;
+};
+
+template <typename T>
+using ElementTypeFromItem = typename GetListElementTypeFromItem<T>::Type;
+
+}  // namespace intrusive_doubly_linked_list_impl
+}  // namespace pw
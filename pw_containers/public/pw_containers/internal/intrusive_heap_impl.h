@@ -0,0 +1,186 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace pw::intrusive_heap_impl {
+
+class Item {
+ public:
+  /// Items are not copyable.
+  Item(const Item&) = delete;
+
+  /// Items are not copyable.
+  Item& operator=(const Item&) = delete;
+
+  /// Returns whether this object is not part of a heap.
+  ///
+  /// This is O(1) whether the object is in a heap or not.
+  bool unlisted() const { return this == parent_; }
+
+ protected:
+  /// Default constructor.
+  ///
+  /// Unlisted items are their own parent.
+  constexpr Item() : parent_(this), left_(nullptr), right_(nullptr) {}
+
+  /// Destructor.
+  ///
+  /// Unlike list items, heap items cannot remove themselves, since that needs
+  /// the heap's last item. Items must be removed before they are destroyed.
+  ~Item();
+
+ private:
+  friend class Heap;
+
+  void Reset() {
+    parent_ = this;
+    left_ = nullptr;
+    right_ = nullptr;
+  }
+
+  // The root's parent is null. Unlisted items are their own parent.
+  Item* parent_;
+  Item* left_;
+  Item* right_;
+};
+
+/// A binary heap of linked items. The shape is that of an array-backed binary
+/// heap: item N (counting from 1 in level order) has children 2N and 2N + 1, so
+/// the tree is always complete and the last item is found from the size.
+///
+/// `less(a, b)` returns whether `a` has lower priority than `b`. The item with
+/// the highest priority is at the root, as with std::priority_queue.
+class Heap {
+ public:
+  constexpr Heap() = default;
+
+  Heap(const Heap&) = delete;
+  Heap& operator=(const Heap&) = delete;
+
+  /// Unlinks all items, so they may be destroyed or reused.
+  ~Heap() { clear(); }
+
+  bool empty() const { return root_ == nullptr; }
+
+  size_t size() const { return size_; }
+
+  Item* top() { return root_; }
+  const Item* top() const { return root_; }
+
+  /// Adds an item. This is O(log n).
+  template <typename Less>
+  void push(Item& item, Less&& less) {
+    Append(item);
+    SiftUp(item, less);
+  }
+
+  /// Removes an item, which must be in this heap. This is O(log n).
+  template <typename Less>
+  void erase(Item& item, Less&& less) {
+    Item* moved = RemoveAndFill(item);
+    if (moved != nullptr) {
+      SiftUp(*moved, less);
+      SiftDown(*moved, less);
+    }
+  }
+
+  /// Restores the heap order after an item's priority changed. This is
+  /// O(log n).
+  template <typename Less>
+  void update(Item& item, Less&& less) {
+    SiftUp(item, less);
+    SiftDown(item, less);
+  }
+
+  /// Unlinks all items. This is O(n).
+  void clear();
+
+ private:
+  /// Links an item in the next free position, without reordering.
+  void Append(Item& item);
+
+  /// Unlinks an item and moves the last item into its position. Returns the
+  /// moved item, or null if the removed item was the last one.
+  Item* RemoveAndFill(Item& item);
+
+  /// Exchanges an item with its parent by relinking both.
+  void SwapWithParent(Item& child);
+
+  /// Returns the item at a 1-based, level-order position. This is O(log n).
+  Item* ItemAt(size_t position) const;
+
+  template <typename Less>
+  void SiftUp(Item& item, Less& less) {
+    while (item.parent_ != nullptr && less(*item.parent_, item)) {
+      SwapWithParent(item);
+    }
+  }
+
+  template <typename Less>
+  void SiftDown(Item& item, Less& less) {
+    while (true) {
+      Item* highest = &item;
+      if (item.left_ != nullptr && less(*highest, *item.left_)) {
+        highest = item.left_;
+      }
+      if (item.right_ != nullptr && less(*highest, *item.right_)) {
+        highest = item.right_;
+      }
+      if (highest == &item) {
+        return;
+      }
+      SwapWithParent(*highest);
+    }
+  }
+
+  Item* root_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Gets the element type from an Item. This is used to check that an
+// IntrusiveHeap element class inherits from Item, either directly or through
+// another class.
+template <typename T, bool kIsItem = std::is_base_of<Item, T>()>
+struct GetHeapElementTypeFromItem {
+  using Type = void;
+};
+
+template <typename T>
+struct GetHeapElementTypeFromItem<T, true> {
+  using Type = typename T::PwIntrusiveHeapElementType;
+};
+
+template <typename T>
+using ElementTypeFromItem = typename GetHeapElementTypeFromItem<T>::Type;
+
+// The base class for items of IntrusiveHeap<T, Compare>. It only depends on
+// T, so the same items can be used with any Compare.
+template <typename T>
+class ElementItem : public Item {
+ protected:
+  constexpr ElementItem() = default;
+
+ private:
+  // GetHeapElementTypeFromItem is used to find the element type from an item.
+  // It is used to ensure heap items inherit from the correct Item type.
+  template <typename, bool>
+  friend struct GetHeapElementTypeFromItem;
+
+  using PwIntrusiveHeapElementType = T;
+};
+
+}  // namespace pw::intrusive_heap_impl
@@ -0,0 +1,471 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace pw::intrusive_tree_impl {
+
+template <typename T, typename I>
+class Iterator;
+
+template <typename T, typename Key, typename KeyOf, typename Compare>
+class Container;
+
+class Item {
+ public:
+  /// Items are not copyable.
+  Item(const Item&) = delete;
+
+  /// Items are not copyable.
+  Item& operator=(const Item&) = delete;
+
+  /// Returns whether this object is not part of a tree.
+  ///
+  /// This is O(1) whether the object is in a tree or not.
+  bool unlisted() const { return this == parent_; }
+
+ protected:
+  /// Default constructor.
+  ///
+  /// Unlisted items are their own parent.
+  constexpr Item() : Item(this) {}
+
+  /// Destructor.
+  ///
+  /// Removing an item may rebalance the tree and change its root, so items
+  /// cannot remove themselves. Items must be removed before they are
+  /// destroyed.
+  ~Item();
+
+ private:
+  friend class Tree;
+
+  template <typename, typename>
+  friend class Iterator;
+
+  /// Explicit constructor, used by Tree to create its sentinel.
+  explicit constexpr Item(Item* parent)
+      : parent_(parent), left_(nullptr), right_(nullptr), red_(false) {}
+
+  /// Returns the next item in order, or the tree's sentinel after the last
+  /// item. This is O(log n) worst case and O(1) amortized.
+  Item* next() const;
+
+  /// Returns the previous item in order. From the tree's sentinel, returns
+  /// the last item.
+  Item* previous() const;
+
+  void Reset() {
+    parent_ = this;
+    left_ = nullptr;
+    right_ = nullptr;
+    red_ = false;
+  }
+
+  // The root's parent is the tree's sentinel, whose left child is the root and
+  // whose own parent is null. Unlisted items are their own parent.
+  Item* parent_;
+  Item* left_;
+  Item* right_;
+  bool red_;
+};
+
+template <typename T, typename I>
+class Iterator {
+ public:
+  using difference_type = std::ptrdiff_t;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using iterator_category = std::bidirectional_iterator_tag;
+
+  constexpr explicit Iterator() : item_(nullptr) {}
+
+  Iterator& operator++() {
+    item_ = static_cast<I*>(item_->next());
+    return *this;
+  }
+
+  Iterator operator++(int) {
+    Iterator previous_value(item_);
+    operator++();
+    return previous_value;
+  }
+
+  Iterator& operator--() {
+    item_ = static_cast<I*>(item_->previous());
+    return *this;
+  }
+
+  Iterator operator--(int) {
+    Iterator previous_value(item_);
+    operator--();
+    return previous_value;
+  }
+
+  constexpr const T& operator*() const { return *static_cast<T*>(item_); }
+  constexpr T& operator*() { return *static_cast<T*>(item_); }
+
+  constexpr const T* operator->() const { return static_cast<T*>(item_); }
+  constexpr T* operator->() { return static_cast<T*>(item_); }
+
+  template <typename U, typename J>
+  constexpr bool operator==(const Iterator<U, J>& rhs) const {
+    return item_ == rhs.item_;
+  }
+
+  template <typename U, typename J>
+  constexpr bool operator!=(const Iterator<U, J>& rhs) const {
+    return item_ != rhs.item_;
+  }
+
+ private:
+  template <typename, typename>
+  friend class Iterator;
+
+  template <typename, typename, typename, typename>
+  friend class Container;
+
+  // Only allow the containers to create iterators that point to something.
+  constexpr explicit Iterator(I* item) : item_{item} {}
+
+  I* item_;
+};
+
+/// A red-black tree of linked items, ordered by the caller.
+///
+/// Lookups take a `compare(item, key)` function that returns a negative
+/// number, zero, or a positive number if the item orders before, the same as,
+/// or after the key.
+class Tree {
+ public:
+  constexpr Tree() : sentinel_(nullptr) {}
+
+  Tree(const Tree&) = delete;
+  Tree& operator=(const Tree&) = delete;
+
+  /// Unlinks all items, so they may be destroyed or reused.
+  ~Tree() { clear(); }
+
+  bool empty() const { return root() == nullptr; }
+
+  size_t size() const { return size_; }
+
+  /// Returns the first item in order, or end() if empty. This is O(log n).
+  Item* begin() const;
+
+  /// Returns the sentinel.
+  Item* end() const { return const_cast<Item*>(&sentinel_); }
+
+  /// Returns the first item that does not order before the key.
+  template <typename Compare>
+  Item* lower_bound(Compare&& compare) const {
+    Item* result = end();
+    for (Item* item = root(); item != nullptr;) {
+      if (compare(*item) < 0) {
+        item = item->right_;
+      } else {
+        result = item;
+        item = item->left_;
+      }
+    }
+    return result;
+  }
+
+  /// Returns the first item that orders after the key.
+  template <typename Compare>
+  Item* upper_bound(Compare&& compare) const {
+    Item* result = end();
+    for (Item* item = root(); item != nullptr;) {
+      if (compare(*item) <= 0) {
+        item = item->right_;
+      } else {
+        result = item;
+        item = item->left_;
+      }
+    }
+    return result;
+  }
+
+  /// Returns the item equal to the key, or end().
+  template <typename Compare>
+  Item* find(Compare&& compare) const {
+    Item* item = lower_bound(compare);
+    return item != end() && compare(*item) == 0 ? item : end();
+  }
+
+  /// Adds an item unless an equal one is already present. Returns the item
+  /// with the key and whether it was added. This is O(log n).
+  template <typename Compare>
+  std::pair<Item*, bool> insert(Item& item, Compare&& compare) {
+    Item* parent = end();
+    bool left = true;
+    for (Item* current = root(); current != nullptr;) {
+      const int order = compare(*current);
+      if (order == 0) {
+        return std::make_pair(current, false);
+      }
+      parent = current;
+      left = order > 0;
+      current = left ? current->left_ : current->right_;
+    }
+    InsertAt(parent, left, item);
+    return std::make_pair(&item, true);
+  }
+
+  /// Removes an item, which must be in this tree. This is O(log n).
+  void erase(Item& item);
+
+  /// Unlinks all items. This is O(n).
+  void clear();
+
+ private:
+  Item* root() const { return sentinel_.left_; }
+
+  /// Links an item as a child of parent and rebalances.
+  void InsertAt(Item* parent, bool left, Item& item);
+
+  void RotateLeft(Item* item);
+  void RotateRight(Item* item);
+
+  static bool IsRed(const Item* item) {
+    return item != nullptr && item->red_;
+  }
+
+  // Points the parent's link to old_child at new_child. This also works when
+  // the parent is the sentinel, since the root is the sentinel's left child.
+  static void ReplaceChild(Item* parent, Item* old_child, Item* new_child);
+
+  // The sentinel is end(). Its left child is the root, which lets the root be
+  // replaced by rotations without special cases.
+  Item sentinel_;
+  size_t size_ = 0;
+};
+
+// Gets the element type from an Item. This is used to check that an
+// IntrusiveSet or IntrusiveMap element class inherits from Item, either
+// directly or through another class.
+template <typename T, bool kIsItem = std::is_base_of<Item, T>()>
+struct GetTreeElementTypeFromItem {
+  using Type = void;
+};
+
+template <typename T>
+struct GetTreeElementTypeFromItem<T, true> {
+  using Type = typename T::PwIntrusiveTreeElementType;
+};
+
+template <typename T>
+using ElementTypeFromItem = typename GetTreeElementTypeFromItem<T>::Type;
+
+// The base class for items of IntrusiveSet<T> and IntrusiveMap<Key, T>. It
+// only depends on T, so the same items can be used with either container.
+template <typename T>
+class ElementItem : public Item {
+ protected:
+  constexpr ElementItem() = default;
+
+ private:
+  // GetTreeElementTypeFromItem is used to find the element type from an item.
+  // It is used to ensure items inherit from the correct Item type.
+  template <typename, bool>
+  friend struct GetTreeElementTypeFromItem;
+
+  using PwIntrusiveTreeElementType = T;
+};
+
+// Key extraction for IntrusiveSet, where items are their own keys.
+struct SetKey {
+  template <typename T>
+  static const T& Get(const T& item) {
+    return item;
+  }
+};
+
+// Key extraction for IntrusiveMap, where items provide a key() method.
+struct MapKey {
+  template <typename T>
+  static decltype(auto) Get(const T& item) {
+    return item.key();
+  }
+};
+
+// The implementation of IntrusiveSet and IntrusiveMap, which only differ in
+// how they get an item's key.
+template <typename T, typename Key, typename KeyOf, typename Compare>
+class Container {
+ public:
+  using Item = ElementItem<T>;
+
+  using key_type = Key;
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using key_compare = Compare;
+  using iterator = Iterator<T, Item>;
+  using const_iterator = Iterator<std::add_const_t<T>, const Item>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  constexpr Container() : Container(Compare()) {}
+
+  constexpr explicit Container(const Compare& compare) : compare_(compare) {
+    CheckItemType();
+  }
+
+  // Constructs a container from an iterator over items. The iterator may
+  // dereference as either T& or T*. Items with duplicate keys are skipped.
+  template <typename Iterator>
+  Container(Iterator first, Iterator last, const Compare& compare = Compare())
+      : Container(compare) {
+    insert(first, last);
+  }
+
+  Container(std::initializer_list<T*> items,
+            const Compare& compare = Compare())
+      : Container(items.begin(), items.end(), compare) {}
+
+  [[nodiscard]] bool empty() const noexcept { return tree_.empty(); }
+
+  // Operation is O(1).
+  size_t size() const { return tree_.size(); }
+
+  iterator begin() noexcept { return iterator(ToItem(tree_.begin())); }
+  const_iterator begin() const noexcept {
+    return const_iterator(ToItem(tree_.begin()));
+  }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(ToItem(tree_.end())); }
+  const_iterator end() const noexcept {
+    return const_iterator(ToItem(tree_.end()));
+  }
+  const_iterator cend() const noexcept { return end(); }
+
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crend() const noexcept { return rend(); }
+
+  // Adds an item, unless an item with an equal key is already present. Returns
+  // an iterator to the item with the key and whether the item was added.
+  std::pair<iterator, bool> insert(T& item) {
+    auto result = tree_.insert(item, Order(KeyOf::Get(item)));
+    return std::make_pair(iterator(ToItem(result.first)), result.second);
+  }
+
+  template <typename Iterator>
+  void insert(Iterator first, Iterator last) {
+    for (Iterator it = first; it != last; ++it) {
+      if constexpr (std::is_pointer<std::remove_reference_t<decltype(*it)>>()) {
+        insert(**it);
+      } else {
+        insert(*it);
+      }
+    }
+  }
+
+  // Removes the item at pos and returns an iterator to the item that followed
+  // it. The item is not destructed.
+  iterator erase(iterator pos) {
+    iterator next = std::next(pos);
+    tree_.erase(*pos.item_);
+    return next;
+  }
+
+  // Removes the item with the key, if any. Returns the number of items
+  // removed.
+  size_t erase(const Key& key) {
+    iterator it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  // Removes all items. The items themselves are not destructed.
+  void clear() { tree_.clear(); }
+
+  iterator find(const Key& key) {
+    return iterator(ToItem(tree_.find(Order(key))));
+  }
+  const_iterator find(const Key& key) const {
+    return const_iterator(ToItem(tree_.find(Order(key))));
+  }
+
+  size_t count(const Key& key) const { return find(key) != end() ? 1 : 0; }
+
+  // Returns the first item whose key is not less than key.
+  iterator lower_bound(const Key& key) {
+    return iterator(ToItem(tree_.lower_bound(Order(key))));
+  }
+  const_iterator lower_bound(const Key& key) const {
+    return const_iterator(ToItem(tree_.lower_bound(Order(key))));
+  }
+
+  // Returns the first item whose key is greater than key.
+  iterator upper_bound(const Key& key) {
+    return iterator(ToItem(tree_.upper_bound(Order(key))));
+  }
+  const_iterator upper_bound(const Key& key) const {
+    return const_iterator(ToItem(tree_.upper_bound(Order(key))));
+  }
+
+  key_compare key_comp() const { return compare_; }
+
+ private:
+  // Check that T is an Item in a function, since the class T will not be fully
+  // defined when the container class is instantiated.
+  static constexpr void CheckItemType() {
+    static_assert(std::is_base_of<ElementTypeFromItem<T>, T>(),
+                  "IntrusiveSet and IntrusiveMap items must be derived from "
+                  "IntrusiveSet<T>::Item or IntrusiveMap<Key, T>::Item, where "
+                  "T is the item or one of its bases.");
+  }
+
+  static Item* ToItem(intrusive_tree_impl::Item* item) {
+    return static_cast<Item*>(item);
+  }
+
+  // Returns a function that orders an item relative to key, as Tree expects.
+  auto Order(const Key& key) const {
+    return [this, &key](const intrusive_tree_impl::Item& item) {
+      const auto& item_key =
+          KeyOf::Get(static_cast<const T&>(static_cast<const Item&>(item)));
+      if (compare_(item_key, key)) {
+        return -1;
+      }
+      return compare_(key, item_key) ? 1 : 0;
+    };
+  }
+
+  Tree tree_;
+  Compare compare_;
+};
+
+}  // namespace pw::intrusive_tree_impl
@@ -0,0 +1,204 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "pw_containers/internal/intrusive_doubly_linked_list_impl.h"
+
+namespace pw {
+
+// IntrusiveDoublyLinkedList is an intrusive list like IntrusiveList, but each
+// item holds pointers to both its next and previous items. This costs one more
+// pointer per item, and in exchange makes removing an item, destroying or
+// moving an item, and push_back() / back() all O(1). Iterators are
+// bidirectional.
+//
+// If kCountItems is true, the list also keeps its size, making size() O(1).
+// Items of counted lists hold a pointer to that size so they can update it
+// when they remove themselves, which costs another pointer per item.
+//
+// As with IntrusiveList, items must outlive the list they are added to and can
+// only be in one list at a time.
+//
+// Usage:
+//
+//   class TestItem
+//      : public IntrusiveDoublyLinkedList<TestItem>::Item {}
+//
+//   IntrusiveDoublyLinkedList<TestItem> test_items;
+//
+//   auto item = TestItem();
+//   test_items.push_back(item);
+//   test_items.remove(item);  // O(1)
+//
+template <typename T, bool kCountItems = false>
+class IntrusiveDoublyLinkedList {
+ private:
+  using ItemBase =
+      std::conditional_t<kCountItems,
+                         intrusive_doubly_linked_list_impl::CountedItem,
+                         intrusive_doubly_linked_list_impl::Item>;
+  using ListBase =
+      std::conditional_t<kCountItems,
+                         intrusive_doubly_linked_list_impl::CountedList,
+                         intrusive_doubly_linked_list_impl::List>;
+
+ public:
+  class Item : public ItemBase {
+   protected:
+    constexpr Item() = default;
+
+   private:
+    // GetListElementTypeFromItem is used to find the element type from an item.
+    // It is used to ensure list items inherit from the correct Item type.
+    template <typename, bool>
+    friend struct intrusive_doubly_linked_list_impl::GetListElementTypeFromItem;
+
+    using PwIntrusiveDoublyLinkedListElementType = T;
+  };
+
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using iterator = intrusive_doubly_linked_list_impl::Iterator<T, Item>;
+  using const_iterator =
+      intrusive_doubly_linked_list_impl::Iterator<std::add_const_t<T>,
+                                                  const Item>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  constexpr IntrusiveDoublyLinkedList() { CheckItemType(); }
+
+  // Constructs a list from an iterator over Items. The iterator may
+  // dereference as either Item& (e.g. from std::array<Item>) or Item* (e.g.
+  // from std::initializer_list<Item*>).
+  template <typename Iterator>
+  IntrusiveDoublyLinkedList(Iterator first, Iterator last)
+      : list_(first, last) {
+    CheckItemType();
+  }
+
+  // Constructs a list from a std::initializer_list of pointers to items.
+  IntrusiveDoublyLinkedList(std::initializer_list<Item*> items)
+      : IntrusiveDoublyLinkedList(items.begin(), items.end()) {}
+
+  template <typename Iterator>
+  void assign(Iterator first, Iterator last) {
+    list_.assign(first, last);
+  }
+
+  void assign(std::initializer_list<Item*> items) {
+    list_.assign(items.begin(), items.end());
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return list_.empty(); }
+
+  void push_front(T& item) { list_.insert(list_.begin(), item); }
+
+  void push_back(T& item) { list_.insert(list_.end(), item); }
+
+  // Inserts item before pos and returns an iterator to it.
+  iterator insert(iterator pos, T& item) {
+    list_.insert(pos.item_, item);
+    return iterator(&item);
+  }
+
+  // Removes the first item in the list. The list must not be empty.
+  void pop_front() { list_.erase(static_cast<Item&>(*list_.begin())); }
+
+  // Removes the last item in the list. The list must not be empty.
+  void pop_back() { list_.erase(static_cast<Item&>(*list_.before_end())); }
+
+  // Removes the item at pos from the list and returns an iterator to the item
+  // that followed it. The item is not destructed.
+  iterator erase(iterator pos) {
+    iterator next = std::next(pos);
+    list_.erase(*pos.item_);
+    return next;
+  }
+
+  // Removes all items from the list. The items themselves are not destructed.
+  void clear() { list_.clear(); }
+
+  // Removes this specific item from the list, if it is present. The item must
+  // be in this list or in no list. Returns true if the item was removed; false
+  // if it was not in a list. Unlike IntrusiveList::remove, this is O(1).
+  bool remove(const T& item) {
+    return list_.remove(const_cast<Item&>(static_cast<const Item&>(item)));
+  }
+
+  // Reference to the first element in the list. Undefined behavior if empty().
+  T& front() { return *static_cast<T*>(static_cast<Item*>(list_.begin())); }
+  const T& front() const {
+    return *static_cast<const T*>(static_cast<const Item*>(list_.begin()));
+  }
+
+  // Reference to the last element in the list. Undefined behavior if empty().
+  T& back() { return *static_cast<T*>(static_cast<Item*>(list_.before_end())); }
+  const T& back() const {
+    return *static_cast<const T*>(
+        static_cast<const Item*>(list_.before_end()));
+  }
+
+  iterator begin() noexcept {
+    return iterator(static_cast<Item*>(list_.begin()));
+  }
+  const_iterator begin() const noexcept {
+    return const_iterator(static_cast<const Item*>(list_.begin()));
+  }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(static_cast<Item*>(list_.end())); }
+  const_iterator end() const noexcept {
+    return const_iterator(static_cast<const Item*>(list_.end()));
+  }
+  const_iterator cend() const noexcept { return end(); }
+
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crend() const noexcept { return rend(); }
+
+  // Operation is O(1) if kCountItems is true, and O(size) otherwise.
+  size_t size() const { return list_.size(); }
+
+ private:
+  // Check that T is an Item in a function, since the class T will not be fully
+  // defined when the IntrusiveDoublyLinkedList<T> class is instantiated.
+  static constexpr void CheckItemType() {
+    static_assert(
+        std::is_base_of<
+            intrusive_doubly_linked_list_impl::ElementTypeFromItem<T>,
+            T>(),
+        "IntrusiveDoublyLinkedList items must be derived from "
+        "IntrusiveDoublyLinkedList<T>::Item, where T is the item or one of its "
+        "bases.");
+  }
+
+  ListBase list_;
+};
+
+}  // namespace pw
@@ -0,0 +1,126 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "pw_containers/internal/intrusive_heap_impl.h"
+
+namespace pw {
+
+// IntrusiveHeap is a priority queue of items that embed their own links, in
+// the same way as IntrusiveList. Each item holds three pointers. Adding and
+// removing items, including items other than the top one, is O(log n), and
+// nothing is allocated.
+//
+// As with std::priority_queue, Compare(a, b) returns whether a has lower
+// priority than b, and top() is the item with the highest priority. Use
+// std::greater or an equivalent to make top() the smallest item, e.g. the
+// timer with the earliest deadline.
+//
+// Items must be removed from the heap before they are destroyed. Destroying
+// the heap removes all of its items.
+//
+// Usage:
+//
+//   class Timer : public IntrusiveHeap<Timer, EarlierDeadline>::Item {
+//     ...
+//   };
+//
+//   IntrusiveHeap<Timer, EarlierDeadline> timers;
+//   timers.push(timer);
+//   Timer& next = timers.top();
+//
+template <typename T, typename Compare = std::less<T>>
+class IntrusiveHeap {
+ public:
+  // The base class for items. It does not depend on Compare, so the same items
+  // may be used in heaps with different orderings.
+  using Item = intrusive_heap_impl::ElementItem<T>;
+
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using value_compare = Compare;
+
+  constexpr IntrusiveHeap() : IntrusiveHeap(Compare()) {}
+
+  constexpr explicit IntrusiveHeap(const Compare& compare)
+      : compare_(compare) {
+    CheckItemType();
+  }
+
+  [[nodiscard]] bool empty() const { return heap_.empty(); }
+
+  // Operation is O(1).
+  size_t size() const { return heap_.size(); }
+
+  // The item with the highest priority. Undefined behavior if empty().
+  T& top() { return *static_cast<T*>(static_cast<Item*>(heap_.top())); }
+  const T& top() const {
+    return *static_cast<const T*>(static_cast<const Item*>(heap_.top()));
+  }
+
+  void push(T& item) { heap_.push(item, Less()); }
+
+  // Removes the top item. The heap must not be empty.
+  void pop() { heap_.erase(*heap_.top(), Less()); }
+
+  // Removes this specific item from the heap, if it is present. The item must
+  // be in this heap or in no heap. Returns true if the item was removed; false
+  // if it was not in a heap.
+  bool remove(T& item) {
+    if (item.unlisted()) {
+      return false;
+    }
+    heap_.erase(item, Less());
+    return true;
+  }
+
+  // Restores the heap order after the priority of an item in the heap changed,
+  // e.g. after a timer was rescheduled. This is cheaper than removing and
+  // re-adding the item.
+  void update(T& item) { heap_.update(item, Less()); }
+
+  // Removes all items from the heap. The items themselves are not destructed.
+  void clear() { heap_.clear(); }
+
+  const Compare& value_comp() const { return compare_; }
+
+ private:
+  // Check that T is an Item in a function, since the class T will not be fully
+  // defined when the IntrusiveHeap<T> class is instantiated.
+  static constexpr void CheckItemType() {
+    static_assert(
+        std::is_base_of<intrusive_heap_impl::ElementTypeFromItem<T>, T>(),
+        "IntrusiveHeap items must be derived from IntrusiveHeap<T>::Item, "
+        "where T is the item or one of its bases.");
+  }
+
+  auto Less() const {
+    return [this](const intrusive_heap_impl::Item& lhs,
+                  const intrusive_heap_impl::Item& rhs) {
+      return compare_(static_cast<const T&>(static_cast<const Item&>(lhs)),
+                      static_cast<const T&>(static_cast<const Item&>(rhs)));
+    };
+  }
+
+  intrusive_heap_impl::Heap heap_;
+  Compare compare_;
+};
+
+}  // namespace pw
@@ -0,0 +1,57 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <functional>
+
+#include "pw_containers/internal/intrusive_tree_impl.h"
+
+namespace pw {
+
+// IntrusiveMap is an ordered map of items that embed their own links, in the
+// same way as IntrusiveList. It is a red-black tree, so inserting, finding,
+// and removing items are O(log n), and nothing is allocated.
+//
+// Items provide their own key through a key() method, which returns a Key or
+// a reference to one. The API is similar to std::map, except that lookups
+// return iterators to the items themselves. An item is not added if an item
+// with the same key is already in the map.
+//
+// Items must be removed from the map before they are destroyed. Destroying the
+// map removes all of its items.
+//
+// Usage:
+//
+//   class Session : public IntrusiveMap<uint32_t, Session>::Item {
+//    public:
+//     uint32_t key() const { return id_; }
+//     ...
+//   };
+//
+//   IntrusiveMap<uint32_t, Session> sessions;
+//   sessions.insert(session);
+//   auto it = sessions.find(id);
+//
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class IntrusiveMap
+    : public intrusive_tree_impl::
+          Container<T, Key, intrusive_tree_impl::MapKey, Compare> {
+ public:
+  using intrusive_tree_impl::
+      Container<T, Key, intrusive_tree_impl::MapKey, Compare>::Container;
+
+  using mapped_type = T;
+};
+
+}  // namespace pw
@@ -0,0 +1,61 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <functional>
+
+#include "pw_containers/internal/intrusive_tree_impl.h"
+
+namespace pw {
+
+// IntrusiveSet is an ordered set of items that embed their own links, in the
+// same way as IntrusiveList. It is a red-black tree, so inserting, finding,
+// and removing items are O(log n), and nothing is allocated. Each item holds
+// three pointers and a flag.
+//
+// The API is similar to std::set. Items are ordered by Compare, and an item is
+// not added if an equivalent one is already in the set.
+//
+// Items must be removed from the set before they are destroyed. Destroying the
+// set removes all of its items. IntrusiveSet<T>::Item is the same type as
+// IntrusiveMap<Key, T>::Item, so the same items may be used in either.
+//
+// Usage:
+//
+//   class FreeBlock : public IntrusiveSet<FreeBlock>::Item {
+//    public:
+//     bool operator<(const FreeBlock& other) const {
+//       return size() < other.size();
+//     }
+//     ...
+//   };
+//
+//   IntrusiveSet<FreeBlock> free_blocks;
+//   free_blocks.insert(block);
+//   auto best_fit = free_blocks.lower_bound(wanted);
+//
+template <typename T, typename Compare = std::less<T>>
+class IntrusiveSet
+    : public intrusive_tree_impl::
+          Container<T, T, intrusive_tree_impl::SetKey, Compare> {
+ public:
+  using intrusive_tree_impl::
+      Container<T, T, intrusive_tree_impl::SetKey, Compare>::Container;
+
+  using value_compare = Compare;
+
+  value_compare value_comp() const { return this->key_comp(); }
+};
+
+}  // namespace pw
@@ -0,0 +1,178 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "pw_containers/internal/raw_storage.h"
+
+namespace pw::containers {
+
+/// A fixed-capacity, lock-free queue for any number of producers and
+/// consumers.
+///
+/// `MpmcQueue` is a bounded queue in the style of Dmitry Vyukov's MPMC queue.
+/// Each slot has a sequence number that tells producers and consumers whether
+/// the slot is ready for them. A push or pop claims a slot with a single
+/// compare-and-swap and then publishes it with a store, so contexts never wait
+/// on each other's locks. Pushing and popping never block: `try_push` fails
+/// when the queue is full and `try_pop` returns `std::nullopt` when it is
+/// empty.
+///
+/// A push that has claimed a slot but not yet published it holds up the
+/// consumers: until it finishes, `try_pop` reports the queue as empty, even if
+/// later pushes have completed. This is what makes the queue safe to push to
+/// from an interrupt that preempted another push.
+///
+/// Using `MpmcQueue` from interrupts requires lock-free `std::atomic<size_t>`
+/// compare-and-swap, which some targets (such as ARMv6-M) do not have. Use
+/// `SpscQueue` there, which only needs atomic loads and stores.
+///
+/// @tparam kCapacity Must be a power of two.
+template <typename T, size_t kCapacity>
+class MpmcQueue {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  static_assert(kCapacity >= 2 && (kCapacity & (kCapacity - 1)) == 0,
+                "MpmcQueue capacity must be a power of two of at least 2");
+
+  MpmcQueue() {
+    for (size_t i = 0; i < kCapacity; ++i) {
+      sequences_[i].store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcQueue(const MpmcQueue&) = delete;
+  MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+  /// Destroys items that remain in the queue. Must not be called concurrently
+  /// with any other member function.
+  ~MpmcQueue() {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      const size_t end = enqueue_position_.load(std::memory_order_relaxed);
+      for (size_t i = dequeue_position_.load(std::memory_order_relaxed);
+           i != end;
+           ++i) {
+        std::destroy_at(&storage_.data()[i & kMask]);
+      }
+    }
+  }
+
+  /// Constructs an item at the back of the queue.
+  ///
+  /// @returns `false` if the queue is full.
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      const size_t sequence =
+          sequences_[position & kMask].load(std::memory_order_acquire);
+      const auto lag = static_cast<ptrdiff_t>(sequence - position);
+      if (lag == 0) {
+        // The slot is free. Claim it, or retry if another producer did first.
+        if (enqueue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (lag < 0) {
+        return false;  // The slot still holds an item from the last lap.
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+
+    new (&storage_.data()[position & kMask])
+        value_type(std::forward<Args>(args)...);
+    sequences_[position & kMask].store(position + 1,
+                                       std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const value_type& value) { return try_emplace(value); }
+  bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+
+  /// Removes the item at the front of the queue.
+  ///
+  /// @returns The item, or `std::nullopt` if the queue is empty.
+  std::optional<value_type> try_pop() {
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      const size_t sequence =
+          sequences_[position & kMask].load(std::memory_order_acquire);
+      const auto lag = static_cast<ptrdiff_t>(sequence - (position + 1));
+      if (lag == 0) {
+        // The slot holds an item. Claim it, or retry if another consumer did
+        // first.
+        if (dequeue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (lag < 0) {
+        return std::nullopt;  // The slot has not been published yet.
+      } else {
+        position = dequeue_position_.load(std::memory_order_relaxed);
+      }
+    }
+
+    value_type& item = storage_.data()[position & kMask];
+    std::optional<value_type> value(std::move(item));
+    std::destroy_at(&item);
+    // Free the slot for the producer that reaches it on the next lap.
+    sequences_[position & kMask].store(position + kCapacity,
+                                       std::memory_order_release);
+    return value;
+  }
+
+  // Capacity. When the queue is in use, these are only snapshots: they may be
+  // out of date by the time they return.
+
+  bool empty() const { return size() == 0; }
+
+  size_type size() const {
+    // Read the dequeue position first so that it cannot pass the enqueue
+    // position. Operations between the two reads may overstate the size, so it
+    // is capped at the capacity.
+    const size_t dequeued = dequeue_position_.load(std::memory_order_acquire);
+    const size_t enqueued = enqueue_position_.load(std::memory_order_acquire);
+    const size_t size = enqueued - dequeued;
+    return size < kCapacity ? size : kCapacity;
+  }
+
+  static constexpr size_type max_size() { return kCapacity; }
+
+ private:
+  static constexpr size_t kMask = kCapacity - 1;
+
+  // Positions count pushes and pops since construction; they are reduced to
+  // slot indices with kMask.
+  std::atomic<size_t> enqueue_position_{0};
+  std::atomic<size_t> dequeue_position_{0};
+
+  // A slot is free for the push at position p when its sequence is p, and
+  // holds the item for the pop at position p when its sequence is p + 1.
+  std::array<std::atomic<size_t>, kCapacity> sequences_;
+
+  internal::RawStorage<value_type, kCapacity> storage_;
+};
+
+}  // namespace pw::containers
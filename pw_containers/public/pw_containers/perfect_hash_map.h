@@ -0,0 +1,254 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "pw_assert/assert.h"
+#include "pw_containers/flat_map.h"
+
+namespace pw::containers {
+
+/// A fixed-size, read-only associative array with lookups that hash the key
+/// once and compare it against a single entry.
+///
+/// `PerfectHashMap` is meant for static lookup tables such as error code
+/// descriptions, register maps, and command handlers. It is built from a list
+/// of key-value pairs, usually at compile time:
+///
+/// @code{.cpp}
+///   constexpr auto kRegisters =
+///       pw::containers::MakePerfectHashMap<uint16_t, const char*>({
+///           {0x0010, "CTRL"},
+///           {0x0014, "STATUS"},
+///           {0x0100, "FIFO"},
+///       });
+///
+///   static_assert(kRegisters.at(0x0014) == std::string_view("STATUS"));
+/// @endcode
+///
+/// The map is a minimal perfect hash built with the hash-and-displace method.
+/// Keys are split into about `kSize / 3` buckets by one hash. Each bucket then
+/// stores a displacement that sends all of its keys to distinct slots of a
+/// table with exactly `kSize` entries. A lookup hashes the key to find its
+/// bucket, hashes it again with the bucket's displacement to find its slot,
+/// and compares the key stored there. The table costs `kSize` entries plus two
+/// bytes per bucket.
+///
+/// Keys must be integers or enums. Building the map is a compilation error
+/// if used in a constant expression with duplicate keys, and asserts
+/// otherwise.
+template <typename Key, typename Value, size_t kSize>
+class PerfectHashMap {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = Pair<key_type, mapped_type>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using container_type = std::array<value_type, kSize>;
+  using const_iterator = typename container_type::const_iterator;
+
+  static_assert(std::is_integral_v<Key> || std::is_enum_v<Key>,
+                "PerfectHashMap keys must be integers or enums");
+
+  /// Builds the map from a list of key-value pairs.
+  ///
+  /// @pre Keys must be unique.
+  constexpr PerfectHashMap(const container_type& items) : displacements_{} {
+    Build(items);
+  }
+
+  PerfectHashMap(PerfectHashMap&) = delete;
+  PerfectHashMap& operator=(PerfectHashMap&) = delete;
+
+  // Capacity.
+  constexpr size_type size() const { return kSize; }
+  constexpr bool empty() const { return kSize == 0; }
+  constexpr size_type max_size() const { return kSize; }
+
+  // Lookup.
+  constexpr const_iterator find(const key_type& key) const {
+    if constexpr (kSize == 0) {
+      return end();
+    } else {
+      const size_t slot = SlotFor(key);
+      return slots_[slot].first == key ? begin() + slot : end();
+    }
+  }
+
+  constexpr bool contains(const key_type& key) const {
+    return find(key) != end();
+  }
+
+  /// Accesses a mapped value.
+  ///
+  /// @pre The key must exist.
+  constexpr const mapped_type& at(const key_type& key) const {
+    const_iterator it = find(key);
+    PW_ASSERT(it != end());
+    return it->second;
+  }
+
+  // Iterators. Entries are visited in an unspecified order.
+  constexpr const_iterator begin() const { return cbegin(); }
+  constexpr const_iterator cbegin() const { return slots_.cbegin(); }
+  constexpr const_iterator end() const { return cend(); }
+  constexpr const_iterator cend() const { return slots_.cend(); }
+
+ private:
+  // Buckets hold three keys on average. Larger buckets need fewer
+  // displacements but take longer to place.
+  static constexpr size_t kBuckets = kSize == 0 ? 1 : (kSize + 2) / 3;
+
+  // Displacements are tried in order, so this bounds the work done per bucket
+  // when building the map.
+  static constexpr uint32_t kMaxDisplacement = UINT16_MAX;
+
+  static constexpr uint64_t KeyBits(const key_type& key) {
+    if constexpr (std::is_enum_v<key_type>) {
+      return static_cast<uint64_t>(
+          static_cast<std::underlying_type_t<key_type>>(key));
+    } else {
+      return static_cast<uint64_t>(key);
+    }
+  }
+
+  // Mixes the key with a seed using the SplitMix64 finalizer.
+  static constexpr uint32_t Hash(const key_type& key, uint32_t seed) {
+    uint64_t hash = KeyBits(key) + (uint64_t{seed} + 1) * 0x9E3779B97F4A7C15u;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9u;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBu;
+    return static_cast<uint32_t>((hash ^ (hash >> 31)) >> 32);
+  }
+
+  // Maps a hash onto [0, range) with a multiply instead of a division.
+  static constexpr size_t Reduce(uint32_t hash, size_t range) {
+    return static_cast<size_t>((uint64_t{hash} * range) >> 32);
+  }
+
+  static constexpr size_t BucketFor(const key_type& key) {
+    return Reduce(Hash(key, 0), kBuckets);
+  }
+
+  static constexpr size_t SlotFor(const key_type& key, uint32_t displacement) {
+    return Reduce(Hash(key, displacement + 1), kSize);
+  }
+
+  constexpr size_t SlotFor(const key_type& key) const {
+    return SlotFor(key, displacements_[BucketFor(key)]);
+  }
+
+  // Assigns each bucket a displacement that places its keys in unused slots.
+  // Buckets are placed from largest to smallest, since large buckets are the
+  // hardest to fit once the table fills up.
+  constexpr void Build(const container_type& items) {
+    std::array<size_t, kSize> item_buckets{};
+    std::array<size_t, kBuckets> bucket_sizes{};
+    size_t largest_bucket = 0;
+    for (size_t i = 0; i < kSize; ++i) {
+      for (size_t j = 0; j < i; ++j) {
+        PW_ASSERT(items[i].first != items[j].first);  // Keys must be unique.
+      }
+      item_buckets[i] = BucketFor(items[i].first);
+      size_t& bucket_size = bucket_sizes[item_buckets[i]];
+      bucket_size += 1;
+      if (bucket_size > largest_bucket) {
+        largest_bucket = bucket_size;
+      }
+    }
+
+    std::array<bool, kSize> used{};
+    std::array<size_t, kSize> bucket_items{};
+    std::array<size_t, kSize> bucket_slots{};
+
+    for (size_t size = largest_bucket; size > 0; --size) {
+      for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        if (bucket_sizes[bucket] != size) {
+          continue;
+        }
+
+        size_t count = 0;
+        for (size_t i = 0; i < kSize; ++i) {
+          if (item_buckets[i] == bucket) {
+            bucket_items[count++] = i;
+          }
+        }
+
+        uint32_t displacement = 0;
+        while (!TryPlace(items,
+                         bucket_items,
+                         count,
+                         displacement,
+                         used,
+                         bucket_slots)) {
+          ++displacement;
+          // No displacement fits this bucket. This is very unlikely unless
+          // the keys are chosen adversarially.
+          PW_ASSERT(displacement <= kMaxDisplacement);
+        }
+
+        displacements_[bucket] = static_cast<uint16_t>(displacement);
+        for (size_t i = 0; i < count; ++i) {
+          used[bucket_slots[i]] = true;
+          slots_[bucket_slots[i]] = items[bucket_items[i]];
+        }
+      }
+    }
+  }
+
+  // Checks whether a displacement sends the bucket's keys to distinct, unused
+  // slots, which are stored in slots.
+  static constexpr bool TryPlace(const container_type& items,
+                                 const std::array<size_t, kSize>& bucket_items,
+                                 size_t count,
+                                 uint32_t displacement,
+                                 const std::array<bool, kSize>& used,
+                                 std::array<size_t, kSize>& slots) {
+    for (size_t i = 0; i < count; ++i) {
+      const size_t slot = SlotFor(items[bucket_items[i]].first, displacement);
+      if (used[slot]) {
+        return false;
+      }
+      for (size_t j = 0; j < i; ++j) {
+        if (slots[j] == slot) {
+          return false;
+        }
+      }
+      slots[i] = slot;
+    }
+    return true;
+  }
+
+  std::array<uint16_t, kBuckets> displacements_;
+  container_type slots_{};
+};
+
+/// Creates a `PerfectHashMap` from a list of key-value pairs.
+///
+/// @pre Keys must be unique.
+template <typename Key, typename Value, size_t kSize>
+constexpr PerfectHashMap<Key, Value, kSize> MakePerfectHashMap(
+    const Pair<Key, Value> (&items)[kSize]) {
+  std::array<Pair<Key, Value>, kSize> array{};
+  for (size_t i = 0; i < kSize; ++i) {
+    array[i] = items[i];
+  }
+  return PerfectHashMap<Key, Value, kSize>(array);
+}
+
+}  // namespace pw::containers
@@ -0,0 +1,151 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "pw_containers/internal/raw_storage.h"
+
+namespace pw::containers {
+
+/// A fixed-capacity, lock-free queue for one producer and one consumer.
+///
+/// One thread or interrupt may push while another pops, without a lock.
+/// Pushing and popping never block: `try_push` fails when the queue is full and
+/// `try_pop` returns `std::nullopt` when it is empty. This makes `SpscQueue`
+/// suitable for passing data from an interrupt handler to a thread, or the
+/// reverse, as long as `std::atomic<size_t>` loads and stores are lock-free on
+/// the target.
+///
+/// @code{.cpp}
+///   pw::containers::SpscQueue<Sample, 32> samples;
+///
+///   void AdcInterruptHandler() {
+///     if (!samples.try_push(ReadSample())) {
+///       dropped_samples += 1;
+///     }
+///   }
+///
+///   void ProcessSamples() {
+///     while (std::optional<Sample> sample = samples.try_pop()) {
+///       Process(*sample);
+///     }
+///   }
+/// @endcode
+///
+/// Only one context may push and only one context may pop at a time. Use
+/// `MpmcQueue` for multiple producers or consumers.
+template <typename T, size_t kCapacity>
+class SpscQueue {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  static_assert(kCapacity > 0, "SpscQueue must have a nonzero capacity");
+
+  constexpr SpscQueue() = default;
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /// Destroys items that remain in the queue. Must not be called concurrently
+  /// with any other member function.
+  ~SpscQueue() {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      const size_t tail = tail_.load(std::memory_order_relaxed);
+      for (size_t i = head_.load(std::memory_order_relaxed); i != tail;
+           i = Next(i)) {
+        std::destroy_at(&storage_.data()[i]);
+      }
+    }
+  }
+
+  // Producer.
+
+  /// Constructs an item at the back of the queue.
+  ///
+  /// @returns `false` if the queue is full.
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t next = Next(tail);
+    if (next == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    new (&storage_.data()[tail]) value_type(std::forward<Args>(args)...);
+    tail_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const value_type& value) { return try_emplace(value); }
+  bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+
+  // Consumer.
+
+  /// Removes the item at the front of the queue.
+  ///
+  /// @returns The item, or `std::nullopt` if the queue is empty.
+  std::optional<value_type> try_pop() {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    value_type& item = storage_.data()[head];
+    std::optional<value_type> value(std::move(item));
+    std::destroy_at(&item);
+    head_.store(Next(head), std::memory_order_release);
+    return value;
+  }
+
+  // Capacity. When the queue is in use, these are only snapshots: they may be
+  // out of date by the time they return.
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  size_type size() const {
+    const size_t head = head_.load(std::memory_order_acquire);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : kSlots - head + tail;
+  }
+
+  static constexpr size_type max_size() { return kCapacity; }
+
+ private:
+  // One slot is always left empty so that a full queue can be told apart from
+  // an empty one without a shared count.
+  static constexpr size_t kSlots = kCapacity + 1;
+
+  static constexpr size_t Next(size_t index) {
+    return index + 1 == kSlots ? 0 : index + 1;
+  }
+
+  // The next slot to pop. Written only by the consumer.
+  std::atomic<size_t> head_{0};
+
+  // The next slot to push. Written only by the producer.
+  std::atomic<size_t> tail_{0};
+
+  internal::RawStorage<value_type, kSlots> storage_;
+};
+
+}  // namespace pw::containers
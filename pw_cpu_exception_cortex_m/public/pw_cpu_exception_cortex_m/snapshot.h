@@ -18,6 +18,7 @@
 #include "pw_cpu_exception_cortex_m/cpu_state.h"
 #include "pw_cpu_exception_cortex_m_protos/cpu_state.pwpb.h"
 #include "pw_protobuf/encoder.h"
+#include "pw_snapshot/raw_snapshot.h"
 #include "pw_status/status.h"
 #include "pw_thread/snapshot.h"
 #include "pw_thread_protos/thread.pwpb.h"
@@ -74,4 +75,34 @@ inline Status SnapshotMainStackThread(
       stack_low_addr, stack_high_addr, encoder, thread_stack_callback);
 }
 
+// Raw snapshot region tags used by CaptureRawSnapshot().
+inline constexpr uint32_t kRawCpuStateTag = 0x434d0001;
+inline constexpr uint32_t kRawMainStackLimitsTag = 0x434d0002;
+inline constexpr uint32_t kRawMainStackTag = 0x434d0003;
+
+// Copies the cpu_state and, if it was active, the used part of the main stack
+// into a raw snapshot. This does no encoding, so it is fast and needs no stack
+// or scratch buffers, which makes it suitable for use directly in the fault
+// handler. If the main stack does not fit, its most recent frames are kept.
+//
+// The writer is not committed, so other regions may be added after this.
+// Convert the regions to protos later with SnapshotFromRawSnapshot().
+Status CaptureRawSnapshot(const pw_cpu_exception_State& cpu_state,
+                          uintptr_t stack_low_addr,
+                          uintptr_t stack_high_addr,
+                          snapshot::RawSnapshotWriter& writer);
+
+// Encodes the regions captured by CaptureRawSnapshot() in the same way as
+// SnapshotCpuState() and SnapshotMainStackThread(). This is typically done on
+// the boot after the fault. The raw snapshot must have been captured by the
+// same firmware, since the cpu state is stored in its in-memory layout.
+//
+// Returns NOT_FOUND if there is no cpu state in the raw snapshot and DATA_LOSS
+// if it is the wrong size.
+Status SnapshotFromRawSnapshot(
+    const snapshot::RawSnapshotReader& raw_snapshot,
+    SnapshotCpuStateOverlay::StreamEncoder& cpu_state_encoder,
+    thread::proto::SnapshotThreadInfo::StreamEncoder& thread_encoder,
+    thread::ProcessThreadStackCallback& thread_stack_callback);
+
 }  // namespace pw::cpu_exception::cortex_m
@@ -16,6 +16,8 @@
 
 #include "pw_cpu_exception_cortex_m/snapshot.h"
 
+#include <cstring>
+
 #include "pw_cpu_exception_cortex_m/proto_dump.h"
 #include "pw_cpu_exception_cortex_m/util.h"
 #include "pw_cpu_exception_cortex_m_private/config.h"
@@ -23,6 +25,8 @@
 #include "pw_cpu_exception_cortex_m_protos/cpu_state.pwpb.h"
 #include "pw_log/log.h"
 #include "pw_protobuf/encoder.h"
+#include "pw_result/result.h"
+#include "pw_snapshot/raw_snapshot.h"
 #include "pw_status/status.h"
 #include "pw_thread/snapshot.h"
 #include "pw_thread_protos/thread.pwpb.h"
@@ -33,16 +37,13 @@ namespace {
 constexpr char kMainStackHandlerModeName[] = "Main Stack (Handler Mode)";
 constexpr char kMainStackThreadModeName[] = "Main Stack (Thread Mode)";
 
-Status CaptureMainStack(
+// Writes the main stack thread's state and name, and returns its context.
+thread::StackContext EncodeMainStackInfo(
     ProcessorMode mode,
     uintptr_t stack_low_addr,
     uintptr_t stack_high_addr,
     uintptr_t stack_pointer,
-    thread::proto::SnapshotThreadInfo::StreamEncoder& snapshot_encoder,
-    thread::ProcessThreadStackCallback& thread_stack_callback) {
-  thread::proto::Thread::StreamEncoder encoder =
-      snapshot_encoder.GetThreadsEncoder();
-
+    thread::proto::Thread::StreamEncoder& encoder) {
   const char* thread_name;
   thread::proto::ThreadState::Enum thread_state;
   if (mode == ProcessorMode::kHandlerMode) {
@@ -59,13 +60,26 @@ Status CaptureMainStack(
   encoder.WriteState(thread_state);
   encoder.WriteName(as_bytes(span(std::string_view(thread_name))));
 
-  const thread::StackContext thread_ctx = {
+  return thread::StackContext{
       .thread_name = thread_name,
       .stack_low_addr = stack_low_addr,
       .stack_high_addr = stack_high_addr,
       .stack_pointer = stack_pointer,
       .stack_pointer_est_peak = std::nullopt,
   };
+}
+
+Status CaptureMainStack(
+    ProcessorMode mode,
+    uintptr_t stack_low_addr,
+    uintptr_t stack_high_addr,
+    uintptr_t stack_pointer,
+    thread::proto::SnapshotThreadInfo::StreamEncoder& snapshot_encoder,
+    thread::ProcessThreadStackCallback& thread_stack_callback) {
+  thread::proto::Thread::StreamEncoder encoder =
+      snapshot_encoder.GetThreadsEncoder();
+  const thread::StackContext thread_ctx = EncodeMainStackInfo(
+      mode, stack_low_addr, stack_high_addr, stack_pointer, encoder);
   return thread::SnapshotStack(thread_ctx, encoder, thread_stack_callback);
 }
 
@@ -145,4 +159,81 @@ Status SnapshotMainStackThread(
                           thread_stack_callback);
 }
 
+Status CaptureRawSnapshot(const pw_cpu_exception_State& cpu_state,
+                          uintptr_t stack_low_addr,
+                          uintptr_t stack_high_addr,
+                          snapshot::RawSnapshotWriter& writer) {
+  Status status = writer.AddRegion(kRawCpuStateTag,
+                                   reinterpret_cast<uintptr_t>(&cpu_state),
+                                   as_bytes(span(&cpu_state, 1)));
+  if (!status.ok() || !MainStackActive(cpu_state)) {
+    return status;
+  }
+
+  const uintptr_t limits[] = {stack_low_addr, stack_high_addr};
+  status = writer.AddRegion(kRawMainStackLimitsTag, 0, as_bytes(span(limits)));
+  if (!status.ok()) {
+    return status;
+  }
+
+  const uintptr_t stack_pointer = cpu_state.extended.msp;
+  if (stack_pointer > stack_high_addr) {
+    return OkStatus();  // Underflowed; reported when the snapshot is encoded.
+  }
+  return writer
+      .AddTruncatedRegion(
+          kRawMainStackTag,
+          stack_pointer,
+          ConstByteSpan(reinterpret_cast<const std::byte*>(stack_pointer),
+                        stack_high_addr - stack_pointer))
+      .status();
+}
+
+Status SnapshotFromRawSnapshot(
+    const snapshot::RawSnapshotReader& raw_snapshot,
+    SnapshotCpuStateOverlay::StreamEncoder& cpu_state_encoder,
+    thread::proto::SnapshotThreadInfo::StreamEncoder& thread_encoder,
+    thread::ProcessThreadStackCallback& thread_stack_callback) {
+  Result<snapshot::RawSnapshotRegion> region =
+      raw_snapshot.Find(kRawCpuStateTag);
+  if (!region.ok()) {
+    return region.status();
+  }
+  pw_cpu_exception_State cpu_state;
+  if (region->data.size() != sizeof(cpu_state)) {
+    return Status::DataLoss();
+  }
+  std::memcpy(&cpu_state, region->data.data(), sizeof(cpu_state));
+
+  Status status = SnapshotCpuState(cpu_state, cpu_state_encoder);
+  if (!status.ok() || !MainStackActive(cpu_state)) {
+    return status;
+  }
+
+  region = raw_snapshot.Find(kRawMainStackLimitsTag);
+  uintptr_t limits[2];
+  if (!region.ok() || region->data.size() != sizeof(limits)) {
+    return Status::DataLoss();
+  }
+  std::memcpy(limits, region->data.data(), sizeof(limits));
+
+  // The stack may be missing if it underflowed, or truncated if it did not fit.
+  ConstByteSpan stack_contents;
+  region = raw_snapshot.Find(kRawMainStackTag);
+  if (region.ok()) {
+    stack_contents = region->data;
+  }
+
+  thread::proto::Thread::StreamEncoder encoder =
+      thread_encoder.GetThreadsEncoder();
+  const thread::StackContext thread_ctx =
+      EncodeMainStackInfo(ActiveProcessorMode(cpu_state),
+                          limits[0],
+                          limits[1],
+                          cpu_state.extended.msp,
+                          encoder);
+  return thread::SnapshotStack(
+      thread_ctx, stack_contents, encoder, thread_stack_callback);
+}
+
 }  // namespace pw::cpu_exception::cortex_m
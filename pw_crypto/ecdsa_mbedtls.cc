@@ -37,52 +37,64 @@ class Defer {
 
 constexpr size_t kP256CurveOrderBytes = 32;
 
-Status VerifyP256Signature(ConstByteSpan public_key,
-                           ConstByteSpan digest,
-                           ConstByteSpan signature) {
+namespace backend {
+
+Status DoLoadP256PublicKey(NativeP256PublicKey& key, ConstByteSpan public_key) {
+  const uint8_t* public_key_data =
+      reinterpret_cast<const uint8_t*>(public_key.data());
+
+  // These init functions never fail.
+  mbedtls_ecp_group_init(&key.grp);
+  mbedtls_ecp_point_init(&key.Q);
+
+  // Load the curve parameters.
+  Status status;
+  if (mbedtls_ecp_group_load(&key.grp, MBEDTLS_ECP_DP_SECP256R1)) {
+    status = Status::Internal();
+  } else if (mbedtls_ecp_point_read_binary(
+                 &key.grp, &key.Q, public_key_data, public_key.size())) {
+    PW_LOG_DEBUG("Bad public key format");
+    status = Status::InvalidArgument();
+  } else if (mbedtls_ecp_check_pubkey(&key.grp, &key.Q)) {
+    PW_LOG_DEBUG("Bad public key curve");
+    status = Status::InvalidArgument();
+  }
+
+  if (!status.ok()) {
+    DoFreeP256PublicKey(key);
+  }
+  return status;
+}
+
+void DoFreeP256PublicKey(NativeP256PublicKey& key) {
+  mbedtls_ecp_group_free(&key.grp);
+  mbedtls_ecp_point_free(&key.Q);
+}
+
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature) {
   // Use a local structure to avoid going over the default inline storage
   // for the `cleanup` callable used below.
   struct {
-    // The elliptic curve group.
-    mbedtls_ecp_group grp;
-    // The public key point.
-    mbedtls_ecp_point Q;
     // The signature (r, s).
     mbedtls_mpi r, s;
   } ctx;
 
-  const uint8_t* public_key_data =
-      reinterpret_cast<const uint8_t*>(public_key.data());
   const uint8_t* digest_data = reinterpret_cast<const uint8_t*>(digest.data());
   const uint8_t* signature_data =
       reinterpret_cast<const uint8_t*>(signature.data());
 
   // These init functions never fail.
-  mbedtls_ecp_group_init(&ctx.grp);
-  mbedtls_ecp_point_init(&ctx.Q);
   mbedtls_mpi_init(&ctx.r);
   mbedtls_mpi_init(&ctx.s);
 
   // Auto clean up on exit.
   Defer cleanup([&ctx](void) {
-    mbedtls_ecp_group_free(&ctx.grp);
-    mbedtls_ecp_point_free(&ctx.Q);
     mbedtls_mpi_free(&ctx.r);
     mbedtls_mpi_free(&ctx.s);
   });
 
-  // Load the curve parameters.
-  if (mbedtls_ecp_group_load(&ctx.grp, MBEDTLS_ECP_DP_SECP256R1)) {
-    return Status::Internal();
-  }
-
-  // Load the public key.
-  if (mbedtls_ecp_point_read_binary(
-          &ctx.grp, &ctx.Q, public_key_data, public_key.size())) {
-    PW_LOG_DEBUG("Bad public key format");
-    return Status::InvalidArgument();
-  }
-
   // Load the signature.
   if (signature.size() != kP256CurveOrderBytes * 2) {
     PW_LOG_DEBUG("Bad signature format");
@@ -102,9 +114,11 @@ Status VerifyP256Signature(ConstByteSpan public_key,
     return Status::InvalidArgument();
   }
 
-  // Verify the signature.
+  // Verify the signature. With MBEDTLS_ECP_FIXED_POINT_OPTIM, the first
+  // verification stores a table of multiples of the generator in the key's
+  // group, which later verifications with the key reuse.
   if (mbedtls_ecdsa_verify(
-          &ctx.grp, digest_data, digest.size(), &ctx.Q, &ctx.r, &ctx.s)) {
+          &key.grp, digest_data, digest.size(), &key.Q, &ctx.r, &ctx.s)) {
     PW_LOG_DEBUG("Signature verification failed");
     return Status::Unauthenticated();
   }
@@ -112,4 +126,6 @@ Status VerifyP256Signature(ConstByteSpan public_key,
   return OkStatus();
 }
 
+}  // namespace backend
+
 }  // namespace pw::crypto::ecdsa
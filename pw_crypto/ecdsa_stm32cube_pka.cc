@@ -0,0 +1,151 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#define PW_LOG_MODULE_NAME "ECDSA-PKA"
+#define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
+
+#include <cstring>
+
+#include "pw_crypto/ecdsa.h"
+#include "pw_log/log.h"
+#include "pw_status/try.h"
+#include "stm32cube/stm32cube.h"
+
+namespace pw::crypto::ecdsa::backend {
+namespace {
+
+constexpr size_t kP256CurveOrderBytes = 32;
+constexpr size_t kP256PublicKeySize = 2 * kP256CurveOrderBytes + 1;
+constexpr size_t kP256SignatureSize = kP256CurveOrderBytes * 2;
+
+// The NIST P256 curve parameters, big endian.
+constexpr uint8_t kModulus[kP256CurveOrderBytes] = {
+    0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+// The absolute value of the coefficient a, which is -3.
+constexpr uint32_t kCoefficientSignNegative = 1;
+constexpr uint8_t kCoefficientA[kP256CurveOrderBytes] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+};
+
+constexpr uint8_t kOrder[kP256CurveOrderBytes] = {
+    0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xbc, 0xe6, 0xfa, 0xad, 0xa7, 0x17,
+    0x9e, 0x84, 0xf3, 0xb9, 0xca, 0xc2, 0xfc, 0x63, 0x25, 0x51,
+};
+
+constexpr uint8_t kGeneratorX[kP256CurveOrderBytes] = {
+    0x6b, 0x17, 0xd1, 0xf2, 0xe1, 0x2c, 0x42, 0x47, 0xf8, 0xbc, 0xe6,
+    0xe5, 0x63, 0xa4, 0x40, 0xf2, 0x77, 0x03, 0x7d, 0x81, 0x2d, 0xeb,
+    0x33, 0xa0, 0xf4, 0xa1, 0x39, 0x45, 0xd8, 0x98, 0xc2, 0x96,
+};
+
+constexpr uint8_t kGeneratorY[kP256CurveOrderBytes] = {
+    0x4f, 0xe3, 0x42, 0xe2, 0xfe, 0x1a, 0x7f, 0x9b, 0x8e, 0xe7, 0xeb,
+    0x4a, 0x7c, 0x0f, 0x9e, 0x16, 0x2b, 0xce, 0x33, 0x57, 0x6b, 0x31,
+    0x5e, 0xce, 0xcb, 0xb6, 0x40, 0x68, 0x37, 0xbf, 0x51, 0xf5,
+};
+
+PKA_HandleTypeDef pka_handle;
+bool pka_initialized = false;
+
+Status InitPka() {
+  if (pka_initialized) {
+    return OkStatus();
+  }
+
+  __HAL_RCC_PKA_CLK_ENABLE();
+  pka_handle.Instance = PKA;
+  if (HAL_PKA_Init(&pka_handle) != HAL_OK) {
+    PW_LOG_DEBUG("Failed to initialize the PKA");
+    return Status::Unavailable();
+  }
+
+  pka_initialized = true;
+  return OkStatus();
+}
+
+}  // namespace
+
+Status DoLoadP256PublicKey(NativeP256PublicKey& key, ConstByteSpan public_key) {
+  // Supports SEC 1 uncompressed form (04||X||Y) only. Checking that the key
+  // is on the curve takes Montgomery parameters that differ between HAL
+  // versions, so only the format is checked.
+  if (public_key.size() != kP256PublicKeySize ||
+      std::to_integer<uint8_t>(public_key.data()[0]) != 0x04) {
+    PW_LOG_DEBUG("Bad public key format");
+    return Status::InvalidArgument();
+  }
+
+  std::memcpy(key.x, public_key.data() + 1, sizeof(key.x));
+  std::memcpy(key.y, public_key.data() + 1 + sizeof(key.x), sizeof(key.y));
+  return OkStatus();
+}
+
+void DoFreeP256PublicKey(NativeP256PublicKey&) {}
+
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature) {
+  // Signature expected in raw format (r||s)
+  if (signature.size() != kP256SignatureSize) {
+    PW_LOG_DEBUG("Bad signature format");
+    return Status::InvalidArgument();
+  }
+
+  // Digests must be at least 32 bytes. Digests longer than 32
+  // bytes are truncated to 32 bytes.
+  if (digest.size() < kP256CurveOrderBytes) {
+    PW_LOG_DEBUG("Digest is too short");
+    return Status::InvalidArgument();
+  }
+
+  PW_TRY(InitPka());
+
+  const uint8_t* signature_bytes =
+      reinterpret_cast<const uint8_t*>(signature.data());
+
+  PKA_ECDSAVerifInTypeDef in = {};
+  in.primeOrderSize = kP256CurveOrderBytes;
+  in.modulusSize = kP256CurveOrderBytes;
+  in.coefSign = kCoefficientSignNegative;
+  in.coef = kCoefficientA;
+  in.modulus = kModulus;
+  in.basePointX = kGeneratorX;
+  in.basePointY = kGeneratorY;
+  in.pPubKeyCurvePtX = key.x;
+  in.pPubKeyCurvePtY = key.y;
+  in.RSign = signature_bytes;
+  in.SSign = signature_bytes + kP256CurveOrderBytes;
+  in.hash = reinterpret_cast<const uint8_t*>(digest.data());
+  in.primeOrder = kOrder;
+
+  if (HAL_PKA_ECDSAVerif(&pka_handle, &in, HAL_MAX_DELAY) != HAL_OK) {
+    PW_LOG_DEBUG("PKA operation failed");
+    return Status::Internal();
+  }
+
+  if (HAL_PKA_ECDSAVerif_IsValidSignature(&pka_handle) == 0u) {
+    PW_LOG_DEBUG("Signature verification failed");
+    return Status::Unauthenticated();
+  }
+
+  return OkStatus();
+}
+
+}  // namespace pw::crypto::ecdsa::backend
@@ -159,5 +159,63 @@ TEST(EcdsaP256, TamperedPubkey) {
                                   AS_BYTES(TEST_SIGNATURE)));
 }
 
+TEST(EcdsaP256, LoadedKeyVerifiesManySignatures) {
+  P256PublicKey key;
+  ASSERT_OK(key.Load(AS_BYTES(TEST_PUBKEY)));
+  ASSERT_TRUE(key.loaded());
+
+  ASSERT_OK(
+      VerifyP256Signature(key, AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+  ASSERT_EQ(Status::Unauthenticated(),
+            VerifyP256Signature(
+                key, AS_BYTES(TEST_DIGEST), AS_BYTES(TAMPERED_SIGNATURE)));
+  ASSERT_EQ(Status::InvalidArgument(),
+            VerifyP256Signature(
+                key, AS_BYTES(SHORT_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+  ASSERT_OK(
+      VerifyP256Signature(key, AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+}
+
+TEST(EcdsaP256, LoadMalformedPublicKey) {
+  P256PublicKey key;
+  ASSERT_OK(key.Load(AS_BYTES(TEST_PUBKEY)));
+  ASSERT_EQ(Status::InvalidArgument(),
+            key.Load(AS_BYTES(MALFORMED_PUBKEY_MISSING_HEADER)));
+  ASSERT_FALSE(key.loaded());
+  ASSERT_EQ(
+      Status::FailedPrecondition(),
+      VerifyP256Signature(key, AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+}
+
+TEST(EcdsaP256, ClearedKeyIsNotLoaded) {
+  P256PublicKey key;
+  ASSERT_FALSE(key.loaded());
+  ASSERT_OK(key.Load(AS_BYTES(TEST_PUBKEY)));
+  key.Clear();
+  ASSERT_FALSE(key.loaded());
+  ASSERT_EQ(
+      Status::FailedPrecondition(),
+      VerifyP256Signature(key, AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE)));
+}
+
+TEST(EcdsaP256, VerifyManySignatures) {
+  P256PublicKey key;
+  ASSERT_OK(key.Load(AS_BYTES(TEST_PUBKEY)));
+
+  P256Signature signatures[] = {
+      {&key, AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE), Status()},
+      {&key, AS_BYTES(TEST_DIGEST), AS_BYTES(TAMPERED_SIGNATURE), Status()},
+      {nullptr, AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE), Status()},
+      {&key, AS_BYTES(TAMPERED_DIGEST), AS_BYTES(TEST_SIGNATURE), Status()},
+      {&key, AS_BYTES(TEST_DIGEST), AS_BYTES(TEST_SIGNATURE), Status()},
+  };
+  ASSERT_EQ(2u, VerifyP256Signatures(signatures));
+  ASSERT_OK(signatures[0].status);
+  ASSERT_EQ(Status::Unauthenticated(), signatures[1].status);
+  ASSERT_EQ(Status::InvalidArgument(), signatures[2].status);
+  ASSERT_EQ(Status::Unauthenticated(), signatures[3].status);
+  ASSERT_OK(signatures[4].status);
+}
+
 }  // namespace
 }  // namespace pw::crypto::ecdsa
@@ -14,27 +14,22 @@
 #define PW_LOG_MODULE_NAME "ECDSA-UECC"
 #define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
 
+#include <algorithm>
 #include <cstring>
 
 #include "pw_crypto/ecdsa.h"
 #include "pw_log/log.h"
 #include "uECC.h"
 
-namespace pw::crypto::ecdsa {
+namespace pw::crypto::ecdsa::backend {
 
 constexpr size_t kP256CurveOrderBytes = 32;
 constexpr size_t kP256PublicKeySize = 2 * kP256CurveOrderBytes + 1;
 constexpr size_t kP256SignatureSize = kP256CurveOrderBytes * 2;
 
-Status VerifyP256Signature(ConstByteSpan public_key,
-                           ConstByteSpan digest,
-                           ConstByteSpan signature) {
-  // Signature expected in raw format (r||s)
-  if (signature.size() != kP256SignatureSize) {
-    PW_LOG_DEBUG("Bad signature format");
-    return Status::InvalidArgument();
-  }
+static_assert(sizeof(NativeP256PublicKey::point) == kP256PublicKeySize - 1);
 
+Status DoLoadP256PublicKey(NativeP256PublicKey& key, ConstByteSpan public_key) {
   // Supports SEC 1 uncompressed form (04||X||Y) only.
   if (public_key.size() != kP256PublicKeySize ||
       std::to_integer<uint8_t>(public_key.data()[0]) != 0x04) {
@@ -42,59 +37,74 @@ Status VerifyP256Signature(ConstByteSpan public_key,
     return Status::InvalidArgument();
   }
 
+  std::memcpy(key.point, public_key.data() + 1, sizeof(key.point));
 #if defined(uECC_VLI_NATIVE_LITTLE_ENDIAN) && uECC_VLI_NATIVE_LITTLE_ENDIAN
   // uECC_VLI_NATIVE_LITTLE_ENDIAN is defined with a non-zero value when
   // pw_crypto_ECDSA_BACKEND is set to "//pw_crypto:ecdsa_uecc_little_endian".
   //
   // Since pw_crypto APIs are big endian only (standard practice), here we
-  // need to convert input parameters to little endian.
+  // need to convert the key to little endian, once for all signatures it
+  // verifies.
+  std::reverse(key.point, key.point + kP256CurveOrderBytes);  // X
+  std::reverse(key.point + kP256CurveOrderBytes,
+               key.point + sizeof(key.point));  // Y
+#endif  // uECC_VLI_NATIVE_LITTLE_ENDIAN
+
+  // Make sure the public key is on the curve.
+  if (!uECC_valid_public_key(key.point, uECC_secp256r1())) {
+    PW_LOG_DEBUG("Bad public key curve");
+    return Status::InvalidArgument();
+  }
+
+  return OkStatus();
+}
+
+void DoFreeP256PublicKey(NativeP256PublicKey&) {}
+
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature) {
+  // Signature expected in raw format (r||s)
+  if (signature.size() != kP256SignatureSize) {
+    PW_LOG_DEBUG("Bad signature format");
+    return Status::InvalidArgument();
+  }
+
+  // Digests must be at least 32 bytes. Digests longer than 32
+  // bytes are truncated to 32 bytes.
+  if (digest.size() < kP256CurveOrderBytes) {
+    PW_LOG_DEBUG("Digest is too short");
+    return Status::InvalidArgument();
+  }
+
+#if defined(uECC_VLI_NATIVE_LITTLE_ENDIAN) && uECC_VLI_NATIVE_LITTLE_ENDIAN
+  // Convert the signature and digest to little endian.
   //
   // Additionally uECC requires these little endian buffers to be word aligned
   // in case unaligned accesses are not supported by the hardware. We choose
   // the maximum 8-byte alignment to avoid referrencing internal uECC headers.
   alignas(8) uint8_t signature_bytes[kP256SignatureSize];
-  memcpy(signature_bytes, signature.data(), sizeof(signature_bytes));
+  std::memcpy(signature_bytes, signature.data(), sizeof(signature_bytes));
   std::reverse(signature_bytes, signature_bytes + kP256CurveOrderBytes);  // r
   std::reverse(signature_bytes + kP256CurveOrderBytes,
                signature_bytes + sizeof(signature_bytes));  // s
 
-  alignas(8) uint8_t public_key_bytes[kP256PublicKeySize - 1];
-  memcpy(public_key_bytes, public_key.data() + 1, sizeof(public_key_bytes));
-  std::reverse(public_key_bytes, public_key_bytes + kP256CurveOrderBytes);  // X
-  std::reverse(public_key_bytes + kP256CurveOrderBytes,
-               public_key_bytes + sizeof(public_key_bytes));  // Y
-
   alignas(8) uint8_t digest_bytes[kP256CurveOrderBytes];
-  memcpy(digest_bytes, digest.data(), sizeof(digest_bytes));
+  std::memcpy(digest_bytes, digest.data(), sizeof(digest_bytes));
   std::reverse(digest_bytes, digest_bytes + sizeof(digest_bytes));
 #else
-  const uint8_t* public_key_bytes =
-      reinterpret_cast<const uint8_t*>(public_key.data()) + 1;
   const uint8_t* digest_bytes = reinterpret_cast<const uint8_t*>(digest.data());
   const uint8_t* signature_bytes =
       reinterpret_cast<const uint8_t*>(signature.data());
 #endif  // uECC_VLI_NATIVE_LITTLE_ENDIAN
 
-  uECC_Curve curve = uECC_secp256r1();
-  // Make sure the public key is on the curve.
-  if (!uECC_valid_public_key(public_key_bytes, curve)) {
-    PW_LOG_DEBUG("Bad public key curve");
-    return Status::InvalidArgument();
-  }
-
-  // Digests must be at least 32 bytes. Digests longer than 32
-  // bytes are truncated to 32 bytes.
-  if (digest.size() < kP256CurveOrderBytes) {
-    PW_LOG_DEBUG("Digest is too short");
-    return Status::InvalidArgument();
-  }
-
-  // Verify the signature.
-  if (!uECC_verify(public_key_bytes,
+  // Verify the signature, passing only the 32 bytes of the digest that are
+  // used.
+  if (!uECC_verify(key.point,
                    digest_bytes,
-                   digest.size(),
+                   kP256CurveOrderBytes,
                    signature_bytes,
-                   curve)) {
+                   uECC_secp256r1())) {
     PW_LOG_DEBUG("Signature verification failed");
     return Status::Unauthenticated();
   }
@@ -102,4 +112,4 @@ Status VerifyP256Signature(ConstByteSpan public_key,
   return OkStatus();
 }
 
-}  // namespace pw::crypto::ecdsa
+}  // namespace pw::crypto::ecdsa::backend
@@ -14,11 +14,101 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "pw_bytes/span.h"
+#include "pw_crypto/ecdsa_backend.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 
 namespace pw::crypto::ecdsa {
 
+namespace backend {
+
+// Primitive operations to be implemented by backends.
+//
+// DoLoadP256PublicKey() is only called on a key that is not loaded, and
+// DoFreeP256PublicKey() only on a key that DoLoadP256PublicKey() loaded
+// successfully. DoLoadP256PublicKey() must release anything it acquired if it
+// fails.
+Status DoLoadP256PublicKey(NativeP256PublicKey& key, ConstByteSpan public_key);
+void DoFreeP256PublicKey(NativeP256PublicKey& key);
+Status DoVerifyP256Signature(NativeP256PublicKey& key,
+                             ConstByteSpan digest,
+                             ConstByteSpan signature);
+
+}  // namespace backend
+
+// P256PublicKey holds a public key that was parsed and validated once, along
+// with any precomputation the backend keeps for it. Keys that verify many
+// signatures, such as the root keys checked at every boot and update, should
+// be loaded once and kept.
+//
+// Backends may update their precomputation while verifying, so a key must not
+// be used by several threads at once.
+//
+// Usage:
+//
+// P256PublicKey root_key;
+// if (!root_key.Load(public_key).ok()) {
+//   // Error handling.
+// }
+// if (!VerifyP256Signature(root_key, digest, signature).ok()) {
+//   // Error handling.
+// }
+class P256PublicKey {
+ public:
+  P256PublicKey() = default;
+  ~P256PublicKey() { Clear(); }
+
+  P256PublicKey(const P256PublicKey&) = delete;
+  P256PublicKey& operator=(const P256PublicKey&) = delete;
+
+  // Load parses and validates `public_key`, replacing any key loaded before.
+  // The key is in the form `VerifyP256Signature()` takes.
+  //
+  // Returns Status::OkStatus() if the key was loaded, or
+  // Status::InvalidArgument() if the key is malformed or not on the curve.
+  Status Load(ConstByteSpan public_key) {
+    Clear();
+    PW_TRY(backend::DoLoadP256PublicKey(native_key_, public_key));
+    loaded_ = true;
+    return OkStatus();
+  }
+
+  // Clear releases the loaded key, if any.
+  void Clear() {
+    if (loaded_) {
+      backend::DoFreeP256PublicKey(native_key_);
+      loaded_ = false;
+    }
+  }
+
+  bool loaded() const { return loaded_; }
+
+ private:
+  friend Status VerifyP256Signature(const P256PublicKey& public_key,
+                                    ConstByteSpan digest,
+                                    ConstByteSpan signature);
+
+  mutable backend::NativeP256PublicKey native_key_;
+  bool loaded_ = false;
+};
+
+// VerifyP256Signature verifies the `signature` of `digest` using a loaded
+// `public_key`, with the same arguments and results as the overload that takes
+// the key's bytes. Returns Status::FailedPrecondition() if no key is loaded.
+inline Status VerifyP256Signature(const P256PublicKey& public_key,
+                                  ConstByteSpan digest,
+                                  ConstByteSpan signature) {
+  if (!public_key.loaded()) {
+    return Status::FailedPrecondition();
+  }
+  return backend::DoVerifyP256Signature(
+      public_key.native_key_, digest, signature);
+}
+
 // VerifyP256Signature verifies the `signature` of `digest` using `public_key`.
 //
 // `public_key` is a byte string in SEC 1 uncompressed form (0x04||X||Y), which
@@ -31,8 +121,42 @@ namespace pw::crypto::ecdsa {
 //
 // Returns Status::OkStatus() for a successful verification, or an error Status
 // otherwise.
-Status VerifyP256Signature(ConstByteSpan public_key,
-                           ConstByteSpan digest,
-                           ConstByteSpan signature);
+inline Status VerifyP256Signature(ConstByteSpan public_key,
+                                  ConstByteSpan digest,
+                                  ConstByteSpan signature) {
+  P256PublicKey key;
+  PW_TRY(key.Load(public_key));
+  return VerifyP256Signature(key, digest, signature);
+}
+
+// A signature to verify with `VerifyP256Signatures()`.
+struct P256Signature {
+  const P256PublicKey* public_key;
+  ConstByteSpan digest;
+  ConstByteSpan signature;
+
+  // Set to the result of verifying the signature.
+  Status status;
+};
+
+// VerifyP256Signatures verifies several signatures in one pass, such as the
+// signatures of TUF metadata, and sets the `status` of each. Signatures may
+// share a `P256PublicKey`, so each key is only parsed and validated once.
+//
+// Returns the number of signatures that were verified successfully.
+inline size_t VerifyP256Signatures(span<P256Signature> signatures) {
+  size_t verified = 0;
+  for (P256Signature& signature : signatures) {
+    signature.status = signature.public_key == nullptr
+                           ? Status::InvalidArgument()
+                           : VerifyP256Signature(*signature.public_key,
+                                                 signature.digest,
+                                                 signature.signature);
+    if (signature.status.ok()) {
+      verified += 1;
+    }
+  }
+  return verified;
+}
 
 }  // namespace pw::crypto::ecdsa
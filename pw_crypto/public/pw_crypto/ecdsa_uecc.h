@@ -0,0 +1,28 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace pw::crypto::ecdsa::backend {
+
+struct NativeP256PublicKey {
+  // The X and Y coordinates of a public key that is on the curve, in the byte
+  // order micro-ecc is configured for. Aligned for the little endian
+  // configuration, which accesses it by word.
+  alignas(8) uint8_t point[64];
+};
+
+}  // namespace pw::crypto::ecdsa::backend
@@ -0,0 +1,41 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Whether the backend uses the SHA256 instructions of the processor it runs
+// on: the ARMv8 Cryptographic Extension when the compiler targets it, and the
+// x86 SHA extensions (SHA-NI) when the running processor reports them.
+// Disabling this always uses the portable implementation.
+#ifndef PW_CRYPTO_SHA256_ACCELERATED_USE_CPU_EXTENSIONS
+#define PW_CRYPTO_SHA256_ACCELERATED_USE_CPU_EXTENSIONS 1
+#endif  // PW_CRYPTO_SHA256_ACCELERATED_USE_CPU_EXTENSIONS
+
+namespace pw::crypto::sha256::backend {
+
+// Size in bytes of the blocks the SHA256 compression function consumes.
+inline constexpr size_t kBlockSizeBytes = 64;
+
+struct NativeSha256Context {
+  // Intermediate hash value, H0 to H7.
+  uint32_t state[8];
+  // Number of bytes hashed so far, including those in `buffer`.
+  uint64_t length_bytes;
+  // Input that does not yet fill a whole block.
+  std::byte buffer[kBlockSizeBytes];
+};
+
+}  // namespace pw::crypto::sha256::backend
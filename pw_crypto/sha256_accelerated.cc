@@ -0,0 +1,338 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "SHA256-ACCEL"
+#define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_crypto/sha256.h"
+#include "pw_status/status.h"
+
+#if PW_CRYPTO_SHA256_ACCELERATED_USE_CPU_EXTENSIONS && \
+    defined(__ARM_FEATURE_SHA2)
+#define PW_CRYPTO_SHA256_ARMV8 1
+#include <arm_neon.h>
+#else
+#define PW_CRYPTO_SHA256_ARMV8 0
+#endif
+
+#if PW_CRYPTO_SHA256_ACCELERATED_USE_CPU_EXTENSIONS && \
+    (defined(__x86_64__) || defined(__i386__)) &&      \
+    (defined(__GNUC__) || defined(__clang__))
+#define PW_CRYPTO_SHA256_SHA_NI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define PW_CRYPTO_SHA256_SHA_NI 0
+#endif
+
+namespace pw::crypto::sha256::backend {
+namespace {
+
+constexpr uint32_t kInitialState[8] = {
+    0x6a09e667,
+    0xbb67ae85,
+    0x3c6ef372,
+    0xa54ff53a,
+    0x510e527f,
+    0x9b05688c,
+    0x1f83d9ab,
+    0x5be0cd19,
+};
+
+// Aligned for 128-bit vector loads.
+alignas(16) constexpr uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+uint32_t LoadBigEndian(const std::byte* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) |
+         (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+void StoreBigEndian(uint32_t value, std::byte* data) {
+  data[0] = static_cast<std::byte>(value >> 24);
+  data[1] = static_cast<std::byte>(value >> 16);
+  data[2] = static_cast<std::byte>(value >> 8);
+  data[3] = static_cast<std::byte>(value);
+}
+
+constexpr uint32_t RotateRight(uint32_t value, int bits) {
+  return (value >> bits) | (value << (32 - bits));
+}
+
+// FIPS 180-4 section 6.2.2. The message schedule is kept in a 16 word window
+// to limit stack use on targets that take this path.
+void CompressPortable(uint32_t state[8], const std::byte* data, size_t blocks) {
+  for (; blocks > 0; --blocks, data += kBlockSizeBytes) {
+    uint32_t w[16];
+    for (size_t i = 0; i < 16; ++i) {
+      w[i] = LoadBigEndian(data + 4 * i);
+    }
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    uint32_t f = state[5];
+    uint32_t g = state[6];
+    uint32_t h = state[7];
+
+    for (size_t i = 0; i < 64; ++i) {
+      if (i >= 16) {
+        const uint32_t w15 = w[(i - 15) % 16];
+        const uint32_t w2 = w[(i - 2) % 16];
+        const uint32_t s0 =
+            RotateRight(w15, 7) ^ RotateRight(w15, 18) ^ (w15 >> 3);
+        const uint32_t s1 =
+            RotateRight(w2, 17) ^ RotateRight(w2, 19) ^ (w2 >> 10);
+        w[i % 16] += s0 + w[(i - 7) % 16] + s1;
+      }
+
+      const uint32_t sum1 =
+          RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+      const uint32_t choice = (e & f) ^ (~e & g);
+      const uint32_t t1 = h + sum1 + choice + kRoundConstants[i] + w[i % 16];
+      const uint32_t sum0 =
+          RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+      const uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+      const uint32_t t2 = sum0 + majority;
+
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+}
+
+#if PW_CRYPTO_SHA256_ARMV8
+
+// Uses the SHA256H, SHA256H2, SHA256SU0 and SHA256SU1 instructions, which
+// each perform four rounds or schedule four message words.
+void CompressArmv8(uint32_t state[8], const std::byte* data, size_t blocks) {
+  uint32x4_t abcd = vld1q_u32(&state[0]);
+  uint32x4_t efgh = vld1q_u32(&state[4]);
+
+  for (; blocks > 0; --blocks, data += kBlockSizeBytes) {
+    const uint32x4_t abcd_saved = abcd;
+    const uint32x4_t efgh_saved = efgh;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+
+    uint32x4_t w[4];
+    for (size_t i = 0; i < 16; ++i) {
+      uint32x4_t& words = w[i % 4];
+      if (i < 4) {
+        words = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(bytes + 16 * i)));
+      } else {
+        words = vsha256su1q_u32(vsha256su0q_u32(words, w[(i + 1) % 4]),
+                                w[(i + 2) % 4],
+                                w[(i + 3) % 4]);
+      }
+
+      const uint32x4_t schedule =
+          vaddq_u32(words, vld1q_u32(&kRoundConstants[4 * i]));
+      const uint32x4_t abcd_before = abcd;
+      abcd = vsha256hq_u32(abcd, efgh, schedule);
+      efgh = vsha256h2q_u32(efgh, abcd_before, schedule);
+    }
+
+    abcd = vaddq_u32(abcd, abcd_saved);
+    efgh = vaddq_u32(efgh, efgh_saved);
+  }
+
+  vst1q_u32(&state[0], abcd);
+  vst1q_u32(&state[4], efgh);
+}
+
+#endif  // PW_CRYPTO_SHA256_ARMV8
+
+#if PW_CRYPTO_SHA256_SHA_NI
+
+// Uses the SHA256RNDS2, SHA256MSG1 and SHA256MSG2 instructions. The state is
+// kept in the ABEF and CDGH word order SHA256RNDS2 operates on. Compiled for
+// these instructions regardless of the build flags; only called once
+// ShaNiSupported() confirms the processor has them.
+__attribute__((target("sha,sse4.1,ssse3"))) void CompressShaNi(
+    uint32_t state[8], const std::byte* data, size_t blocks) {
+  const __m128i byte_swap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+
+  const __m128i dcba =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+  const __m128i hgfe =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+  const __m128i cdab = _mm_shuffle_epi32(dcba, 0xb1);
+  const __m128i efgh = _mm_shuffle_epi32(hgfe, 0x1b);
+  __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+  __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+  for (; blocks > 0; --blocks, data += kBlockSizeBytes) {
+    const __m128i abef_saved = abef;
+    const __m128i cdgh_saved = cdgh;
+
+    __m128i w[4];
+    for (size_t i = 0; i < 16; ++i) {
+      __m128i& words = w[i % 4];
+      if (i < 4) {
+        words = _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i)),
+            byte_swap);
+      } else {
+        words = _mm_sha256msg2_epu32(
+            _mm_add_epi32(_mm_sha256msg1_epu32(words, w[(i + 1) % 4]),
+                          _mm_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4)),
+            w[(i + 3) % 4]);
+      }
+
+      const __m128i schedule = _mm_add_epi32(
+          words,
+          _mm_load_si128(
+              reinterpret_cast<const __m128i*>(&kRoundConstants[4 * i])));
+      cdgh = _mm_sha256rnds2_epu32(cdgh, abef, schedule);
+      abef = _mm_sha256rnds2_epu32(
+          abef, cdgh, _mm_shuffle_epi32(schedule, 0x0e));
+    }
+
+    abef = _mm_add_epi32(abef, abef_saved);
+    cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+  }
+
+  const __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+  const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]),
+                   _mm_blend_epi16(feba, dchg, 0xf0));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]),
+                   _mm_alignr_epi8(dchg, feba, 8));
+}
+
+bool ShaNiSupported() {
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 ||
+      (ecx & bit_SSSE3) == 0 || (ecx & bit_SSE4_1) == 0) {
+    return false;
+  }
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+    return false;
+  }
+  return (ebx & (1u << 29)) != 0;  // CPUID.(EAX=7,ECX=0):EBX.SHA
+}
+
+#endif  // PW_CRYPTO_SHA256_SHA_NI
+
+// Hashes whole blocks into the state with the fastest implementation
+// available.
+void Compress(uint32_t state[8], const std::byte* data, size_t blocks) {
+#if PW_CRYPTO_SHA256_ARMV8
+  CompressArmv8(state, data, blocks);
+#else
+#if PW_CRYPTO_SHA256_SHA_NI
+  static const bool sha_ni_supported = ShaNiSupported();
+  if (sha_ni_supported) {
+    CompressShaNi(state, data, blocks);
+    return;
+  }
+#endif  // PW_CRYPTO_SHA256_SHA_NI
+  CompressPortable(state, data, blocks);
+#endif  // PW_CRYPTO_SHA256_ARMV8
+}
+
+}  // namespace
+
+Status DoInit(NativeSha256Context& ctx) {
+  std::copy(std::begin(kInitialState), std::end(kInitialState), ctx.state);
+  ctx.length_bytes = 0;
+  return OkStatus();
+}
+
+Status DoUpdate(NativeSha256Context& ctx, ConstByteSpan data) {
+  size_t buffered = ctx.length_bytes % kBlockSizeBytes;
+  ctx.length_bytes += data.size();
+
+  // Complete a partial block left by previous updates first.
+  if (buffered != 0) {
+    const size_t copied = std::min(kBlockSizeBytes - buffered, data.size());
+    std::memcpy(&ctx.buffer[buffered], data.data(), copied);
+    data = data.subspan(copied);
+    buffered += copied;
+    if (buffered < kBlockSizeBytes) {
+      return OkStatus();
+    }
+    Compress(ctx.state, ctx.buffer, 1);
+  }
+
+  // Hash whole blocks directly from the input, without copying them.
+  const size_t blocks = data.size() / kBlockSizeBytes;
+  if (blocks != 0) {
+    Compress(ctx.state, data.data(), blocks);
+    data = data.subspan(blocks * kBlockSizeBytes);
+  }
+
+  std::memcpy(ctx.buffer, data.data(), data.size());
+  return OkStatus();
+}
+
+Status DoFinal(NativeSha256Context& ctx, ByteSpan out_digest) {
+  // Pad with a 1 bit, zeros and the message length in bits, big endian.
+  constexpr size_t kLengthOffset = kBlockSizeBytes - sizeof(uint64_t);
+  const uint64_t length_bits = ctx.length_bytes * 8;
+  size_t buffered = ctx.length_bytes % kBlockSizeBytes;
+
+  ctx.buffer[buffered++] = std::byte{0x80};
+  if (buffered > kLengthOffset) {
+    std::memset(&ctx.buffer[buffered], 0, kBlockSizeBytes - buffered);
+    Compress(ctx.state, ctx.buffer, 1);
+    buffered = 0;
+  }
+  std::memset(&ctx.buffer[buffered], 0, kLengthOffset - buffered);
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    ctx.buffer[kLengthOffset + i] =
+        static_cast<std::byte>(length_bits >> (56 - 8 * i));
+  }
+  Compress(ctx.state, ctx.buffer, 1);
+
+  for (size_t i = 0; i < 8; ++i) {
+    StoreBigEndian(ctx.state[i], &out_digest[4 * i]);
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::crypto::sha256::backend
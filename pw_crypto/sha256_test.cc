@@ -14,6 +14,8 @@
 
 #include "pw_crypto/sha256.h"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 
 #include "gtest/gtest.h"
@@ -38,6 +40,29 @@ namespace {
   "\xe3\xb0\xc4\x42\x98\xfc\x1c\x14\x9a\xfb\xf4\xc8\x99\x6f\xb9\x24" \
   "\x27\xae\x41\xe4\x64\x9b\x93\x4c\xa4\x95\x99\x1b\x78\x52\xb8\x55"
 
+// 112 bytes, so the padding spills into a third block. Generated in Python
+// with `hashlib.sha256(TWO_BLOCK_MESSAGE.encode('ascii')).hexdigest()`.
+#define TWO_BLOCK_MESSAGE                                              \
+  "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno" \
+  "ijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu"
+#define SHA256_HASH_OF_TWO_BLOCK_MESSAGE                             \
+  "\xcf\x5b\x16\xa7\x78\xaf\x83\x80\x03\x6c\xe5\x9e\x7b\x04\x92\x37" \
+  "\x0b\x24\x9b\x11\xe8\xf0\x7a\x51\xaf\xac\x45\x03\x7a\xfe\xe9\xd1"
+
+// Generated in Python with
+// `hashlib.sha256(bytes(i % 256 for i in range(1000))).hexdigest()`.
+#define SHA256_HASH_OF_COUNTING_BYTES                                \
+  "\xa8\xaf\x09\x9b\xf2\xe8\x78\x60\x95\x58\xdb\xf6\x9d\x8f\x88\xf4" \
+  "\xa3\x10\x40\xa8\xcf\x84\xb5\x49\xa0\xcf\xa9\x12\xf1\x2f\xfc\x3f"
+
+std::array<std::byte, 1000> CountingBytes() {
+  std::array<std::byte, 1000> bytes;
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<std::byte>(i);
+  }
+  return bytes;
+}
+
 TEST(Hash, ComputesCorrectDigest) {
   std::byte digest[kDigestSizeBytes];
 
@@ -124,6 +149,31 @@ TEST(Sha256, AllowsMultipleUpdates) {
             std::memcmp(digest, SHA256_HASH_OF_HELLO_PIGWEED, sizeof(digest)));
 }
 
+TEST(Hash, ComputesCorrectDigestOfMultipleBlocks) {
+  std::byte digest[kDigestSizeBytes];
+  ASSERT_OK(Hash(AS_BYTES(TWO_BLOCK_MESSAGE), digest));
+  ASSERT_EQ(
+      0, std::memcmp(digest, SHA256_HASH_OF_TWO_BLOCK_MESSAGE, sizeof(digest)));
+}
+
+TEST(Sha256, AllowsUpdatesNotAlignedToBlocks) {
+  const std::array<std::byte, 1000> message = CountingBytes();
+
+  // Exercise updates that fill, straddle and skip over partial blocks.
+  for (size_t chunk_size : {1u, 7u, 63u, 64u, 65u, 300u, 1000u}) {
+    Sha256 sha256;
+    for (size_t offset = 0; offset < message.size(); offset += chunk_size) {
+      sha256.Update(span(message).subspan(
+          offset, std::min(chunk_size, message.size() - offset)));
+    }
+
+    std::byte digest[kDigestSizeBytes];
+    ASSERT_OK(sha256.Final(digest));
+    EXPECT_EQ(
+        0, std::memcmp(digest, SHA256_HASH_OF_COUNTING_BYTES, sizeof(digest)));
+  }
+}
+
 TEST(Sha256, NoFinalAfterFinal) {
   std::byte digest[kDigestSizeBytes];
   auto h = Sha256();
@@ -0,0 +1,167 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_digital_io/edge_capture.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_status/status.h"
+
+namespace pw::digital_io {
+namespace {
+
+// A clock that advances one tick each time it is read.
+struct TestClock {
+  using rep = int64_t;
+  using period = std::micro;
+  using duration = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<TestClock>;
+
+  static time_point now() { return time_point(duration(ticks++)); }
+
+  static inline rep ticks = 0;
+};
+
+// Stores the interrupt handler so tests can fire edges.
+class FakeDigitalInterrupt : public DigitalInterrupt {
+ public:
+  void Fire(State state) {
+    ASSERT_TRUE(handler_enabled);
+    handler_(state);
+  }
+
+  InterruptTrigger trigger = InterruptTrigger::kActivatingEdge;
+  bool handler_enabled = false;
+  bool has_handler() const { return handler_ != nullptr; }
+
+ private:
+  Status DoEnable(bool) override { return OkStatus(); }
+
+  Status DoSetInterruptHandler(InterruptTrigger new_trigger,
+                               InterruptHandler&& handler) override {
+    trigger = new_trigger;
+    handler_ = std::move(handler);
+    return OkStatus();
+  }
+
+  Status DoEnableInterruptHandler(bool enable) override {
+    handler_enabled = enable;
+    return OkStatus();
+  }
+
+  InterruptHandler handler_;
+};
+
+using TestEdge = BasicEdge<TestClock>;
+
+class EdgeCaptureTest : public ::testing::Test {
+ protected:
+  EdgeCaptureTest() {
+    TestClock::ticks = 0;
+    EXPECT_EQ(line_.Enable(), OkStatus());
+  }
+
+  FakeDigitalInterrupt line_;
+  EdgeCaptureBuffer<4, TestClock> capture_;
+};
+
+TEST_F(EdgeCaptureTest, StartAndStop) {
+  ASSERT_EQ(capture_.Start(line_), OkStatus());
+  EXPECT_EQ(line_.trigger, InterruptTrigger::kBothEdges);
+  EXPECT_TRUE(line_.handler_enabled);
+  EXPECT_EQ(capture_.Start(line_), Status::FailedPrecondition());
+
+  ASSERT_EQ(capture_.Stop(), OkStatus());
+  EXPECT_FALSE(line_.handler_enabled);
+  EXPECT_FALSE(line_.has_handler());
+  EXPECT_EQ(capture_.Stop(), OkStatus());
+}
+
+TEST_F(EdgeCaptureTest, RecordsTimestampedEdges) {
+  ASSERT_EQ(capture_.Start(line_, InterruptTrigger::kActivatingEdge),
+            OkStatus());
+  EXPECT_EQ(line_.trigger, InterruptTrigger::kActivatingEdge);
+  line_.Fire(State::kActive);
+  line_.Fire(State::kInactive);
+  line_.Fire(State::kActive);
+  EXPECT_EQ(capture_.size(), 3u);
+
+  std::array<TestEdge, 2> edges;
+  ASSERT_EQ(capture_.Read(edges), 2u);
+  EXPECT_EQ(edges[0].timestamp.time_since_epoch().count(), 0);
+  EXPECT_EQ(edges[0].state, State::kActive);
+  EXPECT_EQ(edges[1].timestamp.time_since_epoch().count(), 1);
+  EXPECT_EQ(edges[1].state, State::kInactive);
+
+  ASSERT_EQ(capture_.Read(edges), 1u);
+  EXPECT_EQ(edges[0].timestamp.time_since_epoch().count(), 2);
+  EXPECT_EQ(edges[0].state, State::kActive);
+  EXPECT_EQ(capture_.Read(edges), 0u);
+}
+
+TEST_F(EdgeCaptureTest, DropsEdgesWhenFull) {
+  ASSERT_EQ(capture_.Start(line_), OkStatus());
+  for (int i = 0; i < 6; ++i) {
+    line_.Fire(i % 2 == 0 ? State::kActive : State::kInactive);
+  }
+  EXPECT_EQ(capture_.size(), capture_.capacity());
+  EXPECT_EQ(capture_.TakeDropCount(), 2u);
+  EXPECT_EQ(capture_.TakeDropCount(), 0u);
+
+  // The oldest edges are kept.
+  std::array<TestEdge, 4> edges;
+  ASSERT_EQ(capture_.Read(edges), 4u);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(edges[i].timestamp.time_since_epoch().count(), i);
+  }
+}
+
+TEST_F(EdgeCaptureTest, WrapsAround) {
+  ASSERT_EQ(capture_.Start(line_), OkStatus());
+  std::array<TestEdge, 3> edges;
+  for (int round = 0; round < 5; ++round) {
+    line_.Fire(State::kActive);
+    line_.Fire(State::kInactive);
+    line_.Fire(State::kActive);
+    ASSERT_EQ(capture_.Read(edges), 3u);
+    EXPECT_EQ(edges[2].timestamp.time_since_epoch().count(), round * 3 + 2);
+  }
+  EXPECT_EQ(capture_.TakeDropCount(), 0u);
+}
+
+TEST_F(EdgeCaptureTest, NotifiesOncePerBatch) {
+  int notifications = 0;
+  capture_.set_notifier(2, [&notifications] { notifications += 1; });
+  ASSERT_EQ(capture_.Start(line_), OkStatus());
+
+  line_.Fire(State::kActive);
+  EXPECT_EQ(notifications, 0);
+  line_.Fire(State::kInactive);
+  EXPECT_EQ(notifications, 1);
+  line_.Fire(State::kActive);
+  EXPECT_EQ(notifications, 1);
+
+  std::array<TestEdge, 4> edges;
+  ASSERT_EQ(capture_.Read(edges), 3u);
+  line_.Fire(State::kInactive);
+  EXPECT_EQ(notifications, 1);
+  line_.Fire(State::kActive);
+  EXPECT_EQ(notifications, 2);
+}
+
+}  // namespace
+}  // namespace pw::digital_io
@@ -0,0 +1,217 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pw_assert/assert.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_digital_io/digital_io.h"
+#include "pw_function/function.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/try.h"
+
+namespace pw::digital_io {
+
+// A state change of a line, recorded by EdgeCapture.
+template <typename Clock = chrono::SystemClock>
+struct BasicEdge {
+  // When the interrupt handler ran.
+  typename Clock::time_point timestamp;
+  // The state of the line passed to the interrupt handler.
+  State state;
+};
+
+using Edge = BasicEdge<>;
+
+// Records the edges of an interrupt line with timestamps, to be read in
+// batches by a consumer thread.
+//
+// The interrupt handler only takes a timestamp and stores it with the sampled
+// state in a single-producer, single-consumer lock-free ring buffer, so it
+// keeps up with lines that change at tens of kHz and the timestamps are taken
+// as early as possible. If the buffer is full, edges are dropped and counted.
+//
+// Timestamps are taken with Clock::now(), which must be interrupt-safe. The
+// default is pw::chrono::SystemClock. A clock based on a cycle counter may be
+// used for finer resolution.
+//
+// Read() may be called from one thread at a time. Start(), Stop(), and
+// set_notifier() must not be called while the line's interrupt is enabled,
+// except for Stop().
+//
+// Usage:
+//
+//   pw::digital_io::EdgeCaptureBuffer<256> capture;
+//   pw::sync::ThreadNotification edges_ready;
+//   capture.set_notifier(64, [&edges_ready] { edges_ready.release(); });
+//   PW_TRY(capture.Start(encoder_line));
+//
+//   std::array<pw::digital_io::Edge, 64> edges;
+//   while (true) {
+//     // Also wake up periodically to process partial batches.
+//     edges_ready.try_acquire_for(kMaxLatency);
+//     for (const auto& edge : span(edges).first(capture.Read(edges))) {
+//       ...
+//     }
+//   }
+//
+template <typename Clock = chrono::SystemClock>
+class BasicEdgeCapture {
+ public:
+  using Edge = BasicEdge<Clock>;
+
+  static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                "EdgeCapture requires lock-free 32-bit atomics");
+
+  BasicEdgeCapture(const BasicEdgeCapture&) = delete;
+  BasicEdgeCapture& operator=(const BasicEdgeCapture&) = delete;
+
+  ~BasicEdgeCapture() { Stop().IgnoreError(); }
+
+  // Sets a function that the interrupt handler calls whenever batch_size
+  // edges are waiting to be read, such as releasing a ThreadNotification.
+  // The function runs in interrupt context, so it must be interrupt-safe.
+  void set_notifier(size_t batch_size, Function<void()>&& notifier) {
+    PW_ASSERT(batch_size > 0u && batch_size <= capacity());
+    batch_size_ = static_cast<uint32_t>(batch_size);
+    notifier_ = std::move(notifier);
+  }
+
+  // Sets the line's interrupt handler to record edges and enables it. The
+  // line must be enabled and must outlive the capture or until Stop().
+  //
+  // Returns:
+  //   OK - Edges are being captured.
+  //   FAILED_PRECONDITION - Edges are already being captured.
+  //   Other status codes as returned by the line.
+  Status Start(DigitalInterrupt& line,
+               InterruptTrigger trigger = InterruptTrigger::kBothEdges) {
+    if (line_ != nullptr) {
+      return Status::FailedPrecondition();
+    }
+    PW_TRY(line.SetInterruptHandler(trigger,
+                                    [this](State state) { Record(state); }));
+    if (Status status = line.EnableInterruptHandler(); !status.ok()) {
+      line.ClearInterruptHandler().IgnoreError();
+      return status;
+    }
+    line_ = &line;
+    return OkStatus();
+  }
+
+  // Disables and clears the line's interrupt handler. Edges that were
+  // recorded may still be read.
+  Status Stop() {
+    if (line_ == nullptr) {
+      return OkStatus();
+    }
+    PW_TRY(line_->DisableInterruptHandler());
+    PW_TRY(line_->ClearInterruptHandler());
+    line_ = nullptr;
+    return OkStatus();
+  }
+
+  // Moves up to edges.size() of the oldest recorded edges into edges, and
+  // returns how many were read.
+  size_t Read(span<Edge> edges) {
+    const uint32_t read = read_.load(std::memory_order_relaxed);
+    const uint32_t write = write_.load(std::memory_order_acquire);
+    const size_t count = std::min<size_t>(edges.size(), write - read);
+    for (size_t i = 0; i < count; ++i) {
+      edges[i] = buffer_[(read + i) & mask_];
+    }
+    read_.store(static_cast<uint32_t>(read + count),
+                std::memory_order_release);
+    return count;
+  }
+
+  // The number of recorded edges that have not been read.
+  size_t size() const {
+    return write_.load(std::memory_order_acquire) -
+           read_.load(std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return buffer_.size(); }
+
+  // Returns the number of edges dropped because the buffer was full since the
+  // last call.
+  uint32_t TakeDropCount() {
+    return dropped_.exchange(0, std::memory_order_relaxed);
+  }
+
+ protected:
+  // The buffer size must be a power of two, so that positions stay consistent
+  // when they wrap.
+  explicit BasicEdgeCapture(span<Edge> buffer)
+      : buffer_(buffer), mask_(static_cast<uint32_t>(buffer.size() - 1)) {
+    PW_ASSERT(!buffer.empty() && (buffer.size() & mask_) == 0u);
+  }
+
+ private:
+  // Called by the interrupt handler.
+  void Record(State state) {
+    const typename Clock::time_point now = Clock::now();
+    const uint32_t write = write_.load(std::memory_order_relaxed);
+    const uint32_t read = read_.load(std::memory_order_acquire);
+    if (write - read == buffer_.size()) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    buffer_[write & mask_] = Edge{now, state};
+    write_.store(write + 1, std::memory_order_release);
+
+    // The pending count grows one edge at a time, so it reaches the batch
+    // size exactly once until the consumer catches up.
+    if (notifier_ != nullptr && write + 1 - read == batch_size_) {
+      notifier_();
+    }
+  }
+
+  const span<Edge> buffer_;
+  const uint32_t mask_;
+  DigitalInterrupt* line_ = nullptr;
+
+  uint32_t batch_size_ = 1;
+  Function<void()> notifier_;
+
+  std::atomic<uint32_t> write_{0};  // Only written by the interrupt handler.
+  std::atomic<uint32_t> read_{0};   // Only written by the consumer.
+  std::atomic<uint32_t> dropped_{0};
+};
+
+using EdgeCapture = BasicEdgeCapture<>;
+
+// An EdgeCapture with a buffer for kCapacity edges, which must be a power of
+// two.
+template <size_t kCapacity, typename Clock = chrono::SystemClock>
+class EdgeCaptureBuffer : public BasicEdgeCapture<Clock> {
+ public:
+  static_assert(kCapacity > 0u && (kCapacity & (kCapacity - 1)) == 0u,
+                "kCapacity must be a power of two");
+
+  EdgeCaptureBuffer() : BasicEdgeCapture<Clock>(buffer_) {}
+
+ private:
+  std::array<BasicEdge<Clock>, kCapacity> buffer_;
+};
+
+}  // namespace pw::digital_io
@@ -36,19 +36,56 @@ namespace pw::file {
 
 using Entry = FlatFileSystemService::Entry;
 
-Status FlatFileSystemService::EnumerateFile(
-    Entry& entry, pwpb::ListResponse::StreamEncoder& output_encoder) {
+namespace {
+
+// 32-bit FNV-1a hash of a file name.
+uint32_t HashName(std::string_view name) {
+  uint32_t hash = 2166136261u;
+  for (char c : name) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  return hash;
+}
+
+// Returns the encoding buffer space needed to add an entry to a ListResponse.
+// The size_bytes field is not read, since reading it may be costly, so its
+// maximum size is used. The nested encoder reserves space for the largest
+// length prefix, so that is used too.
+size_t ListedPathSizeBytes(const Entry& entry, size_t name_size) {
+  return protobuf::SizeOfDelimitedFieldWithoutValue(
+             pwpb::ListResponse::Fields::kPaths) +
+         protobuf::SizeOfFieldString(pwpb::Path::Fields::kPath, name_size) +
+         protobuf::SizeOfFieldEnum(pwpb::Path::Fields::kPermissions,
+                                   entry.Permissions()) +
+         protobuf::SizeOfFieldUint32(pwpb::Path::Fields::kSizeBytes) +
+         protobuf::SizeOfFieldUint32(pwpb::Path::Fields::kFileId,
+                                     entry.FileId());
+}
+
+}  // namespace
+
+StatusWithSize FlatFileSystemService::ReadName(Entry& entry) {
   StatusWithSize sws = entry.Name(file_name_buffer_);
-  if (!sws.ok()) {
-    return sws.status();
+  entry.name_hash_valid_ = sws.ok();
+  if (sws.ok()) {
+    entry.name_hash_ =
+        HashName(std::string_view(file_name_buffer_.data(), sws.size()));
+  } else if (sws.status() != Status::NotFound()) {
+    PW_LOG_ERROR("Failed to read file name (id: %u) with status %d",
+                 static_cast<unsigned>(entry.FileId()),
+                 static_cast<int>(sws.status().code()));
   }
+  return sws;
+}
+
+Status FlatFileSystemService::EnumerateFile(
+    Entry& entry,
+    size_t name_size,
+    pwpb::ListResponse::StreamEncoder& output_encoder) {
   {
     pwpb::Path::StreamEncoder encoder = output_encoder.GetPathsEncoder();
 
-    encoder
-        .WritePath(reinterpret_cast<const char*>(file_name_buffer_.data()),
-                   sws.size())
-        .IgnoreError();
+    encoder.WritePath(file_name_buffer_.data(), name_size).IgnoreError();
     encoder.WriteSizeBytes(entry.SizeBytes()).IgnoreError();
     encoder.WritePermissions(entry.Permissions()).IgnoreError();
     encoder.WriteFileId(entry.FileId()).IgnoreError();
@@ -57,19 +94,45 @@ Status FlatFileSystemService::EnumerateFile(
 }
 
 void FlatFileSystemService::EnumerateAllFiles(RawServerWriter& writer) {
-  for (Entry* entry : entries_) {
-    PW_DCHECK_NOTNULL(entry);
-    // For now, don't try to pack entries.
+  size_t index = 0;
+  // The name of entries_[index], if it was read but did not fit in the
+  // previous response.
+  StatusWithSize pending_name(Status::NotFound(), 0);
+
+  while (index < entries_.size()) {
+    // Pack as many entries into each response as fit in the encoding buffer.
     pwpb::ListResponse::MemoryEncoder encoder(encoding_buffer_);
-    if (Status status = EnumerateFile(*entry, encoder); !status.ok()) {
-      if (status != Status::NotFound()) {
+    for (; index < entries_.size(); ++index) {
+      Entry* entry = entries_[index];
+      PW_DCHECK_NOTNULL(entry);
+      StatusWithSize name = pending_name.ok() ? pending_name : ReadName(*entry);
+      pending_name = StatusWithSize(Status::NotFound(), 0);
+      if (!name.ok()) {
+        continue;
+      }
+
+      if (encoder.size() != 0u &&
+          encoder.size() + ListedPathSizeBytes(*entry, name.size()) >
+              encoding_buffer_.size()) {
+        pending_name = name;
+        break;
+      }
+
+      if (Status status = EnumerateFile(*entry, name.size(), encoder);
+          !status.ok()) {
+        // Only the first entry of a response can fail to encode, since the
+        // others are checked to fit. Drop the entry and start over.
         PW_LOG_ERROR("Failed to enumerate file (id: %u) with status %d",
                      static_cast<unsigned>(entry->FileId()),
                      static_cast<int>(status.code()));
+        index += 1;
+        break;
       }
-      continue;
     }
 
+    if (encoder.size() == 0u || !encoder.status().ok()) {
+      continue;
+    }
     Status write_status = writer.Write(encoder);
     if (!write_status.ok()) {
       writer.Finish(write_status)
@@ -107,8 +170,10 @@ void FlatFileSystemService::List(ConstByteSpan request,
       return;
     }
 
+    // FindFile() leaves the name in file_name_buffer_.
     pwpb::ListResponse::MemoryEncoder encoder(encoding_buffer_);
-    Status proto_encode_status = EnumerateFile(*result.value(), encoder);
+    Status proto_encode_status =
+        EnumerateFile(*result.value(), file_name_view.length(), encoder);
     if (!proto_encode_status.ok()) {
       writer.Finish(proto_encode_status)
           .IgnoreError();  // TODO(b/242598609): Handle Status properly
@@ -145,30 +210,36 @@ void FlatFileSystemService::Delete(ConstByteSpan request,
 }
 
 Result<Entry*> FlatFileSystemService::FindFile(std::string_view file_name) {
-  Status search_status;
-  for (Entry* entry : entries_) {
-    PW_DCHECK_NOTNULL(entry);
-    StatusWithSize sws = entry->Name(file_name_buffer_);
-
-    // If there not an exact file name length match, don't try and check against
-    // a prefix.
-    if (!sws.ok() || file_name.length() != sws.size()) {
-      if (sws.status() != Status::NotFound()) {
-        PW_LOG_ERROR("Failed to read file name (id: %u) with status %d",
-                     static_cast<unsigned>(entry->FileId()),
-                     static_cast<int>(sws.status().code()));
+  const uint32_t hash = HashName(file_name);
+
+  // Names are only read for entries whose cached name hash matches, or that
+  // have none. Names may change without the service knowing, so if that finds
+  // nothing, read the names of the remaining entries too.
+  for (bool check_mismatched_hashes : {false, true}) {
+    for (Entry* entry : entries_) {
+      PW_DCHECK_NOTNULL(entry);
+      const bool hash_matches =
+          !entry->name_hash_valid_ || entry->name_hash_ == hash;
+      if (hash_matches == check_mismatched_hashes) {
+        continue;
       }
-      continue;
-    }
 
-    if (memcmp(file_name.data(), file_name_buffer_.data(), file_name.size()) ==
-        0) {
-      return entry;
+      // If there not an exact file name length match, don't try and check
+      // against a prefix.
+      StatusWithSize sws = ReadName(*entry);
+      if (!sws.ok() || file_name.length() != sws.size()) {
+        continue;
+      }
+
+      if (memcmp(file_name.data(),
+                 file_name_buffer_.data(),
+                 file_name.size()) == 0) {
+        return entry;
+      }
     }
   }
 
-  search_status.Update(Status::NotFound());
-  return search_status;
+  return Status::NotFound();
 }
 
 Status FlatFileSystemService::FindAndDeleteFile(std::string_view file_name) {
@@ -177,6 +248,8 @@ Status FlatFileSystemService::FindAndDeleteFile(std::string_view file_name) {
     return result.status();
   }
 
+  // Deleted files may no longer be named.
+  result.value()->name_hash_valid_ = false;
   return result.value()->Delete();
 }
 
@@ -37,6 +37,7 @@ class FakeFile : public FlatFileSystemService::Entry {
       : name_(file_name), size_(size), file_id_(file_id) {}
 
   StatusWithSize Name(span<char> dest) override {
+    name_reads_ += 1;
     if (name_.empty()) {
       return StatusWithSize(Status::NotFound(), 0);
     }
@@ -60,7 +61,13 @@ class FakeFile : public FlatFileSystemService::Entry {
 
   FlatFileSystemService::Entry::Id FileId() const override { return file_id_; }
 
+  void set_name(std::string_view file_name) { name_ = file_name; }
+
+  // Number of times Name() was called.
+  size_t name_reads() const { return name_reads_; }
+
  private:
+  size_t name_reads_ = 0;
   std::string_view name_;
   size_t size_;
   uint32_t file_id_;
@@ -228,5 +235,86 @@ TEST(FlatFileSystem, List_FileMissingName) {
   EXPECT_EQ(2u, ValidateExpectedPaths(static_file_system, ctx.responses()));
 }
 
+TEST(FlatFileSystem, List_PacksEntriesIntoResponses) {
+  std::array<FakeFile, 3> files{
+      {{"SNAP_001", 372, 9}, {"tokens.csv", 808, 15038202}, {"a.txt", 0, 2}}};
+  std::array<FlatFileSystemService::Entry*, 3> static_file_system{
+      &files[0], &files[1], &files[2]};
+
+  PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemServiceWithBuffer<10, 3>, List)
+  ctx(static_file_system);
+  ctx.call(ConstByteSpan());
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(1u, ctx.responses().size());
+  EXPECT_EQ(3u, ValidateExpectedPaths(static_file_system, ctx.responses()));
+}
+
+TEST(FlatFileSystem, List_SplitsEntriesAcrossResponses) {
+  std::array<FakeFile, 5> files{{{"SNAP_001", 372, 9},
+                                 {"tokens.csv", 808, 15038202},
+                                 {"", 0, 0},
+                                 {"a.txt", 0, 2},
+                                 {"b.txt", 0, 3}}};
+  std::array<FlatFileSystemService::Entry*, 5> static_file_system{
+      &files[0], &files[1], &files[2], &files[3], &files[4]};
+
+  PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemServiceWithBuffer<10, 2>, List)
+  ctx(static_file_system);
+  ctx.call(ConstByteSpan());
+
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(2u, ctx.responses().size());
+  EXPECT_EQ(4u, ValidateExpectedPaths(static_file_system, ctx.responses()));
+  for (const FakeFile& file : files) {
+    EXPECT_EQ(file.name_reads(), 1u);
+  }
+}
+
+void CallDelete(span<FlatFileSystemService::Entry*> file_system,
+                std::string_view file_name,
+                Status expected_status) {
+  std::array<std::byte, 32> request_buffer;
+  pwpb::DeleteRequest::MemoryEncoder request(request_buffer);
+  ASSERT_EQ(OkStatus(), request.WritePath(file_name));
+
+  PW_RAW_TEST_METHOD_CONTEXT(FlatFileSystemServiceWithBuffer<10>, Delete)
+  ctx(file_system);
+  ctx.call(request);
+  EXPECT_EQ(expected_status, ctx.status());
+}
+
+TEST(FlatFileSystem, Delete_OnlyReadsNamesWithMatchingHash) {
+  std::array<FakeFile, 3> files{
+      {{"SNAP_001", 372, 9}, {"tokens.csv", 808, 15038202}, {"a.txt", 0, 2}}};
+  std::array<FlatFileSystemService::Entry*, 3> static_file_system{
+      &files[0], &files[1], &files[2]};
+
+  // The first search reads every name up to the file.
+  CallDelete(static_file_system, "a.txt", Status::Unimplemented());
+  EXPECT_EQ(files[0].name_reads(), 1u);
+  EXPECT_EQ(files[1].name_reads(), 1u);
+  EXPECT_EQ(files[2].name_reads(), 1u);
+
+  // Later searches only read the names whose cached hash matches.
+  CallDelete(static_file_system, "tokens.csv", Status::Unimplemented());
+  EXPECT_EQ(files[0].name_reads(), 1u);
+  EXPECT_EQ(files[1].name_reads(), 2u);
+  EXPECT_EQ(files[2].name_reads(), 1u);
+}
+
+TEST(FlatFileSystem, Delete_FindsRenamedFile) {
+  std::array<FakeFile, 2> files{{{"SNAP_001", 372, 9}, {"a.txt", 0, 2}}};
+  std::array<FlatFileSystemService::Entry*, 2> static_file_system{&files[0],
+                                                                  &files[1]};
+
+  CallDelete(static_file_system, "SNAP_001", Status::Unimplemented());
+  CallDelete(static_file_system, "a.txt", Status::Unimplemented());
+
+  files[0].set_name("SNAP_002");
+  CallDelete(static_file_system, "SNAP_002", Status::Unimplemented());
+  CallDelete(static_file_system, "SNAP_001", Status::NotFound());
+}
+
 }  // namespace
 }  // namespace pw::file
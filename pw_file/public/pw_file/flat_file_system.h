@@ -71,6 +71,14 @@ class FlatFileSystemService
     // File IDs must be globally unique, and map to a pw_transfer
     // TransferService read/write handler.
     virtual Id FileId() const = 0;
+
+   private:
+    friend class FlatFileSystemService;
+
+    // A hash of the name, cached by FlatFileSystemService whenever it reads
+    // the name, so that finding a file does not read every entry's name.
+    uint32_t name_hash_ = 0;
+    bool name_hash_valid_ = false;
   };
 
   // Returns the size of encoding buffer guaranteed to support encoding
@@ -90,6 +98,8 @@ class FlatFileSystemService
   //     contain files. These pointers may not be null. The span's underlying
   //     buffer must outlive this object.
   //   encoding_buffer - Used internally by this class to encode its responses.
+  //     Listing all files packs as many entries into each response as fit in
+  //     this buffer, so it should be no larger than the RPC payload limit.
   //   file_name_buffer - Used internally by this class to find and enumerate
   //     files. Should be large enough to hold the longest expected file name.
   //     The span's underlying buffer must outlive this object.
@@ -121,10 +131,15 @@ class FlatFileSystemService
            protobuf::SizeOfFieldUint32(pwpb::Path::Fields::kFileId);
   }
 
+  // Reads the entry's name into file_name_buffer_ and caches its hash.
+  StatusWithSize ReadName(Entry& entry);
+
   Result<Entry*> FindFile(std::string_view file_name);
   Status FindAndDeleteFile(std::string_view file_name);
 
+  // Encodes the entry, whose name of name_size bytes is in file_name_buffer_.
   Status EnumerateFile(Entry& entry,
+                       size_t name_size,
                        pwpb::ListResponse::StreamEncoder& output_encoder);
   void EnumerateAllFiles(RawServerWriter& writer);
 
@@ -0,0 +1,116 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_function/dynamic_function.h"
+
+#include <array>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "pw_allocator/block_pool.h"
+
+namespace pw {
+namespace {
+
+using Pool = allocator::FixedBytePool<64, 2>;
+
+TEST(DynamicFunction, SmallCallable_StoredInline) {
+  Pool pool;
+  int value = 1;
+  DynamicFunction<int()> function =
+      MakeDynamicFunction<int()>(pool, [&value] { return value + 1; });
+
+  ASSERT_NE(function, nullptr);
+  EXPECT_EQ(function(), 2);
+  EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST(DynamicFunction, LargeCallable_StoredInPool) {
+  Pool pool;
+  int a = 1;
+  int b = 2;
+  int c = 3;
+  DynamicFunction<int(int)> function = MakeDynamicFunction<int(int)>(
+      pool, [&a, &b, &c](int d) { return a + b + c + d; });
+
+  ASSERT_NE(function, nullptr);
+  EXPECT_EQ(sizeof(function), sizeof(Function<int(int)>));
+  EXPECT_EQ(function(4), 10);
+  EXPECT_EQ(pool.available(), 1u);
+
+  function = nullptr;
+  EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST(DynamicFunction, PerSiteInlineSize_AvoidsPool) {
+  Pool pool;
+  int a = 1;
+  int b = 2;
+  DynamicFunction<int(), 2 * sizeof(void*)> function =
+      MakeDynamicFunction<int(), 2 * sizeof(void*)>(pool,
+                                                    [&a, &b] { return a + b; });
+
+  ASSERT_NE(function, nullptr);
+  EXPECT_EQ(function(), 3);
+  EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST(DynamicFunction, PoolExhausted_ReturnsNull) {
+  Pool pool;
+  std::array<int, 4> values{};
+  auto make = [&pool, values] {
+    return MakeDynamicFunction<int()>(pool, [values] { return values[0]; });
+  };
+
+  DynamicFunction<int()> first = make();
+  DynamicFunction<int()> second = make();
+  DynamicFunction<int()> third = make();
+  EXPECT_NE(first, nullptr);
+  EXPECT_NE(second, nullptr);
+  EXPECT_EQ(third, nullptr);
+}
+
+TEST(DynamicFunction, CallableLargerThanBlock_ReturnsNull) {
+  Pool pool;
+  std::array<int, 32> values{};
+  DynamicFunction<int()> function =
+      MakeDynamicFunction<int()>(pool, [values] { return values[0]; });
+
+  EXPECT_EQ(function, nullptr);
+  EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST(DynamicFunction, Move_TransfersBlock) {
+  Pool pool;
+  auto owned = std::make_unique<int>(5);
+  int offset = 1;
+  int* result = nullptr;
+  DynamicFunction<void()> function = MakeDynamicFunction<void()>(
+      pool, [owned = std::move(owned), &offset, &result]() mutable {
+        *owned += offset;
+        result = owned.get();
+      });
+
+  DynamicFunction<void()> moved = std::move(function);
+  EXPECT_EQ(pool.available(), 1u);
+  moved();
+  ASSERT_NE(result, nullptr);
+  EXPECT_EQ(*result, 6);
+
+  moved = nullptr;
+  EXPECT_EQ(pool.available(), 2u);
+}
+
+}  // namespace
+}  // namespace pw
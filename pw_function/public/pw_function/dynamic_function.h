@@ -0,0 +1,154 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pw_function/config.h"
+#include "pw_function/function.h"
+
+namespace pw {
+namespace function_internal {
+
+// Owns a callable that lives in a block allocated from a pool, such as a
+// `pw::allocator::BlockPool`. The block also records the pool it came from,
+// so this object is a single pointer and fits in any function's inline
+// storage.
+template <typename Pool, typename Callable>
+class PooledCallable {
+ public:
+  // Moves or copies `callable` into a block from `pool`. The result is empty
+  // if the pool is exhausted, or its blocks are too small or misaligned.
+  template <typename T>
+  PooledCallable(Pool& pool, T&& callable) : block_(nullptr) {
+    if (sizeof(Block) > pool.block_size()) {
+      return;
+    }
+    void* memory = pool.Allocate();
+    if (memory == nullptr) {
+      return;
+    }
+    if (reinterpret_cast<uintptr_t>(memory) % alignof(Block) != 0) {
+      pool.Free(memory);
+      return;
+    }
+    block_ = new (memory) Block{pool, std::forward<T>(callable)};
+  }
+
+  PooledCallable(const PooledCallable&) = delete;
+  PooledCallable& operator=(const PooledCallable&) = delete;
+
+  PooledCallable(PooledCallable&& other) noexcept
+      : block_(std::exchange(other.block_, nullptr)) {}
+
+  PooledCallable& operator=(PooledCallable&& other) noexcept {
+    Reset();
+    block_ = std::exchange(other.block_, nullptr);
+    return *this;
+  }
+
+  ~PooledCallable() { Reset(); }
+
+  explicit operator bool() const { return block_ != nullptr; }
+
+  template <typename... Args>
+  decltype(auto) operator()(Args&&... args) const {
+    return block_->callable(std::forward<Args>(args)...);
+  }
+
+ private:
+  struct Block {
+    Pool& pool;
+    Callable callable;
+  };
+
+  void Reset() {
+    if (block_ != nullptr) {
+      Pool& pool = block_->pool;
+      block_->~Block();
+      pool.Free(block_);
+      block_ = nullptr;
+    }
+  }
+
+  Block* block_;
+};
+
+}  // namespace function_internal
+
+/// A `pw::InlineFunction` that can hold callables larger than its inline
+/// storage by moving them into a block from a pool.
+///
+/// `DynamicFunction` is only a type; construct one with
+/// `pw::MakeDynamicFunction`, which decides per callable where it is stored.
+/// Callables that fit inline never touch the pool, so memory is only spent on
+/// the callers that need it. A pool-backed `DynamicFunction` occupies a single
+/// pointer of inline storage, and returns its block to the pool when it is
+/// destroyed.
+template <typename Callable,
+          size_t inline_target_size =
+              function_internal::config::kInlineCallableSize>
+using DynamicFunction = InlineFunction<Callable, inline_target_size>;
+
+/// Creates a `pw::DynamicFunction` holding `callable`.
+///
+/// If `callable` fits in the function's inline storage, it is stored there
+/// and `pool` is not used. Otherwise `callable` is moved into a block
+/// allocated from `pool`. `pool` may be any type with `Allocate()`,
+/// `Free(void*)` and `block_size()` members, such as
+/// `pw::allocator::BlockPool`, and must outlive the function.
+///
+/// Returns a null function if the pool has no free blocks, or if its blocks
+/// are too small or insufficiently aligned for the callable.
+///
+/// @code{.cpp}
+///   pw::allocator::FixedBytePool<64, 4> pool;
+///
+///   // Three pointers of captures do not fit in one pointer of inline
+///   // storage, so they are moved into a 64-byte block from the pool.
+///   pw::DynamicFunction<void()> on_done =
+///       pw::MakeDynamicFunction<void()>(pool, [&a, &b, &c] { Finish(a, b, c); });
+///   if (on_done == nullptr) {
+///     return pw::Status::ResourceExhausted();
+///   }
+/// @endcode
+template <typename FunctionType,
+          size_t inline_target_size =
+              function_internal::config::kInlineCallableSize,
+          typename Pool,
+          typename Callable>
+DynamicFunction<FunctionType, inline_target_size> MakeDynamicFunction(
+    Pool& pool, Callable&& callable) {
+  using Result = DynamicFunction<FunctionType, inline_target_size>;
+  using Target = std::decay_t<Callable>;
+  if constexpr (sizeof(Target) <=
+                    fit::internal::RoundUpToWord(inline_target_size) &&
+                alignof(Target) <= alignof(Result)) {
+    static_cast<void>(pool);
+    return Result(std::forward<Callable>(callable));
+  } else {
+    function_internal::PooledCallable<Pool, Target> pooled(
+        pool, std::forward<Callable>(callable));
+    if (!pooled) {
+      return nullptr;
+    }
+    return Result(std::move(pooled));
+  }
+}
+
+}  // namespace pw
@@ -0,0 +1,80 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_fuzzer/cost_feedback.h"
+
+#include <cstdlib>
+
+#include "pw_log/log.h"
+
+namespace pw::fuzzer {
+namespace {
+
+// libFuzzer treats every non-zero byte in this section as a coverage feature.
+#if defined(__linux__)
+__attribute__((used, section("__libfuzzer_extra_counters")))
+#endif  // defined(__linux__)
+uint8_t cost_counters[CostBucket(UINT64_MAX, 0) + 1];
+
+struct Settings {
+  Settings() {
+    const char* feedback = std::getenv("PW_FUZZER_COST_FEEDBACK");
+    const char* limit = std::getenv("PW_FUZZER_MAX_NS_PER_BYTE");
+    if (limit != nullptr) {
+      max_ns_per_byte = std::strtoull(limit, nullptr, 10);
+    }
+    enabled = (feedback != nullptr && feedback[0] != '\0' &&
+               feedback[0] != '0') ||
+              max_ns_per_byte != 0u;
+  }
+
+  bool enabled = false;
+  uint64_t max_ns_per_byte = 0;
+};
+
+const Settings& GetSettings() {
+  static const Settings settings;
+  return settings;
+}
+
+}  // namespace
+
+bool CostFeedbackEnabled() { return GetSettings().enabled; }
+
+void RecordCost(uint64_t cost_ns, size_t size) {
+  static uint64_t max_seen = 0;
+
+  const size_t charged_size =
+      size < kCostFeedbackMinSize ? kCostFeedbackMinSize : size;
+  const uint64_t cost_per_byte = cost_ns / charged_size;
+  cost_counters[CostBucket(cost_ns, size)] = 1;
+
+  if (cost_per_byte > max_seen) {
+    max_seen = cost_per_byte;
+    PW_LOG_INFO("New slowest input: %u bytes at %u ns/byte",
+                static_cast<unsigned>(size),
+                static_cast<unsigned>(cost_per_byte));
+  }
+
+  const uint64_t limit = GetSettings().max_ns_per_byte;
+  if (limit != 0u && cost_per_byte > limit) {
+    PW_LOG_ERROR("Input of %u bytes took %u ns/byte; the limit is %u",
+                 static_cast<unsigned>(size),
+                 static_cast<unsigned>(cost_per_byte),
+                 static_cast<unsigned>(limit));
+    std::abort();
+  }
+}
+
+}  // namespace pw::fuzzer
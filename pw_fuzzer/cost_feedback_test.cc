@@ -0,0 +1,53 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_fuzzer/cost_feedback.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::fuzzer {
+namespace {
+
+TEST(CostFeedback, CostBucket) {
+  static_assert(CostBucket(0, 100) == 0u);
+  static_assert(CostBucket(99, 100) == 0u);
+  static_assert(CostBucket(100, 100) == 1u);
+  static_assert(CostBucket(399, 100) == 2u);
+  static_assert(CostBucket(400, 100) == 3u);
+  static_assert(CostBucket(UINT64_MAX, 1) == 60u);
+
+  // Short inputs are charged as kCostFeedbackMinSize bytes.
+  EXPECT_EQ(CostBucket(kCostFeedbackMinSize, 0), 1u);
+  EXPECT_EQ(CostBucket(kCostFeedbackMinSize, 1), 1u);
+  EXPECT_EQ(CostBucket(kCostFeedbackMinSize - 1, 1), 0u);
+}
+
+TEST(CostFeedback, RunsFunction) {
+  const uint8_t data[] = {1, 2, 3};
+  size_t calls = 0;
+  EXPECT_EQ(RunWithCostFeedback(data,
+                                sizeof(data),
+                                [&](const uint8_t* input, size_t size) {
+                                  EXPECT_EQ(input, data);
+                                  EXPECT_EQ(size, sizeof(data));
+                                  calls += 1;
+                                }),
+            0);
+  EXPECT_EQ(calls, 1u);
+}
+
+}  // namespace
+}  // namespace pw::fuzzer
@@ -0,0 +1,84 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Cost-guided fuzzing for libFuzzer-style fuzzers.
+//
+// Fuzz target functions that run their code under test through
+// RunWithCostFeedback() can be fuzzed for algorithmic blowups, such as
+// quadratic decoding, in addition to crashes. The mode is enabled at runtime
+// with environment variables, so the same fuzzer binary serves both purposes:
+//
+//   PW_FUZZER_COST_FEEDBACK=1
+//     Reports the time spent per input byte to libFuzzer as coverage. Each
+//     power-of-two bucket of nanoseconds per byte is a distinct feature, so
+//     libFuzzer keeps inputs that are slower per byte than any before and
+//     mutates them further.
+//
+//   PW_FUZZER_MAX_NS_PER_BYTE=<n>
+//     Aborts when an input takes more than n nanoseconds per byte, so libFuzzer
+//     saves it as a crash input.
+//
+// Cost feedback is only available on Linux, where libFuzzer supports extra
+// counters. Timing is noisy, so cost-guided runs may keep some inputs that are
+// not actually slower.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace pw::fuzzer {
+
+// Inputs shorter than this are charged as if they were this long, so that the
+// fixed cost of running the fuzz target does not dominate for tiny inputs.
+inline constexpr size_t kCostFeedbackMinSize = 16;
+
+// Returns the bucket of cost per byte that libFuzzer sees as a feature.
+// Buckets range from 0 to 60.
+constexpr size_t CostBucket(uint64_t cost_ns, size_t size) {
+  uint64_t cost_per_byte =
+      cost_ns / (size < kCostFeedbackMinSize ? kCostFeedbackMinSize : size);
+  size_t bucket = 0;
+  while (cost_per_byte != 0u) {
+    cost_per_byte >>= 1;
+    bucket += 1;
+  }
+  return bucket;
+}
+
+// Returns true if PW_FUZZER_COST_FEEDBACK or PW_FUZZER_MAX_NS_PER_BYTE is set.
+bool CostFeedbackEnabled();
+
+// Reports the cost of running the fuzz target on an input of `size` bytes.
+void RecordCost(uint64_t cost_ns, size_t size);
+
+// Calls function(data, size) and reports how long it took, if cost feedback
+// is enabled. Returns 0, so fuzz target functions can return the result.
+template <typename Function>
+int RunWithCostFeedback(const uint8_t* data, size_t size, Function&& function) {
+  if (!CostFeedbackEnabled()) {
+    function(data, size);
+    return 0;
+  }
+  const auto start = std::chrono::steady_clock::now();
+  function(data, size);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  RecordCost(static_cast<uint64_t>(
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                     .count()),
+             size);
+  return 0;
+}
+
+}  // namespace pw::fuzzer
@@ -14,6 +14,9 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "pw_assert/check.h"
 #include "pw_bytes/endian.h"
 #include "pw_hdlc/internal/protocol.h"
@@ -118,6 +121,62 @@ void Decoder::AppendByte(byte new_byte) {
   current_frame_size_ += 1;
 }
 
+void Decoder::AppendBytes(ConstByteSpan data) {
+  // The ring buffer must be refilled entirely to take the bulk path.
+  if (data.size() < last_read_bytes_.size()) {
+    for (byte b : data) {
+      AppendByte(b);
+    }
+    return;
+  }
+
+  if (current_frame_size_ < max_size()) {
+    std::memcpy(&buffer_[current_frame_size_],
+                data.data(),
+                std::min(data.size(), max_size() - current_frame_size_));
+  }
+
+  // Everything in the ring buffer is ejected, then all but the last four new
+  // bytes. The ring buffer is partially filled at the start of a frame.
+  const size_t buffered =
+      std::min(current_frame_size_, last_read_bytes_.size());
+  size_t index = (last_read_bytes_index_ + last_read_bytes_.size() - buffered) %
+                 last_read_bytes_.size();
+  for (size_t i = 0; i < buffered; ++i) {
+    fcs_.Update(last_read_bytes_[index]);
+    index = (index + 1) % last_read_bytes_.size();
+  }
+
+  const size_t ejected_size = data.size() - last_read_bytes_.size();
+  fcs_.Update(data.first(ejected_size));
+  std::memcpy(last_read_bytes_.data(),
+              &data[ejected_size],
+              last_read_bytes_.size());
+  last_read_bytes_index_ = 0;
+
+  current_frame_size_ += data.size();
+}
+
+size_t Decoder::ProcessRun(ConstByteSpan data) {
+  switch (state_) {
+    case State::kInterFrame: {
+      // Bytes between frames are discarded, but counted to report an error.
+      const size_t discarded = static_cast<size_t>(
+          std::find(data.begin(), data.end(), kFlag) - data.begin());
+      current_frame_size_ += discarded;
+      return discarded;
+    }
+    case State::kFrame: {
+      const size_t run_size = FindFlagOrEscape(data);
+      AppendBytes(data.first(run_size));
+      return run_size;
+    }
+    case State::kFrameEscape:
+      return 0;
+  }
+  PW_CRASH("Bad decoder state");
+}
+
 Status Decoder::CheckFrame() const {
   // Empty frames are not an error; repeated flag characters are okay.
   if (current_frame_size_ == 0u) {
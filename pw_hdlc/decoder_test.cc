@@ -14,13 +14,18 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <initializer_list>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
 #include "pw_fuzzer/fuzztest.h"
+#include "pw_hdlc/encoder.h"
 #include "pw_hdlc/internal/protocol.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::hdlc {
 namespace {
@@ -28,6 +33,8 @@ namespace {
 using std::byte;
 using namespace fuzzer;
 
+constexpr uint64_t kAddress = 123;
+
 TEST(Frame, Fields) {
   static constexpr auto kFrameData =
       bytes::String("\x05\xab\x42\x24\xf9\x54\xfb\x3d");
@@ -154,6 +161,115 @@ TEST(Decoder, TooLargeForBuffer_DecodesNextFrame) {
   EXPECT_EQ(OkStatus(), decoder.Process(kFlag).status());
 }
 
+// Encodes frames with the payloads, separated by the specified bytes.
+template <size_t kSize>
+ConstByteSpan EncodeFrames(std::array<byte, kSize>& buffer,
+                           std::initializer_list<ConstByteSpan> payloads,
+                           ConstByteSpan separator = {}) {
+  stream::MemoryWriter writer(buffer);
+  for (ConstByteSpan payload : payloads) {
+    EXPECT_EQ(OkStatus(), WriteUIFrame(kAddress, payload, writer));
+    EXPECT_EQ(OkStatus(), writer.Write(separator));
+  }
+  return writer.WrittenData();
+}
+
+struct DecodedFrame {
+  Status status;
+  std::vector<byte> data;
+
+  bool operator==(const DecodedFrame& other) const {
+    return status == other.status && data == other.data;
+  }
+};
+
+std::vector<DecodedFrame> DecodeByteByByte(Decoder& decoder,
+                                           ConstByteSpan data) {
+  std::vector<DecodedFrame> frames;
+  for (byte b : data) {
+    Result<Frame> result = decoder.Process(b);
+    if (result.status() == Status::Unavailable()) {
+      continue;
+    }
+    frames.push_back({result.status(), {}});
+    if (result.ok()) {
+      frames.back().data.assign(result->data().begin(), result->data().end());
+    }
+  }
+  return frames;
+}
+
+std::vector<DecodedFrame> DecodeSpans(Decoder& decoder,
+                                      ConstByteSpan data,
+                                      size_t span_size) {
+  std::vector<DecodedFrame> frames;
+  while (!data.empty()) {
+    const size_t size = std::min(span_size, data.size());
+    decoder.Process(data.first(size), [&frames](const Result<Frame>& result) {
+      frames.push_back({result.status(), {}});
+      if (result.ok()) {
+        frames.back().data.assign(result->data().begin(),
+                                  result->data().end());
+      }
+    });
+    data = data.subspan(size);
+  }
+  return frames;
+}
+
+constexpr auto kLongPayload = bytes::Initialized<200>(
+    [](size_t i) { return i % 37 == 5 ? 0x7e : i % 41 == 9 ? 0x7d : i; });
+
+TEST(Decoder, ProcessSpan_MatchesProcessByte) {
+  constexpr auto kEscapes = bytes::String("\x7e\x7d\x7e\x7e\x7d\x7d");
+  std::array<byte, 1024> buffer;
+  ConstByteSpan encoded = EncodeFrames(
+      buffer,
+      {kLongPayload, kEscapes, ConstByteSpan(), bytes::String("hello")},
+      bytes::String("~garbage between frames~"));
+
+  DecoderBuffer<256> expected_decoder;
+  const std::vector<DecodedFrame> expected =
+      DecodeByteByByte(expected_decoder, encoded);
+  ASSERT_EQ(expected.size(), 8u);
+  ASSERT_EQ(expected[0].status, OkStatus());
+  EXPECT_EQ(expected[0].data,
+            std::vector<byte>(kLongPayload.begin(), kLongPayload.end()));
+
+  // Feed the data in spans of every size, so that runs start and end at every
+  // position relative to words and escapes.
+  for (size_t span_size = 1; span_size <= encoded.size(); ++span_size) {
+    DecoderBuffer<256> decoder;
+    EXPECT_EQ(DecodeSpans(decoder, encoded, span_size), expected);
+  }
+}
+
+TEST(Decoder, ProcessSpan_TooLargeForBuffer_DecodesNextFrame) {
+  std::array<byte, 1024> buffer;
+  ConstByteSpan encoded =
+      EncodeFrames(buffer, {kLongPayload, bytes::String("small")});
+
+  DecoderBuffer<32> decoder;
+  std::vector<DecodedFrame> frames = DecodeSpans(decoder, encoded, 1024);
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0].status, Status::ResourceExhausted());
+  EXPECT_EQ(frames[1].status, OkStatus());
+}
+
+TEST(Decoder, ProcessSpan_BadFcs_ReportsDataLoss) {
+  std::array<byte, 1024> buffer;
+  ConstByteSpan encoded = EncodeFrames(buffer, {kLongPayload});
+  std::array<byte, 1024> corrupted;
+  std::copy(encoded.begin(), encoded.end(), corrupted.begin());
+  corrupted[100] ^= byte{0x01};
+
+  DecoderBuffer<256> decoder;
+  std::vector<DecodedFrame> frames =
+      DecodeSpans(decoder, span(corrupted).first(encoded.size()), 64);
+  ASSERT_EQ(frames.size(), 1u);
+  EXPECT_EQ(frames[0].status, Status::DataLoss());
+}
+
 void ProcessNeverCrashes(ConstByteSpan data) {
   DecoderBuffer<1024> decoder;
   for (byte b : data) {
@@ -0,0 +1,168 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_hdlc/demultiplexer.h"
+
+#include <algorithm>
+
+#include "pw_varint/varint.h"
+
+namespace pw::hdlc {
+
+void Demultiplexer::Route::Deliver(const Result<Frame>& frame) {
+  if (frame.ok()) {
+    handler_(frame.value());
+  } else {
+    frames_dropped_ += 1;
+  }
+}
+
+Status Demultiplexer::AddRoute(Route& route) {
+  if (FindRoute(route.address()) != nullptr) {
+    return Status::AlreadyExists();
+  }
+  routes_.push_front(route);
+  return OkStatus();
+}
+
+Status Demultiplexer::RemoveRoute(Route& route) {
+  if (!routes_.remove(route)) {
+    return Status::NotFound();
+  }
+  if (route_ == &route) {
+    Clear();
+  }
+  return OkStatus();
+}
+
+void Demultiplexer::Process(ConstByteSpan data) {
+  while (!data.empty()) {
+    switch (state_) {
+      case State::kInterFrame: {
+        const auto flag = std::find(data.begin(), data.end(), kFlag);
+        if (flag == data.end()) {
+          return;
+        }
+        data = data.subspan(static_cast<size_t>(flag - data.begin()) + 1);
+        StartFrame();
+        break;
+      }
+      case State::kAddress:
+        data = data.subspan(ProcessAddress(data));
+        break;
+      case State::kRouting: {
+        // Flags are never escaped, so the frame ends at the next flag. The
+        // route's decoder processes it, including the flag.
+        const auto flag = std::find(data.begin(), data.end(), kFlag);
+        const bool frame_ends = flag != data.end();
+        const size_t size =
+            static_cast<size_t>(flag - data.begin()) + (frame_ends ? 1 : 0);
+
+        Route& route = *route_;
+        if (frame_ends) {
+          // The handler may add or remove routes, so finish routing first.
+          route_ = nullptr;
+          StartFrame();
+        }
+        route.decoder_.Process(data.first(size), &Route::Deliver, route);
+        data = data.subspan(size);
+        break;
+      }
+    }
+  }
+}
+
+size_t Demultiplexer::ProcessAddress(ConstByteSpan data) {
+  for (size_t i = 0; i < data.size(); ++i) {
+    const std::byte b = data[i];
+
+    if (b == kFlag) {
+      // Repeated flags are okay, but a frame cannot end before its address.
+      if (header_size_ > 1u) {
+        unrouted_frames_ += 1;
+      }
+      StartFrame();
+      continue;
+    }
+
+    header_[header_size_++] = b;
+
+    std::byte address_byte = b;
+    if (escape_) {
+      escape_ = false;
+      if (b == kEscape) {
+        DropFrame();
+        return i + 1;
+      }
+      address_byte = Escape(b);
+    } else if (b == kEscape) {
+      escape_ = true;
+      continue;
+    }
+
+    address_[address_size_++] = address_byte;
+
+    // The last byte of a one-terminated varint has its low bit set.
+    if ((address_byte & std::byte{1}) != std::byte{0}) {
+      StartRoute();
+      return i + 1;
+    }
+    if (address_size_ == address_.size()) {
+      DropFrame();
+      return i + 1;
+    }
+  }
+  return data.size();
+}
+
+void Demultiplexer::StartRoute() {
+  uint64_t address;
+  if (varint::Decode(span(address_).first(address_size_),
+                     &address,
+                     kAddressFormat) == 0u) {
+    DropFrame();
+    return;
+  }
+
+  Route* route = FindRoute(address);
+  if (route == nullptr) {
+    DropFrame();
+    return;
+  }
+
+  // Don't overwrite the frame that the route holds.
+  if (route->held()) {
+    route->frames_dropped_ += 1;
+    state_ = State::kInterFrame;
+    return;
+  }
+
+  // Restart the route's decoder with the flag and address bytes that were
+  // read. They do not complete a frame, so Deliver() is not called.
+  route->decoder_.Clear();
+  route->decoder_.Process(
+      ConstByteSpan(header_).first(header_size_), &Route::Deliver, *route);
+
+  route_ = route;
+  state_ = State::kRouting;
+}
+
+Demultiplexer::Route* Demultiplexer::FindRoute(uint64_t address) {
+  auto route = std::find_if(routes_.begin(), routes_.end(), [address](auto& r) {
+    return r.address() == address;
+  });
+  return route == routes_.end() ? nullptr : &*route;
+}
+
+}  // namespace pw::hdlc
@@ -0,0 +1,272 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_hdlc/demultiplexer.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_containers/vector.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::hdlc {
+namespace {
+
+using std::byte;
+
+constexpr uint64_t kRpcAddress = 82;
+constexpr uint64_t kBulkAddress = 3;
+
+// Encodes HDLC frames into a buffer.
+class Stream {
+ public:
+  Stream() : writer_(buffer_) {}
+
+  Stream& Frame(uint64_t address, ConstByteSpan payload) {
+    EXPECT_EQ(OkStatus(), WriteUIFrame(address, payload, writer_));
+    return *this;
+  }
+
+  Stream& Raw(ConstByteSpan data) {
+    EXPECT_EQ(OkStatus(), writer_.Write(data));
+    return *this;
+  }
+
+  ConstByteSpan data() const { return writer_.WrittenData(); }
+
+ private:
+  std::array<byte, 1024> buffer_{};
+  stream::MemoryWriter writer_;
+};
+
+// A route that records the frames it receives.
+template <size_t kSizeBytes>
+class TestRoute : public Demultiplexer::RouteBuffer<kSizeBytes> {
+ public:
+  TestRoute(uint64_t address)
+      : Demultiplexer::RouteBuffer<kSizeBytes>(
+            address, [this](const hdlc::Frame& frame) { Receive(frame); }) {}
+
+  bool hold_frames = false;
+  Vector<ConstByteSpan, 8> frames;
+
+ private:
+  void Receive(const hdlc::Frame& frame) {
+    EXPECT_EQ(frame.address(), this->address());
+    frames.push_back(frame.data());
+    if (hold_frames) {
+      this->Hold();
+    }
+  }
+};
+
+bool Equal(ConstByteSpan lhs, ConstByteSpan rhs) {
+  return lhs.size() == rhs.size() &&
+         std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+class DemultiplexerTest : public ::testing::Test {
+ protected:
+  DemultiplexerTest() : rpc_(kRpcAddress), bulk_(kBulkAddress) {
+    EXPECT_EQ(OkStatus(), demux_.AddRoute(rpc_));
+    EXPECT_EQ(OkStatus(), demux_.AddRoute(bulk_));
+  }
+
+  ~DemultiplexerTest() override {
+    EXPECT_EQ(OkStatus(), demux_.RemoveRoute(rpc_));
+    EXPECT_EQ(OkStatus(), demux_.RemoveRoute(bulk_));
+  }
+
+  Demultiplexer demux_;
+  TestRoute<256> rpc_;
+  TestRoute<32> bulk_;
+};
+
+constexpr auto kSmall = bytes::String("bulk data");
+
+std::array<byte, 200> LargePayload() {
+  std::array<byte, 200> payload;
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = static_cast<byte>(i);  // Includes flag and escape bytes.
+  }
+  return payload;
+}
+
+TEST_F(DemultiplexerTest, RoutesFramesByAddress) {
+  const auto large = LargePayload();
+  Stream stream;
+  stream.Frame(kBulkAddress, kSmall)
+      .Frame(kRpcAddress, large)
+      .Frame(kBulkAddress, kSmall);
+  demux_.Process(stream.data());
+
+  ASSERT_EQ(rpc_.frames.size(), 1u);
+  EXPECT_TRUE(Equal(rpc_.frames[0], large));
+  ASSERT_EQ(bulk_.frames.size(), 2u);
+  EXPECT_TRUE(Equal(bulk_.frames[0], kSmall));
+  EXPECT_TRUE(Equal(bulk_.frames[1], kSmall));
+  EXPECT_EQ(demux_.unrouted_frames(), 0u);
+}
+
+TEST_F(DemultiplexerTest, FramesAreDecodedInPlace) {
+  const auto large = LargePayload();
+  Stream stream;
+  stream.Frame(kRpcAddress, large).Frame(kBulkAddress, kSmall);
+  demux_.Process(stream.data());
+
+  ASSERT_EQ(rpc_.frames.size(), 1u);
+  ASSERT_EQ(bulk_.frames.size(), 1u);
+
+  // The RPC frame is still valid, since it is in its own route's buffer.
+  EXPECT_TRUE(Equal(rpc_.frames[0], large));
+  EXPECT_NE(rpc_.frames[0].data(), bulk_.frames[0].data());
+}
+
+TEST_F(DemultiplexerTest, ProcessOneByteAtATime) {
+  const auto large = LargePayload();
+  Stream stream;
+  stream.Frame(kRpcAddress, large).Frame(kBulkAddress, kSmall);
+  for (byte b : stream.data()) {
+    demux_.Process(b);
+  }
+
+  ASSERT_EQ(rpc_.frames.size(), 1u);
+  EXPECT_TRUE(Equal(rpc_.frames[0], large));
+  ASSERT_EQ(bulk_.frames.size(), 1u);
+  EXPECT_TRUE(Equal(bulk_.frames[0], kSmall));
+}
+
+TEST_F(DemultiplexerTest, FrameTooLargeForRouteIsDropped) {
+  const auto large = LargePayload();
+  Stream stream;
+  stream.Frame(kBulkAddress, large).Frame(kBulkAddress, kSmall);
+  demux_.Process(stream.data());
+
+  ASSERT_EQ(bulk_.frames.size(), 1u);
+  EXPECT_TRUE(Equal(bulk_.frames[0], kSmall));
+  EXPECT_EQ(bulk_.frames_dropped(), 1u);
+}
+
+TEST_F(DemultiplexerTest, HeldRouteOnlyDropsFramesForItsAddress) {
+  constexpr auto kFirst = bytes::String("first");
+  constexpr auto kSecond = bytes::String("second");
+  bulk_.hold_frames = true;
+
+  Stream stream;
+  stream.Frame(kBulkAddress, kFirst)
+      .Frame(kBulkAddress, kSecond)
+      .Frame(kRpcAddress, kSmall);
+  demux_.Process(stream.data());
+
+  EXPECT_TRUE(bulk_.held());
+  ASSERT_EQ(bulk_.frames.size(), 1u);
+  EXPECT_TRUE(Equal(bulk_.frames[0], kFirst));
+  EXPECT_EQ(bulk_.frames_dropped(), 1u);
+  ASSERT_EQ(rpc_.frames.size(), 1u);
+
+  bulk_.hold_frames = false;
+  bulk_.Release();
+  Stream next;
+  next.Frame(kBulkAddress, kSecond);
+  demux_.Process(next.data());
+
+  ASSERT_EQ(bulk_.frames.size(), 2u);
+  EXPECT_TRUE(Equal(bulk_.frames[1], kSecond));
+}
+
+TEST_F(DemultiplexerTest, UnroutedFramesAreCounted) {
+  Stream stream;
+  stream.Frame(kRpcAddress + 1, kSmall)
+      .Frame(kRpcAddress, kSmall)
+      .Frame(kBulkAddress + 1, kSmall);
+  demux_.Process(stream.data());
+
+  EXPECT_EQ(rpc_.frames.size(), 1u);
+  EXPECT_EQ(bulk_.frames.size(), 0u);
+  EXPECT_EQ(demux_.unrouted_frames(), 2u);
+}
+
+TEST_F(DemultiplexerTest, InvalidFramesAreDropped) {
+  Stream stream;
+  stream.Raw(bytes::String("garbage"))
+      .Frame(kRpcAddress, kSmall)
+      .Raw(bytes::String("~\xa5\x03\x7d~"))  // Incomplete and invalid frames.
+      .Frame(kRpcAddress, kSmall);
+  demux_.Process(stream.data());
+
+  EXPECT_EQ(rpc_.frames.size(), 2u);
+  EXPECT_EQ(rpc_.frames_dropped(), 1u);
+  EXPECT_EQ(demux_.unrouted_frames(), 0u);
+}
+
+TEST(Demultiplexer, EscapedAddresses) {
+  // These addresses encode to a varint with an escape or flag byte.
+  constexpr uint64_t kEscapeAddress = 0x3e;
+  constexpr uint64_t kFlagAddress = 0xbf;
+
+  Demultiplexer demux;
+  TestRoute<32> escape_route(kEscapeAddress);
+  TestRoute<32> flag_route(kFlagAddress);
+  ASSERT_EQ(OkStatus(), demux.AddRoute(escape_route));
+  ASSERT_EQ(OkStatus(), demux.AddRoute(flag_route));
+
+  Stream stream;
+  stream.Frame(kFlagAddress, kSmall).Frame(kEscapeAddress, kSmall);
+  demux.Process(stream.data());
+
+  EXPECT_EQ(escape_route.frames.size(), 1u);
+  EXPECT_EQ(flag_route.frames.size(), 1u);
+  EXPECT_EQ(demux.unrouted_frames(), 0u);
+
+  EXPECT_EQ(OkStatus(), demux.RemoveRoute(escape_route));
+  EXPECT_EQ(OkStatus(), demux.RemoveRoute(flag_route));
+}
+
+TEST(Demultiplexer, AddAndRemoveRoutes) {
+  Demultiplexer demux;
+  TestRoute<32> route(kRpcAddress);
+  TestRoute<32> same_address(kRpcAddress);
+
+  EXPECT_EQ(OkStatus(), demux.AddRoute(route));
+  EXPECT_EQ(Status::AlreadyExists(), demux.AddRoute(same_address));
+  EXPECT_EQ(OkStatus(), demux.RemoveRoute(route));
+  EXPECT_EQ(Status::NotFound(), demux.RemoveRoute(route));
+
+  Stream stream;
+  stream.Frame(kRpcAddress, kSmall);
+  demux.Process(stream.data());
+  EXPECT_EQ(route.frames.size(), 0u);
+  EXPECT_EQ(demux.unrouted_frames(), 1u);
+}
+
+TEST(Demultiplexer, RemoveRouteDuringFrame) {
+  Demultiplexer demux;
+  TestRoute<32> route(kRpcAddress);
+  ASSERT_EQ(OkStatus(), demux.AddRoute(route));
+
+  Stream stream;
+  stream.Frame(kRpcAddress, kSmall);
+  demux.Process(stream.data().first(4));
+  EXPECT_EQ(OkStatus(), demux.RemoveRoute(route));
+  demux.Process(stream.data().subspan(4));
+
+  EXPECT_EQ(route.frames.size(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::hdlc
@@ -20,14 +20,67 @@
 #include <cstring>
 
 #include "pw_bytes/endian.h"
+#include "pw_checksum/crc32.h"
+#include "pw_checksum/internal/crc32_slicing.h"
 #include "pw_hdlc/encoded_size.h"
 #include "pw_hdlc/internal/encoder.h"
 #include "pw_span/span.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_varint/varint.h"
 
 using std::byte;
 
 namespace pw::hdlc {
+namespace {
+
+// Fits frames with up to six escaped payload bytes.
+constexpr size_t kWriteUIFrameMaxSegments = 15;
+
+// Whether data is scanned for bytes to escape and added to the frame check
+// sequence in a single pass. This uses the slicing-by-8 CRC32 tables, so it is
+// only done when the default CRC32 implementation links them in anyway.
+constexpr bool kSinglePassFcs =
+    PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICING_BY_8;
+
+// Returns whether any byte of the word is a flag or escape byte. XOR zeroes the
+// bytes that match, and (x - 0x01..) & ~x & 0x80.. is nonzero iff some byte of
+// x is zero.
+constexpr bool HasFlagOrEscape(uint32_t word) {
+  constexpr uint32_t kLowBits = 0x01010101u;
+  constexpr uint32_t kHighBits = 0x80808080u;
+  const uint32_t flags = word ^ (kLowBits * static_cast<uint8_t>(kFlag));
+  const uint32_t escapes = word ^ (kLowBits * static_cast<uint8_t>(kEscape));
+  return ((((flags - kLowBits) & ~flags) | ((escapes - kLowBits) & ~escapes)) &
+          kHighBits) != 0u;
+}
+
+// Like FindFlagOrEscape(), but also updates the CRC32 state with the scanned
+// bytes, including the byte that ends the run, while they are in registers.
+size_t FindFlagOrEscapeAndUpdateCrc32(ConstByteSpan data, uint32_t& state) {
+  size_t i = 0;
+  for (; i + 8 <= data.size(); i += 8) {
+    const uint32_t low =
+        bytes::ReadInOrder<uint32_t>(endian::little, &data[i]);
+    const uint32_t high =
+        bytes::ReadInOrder<uint32_t>(endian::little, &data[i + 4]);
+    if (HasFlagOrEscape(low) || HasFlagOrEscape(high)) {
+      break;
+    }
+    state = checksum::internal::Crc32SlicingBy8Update(state, low, high);
+  }
+
+  for (; i < data.size(); ++i) {
+    state = checksum::internal::Crc32SlicingBy8Update(
+        state, static_cast<uint8_t>(data[i]));
+    if (NeedsEscaping(data[i])) {
+      return i;
+    }
+  }
+  return data.size();
+}
+
+}  // namespace
+
 namespace internal {
 
 Status EscapeAndWrite(const byte b, stream::Writer& writer) {
@@ -41,27 +94,41 @@ Status EscapeAndWrite(const byte b, stream::Writer& writer) {
 }
 
 Status Encoder::WriteData(ConstByteSpan data) {
-  auto begin = data.begin();
+  ConstByteSpan remaining = data;
   while (true) {
-    auto end = std::find_if(begin, data.end(), NeedsEscaping);
+    const size_t run_size = ScanData(remaining);
 
-    if (Status status = writer_.Write(span(begin, end)); !status.ok()) {
+    if (Status status = writer_.Write(remaining.first(run_size));
+        !status.ok()) {
       return status;
     }
-    if (end == data.end()) {
-      fcs_.Update(data);
+    if (run_size == remaining.size()) {
       return OkStatus();
     }
-    if (Status status = EscapeAndWrite(*end, writer_); !status.ok()) {
+    if (Status status = EscapeAndWrite(remaining[run_size], writer_);
+        !status.ok()) {
       return status;
     }
-    begin = end + 1;
+    remaining = remaining.subspan(run_size + 1);
   }
 }
 
+size_t Encoder::ScanData(ConstByteSpan data) {
+  if constexpr (kSinglePassFcs) {
+    uint32_t state = ~fcs_;
+    const size_t run_size = FindFlagOrEscapeAndUpdateCrc32(data, state);
+    fcs_ = ~state;
+    return run_size;
+  }
+
+  const size_t run_size = FindFlagOrEscape(data);
+  const size_t scanned = std::min(run_size + 1, data.size());
+  fcs_ = pw_checksum_Crc32Append(data.data(), scanned, fcs_);
+  return run_size;
+}
+
 Status Encoder::FinishFrame() {
-  if (Status status =
-          WriteData(bytes::CopyInOrder(endian::little, fcs_.value()));
+  if (Status status = WriteData(bytes::CopyInOrder(endian::little, fcs_));
       !status.ok()) {
     return status;
   }
@@ -69,7 +136,7 @@ Status Encoder::FinishFrame() {
 }
 
 Status Encoder::StartFrame(uint64_t address, std::byte control) {
-  fcs_.clear();
+  fcs_ = PW_CHECKSUM_EMPTY_CRC32;
   if (Status status = writer_.Write(kFlag); !status.ok()) {
     return status;
   }
@@ -94,6 +161,15 @@ Status WriteUIFrame(uint64_t address,
     return Status::ResourceExhausted();
   }
 
+  // Most payloads have few bytes to escape, so the frame fits in a short
+  // segment list and reaches the writer in a single WriteV() call. Frames with
+  // more escapes are written piece by piece.
+  FrameSegmentsBuffer<kWriteUIFrameMaxSegments> frame;
+  if (Status status = frame.EncodeUIFrame(address, payload);
+      !status.IsResourceExhausted()) {
+    return status.ok() ? writer.WriteV(frame.segments()) : status;
+  }
+
   internal::Encoder encoder(writer);
 
   if (Status status = encoder.StartUnnumberedFrame(address); !status.ok()) {
@@ -105,4 +181,67 @@ Status WriteUIFrame(uint64_t address,
   return encoder.FinishFrame();
 }
 
+Status FrameSegments::EncodeUIFrame(uint64_t address, ConstByteSpan payload) {
+  clear();
+
+  stream::MemoryWriter frame_bytes_writer(frame_bytes_);
+  internal::Encoder encoder(frame_bytes_writer);
+  if (Status status = encoder.StartUnnumberedFrame(address); !status.ok()) {
+    return status;
+  }
+  const size_t header_size = frame_bytes_writer.bytes_written();
+  if (!AddSegment(span(frame_bytes_).first(header_size))) {
+    return Status::ResourceExhausted();
+  }
+
+  while (!payload.empty()) {
+    const size_t run_size = encoder.ScanData(payload);
+    if (run_size != 0u && !AddSegment(payload.first(run_size))) {
+      clear();
+      return Status::ResourceExhausted();
+    }
+    if (run_size == payload.size()) {
+      break;
+    }
+
+    const ConstByteSpan escaped =
+        payload[run_size] == kFlag ? ConstByteSpan(kEscapedFlag)
+                                   : ConstByteSpan(kEscapedEscape);
+    if (!AddSegment(escaped)) {
+      clear();
+      return Status::ResourceExhausted();
+    }
+    payload = payload.subspan(run_size + 1);
+  }
+
+  if (Status status = encoder.FinishFrame(); !status.ok()) {
+    clear();
+    return status;
+  }
+  if (!AddSegment(
+          span(frame_bytes_)
+              .subspan(header_size,
+                       frame_bytes_writer.bytes_written() - header_size))) {
+    clear();
+    return Status::ResourceExhausted();
+  }
+  return OkStatus();
+}
+
+size_t FrameSegments::size_bytes() const {
+  size_t size = 0;
+  for (ConstByteSpan segment : segments()) {
+    size += segment.size();
+  }
+  return size;
+}
+
+bool FrameSegments::AddSegment(ConstByteSpan segment) {
+  if (segment_count_ == segments_.size()) {
+    return false;
+  }
+  segments_[segment_count_++] = segment;
+  return true;
+}
+
 }  // namespace pw::hdlc
@@ -21,6 +21,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
+#include "pw_hdlc/decoder.h"
 #include "pw_hdlc/encoded_size.h"
 #include "pw_hdlc/internal/encoder.h"
 #include "pw_hdlc/internal/protocol.h"
@@ -184,6 +185,178 @@ TEST_F(WriteUnnumberedFrame, PayloadTooLarge_WritesNothing) {
   EXPECT_EQ(0u, writer_.bytes_written());
 }
 
+TEST(WriteUIFrame, LongPayload_EscapesAcrossWords) {
+  // Place flag and escape bytes at and around word boundaries.
+  constexpr auto kPayload = bytes::Initialized<64>([](size_t i) {
+    switch (i) {
+      case 0:
+      case 7:
+      case 8:
+      case 16:
+        return 0x7e;
+      case 15:
+      case 31:
+      case 32:
+      case 63:
+        return 0x7d;
+      default:
+        return static_cast<int>(i);
+    }
+  });
+
+  std::array<byte, MaxEncodedFrameSize(kPayload.size())> buffer;
+  stream::MemoryWriter writer(buffer);
+  ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, kPayload, writer));
+
+  // Skip the flag, address, and control bytes.
+  ConstByteSpan escaped = writer.WrittenData().subspan(3);
+  for (byte b : kPayload) {
+    ASSERT_FALSE(escaped.empty());
+    if (NeedsEscaping(b)) {
+      EXPECT_EQ(escaped[0], kEscape);
+      EXPECT_EQ(escaped[1], Escape(b));
+      escaped = escaped.subspan(2);
+    } else {
+      EXPECT_EQ(escaped[0], b);
+      escaped = escaped.subspan(1);
+    }
+  }
+}
+
+TEST(WriteUIFrame, LongPayload_FrameCheckSequenceIsValid) {
+  // Escapes at each offset within a word exercise both the word and byte paths
+  // that update the frame check sequence.
+  for (size_t escape_index = 0; escape_index < 24; ++escape_index) {
+    auto payload = bytes::Initialized<40>([](size_t i) {
+      return static_cast<int>(i * 37 + 1);
+    });
+    payload[escape_index] = escape_index % 2 == 0 ? kFlag : kEscape;
+
+    std::array<byte, MaxEncodedFrameSize(payload.size())> buffer;
+    stream::MemoryWriter writer(buffer);
+    ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, payload, writer));
+
+    DecoderBuffer<payload.size() + 16> decoder;
+    Result<Frame> frame = Status::Unknown();
+    for (byte b : writer.WrittenData()) {
+      frame = decoder.Process(b);
+    }
+    ASSERT_EQ(frame.status(), OkStatus());
+    ASSERT_EQ(frame->data().size(), payload.size());
+    EXPECT_EQ(std::memcmp(frame->data().data(), payload.data(), payload.size()),
+              0);
+  }
+}
+
+// Counts the calls that reach a MemoryWriter.
+class CountingWriter : public stream::NonSeekableWriter {
+ public:
+  CountingWriter(ByteSpan buffer) : writer_(buffer) {}
+
+  ConstByteSpan WrittenData() const { return writer_.WrittenData(); }
+  size_t writes() const { return writes_; }
+  size_t vectored_writes() const { return vectored_writes_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+
+  Status DoWriteV(span<const ConstByteSpan> data) override {
+    vectored_writes_ += 1;
+    return writer_.WriteV(data);
+  }
+
+  size_t ConservativeLimit(LimitType type) const override {
+    return type == LimitType::kWrite ? writer_.ConservativeWriteLimit() : 0;
+  }
+
+  stream::MemoryWriter writer_;
+  size_t writes_ = 0;
+  size_t vectored_writes_ = 0;
+};
+
+TEST(WriteUIFrame, FewEscapes_WritesFrameInOneCall) {
+  constexpr auto kPayload = bytes::Array<0x01, 0x7e, 0x02, 0x7d, 0x03>();
+
+  std::array<byte, MaxEncodedFrameSize(kPayload.size())> expected_buffer;
+  stream::MemoryWriter expected(expected_buffer);
+  internal::Encoder encoder(expected);
+  ASSERT_EQ(OkStatus(), encoder.StartUnnumberedFrame(kAddress));
+  ASSERT_EQ(OkStatus(), encoder.WriteData(kPayload));
+  ASSERT_EQ(OkStatus(), encoder.FinishFrame());
+
+  std::array<byte, MaxEncodedFrameSize(kPayload.size())> buffer;
+  CountingWriter writer(buffer);
+  ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, kPayload, writer));
+  EXPECT_EQ(writer.vectored_writes(), 1u);
+  EXPECT_EQ(writer.writes(), 0u);
+
+  ASSERT_EQ(writer.WrittenData().size(), expected.bytes_written());
+  EXPECT_EQ(std::memcmp(writer.WrittenData().data(),
+                        expected.data(),
+                        expected.bytes_written()),
+            0);
+}
+
+// Concatenates a frame's segments and checks that they match WriteUIFrame.
+void ExpectSegmentsMatchWriteUIFrame(const FrameSegments& frame,
+                                     ConstByteSpan payload) {
+  std::array<byte, 256> expected_buffer;
+  stream::MemoryWriter expected(expected_buffer);
+  ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, payload, expected));
+
+  std::array<byte, 256> actual_buffer;
+  stream::MemoryWriter actual(actual_buffer);
+  for (ConstByteSpan segment : frame.segments()) {
+    ASSERT_EQ(OkStatus(), actual.Write(segment));
+  }
+
+  EXPECT_EQ(frame.size_bytes(), expected.bytes_written());
+  ASSERT_EQ(actual.bytes_written(), expected.bytes_written());
+  EXPECT_EQ(std::memcmp(actual.data(), expected.data(), actual.bytes_written()),
+            0);
+}
+
+TEST(FrameSegments, NoEscapes_ReferencesPayload) {
+  constexpr auto kPayload = bytes::String("Hello, world!");
+  FrameSegmentsBuffer<3> frame;
+  ASSERT_EQ(OkStatus(), frame.EncodeUIFrame(kAddress, kPayload));
+
+  ASSERT_EQ(frame.segments().size(), 3u);
+  EXPECT_EQ(frame.segments()[1].data(), kPayload.data());
+  EXPECT_EQ(frame.segments()[1].size(), kPayload.size());
+  ExpectSegmentsMatchWriteUIFrame(frame, kPayload);
+}
+
+TEST(FrameSegments, EmptyPayload) {
+  FrameSegmentsBuffer<3> frame;
+  ASSERT_EQ(OkStatus(), frame.EncodeUIFrame(kAddress, ConstByteSpan()));
+  EXPECT_EQ(frame.segments().size(), 2u);
+  ExpectSegmentsMatchWriteUIFrame(frame, ConstByteSpan());
+}
+
+TEST(FrameSegments, Escapes) {
+  constexpr auto kPayload =
+      bytes::Array<0x7e, '1', '2', '3', 0x7d, 0x7e, '4', '5', '6', 0x7d>();
+  FrameSegmentsBuffer<16> frame;
+  ASSERT_EQ(OkStatus(), frame.EncodeUIFrame(kAddress, kPayload));
+
+  // Header, four escapes, two runs, and the FCS.
+  EXPECT_EQ(frame.segments().size(), 8u);
+  EXPECT_EQ(frame.segments()[2].data(), kPayload.data() + 1);
+  ExpectSegmentsMatchWriteUIFrame(frame, kPayload);
+}
+
+TEST(FrameSegments, TooManyEscapes_ResourceExhausted) {
+  constexpr auto kPayload = bytes::Array<0x7e, '1', 0x7e, '2', 0x7e, '3'>();
+  FrameSegmentsBuffer<5> frame;
+  EXPECT_EQ(Status::ResourceExhausted(),
+            frame.EncodeUIFrame(kAddress, kPayload));
+  EXPECT_TRUE(frame.segments().empty());
+}
+
 class ErrorWriter : public stream::NonSeekableWriter {
  private:
   Status DoWrite(ConstByteSpan) override { return Status::Unimplemented(); }
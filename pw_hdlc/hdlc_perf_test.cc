@@ -0,0 +1,84 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_hdlc/internal/protocol.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::hdlc {
+namespace {
+
+constexpr uint64_t kAddress = 0x7B;
+constexpr size_t kMaxPayloadSize = 256;
+
+// Fills a payload where one in escape_every bytes must be escaped, or none if
+// escape_every is 0.
+std::array<std::byte, kMaxPayloadSize> MakePayload(size_t escape_every) {
+  std::array<std::byte, kMaxPayloadSize> payload;
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = escape_every != 0 && i % escape_every == 0
+                     ? kFlag
+                     : static_cast<std::byte>(i & 0x3F);
+  }
+  return payload;
+}
+
+void EncodeTest(perf_test::State& state,
+                int64_t payload_size,
+                size_t escape_every) {
+  const auto payload = MakePayload(escape_every);
+  const ConstByteSpan data =
+      span(payload).first(static_cast<size_t>(payload_size));
+  stream::MemoryWriterBuffer<2 * kMaxPayloadSize + 32> writer;
+  while (state.KeepRunning()) {
+    writer.clear();
+    WriteUIFrame(kAddress, data, writer).IgnoreError();
+  }
+}
+
+void DecodeTest(perf_test::State& state,
+                int64_t payload_size,
+                size_t escape_every) {
+  const auto payload = MakePayload(escape_every);
+  stream::MemoryWriterBuffer<2 * kMaxPayloadSize + 32> frame;
+  WriteUIFrame(kAddress,
+               span(payload).first(static_cast<size_t>(payload_size)),
+               frame)
+      .IgnoreError();
+
+  DecoderBuffer<kMaxPayloadSize + 16> decoder;
+  size_t frames = 0;
+  while (state.KeepRunning()) {
+    decoder.Process(frame.WrittenData(),
+                    [&frames](const Result<Frame>& result) {
+                      if (result.ok()) {
+                        ++frames;
+                      }
+                    });
+  }
+}
+
+PW_PERF_TEST_RANGE(Encode, EncodeTest, 8, 256, 4, 0);
+PW_PERF_TEST_RANGE(EncodeEscaped, EncodeTest, 8, 256, 4, 8);
+PW_PERF_TEST_RANGE(Decode, DecodeTest, 8, 256, 4, 0);
+PW_PERF_TEST_RANGE(DecodeEscaped, DecodeTest, 8, 256, 4, 8);
+
+}  // namespace
+}  // namespace pw::hdlc
@@ -0,0 +1,197 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pw_bytes/span.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_function/function.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_hdlc/internal/protocol.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw::hdlc {
+
+/// Decodes an HDLC stream that carries frames for several addresses, and
+/// delivers each frame to the route registered for its address.
+///
+/// Each route has its own `Decoder` and buffer. The demultiplexer reads the
+/// address at the start of each frame, then passes the rest of the frame to
+/// that address's decoder, so frames are decoded in place into the route's
+/// buffer and never copied. Each buffer only needs to fit the largest frame
+/// sent to its address. For example, large RPC frames and small frames of bulk
+/// data can each use a buffer sized for them.
+///
+/// A route can hold a frame after its handler returns, for example to queue it
+/// for another thread. While a route holds a frame, later frames for its
+/// address are dropped. Frames for other addresses are still delivered, so a
+/// slow consumer of one address does not hold up the others.
+///
+/// `Process()`, `AddRoute()`, and `RemoveRoute()` must be called from the same
+/// thread. `Route::Release()` may be called from any thread.
+class Demultiplexer {
+ public:
+  /// Receives the frames sent to one address.
+  class Route : public IntrusiveList<Route>::Item {
+   public:
+    /// Called with each valid frame sent to the route's address. The frame's
+    /// data is in the route's buffer, and remains valid until the next frame
+    /// for the address is decoded. If the handler calls `Hold()`, the frame
+    /// remains valid until `Release()` is called.
+    using Handler = Function<void(const Frame& frame)>;
+
+    Route(uint64_t address, ByteSpan buffer, Handler&& handler)
+        : address_(address),
+          decoder_(buffer),
+          handler_(std::move(handler)),
+          held_(false),
+          frames_dropped_(0) {}
+
+    Route(const Route&) = delete;
+    Route& operator=(const Route&) = delete;
+
+    uint64_t address() const { return address_; }
+
+    /// Keeps the last frame delivered to the handler valid until `Release()`
+    /// is called. Frames for this address are dropped in the meantime.
+    void Hold() { held_.store(true, std::memory_order_relaxed); }
+
+    /// Releases a held frame, so that the route receives frames again. May be
+    /// called from any thread.
+    void Release() { held_.store(false, std::memory_order_release); }
+
+    bool held() const { return held_.load(std::memory_order_acquire); }
+
+    /// The number of frames for this address that were not delivered, because
+    /// the route held a frame, or the frame was invalid or did not fit in the
+    /// route's buffer.
+    size_t frames_dropped() const { return frames_dropped_; }
+
+   private:
+    friend class Demultiplexer;
+
+    void Deliver(const Result<Frame>& frame);
+
+    const uint64_t address_;
+    Decoder decoder_;
+    Handler handler_;
+    std::atomic<bool> held_;
+    size_t frames_dropped_;
+  };
+
+  /// A `Route` with a buffer for frames of up to `kSizeBytes`, as for
+  /// `DecoderBuffer`.
+  template <size_t kSizeBytes>
+  class RouteBuffer : public Route {
+   public:
+    RouteBuffer(uint64_t address, Handler&& handler)
+        : Route(address, frame_buffer_, std::move(handler)) {}
+
+   private:
+    static_assert(kSizeBytes >= Frame::kMinContentSizeBytes);
+
+    std::array<std::byte, kSizeBytes> frame_buffer_;
+  };
+
+  constexpr Demultiplexer() = default;
+
+  Demultiplexer(const Demultiplexer&) = delete;
+  Demultiplexer& operator=(const Demultiplexer&) = delete;
+
+  /// Starts delivering frames for the route's address to the route, which
+  /// must remain valid until it is removed.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The route was added.
+  /// * @pw_status{ALREADY_EXISTS} - Another route has the same address.
+  Status AddRoute(Route& route);
+
+  /// Stops delivering frames to the route. If a frame for the route is being
+  /// decoded, it is discarded.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The route was removed.
+  /// * @pw_status{NOT_FOUND} - The route was not added.
+  Status RemoveRoute(Route& route);
+
+  /// Decodes data from the HDLC stream, calling route handlers with the
+  /// frames that it completes.
+  void Process(ConstByteSpan data);
+
+  void Process(std::byte data) { Process(ConstByteSpan(&data, 1)); }
+
+  /// Discards the frame being decoded, if any.
+  void Clear() {
+    state_ = State::kInterFrame;
+    route_ = nullptr;
+  }
+
+  /// The number of frames that were dropped because no route had their
+  /// address, or their address could not be decoded.
+  size_t unrouted_frames() const { return unrouted_frames_; }
+
+ private:
+  enum class State {
+    kInterFrame,  // Discarding bytes until the next flag.
+    kAddress,     // Reading the address at the start of a frame.
+    kRouting,     // Passing the frame to route_'s decoder.
+  };
+
+  // Reads the start of a frame until the address is known. Returns the number
+  // of bytes consumed.
+  size_t ProcessAddress(ConstByteSpan data);
+
+  // Called once the address of the current frame is complete.
+  void StartRoute();
+
+  void StartFrame() {
+    state_ = State::kAddress;
+    header_[0] = kFlag;
+    header_size_ = 1;
+    address_size_ = 0;
+    escape_ = false;
+  }
+
+  void DropFrame() {
+    unrouted_frames_ += 1;
+    state_ = State::kInterFrame;
+  }
+
+  Route* FindRoute(uint64_t address);
+
+  IntrusiveList<Route> routes_;
+  Route* route_ = nullptr;
+  State state_ = State::kInterFrame;
+
+  // The flag and escaped address bytes that start the frame, which are
+  // replayed to the route's decoder once the address is known. Every address
+  // byte may be escaped in an invalid frame.
+  std::array<std::byte, 1 + 2 * kMaxAddressSize> header_{};
+  size_t header_size_ = 0;
+
+  // The unescaped address.
+  std::array<std::byte, kMaxAddressSize> address_{};
+  size_t address_size_ = 0;
+  bool escape_ = false;
+
+  size_t unrouted_frames_ = 0;
+};
+
+}  // namespace pw::hdlc
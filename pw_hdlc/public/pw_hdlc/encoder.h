@@ -13,7 +13,13 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 #include "pw_bytes/span.h"
+#include "pw_hdlc/encoded_size.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
 #include "pw_stream/stream.h"
 
@@ -47,4 +53,68 @@ Status WriteUIFrame(uint64_t address,
                     ConstByteSpan payload,
                     stream::Writer& writer);
 
+/// @brief An HDLC frame encoded as a list of contiguous memory segments, for
+/// drivers that send data with scatter-gather DMA.
+///
+/// Runs of payload bytes that need no escaping are referenced in place rather
+/// than copied, and escape sequences point to constant data. Only the flag,
+/// address, control, and frame check sequence bytes are stored in the
+/// `FrameSegments` object. A frame needs three segments, plus two for each
+/// payload byte that is escaped.
+///
+/// The segments are invalidated when the payload or the `FrameSegments` object
+/// changes or is destroyed. The `FrameSegmentsBuffer` class template, defined
+/// below, allocates storage for the segment list.
+class FrameSegments {
+ public:
+  constexpr FrameSegments(span<ConstByteSpan> segments)
+      : segments_(segments), segment_count_(0), frame_bytes_{} {}
+
+  FrameSegments(const FrameSegments&) = delete;
+  FrameSegments& operator=(const FrameSegments&) = delete;
+
+  /// @brief Encodes an HDLC unnumbered information frame (UI frame), replacing
+  /// any previously encoded frame.
+  ///
+  /// @returns A `pw::Status`:
+  /// * `OK` - The frame was encoded; `segments()` contains it.
+  /// * `RESOURCE_EXHAUSTED` - The payload has too many bytes that need
+  ///   escaping to fit in the segment list. No segments are produced; the frame
+  ///   can be sent with `WriteUIFrame()` instead.
+  /// * `INVALID_ARGUMENT` - The address could not be encoded.
+  Status EncodeUIFrame(uint64_t address, ConstByteSpan payload);
+
+  /// The segments of the encoded frame, to be sent in order.
+  span<const ConstByteSpan> segments() const {
+    return segments_.first(segment_count_);
+  }
+
+  /// The total size of the encoded frame in bytes.
+  size_t size_bytes() const;
+
+  /// Clears the encoded frame.
+  void clear() { segment_count_ = 0; }
+
+ private:
+  bool AddSegment(ConstByteSpan segment);
+
+  const span<ConstByteSpan> segments_;
+  size_t segment_count_;
+
+  // Holds the start of the frame followed by its end, both already escaped.
+  std::array<std::byte, MaxEncodedFrameSize(0)> frame_bytes_;
+};
+
+/// `FrameSegmentsBuffer` declares a segment list along with a `FrameSegments`.
+template <size_t kMaxSegments>
+class FrameSegmentsBuffer : public FrameSegments {
+ public:
+  FrameSegmentsBuffer() : FrameSegments(segment_buffer_) {}
+
+ private:
+  static_assert(kMaxSegments >= 3, "A frame requires at least three segments");
+
+  std::array<ConstByteSpan, kMaxSegments> segment_buffer_;
+};
+
 }  // namespace pw::hdlc
@@ -48,6 +48,12 @@ class Encoder {
   // Finishes a frame. Writes the frame check sequence and a terminating flag.
   Status FinishFrame();
 
+  // Returns the number of bytes at the start of data that do not need to be
+  // escaped, like FindFlagOrEscape(). Adds those bytes, and the byte that ends
+  // the run if there is one, to the frame check sequence. Used to escape and
+  // output data separately from this encoder.
+  size_t ScanData(ConstByteSpan data);
+
  private:
   // Indicates this an information packet with sequence numbers set to 0.
   static constexpr std::byte kUnusedControl = std::byte{0};
@@ -55,7 +61,7 @@ class Encoder {
   Status StartFrame(uint64_t address, std::byte control);
 
   stream::Writer& writer_;
-  checksum::Crc32 fcs_;
+  uint32_t fcs_ = PW_CHECKSUM_EMPTY_CRC32;
 };
 
 }  // namespace pw::hdlc::internal
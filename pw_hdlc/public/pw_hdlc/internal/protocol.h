@@ -13,8 +13,13 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
+#include "pw_bytes/span.h"
 #include "pw_varint/varint.h"
 
 namespace pw::hdlc {
@@ -68,6 +73,39 @@ constexpr bool NeedsEscaping(std::byte b) {
 
 constexpr std::byte Escape(std::byte b) { return b ^ kEscapeConstant; }
 
+// Returns the index of the first flag or escape byte in data, or data.size() if
+// there are none. Bytes are checked a word at a time, so that the runs between
+// these bytes can be copied in bulk.
+inline size_t FindFlagOrEscape(ConstByteSpan data) {
+  using Word = uintptr_t;
+  constexpr Word kLowBits = std::numeric_limits<Word>::max() / 0xFF;
+  constexpr Word kHighBits = kLowBits << 7;
+  constexpr Word kFlags = kLowBits * static_cast<uint8_t>(kFlag);
+  constexpr Word kEscapes = kLowBits * static_cast<uint8_t>(kEscape);
+
+  size_t i = 0;
+  for (; i + sizeof(Word) <= data.size(); i += sizeof(Word)) {
+    Word word;
+    std::memcpy(&word, &data[i], sizeof(word));
+
+    // XOR zeroes the bytes that match. (x - 0x01..) & ~x & 0x80.. is nonzero
+    // iff some byte of x is zero.
+    const Word flags = word ^ kFlags;
+    const Word escapes = word ^ kEscapes;
+    if ((((flags - kLowBits) & ~flags) | ((escapes - kLowBits) & ~escapes)) &
+        kHighBits) {
+      break;
+    }
+  }
+
+  for (; i < data.size(); ++i) {
+    if (NeedsEscaping(data[i])) {
+      break;
+    }
+  }
+  return i;
+}
+
 // Class that manages the 1-byte control field of an HDLC U-frame.
 class UFrameControl {
  public:
@@ -0,0 +1,60 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/initiator.h"
+
+namespace pw::i2c {
+
+Status Initiator::DoTransferFor(span<const Message> messages,
+                                chrono::SystemClock::duration timeout) {
+  if (messages.empty()) {
+    return Status::InvalidArgument();
+  }
+  const chrono::SystemClock::time_point deadline =
+      chrono::SystemClock::TimePointAfterAtLeast(timeout);
+
+  for (size_t i = 0; i < messages.size(); ++i) {
+    const bool first = i == 0;
+    const Message& message = messages[i];
+    if (message.GetData().empty()) {
+      return Status::InvalidArgument();
+    }
+    ConstByteSpan tx_buffer;
+    ByteSpan rx_buffer;
+    if (message.IsRead()) {
+      rx_buffer = message.GetMutableData();
+    } else {
+      tx_buffer = message.GetData();
+      // Combine a write and a following read of the same device.
+      if (i + 1 < messages.size() && messages[i + 1].IsRead() &&
+          messages[i + 1].GetAddress().GetTenBit() ==
+              message.GetAddress().GetTenBit() &&
+          !messages[i + 1].GetData().empty()) {
+        rx_buffer = messages[++i].GetMutableData();
+      }
+    }
+
+    // The first transaction gets the full timeout, like WriteReadFor().
+    const chrono::SystemClock::duration remaining =
+        first ? timeout : deadline - chrono::SystemClock::now();
+    if (Status status = DoWriteReadFor(
+            message.GetAddress(), tx_buffer, rx_buffer, remaining);
+        !status.ok()) {
+      return status;
+    }
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::i2c
@@ -115,5 +115,55 @@ TEST(Transaction, Probe) {
   EXPECT_EQ(mock_initiator.Finalize(), OkStatus());
 }
 
+TEST(Transaction, TransferForCombinesWriteThenRead) {
+  static constexpr Address kAddress1 = Address::SevenBit<0x01>();
+  static constexpr Address kAddress2 = Address::SevenBit<0x02>();
+  constexpr auto kExpectWrite1 = bytes::Array<1, 2>();
+  constexpr auto kExpectRead1 = bytes::Array<3, 4, 5>();
+  constexpr auto kExpectWrite2 = bytes::Array<6>();
+  constexpr auto kExpectRead2 = bytes::Array<7>();
+
+  // The default implementation performs a write followed by a read of the
+  // same device as one transaction, and all other messages separately.
+  auto expected_transactions = MakeExpectedTransactionArray({
+      Transaction(OkStatus(), kAddress1, kExpectWrite1, kExpectRead1, 2ms),
+      WriteTransaction(OkStatus(), kAddress2, kExpectWrite2),
+      ReadTransaction(OkStatus(), kAddress1, kExpectRead2),
+  });
+  MockInitiator mocked_i2c(expected_transactions);
+
+  std::array<std::byte, kExpectRead1.size()> read1;
+  std::array<std::byte, kExpectRead2.size()> read2;
+  const std::array messages = {
+      Message::WriteMessage(kAddress1, kExpectWrite1),
+      Message::ReadMessage(kAddress1, read1),
+      Message::WriteMessage(kAddress2, kExpectWrite2),
+      Message::ReadMessage(kAddress1, read2),
+  };
+  EXPECT_EQ(mocked_i2c.TransferFor(messages, 2ms), OkStatus());
+  EXPECT_TRUE(pw::containers::Equal(read1, kExpectRead1));
+  EXPECT_TRUE(pw::containers::Equal(read2, kExpectRead2));
+  EXPECT_EQ(mocked_i2c.Finalize(), OkStatus());
+}
+
+TEST(Transaction, TransferForStopsAtFailure) {
+  static constexpr Address kAddress1 = Address::SevenBit<0x01>();
+  constexpr auto kExpectWrite = bytes::Array<1>();
+
+  auto expected_transactions = MakeExpectedTransactionArray({
+      WriteTransaction(Status::Unavailable(), kAddress1, kExpectWrite),
+  });
+  MockInitiator mocked_i2c(expected_transactions);
+
+  const std::array messages = {
+      Message::WriteMessage(kAddress1, kExpectWrite),
+      Message::WriteMessage(kAddress1, kExpectWrite),
+  };
+  EXPECT_EQ(mocked_i2c.TransferFor(messages, 2ms), Status::Unavailable());
+  EXPECT_EQ(mocked_i2c.TransferFor(span<const Message>(), 2ms),
+            Status::InvalidArgument());
+  EXPECT_EQ(mocked_i2c.Finalize(), OkStatus());
+}
+
 }  // namespace
 }  // namespace pw::i2c
@@ -166,6 +166,10 @@ class Device {
     return initiator_.ProbeDeviceFor(device_address_, timeout);
   }
 
+ protected:
+  Initiator& initiator() const { return initiator_; }
+  constexpr Address address() const { return device_address_; }
+
  private:
   Initiator& initiator_;
   const Address device_address_;
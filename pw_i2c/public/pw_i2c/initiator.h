@@ -18,10 +18,45 @@
 #include "pw_bytes/span.h"
 #include "pw_chrono/system_clock.h"
 #include "pw_i2c/address.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
 
 namespace pw::i2c {
 
+/// A single read or write of one device, as part of a sequence of messages
+/// passed to `Initiator::TransferFor()`.
+class Message {
+ public:
+  /// Creates a message that writes `data` to the device.
+  static constexpr Message WriteMessage(Address address, ConstByteSpan data) {
+    return Message(address,
+                   ByteSpan(const_cast<std::byte*>(data.data()), data.size()),
+                   /*is_read=*/false);
+  }
+
+  /// Creates a message that reads `data.size()` bytes from the device.
+  static constexpr Message ReadMessage(Address address, ByteSpan data) {
+    return Message(address, data, /*is_read=*/true);
+  }
+
+  constexpr Address GetAddress() const { return address_; }
+  constexpr bool IsRead() const { return is_read_; }
+
+  /// The bytes written, or the buffer read into.
+  constexpr ConstByteSpan GetData() const { return data_; }
+
+  /// The buffer read into. Must only be called on read messages.
+  constexpr ByteSpan GetMutableData() const { return data_; }
+
+ private:
+  constexpr Message(Address address, ByteSpan data, bool is_read)
+      : address_(address), data_(data), is_read_(is_read) {}
+
+  Address address_;
+  ByteSpan data_;
+  bool is_read_;
+};
+
 /// @brief The common, base driver interface for initiating thread-safe
 /// transactions with devices on an I2C bus. Other documentation may call this
 /// style of interface an I2C "master", <!-- inclusive-language: disable -->
@@ -189,6 +224,32 @@ class Initiator {
         device_address, ConstByteSpan(), ignored_buffer, timeout);
   }
 
+  /// Performs a sequence of reads and writes, possibly of several devices,
+  /// with one call. Backends that support it execute the whole sequence at
+  /// once, e.g. as one `I2C_RDWR` ioctl or one interrupt or DMA driven chain,
+  /// with a repeated START between messages and a single STOP at the end. This
+  /// avoids the per-transaction overhead of polling many registers or devices.
+  ///
+  /// Backends that don't override `DoTransferFor()` perform each message as a
+  /// separate transaction, except that a write followed by a read of the same
+  /// device is performed as one `WriteReadFor()` transaction.
+  ///
+  /// The timeout applies to the whole sequence. Stops at the first message
+  /// that fails.
+  ///
+  /// @returns The same statuses as `WriteReadFor()`, and `InvalidArgument` if
+  /// `messages` is empty or a message has no data.
+  Status TransferFor(span<const Message> messages,
+                     chrono::SystemClock::duration timeout) {
+    return DoTransferFor(messages, timeout);
+  }
+
+ protected:
+  /// Implements `TransferFor()` with `DoWriteReadFor()`. Backends that can
+  /// execute a sequence of messages more efficiently should override it.
+  virtual Status DoTransferFor(span<const Message> messages,
+                               chrono::SystemClock::duration timeout);
+
  private:
   virtual Status DoWriteReadFor(Address device_address,
                                 ConstByteSpan tx_buffer,
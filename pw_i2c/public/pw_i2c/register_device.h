@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include "pw_bytes/byte_builder.h"
 #include "pw_bytes/endian.h"
 #include "pw_bytes/span.h"
 #include "pw_chrono/system_clock.h"
@@ -26,6 +27,10 @@
 namespace pw {
 namespace i2c {
 
+namespace internal {
+class GenericRegisterMap;
+}  // namespace internal
+
 enum class RegisterAddressSize {
   k1Byte = 1,
   k2Bytes = 2,
@@ -234,6 +239,13 @@ class RegisterDevice : public Device {
                                   chrono::SystemClock::duration timeout);
 
  private:
+  friend class internal::GenericRegisterMap;
+
+  // Puts the register address in the buffer in the device's address size and
+  // order.
+  void PutRegisterAddress(ByteBuilder& builder,
+                          uint32_t register_address) const;
+
   // Helper write registers.
   Status WriteRegisters(uint32_t register_address,
                         ConstByteSpan register_data,
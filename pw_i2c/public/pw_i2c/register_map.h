@@ -0,0 +1,175 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_containers/vector.h"
+#include "pw_i2c/initiator.h"
+#include "pw_i2c/register_device.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw::i2c {
+namespace internal {
+
+/// The parts of a `RegisterMap` that don't depend on its capacity.
+class GenericRegisterMap {
+ public:
+  GenericRegisterMap(const GenericRegisterMap&) = delete;
+  GenericRegisterMap& operator=(const GenericRegisterMap&) = delete;
+
+  /// Adds a block of 8-bit registers that starts at `register_address` and is
+  /// read into `registers`, which must outlive the map.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The block was added.
+  /// * @pw_status{INVALID_ARGUMENT} - `registers` is empty or doesn't cover
+  ///   whole register addresses.
+  /// * @pw_status{RESOURCE_EXHAUSTED} - The map has no room for the block.
+  Status Add8(uint32_t register_address, span<uint8_t> registers) {
+    return Add(register_address, as_writable_bytes(registers), 1);
+  }
+
+  /// Adds a block of 16-bit registers, like `Add8()`.
+  Status Add16(uint32_t register_address, span<uint16_t> registers) {
+    return Add(register_address, as_writable_bytes(registers), 2);
+  }
+
+  /// Adds a block of 32-bit registers, like `Add8()`.
+  Status Add32(uint32_t register_address, span<uint32_t> registers) {
+    return Add(register_address, as_writable_bytes(registers), 4);
+  }
+
+  /// Reads all blocks with one `Initiator::TransferFor()` call. The blocks are
+  /// only updated if the whole transfer succeeds.
+  ///
+  /// @returns The same statuses as `Initiator::TransferFor()`, and
+  /// @pw_status{FAILED_PRECONDITION} if no blocks were added.
+  Status ReadFor(chrono::SystemClock::duration timeout);
+
+  /// Returns the number of bursts, each of which is one write of a register
+  /// address followed by one read.
+  size_t bursts() const { return bursts_.size(); }
+
+  /// Removes all blocks.
+  void Clear() {
+    blocks_.clear();
+    bursts_.clear();
+    buffer_used_ = 0;
+  }
+
+ protected:
+  struct Block {
+    ByteSpan registers;
+    uint8_t register_size;
+    // Where the block's bytes are in the buffer.
+    size_t offset;
+  };
+
+  struct Burst {
+    uint32_t register_address;
+    size_t offset;
+    size_t size_bytes;
+    // The encoded register address.
+    std::array<std::byte, sizeof(uint32_t)> address_bytes;
+    uint8_t address_size;
+  };
+
+  GenericRegisterMap(RegisterDevice& device,
+                     size_t bytes_per_register_address,
+                     Vector<Block>& blocks,
+                     Vector<Burst>& bursts,
+                     Vector<Message>& messages,
+                     ByteSpan buffer)
+      : device_(device),
+        bytes_per_register_address_(bytes_per_register_address),
+        blocks_(blocks),
+        bursts_(bursts),
+        messages_(messages),
+        buffer_(buffer) {}
+
+  ~GenericRegisterMap() = default;
+
+ private:
+  Status Add(uint32_t register_address,
+             ByteSpan registers,
+             uint8_t register_size);
+
+  RegisterDevice& device_;
+  const size_t bytes_per_register_address_;
+  Vector<Block>& blocks_;
+  Vector<Burst>& bursts_;
+  Vector<Message>& messages_;
+  const ByteSpan buffer_;
+  size_t buffer_used_ = 0;
+};
+
+}  // namespace internal
+
+/// Reads blocks of registers of a `RegisterDevice`, such as all the registers
+/// of a sensor sample, with one `Initiator::TransferFor()` call.
+///
+/// Blocks that continue where the previous block ends are read as one
+/// auto-increment burst, so their register address is only sent once. Each
+/// block's data is converted from the device's data order as a whole after
+/// the transfer. Add blocks in address order so contiguous blocks can be
+/// merged. Blocks separated by registers that aren't added start new bursts.
+///
+/// @code{.cpp}
+///   pw::i2c::RegisterMap<3, 13> sample_map(imu);
+///   uint8_t status;
+///   std::array<uint16_t, 3> accel;
+///   std::array<uint16_t, 3> gyro;
+///   PW_TRY(sample_map.Add8(kStatusRegister, span(&status, 1)));
+///   PW_TRY(sample_map.Add16(kAccelXRegister, accel));
+///   PW_TRY(sample_map.Add16(kGyroXRegister, gyro));
+///
+///   // Each sample is then read in one transfer.
+///   PW_TRY(sample_map.ReadFor(kTimeout));
+/// @endcode
+///
+/// The device must support auto-incrementing register addresses for reads
+/// that span several registers.
+///
+/// @tparam kMaxBlocks The maximum number of blocks.
+/// @tparam kMaxBytes The maximum number of bytes of all blocks.
+template <size_t kMaxBlocks, size_t kMaxBytes>
+class RegisterMap : public internal::GenericRegisterMap {
+ public:
+  /// @param device The device to read.
+  /// @param bytes_per_register_address The number of bytes the register
+  /// address advances by, which is 1 for most devices and the register size
+  /// for devices that address whole registers.
+  explicit RegisterMap(RegisterDevice& device,
+                       size_t bytes_per_register_address = 1)
+      : GenericRegisterMap(device,
+                           bytes_per_register_address,
+                           blocks_,
+                           bursts_,
+                           messages_,
+                           buffer_) {}
+
+ private:
+  Vector<Block, kMaxBlocks> blocks_;
+  Vector<Burst, kMaxBlocks> bursts_;
+  Vector<Message, 2 * kMaxBlocks> messages_;
+  std::array<std::byte, kMaxBytes> buffer_;
+};
+
+}  // namespace pw::i2c
@@ -84,6 +84,12 @@ Status PutRegisterData32InByteBuilder(ByteBuilder& byte_builder,
 
 }  // namespace
 
+void RegisterDevice::PutRegisterAddress(ByteBuilder& builder,
+                                        uint32_t register_address) const {
+  PutRegisterAddressInByteBuilder(
+      builder, register_address, register_address_order_, register_address_size_);
+}
+
 Status RegisterDevice::WriteRegisters(const uint32_t register_address,
                                       ConstByteSpan register_data,
                                       const size_t register_data_size,
@@ -0,0 +1,114 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/register_map.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_bytes/byte_builder.h"
+#include "pw_bytes/endian.h"
+#include "pw_status/try.h"
+
+namespace pw::i2c::internal {
+namespace {
+
+// Copies registers of type T from the device's data order.
+template <typename T>
+void CopyRegisters(ConstByteSpan data, endian order, ByteSpan registers) {
+  if (order == endian::native) {
+    std::memcpy(registers.data(), data.data(), data.size());
+    return;
+  }
+  for (size_t i = 0; i < data.size(); i += sizeof(T)) {
+    const T value = bytes::ReadInOrder<T>(order, data.data() + i);
+    std::memcpy(registers.data() + i, &value, sizeof(value));
+  }
+}
+
+}  // namespace
+
+Status GenericRegisterMap::Add(uint32_t register_address,
+                               ByteSpan registers,
+                               uint8_t register_size) {
+  if (registers.empty() ||
+      registers.size() % bytes_per_register_address_ != 0) {
+    return Status::InvalidArgument();
+  }
+  if (blocks_.full() || buffer_.size() - buffer_used_ < registers.size()) {
+    return Status::ResourceExhausted();
+  }
+
+  // Extend the last burst if the block starts where it ends.
+  const bool continues_burst =
+      !bursts_.empty() &&
+      bursts_.back().register_address +
+              bursts_.back().size_bytes / bytes_per_register_address_ ==
+          register_address;
+  if (continues_burst) {
+    bursts_.back().size_bytes += registers.size();
+  } else {
+    Burst burst = {};
+    burst.register_address = register_address;
+    burst.offset = buffer_used_;
+    burst.size_bytes = registers.size();
+    ByteBuilder builder(burst.address_bytes);
+    device_.PutRegisterAddress(builder, register_address);
+    if (!builder.ok()) {
+      return Status::Internal();
+    }
+    burst.address_size = static_cast<uint8_t>(builder.size());
+    bursts_.push_back(burst);
+  }
+
+  blocks_.push_back({registers, register_size, buffer_used_});
+  buffer_used_ += registers.size();
+  return OkStatus();
+}
+
+Status GenericRegisterMap::ReadFor(chrono::SystemClock::duration timeout) {
+  if (bursts_.empty()) {
+    return Status::FailedPrecondition();
+  }
+
+  const Address address = device_.address();
+  messages_.clear();
+  for (const Burst& burst : bursts_) {
+    messages_.push_back(Message::WriteMessage(
+        address, span(burst.address_bytes).first(burst.address_size)));
+    messages_.push_back(Message::ReadMessage(
+        address, buffer_.subspan(burst.offset, burst.size_bytes)));
+  }
+  PW_TRY(device_.initiator().TransferFor(messages_, timeout));
+
+  const endian order = device_.data_order_;
+  for (const Block& block : blocks_) {
+    const ConstByteSpan data =
+        buffer_.subspan(block.offset, block.registers.size());
+    switch (block.register_size) {
+      case 2:
+        CopyRegisters<uint16_t>(data, order, block.registers);
+        break;
+      case 4:
+        CopyRegisters<uint32_t>(data, order, block.registers);
+        break;
+      default:
+        std::copy(data.begin(), data.end(), block.registers.begin());
+        break;
+    }
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::i2c::internal
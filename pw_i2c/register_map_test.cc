@@ -0,0 +1,185 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/register_map.h"
+
+#include <array>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::i2c {
+namespace {
+
+using namespace std::literals::chrono_literals;
+
+constexpr Address kTestDeviceAddress = Address::SevenBit<0x3F>();
+
+constexpr chrono::SystemClock::duration kTimeout =
+    std::chrono::duration_cast<chrono::SystemClock::duration>(100ms);
+
+// Simulates a device with 1-byte register addresses that auto-increment
+// reads, and counts the transfers of the initiator.
+class RegisterFileInitiator : public Initiator {
+ public:
+  RegisterFileInitiator() {
+    for (size_t i = 0; i < registers_.size(); ++i) {
+      registers_[i] = static_cast<std::byte>(i);
+    }
+  }
+
+  size_t transfers() const { return transfers_; }
+  size_t messages() const { return messages_; }
+  void set_status(Status status) { status_ = status; }
+
+ private:
+  Status DoTransferFor(span<const Message> messages,
+                       chrono::SystemClock::duration) override {
+    transfers_ += 1;
+    if (!status_.ok()) {
+      return status_;
+    }
+    for (const Message& message : messages) {
+      messages_ += 1;
+      EXPECT_EQ(message.GetAddress().GetSevenBit(),
+                kTestDeviceAddress.GetSevenBit());
+      if (message.IsRead()) {
+        for (std::byte& byte : message.GetMutableData()) {
+          byte = registers_[next_register_++];
+        }
+      } else {
+        EXPECT_EQ(message.GetData().size(), 1u);
+        next_register_ = static_cast<size_t>(message.GetData()[0]);
+      }
+    }
+    return OkStatus();
+  }
+
+  Status DoWriteReadFor(Address,
+                        ConstByteSpan,
+                        ByteSpan,
+                        chrono::SystemClock::duration) override {
+    ADD_FAILURE();  // RegisterMap must use TransferFor().
+    return Status::Internal();
+  }
+
+  std::array<std::byte, 256> registers_;
+  size_t next_register_ = 0;
+  size_t transfers_ = 0;
+  size_t messages_ = 0;
+  Status status_;
+};
+
+TEST(RegisterMap, ContiguousBlocksAreReadInOneBurst) {
+  RegisterFileInitiator initiator;
+  RegisterDevice device(
+      initiator, kTestDeviceAddress, endian::big, RegisterAddressSize::k1Byte);
+  RegisterMap<3, 16> map(device);
+
+  uint8_t status = 0;
+  std::array<uint16_t, 3> accel = {};
+  std::array<uint32_t, 1> timestamp = {};
+  ASSERT_EQ(map.Add8(0x10, span(&status, 1)), OkStatus());
+  ASSERT_EQ(map.Add16(0x11, accel), OkStatus());
+  ASSERT_EQ(map.Add32(0x17, timestamp), OkStatus());
+  EXPECT_EQ(map.bursts(), 1u);
+
+  ASSERT_EQ(map.ReadFor(kTimeout), OkStatus());
+  EXPECT_EQ(initiator.transfers(), 1u);
+  EXPECT_EQ(initiator.messages(), 2u);
+
+  EXPECT_EQ(status, 0x10);
+  EXPECT_EQ(accel[0], 0x1112);
+  EXPECT_EQ(accel[1], 0x1314);
+  EXPECT_EQ(accel[2], 0x1516);
+  EXPECT_EQ(timestamp[0], 0x1718191Au);
+}
+
+TEST(RegisterMap, SeparateBlocksAreReadInOneTransfer) {
+  RegisterFileInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        endian::little,
+                        RegisterAddressSize::k1Byte);
+  RegisterMap<2, 8> map(device);
+
+  std::array<uint16_t, 2> accel = {};
+  std::array<uint16_t, 2> gyro = {};
+  ASSERT_EQ(map.Add16(0x20, accel), OkStatus());
+  ASSERT_EQ(map.Add16(0x40, gyro), OkStatus());
+  EXPECT_EQ(map.bursts(), 2u);
+
+  ASSERT_EQ(map.ReadFor(kTimeout), OkStatus());
+  EXPECT_EQ(initiator.transfers(), 1u);
+  EXPECT_EQ(initiator.messages(), 4u);
+
+  EXPECT_EQ(accel[0], 0x2120);
+  EXPECT_EQ(accel[1], 0x2322);
+  EXPECT_EQ(gyro[0], 0x4140);
+  EXPECT_EQ(gyro[1], 0x4342);
+}
+
+TEST(RegisterMap, RegisterAddressesOfWholeRegisters) {
+  RegisterFileInitiator initiator;
+  RegisterDevice device(
+      initiator, kTestDeviceAddress, endian::big, RegisterAddressSize::k1Byte);
+  RegisterMap<2, 8> map(device, /*bytes_per_register_address=*/2);
+
+  std::array<uint16_t, 2> first = {};
+  uint16_t second = 0;
+  ASSERT_EQ(map.Add16(0x10, first), OkStatus());
+  ASSERT_EQ(map.Add16(0x12, span(&second, 1)), OkStatus());
+  EXPECT_EQ(map.bursts(), 1u);
+
+  // A single byte doesn't cover a whole register address.
+  uint8_t byte = 0;
+  EXPECT_EQ(map.Add8(0x13, span(&byte, 1)), Status::InvalidArgument());
+}
+
+TEST(RegisterMap, Capacity) {
+  RegisterFileInitiator initiator;
+  RegisterDevice device(
+      initiator, kTestDeviceAddress, endian::big, RegisterAddressSize::k1Byte);
+  RegisterMap<2, 4> map(device);
+
+  std::array<uint8_t, 3> three = {};
+  std::array<uint8_t, 2> two = {};
+  uint8_t one = 0;
+  EXPECT_EQ(map.Add8(0x00, span<uint8_t>()), Status::InvalidArgument());
+  ASSERT_EQ(map.Add8(0x00, three), OkStatus());
+  EXPECT_EQ(map.Add8(0x10, two), Status::ResourceExhausted());
+  ASSERT_EQ(map.Add8(0x10, span(&one, 1)), OkStatus());
+  EXPECT_EQ(map.Add8(0x20, span(&one, 1)), Status::ResourceExhausted());
+
+  map.Clear();
+  EXPECT_EQ(map.bursts(), 0u);
+  EXPECT_EQ(map.ReadFor(kTimeout), Status::FailedPrecondition());
+  ASSERT_EQ(map.Add8(0x10, two), OkStatus());
+}
+
+TEST(RegisterMap, FailedTransferLeavesRegisters) {
+  RegisterFileInitiator initiator;
+  initiator.set_status(Status::Unavailable());
+  RegisterDevice device(
+      initiator, kTestDeviceAddress, endian::big, RegisterAddressSize::k1Byte);
+  RegisterMap<1, 2> map(device);
+
+  uint16_t value = 0xabcd;
+  ASSERT_EQ(map.Add16(0x10, span(&value, 1)), OkStatus());
+  EXPECT_EQ(map.ReadFor(kTimeout), Status::Unavailable());
+  EXPECT_EQ(value, 0xabcd);
+}
+
+}  // namespace
+}  // namespace pw::i2c
@@ -35,6 +35,9 @@
 #include "pw_status/try.h"
 
 namespace pw::i2c {
+
+static_assert(LinuxInitiator::kMaxTransferMessages == I2C_RDWR_IOCTL_MAX_MSGS);
+
 namespace {
 
 using ::pw::chrono::SystemClock;
@@ -140,16 +143,12 @@ Status LinuxInitiator::DoWriteReadFor(Address device_address,
 //  - `address` is a 7-bit device address
 //  - At least one of `tx_buffer` or `rx_buffer` is not empty.
 //
-// The transaction will be retried if we can't get access to the bus, until
-// the timeout is reached. There will be no retries if `timeout` is zero or
-// negative.
+// See TransferLocked() for how the timeout is used.
 Status LinuxInitiator::DoWriteReadForLocked(
     uint8_t address,
     ConstByteSpan tx_buffer,
     ByteSpan rx_buffer,
     chrono::SystemClock::duration timeout) {
-  const auto start_time = SystemClock::now();
-
   // Prepare messages for either a read, write, or combined transaction.
   // Populate `ioctl_data` with either one or two `i2c_msg` operations.
   // Use the `messages` buffer to store the operations.
@@ -200,6 +199,58 @@ Status LinuxInitiator::DoWriteReadForLocked(
         .nmsgs = 2,
     };
   }
+  return TransferLocked(ioctl_data, address, timeout);
+}
+
+Status LinuxInitiator::DoTransferFor(span<const Message> messages,
+                                     SystemClock::duration timeout) {
+  auto start_time = SystemClock::now();
+
+  // Validate arguments.
+  if (messages.empty() || messages.size() > kMaxTransferMessages) {
+    PW_LOG_ERROR("I2C transfers must have 1 to %u messages",
+                 static_cast<unsigned>(kMaxTransferMessages));
+    return Status::InvalidArgument();
+  }
+  std::array<i2c_msg, kMaxTransferMessages> i2c_messages{};
+  for (size_t i = 0; i < messages.size(); ++i) {
+    const Message& message = messages[i];
+    if (message.GetData().empty()) {
+      PW_LOG_ERROR("I2C transfer messages must be not empty");
+      return Status::InvalidArgument();
+    }
+    i2c_messages[i] = i2c_msg{
+        .addr = message.GetAddress().GetSevenBit(),
+        .flags = static_cast<uint16_t>(message.IsRead() ? I2C_M_RD : 0),
+        .len = static_cast<uint16_t>(message.GetData().size()),
+        .buf = reinterpret_cast<uint8_t*>(message.GetMutableData().data()),
+    };
+  }
+  i2c_rdwr_ioctl_data ioctl_data = {
+      .msgs = i2c_messages.data(),
+      .nmsgs = static_cast<uint32_t>(messages.size()),
+  };
+
+  // Try to acquire access to the bus.
+  if (!mutex_.try_lock_for(timeout)) {
+    return Status::DeadlineExceeded();
+  }
+  std::lock_guard lock(mutex_, std::adopt_lock);
+  const auto elapsed = SystemClock::now() - start_time;
+  return TransferLocked(
+      ioctl_data, messages[0].GetAddress().GetSevenBit(), timeout - elapsed);
+}
+
+// Perform the I2C_RDWR ioctl for a prepared set of messages.
+//
+// The transaction will be retried if we can't get access to the bus, until
+// the timeout is reached. There will be no retries if `timeout` is zero or
+// negative.
+Status LinuxInitiator::TransferLocked(i2c_rdwr_ioctl_data& ioctl_data,
+                                      uint8_t address,
+                                      SystemClock::duration timeout) {
+  const auto start_time = SystemClock::now();
+
   PW_LOG_DEBUG("Attempting I2C transaction with %" PRIu32 " operations",
                ioctl_data.nmsgs);
 
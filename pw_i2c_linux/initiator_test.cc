@@ -14,7 +14,12 @@
 
 #include "pw_i2c_linux/initiator.h"
 
+#include <fcntl.h>
+
+#include <array>
+#include <chrono>
 #include <type_traits>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "pw_i2c/initiator.h"
@@ -37,6 +42,29 @@ TEST(LinuxInitiatorTest, TestOpenInvalidFileFails) {
             Status::InvalidArgument());
 }
 
+TEST(LinuxInitiatorTest, TestTransferForValidatesMessages) {
+  // Invalid transfers are rejected before the device is used.
+  const int fd = open(kBusPathInvalid, O_RDWR);
+  ASSERT_GE(fd, 0);
+  LinuxInitiator initiator(fd);
+  constexpr auto kAddress = Address::SevenBit<0x01>();
+  constexpr auto kTimeout = std::chrono::milliseconds(10);
+
+  EXPECT_EQ(initiator.TransferFor(span<const Message>(), kTimeout),
+            Status::InvalidArgument());
+
+  const std::array<Message, 1> empty_message = {
+      Message::ReadMessage(kAddress, ByteSpan())};
+  EXPECT_EQ(initiator.TransferFor(empty_message, kTimeout),
+            Status::InvalidArgument());
+
+  std::array<std::byte, 1> buffer{};
+  const std::vector<Message> messages(LinuxInitiator::kMaxTransferMessages + 1,
+                                      Message::ReadMessage(kAddress, buffer));
+  EXPECT_EQ(initiator.TransferFor(messages, kTimeout),
+            Status::InvalidArgument());
+}
+
 // Check that LinuxInitiator implements Initiator.
 static_assert(std::is_assignable_v<Initiator&, LinuxInitiator&>);
 
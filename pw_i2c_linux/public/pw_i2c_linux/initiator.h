@@ -13,15 +13,21 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "pw_bytes/span.h"
 #include "pw_chrono/system_clock.h"
 #include "pw_i2c/address.h"
 #include "pw_i2c/initiator.h"
 #include "pw_result/result.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
 #include "pw_sync/lock_annotations.h"
 #include "pw_sync/timed_mutex.h"
 
+struct i2c_rdwr_ioctl_data;
+
 namespace pw::i2c {
 
 /// Initiator interface implementation using the Linux userspace i2c-dev driver.
@@ -38,6 +44,10 @@ namespace pw::i2c {
 ///
 class LinuxInitiator final : public Initiator {
  public:
+  /// The most messages `TransferFor()` accepts, which are sent with a single
+  /// `I2C_RDWR` ioctl. This is the kernel's `I2C_RDWR_IOCTL_MAX_MSGS`.
+  static constexpr size_t kMaxTransferMessages = 42;
+
   /// Open an I2C bus and validate that full I2C functionality is supported.
   ///
   /// @param[in] bus_path Path to the I2C bus device node.
@@ -80,12 +90,24 @@ class LinuxInitiator final : public Initiator {
                         chrono::SystemClock::duration timeout) override
       PW_LOCKS_EXCLUDED(mutex_);
 
+  /// Implement pw::i2c::Initiator::DoTransferFor() with a single `I2C_RDWR`
+  /// ioctl. All addresses must be 7-bit, and there may be at most
+  /// `kMaxTransferMessages` messages. Otherwise, returns InvalidArgument.
+  Status DoTransferFor(span<const Message> messages,
+                       chrono::SystemClock::duration timeout) override
+      PW_LOCKS_EXCLUDED(mutex_);
+
   Status DoWriteReadForLocked(uint8_t address,
                               ConstByteSpan tx_buffer,
                               ByteSpan rx_buffer,
                               chrono::SystemClock::duration timeout)
       PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  Status TransferLocked(i2c_rdwr_ioctl_data& ioctl_data,
+                        uint8_t address,
+                        chrono::SystemClock::duration timeout)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   /// The file descriptor for the i2c-dev device representing this bus.
   const int fd_;
 
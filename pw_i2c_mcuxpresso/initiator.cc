@@ -163,5 +163,57 @@ Status McuxpressoInitiator::DoWriteReadFor(
     return Status::InvalidArgument();
   }
 }
+
+// Chains the messages into one bus sequence: each message after the first
+// starts with a repeated START, and only the last one ends with a STOP.
+Status McuxpressoInitiator::DoTransferFor(
+    span<const Message> messages, chrono::SystemClock::duration timeout) {
+  if (timeout <= chrono::SystemClock::duration::zero()) {
+    return Status::DeadlineExceeded();
+  }
+  if (messages.empty()) {
+    return Status::InvalidArgument();
+  }
+  for (const Message& message : messages) {
+    if (message.GetData().empty()) {
+      return Status::InvalidArgument();
+    }
+  }
+
+  const chrono::SystemClock::time_point deadline =
+      chrono::SystemClock::TimePointAfterAtLeast(timeout);
+  std::lock_guard lock(mutex_);
+
+  if (!enabled_) {
+    return Status::FailedPrecondition();
+  }
+
+  for (size_t i = 0; i < messages.size(); ++i) {
+    const Message& message = messages[i];
+    uint32_t flags = i == 0 ? kI2C_TransferDefaultFlag
+                            : kI2C_TransferRepeatedStartFlag;
+    if (i + 1 < messages.size()) {
+      flags |= kI2C_TransferNoStopFlag;
+    }
+    const ByteSpan data = message.GetMutableData();
+    i2c_master_transfer_t transfer{
+        flags,
+        message.GetAddress().GetSevenBit(),
+        message.IsRead() ? kI2C_Read : kI2C_Write,
+        0,
+        0,
+        data.data(),
+        data.size()};
+
+    const chrono::SystemClock::duration time_remaining =
+        i == 0 ? timeout : deadline - chrono::SystemClock::now();
+    if (time_remaining <= chrono::SystemClock::duration::zero()) {
+      I2C_MasterTransferAbort(base_, &handle_);
+      return Status::DeadlineExceeded();
+    }
+    PW_TRY(InitiateNonBlockingTransfer(time_remaining, &transfer));
+  }
+  return OkStatus();
+}
 // inclusive-language: enable
 }  // namespace pw::i2c
@@ -50,6 +50,12 @@ class McuxpressoInitiator final : public Initiator {
                         chrono::SystemClock::duration timeout) override
       PW_LOCKS_EXCLUDED(mutex_);
 
+  // Performs the messages as one chain of transfers with a single STOP,
+  // holding the bus for the whole sequence.
+  Status DoTransferFor(span<const Message> messages,
+                       chrono::SystemClock::duration timeout) override
+      PW_LOCKS_EXCLUDED(mutex_);
+
   // inclusive-language: disable
   Status InitiateNonBlockingTransfer(chrono::SystemClock::duration rw_timeout,
                                      i2c_master_transfer_t* transfer)
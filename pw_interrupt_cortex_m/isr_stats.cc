@@ -0,0 +1,58 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_interrupt_cortex_m/isr_stats.h"
+
+namespace pw::interrupt {
+
+void IsrTracker::Enter(IrqStats& stats, uint32_t timestamp) {
+  stats.count_.Increment();
+  stats.nesting_depth_.Record(static_cast<uint32_t>(depth_));
+
+  const uint32_t pending_since =
+      stats.pending_since_.exchange(0, std::memory_order_relaxed);
+  if (pending_since != 0u) {
+    stats.latency_cycles_.Record(timestamp - pending_since);
+  }
+
+  if (depth_ < kMaxDepth) {
+    frames_[depth_] = Frame{timestamp, 0};
+  }
+  depth_ += 1;
+}
+
+void IsrTracker::Exit(IrqStats& stats, uint32_t timestamp) {
+  if (depth_ == 0u) {
+    return;  // Unbalanced exit; there is nothing to time.
+  }
+  depth_ -= 1;
+  if (depth_ >= kMaxDepth) {
+    return;
+  }
+
+  const Frame& frame = frames_[depth_];
+  const uint32_t total = timestamp - frame.entry;
+  const uint32_t duration = total - frame.nested_cycles;
+  stats.duration_cycles_.Record(duration);
+  if (duration > stats.max_duration_cycles_.value()) {
+    stats.max_duration_cycles_.Set(duration);
+  }
+
+  // The preempted handler does not count this time as its own.
+  if (depth_ > 0u) {
+    frames_[depth_ - 1].nested_cycles += total;
+  }
+}
+
+}  // namespace pw::interrupt
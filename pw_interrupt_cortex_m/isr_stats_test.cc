@@ -0,0 +1,110 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_interrupt_cortex_m/isr_stats.h"
+
+#include "gtest/gtest.h"
+
+namespace pw::interrupt {
+namespace {
+
+// Returns how many values the histogram counted in the bucket of the value.
+uint32_t CountAt(const metric::Histogram& histogram, uint32_t value) {
+  for (size_t i = 0; i < histogram.buckets().size(); ++i) {
+    if (histogram.BucketLowerBound(i) <= value &&
+        value <= histogram.BucketUpperBound(i)) {
+      return histogram.buckets()[i].load();
+    }
+  }
+  return 0;
+}
+
+TEST(IsrTracker, RecordsDuration) {
+  IrqStats stats(1);
+  IsrTracker tracker;
+
+  tracker.Enter(stats, 100);
+  EXPECT_EQ(tracker.depth(), 1u);
+  tracker.Exit(stats, 110);
+  EXPECT_EQ(tracker.depth(), 0u);
+
+  EXPECT_EQ(stats.count(), 1u);
+  EXPECT_EQ(stats.max_duration_cycles(), 10u);
+  EXPECT_EQ(CountAt(stats.duration_cycles(), 10), 1u);
+  EXPECT_EQ(CountAt(stats.nesting_depth(), 0), 1u);
+  EXPECT_EQ(stats.latency_cycles().count(), 0u);
+}
+
+TEST(IsrTracker, NestedHandlersAreNotCountedInPreemptedHandler) {
+  IrqStats low(1);
+  IrqStats high(2);
+  IsrTracker tracker;
+
+  tracker.Enter(low, 0);
+  tracker.Enter(high, 5);
+  tracker.Exit(high, 25);
+  tracker.Exit(low, 30);
+
+  EXPECT_EQ(high.max_duration_cycles(), 20u);
+  EXPECT_EQ(CountAt(high.nesting_depth(), 1), 1u);
+  EXPECT_EQ(low.max_duration_cycles(), 10u);
+  EXPECT_EQ(CountAt(low.nesting_depth(), 0), 1u);
+}
+
+TEST(IsrTracker, RecordsLatencyOnceAfterMarkPending) {
+  IrqStats stats(1);
+  IsrTracker tracker;
+
+  stats.MarkPending(40);
+  tracker.Enter(stats, 52);
+  tracker.Exit(stats, 60);
+  tracker.Enter(stats, 100);
+  tracker.Exit(stats, 110);
+
+  EXPECT_EQ(stats.latency_cycles().count(), 1u);
+  EXPECT_EQ(CountAt(stats.latency_cycles(), 12), 1u);
+  EXPECT_EQ(stats.count(), 2u);
+}
+
+TEST(IsrTracker, CounterWraps) {
+  IrqStats stats(1);
+  IsrTracker tracker;
+
+  stats.MarkPending(0xfffffff0u);
+  tracker.Enter(stats, 0xfffffff8u);
+  tracker.Exit(stats, 8);
+
+  EXPECT_EQ(CountAt(stats.latency_cycles(), 8), 1u);
+  EXPECT_EQ(stats.max_duration_cycles(), 16u);
+}
+
+TEST(IsrTracker, DeepNestingIsCountedButNotTimed) {
+  IrqStats stats(1);
+  IsrTracker tracker;
+
+  for (uint32_t i = 0; i < IsrTracker::kMaxDepth + 2; ++i) {
+    tracker.Enter(stats, i);
+  }
+  for (uint32_t i = 0; i < IsrTracker::kMaxDepth + 2; ++i) {
+    tracker.Exit(stats, 100 + i);
+  }
+  tracker.Exit(stats, 200);  // Unbalanced exits are ignored.
+
+  EXPECT_EQ(tracker.depth(), 0u);
+  EXPECT_EQ(stats.count(), IsrTracker::kMaxDepth + 2);
+  EXPECT_EQ(stats.duration_cycles().count(), IsrTracker::kMaxDepth);
+}
+
+}  // namespace
+}  // namespace pw::interrupt
@@ -0,0 +1,31 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Configuration macros for the Cortex-M interrupt module.
+#pragma once
+
+// The number of entries, including the 16 system exceptions, in the RAM copy of
+// the vector table that the ISR instrumentation installs. It must be a power of
+// two, since the table is aligned to its size, and cover every vector the
+// device uses.
+#ifndef PW_INTERRUPT_CORTEX_M_CFG_VECTOR_TABLE_ENTRIES
+#define PW_INTERRUPT_CORTEX_M_CFG_VECTOR_TABLE_ENTRIES 128
+#endif  // PW_INTERRUPT_CORTEX_M_CFG_VECTOR_TABLE_ENTRIES
+
+static_assert((PW_INTERRUPT_CORTEX_M_CFG_VECTOR_TABLE_ENTRIES >= 32) &&
+                  (PW_INTERRUPT_CORTEX_M_CFG_VECTOR_TABLE_ENTRIES <= 512) &&
+                  ((PW_INTERRUPT_CORTEX_M_CFG_VECTOR_TABLE_ENTRIES &
+                    (PW_INTERRUPT_CORTEX_M_CFG_VECTOR_TABLE_ENTRIES - 1)) == 0),
+              "The vector table must have a power of two entries, from 32 "
+              "to 512");
@@ -0,0 +1,111 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_metric/histogram.h"
+#include "pw_metric/metric.h"
+
+namespace pw::interrupt {
+
+// Metrics for one interrupt handler, in cycles of the timestamp counter.
+//
+//   latency_cycles: from MarkPending() to handler entry. Only recorded for
+//       interrupts whose source calls MarkPending().
+//   duration_cycles: time spent in the handler itself, excluding the handlers
+//       that preempted it.
+//   nesting_depth: the number of handlers the interrupt preempted.
+//
+// The metrics are in a group, so they can be added to a parent group and
+// exported with the MetricService.
+class IrqStats {
+ public:
+  // The group name is a token, such as
+  // PW_TOKENIZE_STRING_DOMAIN("metrics", "UART1").
+  explicit IrqStats(metric::Token name) : group_(name) {}
+
+  IrqStats(const IrqStats&) = delete;
+  IrqStats& operator=(const IrqStats&) = delete;
+
+  // Notes when the interrupt's source fired, with the same counter the
+  // handler's timestamps use. The next entry to the handler records the
+  // latency since this time.
+  void MarkPending(uint32_t timestamp) {
+    // Zero means nothing is pending, so skip it.
+    pending_since_.store(timestamp == 0u ? 1u : timestamp,
+                         std::memory_order_relaxed);
+  }
+
+  metric::Group& group() { return group_; }
+
+  uint32_t count() const { return count_.value(); }
+  uint32_t max_duration_cycles() const { return max_duration_cycles_.value(); }
+  const metric::Histogram& latency_cycles() const { return latency_cycles_; }
+  const metric::Histogram& duration_cycles() const { return duration_cycles_; }
+  const metric::Histogram& nesting_depth() const { return nesting_depth_; }
+
+ private:
+  friend class IsrTracker;
+  friend class VectorTableInstrumentation;
+
+  metric::Group group_;
+  PW_METRIC(group_, count_, "count", 0u);
+  PW_METRIC(group_, max_duration_cycles_, "max_duration_cycles", 0u);
+  PW_METRIC_HISTOGRAM(group_, latency_cycles_, "latency_cycles", 2, 16);
+  PW_METRIC_HISTOGRAM(group_, duration_cycles_, "duration_cycles", 2, 16);
+  PW_METRIC_HISTOGRAM(group_, nesting_depth_, "nesting_depth", 1, 4);
+
+  std::atomic<uint32_t> pending_since_ = 0;
+
+  // The original handler, when instrumented through the vector table.
+  void (*handler_)() = nullptr;
+};
+
+// Tracks entries and exits of nested interrupt handlers and records their
+// IrqStats. Timestamps are from a free running, wrapping 32-bit counter.
+//
+// Enter() and Exit() must be called in pairs, in the order handlers nest, with
+// interrupts masked so a preempting handler cannot run between the timestamp
+// and the update.
+class IsrTracker {
+ public:
+  // Handlers nested deeper than this are counted, but not timed.
+  static constexpr size_t kMaxDepth = 16;
+
+  constexpr IsrTracker() = default;
+
+  IsrTracker(const IsrTracker&) = delete;
+  IsrTracker& operator=(const IsrTracker&) = delete;
+
+  void Enter(IrqStats& stats, uint32_t timestamp);
+  void Exit(IrqStats& stats, uint32_t timestamp);
+
+  // The number of handlers entered and not yet exited.
+  size_t depth() const { return depth_; }
+
+ private:
+  struct Frame {
+    uint32_t entry = 0;
+    uint32_t nested_cycles = 0;  // Spent in handlers that preempted this one.
+  };
+
+  std::array<Frame, kMaxDepth> frames_ = {};
+  size_t depth_ = 0;
+};
+
+}  // namespace pw::interrupt
@@ -0,0 +1,62 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_interrupt_cortex_m/isr_stats.h"
+#include "pw_status/status.h"
+
+namespace pw::interrupt {
+
+// Times interrupt handlers by routing their vectors through a wrapper, which
+// records IrqStats with the DWT cycle counter (CYCCNT) at entry and exit, and
+// emits a pw_trace start and end event with the IRQ number as the trace ID.
+//
+// Only the instrumented interrupts go through the wrapper; the others keep
+// their original vectors.
+class VectorTableInstrumentation {
+ public:
+  // Copies the active vector table to RAM, points VTOR at the copy, and
+  // enables the DWT cycle counter. Calling it again has no effect.
+  static void Init();
+
+  // Routes an interrupt's vector through the wrapper. The IRQ number is the
+  // CMSIS IRQn: 0 and above for device interrupts, or -1 for SysTick. The
+  // stats must outlive the instrumentation.
+  //
+  // Returns:
+  //   OK - The interrupt is instrumented.
+  //   FAILED_PRECONDITION - Init() was not called.
+  //   INVALID_ARGUMENT - The IRQ is a system exception other than SysTick,
+  //       whose handlers may depend on their exception frame.
+  //   OUT_OF_RANGE - The IRQ is past the configured vector table entries.
+  //   ALREADY_EXISTS - The interrupt or the stats are already instrumented.
+  static Status Instrument(int32_t irq, IrqStats& stats);
+
+  // Returns the cycle counter, for IrqStats::MarkPending().
+  static uint32_t CycleCount() {
+    return *reinterpret_cast<volatile uint32_t*>(0xE0001004u);
+  }
+
+  // Notes that an interrupt's source fired now. Call it from the code that
+  // triggers the interrupt, or that observes the event it reports.
+  static void MarkPending(IrqStats& stats) { stats.MarkPending(CycleCount()); }
+
+ private:
+  // The handler of every instrumented vector.
+  static void InstrumentedHandler();
+};
+
+}  // namespace pw::interrupt
@@ -0,0 +1,147 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_interrupt_cortex_m/vector_table_instrumentation.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_interrupt_cortex_m/config.h"
+#include "pw_preprocessor/arch.h"
+#include "pw_trace/trace.h"
+
+#if !(_PW_ARCH_ARM_V7M || _PW_ARCH_ARM_V7EM || _PW_ARCH_ARM_V8M_MAINLINE || \
+      _PW_ARCH_ARM_V8_1M_MAINLINE)
+#error "ISR instrumentation requires the DWT cycle counter and a relocatable \
+       vector table, which ARMv6-M and ARMv8-M baseline do not have."
+#endif
+
+namespace pw::interrupt {
+namespace {
+
+using Handler = void (*)();
+
+constexpr size_t kVectorTableEntries =
+    PW_INTERRUPT_CORTEX_M_CFG_VECTOR_TABLE_ENTRIES;
+constexpr uint32_t kSystemExceptions = 16;
+constexpr int32_t kSysTickIrq = -1;
+
+// ARMv7-M Architecture Reference Manual, sections B3.2 and C1.8.
+volatile uint32_t& vtor = *reinterpret_cast<volatile uint32_t*>(0xE000ED08u);
+volatile uint32_t& demcr = *reinterpret_cast<volatile uint32_t*>(0xE000EDFCu);
+volatile uint32_t& dwt_ctrl = *reinterpret_cast<volatile uint32_t*>(0xE0001000u);
+
+constexpr uint32_t kDemcrTraceEnable = 1u << 24;
+constexpr uint32_t kDwtCtrlCycleCounterEnable = 1u << 0;
+
+// VTOR requires the table to be aligned to its size rounded up to a power of
+// two, which the config guarantees.
+alignas(kVectorTableEntries * sizeof(Handler))
+    std::array<Handler, kVectorTableEntries> ram_vector_table;
+
+std::array<IrqStats*, kVectorTableEntries> stats_by_exception;
+
+IsrTracker tracker;
+
+uint32_t DisableInterrupts() {
+  uint32_t primask;
+  asm volatile("MRS %0, primask\n cpsid i" : "=r"(primask)::"memory");
+  return primask;
+}
+
+void RestoreInterrupts(uint32_t primask) {
+  asm volatile("MSR primask, %0" ::"r"(primask) : "memory");
+}
+
+void SyncVectorTable() {
+  asm volatile("dsb\n isb" ::: "memory");
+}
+
+bool Initialized() {
+  return vtor == reinterpret_cast<uintptr_t>(ram_vector_table.data());
+}
+
+}  // namespace
+
+// Cortex-M stacks the caller-saved registers on exception entry, so an
+// ordinary function works as a handler.
+void VectorTableInstrumentation::InstrumentedHandler() {
+  uint32_t ipsr;
+  asm volatile("MRS %0, ipsr" : "=r"(ipsr));
+  const uint32_t exception = ipsr & 0x1ffu;
+  IrqStats& stats = *stats_by_exception[exception];
+  const uint32_t irq = exception - kSystemExceptions;
+
+  PW_TRACE_START("IRQ", "pw_interrupt", irq);
+
+  // Mask interrupts so a preempting handler cannot run between taking the
+  // timestamp and updating the tracker.
+  uint32_t primask = DisableInterrupts();
+  tracker.Enter(stats, CycleCount());
+  RestoreInterrupts(primask);
+
+  stats.handler_();
+
+  primask = DisableInterrupts();
+  tracker.Exit(stats, CycleCount());
+  RestoreInterrupts(primask);
+
+  PW_TRACE_END("IRQ", "pw_interrupt", irq);
+}
+
+void VectorTableInstrumentation::Init() {
+  const uint32_t primask = DisableInterrupts();
+  if (!Initialized()) {
+    const Handler* active_table = reinterpret_cast<const Handler*>(vtor);
+    for (size_t i = 0; i < kVectorTableEntries; ++i) {
+      ram_vector_table[i] = active_table[i];
+    }
+    SyncVectorTable();
+    vtor = reinterpret_cast<uintptr_t>(ram_vector_table.data());
+    SyncVectorTable();
+
+    demcr |= kDemcrTraceEnable;
+    dwt_ctrl |= kDwtCtrlCycleCounterEnable;
+  }
+  RestoreInterrupts(primask);
+}
+
+Status VectorTableInstrumentation::Instrument(int32_t irq, IrqStats& stats) {
+  if (irq < kSysTickIrq) {
+    return Status::InvalidArgument();
+  }
+  const size_t exception = static_cast<size_t>(irq + kSystemExceptions);
+  if (exception >= kVectorTableEntries) {
+    return Status::OutOfRange();
+  }
+
+  const uint32_t primask = DisableInterrupts();
+  Status status;
+  if (!Initialized()) {
+    status = Status::FailedPrecondition();
+  } else if (stats.handler_ != nullptr ||
+             stats_by_exception[exception] != nullptr) {
+    status = Status::AlreadyExists();
+  } else {
+    stats.handler_ = ram_vector_table[exception];
+    stats_by_exception[exception] = &stats;
+    ram_vector_table[exception] = InstrumentedHandler;
+    SyncVectorTable();
+  }
+  RestoreInterrupts(primask);
+  return status;
+}
+
+}  // namespace pw::interrupt
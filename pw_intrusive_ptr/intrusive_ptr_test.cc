@@ -94,11 +94,21 @@ struct FreeTestItem {
   mutable int32_t instance_counter = 0;
 };
 
+class SingleThreadTestItem
+    : public SingleThreadRefCounted<SingleThreadTestItem> {
+ public:
+  SingleThreadTestItem() { ++instance_counter; }
+  ~SingleThreadTestItem() { --instance_counter; }
+
+  inline static int32_t instance_counter = 0;
+};
+
 class IntrusivePtrTest : public ::testing::Test {
  protected:
   void SetUp() override {
     TestItem::instance_counter = 0;
     TestItemDerived::derived_instance_counter = 0;
+    SingleThreadTestItem::instance_counter = 0;
   }
 };
 
@@ -455,5 +465,29 @@ TEST_F(IntrusivePtrTest, UseCountForNullPtr) {
   EXPECT_EQ(ptr.use_count(), 0);
 }
 
+TEST_F(IntrusivePtrTest, SingleThreadRefCounted) {
+  {
+    SingleThreadTestItem::Ptr ptr = MakeRefCounted<SingleThreadTestItem>();
+    EXPECT_EQ(ptr.use_count(), 1);
+    {
+      SingleThreadTestItem::Ptr ptr_copy = ptr;
+      EXPECT_EQ(ptr.use_count(), 2);
+      SingleThreadTestItem::Ptr ptr_moved = std::move(ptr_copy);
+      EXPECT_EQ(ptr.use_count(), 2);
+    }
+    EXPECT_EQ(ptr.use_count(), 1);
+    EXPECT_EQ(SingleThreadTestItem::instance_counter, 1);
+  }
+  EXPECT_EQ(SingleThreadTestItem::instance_counter, 0);
+}
+
+TEST_F(IntrusivePtrTest, SingleThreadRefCountedConstPtr) {
+  {
+    IntrusivePtr<const SingleThreadTestItem> ptr(new SingleThreadTestItem());
+    EXPECT_EQ(ptr.use_count(), 1);
+  }
+  EXPECT_EQ(SingleThreadTestItem::instance_counter, 0);
+}
+
 }  // namespace
 }  // namespace pw
@@ -0,0 +1,105 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_intrusive_ptr/pool_recyclable.h"
+
+#include <stdint.h>
+
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "pw_allocator/block_pool.h"
+#include "pw_intrusive_ptr/intrusive_ptr.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public SingleThreadRefCounted<TestItem>,
+                 public PoolRecyclable<TestItem> {
+ public:
+  explicit TestItem(int32_t v) : value(v) { ++instance_counter; }
+
+  ~TestItem() { --instance_counter; }
+
+  inline static int32_t instance_counter = 0;
+
+  int32_t value;
+};
+
+class LockFreeTestItem : public RefCounted<LockFreeTestItem>,
+                         public PoolRecyclable<LockFreeTestItem, true> {};
+
+class PoolRecyclableTest : public ::testing::Test {
+ protected:
+  void SetUp() override { TestItem::instance_counter = 0; }
+
+  allocator::FixedBlockPool<TestItem, 2> pool_;
+};
+
+TEST_F(PoolRecyclableTest, ReleasingLastPtrReturnsBlockToPool) {
+  {
+    TestItem::Ptr ptr = MakePooledRefCounted<TestItem>(pool_, 5);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(ptr->value, 5);
+    EXPECT_TRUE(pool_.Contains(ptr.get()));
+    EXPECT_EQ(pool_.available(), 1u);
+
+    TestItem::Ptr copy = ptr;
+    EXPECT_EQ(ptr.use_count(), 2);
+    ptr = nullptr;
+    EXPECT_EQ(TestItem::instance_counter, 1);
+    EXPECT_EQ(pool_.available(), 1u);
+  }
+  EXPECT_EQ(TestItem::instance_counter, 0);
+  EXPECT_EQ(pool_.available(), 2u);
+}
+
+TEST_F(PoolRecyclableTest, RecycledBlockIsReused) {
+  TestItem* first = MakePooledRefCounted<TestItem>(pool_, 1).get();
+  TestItem::Ptr ptr = MakePooledRefCounted<TestItem>(pool_, 2);
+  EXPECT_EQ(ptr.get(), first);
+}
+
+TEST_F(PoolRecyclableTest, ExhaustedPoolReturnsNull) {
+  TestItem::Ptr first = MakePooledRefCounted<TestItem>(pool_, 1);
+  TestItem::Ptr second = MakePooledRefCounted<TestItem>(pool_, 2);
+  TestItem::Ptr third = MakePooledRefCounted<TestItem>(pool_, 3);
+  EXPECT_NE(first, nullptr);
+  EXPECT_NE(second, nullptr);
+  EXPECT_EQ(third, nullptr);
+  EXPECT_EQ(TestItem::instance_counter, 2);
+}
+
+TEST_F(PoolRecyclableTest, HeapAllocatedObjectIsDeleted) {
+  {
+    TestItem::Ptr ptr = MakeRefCounted<TestItem>(7);
+    EXPECT_FALSE(pool_.Contains(ptr.get()));
+    EXPECT_EQ(TestItem::instance_counter, 1);
+  }
+  EXPECT_EQ(TestItem::instance_counter, 0);
+  EXPECT_EQ(pool_.available(), 2u);
+}
+
+TEST_F(PoolRecyclableTest, LockFreePool) {
+  allocator::FixedBlockPool<LockFreeTestItem, 1, true> pool;
+  {
+    LockFreeTestItem::Ptr ptr = MakePooledRefCounted<LockFreeTestItem>(pool);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(pool.available(), 0u);
+  }
+  EXPECT_EQ(pool.available(), 1u);
+}
+
+}  // namespace
+}  // namespace pw
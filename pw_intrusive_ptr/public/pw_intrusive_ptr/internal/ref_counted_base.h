@@ -16,6 +16,8 @@
 #include <atomic>
 #include <cstdint>
 
+#include "pw_assert/assert.h"
+
 namespace pw::internal {
 
 // Base class for RefCounted. Separates ref count storage from the private
@@ -47,4 +49,44 @@ class RefCountedBase {
   mutable std::atomic_int32_t ref_count_{0};
 };
 
+// Base class for SingleThreadRefCounted. Same as RefCountedBase, but with a
+// plain reference counter, so the operations are inlined and need no atomic
+// instructions.
+class SingleThreadRefCountedBase {
+ public:
+  SingleThreadRefCountedBase(const SingleThreadRefCountedBase&) = delete;
+  SingleThreadRefCountedBase(SingleThreadRefCountedBase&&) = delete;
+  SingleThreadRefCountedBase& operator=(const SingleThreadRefCountedBase&) =
+      delete;
+  SingleThreadRefCountedBase& operator=(SingleThreadRefCountedBase&&) = delete;
+
+ protected:
+  constexpr SingleThreadRefCountedBase() = default;
+
+  ~SingleThreadRefCountedBase() {
+    // Poison the ref count, as in ~RefCountedBase().
+    ref_count_ = static_cast<int32_t>(0xC0000000);
+  }
+
+  // Increments reference counter.
+  void AddRef() const {
+    PW_DASSERT(ref_count_ >= 0);
+    ref_count_ += 1;
+  }
+
+  // Decrements reference count and returns true if the object should be
+  // deleted.
+  [[nodiscard]] bool ReleaseRef() const {
+    PW_DASSERT(ref_count_ >= 1);
+    ref_count_ -= 1;
+    return ref_count_ == 0;
+  }
+
+  // Returns current ref count value.
+  [[nodiscard]] int32_t ref_count() const { return ref_count_; }
+
+ private:
+  mutable int32_t ref_count_ = 0;
+};
+
 }  // namespace pw::internal
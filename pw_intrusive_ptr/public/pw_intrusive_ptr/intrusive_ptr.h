@@ -36,7 +36,8 @@ namespace pw {
 //
 // IntrusivePtr by itself doesn't provide any thread-safety guarantees but if T
 // is a subclass from `RefCounted` - it is guaranteed to have atomic reference
-// counter operations.
+// counter operations. If T is a subclass of `SingleThreadRefCounted`, the
+// reference counter is not atomic.
 template <typename T>
 class IntrusivePtr final {
  public:
@@ -169,6 +170,27 @@ class RefCounted : private internal::RefCountedBase {
   friend class IntrusivePtr;
 };
 
+// Base class to be used with the IntrusivePtr for objects that are only used
+// from a single thread, such as objects confined to a dispatcher. Doesn't
+// provide any public methods.
+//
+// The reference counter is a plain integer, so copying and destroying the
+// IntrusivePtr does not need atomic operations. IntrusivePtrs to the object
+// MUST NOT be copied or destroyed concurrently, including from interrupts.
+//
+// Like RefCounted, SingleThreadRefCounted MUST never be used as a pointer type
+// to store derived objects.
+template <typename T>
+class SingleThreadRefCounted : private internal::SingleThreadRefCountedBase {
+ public:
+  // Type alias for the IntrusivePtr of ref-counted type.
+  using Ptr = IntrusivePtr<T>;
+
+ private:
+  template <typename U>
+  friend class IntrusivePtr;
+};
+
 template <typename T, typename U>
 inline bool operator==(const IntrusivePtr<T>& lhs, const IntrusivePtr<U>& rhs) {
   return lhs.get() == rhs.get();
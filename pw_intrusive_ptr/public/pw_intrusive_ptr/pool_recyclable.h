@@ -0,0 +1,105 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pw_allocator/block_pool.h"
+#include "pw_assert/assert.h"
+#include "pw_intrusive_ptr/intrusive_ptr.h"
+#include "pw_intrusive_ptr/recyclable.h"
+
+namespace pw {
+
+// pw::PoolRecyclable<T> is a Recyclable mixin that returns objects created by
+// MakePooledRefCounted() to their pw::allocator block pool once the last
+// IntrusivePtr to them is released. Returning a block to the pool is a single
+// push onto its free list, instead of a call to delete.
+//
+// Objects of a PoolRecyclable type that were allocated with new, e.g. by
+// MakeRefCounted(), are deleted as usual.
+//
+// :: Example ::
+//
+// class Buffer : public pw::RefCounted<Buffer>,
+//                public pw::PoolRecyclable<Buffer> {
+//   ...
+// };
+//
+// pw::allocator::FixedBlockPool<Buffer, 8> pool;
+// Buffer::Ptr buffer = pw::MakePooledRefCounted<Buffer>(pool, args...);
+//
+// Use a LockFreeBlockPool if the objects may be released from multiple threads
+// or from interrupts.
+template <typename T, bool kLockFree = false>
+class PoolRecyclable : public Recyclable<T> {
+ public:
+  using Pool = allocator::BasicBlockPool<kLockFree>;
+
+ protected:
+  constexpr PoolRecyclable() = default;
+
+  // The pool is not copied or moved with the object.
+  constexpr PoolRecyclable(const PoolRecyclable&) : PoolRecyclable() {}
+  constexpr PoolRecyclable& operator=(const PoolRecyclable&) { return *this; }
+
+ private:
+  friend class Recyclable<T>;
+
+  template <typename U, bool kPoolIsLockFree, typename... Args>
+  friend IntrusivePtr<U> MakePooledRefCounted(
+      allocator::BasicBlockPool<kPoolIsLockFree>& pool, Args&&... args);
+
+  void pw_recycle() {
+    T* object = static_cast<T*>(this);
+    if (pool_ == nullptr) {
+      delete object;
+      return;
+    }
+    Pool& pool = *pool_;
+    object->~T();
+    pool.Free(object);
+  }
+
+  Pool* pool_ = nullptr;
+};
+
+// Constructs a T in a block from the pool, and returns an IntrusivePtr that
+// returns the block to the pool when the object is released. T must derive
+// from PoolRecyclable<T>. Returns an empty IntrusivePtr if the pool is
+// exhausted.
+template <typename T, bool kLockFree, typename... Args>
+IntrusivePtr<T> MakePooledRefCounted(allocator::BasicBlockPool<kLockFree>& pool,
+                                     Args&&... args) {
+  static_assert(std::is_base_of_v<PoolRecyclable<T, kLockFree>, T>,
+                "T must derive from pw::PoolRecyclable<T> with a matching "
+                "kLockFree setting");
+  PW_ASSERT(pool.block_size() >= sizeof(T));
+
+  void* block = pool.Allocate();
+  if (block == nullptr) {
+    return nullptr;
+  }
+  PW_ASSERT(reinterpret_cast<uintptr_t>(block) % alignof(T) == 0);
+
+  T* object = new (block) T(std::forward<Args>(args)...);
+  static_cast<PoolRecyclable<T, kLockFree>*>(object)->pool_ = &pool;
+  return IntrusivePtr<T>(object);
+}
+
+}  // namespace pw
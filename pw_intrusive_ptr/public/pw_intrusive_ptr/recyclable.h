@@ -123,11 +123,13 @@ class Recyclable<T, std::enable_if_t<std::is_same_v<std::remove_cv_t<T>, T>>> {
   friend void ::pw::internal::recycle<const T>(const T*);
 
   static void pw_recycle_thunk(T* ptr) {
-    static_assert(std::is_same_v<decltype(&T::pw_recycle), void (T::*)(void)>,
-                  "pw_recycle() methods must be non-static member functions "
-                  "with the signature 'void pw_recycle()', and be visible to "
-                  "pw::Recyclable<T> (either because they are public, or "
-                  "because of friendship).");
+    // pw_recycle() may be inherited, e.g. from pw::PoolRecyclable<T>.
+    static_assert(
+        std::is_convertible_v<decltype(&T::pw_recycle), void (T::*)(void)>,
+        "pw_recycle() methods must be non-static member functions "
+        "with the signature 'void pw_recycle()', and be visible to "
+        "pw::Recyclable<T> (either because they are public, or "
+        "because of friendship).");
     ptr->pw_recycle();
   }
 };
@@ -0,0 +1,66 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/async_flash_memory.h"
+
+#include "pw_sync/thread_notification.h"
+
+namespace pw::kvs {
+namespace {
+
+// Holds the result of an operation until the waiting thread picks it up.
+struct Completion {
+  StatusWithSize result;
+  sync::ThreadNotification done;
+};
+
+// Starts an operation with a callback that completes the Completion, then waits
+// for it. If the operation does not start, its callback is never called.
+template <typename StartFunction>
+StatusWithSize StartAndWait(StartFunction&& start) {
+  Completion completion;
+  const Status status = start([&completion](StatusWithSize result) {
+    completion.result = result;
+    completion.done.release();
+  });
+  if (!status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+  completion.done.acquire();
+  return completion.result;
+}
+
+}  // namespace
+
+Status AsyncFlashMemory::Erase(Address flash_address, size_t num_sectors) {
+  return StartAndWait([&](Callback&& done) {
+           return StartErase(flash_address, num_sectors, std::move(done));
+         })
+      .status();
+}
+
+StatusWithSize AsyncFlashMemory::Read(Address address, span<std::byte> output) {
+  return StartAndWait([&](Callback&& done) {
+    return StartRead(address, output, std::move(done));
+  });
+}
+
+StatusWithSize AsyncFlashMemory::Write(Address destination_flash_address,
+                                       span<const std::byte> data) {
+  return StartAndWait([&](Callback&& done) {
+    return StartWrite(destination_flash_address, data, std::move(done));
+  });
+}
+
+}  // namespace pw::kvs
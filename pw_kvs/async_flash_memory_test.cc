@@ -0,0 +1,437 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/async_flash_memory.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/async_flash_redundant_writer.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kSectorSize = 512;
+constexpr size_t kSectorCount = 4;
+constexpr size_t kAlignment = 16;
+
+// An AsyncFlashMemory with two banks, each of which can run one operation at a
+// time. Operations run on a FakeFlashMemory when they are completed, either by
+// the test or immediately when they start.
+class FakeAsyncFlashMemory : public AsyncFlashMemory {
+ public:
+  static constexpr size_t kBanks = 2;
+
+  FakeAsyncFlashMemory()
+      : AsyncFlashMemory(kSectorSize, kSectorCount, kAlignment),
+        memory_(kAlignment) {}
+
+  Status Enable() override { return OkStatus(); }
+  Status Disable() override { return OkStatus(); }
+  bool IsEnabled() const override { return true; }
+
+  // Completes operations as soon as they start, as for blocking calls.
+  void set_complete_immediately(bool complete) {
+    complete_immediately_ = complete;
+  }
+
+  bool busy(size_t bank) const { return pending_[bank].has_value(); }
+
+  // Runs the bank's operation and calls its callback.
+  void Complete(size_t bank) {
+    PW_ASSERT(pending_[bank].has_value());
+    Operation operation = std::move(*pending_[bank]);
+    pending_[bank].reset();
+    operation.done(Run(operation));
+  }
+
+  FakeFlashMemory& memory() { return memory_; }
+
+ private:
+  struct Operation {
+    enum { kErase, kRead, kWrite } type;
+    Address address;
+    size_t num_sectors;
+    span<std::byte> output;
+    span<const std::byte> data;
+    Callback done;
+  };
+
+  static size_t BankFor(Address address) {
+    return address / (kSectorSize * kSectorCount / kBanks);
+  }
+
+  StatusWithSize Run(const Operation& operation) {
+    switch (operation.type) {
+      case Operation::kErase:
+        return StatusWithSize(
+            memory_.Erase(operation.address, operation.num_sectors), 0);
+      case Operation::kRead:
+        return memory_.Read(operation.address, operation.output);
+      case Operation::kWrite:
+        return memory_.Write(operation.address, operation.data);
+    }
+    return StatusWithSize::Internal();
+  }
+
+  Status Start(Operation&& operation) {
+    const size_t bank = BankFor(operation.address);
+    if (bank >= kBanks) {
+      return Status::InvalidArgument();
+    }
+    if (busy(bank)) {
+      return Status::Unavailable();
+    }
+    pending_[bank] = std::move(operation);
+    if (complete_immediately_) {
+      Complete(bank);
+    }
+    return OkStatus();
+  }
+
+  Status DoStartErase(Address address,
+                      size_t num_sectors,
+                      Callback&& done) override {
+    return Start(
+        {Operation::kErase, address, num_sectors, {}, {}, std::move(done)});
+  }
+
+  Status DoStartRead(Address address,
+                     span<std::byte> output,
+                     Callback&& done) override {
+    return Start({Operation::kRead, address, 0, output, {}, std::move(done)});
+  }
+
+  Status DoStartWrite(Address address,
+                      span<const std::byte> data,
+                      Callback&& done) override {
+    return Start({Operation::kWrite, address, 0, {}, data, std::move(done)});
+  }
+
+  FakeFlashMemoryBuffer<kSectorSize, kSectorCount> memory_;
+  std::array<std::optional<Operation>, kBanks> pending_;
+  bool complete_immediately_ = false;
+};
+
+constexpr size_t kBank1 = kSectorSize * kSectorCount / 2;
+
+// Records the result of an asynchronous operation.
+struct OperationResult {
+  AsyncFlashMemory::Callback callback() {
+    return [this](StatusWithSize status) {
+      result = status;
+      calls += 1;
+    };
+  }
+
+  StatusWithSize result;
+  int calls = 0;
+};
+
+TEST(AsyncFlashMemory, StartWriteCompletesLater) {
+  FakeAsyncFlashMemory flash;
+  constexpr std::array<std::byte, kAlignment> kData = {std::byte{0x12}};
+
+  OperationResult write;
+  ASSERT_EQ(flash.StartWrite(0, kData, write.callback()), OkStatus());
+  EXPECT_EQ(write.calls, 0);
+  EXPECT_EQ(flash.memory().buffer()[0], FakeFlashMemory::kErasedValue);
+
+  flash.Complete(0);
+  EXPECT_EQ(write.calls, 1);
+  EXPECT_EQ(write.result.status(), OkStatus());
+  EXPECT_EQ(write.result.size(), kData.size());
+  EXPECT_EQ(flash.memory().buffer()[0], std::byte{0x12});
+}
+
+TEST(AsyncFlashMemory, BusyBankIsUnavailable) {
+  FakeAsyncFlashMemory flash;
+  constexpr std::array<std::byte, kAlignment> kData{};
+
+  OperationResult erase;
+  ASSERT_EQ(flash.StartErase(0, 1, erase.callback()), OkStatus());
+
+  OperationResult write;
+  EXPECT_EQ(flash.StartWrite(kSectorSize, kData, write.callback()),
+            Status::Unavailable());
+
+  flash.Complete(0);
+  EXPECT_EQ(erase.calls, 1);
+  EXPECT_EQ(write.calls, 0);
+  EXPECT_EQ(flash.StartWrite(kSectorSize, kData, write.callback()), OkStatus());
+  flash.Complete(0);
+  EXPECT_EQ(write.calls, 1);
+}
+
+TEST(AsyncFlashMemory, WriteWhileErasingOtherBank) {
+  FakeAsyncFlashMemory flash;
+  std::array<std::byte, 2 * kAlignment> data;
+  std::memset(data.data(), 0xa5, data.size());
+
+  // Fill bank 1 so that it needs erasing.
+  flash.set_complete_immediately(true);
+  ASSERT_EQ(flash.Write(kBank1, data).status(), OkStatus());
+  flash.set_complete_immediately(false);
+
+  // Erase bank 1 while programming bank 0.
+  OperationResult erase;
+  OperationResult write;
+  ASSERT_EQ(flash.StartErase(kBank1, 1, erase.callback()), OkStatus());
+  ASSERT_EQ(flash.StartWrite(0, data, write.callback()), OkStatus());
+  EXPECT_TRUE(flash.busy(0));
+  EXPECT_TRUE(flash.busy(1));
+
+  flash.Complete(0);
+  EXPECT_EQ(write.result.status(), OkStatus());
+  EXPECT_EQ(erase.calls, 0);
+
+  flash.Complete(1);
+  EXPECT_EQ(erase.result.status(), OkStatus());
+  EXPECT_EQ(flash.memory().buffer()[kBank1], FakeFlashMemory::kErasedValue);
+  EXPECT_EQ(flash.memory().buffer()[0], std::byte{0xa5});
+}
+
+TEST(AsyncFlashMemory, ErrorsAreReportedToCallback) {
+  FakeAsyncFlashMemory flash;
+  constexpr std::array<std::byte, kAlignment> kData{};
+  ASSERT_TRUE(flash.memory().InjectWriteError(
+      FlashError::Unconditional(Status::DataLoss())));
+
+  OperationResult write;
+  ASSERT_EQ(flash.StartWrite(0, kData, write.callback()), OkStatus());
+  flash.Complete(0);
+  EXPECT_EQ(write.result.status(), Status::DataLoss());
+}
+
+TEST(AsyncFlashMemory, BlockingCalls) {
+  FakeAsyncFlashMemory flash;
+  flash.set_complete_immediately(true);
+
+  constexpr std::array<std::byte, kAlignment> kData = {
+      std::byte{1}, std::byte{2}, std::byte{3}};
+  EXPECT_EQ(flash.Write(kSectorSize, kData).status(), OkStatus());
+
+  std::array<std::byte, kAlignment> read{};
+  StatusWithSize result = flash.Read(kSectorSize, read);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(read, kData);
+
+  EXPECT_EQ(flash.Erase(kSectorSize, 1), OkStatus());
+  ASSERT_EQ(flash.Read(kSectorSize, read).status(), OkStatus());
+  EXPECT_EQ(read[0], FakeFlashMemory::kErasedValue);
+
+  // Calls that cannot start report why.
+  flash.set_complete_immediately(false);
+  OperationResult erase;
+  ASSERT_EQ(flash.StartErase(0, 1, erase.callback()), OkStatus());
+  EXPECT_EQ(flash.Read(0, read).status(), Status::Unavailable());
+  flash.Complete(0);
+}
+
+TEST(AsyncFlashMemory, KeyValueStoreUsesBlockingCalls) {
+  FakeAsyncFlashMemory flash;
+  flash.set_complete_immediately(true);
+  FlashPartition partition(&flash);
+
+  ChecksumCrc16 checksum;
+  const EntryFormat format{.magic = 0x2c5f0a13, .checksum = &checksum};
+  KeyValueStoreBuffer<8, kSectorCount> kvs(&partition, format);
+  ASSERT_EQ(kvs.Init(), OkStatus());
+
+  for (uint32_t i = 0; i < 64; ++i) {
+    ASSERT_EQ(kvs.Put("counter", i), OkStatus());
+  }
+  uint32_t value = 0;
+  ASSERT_EQ(kvs.Get("counter", &value), OkStatus());
+  EXPECT_EQ(value, 63u);
+}
+
+TEST(AsyncFlashRedundantWriter, WritesToBothBanksAtOnce) {
+  FakeAsyncFlashMemory flash;
+  FlashPartition partition(&flash);
+  AsyncFlashRedundantWriterBuffer<2> writer(flash);
+  constexpr std::array<std::byte, kAlignment> kData = {std::byte{0x34}};
+
+  ASSERT_EQ(writer.StartWrite(partition, 0, kData), OkStatus());
+  ASSERT_EQ(writer.StartWrite(partition, kBank1, kData), OkStatus());
+  EXPECT_TRUE(flash.busy(0));
+  EXPECT_TRUE(flash.busy(1));
+  EXPECT_EQ(writer.StartWrite(partition, kSectorSize, kData),
+            Status::Unavailable());
+
+  flash.Complete(1);
+  flash.Complete(0);
+  EXPECT_EQ(writer.WaitForWrite(), OkStatus());
+  EXPECT_EQ(writer.WaitForWrite(), OkStatus());
+  EXPECT_EQ(writer.WaitForWrite(), Status::FailedPrecondition());
+  EXPECT_EQ(flash.memory().buffer()[0], std::byte{0x34});
+  EXPECT_EQ(flash.memory().buffer()[kBank1], std::byte{0x34});
+}
+
+TEST(AsyncFlashRedundantWriter, BusyBankIsUnavailable) {
+  FakeAsyncFlashMemory flash;
+  FlashPartition partition(&flash);
+  AsyncFlashRedundantWriterBuffer<2> writer(flash);
+  constexpr std::array<std::byte, kAlignment> kData{};
+
+  ASSERT_EQ(writer.StartWrite(partition, 0, kData), OkStatus());
+  EXPECT_EQ(writer.StartWrite(partition, kSectorSize, kData),
+            Status::Unavailable());
+  flash.Complete(0);
+  EXPECT_EQ(writer.WaitForWrite(), OkStatus());
+}
+
+// Defers each write until it is waited for, and records how many writes were
+// in progress at once.
+class DeferredRedundantWriter : public KeyValueStore::RedundantWriter {
+ public:
+  explicit DeferredRedundantWriter(size_t max_writes)
+      : max_writes_(max_writes) {}
+
+  size_t most_in_progress() const { return most_in_progress_; }
+  size_t writes() const { return writes_; }
+
+  // Fails every second write, which is the second copy of each chunk when
+  // two copies are written at once.
+  void FailSecondCopies() { fail_second_copies_ = true; }
+
+ private:
+  struct Write {
+    FlashPartition* partition;
+    FlashPartition::Address address;
+    span<const std::byte> data;
+  };
+
+  Status DoStartWrite(FlashPartition& partition,
+                      FlashPartition::Address address,
+                      span<const std::byte> data) override {
+    if (in_progress_.size() == max_writes_) {
+      return Status::Unavailable();
+    }
+    in_progress_.push_back({&partition, address, data});
+    most_in_progress_ = std::max(most_in_progress_, in_progress_.size());
+    return OkStatus();
+  }
+
+  Status DoWaitForWrite() override {
+    const Write write = in_progress_.front();
+    in_progress_.erase(in_progress_.begin());
+    writes_ += 1;
+    if (fail_second_copies_ && writes_ % 2 == 0u) {
+      return Status::DataLoss();
+    }
+    return write.partition->Write(write.address, write.data).status();
+  }
+
+  const size_t max_writes_;
+  std::vector<Write> in_progress_;
+  size_t most_in_progress_ = 0;
+  size_t writes_ = 0;
+  bool fail_second_copies_ = false;
+};
+
+class RedundantWriterTest : public ::testing::Test {
+ protected:
+  RedundantWriterTest()
+      : partition_(&flash_),
+        format_{.magic = 0x2c5f0a13, .checksum = &checksum_},
+        kvs_(&partition_, format_) {
+    flash_.set_complete_immediately(true);
+  }
+
+  FakeAsyncFlashMemory flash_;
+  FlashPartition partition_;
+  ChecksumCrc16 checksum_;
+  const EntryFormat format_;
+  KeyValueStoreBuffer<8, kSectorCount, 2> kvs_;
+};
+
+TEST_F(RedundantWriterTest, WritesCopiesConcurrently) {
+  DeferredRedundantWriter writer(2);
+  kvs_.set_redundant_writer(&writer);
+  ASSERT_EQ(kvs_.Init(), OkStatus());
+
+  ASSERT_EQ(kvs_.Put("key", uint32_t{0x12345678}), OkStatus());
+  EXPECT_EQ(writer.most_in_progress(), 2u);
+  EXPECT_EQ(writer.writes() % 2, 0u);
+
+  uint32_t value = 0;
+  ASSERT_EQ(kvs_.Get("key", &value), OkStatus());
+  EXPECT_EQ(value, 0x12345678u);
+
+  // Both copies are found when the KVS is loaded again.
+  KeyValueStoreBuffer<8, kSectorCount, 2> reloaded(&partition_, format_);
+  ASSERT_EQ(reloaded.Init(), OkStatus());
+  EXPECT_EQ(reloaded.GetStorageStats().missing_redundant_entries_recovered,
+            0u);
+  ASSERT_EQ(reloaded.Get("key", &value), OkStatus());
+  EXPECT_EQ(value, 0x12345678u);
+}
+
+TEST_F(RedundantWriterTest, FallsBackWhenWritesCannotOverlap) {
+  DeferredRedundantWriter writer(1);
+  kvs_.set_redundant_writer(&writer);
+  ASSERT_EQ(kvs_.Init(), OkStatus());
+
+  for (uint32_t i = 0; i < 32; ++i) {
+    ASSERT_EQ(kvs_.Put("counter", i), OkStatus());
+  }
+  EXPECT_EQ(writer.most_in_progress(), 1u);
+
+  uint32_t value = 0;
+  ASSERT_EQ(kvs_.Get("counter", &value), OkStatus());
+  EXPECT_EQ(value, 31u);
+}
+
+TEST_F(RedundantWriterTest, FailedCopyKeepsEarlierCopies) {
+  DeferredRedundantWriter writer(2);
+  kvs_.set_redundant_writer(&writer);
+  ASSERT_EQ(kvs_.Init(), OkStatus());
+  ASSERT_EQ(kvs_.Put("key", uint32_t{1}), OkStatus());
+
+  writer.FailSecondCopies();
+  EXPECT_EQ(kvs_.Put("key", uint32_t{2}), Status::DataLoss());
+  EXPECT_TRUE(kvs_.error_detected());
+
+  // The first copy was written, so it replaces the old value.
+  uint32_t value = 0;
+  ASSERT_EQ(kvs_.Get("key", &value), OkStatus());
+  EXPECT_EQ(value, 2u);
+}
+
+TEST_F(RedundantWriterTest, AsyncFlashRedundantWriter) {
+  AsyncFlashRedundantWriterBuffer<2> writer(flash_);
+  kvs_.set_redundant_writer(&writer);
+  ASSERT_EQ(kvs_.Init(), OkStatus());
+
+  for (uint32_t i = 0; i < 64; ++i) {
+    ASSERT_EQ(kvs_.Put("counter", i), OkStatus());
+  }
+  uint32_t value = 0;
+  ASSERT_EQ(kvs_.Get("counter", &value), OkStatus());
+  EXPECT_EQ(value, 63u);
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -0,0 +1,53 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/async_flash_redundant_writer.h"
+
+#include "pw_status/try.h"
+
+namespace pw::kvs {
+
+Status AsyncFlashRedundantWriter::DoStartWrite(FlashPartition& partition,
+                                               FlashPartition::Address address,
+                                               span<const std::byte> data) {
+  if (!partition.writable()) {
+    return Status::PermissionDenied();
+  }
+  if (in_progress_ == writes_.size()) {
+    return Status::Unavailable();
+  }
+
+  Write& write = writes_[(oldest_ + in_progress_) % writes_.size()];
+  PW_TRY(flash_.StartWrite(partition.PartitionToFlashAddress(address),
+                           data,
+                           [&write](StatusWithSize result) {
+                             write.result = result.status();
+                             write.done.release();
+                           }));
+  in_progress_ += 1;
+  return OkStatus();
+}
+
+Status AsyncFlashRedundantWriter::DoWaitForWrite() {
+  if (in_progress_ == 0u) {
+    return Status::FailedPrecondition();
+  }
+  Write& write = writes_[oldest_];
+  write.done.acquire();
+  oldest_ = (oldest_ + 1) % writes_.size();
+  in_progress_ -= 1;
+  return write.result;
+}
+
+}  // namespace pw::kvs
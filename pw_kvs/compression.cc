@@ -0,0 +1,309 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/internal/compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "pw_bytes/endian.h"
+#include "pw_kvs_private/config.h"
+#include "pw_status/try.h"
+
+namespace pw::kvs::internal {
+namespace {
+
+using std::byte;
+
+// Limits of the LZ4 block format. Matches are at least 4 bytes long. The last
+// match must start at least 12 bytes before the end of the data, and the last 5
+// bytes must be literals.
+constexpr size_t kMinMatch = 4;
+constexpr size_t kMatchStartLimit = 12;
+constexpr size_t kLastLiterals = 5;
+constexpr size_t kMaxOffset = 0xFFFF;
+
+// Literal and match lengths of 15 or more are extended with additional bytes.
+constexpr size_t kLengthMask = 0xF;
+
+constexpr size_t kHashBits = PW_KVS_COMPRESSION_HASH_BITS;
+
+uint32_t Read32(const byte* data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+constexpr size_t Hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+// Writes compressed data to an Output, counting its size.
+class CompressedWriter {
+ public:
+  explicit CompressedWriter(Output& output) : output_(output), size_(0) {}
+
+  Status Write(span<const byte> data) {
+    if (data.empty()) {
+      return OkStatus();
+    }
+    const StatusWithSize result = output_.Write(data);
+    size_ += result.size();
+    return result.status();
+  }
+
+  // Writes a sequence of literals followed by a match. The match is omitted if
+  // match_length is 0, which is only valid for the last sequence.
+  Status WriteSequence(span<const byte> literals,
+                       size_t offset,
+                       size_t match_length) {
+    const size_t match_code = match_length == 0 ? 0 : match_length - kMinMatch;
+    const byte token =
+        static_cast<byte>(std::min(literals.size(), kLengthMask) << 4 |
+                          std::min(match_code, kLengthMask));
+    PW_TRY(Write(span(&token, 1)));
+    if (literals.size() >= kLengthMask) {
+      PW_TRY(WriteLengthExtension(literals.size() - kLengthMask));
+    }
+    PW_TRY(Write(literals));
+
+    if (match_length == 0) {
+      return OkStatus();
+    }
+    PW_TRY(Write(bytes::CopyInOrder(endian::little,
+                                    static_cast<uint16_t>(offset))));
+    if (match_code >= kLengthMask) {
+      PW_TRY(WriteLengthExtension(match_code - kLengthMask));
+    }
+    return OkStatus();
+  }
+
+  size_t size() const { return size_; }
+
+ private:
+  // Writes bytes of 255 until the remaining length is less than 255, which is
+  // written as the last byte.
+  Status WriteLengthExtension(size_t length) {
+    std::array<byte, 16> buffer;
+    size_t buffered = 0;
+    while (true) {
+      const size_t value = std::min<size_t>(length, 255);
+      buffer[buffered++] = static_cast<byte>(value);
+      length -= value;
+      if (value < 255u) {
+        return Write(span(buffer).first(buffered));
+      }
+      if (buffered == buffer.size()) {
+        PW_TRY(Write(buffer));
+        buffered = 0;
+      }
+    }
+  }
+
+  Output& output_;
+  size_t size_;
+};
+
+// Discards output, so that it is only counted.
+class NullOutput final : public Output {
+ private:
+  StatusWithSize DoWrite(span<const byte> data) override {
+    return StatusWithSize(data.size());
+  }
+};
+
+// Reads compressed data from an Input. Data is read in small chunks, except
+// that long runs of literals are read directly into the output.
+class CompressedReader {
+ public:
+  CompressedReader(Input& input, size_t size)
+      : input_(input), remaining_(size), buffered_(0), position_(0) {}
+
+  // Reads exactly data.size() bytes.
+  Status Read(span<byte> data) {
+    while (!data.empty()) {
+      if (position_ == buffered_) {
+        if (data.size() >= buffer_.size()) {
+          return ReadFromInput(data);
+        }
+        const size_t size = std::min(remaining_, buffer_.size());
+        if (size == 0u) {
+          return Status::DataLoss();
+        }
+        PW_TRY(ReadFromInput(span(buffer_).first(size)));
+        buffered_ = size;
+        position_ = 0;
+      }
+      const size_t size = std::min(data.size(), buffered_ - position_);
+      std::memcpy(data.data(), &buffer_[position_], size);
+      position_ += size;
+      data = data.subspan(size);
+    }
+    return OkStatus();
+  }
+
+  // Reads the bytes that extend a literal or match length.
+  Status ReadLengthExtension(size_t& length) {
+    byte value;
+    do {
+      PW_TRY(Read(span(&value, 1)));
+      length += static_cast<size_t>(value);
+    } while (value == byte{255});
+    return OkStatus();
+  }
+
+  // True if all of the compressed data was read.
+  bool done() const { return remaining_ == 0u && position_ == buffered_; }
+
+ private:
+  Status ReadFromInput(span<byte> data) {
+    if (data.size() > remaining_) {
+      return Status::DataLoss();
+    }
+    const StatusWithSize result = input_.Read(data);
+    PW_TRY(result.status());
+    if (result.size() != data.size()) {
+      return Status::DataLoss();
+    }
+    remaining_ -= data.size();
+    return OkStatus();
+  }
+
+  Input& input_;
+  size_t remaining_;
+  std::array<byte, 32> buffer_;
+  size_t buffered_;
+  size_t position_;
+};
+
+}  // namespace
+
+StatusWithSize Compress(span<const byte> data, Output& output) {
+  CompressedWriter writer(output);
+  PW_TRY_WITH_SIZE(writer.Write(
+      bytes::CopyInOrder(endian::little, static_cast<uint32_t>(data.size()))));
+
+  size_t anchor = 0;
+  if (data.size() > kMatchStartLimit) {
+    // The last position at which each hashed 4-byte sequence was found, plus
+    // one, so that 0 means no position.
+    std::array<uint32_t, size_t{1} << kHashBits> positions{};
+
+    const size_t match_start_limit = data.size() - kMatchStartLimit;
+    const size_t match_end_limit = data.size() - kLastLiterals;
+
+    size_t i = 0;
+    while (i <= match_start_limit) {
+      const uint32_t sequence = Read32(&data[i]);
+      uint32_t& position = positions[Hash(sequence)];
+      const size_t candidate = position;
+      position = static_cast<uint32_t>(i + 1);
+
+      if (candidate == 0u || i + 1 - candidate > kMaxOffset ||
+          Read32(&data[candidate - 1]) != sequence) {
+        i += 1;
+        continue;
+      }
+
+      const size_t match = candidate - 1;
+      size_t length = kMinMatch;
+      while (i + length < match_end_limit &&
+             data[match + length] == data[i + length]) {
+        length += 1;
+      }
+
+      PW_TRY_WITH_SIZE(writer.WriteSequence(
+          data.subspan(anchor, i - anchor), i - match, length));
+      i += length;
+      anchor = i;
+    }
+  }
+
+  PW_TRY_WITH_SIZE(writer.WriteSequence(data.subspan(anchor), 0, 0));
+  return StatusWithSize(writer.size());
+}
+
+size_t CompressedSize(span<const byte> data) {
+  NullOutput output;
+  return Compress(data, output).size();
+}
+
+StatusWithSize Decompress(Input& input,
+                          size_t compressed_size,
+                          span<byte> output) {
+  CompressedReader reader(input, compressed_size);
+
+  std::array<byte, kCompressedSizePrefixBytes> size_prefix;
+  PW_TRY_WITH_SIZE(reader.Read(size_prefix));
+  const size_t size = bytes::ReadInOrder<uint32_t>(endian::little, size_prefix);
+
+  size_t written = 0;
+  while (true) {
+    byte token;
+    PW_TRY_WITH_SIZE(reader.Read(span(&token, 1)));
+
+    size_t literals = static_cast<size_t>(token >> 4);
+    if (literals == kLengthMask) {
+      PW_TRY_WITH_SIZE(reader.ReadLengthExtension(literals));
+    }
+    if (literals > size - written) {
+      return StatusWithSize::DataLoss(written);
+    }
+    const size_t literals_read = std::min(literals, output.size() - written);
+    PW_TRY_WITH_SIZE(reader.Read(output.subspan(written, literals_read)));
+    written += literals_read;
+
+    // Stop if the output is full, or after the last sequence, which has no
+    // match.
+    if (literals_read < literals || written == size) {
+      break;
+    }
+
+    std::array<byte, sizeof(uint16_t)> offset_bytes;
+    PW_TRY_WITH_SIZE(reader.Read(offset_bytes));
+    const size_t offset =
+        bytes::ReadInOrder<uint16_t>(endian::little, offset_bytes);
+
+    size_t match_length = static_cast<size_t>(token & byte{0xF});
+    if (match_length == kLengthMask) {
+      PW_TRY_WITH_SIZE(reader.ReadLengthExtension(match_length));
+    }
+    match_length += kMinMatch;
+
+    if (offset == 0u || offset > written || match_length > size - written) {
+      return StatusWithSize::DataLoss(written);
+    }
+
+    // The match may overlap the bytes it produces, so copy it byte by byte.
+    const size_t match_end = written + std::min(match_length,
+                                                output.size() - written);
+    for (; written < match_end; ++written) {
+      output[written] = output[written - offset];
+    }
+    if (written == output.size()) {
+      break;
+    }
+  }
+
+  if (written < size) {
+    return StatusWithSize::ResourceExhausted(written);
+  }
+  if (!reader.done()) {
+    return StatusWithSize::DataLoss(written);
+  }
+  return StatusWithSize(size);
+}
+
+}  // namespace pw::kvs::internal
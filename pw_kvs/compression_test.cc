@@ -0,0 +1,192 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/internal/compression.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::kvs::internal {
+namespace {
+
+using std::byte;
+
+// Writes to a buffer.
+class BufferOutput final : public Output {
+ public:
+  span<const byte> data() const { return span(buffer_).first(size_); }
+
+ private:
+  StatusWithSize DoWrite(span<const byte> data) override {
+    if (data.size() > buffer_.size() - size_) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    std::memcpy(&buffer_[size_], data.data(), data.size());
+    size_ += data.size();
+    return StatusWithSize(data.size());
+  }
+
+  std::array<byte, 2048> buffer_;
+  size_t size_ = 0;
+};
+
+// Reads from a buffer, counting the reads.
+class BufferInput final : public Input {
+ public:
+  explicit BufferInput(span<const byte> data) : data_(data) {}
+
+  size_t reads = 0;
+
+ private:
+  StatusWithSize DoRead(span<byte> data) override {
+    reads += 1;
+    const size_t size = std::min(data.size(), data_.size());
+    std::memcpy(data.data(), data_.data(), size);
+    data_ = data_.subspan(size);
+    return StatusWithSize(size);
+  }
+
+  span<const byte> data_;
+};
+
+// Text with the repetition typical of serialized configuration.
+constexpr char kConfig[] =
+    "{\"channels\":[{\"name\":\"left\",\"gain\":12,\"enabled\":true},"
+    "{\"name\":\"right\",\"gain\":12,\"enabled\":true},"
+    "{\"name\":\"center\",\"gain\":10,\"enabled\":false},"
+    "{\"name\":\"rear\",\"gain\":10,\"enabled\":false}]}";
+
+span<const byte> ConfigBytes() {
+  return as_bytes(span(kConfig, sizeof(kConfig) - 1));
+}
+
+StatusWithSize RoundTrip(span<const byte> data, span<byte> output) {
+  BufferOutput compressed;
+  const StatusWithSize result = Compress(data, compressed);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(result.size(), compressed.data().size());
+  EXPECT_EQ(CompressedSize(data), compressed.data().size());
+
+  BufferInput input(compressed.data());
+  return Decompress(input, compressed.data().size(), output);
+}
+
+TEST(Compression, MatchesLz4BlockFormat) {
+  std::array<byte, 20> data;
+  data.fill(byte{'a'});
+
+  BufferOutput compressed;
+  ASSERT_EQ(OkStatus(), Compress(data, compressed).status());
+
+  // One literal and a 14-byte match at offset 1, then the last 5 literals.
+  constexpr auto kExpected = bytes::Concat(
+      bytes::String("\x14\x00\x00\x00"), bytes::String("\x1a" "a\x01\x00"),
+      bytes::String("\x50" "aaaaa"));
+  ASSERT_EQ(kExpected.size(), compressed.data().size());
+  EXPECT_EQ(0,
+            std::memcmp(kExpected.data(), compressed.data().data(),
+                        kExpected.size()));
+}
+
+TEST(Compression, RoundTrip_Empty) {
+  std::array<byte, 1> output;
+  const StatusWithSize result = RoundTrip({}, output);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST(Compression, RoundTrip_Config) {
+  const span<const byte> data = ConfigBytes();
+  EXPECT_LT(CompressedSize(data), data.size());
+
+  std::array<byte, sizeof(kConfig)> output;
+  const StatusWithSize result = RoundTrip(data, output);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(data.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(output.data(), data.data(), data.size()));
+}
+
+TEST(Compression, RoundTrip_LongLiteralsAndMatches) {
+  // A run of literals with no repetition, followed by a long match, needs
+  // several bytes to extend each length.
+  std::array<byte, 1200> data;
+  uint32_t state = 1;
+  for (size_t i = 0; i < 600; ++i) {
+    state = state * 1103515245u + 12345u;
+    data[i] = static_cast<byte>(state >> 16);
+  }
+  std::memcpy(&data[600], &data[0], 600);
+
+  std::array<byte, 1200> output;
+  const StatusWithSize result = RoundTrip(data, output);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(data.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(output.data(), data.data(), data.size()));
+}
+
+TEST(Compression, Decompress_OutputTooSmall) {
+  const span<const byte> data = ConfigBytes();
+  std::array<byte, 40> output;
+  const StatusWithSize result = RoundTrip(data, output);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(output.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(output.data(), data.data(), output.size()));
+}
+
+TEST(Compression, Decompress_LongLiteralsAreReadDirectly) {
+  std::array<byte, 200> data;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<byte>(i);
+  }
+  BufferOutput compressed;
+  ASSERT_EQ(OkStatus(), Compress(data, compressed).status());
+
+  BufferInput input(compressed.data());
+  std::array<byte, 200> output;
+  const StatusWithSize result =
+      Decompress(input, compressed.data().size(), output);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(data.size(), result.size());
+  EXPECT_LE(input.reads, 4u);
+}
+
+TEST(Compression, Decompress_Invalid) {
+  std::array<byte, 32> output;
+
+  // The match refers to data before the start of the value.
+  constexpr auto kBadOffset =
+      bytes::String("\x10\x00\x00\x00\x10" "a\x02\x00\x70" "aaaaaaa");
+  BufferInput bad_offset(kBadOffset);
+  EXPECT_EQ(Status::DataLoss(),
+            Decompress(bad_offset, kBadOffset.size(), output).status());
+
+  // The value ends before its last literals.
+  constexpr auto kTruncated = bytes::String("\x05\x00\x00\x00\x50" "aaa");
+  BufferInput truncated(kTruncated);
+  EXPECT_EQ(Status::DataLoss(),
+            Decompress(truncated, kTruncated.size(), output).status());
+
+  // The value continues after its last literals.
+  constexpr auto kTrailing = bytes::String("\x01\x00\x00\x00\x10" "aa");
+  BufferInput trailing(kTrailing);
+  EXPECT_EQ(Status::DataLoss(),
+            Decompress(trailing, kTrailing.size(), output).status());
+}
+
+}  // namespace
+}  // namespace pw::kvs::internal
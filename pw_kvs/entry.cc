@@ -20,6 +20,8 @@
 #include <cinttypes>
 #include <cstring>
 
+#include "pw_bytes/endian.h"
+#include "pw_kvs/internal/compression.h"
 #include "pw_kvs_private/config.h"
 #include "pw_log/log.h"
 #include "pw_status/try.h"
@@ -35,6 +37,101 @@ constexpr size_t kWriteBufferSize =
 
 using std::byte;
 
+namespace {
+
+// Writes to an AlignedWriter as an Output.
+class AlignedWriterOutput final : public Output {
+ public:
+  explicit constexpr AlignedWriterOutput(AlignedWriter& writer)
+      : writer_(writer) {}
+
+ private:
+  StatusWithSize DoWrite(span<const byte> data) override {
+    // AlignedWriter reports the bytes flushed rather than the bytes written.
+    return StatusWithSize(writer_.Write(data).status(), data.size());
+  }
+
+  AlignedWriter& writer_;
+};
+
+// Adds the data written to it to a checksum.
+class ChecksumOutput final : public Output {
+ public:
+  explicit constexpr ChecksumOutput(ChecksumAlgorithm& checksum)
+      : checksum_(checksum) {}
+
+ private:
+  StatusWithSize DoWrite(span<const byte> data) override {
+    checksum_.Update(data);
+    return StatusWithSize(data.size());
+  }
+
+  ChecksumAlgorithm& checksum_;
+};
+
+// Reads from flash, adding the data read to a checksum if there is one.
+class ChecksumFlashInput final : public Input {
+ public:
+  ChecksumFlashInput(FlashPartition& partition,
+                     FlashPartition::Address address,
+                     ChecksumAlgorithm* checksum)
+      : flash_(partition, address), checksum_(checksum) {}
+
+ private:
+  StatusWithSize DoRead(span<byte> data) override {
+    const StatusWithSize result = flash_.Read(data);
+    if (checksum_ != nullptr) {
+      checksum_->Update(data.first(result.size()));
+    }
+    return result;
+  }
+
+  FlashPartition::Input flash_;
+  ChecksumAlgorithm* checksum_;
+};
+
+// Compares the data written to it with data in flash. Writes fail with
+// NOT_FOUND once the data differs.
+class FlashComparison final : public Output {
+ public:
+  FlashComparison(FlashPartition& partition,
+                  FlashPartition::Address address,
+                  size_t size)
+      : partition_(partition), address_(address), remaining_(size) {}
+
+  // True if all of the data in flash was compared.
+  bool complete() const { return remaining_ == 0u; }
+
+ private:
+  StatusWithSize DoWrite(span<const byte> data) override {
+    if (data.size() > remaining_) {
+      return StatusWithSize::NotFound();
+    }
+
+    const size_t size = data.size();
+    std::array<byte, 2 * Entry::kMinAlignmentBytes> buffer;
+    while (!data.empty()) {
+      const size_t read_size = std::min(data.size(), buffer.size());
+      PW_TRY_WITH_SIZE(
+          partition_.Read(address_, span(buffer).first(read_size)));
+
+      if (std::memcmp(buffer.data(), data.data(), read_size) != 0) {
+        return StatusWithSize::NotFound();
+      }
+      address_ += read_size;
+      remaining_ -= read_size;
+      data = data.subspan(read_size);
+    }
+    return StatusWithSize(size);
+  }
+
+  FlashPartition& partition_;
+  FlashPartition::Address address_;
+  size_t remaining_;
+};
+
+}  // namespace
+
 Status Entry::Read(FlashPartition& partition,
                    Address address,
                    const internal::EntryFormats& formats,
@@ -45,7 +142,8 @@ Status Entry::Read(FlashPartition& partition,
   if (partition.AppearsErased(as_bytes(span(&header.magic, 1)))) {
     return Status::NotFound();
   }
-  if (header.key_length_bytes > kMaxKeyLength) {
+  if ((header.key_length_bytes & ~(kContinuesBatchFlag | kCompressedFlag)) >
+      kMaxKeyLength) {
     return Status::DataLoss();
   }
 
@@ -79,7 +177,9 @@ Entry::Entry(FlashPartition& partition,
              Key key,
              span<const byte> value,
              uint16_t value_size_bytes,
-             uint32_t transaction_id)
+             uint32_t transaction_id,
+             bool continues_batch,
+             bool compressed)
     : Entry(&partition,
             address,
             format,
@@ -87,7 +187,9 @@ Entry::Entry(FlashPartition& partition,
              .checksum = 0,
              .alignment_units =
                  alignment_bytes_to_units(partition.alignment_bytes()),
-             .key_length_bytes = static_cast<uint8_t>(key.size()),
+             .key_length_bytes = static_cast<uint8_t>(
+                 key.size() | (continues_batch ? kContinuesBatchFlag : 0u) |
+                 (compressed ? kCompressedFlag : 0u)),
              .value_size_bytes = value_size_bytes,
              .transaction_id = transaction_id}) {
   if (checksum_algo_ != nullptr) {
@@ -98,14 +200,44 @@ Entry::Entry(FlashPartition& partition,
   }
 }
 
+size_t Entry::StoredValueSize(span<const byte> value, bool compress) {
+  return compress ? std::min(CompressedSize(value), value.size())
+                  : value.size();
+}
+
 StatusWithSize Entry::Write(Key key, span<const byte> value) const {
   FlashPartition::Output flash(partition(), address_);
+  if (compressed()) {
+    AlignedWriterBuffer<kWriteBufferSize> writer(alignment_bytes(), flash);
+    PW_TRY_WITH_SIZE(Write(writer, key, value));
+    return writer.Flush();
+  }
   return AlignedWrite<kWriteBufferSize>(
       flash,
       alignment_bytes(),
       {as_bytes(span(&header_, 1)), as_bytes(span(key)), value});
 }
 
+StatusWithSize Entry::Write(AlignedWriter& writer,
+                            Key key,
+                            span<const byte> value) const {
+  PW_TRY_WITH_SIZE(writer.Write(&header_, sizeof(header_)));
+  PW_TRY_WITH_SIZE(writer.Write(as_bytes(span(key))));
+  PW_TRY_WITH_SIZE(WriteValue(writer, value));
+
+  // Pad to the alignment boundary here rather than when the writer is flushed,
+  // so that the next entry starts at an aligned address.
+  constexpr byte padding[kMinAlignmentBytes - 1] = {};
+  size_t padding_to_add = Padding(content_size(), alignment_bytes());
+
+  while (padding_to_add != 0u) {
+    const size_t chunk_size = std::min(padding_to_add, sizeof(padding));
+    PW_TRY_WITH_SIZE(writer.Write(padding, chunk_size));
+    padding_to_add -= chunk_size;
+  }
+  return StatusWithSize(size());
+}
+
 Status Entry::Update(const EntryFormat& new_format,
                      uint32_t new_transaction_id) {
   checksum_algo_ = new_format.checksum;
@@ -140,6 +272,19 @@ StatusWithSize Entry::Copy(Address new_address) const {
   return writer.Flush();
 }
 
+Status Entry::DetachFromBatch() {
+  header_.key_length_bytes &= ~kContinuesBatchFlag;
+  return CalculateChecksumFromFlash();
+}
+
+Status Entry::WriteValue(AlignedWriter& writer, span<const byte> value) const {
+  if (!compressed()) {
+    return writer.Write(value).status();
+  }
+  AlignedWriterOutput output(writer);
+  return Compress(value, output).status();
+}
+
 StatusWithSize Entry::ReadValue(span<byte> buffer, size_t offset_bytes) const {
   if (offset_bytes > value_size()) {
     return StatusWithSize::OutOfRange();
@@ -159,29 +304,59 @@ StatusWithSize Entry::ReadValue(span<byte> buffer, size_t offset_bytes) const {
   return StatusWithSize(read_size);
 }
 
-Status Entry::ValueMatches(span<const std::byte> value) const {
-  if (value_size() != value.size_bytes()) {
-    return Status::NotFound();
+StatusWithSize Entry::ReadCompressedValue(span<byte> buffer,
+                                          bool verify) const {
+  if (verify && checksum_algo_ == nullptr && header_.checksum != 0u) {
+    return StatusWithSize::DataLoss();
   }
+  verify = verify && checksum_algo_ != nullptr;
 
-  Address address = address_ + sizeof(EntryHeader) + key_length();
-  Address end = address + value_size();
-  const std::byte* value_ptr = value.data();
+  if (!verify) {
+    ChecksumFlashInput input(partition(), value_address(), nullptr);
+    return Decompress(input, value_size(), buffer);
+  }
 
-  std::array<std::byte, 2 * kMinAlignmentBytes> buffer;
-  while (address < end) {
-    const size_t read_size = std::min(size_t(end - address), buffer.size());
-    PW_TRY(partition_->Read(address, span(buffer).first(read_size)));
+  // Checksum the entry as it is read, as if the checksum field were 0.
+  EntryHeader header = header_;
+  header.checksum = 0;
+  checksum_algo_->Reset();
+  checksum_algo_->Update(&header, sizeof(header));
 
-    if (std::memcmp(buffer.data(), value_ptr, read_size) != 0) {
-      return Status::NotFound();
-    }
+  ChecksumFlashInput input(
+      partition(), address_ + sizeof(EntryHeader), checksum_algo_);
+  KeyBuffer key;
+  PW_TRY_WITH_SIZE(input.Read(key.data(), key_length()));
 
-    address += read_size;
-    value_ptr += read_size;
+  const StatusWithSize result = Decompress(input, value_size(), buffer);
+  if (!result.ok()) {
+    return result;
   }
 
-  return OkStatus();
+  AddPaddingBytesToChecksum();
+  checksum_algo_->Finish();
+  return StatusWithSize(checksum_algo_->Verify(checksum_bytes()),
+                        result.size());
+}
+
+StatusWithSize Entry::ReadValueSize() const {
+  if (!compressed()) {
+    return StatusWithSize(value_size());
+  }
+  std::array<byte, kCompressedSizePrefixBytes> size_prefix;
+  PW_TRY_WITH_SIZE(partition().Read(value_address(), size_prefix));
+  return StatusWithSize(
+      bytes::ReadInOrder<uint32_t>(endian::little, size_prefix));
+}
+
+Status Entry::ValueMatches(span<const std::byte> value) const {
+  if (!compressed() && value_size() != value.size_bytes()) {
+    return Status::NotFound();
+  }
+
+  FlashComparison comparison(partition(), value_address(), value_size());
+  PW_TRY(compressed() ? Compress(value, comparison).status()
+                      : comparison.Write(value).status());
+  return comparison.complete() ? OkStatus() : Status::NotFound();
 }
 
 Status Entry::VerifyChecksum(Key key, span<const byte> value) const {
@@ -251,6 +426,7 @@ void Entry::DebugLog() const {
   PW_LOG_DEBUG("   Checksum     = 0x%x", unsigned(header_.checksum));
   PW_LOG_DEBUG("   Key length   = 0x%x", unsigned(key_length()));
   PW_LOG_DEBUG("   Value length = 0x%x", unsigned(value_size()));
+  PW_LOG_DEBUG("   Compressed   = %s", compressed() ? "yes" : "no");
   PW_LOG_DEBUG("   Entry size   = 0x%x", unsigned(size()));
   PW_LOG_DEBUG("   Alignment    = 0x%x", unsigned(alignment_bytes()));
 }
@@ -265,7 +441,12 @@ span<const byte> Entry::CalculateChecksum(const Key key,
 
     checksum_algo_->Update(&header_for_checksum, sizeof(header_for_checksum));
     checksum_algo_->Update(as_bytes(span(key)));
-    checksum_algo_->Update(value);
+    if (compressed()) {
+      ChecksumOutput output(*checksum_algo_);
+      Compress(value, output).IgnoreError();  // ChecksumOutput cannot fail.
+    } else {
+      checksum_algo_->Update(value);
+    }
   }
 
   AddPaddingBytesToChecksum();
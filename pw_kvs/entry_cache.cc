@@ -17,6 +17,7 @@
 
 #include "pw_kvs/internal/entry_cache.h"
 
+#include <algorithm>
 #include <cinttypes>
 
 #include "pw_assert/check.h"
@@ -51,7 +52,7 @@ void EntryMetadata::RemoveAddress(Address address_to_remove) {
 }
 
 void EntryMetadata::Reset(const KeyDescriptor& descriptor, Address address) {
-  *descriptor_ = descriptor;
+  entry_cache_->SetDescriptor(index_, descriptor);
 
   addresses_[0] = address;
   for (size_t i = 1; i < addresses_.size(); ++i) {
@@ -60,6 +61,11 @@ void EntryMetadata::Reset(const KeyDescriptor& descriptor, Address address) {
   addresses_ = addresses_.first(1);
 }
 
+void EntryCache::Reset() const {
+  key_hashes_.clear();
+  std::fill(hash_index_.begin(), hash_index_.end(), HashIndexSlot(0));
+}
+
 StatusWithSize EntryCache::Find(FlashPartition& partition,
                                 const Sectors& sectors,
                                 const EntryFormats& formats,
@@ -69,93 +75,104 @@ StatusWithSize EntryCache::Find(FlashPartition& partition,
   Entry::KeyBuffer key_buffer;
   bool error_detected = false;
 
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == hash) {
-      bool key_found = false;
-      Key read_key;
-
-      for (Address address : addresses(i)) {
-        Status read_result =
-            Entry::ReadKey(partition, address, key.size(), key_buffer.data());
-
-        read_key = Key(key_buffer.data(), key.size());
-
-        if (read_result.ok() && hash == internal::Hash(read_key)) {
-          key_found = true;
-          break;
-        } else {
-          // A hash mismatch can be caused by reading invalid data or a key hash
-          // collision of keys with differing size. To verify the data read from
-          // flash is good, validate the entry.
-          Entry entry;
-          read_result = Entry::Read(partition, address, formats, &entry);
-          if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
-            key_found = true;
-            break;
-          }
-
-          PW_LOG_WARN(
-              "   Found corrupt entry, invalidating this copy of the key");
-          error_detected = true;
-          sectors.FromAddress(address).mark_corrupt();
-        }
-      }
-      size_t error_val = error_detected ? 1 : 0;
-
-      if (!key_found) {
-        PW_LOG_ERROR("No valid entries for key. Data has been lost!");
-        return StatusWithSize::DataLoss(error_val);
-      } else if (key == read_key) {
-        PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
-        *metadata = EntryMetadata(descriptors_[i], addresses(i));
-        return StatusWithSize(error_val);
-      } else {
-        PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
-        return StatusWithSize::AlreadyExists(error_val);
+  // Keys must have unique hashes, so at most one descriptor can match.
+  const int index = FindIndex(hash);
+  if (index == -1) {
+    return StatusWithSize::NotFound();
+  }
+  const size_t i = index;
+  bool key_found = false;
+  Key read_key;
+
+  for (Address address : addresses(i)) {
+    Status read_result =
+        Entry::ReadKey(partition, address, key.size(), key_buffer.data());
+
+    read_key = Key(key_buffer.data(), key.size());
+
+    if (read_result.ok() && hash == internal::Hash(read_key)) {
+      key_found = true;
+      break;
+    } else {
+      // A hash mismatch can be caused by reading invalid data or a key hash
+      // collision of keys with differing size. To verify the data read from
+      // flash is good, validate the entry.
+      Entry entry;
+      read_result = Entry::Read(partition, address, formats, &entry);
+      if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
+        key_found = true;
+        break;
       }
+
+      PW_LOG_WARN("   Found corrupt entry, invalidating this copy of the key");
+      error_detected = true;
+      sectors.FromAddress(address).mark_corrupt();
     }
   }
-  return StatusWithSize::NotFound();
+  size_t error_val = error_detected ? 1 : 0;
+
+  if (!key_found) {
+    PW_LOG_ERROR("No valid entries for key. Data has been lost!");
+    return StatusWithSize::DataLoss(error_val);
+  } else if (key == read_key) {
+    PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
+    *metadata = EntryMetadata(*this, i, addresses(i));
+    return StatusWithSize(error_val);
+  } else {
+    PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
+    return StatusWithSize::AlreadyExists(error_val);
+  }
 }
 
 EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
                                  Address address) const {
   // TODO(hepler): DCHECK(!full());
-  Address* first_address = ResetAddresses(descriptors_.size(), address);
-  descriptors_.push_back(descriptor);
-  return EntryMetadata(descriptors_.back(), span(first_address, 1));
+  const size_t index = key_hashes_.size();
+  Address* first_address = ResetAddresses(index, address);
+  InsertIntoHashIndex(descriptor.key_hash, index);
+  key_hashes_.push_back(descriptor.key_hash);
+  SetDescriptor(index, descriptor);
+  return EntryMetadata(*this, index, span(first_address, 1));
 }
 
 // Removes an existing entry from the cache
 EntryCache::iterator EntryCache::RemoveEntry(iterator& entry_it) {
-  PW_DCHECK_PTR_EQ(entry_it.entry_cache_, this);
+  PW_DCHECK_PTR_EQ(entry_it.metadata_.entry_cache_, this);
 
-  const unsigned int index_to_remove =
-      entry_it.metadata_.descriptor_ - &descriptors_.front();
-  const KeyDescriptor last_desc = descriptors_[descriptors_.size() - 1];
+  const size_t index_to_remove = entry_it.metadata_.index_;
+  const size_t last_index = key_hashes_.size() - 1;
+  uint32_t* const key_hashes = key_hashes_.data();
 
   // Since order is not important, this copies the last descriptor into the
   // deleted descriptor's space and then pops the last entry.
-  Address* addresses_at_end = first_address(descriptors_.size() - 1);
+  Address* addresses_at_end = first_address(last_index);
+
+  RemoveFromHashIndex(key_hashes[index_to_remove]);
 
-  if (index_to_remove < descriptors_.size() - 1) {
+  if (index_to_remove < last_index) {
+    if (has_hash_index()) {
+      hash_index_[FindHashIndexSlot(key_hashes[last_index])] =
+          static_cast<HashIndexSlot>(index_to_remove + 1);
+    }
     Address* addresses_to_remove = first_address(index_to_remove);
     for (unsigned int i = 0; i < redundancy_; i++) {
       addresses_to_remove[i] = addresses_at_end[i];
     }
-    descriptors_[index_to_remove] = last_desc;
+    key_hashes[index_to_remove] = key_hashes[last_index];
+    transaction_ids_[index_to_remove] = transaction_ids_[last_index];
+    states_[index_to_remove] = states_[last_index];
   }
 
   // Erase the last entry since it was copied over the entry being deleted.
-  descriptors_.pop_back();
+  key_hashes_.pop_back();
 
-  return {this, descriptors_.data() + index_to_remove};
+  return {this, index_to_remove};
 }
 
-// TODO(hepler): This method is the trigger of the O(valid_entries *
-// all_entries) time complexity for reading. At some cost to memory, this could
-// be optimized by using a hash table instead of scanning, but in practice this
-// should be fine for a small number of keys
+// Without a hash index, this method is the trigger of the O(valid_entries *
+// all_entries) time complexity for reading, since FindIndex scans the
+// descriptors. This is fine for a small number of keys; larger caches should
+// provide a hash index.
 Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
                                           Address address,
                                           size_t sector_size_bytes) const {
@@ -173,16 +190,16 @@ Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
   }
 
   // Existing entry is old; replace the existing entry with the new one.
-  if (descriptor.transaction_id > descriptors_[index].transaction_id) {
-    descriptors_[index] = descriptor;
+  if (descriptor.transaction_id > transaction_ids_[index]) {
+    SetDescriptor(index, descriptor);
     ResetAddresses(index, address);
     return OkStatus();
   }
 
   // If the entries have a duplicate transaction ID, add the new (redundant)
   // entry to the existing descriptor.
-  if (descriptors_[index].transaction_id == descriptor.transaction_id) {
-    if (descriptors_[index].key_hash != descriptor.key_hash) {
+  if (transaction_ids_[index] == descriptor.transaction_id) {
+    if (key_hashes_.data()[index] != descriptor.key_hash) {
       PW_LOG_ERROR("Duplicate entry for key 0x%08" PRIx32
                    " with transaction ID %" PRIu32 " has non-matching hash",
                    descriptor.key_hash,
@@ -210,8 +227,8 @@ Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
 size_t EntryCache::present_entries() const {
   size_t present_entries = 0;
 
-  for (const KeyDescriptor& descriptor : descriptors_) {
-    if (descriptor.state != EntryState::kDeleted) {
+  for (size_t i = 0; i < key_hashes_.size(); ++i) {
+    if (states_[i] != EntryState::kDeleted) {
       present_entries += 1;
     }
   }
@@ -220,9 +237,35 @@ size_t EntryCache::present_entries() const {
 }
 
 int EntryCache::FindIndex(uint32_t key_hash) const {
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == key_hash) {
-      return i;
+  if (has_hash_index()) {
+    const size_t slot = FindHashIndexSlot(key_hash);
+    return slot == hash_index_.size() ? -1 : hash_index_[slot] - 1;
+  }
+  return ScanForKeyHash(key_hash);
+}
+
+int EntryCache::ScanForKeyHash(uint32_t key_hash) const {
+  const uint32_t* const key_hashes = key_hashes_.data();
+  const size_t size = key_hashes_.size();
+
+  // Compare a block of hashes at a time without branching on each one, which
+  // compilers can turn into vector compares, then find the match within the
+  // block, if any.
+  constexpr size_t kBlockSize = 8;
+  size_t i = 0;
+  for (; i + kBlockSize <= size; i += kBlockSize) {
+    bool found = false;
+    for (size_t j = 0; j < kBlockSize; ++j) {
+      found |= key_hashes[i + j] == key_hash;
+    }
+    if (found) {
+      break;
+    }
+  }
+
+  for (; i < size; ++i) {
+    if (key_hashes[i] == key_hash) {
+      return static_cast<int>(i);
     }
   }
   return -1;
@@ -264,4 +307,60 @@ EntryCache::Address* EntryCache::ResetAddresses(size_t descriptor_index,
   return first;
 }
 
+size_t EntryCache::HashIndexHome(uint32_t key_hash) const {
+  // Spread the key hash with a multiplicative (Fibonacci) hash and use its top
+  // bits, so that hashes that differ only in their high bits do not collide.
+  const uint32_t mixed = key_hash * 2654435769u;
+  return static_cast<size_t>((uint64_t{mixed} * hash_index_.size()) >> 32);
+}
+
+size_t EntryCache::FindHashIndexSlot(uint32_t key_hash) const {
+  const size_t mask = hash_index_.size() - 1;
+  for (size_t slot = HashIndexHome(key_hash); hash_index_[slot] != 0;
+       slot = (slot + 1) & mask) {
+    if (key_hashes_.data()[hash_index_[slot] - 1] == key_hash) {
+      return slot;
+    }
+  }
+  return hash_index_.size();
+}
+
+void EntryCache::InsertIntoHashIndex(uint32_t key_hash,
+                                     size_t descriptor_index) const {
+  if (!has_hash_index()) {
+    return;
+  }
+  const size_t mask = hash_index_.size() - 1;
+  size_t slot = HashIndexHome(key_hash);
+  while (hash_index_[slot] != 0) {
+    slot = (slot + 1) & mask;
+  }
+  hash_index_[slot] = static_cast<HashIndexSlot>(descriptor_index + 1);
+}
+
+void EntryCache::RemoveFromHashIndex(uint32_t key_hash) const {
+  if (!has_hash_index()) {
+    return;
+  }
+  const size_t mask = hash_index_.size() - 1;
+  size_t empty = FindHashIndexSlot(key_hash);
+  if (empty == hash_index_.size()) {
+    return;
+  }
+
+  // Shift later entries in the probe sequence back into the freed slot, so that
+  // lookups never stop early at a hole. An entry can be moved if its home slot
+  // is not cyclically between the freed slot and its current slot.
+  for (size_t slot = (empty + 1) & mask; hash_index_[slot] != 0;
+       slot = (slot + 1) & mask) {
+    const size_t home =
+        HashIndexHome(key_hashes_.data()[hash_index_[slot] - 1]);
+    if (((slot - home) & mask) >= ((slot - empty) & mask)) {
+      hash_index_[empty] = hash_index_[slot];
+      empty = slot;
+    }
+  }
+  hash_index_[empty] = 0;
+}
+
 }  // namespace pw::kvs::internal
@@ -31,9 +31,16 @@ class EmptyEntryCache : public ::testing::Test {
   static constexpr size_t kMaxEntries = 32;
   static constexpr size_t kRedundancy = 3;
 
-  EmptyEntryCache() : entries_(descriptors_, addresses_, kRedundancy) {}
-
-  Vector<KeyDescriptor, kMaxEntries> descriptors_;
+  EmptyEntryCache()
+      : entries_(key_hashes_,
+                 transaction_ids_,
+                 states_,
+                 addresses_,
+                 kRedundancy) {}
+
+  Vector<uint32_t, kMaxEntries> key_hashes_;
+  uint32_t transaction_ids_[kMaxEntries];
+  EntryState states_[kMaxEntries];
   EntryCache::AddressList<kMaxEntries, kRedundancy> addresses_;
 
   EntryCache entries_;
@@ -109,6 +116,29 @@ TEST_F(EmptyEntryCache, AddNewOrUpdateExisting_NewEntry_Full) {
   EXPECT_EQ(kMaxEntries, entries_.total_entries());
 }
 
+TEST_F(EmptyEntryCache, AddNewOrUpdateExisting_FindsEntryAtAnyIndex) {
+  // Use enough entries that the key hash scan covers whole blocks of hashes
+  // and a partial block at the end.
+  constexpr uint32_t kEntries = 21;
+  for (uint32_t i = 0; i < kEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {i * 1000, 1, EntryState::kValid}, i, 1));
+  }
+  for (uint32_t i = 0; i < kEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {i * 1000, 2, EntryState::kDeleted}, 100 + i, 1));
+  }
+
+  EXPECT_EQ(kEntries, entries_.total_entries());
+  EXPECT_EQ(0u, entries_.present_entries());
+  for (const EntryMetadata& entry : entries_) {
+    EXPECT_EQ(2u, entry.transaction_id());
+    EXPECT_EQ(100u + entry.hash() / 1000, entry.first_address());
+  }
+}
+
 TEST_F(EmptyEntryCache, AddNewOrUpdateExisting_UpdatedEntry) {
   KeyDescriptor kd = kDescriptor;
   kd.transaction_id += 3;
@@ -194,6 +224,88 @@ TEST_F(EmptyEntryCache, Iterator_Const_CanBeAssignedFromMutable) {
   EXPECT_EQ(99u, it->first_address());
 }
 
+class HashIndexedEntryCache : public ::testing::Test {
+ protected:
+  static constexpr size_t kMaxEntries = 32;
+  static constexpr size_t kRedundancy = 1;
+
+  HashIndexedEntryCache()
+      : entries_(key_hashes_,
+                 transaction_ids_,
+                 states_,
+                 addresses_,
+                 kRedundancy,
+                 hash_index_) {}
+
+  // Adds an entry or updates an existing one; returns whether it was new.
+  bool AddOrUpdate(uint32_t key_hash, uint32_t transaction_id) {
+    const size_t before = entries_.total_entries();
+    EXPECT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {key_hash, transaction_id, EntryState::kValid}, 0, 1));
+    return entries_.total_entries() != before;
+  }
+
+  Vector<uint32_t, kMaxEntries> key_hashes_;
+  uint32_t transaction_ids_[kMaxEntries];
+  EntryState states_[kMaxEntries];
+  EntryCache::AddressList<kMaxEntries, kRedundancy> addresses_;
+  EntryCache::HashIndex<kMaxEntries> hash_index_ = {};
+
+  EntryCache entries_;
+};
+
+TEST(EntryCacheHashIndex, Size) {
+  EXPECT_EQ(2u, EntryCache::HashIndexSize(1));
+  EXPECT_EQ(64u, EntryCache::HashIndexSize(32));
+  EXPECT_EQ(128u, EntryCache::HashIndexSize(33));
+}
+
+TEST_F(HashIndexedEntryCache, FindsExistingEntries) {
+  // Hashes that differ only in their high bits must still be told apart.
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_TRUE(AddOrUpdate(i << 24, 1));
+  }
+  ASSERT_TRUE(entries_.full());
+
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    EXPECT_FALSE(AddOrUpdate(i << 24, 2));
+  }
+  for (const EntryMetadata& entry : entries_) {
+    EXPECT_EQ(2u, entry.transaction_id());
+  }
+}
+
+TEST_F(HashIndexedEntryCache, RemoveEntry_KeepsOtherEntries) {
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_TRUE(AddOrUpdate(i * 7, 1));
+  }
+
+  // Remove every entry with an odd hash. This moves descriptors from the end
+  // of the list into the removed slots.
+  for (EntryCache::iterator it = entries_.begin(); it != entries_.end();) {
+    if (it->hash() % 2 == 1) {
+      it = entries_.RemoveEntry(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_EQ(kMaxEntries / 2, entries_.total_entries());
+
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    EXPECT_EQ(i % 2 == 1, AddOrUpdate(i * 7, 2));
+  }
+  EXPECT_TRUE(entries_.full());
+}
+
+TEST_F(HashIndexedEntryCache, Reset_ClearsIndex) {
+  ASSERT_TRUE(AddOrUpdate(Hash(kTheKey), 1));
+  entries_.Reset();
+
+  EXPECT_TRUE(AddOrUpdate(Hash(kTheKey), 1));
+  EXPECT_EQ(1u, entries_.total_entries());
+}
+
 constexpr size_t kSectorSize = 64;
 constexpr uint32_t kMagic = 0xa14ae726;
 // For KVS entry magic value always use a random 32 bit integer rather than a
@@ -0,0 +1,154 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/flash_partition_with_read_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::kvs {
+
+FlashPartitionWithReadCache::FlashPartitionWithReadCache(
+    span<std::byte> buffer,
+    span<Block> blocks,
+    FlashMemory* flash,
+    uint32_t flash_start_sector_index,
+    uint32_t flash_sector_count,
+    uint32_t alignment_bytes,
+    PartitionPermission permission)
+    : FlashPartition(flash,
+                     flash_start_sector_index,
+                     flash_sector_count,
+                     alignment_bytes,
+                     permission),
+      buffer_(buffer),
+      blocks_(blocks),
+      block_size_(blocks.empty() ? 0 : buffer.size() / blocks.size()) {
+  PW_CHECK_UINT_NE(block_size_, 0u);
+  const size_t buffer_block_offset = buffer_.size() % block_size_;
+  PW_CHECK_UINT_EQ(buffer_block_offset, 0u);
+  const size_t sector_block_offset = sector_size_bytes() % block_size_;
+  PW_CHECK_UINT_EQ(sector_block_offset, 0u);
+}
+
+Status FlashPartitionWithReadCache::Erase(Address address,
+                                          size_t num_sectors) {
+  Invalidate(address, num_sectors * sector_size_bytes());
+  return FlashPartition::Erase(address, num_sectors);
+}
+
+StatusWithSize FlashPartitionWithReadCache::Read(Address address,
+                                                 span<std::byte> output) {
+  PW_TRY_WITH_SIZE(CheckBounds(address, output.size()));
+
+  size_t read = 0;
+  while (read < output.size()) {
+    const size_t block_offset = address % block_size_;
+    const Address block_address = address - block_offset;
+    const span<std::byte> remaining = output.subspan(read);
+
+    // Read runs of whole blocks that are not cached directly into the output.
+    if (block_offset == 0u && remaining.size() >= block_size_ &&
+        !IsCached(address)) {
+      size_t size = block_size_;
+      while (remaining.size() - size >= block_size_ &&
+             !IsCached(address + size)) {
+        size += block_size_;
+      }
+      const StatusWithSize result =
+          FlashPartition::Read(address, remaining.first(size));
+      if (!result.ok()) {
+        return StatusWithSize(result.status(), read);
+      }
+      address += size;
+      read += size;
+      continue;
+    }
+
+    size_t index;
+    if (Status status = Load(block_address, &index); !status.ok()) {
+      return StatusWithSize(status, read);
+    }
+    const size_t size = std::min(remaining.size(), block_size_ - block_offset);
+    std::memcpy(
+        remaining.data(), block_data(index).data() + block_offset, size);
+    address += size;
+    read += size;
+  }
+  return StatusWithSize(read);
+}
+
+StatusWithSize FlashPartitionWithReadCache::Write(Address address,
+                                                  span<const std::byte> data) {
+  // Invalidate first, since the state of the flash is unknown if the write
+  // fails.
+  Invalidate(address, data.size());
+  return FlashPartition::Write(address, data);
+}
+
+void FlashPartitionWithReadCache::Invalidate() {
+  for (Block& block : blocks_) {
+    block.last_used = 0;
+  }
+}
+
+Status FlashPartitionWithReadCache::Load(Address block_address,
+                                         size_t* index) {
+  // Blocks are stamped with a use count to find the least recently used one.
+  // Start over when the count wraps, rather than evicting the wrong blocks.
+  if (++uses_ == 0u) {
+    Invalidate();
+    uses_ = 1;
+  }
+
+  size_t oldest = 0;
+  for (size_t i = 0; i < blocks_.size(); ++i) {
+    if (blocks_[i].last_used != 0u && blocks_[i].address == block_address) {
+      blocks_[i].last_used = uses_;
+      *index = i;
+      return OkStatus();
+    }
+    if (blocks_[i].last_used < blocks_[oldest].last_used) {
+      oldest = i;
+    }
+  }
+
+  Block& block = blocks_[oldest];
+  block.last_used = 0;
+  PW_TRY(FlashPartition::Read(block_address, block_data(oldest)).status());
+  block.address = block_address;
+  block.last_used = uses_;
+  *index = oldest;
+  return OkStatus();
+}
+
+bool FlashPartitionWithReadCache::IsCached(Address block_address) const {
+  return std::any_of(blocks_.begin(), blocks_.end(), [&](const Block& block) {
+    return block.last_used != 0u && block.address == block_address;
+  });
+}
+
+void FlashPartitionWithReadCache::Invalidate(Address address, size_t size) {
+  for (Block& block : blocks_) {
+    if (block.address < address + size &&
+        address < block.address + block_size_) {
+      block.last_used = 0;
+    }
+  }
+}
+
+}  // namespace pw::kvs
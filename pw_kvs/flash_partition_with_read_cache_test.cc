@@ -0,0 +1,211 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/flash_partition_with_read_cache.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kSectorSize = 1024;
+constexpr size_t kSectorCount = 4;
+constexpr size_t kAlignment = 16;
+constexpr size_t kBlockSize = 64;
+constexpr size_t kBlockCount = 4;
+
+// Counts the read operations that reach the flash.
+class CountingFlashMemory
+    : public FakeFlashMemoryBuffer<kSectorSize, kSectorCount> {
+ public:
+  CountingFlashMemory()
+      : FakeFlashMemoryBuffer<kSectorSize, kSectorCount>(kAlignment) {}
+
+  StatusWithSize Read(Address address, span<std::byte> output) override {
+    reads += 1;
+    return FakeFlashMemory::Read(address, output);
+  }
+
+  size_t reads = 0;
+};
+
+class FlashPartitionWithReadCacheTest : public ::testing::Test {
+ protected:
+  FlashPartitionWithReadCacheTest() : partition_(&flash_) {
+    for (size_t i = 0; i < data_.size(); ++i) {
+      data_[i] = static_cast<std::byte>(i);
+    }
+    EXPECT_EQ(partition_.Write(0, data_).status(), OkStatus());
+    flash_.reads = 0;
+  }
+
+  // Checks the data read through the partition against data_.
+  void ExpectData(FlashPartition::Address address, size_t size) {
+    std::array<std::byte, kSectorSize> read{};
+    ASSERT_EQ(partition_.Read(address, span(read).first(size)).status(),
+              OkStatus());
+    EXPECT_EQ(std::memcmp(read.data(), data_.data() + address, size), 0);
+  }
+
+  CountingFlashMemory flash_;
+  FlashPartitionWithReadCacheBuffer<kBlockSize, kBlockCount> partition_;
+  std::array<std::byte, kSectorSize * kSectorCount> data_;
+};
+
+TEST_F(FlashPartitionWithReadCacheTest, RepeatedReadsHitCache) {
+  ExpectData(8, 16);
+  EXPECT_EQ(flash_.reads, 1u);
+
+  ExpectData(8, 16);
+  ExpectData(0, 4);
+  ExpectData(40, 24);
+  EXPECT_EQ(flash_.reads, 1u);
+}
+
+TEST_F(FlashPartitionWithReadCacheTest, ReadSpanningBlocks) {
+  ExpectData(48, 32);
+  EXPECT_EQ(flash_.reads, 2u);
+
+  ExpectData(0, 2 * kBlockSize);
+  EXPECT_EQ(flash_.reads, 2u);
+}
+
+TEST_F(FlashPartitionWithReadCacheTest, EvictsLeastRecentlyUsedBlock) {
+  for (size_t i = 0; i < kBlockCount; ++i) {
+    ExpectData(i * kBlockSize, 8);
+  }
+  EXPECT_EQ(flash_.reads, kBlockCount);
+
+  // Use the first block again, so the second one is evicted next.
+  ExpectData(0, 8);
+  ExpectData(kBlockCount * kBlockSize, 8);
+  EXPECT_EQ(flash_.reads, kBlockCount + 1);
+
+  ExpectData(0, 8);
+  EXPECT_EQ(flash_.reads, kBlockCount + 1);
+  ExpectData(kBlockSize, 8);
+  EXPECT_EQ(flash_.reads, kBlockCount + 2);
+}
+
+TEST_F(FlashPartitionWithReadCacheTest, WholeBlocksAreReadDirectly) {
+  ExpectData(kBlockSize, 8);
+  EXPECT_EQ(flash_.reads, 1u);
+
+  // Blocks 0 and 2 to 5 are read directly, and block 1 comes from the cache.
+  ExpectData(0, 6 * kBlockSize);
+  EXPECT_EQ(flash_.reads, 3u);
+
+  // The directly read blocks were not cached.
+  ExpectData(2 * kBlockSize, 8);
+  EXPECT_EQ(flash_.reads, 4u);
+}
+
+TEST_F(FlashPartitionWithReadCacheTest, WriteInvalidatesBlock) {
+  ASSERT_EQ(partition_.Erase(kSectorSize, 1), OkStatus());
+  std::memset(data_.data() + kSectorSize,
+              static_cast<int>(FakeFlashMemory::kErasedValue),
+              kSectorSize);
+  ExpectData(kSectorSize, 64);
+  EXPECT_EQ(flash_.reads, 1u);
+
+  for (size_t i = 0; i < 16; ++i) {
+    data_[kSectorSize + 16 + i] = std::byte{0x5a};
+  }
+  const span<const std::byte> written =
+      span(data_).subspan(kSectorSize + 16, 16);
+  ASSERT_EQ(partition_.Write(kSectorSize + 16, written).status(), OkStatus());
+  ExpectData(kSectorSize, 64);
+  EXPECT_EQ(flash_.reads, 2u);
+}
+
+TEST_F(FlashPartitionWithReadCacheTest, EraseInvalidatesBlocks) {
+  ExpectData(0, 8);
+  ExpectData(kSectorSize, 8);
+  ASSERT_EQ(partition_.Erase(0, 1), OkStatus());
+
+  std::array<std::byte, 8> read{};
+  ASSERT_EQ(partition_.Read(0, read).status(), OkStatus());
+  for (std::byte b : read) {
+    EXPECT_EQ(b, FakeFlashMemory::kErasedValue);
+  }
+
+  // Blocks in other sectors stay cached.
+  const size_t reads = flash_.reads;
+  ExpectData(kSectorSize, 8);
+  EXPECT_EQ(flash_.reads, reads);
+}
+
+TEST_F(FlashPartitionWithReadCacheTest, ReadErrorIsNotCached) {
+  ASSERT_TRUE(
+      flash_.InjectReadError(FlashError::Unconditional(Status::DataLoss(), 1)));
+  std::array<std::byte, 8> read{};
+  EXPECT_EQ(partition_.Read(0, read).status(), Status::DataLoss());
+
+  ExpectData(0, 8);
+  EXPECT_EQ(flash_.reads, 2u);
+}
+
+TEST_F(FlashPartitionWithReadCacheTest, OutOfRange) {
+  std::array<std::byte, 8> read{};
+  EXPECT_EQ(partition_.Read(partition_.size_bytes() - 4, read).status(),
+            Status::OutOfRange());
+  EXPECT_EQ(flash_.reads, 0u);
+}
+
+TEST_F(FlashPartitionWithReadCacheTest, KeyValueStore) {
+  ChecksumCrc16 checksum;
+  const EntryFormat kFormat{.magic = 0x5a1c6e0d, .checksum = &checksum};
+  ASSERT_EQ(partition_.Erase(), OkStatus());
+
+  size_t uncached_reads = 0;
+  {
+    KeyValueStoreBuffer<16, kSectorCount> kvs(&partition_, kFormat);
+    ASSERT_EQ(kvs.Init(), OkStatus());
+    for (uint32_t i = 0; i < 8; ++i) {
+      ASSERT_EQ(kvs.Put("key", i), OkStatus());
+    }
+  }
+
+  {
+    FlashPartition uncached(&flash_);
+    KeyValueStoreBuffer<16, kSectorCount> kvs(&uncached, kFormat);
+    flash_.reads = 0;
+    ASSERT_EQ(kvs.Init(), OkStatus());
+    uint32_t value = 0;
+    ASSERT_EQ(kvs.Get("key", &value), OkStatus());
+    EXPECT_EQ(value, 7u);
+    uncached_reads = flash_.reads;
+  }
+
+  partition_.Invalidate();
+  KeyValueStoreBuffer<16, kSectorCount> kvs(&partition_, kFormat);
+  flash_.reads = 0;
+  ASSERT_EQ(kvs.Init(), OkStatus());
+  uint32_t value = 0;
+  ASSERT_EQ(kvs.Get("key", &value), OkStatus());
+  EXPECT_EQ(value, 7u);
+  EXPECT_LT(flash_.reads, uncached_reads);
+}
+
+}  // namespace
+}  // namespace pw::kvs
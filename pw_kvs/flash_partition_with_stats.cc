@@ -18,12 +18,28 @@
 #include "pw_kvs/flash_partition_with_stats.h"
 
 #include <cstdio>
+#include <cstdlib>
 
 #include "pw_kvs/flash_memory.h"
 #include "pw_kvs_private/config.h"
 #include "pw_log/log.h"
 
 namespace pw::kvs {
+namespace {
+
+// Returns the directory to save stats in, so that running tests does not leave
+// files in the working directory, which may be the source tree.
+const char* StatsDirectory() {
+  for (const char* variable : {"TEST_UNDECLARED_OUTPUTS_DIR", "TMPDIR"}) {
+    const char* directory = std::getenv(variable);
+    if (directory != nullptr && directory[0] != '\0') {
+      return directory;
+    }
+  }
+  return "/tmp";
+}
+
+}  // namespace
 
 Status FlashPartitionWithStats::SaveStorageStats(const KeyValueStore& kvs,
                                                  const char* label) {
@@ -35,7 +51,13 @@ Status FlashPartitionWithStats::SaveStorageStats(const KeyValueStore& kvs,
   KeyValueStore::StorageStats stats = kvs.GetStorageStats();
   size_t utilization_percentage = (stats.in_use_bytes * 100) / size_bytes();
 
-  const char* file_name = "flash_stats.csv";
+  char file_name[256];
+  const int length = std::snprintf(
+      file_name, sizeof(file_name), "%s/flash_stats.csv", StatsDirectory());
+  if (length < 0 || static_cast<size_t>(length) >= sizeof(file_name)) {
+    PW_LOG_ERROR("Stats file path is too long");
+    return Status::ResourceExhausted();
+  }
   std::FILE* out_file = std::fopen(file_name, "a+");
   if (out_file == nullptr) {
     PW_LOG_ERROR("Failed to dump to %s", file_name);
@@ -0,0 +1,161 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/flash_partition_with_write_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::kvs {
+
+FlashPartitionWithWriteCache::FlashPartitionWithWriteCache(
+    span<std::byte> page_buffer,
+    FlashMemory* flash,
+    uint32_t flash_start_sector_index,
+    uint32_t flash_sector_count,
+    uint32_t alignment_bytes,
+    PartitionPermission permission)
+    : FlashPartition(flash,
+                     flash_start_sector_index,
+                     flash_sector_count,
+                     alignment_bytes,
+                     permission),
+      page_(page_buffer) {
+  PW_CHECK_UINT_NE(page_.size(), 0u);
+  const size_t page_alignment_offset = page_.size() % this->alignment_bytes();
+  PW_CHECK_UINT_EQ(page_alignment_offset, 0u);
+  const size_t sector_page_offset = sector_size_bytes() % page_.size();
+  PW_CHECK_UINT_EQ(sector_page_offset, 0u);
+}
+
+Status FlashPartitionWithWriteCache::Erase(Address address,
+                                           size_t num_sectors) {
+  if (cached_bytes() != 0u) {
+    const bool erases_cache =
+        page_address_ >= address &&
+        page_address_ < address + num_sectors * sector_size_bytes();
+    if (erases_cache) {
+      cache_start_ = cache_end_ = 0;
+    } else {
+      PW_TRY(Flush());
+    }
+  }
+  return FlashPartition::Erase(address, num_sectors);
+}
+
+StatusWithSize FlashPartitionWithWriteCache::Read(Address address,
+                                                  span<std::byte> output) {
+  const StatusWithSize result = FlashPartition::Read(address, output);
+  if (!result.ok() || cached_bytes() == 0u) {
+    return result;
+  }
+
+  // The cached bytes are still erased in flash, so replace them with the
+  // cached data.
+  const size_t begin = std::max<size_t>(address, page_address_ + cache_start_);
+  const size_t end =
+      std::min<size_t>(address + output.size(), page_address_ + cache_end_);
+  if (begin < end) {
+    std::memcpy(output.data() + (begin - address),
+                page_.data() + (begin - page_address_),
+                end - begin);
+  }
+  return result;
+}
+
+StatusWithSize FlashPartitionWithWriteCache::Write(Address address,
+                                                   span<const std::byte> data) {
+  if (!writable()) {
+    return StatusWithSize::PermissionDenied();
+  }
+  PW_TRY_WITH_SIZE(CheckBounds(address, data.size()));
+  const size_t address_alignment_offset = address % alignment_bytes();
+  PW_CHECK_UINT_EQ(address_alignment_offset, 0u);
+  const size_t size_alignment_offset = data.size() % alignment_bytes();
+  PW_CHECK_UINT_EQ(size_alignment_offset, 0u);
+
+  size_t written = 0;
+  while (written < data.size()) {
+    const size_t page_offset = address % page_.size();
+
+    // Only a contiguous run of data is cached, so program the cache before
+    // writing anywhere else.
+    if (cached_bytes() != 0u && (address - page_offset != page_address_ ||
+                                 page_offset != cache_end_)) {
+      if (Status status = Flush(); !status.ok()) {
+        return StatusWithSize(status, written);
+      }
+    }
+
+    const span<const std::byte> remaining = data.subspan(written);
+
+    // Whole pages are programmed directly rather than copied.
+    if (cached_bytes() == 0u && page_offset == 0u &&
+        remaining.size() >= page_.size()) {
+      const size_t size = remaining.size() - remaining.size() % page_.size();
+      const StatusWithSize result =
+          FlashPartition::Write(address, remaining.first(size));
+      if (!result.ok()) {
+        return StatusWithSize(result.status(), written);
+      }
+      address += size;
+      written += size;
+      continue;
+    }
+
+    if (cached_bytes() == 0u) {
+      StartCaching(address);
+    }
+
+    const size_t size = std::min(remaining.size(), page_.size() - page_offset);
+    std::memcpy(page_.data() + page_offset, remaining.data(), size);
+    cache_end_ += size;
+    address += size;
+    written += size;
+
+    if (cache_end_ == page_.size()) {
+      if (Status status = Flush(); !status.ok()) {
+        return StatusWithSize(status, written);
+      }
+    }
+  }
+  return StatusWithSize(written);
+}
+
+Status FlashPartitionWithWriteCache::Flush() {
+  if (cached_bytes() == 0u) {
+    return OkStatus();
+  }
+
+  const span<const std::byte> cached =
+      page_.subspan(cache_start_, cached_bytes());
+  const Address address = page_address_ + cache_start_;
+
+  // Discard the cache even if the write fails, since the state of the flash
+  // is unknown.
+  cache_start_ = cache_end_ = 0;
+  return FlashPartition::Write(address, cached).status();
+}
+
+void FlashPartitionWithWriteCache::StartCaching(Address address) {
+  const size_t page_offset = address % page_.size();
+  page_address_ = address - page_offset;
+  cache_start_ = page_offset;
+  cache_end_ = page_offset;
+}
+
+}  // namespace pw::kvs
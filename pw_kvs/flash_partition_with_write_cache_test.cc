@@ -0,0 +1,256 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/flash_partition_with_write_cache.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kSectorSize = 1024;
+constexpr size_t kSectorCount = 4;
+constexpr size_t kAlignment = 16;
+constexpr size_t kPageSize = 256;
+
+// Counts the program operations that reach the flash.
+class CountingFlashMemory
+    : public FakeFlashMemoryBuffer<kSectorSize, kSectorCount> {
+ public:
+  CountingFlashMemory()
+      : FakeFlashMemoryBuffer<kSectorSize, kSectorCount>(kAlignment) {}
+
+  StatusWithSize Write(Address address, span<const std::byte> data) override {
+    writes += 1;
+    return FakeFlashMemory::Write(address, data);
+  }
+
+  size_t writes = 0;
+};
+
+class FlashPartitionWithWriteCacheTest : public ::testing::Test {
+ protected:
+  FlashPartitionWithWriteCacheTest() : partition_(&flash_) {
+    for (size_t i = 0; i < data_.size(); ++i) {
+      data_[i] = static_cast<std::byte>(i);
+    }
+  }
+
+  span<const std::byte> data(size_t offset, size_t size) const {
+    return span(data_).subspan(offset, size);
+  }
+
+  // Checks the partition contents against data_ through the partition and the
+  // flash.
+  void ExpectData(FlashPartition::Address address, size_t size) {
+    std::array<std::byte, kSectorSize> read{};
+    ASSERT_EQ(partition_.Read(address, span(read).first(size)).status(),
+              OkStatus());
+    EXPECT_EQ(std::memcmp(read.data(), data_.data() + address, size), 0);
+  }
+
+  bool FlashContains(FlashPartition::Address address, size_t size) const {
+    return std::memcmp(flash_.buffer().data() + address,
+                       data_.data() + address,
+                       size) == 0;
+  }
+
+  CountingFlashMemory flash_;
+  FlashPartitionWithWriteCacheBuffer<kPageSize> partition_;
+  std::array<std::byte, kSectorSize * kSectorCount> data_;
+};
+
+TEST_F(FlashPartitionWithWriteCacheTest, AdjacentWritesProgramOnePage) {
+  for (size_t offset = 0; offset < kPageSize; offset += kAlignment) {
+    ASSERT_EQ(partition_.Write(offset, data(offset, kAlignment)).status(),
+              OkStatus());
+    if (offset + kAlignment < kPageSize) {
+      EXPECT_EQ(flash_.writes, 0u);
+      EXPECT_EQ(partition_.cached_bytes(), offset + kAlignment);
+    }
+  }
+
+  EXPECT_EQ(flash_.writes, 1u);
+  EXPECT_EQ(partition_.cached_bytes(), 0u);
+  EXPECT_TRUE(FlashContains(0, kPageSize));
+}
+
+TEST_F(FlashPartitionWithWriteCacheTest, ReadsReturnCachedData) {
+  ASSERT_EQ(partition_.Write(32, data(32, 48)).status(), OkStatus());
+  EXPECT_EQ(flash_.writes, 0u);
+
+  ExpectData(32, 48);
+
+  // Reads that partly overlap the cache combine flash and cached data.
+  std::array<std::byte, 64> read{};
+  ASSERT_EQ(partition_.Read(0, read).status(), OkStatus());
+  for (size_t i = 0; i < 32; ++i) {
+    EXPECT_EQ(read[i], FakeFlashMemory::kErasedValue);
+  }
+  EXPECT_EQ(std::memcmp(read.data() + 32, data_.data() + 32, 32), 0);
+
+  bool is_erased = true;
+  ASSERT_EQ(partition_.IsRegionErased(32, 16, &is_erased), OkStatus());
+  EXPECT_FALSE(is_erased);
+}
+
+TEST_F(FlashPartitionWithWriteCacheTest, FlushProgramsPartialPage) {
+  ASSERT_EQ(partition_.Write(64, data(64, 32)).status(), OkStatus());
+  EXPECT_FALSE(FlashContains(64, 32));
+
+  ASSERT_EQ(partition_.Flush(), OkStatus());
+  EXPECT_EQ(flash_.writes, 1u);
+  EXPECT_EQ(partition_.cached_bytes(), 0u);
+  EXPECT_TRUE(FlashContains(64, 32));
+
+  // The rest of the page can still be written.
+  ASSERT_EQ(partition_.Write(96, data(96, 16)).status(), OkStatus());
+  ASSERT_EQ(partition_.Flush(), OkStatus());
+  EXPECT_EQ(flash_.writes, 2u);
+  ExpectData(64, 48);
+
+  // Flushing an empty cache does nothing.
+  ASSERT_EQ(partition_.Flush(), OkStatus());
+  EXPECT_EQ(flash_.writes, 2u);
+}
+
+TEST_F(FlashPartitionWithWriteCacheTest, NonAdjacentWriteProgramsCache) {
+  ASSERT_EQ(partition_.Write(0, data(0, 16)).status(), OkStatus());
+  ASSERT_EQ(partition_.Write(48, data(48, 16)).status(), OkStatus());
+  EXPECT_EQ(flash_.writes, 1u);
+  EXPECT_TRUE(FlashContains(0, 16));
+
+  ASSERT_EQ(partition_.Write(512, data(512, 16)).status(), OkStatus());
+  EXPECT_EQ(flash_.writes, 2u);
+  EXPECT_TRUE(FlashContains(48, 16));
+
+  ASSERT_EQ(partition_.Flush(), OkStatus());
+  ExpectData(0, 16);
+  ExpectData(48, 16);
+  ExpectData(512, 16);
+}
+
+TEST_F(FlashPartitionWithWriteCacheTest, WritesAcrossPages) {
+  // Fill the end of one page, two whole pages, and the start of another.
+  ASSERT_EQ(partition_.Write(224, data(224, 32)).status(), OkStatus());
+  EXPECT_EQ(flash_.writes, 1u);
+
+  const StatusWithSize result =
+      partition_.Write(256, data(256, 2 * kPageSize + 64));
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 2 * kPageSize + 64);
+
+  // The whole pages are programmed directly in one write.
+  EXPECT_EQ(flash_.writes, 2u);
+  EXPECT_EQ(partition_.cached_bytes(), 64u);
+
+  ASSERT_EQ(partition_.Flush(), OkStatus());
+  EXPECT_EQ(flash_.writes, 3u);
+  ExpectData(224, 32 + 2 * kPageSize + 64);
+}
+
+TEST_F(FlashPartitionWithWriteCacheTest, WriteSpanningCachedPage) {
+  ASSERT_EQ(partition_.Write(192, data(192, 16)).status(), OkStatus());
+  ASSERT_EQ(partition_.Write(208, data(208, 96)).status(), OkStatus());
+
+  // The first page is programmed once it fills, and the rest is cached.
+  EXPECT_EQ(flash_.writes, 1u);
+  EXPECT_EQ(partition_.cached_bytes(), 48u);
+  ExpectData(192, 112);
+}
+
+TEST_F(FlashPartitionWithWriteCacheTest, EraseProgramsCacheInOtherSectors) {
+  ASSERT_EQ(partition_.Write(0, data(0, 16)).status(), OkStatus());
+  ASSERT_EQ(partition_.Erase(kSectorSize, 1), OkStatus());
+  EXPECT_EQ(flash_.writes, 1u);
+  EXPECT_TRUE(FlashContains(0, 16));
+}
+
+TEST_F(FlashPartitionWithWriteCacheTest, EraseDiscardsCacheInErasedSector) {
+  ASSERT_EQ(partition_.Write(kSectorSize, data(kSectorSize, 16)).status(),
+            OkStatus());
+  ASSERT_EQ(partition_.Erase(kSectorSize, 1), OkStatus());
+  EXPECT_EQ(flash_.writes, 0u);
+  EXPECT_EQ(partition_.cached_bytes(), 0u);
+
+  bool is_erased = false;
+  ASSERT_EQ(partition_.IsRegionErased(kSectorSize, kSectorSize, &is_erased),
+            OkStatus());
+  EXPECT_TRUE(is_erased);
+}
+
+TEST_F(FlashPartitionWithWriteCacheTest, FlushErrorDiscardsCache) {
+  ASSERT_TRUE(
+      flash_.InjectWriteError(FlashError::Unconditional(Status::DataLoss())));
+  ASSERT_EQ(partition_.Write(0, data(0, 16)).status(), OkStatus());
+  EXPECT_EQ(partition_.Flush(), Status::DataLoss());
+  EXPECT_EQ(partition_.cached_bytes(), 0u);
+}
+
+TEST_F(FlashPartitionWithWriteCacheTest, ReadOnly) {
+  FlashPartitionWithWriteCacheBuffer<kPageSize> read_only(
+      &flash_, 0, kSectorCount, 0, PartitionPermission::kReadOnly);
+  EXPECT_EQ(read_only.Write(0, data(0, 16)).status(),
+            Status::PermissionDenied());
+}
+
+TEST_F(FlashPartitionWithWriteCacheTest, KeyValueStore) {
+  ChecksumCrc16 checksum;
+  const EntryFormat kFormat{.magic = 0x5a1c6e0d, .checksum = &checksum};
+
+  size_t uncached_writes = 0;
+  {
+    CountingFlashMemory uncached_flash;
+    FlashPartition uncached(&uncached_flash);
+    KeyValueStoreBuffer<16, kSectorCount> kvs(&uncached, kFormat);
+    ASSERT_EQ(kvs.Init(), OkStatus());
+    for (uint32_t i = 0; i < 8; ++i) {
+      ASSERT_EQ(kvs.Put("key", i), OkStatus());
+    }
+    uncached_writes = uncached_flash.writes;
+  }
+
+  {
+    KeyValueStoreBuffer<16, kSectorCount> kvs(&partition_, kFormat);
+    ASSERT_EQ(kvs.Init(), OkStatus());
+    for (uint32_t i = 0; i < 8; ++i) {
+      ASSERT_EQ(kvs.Put("key", i), OkStatus());
+    }
+
+    uint32_t value = 0;
+    ASSERT_EQ(kvs.Get("key", &value), OkStatus());
+    EXPECT_EQ(value, 7u);
+    ASSERT_EQ(partition_.Flush(), OkStatus());
+  }
+  EXPECT_LT(flash_.writes, uncached_writes);
+
+  // A new KVS finds the flushed entries.
+  KeyValueStoreBuffer<16, kSectorCount> kvs(&partition_, kFormat);
+  ASSERT_EQ(kvs.Init(), OkStatus());
+  uint32_t value = 0;
+  ASSERT_EQ(kvs.Get("key", &value), OkStatus());
+  EXPECT_EQ(value, 7u);
+}
+
+}  // namespace
+}  // namespace pw::kvs
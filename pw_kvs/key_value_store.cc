@@ -23,6 +23,8 @@
 #include <type_traits>
 
 #include "pw_assert/check.h"
+#include "pw_checksum/crc32.h"
+#include "pw_kvs/alignment.h"
 #include "pw_kvs_private/config.h"
 #include "pw_log/shorter.h"
 #include "pw_status/try.h"
@@ -36,20 +38,152 @@ constexpr bool InvalidKey(Key key) {
   return key.empty() || (key.size() > internal::Entry::kMaxKeyLength);
 }
 
+// The index checkpoint is laid out as this header, followed by the write
+// offset of each sector as a uint32_t, then each key descriptor as its hash,
+// transaction ID, and state, followed by `redundancy` addresses. A CRC32 of
+// everything before it ends the checkpoint.
+struct IndexCheckpointHeader {
+  uint32_t magic;
+  uint32_t sector_size_bytes;
+  uint32_t sector_count;
+  uint32_t redundancy;
+  uint32_t entry_count;
+};
+
+// Like entry magics, this is a random 32 bit integer.
+constexpr uint32_t kIndexCheckpointMagic = 0x6b1e9d3c;
+
+constexpr FlashPartition::Address kNoCheckpointAddress =
+    FlashPartition::Address(-1);
+
+constexpr FlashPartition::Address kNoViewAddress = FlashPartition::Address(-1);
+
+constexpr size_t IndexCheckpointSize(size_t sector_count,
+                                     size_t entry_count,
+                                     size_t redundancy) {
+  return sizeof(IndexCheckpointHeader) + sector_count * sizeof(uint32_t) +
+         entry_count * (3 + redundancy) * sizeof(uint32_t) + sizeof(uint32_t);
+}
+
+// Batches are written through a buffer this size, so that small entries share
+// flash writes.
+constexpr size_t kBatchWriteBufferSize =
+    std::max(kMaxFlashAlignment, 4 * internal::Entry::kMinAlignmentBytes);
+
+// Failed copies are tracked in a bitmask, so the RedundantWriter is only used
+// for up to this many copies.
+constexpr size_t kMaxConcurrentCopies = 32;
+
+// Writes each chunk of an entry to every copy's address. The writes of a chunk
+// are all started before any is waited on, so they may program concurrently. A
+// copy that fails is not written again; the output only fails when every copy
+// has.
+class RedundantOutput final : public Output {
+ public:
+  RedundantOutput(KeyValueStore::RedundantWriter& writer,
+                  FlashPartition& partition,
+                  span<const FlashPartition::Address> addresses)
+      : writer_(writer),
+        partition_(partition),
+        addresses_(addresses),
+        offset_(0),
+        failed_copies_(0) {}
+
+  // Returns the first error of a copy, or OK if it was written.
+  Status status(size_t copy) const {
+    return failed(copy) ? first_error_ : OkStatus();
+  }
+
+ private:
+  StatusWithSize DoWrite(span<const std::byte> data) override {
+    size_t first_pending = 0;
+    for (size_t i = 0; i < addresses_.size(); ++i) {
+      if (failed(i)) {
+        continue;
+      }
+      const FlashPartition::Address address = addresses_[i] + offset_;
+      Status status = writer_.StartWrite(partition_, address, data);
+      if (status.IsUnavailable()) {
+        // The flash cannot run this write alongside the others, so let them
+        // finish first.
+        WaitForWrites(first_pending, i);
+        first_pending = i;
+        status = writer_.StartWrite(partition_, address, data);
+      }
+      Fail(i, status);
+    }
+    WaitForWrites(first_pending, addresses_.size());
+    offset_ += data.size();
+
+    for (size_t i = 0; i < addresses_.size(); ++i) {
+      if (!failed(i)) {
+        return StatusWithSize(data.size());
+      }
+    }
+    return StatusWithSize(first_error_, 0);
+  }
+
+  // Waits for the writes that were started for copies in [begin, end). Copies
+  // whose write did not start are already marked failed.
+  void WaitForWrites(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      if (!failed(i)) {
+        Fail(i, writer_.WaitForWrite());
+      }
+    }
+  }
+
+  bool failed(size_t copy) const { return (failed_copies_ >> copy) & 1u; }
+
+  void Fail(size_t copy, Status status) {
+    if (status.ok()) {
+      return;
+    }
+    if (failed_copies_ == 0u) {
+      first_error_ = status;
+    }
+    failed_copies_ |= uint32_t{1} << copy;
+  }
+
+  KeyValueStore::RedundantWriter& writer_;
+  FlashPartition& partition_;
+  const span<const FlashPartition::Address> addresses_;
+  size_t offset_;
+  uint32_t failed_copies_;
+  Status first_error_;
+};
+
 }  // namespace
 
-KeyValueStore::KeyValueStore(FlashPartition* partition,
-                             span<const EntryFormat> formats,
-                             const Options& options,
-                             size_t redundancy,
-                             Vector<SectorDescriptor>& sector_descriptor_list,
-                             const SectorDescriptor** temp_sectors_to_skip,
-                             Vector<KeyDescriptor>& key_descriptor_list,
-                             Address* addresses)
+KeyValueStore::KeyValueStore(
+    FlashPartition* partition,
+    span<const EntryFormat> formats,
+    const Options& options,
+    size_t redundancy,
+    Vector<SectorDescriptor>& sector_descriptor_list,
+    const SectorDescriptor** temp_sectors_to_skip,
+    Vector<uint32_t>& key_hash_list,
+    uint32_t* transaction_ids,
+    internal::EntryState* entry_states,
+    Address* addresses,
+    span<internal::EntryCache::HashIndexSlot> hash_index)
     : partition_(*partition),
       formats_(formats),
       sectors_(sector_descriptor_list, *partition, temp_sectors_to_skip),
-      entry_cache_(key_descriptor_list, addresses, redundancy),
+      incremental_gc_sector_(nullptr),
+      index_checkpoint_partition_(nullptr),
+      index_checkpoint_in_flash_(false),
+      redundant_writer_(nullptr),
+      entries_verified_(false),
+      verified_view_address_(kNoViewAddress),
+      verified_view_transaction_id_(0),
+      verified_view_key_hash_(0),
+      entry_cache_(key_hash_list,
+                   transaction_ids,
+                   entry_states,
+                   addresses,
+                   redundancy,
+                   hash_index),
       options_(options),
       initialized_(InitializationState::kNotInitialized),
       error_detected_(false),
@@ -60,6 +194,8 @@ Status KeyValueStore::Init() {
   initialized_ = InitializationState::kNotInitialized;
   error_detected_ = false;
   last_transaction_id_ = 0;
+  incremental_gc_sector_ = nullptr;
+  verified_view_address_ = kNoViewAddress;
 
   INF("Initializing key value store");
   if (partition_.sector_count() > sectors_.max_size()) {
@@ -143,6 +279,23 @@ Status KeyValueStore::InitializeMetadata() {
   sectors_.Reset();
   entry_cache_.Reset();
 
+  // Entries loaded from an index checkpoint are not verified.
+  entries_verified_ = options_.verify_on_write;
+
+  if (index_checkpoint_partition_ != nullptr) {
+    Status checkpoint_status = LoadIndexCheckpoint();
+    if (checkpoint_status.ok()) {
+      entries_verified_ = false;
+      INF("Loaded index checkpoint with %u entries",
+          unsigned(entry_cache_.total_entries()));
+    } else {
+      DBG("No usable index checkpoint (%s); reading all entries",
+          checkpoint_status.str());
+      sectors_.Reset();
+      entry_cache_.Reset();
+    }
+  }
+
   DBG("First pass: Read all entries from all sectors");
   Address sector_address = 0;
 
@@ -152,9 +305,15 @@ Status KeyValueStore::InitializeMetadata() {
   size_t entry_copies_missing = 0;
 
   for (SectorDescriptor& sector : sectors_) {
-    Address entry_address = sector_address;
+    LoadSectorHeader(sector);
+
+    // Start after the sector header and the entries that were loaded from the
+    // index checkpoint, if any.
+    Address entry_address =
+        sector_address + (sector_size_bytes - sector.writable_bytes());
 
     size_t sector_corrupt_bytes = 0;
+    PendingBatch pending_batch = {};
 
     for (int num_entries_in_sector = 0; true; num_entries_in_sector++) {
       DBG("Load entry: sector=%u, entry#=%d, address=%u",
@@ -168,7 +327,8 @@ Status KeyValueStore::InitializeMetadata() {
       }
 
       Address next_entry_address;
-      Status status = LoadEntry(entry_address, &next_entry_address);
+      Status status =
+          LoadEntry(entry_address, &next_entry_address, pending_batch);
       if (status.IsNotFound()) {
         DBG("Hit un-written data in sector; moving to the next sector");
         break;
@@ -177,6 +337,7 @@ Status KeyValueStore::InitializeMetadata() {
         // the sector. Try to scan the remainder of the sector for other
         // entries.
 
+        DiscardIncompleteBatch(pending_batch);
         error_detected_ = true;
         corrupt_entries++;
 
@@ -203,6 +364,10 @@ Status KeyValueStore::InitializeMetadata() {
                                 (entry_address - sector_address));
     }
 
+    // A batch that is not complete at the end of the written part of the
+    // sector was interrupted while it was written.
+    DiscardIncompleteBatch(pending_batch);
+
     if (sector_corrupt_bytes > 0) {
       // If the sector contains corrupt data, prevent any further entries from
       // being written to it by indicating that it has no space. This should
@@ -298,6 +463,165 @@ Status KeyValueStore::InitializeMetadata() {
   return OkStatus();
 }
 
+Status KeyValueStore::LoadIndexCheckpoint() {
+  FlashPartition::Input input(*index_checkpoint_partition_, 0);
+  checksum::Crc32 crc;
+  auto read = [&input, &crc](auto& value) -> Status {
+    span<byte> bytes = as_writable_bytes(span(&value, 1));
+    PW_TRY(input.Read(bytes).status());
+    crc.Update(bytes);
+    return OkStatus();
+  };
+
+  IndexCheckpointHeader header;
+  PW_TRY(read(header));
+  if (header.magic != kIndexCheckpointMagic) {
+    index_checkpoint_in_flash_ = false;
+    return Status::NotFound();
+  }
+  index_checkpoint_in_flash_ = true;
+
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  if (header.sector_size_bytes != sector_size_bytes ||
+      header.sector_count != sectors_.size() ||
+      header.redundancy != redundancy() ||
+      header.entry_count > entry_cache_.max_entries()) {
+    return Status::FailedPrecondition();
+  }
+  if (IndexCheckpointSize(
+          header.sector_count, header.entry_count, header.redundancy) >
+      index_checkpoint_partition_->size_bytes()) {
+    return Status::DataLoss();
+  }
+
+  for (SectorDescriptor& sector : sectors_) {
+    uint32_t write_offset;
+    PW_TRY(read(write_offset));
+    if (write_offset > sector_size_bytes) {
+      return Status::DataLoss();
+    }
+    sector.set_writable_bytes(sector_size_bytes - write_offset);
+  }
+
+  for (uint32_t i = 0; i < header.entry_count; ++i) {
+    uint32_t key_hash;
+    uint32_t transaction_id;
+    uint32_t deleted;
+    Address address;
+    PW_TRY(read(key_hash));
+    PW_TRY(read(transaction_id));
+    PW_TRY(read(deleted));
+    PW_TRY(read(address));
+    if (address == kNoCheckpointAddress) {
+      return Status::DataLoss();
+    }
+
+    EntryMetadata metadata = entry_cache_.AddNew(
+        {.key_hash = key_hash,
+         .transaction_id = transaction_id,
+         .state = deleted != 0 ? EntryState::kDeleted : EntryState::kValid},
+        address);
+    for (size_t j = 1; j < redundancy(); ++j) {
+      PW_TRY(read(address));
+      if (address != kNoCheckpointAddress) {
+        metadata.AddNewAddress(address);
+      }
+    }
+  }
+
+  const uint32_t expected_checksum = crc.value();
+  uint32_t checksum;
+  PW_TRY(input.Read(&checksum, sizeof(checksum)).status());
+  if (checksum != expected_checksum) {
+    return Status::DataLoss();
+  }
+
+  // The KVS partition may have been erased or rewritten without going through
+  // the KVS, so make sure the entries are still where the checkpoint says.
+  for (const EntryMetadata& metadata : entry_cache_) {
+    for (Address entry_address : metadata.addresses()) {
+      Entry entry;
+      PW_TRY(Entry::Read(partition_, entry_address, formats_, &entry));
+      if (entry.transaction_id() != metadata.transaction_id()) {
+        return Status::DataLoss();
+      }
+    }
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::WriteIndexCheckpoint() {
+  if (index_checkpoint_partition_ == nullptr || !initialized() ||
+      CheckForErrors()) {
+    return Status::FailedPrecondition();
+  }
+
+  FlashPartition& checkpoint = *index_checkpoint_partition_;
+  if (IndexCheckpointSize(sectors_.size(),
+                          entry_cache_.total_entries(),
+                          redundancy()) > checkpoint.size_bytes()) {
+    return Status::ResourceExhausted();
+  }
+  if (checkpoint.alignment_bytes() > kMaxFlashAlignment) {
+    return Status::FailedPrecondition();
+  }
+
+  PW_TRY(checkpoint.Erase());
+  index_checkpoint_in_flash_ = true;
+
+  FlashPartition::Output output(checkpoint, 0);
+  AlignedWriterBuffer<kMaxFlashAlignment> writer(checkpoint.alignment_bytes(),
+                                                 output);
+  checksum::Crc32 crc;
+  auto write = [&writer, &crc](const auto& value) -> Status {
+    span<const byte> bytes = as_bytes(span(&value, 1));
+    crc.Update(bytes);
+    return writer.Write(bytes).status();
+  };
+
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  PW_TRY(write(IndexCheckpointHeader{
+      .magic = kIndexCheckpointMagic,
+      .sector_size_bytes = static_cast<uint32_t>(sector_size_bytes),
+      .sector_count = static_cast<uint32_t>(sectors_.size()),
+      .redundancy = static_cast<uint32_t>(redundancy()),
+      .entry_count = static_cast<uint32_t>(entry_cache_.total_entries()),
+  }));
+
+  for (const SectorDescriptor& sector : sectors_) {
+    PW_TRY(write(
+        static_cast<uint32_t>(sector_size_bytes - sector.writable_bytes())));
+  }
+
+  for (const EntryMetadata& metadata : entry_cache_) {
+    PW_TRY(write(metadata.hash()));
+    PW_TRY(write(metadata.transaction_id()));
+    PW_TRY(write(uint32_t{metadata.state() == EntryState::kDeleted}));
+    for (size_t i = 0; i < redundancy(); ++i) {
+      PW_TRY(write(i < metadata.addresses().size() ? metadata.addresses()[i]
+                                                   : kNoCheckpointAddress));
+    }
+  }
+
+  const uint32_t checksum = crc.value();
+  PW_TRY(writer.Write(&checksum, sizeof(checksum)).status());
+  PW_TRY(writer.Flush().status());
+
+  DBG("Wrote index checkpoint with %u entries",
+      unsigned(entry_cache_.total_entries()));
+  return OkStatus();
+}
+
+Status KeyValueStore::InvalidateIndexCheckpoint() {
+  if (index_checkpoint_partition_ == nullptr || !index_checkpoint_in_flash_) {
+    return OkStatus();
+  }
+  DBG("Erasing index checkpoint before erasing a sector");
+  PW_TRY(index_checkpoint_partition_->Erase());
+  index_checkpoint_in_flash_ = false;
+  return OkStatus();
+}
+
 KeyValueStore::StorageStats KeyValueStore::GetStorageStats() const {
   StorageStats stats{};
   const size_t sector_size = partition_.sector_size_bytes();
@@ -307,6 +631,17 @@ KeyValueStore::StorageStats KeyValueStore::GetStorageStats() const {
   stats.missing_redundant_entries_recovered =
       internal_stats_.missing_redundant_entries_recovered;
 
+  if (sectors_.size() != 0u) {
+    const auto [least_erased, most_erased] = std::minmax_element(
+        sectors_.begin(),
+        sectors_.end(),
+        [](const SectorDescriptor& lhs, const SectorDescriptor& rhs) {
+          return lhs.erase_count() < rhs.erase_count();
+        });
+    stats.min_sector_erase_count = least_erased->erase_count();
+    stats.max_sector_erase_count = most_erased->erase_count();
+  }
+
   for (const SectorDescriptor& sector : sectors_) {
     stats.in_use_bytes += sector.valid_bytes();
     stats.reclaimable_bytes += sector.RecoverableBytes(sector_size);
@@ -351,8 +686,30 @@ bool KeyValueStore::CheckForErrors() {
   return error_detected();
 }
 
+void KeyValueStore::LoadSectorHeader(SectorDescriptor& sector) {
+  Entry entry;
+  if (!Entry::Read(partition_, sectors_.BaseAddress(sector), formats_, &entry)
+           .ok() ||
+      entry.key_length() != 0u || entry.value_size() != sizeof(uint32_t)) {
+    return;
+  }
+
+  uint32_t erase_count;
+  if (!entry.ReadValue(as_writable_bytes(span(&erase_count, 1))).ok() ||
+      !entry.VerifyChecksumInFlash().ok()) {
+    return;
+  }
+
+  // Sectors loaded from an index checkpoint already account for the header.
+  if (sector.Empty(partition_.sector_size_bytes())) {
+    sector.RemoveWritableBytes(entry.size());
+  }
+  sector.set_header(erase_count, entry.size());
+}
+
 Status KeyValueStore::LoadEntry(Address entry_address,
-                                Address* next_entry_address) {
+                                Address* next_entry_address,
+                                PendingBatch& pending_batch) {
   Entry entry;
   PW_TRY(Entry::Read(partition_, entry_address, formats_, &entry));
 
@@ -366,10 +723,66 @@ Status KeyValueStore::LoadEntry(Address entry_address,
   // A valid entry was found, so update the next entry address before doing any
   // of the checks that happen in AddNewOrUpdateExisting.
   *next_entry_address = entry.next_address();
+
+  // Entries of a batch directly follow each other with consecutive transaction
+  // IDs. Anything else means the pending batch was never completed.
+  if (!pending_batch.empty() &&
+      entry.transaction_id() != pending_batch.last_transaction_id + 1) {
+    DiscardIncompleteBatch(pending_batch);
+  }
+
+  if (entry.continues_batch()) {
+    if (pending_batch.empty()) {
+      pending_batch.first_address = entry_address;
+    }
+    pending_batch.count += 1;
+    pending_batch.last_transaction_id = entry.transaction_id();
+    return OkStatus();
+  }
+
+  if (!pending_batch.empty()) {
+    // This entry completes the batch, so its other entries can be loaded.
+    const PendingBatch batch = pending_batch;
+    pending_batch = {};
+    PW_TRY(LoadBatch(batch));
+  }
+
   return entry_cache_.AddNewOrUpdateExisting(
       entry.descriptor(key), entry.address(), partition_.sector_size_bytes());
 }
 
+Status KeyValueStore::LoadBatch(const PendingBatch& batch) {
+  DBG("Loading %u entries of a batch starting at address %u",
+      unsigned(batch.count),
+      unsigned(batch.first_address));
+
+  // The entries were already verified by LoadEntry, so only read their keys.
+  Address address = batch.first_address;
+  for (size_t i = 0; i < batch.count; ++i) {
+    Entry entry;
+    PW_TRY(Entry::Read(partition_, address, formats_, &entry));
+
+    Entry::KeyBuffer key_buffer;
+    PW_TRY_ASSIGN(size_t key_length, entry.ReadKey(key_buffer));
+    const Key key(key_buffer.data(), key_length);
+
+    PW_TRY(entry_cache_.AddNewOrUpdateExisting(
+        entry.descriptor(key), address, partition_.sector_size_bytes()));
+    address = entry.next_address();
+  }
+  return OkStatus();
+}
+
+void KeyValueStore::DiscardIncompleteBatch(PendingBatch& batch) const {
+  if (batch.empty()) {
+    return;
+  }
+  WRN("Ignoring %u entries of an incomplete batch at address %u",
+      unsigned(batch.count),
+      unsigned(batch.first_address));
+  batch = {};
+}
+
 // Scans flash memory within a sector to find a KVS entry magic.
 Status KeyValueStore::ScanForEntry(const SectorDescriptor& sector,
                                    Address start_address,
@@ -446,13 +859,27 @@ StatusWithSize KeyValueStore::Get(Key key,
   return Get(key, metadata, value_buffer, offset_bytes);
 }
 
+Result<span<const byte>> KeyValueStore::GetView(Key key) const {
+  PW_TRY(CheckReadOperation(key));
+
+  EntryMetadata metadata;
+  PW_TRY(FindExisting(key, &metadata));
+
+  return GetView(key, metadata);
+}
+
 Status KeyValueStore::PutBytes(Key key, span<const byte> value) {
   PW_TRY(CheckWriteOperation(key));
   DBG("Writing key/value; key length=%u, value length=%u",
       unsigned(key.size()),
       unsigned(value.size()));
 
-  if (Entry::size(partition_, key, value) > partition_.sector_size_bytes()) {
+  // Finding the stored size of a compressed value compresses it, so the size
+  // is calculated once here and passed along for the rest of the write.
+  const size_t stored_value_size =
+      Entry::StoredValueSize(value, options_.compress_values);
+  if (Entry::SizeWithStoredValue(partition_, key, stored_value_size) >
+      max_entry_size()) {
     DBG("%u B value with %u B key cannot fit in one sector",
         unsigned(value.size()),
         unsigned(key.size()));
@@ -468,11 +895,12 @@ Status KeyValueStore::PutBytes(Key key, span<const byte> value) {
         unsigned(metadata.hash()),
         unsigned(metadata.addresses().size()),
         sectors_.Index(metadata.first_address()));
-    return WriteEntryForExistingKey(metadata, EntryState::kValid, key, value);
+    return WriteEntryForExistingKey(
+        metadata, EntryState::kValid, key, value, stored_value_size);
   }
 
   if (status.IsNotFound()) {
-    return WriteEntryForNewKey(key, value);
+    return WriteEntryForNewKey(key, value, stored_value_size);
   }
 
   return status;
@@ -489,7 +917,106 @@ Status KeyValueStore::Delete(Key key) {
       unsigned(metadata.hash()),
       unsigned(metadata.addresses().size()),
       sectors_.Index(metadata.first_address()));
-  return WriteEntryForExistingKey(metadata, EntryState::kDeleted, key, {});
+  return WriteEntryForExistingKey(
+      metadata, EntryState::kDeleted, key, {}, /*stored_value_size=*/0);
+}
+
+Status KeyValueStore::Commit(const Batch& batch) {
+  if (initialized_ == InitializationState::kNotInitialized) {
+    return Status::FailedPrecondition();
+  }
+  if (batch.empty()) {
+    return OkStatus();
+  }
+
+  // Check every operation before writing anything, so that a batch is either
+  // written in full or not at all.
+  size_t batch_size = 0;
+  size_t new_keys = 0;
+  for (size_t i = 0; i < batch.size(); ++i) {
+    const Batch::Operation& operation = batch[i];
+    PW_TRY(CheckWriteOperation(operation.key));
+
+    const uint32_t hash = internal::Hash(operation.key);
+    for (size_t j = 0; j < i; ++j) {
+      if (internal::Hash(batch[j].key) == hash) {
+        DBG("Key 0x%08x appears more than once in a batch", unsigned(hash));
+        return Status::InvalidArgument();
+      }
+    }
+
+    EntryMetadata metadata;
+    if (operation.deleted) {
+      PW_TRY(FindExisting(operation.key, &metadata));
+    } else {
+      Status status = FindEntry(operation.key, &metadata);
+      if (status.IsNotFound()) {
+        new_keys += 1;
+      } else if (!status.ok()) {
+        return status;
+      }
+    }
+
+    batch_size += Entry::size(partition_,
+                              operation.key,
+                              operation.value,
+                              options_.compress_values);
+  }
+
+  if (batch_size > max_entry_size()) {
+    DBG("%u B batch cannot fit in one sector", unsigned(batch_size));
+    return Status::InvalidArgument();
+  }
+
+  if (entry_cache_.total_entries() + new_keys > entry_cache_.max_entries()) {
+    WRN("KVS full: trying to store %u new entries, but can't. Have %u entries",
+        unsigned(new_keys),
+        unsigned(entry_cache_.total_entries()));
+    return Status::ResourceExhausted();
+  }
+
+  Address* reserved_addresses = entry_cache_.TempReservedAddressesForWrite();
+  PW_TRY(GetAddressesForWrite(reserved_addresses, batch_size));
+
+  // Burn the transaction IDs for the whole batch up front, as CreateEntry does
+  // for single entries.
+  const uint32_t first_transaction_id = last_transaction_id_ + 1;
+  last_transaction_id_ += batch.size();
+
+  PW_TRY(AppendBatch(batch, first_transaction_id, reserved_addresses[0]));
+
+  // The first copy of the batch is complete, so the new entries replace the
+  // old ones.
+  Address address = reserved_addresses[0];
+  for (size_t i = 0; i < batch.size(); ++i) {
+    const Entry entry =
+        CreateBatchEntry(batch, i, first_transaction_id, address);
+    EntryMetadata metadata;
+    if (FindEntry(batch[i].key, &metadata).ok()) {
+      Entry prior_entry;
+      PW_TRY(ReadEntry(metadata, prior_entry));
+      UpdateKeyDescriptor(entry, address, &metadata, prior_entry.size());
+    } else {
+      entry_cache_.AddNew(entry.descriptor(batch[i].key), address);
+    }
+    address = entry.next_address();
+  }
+
+  // Write the additional copies of the batch, if redundancy is greater than 1.
+  for (size_t copy = 1; copy < redundancy(); ++copy) {
+    PW_TRY(
+        AppendBatch(batch, first_transaction_id, reserved_addresses[copy]));
+
+    // Each copy has the same layout as the first, so find the entries by their
+    // offsets in the first copy rather than compressing the values again.
+    for (size_t i = 0; i < batch.size(); ++i) {
+      EntryMetadata metadata;
+      PW_TRY(FindEntry(batch[i].key, &metadata));
+      const Address offset = metadata.first_address() - reserved_addresses[0];
+      metadata.AddNewAddress(reserved_addresses[copy] + offset);
+    }
+  }
+  return OkStatus();
 }
 
 void KeyValueStore::Item::ReadKey() {
@@ -578,8 +1105,25 @@ StatusWithSize KeyValueStore::Get(Key key,
 
   PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
 
+  const bool verify = options_.verify_on_read &&
+                      (options_.reverify_on_read || !entries_verified_);
+
+  if (entry.compressed()) {
+    // Decompression starts at the beginning of the value, so compressed values
+    // cannot be read at an offset.
+    if (offset_bytes != 0u) {
+      return StatusWithSize::Unimplemented();
+    }
+    StatusWithSize result = entry.ReadCompressedValue(value_buffer, verify);
+    if (!result.ok() && !result.IsResourceExhausted()) {
+      std::memset(value_buffer.data(), 0, value_buffer.size());
+      return StatusWithSize(result.status(), 0);
+    }
+    return result;
+  }
+
   StatusWithSize result = entry.ReadValue(value_buffer, offset_bytes);
-  if (result.ok() && options_.verify_on_read && offset_bytes == 0u) {
+  if (result.ok() && verify && offset_bytes == 0u) {
     Status verify_result =
         entry.VerifyChecksum(key, value_buffer.first(result.size()));
     if (!verify_result.ok()) {
@@ -592,6 +1136,41 @@ StatusWithSize KeyValueStore::Get(Key key,
   return result;
 }
 
+Result<span<const byte>> KeyValueStore::GetView(
+    Key key, const EntryMetadata& metadata) const {
+  Entry entry;
+  PW_TRY(ReadEntry(metadata, entry));
+
+  if (entry.compressed()) {
+    return Status::Unimplemented();
+  }
+
+  // Cached writes must be programmed before the flash is read through memory.
+  PW_TRY(partition_.Flush());
+  const byte* value_data =
+      partition_.PartitionAddressToMcuAddress(entry.value_address());
+  if (value_data == nullptr) {
+    return Status::Unimplemented();
+  }
+  const span<const byte> value(value_data, entry.value_size());
+
+  // An entry at the same address with the same key and transaction ID holds
+  // the same data as the entry that was verified, since each update of a key
+  // has a new transaction ID.
+  const bool verified = entry.address() == verified_view_address_ &&
+                        entry.transaction_id() ==
+                            verified_view_transaction_id_ &&
+                        metadata.hash() == verified_view_key_hash_;
+  if (options_.verify_on_read && !verified &&
+      (options_.reverify_on_read || !entries_verified_)) {
+    PW_TRY(entry.VerifyChecksum(key, value));
+    verified_view_address_ = entry.address();
+    verified_view_transaction_id_ = entry.transaction_id();
+    verified_view_key_hash_ = metadata.hash();
+  }
+  return value;
+}
+
 Status KeyValueStore::FixedSizeGet(Key key,
                                    void* value,
                                    size_t size_bytes) const {
@@ -628,7 +1207,7 @@ StatusWithSize KeyValueStore::ValueSize(const EntryMetadata& metadata) const {
   Entry entry;
   PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
 
-  return StatusWithSize(entry.value_size());
+  return entry.ReadValueSize();
 }
 
 Status KeyValueStore::CheckWriteOperation(Key key) const {
@@ -659,22 +1238,26 @@ Status KeyValueStore::CheckReadOperation(Key key) const {
 Status KeyValueStore::WriteEntryForExistingKey(EntryMetadata& metadata,
                                                EntryState new_state,
                                                Key key,
-                                               span<const byte> value) {
+                                               span<const byte> value,
+                                               size_t stored_value_size) {
   // Read the original entry to get the size for sector accounting purposes.
   Entry entry;
   PW_TRY(ReadEntry(metadata, entry));
 
-  return WriteEntry(key, value, new_state, &metadata, &entry);
+  return WriteEntry(
+      key, value, stored_value_size, new_state, &metadata, &entry);
 }
 
-Status KeyValueStore::WriteEntryForNewKey(Key key, span<const byte> value) {
+Status KeyValueStore::WriteEntryForNewKey(Key key,
+                                          span<const byte> value,
+                                          size_t stored_value_size) {
   // If there is no room in the cache for a new entry, it is possible some cache
   // entries could be freed by removing deleted keys. If deleted key removal is
   // enabled and the KVS is configured to make all possible writes succeed,
   // attempt heavy maintenance now.
 #if PW_KVS_REMOVE_DELETED_KEYS_IN_HEAVY_MAINTENANCE
   if (options_.gc_on_write == GargbageCollectOnWrite::kAsManySectorsNeeded &&
-      entry_cache_.full()) {
+      options_.max_relocations_per_write == 0 && entry_cache_.full()) {
     Status maintenance_status = HeavyMaintenance();
     if (!maintenance_status.ok()) {
       WRN("KVS Maintenance failed for write: %s", maintenance_status.str());
@@ -689,20 +1272,24 @@ Status KeyValueStore::WriteEntryForNewKey(Key key, span<const byte> value) {
     return Status::ResourceExhausted();
   }
 
-  return WriteEntry(key, value, EntryState::kValid);
+  return WriteEntry(key, value, stored_value_size, EntryState::kValid);
 }
 
 Status KeyValueStore::WriteEntry(Key key,
                                  span<const byte> value,
+                                 size_t stored_value_size,
                                  EntryState new_state,
                                  EntryMetadata* prior_metadata,
                                  const Entry* prior_entry) {
-  // If new entry and prior entry have matching value size, state, and checksum,
-  // check if the values match. Directly compare the prior and new values
-  // because the checksum can not be depended on to establish equality, it can
-  // only be depended on to establish inequality.
-  if (prior_entry != nullptr && prior_entry->value_size() == value.size() &&
-      prior_metadata->state() == new_state &&
+  // If new entry and prior entry have matching state, check if the values
+  // match. Directly compare the prior and new values because the checksum can
+  // not be depended on to establish equality, it can only be depended on to
+  // establish inequality. A compressed prior value can only match if the new
+  // value compresses to the same size, so only compress it again to compare it
+  // if it does.
+  if (prior_entry != nullptr && prior_metadata->state() == new_state &&
+      (!prior_entry->compressed() ||
+       prior_entry->value_size() == stored_value_size) &&
       prior_entry->ValueMatches(value).ok()) {
     // The new value matches the prior value, don't need to write anything. Just
     // keep the existing entry.
@@ -716,16 +1303,35 @@ Status KeyValueStore::WriteEntry(Key key,
 
   // Find addresses to write the entry to. This may involve garbage collecting
   // one or more sectors.
-  const size_t entry_size = Entry::size(partition_, key, value);
+  const size_t entry_size =
+      Entry::SizeWithStoredValue(partition_, key, stored_value_size);
   PW_TRY(GetAddressesForWrite(reserved_addresses, entry_size));
 
   // Write the entry at the first address that was found.
-  Entry entry = CreateEntry(reserved_addresses[0], key, value, new_state);
+  Entry entry = CreateEntry(
+      reserved_addresses[0], key, value, stored_value_size, new_state);
+  size_t prior_size = prior_entry != nullptr ? prior_entry->size() : 0;
+
+  if (redundant_writer_ != nullptr && redundancy() > 1 &&
+      redundancy() <= kMaxConcurrentCopies) {
+    size_t copies_written;
+    const Status status = AppendEntryCopies(
+        entry, key, value, span(reserved_addresses, redundancy()),
+        copies_written);
+    if (copies_written != 0u) {
+      EntryMetadata new_metadata =
+          CreateOrUpdateKeyDescriptor(entry, key, prior_metadata, prior_size);
+      for (size_t i = 1; i < copies_written; ++i) {
+        new_metadata.AddNewAddress(reserved_addresses[i]);
+      }
+    }
+    return status;
+  }
+
   PW_TRY(AppendEntry(entry, key, value));
 
   // After writing the first entry successfully, update the key descriptors.
   // Once a single new the entry is written, the old entries are invalidated.
-  size_t prior_size = prior_entry != nullptr ? prior_entry->size() : 0;
   EntryMetadata new_metadata =
       CreateOrUpdateKeyDescriptor(entry, key, prior_metadata, prior_size);
 
@@ -794,6 +1400,7 @@ Status KeyValueStore::GetSectorForWrite(
 
   size_t gc_sector_count = 0;
   bool do_auto_gc = options_.gc_on_write != GargbageCollectOnWrite::kDisabled;
+  size_t relocation_budget = options_.max_relocations_per_write;
 
   // Do garbage collection as needed, so long as policy allows.
   while (result.IsResourceExhausted() && do_auto_gc) {
@@ -803,12 +1410,20 @@ Status KeyValueStore::GetSectorForWrite(
       do_auto_gc = false;
     }
     // Garbage collect and then try again to find the best sector.
-    Status gc_status = GarbageCollect(reserved_addresses);
+    Status gc_status =
+        options_.max_relocations_per_write == 0
+            ? GarbageCollect(reserved_addresses)
+            : IncrementalGarbageCollect(relocation_budget, reserved_addresses);
     if (!gc_status.ok()) {
       if (gc_status.IsNotFound()) {
         // Not enough space, and no reclaimable bytes, this KVS is full!
         return Status::ResourceExhausted();
       }
+      if (gc_status.IsDeadlineExceeded()) {
+        WRN("Relocation budget for write exhausted; deferring garbage "
+            "collection");
+        return Status::ResourceExhausted();
+      }
       return gc_status;
     }
 
@@ -865,9 +1480,108 @@ Status KeyValueStore::AppendEntry(const Entry& entry,
   return OkStatus();
 }
 
+Status KeyValueStore::AppendEntryCopies(const Entry& entry,
+                                        Key key,
+                                        span<const byte> value,
+                                        span<const Address> addresses,
+                                        size_t& copies_written) {
+  RedundantOutput output(*redundant_writer_, partition_, addresses);
+  StatusWithSize result;
+  {
+    AlignedWriterBuffer<kBatchWriteBufferSize> writer(
+        partition_.alignment_bytes(), output);
+    result = entry.Write(writer, key, value);
+    if (result.ok()) {
+      result = writer.Flush();
+    }
+  }
+
+  // Like the copies written one by one, only the copies before the first
+  // failure are kept. Later copies that were written are left as reclaimable
+  // bytes.
+  copies_written = addresses.size();
+  Status first_error;
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    SectorDescriptor& sector = sectors_.FromAddress(addresses[i]);
+    Status status = result.ok() ? output.status(i) : result.status();
+    if (status.ok() && options_.verify_on_write) {
+      Entry copy = entry;
+      copy.set_address(addresses[i]);
+      status = copy.VerifyChecksumInFlash();
+    }
+
+    if (!status.ok()) {
+      ERR("Failed to write %u bytes at %#x",
+          unsigned(entry.size()),
+          unsigned(addresses[i]));
+      MarkSectorCorruptIfNotOk(status, &sector).IgnoreError();
+      if (first_error.ok()) {
+        first_error = status;
+        copies_written = i;
+      }
+      continue;
+    }
+
+    sector.RemoveWritableBytes(entry.size());
+    if (i < copies_written) {
+      sector.AddValidBytes(entry.size());
+    }
+  }
+  return first_error;
+}
+
+Status KeyValueStore::AppendBatch(const Batch& batch,
+                                  uint32_t first_transaction_id,
+                                  Address address) {
+  SectorDescriptor& sector = sectors_.FromAddress(address);
+
+  FlashPartition::Output output(partition_, address);
+  AlignedWriterBuffer<kBatchWriteBufferSize> writer(
+      partition_.alignment_bytes(), output);
+
+  StatusWithSize result;
+  Address entry_address = address;
+  for (size_t i = 0; i < batch.size() && result.ok(); ++i) {
+    const Entry entry =
+        CreateBatchEntry(batch, i, first_transaction_id, entry_address);
+    result = entry.Write(writer, batch[i].key, batch[i].value);
+    entry_address = entry.next_address();
+  }
+  if (result.ok()) {
+    result = writer.Flush();
+  }
+
+  if (!result.ok()) {
+    ERR("Failed to write %u B batch at %#x",
+        unsigned(entry_address - address),
+        unsigned(address));
+    PW_TRY(MarkSectorCorruptIfNotOk(result.status(), &sector));
+  }
+
+  if (options_.verify_on_write) {
+    for (Address verify_address = address; verify_address < entry_address;) {
+      Entry entry;
+      PW_TRY(MarkSectorCorruptIfNotOk(
+          Entry::Read(partition_, verify_address, formats_, &entry), &sector));
+      PW_TRY(
+          MarkSectorCorruptIfNotOk(entry.VerifyChecksumInFlash(), &sector));
+      verify_address = entry.next_address();
+    }
+  }
+
+  sector.RemoveWritableBytes(entry_address - address);
+  sector.AddValidBytes(entry_address - address);
+  return OkStatus();
+}
+
 StatusWithSize KeyValueStore::CopyEntryToSector(Entry& entry,
                                                 SectorDescriptor* new_sector,
                                                 Address new_address) {
+  // Once copied, the entry is no longer next to the rest of its batch.
+  if (entry.continues_batch()) {
+    PW_TRY_WITH_SIZE(entry.DetachFromBatch());
+  }
+
   const StatusWithSize result = entry.Copy(new_address);
 
   PW_TRY_WITH_SIZE(MarkSectorCorruptIfNotOk(result.status(), new_sector));
@@ -1019,6 +1733,26 @@ Status KeyValueStore::PartialMaintenance() {
   return GarbageCollect(span<const Address>());
 }
 
+Status KeyValueStore::PartialMaintenance(size_t max_relocations) {
+  if (initialized_ == InitializationState::kNotInitialized) {
+    return Status::FailedPrecondition();
+  }
+
+  CheckForErrors();
+  // Do automatic repair, if KVS options allow for it.
+  if (error_detected_ && options_.recovery != ErrorRecovery::kManual) {
+    PW_TRY(Repair());
+  }
+
+  // Unlike garbage collection for a write, background collection should not
+  // shuffle valid entries around when there is no space to reclaim.
+  if (incremental_gc_sector_ == nullptr &&
+      GetStorageStats().reclaimable_bytes == 0) {
+    return Status::NotFound();
+  }
+  return IncrementalGarbageCollect(max_relocations, span<const Address>());
+}
+
 Status KeyValueStore::GarbageCollect(span<const Address> reserved_addresses) {
   DBG("Garbage Collect a single sector");
   for ([[maybe_unused]] Address address : reserved_addresses) {
@@ -1035,7 +1769,57 @@ Status KeyValueStore::GarbageCollect(span<const Address> reserved_addresses) {
   }
 
   // Step 2: Garbage collect the selected sector.
-  return GarbageCollectSector(*sector_to_gc, reserved_addresses);
+  PW_TRY(GarbageCollectSector(*sector_to_gc, reserved_addresses));
+
+  // Step 3: Now that there is free space, move data that rarely changes out
+  // of a sector that has fallen behind in wear.
+  return LevelWear(reserved_addresses);
+}
+
+Status KeyValueStore::IncrementalGarbageCollect(
+    size_t& relocation_budget, span<const Address> reserved_addresses) {
+  if (incremental_gc_sector_ == nullptr) {
+    incremental_gc_sector_ =
+        sectors_.FindSectorToGarbageCollect(reserved_addresses);
+    if (incremental_gc_sector_ == nullptr) {
+      // Nothing to GC.
+      return Status::NotFound();
+    }
+    DBG("Incrementally garbage collect sector %u",
+        sectors_.Index(incremental_gc_sector_));
+
+    // Keep new entries out of the sector while it is being emptied. Its
+    // remaining space is reclaimed when it is erased.
+    incremental_gc_sector_->set_writable_bytes(0);
+  }
+
+  SectorDescriptor& sector_to_gc = *incremental_gc_sector_;
+
+  // Since nothing is written to the sector, reserved addresses cannot be in it
+  // and the relocations below cannot add more work.
+  for (EntryMetadata& metadata : entry_cache_) {
+    if (sector_to_gc.valid_bytes() == 0) {
+      break;
+    }
+    for (FlashPartition::Address& address : metadata.addresses()) {
+      if (!sectors_.AddressInSector(sector_to_gc, address)) {
+        continue;
+      }
+      if (relocation_budget == 0) {
+        DBG("  Relocation budget exhausted, %u valid bytes remain",
+            unsigned(sector_to_gc.valid_bytes()));
+        return Status::DeadlineExceeded();
+      }
+      DBG("  Relocate entry for Key 0x%08" PRIx32 ", sector %u",
+          metadata.hash(),
+          sectors_.Index(sector_to_gc));
+      PW_TRY(RelocateEntry(metadata, address, reserved_addresses));
+      relocation_budget -= 1;
+    }
+  }
+
+  // The sector has no valid entries left, so this only erases it.
+  return GarbageCollectSector(sector_to_gc, reserved_addresses);
 }
 
 Status KeyValueStore::RelocateKeyAddressesInSector(
@@ -1058,6 +1842,10 @@ Status KeyValueStore::GarbageCollectSector(
     SectorDescriptor& sector_to_gc, span<const Address> reserved_addresses) {
   DBG("  Garbage Collect sector %u", sectors_.Index(sector_to_gc));
 
+  if (&sector_to_gc == incremental_gc_sector_) {
+    incremental_gc_sector_ = nullptr;
+  }
+
   // Step 1: Move any valid entries in the GC sector to other sectors
   if (sector_to_gc.valid_bytes() != 0) {
     for (EntryMetadata& metadata : entry_cache_) {
@@ -1076,15 +1864,63 @@ Status KeyValueStore::GarbageCollectSector(
   // Step 2: Reinitialize the sector
   if (!sector_to_gc.Empty(partition_.sector_size_bytes())) {
     sector_to_gc.mark_corrupt();
+    PW_TRY(InvalidateIndexCheckpoint());
     internal_stats_.sector_erase_count++;
     PW_TRY(partition_.Erase(sectors_.BaseAddress(sector_to_gc), 1));
-    sector_to_gc.set_writable_bytes(partition_.sector_size_bytes());
+    sector_to_gc.MarkErased(partition_.sector_size_bytes());
+    if (options_.wear_leveling_threshold != 0u) {
+      PW_TRY(WriteSectorHeader(sector_to_gc));
+    }
   }
 
   DBG("  Garbage Collect sector %u complete", sectors_.Index(sector_to_gc));
   return OkStatus();
 }
 
+Status KeyValueStore::WriteSectorHeader(SectorDescriptor& sector) {
+  const uint32_t erase_count = sector.erase_count();
+  const span<const byte> value = as_bytes(span(&erase_count, 1));
+  const Entry header = Entry::Valid(partition_,
+                                    sectors_.BaseAddress(sector),
+                                    formats_.primary(),
+                                    Key(),
+                                    value,
+                                    /*transaction_id=*/0);
+
+  PW_TRY(MarkSectorCorruptIfNotOk(header.Write(Key(), value).status(),
+                                  &sector));
+  if (options_.verify_on_write) {
+    PW_TRY(MarkSectorCorruptIfNotOk(header.VerifyChecksumInFlash(), &sector));
+  }
+
+  sector.RemoveWritableBytes(header.size());
+  sector.set_header(erase_count, header.size());
+  return OkStatus();
+}
+
+Status KeyValueStore::LevelWear(span<const Address> reserved_addresses) {
+  if (options_.wear_leveling_threshold == 0u) {
+    return OkStatus();
+  }
+
+  SectorDescriptor* sector = sectors_.FindSectorToLevelWear(
+      options_.wear_leveling_threshold, reserved_addresses);
+  if (sector == nullptr) {
+    return OkStatus();
+  }
+  DBG("Relocating data from sector %u to level wear", sectors_.Index(sector));
+  return GarbageCollectSector(*sector, reserved_addresses);
+}
+
+size_t KeyValueStore::max_entry_size() const {
+  if (options_.wear_leveling_threshold == 0u) {
+    return partition_.sector_size_bytes();
+  }
+  constexpr uint32_t kErasedCount = 0;
+  return partition_.sector_size_bytes() -
+         Entry::size(partition_, Key(), as_bytes(span(&kErasedCount, 1)));
+}
+
 StatusWithSize KeyValueStore::UpdateEntriesToPrimaryFormat() {
   size_t entries_updated = 0;
   for (EntryMetadata& prior_metadata : entry_cache_) {
@@ -1291,6 +2127,7 @@ Status KeyValueStore::Repair() {
 KeyValueStore::Entry KeyValueStore::CreateEntry(Address address,
                                                 Key key,
                                                 span<const byte> value,
+                                                size_t stored_value_size,
                                                 EntryState state) {
   // Always bump the transaction ID when creating a new entry.
   //
@@ -1310,12 +2147,41 @@ KeyValueStore::Entry KeyValueStore::CreateEntry(Address address,
     return Entry::Tombstone(
         partition_, address, formats_.primary(), key, last_transaction_id_);
   }
+  return Entry::ValidWithStoredSize(partition_,
+                                    address,
+                                    formats_.primary(),
+                                    key,
+                                    value,
+                                    stored_value_size,
+                                    last_transaction_id_);
+}
+
+KeyValueStore::Entry KeyValueStore::CreateBatchEntry(
+    const Batch& batch,
+    size_t index,
+    uint32_t first_transaction_id,
+    Address address) {
+  const Batch::Operation& operation = batch[index];
+  const uint32_t transaction_id =
+      first_transaction_id + static_cast<uint32_t>(index);
+  const bool continues_batch = index + 1 < batch.size();
+
+  if (operation.deleted) {
+    return Entry::Tombstone(partition_,
+                            address,
+                            formats_.primary(),
+                            operation.key,
+                            transaction_id,
+                            continues_batch);
+  }
   return Entry::Valid(partition_,
                       address,
                       formats_.primary(),
-                      key,
-                      value,
-                      last_transaction_id_);
+                      operation.key,
+                      operation.value,
+                      transaction_id,
+                      continues_batch,
+                      options_.compress_values);
 }
 
 void KeyValueStore::LogDebugInfo() const {
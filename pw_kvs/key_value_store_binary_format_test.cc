@@ -345,6 +345,33 @@ TEST_F(KvsErrorHandling, Init_CorruptKey_RevertsToPreviousVersion) {
   EXPECT_EQ(32u, kvs_.GetStorageStats().in_use_bytes);
 }
 
+TEST_F(KvsErrorHandling, Get_CorruptedAfterInit_ReturnsDataLoss) {
+  InitFlashTo(kEntry1);
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+
+  // Corrupt a byte of the value ("value1" starts at address 20).
+  flash_.buffer()[20] = byte{'V'};
+
+  byte buffer[64];
+  EXPECT_EQ(Status::DataLoss(), kvs_.Get("key1", buffer).status());
+}
+
+TEST_F(KvsErrorHandling, Get_NoReverifyOnRead_SkipsEntriesVerifiedByInit) {
+  Options options = kNoGcOptions;
+  options.reverify_on_read = false;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &partition_, default_format, options);
+
+  InitFlashTo(kEntry1);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  flash_.buffer()[20] = byte{'V'};
+
+  char buffer[64] = {};
+  auto result = kvs.Get("key1", as_writable_bytes(span(buffer)));
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_STREQ("Value1", buffer);
+}
+
 // The Put_WriteFailure_EntryNotAddedButBytesMarkedWritten test is run with both
 // the KvsErrorRecovery and KvsErrorHandling test fixtures (different KVS
 // configurations).
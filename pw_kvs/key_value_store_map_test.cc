@@ -56,6 +56,7 @@ struct TestParameters {
   size_t partition_start_sector;
   size_t partition_sector_count;
   size_t partition_alignment;
+  bool hash_index;
 };
 
 enum Options {
@@ -403,7 +404,12 @@ class KvsTester {
 
   FlashPartitionWithStatsBuffer<kMaxEntries> partition_;
 
-  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, kParams.redundancy> kvs_;
+  KeyValueStoreBuffer<kMaxEntries,
+                      kMaxUsableSectors,
+                      kParams.redundancy,
+                      1,
+                      kParams.hash_index>
+      kvs_;
   std::unordered_map<std::string, std::string> map_;
   std::unordered_set<std::string> deleted_;
   unsigned count_ = 0;
@@ -470,7 +476,8 @@ RUN_TESTS_WITH_PARAMETERS(Basic,
                           .redundancy = 1,
                           .partition_start_sector = 0,
                           .partition_sector_count = 4,
-                          .partition_alignment = 16);
+                          .partition_alignment = 16,
+                          .hash_index = false);
 
 RUN_TESTS_WITH_PARAMETERS(BasicRedundant,
                           .sector_size = 4 * 1024,
@@ -479,7 +486,8 @@ RUN_TESTS_WITH_PARAMETERS(BasicRedundant,
                           .redundancy = 2,
                           .partition_start_sector = 0,
                           .partition_sector_count = 4,
-                          .partition_alignment = 16);
+                          .partition_alignment = 16,
+                          .hash_index = false);
 
 RUN_TESTS_WITH_PARAMETERS(LotsOfSmallSectors,
                           .sector_size = 160,
@@ -488,7 +496,8 @@ RUN_TESTS_WITH_PARAMETERS(LotsOfSmallSectors,
                           .redundancy = 1,
                           .partition_start_sector = 5,
                           .partition_sector_count = 95,
-                          .partition_alignment = 32);
+                          .partition_alignment = 32,
+                          .hash_index = false);
 
 RUN_TESTS_WITH_PARAMETERS(LotsOfSmallSectorsRedundant,
                           .sector_size = 160,
@@ -497,7 +506,28 @@ RUN_TESTS_WITH_PARAMETERS(LotsOfSmallSectorsRedundant,
                           .redundancy = 2,
                           .partition_start_sector = 5,
                           .partition_sector_count = 95,
-                          .partition_alignment = 32);
+                          .partition_alignment = 32,
+                          .hash_index = false);
+
+RUN_TESTS_WITH_PARAMETERS(BasicHashIndex,
+                          .sector_size = 4 * 1024,
+                          .sector_count = 4,
+                          .sector_alignment = 16,
+                          .redundancy = 1,
+                          .partition_start_sector = 0,
+                          .partition_sector_count = 4,
+                          .partition_alignment = 16,
+                          .hash_index = true);
+
+RUN_TESTS_WITH_PARAMETERS(LotsOfSmallSectorsRedundantHashIndex,
+                          .sector_size = 160,
+                          .sector_count = 100,
+                          .sector_alignment = 32,
+                          .redundancy = 2,
+                          .partition_start_sector = 5,
+                          .partition_sector_count = 95,
+                          .partition_alignment = 32,
+                          .hash_index = true);
 
 RUN_TESTS_WITH_PARAMETERS(OnlyTwoSectors,
                           .sector_size = 4 * 1024,
@@ -506,7 +536,8 @@ RUN_TESTS_WITH_PARAMETERS(OnlyTwoSectors,
                           .redundancy = 1,
                           .partition_start_sector = 18,
                           .partition_sector_count = 2,
-                          .partition_alignment = 64);
+                          .partition_alignment = 64,
+                          .hash_index = false);
 
 }  // namespace
 }  // namespace pw::kvs
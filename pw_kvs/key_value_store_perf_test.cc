@@ -0,0 +1,103 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kMaxEntries = 64;
+constexpr size_t kSectorSize = 4096;
+constexpr size_t kSectorCount = 8;
+
+ChecksumCrc16 checksum;
+constexpr EntryFormat kFormat{.magic = 0x5ab7c0de, .checksum = &checksum};
+
+// Keys of the form "sensor/00" to "sensor/63".
+struct Keys {
+  Keys() {
+    for (size_t i = 0; i < names.size(); ++i) {
+      std::snprintf(names[i].data(), names[i].size(), "sensor/%02zu", i);
+    }
+  }
+
+  const char* operator[](size_t i) const { return names[i].data(); }
+
+  std::array<std::array<char, 16>, kMaxEntries> names;
+};
+
+const Keys keys;
+
+// A KVS on fake flash. These are too large for the stack of most devices, so
+// each test reuses a static instance.
+template <bool kHashIndex>
+class Store {
+ public:
+  Store() : partition_(&flash_), kvs_(&partition_, kFormat) {}
+
+  // Erases the KVS and writes keys 0 to key_count - 1.
+  KeyValueStore& Reset(size_t key_count) {
+    partition_.Erase().IgnoreError();
+    kvs_.Init().IgnoreError();
+    for (size_t i = 0; i < key_count; ++i) {
+      kvs_.Put(keys[i], static_cast<uint32_t>(i)).IgnoreError();
+    }
+    return kvs_;
+  }
+
+ private:
+  FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  FlashPartition partition_;
+  KeyValueStoreBuffer<kMaxEntries, kSectorCount, 1, 1, kHashIndex> kvs_;
+};
+
+// Reads the last key written, which takes longest to find without a hash
+// index.
+template <bool kHashIndex>
+void GetTest(perf_test::State& state, int64_t key_count) {
+  static Store<kHashIndex> store;
+  KeyValueStore& kvs = store.Reset(static_cast<size_t>(key_count));
+  const char* key = keys[static_cast<size_t>(key_count) - 1];
+  uint32_t value;
+  while (state.KeepRunning()) {
+    kvs.Get(key, &value).IgnoreError();
+  }
+}
+
+// Overwrites a value. Entries are appended to flash, so this includes the
+// occasional garbage collection of a sector.
+void PutTest(perf_test::State& state, int64_t key_count) {
+  static Store<false> store;
+  KeyValueStore& kvs = store.Reset(static_cast<size_t>(key_count));
+  uint32_t value = 0;
+  while (state.KeepRunning()) {
+    kvs.Put(keys[0], ++value).IgnoreError();
+  }
+}
+
+PW_PERF_TEST_RANGE(Get, GetTest<false>, 1, 64, 4);
+PW_PERF_TEST_RANGE(GetWithHashIndex, GetTest<true>, 1, 64, 4);
+PW_PERF_TEST_RANGE(Put, PutTest, 1, 64, 4);
+
+}  // namespace
+}  // namespace pw::kvs
@@ -17,6 +17,7 @@
 
 #include "pw_kvs/key_value_store.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdio>
 #include <cstring>
@@ -475,6 +476,574 @@ TEST_F(LargeEmptyInitializedKvs, KeyDeletionMaintenance) {
   ASSERT_EQ(val, kValue2);
 }
 
+TEST_F(LargeEmptyInitializedKvs, PartialMaintenance_BoundedRelocations) {
+  const uint8_t kValue1 = 0xDA;
+  const uint8_t kValue2 = 0x12;
+  uint8_t val = 0;
+
+  // Write three keys, then rewrite one, leaving three valid entries and a stale
+  // entry in the same sector.
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], kValue1));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], kValue1));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[2], kValue1));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], kValue2));
+
+  // Each step relocates one valid entry; the sector is erased on the last.
+  EXPECT_EQ(Status::DeadlineExceeded(), kvs_.PartialMaintenance(1));
+  EXPECT_EQ(Status::DeadlineExceeded(), kvs_.PartialMaintenance(1));
+  EXPECT_EQ(0u, kvs_.GetStorageStats().sector_erase_count);
+  EXPECT_EQ(OkStatus(), kvs_.PartialMaintenance(1));
+
+  KeyValueStore::StorageStats stats = kvs_.GetStorageStats();
+  EXPECT_EQ(stats.sector_erase_count, 1u);
+  EXPECT_EQ(stats.reclaimable_bytes, 0u);
+  EXPECT_EQ(Status::NotFound(), kvs_.PartialMaintenance(1));
+
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &val));
+  EXPECT_EQ(kValue2, val);
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &val));
+  EXPECT_EQ(kValue1, val);
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[2], &val));
+  EXPECT_EQ(kValue1, val);
+}
+
+TEST(InMemoryKvs, Put_BoundedRelocationsPerWrite) {
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+
+  // For KVS magic value always use a random 32 bit integer rather than a
+  // human readable 4 bytes. See pw_kvs/format.h for more information.
+  constexpr EntryFormat format{.magic = 0x1f3a6c52, .checksum = nullptr};
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition, format, {.max_relocations_per_write = 1});
+  ASSERT_OK(kvs.Init());
+
+  // Keep the partition mostly full of valid entries and rewrite keys in a
+  // scrambled order, so reclaiming a sector usually requires relocating
+  // several entries. Writes that run out of relocation budget fail, and are
+  // retried after finishing the collection in the background.
+  constexpr uint32_t kNumKeys = 30;
+  std::array<uint32_t, 8> values[kNumKeys] = {};
+  size_t deferred_writes = 0;
+  uint32_t seed = 1;
+  for (uint32_t i = 0; i < 400; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    const uint32_t key_index = (seed >> 16) % kNumKeys;
+    StringBuffer<16> key;
+    key << "key_" << key_index;
+    values[key_index].fill(i);
+
+    Status status = kvs.Put(key.view(), values[key_index]);
+    if (status.IsResourceExhausted()) {
+      deferred_writes += 1;
+      while (kvs.PartialMaintenance(1).IsDeadlineExceeded()) {
+      }
+      status = kvs.Put(key.view(), values[key_index]);
+    }
+    ASSERT_EQ(OkStatus(), status);
+  }
+  EXPECT_GT(deferred_writes, 0u);
+
+  for (uint32_t key_index = 0; key_index < kNumKeys; ++key_index) {
+    StringBuffer<16> key;
+    key << "key_" << key_index;
+    std::array<uint32_t, 8> value = {};
+    ASSERT_EQ(OkStatus(), kvs.Get(key.view(), &value));
+    EXPECT_EQ(values[key_index], value);
+  }
+}
+
+class IndexCheckpointKvs : public ::testing::Test {
+ protected:
+  // For KVS magic value always use a random 32 bit integer rather than a
+  // human readable 4 bytes. See pw_kvs/format.h for more information.
+  static constexpr EntryFormat kFormat{.magic = 0x7c2e41a9,
+                                       .checksum = &checksum};
+
+  IndexCheckpointKvs()
+      : checkpoint_flash_(16),
+        checkpoint_partition_(&checkpoint_flash_),
+        kvs_(&flash_.partition, kFormat) {
+    PW_CHECK_OK(flash_.partition.Erase());
+    PW_CHECK_OK(checkpoint_partition_.Erase());
+    kvs_.set_index_checkpoint_partition(&checkpoint_partition_);
+    PW_CHECK_OK(kvs_.Init());
+  }
+
+  // Initializes a second KVS on the same flash, as if after a reboot.
+  void ExpectValuesAfterReboot(uint32_t first_value, size_t num_keys) {
+    KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash_.partition,
+                                                            kFormat);
+    kvs.set_index_checkpoint_partition(&checkpoint_partition_);
+    ASSERT_EQ(OkStatus(), kvs.Init());
+    ASSERT_EQ(num_keys, kvs.size());
+    for (size_t i = 0; i < num_keys; ++i) {
+      uint32_t value = 0;
+      ASSERT_EQ(OkStatus(), kvs.Get(keys[i], &value));
+      EXPECT_EQ(first_value + i, value);
+    }
+  }
+
+  bool CheckpointErased() {
+    bool erased = false;
+    PW_CHECK_OK(checkpoint_partition_.IsErased(&erased));
+    return erased;
+  }
+
+  Flash flash_;
+  FakeFlashMemoryBuffer<512, 2> checkpoint_flash_;
+  FlashPartition checkpoint_partition_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+};
+
+TEST_F(IndexCheckpointKvs, WriteWithoutPartition_FailedPrecondition) {
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash_.partition,
+                                                          kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_EQ(Status::FailedPrecondition(), kvs.WriteIndexCheckpoint());
+}
+
+TEST_F(IndexCheckpointKvs, Init_LoadsCheckpointAndLaterEntries) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(10)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint32_t(11)));
+  ASSERT_EQ(OkStatus(), kvs_.WriteIndexCheckpoint());
+  EXPECT_FALSE(CheckpointErased());
+
+  // Entries written after the checkpoint are found by scanning.
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint32_t(21)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[2], uint32_t(22)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(20)));
+
+  ExpectValuesAfterReboot(20, 3);
+}
+
+TEST_F(IndexCheckpointKvs, GarbageCollection_ErasesCheckpoint) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(10)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(20)));
+  ASSERT_EQ(OkStatus(), kvs_.WriteIndexCheckpoint());
+
+  ASSERT_EQ(OkStatus(), kvs_.HeavyMaintenance());
+  EXPECT_TRUE(CheckpointErased());
+
+  ExpectValuesAfterReboot(20, 1);
+}
+
+TEST_F(IndexCheckpointKvs, CorruptCheckpoint_FallsBackToFullScan) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(30)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint32_t(31)));
+  ASSERT_EQ(OkStatus(), kvs_.WriteIndexCheckpoint());
+
+  // Flip a bit in the first key descriptor's hash.
+  checkpoint_flash_.buffer()[sizeof(uint32_t) * (5 + 6)] ^= std::byte{1};
+
+  ExpectValuesAfterReboot(30, 2);
+}
+
+TEST_F(IndexCheckpointKvs, StaleCheckpoint_FallsBackToFullScan) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(40)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(41)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(42)));
+  ASSERT_EQ(OkStatus(), kvs_.WriteIndexCheckpoint());
+
+  // Erase the KVS behind the checkpoint's back and write different entries.
+  ASSERT_EQ(OkStatus(), flash_.partition.Erase());
+  {
+    KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash_.partition,
+                                                            kFormat);
+    ASSERT_EQ(OkStatus(), kvs.Init());
+    ASSERT_EQ(OkStatus(), kvs.Put(keys[0], uint32_t(50)));
+    ASSERT_EQ(OkStatus(), kvs.Put(keys[1], uint32_t(51)));
+  }
+
+  ExpectValuesAfterReboot(50, 2);
+}
+
+class BatchKvs : public ::testing::Test {
+ protected:
+  // For KVS magic value always use a random 32 bit integer rather than a
+  // human readable 4 bytes. See pw_kvs/format.h for more information.
+  static constexpr EntryFormat kFormat{.magic = 0x3e5b1f87,
+                                       .checksum = &checksum};
+
+  BatchKvs() : kvs_(&flash_.partition, kFormat) {
+    PW_CHECK_OK(flash_.partition.Erase());
+    PW_CHECK_OK(kvs_.Init());
+  }
+
+  // Initializes a second KVS on the same flash, as if after a reboot.
+  void ExpectValuesAfterReboot(uint32_t first_value, size_t num_keys) {
+    KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash_.partition,
+                                                            kFormat);
+    ASSERT_EQ(OkStatus(), kvs.Init());
+    ASSERT_EQ(num_keys, kvs.size());
+    for (size_t i = 0; i < num_keys; ++i) {
+      uint32_t value = 0;
+      ASSERT_EQ(OkStatus(), kvs.Get(keys[i], &value));
+      EXPECT_EQ(first_value + i, value);
+    }
+  }
+
+  // Erases the last entry written to the flash, as if power was lost before it
+  // was written. Entries of three keys with uint32_t values are 32 bytes.
+  void EraseLastEntry() {
+    span<std::byte> buffer = flash_.memory.buffer();
+    size_t end = buffer.size();
+    while (end > 0 && buffer[end - 1] == std::byte{0xff}) {
+      --end;
+    }
+    ASSERT_GE(end, 32u);
+    end = AlignUp(end, 32);
+    std::memset(&buffer[end - 32], 0xff, 32);
+  }
+
+  Flash flash_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+  KeyValueStoreBatch<3> batch_;
+};
+
+TEST_F(BatchKvs, Commit_WritesAllEntries) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[2], uint32_t(1)));
+
+  // The batch refers to its values, so they must outlive the commit.
+  const uint32_t values[] = {10, 11, 12};
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[0], values[0]));
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[1], values[1]));
+  ASSERT_EQ(OkStatus(), batch_.Delete(keys[2]));
+  EXPECT_EQ(Status::ResourceExhausted(), batch_.Put(keys[2], values[2]));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  EXPECT_EQ(2u, kvs_.size());
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &value));
+  EXPECT_EQ(10u, value);
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &value));
+  EXPECT_EQ(11u, value);
+  EXPECT_EQ(Status::NotFound(), kvs_.Get(keys[2], &value));
+
+  ExpectValuesAfterReboot(10, 2);
+}
+
+TEST_F(BatchKvs, Commit_InvalidOperation_WritesNothing) {
+  const uint32_t values[] = {10, 20};
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[0], values[0]));
+  ASSERT_EQ(OkStatus(), batch_.Delete(keys[1]));
+  EXPECT_EQ(Status::NotFound(), kvs_.Commit(batch_));
+
+  batch_.clear();
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[0], values[0]));
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[0], values[1]));
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.Commit(batch_));
+
+  EXPECT_EQ(0u, kvs_.size());
+  EXPECT_EQ(kvs_.GetStorageStats().in_use_bytes, 0u);
+}
+
+TEST_F(BatchKvs, Init_IgnoresIncompleteBatch) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(10)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint32_t(11)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[2], uint32_t(12)));
+
+  const uint32_t values[] = {20, 21, 22};
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[0], values[0]));
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[1], values[1]));
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[2], values[2]));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  EraseLastEntry();
+  ExpectValuesAfterReboot(10, 3);
+
+  // Entries written after the incomplete batch do not complete it.
+  {
+    KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash_.partition,
+                                                            kFormat);
+    ASSERT_EQ(OkStatus(), kvs.Init());
+    ASSERT_EQ(OkStatus(), kvs.Put(keys[2], uint32_t(12)));
+  }
+  ExpectValuesAfterReboot(10, 3);
+}
+
+TEST_F(BatchKvs, GarbageCollection_RelocatedBatchEntriesSurviveInit) {
+  const uint32_t values[] = {30, 31, 0};
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[0], values[0]));
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[1], values[1]));
+  ASSERT_EQ(OkStatus(), batch_.Put(keys[2], values[2]));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  // Make the last entry of the batch stale, then relocate the others.
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[2], uint32_t(32)));
+  ASSERT_EQ(OkStatus(), kvs_.HeavyMaintenance());
+
+  ExpectValuesAfterReboot(30, 3);
+}
+
+class CompressedKvs : public ::testing::Test {
+ protected:
+  // For KVS magic value always use a random 32 bit integer rather than a
+  // human readable 4 bytes. See pw_kvs/format.h for more information.
+  static constexpr EntryFormat kFormat{.magic = 0x71c8a9e4,
+                                       .checksum = &checksum};
+  static constexpr Options kOptions{.compress_values = true};
+
+  // Text with the repetition typical of serialized configuration.
+  static constexpr char kConfig[] =
+      "{\"channels\":[{\"name\":\"left\",\"gain\":12,\"enabled\":true},"
+      "{\"name\":\"right\",\"gain\":12,\"enabled\":true},"
+      "{\"name\":\"center\",\"gain\":10,\"enabled\":false},"
+      "{\"name\":\"rear\",\"gain\":10,\"enabled\":false}]}";
+
+  CompressedKvs() : kvs_(&flash_.partition, kFormat, kOptions) {
+    PW_CHECK_OK(flash_.partition.Erase());
+    PW_CHECK_OK(kvs_.Init());
+  }
+
+  static span<const std::byte> config() {
+    return as_bytes(span(kConfig, sizeof(kConfig) - 1));
+  }
+
+  void ExpectConfig(KeyValueStore& kvs) {
+    std::array<std::byte, sizeof(kConfig)> value{};
+    const StatusWithSize result = kvs.Get(keys[0], value);
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(config().size(), result.size());
+    EXPECT_EQ(0, std::memcmp(value.data(), kConfig, config().size()));
+    EXPECT_EQ(config().size(), kvs.ValueSize(keys[0]).size());
+  }
+
+  Flash flash_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+};
+
+TEST_F(CompressedKvs, PutAndGet) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], config()));
+  ExpectConfig(kvs_);
+
+  // The value takes less space than it would uncompressed.
+  EXPECT_LT(kvs_.GetStorageStats().in_use_bytes,
+            internal::Entry::size(flash_.partition, keys[0], config()));
+}
+
+TEST_F(CompressedKvs, ReadAfterReboot) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], config()));
+
+  // Compressed values are read regardless of the compress_values option.
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash_.partition,
+                                                          kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  ExpectConfig(kvs);
+}
+
+TEST_F(CompressedKvs, Get_Partial) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], config()));
+
+  std::array<std::byte, 32> value;
+  const StatusWithSize result = kvs_.Get(keys[0], value);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(value.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(value.data(), kConfig, value.size()));
+  EXPECT_EQ(Status::Unimplemented(), kvs_.Get(keys[0], value, 1).status());
+}
+
+TEST_F(CompressedKvs, Put_SameValue_WritesNothing) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], config()));
+  const size_t writable_bytes = kvs_.GetStorageStats().writable_bytes;
+
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], config()));
+  EXPECT_EQ(writable_bytes, kvs_.GetStorageStats().writable_bytes);
+}
+
+TEST_F(CompressedKvs, Put_IncompressibleValue_StoredUncompressed) {
+  const uint32_t value = 0x12345678;
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], value));
+
+  uint32_t read = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &read));
+  EXPECT_EQ(value, read);
+
+  // Uncompressed values may still be read at an offset.
+  std::array<std::byte, 2> part;
+  EXPECT_EQ(OkStatus(), kvs_.Get(keys[1], part, 2).status());
+}
+
+TEST_F(CompressedKvs, Get_CorruptValue_DataLoss) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], config()));
+
+  // Corrupt the last byte of the compressed value, which is a literal.
+  span<std::byte> buffer = flash_.memory.buffer();
+  size_t end = buffer.size();
+  while (end > 0 && buffer[end - 1] != std::byte{'}'}) {
+    --end;
+  }
+  ASSERT_GT(end, 0u);
+  buffer[end - 1] = std::byte{']'};
+
+  std::array<std::byte, sizeof(kConfig)> value;
+  EXPECT_EQ(Status::DataLoss(), kvs_.Get(keys[0], value).status());
+}
+
+TEST_F(CompressedKvs, Commit_CompressesValues) {
+  KeyValueStoreBatch<2> batch;
+  const uint32_t count = 3;
+  ASSERT_EQ(OkStatus(), batch.Put(keys[0], config()));
+  ASSERT_EQ(OkStatus(), batch.Put(keys[1], count));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch));
+
+  ExpectConfig(kvs_);
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &value));
+  EXPECT_EQ(count, value);
+}
+
+TEST_F(CompressedKvs, Commit_Redundant_EachCopyIsReadable) {
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, 2> kvs(
+      &flash_.partition, kFormat, kOptions);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  KeyValueStoreBatch<2> batch;
+  const uint32_t count = 3;
+  ASSERT_EQ(OkStatus(), batch.Put(keys[0], config()));
+  ASSERT_EQ(OkStatus(), batch.Put(keys[1], count));
+  ASSERT_EQ(OkStatus(), kvs.Commit(batch));
+
+  // Erase each sector in turn, so that the values are read from another copy.
+  const size_t sector_size = flash_.partition.sector_size_bytes();
+  std::array<std::byte, 512> saved;
+  ASSERT_EQ(saved.size(), sector_size);
+  for (size_t i = 0; i < flash_.partition.sector_count(); ++i) {
+    span<std::byte> sector =
+        flash_.memory.buffer().subspan(i * sector_size, sector_size);
+    std::copy(sector.begin(), sector.end(), saved.begin());
+    std::fill(sector.begin(), sector.end(), std::byte{0xff});
+
+    ExpectConfig(kvs);
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), kvs.Get(keys[1], &value));
+    EXPECT_EQ(count, value);
+
+    std::copy(saved.begin(), saved.end(), sector.begin());
+  }
+}
+
+TEST_F(CompressedKvs, Put_ChangedValue_IsWritten) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], config()));
+
+  // A value that differs in one byte compresses to the same size.
+  std::array<char, sizeof(kConfig)> changed;
+  std::memcpy(changed.data(), kConfig, sizeof(kConfig));
+  changed[sizeof(kConfig) - 3] = ']';
+  const span<const std::byte> changed_value =
+      as_bytes(span(changed.data(), sizeof(kConfig) - 1));
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], changed_value));
+
+  std::array<std::byte, sizeof(kConfig)> value{};
+  const StatusWithSize result = kvs_.Get(keys[0], value);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(changed_value.size(), result.size());
+  EXPECT_EQ(0, std::memcmp(value.data(), changed.data(), result.size()));
+}
+
+TEST_F(CompressedKvs, GarbageCollection_RelocatesCompressedValues) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], config()));
+  for (uint32_t i = 0; i < 40; ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], i));
+  }
+  ASSERT_EQ(OkStatus(), kvs_.HeavyMaintenance());
+
+  ExpectConfig(kvs_);
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash_.partition, kFormat, kOptions);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  ExpectConfig(kvs);
+}
+
+class GetViewTest : public ::testing::Test {
+ protected:
+  static constexpr char kValue[] = "A value that is read in place";
+
+  GetViewTest() : kvs_(&flash_.partition, default_format) {
+    PW_CHECK_OK(flash_.partition.Erase());
+    PW_CHECK_OK(kvs_.Init());
+    PW_CHECK_OK(kvs_.Put(keys[0], kValue));
+  }
+
+  // Changes a byte of the value in flash.
+  void CorruptValue(span<const std::byte> view) {
+    span<std::byte> buffer = flash_.memory.buffer();
+    buffer[static_cast<size_t>(view.data() - buffer.data())] = std::byte{'?'};
+  }
+
+  Flash flash_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+};
+
+TEST_F(GetViewTest, ReturnsValueInFlash) {
+  const Result<span<const std::byte>> view = kvs_.GetView(keys[0]);
+  ASSERT_EQ(OkStatus(), view.status());
+  ASSERT_EQ(sizeof(kValue), view->size());
+  EXPECT_EQ(0, std::memcmp(view->data(), kValue, sizeof(kValue)));
+
+  const span<std::byte> buffer = flash_.memory.buffer();
+  EXPECT_GE(view->data(), buffer.data());
+  EXPECT_LT(view->data(), buffer.data() + buffer.size());
+}
+
+TEST_F(GetViewTest, Iterator) {
+  for (const KeyValueStore::Item& item : kvs_) {
+    const Result<span<const std::byte>> view = item.GetView();
+    ASSERT_EQ(OkStatus(), view.status());
+    EXPECT_EQ(0, std::memcmp(view->data(), kValue, sizeof(kValue)));
+  }
+}
+
+TEST_F(GetViewTest, MissingKey_NotFound) {
+  EXPECT_EQ(Status::NotFound(), kvs_.GetView(keys[1]).status());
+  ASSERT_EQ(OkStatus(), kvs_.Delete(keys[0]));
+  EXPECT_EQ(Status::NotFound(), kvs_.GetView(keys[0]).status());
+}
+
+TEST_F(GetViewTest, CorruptValue_DataLoss) {
+  const Result<span<const std::byte>> view = kvs_.GetView(keys[0]);
+  ASSERT_EQ(OkStatus(), view.status());
+  CorruptValue(*view);
+
+  // The checksum of the last entry viewed is not verified again.
+  EXPECT_EQ(OkStatus(), kvs_.GetView(keys[0]).status());
+
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], kValue));
+  EXPECT_EQ(OkStatus(), kvs_.GetView(keys[1]).status());
+  EXPECT_EQ(Status::DataLoss(), kvs_.GetView(keys[0]).status());
+}
+
+TEST_F(GetViewTest, CompressedValue_Unimplemented) {
+  char value[64];
+  std::memset(value, 'a', sizeof(value));
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash_.partition, default_format, {.compress_values = true});
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  ASSERT_EQ(OkStatus(), kvs.Put(keys[1], value));
+
+  EXPECT_EQ(Status::Unimplemented(), kvs.GetView(keys[1]).status());
+  EXPECT_EQ(OkStatus(), kvs.GetView(keys[0]).status());
+}
+
+TEST(GetView, NotMemoryMapped_Unimplemented) {
+  class UnmappedFlash : public FakeFlashMemoryBuffer<512, 4> {
+   public:
+    UnmappedFlash() : FakeFlashMemoryBuffer<512, 4>(16) {}
+
+    std::byte* FlashAddressToMcuAddress(Address) const override {
+      return nullptr;
+    }
+  } flash;
+  FlashPartition partition(&flash);
+  ASSERT_EQ(OkStatus(), partition.Erase());
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&partition,
+                                                          default_format);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  ASSERT_EQ(OkStatus(), kvs.Put(keys[0], uint32_t{1}));
+  EXPECT_EQ(Status::Unimplemented(), kvs.GetView(keys[0]).status());
+}
+
 TEST(InMemoryKvs, Put_MaxValueSize) {
   // Create and erase the fake flash.
   Flash flash;
@@ -115,5 +115,45 @@ TEST_F(WearTest, TwoPassFillWithLargeAndLarger) {
             2u * partition_.average_erase_count());
 }
 
+// Write a key that changes often in a KVS that also holds data that never
+// changes. With wear leveling, the sectors holding the unchanging data are
+// garbage collected too, so that no sector falls far behind in erases.
+TEST_F(WearTest, WearLevelingMovesUnchangingData) {
+  constexpr uint32_t kThreshold = 4;
+  Options options;
+  options.wear_leveling_threshold = kThreshold;
+
+  ASSERT_EQ(OkStatus(), partition_.Erase());
+  partition_.ResetCounters();
+  KeyValueStoreBuffer<kMaxEntries, kSectors> kvs(&partition_, format, options);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  // Each of these entries fills most of a sector.
+  const char* const kColdKeys[] = {"cold0", "cold1", "cold2", "cold3"};
+  for (const char* key : kColdKeys) {
+    ASSERT_EQ(OkStatus(), kvs.Put(key, span(test_data, 400)));
+  }
+
+  for (size_t i = 0; i < kSectors * 20; ++i) {
+    test_data[0]++;
+    ASSERT_EQ(OkStatus(), kvs.Put("hot", span(test_data, 300)));
+  }
+
+  EXPECT_GE(partition_.min_erase_count(), 5u);
+  EXPECT_LE(partition_.max_erase_count(),
+            partition_.min_erase_count() + kThreshold + 1);
+
+  const KeyValueStore::StorageStats stats = kvs.GetStorageStats();
+  EXPECT_EQ(stats.max_sector_erase_count, partition_.max_erase_count());
+
+  // The erase counts are read back from flash.
+  KeyValueStoreBuffer<kMaxEntries, kSectors> reloaded(
+      &partition_, format, options);
+  ASSERT_EQ(OkStatus(), reloaded.Init());
+  EXPECT_EQ(stats.max_sector_erase_count,
+            reloaded.GetStorageStats().max_sector_erase_count);
+  EXPECT_EQ(reloaded.size(), 5u);
+}
+
 }  // namespace
 }  // namespace pw::kvs
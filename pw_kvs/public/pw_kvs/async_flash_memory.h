@@ -0,0 +1,116 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pw_function/function.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::kvs {
+
+// A FlashMemory with non-blocking erase, read, and write operations.
+//
+// Flash controllers that signal completion with an interrupt can implement
+// this class to let callers do useful work while an erase or program is in
+// progress. Each operation is started with a Start function, which returns
+// immediately, and reports its result through a callback when it finishes:
+//
+//   flash.StartErase(next_sector_address, 1, [](StatusWithSize result) {
+//     erase_done.release();
+//   });
+//   PW_TRY(FillBufferWhileErasing());
+//   erase_done.acquire();
+//
+// The blocking FlashMemory API is implemented on top of the Start functions,
+// so an AsyncFlashMemory can be used anywhere a FlashMemory is, such as by a
+// FlashPartition for KVS or BlobStore.
+//
+// How many operations may be in progress at once depends on the hardware. A
+// controller with one bank typically allows a single operation, while dual
+// bank parts can program one bank while erasing the other. Start functions
+// return UNAVAILABLE when the flash cannot accept another operation until one
+// finishes. Blocking calls wait for their own operation only, so they must not
+// be used while an asynchronous operation they conflict with is in progress.
+class AsyncFlashMemory : public FlashMemory {
+ public:
+  // Called once when an operation finishes, possibly from interrupt context.
+  // The StatusWithSize has the same meaning as the blocking call's result; for
+  // erases, the size is zero.
+  using Callback = Function<void(StatusWithSize result)>;
+
+  // Starts erasing num_sectors starting at a given address, which must be on a
+  // sector boundary. Returns:
+  //
+  // OK - the erase started; done is called when it finishes.
+  // UNAVAILABLE - the flash is busy with another operation.
+  // INVALID_ARGUMENT - address or sector count is invalid.
+  //
+  // done is not called unless the operation starts.
+  Status StartErase(Address flash_address,
+                    size_t num_sectors,
+                    Callback&& done) {
+    return DoStartErase(flash_address, num_sectors, std::move(done));
+  }
+
+  // Starts reading bytes from flash into output, which must remain valid until
+  // done is called. Returns the same errors as StartErase().
+  Status StartRead(Address address, span<std::byte> output, Callback&& done) {
+    return DoStartRead(address, output, std::move(done));
+  }
+
+  // Starts writing bytes to flash. data must remain valid until done is called.
+  // The address and size must be multiples of alignment_bytes(). Returns the
+  // same errors as StartErase().
+  Status StartWrite(Address destination_flash_address,
+                    span<const std::byte> data,
+                    Callback&& done) {
+    return DoStartWrite(destination_flash_address, data, std::move(done));
+  }
+
+  // Blocking FlashMemory functions, which start an operation and wait on a
+  // pw::sync::ThreadNotification for it to finish. These must be called from a
+  // thread, not from interrupt context.
+  Status Erase(Address flash_address, size_t num_sectors) final;
+
+  using FlashMemory::Read;
+  StatusWithSize Read(Address address, span<std::byte> output) final;
+
+  using FlashMemory::Write;
+  StatusWithSize Write(Address destination_flash_address,
+                       span<const std::byte> data) final;
+
+ protected:
+  using FlashMemory::FlashMemory;
+
+ private:
+  virtual Status DoStartErase(Address flash_address,
+                              size_t num_sectors,
+                              Callback&& done) = 0;
+
+  virtual Status DoStartRead(Address address,
+                             span<std::byte> output,
+                             Callback&& done) = 0;
+
+  virtual Status DoStartWrite(Address destination_flash_address,
+                              span<const std::byte> data,
+                              Callback&& done) = 0;
+};
+
+}  // namespace pw::kvs
@@ -0,0 +1,76 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_kvs/async_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_sync/thread_notification.h"
+
+namespace pw::kvs {
+
+// KeyValueStore::RedundantWriter that programs a kvs::AsyncFlashMemory. The
+// flash must be the memory that the KVS's partition is on. Whether the copies
+// of an entry program concurrently depends on the flash, such as whether their
+// sectors are in different banks.
+//
+// Declare instances as AsyncFlashRedundantWriterBuffer<kMaxWrites>, where
+// kMaxWrites is at least the KVS's redundancy.
+class AsyncFlashRedundantWriter : public KeyValueStore::RedundantWriter {
+ public:
+  AsyncFlashRedundantWriter(const AsyncFlashRedundantWriter&) = delete;
+  AsyncFlashRedundantWriter& operator=(const AsyncFlashRedundantWriter&) =
+      delete;
+
+ protected:
+  struct Write {
+    sync::ThreadNotification done;
+    Status result;
+  };
+
+  AsyncFlashRedundantWriter(AsyncFlashMemory& flash, span<Write> writes)
+      : flash_(flash), writes_(writes), oldest_(0), in_progress_(0) {}
+
+ private:
+  Status DoStartWrite(FlashPartition& partition,
+                      FlashPartition::Address address,
+                      span<const std::byte> data) override;
+  Status DoWaitForWrite() override;
+
+  AsyncFlashMemory& flash_;
+
+  // The writes in progress, as a ring buffer in the order they were started.
+  const span<Write> writes_;
+  size_t oldest_;
+  size_t in_progress_;
+};
+
+template <size_t kMaxWrites>
+class AsyncFlashRedundantWriterBuffer final : public AsyncFlashRedundantWriter {
+ public:
+  static_assert(kMaxWrites > 0u);
+
+  explicit AsyncFlashRedundantWriterBuffer(AsyncFlashMemory& flash)
+      : AsyncFlashRedundantWriter(flash, write_buffer_) {}
+
+ private:
+  std::array<Write, kMaxWrites> write_buffer_;
+};
+
+}  // namespace pw::kvs
@@ -290,6 +290,11 @@ class FlashPartition {
   // UNKNOWN - HAL error
   virtual StatusWithSize Write(Address address, span<const std::byte> data);
 
+  // Programs any data the partition buffers in RAM, so that it survives a
+  // reset. The base FlashPartition writes directly to flash, so this does
+  // nothing. Returns the same errors as Write().
+  virtual Status Flush() { return OkStatus(); }
+
   // Check to see if chunk of flash partition is erased. Address and len need to
   // be aligned with FlashMemory. Returns:
   //
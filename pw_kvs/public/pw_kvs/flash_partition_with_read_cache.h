@@ -0,0 +1,136 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::kvs {
+
+// A FlashPartition that keeps recently read blocks of flash in RAM, so that
+// reading the same data again does not access the flash.
+//
+// Each read that misses the cache reads whole blocks from flash. The least
+// recently used block is replaced when the cache is full. This suits flash
+// where each read is a costly bus transaction, such as SPI NOR flash. For
+// example, a KVS reads an entry's header, key, and value in separate reads,
+// which are served by a single flash read when the entry fits in a block.
+//
+// Blocks that a read covers entirely and that are not cached are read directly
+// into the output, so reading large values does not evict the cache.
+//
+// Write() and Erase() invalidate the cached blocks that they touch, so the
+// cache is invisible to code using the FlashPartition API. Writes to the flash
+// that do not go through this partition are not seen until the blocks are
+// evicted or Invalidate() is called.
+class FlashPartitionWithReadCache : public FlashPartition {
+ public:
+  // Tracks which partition block a cache block holds.
+  struct Block {
+    Address address;
+    uint32_t last_used;  // 0 if the block is empty.
+  };
+
+  FlashPartitionWithReadCache(const FlashPartitionWithReadCache&) = delete;
+  FlashPartitionWithReadCache& operator=(const FlashPartitionWithReadCache&) =
+      delete;
+
+  using FlashPartition::Erase;
+  using FlashPartition::Read;
+
+  Status Erase(Address address, size_t num_sectors) override;
+
+  StatusWithSize Read(Address address, span<std::byte> output) override;
+
+  StatusWithSize Write(Address address, span<const std::byte> data) override;
+
+  // Discards all cached blocks.
+  void Invalidate();
+
+  // Size of the cached blocks.
+  size_t block_size_bytes() const { return block_size_; }
+
+  // Number of blocks the cache holds.
+  size_t block_count() const { return blocks_.size(); }
+
+ protected:
+  // The buffer holds blocks.size() blocks. Its size divided by blocks.size()
+  // is the block size, which must evenly divide the sector size.
+  FlashPartitionWithReadCache(
+      span<std::byte> buffer,
+      span<Block> blocks,
+      FlashMemory* flash,
+      uint32_t flash_start_sector_index,
+      uint32_t flash_sector_count,
+      uint32_t alignment_bytes = 0,  // Defaults to flash alignment
+      PartitionPermission permission = PartitionPermission::kReadAndWrite);
+
+ private:
+  // Finds the cache block holding the partition block at block_address,
+  // reading it from flash into the least recently used cache block if it is
+  // not cached.
+  Status Load(Address block_address, size_t* index);
+
+  bool IsCached(Address block_address) const;
+
+  // Discards cached blocks that overlap [address, address + size).
+  void Invalidate(Address address, size_t size);
+
+  span<std::byte> block_data(size_t index) {
+    return buffer_.subspan(index * block_size_, block_size_);
+  }
+
+  const span<std::byte> buffer_;
+  const span<Block> blocks_;
+  const size_t block_size_;
+  uint32_t uses_ = 0;
+};
+
+// A FlashPartitionWithReadCache that caches kBlockCount blocks of
+// kBlockSizeBytes.
+template <size_t kBlockSizeBytes, size_t kBlockCount>
+class FlashPartitionWithReadCacheBuffer : public FlashPartitionWithReadCache {
+ public:
+  static_assert(kBlockSizeBytes > 0u && kBlockCount > 0u);
+
+  FlashPartitionWithReadCacheBuffer(
+      FlashMemory* flash,
+      uint32_t flash_start_sector_index,
+      uint32_t flash_sector_count,
+      uint32_t alignment_bytes = 0,  // Defaults to flash alignment
+      PartitionPermission permission = PartitionPermission::kReadAndWrite)
+      : FlashPartitionWithReadCache(buffer_,
+                                    blocks_,
+                                    flash,
+                                    flash_start_sector_index,
+                                    flash_sector_count,
+                                    alignment_bytes,
+                                    permission) {}
+
+  FlashPartitionWithReadCacheBuffer(FlashMemory* flash)
+      : FlashPartitionWithReadCacheBuffer(
+            flash, 0, flash->sector_count(), flash->alignment_bytes()) {}
+
+ private:
+  std::array<std::byte, kBlockSizeBytes * kBlockCount> buffer_;
+  std::array<Block, kBlockCount> blocks_{};
+};
+
+}  // namespace pw::kvs
@@ -32,6 +32,10 @@ class FlashPartitionWithStats : public FlashPartition {
  public:
   // Save flash partition and KVS storage stats. Does not save if
   // sector_counters_ is zero.
+  //
+  // The stats are appended to flash_stats.csv in the test output directory
+  // named by TEST_UNDECLARED_OUTPUTS_DIR if it is set, such as under Bazel, or
+  // in the temporary directory otherwise.
   Status SaveStorageStats(const KeyValueStore& kvs, const char* label);
 
   using FlashPartition::Erase;
@@ -90,8 +94,26 @@ class FlashPartitionWithStats : public FlashPartition {
   Vector<size_t>& sector_counters_;
 };
 
+namespace internal {
+
+// Storage for FlashPartitionWithStatsBuffer's sector counters. This is a base
+// class so that the counters are constructed before FlashPartitionWithStats,
+// whose constructor fills them in.
+template <size_t kMaxSectors>
+class SectorCountersBuffer {
+ protected:
+  // If PW_KVS_RECORD_PARTITION_STATS is not set, use zero size vector which
+  // will not save any stats.
+  Vector<size_t, PW_KVS_RECORD_PARTITION_STATS ? kMaxSectors : 0>
+      sector_counters_buffer_;
+};
+
+}  // namespace internal
+
 template <size_t kMaxSectors>
-class FlashPartitionWithStatsBuffer : public FlashPartitionWithStats {
+class FlashPartitionWithStatsBuffer
+    : private internal::SectorCountersBuffer<kMaxSectors>,
+      public FlashPartitionWithStats {
  public:
   FlashPartitionWithStatsBuffer(
       FlashMemory* flash,
@@ -99,7 +121,7 @@ class FlashPartitionWithStatsBuffer : public FlashPartitionWithStats {
       uint32_t flash_sector_count,
       uint32_t alignment_bytes = 0,  // Defaults to flash alignment
       PartitionPermission permission = PartitionPermission::kReadAndWrite)
-      : FlashPartitionWithStats(sector_counters_,
+      : FlashPartitionWithStats(this->sector_counters_buffer_,
                                 flash,
                                 flash_start_sector_index,
                                 flash_sector_count,
@@ -109,12 +131,6 @@ class FlashPartitionWithStatsBuffer : public FlashPartitionWithStats {
   FlashPartitionWithStatsBuffer(FlashMemory* flash)
       : FlashPartitionWithStatsBuffer(
             flash, 0, flash->sector_count(), flash->alignment_bytes()) {}
-
- private:
-  // If PW_KVS_RECORD_PARTITION_STATS is not set, use zero size vector which
-  // will not save any stats.
-  Vector<size_t, PW_KVS_RECORD_PARTITION_STATS ? kMaxSectors : 0>
-      sector_counters_;
 };
 
 }  // namespace pw::kvs
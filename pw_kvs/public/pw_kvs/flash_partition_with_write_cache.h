@@ -0,0 +1,133 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::kvs {
+
+// A FlashPartition that collects small writes in a one-page write-back cache,
+// so that adjacent writes are programmed to flash as a single write.
+//
+// Many flash parts program a whole page, such as 256 bytes of NOR flash, in
+// about the time it takes to program a single aligned word. Writes smaller
+// than a page, such as KVS entries, are copied into the cache and programmed
+// when the page fills, when a write to a different location arrives, or when
+// Flush() is called. Writes that cover whole pages while the cache is empty
+// are programmed directly.
+//
+// Reads through the partition return cached data, so the cache is invisible
+// to code using the FlashPartition API. Memory-mapped reads through
+// PartitionAddressToMcuAddress() only see data once it is flushed.
+//
+// Power-loss semantics: writes are durable only once they are programmed.
+// Data still in the cache when power is lost is gone, as if the writes never
+// happened. At most one page of the most recently written data is cached.
+// Erase() programs the cache before erasing other sectors, so data that was
+// copied elsewhere before an erase, such as KVS garbage collection, is never
+// lost. Call Flush() after writes that must survive a reset, for example
+// after a KVS Put() that must not be lost.
+//
+// Errors from programming cached data are returned by the Write(), Erase(), or
+// Flush() call that programs it. The cached data is discarded on error.
+class FlashPartitionWithWriteCache : public FlashPartition {
+ public:
+  FlashPartitionWithWriteCache(const FlashPartitionWithWriteCache&) = delete;
+  FlashPartitionWithWriteCache& operator=(const FlashPartitionWithWriteCache&) =
+      delete;
+
+  using FlashPartition::Erase;
+  using FlashPartition::Read;
+
+  Status Erase(Address address, size_t num_sectors) override;
+
+  StatusWithSize Read(Address address, span<std::byte> output) override;
+
+  // Writes bytes to the cache or flash. Address and data.size_bytes() must
+  // both be a multiple of alignment_bytes(). Returns the same errors as
+  // FlashPartition::Write(), which may come from programming previously cached
+  // data.
+  StatusWithSize Write(Address address, span<const std::byte> data) override;
+
+  // Programs the cached data, if any, to flash.
+  Status Flush() override;
+
+  // Size of the cache, which is the flash page size.
+  size_t page_size_bytes() const { return page_.size(); }
+
+  // Number of bytes written to the cache that are not yet programmed.
+  size_t cached_bytes() const { return cache_end_ - cache_start_; }
+
+ protected:
+  // page_buffer must be a multiple of the alignment and evenly divide the
+  // sector size. Derived classes that own the buffer should call Flush() from
+  // their destructor.
+  FlashPartitionWithWriteCache(
+      span<std::byte> page_buffer,
+      FlashMemory* flash,
+      uint32_t flash_start_sector_index,
+      uint32_t flash_sector_count,
+      uint32_t alignment_bytes = 0,  // Defaults to flash alignment
+      PartitionPermission permission = PartitionPermission::kReadAndWrite);
+
+ private:
+  // Starts caching at an address with an empty cache.
+  void StartCaching(Address address);
+
+  const span<std::byte> page_;
+  Address page_address_ = 0;  // Partition address of the cached page.
+
+  // The cached data is page_[cache_start_, cache_end_). The cache is empty if
+  // cache_start_ == cache_end_.
+  size_t cache_start_ = 0;
+  size_t cache_end_ = 0;
+};
+
+// A FlashPartitionWithWriteCache with a cache for pages of kPageSizeBytes.
+template <size_t kPageSizeBytes>
+class FlashPartitionWithWriteCacheBuffer : public FlashPartitionWithWriteCache {
+ public:
+  FlashPartitionWithWriteCacheBuffer(
+      FlashMemory* flash,
+      uint32_t flash_start_sector_index,
+      uint32_t flash_sector_count,
+      uint32_t alignment_bytes = 0,  // Defaults to flash alignment
+      PartitionPermission permission = PartitionPermission::kReadAndWrite)
+      : FlashPartitionWithWriteCache(page_buffer_,
+                                     flash,
+                                     flash_start_sector_index,
+                                     flash_sector_count,
+                                     alignment_bytes,
+                                     permission) {}
+
+  FlashPartitionWithWriteCacheBuffer(FlashMemory* flash)
+      : FlashPartitionWithWriteCacheBuffer(
+            flash, 0, flash->sector_count(), flash->alignment_bytes()) {}
+
+  // Programs any cached data. Errors cannot be reported; call Flush() first to
+  // check them.
+  ~FlashPartitionWithWriteCacheBuffer() override { Flush().IgnoreError(); }
+
+ private:
+  std::array<std::byte, kPageSizeBytes> page_buffer_;
+};
+
+}  // namespace pw::kvs
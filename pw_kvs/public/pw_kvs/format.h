@@ -68,11 +68,15 @@ struct EntryHeader {
 
   // The length of the key in bytes. The key is not null terminated.
   //  6 bits, 0:5 - key length - maximum 64 characters
-  //  2 bits, 6:7 - reserved
+  //  1 bit,    6 - set if the value is compressed; see
+  //                pw_kvs/internal/compression.h
+  //  1 bit,    7 - set if this entry is followed by more entries of the same
+  //                batch; the batch takes effect once its last entry is found
   uint8_t key_length_bytes;
 
-  // Byte length of the value; maximum of 65534. The max uint16_t value (65535
-  // or 0xFFFF) is reserved to indicate this is a tombstone (deleted) entry.
+  // Byte length of the value in flash, which is its compressed length if it is
+  // compressed; maximum of 65534. The max uint16_t value (65535 or 0xFFFF) is
+  // reserved to indicate this is a tombstone (deleted) entry.
   uint16_t value_size_bytes;
 
   // The transaction ID for this key. Monotonically increasing.
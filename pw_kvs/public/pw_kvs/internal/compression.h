@@ -0,0 +1,57 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This file defines the compression used for KVS values.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_kvs/io.h"
+#include "pw_span/span.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw {
+namespace kvs {
+namespace internal {
+
+// A compressed value is its uncompressed size as a little-endian uint32_t,
+// followed by the value compressed in the LZ4 block format.
+inline constexpr size_t kCompressedSizePrefixBytes = sizeof(uint32_t);
+
+// Compresses data, writing the compressed value to the output in pieces.
+// Returns the output's error, if any, or the compressed size. The compressed
+// value is always the same for the same data, so data may be compressed again
+// to recalculate or compare it rather than buffering it.
+StatusWithSize Compress(span<const std::byte> data, Output& output);
+
+// Returns the size of data after compression.
+size_t CompressedSize(span<const std::byte> data);
+
+// Decompresses a value of compressed_size bytes read from the input into the
+// output buffer. Returns one of the following:
+//
+//                   OK: the value was decompressed; its size is returned
+//   RESOURCE_EXHAUSTED: the output buffer was filled with the start of the
+//                       value before it was complete
+//            DATA_LOSS: the compressed value is invalid
+//
+// Errors from reading the input are also returned.
+StatusWithSize Decompress(Input& input,
+                          size_t compressed_size,
+                          span<std::byte> output);
+
+}  // namespace internal
+}  // namespace kvs
+}  // namespace pw
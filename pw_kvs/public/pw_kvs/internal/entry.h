@@ -61,15 +61,46 @@ class Entry {
                         size_t key_length,
                         char* key);
 
-  // Creates a new Entry for a valid (non-deleted) entry.
+  // Creates a new Entry for a valid (non-deleted) entry. If compress is true,
+  // the value is compressed if that makes it smaller.
   static Entry Valid(FlashPartition& partition,
                      Address address,
                      const EntryFormat& format,
                      Key key,
                      span<const std::byte> value,
-                     uint32_t transaction_id) {
-    return Entry(
-        partition, address, format, key, value, value.size(), transaction_id);
+                     uint32_t transaction_id,
+                     bool continues_batch = false,
+                     bool compress = false) {
+    return ValidWithStoredSize(partition,
+                               address,
+                               format,
+                               key,
+                               value,
+                               StoredValueSize(value, compress),
+                               transaction_id,
+                               continues_batch);
+  }
+
+  // Creates a new Entry for a valid entry whose value occupies
+  // stored_value_size bytes in flash, as calculated by StoredValueSize. This
+  // avoids compressing the value again to find its size.
+  static Entry ValidWithStoredSize(FlashPartition& partition,
+                                   Address address,
+                                   const EntryFormat& format,
+                                   Key key,
+                                   span<const std::byte> value,
+                                   size_t stored_value_size,
+                                   uint32_t transaction_id,
+                                   bool continues_batch = false) {
+    return Entry(partition,
+                 address,
+                 format,
+                 key,
+                 value,
+                 static_cast<uint16_t>(stored_value_size),
+                 transaction_id,
+                 continues_batch,
+                 stored_value_size < value.size());
   }
 
   // Creates a new Entry for a tombstone entry, which marks a deleted key.
@@ -77,14 +108,17 @@ class Entry {
                          Address address,
                          const EntryFormat& format,
                          Key key,
-                         uint32_t transaction_id) {
+                         uint32_t transaction_id,
+                         bool continues_batch = false) {
     return Entry(partition,
                  address,
                  format,
                  key,
                  {},
                  kDeletedValueLength,
-                 transaction_id);
+                 transaction_id,
+                 continues_batch,
+                 /*compressed=*/false);
   }
 
   Entry() = default;
@@ -99,6 +133,13 @@ class Entry {
 
   StatusWithSize Write(Key key, span<const std::byte> value) const;
 
+  // Writes this entry, including its padding, to an AlignedWriter. Several
+  // entries may be written back to back with the same writer, which batches
+  // them into fewer flash writes. The writer must be flushed afterwards.
+  StatusWithSize Write(AlignedWriter& writer,
+                       Key key,
+                       span<const std::byte> value) const;
+
   // Changes the format and transcation ID for this entry. In order to calculate
   // the new checksum, the entire entry is read into a small stack-allocated
   // buffer. The updated entry may be written to flash using the Copy function.
@@ -109,6 +150,11 @@ class Entry {
   // what is in flash, is used.
   StatusWithSize Copy(Address new_address) const;
 
+  // Clears the flag that marks this entry as followed by more entries of its
+  // batch, and recalculates the checksum. Entries must stop referring to their
+  // batch before they are copied away from it.
+  Status DetachFromBatch();
+
   // Reads a key into a buffer, which must be large enough for a max-length key.
   // If successful, the size is returned in the StatusWithSize. The key is not
   // null terminated.
@@ -119,29 +165,65 @@ class Entry {
         ReadKey(partition(), address_, key_length(), key.data()), key_length());
   }
 
+  // Reads the value as it is stored in flash, which is compressed if
+  // compressed() is true.
   StatusWithSize ReadValue(span<std::byte> buffer,
                            size_t offset_bytes = 0) const;
 
+  // Decompresses a compressed value into the buffer. If verify is true and the
+  // buffer fits the whole value, the entry's checksum is verified as the value
+  // is read, rather than by reading the entry again.
+  StatusWithSize ReadCompressedValue(span<std::byte> buffer,
+                                     bool verify) const;
+
+  // Returns the size of the value, after decompressing it if it is
+  // compressed. The size of a compressed value is read from flash.
+  StatusWithSize ReadValueSize() const;
+
+  // Checks if the value in flash matches the value, compressing the value to
+  // compare it if the value in flash is compressed.
   Status ValueMatches(span<const std::byte> value) const;
 
   Status VerifyChecksum(Key key, span<const std::byte> value) const;
 
   Status VerifyChecksumInFlash() const;
 
-  // Calculates the total size of an entry, including padding.
+  // Calculates the total size of an entry, including padding. If compress is
+  // true, the value is compressed if that makes it smaller.
   static size_t size(const FlashPartition& partition,
                      Key key,
-                     span<const std::byte> value) {
-    return AlignUp(sizeof(EntryHeader) + key.size() + value.size(),
+                     span<const std::byte> value,
+                     bool compress = false) {
+    return SizeWithStoredValue(
+        partition, key, StoredValueSize(value, compress));
+  }
+
+  // Calculates the total size of an entry, including padding, whose value
+  // occupies stored_value_size bytes in flash.
+  static size_t SizeWithStoredValue(const FlashPartition& partition,
+                                    Key key,
+                                    size_t stored_value_size) {
+    return AlignUp(sizeof(EntryHeader) + key.size() + stored_value_size,
                    std::max(partition.alignment_bytes(), kMinAlignmentBytes));
   }
 
+  // The number of bytes that a value occupies in flash. If compress is true and
+  // compressing the value makes it smaller, this is its compressed size.
+  // Calculating the compressed size compresses the value, so writers calculate
+  // it once and pass it to SizeWithStoredValue and ValidWithStoredSize.
+  static size_t StoredValueSize(span<const std::byte> value, bool compress);
+
   // Byte size of overhead (not-key, not-value) in an entry. Does not include
   // any paddding used to get proper size alignment.
   static constexpr size_t entry_overhead() { return sizeof(EntryHeader); }
 
   Address address() const { return address_; }
 
+  // The address of the value, which follows the header and key.
+  Address value_address() const {
+    return address_ + sizeof(EntryHeader) + key_length();
+  }
+
   void set_address(Address address) { address_ = address; }
 
   // The address at which the next possible entry could be located.
@@ -151,10 +233,12 @@ class Entry {
   size_t size() const { return AlignUp(content_size(), alignment_bytes()); }
 
   // The length of the key in bytes. Keys are not null terminated.
-  size_t key_length() const { return header_.key_length_bytes; }
+  size_t key_length() const {
+    return header_.key_length_bytes & kKeyLengthMask;
+  }
 
-  // The size of the value, without padding. The size is 0 if this is a
-  // tombstone entry.
+  // The size of the value in flash, without padding, which is its compressed
+  // size if it is compressed. The size is 0 if this is a tombstone entry.
   size_t value_size() const {
     return deleted() ? 0u : header_.value_size_bytes;
   }
@@ -163,6 +247,17 @@ class Entry {
 
   uint32_t transaction_id() const { return header_.transaction_id; }
 
+  // True if more entries of the same batch follow this one. A batch is only
+  // valid once its last entry, which does not have this flag set, is written.
+  bool continues_batch() const {
+    return (header_.key_length_bytes & kContinuesBatchFlag) != 0u;
+  }
+
+  // True if the value is compressed.
+  bool compressed() const {
+    return (header_.key_length_bytes & kCompressedFlag) != 0u;
+  }
+
   // True if this is a tombstone entry.
   bool deleted() const {
     return header_.value_size_bytes == kDeletedValueLength;
@@ -172,6 +267,9 @@ class Entry {
 
  private:
   static constexpr uint16_t kDeletedValueLength = 0xFFFF;
+  static constexpr uint8_t kKeyLengthMask = 0b111111;
+  static constexpr uint8_t kCompressedFlag = 0b01000000;
+  static constexpr uint8_t kContinuesBatchFlag = 0b10000000;
 
   Entry(FlashPartition& partition,
         Address address,
@@ -179,7 +277,9 @@ class Entry {
         Key key,
         span<const std::byte> value,
         uint16_t value_size_bytes,
-        uint32_t transaction_id);
+        uint32_t transaction_id,
+        bool continues_batch,
+        bool compressed);
 
   constexpr Entry(FlashPartition* partition,
                   Address address,
@@ -199,6 +299,9 @@ class Entry {
     return sizeof(EntryHeader) + key_length() + value_size();
   }
 
+  // Writes the value as it is stored in flash, compressing it if needed.
+  Status WriteValue(AlignedWriter& writer, span<const std::byte> value) const;
+
   span<const std::byte> checksum_bytes() const {
     return as_bytes(span<const uint32_t>(&header_.checksum, 1));
   }
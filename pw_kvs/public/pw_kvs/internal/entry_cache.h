@@ -29,6 +29,8 @@ namespace pw {
 namespace kvs {
 namespace internal {
 
+class EntryCache;
+
 // Caches information about a key-value entry. Facilitates quickly finding
 // entries without having to read flash.
 class EntryMetadata {
@@ -37,11 +39,11 @@ class EntryMetadata {
 
   EntryMetadata() = default;
 
-  uint32_t hash() const { return descriptor_->key_hash; }
+  inline uint32_t hash() const;
 
-  uint32_t transaction_id() const { return descriptor_->transaction_id; }
+  inline uint32_t transaction_id() const;
 
-  EntryState state() const { return descriptor_->state; }
+  inline EntryState state() const;
 
   // The first known address of this entry.
   uint32_t first_address() const { return addresses_[0]; }
@@ -70,21 +72,30 @@ class EntryMetadata {
   void RemoveAddress(Address address_to_remove);
 
   // Resets the KeyDescrtiptor and addresses to refer to the provided
-  // KeyDescriptor and address.
+  // KeyDescriptor and address. If the EntryCache has a hash index, the key
+  // hash must not change.
   void Reset(const KeyDescriptor& descriptor, Address address);
 
  private:
   friend class EntryCache;
 
-  constexpr EntryMetadata(KeyDescriptor& descriptor, span<Address> addresses)
-      : descriptor_(&descriptor), addresses_(addresses) {}
+  constexpr EntryMetadata(const EntryCache& entry_cache,
+                          size_t index,
+                          span<Address> addresses)
+      : entry_cache_(&entry_cache), index_(index), addresses_(addresses) {}
 
-  KeyDescriptor* descriptor_;
+  const EntryCache* entry_cache_;
+  size_t index_;
   span<Address> addresses_;
 };
 
 // Tracks entry metadata. Combines KeyDescriptors and with their associated
 // addresses.
+//
+// The fields of the KeyDescriptors are stored in parallel arrays rather than as
+// an array of structs. Lookups only compare key hashes, so keeping the hashes
+// contiguous lets a scan or a hash index probe touch a third of the memory and
+// lets the compiler compare several hashes at once.
 class EntryCache {
  private:
   enum Constness : bool { kMutable = false, kConst = true };
@@ -97,7 +108,7 @@ class EntryCache {
         std::conditional_t<kIsConst, const EntryMetadata, EntryMetadata>;
 
     Iterator& operator++() {
-      ++metadata_.descriptor_;
+      ++metadata_.index_;
       return *this;
     }
 
@@ -109,31 +120,29 @@ class EntryCache {
 
     // Updates the internal EntryMetadata object.
     value_type& operator*() const {
-      metadata_.addresses_ = entry_cache_->addresses(
-          metadata_.descriptor_ - entry_cache_->descriptors_.begin());
+      metadata_.addresses_ =
+          metadata_.entry_cache_->addresses(metadata_.index_);
       return metadata_;
     }
     value_type* operator->() const { return &operator*(); }
 
     constexpr bool operator==(const Iterator& rhs) const {
-      return metadata_.descriptor_ == rhs.metadata_.descriptor_;
+      return metadata_.index_ == rhs.metadata_.index_;
     }
     constexpr bool operator!=(const Iterator& rhs) const {
-      return metadata_.descriptor_ != rhs.metadata_.descriptor_;
+      return metadata_.index_ != rhs.metadata_.index_;
     }
 
     // Allow non-const to convert to const.
     operator Iterator<kConst>() const {
-      return {entry_cache_, metadata_.descriptor_};
+      return {metadata_.entry_cache_, metadata_.index_};
     }
 
    private:
     friend class EntryCache;
 
-    constexpr Iterator(const EntryCache* entry_cache, KeyDescriptor* descriptor)
-        : entry_cache_(entry_cache), metadata_(*descriptor, {}) {}
-
-    const EntryCache* entry_cache_;
+    constexpr Iterator(const EntryCache* entry_cache, size_t index)
+        : metadata_(*entry_cache, index, {}) {}
 
     // Mark this mutable so it can be updated in the const operator*() method.
     // This allows lazy updating of the EntryMetadata.
@@ -152,15 +161,47 @@ class EntryCache {
   template <size_t kMaxEntries, size_t kRedundancy>
   using AddressList = Address[kMaxEntries * kRedundancy + kRedundancy];
 
-  constexpr EntryCache(Vector<KeyDescriptor>& descriptors,
+  // Slots in the optional hash index. Each slot holds a descriptor index plus
+  // one, or zero if the slot is empty.
+  using HashIndexSlot = uint16_t;
+
+  // The number of hash index slots for an EntryCache with the specified number
+  // of entries: the smallest power of two that keeps the load factor at or
+  // below 50%.
+  static constexpr size_t HashIndexSize(size_t max_entries) {
+    size_t size = 1;
+    while (size < 2 * max_entries) {
+      size *= 2;
+    }
+    return size;
+  }
+
+  // The type to use for a hash index with the specified number of entries.
+  template <size_t kMaxEntries>
+  using HashIndex = HashIndexSlot[HashIndexSize(kMaxEntries)];
+
+  // Creates an EntryCache. The key hashes vector holds the number of entries;
+  // transaction_ids and states must have key_hashes.max_size() elements each.
+  //
+  // If hash_index is provided, it must have
+  // HashIndexSize(key_hashes.max_size()) slots. It is then used to look up
+  // descriptors by key hash with open addressing, instead of scanning all key
+  // hashes.
+  constexpr EntryCache(Vector<uint32_t>& key_hashes,
+                       uint32_t* transaction_ids,
+                       EntryState* states,
                        Address* addresses,
-                       size_t redundancy)
-      : descriptors_(descriptors),
+                       size_t redundancy,
+                       span<HashIndexSlot> hash_index = {})
+      : key_hashes_(key_hashes),
+        transaction_ids_(transaction_ids),
+        states_(states),
         addresses_(addresses),
-        redundancy_(redundancy) {}
+        redundancy_(redundancy),
+        hash_index_(hash_index) {}
 
   // Clears all KeyDescriptors.
-  void Reset() const { descriptors_.clear(); }
+  void Reset() const;
 
   // Finds the metadata for an entry matching a particular key. Searches for a
   // KeyDescriptor that matches this key and sets *metadata to point to it if
@@ -199,33 +240,45 @@ class EntryCache {
   // This is used by the KeyValueStore to track reserved addresses when finding
   // space for a new entry.
   Address* TempReservedAddressesForWrite() const {
-    return &addresses_[descriptors_.max_size() * redundancy_];
+    return &addresses_[key_hashes_.max_size() * redundancy_];
   }
 
   // The number of copies of each entry.
   size_t redundancy() const { return redundancy_; }
 
   // True if no more entries can be added to the cache.
-  bool full() const { return descriptors_.full(); }
+  bool full() const { return key_hashes_.full(); }
 
   // The total number of entries, including tombstone entries.
-  size_t total_entries() const { return descriptors_.size(); }
+  size_t total_entries() const { return key_hashes_.size(); }
 
   // The total number of present (non-tombstone) entries.
   size_t present_entries() const;
 
   // The maximum number of entries supported by this EntryCache.
-  size_t max_entries() const { return descriptors_.max_size(); }
+  size_t max_entries() const { return key_hashes_.max_size(); }
 
-  iterator begin() const { return {this, descriptors_.begin()}; }
-  const_iterator cbegin() const { return {this, descriptors_.begin()}; }
+  iterator begin() const { return {this, 0}; }
+  const_iterator cbegin() const { return {this, 0}; }
 
-  iterator end() const { return {this, descriptors_.end()}; }
-  const_iterator cend() const { return {this, descriptors_.end()}; }
+  iterator end() const { return {this, total_entries()}; }
+  const_iterator cend() const { return {this, total_entries()}; }
 
  private:
+  friend class EntryMetadata;
+
   int FindIndex(uint32_t key_hash) const;
 
+  // Returns the index of the key hash, or -1, by scanning all key hashes.
+  int ScanForKeyHash(uint32_t key_hash) const;
+
+  // Overwrites the descriptor at the specified index.
+  void SetDescriptor(size_t index, const KeyDescriptor& descriptor) const {
+    key_hashes_.data()[index] = descriptor.key_hash;
+    transaction_ids_[index] = descriptor.transaction_id;
+    states_[index] = descriptor.state;
+  }
+
   // Adds the address to the descriptor at the specified index if there is an
   // address slot available.
   void AddAddressIfRoom(size_t descriptor_index, Address address) const;
@@ -239,11 +292,41 @@ class EntryCache {
 
   Address* ResetAddresses(size_t descriptor_index, Address address) const;
 
-  Vector<KeyDescriptor>& descriptors_;
+  bool has_hash_index() const { return !hash_index_.empty(); }
+
+  // Returns the first hash index slot to probe for the key hash.
+  size_t HashIndexHome(uint32_t key_hash) const;
+
+  // Returns the hash index slot that refers to the key hash, or
+  // hash_index_.size() if there is none.
+  size_t FindHashIndexSlot(uint32_t key_hash) const;
+
+  void InsertIntoHashIndex(uint32_t key_hash, size_t descriptor_index) const;
+
+  void RemoveFromHashIndex(uint32_t key_hash) const;
+
+  // The KeyDescriptor fields, as parallel arrays indexed by descriptor index.
+  Vector<uint32_t>& key_hashes_;
+  uint32_t* const transaction_ids_;
+  EntryState* const states_;
+
   FlashPartition::Address* const addresses_;
   const size_t redundancy_;
+  const span<HashIndexSlot> hash_index_;
 };
 
+uint32_t EntryMetadata::hash() const {
+  return entry_cache_->key_hashes_.data()[index_];
+}
+
+uint32_t EntryMetadata::transaction_id() const {
+  return entry_cache_->transaction_ids_[index_];
+}
+
+EntryState EntryMetadata::state() const {
+  return entry_cache_->states_[index_];
+}
+
 }  // namespace internal
 }  // namespace kvs
 }  // namespace pw
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <algorithm>
 #include <climits>
 #include <cstddef>
 #include <cstdint>
@@ -71,14 +72,38 @@ class SectorDescriptor {
     return writable_bytes() >= required_space;
   }
 
+  // A sector is empty if nothing but its header has been written to it.
   bool Empty(size_t sector_size_bytes) const {
-    return writable_bytes() == sector_size_bytes;
+    return writable_bytes() + header_bytes() == sector_size_bytes;
   }
 
   // Returns the number of bytes that would be recovered if this sector is
   // garbage collected.
   size_t RecoverableBytes(size_t sector_size_bytes) const {
-    return sector_size_bytes - valid_bytes_ - writable_bytes();
+    return sector_size_bytes - valid_bytes_ - writable_bytes() -
+           header_bytes();
+  }
+
+  // The number of times this sector was erased. This is only persisted in
+  // flash for sectors with a header; otherwise it counts erases since Init().
+  uint32_t erase_count() const { return erase_count_; }
+
+  // The size of the header at the start of the sector, which records its erase
+  // count, or 0 if the sector has no header.
+  size_t header_bytes() const { return header_units_ * kHeaderUnitBytes; }
+
+  // Records the header at the start of the sector. Does not update the
+  // writable bytes.
+  void set_header(uint32_t erase_count, size_t header_bytes) {
+    erase_count_ = std::min(erase_count, kMaxEraseCount);
+    header_units_ = static_cast<uint32_t>(header_bytes / kHeaderUnitBytes);
+  }
+
+  // Records that the sector was erased, which also erased its header.
+  void MarkErased(uint16_t sector_size_bytes) {
+    tail_free_bytes_ = sector_size_bytes;
+    header_units_ = 0;
+    erase_count_ = std::min<uint32_t>(erase_count_ + 1u, kMaxEraseCount);
   }
 
   static constexpr size_t max_sector_size() { return kMaxSectorSize; }
@@ -89,11 +114,20 @@ class SectorDescriptor {
   static constexpr uint16_t kCorruptSector = UINT16_MAX;
   static constexpr size_t kMaxSectorSize = UINT16_MAX - 1;
 
+  // Headers are entries, so they are a multiple of the minimum entry alignment.
+  static constexpr size_t kHeaderUnitBytes = 16;
+  static constexpr uint32_t kMaxEraseCount = (1u << 24) - 1;
+
   explicit constexpr SectorDescriptor(uint16_t sector_size_bytes)
-      : tail_free_bytes_(sector_size_bytes), valid_bytes_(0) {}
+      : tail_free_bytes_(sector_size_bytes),
+        valid_bytes_(0),
+        erase_count_(0),
+        header_units_(0) {}
 
   uint16_t tail_free_bytes_;  // writable bytes at the end of the sector
   uint16_t valid_bytes_;      // sum of sizes of valid entries
+  uint32_t erase_count_ : 24;
+  uint32_t header_units_ : 8;  // size of the sector header
 };
 
 // Represents a list of sectors usable by the KVS.
@@ -184,6 +218,15 @@ class Sectors {
   SectorDescriptor* FindSectorToGarbageCollect(
       span<const Address> reserved_addresses) const;
 
+  // Finds the least erased sector holding valid data, if it was erased more
+  // than max_erase_count_difference times less than the most erased sector.
+  // Garbage collecting it moves its data, which rarely changes, to a more worn
+  // sector and lets the sector take its share of the erases. Returns nullptr if
+  // the erase counts are balanced.
+  SectorDescriptor* FindSectorToLevelWear(
+      uint32_t max_erase_count_difference,
+      span<const Address> reserved_addresses) const;
+
   // The number of sectors in use.
   size_t size() const { return descriptors_.size(); }
 
@@ -28,6 +28,7 @@
 #include "pw_kvs/internal/sectors.h"
 #include "pw_kvs/internal/span_traits.h"
 #include "pw_kvs/key.h"
+#include "pw_result/result.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
@@ -78,6 +79,48 @@ struct Options {
 
   // Verify an in-flash entry's checksum after writing it.
   bool verify_on_write = true;
+
+  // If false, verify_on_read is skipped for entries whose checksum was already
+  // verified since Init(). Init() verifies every entry it reads, and
+  // verify_on_write verifies every entry written after that, so this only
+  // takes effect if verify_on_write is set and Init() did not load an index
+  // checkpoint. Corruption of the flash after Init() then goes undetected by
+  // reads.
+  bool reverify_on_read = true;
+
+  // If nonzero, garbage collection on write is done incrementally, relocating
+  // at most this many entries per write. A write that still cannot find space
+  // fails with RESOURCE_EXHAUSTED, and the next write or
+  // PartialMaintenance(max_relocations) call resumes collecting the same
+  // sector. This also skips the heavy maintenance that is otherwise attempted
+  // when writing a new key to a full entry cache. If zero, writes garbage
+  // collect whole sectors at a time.
+  size_t max_relocations_per_write = 0;
+
+  // If nonzero, the KVS levels wear across sectors. It writes a small header
+  // with the sector's erase count to the start of each sector it erases, and
+  // writes new entries to the least erased empty sector. When garbage
+  // collection leaves a sector holding valid data erased more than this many
+  // times less than the most erased sector, that sector's data, which rarely
+  // changes, is moved so that the sector is reused. Headers reduce the largest
+  // entry that fits in a sector, and KVS versions that predate them treat them
+  // as corrupt entries. If zero, no headers are written, but existing headers
+  // are still read.
+  uint32_t wear_leveling_threshold = 0;
+
+  // If true, values are compressed when they are written, if that makes them
+  // smaller. Compressed values are decompressed into the buffer passed to Get,
+  // which must fit the whole value; they cannot be read at an offset. This
+  // suits large, repetitive values, such as serialized configuration, since
+  // they take less flash and are read in fewer bytes.
+  //
+  // Firmware with a KVS version that predates compression does not recognize
+  // compressed entries, which are marked by bit 6 of the entry header's key
+  // length byte. Depending on the version, it either rejects them as corrupt,
+  // or masks off that bit and returns the compressed bytes from Get as if they
+  // were the value. Do not downgrade to such firmware after writing compressed
+  // values unless the KVS is erased first.
+  bool compress_values = false;
 };
 
 class KeyValueStore {
@@ -116,6 +159,8 @@ class KeyValueStore {
   //                        many bytes as possible were written to it
   //   FAILED_PRECONDITION: the KVS is not initialized
   //      INVALID_ARGUMENT: key is empty or too long or value is too large
+  //         UNIMPLEMENTED: offset_bytes is nonzero, but the value is compressed
+  //                        (see Options::compress_values)
   //
   StatusWithSize Get(Key key,
                      span<std::byte> value,
@@ -133,6 +178,25 @@ class KeyValueStore {
     return FixedSizeGet(key, pointer, sizeof(T));
   }
 
+  // Returns the value of an entry in place, without copying it, if the flash is
+  // memory mapped (see FlashMemory::FlashAddressToMcuAddress). This suits
+  // large values that are mostly read, such as certificates or lookup tables.
+  //
+  // The span points into flash and is only valid until the next call that
+  // modifies the KVS, including maintenance, which may move or erase the
+  // entry. The checksum of the last entry returned is not verified again until
+  // another entry is returned.
+  //
+  //                    OK: the span refers to the value in flash
+  //             NOT_FOUND: the key is not present in the KVS
+  //             DATA_LOSS: found the entry, but the data was corrupted
+  //         UNIMPLEMENTED: the flash is not memory mapped, or the value is
+  //                        compressed (see Options::compress_values)
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //      INVALID_ARGUMENT: key is empty or too long
+  //
+  Result<span<const std::byte>> GetView(Key key) const;
+
   // Adds a key-value entry to the KVS. If the key was already present, its
   // value is overwritten.
   //
@@ -174,6 +238,103 @@ class KeyValueStore {
   //
   Status Delete(Key key);
 
+  // A group of puts and deletes that are written to the KVS together with
+  // Commit. The batch refers to, but does not copy, its keys and values, which
+  // must remain valid until the batch is committed or cleared. Each key may
+  // only appear once per batch. See KeyValueStoreBatch for a batch with its own
+  // storage.
+  class Batch {
+   public:
+    struct Operation {
+      Key key;
+      span<const std::byte> value;
+      bool deleted;
+    };
+
+    constexpr explicit Batch(span<Operation> operations)
+        : operations_(operations), size_(0) {}
+
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+
+    // Adds a put of the value to the batch. The value may be a span of bytes or
+    // a trivially copyable object.
+    //
+    //                    OK: the put was added
+    //    RESOURCE_EXHAUSTED: the batch is full
+    //
+    template <typename T,
+              typename std::enable_if_t<ConvertsToSpan<T>::value>* = nullptr>
+    Status Put(const Key& key, const T& value) {
+      return Add(key, as_bytes(internal::make_span(value)), false);
+    }
+
+    template <typename T,
+              typename std::enable_if_t<!ConvertsToSpan<T>::value>* = nullptr>
+    Status Put(const Key& key, const T& value) {
+      CheckThatObjectCanBePutOrGet<T>();
+      return Add(key, as_bytes(span<const T>(&value, 1)), false);
+    }
+
+    // The batch refers to the value, so it cannot be a temporary object.
+    template <typename T,
+              typename std::enable_if_t<!ConvertsToSpan<T>::value>* = nullptr>
+    Status Put(const Key& key, const T&& value) = delete;
+
+    // Adds a delete of the key to the batch.
+    //
+    //                    OK: the delete was added
+    //    RESOURCE_EXHAUSTED: the batch is full
+    //
+    Status Delete(Key key) { return Add(key, {}, true); }
+
+    void clear() { size_ = 0; }
+
+    size_t size() const { return size_; }
+    size_t max_size() const { return operations_.size(); }
+    bool empty() const { return size_ == 0u; }
+
+   private:
+    friend class KeyValueStore;
+
+    Status Add(Key key, span<const std::byte> value, bool deleted) {
+      if (size_ == operations_.size()) {
+        return Status::ResourceExhausted();
+      }
+      operations_[size_++] = {key, value, deleted};
+      return OkStatus();
+    }
+
+    const Operation& operator[](size_t index) const {
+      return operations_[index];
+    }
+
+    span<Operation> operations_;
+    size_t size_;
+  };
+
+  // Writes all puts and deletes in a batch. The batch's entries are written
+  // back to back with consecutive transaction IDs into one sector per redundant
+  // copy, so they share flash writes and alignment padding. Either all or none
+  // of the batch is visible, including after a power loss while the batch is
+  // written: Init ignores the entries of a batch whose last entry is missing.
+  //
+  // The batch's entries must fit in one sector. Nothing is written if any
+  // operation in the batch is invalid.
+  //
+  //                    OK: all entries were written; this includes an empty
+  //                        batch
+  //             NOT_FOUND: a key to delete is not present in the KVS
+  //             DATA_LOSS: checksum validation failed after writing the data
+  //    RESOURCE_EXHAUSTED: there is not enough space for the entries
+  //        ALREADY_EXISTS: a key has the same hash as a different key that is
+  //                        already in the KVS
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //      INVALID_ARGUMENT: a key is empty, too long, or appears twice, or the
+  //                        entries do not fit in one sector
+  //
+  Status Commit(const Batch& batch);
+
   // Returns the size of the value corresponding to the key.
   //
   //                    OK: the size was returned successfully
@@ -212,6 +373,89 @@ class KeyValueStore {
   // that makes sense for the KVS implementation.
   Status PartialMaintenance();
 
+  // Perform a bounded portion of garbage collection, for use from a
+  // low-priority thread or work queue. Relocates at most max_relocations
+  // entries out of the sector being collected, and erases the sector once it
+  // holds no valid entries. The next call picks up where this one stopped. If
+  // configured for at least lazy recovery, first does any needed repairing of
+  // corruption, which is not bounded.
+  //
+  //                  OK: a sector was fully garbage collected
+  //           NOT_FOUND: there is nothing to garbage collect
+  //   DEADLINE_EXCEEDED: max_relocations were done, but the sector being
+  //                      collected still has valid entries; call again to
+  //                      continue
+  // FAILED_PRECONDITION: the KVS is not initialized
+  //
+  Status PartialMaintenance(size_t max_relocations);
+
+  // Writes the redundant copies of an entry at the same time, for KVSs whose
+  // sectors are on flash banks or devices that can program concurrently. See
+  // pw_kvs/async_flash_redundant_writer.h for a RedundantWriter that uses a
+  // kvs::AsyncFlashMemory.
+  //
+  // The KVS starts one write per copy, then waits for each of them, in the
+  // order they were started. Up to redundancy() writes are in progress at once.
+  class RedundantWriter {
+   public:
+    virtual ~RedundantWriter() = default;
+
+    // Starts writing data to the partition. data remains valid until the
+    // matching WaitForWrite() returns. Returns:
+    //
+    // OK - the write was started.
+    // UNAVAILABLE - the flash cannot start another write until one finishes.
+    // [error status] - the write could not be started.
+    Status StartWrite(FlashPartition& partition,
+                      FlashPartition::Address address,
+                      span<const std::byte> data) {
+      return DoStartWrite(partition, address, data);
+    }
+
+    // Blocks until the oldest write in progress finishes, and returns its
+    // result.
+    Status WaitForWrite() { return DoWaitForWrite(); }
+
+   private:
+    virtual Status DoStartWrite(FlashPartition& partition,
+                                FlashPartition::Address address,
+                                span<const std::byte> data) = 0;
+    virtual Status DoWaitForWrite() = 0;
+  };
+
+  // Sets a RedundantWriter for writing new entries when redundancy() is
+  // greater than 1. Entries are written in chunks, each of which is started
+  // for every copy before any is waited on. If a write is UNAVAILABLE, the
+  // writes in progress are finished first, so flash that runs one write at a
+  // time still works. Relocations and repairs still write copies one by one.
+  void set_redundant_writer(RedundantWriter* writer) {
+    redundant_writer_ = writer;
+  }
+
+  // Sets a flash partition, separate from the KVS's own partition, for an
+  // index checkpoint. Init loads the index of keys from a valid checkpoint and
+  // only reads the entries written after it, instead of reading and verifying
+  // every entry in the KVS. Must be called before Init.
+  //
+  // Entries covered by a checkpoint are not checksummed by Init. The checkpoint
+  // is erased before the KVS erases any of its sectors, so it only stays valid
+  // while the KVS is appended to.
+  void set_index_checkpoint_partition(FlashPartition* partition) {
+    index_checkpoint_partition_ = partition;
+    index_checkpoint_in_flash_ = partition != nullptr;
+  }
+
+  // Writes a checkpoint of the current index of keys to the index checkpoint
+  // partition, replacing any previous checkpoint. Checkpoints are best written
+  // after maintenance, since the next garbage collection invalidates them.
+  //
+  //                    OK: the checkpoint was written
+  //   FAILED_PRECONDITION: there is no checkpoint partition, the KVS is not
+  //                        initialized, or the KVS has unrepaired errors
+  //    RESOURCE_EXHAUSTED: the checkpoint does not fit in its partition
+  //
+  Status WriteIndexCheckpoint();
+
   void LogDebugInfo() const;
 
   // Classes and functions to support STL-style iteration.
@@ -237,6 +481,12 @@ class KeyValueStore {
       return kvs_.FixedSizeGet(key(), *iterator_, pointer, sizeof(T));
     }
 
+    // Returns the value referred to by this iterator in place. Equivalent to
+    // KeyValueStore::GetView.
+    Result<span<const std::byte>> GetView() const {
+      return kvs_.GetView(key(), *iterator_);
+    }
+
     // Reads the size of the value referred to by this iterator. Equivalent to
     // KeyValueStore::ValueSize.
     StatusWithSize ValueSize() const { return kvs_.ValueSize(*iterator_); }
@@ -325,6 +575,11 @@ class KeyValueStore {
     size_t sector_erase_count;
     size_t corrupt_sectors_recovered;
     size_t missing_redundant_entries_recovered;
+
+    // Erase counts of the least and most erased sectors. These are persisted
+    // in sector headers when Options::wear_leveling_threshold is set.
+    uint32_t min_sector_erase_count;
+    uint32_t max_sector_erase_count;
   };
 
   StorageStats GetStorageStats() const;
@@ -364,8 +619,11 @@ class KeyValueStore {
                 size_t redundancy,
                 Vector<SectorDescriptor>& sector_descriptor_list,
                 const SectorDescriptor** temp_sectors_to_skip,
-                Vector<KeyDescriptor>& key_descriptor_list,
-                Address* addresses);
+                Vector<uint32_t>& key_hash_list,
+                uint32_t* transaction_ids,
+                internal::EntryState* entry_states,
+                Address* addresses,
+                span<internal::EntryCache::HashIndexSlot> hash_index = {});
 
  private:
   using EntryMetadata = internal::EntryMetadata;
@@ -382,7 +640,35 @@ class KeyValueStore {
   }
 
   Status InitializeMetadata();
-  Status LoadEntry(Address entry_address, Address* next_entry_address);
+
+  // Loads the key descriptors and sector write positions from the index
+  // checkpoint. Fails if the checkpoint is missing, corrupt, or does not match
+  // the KVS.
+  Status LoadIndexCheckpoint();
+
+  // Erases the index checkpoint, if there is one. Must be called before
+  // erasing a sector, since the checkpoint may reference entries in it.
+  Status InvalidateIndexCheckpoint();
+
+  // A sequence of batch entries found while loading a sector, which is only
+  // loaded once the entry that completes the batch is found.
+  struct PendingBatch {
+    bool empty() const { return count == 0u; }
+
+    Address first_address;
+    size_t count;
+    uint32_t last_transaction_id;
+  };
+
+  // Reads the erase count from the header at the start of a sector, if it has
+  // one. Invalid headers are left to be found as corrupt entries.
+  void LoadSectorHeader(SectorDescriptor& sector);
+
+  Status LoadEntry(Address entry_address,
+                   Address* next_entry_address,
+                   PendingBatch& pending_batch);
+  Status LoadBatch(const PendingBatch& batch);
+  void DiscardIncompleteBatch(PendingBatch& batch) const;
   Status ScanForEntry(const SectorDescriptor& sector,
                       Address start_address,
                       Address* next_entry_address);
@@ -428,6 +714,9 @@ class KeyValueStore {
                      span<std::byte> value_buffer,
                      size_t offset_bytes) const;
 
+  Result<span<const std::byte>> GetView(Key key,
+                                        const EntryMetadata& metadata) const;
+
   Status FixedSizeGet(Key key, void* value, size_t size_bytes) const;
 
   Status FixedSizeGet(Key key,
@@ -438,15 +727,22 @@ class KeyValueStore {
   Status CheckWriteOperation(Key key) const;
   Status CheckReadOperation(Key key) const;
 
+  // stored_value_size is the size of the value in flash, as calculated by
+  // Entry::StoredValueSize, so that the value is not compressed again to find
+  // it.
   Status WriteEntryForExistingKey(EntryMetadata& metadata,
                                   EntryState new_state,
                                   Key key,
-                                  span<const std::byte> value);
+                                  span<const std::byte> value,
+                                  size_t stored_value_size);
 
-  Status WriteEntryForNewKey(Key key, span<const std::byte> value);
+  Status WriteEntryForNewKey(Key key,
+                             span<const std::byte> value,
+                             size_t stored_value_size);
 
   Status WriteEntry(Key key,
                     span<const std::byte> value,
+                    size_t stored_value_size,
                     EntryState new_state,
                     EntryMetadata* prior_metadata = nullptr,
                     const internal::Entry* prior_entry = nullptr);
@@ -471,6 +767,27 @@ class KeyValueStore {
 
   Status AppendEntry(const Entry& entry, Key key, span<const std::byte> value);
 
+  // Writes every copy of an entry through the redundant writer, and sets
+  // copies_written to the number of copies, from the first, that were written
+  // before any failed.
+  Status AppendEntryCopies(const Entry& entry,
+                           Key key,
+                           span<const std::byte> value,
+                           span<const Address> addresses,
+                           size_t& copies_written);
+
+  // Writes one copy of a batch's entries, back to back from address.
+  Status AppendBatch(const Batch& batch,
+                     uint32_t first_transaction_id,
+                     Address address);
+
+  // Creates the entry for one operation of a batch. All but the last entry of
+  // the batch are marked as continuing the batch.
+  Entry CreateBatchEntry(const Batch& batch,
+                         size_t index,
+                         uint32_t first_transaction_id,
+                         Address address);
+
   StatusWithSize CopyEntryToSector(Entry& entry,
                                    SectorDescriptor* new_sector,
                                    Address new_address);
@@ -505,6 +822,22 @@ class KeyValueStore {
   Status GarbageCollectSector(SectorDescriptor& sector_to_gc,
                               span<const Address> reserved_addresses);
 
+  // Writes a header with the erase count to the start of an erased sector.
+  Status WriteSectorHeader(SectorDescriptor& sector);
+
+  // Garbage collects the least erased sector with valid data if its erase
+  // count is too far behind the others.
+  Status LevelWear(span<const Address> reserved_addresses);
+
+  // The size of the largest entry or batch that fits in every sector.
+  size_t max_entry_size() const;
+
+  // Continues garbage collecting incremental_gc_sector_, or starts on a new
+  // sector if there is none. Decrements relocation_budget for each entry
+  // relocated, and returns DEADLINE_EXCEEDED if it runs out.
+  Status IncrementalGarbageCollect(size_t& relocation_budget,
+                                   span<const Address> reserved_addresses);
+
   // Ensure that all entries are on the primary (first) format. Entries that are
   // not on the primary format are rewritten.
   //
@@ -526,6 +859,7 @@ class KeyValueStore {
   internal::Entry CreateEntry(Address address,
                               Key key,
                               span<const std::byte> value,
+                              size_t stored_value_size,
                               EntryState state);
 
   void LogSectors() const;
@@ -537,6 +871,27 @@ class KeyValueStore {
   // List of sectors used by this KVS.
   internal::Sectors sectors_;
 
+  // Sector that incremental garbage collection is emptying, if any.
+  SectorDescriptor* incremental_gc_sector_;
+
+  // Optional partition for the index checkpoint, and whether it may currently
+  // hold a checkpoint that must be erased before a sector is.
+  FlashPartition* index_checkpoint_partition_;
+  bool index_checkpoint_in_flash_;
+
+  // Writes the copies of new entries concurrently, if set.
+  RedundantWriter* redundant_writer_;
+
+  // Whether every entry's checksum has been verified since Init(), so reads
+  // may skip verifying them again. See Options::reverify_on_read.
+  bool entries_verified_;
+
+  // The entry last returned by GetView, identified by its address, transaction
+  // ID, and key hash, whose checksum need not be verified again.
+  mutable Address verified_view_address_;
+  mutable uint32_t verified_view_transaction_id_;
+  mutable uint32_t verified_view_key_hash_;
+
   // Unordered list of KeyDescriptors. Finding a key requires scanning and
   // verifying a match by reading the actual entry.
   internal::EntryCache entry_cache_;
@@ -577,10 +932,17 @@ class KeyValueStore {
   uint32_t last_transaction_id_;
 };
 
+// Allocates the buffers for a KeyValueStore.
+//
+// If kHashIndex is true, a hash index of
+// internal::EntryCache::HashIndexSize(kMaxEntries) 16-bit slots is also
+// allocated. Key lookups then take constant time on average instead of
+// scanning every key descriptor, which helps KVSs with many entries.
 template <size_t kMaxEntries,
           size_t kMaxUsableSectors,
           size_t kRedundancy = 1,
-          size_t kEntryFormats = 1>
+          size_t kEntryFormats = 1,
+          bool kHashIndex = false>
 class KeyValueStoreBuffer : public KeyValueStore {
  public:
   // Constructs a KeyValueStore on the partition, with support for one
@@ -608,10 +970,13 @@ class KeyValueStoreBuffer : public KeyValueStore {
                       kRedundancy,
                       sectors_,
                       temp_sectors_to_skip_,
-                      key_descriptors_,
-                      addresses_),
+                      key_hashes_,
+                      transaction_ids_,
+                      entry_states_,
+                      addresses_,
+                      hash_index_),
         sectors_(),
-        key_descriptors_(),
+        key_hashes_(),
         formats_() {
     std::copy(formats.begin(), formats.end(), formats_.begin());
   }
@@ -621,6 +986,8 @@ class KeyValueStoreBuffer : public KeyValueStore {
   static_assert(kMaxUsableSectors > 0u);
   static_assert(kRedundancy > 0u);
   static_assert(kEntryFormats > 0u);
+  static_assert(!kHashIndex || kMaxEntries < 0xffffu,
+                "The hash index supports at most 65534 entries");
 
   Vector<SectorDescriptor, kMaxUsableSectors> sectors_;
 
@@ -632,8 +999,11 @@ class KeyValueStoreBuffer : public KeyValueStore {
   // maximum of 2 * kRedundancy - 1 sectors to avoid.
   const SectorDescriptor* temp_sectors_to_skip_[2 * kRedundancy - 1];
 
-  // KeyDescriptors for use by the KVS's EntryCache.
-  Vector<KeyDescriptor, kMaxEntries> key_descriptors_;
+  // KeyDescriptors for use by the KVS's EntryCache, stored as parallel arrays
+  // so that key lookups only read the key hashes.
+  Vector<uint32_t, kMaxEntries> key_hashes_;
+  uint32_t transaction_ids_[kMaxEntries];
+  internal::EntryState entry_states_[kMaxEntries];
 
   // An array of addresses associated with the KeyDescriptors for use with the
   // EntryCache. To support having KeyValueStores with different redundancies,
@@ -641,9 +1011,26 @@ class KeyValueStoreBuffer : public KeyValueStore {
   // KeyDescriptors.
   internal::EntryCache::AddressList<kRedundancy, kMaxEntries> addresses_;
 
+  // Optional hash index from key hashes to KeyDescriptors.
+  std::array<internal::EntryCache::HashIndexSlot,
+             kHashIndex ? internal::EntryCache::HashIndexSize(kMaxEntries) : 0>
+      hash_index_{};
+
   // EntryFormats that can be read by this KeyValueStore.
   std::array<EntryFormat, kEntryFormats> formats_;
 };
 
+// A KeyValueStore::Batch with storage for up to kMaxOperations operations.
+template <size_t kMaxOperations>
+class KeyValueStoreBatch : public KeyValueStore::Batch {
+ public:
+  KeyValueStoreBatch() : KeyValueStore::Batch(operations_), operations_{} {}
+
+ private:
+  static_assert(kMaxOperations > 0u);
+
+  std::array<Operation, kMaxOperations> operations_;
+};
+
 }  // namespace kvs
 }  // namespace pw
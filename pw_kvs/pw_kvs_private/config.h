@@ -38,6 +38,18 @@ static_assert((PW_KVS_MAX_FLASH_ALIGNMENT >= 16UL),
 #define PW_KVS_REMOVE_DELETED_KEYS_IN_HEAVY_MAINTENANCE 1
 #endif  // PW_KVS_REMOVE_DELETED_KEYS_IN_HEAVY_MAINTENANCE
 
+// The number of bits in the hashes used to find repeated data when compressing
+// values. Compression uses a table of 2^PW_KVS_COMPRESSION_HASH_BITS 32-bit
+// positions on the stack. Larger tables find more matches, which may compress
+// values better.
+#ifndef PW_KVS_COMPRESSION_HASH_BITS
+#define PW_KVS_COMPRESSION_HASH_BITS 7
+#endif  // PW_KVS_COMPRESSION_HASH_BITS
+
+static_assert((PW_KVS_COMPRESSION_HASH_BITS >= 1) &&
+                  (PW_KVS_COMPRESSION_HASH_BITS <= 16),
+              "The compression hash must have 1 to 16 bits");
+
 namespace pw::kvs {
 
 inline constexpr size_t kMaxFlashAlignment = PW_KVS_MAX_FLASH_ALIGNMENT;
@@ -17,6 +17,8 @@
 
 #include "pw_kvs/internal/sectors.h"
 
+#include <algorithm>
+
 #include "pw_kvs_private/config.h"
 #include "pw_log/shorter.h"
 
@@ -39,7 +41,7 @@ Status Sectors::Find(FindMode find_mode,
                      size_t size,
                      span<const Address> addresses_to_skip,
                      span<const Address> reserved_addresses) {
-  SectorDescriptor* first_empty_sector = nullptr;
+  SectorDescriptor* least_erased_empty_sector = nullptr;
   bool at_least_two_empty_sectors = (find_mode == kGarbageCollect);
 
   // Used for the GC reclaimable bytes check
@@ -80,6 +82,7 @@ Status Sectors::Find(FindMode find_mode,
   // leveling benefit, rather than putting more wear on the lower number
   // sectors.
   SectorDescriptor* sector = last_new_;
+  bool empty_sectors_seen = false;
 
   // Look for a sector to use with enough space. The search uses a 3 priority
   // tier process.
@@ -89,7 +92,8 @@ Status Sectors::Find(FindMode find_mode,
   // sector that is found.
   //
   // Tier 2 is find sectors that are empty/erased. While scanning for a partial
-  // sector, keep track of the first empty sector and if a second empty sector
+  // sector, keep track of the least erased empty sector with enough space (the
+  // first one found, if erase counts are equal) and if a second empty sector
   // was seen. If during GC then count the second empty sector as always seen.
   //
   // Tier 3 is during garbage collection, find sectors with enough space that
@@ -123,23 +127,29 @@ Status Sectors::Find(FindMode find_mode,
     }
 
     if (sector->Empty(sector_size_bytes)) {
-      if (first_empty_sector == nullptr) {
-        first_empty_sector = sector;
-      } else {
+      if (empty_sectors_seen) {
         at_least_two_empty_sectors = true;
       }
+      empty_sectors_seen = true;
+
+      // Sector headers make some empty sectors slightly smaller than others.
+      if (sector->HasSpace(size) &&
+          (least_erased_empty_sector == nullptr ||
+           sector->erase_count() < least_erased_empty_sector->erase_count())) {
+        least_erased_empty_sector = sector;
+      }
     }
   }
 
   // Tier 2 check: If the scan for a partial sector does not find a suitable
-  // sector, use the first empty sector that was found. Normally it is required
-  // to keep 1 empty sector after the sector found here, but that rule does not
-  // apply during GC.
-  if (first_empty_sector != nullptr && at_least_two_empty_sectors) {
-    DBG("  Found a usable empty sector; returning the first found (%u)",
-        Index(first_empty_sector));
-    last_new_ = first_empty_sector;
-    *found_sector = first_empty_sector;
+  // sector, use the least erased empty sector that was found. Normally it is
+  // required to keep 1 empty sector after the sector found here, but that rule
+  // does not apply during GC.
+  if (least_erased_empty_sector != nullptr && at_least_two_empty_sectors) {
+    DBG("  Found a usable empty sector; returning the least erased (%u)",
+        Index(least_erased_empty_sector));
+    last_new_ = least_erased_empty_sector;
+    *found_sector = least_erased_empty_sector;
     return OkStatus();
   }
 
@@ -231,4 +241,37 @@ SectorDescriptor* Sectors::FindSectorToGarbageCollect(
   return sector_candidate;
 }
 
+SectorDescriptor* Sectors::FindSectorToLevelWear(
+    uint32_t max_erase_count_difference,
+    span<const Address> reserved_addresses) const {
+  uint32_t most_erases = 0;
+  SectorDescriptor* least_erased = nullptr;
+
+  for (SectorDescriptor& sector : descriptors_) {
+    most_erases = std::max(most_erases, sector.erase_count());
+
+    const bool reserved = std::any_of(
+        reserved_addresses.begin(),
+        reserved_addresses.end(),
+        [&](Address address) { return AddressInSector(sector, address); });
+    if (sector.valid_bytes() == 0u || reserved) {
+      continue;
+    }
+    if (least_erased == nullptr ||
+        sector.erase_count() < least_erased->erase_count()) {
+      least_erased = &sector;
+    }
+  }
+
+  if (least_erased == nullptr ||
+      most_erases - least_erased->erase_count() <= max_erase_count_difference) {
+    return nullptr;
+  }
+  DBG("Sector %u was erased %u times, %u fewer than the most erased sector",
+      Index(least_erased),
+      unsigned(least_erased->erase_count()),
+      unsigned(most_erases - least_erased->erase_count()));
+  return least_erased;
+}
+
 }  // namespace pw::kvs::internal
@@ -79,7 +79,51 @@ TEST_F(SectorsTest, NextWritableAddress_PartiallyWrittenSector) {
   EXPECT_EQ(123u, sectors_.NextWritableAddress(*sectors_.begin()));
 }
 
-// TODO(hepler): Add tests for FindSpace, FindSpaceDuringGarbageCollection, and
+TEST_F(SectorsTest, EmptySectorWithHeader) {
+  SectorDescriptor& sector = sectors_.FromAddress(128);
+  sector.MarkErased(128);
+  sector.RemoveWritableBytes(32);
+  sector.set_header(1, 32);
+
+  EXPECT_TRUE(sector.Empty(128));
+  EXPECT_EQ(0u, sector.RecoverableBytes(128));
+  EXPECT_EQ(1u, sector.erase_count());
+  EXPECT_EQ(160u, sectors_.NextWritableAddress(sector));
+
+  sector.MarkErased(128);
+  EXPECT_EQ(0u, sector.header_bytes());
+  EXPECT_EQ(2u, sector.erase_count());
+}
+
+TEST_F(SectorsTest, FindSpace_PrefersLeastErasedEmptySector) {
+  for (SectorDescriptor& sector : sectors_) {
+    sector.set_header(3, 0);
+  }
+  sectors_.FromAddress(7 * 128).set_header(1, 0);
+
+  SectorDescriptor* found = nullptr;
+  ASSERT_EQ(OkStatus(), sectors_.FindSpace(&found, 16, {}));
+  EXPECT_EQ(7u, sectors_.Index(found));
+  EXPECT_EQ(found, sectors_.last_new());
+}
+
+TEST_F(SectorsTest, FindSectorToLevelWear) {
+  for (SectorDescriptor& sector : sectors_) {
+    sector.set_header(10, 0);
+  }
+  SectorDescriptor& cold = sectors_.FromAddress(2 * 128);
+  cold.set_header(2, 0);
+  cold.RemoveWritableBytes(64);
+  cold.AddValidBytes(64);
+
+  EXPECT_EQ(&cold, sectors_.FindSectorToLevelWear(5, {}));
+  EXPECT_EQ(nullptr, sectors_.FindSectorToLevelWear(8, {}));
+
+  const FlashPartition::Address reserved[] = {2 * 128 + 16};
+  EXPECT_EQ(nullptr, sectors_.FindSectorToLevelWear(5, reserved));
+}
+
+// TODO(hepler): Add tests for FindSpaceDuringGarbageCollection and
 // FindSectorToGarbageCollect.
 
 }  // namespace
@@ -0,0 +1,258 @@
+// Copyright 2019 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_libc/memory.h"
+
+#include <cstdint>
+
+// GCC replaces loops that copy or set bytes with calls to memcpy and memset,
+// even with -fno-builtin, which would make these functions call themselves.
+#if defined(__GNUC__) && !defined(__clang__)
+#define PW_LIBC_NO_LOOP_PATTERNS \
+  __attribute__((optimize("no-tree-loop-distribute-patterns")))
+#else
+#define PW_LIBC_NO_LOOP_PATTERNS
+#endif  // defined(__GNUC__) && !defined(__clang__)
+
+// LDM and STM move several words in one instruction. Compilers do not always
+// combine separate loads and stores into them, so they are used explicitly.
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_MAIN__)
+#define PW_LIBC_ARM_LDM_STM 1
+#else
+#define PW_LIBC_ARM_LDM_STM 0
+#endif
+
+namespace pw::libc {
+namespace {
+
+// The buffers may hold objects of any type, so words may alias them.
+typedef uint32_t Word __attribute__((may_alias));
+
+// A word at an address that may not be aligned. Cores with unaligned access,
+// such as ARMv7-M, read it with one load. Others read it a byte at a time.
+struct __attribute__((packed, may_alias)) UnalignedWord {
+  uint32_t value;
+};
+
+constexpr size_t kWordSize = sizeof(Word);
+
+// The main loops move four words at a time.
+constexpr size_t kBlockSize = 4 * kWordSize;
+
+// Copies shorter than this are done a byte at a time, since aligning the
+// buffers would cost more than it saves.
+constexpr size_t kMinWordCopySize = kBlockSize;
+
+bool IsAligned(const void* pointer) {
+  return reinterpret_cast<uintptr_t>(pointer) % kWordSize == 0u;
+}
+
+Word& WordAt(unsigned char* pointer) {
+  return *reinterpret_cast<Word*>(pointer);
+}
+
+Word WordAt(const unsigned char* pointer) {
+  return *reinterpret_cast<const Word*>(pointer);
+}
+
+Word UnalignedWordAt(const unsigned char* pointer) {
+  return reinterpret_cast<const UnalignedWord*>(pointer)->value;
+}
+
+// Copies a block from src to dst, which are word aligned, and advances them.
+void CopyBlockForward(unsigned char*& dst, const unsigned char*& src) {
+#if PW_LIBC_ARM_LDM_STM
+  asm volatile(
+      "ldmia %[src]!, {r3, r4, r5, r6}\n"
+      "stmia %[dst]!, {r3, r4, r5, r6}"
+      : [dst] "+r"(dst), [src] "+r"(src)
+      :
+      : "r3", "r4", "r5", "r6", "memory");
+#else
+  // Load the whole block before storing it, so overlapping moves work.
+  const Word w0 = WordAt(src);
+  const Word w1 = WordAt(src + kWordSize);
+  const Word w2 = WordAt(src + 2 * kWordSize);
+  const Word w3 = WordAt(src + 3 * kWordSize);
+  WordAt(dst) = w0;
+  WordAt(dst + kWordSize) = w1;
+  WordAt(dst + 2 * kWordSize) = w2;
+  WordAt(dst + 3 * kWordSize) = w3;
+  dst += kBlockSize;
+  src += kBlockSize;
+#endif  // PW_LIBC_ARM_LDM_STM
+}
+
+// Copies the block before src to the block before dst, which are word
+// aligned, and moves them back.
+void CopyBlockBackward(unsigned char*& dst, const unsigned char*& src) {
+#if PW_LIBC_ARM_LDM_STM
+  asm volatile(
+      "ldmdb %[src]!, {r3, r4, r5, r6}\n"
+      "stmdb %[dst]!, {r3, r4, r5, r6}"
+      : [dst] "+r"(dst), [src] "+r"(src)
+      :
+      : "r3", "r4", "r5", "r6", "memory");
+#else
+  dst -= kBlockSize;
+  src -= kBlockSize;
+  const Word w0 = WordAt(src);
+  const Word w1 = WordAt(src + kWordSize);
+  const Word w2 = WordAt(src + 2 * kWordSize);
+  const Word w3 = WordAt(src + 3 * kWordSize);
+  WordAt(dst) = w0;
+  WordAt(dst + kWordSize) = w1;
+  WordAt(dst + 2 * kWordSize) = w2;
+  WordAt(dst + 3 * kWordSize) = w3;
+#endif  // PW_LIBC_ARM_LDM_STM
+}
+
+// Sets a word-aligned block at dst to the repeated word and advances dst.
+void SetBlock(unsigned char*& dst, Word word) {
+#if PW_LIBC_ARM_LDM_STM
+  register Word w0 asm("r3") = word;
+  register Word w1 asm("r4") = word;
+  register Word w2 asm("r5") = word;
+  register Word w3 asm("r6") = word;
+  asm volatile("stmia %[dst]!, {r3, r4, r5, r6}"
+               : [dst] "+r"(dst)
+               : "r"(w0), "r"(w1), "r"(w2), "r"(w3)
+               : "memory");
+#else
+  WordAt(dst) = word;
+  WordAt(dst + kWordSize) = word;
+  WordAt(dst + 2 * kWordSize) = word;
+  WordAt(dst + 3 * kWordSize) = word;
+  dst += kBlockSize;
+#endif  // PW_LIBC_ARM_LDM_STM
+}
+
+// Copies from the start of the buffers to the end. This is safe for
+// overlapping buffers if dst is before src, since every part of src is read
+// before the same part of dst is written.
+PW_LIBC_NO_LOOP_PATTERNS void CopyForward(unsigned char* dst,
+                                          const unsigned char* src,
+                                          size_t size) {
+  if (size >= kMinWordCopySize) {
+    // Align the destination, so every store is a word store.
+    for (; !IsAligned(dst); --size) {
+      *dst++ = *src++;
+    }
+
+    if (IsAligned(src)) {
+      for (; size >= kBlockSize; size -= kBlockSize) {
+        CopyBlockForward(dst, src);
+      }
+      for (; size >= kWordSize; size -= kWordSize) {
+        WordAt(dst) = WordAt(src);
+        dst += kWordSize;
+        src += kWordSize;
+      }
+    } else {
+      for (; size >= kWordSize; size -= kWordSize) {
+        WordAt(dst) = UnalignedWordAt(src);
+        dst += kWordSize;
+        src += kWordSize;
+      }
+    }
+  }
+
+  for (; size != 0u; --size) {
+    *dst++ = *src++;
+  }
+}
+
+// Copies from the end of the buffers to the start, given pointers past their
+// ends. This is safe for overlapping buffers if dst is after src.
+PW_LIBC_NO_LOOP_PATTERNS void CopyBackward(unsigned char* dst_end,
+                                           const unsigned char* src_end,
+                                           size_t size) {
+  if (size >= kMinWordCopySize) {
+    for (; !IsAligned(dst_end); --size) {
+      *--dst_end = *--src_end;
+    }
+
+    if (IsAligned(src_end)) {
+      for (; size >= kBlockSize; size -= kBlockSize) {
+        CopyBlockBackward(dst_end, src_end);
+      }
+      for (; size >= kWordSize; size -= kWordSize) {
+        dst_end -= kWordSize;
+        src_end -= kWordSize;
+        WordAt(dst_end) = WordAt(src_end);
+      }
+    } else {
+      for (; size >= kWordSize; size -= kWordSize) {
+        dst_end -= kWordSize;
+        src_end -= kWordSize;
+        WordAt(dst_end) = UnalignedWordAt(src_end);
+      }
+    }
+  }
+
+  for (; size != 0u; --size) {
+    *--dst_end = *--src_end;
+  }
+}
+
+}  // namespace
+
+void* Memcpy(void* dest, const void* src, size_t size) {
+  CopyForward(static_cast<unsigned char*>(dest),
+              static_cast<const unsigned char*>(src),
+              size);
+  return dest;
+}
+
+void* Memmove(void* dest, const void* src, size_t size) {
+  auto* dst = static_cast<unsigned char*>(dest);
+  const auto* source = static_cast<const unsigned char*>(src);
+
+  // Copying forward is safe unless dst starts inside src.
+  if (reinterpret_cast<uintptr_t>(dst) - reinterpret_cast<uintptr_t>(source) >=
+      size) {
+    CopyForward(dst, source, size);
+  } else if (dst != source) {
+    CopyBackward(dst + size, source + size, size);
+  }
+  return dest;
+}
+
+PW_LIBC_NO_LOOP_PATTERNS void* Memset(void* dest, int value, size_t size) {
+  auto* dst = static_cast<unsigned char*>(dest);
+  const auto byte = static_cast<unsigned char>(value);
+
+  if (size >= kMinWordCopySize) {
+    for (; !IsAligned(dst); --size) {
+      *dst++ = byte;
+    }
+
+    const Word word = byte * Word{0x01010101};
+    for (; size >= kBlockSize; size -= kBlockSize) {
+      SetBlock(dst, word);
+    }
+    for (; size >= kWordSize; size -= kWordSize) {
+      WordAt(dst) = word;
+      dst += kWordSize;
+    }
+  }
+
+  for (; size != 0u; --size) {
+    *dst++ = byte;
+  }
+  return dest;
+}
+
+}  // namespace pw::libc
@@ -0,0 +1,36 @@
+// Copyright 2019 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Defines the C library's memcpy, memmove, and memset with the pw_libc
+// implementations. Link this instead of the toolchain's versions.
+
+#include <cstddef>
+
+#include "pw_libc/memory.h"
+
+extern "C" {
+
+void* memcpy(void* dest, const void* src, size_t size) {
+  return pw::libc::Memcpy(dest, src, size);
+}
+
+void* memmove(void* dest, const void* src, size_t size) {
+  return pw::libc::Memmove(dest, src, size);
+}
+
+void* memset(void* dest, int value, size_t size) {
+  return pw::libc::Memset(dest, value, size);
+}
+
+}  // extern "C"
@@ -0,0 +1,91 @@
+// Copyright 2019 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_libc/memory.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::libc {
+namespace {
+
+// Compares the pw_libc functions with the toolchain's C library, for aligned
+// and misaligned buffers of typical message and packet sizes.
+
+constexpr size_t kMaxSize = 1024;
+
+// One extra byte allows for misaligned buffers.
+alignas(uint32_t) std::array<std::byte, kMaxSize + 1> source;
+alignas(uint32_t) std::array<std::byte, kMaxSize + 1> destination;
+
+void PwMemcpyTest(perf_test::State& state, size_t size, size_t offset) {
+  while (state.KeepRunning()) {
+    Memcpy(destination.data(), source.data() + offset, size);
+  }
+}
+
+void StdMemcpyTest(perf_test::State& state, size_t size, size_t offset) {
+  while (state.KeepRunning()) {
+    std::memcpy(destination.data(), source.data() + offset, size);
+  }
+}
+
+void PwMemmoveTest(perf_test::State& state, size_t size) {
+  while (state.KeepRunning()) {
+    Memmove(destination.data() + 1, destination.data(), size);
+  }
+}
+
+void StdMemmoveTest(perf_test::State& state, size_t size) {
+  while (state.KeepRunning()) {
+    std::memmove(destination.data() + 1, destination.data(), size);
+  }
+}
+
+void PwMemsetTest(perf_test::State& state, size_t size) {
+  while (state.KeepRunning()) {
+    Memset(destination.data(), 0, size);
+  }
+}
+
+void StdMemsetTest(perf_test::State& state, size_t size) {
+  while (state.KeepRunning()) {
+    std::memset(destination.data(), 0, size);
+  }
+}
+
+PW_PERF_TEST(PwMemcpy16Aligned, PwMemcpyTest, 16, 0);
+PW_PERF_TEST(StdMemcpy16Aligned, StdMemcpyTest, 16, 0);
+PW_PERF_TEST(PwMemcpy256Aligned, PwMemcpyTest, 256, 0);
+PW_PERF_TEST(StdMemcpy256Aligned, StdMemcpyTest, 256, 0);
+PW_PERF_TEST(PwMemcpy256Misaligned, PwMemcpyTest, 256, 1);
+PW_PERF_TEST(StdMemcpy256Misaligned, StdMemcpyTest, 256, 1);
+PW_PERF_TEST(PwMemcpy1024Aligned, PwMemcpyTest, 1024, 0);
+PW_PERF_TEST(StdMemcpy1024Aligned, StdMemcpyTest, 1024, 0);
+PW_PERF_TEST(PwMemcpy1024Misaligned, PwMemcpyTest, 1024, 1);
+PW_PERF_TEST(StdMemcpy1024Misaligned, StdMemcpyTest, 1024, 1);
+
+PW_PERF_TEST(PwMemmove256Overlapping, PwMemmoveTest, 256);
+PW_PERF_TEST(StdMemmove256Overlapping, StdMemmoveTest, 256);
+
+PW_PERF_TEST(PwMemset256, PwMemsetTest, 256);
+PW_PERF_TEST(StdMemset256, StdMemsetTest, 256);
+PW_PERF_TEST(PwMemset1024, PwMemsetTest, 1024);
+PW_PERF_TEST(StdMemset1024, StdMemsetTest, 1024);
+
+}  // namespace
+}  // namespace pw::libc
@@ -0,0 +1,119 @@
+// Copyright 2019 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_libc/memory.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::libc {
+namespace {
+
+// Covers the byte, word, and block loops, with a few blocks to spare.
+constexpr size_t kMaxSize = 80;
+constexpr size_t kMaxOffset = 8;
+constexpr size_t kBufferSize = kMaxSize + 2 * kMaxOffset;
+
+using Buffer = std::array<unsigned char, kBufferSize>;
+
+Buffer Pattern() {
+  Buffer buffer;
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<unsigned char>(i * 7 + 1);
+  }
+  return buffer;
+}
+
+// Reference implementation that moves a byte at a time.
+void ExpectedMove(Buffer& buffer, size_t dst, size_t src, size_t size) {
+  const Buffer original = buffer;
+  for (size_t i = 0; i < size; ++i) {
+    buffer[dst + i] = original[src + i];
+  }
+}
+
+TEST(Memcpy, AllSizesAndAlignments) {
+  alignas(uint32_t) const Buffer src = Pattern();
+  for (size_t size = 0; size <= kMaxSize; ++size) {
+    for (size_t src_offset = 0; src_offset < kMaxOffset; ++src_offset) {
+      for (size_t dst_offset = 0; dst_offset < kMaxOffset; ++dst_offset) {
+        alignas(uint32_t) Buffer dst{};
+        Buffer expected{};
+        for (size_t i = 0; i < size; ++i) {
+          expected[dst_offset + i] = src[src_offset + i];
+        }
+
+        void* result =
+            Memcpy(dst.data() + dst_offset, src.data() + src_offset, size);
+        EXPECT_EQ(result, dst.data() + dst_offset);
+        ASSERT_EQ(dst, expected);
+      }
+    }
+  }
+}
+
+TEST(Memmove, OverlappingInBothDirections) {
+  for (size_t size = 0; size <= kMaxSize; ++size) {
+    for (size_t src = 0; src < 2 * kMaxOffset; ++src) {
+      for (size_t dst = 0; dst < 2 * kMaxOffset; ++dst) {
+        alignas(uint32_t) Buffer buffer = Pattern();
+        Buffer expected = Pattern();
+        ExpectedMove(expected, dst, src, size);
+
+        void* result = Memmove(buffer.data() + dst, buffer.data() + src, size);
+        EXPECT_EQ(result, buffer.data() + dst);
+        ASSERT_EQ(buffer, expected);
+      }
+    }
+  }
+}
+
+TEST(Memmove, SeparateBuffers) {
+  alignas(uint32_t) const Buffer src = Pattern();
+  alignas(uint32_t) Buffer dst{};
+  EXPECT_EQ(Memmove(dst.data() + 1, src.data() + 2, kMaxSize), dst.data() + 1);
+  for (size_t i = 0; i < kMaxSize; ++i) {
+    ASSERT_EQ(dst[1 + i], src[2 + i]);
+  }
+}
+
+TEST(Memset, AllSizesAndAlignments) {
+  for (size_t size = 0; size <= kMaxSize; ++size) {
+    for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+      alignas(uint32_t) Buffer buffer = Pattern();
+      Buffer expected = Pattern();
+      for (size_t i = 0; i < size; ++i) {
+        expected[offset + i] = 0xa5;
+      }
+
+      void* result = Memset(buffer.data() + offset, 0xa5, size);
+      EXPECT_EQ(result, buffer.data() + offset);
+      ASSERT_EQ(buffer, expected);
+    }
+  }
+}
+
+TEST(Memset, UsesLowByteOfValue) {
+  std::array<unsigned char, 32> buffer{};
+  Memset(buffer.data(), 0x1234, buffer.size());
+  for (unsigned char byte : buffer) {
+    EXPECT_EQ(byte, 0x34);
+  }
+}
+
+}  // namespace
+}  // namespace pw::libc
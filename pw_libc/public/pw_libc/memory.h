@@ -0,0 +1,34 @@
+// Copyright 2019 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+// Implementations of memcpy, memmove, and memset that move data a word at a
+// time when they can. They are tuned for ARMv7-M and ARMv8-M Mainline cores,
+// such as the Cortex-M4, M7, and M33, but work on any target.
+//
+// The memory_functions library defines the standard C functions with these.
+namespace pw::libc {
+
+// Behaves like std::memcpy.
+void* Memcpy(void* dest, const void* src, size_t size);
+
+// Behaves like std::memmove.
+void* Memmove(void* dest, const void* src, size_t size);
+
+// Behaves like std::memset.
+void* Memset(void* dest, int value, size_t size);
+
+}  // namespace pw::libc
@@ -726,6 +726,51 @@ class TestLogStreamDecoderDecodingFunctionality(TestLogStreamDecoderBase):
             test_log.metadata_fields,
         )
 
+    def test_parse_compact_log_entries(self):
+        """Tests that compact entries inherit omitted fields."""
+        line_level = Log.pack_line_level(10, logging.INFO)
+        log_entries = log_pb2.LogEntries(
+            first_entry_sequence_id=0,
+            compact_entries=True,
+            entries=[
+                log_pb2.LogEntry(
+                    message=b'first',
+                    line_level=line_level,
+                    flags=3,
+                    timestamp=1_500_000_000,
+                    module=b'wifi',
+                ),
+                log_pb2.LogEntry(
+                    message=b'second',
+                    line_level=line_level,
+                    time_since_last_entry=250_000_000,
+                ),
+                _create_drop_count_message_log_entry(2),
+                log_pb2.LogEntry(
+                    message=b'third',
+                    line_level=line_level,
+                    flags=0,
+                    time_since_last_entry=200_000_000,
+                ),
+            ],
+        )
+        self.decoder.parse_log_entries_proto(log_entries)
+
+        self.assertEqual(len(self.captured_logs), 4)
+        first, second, dropped, third = self.captured_logs
+        self.assertEqual(first.timestamp, '0:00:01.500')
+        self.assertEqual(second.timestamp, '0:00:01.750')
+        self.assertEqual(second.flags, 3)
+        self.assertEqual(second.module_name, 'wifi')
+        self.assertEqual(
+            dropped.message,
+            'Dropped 2 logs due to '
+            f'{LogStreamDecoder.DROP_REASON_SOURCE_ENQUEUE_FAILURE}',
+        )
+        self.assertEqual(third.timestamp, '0:00:01.950')
+        self.assertEqual(third.flags, 0)
+        self.assertEqual(third.module_name, 'wifi')
+
 
 class TestLogStreamDecoderLogDropDetectionFunctionality(
     TestLogStreamDecoderBase
@@ -18,7 +18,7 @@ from dataclasses import dataclass
 import datetime
 import logging
 import re
-from typing import Any, Callable, Dict, Optional
+from typing import Any, Callable, Dict, Iterable, List, Optional
 
 from pw_log.proto import log_pb2
 import pw_log_tokenized
@@ -288,7 +288,11 @@ class LogStreamDecoder:
         elif dropped_log_count < 0:
             _LOG.error('Log sequence ID is smaller than expected')
 
-        for i, log_entry_proto in enumerate(log_entries_proto.entries):
+        entries = log_entries_proto.entries
+        if log_entries_proto.compact_entries:
+            entries = self._expand_compact_entries(entries)
+
+        for i, log_entry_proto in enumerate(entries):
             # Handle dropped count first.
             if log_entry_proto.dropped:
                 # Avoid duplicating drop reports since the device will report
@@ -300,6 +304,44 @@ class LogStreamDecoder:
             parsed_log = self.parse_log_entry_proto(log_entry_proto)
             self.decoded_log_handler(parsed_log)
 
+    @staticmethod
+    def _expand_compact_entries(
+        entries: Iterable[log_pb2.LogEntry],
+    ) -> List[log_pb2.LogEntry]:
+        """Restores the fields omitted from compact LogEntries.
+
+        Compact entries carry a timestamp relative to the previous entry, and
+        only set the flags and module when they change. Entries with a dropped
+        count are standalone.
+        """
+        expanded: List[log_pb2.LogEntry] = []
+        timestamp = 0
+        flags = 0
+        module = b''
+        for compact_entry in entries:
+            entry = log_pb2.LogEntry()
+            entry.CopyFrom(compact_entry)
+            expanded.append(entry)
+            if entry.dropped:
+                continue
+
+            if entry.HasField('time_since_last_entry'):
+                timestamp += entry.time_since_last_entry
+                entry.timestamp = timestamp
+            elif entry.HasField('timestamp'):
+                timestamp = entry.timestamp
+
+            if entry.HasField('flags'):
+                flags = entry.flags
+            else:
+                entry.flags = flags
+
+            if entry.HasField('module'):
+                module = entry.module
+            else:
+                entry.module = module
+        return expanded
+
     def parse_log_entry_proto(self, log_entry_proto: log_pb2.LogEntry) -> Log:
         """Parses the log_entry_proto contents into a human readable format.
 
@@ -0,0 +1,401 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Deferred log implementation. Logging copies the format string pointer and the
+// tokenizer-encoded arguments into a ring buffer. ProcessDeferredLogs() formats
+// the queued logs and writes them with the regular pw_log_basic output.
+
+#include "pw_log_basic/deferred.h"
+
+#include <array>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+#include "pw_log/levels.h"
+#include "pw_log_basic_private/config.h"
+#include "pw_log_basic_private/format.h"
+#include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+#include "pw_span/span.h"
+#include "pw_string/string_builder.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_tokenizer/encode_args.h"
+#include "pw_varint/varint.h"
+
+namespace pw::log_basic {
+namespace {
+
+// Everything but the arguments is captured by pointer or value.
+struct EntryHeader {
+  const char* message;
+  const char* module_name;
+  const char* file_name;
+  const char* function_name;
+  pw_tokenizer_ArgTypes arg_types;
+  int line_number;
+  int level;
+  unsigned int flags;
+};
+
+constexpr size_t kMaxEntrySizeBytes =
+    sizeof(EntryHeader) + PW_LOG_BASIC_DEFERRED_ARGS_SIZE_BYTES;
+
+class LogQueue {
+ public:
+  LogQueue() {
+    ring_buffer_.SetBuffer(buffer_)
+        .IgnoreError();  // The buffer is statically known to be valid.
+  }
+
+  void Push(span<const std::byte> entry) {
+    std::lock_guard lock(lock_);
+    if (!ring_buffer_.TryPushBack(entry).ok()) {
+      dropped_ += 1;
+    }
+  }
+
+  // Copies out and removes the oldest entry. Returns its size, or 0 if the
+  // queue is empty. Also returns the number of entries dropped since the last
+  // call.
+  size_t Pop(span<std::byte> entry, uint32_t& dropped) {
+    std::lock_guard lock(lock_);
+    dropped = std::exchange(dropped_, 0u);
+
+    size_t size = 0;
+    if (!ring_buffer_.PeekFront(entry, &size).ok()) {
+      return 0;
+    }
+    ring_buffer_.PopFront().IgnoreError();  // An entry was just peeked.
+    return size;
+  }
+
+ private:
+  sync::InterruptSpinLock lock_;
+  ring_buffer::PrefixedEntryRingBuffer ring_buffer_ PW_GUARDED_BY(lock_);
+  uint32_t dropped_ PW_GUARDED_BY(lock_) = 0;
+  std::array<std::byte, PW_LOG_BASIC_DEFERRED_BUFFER_SIZE_BYTES> buffer_;
+};
+
+LogQueue& Queue() {
+  static LogQueue queue;
+  return queue;
+}
+
+void (*log_queued)() = nullptr;
+
+// Reads the next encoded argument. Returns false if it's missing or corrupt.
+bool ReadInt(span<const std::byte>& args, int64_t& value) {
+  const size_t bytes = varint::Decode(args, &value);
+  args = args.subspan(bytes);
+  return bytes != 0u;
+}
+
+bool ReadFloat(span<const std::byte>& args, double& value) {
+  float float_value;
+  if (args.size() < sizeof(float_value)) {
+    return false;
+  }
+  std::memcpy(&float_value, args.data(), sizeof(float_value));
+  args = args.subspan(sizeof(float_value));
+  value = float_value;
+  return true;
+}
+
+bool ReadString(span<const std::byte>& args, std::array<char, 128>& value) {
+  if (args.empty()) {
+    return false;
+  }
+  const size_t size = static_cast<size_t>(args[0] & std::byte{0x7f});
+  if (args.size() < size + 1) {
+    return false;
+  }
+  std::memcpy(value.data(), args.data() + 1, size);
+  value[size] = '\0';
+  args = args.subspan(size + 1);
+  return true;
+}
+
+// Replays one conversion specification with its decoded argument. The length
+// modifier in the spec is replaced to match the type of the decoded value.
+bool FormatArg(StringBuilder& output,
+               std::array<char, 32>& spec,
+               size_t spec_length,
+               char length_modifier,
+               char conversion,
+               pw_tokenizer_ArgTypes type,
+               span<const std::byte>& args) {
+  if (type == PW_TOKENIZER_ARG_TYPE_STRING) {
+    std::array<char, 128> value;
+    if (conversion != 's' || !ReadString(args, value)) {
+      return false;
+    }
+    spec[spec_length++] = 's';
+    spec[spec_length] = '\0';
+    output.Format(spec.data(), value.data());
+    return true;
+  }
+
+  if (type == PW_TOKENIZER_ARG_TYPE_DOUBLE) {
+    double value;
+    if (std::strchr("fFeEgGaA", conversion) == nullptr ||
+        !ReadFloat(args, value)) {
+      return false;
+    }
+    spec[spec_length++] = conversion;
+    spec[spec_length] = '\0';
+    output.Format(spec.data(), value);
+    return true;
+  }
+
+  int64_t value;
+  if (!ReadInt(args, value)) {
+    return false;
+  }
+
+  // The encoded argument type, not the length modifier, gives the argument's
+  // size. A long is 32 bits on most targets, so %lx may have a 32-bit argument.
+  const bool is_64_bit = type == PW_TOKENIZER_ARG_TYPE_INT64;
+
+  if (conversion == 'p') {
+    spec[spec_length++] = 'p';
+    spec[spec_length] = '\0';
+    const uintptr_t address =
+        is_64_bit ? static_cast<uintptr_t>(value)
+                  : static_cast<uintptr_t>(static_cast<uint32_t>(value));
+    output.Format(spec.data(), reinterpret_cast<void*>(address));
+    return true;
+  }
+
+  if (std::strchr("diuoxXc", conversion) == nullptr) {
+    return false;
+  }
+
+  const bool is_signed = conversion == 'd' || conversion == 'i';
+
+  // 32-bit arguments are sign extended when encoded. Truncate them back to 32
+  // bits so that unsigned values with the top bit set print correctly.
+  if (!is_64_bit) {
+    value = is_signed ? static_cast<int64_t>(static_cast<int32_t>(value))
+                      : static_cast<int64_t>(static_cast<uint32_t>(value));
+  }
+
+  if (is_64_bit && conversion != 'c') {
+    spec[spec_length++] = 'l';
+    spec[spec_length++] = 'l';
+    spec[spec_length++] = conversion;
+    spec[spec_length] = '\0';
+    if (is_signed) {
+      output.Format(spec.data(), static_cast<long long>(value));
+    } else {
+      output.Format(spec.data(), static_cast<unsigned long long>(value));
+    }
+    return true;
+  }
+
+  spec[spec_length++] = conversion;
+  spec[spec_length] = '\0';
+  if (length_modifier == 'H') {  // hh
+    value = is_signed ? static_cast<signed char>(value)
+                      : static_cast<unsigned char>(value);
+  } else if (length_modifier == 'h') {
+    value = is_signed ? static_cast<short>(value)
+                      : static_cast<unsigned short>(value);
+  }
+
+  if (is_signed || conversion == 'c') {
+    output.Format(spec.data(), static_cast<int>(value));
+  } else {
+    output.Format(spec.data(), static_cast<unsigned>(value));
+  }
+  return true;
+}
+
+// Formats a message from its printf-style format string and the arguments
+// encoded by pw_tokenizer_EncodeArgs.
+void FormatMessage(StringBuilder& output,
+                   const char* format,
+                   pw_tokenizer_ArgTypes types,
+                   span<const std::byte> args) {
+  size_t arg_count = types & PW_TOKENIZER_TYPE_COUNT_MASK;
+  types >>= PW_TOKENIZER_TYPE_COUNT_SIZE_BITS;
+
+  while (*format != '\0') {
+    if (*format != '%') {
+      output.push_back(*format++);
+      continue;
+    }
+    if (format[1] == '%') {
+      output.push_back('%');
+      format += 2;
+      continue;
+    }
+
+    const char* const spec_start = format++;
+    std::array<char, 32> spec;
+    size_t spec_length = 0;
+    spec[spec_length++] = '%';
+    bool ok = true;
+
+    // Flags, width, and precision are copied to the spec. Arguments for *
+    // width or precision are written into the spec as digits.
+    while (*format != '\0' && std::strchr("-+ #0123456789.*", *format)) {
+      if (spec_length + 24 >= spec.size()) {
+        ok = false;
+        break;
+      }
+      if (*format == '*') {
+        int64_t value;
+        if (arg_count == 0u || (types & 0b11u) > PW_TOKENIZER_ARG_TYPE_INT64 ||
+            !ReadInt(args, value)) {
+          ok = false;
+          break;
+        }
+        arg_count -= 1;
+        types >>= 2;
+        spec_length += static_cast<size_t>(
+            std::snprintf(&spec[spec_length],
+                          spec.size() - spec_length,
+                          "%d",
+                          static_cast<int>(value)));
+      } else {
+        spec[spec_length++] = *format;
+      }
+      format += 1;
+    }
+
+    // Length modifiers are dropped from the spec and reapplied by FormatArg.
+    // 'H' stands for hh.
+    char length_modifier = '\0';
+    while (*format != '\0' && std::strchr("hljztL", *format)) {
+      length_modifier = (length_modifier == *format && *format == 'h')
+                            ? 'H'
+                            : *format;
+      format += 1;
+    }
+
+    const char conversion = *format;
+    if (conversion != '\0') {
+      format += 1;
+    }
+
+    ok = ok && arg_count != 0u &&
+         FormatArg(output,
+                   spec,
+                   spec_length,
+                   length_modifier,
+                   conversion,
+                   types & 0b11u,
+                   args);
+    if (!ok) {
+      // The arguments are missing or do not match the format string. Output
+      // the rest of the format string as is.
+      output << spec_start;
+      return;
+    }
+
+    arg_count -= 1;
+    types >>= 2;
+  }
+}
+
+void OutputEntry(span<const std::byte> entry) {
+  EntryHeader header;
+  std::memcpy(&header, entry.data(), sizeof(header));
+
+  StringBuffer<PW_LOG_BASIC_ENTRY_SIZE> buffer;
+  internal::AppendPrefix(buffer,
+                         header.level,
+                         header.flags,
+                         header.module_name,
+                         header.file_name,
+                         header.line_number,
+                         header.function_name);
+  FormatMessage(buffer,
+                header.message,
+                header.arg_types,
+                entry.subspan(sizeof(header)));
+  internal::WriteLog(buffer);
+}
+
+void OutputDropped(uint32_t dropped) {
+  StringBuffer<PW_LOG_BASIC_ENTRY_SIZE> buffer;
+  internal::AppendPrefix(
+      buffer, PW_LOG_LEVEL_WARN, 0, "", __FILE__, __LINE__, __func__);
+  buffer.Format("Dropped %u deferred logs", static_cast<unsigned>(dropped));
+  internal::WriteLog(buffer);
+}
+
+}  // namespace
+
+extern "C" void pw_log_basic_DeferLog(int level,
+                                      unsigned int flags,
+                                      const char* module_name,
+                                      const char* file_name,
+                                      int line_number,
+                                      const char* function_name,
+                                      pw_tokenizer_ArgTypes arg_types,
+                                      const char* message,
+                                      ...) {
+  const EntryHeader header{message,
+                           module_name,
+                           file_name,
+                           function_name,
+                           arg_types,
+                           line_number,
+                           level,
+                           flags};
+
+  std::array<std::byte, kMaxEntrySizeBytes> entry;
+  std::memcpy(entry.data(), &header, sizeof(header));
+
+  va_list args;
+  va_start(args, message);
+  const size_t args_size =
+      pw_tokenizer_EncodeArgs(arg_types,
+                              args,
+                              entry.data() + sizeof(header),
+                              entry.size() - sizeof(header));
+  va_end(args);
+
+  Queue().Push(span(entry.data(), sizeof(header) + args_size));
+
+  if (log_queued != nullptr) {
+    log_queued();
+  }
+}
+
+size_t ProcessDeferredLogs() {
+  std::array<std::byte, kMaxEntrySizeBytes> entry;
+  size_t processed = 0;
+
+  while (true) {
+    uint32_t dropped;
+    const size_t size = Queue().Pop(entry, dropped);
+    if (dropped != 0u) {
+      OutputDropped(dropped);
+    }
+    if (size == 0u) {
+      return processed;
+    }
+    OutputEntry(span(entry.data(), size));
+    processed += 1;
+  }
+}
+
+void SetDeferredLogCallback(void (*callback)()) { log_queued = callback; }
+
+}  // namespace pw::log_basic
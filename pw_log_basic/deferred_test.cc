@@ -0,0 +1,154 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_basic/deferred.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_log/levels.h"
+#include "pw_log_basic/log_basic.h"
+#include "pw_string/string_builder.h"
+#include "pw_sys_io/sys_io.h"
+
+namespace pw::log_basic {
+namespace {
+
+StringBuffer<256> first_log;
+StringBuffer<256> last_log;
+int log_count = 0;
+int queued_count = 0;
+
+bool EndsWith(std::string_view log, std::string_view message) {
+  return log.size() >= message.size() &&
+         log.substr(log.size() - message.size()) == message;
+}
+
+#define DEFER_LOG(...) \
+  PW_LOG_BASIC_DEFER(PW_LOG_LEVEL_INFO, "TST", 0, __VA_ARGS__)
+
+class DeferredLogTest : public ::testing::Test {
+ protected:
+  DeferredLogTest() {
+    SetOutput([](std::string_view log) {
+      if (log_count == 0) {
+        first_log.clear();
+        first_log << log;
+      }
+      last_log.clear();
+      last_log << log;
+      log_count += 1;
+    });
+    SetDeferredLogCallback([] { queued_count += 1; });
+    ProcessDeferredLogs();
+    log_count = 0;
+    queued_count = 0;
+  }
+
+  ~DeferredLogTest() override {
+    SetDeferredLogCallback(nullptr);
+    // Restore the default output so the test framework's logs are visible.
+    SetOutput(
+        [](std::string_view log) { sys_io::WriteLine(log).IgnoreError(); });
+  }
+
+  void ExpectLog(std::string_view message) {
+    EXPECT_EQ(ProcessDeferredLogs(), 1u);
+    EXPECT_TRUE(EndsWith(last_log.view(), message));
+  }
+};
+
+TEST_F(DeferredLogTest, NotOutputUntilProcessed) {
+  DEFER_LOG("Hello");
+  EXPECT_EQ(log_count, 0);
+  EXPECT_EQ(queued_count, 1);
+
+  ExpectLog("Hello");
+  EXPECT_EQ(log_count, 1);
+  EXPECT_EQ(ProcessDeferredLogs(), 0u);
+}
+
+TEST_F(DeferredLogTest, OutputInOrder) {
+  DEFER_LOG("one");
+  DEFER_LOG("two");
+  EXPECT_EQ(ProcessDeferredLogs(), 2u);
+  EXPECT_EQ(log_count, 2);
+  EXPECT_TRUE(EndsWith(last_log.view(), "two"));
+}
+
+TEST_F(DeferredLogTest, Integers) {
+  DEFER_LOG("%d %u %x %X %o %c", -5, 7u, 0xabu, 0xCDu, 8u, 'Z');
+  ExpectLog("-5 7 ab CD 10 Z");
+}
+
+TEST_F(DeferredLogTest, LengthModifiers) {
+  DEFER_LOG("%lld %llu %hhd %hu %ld",
+            static_cast<long long>(-1234567890123),
+            static_cast<unsigned long long>(UINT64_MAX),
+            static_cast<signed char>(-3),
+            static_cast<unsigned short>(65535),
+            -9L);
+  ExpectLog("-1234567890123 18446744073709551615 -3 65535 -9");
+}
+
+TEST_F(DeferredLogTest, LongWithTopBitSet) {
+  DEFER_LOG("%lx %ld %x",
+            static_cast<unsigned long>(0x80000000u),
+            static_cast<long>(INT32_MIN),
+            0x80000000u);
+  ExpectLog("80000000 -2147483648 80000000");
+}
+
+TEST_F(DeferredLogTest, FlagsWidthAndPrecision) {
+  DEFER_LOG(
+      "[%5d] [%-4d] [%04x] [%.2f] [%*d] [%.*s]", 1, 2, 3u, 1.5, 3, 4, 2, "abc");
+  ExpectLog("[    1] [2   ] [0003] [1.50] [  4] [ab]");
+}
+
+TEST_F(DeferredLogTest, Percent) {
+  DEFER_LOG("100%% %s", "done");
+  ExpectLog("100% done");
+}
+
+TEST_F(DeferredLogTest, StringsAreCopied) {
+  char name[] = "before";
+  DEFER_LOG("name=%s", name);
+  std::strcpy(name, "after!");
+  ExpectLog("name=before");
+}
+
+TEST_F(DeferredLogTest, BufferFull_DropsAndReportsLogs) {
+  constexpr int kLogs = 200;
+  for (int i = 0; i < kLogs; ++i) {
+    DEFER_LOG("Log %d", i);
+  }
+
+  const int processed = static_cast<int>(ProcessDeferredLogs());
+  ASSERT_LT(processed, kLogs);
+  EXPECT_EQ(log_count, processed + 1);
+
+  // The drop count is reported first, then the oldest logs, which were kept.
+  StringBuffer<64> expected;
+  expected.Format("Dropped %d deferred logs", kLogs - processed);
+  EXPECT_TRUE(EndsWith(first_log.view(), expected.view()));
+
+  expected.clear();
+  expected.Format("Log %d", processed - 1);
+  EXPECT_TRUE(EndsWith(last_log.view(), expected.view()));
+}
+
+}  // namespace
+}  // namespace pw::log_basic
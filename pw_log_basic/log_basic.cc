@@ -20,6 +20,7 @@
 
 #include "pw_log/levels.h"
 #include "pw_log_basic_private/config.h"
+#include "pw_log_basic_private/format.h"
 #include "pw_string/string_builder.h"
 #include "pw_sys_io/sys_io.h"
 
@@ -90,18 +91,15 @@ void (*write_log)(std::string_view) = [](std::string_view log) {
 
 }  // namespace
 
-// This is a fully loaded, inefficient-at-the-callsite, log implementation.
-extern "C" void pw_Log(int level,
-                       unsigned int flags,
-                       const char* module_name,
-                       const char* file_name,
-                       int line_number,
-                       const char* function_name,
-                       const char* message,
-                       ...) {
-  // Accumulate the log message in this buffer, then output it.
-  pw::StringBuffer<PW_LOG_BASIC_ENTRY_SIZE> buffer;
+namespace internal {
 
+void AppendPrefix(StringBuilder& buffer,
+                  int level,
+                  unsigned int flags,
+                  const char* module_name,
+                  const char* file_name,
+                  int line_number,
+                  const char* function_name) {
   // Column: Timestamp
   // Note that this macro method defaults to a no-op.
   PW_LOG_APPEND_TIMESTAMP(buffer);
@@ -144,6 +142,31 @@ extern "C" void pw_Log(int level,
 
   // Column: Level
   buffer << LogLevelToLogLevelName(level) << "  ";
+}
+
+void WriteLog(std::string_view log) { write_log(log); }
+
+}  // namespace internal
+
+// This is a fully loaded, inefficient-at-the-callsite, log implementation.
+extern "C" void pw_Log(int level,
+                       unsigned int flags,
+                       const char* module_name,
+                       const char* file_name,
+                       int line_number,
+                       const char* function_name,
+                       const char* message,
+                       ...) {
+  // Accumulate the log message in this buffer, then output it.
+  pw::StringBuffer<PW_LOG_BASIC_ENTRY_SIZE> buffer;
+
+  internal::AppendPrefix(buffer,
+                         level,
+                         flags,
+                         module_name,
+                         file_name,
+                         line_number,
+                         function_name);
 
   // Column: Message
   va_list args;
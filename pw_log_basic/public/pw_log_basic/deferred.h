@@ -0,0 +1,74 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_preprocessor/arguments.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_preprocessor/util.h"
+#include "pw_tokenizer/tokenize.h"
+
+PW_EXTERN_C_START
+
+// Queues a log message to be formatted later by ProcessDeferredLogs(). The
+// message, module, file, and function strings must have static storage
+// duration. The arguments are copied, including the contents of strings.
+void pw_log_basic_DeferLog(int level,
+                           unsigned int flags,
+                           const char* module_name,
+                           const char* file_name,
+                           int line_number,
+                           const char* function_name,
+                           pw_tokenizer_ArgTypes arg_types,
+                           const char* message,
+                           ...) PW_PRINTF_FORMAT(8, 9);
+
+PW_EXTERN_C_END
+
+// Queues a log message with many attributes included.
+//
+// Like PW_HANDLE_LOG in pw_log_basic/log_basic.h, but the caller only copies
+// the format string pointer and encoded arguments into a ring buffer. Argument
+// types are captured at compile time with PW_TOKENIZER_ARG_TYPES, which limits
+// logs to PW_TOKENIZER_MAX_SUPPORTED_ARGS arguments.
+#define PW_LOG_BASIC_DEFER(level, module, flags, message, ...) \
+  do {                                                         \
+    pw_log_basic_DeferLog((level),                             \
+                          (flags),                             \
+                          module,                              \
+                          __FILE__,                            \
+                          __LINE__,                            \
+                          __func__,                            \
+                          PW_TOKENIZER_ARG_TYPES(__VA_ARGS__), \
+                          message PW_COMMA_ARGS(__VA_ARGS__)); \
+  } while (0)
+
+#ifdef __cplusplus
+
+#include <cstddef>
+
+namespace pw::log_basic {
+
+// Formats and outputs all queued logs with the function set by SetOutput().
+// Call this from a low-priority thread or work queue item. Returns the number
+// of logs that were output.
+size_t ProcessDeferredLogs();
+
+// Sets a function that is called each time a log is queued, such as one that
+// wakes the thread that calls ProcessDeferredLogs(). The function runs in the
+// logging context, so it must be fast and must not log.
+void SetDeferredLogCallback(void (*log_queued)());
+
+}  // namespace pw::log_basic
+
+#endif  // __cplusplus
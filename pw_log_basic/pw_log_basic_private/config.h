@@ -74,3 +74,17 @@
 #ifndef PW_LOG_BASIC_ENTRY_SIZE
 #define PW_LOG_BASIC_ENTRY_SIZE 150
 #endif  // PW_LOG_BASIC_ENTRY_SIZE
+
+// Size of the ring buffer that holds logs for the deferred backend until they
+// are formatted by pw::log_basic::ProcessDeferredLogs(). Logs that do not fit
+// are dropped and counted.
+#ifndef PW_LOG_BASIC_DEFERRED_BUFFER_SIZE_BYTES
+#define PW_LOG_BASIC_DEFERRED_BUFFER_SIZE_BYTES 2048
+#endif  // PW_LOG_BASIC_DEFERRED_BUFFER_SIZE_BYTES
+
+// Maximum size of a deferred log's encoded arguments. Arguments that do not fit
+// are omitted from the formatted message. The buffer for the arguments is
+// allocated on the stack on every deferred log call.
+#ifndef PW_LOG_BASIC_DEFERRED_ARGS_SIZE_BYTES
+#define PW_LOG_BASIC_DEFERRED_ARGS_SIZE_BYTES 64
+#endif  // PW_LOG_BASIC_DEFERRED_ARGS_SIZE_BYTES
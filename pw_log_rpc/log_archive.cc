@@ -0,0 +1,554 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/log_archive.h"
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+#include "pw_bytes/endian.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_status/try.h"
+#include "pw_varint/stream.h"
+#include "pw_varint/varint.h"
+
+namespace pw::log_rpc {
+namespace {
+
+// Bounds the memory a corrupt archive can make a reader allocate.
+constexpr uint64_t kMaxIndexSizeBytes = 1 << 20;
+constexpr uint64_t kMaxDataSizeBytes = 1 << 30;
+
+// The size of a protobuf field's key and length prefix, at most.
+constexpr size_t kMaxFieldOverheadBytes = 2 * varint::kMaxVarint64SizeBytes;
+
+// Bits in the token filter per distinct token. With 4 hashes, this gives a
+// false positive rate of about 1%.
+constexpr size_t kFilterBitsPerToken = 10;
+constexpr size_t kMinFilterBits = 64;
+
+void AppendVarint(std::vector<std::byte>& column, uint64_t value) {
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> buffer;
+  const size_t size = varint::Encode(value, buffer);
+  column.insert(column.end(), buffer.begin(), buffer.begin() + size);
+}
+
+// Reads the varints in a column.
+class VarintColumn {
+ public:
+  explicit VarintColumn(ConstByteSpan data) : data_(data) {}
+
+  bool Read(uint64_t& value) {
+    const size_t size = varint::Decode(data_, &value);
+    data_ = data_.subspan(size);
+    return size != 0u;
+  }
+
+  bool empty() const { return data_.empty(); }
+
+ private:
+  ConstByteSpan data_;
+};
+
+// Replaces each value with its index in a dictionary of the distinct values.
+void DictionaryEncode(const std::vector<uint32_t>& values,
+                      std::vector<uint32_t>& dictionary,
+                      std::vector<std::byte>& indices) {
+  std::unordered_map<uint32_t, uint32_t> index_of;
+  for (uint32_t value : values) {
+    const auto [entry, added] =
+        index_of.try_emplace(value, static_cast<uint32_t>(dictionary.size()));
+    if (added) {
+      dictionary.push_back(value);
+    }
+    AppendVarint(indices, entry->second);
+  }
+}
+
+Status DecodePackedFixed32(ConstByteSpan data, std::vector<uint32_t>& values) {
+  if (data.size() % sizeof(uint32_t) != 0u) {
+    return Status::DataLoss();
+  }
+  values.clear();
+  for (size_t i = 0; i < data.size(); i += sizeof(uint32_t)) {
+    values.push_back(
+        bytes::ReadInOrder<uint32_t>(endian::little, &data[i]));
+  }
+  return OkStatus();
+}
+
+Status DecodeIndices(ConstByteSpan data,
+                     const std::vector<uint32_t>& dictionary,
+                     uint32_t count,
+                     std::vector<uint32_t>& values) {
+  VarintColumn column(data);
+  values.clear();
+  for (uint32_t i = 0; i < count; ++i) {
+    uint64_t index;
+    if (!column.Read(index) || index >= dictionary.size()) {
+      return Status::DataLoss();
+    }
+    values.push_back(dictionary[index]);
+  }
+  return column.empty() ? OkStatus() : Status::DataLoss();
+}
+
+constexpr bool IsPowerOf2(size_t value) {
+  return value != 0u && (value & (value - 1)) == 0u;
+}
+
+size_t RoundUpToPowerOf2(size_t value) {
+  size_t power = 1;
+  while (power < value) {
+    power <<= 1;
+  }
+  return power;
+}
+
+uint32_t Mix(uint32_t value) {
+  value ^= value >> 16;
+  value *= 0x7feb352du;
+  value ^= value >> 15;
+  value *= 0x846ca68bu;
+  value ^= value >> 16;
+  return value;
+}
+
+}  // namespace
+
+size_t LogArchive::FilterBit(uint32_t token, size_t hash, size_t filter_bits) {
+  // Derive the hashes from two, as described by Kirsch and Mitzenmacher.
+  const uint32_t first = Mix(token);
+  const uint32_t second = Mix(first) | 1u;
+  return (first + static_cast<uint32_t>(hash) * second) & (filter_bits - 1);
+}
+
+bool LogArchive::FilterMayContain(ConstByteSpan filter, uint32_t token) {
+  const size_t filter_bits = filter.size() * 8;
+  if (!IsPowerOf2(filter_bits)) {
+    return true;
+  }
+  for (size_t hash = 0; hash < kFilterHashes; ++hash) {
+    const size_t bit = FilterBit(token, hash, filter_bits);
+    if ((filter[bit / 8] & std::byte(1u << (bit % 8))) == std::byte(0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status LogArchiveWriter::Append(const LogArchiveEntry& entry) {
+  timestamps_.push_back(entry.timestamp);
+  tokens_.push_back(entry.token);
+  levels_.push_back(entry.level);
+  modules_.push_back(entry.module);
+  arg_sizes_.push_back(static_cast<uint32_t>(entry.args.size()));
+  args_.insert(args_.end(), entry.args.begin(), entry.args.end());
+
+  if (timestamps_.size() >= entries_per_chunk_) {
+    return WriteChunk();
+  }
+  return OkStatus();
+}
+
+Status LogArchiveWriter::Flush() {
+  if (timestamps_.empty() && header_written_) {
+    return OkStatus();
+  }
+  return WriteChunk();
+}
+
+Status LogArchiveWriter::WriteChunk() {
+  if (!header_written_) {
+    std::array<std::byte, kFileHeaderSizeBytes> header;
+    const auto magic = bytes::CopyInOrder(endian::little, kMagic);
+    const auto version = bytes::CopyInOrder(endian::little, kVersion);
+    std::copy(magic.begin(), magic.end(), header.begin());
+    std::copy(version.begin(), version.end(), header.begin() + magic.size());
+    PW_TRY(output_.Write(header));
+    header_written_ = true;
+  }
+  if (timestamps_.empty()) {
+    return OkStatus();
+  }
+
+  const auto [min, max] =
+      std::minmax_element(timestamps_.begin(), timestamps_.end());
+  const int64_t min_timestamp = *min;
+  const int64_t max_timestamp = *max;
+
+  // Encode the columns. Deltas are computed as unsigned to wrap rather than
+  // overflow.
+  std::vector<std::byte> timestamps;
+  uint64_t previous = static_cast<uint64_t>(min_timestamp);
+  for (int64_t timestamp : timestamps_) {
+    const uint64_t delta = static_cast<uint64_t>(timestamp) - previous;
+    AppendVarint(timestamps, varint::ZigZagEncode(static_cast<int64_t>(delta)));
+    previous = static_cast<uint64_t>(timestamp);
+  }
+
+  std::vector<uint32_t> token_dictionary;
+  std::vector<std::byte> token_indices;
+  DictionaryEncode(tokens_, token_dictionary, token_indices);
+
+  std::vector<std::byte> levels;
+  for (size_t i = 0; i < levels_.size();) {
+    size_t run = 1;
+    while (i + run < levels_.size() && levels_[i + run] == levels_[i]) {
+      run += 1;
+    }
+    AppendVarint(levels, levels_[i]);
+    AppendVarint(levels, run);
+    i += run;
+  }
+
+  std::vector<uint32_t> module_dictionary;
+  std::vector<std::byte> module_indices;
+  DictionaryEncode(modules_, module_dictionary, module_indices);
+
+  std::vector<std::byte> arg_sizes;
+  for (uint32_t size : arg_sizes_) {
+    AppendVarint(arg_sizes, size);
+  }
+
+  std::vector<std::byte> token_filter(
+      std::max(kMinFilterBits,
+               RoundUpToPowerOf2(token_dictionary.size() *
+                                 kFilterBitsPerToken)) /
+      8);
+  for (uint32_t token : token_dictionary) {
+    for (size_t hash = 0; hash < kFilterHashes; ++hash) {
+      const size_t bit = FilterBit(token, hash, token_filter.size() * 8);
+      token_filter[bit / 8] |= std::byte(1u << (bit % 8));
+    }
+  }
+
+  // Encode the data message, then the index message that precedes it.
+  std::vector<std::byte> data(
+      7 * kMaxFieldOverheadBytes + timestamps.size() +
+      token_dictionary.size() * sizeof(uint32_t) + token_indices.size() +
+      levels.size() + module_indices.size() + arg_sizes.size() + args_.size());
+  protobuf::MemoryEncoder data_encoder(data);
+  data_encoder
+      .WriteBytes(static_cast<uint32_t>(DataField::kTimestamps), timestamps)
+      .IgnoreError();  // Errors are checked with status().
+  data_encoder
+      .WritePackedFixed32(static_cast<uint32_t>(DataField::kTokens),
+                          token_dictionary)
+      .IgnoreError();
+  data_encoder
+      .WriteBytes(static_cast<uint32_t>(DataField::kTokenIndices),
+                  token_indices)
+      .IgnoreError();
+  data_encoder.WriteBytes(static_cast<uint32_t>(DataField::kLevels), levels)
+      .IgnoreError();
+  data_encoder
+      .WriteBytes(static_cast<uint32_t>(DataField::kModuleIndices),
+                  module_indices)
+      .IgnoreError();
+  data_encoder
+      .WriteBytes(static_cast<uint32_t>(DataField::kArgSizes), arg_sizes)
+      .IgnoreError();
+  data_encoder.WriteBytes(static_cast<uint32_t>(DataField::kArgs), args_)
+      .IgnoreError();
+  PW_TRY(data_encoder.status());
+
+  std::vector<std::byte> index(6 * kMaxFieldOverheadBytes +
+                               module_dictionary.size() * sizeof(uint32_t) +
+                               token_filter.size());
+  protobuf::MemoryEncoder index_encoder(index);
+  index_encoder
+      .WriteUint32(static_cast<uint32_t>(IndexField::kEntryCount),
+                   static_cast<uint32_t>(timestamps_.size()))
+      .IgnoreError();
+  index_encoder
+      .WriteSint64(static_cast<uint32_t>(IndexField::kMinTimestamp),
+                   min_timestamp)
+      .IgnoreError();
+  index_encoder
+      .WriteSint64(static_cast<uint32_t>(IndexField::kMaxTimestamp),
+                   max_timestamp)
+      .IgnoreError();
+  index_encoder
+      .WritePackedFixed32(static_cast<uint32_t>(IndexField::kModules),
+                          module_dictionary)
+      .IgnoreError();
+  index_encoder
+      .WriteBytes(static_cast<uint32_t>(IndexField::kTokenFilter),
+                  token_filter)
+      .IgnoreError();
+  index_encoder
+      .WriteUint32(static_cast<uint32_t>(IndexField::kDataSizeBytes),
+                   static_cast<uint32_t>(data_encoder.size()))
+      .IgnoreError();
+  PW_TRY(index_encoder.status());
+
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> index_size;
+  PW_TRY(output_.Write(
+      span(index_size).first(varint::Encode(index_encoder.size(), index_size))));
+  PW_TRY(output_.Write(index_encoder));
+  PW_TRY(output_.Write(data_encoder));
+
+  timestamps_.clear();
+  tokens_.clear();
+  levels_.clear();
+  modules_.clear();
+  arg_sizes_.clear();
+  args_.clear();
+  chunks_written_ += 1;
+  return OkStatus();
+}
+
+Result<LogArchiveEntry> LogArchiveReader::Next() {
+  while (true) {
+    while (next_entry_ < entry_count_) {
+      const size_t i = next_entry_++;
+      if (Matches(i)) {
+        LogArchiveEntry entry;
+        entry.timestamp = timestamps_[i];
+        entry.token = tokens_[i];
+        entry.level = levels_[i];
+        entry.module = modules_[i];
+        entry.args = args_[i];
+        return entry;
+      }
+    }
+    PW_TRY(LoadNextChunk());
+  }
+}
+
+Status LogArchiveReader::LoadNextChunk() {
+  if (!header_read_) {
+    std::array<std::byte, kFileHeaderSizeBytes> header;
+    if (!ReadExact(header).ok() ||
+        bytes::ReadInOrder<uint32_t>(endian::little, &header[0]) != kMagic ||
+        bytes::ReadInOrder<uint32_t>(endian::little, &header[4]) != kVersion) {
+      return Status::DataLoss();
+    }
+    header_read_ = true;
+  }
+
+  entry_count_ = 0;
+  next_entry_ = 0;
+
+  while (true) {
+    // The end of the archive is only expected between chunks.
+    uint64_t index_size;
+    const StatusWithSize result = varint::Read(input_, &index_size);
+    if (result.IsOutOfRange()) {
+      return Status::OutOfRange();
+    }
+    if (!result.ok() || index_size > kMaxIndexSizeBytes) {
+      return Status::DataLoss();
+    }
+
+    index_.resize(index_size);
+    if (!ReadExact(index_).ok()) {
+      return Status::DataLoss();
+    }
+    uint32_t entry_count;
+    uint32_t data_size;
+    const Result<bool> may_match =
+        DecodeIndex(index_, entry_count, data_size);
+    if (!may_match.ok()) {
+      return Status::DataLoss();
+    }
+
+    if (!*may_match) {
+      if (!input_.Seek(data_size, stream::Stream::kCurrent).ok()) {
+        return Status::DataLoss();
+      }
+      stats_.chunks_skipped += 1;
+      continue;
+    }
+
+    data_.resize(data_size);
+    if (!ReadExact(data_).ok()) {
+      return Status::DataLoss();
+    }
+    stats_.chunks_read += 1;
+    if (!DecodeData(data_, entry_count).ok()) {
+      return Status::DataLoss();
+    }
+    return OkStatus();
+  }
+}
+
+Result<bool> LogArchiveReader::DecodeIndex(ConstByteSpan index,
+                                           uint32_t& entry_count,
+                                           uint32_t& data_size) {
+  int64_t max_timestamp = 0;
+  ConstByteSpan modules;
+  ConstByteSpan token_filter;
+  entry_count = 0;
+  data_size = 0;
+  min_timestamp_ = 0;
+
+  protobuf::Decoder decoder(index);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (static_cast<IndexField>(decoder.FieldNumber())) {
+      case IndexField::kEntryCount:
+        PW_TRY(decoder.ReadUint32(&entry_count));
+        break;
+      case IndexField::kMinTimestamp:
+        PW_TRY(decoder.ReadSint64(&min_timestamp_));
+        break;
+      case IndexField::kMaxTimestamp:
+        PW_TRY(decoder.ReadSint64(&max_timestamp));
+        break;
+      case IndexField::kModules:
+        PW_TRY(decoder.ReadBytes(&modules));
+        break;
+      case IndexField::kTokenFilter:
+        PW_TRY(decoder.ReadBytes(&token_filter));
+        break;
+      case IndexField::kDataSizeBytes:
+        PW_TRY(decoder.ReadUint32(&data_size));
+        break;
+    }
+  }
+  if (status != Status::OutOfRange() || data_size > kMaxDataSizeBytes ||
+      (!token_filter.empty() && !IsPowerOf2(token_filter.size()))) {
+    return Status::DataLoss();
+  }
+  PW_TRY(DecodePackedFixed32(modules, module_dictionary_));
+
+  if (max_timestamp < query_.min_timestamp ||
+      min_timestamp_ > query_.max_timestamp) {
+    return false;
+  }
+  if (query_.module.has_value() &&
+      std::find(module_dictionary_.begin(),
+                module_dictionary_.end(),
+                *query_.module) == module_dictionary_.end()) {
+    return false;
+  }
+  if (query_.token.has_value() &&
+      !FilterMayContain(token_filter, *query_.token)) {
+    return false;
+  }
+  return true;
+}
+
+Status LogArchiveReader::DecodeData(ConstByteSpan data, uint32_t entry_count) {
+  ConstByteSpan timestamps;
+  ConstByteSpan token_dictionary;
+  ConstByteSpan token_indices;
+  ConstByteSpan levels;
+  ConstByteSpan module_indices;
+  ConstByteSpan arg_sizes;
+  ConstByteSpan args;
+
+  protobuf::Decoder decoder(data);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (static_cast<DataField>(decoder.FieldNumber())) {
+      case DataField::kTimestamps:
+        PW_TRY(decoder.ReadBytes(&timestamps));
+        break;
+      case DataField::kTokens:
+        PW_TRY(decoder.ReadBytes(&token_dictionary));
+        break;
+      case DataField::kTokenIndices:
+        PW_TRY(decoder.ReadBytes(&token_indices));
+        break;
+      case DataField::kLevels:
+        PW_TRY(decoder.ReadBytes(&levels));
+        break;
+      case DataField::kModuleIndices:
+        PW_TRY(decoder.ReadBytes(&module_indices));
+        break;
+      case DataField::kArgSizes:
+        PW_TRY(decoder.ReadBytes(&arg_sizes));
+        break;
+      case DataField::kArgs:
+        PW_TRY(decoder.ReadBytes(&args));
+        break;
+    }
+  }
+  if (status != Status::OutOfRange()) {
+    return Status::DataLoss();
+  }
+
+  VarintColumn timestamp_column(timestamps);
+  timestamps_.clear();
+  uint64_t timestamp = static_cast<uint64_t>(min_timestamp_);
+  for (uint32_t i = 0; i < entry_count; ++i) {
+    uint64_t delta;
+    if (!timestamp_column.Read(delta)) {
+      return Status::DataLoss();
+    }
+    timestamp += static_cast<uint64_t>(varint::ZigZagDecode(delta));
+    timestamps_.push_back(static_cast<int64_t>(timestamp));
+  }
+
+  std::vector<uint32_t> dictionary;
+  PW_TRY(DecodePackedFixed32(token_dictionary, dictionary));
+  PW_TRY(DecodeIndices(token_indices, dictionary, entry_count, tokens_));
+  PW_TRY(DecodeIndices(
+      module_indices, module_dictionary_, entry_count, modules_));
+
+  VarintColumn level_column(levels);
+  levels_.clear();
+  while (!level_column.empty()) {
+    uint64_t level;
+    uint64_t run;
+    if (!level_column.Read(level) || !level_column.Read(run) ||
+        run > entry_count - levels_.size()) {
+      return Status::DataLoss();
+    }
+    levels_.insert(levels_.end(), run, static_cast<uint8_t>(level));
+  }
+
+  VarintColumn arg_size_column(arg_sizes);
+  args_.clear();
+  for (uint32_t i = 0; i < entry_count; ++i) {
+    uint64_t size;
+    if (!arg_size_column.Read(size) || size > args.size()) {
+      return Status::DataLoss();
+    }
+    args_.push_back(args.first(size));
+    args = args.subspan(size);
+  }
+
+  if (!timestamp_column.empty() || levels_.size() != entry_count ||
+      !arg_size_column.empty() || !args.empty()) {
+    return Status::DataLoss();
+  }
+  entry_count_ = entry_count;
+  return OkStatus();
+}
+
+bool LogArchiveReader::Matches(size_t entry) const {
+  return timestamps_[entry] >= query_.min_timestamp &&
+         timestamps_[entry] <= query_.max_timestamp &&
+         (!query_.module.has_value() || modules_[entry] == *query_.module) &&
+         (!query_.token.has_value() || tokens_[entry] == *query_.token);
+}
+
+Status LogArchiveReader::ReadExact(ByteSpan buffer) {
+  while (!buffer.empty()) {
+    PW_TRY_ASSIGN(const ByteSpan read, input_.Read(buffer));
+    if (read.empty()) {
+      return Status::DataLoss();
+    }
+    buffer = buffer.subspan(read.size());
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::log_rpc
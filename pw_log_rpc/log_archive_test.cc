@@ -0,0 +1,186 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/log_archive.h"
+
+#include <array>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::log_rpc {
+namespace {
+
+constexpr size_t kEntriesPerChunk = 4;
+constexpr size_t kEntries = 10;
+
+constexpr uint32_t kModuleA = 0xaaaa0000;
+constexpr uint32_t kModuleB = 0xbbbb0000;
+
+// The arguments of each entry are its index.
+constexpr std::array<std::byte, kEntries> kArgs =
+    bytes::Array<0, 1, 2, 3, 4, 5, 6, 7, 8, 9>();
+
+// Entries 0-3 are in module A, and the rest in module B. Each entry has its
+// own token, except the last two.
+LogArchiveEntry MakeEntry(size_t i) {
+  LogArchiveEntry entry;
+  entry.timestamp = 1000 + 10 * static_cast<int64_t>(i);
+  entry.token = i < 8u ? 0x10000 + static_cast<uint32_t>(i) : 0x20000;
+  entry.level = i % 3 == 0u ? 1 : 3;
+  entry.module = i < 4u ? kModuleA : kModuleB;
+  entry.args = span(kArgs).subspan(i, 1);
+  return entry;
+}
+
+class LogArchiveTest : public ::testing::Test {
+ protected:
+  void WriteEntries() {
+    LogArchiveWriter writer(output_, kEntriesPerChunk);
+    for (size_t i = 0; i < kEntries; ++i) {
+      ASSERT_EQ(writer.Append(MakeEntry(i)), OkStatus());
+    }
+    ASSERT_EQ(writer.Flush(), OkStatus());
+    EXPECT_EQ(writer.chunks_written(), 3u);
+  }
+
+  // Reads the matching entries and returns their indices.
+  std::vector<size_t> Query(const LogArchiveQuery& query,
+                            LogArchiveReader::Stats* stats = nullptr) {
+    stream::MemoryReader input(output_.WrittenData());
+    LogArchiveReader reader(input, query);
+
+    std::vector<size_t> indices;
+    Result<LogArchiveEntry> entry;
+    while ((entry = reader.Next()).ok()) {
+      EXPECT_EQ(entry->args.size(), 1u);
+      indices.push_back(static_cast<size_t>(entry->args[0]));
+    }
+    EXPECT_EQ(entry.status(), Status::OutOfRange());
+    if (stats != nullptr) {
+      *stats = reader.stats();
+    }
+    return indices;
+  }
+
+  stream::MemoryWriterBuffer<1024> output_;
+};
+
+TEST_F(LogArchiveTest, ReadsAllEntries) {
+  WriteEntries();
+
+  stream::MemoryReader input(output_.WrittenData());
+  LogArchiveReader reader(input);
+  for (size_t i = 0; i < kEntries; ++i) {
+    Result<LogArchiveEntry> entry = reader.Next();
+    ASSERT_EQ(entry.status(), OkStatus());
+    const LogArchiveEntry expected = MakeEntry(i);
+    EXPECT_EQ(entry->timestamp, expected.timestamp);
+    EXPECT_EQ(entry->token, expected.token);
+    EXPECT_EQ(entry->level, expected.level);
+    EXPECT_EQ(entry->module, expected.module);
+    ASSERT_EQ(entry->args.size(), 1u);
+    EXPECT_EQ(entry->args[0], expected.args[0]);
+  }
+  EXPECT_EQ(reader.Next().status(), Status::OutOfRange());
+  EXPECT_EQ(reader.stats().chunks_read, 3u);
+  EXPECT_EQ(reader.stats().chunks_skipped, 0u);
+}
+
+TEST(LogArchiveWriter, ColumnsAreSmallerThanEntries) {
+  constexpr size_t kLogs = 1000;
+  constexpr auto kTwoArgs = bytes::Array<0x54, 0x02>();
+  stream::MemoryWriterBuffer<16 * kLogs> output;
+  LogArchiveWriter writer(output);
+  for (size_t i = 0; i < kLogs; ++i) {
+    LogArchiveEntry entry;
+    entry.timestamp = 1'000'000 + 1000 * static_cast<int64_t>(i);
+    entry.token = 0x10000 + static_cast<uint32_t>(i % 8);
+    entry.level = 2;
+    entry.module = kModuleA;
+    entry.args = kTwoArgs;
+    ASSERT_EQ(writer.Append(entry), OkStatus());
+  }
+  ASSERT_EQ(writer.Flush(), OkStatus());
+
+  // Each entry would take at least 19 bytes on its own.
+  EXPECT_LT(output.bytes_written(), 8 * kLogs);
+}
+
+TEST_F(LogArchiveTest, TimeRangeSkipsChunks) {
+  WriteEntries();
+
+  LogArchiveQuery query;
+  query.min_timestamp = 1050;
+  query.max_timestamp = 1070;
+  LogArchiveReader::Stats stats;
+  EXPECT_EQ(Query(query, &stats), (std::vector<size_t>{5, 6, 7}));
+  EXPECT_EQ(stats.chunks_read, 1u);
+  EXPECT_EQ(stats.chunks_skipped, 2u);
+}
+
+TEST_F(LogArchiveTest, ModuleSkipsChunks) {
+  WriteEntries();
+
+  LogArchiveQuery query;
+  query.module = kModuleA;
+  LogArchiveReader::Stats stats;
+  EXPECT_EQ(Query(query, &stats), (std::vector<size_t>{0, 1, 2, 3}));
+  EXPECT_EQ(stats.chunks_read, 1u);
+  EXPECT_EQ(stats.chunks_skipped, 2u);
+
+  query.module = 0x12345678;
+  EXPECT_TRUE(Query(query, &stats).empty());
+  EXPECT_EQ(stats.chunks_read, 0u);
+}
+
+TEST_F(LogArchiveTest, TokenSkipsChunks) {
+  WriteEntries();
+
+  LogArchiveQuery query;
+  query.token = 0x20000;
+  LogArchiveReader::Stats stats;
+  EXPECT_EQ(Query(query, &stats), (std::vector<size_t>{8, 9}));
+  EXPECT_EQ(stats.chunks_read, 1u);
+  EXPECT_EQ(stats.chunks_skipped, 2u);
+
+  query.token = 0x10005;
+  query.module = kModuleB;
+  EXPECT_EQ(Query(query), (std::vector<size_t>{5}));
+}
+
+TEST_F(LogArchiveTest, EmptyArchive) {
+  LogArchiveWriter writer(output_);
+  ASSERT_EQ(writer.Flush(), OkStatus());
+  EXPECT_EQ(output_.bytes_written(), LogArchive::kFileHeaderSizeBytes);
+  EXPECT_TRUE(Query({}).empty());
+}
+
+TEST_F(LogArchiveTest, InvalidArchives) {
+  WriteEntries();
+
+  constexpr auto kNotAnArchive = bytes::Array<1, 2, 3, 4, 5, 6, 7, 8>();
+  stream::MemoryReader not_an_archive(kNotAnArchive);
+  EXPECT_EQ(LogArchiveReader(not_an_archive).Next().status(),
+            Status::DataLoss());
+
+  // Cut the archive off in the middle of the first chunk.
+  stream::MemoryReader truncated(output_.WrittenData().first(20));
+  EXPECT_EQ(LogArchiveReader(truncated).Next().status(), Status::DataLoss());
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
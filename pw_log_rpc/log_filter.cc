@@ -14,6 +14,8 @@
 
 #include "pw_log_rpc/log_filter.h"
 
+#include <algorithm>
+
 #include "pw_log/levels.h"
 #include "pw_protobuf/decoder.h"
 #include "pw_status/try.h"
@@ -24,36 +26,124 @@ namespace {
 namespace FilterRule = ::pw::log::pwpb::FilterRule;
 namespace LogEntry = ::pw::log::pwpb::LogEntry;
 
-// Returns true if the provided log parameters match the given filter rule.
-bool IsRuleMet(const Filter::Rule& rule,
-               uint32_t level,
-               ConstByteSpan module,
-               uint32_t flags,
-               ConstByteSpan thread) {
-  if (level < static_cast<uint32_t>(rule.level_greater_than_or_equal)) {
-    return false;
+// Decodes the LogEntry fields that filter rules check as they are requested.
+// Entries are normally encoded in field number order, so a field is found
+// without decoding the fields after it.
+class LazyLogEntry {
+ public:
+  explicit LazyLogEntry(ConstByteSpan entry) : decoder_(entry) {}
+
+  uint32_t level() {
+    DecodeUntil(has_level_);
+    return level_;
   }
-  if ((rule.any_flags_set != 0) && ((flags & rule.any_flags_set) == 0)) {
-    return false;
+
+  uint32_t flags() {
+    DecodeUntil(has_flags_);
+    return flags_;
   }
-  if (!rule.module_equals.empty() && !std::equal(module.begin(),
-                                                 module.end(),
-                                                 rule.module_equals.begin(),
-                                                 rule.module_equals.end())) {
-    return false;
+
+  ConstByteSpan module() {
+    DecodeUntil(has_module_);
+    return module_;
+  }
+
+  ConstByteSpan thread() {
+    DecodeUntil(has_thread_);
+    return thread_;
   }
-  if (!rule.thread_equals.empty() && !std::equal(thread.begin(),
-                                                 thread.end(),
-                                                 rule.thread_equals.begin(),
-                                                 rule.thread_equals.end())) {
+
+ private:
+  // Decodes fields until the given field is found, or the entry ends.
+  void DecodeUntil(const bool& found) {
+    while (!found && !done_) {
+      DecodeNextField();
+    }
+  }
+
+  void DecodeNextField() {
+    if (!decoder_.Next().ok()) {
+      done_ = true;
+      return;
+    }
+    switch (static_cast<LogEntry::Fields>(decoder_.FieldNumber())) {
+      case LogEntry::Fields::kLineLevel:
+        if (decoder_.ReadUint32(&level_).ok()) {
+          level_ &= PW_LOG_LEVEL_BITMASK;
+        }
+        has_level_ = true;
+        break;
+      case LogEntry::Fields::kFlags:
+        decoder_.ReadUint32(&flags_).IgnoreError();
+        has_flags_ = true;
+        break;
+      case LogEntry::Fields::kModule:
+        decoder_.ReadBytes(&module_).IgnoreError();
+        has_module_ = true;
+        break;
+      case LogEntry::Fields::kThread:
+        decoder_.ReadBytes(&thread_).IgnoreError();
+        has_thread_ = true;
+        break;
+      default:
+        break;
+    }
+  }
+
+  protobuf::Decoder decoder_;
+  bool done_ = false;
+  bool has_level_ = false;
+  bool has_flags_ = false;
+  bool has_module_ = false;
+  bool has_thread_ = false;
+  uint32_t level_ = 0;
+  uint32_t flags_ = 0;
+  ConstByteSpan module_;
+  ConstByteSpan thread_;
+};
+
+// Returns true if the rule only depends on the log level.
+bool OnlyChecksLevel(const Filter::Rule& rule) {
+  return rule.any_flags_set == 0 && rule.module_equals.empty() &&
+         rule.thread_equals.empty();
+}
+
+// Returns true if the log meets the rule's conditions besides the level.
+bool IsRuleMet(const Filter::Rule& rule, LazyLogEntry& log) {
+  if ((rule.any_flags_set != 0) && ((log.flags() & rule.any_flags_set) == 0)) {
     return false;
   }
+  if (!rule.module_equals.empty()) {
+    const ConstByteSpan module = log.module();
+    if (!std::equal(module.begin(),
+                    module.end(),
+                    rule.module_equals.begin(),
+                    rule.module_equals.end())) {
+      return false;
+    }
+  }
+  if (!rule.thread_equals.empty()) {
+    const ConstByteSpan thread = log.thread();
+    if (!std::equal(thread.begin(),
+                    thread.end(),
+                    rule.thread_equals.begin(),
+                    rule.thread_equals.end())) {
+      return false;
+    }
+  }
   return true;
 }
 
 }  // namespace
 
 Status Filter::UpdateRulesFromProto(ConstByteSpan buffer) {
+  const Status status = DecodeRulesFromProto(buffer);
+  // Rules may have been partially updated on failure, so always recompile.
+  CompileRules();
+  return status;
+}
+
+Status Filter::DecodeRulesFromProto(ConstByteSpan buffer) {
   if (rules_.empty()) {
     return Status::FailedPrecondition();
   }
@@ -105,41 +195,62 @@ Status Filter::UpdateRulesFromProto(ConstByteSpan buffer) {
   return status.IsOutOfRange() ? OkStatus() : status;
 }
 
-bool Filter::ShouldDropLog(ConstByteSpan entry) const {
-  if (rules_.empty()) {
-    return false;
+void Filter::CompileRules() {
+  active_rules_end_ = 0;
+  checks_level_ = false;
+  for (size_t i = 0; i < rules_.size(); ++i) {
+    if (rules_[i].action == Filter::Rule::Action::kInactive) {
+      continue;
+    }
+    active_rules_end_ = i + 1;
+    if (rules_[i].level_greater_than_or_equal !=
+        FilterRule::Level::ANY_LEVEL) {
+      checks_level_ = true;
+    }
   }
 
-  uint32_t log_level = 0;
-  ConstByteSpan log_module;
-  ConstByteSpan log_thread;
-  uint32_t log_flags = 0;
-  protobuf::Decoder decoder(entry);
-  while (decoder.Next().ok()) {
-    const auto field_num = static_cast<LogEntry::Fields>(decoder.FieldNumber());
-
-    if (field_num == LogEntry::Fields::kLineLevel) {
-      if (decoder.ReadUint32(&log_level).ok()) {
-        log_level &= PW_LOG_LEVEL_BITMASK;
+  // Find the first rule that logs of each level can meet. If that rule only
+  // checks the level, it decides the outcome for every log of that level.
+  for (size_t level = 0; level < kLogLevels; ++level) {
+    LevelDecision& decision = level_decisions_[level];
+    decision = {};
+    for (size_t i = 0; i < active_rules_end_; ++i) {
+      const Filter::Rule& rule = rules_[i];
+      if (rule.action == Filter::Rule::Action::kInactive ||
+          level < static_cast<uint32_t>(rule.level_greater_than_or_equal)) {
+        continue;
       }
+      decision.first_rule = i;
+      if (!OnlyChecksLevel(rule)) {
+        decision.kind = LevelDecision::Kind::kEvaluateRules;
+      } else if (rule.action == Filter::Rule::Action::kDrop) {
+        decision.kind = LevelDecision::Kind::kDrop;
+      }
+      break;
+    }
+  }
+}
 
-    } else if (field_num == LogEntry::Fields::kModule) {
-      decoder.ReadBytes(&log_module).IgnoreError();
-
-    } else if (field_num == LogEntry::Fields::kFlags) {
-      decoder.ReadUint32(&log_flags).IgnoreError();
+bool Filter::ShouldDropLog(ConstByteSpan entry) const {
+  if (active_rules_end_ == 0) {
+    return false;
+  }
 
-    } else if (field_num == LogEntry::Fields::kThread) {
-      decoder.ReadBytes(&log_thread).IgnoreError();
-    }
+  LazyLogEntry log(entry);
+  const uint32_t log_level = checks_level_ ? log.level() : 0;
+  const LevelDecision& decision = level_decisions_[log_level];
+  if (decision.kind != LevelDecision::Kind::kEvaluateRules) {
+    return decision.kind == LevelDecision::Kind::kDrop;
   }
 
   // Follow the action of the first rule whose condition is met.
-  for (const auto& rule : rules_) {
-    if (rule.action == Filter::Rule::Action::kInactive) {
+  for (size_t i = decision.first_rule; i < active_rules_end_; ++i) {
+    const Filter::Rule& rule = rules_[i];
+    if (rule.action == Filter::Rule::Action::kInactive ||
+        log_level < static_cast<uint32_t>(rule.level_greater_than_or_equal)) {
       continue;
     }
-    if (IsRuleMet(rule, log_level, log_module, log_flags, log_thread)) {
+    if (IsRuleMet(rule, log)) {
       return rule.action == Filter::Rule::Action::kDrop;
     }
   }
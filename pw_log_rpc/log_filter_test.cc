@@ -384,6 +384,79 @@ TEST(FilterTest, FilterLogsRuleDefaultDrop) {
   EXPECT_TRUE(filter.ShouldDropLog(log_entry_same_thread.value()));
 }
 
+TEST(FilterTest, FilterLogsByLevelOnly) {
+  const std::array<Filter::Rule, 3> rules{{
+      {
+          .action = Filter::Rule::Action::kInactive,
+          .level_greater_than_or_equal = FilterRule::Level::ANY_LEVEL,
+      },
+      {
+          .action = Filter::Rule::Action::kKeep,
+          .level_greater_than_or_equal = FilterRule::Level::WARN_LEVEL,
+      },
+      {
+          .action = Filter::Rule::Action::kDrop,
+          .level_greater_than_or_equal = FilterRule::Level::DEBUG_LEVEL,
+          .any_flags_set = kSampleFlags,
+      },
+  }};
+  const std::array<std::byte, cfg::kMaxFilterIdBytes> filter_id{
+      std::byte(0xfe), std::byte(0xed), std::byte(0xba), std::byte(0xb1)};
+  const Filter filter(filter_id,
+                      const_cast<std::array<Filter::Rule, 3>&>(rules));
+
+  std::array<std::byte, 50> buffer;
+  const Result<ConstByteSpan> log_entry_warn =
+      EncodeLogEntry<PW_LOG_LEVEL_WARN, kSampleModule, kSampleFlags>(
+          kSampleMessage, buffer, kSampleThread);
+  ASSERT_EQ(log_entry_warn.status(), OkStatus());
+  EXPECT_FALSE(filter.ShouldDropLog(log_entry_warn.value()));
+
+  buffer.fill(std::byte(0));
+  const Result<ConstByteSpan> log_entry_info_flags =
+      EncodeLogEntry<PW_LOG_LEVEL_INFO, kSampleModule, kSampleFlags>(
+          kSampleMessage, buffer, kSampleThread);
+  ASSERT_EQ(log_entry_info_flags.status(), OkStatus());
+  EXPECT_TRUE(filter.ShouldDropLog(log_entry_info_flags.value()));
+
+  buffer.fill(std::byte(0));
+  const Result<ConstByteSpan> log_entry_info =
+      EncodeLogEntry<PW_LOG_LEVEL_INFO, kSampleModule, 0>(
+          kSampleMessage, buffer, kSampleThread);
+  ASSERT_EQ(log_entry_info.status(), OkStatus());
+  EXPECT_FALSE(filter.ShouldDropLog(log_entry_info.value()));
+}
+
+TEST(FilterTest, UpdateRulesChangesFiltering) {
+  std::array<Filter::Rule, 1> rules{};
+  const std::array<std::byte, cfg::kMaxFilterIdBytes> filter_id{
+      std::byte(0xfe), std::byte(0xed), std::byte(0xba), std::byte(0xb1)};
+  Filter filter(filter_id, rules);
+
+  std::array<std::byte, 50> buffer;
+  const Result<ConstByteSpan> log_entry_debug =
+      EncodeLogEntry<PW_LOG_LEVEL_DEBUG, kSampleModule, kSampleFlags>(
+          kSampleMessage, buffer, kSampleThread);
+  ASSERT_EQ(log_entry_debug.status(), OkStatus());
+  EXPECT_FALSE(filter.ShouldDropLog(log_entry_debug.value()));
+
+  std::array<Filter::Rule, 1> drop_rules{{
+      {
+          .action = Filter::Rule::Action::kDrop,
+          .level_greater_than_or_equal = FilterRule::Level::ANY_LEVEL,
+          .module_equals{kSampleModuleLittleEndian.begin(),
+                         kSampleModuleLittleEndian.end()},
+      },
+  }};
+  const Filter drop_filter(filter_id, drop_rules);
+  std::byte filter_buffer[256];
+  const Result<ConstByteSpan> encoded_filter =
+      EncodeFilter(drop_filter, filter_buffer);
+  ASSERT_EQ(encoded_filter.status(), OkStatus());
+  ASSERT_EQ(filter.UpdateRulesFromProto(encoded_filter.value()), OkStatus());
+  EXPECT_TRUE(filter.ShouldDropLog(log_entry_debug.value()));
+}
+
 TEST(FilterTest, FilterLogsKeepLogsWhenNoRuleMatches) {
   // There is no rule that catches all logs.
   const std::array<Filter::Rule, 1> rules{{
@@ -0,0 +1,180 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Decodes the log streams of several devices in parallel into shared-memory
+// log rings, which log viewers map and read with pw::log_rpc::LogRingReader.
+//
+//   log_ingest [--database TOKENS.bin] [--ring-size BYTES] DEVICE:RING...
+//
+// Each DEVICE is a file to read the device's HDLC stream from, such as a
+// configured serial port or a FIFO. Its logs are written to the file RING,
+// which is created or truncated. The database is a binary token database, as
+// created by pw_tokenizer's database.py. Each device is read on its own
+// thread until the end of its stream.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pw_log_rpc/log_ingester.h"
+#include "pw_log_rpc/log_ring.h"
+#include "pw_stream/mapped_file_stream.h"
+#include "pw_tokenizer/detokenize.h"
+#include "pw_tokenizer/token_database.h"
+
+namespace pw::log_rpc {
+namespace {
+
+constexpr size_t kDefaultRingSizeBytes = 64 << 20;
+constexpr size_t kFrameBufferSizeBytes = 4096;
+constexpr size_t kReadSizeBytes = 64 << 10;
+
+struct Device {
+  std::string input_path;
+  std::string ring_path;
+};
+
+void Usage(const char* program) {
+  std::fprintf(stderr,
+               "Usage: %s [--database TOKENS.bin] [--ring-size BYTES] "
+               "DEVICE:RING...\n",
+               program);
+}
+
+void IngestDevice(const Device& device,
+                  size_t ring_size_bytes,
+                  const tokenizer::Detokenizer* detokenizer) {
+  const int fd = open(device.input_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    std::fprintf(stderr,
+                 "Failed to open %s: %s\n",
+                 device.input_path.c_str(),
+                 std::strerror(errno));
+    return;
+  }
+
+  MappedLogRing ring;
+  if (const Status status =
+          ring.Create(device.ring_path.c_str(), ring_size_bytes);
+      !status.ok()) {
+    std::fprintf(stderr,
+                 "Failed to create %s: %s\n",
+                 device.ring_path.c_str(),
+                 status.str());
+    close(fd);
+    return;
+  }
+
+  LogRingWriter writer(ring.memory());
+  std::array<std::byte, kFrameBufferSizeBytes> frame_buffer;
+  LogIngester ingester(writer, detokenizer, frame_buffer);
+
+  std::vector<std::byte> data(kReadSizeBytes);
+  while (true) {
+    const ssize_t result = read(fd, data.data(), data.size());
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      break;
+    }
+    ingester.Process(ConstByteSpan(data.data(), static_cast<size_t>(result)));
+  }
+  close(fd);
+
+  const LogIngester::Stats& stats = ingester.stats();
+  std::fprintf(stderr,
+               "%s: %zu records (%zu too large), %zu logs dropped, "
+               "%zu log packets (%zu invalid), %zu frame errors\n",
+               device.input_path.c_str(),
+               stats.records,
+               stats.records_dropped,
+               stats.logs_dropped,
+               stats.log_packets,
+               stats.decode_errors,
+               stats.frame_errors);
+}
+
+int Main(int argc, char** argv) {
+  const char* database_path = nullptr;
+  size_t ring_size_bytes = kDefaultRingSizeBytes;
+  std::vector<Device> devices;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--database" && i + 1 < argc) {
+      database_path = argv[++i];
+    } else if (arg == "--ring-size" && i + 1 < argc) {
+      ring_size_bytes = std::strtoull(argv[++i], nullptr, 0);
+    } else if (const size_t colon = arg.rfind(':');
+               colon != std::string::npos && colon != 0u &&
+               colon + 1 != arg.size()) {
+      devices.push_back({arg.substr(0, colon), arg.substr(colon + 1)});
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+  if (devices.empty() || ring_size_bytes < LogRing::kMinSizeBytes) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  // The database is referenced in place, so keep it mapped while ingesting.
+  stream::MappedFileReader database_file;
+  std::optional<tokenizer::Detokenizer> detokenizer;
+  if (database_path != nullptr) {
+    if (const Status status = database_file.Open(database_path);
+        !status.ok()) {
+      std::fprintf(
+          stderr, "Failed to open %s: %s\n", database_path, status.str());
+      return 1;
+    }
+    const ConstByteSpan bytes = database_file.mapped_data();
+    const tokenizer::TokenDatabase database = tokenizer::TokenDatabase::Create(
+        span(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+    if (!database.ok()) {
+      std::fprintf(stderr, "%s is not a token database\n", database_path);
+      return 1;
+    }
+    detokenizer.emplace(tokenizer::Detokenizer::InPlace(database));
+  }
+
+  const tokenizer::Detokenizer* shared_detokenizer =
+      detokenizer.has_value() ? &*detokenizer : nullptr;
+  std::vector<std::thread> threads;
+  for (const Device& device : devices) {
+    threads.emplace_back(
+        IngestDevice, std::cref(device), ring_size_bytes, shared_detokenizer);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
+
+int main(int argc, char** argv) { return pw::log_rpc::Main(argc, argv); }
@@ -0,0 +1,234 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/log_ingester.h"
+
+#include <algorithm>
+#include <string_view>
+
+#include "pw_log/proto/log.pwpb.h"
+#include "pw_log/proto/log.raw_rpc.pb.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_rpc/method_info.h"
+#include "pw_rpc/packet_meta.h"
+#include "pw_status/try.h"
+#include "pw_tokenizer/base64.h"
+
+namespace pw::log_rpc {
+namespace {
+
+namespace LogEntries = ::pw::log::pwpb::LogEntries;
+namespace LogEntry = ::pw::log::pwpb::LogEntry;
+
+constexpr auto kListen = log::pw_rpc::raw::Logs::Listen;
+
+std::string_view AsString(ConstByteSpan data) {
+  return std::string_view(reinterpret_cast<const char*>(data.data()),
+                          data.size());
+}
+
+// Matches the Python tools, which treat fields with only printable characters
+// and whitespace as plain text. Bytes outside ASCII are assumed to be UTF-8.
+bool IsText(std::string_view data) {
+  return std::all_of(data.begin(), data.end(), [](char c) {
+    const auto byte = static_cast<unsigned char>(c);
+    return (byte >= 0x20u && byte != 0x7fu) || (byte >= '\t' && byte <= '\r');
+  });
+}
+
+}  // namespace
+
+void LogIngester::Process(ConstByteSpan data) {
+  decoder_.Process(data, &LogIngester::ProcessFrame, this);
+}
+
+void LogIngester::ProcessFrame(const Result<hdlc::Frame>& frame) {
+  if (!frame.ok()) {
+    stats_.frame_errors += 1;
+    return;
+  }
+  if (frame->address() != rpc_address_) {
+    return;
+  }
+  stats_.frames += 1;
+
+  // Only responses sent to the client carry log entries.
+  const Result<rpc::PacketMeta> packet =
+      rpc::PacketMeta::FromBuffer(frame->data());
+  if (!packet.ok() ||
+      packet->service_id() != rpc::GetServiceIdForMethod<kListen>() ||
+      packet->method_id() != rpc::GetMethodId<kListen>() ||
+      !packet->destination_is_client() || packet->type_is_server_error()) {
+    return;
+  }
+
+  stats_.log_packets += 1;
+  if (!ProcessLogEntries(packet->payload()).ok()) {
+    stats_.decode_errors += 1;
+  }
+}
+
+Status LogIngester::ProcessLogEntries(ConstByteSpan log_entries) {
+  // The sequence ID may follow the entries, so find it first to report logs
+  // lost in transit before the entries that follow them.
+  uint32_t first_sequence_id = 0;
+  bool has_sequence_id = false;
+
+  protobuf::Decoder decoder(log_entries);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    if (static_cast<LogEntries::Fields>(decoder.FieldNumber()) ==
+        LogEntries::Fields::kFirstEntrySequenceId) {
+      PW_TRY(decoder.ReadUint32(&first_sequence_id));
+      has_sequence_id = true;
+    }
+  }
+  if (status != Status::OutOfRange()) {
+    return Status::DataLoss();
+  }
+
+  if (has_sequence_id) {
+    if (sequence_id_known_ && first_sequence_id != next_sequence_id_) {
+      WriteDropRecord(first_sequence_id - next_sequence_id_,
+                      "transmission error");
+    }
+    sequence_id_known_ = true;
+    next_sequence_id_ = first_sequence_id;
+  }
+
+  decoder.Reset(log_entries);
+  while (decoder.Next().ok()) {
+    if (static_cast<LogEntries::Fields>(decoder.FieldNumber()) !=
+        LogEntries::Fields::kEntries) {
+      continue;
+    }
+    ConstByteSpan log_entry;
+    PW_TRY(decoder.ReadBytes(&log_entry));
+    PW_TRY(ProcessLogEntry(log_entry));
+  }
+  return OkStatus();
+}
+
+Status LogIngester::ProcessLogEntry(ConstByteSpan log_entry) {
+  LogRecord record;
+  record.timestamp = last_timestamp_;
+  message_.clear();
+  module_.clear();
+  file_.clear();
+  thread_.clear();
+
+  protobuf::Decoder decoder(log_entry);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    ConstByteSpan bytes;
+    switch (static_cast<LogEntry::Fields>(decoder.FieldNumber())) {
+      case LogEntry::Fields::kMessage:
+        PW_TRY(decoder.ReadBytes(&bytes));
+        DecodeField(bytes, message_);
+        break;
+      case LogEntry::Fields::kLineLevel:
+        PW_TRY(decoder.ReadUint32(&record.line_level));
+        break;
+      case LogEntry::Fields::kFlags:
+        PW_TRY(decoder.ReadUint32(&record.flags));
+        break;
+      case LogEntry::Fields::kTimestamp:
+        PW_TRY(decoder.ReadInt64(&record.timestamp));
+        break;
+      case LogEntry::Fields::kTimeSinceLastEntry: {
+        int64_t delta;
+        PW_TRY(decoder.ReadInt64(&delta));
+        record.timestamp = last_timestamp_ + delta;
+        break;
+      }
+      case LogEntry::Fields::kDropped:
+        PW_TRY(decoder.ReadUint32(&record.dropped));
+        break;
+      case LogEntry::Fields::kModule:
+        PW_TRY(decoder.ReadBytes(&bytes));
+        DecodeField(bytes, module_);
+        break;
+      case LogEntry::Fields::kFile:
+        PW_TRY(decoder.ReadBytes(&bytes));
+        DecodeField(bytes, file_);
+        break;
+      case LogEntry::Fields::kThread:
+        PW_TRY(decoder.ReadBytes(&bytes));
+        DecodeField(bytes, thread_);
+        break;
+    }
+  }
+  if (status != Status::OutOfRange()) {
+    return Status::DataLoss();
+  }
+
+  // Drop entries report logs that never got a sequence ID.
+  if (record.dropped == 0u) {
+    next_sequence_id_ += 1;
+  } else {
+    stats_.logs_dropped += record.dropped;
+  }
+
+  last_timestamp_ = record.timestamp;
+  record.message = message_;
+  record.module = module_;
+  record.file = file_;
+  record.thread = thread_;
+  WriteRecord(record);
+  return OkStatus();
+}
+
+void LogIngester::WriteDropRecord(uint32_t dropped, std::string_view reason) {
+  stats_.logs_dropped += dropped;
+  LogRecord record;
+  record.timestamp = last_timestamp_;
+  record.dropped = dropped;
+  record.message = reason;
+  WriteRecord(record);
+}
+
+void LogIngester::WriteRecord(const LogRecord& record) {
+  if (ring_.Write(record).ok()) {
+    stats_.records += 1;
+  } else {
+    stats_.records_dropped += 1;
+  }
+}
+
+void LogIngester::DecodeField(ConstByteSpan data, std::string& output) const {
+  if (data.empty()) {
+    output.clear();
+    return;
+  }
+
+  if (detokenizer_ != nullptr) {
+    const tokenizer::DetokenizedString result =
+        detokenizer_->Detokenize(data.data(), data.size());
+    if (result.ok()) {
+      output = result.BestString();
+      return;
+    }
+  }
+
+  if (IsText(AsString(data))) {
+    output.assign(AsString(data));
+    return;
+  }
+
+  // Assume this is tokenized data that could not be decoded.
+  output.resize(tokenizer::Base64EncodedBufferSize(data.size()));
+  output.resize(tokenizer::PrefixedBase64Encode(data, output));
+}
+
+}  // namespace pw::log_rpc
@@ -0,0 +1,333 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/log_ingester.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_log/proto/log.pwpb.h"
+#include "pw_log/proto/log.raw_rpc.pb.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_rpc/internal/packet.pwpb.h"
+#include "pw_rpc/method_info.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::log_rpc {
+namespace {
+
+namespace LogEntries = ::pw::log::pwpb::LogEntries;
+namespace LogEntry = ::pw::log::pwpb::LogEntry;
+namespace RpcPacket = ::pw::rpc::internal::pwpb::RpcPacket;
+using rpc::internal::pwpb::PacketType;
+using namespace std::literals::string_view_literals;
+
+constexpr auto kListen = log::pw_rpc::raw::Logs::Listen;
+constexpr uint32_t kLogsServiceId =
+    rpc::internal::UnwrapServiceId(rpc::GetServiceIdForMethod<kListen>());
+constexpr uint32_t kListenMethodId =
+    rpc::internal::UnwrapMethodId(rpc::GetMethodId<kListen>());
+constexpr uint32_t kOtherServiceId = 0x4f544852;
+
+// Use alignas to ensure that the data is properly aligned to be read from a
+// token database entry struct.
+alignas(tokenizer::TokenDatabase::RawEntry) constexpr char kDatabase[] =
+    "TOKENS\0\0"
+    "\x01\x00\x00\x00"
+    "\0\0\0\0"
+    "\x01\x00\x00\x00----"
+    "The answer is %d";
+
+constexpr auto kTokenizedMessage = bytes::Array<1, 0, 0, 0, 84>();  // 42
+constexpr auto kUnknownToken = bytes::Array<2, 0, 0, 0>();
+
+struct TestEntry {
+  TestEntry(std::string_view text = "") : message(text) {}
+
+  std::string_view message;
+  ConstByteSpan tokenized_message;
+  std::optional<int64_t> timestamp;
+  std::optional<int64_t> time_since_last_entry;
+  uint32_t line_level = 0;
+  uint32_t flags = 0;
+  uint32_t dropped = 0;
+  std::string_view module;
+  std::string_view file;
+  std::string_view thread;
+};
+
+class LogIngesterTest : public ::testing::Test {
+ protected:
+  LogIngesterTest()
+      : detokenizer_(tokenizer::TokenDatabase::Create<kDatabase>()),
+        writer_(ring_memory_),
+        ingester_(writer_, &detokenizer_, frame_buffer_),
+        reader_(*LogRingReader::Create(ring_memory_)) {}
+
+  // Encodes a LogEntries message.
+  ConstByteSpan EncodeEntries(std::initializer_list<TestEntry> entries,
+                              std::optional<uint32_t> first_sequence_id) {
+    protobuf::MemoryEncoder encoder(entries_buffer_);
+    for (const TestEntry& entry : entries) {
+      protobuf::StreamEncoder entry_encoder = encoder.GetNestedEncoder(
+          static_cast<uint32_t>(LogEntries::Fields::kEntries));
+      if (!entry.message.empty()) {
+        entry_encoder
+            .WriteString(static_cast<uint32_t>(LogEntry::Fields::kMessage),
+                         entry.message)
+            .IgnoreError();
+      }
+      if (!entry.tokenized_message.empty()) {
+        entry_encoder
+            .WriteBytes(static_cast<uint32_t>(LogEntry::Fields::kMessage),
+                        entry.tokenized_message)
+            .IgnoreError();
+      }
+      entry_encoder
+          .WriteUint32(static_cast<uint32_t>(LogEntry::Fields::kLineLevel),
+                       entry.line_level)
+          .IgnoreError();
+      entry_encoder
+          .WriteUint32(static_cast<uint32_t>(LogEntry::Fields::kFlags),
+                       entry.flags)
+          .IgnoreError();
+      if (entry.timestamp.has_value()) {
+        entry_encoder
+            .WriteInt64(static_cast<uint32_t>(LogEntry::Fields::kTimestamp),
+                        *entry.timestamp)
+            .IgnoreError();
+      }
+      if (entry.time_since_last_entry.has_value()) {
+        entry_encoder
+            .WriteInt64(
+                static_cast<uint32_t>(LogEntry::Fields::kTimeSinceLastEntry),
+                *entry.time_since_last_entry)
+            .IgnoreError();
+      }
+      if (entry.dropped != 0u) {
+        entry_encoder
+            .WriteUint32(static_cast<uint32_t>(LogEntry::Fields::kDropped),
+                         entry.dropped)
+            .IgnoreError();
+      }
+      entry_encoder
+          .WriteString(static_cast<uint32_t>(LogEntry::Fields::kModule),
+                       entry.module)
+          .IgnoreError();
+      entry_encoder
+          .WriteString(static_cast<uint32_t>(LogEntry::Fields::kFile),
+                       entry.file)
+          .IgnoreError();
+      entry_encoder
+          .WriteString(static_cast<uint32_t>(LogEntry::Fields::kThread),
+                       entry.thread)
+          .IgnoreError();
+    }
+    if (first_sequence_id.has_value()) {
+      encoder
+          .WriteUint32(
+              static_cast<uint32_t>(LogEntries::Fields::kFirstEntrySequenceId),
+              *first_sequence_id)
+          .IgnoreError();
+    }
+    EXPECT_EQ(encoder.status(), OkStatus());
+    return ConstByteSpan(encoder);
+  }
+
+  // Encodes a packet in an HDLC frame.
+  ConstByteSpan EncodeFrame(ConstByteSpan payload,
+                            uint32_t service_id = kLogsServiceId,
+                            uint64_t address = 'R') {
+    RpcPacket::MemoryEncoder packet(packet_buffer_);
+    packet.WriteType(PacketType::SERVER_STREAM).IgnoreError();
+    packet.WriteChannelId(1).IgnoreError();
+    packet.WriteServiceId(service_id).IgnoreError();
+    packet.WriteMethodId(kListenMethodId).IgnoreError();
+    packet.WriteCallId(1).IgnoreError();
+    packet.WritePayload(payload).IgnoreError();
+    EXPECT_EQ(packet.status(), OkStatus());
+    frame_.clear();
+    EXPECT_EQ(hdlc::WriteUIFrame(address, packet, frame_), OkStatus());
+    return frame_.WrittenData();
+  }
+
+  void Send(std::initializer_list<TestEntry> entries,
+            std::optional<uint32_t> first_sequence_id = std::nullopt) {
+    ingester_.Process(EncodeFrame(EncodeEntries(entries, first_sequence_id)));
+  }
+
+  Result<LogRecord> Next() { return reader_.Read(record_buffer_); }
+
+  tokenizer::Detokenizer detokenizer_;
+  alignas(LogRing::Header) std::array<std::byte, 4096> ring_memory_{};
+  LogRingWriter writer_;
+  std::array<std::byte, 512> frame_buffer_;
+  LogIngester ingester_;
+  LogRingReader reader_;
+
+  std::array<std::byte, 256> entries_buffer_;
+  std::array<std::byte, 512> packet_buffer_;
+  stream::MemoryWriterBuffer<1024> frame_;
+  std::array<std::byte, 256> record_buffer_;
+};
+
+TEST_F(LogIngesterTest, DecodesEntries) {
+  TestEntry tokenized;
+  tokenized.tokenized_message = kTokenizedMessage;
+  tokenized.timestamp = 100;
+  tokenized.line_level = (12 << 3) | 3;
+  tokenized.flags = 2;
+  tokenized.module = "net";
+  tokenized.file = "net.cc";
+  tokenized.thread = "main";
+  TestEntry text("plain text");
+  text.timestamp = 200;
+  text.line_level = 1;
+  Send({tokenized, text});
+
+  Result<LogRecord> record = Next();
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->message, "The answer is 42");
+  EXPECT_EQ(record->timestamp, 100);
+  EXPECT_EQ(record->line_level, (12u << 3) | 3u);
+  EXPECT_EQ(record->flags, 2u);
+  EXPECT_EQ(record->dropped, 0u);
+  EXPECT_EQ(record->module, "net");
+  EXPECT_EQ(record->file, "net.cc");
+  EXPECT_EQ(record->thread, "main");
+
+  record = Next();
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->message, "plain text");
+  EXPECT_EQ(record->timestamp, 200);
+  EXPECT_EQ(record->line_level, 1u);
+  EXPECT_TRUE(record->module.empty());
+
+  EXPECT_EQ(Next().status(), Status::Unavailable());
+  EXPECT_EQ(ingester_.stats().frames, 1u);
+  EXPECT_EQ(ingester_.stats().log_packets, 1u);
+  EXPECT_EQ(ingester_.stats().records, 2u);
+}
+
+TEST_F(LogIngesterTest, UnknownTokenIsBase64) {
+  TestEntry entry;
+  entry.tokenized_message = kUnknownToken;
+  Send({entry});
+
+  Result<LogRecord> record = Next();
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->message, "$AgAAAA==");
+}
+
+TEST_F(LogIngesterTest, TimeSinceLastEntry) {
+  TestEntry a("a"), b("b"), c("c"), d("d");
+  a.timestamp = 1000;
+  b.time_since_last_entry = 5;
+  c.time_since_last_entry = 7;
+  d.time_since_last_entry = 1;
+  Send({a, b, c});
+  Send({d});
+
+  for (int64_t timestamp : {1000, 1005, 1012, 1013}) {
+    Result<LogRecord> record = Next();
+    ASSERT_EQ(record.status(), OkStatus());
+    EXPECT_EQ(record->timestamp, timestamp);
+  }
+}
+
+TEST_F(LogIngesterTest, ReportsDroppedLogs) {
+  TestEntry drop("slow reader");
+  drop.dropped = 4;
+  Send({TestEntry("a"), TestEntry("b")}, 0);
+  Send({TestEntry("c")}, 5);
+  Send({drop, TestEntry("d")}, 6);
+
+  const std::array<std::pair<std::string_view, uint32_t>, 6> expected = {{
+      {"a", 0},
+      {"b", 0},
+      {"transmission error", 3},
+      {"c", 0},
+      {"slow reader", 4},
+      {"d", 0},
+  }};
+  for (const auto& [message, dropped] : expected) {
+    Result<LogRecord> record = Next();
+    ASSERT_EQ(record.status(), OkStatus());
+    EXPECT_EQ(record->message, message);
+    EXPECT_EQ(record->dropped, dropped);
+  }
+  EXPECT_EQ(ingester_.stats().logs_dropped, 7u);
+}
+
+TEST_F(LogIngesterTest, IgnoresOtherFramesAndPackets) {
+  const ConstByteSpan entries = EncodeEntries({TestEntry("a")}, 0);
+  ingester_.Process(EncodeFrame(entries, kLogsServiceId, 'L'));
+  ingester_.Process(EncodeFrame(entries, kOtherServiceId));
+
+  EXPECT_EQ(Next().status(), Status::Unavailable());
+  EXPECT_EQ(ingester_.stats().frames, 1u);
+  EXPECT_EQ(ingester_.stats().log_packets, 0u);
+}
+
+TEST_F(LogIngesterTest, FrameSplitAcrossCalls) {
+  const ConstByteSpan frame =
+      EncodeFrame(EncodeEntries({TestEntry("split")}, 0));
+  for (std::byte b : frame) {
+    ingester_.Process(ConstByteSpan(&b, 1));
+  }
+
+  Result<LogRecord> record = Next();
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->message, "split");
+}
+
+TEST_F(LogIngesterTest, InvalidLogEntries) {
+  constexpr auto kInvalid = bytes::Array<0x0a, 0x10, 0x01>();
+  ingester_.Process(EncodeFrame(kInvalid));
+  EXPECT_EQ(ingester_.ProcessLogEntries(kInvalid), Status::DataLoss());
+
+  EXPECT_EQ(Next().status(), Status::Unavailable());
+  EXPECT_EQ(ingester_.stats().log_packets, 1u);
+  EXPECT_EQ(ingester_.stats().decode_errors, 1u);
+}
+
+TEST(LogIngester, NoDetokenizer) {
+  alignas(LogRing::Header) std::array<std::byte, 1024> ring_memory{};
+  LogRingWriter writer(ring_memory);
+  std::array<std::byte, 128> frame_buffer;
+  LogIngester ingester(writer, nullptr, frame_buffer);
+
+  std::array<std::byte, 64> entries_buffer;
+  protobuf::MemoryEncoder encoder(entries_buffer);
+  encoder
+      .GetNestedEncoder(static_cast<uint32_t>(LogEntries::Fields::kEntries))
+      .WriteBytes(static_cast<uint32_t>(LogEntry::Fields::kMessage),
+                  kTokenizedMessage)
+      .IgnoreError();
+  ASSERT_EQ(ingester.ProcessLogEntries(encoder), OkStatus());
+
+  LogRingReader reader = *LogRingReader::Create(ring_memory);
+  std::array<std::byte, 64> buffer;
+  Result<LogRecord> record = reader.Read(buffer);
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->message, "$AQAAAFQ=");
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
@@ -0,0 +1,396 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/log_ring.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#include "pw_assert/check.h"
+
+namespace pw::log_rpc {
+namespace {
+
+constexpr size_t kAlignment = 8;
+
+constexpr size_t AlignUp(size_t value) {
+  return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+bool IsAligned(const void* pointer) {
+  return reinterpret_cast<uintptr_t>(pointer) % kAlignment == 0u;
+}
+
+// Readers may copy a record while the writer overwrites it, and discard the
+// copy afterwards. To keep these races defined, the ring is only accessed in
+// relaxed atomic words, which compile to plain loads and stores.
+using Word = std::atomic<uint64_t>;
+static_assert(sizeof(Word) == kAlignment);
+
+Word* Words(std::byte* data) { return reinterpret_cast<Word*>(data); }
+
+const Word* Words(const std::byte* data) {
+  return reinterpret_cast<const Word*>(data);
+}
+
+// Copies size bytes from the ring, reading whole words.
+void LoadWords(const std::byte* ring, void* output, size_t size) {
+  const Word* words = Words(ring);
+  auto* out = static_cast<std::byte*>(output);
+  for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+    const uint64_t word = words[i / sizeof(uint64_t)].load(
+        std::memory_order_relaxed);
+    std::memcpy(out + i, &word, std::min(sizeof(word), size - i));
+  }
+}
+
+// Copies data into the ring one word at a time. Call Flush() to write the
+// last, partial word.
+class WordWriter {
+ public:
+  explicit WordWriter(std::byte* ring) : words_(Words(ring)) {}
+
+  void Write(const void* data, size_t size) {
+    const auto* bytes = static_cast<const std::byte*>(data);
+    while (size != 0u) {
+      const size_t to_copy = std::min(size, sizeof(word_) - filled_);
+      std::memcpy(reinterpret_cast<std::byte*>(&word_) + filled_,
+                  bytes,
+                  to_copy);
+      filled_ += to_copy;
+      bytes += to_copy;
+      size -= to_copy;
+      if (filled_ == sizeof(word_)) {
+        Store();
+      }
+    }
+  }
+
+  void Flush() {
+    if (filled_ != 0u) {
+      std::memset(reinterpret_cast<std::byte*>(&word_) + filled_,
+                  0,
+                  sizeof(word_) - filled_);
+      Store();
+    }
+  }
+
+ private:
+  void Store() {
+    words_->store(word_, std::memory_order_relaxed);
+    words_ += 1;
+    filled_ = 0;
+  }
+
+  Word* words_;
+  uint64_t word_ = 0;
+  size_t filled_ = 0;
+};
+
+Status ErrnoToStatus(int error) {
+  switch (error) {
+    case ENOENT:
+    case ENOTDIR:
+      return Status::NotFound();
+    case EACCES:
+    case EPERM:
+    case EROFS:
+      return Status::PermissionDenied();
+    case ENODEV:  // The file system does not support mapping.
+      return Status::FailedPrecondition();
+    case ENOMEM:
+    case ENOSPC:
+    case EMFILE:
+    case ENFILE:
+      return Status::ResourceExhausted();
+    default:
+      return Status::Unknown();
+  }
+}
+
+}  // namespace
+
+size_t LogRing::RecordSize(const LogRecord& record) {
+  return AlignUp(sizeof(RecordHeader) + record.message.size() +
+                 record.module.size() + record.file.size() +
+                 record.thread.size());
+}
+
+LogRing::Header& LogRingWriter::Initialize(ByteSpan memory) {
+  PW_CHECK_UINT_GE(memory.size(), kMinSizeBytes);
+  PW_CHECK(IsAligned(memory.data()));
+
+  Header& header = *new (memory.data()) Header{};
+  header.version = kVersion;
+  header.capacity = (memory.size() - sizeof(Header)) / kAlignment * kAlignment;
+  header.head.store(0, std::memory_order_relaxed);
+  header.tail.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  header.magic = kMagic;
+  return header;
+}
+
+LogRingWriter::LogRingWriter(ByteSpan memory)
+    : header_(Initialize(memory)),
+      data_(memory.data() + sizeof(Header)),
+      capacity_(header_.capacity),
+      max_record_size_(capacity_ / 2 / kAlignment * kAlignment) {}
+
+Status LogRingWriter::Write(const LogRecord& record) {
+  constexpr size_t kMaxStringSize = std::numeric_limits<uint16_t>::max();
+  const size_t size = RecordSize(record);
+  if (size > max_record_size_ || record.message.size() > kMaxStringSize ||
+      record.module.size() > kMaxStringSize ||
+      record.file.size() > kMaxStringSize ||
+      record.thread.size() > kMaxStringSize) {
+    return Status::ResourceExhausted();
+  }
+
+  // Records do not wrap, so pad the end of the ring if the record does not
+  // fit there. The padding is smaller than the record, and records are at most
+  // half of the ring, so evicting records always makes room.
+  const uint64_t head = header_.head.load(std::memory_order_relaxed);
+  const size_t position = head % capacity_;
+  const size_t padding = capacity_ - position < size ? capacity_ - position : 0;
+  const uint64_t new_head = head + padding + size;
+
+  const uint64_t old_tail = header_.tail.load(std::memory_order_relaxed);
+  uint64_t tail = old_tail;
+  while (new_head - tail > capacity_) {
+    uint32_t tail_size;
+    LoadWords(data_ + tail % capacity_, &tail_size, sizeof(tail_size));
+    tail += tail_size & ~kPadding;
+  }
+
+  if (tail != old_tail) {
+    // Readers check the tail after copying a record, so move it past the
+    // records that are about to be overwritten first. The fence keeps the
+    // writes below from becoming visible before the new tail.
+    header_.tail.store(tail, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  if (padding != 0u) {
+    const uint32_t padding_size = static_cast<uint32_t>(padding) | kPadding;
+    WordWriter out(data_ + position);
+    out.Write(&padding_size, sizeof(padding_size));
+    out.Flush();
+  }
+
+  const RecordHeader record_header = {
+      .size = static_cast<uint32_t>(size),
+      .line_level = record.line_level,
+      .sequence = sequence_,
+      .timestamp = record.timestamp,
+      .flags = record.flags,
+      .dropped = record.dropped,
+      .message_size = static_cast<uint16_t>(record.message.size()),
+      .module_size = static_cast<uint16_t>(record.module.size()),
+      .file_size = static_cast<uint16_t>(record.file.size()),
+      .thread_size = static_cast<uint16_t>(record.thread.size()),
+  };
+  WordWriter out(data_ + (head + padding) % capacity_);
+  out.Write(&record_header, sizeof(record_header));
+  for (std::string_view string :
+       {record.message, record.module, record.file, record.thread}) {
+    out.Write(string.data(), string.size());
+  }
+  out.Flush();
+
+  sequence_ += 1;
+  header_.head.store(new_head, std::memory_order_release);
+  return OkStatus();
+}
+
+Result<LogRingReader> LogRingReader::Create(ConstByteSpan memory) {
+  if (memory.size() < kMinSizeBytes || !IsAligned(memory.data())) {
+    return Status::DataLoss();
+  }
+  const Header& header = *reinterpret_cast<const Header*>(memory.data());
+  if (header.magic != kMagic || header.version != kVersion ||
+      header.capacity % kAlignment != 0u ||
+      header.capacity < kMinSizeBytes - sizeof(Header) ||
+      header.capacity > memory.size() - sizeof(Header)) {
+    return Status::DataLoss();
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  LogRingReader reader(header, memory.data() + sizeof(Header));
+  reader.offset_ = header.tail.load(std::memory_order_acquire);
+  return reader;
+}
+
+Result<LogRecord> LogRingReader::Read(ByteSpan buffer) {
+  while (true) {
+    const uint64_t head = header_->head.load(std::memory_order_acquire);
+    const uint64_t tail = header_->tail.load(std::memory_order_acquire);
+    if (offset_ < tail) {
+      offset_ = tail;  // The sequence numbers count the skipped records.
+    }
+    if (offset_ >= head) {
+      return Status::Unavailable();
+    }
+
+    // A padding record at the end of the ring may be smaller than a header.
+    const size_t position = offset_ % capacity_;
+    const size_t available = capacity_ - position;
+    RecordHeader header{};
+    LoadWords(data_ + position, &header, std::min(sizeof(header), available));
+
+    if ((header.size & kPadding) != 0u) {
+      if (Overwritten()) {
+        continue;
+      }
+      if ((header.size & ~kPadding) != available) {
+        return Status::DataLoss();
+      }
+      offset_ += available;
+      continue;
+    }
+
+    const size_t strings_size =
+        size_t{header.message_size} + header.module_size + header.file_size +
+        header.thread_size;
+    if (header.size % kAlignment != 0u || header.size > available ||
+        header.size < sizeof(header) + strings_size) {
+      if (Overwritten()) {
+        continue;
+      }
+      return Status::DataLoss();
+    }
+    if (strings_size > buffer.size()) {
+      if (Overwritten()) {
+        continue;
+      }
+      return Status::ResourceExhausted();
+    }
+
+    LoadWords(data_ + position + sizeof(header), buffer.data(), strings_size);
+    if (Overwritten()) {
+      continue;
+    }
+    offset_ += header.size;
+
+    if (next_sequence_ != kNoSequence && header.sequence > next_sequence_) {
+      records_dropped_ += header.sequence - next_sequence_;
+    }
+    next_sequence_ = header.sequence + 1;
+
+    const char* strings = reinterpret_cast<const char*>(buffer.data());
+    LogRecord record;
+    record.sequence = header.sequence;
+    record.timestamp = header.timestamp;
+    record.line_level = header.line_level;
+    record.flags = header.flags;
+    record.dropped = header.dropped;
+    record.message = std::string_view(strings, header.message_size);
+    strings += header.message_size;
+    record.module = std::string_view(strings, header.module_size);
+    strings += header.module_size;
+    record.file = std::string_view(strings, header.file_size);
+    strings += header.file_size;
+    record.thread = std::string_view(strings, header.thread_size);
+    return record;
+  }
+}
+
+void LogRingReader::SkipToNewest() {
+  offset_ = header_->head.load(std::memory_order_acquire);
+  next_sequence_ = kNoSequence;
+}
+
+bool LogRingReader::Overwritten() const {
+  // Pairs with the fence in LogRingWriter::Write(): if the copy saw any data
+  // written after the tail moved, this load sees the new tail.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return header_->tail.load(std::memory_order_relaxed) > offset_;
+}
+
+Status MappedLogRing::Create(const char* path, size_t size_bytes) {
+  Close();
+  if (size_bytes < LogRing::kMinSizeBytes) {
+    return Status::InvalidArgument();
+  }
+
+  const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return ErrnoToStatus(errno);
+  }
+  if (ftruncate(fd, static_cast<off_t>(size_bytes)) != 0) {
+    const int error = errno;
+    close(fd);
+    return ErrnoToStatus(error);
+  }
+
+  void* mapping =
+      mmap(nullptr, size_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int error = errno;
+  close(fd);  // The mapping holds its own reference to the file.
+  if (mapping == MAP_FAILED) {
+    return ErrnoToStatus(error);
+  }
+
+  data_ = static_cast<std::byte*>(mapping);
+  size_ = size_bytes;
+  return OkStatus();
+}
+
+Status MappedLogRing::Open(const char* path) {
+  Close();
+
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return ErrnoToStatus(errno);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    const int error = errno;
+    close(fd);
+    return ErrnoToStatus(error);
+  }
+  const size_t size = static_cast<size_t>(file_stat.st_size);
+  if (size < LogRing::kMinSizeBytes) {
+    close(fd);
+    return Status::DataLoss();
+  }
+
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  const int error = errno;
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return ErrnoToStatus(error);
+  }
+
+  data_ = static_cast<std::byte*>(mapping);
+  size_ = size;
+  return OkStatus();
+}
+
+void MappedLogRing::Close() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace pw::log_rpc
@@ -0,0 +1,259 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/log_ring.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace pw::log_rpc {
+namespace {
+
+constexpr size_t kRingSizeBytes = 512;
+
+LogRecord MakeRecord(std::string_view message, int64_t timestamp = 0) {
+  LogRecord record;
+  record.timestamp = timestamp;
+  record.line_level = (42 << 3) | 2;
+  record.flags = 1;
+  record.message = message;
+  record.module = "mod";
+  record.file = "file.cc";
+  record.thread = "main";
+  return record;
+}
+
+class LogRingTest : public ::testing::Test {
+ protected:
+  LogRingTest() : writer_(memory_) {}
+
+  LogRingReader CreateReader() {
+    Result<LogRingReader> reader = LogRingReader::Create(memory_);
+    EXPECT_EQ(reader.status(), OkStatus());
+    return *reader;
+  }
+
+  alignas(LogRing::Header) std::array<std::byte, kRingSizeBytes> memory_{};
+  LogRingWriter writer_;
+  std::array<std::byte, 256> buffer_;
+};
+
+TEST_F(LogRingTest, ReadsRecordsInOrder) {
+  ASSERT_EQ(writer_.Write(MakeRecord("one", 10)), OkStatus());
+  ASSERT_EQ(writer_.Write(MakeRecord("two", 20)), OkStatus());
+
+  LogRingReader reader = CreateReader();
+  Result<LogRecord> record = reader.Read(buffer_);
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->sequence, 0u);
+  EXPECT_EQ(record->timestamp, 10);
+  EXPECT_EQ(record->line_level, (42u << 3) | 2u);
+  EXPECT_EQ(record->flags, 1u);
+  EXPECT_EQ(record->dropped, 0u);
+  EXPECT_EQ(record->message, "one");
+  EXPECT_EQ(record->module, "mod");
+  EXPECT_EQ(record->file, "file.cc");
+  EXPECT_EQ(record->thread, "main");
+
+  record = reader.Read(buffer_);
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->sequence, 1u);
+  EXPECT_EQ(record->message, "two");
+
+  EXPECT_EQ(reader.Read(buffer_).status(), Status::Unavailable());
+  ASSERT_EQ(writer_.Write(MakeRecord("three")), OkStatus());
+  record = reader.Read(buffer_);
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->message, "three");
+  EXPECT_EQ(reader.records_dropped(), 0u);
+}
+
+TEST_F(LogRingTest, OverwritesOldestRecords) {
+  LogRingReader reader = CreateReader();
+
+  // Write enough records to wrap around the ring several times.
+  std::array<std::string, 40> messages;
+  for (size_t i = 0; i < messages.size(); ++i) {
+    messages[i] = "message " + std::to_string(i);
+    ASSERT_EQ(writer_.Write(MakeRecord(messages[i])), OkStatus());
+  }
+  EXPECT_EQ(writer_.records_written(), messages.size());
+
+  // The reader skips to the oldest record that was not overwritten.
+  Result<LogRecord> record = reader.Read(buffer_);
+  ASSERT_EQ(record.status(), OkStatus());
+  const uint64_t first = record->sequence;
+  EXPECT_GT(first, 0u);
+  EXPECT_EQ(reader.records_dropped(), 0u);  // Unknown until the second read.
+  EXPECT_EQ(record->message, messages[first]);
+
+  uint64_t expected = first + 1;
+  while ((record = reader.Read(buffer_)).ok()) {
+    EXPECT_EQ(record->sequence, expected);
+    EXPECT_EQ(record->message, messages[expected]);
+    expected += 1;
+  }
+  EXPECT_EQ(record.status(), Status::Unavailable());
+  EXPECT_EQ(expected, messages.size());
+}
+
+TEST_F(LogRingTest, CountsRecordsOverwrittenBeforeRead) {
+  LogRingReader reader = CreateReader();
+  ASSERT_EQ(writer_.Write(MakeRecord("first")), OkStatus());
+  ASSERT_EQ(reader.Read(buffer_).status(), OkStatus());
+
+  size_t written = 0;
+  const size_t record_size = LogRing::RecordSize(MakeRecord("x"));
+  while (written * record_size < 2 * kRingSizeBytes) {
+    ASSERT_EQ(writer_.Write(MakeRecord("x")), OkStatus());
+    written += 1;
+  }
+
+  size_t read = 0;
+  while (reader.Read(buffer_).ok()) {
+    read += 1;
+  }
+  EXPECT_LT(read, written);
+  EXPECT_EQ(reader.records_dropped(), written - read);
+}
+
+TEST_F(LogRingTest, RecordTooLarge) {
+  const std::string message(writer_.max_record_size(), 'x');
+  EXPECT_EQ(writer_.Write(MakeRecord(message)), Status::ResourceExhausted());
+
+  const std::string largest(
+      writer_.max_record_size() - LogRing::RecordSize(MakeRecord("")), 'x');
+  EXPECT_EQ(writer_.Write(MakeRecord(largest)), OkStatus());
+}
+
+TEST_F(LogRingTest, BufferTooSmall) {
+  ASSERT_EQ(writer_.Write(MakeRecord("message")), OkStatus());
+
+  LogRingReader reader = CreateReader();
+  std::array<std::byte, 8> small;
+  EXPECT_EQ(reader.Read(small).status(), Status::ResourceExhausted());
+
+  Result<LogRecord> record = reader.Read(buffer_);
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->message, "message");
+}
+
+TEST_F(LogRingTest, SkipToNewest) {
+  ASSERT_EQ(writer_.Write(MakeRecord("old")), OkStatus());
+
+  LogRingReader reader = CreateReader();
+  reader.SkipToNewest();
+  EXPECT_EQ(reader.Read(buffer_).status(), Status::Unavailable());
+
+  ASSERT_EQ(writer_.Write(MakeRecord("new")), OkStatus());
+  Result<LogRecord> record = reader.Read(buffer_);
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->message, "new");
+}
+
+TEST(LogRingReader, RejectsUninitializedMemory) {
+  alignas(LogRing::Header) std::array<std::byte, kRingSizeBytes> memory{};
+  EXPECT_EQ(LogRingReader::Create(memory).status(), Status::DataLoss());
+  EXPECT_EQ(LogRingReader::Create(span(memory).first(16)).status(),
+            Status::DataLoss());
+}
+
+TEST(LogRingReader, ReadsWhileWriting) {
+  alignas(LogRing::Header) std::array<std::byte, 4096> memory;
+  LogRingWriter writer(memory);
+  LogRingReader reader = *LogRingReader::Create(memory);
+
+  // Each message is its sequence number, so torn records are detected.
+  constexpr uint64_t kRecords = 100000;
+  std::atomic<bool> done = false;
+  std::thread thread([&] {
+    for (uint64_t i = 0; i < kRecords; ++i) {
+      const std::string message = std::to_string(i);
+      writer.Write(MakeRecord(message, static_cast<int64_t>(i))).IgnoreError();
+    }
+    done.store(true);
+  });
+
+  std::array<std::byte, 64> buffer;
+  uint64_t read = 0;
+  uint64_t first = 0;
+  uint64_t last = 0;
+  while (true) {
+    const bool finished = done.load();
+    Result<LogRecord> record = reader.Read(buffer);
+    if (!record.ok()) {
+      EXPECT_EQ(record.status(), Status::Unavailable());
+      if (finished) {
+        break;
+      }
+      continue;
+    }
+    EXPECT_EQ(record->message, std::to_string(record->sequence));
+    EXPECT_EQ(record->timestamp, static_cast<int64_t>(record->sequence));
+    if (read == 0u) {
+      first = record->sequence;
+    } else {
+      EXPECT_GT(record->sequence, last);
+    }
+    last = record->sequence;
+    read += 1;
+  }
+  thread.join();
+
+  EXPECT_EQ(last, kRecords - 1);
+  EXPECT_EQ(read + reader.records_dropped(), last - first + 1);
+}
+
+TEST(MappedLogRing, SharesRingThroughFile) {
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "pw_log_rpc_log_ring_test")
+          .string();
+
+  MappedLogRing writer_file;
+  ASSERT_EQ(writer_file.Create(path.c_str(), kRingSizeBytes), OkStatus());
+  LogRingWriter writer(writer_file.memory());
+  ASSERT_EQ(writer.Write(MakeRecord("shared")), OkStatus());
+
+  MappedLogRing reader_file;
+  ASSERT_EQ(reader_file.Open(path.c_str()), OkStatus());
+  Result<LogRingReader> reader = LogRingReader::Create(reader_file.memory());
+  ASSERT_EQ(reader.status(), OkStatus());
+
+  std::array<std::byte, 64> buffer;
+  Result<LogRecord> record = reader->Read(buffer);
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->message, "shared");
+
+  ASSERT_EQ(writer.Write(MakeRecord("after open")), OkStatus());
+  record = reader->Read(buffer);
+  ASSERT_EQ(record.status(), OkStatus());
+  EXPECT_EQ(record->message, "after open");
+
+  reader_file.Close();
+  writer_file.Close();
+  std::filesystem::remove(path);
+
+  EXPECT_EQ(MappedLogRing().Open(path.c_str()), Status::NotFound());
+  EXPECT_EQ(MappedLogRing().Create(path.c_str(), 16),
+            Status::InvalidArgument());
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
@@ -20,17 +20,38 @@
 
 #include "pw_log/log.h"
 #include "pw_log/proto/log.pwpb.h"
+#include "pw_protobuf/decoder.h"
 
 namespace pw::log_rpc {
+namespace {
 
-void LogService::Listen(ConstByteSpan, rpc::RawServerWriter& writer) {
+RpcLogDrain::LogEntryEncoding RequestedEncoding(ConstByteSpan request) {
+  protobuf::Decoder decoder(request);
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() !=
+        static_cast<uint32_t>(log::pwpb::LogRequest::Fields::kCompactEntries)) {
+      continue;
+    }
+    bool compact_entries = false;
+    if (decoder.ReadBool(&compact_entries).ok() && compact_entries) {
+      return RpcLogDrain::LogEntryEncoding::kCompact;
+    }
+  }
+  return RpcLogDrain::LogEntryEncoding::kFull;
+}
+
+}  // namespace
+
+void LogService::Listen(ConstByteSpan request, rpc::RawServerWriter& writer) {
   uint32_t channel_id = writer.channel_id();
   Result<RpcLogDrain*> drain = drains_.GetDrainFromChannelId(channel_id);
   if (!drain.ok()) {
     return;
   }
 
-  if (const Status status = drain.value()->Open(writer); !status.ok()) {
+  if (const Status status =
+          drain.value()->Open(writer, RequestedEncoding(request));
+      !status.ok()) {
     PW_LOG_DEBUG("Could not start new log stream. %d",
                  static_cast<int>(status.code()));
   }
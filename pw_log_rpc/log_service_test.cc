@@ -250,6 +250,47 @@ TEST_F(LogServiceTest, StartAndEndStream) {
   EXPECT_EQ(drop_count_found, 0u);
 }
 
+TEST_F(LogServiceTest, RequestCompactEntries) {
+  RpcLogDrain& active_drain = drains_[2];
+  const uint32_t drain_channel_id = active_drain.channel_id();
+  LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
+  context.set_channel_id(drain_channel_id);
+
+  const size_t total_entries = 10;
+  AddLogEntries(total_entries, kMessage, kSampleMetadata, kSampleTimestamp, {});
+
+  // Request compact logs.
+  std::array<std::byte, 8> request_buffer;
+  log::pwpb::LogRequest::MemoryEncoder request(request_buffer);
+  ASSERT_EQ(request.WriteCompactEntries(true), OkStatus());
+  context.call(request);
+  EXPECT_EQ(active_drain.Flush(encoding_buffer_), OkStatus());
+  EXPECT_EQ(OkStatus(), active_drain.Close());
+  ASSERT_TRUE(context.done());
+  EXPECT_GE(context.responses().size(), 1u);
+
+  size_t entries_found = 0;
+  for (auto& response : context.responses()) {
+    bool compact_entries = false;
+    protobuf::Decoder entries_decoder(response);
+    while (entries_decoder.Next().ok()) {
+      switch (static_cast<log::pwpb::LogEntries::Fields>(
+          entries_decoder.FieldNumber())) {
+        case log::pwpb::LogEntries::Fields::kEntries:
+          ++entries_found;
+          break;
+        case log::pwpb::LogEntries::Fields::kCompactEntries:
+          ASSERT_EQ(entries_decoder.ReadBool(&compact_entries), OkStatus());
+          break;
+        default:
+          break;
+      }
+    }
+    EXPECT_TRUE(compact_entries);
+  }
+  EXPECT_EQ(entries_found, total_entries);
+}
+
 TEST_F(LogServiceTest, HandleDropped) {
   RpcLogDrain& active_drain = drains_[0];
   const uint32_t drain_channel_id = active_drain.channel_id();
@@ -41,6 +41,13 @@
 #define PW_LOG_RPC_CONFIG_MAX_FILTER_ID_SIZE 4
 #endif  // PW_LOG_RPC_CONFIG_MAX_FILTER_ID_SIZE
 
+// Drains using the compact LogEntries encoding remember the previous entry's
+// module to avoid resending it. Longer module names are sent with every entry.
+// Default the max remembered module name size to 8 bytes, which fits tokens.
+#ifndef PW_LOG_RPC_CONFIG_MAX_COMPACT_MODULE_NAME_SIZE
+#define PW_LOG_RPC_CONFIG_MAX_COMPACT_MODULE_NAME_SIZE 8
+#endif  // PW_LOG_RPC_CONFIG_MAX_COMPACT_MODULE_NAME_SIZE
+
 // The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_LOG_RPC_CONFIG_LOG_LEVEL
 #define PW_LOG_RPC_CONFIG_LOG_LEVEL PW_LOG_LEVEL_INFO
@@ -91,4 +98,7 @@ inline constexpr size_t kMaxFilterIdBytes =
 
 inline constexpr size_t kMaxThreadNameBytes =
     PW_LOG_RPC_CONFIG_MAX_FILTER_RULE_THREAD_NAME_SIZE;
+
+inline constexpr size_t kMaxCompactModuleNameBytes =
+    PW_LOG_RPC_CONFIG_MAX_COMPACT_MODULE_NAME_SIZE;
 }  // namespace pw::log_rpc::cfg
@@ -0,0 +1,206 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::log_rpc {
+
+/// A tokenized log or trace event, as stored in a log archive.
+struct LogArchiveEntry {
+  int64_t timestamp = 0;
+  /// The token of the message format string.
+  uint32_t token = 0;
+  uint8_t level = 0;
+  /// The token of the module name, or 0 if the log has no module.
+  uint32_t module = 0;
+  /// The encoded arguments that follow the token in a tokenized message.
+  ConstByteSpan args;
+};
+
+/// Selects the entries a `LogArchiveReader` returns. Timestamps are inclusive.
+struct LogArchiveQuery {
+  int64_t min_timestamp = std::numeric_limits<int64_t>::min();
+  int64_t max_timestamp = std::numeric_limits<int64_t>::max();
+  std::optional<uint32_t> module;
+  std::optional<uint32_t> token;
+};
+
+/// The on-disk format of log archives.
+///
+/// An archive is a file header followed by chunks of up to a few thousand
+/// entries. Each chunk starts with a varint-prefixed index message, which
+/// holds the chunk's timestamp range, its distinct modules, and a Bloom filter
+/// of its tokens. Readers use the index to skip chunks that cannot match a
+/// query without reading their data.
+///
+/// The chunk's data message that follows stores each field as a column:
+/// timestamps as deltas, tokens and modules as indices into per-chunk
+/// dictionaries, and levels as runs. Logs repeat the same tokens, modules and
+/// levels, and are mostly in time order, so the columns are much smaller than
+/// the entries.
+class LogArchive {
+ public:
+  static constexpr uint32_t kMagic = 0x616c7770;  // "pwla"
+  static constexpr uint32_t kVersion = 1;
+  static constexpr size_t kFileHeaderSizeBytes = 8;
+
+  /// Fields of the index message at the start of each chunk.
+  enum class IndexField : uint32_t {
+    kEntryCount = 1,     // uint32
+    kMinTimestamp = 2,   // sint64
+    kMaxTimestamp = 3,   // sint64
+    kModules = 4,        // packed fixed32, the module dictionary
+    kTokenFilter = 5,    // bytes, a Bloom filter with a power of 2 bits
+    kDataSizeBytes = 6,  // uint32, the size of the data message that follows
+  };
+
+  /// Fields of the data message of each chunk. Columns of integers are
+  /// concatenated varints.
+  enum class DataField : uint32_t {
+    kTimestamps = 1,  // Zig-zag deltas, the first from the minimum timestamp.
+    kTokens = 2,      // Packed fixed32, the token dictionary.
+    kTokenIndices = 3,
+    kLevels = 4,  // Pairs of level and run length.
+    kModuleIndices = 5,
+    kArgSizes = 6,
+    kArgs = 7,  // Concatenated arguments.
+  };
+
+  /// Returns whether the Bloom filter might contain the token.
+  static bool FilterMayContain(ConstByteSpan filter, uint32_t token);
+
+ protected:
+  // Bits set in the token filter per token.
+  static constexpr size_t kFilterHashes = 4;
+
+  // Returns the bit that the token sets for the given hash in a filter with
+  // filter_bits bits, which is a power of 2.
+  static size_t FilterBit(uint32_t token, size_t hash, size_t filter_bits);
+};
+
+/// Writes entries to a log archive.
+///
+/// Entries are buffered in memory and written a chunk at a time. `Flush()` must
+/// be called after the last entry.
+class LogArchiveWriter : public LogArchive {
+ public:
+  static constexpr size_t kDefaultEntriesPerChunk = 4096;
+
+  explicit LogArchiveWriter(stream::Writer& output,
+                            size_t entries_per_chunk = kDefaultEntriesPerChunk)
+      : output_(output), entries_per_chunk_(entries_per_chunk) {}
+
+  LogArchiveWriter(const LogArchiveWriter&) = delete;
+  LogArchiveWriter& operator=(const LogArchiveWriter&) = delete;
+
+  /// Adds an entry, writing the current chunk if it is full. Returns errors
+  /// from writing the output.
+  Status Append(const LogArchiveEntry& entry);
+
+  /// Writes the current chunk, and the file header if nothing was written yet.
+  Status Flush();
+
+  size_t chunks_written() const { return chunks_written_; }
+
+ private:
+  Status WriteChunk();
+
+  stream::Writer& output_;
+  const size_t entries_per_chunk_;
+  bool header_written_ = false;
+  size_t chunks_written_ = 0;
+
+  // The entries of the current chunk, by column.
+  std::vector<int64_t> timestamps_;
+  std::vector<uint32_t> tokens_;
+  std::vector<uint8_t> levels_;
+  std::vector<uint32_t> modules_;
+  std::vector<uint32_t> arg_sizes_;
+  std::vector<std::byte> args_;
+};
+
+/// Reads the entries that match a query from a log archive, in the order they
+/// were written.
+class LogArchiveReader : public LogArchive {
+ public:
+  struct Stats {
+    size_t chunks_read = 0;
+    size_t chunks_skipped = 0;
+  };
+
+  explicit LogArchiveReader(stream::SeekableReader& input,
+                            const LogArchiveQuery& query = {})
+      : input_(input), query_(query) {}
+
+  LogArchiveReader(const LogArchiveReader&) = delete;
+  LogArchiveReader& operator=(const LogArchiveReader&) = delete;
+
+  /// Returns the next matching entry. Its arguments remain valid until the
+  /// next call.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - Returns the entry.
+  /// * @pw_status{OUT_OF_RANGE} - There are no more matching entries.
+  /// * @pw_status{DATA_LOSS} - The archive is invalid or truncated.
+  Result<LogArchiveEntry> Next();
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // Reads chunks until one that may match the query is loaded.
+  Status LoadNextChunk();
+
+  // Decodes the index of a chunk. Returns whether the chunk may match the
+  // query, and sets the number of entries and the size of its data.
+  Result<bool> DecodeIndex(ConstByteSpan index,
+                           uint32_t& entry_count,
+                           uint32_t& data_size);
+
+  Status DecodeData(ConstByteSpan data, uint32_t entry_count);
+
+  bool Matches(size_t entry) const;
+
+  Status ReadExact(ByteSpan buffer);
+
+  stream::SeekableReader& input_;
+  const LogArchiveQuery query_;
+  bool header_read_ = false;
+  Stats stats_;
+
+  std::vector<std::byte> index_;
+  std::vector<std::byte> data_;
+
+  // The current chunk. The arguments refer to its data.
+  uint32_t entry_count_ = 0;
+  int64_t min_timestamp_ = 0;
+  std::vector<uint32_t> module_dictionary_;
+  std::vector<int64_t> timestamps_;
+  std::vector<uint32_t> tokens_;
+  std::vector<uint8_t> levels_;
+  std::vector<uint32_t> modules_;
+  std::vector<ConstByteSpan> args_;
+  size_t next_entry_ = 0;
+};
+
+}  // namespace pw::log_rpc
@@ -14,12 +14,15 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 
 #include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
 #include "pw_containers/vector.h"
+#include "pw_log/levels.h"
 #include "pw_log/proto/log.pwpb.h"
 #include "pw_log_rpc/internal/config.h"
 #include "pw_span/span.h"
@@ -55,9 +58,13 @@ class Filter {
     Vector<std::byte, cfg::kMaxThreadNameBytes> thread_equals{};
   };
 
+  // The rules are compiled when the filter is created and when they are
+  // updated with UpdateRulesFromProto(). Rules must not be modified through
+  // other means after the filter is created.
   Filter(span<const std::byte> id, span<Rule> rules) : rules_(rules) {
     PW_ASSERT(!id.empty());
     id_.assign(id.begin(), id.end());
+    CompileRules();
   }
 
   // Not copyable.
@@ -71,6 +78,9 @@ class Filter {
   // provided, stopping at the first rule that matches.
   // Returns true when the log should be dropped, false otherwise. Defaults to
   // false if there are no rules, or no rules were matched.
+  //
+  // The entry is only decoded as far as needed to reach a decision. Logs whose
+  // level alone decides the outcome are not decoded past the level.
   bool ShouldDropLog(ConstByteSpan entry) const;
 
   // Decodes and updates the filter's rules given a buffer with a proto-encoded
@@ -84,8 +94,33 @@ class Filter {
   Status UpdateRulesFromProto(ConstByteSpan buffer);
 
  private:
+  static constexpr size_t kLogLevels = 1 << PW_LOG_LEVEL_BITS;
+
+  // What is known about the outcome of a log with a given level, before
+  // looking at any of its other fields.
+  struct LevelDecision {
+    enum class Kind : uint8_t {
+      kKeep,
+      kDrop,
+      kEvaluateRules,
+    };
+    Kind kind = Kind::kKeep;
+    // The first rule that may match logs of this level.
+    size_t first_rule = 0;
+  };
+
+  Status DecodeRulesFromProto(ConstByteSpan buffer);
+
+  // Precomputes the per-level decisions from the current rules.
+  void CompileRules();
+
   Vector<std::byte, cfg::kMaxFilterIdBytes> id_;
   span<Rule> rules_;
+  std::array<LevelDecision, kLogLevels> level_decisions_;
+  // One past the last active rule.
+  size_t active_rules_end_ = 0;
+  // Whether any active rule checks the log level.
+  bool checks_level_ = false;
 };
 
 }  // namespace pw::log_rpc
@@ -0,0 +1,120 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_log_rpc/log_ring.h"
+#include "pw_status/status.h"
+#include "pw_tokenizer/detokenize.h"
+
+namespace pw::log_rpc {
+
+/// Decodes the log stream from one device on the host and writes the logs to
+/// a `LogRing`.
+///
+/// The ingester decodes HDLC frames sent to the RPC address, and takes the
+/// `LogEntries` from `pw.log.Logs.Listen` responses on any channel. Other
+/// frames and packets are ignored. Optionally tokenized fields are decoded as
+/// the Python tools do: a field is detokenized if its token is in the
+/// database, kept as is if it is printable text, and otherwise stored as
+/// prefixed Base64.
+///
+/// To ingest several devices in parallel, give each device its own ingester
+/// and ring, and run each ingester on its own thread. The `Detokenizer` may be
+/// shared by all of them.
+class LogIngester {
+ public:
+  // The address pw_hdlc uses for RPC packets by default.
+  static constexpr uint64_t kDefaultRpcAddress = 'R';
+
+  struct Stats {
+    size_t frames = 0;           // Frames for the RPC address.
+    size_t frame_errors = 0;     // Invalid or oversized frames.
+    size_t log_packets = 0;      // Log stream packets.
+    size_t decode_errors = 0;    // Log packets that could not be decoded.
+    size_t records = 0;          // Records written, including drop records.
+    size_t records_dropped = 0;  // Records too large for the ring.
+    size_t logs_dropped = 0;     // Logs dropped by the device or in transit.
+  };
+
+  /// Creates an ingester that decodes frames into `frame_buffer`, which must
+  /// fit the largest frame the device sends. `detokenizer` may be null if the
+  /// device does not tokenize its logs.
+  LogIngester(LogRingWriter& ring,
+              const tokenizer::Detokenizer* detokenizer,
+              ByteSpan frame_buffer,
+              uint64_t rpc_address = kDefaultRpcAddress)
+      : ring_(ring),
+        detokenizer_(detokenizer),
+        decoder_(frame_buffer),
+        rpc_address_(rpc_address) {}
+
+  LogIngester(const LogIngester&) = delete;
+  LogIngester& operator=(const LogIngester&) = delete;
+
+  /// Decodes data received from the device. Frames may be split across calls.
+  void Process(ConstByteSpan data);
+
+  /// Decodes one `LogEntries` message, as sent in a log stream packet.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The entries were written to the ring.
+  /// * @pw_status{DATA_LOSS} - The message could not be decoded. The entries
+  ///   before the error were written.
+  Status ProcessLogEntries(ConstByteSpan log_entries);
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  void ProcessFrame(const Result<hdlc::Frame>& frame);
+
+  Status ProcessLogEntry(ConstByteSpan log_entry);
+
+  // Writes a record reporting logs that were dropped.
+  void WriteDropRecord(uint32_t dropped, std::string_view reason);
+
+  void WriteRecord(const LogRecord& record);
+
+  // Decodes an optionally tokenized field into a string.
+  void DecodeField(ConstByteSpan data, std::string& output) const;
+
+  LogRingWriter& ring_;
+  const tokenizer::Detokenizer* const detokenizer_;
+  hdlc::Decoder decoder_;
+  const uint64_t rpc_address_;
+
+  // Timestamps may be sent as deltas from the previous entry.
+  int64_t last_timestamp_ = 0;
+
+  // The sequence ID expected for the next entry, used to detect entries lost
+  // in transit. Unknown until the first packet is received.
+  uint32_t next_sequence_id_ = 0;
+  bool sequence_id_known_ = false;
+
+  // Decoded fields, kept to reuse their memory.
+  std::string message_;
+  std::string module_;
+  std::string file_;
+  std::string thread_;
+
+  Stats stats_;
+};
+
+}  // namespace pw::log_rpc
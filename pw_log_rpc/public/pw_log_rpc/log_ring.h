@@ -0,0 +1,239 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw::log_rpc {
+
+/// A decoded log, as stored in a log ring. The strings are not
+/// null-terminated.
+struct LogRecord {
+  /// The position of the record in its ring. Gaps in the sequence show where
+  /// records were overwritten before they were read.
+  uint64_t sequence = 0;
+  int64_t timestamp = 0;
+  /// The `line_level` field of the `LogEntry`: the log level in the low 3
+  /// bits, and the line number in the remaining bits.
+  uint32_t line_level = 0;
+  uint32_t flags = 0;
+  /// The number of logs dropped before this one. If this is nonzero, the
+  /// message is the reason they were dropped, if known.
+  uint32_t dropped = 0;
+  std::string_view message;
+  std::string_view module;
+  std::string_view file;
+  std::string_view thread;
+};
+
+/// Shared-memory ring of decoded log records, with one writer and any number
+/// of readers.
+///
+/// The ring lives in a region of memory that starts with a `LogRing::Header`,
+/// usually a file that the writer and readers map with `MappedLogRing`. Readers
+/// never block the writer: when the ring is full, the writer overwrites the
+/// oldest records, and readers that fall behind skip ahead. Readers only load
+/// from the region, so they may map it read-only in other processes.
+///
+/// Records are written whole and never wrap around the end of the ring. Each
+/// starts with a fixed-size header followed by its strings, padded to 8 bytes.
+class LogRing {
+ public:
+  static constexpr uint32_t kMagic = 0x676f6c70;  // "plog"
+  static constexpr uint32_t kVersion = 1;
+
+  /// The start of the ring's memory. `head` and `tail` are byte offsets that
+  /// only increase; the position of an offset in the ring is
+  /// `offset % capacity`.
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    std::atomic<uint64_t> head;  // End of the newest record.
+    std::atomic<uint64_t> tail;  // Start of the oldest record.
+    uint64_t reserved[4];
+  };
+
+  // Readers in other processes load the offsets directly from shared memory.
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+  static_assert(sizeof(Header) == 64u);
+
+  /// Returns the number of bytes a ring needs to store `record`.
+  static size_t RecordSize(const LogRecord& record);
+
+ protected:
+  // The fixed-size part of each record in the ring. A padding record, which
+  // fills the end of the ring when the next record does not fit, is only the
+  // size field with kPadding set.
+  struct RecordHeader {
+    uint32_t size;
+    uint32_t line_level;
+    uint64_t sequence;
+    int64_t timestamp;
+    uint32_t flags;
+    uint32_t dropped;
+    uint16_t message_size;
+    uint16_t module_size;
+    uint16_t file_size;
+    uint16_t thread_size;
+  };
+  static_assert(sizeof(RecordHeader) % 8 == 0u);
+
+  static constexpr uint32_t kPadding = 1u << 31;
+
+ public:
+  /// The smallest memory region that holds a ring.
+  static constexpr size_t kMinSizeBytes =
+      sizeof(Header) + 2 * sizeof(RecordHeader);
+};
+
+/// Writes records to a `LogRing`. Only one writer may use a ring at a time.
+class LogRingWriter : public LogRing {
+ public:
+  /// Initializes `memory` as an empty ring. The memory must be 8-byte aligned,
+  /// at least `kMinSizeBytes`, and must remain valid while the writer is used.
+  /// Records of up to half of the space after the header may be written.
+  explicit LogRingWriter(ByteSpan memory);
+
+  LogRingWriter(const LogRingWriter&) = delete;
+  LogRingWriter& operator=(const LogRingWriter&) = delete;
+
+  /// Appends a record, overwriting the oldest records if the ring is full.
+  /// The record's `sequence` is ignored; records are numbered in the order
+  /// they are written.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The record was written.
+  /// * @pw_status{RESOURCE_EXHAUSTED} - The record is too large for the ring.
+  ///   Strings are limited to 65535 bytes each.
+  Status Write(const LogRecord& record);
+
+  /// The largest record that `Write()` accepts, as returned by `RecordSize()`.
+  size_t max_record_size() const { return max_record_size_; }
+
+  uint64_t records_written() const { return sequence_; }
+
+ private:
+  static Header& Initialize(ByteSpan memory);
+
+  Header& header_;
+  std::byte* const data_;
+  const uint64_t capacity_;
+  const size_t max_record_size_;
+  uint64_t sequence_ = 0;
+};
+
+/// Reads the records in a `LogRing`. Any number of readers may read a ring
+/// while it is written, from any thread or process.
+class LogRingReader : public LogRing {
+ public:
+  /// Reads a ring that was initialized by a `LogRingWriter`, starting from the
+  /// oldest record.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The reader was created.
+  /// * @pw_status{DATA_LOSS} - The memory does not hold a ring of this
+  ///   version.
+  static Result<LogRingReader> Create(ConstByteSpan memory);
+
+  /// Reads the next record, copying its strings into `buffer`. The strings in
+  /// the returned record point into `buffer`.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The next record was read.
+  /// * @pw_status{UNAVAILABLE} - There are no new records.
+  /// * @pw_status{RESOURCE_EXHAUSTED} - The buffer is too small for the
+  ///   strings of the next record. Reading again with a larger buffer returns
+  ///   the record, unless it was overwritten in the meantime.
+  /// * @pw_status{DATA_LOSS} - The ring is corrupt.
+  Result<LogRecord> Read(ByteSpan buffer);
+
+  /// Skips all records written so far, so that the next read returns the next
+  /// record written.
+  void SkipToNewest();
+
+  /// The number of records that were overwritten before this reader read
+  /// them.
+  uint64_t records_dropped() const { return records_dropped_; }
+
+ private:
+  LogRingReader(const Header& header, const std::byte* data)
+      : header_(&header), data_(data), capacity_(header.capacity) {}
+
+  // Whether the records at offset_ were overwritten. Checked after reading
+  // from the ring, since the writer may overwrite records while they are read.
+  bool Overwritten() const;
+
+  static constexpr uint64_t kNoSequence = UINT64_MAX;
+
+  const Header* header_;
+  const std::byte* data_;
+  uint64_t capacity_;
+  uint64_t offset_ = 0;
+  uint64_t next_sequence_ = kNoSequence;
+  uint64_t records_dropped_ = 0;
+};
+
+/// Maps a file that holds a `LogRing` into memory, shared with other processes
+/// that map the same file.
+class MappedLogRing {
+ public:
+  MappedLogRing() = default;
+
+  MappedLogRing(const MappedLogRing&) = delete;
+  MappedLogRing& operator=(const MappedLogRing&) = delete;
+
+  ~MappedLogRing() { Close(); }
+
+  /// Creates or truncates a file of `size_bytes` and maps it for writing.
+  /// Initialize the ring with a `LogRingWriter` on `memory()`.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The file is mapped.
+  /// * @pw_status{INVALID_ARGUMENT} - The size is less than `kMinSizeBytes`.
+  /// * @pw_status{PERMISSION_DENIED} - The file cannot be written.
+  /// * @pw_status{RESOURCE_EXHAUSTED} - The file could not be mapped.
+  Status Create(const char* path, size_t size_bytes);
+
+  /// Maps an existing ring file for reading. Read it with a `LogRingReader`
+  /// on `memory()`.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The file is mapped.
+  /// * @pw_status{NOT_FOUND} - The file does not exist.
+  /// * @pw_status{PERMISSION_DENIED} - The file cannot be read.
+  /// * @pw_status{DATA_LOSS} - The file is too small to hold a ring.
+  /// * @pw_status{RESOURCE_EXHAUSTED} - The file could not be mapped.
+  Status Open(const char* path);
+
+  /// Unmaps the file.
+  void Close();
+
+  /// The mapped file. The memory is read-only unless the file was mapped with
+  /// `Create()`.
+  ByteSpan memory() const { return ByteSpan(data_, size_); }
+
+ private:
+  std::byte* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace pw::log_rpc
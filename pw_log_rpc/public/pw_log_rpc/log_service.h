@@ -31,8 +31,9 @@ class LogService final : public log::pw_rpc::raw::Logs::Service<LogService> {
   // ignored if the channel was not pre-registered in the drain map. If there is
   // an existent stream of logs for the given channel and previous writer, the
   // writer in this call is closed without finishing the RPC call and the log
-  // stream using the previous writer continues.
-  void Listen(ConstByteSpan, rpc::RawServerWriter& writer);
+  // stream using the previous writer continues. Entries are sent in the compact
+  // encoding if the LogRequest sets compact_entries.
+  void Listen(ConstByteSpan request, rpc::RawServerWriter& writer);
 
  private:
   RpcLogDrainMap& drains_;
@@ -52,6 +52,10 @@ namespace pw::log_rpc {
 // sending a drop count.
 // Note: the error handling and drop count reporting might change in the future.
 // Log filtering is done using the rules of the Filter provided if any.
+//
+// When opened with LogEntryEncoding::kCompact, each LogEntries message carries
+// one absolute timestamp followed by time deltas, and the flags and module are
+// only sent when they change. See LogEntries in pw_log/log.proto.
 class RpcLogDrain : public multisink::MultiSink::Drain {
  public:
   // Dictates how to handle server writer errors.
@@ -60,6 +64,14 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
     kCloseStreamOnWriterError,
   };
 
+  // How log entries are encoded in each outgoing LogEntries message.
+  enum class LogEntryEncoding {
+    // Entries are sent as stored in the MultiSink.
+    kFull,
+    // Entries are delta encoded against the previous entry in the message.
+    kCompact,
+  };
+
   // The minimum buffer size, without the message payload or module sizes,
   // needed to retrieve a log::pwpb::LogEntry from the attached MultiSink. The
   // user must account for the max message size to avoid log entry drops. The
@@ -123,6 +135,7 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
       : channel_id_(channel_id),
         error_handling_(error_handling),
         server_writer_(),
+        encoding_(LogEntryEncoding::kFull),
         log_entry_buffer_(log_entry_buffer),
         drop_count_ingress_error_(0),
         drop_count_slow_drain_(0),
@@ -144,13 +157,15 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
   RpcLogDrain& operator=(const RpcLogDrain&) = delete;
 
   // Configures the drain with a new open server writer if the current one is
-  // not open.
+  // not open. Entries are sent to the writer with the given encoding.
   //
   // Return values:
   // OK - Successfully set the new open writer.
   // FAILED_PRECONDITION - The given writer is not open.
   // ALREADY_EXISTS - an open writer is already set.
-  Status Open(rpc::RawServerWriter& writer) PW_LOCKS_EXCLUDED(mutex_);
+  Status Open(rpc::RawServerWriter& writer,
+              LogEntryEncoding encoding = LogEntryEncoding::kFull)
+      PW_LOCKS_EXCLUDED(mutex_);
 
   // Accesses log entries and sends them via the writer. Expected to be called
   // frequently to avoid log drops. If the writer fails to send a packet with
@@ -219,6 +234,7 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
   const uint32_t channel_id_;
   const LogDrainErrorHandling error_handling_;
   rpc::RawServerWriter server_writer_ PW_GUARDED_BY(mutex_);
+  LogEntryEncoding encoding_ PW_GUARDED_BY(mutex_);
   const ByteSpan log_entry_buffer_ PW_GUARDED_BY(mutex_);
   uint32_t drop_count_ingress_error_ PW_GUARDED_BY(mutex_);
   uint32_t drop_count_slow_drain_ PW_GUARDED_BY(mutex_);
@@ -35,13 +35,28 @@ namespace pw::log_rpc {
 // manages multiple log streams. It is a suitable option when a minimal
 // thread count is desired but comes with the cost of individual log streams
 // blocking each other's flushing.
+//
+// To keep a slow log stream from delaying the others, split the drains into
+// groups and flush each group with its own RpcLogDrainThread, running on its
+// own thread.
 class RpcLogDrainThread : public thread::ThreadCore,
                           public multisink::MultiSink::Listener {
  public:
+  // Flushes all of the drains in drain_map.
   RpcLogDrainThread(multisink::MultiSink& multisink,
                     RpcLogDrainMap& drain_map,
                     span<std::byte> encoding_buffer)
+      : RpcLogDrainThread(
+            multisink, drain_map, drain_map.drains(), encoding_buffer) {}
+
+  // Flushes only the given group of drains from drain_map. Each drain must be
+  // flushed by exactly one RpcLogDrainThread.
+  RpcLogDrainThread(multisink::MultiSink& multisink,
+                    RpcLogDrainMap& drain_map,
+                    span<RpcLogDrain> drains,
+                    span<std::byte> encoding_buffer)
       : drain_map_(drain_map),
+        drains_(drains),
         multisink_(multisink),
         encoding_buffer_(encoding_buffer) {}
 
@@ -51,7 +66,7 @@ class RpcLogDrainThread : public thread::ThreadCore,
 
   // Sequentially flushes each log stream.
   void Run() override {
-    for (auto& drain : drain_map_.drains()) {
+    for (auto& drain : drains_) {
       multisink_.AttachDrain(drain);
       drain.set_on_open_callback(
           [this]() { this->ready_to_flush_notification_.release(); });
@@ -67,9 +82,12 @@ class RpcLogDrainThread : public thread::ThreadCore,
       } else {
         ready_to_flush_notification_.acquire();
       }
+      // Rearm before flushing, so that entries added while flushing notify
+      // this thread again when listener notifications are coalesced.
+      multisink_.RearmListener(*this);
       drains_pending = false;
       min_delay = std::nullopt;
-      for (auto& drain : drain_map_.drains()) {
+      for (auto& drain : drains_) {
         std::optional<chrono::SystemClock::duration> drain_ready_in =
             drain.Trickle(encoding_buffer_);
         if (drain_ready_in.has_value()) {
@@ -82,21 +100,25 @@ class RpcLogDrainThread : public thread::ThreadCore,
   }
 
   // Opens a server writer to set up an unrequested log stream.
-  Status OpenUnrequestedLogStream(uint32_t channel_id,
-                                  rpc::Server& rpc_server,
-                                  LogService& log_service) {
+  Status OpenUnrequestedLogStream(
+      uint32_t channel_id,
+      rpc::Server& rpc_server,
+      LogService& log_service,
+      RpcLogDrain::LogEntryEncoding encoding =
+          RpcLogDrain::LogEntryEncoding::kFull) {
     rpc::RawServerWriter writer =
         rpc::RawServerWriter::Open<log::pw_rpc::raw::Logs::Listen>(
             rpc_server, channel_id, log_service);
     const Result<RpcLogDrain*> drain =
         drain_map_.GetDrainFromChannelId(channel_id);
     PW_TRY(drain.status());
-    return drain.value()->Open(writer);
+    return drain.value()->Open(writer, encoding);
   }
 
  private:
   sync::TimedThreadNotification ready_to_flush_notification_;
   RpcLogDrainMap& drain_map_;
+  const span<RpcLogDrain> drains_;
   multisink::MultiSink& multisink_;
   span<std::byte> encoding_buffer_;
 };
@@ -108,6 +130,12 @@ class RpcLogDrainThreadWithBuffer final : public RpcLogDrainThread {
                               RpcLogDrainMap& drain_map)
       : RpcLogDrainThread(multisink, drain_map, encoding_buffer_array_) {}
 
+  RpcLogDrainThreadWithBuffer(multisink::MultiSink& multisink,
+                              RpcLogDrainMap& drain_map,
+                              span<RpcLogDrain> drains)
+      : RpcLogDrainThread(
+            multisink, drain_map, drains, encoding_buffer_array_) {}
+
  private:
   static_assert(kEncodingBufferSizeBytes >=
                     RpcLogDrain::kLogEntriesEncodeFrameSize +
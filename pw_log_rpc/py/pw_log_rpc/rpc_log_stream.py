@@ -30,13 +30,19 @@ class LogStreamHandler:
     Args:
         rpcs: RPC services to request RPC Log Streams.
         decoder: LogStreamDecoder
+        compact_entries: Requests compact LogEntries, which omit unchanged
+          metadata and delta encode timestamps.
     """
 
     def __init__(
-        self, rpcs: pw_rpc.client.Services, decoder: LogStreamDecoder
+        self,
+        rpcs: pw_rpc.client.Services,
+        decoder: LogStreamDecoder,
+        compact_entries: bool = False,
     ) -> None:
         self.rpcs = rpcs
         self._decoder = decoder
+        self._compact_entries = compact_entries
 
     def listen_to_logs(self) -> None:
         """Requests Logs streamed over RPC.
@@ -49,6 +55,7 @@ class LogStreamHandler:
             self._decoder.parse_log_entries_proto(log_entries_proto)
 
         self.rpcs.pw.log.Logs.Listen.open(
+            request=log_pb2.LogRequest(compact_entries=self._compact_entries),
             on_next=on_log_entries,
             on_completed=lambda _, status: self.handle_log_stream_completed(
                 status
@@ -14,6 +14,8 @@
 
 #include "pw_log_rpc/rpc_log_drain.h"
 
+#include <algorithm>
+#include <array>
 #include <limits>
 #include <mutex>
 #include <optional>
@@ -22,11 +24,14 @@
 #include "pw_assert/check.h"
 #include "pw_chrono/system_clock.h"
 #include "pw_log/proto/log.pwpb.h"
+#include "pw_log_rpc/internal/config.h"
+#include "pw_protobuf/decoder.h"
 #include "pw_result/result.h"
 #include "pw_rpc/raw/server_reader_writer.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
 #include "pw_status/try.h"
+#include "pw_stream/null_stream.h"
 
 namespace pw::log_rpc {
 namespace {
@@ -58,9 +63,165 @@ void TryEncodeDropMessage(
   }
 }
 
+namespace LogEntry = ::pw::log::pwpb::LogEntry;
+
+// The fields of a LogEntry stored in the MultiSink. Unknown fields are not
+// forwarded in compact LogEntries.
+struct LogEntryFields {
+  std::optional<ConstByteSpan> message;
+  std::optional<uint32_t> line_level;
+  uint32_t flags = 0;
+  std::optional<int64_t> timestamp;
+  std::optional<int64_t> time_since_last_entry;
+  std::optional<uint32_t> dropped;
+  ConstByteSpan module;
+  std::optional<ConstByteSpan> file;
+  std::optional<ConstByteSpan> thread;
+};
+
+// What the receiver of a compact LogEntries message knows about the previous
+// entry in the message.
+struct CompactEntryState {
+  bool has_timestamp = false;
+  int64_t timestamp = 0;
+  bool flags_known = true;
+  uint32_t flags = 0;
+  bool module_known = true;
+  size_t module_size = 0;
+  std::array<std::byte, cfg::kMaxCompactModuleNameBytes> module{};
+};
+
+Status DecodeLogEntryFields(ConstByteSpan entry, LogEntryFields& fields) {
+  protobuf::Decoder decoder(entry);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (static_cast<LogEntry::Fields>(decoder.FieldNumber())) {
+      case LogEntry::Fields::kMessage:
+        PW_TRY(decoder.ReadBytes(&fields.message.emplace()));
+        break;
+      case LogEntry::Fields::kLineLevel:
+        PW_TRY(decoder.ReadUint32(&fields.line_level.emplace()));
+        break;
+      case LogEntry::Fields::kFlags:
+        PW_TRY(decoder.ReadUint32(&fields.flags));
+        break;
+      case LogEntry::Fields::kTimestamp:
+        PW_TRY(decoder.ReadInt64(&fields.timestamp.emplace()));
+        fields.time_since_last_entry.reset();
+        break;
+      case LogEntry::Fields::kTimeSinceLastEntry:
+        PW_TRY(decoder.ReadInt64(&fields.time_since_last_entry.emplace()));
+        fields.timestamp.reset();
+        break;
+      case LogEntry::Fields::kDropped:
+        PW_TRY(decoder.ReadUint32(&fields.dropped.emplace()));
+        break;
+      case LogEntry::Fields::kModule:
+        PW_TRY(decoder.ReadBytes(&fields.module));
+        break;
+      case LogEntry::Fields::kFile:
+        PW_TRY(decoder.ReadBytes(&fields.file.emplace()));
+        break;
+      case LogEntry::Fields::kThread:
+        PW_TRY(decoder.ReadBytes(&fields.thread.emplace()));
+        break;
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : status;
+}
+
+// Encodes an entry relative to the previous entry described by `state`, and
+// updates `state` to describe this entry.
+Status WriteCompactEntry(const LogEntryFields& fields,
+                         CompactEntryState& state,
+                         LogEntry::StreamEncoder& encoder) {
+  // Drop messages are standalone, so they are sent as is.
+  const bool standalone = fields.dropped.has_value();
+
+  if (fields.message.has_value()) {
+    encoder.WriteMessage(*fields.message).IgnoreError();
+  }
+  if (fields.line_level.has_value()) {
+    encoder.WriteLineLevel(*fields.line_level).IgnoreError();
+  }
+
+  if (standalone) {
+    if (fields.flags != 0) {
+      encoder.WriteFlags(fields.flags).IgnoreError();
+    }
+  } else if (!state.flags_known || fields.flags != state.flags) {
+    encoder.WriteFlags(fields.flags).IgnoreError();
+    state.flags_known = true;
+    state.flags = fields.flags;
+  }
+
+  if (fields.time_since_last_entry.has_value()) {
+    encoder.WriteTimeSinceLastEntry(*fields.time_since_last_entry)
+        .IgnoreError();
+    // A relative timestamp only gives a known time if the receiver already
+    // has an absolute timestamp to add it to.
+    if (!standalone && state.has_timestamp) {
+      state.timestamp += *fields.time_since_last_entry;
+    }
+  } else if (fields.timestamp.has_value()) {
+    const int64_t timestamp = *fields.timestamp;
+    if (!standalone && state.has_timestamp && timestamp >= state.timestamp) {
+      encoder.WriteTimeSinceLastEntry(timestamp - state.timestamp)
+          .IgnoreError();
+    } else {
+      encoder.WriteTimestamp(timestamp).IgnoreError();
+    }
+    if (!standalone) {
+      state.timestamp = timestamp;
+      state.has_timestamp = true;
+    }
+  }
+
+  if (fields.dropped.has_value()) {
+    encoder.WriteDropped(*fields.dropped).IgnoreError();
+  }
+
+  if (standalone) {
+    if (!fields.module.empty()) {
+      encoder.WriteModule(fields.module).IgnoreError();
+    }
+  } else if (!state.module_known ||
+             !std::equal(fields.module.begin(),
+                         fields.module.end(),
+                         state.module.begin(),
+                         state.module.begin() + state.module_size)) {
+    encoder.WriteModule(fields.module).IgnoreError();
+    // Modules too long to remember are resent with the next entry.
+    state.module_known = fields.module.size() <= state.module.size();
+    if (state.module_known) {
+      std::copy(
+          fields.module.begin(), fields.module.end(), state.module.begin());
+      state.module_size = fields.module.size();
+    }
+  }
+
+  if (fields.file.has_value()) {
+    encoder.WriteFile(*fields.file).IgnoreError();
+  }
+  if (fields.thread.has_value()) {
+    encoder.WriteThread(*fields.thread).IgnoreError();
+  }
+  return encoder.status();
+}
+
+// Returns the size of the entry WriteCompactEntry() would encode.
+size_t CompactEntrySize(const LogEntryFields& fields,
+                        CompactEntryState state) {
+  stream::CountingNullStream counter;
+  LogEntry::StreamEncoder encoder(counter, ByteSpan());
+  WriteCompactEntry(fields, state, encoder).IgnoreError();
+  return counter.bytes_written();
+}
+
 }  // namespace
 
-Status RpcLogDrain::Open(rpc::RawServerWriter& writer) {
+Status RpcLogDrain::Open(rpc::RawServerWriter& writer,
+                         LogEntryEncoding encoding) {
   if (!writer.active()) {
     return Status::FailedPrecondition();
   }
@@ -69,6 +230,7 @@ Status RpcLogDrain::Open(rpc::RawServerWriter& writer) {
     return Status::AlreadyExists();
   }
   server_writer_ = std::move(writer);
+  encoding_ = encoding;
 
   // Set a callback to close the drain when RequestCompletion() is requested by
   // the reader. This callback is only set and invoked if
@@ -133,6 +295,10 @@ RpcLogDrain::LogDrainState RpcLogDrain::SendLogs(size_t max_num_bundles,
       continue;
     }
 
+    if (encoding_ == LogEntryEncoding::kCompact) {
+      encoder.WriteCompactEntries(true).IgnoreError();
+    }
+
     encoder.WriteFirstEntrySequenceId(sequence_id_)
         .IgnoreError();  // TODO(b/242598609): Handle Status properly
     sequence_id_ += packed_entry_count;
@@ -155,6 +321,7 @@ RpcLogDrain::LogDrainState RpcLogDrain::EncodeOutgoingPacket(
     log::pwpb::LogEntries::MemoryEncoder& encoder,
     uint32_t& packed_entry_count_out) {
   const size_t total_buffer_size = encoder.ConservativeWriteLimit();
+  CompactEntryState compact_state;
   do {
     // Peek entry and get drop count from multisink.
     uint32_t drop_count = 0;
@@ -249,16 +416,36 @@ RpcLogDrain::LogDrainState RpcLogDrain::EncodeOutgoingPacket(
                       .status());
     }
 
+    // Entries that cannot be decoded are sent as is. The receiver cannot rely
+    // on them, so the next entry is sent in full.
+    LogEntryFields fields;
+    const bool compact =
+        encoding_ == LogEntryEncoding::kCompact &&
+        DecodeLogEntryFields(possible_entry.value().entry(), fields).ok();
+    const size_t packed_entry_size =
+        compact ? CompactEntrySize(fields, compact_state) +
+                      kLogEntriesEncodeFrameSize
+                : encoded_entry_size;
+
     // Check if the entry fits in the partially filled encoder buffer.
-    if (encoded_entry_size > encoder.ConservativeWriteLimit()) {
+    if (packed_entry_size > encoder.ConservativeWriteLimit()) {
       // Notify the caller there are more entries to send.
       return LogDrainState::kMoreEntriesRemaining;
     }
 
     // Encode the entry and remove it from multisink.
-    PW_CHECK_OK(encoder.WriteBytes(
-        static_cast<uint32_t>(log::pwpb::LogEntries::Fields::kEntries),
-        possible_entry.value().entry()));
+    if (compact) {
+      LogEntry::StreamEncoder entry_encoder = encoder.GetEntriesEncoder();
+      PW_CHECK_OK(WriteCompactEntry(fields, compact_state, entry_encoder));
+    } else {
+      PW_CHECK_OK(encoder.WriteBytes(
+          static_cast<uint32_t>(log::pwpb::LogEntries::Fields::kEntries),
+          possible_entry.value().entry()));
+      compact_state.has_timestamp = false;
+      compact_state.flags_known = false;
+      compact_state.module_known = false;
+    }
+    PW_CHECK_OK(encoder.status());
     PW_CHECK_OK(PopEntry(possible_entry.value()));
     ++packed_entry_count_out;
   } while (true);
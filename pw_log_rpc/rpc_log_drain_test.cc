@@ -16,6 +16,7 @@
 
 #include <array>
 #include <cstdint>
+#include <optional>
 #include <string_view>
 
 #include "gtest/gtest.h"
@@ -311,6 +312,207 @@ TEST_F(TrickleTest, EntriesAreFlushedToSinglePayload) {
   EXPECT_EQ(entries_count, 3u);
 }
 
+// Fields of a compact LogEntry that may be inherited from the previous entry.
+struct CompactLogEntry {
+  std::optional<uint32_t> flags;
+  std::optional<int64_t> timestamp;
+  std::optional<int64_t> time_since_last_entry;
+  std::optional<ConstByteSpan> module;
+};
+
+CompactLogEntry DecodeCompactLogEntry(ConstByteSpan entry) {
+  CompactLogEntry fields;
+  protobuf::Decoder decoder(entry);
+  while (decoder.Next().ok()) {
+    switch (static_cast<log::pwpb::LogEntry::Fields>(decoder.FieldNumber())) {
+      case log::pwpb::LogEntry::Fields::kFlags:
+        EXPECT_EQ(decoder.ReadUint32(&fields.flags.emplace()), OkStatus());
+        break;
+      case log::pwpb::LogEntry::Fields::kTimestamp:
+        EXPECT_EQ(decoder.ReadInt64(&fields.timestamp.emplace()), OkStatus());
+        break;
+      case log::pwpb::LogEntry::Fields::kTimeSinceLastEntry:
+        EXPECT_EQ(decoder.ReadInt64(&fields.time_since_last_entry.emplace()),
+                  OkStatus());
+        break;
+      case log::pwpb::LogEntry::Fields::kModule:
+        EXPECT_EQ(decoder.ReadBytes(&fields.module.emplace()), OkStatus());
+        break;
+      default:
+        break;
+    }
+  }
+  return fields;
+}
+
+TEST_F(TrickleTest, CompactEntriesOnlySendChanges) {
+  AttachDrain();
+  OpenWriter();
+
+  TestLogEntry first = BasicLog("first");
+  TestLogEntry second = BasicLog("second");
+  second.timestamp = kSampleTimestamp + 5;
+  TestLogEntry third = BasicLog("third");
+  third.metadata =
+      log_tokenized::Metadata::Set<PW_LOG_LEVEL_INFO, 123, 0, 300>();
+  third.timestamp = kSampleTimestamp + 12;
+  AddLogEntries(Vector<TestLogEntry, 3>{first, second, third});
+
+  ASSERT_TRUE(writer_.active());
+  EXPECT_EQ(
+      drains_[0].Open(writer_, RpcLogDrain::LogEntryEncoding::kCompact),
+      OkStatus());
+  EXPECT_FALSE(drains_[0].Trickle(channel_encode_buffer_).has_value());
+
+  rpc::PayloadsView payloads =
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId);
+  ASSERT_EQ(payloads.size(), 1u);
+
+  Vector<CompactLogEntry, 3> entries;
+  bool compact_entries = false;
+  protobuf::Decoder payload_decoder(payloads[0]);
+  while (payload_decoder.Next().ok()) {
+    switch (static_cast<log::pwpb::LogEntries::Fields>(
+        payload_decoder.FieldNumber())) {
+      case log::pwpb::LogEntries::Fields::kEntries: {
+        ConstByteSpan entry;
+        ASSERT_EQ(payload_decoder.ReadBytes(&entry), OkStatus());
+        ASSERT_FALSE(entries.full());
+        entries.push_back(DecodeCompactLogEntry(entry));
+      } break;
+      case log::pwpb::LogEntries::Fields::kCompactEntries:
+        ASSERT_EQ(payload_decoder.ReadBool(&compact_entries), OkStatus());
+        break;
+      default:
+        break;
+    }
+  }
+  EXPECT_TRUE(compact_entries);
+  ASSERT_EQ(entries.size(), 3u);
+
+  // The first entry is sent in full.
+  EXPECT_EQ(entries[0].flags, kSampleMetadata.flags());
+  EXPECT_EQ(entries[0].timestamp, static_cast<int64_t>(kSampleTimestamp));
+  EXPECT_TRUE(entries[0].module.has_value());
+
+  // The second entry only differs in the timestamp.
+  EXPECT_FALSE(entries[1].flags.has_value());
+  EXPECT_FALSE(entries[1].timestamp.has_value());
+  EXPECT_EQ(entries[1].time_since_last_entry, 5);
+  EXPECT_FALSE(entries[1].module.has_value());
+
+  // Flags that change to zero are sent explicitly.
+  EXPECT_EQ(entries[2].flags, 0u);
+  EXPECT_EQ(entries[2].time_since_last_entry, 7);
+  EXPECT_FALSE(entries[2].module.has_value());
+}
+
+TEST_F(TrickleTest, CompactEntriesOnlyStartFromAbsoluteTimestamps) {
+  AttachDrain();
+  OpenWriter();
+
+  // The first entry only has a time relative to an entry the receiver of the
+  // drain never saw.
+  std::array<std::byte, kMaxMessageSize> relative_buffer;
+  log::pwpb::LogEntry::MemoryEncoder relative(relative_buffer);
+  ASSERT_EQ(relative.WriteMessage(as_bytes(span("relative"))), OkStatus());
+  ASSERT_EQ(relative.WriteTimeSinceLastEntry(3), OkStatus());
+  multisink_.HandleEntry(ConstByteSpan(relative.data(), relative.size()));
+
+  TestLogEntry second = BasicLog("second");
+  TestLogEntry third = BasicLog("third");
+  third.timestamp = kSampleTimestamp + 5;
+  AddLogEntries(Vector<TestLogEntry, 2>{second, third});
+
+  ASSERT_TRUE(writer_.active());
+  EXPECT_EQ(
+      drains_[0].Open(writer_, RpcLogDrain::LogEntryEncoding::kCompact),
+      OkStatus());
+  EXPECT_FALSE(drains_[0].Trickle(channel_encode_buffer_).has_value());
+
+  rpc::PayloadsView payloads =
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId);
+  ASSERT_EQ(payloads.size(), 1u);
+
+  Vector<CompactLogEntry, 3> entries;
+  protobuf::Decoder payload_decoder(payloads[0]);
+  while (payload_decoder.Next().ok()) {
+    if (static_cast<log::pwpb::LogEntries::Fields>(
+            payload_decoder.FieldNumber()) ==
+        log::pwpb::LogEntries::Fields::kEntries) {
+      ConstByteSpan entry;
+      ASSERT_EQ(payload_decoder.ReadBytes(&entry), OkStatus());
+      ASSERT_FALSE(entries.full());
+      entries.push_back(DecodeCompactLogEntry(entry));
+    }
+  }
+  ASSERT_EQ(entries.size(), 3u);
+
+  EXPECT_FALSE(entries[0].timestamp.has_value());
+  EXPECT_EQ(entries[0].time_since_last_entry, 3);
+
+  // The relative time does not give a base for the next entry, so it is sent
+  // with its absolute timestamp.
+  EXPECT_EQ(entries[1].timestamp, static_cast<int64_t>(kSampleTimestamp));
+  EXPECT_FALSE(entries[1].time_since_last_entry.has_value());
+
+  EXPECT_FALSE(entries[2].timestamp.has_value());
+  EXPECT_EQ(entries[2].time_since_last_entry, 5);
+}
+
+TEST_F(TrickleTest, CompactEntriesRestartEachPayload) {
+  AttachDrain();
+  OpenWriter();
+
+  Vector<TestLogEntry, 6> kExpectedEntries{
+      BasicLog("Use longer logs in this test"),
+      BasicLog("My feet are cold"),
+      BasicLog("I'm hungry, what's for dinner?"),
+      BasicLog("Add a few longer logs"),
+      BasicLog("Eventually the logs will"),
+      BasicLog("Overflow into another payload")};
+  AddLogEntries(kExpectedEntries);
+
+  ASSERT_TRUE(writer_.active());
+  EXPECT_EQ(
+      drains_[0].Open(writer_, RpcLogDrain::LogEntryEncoding::kCompact),
+      OkStatus());
+  EXPECT_FALSE(drains_[0].Trickle(channel_encode_buffer_).has_value());
+
+  rpc::PayloadsView payloads =
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId);
+  ASSERT_GE(payloads.size(), 1u);
+
+  // Every payload starts with an absolute timestamp and the full metadata.
+  size_t total_entries = 0;
+  for (ConstByteSpan payload : payloads) {
+    protobuf::Decoder payload_decoder(payload);
+    bool first_entry = true;
+    while (payload_decoder.Next().ok()) {
+      if (static_cast<log::pwpb::LogEntries::Fields>(
+              payload_decoder.FieldNumber()) !=
+          log::pwpb::LogEntries::Fields::kEntries) {
+        continue;
+      }
+      ConstByteSpan entry;
+      ASSERT_EQ(payload_decoder.ReadBytes(&entry), OkStatus());
+      const CompactLogEntry fields = DecodeCompactLogEntry(entry);
+      if (first_entry) {
+        EXPECT_EQ(fields.timestamp, static_cast<int64_t>(kSampleTimestamp));
+        EXPECT_EQ(fields.flags, kSampleMetadata.flags());
+        EXPECT_TRUE(fields.module.has_value());
+      } else {
+        EXPECT_EQ(fields.time_since_last_entry, 0);
+        EXPECT_FALSE(fields.flags.has_value());
+        EXPECT_FALSE(fields.module.has_value());
+      }
+      first_entry = false;
+      ++total_entries;
+    }
+  }
+  EXPECT_EQ(total_entries, kExpectedEntries.size());
+}
+
 TEST_F(TrickleTest, ManyLogsOverflowToNextPayload) {
   AttachDrain();
   OpenWriter();
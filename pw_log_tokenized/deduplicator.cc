@@ -0,0 +1,150 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "pw_log_tokenized"
+
+#include "pw_log_tokenized/deduplicator.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_log_tokenized/config.h"
+#include "pw_tokenizer/base64.h"
+#include "pw_tokenizer/encode_args.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::log_tokenized {
+namespace {
+
+// The original message is nested in the summary as prefixed Base64, which
+// detokenizers expand recursively.
+constexpr size_t kNestedMessageSize =
+    tokenizer::Base64EncodedBufferSize(Deduplicator::kMaxMessageSizeBytes);
+
+}  // namespace
+
+void Deduplicator::HandleLog(uint32_t metadata, span<const uint8_t> message) {
+  sequence_ += 1;
+
+  // Output summaries for messages that stopped repeating and forget them.
+  for (Entry& entry : entries_) {
+    if (entry.in_use && sequence_ - entry.last_seen > window_) {
+      OutputRepeats(entry);
+      entry.in_use = false;
+    }
+  }
+
+  if (message.size() > kMaxMessageSizeBytes || entries_.empty()) {
+    output_(metadata, message);
+    return;
+  }
+
+  const uint32_t hash = Hash(metadata, message);
+  for (Entry& entry : entries_) {
+    if (entry.in_use && entry.hash == hash && entry.metadata == metadata &&
+        entry.size == message.size() &&
+        std::memcmp(entry.message.data(), message.data(), message.size()) ==
+            0) {
+      entry.last_seen = sequence_;
+      entry.repeats += 1;
+      if (entry.repeats >= max_repeats_) {
+        OutputRepeats(entry);
+      }
+      return;
+    }
+  }
+
+  Entry& entry = Evict();
+  entry.in_use = true;
+  entry.size = message.size();
+  entry.hash = hash;
+  entry.metadata = metadata;
+  entry.last_seen = sequence_;
+  entry.repeats = 0;
+  std::memcpy(entry.message.data(), message.data(), message.size());
+
+  output_(metadata, message);
+}
+
+void Deduplicator::Flush() {
+  for (Entry& entry : entries_) {
+    if (entry.in_use) {
+      OutputRepeats(entry);
+      entry.in_use = false;
+    }
+  }
+}
+
+uint32_t Deduplicator::Hash(uint32_t metadata, span<const uint8_t> message) {
+  // 32-bit FNV-1a over the metadata and message.
+  uint32_t hash = 2166136261u;
+  const auto add = [&hash](uint8_t byte) {
+    hash = (hash ^ byte) * 16777619u;
+  };
+
+  for (int shift = 0; shift < 32; shift += 8) {
+    add(static_cast<uint8_t>(metadata >> shift));
+  }
+  for (uint8_t byte : message) {
+    add(byte);
+  }
+  return hash;
+}
+
+void Deduplicator::OutputRepeats(Entry& entry) {
+  if (entry.repeats == 0u) {
+    return;
+  }
+
+  constexpr pw_tokenizer_Token kToken = PW_TOKENIZE_STRING(
+      PW_LOG_TOKENIZED_FORMAT_STRING("%s repeated %u more times"));
+
+  char nested[kNestedMessageSize];
+  tokenizer::PrefixedBase64Encode(span(entry.message.data(), entry.size),
+                                  nested);
+
+  std::array<std::byte,
+             tokenizer::MinEncodingBufferSizeBytes<const char*, uint32_t>() +
+                 sizeof(nested)>
+      summary;
+  std::memcpy(summary.data(), &kToken, sizeof(kToken));
+  const size_t size =
+      sizeof(kToken) +
+      tokenizer::EncodeArgs(span(summary).subspan(sizeof(kToken)),
+                            static_cast<const char*>(nested),
+                            entry.repeats);
+
+  entry.repeats = 0;
+  output_(entry.metadata,
+          span(reinterpret_cast<const uint8_t*>(summary.data()), size));
+}
+
+Deduplicator::Entry& Deduplicator::Evict() {
+  Entry* oldest = nullptr;
+  for (Entry& entry : entries_) {
+    if (!entry.in_use) {
+      return entry;
+    }
+    if (oldest == nullptr ||
+        sequence_ - entry.last_seen > sequence_ - oldest->last_seen) {
+      oldest = &entry;
+    }
+  }
+
+  OutputRepeats(*oldest);
+  oldest->in_use = false;
+  return *oldest;
+}
+
+}  // namespace pw::log_tokenized
@@ -0,0 +1,177 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_tokenized/deduplicator.h"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_containers/vector.h"
+#include "pw_tokenizer/base64.h"
+
+namespace pw::log_tokenized {
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+struct Log {
+  uint32_t metadata;
+  Vector<uint8_t, 128> message;
+};
+
+span<const uint8_t> Bytes(std::string_view data) {
+  return span(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+constexpr std::string_view kFirst = "\x01\x00\x00\x00\x02"sv;
+constexpr std::string_view kSecond = "\x02\x00\x00\x00\x04"sv;
+constexpr std::string_view kThird = "\x03\x00\x00\x00"sv;
+
+class DeduplicatorTest : public ::testing::Test {
+ protected:
+  DeduplicatorTest()
+      : deduplicator_(
+            entries_,
+            [this](uint32_t metadata, span<const uint8_t> message) {
+              logs_.emplace_back();
+              logs_.back().metadata = metadata;
+              logs_.back().message.assign(message.begin(), message.end());
+            },
+            /*window=*/4,
+            /*max_repeats=*/10) {}
+
+  void Handle(std::string_view message, uint32_t metadata = 0) {
+    deduplicator_.HandleLog(metadata, Bytes(message));
+  }
+
+  bool IsMessage(const Log& log, std::string_view message) const {
+    return log.message.size() == message.size() &&
+           std::memcmp(log.message.data(), message.data(), message.size()) ==
+               0;
+  }
+
+  // Checks that a log is a summary for the message and returns the count.
+  uint32_t SummaryCount(const Log& log, std::string_view message) const {
+    // The summary is a token, a string argument, and an integer argument.
+    EXPECT_GT(log.message.size(), 5u);
+    const size_t string_size = log.message[4] & 0x7Fu;
+    const std::string_view nested(
+        reinterpret_cast<const char*>(log.message.data()) + 5, string_size);
+
+    std::array<std::byte, 64> decoded;
+    const size_t decoded_size =
+        tokenizer::PrefixedBase64Decode(nested, decoded);
+    EXPECT_EQ(decoded_size, message.size());
+    EXPECT_EQ(std::memcmp(decoded.data(), message.data(), message.size()), 0);
+
+    // The count is a zig-zag encoded varint.
+    const size_t count_index = 5 + string_size;
+    EXPECT_EQ(log.message.size(), count_index + 1);
+    return log.message[count_index] / 2u;
+  }
+
+  std::array<Deduplicator::Entry, 2> entries_;
+  Vector<Log, 32> logs_;
+  Deduplicator deduplicator_;
+};
+
+TEST_F(DeduplicatorTest, DifferentMessagesPassThrough) {
+  Handle(kFirst);
+  Handle(kSecond);
+  Handle(kFirst, 1);  // Different metadata
+
+  ASSERT_EQ(logs_.size(), 3u);
+  EXPECT_TRUE(IsMessage(logs_[0], kFirst));
+  EXPECT_TRUE(IsMessage(logs_[1], kSecond));
+  EXPECT_TRUE(IsMessage(logs_[2], kFirst));
+  EXPECT_EQ(logs_[2].metadata, 1u);
+}
+
+TEST_F(DeduplicatorTest, DifferentArgumentsPassThrough) {
+  Handle(kFirst);
+  Handle("\x01\x00\x00\x00\x03"sv);
+  ASSERT_EQ(logs_.size(), 2u);
+}
+
+TEST_F(DeduplicatorTest, RepeatsSummarizedAfterWindow) {
+  Handle(kFirst, 7);
+  Handle(kFirst, 7);
+  Handle(kFirst, 7);
+  ASSERT_EQ(logs_.size(), 1u);
+
+  for (int i = 0; i < 5; ++i) {
+    Handle(kSecond);
+  }
+
+  // kFirst, kSecond, then the summary once the window passed.
+  ASSERT_EQ(logs_.size(), 3u);
+  EXPECT_TRUE(IsMessage(logs_[1], kSecond));
+  EXPECT_EQ(logs_[2].metadata, 7u);
+  EXPECT_EQ(SummaryCount(logs_[2], kFirst), 2u);
+
+  // After the window, the message is output again.
+  Handle(kFirst, 7);
+  ASSERT_EQ(logs_.size(), 4u);
+  EXPECT_TRUE(IsMessage(logs_[3], kFirst));
+}
+
+TEST_F(DeduplicatorTest, SummaryEveryMaxRepeats) {
+  for (int i = 0; i < 21; ++i) {
+    Handle(kFirst);
+  }
+
+  ASSERT_EQ(logs_.size(), 3u);
+  EXPECT_TRUE(IsMessage(logs_[0], kFirst));
+  EXPECT_EQ(SummaryCount(logs_[1], kFirst), 10u);
+  EXPECT_EQ(SummaryCount(logs_[2], kFirst), 10u);
+}
+
+TEST_F(DeduplicatorTest, EvictionOutputsSummary) {
+  Handle(kFirst);
+  Handle(kFirst);
+  Handle(kSecond);
+  Handle(kThird);  // Evicts kFirst, the least recently seen.
+
+  ASSERT_EQ(logs_.size(), 4u);
+  EXPECT_TRUE(IsMessage(logs_[1], kSecond));
+  EXPECT_EQ(SummaryCount(logs_[2], kFirst), 1u);
+  EXPECT_TRUE(IsMessage(logs_[3], kThird));
+}
+
+TEST_F(DeduplicatorTest, Flush) {
+  Handle(kFirst);
+  Handle(kFirst);
+  Handle(kSecond);
+  deduplicator_.Flush();
+
+  ASSERT_EQ(logs_.size(), 3u);
+  EXPECT_EQ(SummaryCount(logs_[2], kFirst), 1u);
+
+  // Flushed messages are forgotten.
+  Handle(kSecond);
+  ASSERT_EQ(logs_.size(), 4u);
+  EXPECT_TRUE(IsMessage(logs_[3], kSecond));
+}
+
+TEST_F(DeduplicatorTest, OversizedMessagesPassThrough) {
+  std::array<uint8_t, Deduplicator::kMaxMessageSizeBytes + 1> large{};
+  deduplicator_.HandleLog(0, large);
+  deduplicator_.HandleLog(0, large);
+  EXPECT_EQ(logs_.size(), 2u);
+}
+
+}  // namespace
+}  // namespace pw::log_tokenized
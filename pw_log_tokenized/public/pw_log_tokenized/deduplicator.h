@@ -0,0 +1,119 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pw_function/function.h"
+#include "pw_span/span.h"
+#include "pw_tokenizer/config.h"
+
+namespace pw::log_tokenized {
+
+/// Suppresses repeated tokenized log messages.
+///
+/// A `Deduplicator` sits between `pw_log_tokenized_HandleLog` and the log's
+/// destination. Messages with the same metadata, token, and arguments that
+/// repeat within a window of log messages are suppressed. In their place, a
+/// tokenized `"<message> repeated N more times"` record is output once the
+/// message stops repeating, or every `max_repeats` repeats if it does not. The
+/// summary contains the original message as nested prefixed Base64, so it
+/// detokenizes to the original text and no information is lost.
+///
+/// The window is measured in log messages rather than time, so no clock is
+/// required. Recently seen messages are tracked in a fixed-size table provided
+/// by the caller. When the table is full, the least recently seen message is
+/// evicted.
+///
+/// `Deduplicator` is not thread safe. Call it from a log handler that already
+/// serializes access to its output:
+///
+/// @code{.cpp}
+///   std::array<pw::log_tokenized::Deduplicator::Entry, 8> entries;
+///   pw::log_tokenized::Deduplicator deduplicator(
+///       entries, [](uint32_t metadata, pw::span<const uint8_t> message) {
+///         SendLog(metadata, message);
+///       });
+///
+///   extern "C" void pw_log_tokenized_HandleLog(
+///       uint32_t metadata, const uint8_t message[], size_t size) {
+///     std::lock_guard lock(log_mutex);
+///     deduplicator.HandleLog(metadata, pw::span(message, size));
+///   }
+/// @endcode
+class Deduplicator {
+ public:
+  /// Messages longer than this are passed through without deduplication.
+  static constexpr size_t kMaxMessageSizeBytes =
+      PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES;
+
+  /// Receives messages that are not suppressed and repeat summaries.
+  using Output = Function<void(uint32_t metadata, span<const uint8_t> message)>;
+
+  /// A recently seen log message.
+  class Entry {
+   private:
+    friend class Deduplicator;
+
+    bool in_use = false;
+    size_t size = 0;
+    uint32_t hash = 0;
+    uint32_t metadata = 0;
+    uint32_t last_seen = 0;
+    uint32_t repeats = 0;
+    std::array<uint8_t, kMaxMessageSizeBytes> message{};
+  };
+
+  /// @param entries Table of recently seen messages.
+  /// @param output Called for each message or summary that is output.
+  /// @param window A message stops being suppressed once this many other
+  ///     messages are logged without it repeating.
+  /// @param max_repeats A summary is output after this many repeats, even if
+  ///     the message is still repeating.
+  Deduplicator(span<Entry> entries,
+               Output&& output,
+               uint32_t window = 64,
+               uint32_t max_repeats = 1000)
+      : entries_(entries),
+        output_(std::move(output)),
+        window_(window),
+        max_repeats_(max_repeats) {}
+
+  /// Outputs the message, or counts it as a repeat if it was seen recently.
+  void HandleLog(uint32_t metadata, span<const uint8_t> message);
+
+  /// Outputs summaries for all suppressed repeats and forgets all messages.
+  void Flush();
+
+ private:
+  static uint32_t Hash(uint32_t metadata, span<const uint8_t> message);
+
+  // Outputs the summary for an entry's repeats, if there were any, and resets
+  // its repeat count.
+  void OutputRepeats(Entry& entry);
+
+  // Returns an unused entry, evicting the least recently seen one if needed.
+  Entry& Evict();
+
+  span<Entry> entries_;
+  Output output_;
+  uint32_t window_;
+  uint32_t max_repeats_;
+  uint32_t sequence_ = 0;
+};
+
+}  // namespace pw::log_tokenized
@@ -12,8 +12,12 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <cstring>
+
 #include "pw_allocator/freelist_heap.h"
+#include "pw_allocator/magazine_cache.h"
 #include "pw_malloc/malloc.h"
+#include "pw_malloc_freelist_private/config.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_preprocessor/util.h"
 #include "pw_span/span.h"
@@ -25,6 +29,49 @@ std::aligned_storage_t<sizeof(pw::allocator::FreeListHeapBuffer<>),
 }  // namespace
 pw::allocator::FreeListHeapBuffer<>* pw_freelist_heap;
 
+namespace {
+
+#if PW_MALLOC_FREELIST_THREAD_CACHE_ENABLE
+
+using ThreadCache = pw::allocator::MagazineCache<
+    pw::allocator::FreeListHeapBuffer<>,
+    PW_MALLOC_FREELIST_THREAD_CACHE_NUM_SIZE_CLASSES,
+    PW_MALLOC_FREELIST_THREAD_CACHE_MAGAZINE_CAPACITY,
+    PW_MALLOC_FREELIST_THREAD_CACHE_MIN_SIZE_CLASS>;
+
+// Each thread's cache is created on its first allocation and flushes its
+// blocks back to the heap when the thread exits.
+ThreadCache& GetThreadCache() {
+  thread_local ThreadCache cache(*pw_freelist_heap);
+  return cache;
+}
+
+void* Allocate(size_t size) { return GetThreadCache().Allocate(size); }
+
+void Free(void* ptr) { GetThreadCache().Free(ptr); }
+
+void* Calloc(size_t num, size_t size) {
+  void* ptr = Allocate(num * size);
+  if (ptr != nullptr) {
+    std::memset(ptr, 0, num * size);
+  }
+  return ptr;
+}
+
+#else
+
+void* Allocate(size_t size) { return pw_freelist_heap->Allocate(size); }
+
+void Free(void* ptr) { pw_freelist_heap->Free(ptr); }
+
+void* Calloc(size_t num, size_t size) {
+  return pw_freelist_heap->Calloc(num, size);
+}
+
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE_ENABLE
+
+}  // namespace
+
 #if __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -42,30 +89,26 @@ void pw_MallocInit(uint8_t* heap_low_addr, uint8_t* heap_high_addr) {
 // "__wrap_<function name>" with "<function_name>", and calling
 // "<function name>" will call "__wrap_<function name>" instead
 // Linker options are set in a config in "pw_malloc:pw_malloc_config".
-void* __wrap_malloc(size_t size) { return pw_freelist_heap->Allocate(size); }
+void* __wrap_malloc(size_t size) { return Allocate(size); }
 
-void __wrap_free(void* ptr) { pw_freelist_heap->Free(ptr); }
+void __wrap_free(void* ptr) { Free(ptr); }
 
 void* __wrap_realloc(void* ptr, size_t size) {
   return pw_freelist_heap->Realloc(ptr, size);
 }
 
-void* __wrap_calloc(size_t num, size_t size) {
-  return pw_freelist_heap->Calloc(num, size);
-}
+void* __wrap_calloc(size_t num, size_t size) { return Calloc(num, size); }
 
-void* __wrap__malloc_r(struct _reent*, size_t size) {
-  return pw_freelist_heap->Allocate(size);
-}
+void* __wrap__malloc_r(struct _reent*, size_t size) { return Allocate(size); }
 
-void __wrap__free_r(struct _reent*, void* ptr) { pw_freelist_heap->Free(ptr); }
+void __wrap__free_r(struct _reent*, void* ptr) { Free(ptr); }
 
 void* __wrap__realloc_r(struct _reent*, void* ptr, size_t size) {
   return pw_freelist_heap->Realloc(ptr, size);
 }
 
 void* __wrap__calloc_r(struct _reent*, size_t num, size_t size) {
-  return pw_freelist_heap->Calloc(num, size);
+  return Calloc(num, size);
 }
 #if __cplusplus
 }
@@ -0,0 +1,35 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Whether to put a per-thread cache of small blocks in front of the global
+// heap. Requires toolchain support for thread_local.
+#ifndef PW_MALLOC_FREELIST_THREAD_CACHE_ENABLE
+#define PW_MALLOC_FREELIST_THREAD_CACHE_ENABLE 0
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE_ENABLE
+
+// Number of power-of-two size classes held by each thread cache.
+#ifndef PW_MALLOC_FREELIST_THREAD_CACHE_NUM_SIZE_CLASSES
+#define PW_MALLOC_FREELIST_THREAD_CACHE_NUM_SIZE_CLASSES 4
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE_NUM_SIZE_CLASSES
+
+// Smallest size class, in bytes. Classes double in size from here.
+#ifndef PW_MALLOC_FREELIST_THREAD_CACHE_MIN_SIZE_CLASS
+#define PW_MALLOC_FREELIST_THREAD_CACHE_MIN_SIZE_CLASS 16
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE_MIN_SIZE_CLASS
+
+// Maximum number of freed blocks each size class keeps per thread.
+#ifndef PW_MALLOC_FREELIST_THREAD_CACHE_MAGAZINE_CAPACITY
+#define PW_MALLOC_FREELIST_THREAD_CACHE_MAGAZINE_CAPACITY 8
+#endif  // PW_MALLOC_FREELIST_THREAD_CACHE_MAGAZINE_CAPACITY
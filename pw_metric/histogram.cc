@@ -0,0 +1,104 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/histogram.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "pw_assert/check.h"
+
+namespace pw::metric {
+namespace {
+
+// The bounds of the overflow bucket may not fit in 32 bits.
+uint64_t LowerBound(size_t index, uint8_t sub_bucket_bits) {
+  const size_t sub_buckets = size_t{1} << sub_bucket_bits;
+  if (index < 2 * sub_buckets) {
+    return index;
+  }
+  const size_t shift = index / sub_buckets - 1;
+  return uint64_t{index - shift * sub_buckets} << shift;
+}
+
+}  // namespace
+
+Histogram::Histogram(Token name,
+                     span<std::atomic<uint32_t>> buckets,
+                     uint8_t sub_bucket_bits)
+    : Metric(name, Distribution::kHistogram),
+      buckets_(buckets.data()),
+      num_buckets_(static_cast<uint16_t>(buckets.size())),
+      sub_bucket_bits_(sub_bucket_bits) {
+  PW_DCHECK_UINT_GT(buckets.size(), size_t{2} << sub_bucket_bits);
+}
+
+Histogram::Histogram(Token name,
+                     span<std::atomic<uint32_t>> buckets,
+                     uint8_t sub_bucket_bits,
+                     IntrusiveList<Metric>& metrics)
+    : Histogram(name, buckets, sub_bucket_bits) {
+  metrics.push_front(*this);
+}
+
+uint32_t Histogram::count() const {
+  uint32_t count = 0;
+  for (const std::atomic<uint32_t>& bucket : buckets()) {
+    count += bucket.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+uint32_t Histogram::ValueAtQuantile(float quantile) const {
+  const uint32_t total = count();
+  if (total == 0) {
+    return 0;
+  }
+  // The rank of the value at the quantile, from 1 to the count.
+  const float clamped = std::clamp(quantile, 0.0f, 1.0f);
+  const uint32_t rank = std::max<uint32_t>(
+      1, static_cast<uint32_t>(clamped * static_cast<float>(total) + 0.5f));
+
+  // Buckets may be incremented while counting, so stop at the last bucket.
+  uint32_t seen = 0;
+  size_t index = 0;
+  for (; index < num_buckets_ - 1u; ++index) {
+    seen += buckets_[index].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      break;
+    }
+  }
+  return BucketUpperBound(index);
+}
+
+void Histogram::Reset() {
+  for (size_t i = 0; i < num_buckets_; ++i) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+uint32_t Histogram::BucketLowerBound(size_t index) const {
+  return static_cast<uint32_t>(
+      std::min<uint64_t>(LowerBound(index, sub_bucket_bits_),
+                         std::numeric_limits<uint32_t>::max()));
+}
+
+uint32_t Histogram::BucketUpperBound(size_t index) const {
+  if (index + 1 >= num_buckets_) {
+    return std::numeric_limits<uint32_t>::max();
+  }
+  return static_cast<uint32_t>(LowerBound(index + 1, sub_bucket_bits_) - 1);
+}
+
+}  // namespace pw::metric
@@ -0,0 +1,140 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/histogram.h"
+
+#include <limits>
+
+#include "gtest/gtest.h"
+
+namespace pw::metric {
+namespace {
+
+TEST(Histogram, Type) {
+  TypedHistogram<2, 8> histogram(0xf1223344);
+  EXPECT_EQ(histogram.name(), 0x71223344u);
+  EXPECT_TRUE(histogram.is_histogram());
+  EXPECT_FALSE(histogram.is_int());
+  EXPECT_FALSE(histogram.is_float());
+  EXPECT_FALSE(histogram.is_quantile_sketch());
+}
+
+TEST(Histogram, BucketCount) {
+  // 2^3 exact buckets, 2^2 buckets for each of [8, 16) to [128, 256), and one
+  // overflow bucket.
+  EXPECT_EQ((TypedHistogram<2, 8>::kBuckets), 8u + 5 * 4 + 1);
+  EXPECT_EQ(Histogram::BucketCount(2, 8), 29u);
+  EXPECT_EQ(Histogram::BucketCount(0, 8), 10u);
+}
+
+TEST(Histogram, BucketBounds) {
+  TypedHistogram<2, 8> histogram(0);
+  // Values below 8 are exact.
+  for (uint32_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(histogram.BucketLowerBound(i), i);
+    EXPECT_EQ(histogram.BucketUpperBound(i), i);
+  }
+  // [8, 16) is split in buckets of 2, [16, 32) in buckets of 4, and so on.
+  EXPECT_EQ(histogram.BucketLowerBound(8), 8u);
+  EXPECT_EQ(histogram.BucketUpperBound(8), 9u);
+  EXPECT_EQ(histogram.BucketLowerBound(12), 16u);
+  EXPECT_EQ(histogram.BucketUpperBound(12), 19u);
+  EXPECT_EQ(histogram.BucketUpperBound(27), 255u);
+  EXPECT_EQ(histogram.BucketLowerBound(28), 256u);
+  EXPECT_EQ(histogram.BucketUpperBound(28),
+            std::numeric_limits<uint32_t>::max());
+}
+
+TEST(Histogram, Record_EachValueInItsBucket) {
+  TypedHistogram<2, 8> histogram(0);
+  for (uint32_t value = 0; value < 256; ++value) {
+    histogram.Record(value);
+  }
+  for (size_t i = 0; i + 1 < histogram.buckets().size(); ++i) {
+    EXPECT_EQ(histogram.buckets()[i].load(),
+              histogram.BucketUpperBound(i) - histogram.BucketLowerBound(i) +
+                  1);
+  }
+  EXPECT_EQ(histogram.buckets().back().load(), 0u);
+  EXPECT_EQ(histogram.count(), 256u);
+}
+
+TEST(Histogram, Record_Overflow) {
+  TypedHistogram<2, 8> histogram(0);
+  histogram.Record(256);
+  histogram.Record(std::numeric_limits<uint32_t>::max());
+  EXPECT_EQ(histogram.buckets().back().load(), 2u);
+}
+
+TEST(Histogram, Record_FullRange) {
+  TypedHistogram<0, 32> histogram(0);
+  histogram.Record(std::numeric_limits<uint32_t>::max());
+  EXPECT_EQ(histogram.buckets()[histogram.buckets().size() - 2].load(), 1u);
+  EXPECT_EQ(histogram.BucketUpperBound(histogram.buckets().size() - 2),
+            std::numeric_limits<uint32_t>::max());
+}
+
+TEST(Histogram, ValueAtQuantile) {
+  TypedHistogram<2, 16> histogram(0);
+  EXPECT_EQ(histogram.ValueAtQuantile(0.5f), 0u);
+
+  for (uint32_t value = 1; value <= 1000; ++value) {
+    histogram.Record(value);
+  }
+  // Reported values are the top of their bucket, within 2^-2 of the value.
+  const uint32_t p50 = histogram.ValueAtQuantile(0.5f);
+  EXPECT_GE(p50, 500u);
+  EXPECT_LE(p50, 500u + 500u / 4);
+  const uint32_t p99 = histogram.ValueAtQuantile(0.99f);
+  EXPECT_GE(p99, 990u);
+  EXPECT_LE(p99, 990u + 990u / 4);
+  EXPECT_EQ(histogram.ValueAtQuantile(0.0f), 1u);
+}
+
+TEST(Histogram, ValueAtQuantile_Overflow) {
+  TypedHistogram<2, 8> histogram(0);
+  histogram.Record(1000);
+  EXPECT_EQ(histogram.ValueAtQuantile(0.5f),
+            std::numeric_limits<uint32_t>::max());
+}
+
+TEST(Histogram, Reset) {
+  TypedHistogram<2, 8> histogram(0);
+  histogram.Record(3);
+  histogram.Reset();
+  EXPECT_EQ(histogram.count(), 0u);
+}
+
+TEST(Histogram, FromMacro) {
+  PW_METRIC_GROUP(group, "group");
+  PW_METRIC_HISTOGRAM(group, latency, "latency", 2, 16);
+  PW_METRIC_HISTOGRAM(ungrouped, "ungrouped", 1, 8);
+
+  EXPECT_EQ(group.metrics().size(), 1u);
+  EXPECT_EQ(&group.metrics().front(), &latency);
+  EXPECT_TRUE(ungrouped.is_histogram());
+
+  latency.Record(5);
+  group.Dump();
+}
+
+PW_METRIC_HISTOGRAM_STATIC(static_histogram, "static_histogram", 2, 10);
+
+TEST(Histogram, FromStaticMacro) {
+  static_histogram.Record(1);
+  EXPECT_EQ(static_histogram.count(), 1u);
+}
+
+}  // namespace
+}  // namespace pw::metric
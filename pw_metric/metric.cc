@@ -15,9 +15,12 @@
 #include "pw_metric/metric.h"
 
 #include <array>
+#include <cstring>
 
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
+#include "pw_metric/histogram.h"
+#include "pw_metric/quantile_sketch.h"
 #include "pw_span/span.h"
 #include "pw_tokenizer/base64.h"
 
@@ -60,29 +63,55 @@ Metric::Metric(Token name, uint32_t value, IntrusiveList<Metric>& metrics)
   metrics.push_front(*this);
 }
 
+Metric::Metric(Token name,
+               Distribution distribution,
+               IntrusiveList<Metric>& metrics)
+    : Metric(name, distribution) {
+  metrics.push_front(*this);
+}
+
 float Metric::as_float() const {
   PW_DCHECK(is_float());
-  return float_;
+  const uint32_t bits = shards_[0]->load(std::memory_order_relaxed);
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
 }
 
 uint32_t Metric::as_int() const {
   PW_DCHECK(is_int());
-  return uint_;
+  uint32_t sum = 0;
+  for (const auto& shard : shards_) {
+    sum += shard->load(std::memory_order_relaxed);
+  }
+  return sum;
 }
 
 void Metric::Increment(uint32_t amount) {
   PW_DCHECK(is_int());
-  uint_ += amount;
+  const size_t index = PW_METRIC_CURRENT_SHARD();
+  PW_DCHECK_UINT_LT(index, PW_METRIC_SHARDS);
+  std::atomic<uint32_t>& shard = *shards_[index];
+#if PW_METRIC_ATOMIC_INCREMENT
+  shard.fetch_add(amount, std::memory_order_relaxed);
+#else
+  // Each shard is only incremented by one context at a time.
+  shard.store(shard.load(std::memory_order_relaxed) + amount,
+              std::memory_order_relaxed);
+#endif  // PW_METRIC_ATOMIC_INCREMENT
 }
 
 void Metric::SetInt(uint32_t value) {
   PW_DCHECK(is_int());
-  uint_ = value;
+  shards_[0]->store(value, std::memory_order_relaxed);
+  for (size_t i = 1; i < PW_METRIC_SHARDS; ++i) {
+    shards_[i]->store(0, std::memory_order_relaxed);
+  }
 }
 
 void Metric::SetFloat(float value) {
   PW_DCHECK(is_float());
-  float_ = value;
+  shards_[0]->store(FloatBits(value), std::memory_order_relaxed);
 }
 
 void Metric::Dump(int level) {
@@ -95,6 +124,24 @@ void Metric::Dump(int level) {
                 indent,
                 encoded_name.value(),
                 static_cast<double>(as_float()));
+  } else if (is_histogram()) {
+    const auto& histogram = static_cast<const Histogram&>(*this);
+    PW_LOG_INFO("%s \"%s\": {\"count\": %u, \"p50\": %u, \"p99\": %u},",
+                indent,
+                encoded_name.value(),
+                static_cast<unsigned int>(histogram.count()),
+                static_cast<unsigned int>(histogram.ValueAtQuantile(0.5f)),
+                static_cast<unsigned int>(histogram.ValueAtQuantile(0.99f)));
+  } else if (is_quantile_sketch()) {
+    const QuantileSketch::Snapshot sketch =
+        static_cast<const QuantileSketch&>(*this).GetSnapshot();
+    PW_LOG_INFO(
+        "%s \"%s\": {\"count\": %u, \"quantile\": %f, \"estimate\": %f},",
+        indent,
+        encoded_name.value(),
+        static_cast<unsigned int>(sketch.count),
+        static_cast<double>(sketch.quantile),
+        static_cast<double>(sketch.estimate));
   } else {
     PW_LOG_INFO("%s \"%s\": %u,",
                 indent,
@@ -18,7 +18,10 @@
 
 #include "pw_assert/check.h"
 #include "pw_containers/vector.h"
+#include "pb_encode.h"
+#include "pw_metric/histogram.h"
 #include "pw_metric/metric.h"
+#include "pw_metric/quantile_sketch.h"
 #include "pw_metric_private/metric_walker.h"
 #include "pw_preprocessor/util.h"
 #include "pw_span/span.h"
@@ -26,6 +29,43 @@
 namespace pw::metric {
 namespace {
 
+// Encodes every bucket of the Histogram in arg, since the callback cannot be
+// told where the non-empty buckets start.
+bool EncodeHistogramCounts(pb_ostream_t* stream,
+                           const pb_field_t* field,
+                           void* const* arg) {
+  // Note: nanopb passes the pointer to the arg member, not its contents.
+  const auto& histogram = *static_cast<const Histogram*>(*arg);
+  for (const std::atomic<uint32_t>& bucket : histogram.buckets()) {
+    if (!pb_encode_tag_for_field(stream, field) ||
+        !pb_encode_varint(stream, bucket.load(std::memory_order_relaxed))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void CopyHistogram(const Histogram& histogram,
+                   pw_metric_proto_Histogram& proto_histogram) {
+  proto_histogram.sub_bucket_bits = histogram.sub_bucket_bits();
+  proto_histogram.bucket_count =
+      static_cast<uint32_t>(histogram.buckets().size());
+  proto_histogram.first_bucket = 0;
+  proto_histogram.counts.funcs.encode = EncodeHistogramCounts;
+  proto_histogram.counts.arg = const_cast<Histogram*>(&histogram);
+}
+
+void CopyQuantileSketch(const QuantileSketch& sketch,
+                        pw_metric_proto_QuantileSketch& proto_sketch) {
+  const QuantileSketch::Snapshot snapshot = sketch.GetSnapshot();
+  proto_sketch.quantile = snapshot.quantile;
+  proto_sketch.estimate = snapshot.estimate;
+  proto_sketch.min = snapshot.min;
+  proto_sketch.max = snapshot.max;
+  proto_sketch.count = snapshot.count;
+  proto_sketch.dropped = snapshot.dropped;
+}
+
 class NanopbMetricWriter : public virtual internal::MetricWriter {
  public:
   NanopbMetricWriter(
@@ -38,6 +78,12 @@ class NanopbMetricWriter : public virtual internal::MetricWriter {
   // on transport MTU, rather than having this as a static knob. For example,
   // some transports may be able to fit 30 metrics; others, only 5.
   Status Write(const Metric& metric, const Vector<Token>& path) override {
+    // Histograms may be much larger than other metrics, so each is sent in a
+    // response of its own.
+    if (metric.is_histogram()) {
+      Flush();
+    }
+
     // Nanopb doesn't offer an easy way to do bounds checking, so use span's
     // type deduction magic to figure out the max size.
     span<pw_metric_proto_Metric> metrics(response_.metrics);
@@ -57,6 +103,14 @@ class NanopbMetricWriter : public virtual internal::MetricWriter {
     if (metric.is_float()) {
       proto_metric.value.as_float = metric.as_float();
       proto_metric.which_value = pw_metric_proto_Metric_as_float_tag;
+    } else if (metric.is_histogram()) {
+      CopyHistogram(static_cast<const Histogram&>(metric),
+                    proto_metric.value.as_histogram);
+      proto_metric.which_value = pw_metric_proto_Metric_as_histogram_tag;
+    } else if (metric.is_quantile_sketch()) {
+      CopyQuantileSketch(static_cast<const QuantileSketch&>(metric),
+                         proto_metric.value.as_quantile_sketch);
+      proto_metric.which_value = pw_metric_proto_Metric_as_quantile_sketch_tag;
     } else {
       proto_metric.value.as_int = metric.as_int();
       proto_metric.which_value = pw_metric_proto_Metric_as_int_tag;
@@ -67,7 +121,7 @@ class NanopbMetricWriter : public virtual internal::MetricWriter {
 
     // If the metric response object is full, send the response and reset.
     // TODO(keir): Support runtime batch sizes < max proto size.
-    if (response_.metrics_count == metrics.size()) {
+    if (response_.metrics_count == metrics.size() || metric.is_histogram()) {
       Flush();
     }
 
@@ -14,14 +14,19 @@
 
 #include "pw_metric/metric_service_pwpb.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "pw_assert/check.h"
 #include "pw_containers/vector.h"
+#include "pw_metric/histogram.h"
 #include "pw_metric/metric.h"
+#include "pw_metric/quantile_sketch.h"
 #include "pw_metric_private/metric_walker.h"
 #include "pw_metric_proto/metric_service.pwpb.h"
 #include "pw_preprocessor/util.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/serialized_size.h"
 #include "pw_rpc/raw/server_reader_writer.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
@@ -34,27 +39,151 @@ constexpr size_t kMaxNumPackedEntries = 3;
 
 namespace {
 
+// Histograms may be much larger than other metrics, so each is sent in a
+// response of its own.
+constexpr size_t kMaxHistogramCountsSize =
+    kMaxHistogramBuckets *
+    protobuf::SizeOfFieldUint32(proto::pwpb::Histogram::Fields::kCounts);
+
+Status EncodeHistogram(const Histogram& histogram,
+                       proto::pwpb::Metric::StreamEncoder& metric_encoder) {
+  span<const std::atomic<uint32_t>> buckets = histogram.buckets();
+  size_t first = 0;
+  size_t end = buckets.size();
+  while (first < end && buckets[first].load(std::memory_order_relaxed) == 0) {
+    ++first;
+  }
+  while (end > first && buckets[end - 1].load(std::memory_order_relaxed) == 0) {
+    --end;
+  }
+
+  proto::pwpb::Histogram::StreamEncoder encoder =
+      metric_encoder.GetAsHistogramEncoder();
+  encoder.WriteSubBucketBits(histogram.sub_bucket_bits()).IgnoreError();
+  encoder.WriteBucketCount(static_cast<uint32_t>(buckets.size())).IgnoreError();
+  encoder.WriteFirstBucket(static_cast<uint32_t>(first)).IgnoreError();
+  for (size_t i = first; i < end; ++i) {
+    encoder.WriteCounts(buckets[i].load(std::memory_order_relaxed))
+        .IgnoreError();
+  }
+  return encoder.status();
+}
+
+Status EncodeQuantileSketch(
+    const QuantileSketch& sketch,
+    proto::pwpb::Metric::StreamEncoder& metric_encoder) {
+  const QuantileSketch::Snapshot snapshot = sketch.GetSnapshot();
+  proto::pwpb::QuantileSketch::StreamEncoder encoder =
+      metric_encoder.GetAsQuantileSketchEncoder();
+  encoder.WriteQuantile(snapshot.quantile).IgnoreError();
+  encoder.WriteEstimate(snapshot.estimate).IgnoreError();
+  encoder.WriteMin(snapshot.min).IgnoreError();
+  encoder.WriteMax(snapshot.max).IgnoreError();
+  encoder.WriteCount(snapshot.count).IgnoreError();
+  encoder.WriteDropped(snapshot.dropped).IgnoreError();
+  return encoder.status();
+}
+
+// Returns a value which changes when the metric's value changes.
+uint32_t Fingerprint(const Metric& metric) {
+  constexpr uint32_t kFnvPrime = 0x0100'0193;
+  uint32_t hash = 0x811c'9dc5;
+  const auto add = [&hash](uint32_t value) {
+    hash = (hash ^ value) * kFnvPrime;
+  };
+
+  if (metric.is_float()) {
+    const float value = metric.as_float();
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+  if (metric.is_histogram()) {
+    for (const std::atomic<uint32_t>& bucket :
+         static_cast<const Histogram&>(metric).buckets()) {
+      add(bucket.load(std::memory_order_relaxed));
+    }
+    return hash;
+  }
+  if (metric.is_quantile_sketch()) {
+    const QuantileSketch::Snapshot snapshot =
+        static_cast<const QuantileSketch&>(metric).GetSnapshot();
+    uint32_t estimate;
+    std::memcpy(&estimate, &snapshot.estimate, sizeof(estimate));
+    add(estimate);
+    add(snapshot.count);
+    add(snapshot.dropped);
+    return hash;
+  }
+  return metric.as_int();
+}
+
+class MetricCounter : public virtual internal::MetricWriter {
+ public:
+  Status Write(const Metric&, const Vector<Token>&) override {
+    count++;
+    return OkStatus();
+  }
+
+  uint32_t count = 0;
+};
+
+// The state of a delta request being responded to.
+struct DeltaResponse {
+  // The fingerprints of the metrics last sent to the client, by ID. Empty if
+  // the service has no delta clients.
+  span<uint32_t> fingerprints;
+  uint32_t generation;
+  bool full;
+};
+
 class PwpbMetricWriter : public virtual internal::MetricWriter {
  public:
   PwpbMetricWriter(span<std::byte> response,
-                   rpc::RawServerWriter& response_writer)
+                   rpc::RawServerWriter& response_writer,
+                   const DeltaResponse* delta = nullptr)
       : response_(response),
         response_writer_(response_writer),
-        encoder_(response) {}
+        encoder_(response),
+        delta_(delta) {}
 
   // TODO(keir): Figure out a pw_rpc mechanism to fill a streaming packet based
   // on transport MTU, rather than having this as a static knob. For example,
   // some transports may be able to fit 30 metrics; others, only 5.
   Status Write(const Metric& metric, const Vector<Token>& path) override {
+    const uint32_t id = next_id_++;
+    if (delta_ != nullptr && id < delta_->fingerprints.size()) {
+      const uint32_t fingerprint = Fingerprint(metric);
+      if (!delta_->full && delta_->fingerprints[id] == fingerprint) {
+        return OkStatus();  // Unchanged since the client's last request.
+      }
+      delta_->fingerprints[id] = fingerprint;
+    }
+
+    if (metric.is_histogram()) {
+      PW_TRY(Flush());
+    }
+
     {  // Scope to control proto_encoder lifetime.
 
       // Grab the next available Metric slot to write to in the response.
       proto::pwpb::Metric::StreamEncoder proto_encoder =
           encoder_.GetMetricsEncoder();
-      PW_TRY(proto_encoder.WriteTokenPath(path));
+      if (delta_ == nullptr || delta_->full) {
+        PW_TRY(proto_encoder.WriteTokenPath(path));
+      }
+      if (delta_ != nullptr) {
+        PW_TRY(proto_encoder.WriteId(id));
+      }
       // Encode the metric value.
       if (metric.is_float()) {
         PW_TRY(proto_encoder.WriteAsFloat(metric.as_float()));
+      } else if (metric.is_histogram()) {
+        PW_TRY(EncodeHistogram(static_cast<const Histogram&>(metric),
+                               proto_encoder));
+      } else if (metric.is_quantile_sketch()) {
+        PW_TRY(EncodeQuantileSketch(static_cast<const QuantileSketch&>(metric),
+                                    proto_encoder));
       } else {
         PW_TRY(proto_encoder.WriteAsInt(metric.as_int()));
       }
@@ -62,47 +191,148 @@ class PwpbMetricWriter : public virtual internal::MetricWriter {
       metrics_count++;
     }
 
-    if (metrics_count == kMaxNumPackedEntries) {
+    if (metrics_count == kMaxNumPackedEntries || metric.is_histogram()) {
       return Flush();
     }
     return OkStatus();
   }
 
-  Status Flush() {
-    Status status;
-    if (metrics_count) {
-      status = response_writer_.Write(encoder_);
-      // Different way to clear MemoryEncoder. Copy constructor is disabled
-      // for memory encoder, and there is no "clear()" method.
-      encoder_.~MemoryEncoder();
-      new (&encoder_) proto::pwpb::MetricRequest::MemoryEncoder(response_);
-      metrics_count = 0;
+  // Delta responses are always sent, even if empty, to send the generation.
+  Status Finish() {
+    if (delta_ != nullptr && responses_sent_ == 0) {
+      return Send();
     }
-    return status;
+    return Flush();
   }
 
  private:
+  Status Flush() { return metrics_count == 0 ? OkStatus() : Send(); }
+
+  Status Send() {
+    if (delta_ != nullptr) {
+      encoder_.WriteGeneration(delta_->generation).IgnoreError();
+      encoder_.WriteFull(delta_->full).IgnoreError();
+    }
+    Status status = response_writer_.Write(encoder_);
+    responses_sent_++;
+    // Different way to clear MemoryEncoder. Copy constructor is disabled
+    // for memory encoder, and there is no "clear()" method.
+    encoder_.~MemoryEncoder();
+    new (&encoder_) proto::pwpb::MetricResponse::MemoryEncoder(response_);
+    metrics_count = 0;
+    return status;
+  }
+
   span<std::byte> response_;
   // This RPC stream writer handle must be valid for the metric writer
   // lifetime.
   rpc::RawServerWriter& response_writer_;
-  proto::pwpb::MetricRequest::MemoryEncoder encoder_;
+  proto::pwpb::MetricResponse::MemoryEncoder encoder_;
+  const DeltaResponse* delta_;
   size_t metrics_count = 0;
+  size_t responses_sent_ = 0;
+  uint32_t next_id_ = 0;
+};
+
+struct DecodedRequest {
+  bool delta = false;
+  uint32_t client_id = 0;
+  uint32_t generation = 0;
 };
+
+DecodedRequest DecodeRequest(ConstByteSpan request) {
+  DecodedRequest decoded;
+  protobuf::Decoder decoder(request);
+  while (decoder.Next().ok()) {
+    switch (static_cast<proto::pwpb::MetricRequest::Fields>(
+        decoder.FieldNumber())) {
+      case proto::pwpb::MetricRequest::Fields::kDelta:
+        decoder.ReadBool(&decoded.delta).IgnoreError();
+        break;
+      case proto::pwpb::MetricRequest::Fields::kClientId:
+        decoder.ReadUint32(&decoded.client_id).IgnoreError();
+        break;
+      case proto::pwpb::MetricRequest::Fields::kGeneration:
+        decoder.ReadUint32(&decoded.generation).IgnoreError();
+        break;
+      default:
+        break;
+    }
+  }
+  return decoded;
+}
+
 }  // namespace
 
-void MetricService::Get(ConstByteSpan /*request*/,
+MetricDeltaClient* MetricService::FindDeltaClient(uint32_t client_id) {
+  MetricDeltaClient* least_recent = nullptr;
+  for (MetricDeltaClient& client : delta_clients_) {
+    if (client.last_used_ != 0 && client.client_id_ == client_id) {
+      return &client;
+    }
+    if (least_recent == nullptr ||
+        delta_requests_ - client.last_used_ >
+            delta_requests_ - least_recent->last_used_) {
+      least_recent = &client;
+    }
+  }
+  if (least_recent != nullptr) {
+    // Forget the replaced client, which will receive a full response if it
+    // makes another request.
+    least_recent->client_id_ = client_id;
+    least_recent->generation_ = 0;
+  }
+  return least_recent;
+}
+
+void MetricService::Get(ConstByteSpan request,
                         rpc::RawServerWriter& raw_response) {
-  // For now, ignore the request and just stream all the metrics back.
+  // Other than delta requests, ignore the request and just stream all the
+  // metrics back.
   // TODO(amontanez): Make this follow the metric_service.options configuration.
   constexpr size_t kSizeOfOneMetric =
       pw::metric::proto::pwpb::MetricResponse::kMaxEncodedSizeBytes +
       pw::metric::proto::pwpb::Metric::kMaxEncodedSizeBytes;
-  constexpr size_t kEncodeBufferSize = kMaxNumPackedEntries * kSizeOfOneMetric;
+  constexpr size_t kEncodeBufferSize =
+      std::max(kMaxNumPackedEntries * kSizeOfOneMetric,
+               kSizeOfOneMetric + kMaxHistogramCountsSize);
 
   std::array<std::byte, kEncodeBufferSize> encode_buffer;
 
-  PwpbMetricWriter writer(encode_buffer, raw_response);
+  const DecodedRequest decoded = DecodeRequest(request);
+  DeltaResponse delta{};
+  if (decoded.delta) {
+    // Metrics are only ever added, so a change in the number of metrics means
+    // the IDs the client knows no longer match.
+    MetricCounter counter;
+    internal::MetricWalker counting_walker(counter);
+    counting_walker.Walk(metrics_).IgnoreError();
+    counting_walker.Walk(groups_).IgnoreError();
+
+    delta_requests_ += 1;
+    MetricDeltaClient* const client_state = FindDeltaClient(decoded.client_id);
+    delta.full = true;
+    if (client_state != nullptr) {
+      MetricDeltaClient& client = *client_state;
+      delta.full = decoded.generation == 0 ||
+                   decoded.generation != client.generation_ ||
+                   counter.count != client.metric_count_;
+      delta.fingerprints = client.fingerprints_;
+      client.metric_count_ = counter.count;
+      client.last_used_ = delta_requests_;
+
+      // Advance the generation before sending, so that a client which does
+      // not receive the whole response gets a full response next time.
+      client.generation_ += 1;
+      if (client.generation_ == 0) {
+        client.generation_ = 1;
+      }
+      delta.generation = client.generation_;
+    }
+  }
+
+  PwpbMetricWriter writer(
+      encode_buffer, raw_response, decoded.delta ? &delta : nullptr);
   internal::MetricWalker walker(writer);
 
   // This will stream all the metrics in the span of this Get() method call.
@@ -117,7 +347,7 @@ void MetricService::Get(ConstByteSpan /*request*/,
   Status status;
   status.Update(walker.Walk(metrics_));
   status.Update(walker.Walk(groups_));
-  status.Update(writer.Flush());
+  status.Update(writer.Finish());
   raw_response.Finish(status).IgnoreError();
 }
 }  // namespace pw::metric
@@ -15,7 +15,10 @@
 #include "pw_metric/metric_service_pwpb.h"
 
 #include "gtest/gtest.h"
+#include "pw_containers/vector.h"
 #include "pw_log/log.h"
+#include "pw_metric/histogram.h"
+#include "pw_metric/quantile_sketch.h"
 #include "pw_metric_proto/metric_service.pwpb.h"
 #include "pw_protobuf/decoder.h"
 #include "pw_rpc/pwpb/test_method_context.h"
@@ -214,5 +217,243 @@ TEST(MetricService, NestedGroupsWithBatches) {
                 GetMetricsSum(ctx.responses()[3]));
 }
 
+// Returns the encoded value of the given field of the only metric in a
+// response.
+ConstByteSpan GetMetricField(ConstByteSpan response,
+                             proto::pwpb::Metric::Fields field) {
+  protobuf::Decoder decoder(response);
+  ConstByteSpan metric;
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() ==
+        static_cast<uint32_t>(proto::pwpb::MetricResponse::Fields::kMetrics)) {
+      EXPECT_EQ(OkStatus(), decoder.ReadBytes(&metric));
+    }
+  }
+  protobuf::Decoder metric_decoder(metric);
+  ConstByteSpan value;
+  while (metric_decoder.Next().ok()) {
+    if (metric_decoder.FieldNumber() == static_cast<uint32_t>(field)) {
+      EXPECT_EQ(OkStatus(), metric_decoder.ReadBytes(&value));
+    }
+  }
+  return value;
+}
+
+TEST(MetricService, HistogramSentAlone) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC_HISTOGRAM(root, latency, "latency", 2, 16);
+  PW_METRIC(root, b, "b", 2u);
+
+  latency.Record(2);
+  latency.Record(2);
+  latency.Record(9);
+
+  PW_RAW_TEST_METHOD_CONTEXT(MetricService, Get)
+  ctx{root.metrics(), root.children()};
+  ctx.call({});
+  EXPECT_TRUE(ctx.done());
+  EXPECT_EQ(OkStatus(), ctx.status());
+
+  // Metrics are listed in reverse order of declaration: b, latency, a.
+  ASSERT_EQ(3u, ctx.responses().size());
+  EXPECT_EQ(1u, CountEncodedMetrics(ctx.responses()[1]));
+
+  protobuf::Decoder decoder(GetMetricField(
+      ctx.responses()[1], proto::pwpb::Metric::Fields::kAsHistogram));
+  uint32_t first_bucket = 0;
+  uint32_t bucket_count = 0;
+  Vector<uint32_t, 8> counts;
+  while (decoder.Next().ok()) {
+    uint32_t value = 0;
+    EXPECT_EQ(OkStatus(), decoder.ReadUint32(&value));
+    switch (
+        static_cast<proto::pwpb::Histogram::Fields>(decoder.FieldNumber())) {
+      case proto::pwpb::Histogram::Fields::kFirstBucket:
+        first_bucket = value;
+        break;
+      case proto::pwpb::Histogram::Fields::kBucketCount:
+        bucket_count = value;
+        break;
+      case proto::pwpb::Histogram::Fields::kCounts:
+        counts.push_back(value);
+        break;
+      case proto::pwpb::Histogram::Fields::kSubBucketBits:
+        EXPECT_EQ(2u, value);
+        break;
+    }
+  }
+  EXPECT_EQ(latency.buckets().size(), bucket_count);
+  // Only buckets 2 to 8, which counts 8 and 9, are sent.
+  EXPECT_EQ(2u, first_bucket);
+  ASSERT_EQ(7u, counts.size());
+  EXPECT_EQ(2u, counts.front());
+  EXPECT_EQ(1u, counts.back());
+}
+
+TEST(MetricService, QuantileSketch) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC_QUANTILE_SKETCH(root, median, "median", 0.5f);
+  median.Record(3.0f);
+
+  PW_RAW_TEST_METHOD_CONTEXT(MetricService, Get)
+  ctx{root.metrics(), root.children()};
+  ctx.call({});
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_EQ(1u, ctx.responses().size());
+
+  protobuf::Decoder decoder(GetMetricField(
+      ctx.responses()[0], proto::pwpb::Metric::Fields::kAsQuantileSketch));
+  float estimate = 0.0f;
+  uint32_t count = 0;
+  while (decoder.Next().ok()) {
+    switch (static_cast<proto::pwpb::QuantileSketch::Fields>(
+        decoder.FieldNumber())) {
+      case proto::pwpb::QuantileSketch::Fields::kEstimate:
+        EXPECT_EQ(OkStatus(), decoder.ReadFloat(&estimate));
+        break;
+      case proto::pwpb::QuantileSketch::Fields::kCount:
+        EXPECT_EQ(OkStatus(), decoder.ReadUint32(&count));
+        break;
+      default:
+        break;
+    }
+  }
+  EXPECT_EQ(3.0f, estimate);
+  EXPECT_EQ(1u, count);
+}
+
+ConstByteSpan EncodeDeltaRequest(ByteSpan buffer,
+                                 uint32_t client_id,
+                                 uint32_t generation) {
+  proto::pwpb::MetricRequest::MemoryEncoder encoder(buffer);
+  EXPECT_EQ(OkStatus(), encoder.WriteDelta(true));
+  EXPECT_EQ(OkStatus(), encoder.WriteClientId(client_id));
+  EXPECT_EQ(OkStatus(), encoder.WriteGeneration(generation));
+  EXPECT_EQ(OkStatus(), encoder.status());
+  return ConstByteSpan(encoder);
+}
+
+struct DeltaResponse {
+  uint32_t generation = 0;
+  bool full = false;
+  size_t metrics = 0;
+  size_t token_paths = 0;
+};
+
+template <typename Responses>
+DeltaResponse DecodeDeltaResponses(const Responses& responses) {
+  DeltaResponse decoded;
+  for (ConstByteSpan response : responses) {
+    protobuf::Decoder decoder(response);
+    while (decoder.Next().ok()) {
+      switch (static_cast<proto::pwpb::MetricResponse::Fields>(
+          decoder.FieldNumber())) {
+        case proto::pwpb::MetricResponse::Fields::kGeneration:
+          EXPECT_EQ(OkStatus(), decoder.ReadUint32(&decoded.generation));
+          break;
+        case proto::pwpb::MetricResponse::Fields::kFull:
+          EXPECT_EQ(OkStatus(), decoder.ReadBool(&decoded.full));
+          break;
+        case proto::pwpb::MetricResponse::Fields::kMetrics: {
+          ConstByteSpan metric;
+          EXPECT_EQ(OkStatus(), decoder.ReadBytes(&metric));
+          decoded.metrics += 1;
+          protobuf::Decoder metric_decoder(metric);
+          while (metric_decoder.Next().ok()) {
+            if (metric_decoder.FieldNumber() ==
+                static_cast<uint32_t>(
+                    proto::pwpb::Metric::Fields::kTokenPath)) {
+              decoded.token_paths += 1;
+              break;
+            }
+          }
+          break;
+        }
+      }
+    }
+  }
+  return decoded;
+}
+
+TEST(MetricService, DeltaRequestSendsChangedMetrics) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+  PW_METRIC(root, c, "c", 3.0f);
+  MetricDeltaClientBuffer<8> client;
+
+  PW_RAW_TEST_METHOD_CONTEXT(MetricService, Get)
+  ctx{root.metrics(), root.children()};
+  ctx.service().AddDeltaClient(client);
+  std::array<std::byte, 32> request;
+
+  // The first request receives every metric with its path.
+  ctx.call(EncodeDeltaRequest(request, 1234, 0));
+  EXPECT_EQ(OkStatus(), ctx.status());
+  DeltaResponse response = DecodeDeltaResponses(ctx.responses());
+  EXPECT_TRUE(response.full);
+  EXPECT_EQ(3u, response.metrics);
+  EXPECT_EQ(3u, response.token_paths);
+  EXPECT_NE(0u, response.generation);
+
+  // The next only receives the changed metric, without its path.
+  b.Increment();
+  ctx.call(EncodeDeltaRequest(request, 1234, response.generation));
+  EXPECT_EQ(OkStatus(), ctx.status());
+  const uint32_t previous_generation = response.generation;
+  response = DecodeDeltaResponses(ctx.responses());
+  EXPECT_FALSE(response.full);
+  EXPECT_EQ(1u, response.metrics);
+  EXPECT_EQ(0u, response.token_paths);
+  EXPECT_EQ(3u, GetMetricsSum(ctx.responses()[0]));
+  EXPECT_NE(previous_generation, response.generation);
+
+  // Without changes, one empty response carries the generation.
+  ctx.call(EncodeDeltaRequest(request, 1234, response.generation));
+  ASSERT_EQ(1u, ctx.responses().size());
+  response = DecodeDeltaResponses(ctx.responses());
+  EXPECT_FALSE(response.full);
+  EXPECT_EQ(0u, response.metrics);
+}
+
+TEST(MetricService, DeltaRequestWithStaleGenerationIsFull) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+  MetricDeltaClientBuffer<8> client;
+
+  PW_RAW_TEST_METHOD_CONTEXT(MetricService, Get)
+  ctx{root.metrics(), root.children()};
+  ctx.service().AddDeltaClient(client);
+  std::array<std::byte, 32> request;
+
+  ctx.call(EncodeDeltaRequest(request, 1, 0));
+  const uint32_t generation = DecodeDeltaResponses(ctx.responses()).generation;
+
+  // A second client replaces the first, which only has one slot.
+  ctx.call(EncodeDeltaRequest(request, 2, 0));
+  ctx.call(EncodeDeltaRequest(request, 1, generation));
+  DeltaResponse response = DecodeDeltaResponses(ctx.responses());
+  EXPECT_TRUE(response.full);
+  EXPECT_EQ(2u, response.metrics);
+  EXPECT_EQ(2u, response.token_paths);
+}
+
+TEST(MetricService, DeltaRequestWithoutClientsIsFull) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+
+  PW_RAW_TEST_METHOD_CONTEXT(MetricService, Get)
+  ctx{root.metrics(), root.children()};
+  std::array<std::byte, 32> request;
+
+  ctx.call(EncodeDeltaRequest(request, 1, 0));
+  DeltaResponse response = DecodeDeltaResponses(ctx.responses());
+  EXPECT_TRUE(response.full);
+  EXPECT_EQ(1u, response.metrics);
+  EXPECT_EQ(1u, response.token_paths);
+}
+
 }  // namespace
 }  // namespace pw::metric
@@ -14,6 +14,10 @@
 
 #include "pw_metric/metric.h"
 
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 #include "gtest/gtest.h"
 #include "pw_log/log.h"
 
@@ -55,6 +59,35 @@ TEST(Metric, IntFromObject) {
   EXPECT_EQ(m.value(), 426u);
 }
 
+TEST(Metric, IntIncrementWrapsAround) {
+  TypedMetric<uint32_t> m(0x1234, std::numeric_limits<uint32_t>::max() - 1);
+  m.Increment(3u);
+  EXPECT_EQ(m.value(), 1u);
+}
+
+TEST(Metric, NegativeFloatFromObject) {
+  TypedMetric<float> m(0x1234, -0.0f);
+  EXPECT_TRUE(std::signbit(m.value()));
+
+  m.Set(-1.25e-30f);
+  EXPECT_EQ(m.value(), -1.25e-30f);
+}
+
+TEST(Metric, NanFloatIsNotADistribution) {
+  float signaling_nan;
+  const uint32_t kHistogramBits = 0x7f800001;
+  std::memcpy(&signaling_nan, &kHistogramBits, sizeof(signaling_nan));
+
+  TypedMetric<float> m(0x1234, signaling_nan);
+  EXPECT_TRUE(m.is_float());
+  EXPECT_FALSE(m.is_histogram());
+  EXPECT_TRUE(std::isnan(m.value()));
+
+  m.Set(std::numeric_limits<float>::quiet_NaN());
+  EXPECT_TRUE(m.is_float());
+  EXPECT_TRUE(std::isnan(m.value()));
+}
+
 TEST(m, IntFromMacroLocal) {
   PW_METRIC(m, "some_metric", 14u);
   EXPECT_TRUE(m.is_int());
@@ -0,0 +1,49 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Whether the target has atomic read-modify-write instructions, which
+// Metric::Increment() uses to add to a metric from any thread or interrupt.
+// Without them, Increment() is a relaxed load and store, which is only safe if
+// each shard (see PW_METRIC_SHARDS) is incremented by one context at a time.
+//
+// Defaults to 0 on ARMv6-M and on RISC-V without the A extension, where
+// std::atomic read-modify-write operations need libatomic.
+#ifndef PW_METRIC_ATOMIC_INCREMENT
+#if defined(__ARM_ARCH_6M__) || (defined(__riscv) && !defined(__riscv_atomic))
+#define PW_METRIC_ATOMIC_INCREMENT 0
+#else
+#define PW_METRIC_ATOMIC_INCREMENT 1
+#endif  // defined(__ARM_ARCH_6M__) || ...
+#endif  // PW_METRIC_ATOMIC_INCREMENT
+
+// The number of shards each int metric is split into. Increment() adds to the
+// shard of the context it is called from, given by PW_METRIC_CURRENT_SHARD(),
+// and reading the metric sums the shards. Each shard adds 4 bytes to every
+// metric.
+//
+// Shards let contexts which cannot preempt each other, such as the cores of an
+// SMP system or the threads and interrupts of a single core, increment metrics
+// without atomic read-modify-write instructions.
+#ifndef PW_METRIC_SHARDS
+#define PW_METRIC_SHARDS 1
+#endif  // PW_METRIC_SHARDS
+
+// Returns the shard, from 0 to PW_METRIC_SHARDS - 1, the calling context
+// increments. For example, the current core index on an SMP system.
+#ifndef PW_METRIC_CURRENT_SHARD
+#define PW_METRIC_CURRENT_SHARD() 0
+#endif  // PW_METRIC_CURRENT_SHARD
+
+static_assert(PW_METRIC_SHARDS >= 1, "PW_METRIC_SHARDS must be at least 1");
@@ -0,0 +1,156 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_containers/intrusive_list.h"
+#include "pw_metric/metric.h"
+#include "pw_preprocessor/arguments.h"
+#include "pw_span/span.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::metric {
+
+// The most buckets a histogram may have, which bounds the size of a histogram
+// sent by the MetricService.
+inline constexpr size_t kMaxHistogramBuckets = 64;
+
+// A histogram metric with log-linear buckets, in the style of HdrHistogram.
+//
+// Values below 2^(sub_bucket_bits + 1) are counted exactly. Above that, each
+// power of two is split into 2^sub_bucket_bits equally sized buckets, so the
+// relative error of a reported value is at most 2^-sub_bucket_bits. Values of
+// 2^max_value_bits or more are counted in a final overflow bucket.
+//
+// Record() is safe to call from interrupts and other threads. It uses one
+// relaxed atomic increment, which requires atomic read-modify-write
+// instructions or libatomic.
+class Histogram : public Metric {
+ public:
+  // Returns the number of buckets needed by a histogram.
+  static constexpr size_t BucketCount(uint8_t sub_bucket_bits,
+                                      uint8_t max_value_bits) {
+    // One overflow bucket follows the counted range.
+    return ((max_value_bits - sub_bucket_bits + size_t{1}) << sub_bucket_bits) +
+           1;
+  }
+
+  void Record(uint32_t value) {
+    buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Returns the number of values recorded.
+  uint32_t count() const;
+
+  // Returns the largest value counted in the same bucket as the value at the
+  // quantile, from 0 to 1, of the recorded values. For example, 0.99 returns
+  // the 99th percentile. Returns 0 if no values were recorded, or UINT32_MAX
+  // if the quantile is in the overflow bucket.
+  uint32_t ValueAtQuantile(float quantile) const;
+
+  // Discards all recorded values.
+  void Reset();
+
+  // Returns the smallest and largest values counted by a bucket.
+  uint32_t BucketLowerBound(size_t index) const;
+  uint32_t BucketUpperBound(size_t index) const;
+
+  span<const std::atomic<uint32_t>> buckets() const {
+    return span(buckets_, num_buckets_);
+  }
+  uint8_t sub_bucket_bits() const { return sub_bucket_bits_; }
+
+ protected:
+  Histogram(Token name,
+            span<std::atomic<uint32_t>> buckets,
+            uint8_t sub_bucket_bits);
+  Histogram(Token name,
+            span<std::atomic<uint32_t>> buckets,
+            uint8_t sub_bucket_bits,
+            IntrusiveList<Metric>& metrics);
+
+ private:
+  size_t BucketIndex(uint32_t value) const {
+    const size_t sub_buckets = size_t{1} << sub_bucket_bits_;
+    if (value < 2 * sub_buckets) {
+      return value;
+    }
+    // Bucket by the sub_bucket_bits + 1 most significant bits of the value.
+    const uint32_t shift = 31 - __builtin_clz(value) - sub_bucket_bits_;
+    const size_t index = shift * sub_buckets + (value >> shift);
+    return index < num_buckets_ ? index : num_buckets_ - 1;
+  }
+
+  std::atomic<uint32_t>* buckets_;
+  uint16_t num_buckets_;
+  uint8_t sub_bucket_bits_;
+};
+
+// A Histogram with storage for its buckets.
+template <uint8_t kSubBucketBits, uint8_t kMaxValueBits>
+class TypedHistogram : public Histogram {
+ public:
+  static constexpr size_t kBuckets =
+      BucketCount(kSubBucketBits, kMaxValueBits);
+
+  static_assert(kSubBucketBits < kMaxValueBits && kMaxValueBits <= 32,
+                "A histogram must count values of up to 32 bits, with fewer "
+                "sub-bucket bits than value bits");
+  static_assert(kBuckets <= kMaxHistogramBuckets,
+                "Too many histogram buckets; reduce the sub-bucket bits or "
+                "the max value bits");
+
+  TypedHistogram(Token name) : Histogram(name, buckets_, kSubBucketBits) {}
+  TypedHistogram(Token name, IntrusiveList<Metric>& metrics)
+      : Histogram(name, buckets_, kSubBucketBits, metrics) {}
+
+ private:
+  std::array<std::atomic<uint32_t>, kBuckets> buckets_ = {};
+};
+
+// Declares a histogram metric, optionally in a group. Values of up to
+// max_value_bits bits are counted with a relative error of at most
+// 2^-sub_bucket_bits.
+//
+//   PW_METRIC_HISTOGRAM(group, latency_us_, "latency_us", 2, 16);
+//   latency_us_.Record(elapsed_us);
+//
+#define PW_METRIC_HISTOGRAM(...) \
+  PW_DELEGATE_BY_ARG_COUNT(_PW_METRIC_HISTOGRAM_, , __VA_ARGS__)
+#define PW_METRIC_HISTOGRAM_STATIC(...) \
+  PW_DELEGATE_BY_ARG_COUNT(_PW_METRIC_HISTOGRAM_, static, __VA_ARGS__)
+
+#define _PW_METRIC_HISTOGRAM_5(                                               \
+    static_def, variable_name, metric_name, sub_bucket_bits, max_value_bits) \
+  static constexpr uint32_t variable_name##_token =                          \
+      PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, metric_name); \
+  static_def ::pw::metric::TypedHistogram<sub_bucket_bits, max_value_bits>   \
+      variable_name = {variable_name##_token}
+
+#define _PW_METRIC_HISTOGRAM_6(static_def,                                    \
+                               group,                                         \
+                               variable_name,                                 \
+                               metric_name,                                   \
+                               sub_bucket_bits,                               \
+                               max_value_bits)                                \
+  static constexpr uint32_t variable_name##_token =                           \
+      PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, metric_name); \
+  static_def ::pw::metric::TypedHistogram<sub_bucket_bits, max_value_bits>    \
+      variable_name = {variable_name##_token, group.metrics()}
+
+}  // namespace pw::metric
@@ -14,10 +14,15 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <limits>
 
+#include "pw_alignment/alignment.h"
 #include "pw_containers/intrusive_list.h"
+#include "pw_metric/config.h"
 #include "pw_preprocessor/arguments.h"
 #include "pw_tokenizer/tokenize.h"
 
@@ -33,9 +38,13 @@ using tokenizer::Token;
 // float. More complicated compound metrics can be built on these primitives.
 // See the documentation for a discussion for this design was selected.
 //
-// Size: 12 bytes / 96 bits - next, name, value.
+// Metrics are updated and read with relaxed atomics, so they may be updated
+// from any thread or interrupt without a lock; see pw_metric/config.h for
+// targets without atomic read-modify-write instructions.
+//
+// Size: 12 bytes / 96 bits - next, name, value; plus 4 bytes for each shard past
+// the first.
 //
-// TODO(keir): Implement Set() and Increment() using atomics.
 // TODO(keir): Consider an alternative structure where metrics have pointers to
 // parent groups, which would enable (1) safe destruction and (2) safe static
 // initialization, but at the cost of an additional 4 bytes per metric and 4
@@ -44,9 +53,19 @@ class Metric : public IntrusiveList<Metric>::Item {
  public:
   Token name() const { return name_and_type_ & kTokenMask; }
 
-  bool is_float() const { return (name_and_type_ & kTypeMask) == kTypeFloat; }
+  bool is_float() const {
+    return (name_and_type_ & kTypeMask) == kTypeFloat &&
+           !is_histogram() && !is_quantile_sketch();
+  }
   bool is_int() const { return (name_and_type_ & kTypeMask) == kTypeInt; }
 
+  // Histograms and quantile sketches are distributions of values; see
+  // pw_metric/histogram.h and pw_metric/quantile_sketch.h.
+  bool is_histogram() const { return HasDistribution(Distribution::kHistogram); }
+  bool is_quantile_sketch() const {
+    return HasDistribution(Distribution::kQuantileSketch);
+  }
+
   float as_float() const;
   uint32_t as_int() const;
 
@@ -65,11 +84,29 @@ class Metric : public IntrusiveList<Metric>::Item {
   void operator=(const Metric&) = delete;
 
  protected:
+  // Distribution metrics are float metrics whose value is one of these
+  // signaling NaN bit patterns. Float metrics never store them, since
+  // FloatBits() replaces every NaN with the canonical quiet NaN.
+  enum class Distribution : uint32_t {
+    kHistogram = 0x7f80'0001,
+    kQuantileSketch = 0x7f80'0002,
+  };
+
+  // Constructs a distribution metric, which keeps its values in the derived
+  // class rather than in this metric.
+  Metric(Token name, Distribution distribution)
+      : name_and_type_((name & kTokenMask) | kTypeFloat),
+        shards_{static_cast<uint32_t>(distribution)} {}
+  Metric(Token name,
+         Distribution distribution,
+         IntrusiveList<Metric>& metrics);
+
   Metric(Token name, float value)
-      : name_and_type_((name & kTokenMask) | kTypeFloat), float_(value) {}
+      : name_and_type_((name & kTokenMask) | kTypeFloat),
+        shards_{FloatBits(value)} {}
 
   Metric(Token name, uint32_t value)
-      : name_and_type_((name & kTokenMask) | kTypeInt), uint_(value) {}
+      : name_and_type_((name & kTokenMask) | kTypeInt), shards_{value} {}
 
   Metric(Token name, float value, IntrusiveList<Metric>& metrics);
   Metric(Token name, uint32_t value, IntrusiveList<Metric>& metrics);
@@ -79,6 +116,7 @@ class Metric : public IntrusiveList<Metric>::Item {
   // a float metric at compile time.
   void Increment(uint32_t amount = 1);
 
+  // Setting a sharded metric is not atomic with increments in other shards.
   void SetInt(uint32_t value);
 
   void SetFloat(float value);
@@ -88,10 +126,28 @@ class Metric : public IntrusiveList<Metric>::Item {
   // Last bit of the token is used to store int or float; 0 == int, 1 == float.
   Token name_and_type_;
 
-  union {
-    float float_;
-    uint32_t uint_;
-  };
+  bool HasDistribution(Distribution distribution) const {
+    return (name_and_type_ & kTypeMask) == kTypeFloat &&
+           shards_[0]->load(std::memory_order_relaxed) ==
+               static_cast<uint32_t>(distribution);
+  }
+
+  static uint32_t FloatBits(float value) {
+    if (value != value) {
+      return 0x7fc0'0000;  // Canonical quiet NaN; see Distribution.
+    }
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  // The value of an int metric is the sum of its shards. Floats use only the
+  // first shard, which holds the float's bits. With
+  // PW_ALIGNMENT_CACHE_LINE_PADDING, each of multiple shards is on its own
+  // cache line, so contexts on different cores do not contend for it.
+  CacheLinePadded<std::atomic<uint32_t>,
+                  kCacheLinePadding && (PW_METRIC_SHARDS > 1)>
+      shards_[PW_METRIC_SHARDS];
 
   enum : uint32_t {
     kTokenMask = _PW_METRIC_TOKEN_MASK,  // 0x7fff'ffff
@@ -101,6 +157,10 @@ class Metric : public IntrusiveList<Metric>::Item {
   };
 };
 
+static_assert(PW_METRIC_SHARDS != 1 ||
+                  sizeof(Metric) == sizeof(void*) + 2 * sizeof(uint32_t),
+              "A metric is its list pointer, name, and value");
+
 // TypedMetric provides a type-safe wrapper the runtime-typed Metric object.
 // Note: Definition omitted to prevent accidental instantiation.
 // TODO(keir): Provide a more precise error message via static assert.
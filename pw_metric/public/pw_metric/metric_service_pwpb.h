@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <cstring>
 
 #include "pw_bytes/span.h"
@@ -24,6 +26,41 @@
 
 namespace pw::metric {
 
+// Remembers the metrics last sent to a client making delta Get() requests, so
+// that later requests only send the metrics which changed. Remembers up to
+// fingerprints.size() metrics; any further metrics are sent in every response.
+class MetricDeltaClient : public IntrusiveList<MetricDeltaClient>::Item {
+ public:
+  explicit constexpr MetricDeltaClient(span<uint32_t> fingerprints)
+      : fingerprints_(fingerprints) {}
+
+  MetricDeltaClient(const MetricDeltaClient&) = delete;
+  MetricDeltaClient& operator=(const MetricDeltaClient&) = delete;
+
+ private:
+  friend class MetricService;
+
+  // A fingerprint of the value last sent for each metric, by ID.
+  span<uint32_t> fingerprints_;
+  uint32_t client_id_ = 0;
+  uint32_t generation_ = 0;
+  uint32_t metric_count_ = 0;
+
+  // The service's request count when this client was last used, to replace
+  // the least recently used client when a new one arrives.
+  uint32_t last_used_ = 0;
+};
+
+// A MetricDeltaClient which remembers up to kMaxMetrics metrics.
+template <size_t kMaxMetrics>
+class MetricDeltaClientBuffer : public MetricDeltaClient {
+ public:
+  constexpr MetricDeltaClientBuffer() : MetricDeltaClient(fingerprints_) {}
+
+ private:
+  std::array<uint32_t, kMaxMetrics> fingerprints_ = {};
+};
+
 // The MetricService will send metrics when requested by Get(). For now, each
 // Get() request results in a stream of responses, containing the metrics from
 // the supplied list of groups and metrics. This includes recursive traversal
@@ -33,6 +70,12 @@ namespace pw::metric {
 // method is blocking, and sends all metrics at once (though batched). In the
 // future, we may switch to offering an async version where the Get() method
 // returns immediately, and someone else is responsible for pumping the queue.
+//
+// Clients which poll often may make delta requests, which only send the
+// metrics that changed since their last request, and send each metric's token
+// path once. The service remembers the state of as many clients as were added
+// with AddDeltaClient(), replacing the least recently used. Delta requests
+// receive full responses if no clients were added.
 class MetricService final
     : public proto::pw_rpc::raw::MetricService::Service<MetricService> {
  public:
@@ -40,11 +83,21 @@ class MetricService final
                 const IntrusiveList<Group>& groups)
       : metrics_(metrics), groups_(groups) {}
 
+  // Adds storage for the state of a client making delta requests. Must not be
+  // called while a Get() request is being handled.
+  void AddDeltaClient(MetricDeltaClient& client) {
+    delta_clients_.push_front(client);
+  }
+
   void Get(ConstByteSpan request, rpc::RawServerWriter& response);
 
  private:
+  MetricDeltaClient* FindDeltaClient(uint32_t client_id);
+
   const IntrusiveList<Metric>& metrics_;
   const IntrusiveList<Group>& groups_;
+  IntrusiveList<MetricDeltaClient> delta_clients_;
+  uint32_t delta_requests_ = 0;
 };
 
 }  // namespace pw::metric
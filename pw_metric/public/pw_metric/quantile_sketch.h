@@ -0,0 +1,105 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "pw_containers/intrusive_list.h"
+#include "pw_metric/metric.h"
+#include "pw_preprocessor/arguments.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::metric {
+
+// A metric which estimates one quantile of the values recorded, such as the
+// median or the 99th percentile, in constant space. Uses the P-square
+// algorithm (Jain and Chlamtac, 1985), which tracks five markers: the minimum,
+// the maximum, the quantile and points halfway to it from either end.
+//
+// Record() never blocks, so it is safe to call from interrupts. A value
+// recorded while another Record() or a read is in progress, for example from
+// an interrupt which preempted it, is dropped and counted instead. Record()
+// uses floating point arithmetic.
+class QuantileSketch : public Metric {
+ public:
+  QuantileSketch(Token name, float quantile);
+  QuantileSketch(Token name, float quantile, IntrusiveList<Metric>& metrics);
+
+  void Record(float value);
+
+  // The estimate and the values it was made from.
+  struct Snapshot {
+    float quantile;
+    float estimate;
+    float min;
+    float max;
+    uint32_t count;
+    uint32_t dropped;
+  };
+
+  // Reads the current estimate. Must not be called from interrupts.
+  Snapshot GetSnapshot() const;
+
+  float quantile() const { return quantile_; }
+
+  // Discards all recorded values. Must not be called from interrupts.
+  void Reset();
+
+ private:
+  static constexpr size_t kMarkers = 5;
+
+  void Lock() const;
+  void Unlock() const { busy_.store(false, std::memory_order_release); }
+
+  void Adjust(size_t marker);
+
+  float quantile_;
+  uint32_t count_ = 0;
+  std::atomic<uint32_t> dropped_ = 0;
+  mutable std::atomic<bool> busy_ = false;
+
+  // Marker heights, and their actual and desired positions, from 0.
+  std::array<float, kMarkers> heights_ = {};
+  std::array<int32_t, kMarkers> positions_ = {};
+  std::array<float, kMarkers> desired_positions_ = {};
+};
+
+// Declares a quantile sketch metric, optionally in a group, which estimates
+// the given quantile from 0 to 1.
+//
+//   PW_METRIC_QUANTILE_SKETCH(group, p99_latency_us_, "p99_latency_us", 0.99f);
+//   p99_latency_us_.Record(elapsed_us);
+//
+#define PW_METRIC_QUANTILE_SKETCH(...) \
+  PW_DELEGATE_BY_ARG_COUNT(_PW_METRIC_QUANTILE_SKETCH_, , __VA_ARGS__)
+#define PW_METRIC_QUANTILE_SKETCH_STATIC(...) \
+  PW_DELEGATE_BY_ARG_COUNT(_PW_METRIC_QUANTILE_SKETCH_, static, __VA_ARGS__)
+
+#define _PW_METRIC_QUANTILE_SKETCH_4(                                         \
+    static_def, variable_name, metric_name, quantile)                         \
+  static constexpr uint32_t variable_name##_token =                           \
+      PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, metric_name); \
+  static_def ::pw::metric::QuantileSketch variable_name = {                   \
+      variable_name##_token, quantile}
+
+#define _PW_METRIC_QUANTILE_SKETCH_5(                                         \
+    static_def, group, variable_name, metric_name, quantile)                  \
+  static constexpr uint32_t variable_name##_token =                           \
+      PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, metric_name); \
+  static_def ::pw::metric::QuantileSketch variable_name = {                   \
+      variable_name##_token, quantile, group.metrics()}
+
+}  // namespace pw::metric
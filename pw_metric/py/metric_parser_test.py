@@ -14,7 +14,7 @@
 # the License.
 """Tests for retreiving and parsing metrics."""
 from unittest import TestCase, mock, main
-from pw_metric.metric_parser import parse_metrics
+from pw_metric.metric_parser import MetricPoller, parse_metrics
 
 from pw_metric_proto import metric_service_pb2
 from pw_status import Status
@@ -292,6 +292,164 @@ class TestParseMetrics(TestCase):
         parse_metrics(self.rpcs, self.detokenize, self.rpc_timeout_s)
         self.assertRaises(ValueError, msg='Expected Value Error.')
 
+    def test_histogram(self) -> None:
+        """Tests summarizing a histogram by its percentiles."""
+        # Two sub-bucket bits; buckets 8 to 11 count 8-9, 10-11, 12-13 and
+        # 14-15, and bucket 29 is the overflow bucket.
+        histogram = metric_service_pb2.Histogram(
+            sub_bucket_bits=2,
+            bucket_count=30,
+            first_bucket=3,
+            counts=[50, 0, 0, 0, 0, 0, 40, 0, 9],
+        )
+        self.rpcs.pw.metric.proto.MetricService.Get.return_value.responses = [
+            metric_service_pb2.MetricResponse(
+                metrics=[
+                    metric_service_pb2.Metric(
+                        token_path=[self.log, self.total_created],
+                        as_histogram=histogram,
+                    )
+                ]
+            )
+        ]
+        self.assertEqual(
+            {
+                'log': {
+                    'total_created': {
+                        'count': 99,
+                        'p50': 3,
+                        'p90': 11,
+                        'p99': 15,
+                    },
+                },
+            },
+            parse_metrics(self.rpcs, self.detokenize, self.rpc_timeout_s),
+        )
+
+    def test_quantile_sketch(self) -> None:
+        """Tests parsing a quantile sketch."""
+        sketch = metric_service_pb2.QuantileSketch(
+            quantile=0.5, estimate=4.0, min=1.0, max=8.0, count=10
+        )
+        self.rpcs.pw.metric.proto.MetricService.Get.return_value.responses = [
+            metric_service_pb2.MetricResponse(
+                metrics=[
+                    metric_service_pb2.Metric(
+                        token_path=[self.log, self.total_created],
+                        as_quantile_sketch=sketch,
+                    )
+                ]
+            )
+        ]
+        self.assertEqual(
+            {
+                'log': {
+                    'total_created': {
+                        'quantile': 0.5,
+                        'estimate': 4.0,
+                        'min': 1.0,
+                        'max': 8.0,
+                        'count': 10,
+                        'dropped': 0,
+                    },
+                },
+            },
+            parse_metrics(self.rpcs, self.detokenize, self.rpc_timeout_s),
+        )
+
+
+class TestMetricPoller(TestCase):
+    """Tests polling metrics with delta requests."""
+
+    def setUp(self) -> None:
+        self.detokenize = detokenize.Detokenizer(DATABASE)
+        self.rpcs = mock.Mock()
+        self.get = self.rpcs.pw.metric.proto.MetricService.Get
+        self.get.return_value.status = Status.OK
+        self.log = 0xA7C43965
+        self.total_created = 0x22198280
+        self.total_dropped = 0x01148A48
+        self.poller = MetricPoller(self.rpcs, self.detokenize, client_id=7)
+
+    def test_full_then_delta(self) -> None:
+        """Tests updating metrics sent by ID after a full response."""
+        self.get.return_value.responses = [
+            metric_service_pb2.MetricResponse(
+                generation=1,
+                full=True,
+                metrics=[
+                    metric_service_pb2.Metric(
+                        token_path=[self.log, self.total_created],
+                        id=0,
+                        as_int=3,
+                    ),
+                    metric_service_pb2.Metric(
+                        token_path=[self.log, self.total_dropped],
+                        id=1,
+                        as_int=4,
+                    ),
+                ],
+            )
+        ]
+        self.assertEqual(
+            {'log': {'total_created': 3, 'total_dropped': 4}},
+            self.poller.poll(),
+        )
+        self.get.assert_called_with(
+            delta=True, client_id=7, generation=0, pw_rpc_timeout_s=None
+        )
+
+        self.get.return_value.responses = [
+            metric_service_pb2.MetricResponse(
+                generation=2,
+                metrics=[metric_service_pb2.Metric(id=1, as_int=5)],
+            )
+        ]
+        self.assertEqual(
+            {'log': {'total_created': 3, 'total_dropped': 5}},
+            self.poller.poll(),
+        )
+        self.get.assert_called_with(
+            delta=True, client_id=7, generation=1, pw_rpc_timeout_s=None
+        )
+
+        # The next request sends the generation of the last response.
+        self.get.return_value.responses = [
+            metric_service_pb2.MetricResponse(generation=3)
+        ]
+        self.poller.poll()
+        self.get.assert_called_with(
+            delta=True, client_id=7, generation=2, pw_rpc_timeout_s=None
+        )
+
+    def test_unknown_id_requests_full_response(self) -> None:
+        """Tests that an unknown ID resets the generation."""
+        self.get.return_value.responses = [
+            metric_service_pb2.MetricResponse(
+                generation=4,
+                metrics=[metric_service_pb2.Metric(id=3, as_int=5)],
+            )
+        ]
+        self.assertEqual({}, self.poller.poll())
+        self.poller.poll()
+        self.get.assert_called_with(
+            delta=True, client_id=7, generation=0, pw_rpc_timeout_s=None
+        )
+
+    def test_failed_stream_requests_full_response(self) -> None:
+        """Tests that a failed stream resets the generation."""
+        self.get.return_value.responses = [
+            metric_service_pb2.MetricResponse(generation=1, full=True)
+        ]
+        self.poller.poll()
+        self.get.return_value.status = Status.ABORTED
+        self.poller.poll()
+        self.get.return_value.status = Status.OK
+        self.poller.poll()
+        self.get.assert_called_with(
+            delta=True, client_id=7, generation=0, pw_rpc_timeout_s=None
+        )
+
 
 if __name__ == '__main__':
     main()
@@ -15,7 +15,8 @@
 from collections import defaultdict
 import json
 import logging
-from typing import Any, Optional
+import random
+from typing import Any, Dict, List, Optional, Tuple
 from pw_tokenizer import detokenize
 
 _LOG = logging.getLogger(__name__)
@@ -41,6 +42,74 @@ def _insert(metrics, path_names, value):
             metrics[path_name] = value
 
 
+def _bucket_upper_bound(index: int, sub_bucket_bits: int) -> int:
+    """Returns the largest value counted by a pw::metric::Histogram bucket."""
+    sub_buckets = 1 << sub_bucket_bits
+    next_index = index + 1
+    if next_index < 2 * sub_buckets:
+        return index
+    shift = next_index // sub_buckets - 1
+    return ((next_index - shift * sub_buckets) << shift) - 1
+
+
+def _histogram_summary(histogram) -> Dict[str, Any]:
+    """Summarizes a Histogram message by its count and common percentiles.
+
+    Percentiles are the largest value in their bucket, or None if in the
+    overflow bucket.
+    """
+    total = sum(histogram.counts)
+    summary: Dict[str, Any] = {'count': total}
+    for name, quantile in (('p50', 0.5), ('p90', 0.9), ('p99', 0.99)):
+        summary[name] = 0
+        rank = max(1, int(quantile * total + 0.5))
+        seen = 0
+        for offset, count in enumerate(histogram.counts):
+            seen += count
+            if seen < rank:
+                continue
+            index = histogram.first_bucket + offset
+            if index < histogram.bucket_count - 1:
+                summary[name] = _bucket_upper_bound(
+                    index, histogram.sub_bucket_bits
+                )
+            else:
+                summary[name] = None
+            break
+    return summary
+
+
+def _metric_value(metric) -> Any:
+    """Returns the value of a Metric message."""
+    field = metric.WhichOneof('value')
+    if field == 'as_histogram':
+        return _histogram_summary(metric.as_histogram)
+    if field == 'as_quantile_sketch':
+        sketch = metric.as_quantile_sketch
+        return {
+            'quantile': sketch.quantile,
+            'estimate': sketch.estimate,
+            'min': sketch.min,
+            'max': sketch.max,
+            'count': sketch.count,
+            'dropped': sketch.dropped,
+        }
+    return metric.as_float if field == 'as_float' else metric.as_int
+
+
+def _path_names(token_path, detokenizer: detokenize.Detokenizer) -> List[str]:
+    """Detokenizes a metric's token path."""
+    path_names = []
+    for path in token_path:
+        path_name = str(
+            detokenize.DetokenizedString(
+                path, detokenizer.lookup(path), b'', False
+            )
+        ).strip('"')
+        path_names.append(path_name)
+    return path_names
+
+
 def parse_metrics(
     rpcs: Any,
     detokenizer: Optional[detokenize.Detokenizer],
@@ -61,20 +130,77 @@ def parse_metrics(
         return metrics
     for metric_response in stream_response.responses:
         for metric in metric_response.metrics:
-            path_names = []
-            for path in metric.token_path:
-                path_name = str(
-                    detokenize.DetokenizedString(
-                        path, detokenizer.lookup(path), b'', False
-                    )
-                ).strip('"')
-                path_names.append(path_name)
-            value = (
-                metric.as_float
-                if metric.HasField('as_float')
-                else metric.as_int
-            )
+            path_names = _path_names(metric.token_path, detokenizer)
             # inserting path_names into metrics.
-            _insert(metrics, path_names, value)
+            _insert(metrics, path_names, _metric_value(metric))
     # Converts default dict objects into standard dictionaries.
     return json.loads(json.dumps(metrics))
+
+
+class MetricPoller:
+    """Polls metrics with delta requests, which only send changed metrics.
+
+    The device sends every metric with its token path in the first response,
+    and afterwards only the metrics which changed, identified by their ID. The
+    poller keeps the latest value of every metric.
+    """
+
+    def __init__(
+        self,
+        rpcs: Any,
+        detokenizer: detokenize.Detokenizer,
+        timeout_s: Optional[float] = None,
+        client_id: Optional[int] = None,
+    ):
+        self._rpcs = rpcs
+        self._detokenizer = detokenizer
+        self._timeout_s = timeout_s
+        self._client_id = (
+            client_id if client_id is not None else random.getrandbits(32)
+        )
+        self._generation = 0
+        self._paths: Dict[int, Tuple[str, ...]] = {}
+        self._values: Dict[Tuple[str, ...], Any] = {}
+
+    def poll(self) -> Dict[str, Any]:
+        """Requests the metrics which changed and returns all metrics."""
+        stream_response = self._rpcs.pw.metric.proto.MetricService.Get(
+            delta=True,
+            client_id=self._client_id,
+            generation=self._generation,
+            pw_rpc_timeout_s=self._timeout_s,
+        )
+        if not stream_response.status.ok():
+            _LOG.error('Unexpected status %s', stream_response.status)
+            # The device may have sent part of the changes; start over.
+            self._generation = 0
+            return self.metrics()
+
+        generation = 0
+        unknown_id = False
+        for index, metric_response in enumerate(stream_response.responses):
+            if index == 0 and metric_response.full:
+                self._paths.clear()
+                self._values.clear()
+            generation = metric_response.generation
+            for metric in metric_response.metrics:
+                if metric.token_path:
+                    self._paths[metric.id] = tuple(
+                        _path_names(metric.token_path, self._detokenizer)
+                    )
+                path = self._paths.get(metric.id)
+                if path is None:
+                    # Request a full response next time.
+                    _LOG.warning('Received unknown metric ID %d', metric.id)
+                    unknown_id = True
+                    continue
+                self._values[path] = _metric_value(metric)
+        self._generation = 0 if unknown_id else generation
+        return self.metrics()
+
+    def metrics(self) -> Dict[str, Any]:
+        """Returns the latest value of each metric, nested by group."""
+        metrics: defaultdict = _tree()
+        for path_names, value in self._values.items():
+            _insert(metrics, list(path_names), value)
+        return json.loads(json.dumps(metrics))
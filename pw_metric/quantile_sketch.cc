@@ -0,0 +1,164 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/quantile_sketch.h"
+
+#include <algorithm>
+
+#include "pw_assert/check.h"
+
+namespace pw::metric {
+
+QuantileSketch::QuantileSketch(Token name, float quantile)
+    : Metric(name, Distribution::kQuantileSketch), quantile_(quantile) {
+  PW_DCHECK(quantile > 0.0f && quantile < 1.0f);
+}
+
+QuantileSketch::QuantileSketch(Token name,
+                               float quantile,
+                               IntrusiveList<Metric>& metrics)
+    : QuantileSketch(name, quantile) {
+  metrics.push_front(*this);
+}
+
+void QuantileSketch::Lock() const {
+  bool expected = false;
+  while (!busy_.compare_exchange_weak(
+      expected, true, std::memory_order_acquire, std::memory_order_relaxed)) {
+    expected = false;
+  }
+}
+
+void QuantileSketch::Record(float value) {
+  bool expected = false;
+  if (!busy_.compare_exchange_strong(expected,
+                                     true,
+                                     std::memory_order_acquire,
+                                     std::memory_order_relaxed)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // The first values are kept in order as the initial marker heights.
+  if (count_ < kMarkers) {
+    size_t i = count_;
+    for (; i > 0 && heights_[i - 1] > value; --i) {
+      heights_[i] = heights_[i - 1];
+    }
+    heights_[i] = value;
+    count_ += 1;
+    if (count_ == kMarkers) {
+      for (size_t m = 0; m < kMarkers; ++m) {
+        positions_[m] = static_cast<int32_t>(m);
+      }
+      desired_positions_ = {
+          0.0f, 2 * quantile_, 4 * quantile_, 2 + 2 * quantile_, 4.0f};
+    }
+    Unlock();
+    return;
+  }
+
+  // Find the cell the value falls into, extending the range if needed.
+  size_t cell;
+  if (value < heights_[0]) {
+    heights_[0] = value;
+    cell = 0;
+  } else if (value >= heights_[kMarkers - 1]) {
+    heights_[kMarkers - 1] = value;
+    cell = kMarkers - 2;
+  } else {
+    cell = 0;
+    while (value >= heights_[cell + 1]) {
+      ++cell;
+    }
+  }
+
+  for (size_t m = cell + 1; m < kMarkers; ++m) {
+    positions_[m] += 1;
+  }
+  const std::array<float, kMarkers> increments = {
+      0.0f, quantile_ / 2, quantile_, (1 + quantile_) / 2, 1.0f};
+  for (size_t m = 0; m < kMarkers; ++m) {
+    desired_positions_[m] += increments[m];
+  }
+  for (size_t m = 1; m < kMarkers - 1; ++m) {
+    Adjust(m);
+  }
+  count_ += 1;
+  Unlock();
+}
+
+// Moves a middle marker by one position towards its desired position, if it
+// is at least one off, adjusting its height with a piecewise-parabolic
+// prediction, or linearly if that would put it out of order.
+void QuantileSketch::Adjust(size_t m) {
+  const float offset =
+      desired_positions_[m] - static_cast<float>(positions_[m]);
+  const int32_t to_next = positions_[m + 1] - positions_[m];
+  const int32_t to_prev = positions_[m - 1] - positions_[m];
+  if (!((offset >= 1.0f && to_next > 1) || (offset <= -1.0f && to_prev < -1))) {
+    return;
+  }
+
+  const int32_t step = offset > 0 ? 1 : -1;
+  const float d = static_cast<float>(step);
+  const float n_prev = static_cast<float>(positions_[m - 1]);
+  const float n = static_cast<float>(positions_[m]);
+  const float n_next = static_cast<float>(positions_[m + 1]);
+
+  const float parabolic =
+      heights_[m] +
+      d / (n_next - n_prev) *
+          ((n - n_prev + d) * (heights_[m + 1] - heights_[m]) / (n_next - n) +
+           (n_next - n - d) * (heights_[m] - heights_[m - 1]) / (n - n_prev));
+  if (heights_[m - 1] < parabolic && parabolic < heights_[m + 1]) {
+    heights_[m] = parabolic;
+  } else {
+    const size_t neighbor = step > 0 ? m + 1 : m - 1;
+    heights_[m] += d * (heights_[neighbor] - heights_[m]) /
+                   static_cast<float>(positions_[neighbor] - positions_[m]);
+  }
+  positions_[m] += step;
+}
+
+QuantileSketch::Snapshot QuantileSketch::GetSnapshot() const {
+  Lock();
+  Snapshot snapshot{};
+  snapshot.quantile = quantile_;
+  snapshot.count = count_;
+  snapshot.dropped = dropped_.load(std::memory_order_relaxed);
+  if (count_ >= kMarkers) {
+    snapshot.estimate = heights_[2];
+    snapshot.min = heights_[0];
+    snapshot.max = heights_[kMarkers - 1];
+  } else if (count_ > 0) {
+    // Too few values for the markers; use the nearest of the sorted values.
+    const size_t rank = static_cast<size_t>(
+        quantile_ * static_cast<float>(count_ - 1) + 0.5f);
+    snapshot.estimate = heights_[rank];
+    snapshot.min = heights_[0];
+    snapshot.max = heights_[count_ - 1];
+  }
+  Unlock();
+  return snapshot;
+}
+
+void QuantileSketch::Reset() {
+  Lock();
+  count_ = 0;
+  dropped_.store(0, std::memory_order_relaxed);
+  Unlock();
+}
+
+}  // namespace pw::metric
@@ -0,0 +1,103 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_metric/quantile_sketch.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::metric {
+namespace {
+
+TEST(QuantileSketch, Type) {
+  QuantileSketch sketch(0xf1223344, 0.5f);
+  EXPECT_EQ(sketch.name(), 0x71223344u);
+  EXPECT_TRUE(sketch.is_quantile_sketch());
+  EXPECT_FALSE(sketch.is_histogram());
+  EXPECT_FALSE(sketch.is_float());
+  EXPECT_FALSE(sketch.is_int());
+}
+
+TEST(QuantileSketch, Empty) {
+  QuantileSketch sketch(0, 0.5f);
+  const QuantileSketch::Snapshot snapshot = sketch.GetSnapshot();
+  EXPECT_EQ(snapshot.count, 0u);
+  EXPECT_EQ(snapshot.estimate, 0.0f);
+  EXPECT_EQ(snapshot.quantile, 0.5f);
+}
+
+TEST(QuantileSketch, FewValues_Exact) {
+  QuantileSketch sketch(0, 0.5f);
+  sketch.Record(30.0f);
+  sketch.Record(10.0f);
+  sketch.Record(20.0f);
+  const QuantileSketch::Snapshot snapshot = sketch.GetSnapshot();
+  EXPECT_EQ(snapshot.count, 3u);
+  EXPECT_EQ(snapshot.estimate, 20.0f);
+  EXPECT_EQ(snapshot.min, 10.0f);
+  EXPECT_EQ(snapshot.max, 30.0f);
+}
+
+// Records 0 to 999 in a scrambled order.
+void RecordScrambled(QuantileSketch& sketch) {
+  for (uint32_t i = 0; i < 1000; ++i) {
+    sketch.Record(static_cast<float>((i * 7919u) % 1000u));
+  }
+}
+
+TEST(QuantileSketch, Median) {
+  QuantileSketch sketch(0, 0.5f);
+  RecordScrambled(sketch);
+  const QuantileSketch::Snapshot snapshot = sketch.GetSnapshot();
+  EXPECT_EQ(snapshot.count, 1000u);
+  EXPECT_EQ(snapshot.dropped, 0u);
+  EXPECT_GE(snapshot.estimate, 475.0f);
+  EXPECT_LE(snapshot.estimate, 525.0f);
+  EXPECT_EQ(snapshot.min, 0.0f);
+  EXPECT_EQ(snapshot.max, 999.0f);
+}
+
+TEST(QuantileSketch, P99) {
+  QuantileSketch sketch(0, 0.99f);
+  RecordScrambled(sketch);
+  const float estimate = sketch.GetSnapshot().estimate;
+  EXPECT_GE(estimate, 980.0f);
+  EXPECT_LE(estimate, 1000.0f);
+}
+
+TEST(QuantileSketch, Reset) {
+  QuantileSketch sketch(0, 0.5f);
+  RecordScrambled(sketch);
+  sketch.Reset();
+  EXPECT_EQ(sketch.GetSnapshot().count, 0u);
+
+  sketch.Record(4.0f);
+  EXPECT_EQ(sketch.GetSnapshot().estimate, 4.0f);
+}
+
+TEST(QuantileSketch, FromMacro) {
+  PW_METRIC_GROUP(group, "group");
+  PW_METRIC_QUANTILE_SKETCH(group, p99, "p99", 0.99f);
+  PW_METRIC_QUANTILE_SKETCH(median, "median", 0.5f);
+
+  EXPECT_EQ(&group.metrics().front(), &p99);
+  EXPECT_EQ(median.quantile(), 0.5f);
+
+  p99.Record(1.0f);
+  group.Dump();
+}
+
+}  // namespace
+}  // namespace pw::metric
@@ -0,0 +1,110 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_multisink/lock_free_ingress.h"
+
+#include <cstring>
+
+#include "pw_assert/check.h"
+
+namespace pw {
+namespace multisink {
+
+LockFreeIngress::LockFreeIngress(span<std::atomic<uint32_t>> sequences,
+                                 span<size_t> sizes,
+                                 ByteSpan data,
+                                 size_t max_entry_size)
+    : sequences_(sequences),
+      sizes_(sizes),
+      data_(data),
+      max_entry_size_(max_entry_size),
+      enqueue_position_(0),
+      drop_count_(0),
+      dequeue_position_(0) {
+  PW_DCHECK(!sequences.empty() &&
+            (sequences.size() & (sequences.size() - 1)) == 0);
+  PW_DCHECK_UINT_EQ(sizes.size(), sequences.size());
+  PW_DCHECK_UINT_GE(data.size(), sequences.size() * max_entry_size);
+}
+
+void LockFreeIngress::Initialize() {
+  for (size_t slot = 0; slot < sequences_.size(); ++slot) {
+    sequences_[slot].store(static_cast<uint32_t>(slot),
+                           std::memory_order_relaxed);
+  }
+  enqueue_position_.store(0, std::memory_order_relaxed);
+  drop_count_.store(0, std::memory_order_relaxed);
+  dequeue_position_ = 0;
+}
+
+Status LockFreeIngress::Push(ConstByteSpan entry) {
+  if (entry.size() > max_entry_size_) {
+    drop_count_.fetch_add(1, std::memory_order_relaxed);
+    return Status::InvalidArgument();
+  }
+
+  // Reserve a slot. The compare-and-swap only fails if another producer
+  // reserved the same position first, in which case that producer has made
+  // progress and this one retries with the next position.
+  uint32_t position = enqueue_position_.load(std::memory_order_relaxed);
+  size_t slot;
+  while (true) {
+    slot = position % sequences_.size();
+    const uint32_t sequence = sequences_[slot].load(std::memory_order_acquire);
+    const int32_t difference = static_cast<int32_t>(sequence - position);
+
+    if (difference == 0) {
+      if (enqueue_position_.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // The slot still holds an entry from the previous lap: the queue is full.
+      drop_count_.fetch_add(1, std::memory_order_relaxed);
+      return Status::ResourceExhausted();
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+
+  if (!entry.empty()) {
+    std::memcpy(slot_data(slot).data(), entry.data(), entry.size());
+  }
+  sizes_[slot] = entry.size();
+
+  // Publish the entry to the consumer.
+  sequences_[slot].store(position + 1, std::memory_order_release);
+  return OkStatus();
+}
+
+bool LockFreeIngress::PeekFront(ConstByteSpan& entry) const {
+  const size_t slot = dequeue_position_ % sequences_.size();
+  if (sequences_[slot].load(std::memory_order_acquire) !=
+      dequeue_position_ + 1) {
+    return false;
+  }
+  entry = slot_data(slot).first(sizes_[slot]);
+  return true;
+}
+
+void LockFreeIngress::PopFront() {
+  const size_t slot = dequeue_position_ % sequences_.size();
+  sequences_[slot].store(
+      dequeue_position_ + static_cast<uint32_t>(sequences_.size()),
+      std::memory_order_release);
+  dequeue_position_ += 1;
+}
+
+}  // namespace multisink
+}  // namespace pw
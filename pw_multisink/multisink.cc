@@ -82,13 +82,73 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
     uint32_t& drain_drop_count_out,
     uint32_t& ingress_drop_count_out,
     uint32_t& entry_sequence_id_out) {
-  size_t bytes_read = 0;
-  entry_sequence_id_out = 0;
+  std::lock_guard lock(lock_);
+  PW_DCHECK_PTR_EQ(drain.multisink_, this);
+  FlushIngressLocked();
+  return PeekOrPopEntryLocked(drain,
+                              buffer,
+                              request,
+                              drain_drop_count_out,
+                              ingress_drop_count_out,
+                              entry_sequence_id_out);
+}
+
+StatusWithSize MultiSink::PopEntries(Drain& drain,
+                                     ByteSpan buffer,
+                                     span<ConstByteSpan> entries_out,
+                                     uint32_t& drain_drop_count_out,
+                                     uint32_t& ingress_drop_count_out) {
   drain_drop_count_out = 0;
   ingress_drop_count_out = 0;
 
   std::lock_guard lock(lock_);
   PW_DCHECK_PTR_EQ(drain.multisink_, this);
+  FlushIngressLocked();
+
+  size_t entry_count = 0;
+  while (entry_count < entries_out.size()) {
+    // Leave an entry that doesn't fit in the remaining space for the next
+    // call, rather than discarding it as PeekOrPopEntryLocked would.
+    if (entry_count > 0 &&
+        drain.reader_.FrontEntryDataSizeBytes() > buffer.size()) {
+      break;
+    }
+
+    uint32_t drain_drop_count = 0;
+    uint32_t ingress_drop_count = 0;
+    uint32_t entry_sequence_id = 0;
+    const Result<ConstByteSpan> entry = PeekOrPopEntryLocked(drain,
+                                                             buffer,
+                                                             Request::kPop,
+                                                             drain_drop_count,
+                                                             ingress_drop_count,
+                                                             entry_sequence_id);
+    drain_drop_count_out += drain_drop_count;
+    ingress_drop_count_out += ingress_drop_count;
+    if (!entry.ok()) {
+      if (entry_count == 0) {
+        return StatusWithSize(entry.status(), 0);
+      }
+      break;
+    }
+
+    entries_out[entry_count++] = entry.value();
+    buffer = buffer.subspan(entry.value().size());
+  }
+  return StatusWithSize(entry_count);
+}
+
+Result<ConstByteSpan> MultiSink::PeekOrPopEntryLocked(
+    Drain& drain,
+    ByteSpan buffer,
+    Request request,
+    uint32_t& drain_drop_count_out,
+    uint32_t& ingress_drop_count_out,
+    uint32_t& entry_sequence_id_out) {
+  size_t bytes_read = 0;
+  entry_sequence_id_out = 0;
+  drain_drop_count_out = 0;
+  ingress_drop_count_out = 0;
 
   const Status peek_status = drain.reader_.PeekFrontWithPreamble(
       buffer, entry_sequence_id_out, bytes_read);
@@ -174,6 +234,7 @@ void MultiSink::AttachListener(Listener& listener) {
   std::lock_guard lock(lock_);
   listeners_.push_back(listener);
   // Notify the newly added entry, in case there are items in the sink.
+  listener.MarkNotified(listener_notify_delay_);
   listener.OnNewEntryAvailable();
 }
 
@@ -183,6 +244,67 @@ void MultiSink::DetachListener(Listener& listener) {
   PW_DCHECK(was_detached, "The listener was already attached.");
 }
 
+void MultiSink::SetListenerNotificationCoalescing(
+    uint32_t max_entries, chrono::SystemClock::duration max_delay) {
+  PW_DCHECK_UINT_NE(max_entries, 0u);
+  std::lock_guard lock(lock_);
+  listener_notify_entries_ = max_entries;
+  listener_notify_delay_ = max_delay;
+}
+
+void MultiSink::RearmListener(Listener& listener) {
+  std::lock_guard lock(lock_);
+  listener.armed_ = true;
+}
+
+void MultiSink::AttachIngress(LockFreeIngress& ingress) {
+  std::lock_guard lock(lock_);
+  PW_DCHECK_PTR_EQ(ingress_, nullptr);
+  ingress_ = &ingress;
+}
+
+void MultiSink::DetachIngress() {
+  std::lock_guard lock(lock_);
+  PW_DCHECK_NOTNULL(ingress_);
+  if (FlushIngressLocked()) {
+    NotifyListeners();
+  }
+  ingress_ = nullptr;
+}
+
+void MultiSink::FlushIngress() {
+  std::lock_guard lock(lock_);
+  if (FlushIngressLocked()) {
+    NotifyListeners();
+  }
+}
+
+bool MultiSink::FlushIngressLocked() {
+  if (ingress_ == nullptr) {
+    return false;
+  }
+
+  bool changed = false;
+  ConstByteSpan entry;
+  while (ingress_->PeekFront(entry)) {
+    const Status push_back_status =
+        ring_buffer_.PushBack(entry, sequence_id_++);
+    PW_DCHECK_OK(push_back_status);
+    ingress_->PopFront();
+    changed = true;
+  }
+
+  // Entries are only dropped when the queue is full, so report the drops after
+  // the entries that were already committed.
+  const uint32_t drop_count = ingress_->TakeDropCount();
+  if (drop_count > 0) {
+    sequence_id_ += drop_count;
+    total_ingress_drops_ += drop_count;
+    changed = true;
+  }
+  return changed;
+}
+
 void MultiSink::Clear() {
   std::lock_guard lock(lock_);
   ring_buffer_.Clear();
@@ -190,7 +312,31 @@ void MultiSink::Clear() {
 
 void MultiSink::NotifyListeners() {
   for (auto& listener : listeners_) {
-    listener.OnNewEntryAvailable();
+    if (listener.ShouldNotify(listener_notify_entries_,
+                              listener_notify_delay_)) {
+      listener.OnNewEntryAvailable();
+    }
+  }
+}
+
+bool MultiSink::Listener::ShouldNotify(
+    uint32_t max_entries, chrono::SystemClock::duration max_delay) {
+  if (!armed_ && ++unnotified_entries_ < max_entries &&
+      (max_delay == chrono::SystemClock::duration::zero() ||
+       chrono::SystemClock::now() - last_notified_ < max_delay)) {
+    return false;
+  }
+  MarkNotified(max_delay);
+  return true;
+}
+
+void MultiSink::Listener::MarkNotified(
+    chrono::SystemClock::duration max_delay) {
+  armed_ = false;
+  unnotified_entries_ = 0;
+  // Only read the clock if the timeout is used.
+  if (max_delay != chrono::SystemClock::duration::zero()) {
+    last_notified_ = chrono::SystemClock::now();
   }
 }
 
@@ -198,10 +344,12 @@ Status MultiSink::UnsafeForEachEntry(
     const Function<void(ConstByteSpan)>& callback, size_t max_num_entries) {
   MultiSink::UnsafeIterationWrapper multisink_iteration = UnsafeIteration();
 
-  // First count the number of entries.
+  // Count the entries that can be read, unless all of them are logged anyway.
   size_t num_entries = 0;
-  for ([[maybe_unused]] ConstByteSpan entry : multisink_iteration) {
-    num_entries++;
+  if (max_num_entries < oldest_entry_drain_.reader_.EntryCount()) {
+    for ([[maybe_unused]] ConstByteSpan entry : multisink_iteration) {
+      num_entries++;
+    }
   }
 
   // Log up to the max number of logs to avoid overflowing the crash log
@@ -228,6 +376,18 @@ Status MultiSink::Drain::PopEntry(const PeekedEntry& entry) {
   return multisink_->PopEntry(*this, entry);
 }
 
+StatusWithSize MultiSink::Drain::PopEntries(ByteSpan buffer,
+                                            span<ConstByteSpan> entries_out,
+                                            uint32_t& drain_drop_count_out,
+                                            uint32_t& ingress_drop_count_out) {
+  PW_DCHECK_NOTNULL(multisink_);
+  return multisink_->PopEntries(*this,
+                                buffer,
+                                entries_out,
+                                drain_drop_count_out,
+                                ingress_drop_count_out);
+}
+
 Result<MultiSink::Drain::PeekedEntry> MultiSink::Drain::PeekEntry(
     ByteSpan buffer,
     uint32_t& drain_drop_count_out,
@@ -0,0 +1,71 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_multisink/multisink.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::multisink {
+namespace {
+
+constexpr size_t kMaxDrains = 4;
+constexpr size_t kEntrySize = 32;
+
+// Pushes an entry and pops it from each attached drain, as a log entry is
+// forwarded to each of its readers.
+void PushPopTest(perf_test::State& state, int64_t drain_count) {
+  std::array<std::byte, 1024> buffer;
+  MultiSink multisink(buffer);
+  std::array<MultiSink::Drain, kMaxDrains> drains;
+  for (size_t i = 0; i < static_cast<size_t>(drain_count); ++i) {
+    multisink.AttachDrain(drains[i]);
+  }
+
+  std::array<std::byte, kEntrySize> entry;
+  entry.fill(std::byte{0x5A});
+  std::array<std::byte, kEntrySize> output;
+  uint32_t drain_drops = 0;
+  uint32_t ingress_drops = 0;
+  while (state.KeepRunning()) {
+    multisink.HandleEntry(entry);
+    for (size_t i = 0; i < static_cast<size_t>(drain_count); ++i) {
+      drains[i].PopEntry(output, drain_drops, ingress_drops).IgnoreError();
+    }
+  }
+
+  for (size_t i = 0; i < static_cast<size_t>(drain_count); ++i) {
+    multisink.DetachDrain(drains[i]);
+  }
+}
+
+// Pushes entries with no drains reading, so each push evicts an older entry.
+void PushEvictingTest(perf_test::State& state) {
+  std::array<std::byte, 256> buffer;
+  MultiSink multisink(buffer);
+  std::array<std::byte, kEntrySize> entry;
+  entry.fill(std::byte{0x5A});
+  while (state.KeepRunning()) {
+    multisink.HandleEntry(entry);
+  }
+}
+
+PW_PERF_TEST_RANGE(PushPop, PushPopTest, 1, kMaxDrains, 2);
+PW_PERF_TEST(PushEvicting, PushEvictingTest);
+
+}  // namespace
+}  // namespace pw::multisink
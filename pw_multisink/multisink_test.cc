@@ -17,6 +17,7 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <optional>
 #include <string_view>
 
@@ -248,6 +249,59 @@ TEST_F(MultiSinkTest, DynamicDrainRegistration) {
   VerifyPopEntry(drains_[0], std::nullopt, 0u, 0u);
 }
 
+TEST_F(MultiSinkTest, CoalescedNotifications) {
+  multisink_.SetListenerNotificationCoalescing(
+      4, chrono::SystemClock::duration::zero());
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachListener(listeners_[0]);
+  multisink_.AttachListener(listeners_[1]);
+  ExpectNotificationCount(listeners_[0], 1u);
+  ExpectNotificationCount(listeners_[1], 1u);
+
+  // Listeners that were notified on attach are not notified again until they
+  // rearm or four more entries arrive.
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleDropped();
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 0u);
+  ExpectNotificationCount(listeners_[1], 0u);
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 1u);
+  ExpectNotificationCount(listeners_[1], 1u);
+
+  // A rearmed listener is notified of the next entry only.
+  multisink_.RearmListener(listeners_[0]);
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+  VerifyPopEntry(drains_[0], kMessage, 0u, 1u);
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u, 0u);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 1u);
+  ExpectNotificationCount(listeners_[1], 0u);
+
+  multisink_.DetachListener(listeners_[0]);
+  multisink_.DetachListener(listeners_[1]);
+}
+
+TEST_F(MultiSinkTest, CoalescedNotificationsTimeout) {
+  multisink_.SetListenerNotificationCoalescing(
+      std::numeric_limits<uint32_t>::max(),
+      chrono::SystemClock::duration(1));
+  multisink_.AttachListener(listeners_[0]);
+  ExpectNotificationCount(listeners_[0], 1u);
+
+  // Wait for the timeout to pass since the notification on attach.
+  const chrono::SystemClock::time_point start = chrono::SystemClock::now();
+  while (chrono::SystemClock::now() - start <
+         chrono::SystemClock::duration(1)) {
+  }
+  multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 1u);
+
+  multisink_.DetachListener(listeners_[0]);
+}
+
 TEST_F(MultiSinkTest, TooSmallBuffer) {
   multisink_.AttachDrain(drains_[0]);
 
@@ -532,6 +586,185 @@ TEST_F(MultiSinkTest, DetachedDrainReportsDropCount) {
   VerifyPopEntry(drains_[0], kMessage, 0, ingress_drops);
 }
 
+TEST_F(MultiSinkTest, PopEntries) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(kMessageOther);
+  multisink_.HandleEntry(kMessage);
+
+  std::array<ConstByteSpan, 4> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  StatusWithSize result = drains_[0].PopEntries(
+      entry_buffer_, entries, drop_count, ingress_drop_count);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), 3u);
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 0u);
+  EXPECT_EQ(std::memcmp(entries[0].data(), kMessage, sizeof(kMessage)), 0);
+  EXPECT_EQ(
+      std::memcmp(entries[1].data(), kMessageOther, sizeof(kMessageOther)), 0);
+  EXPECT_EQ(std::memcmp(entries[2].data(), kMessage, sizeof(kMessage)), 0);
+  // Entries are stored back-to-back in the buffer.
+  EXPECT_EQ(entries[1].data(), entries[0].data() + entries[0].size());
+
+  result = drains_[0].PopEntries(
+      entry_buffer_, entries, drop_count, ingress_drop_count);
+  EXPECT_EQ(result.status(), Status::OutOfRange());
+  EXPECT_EQ(result.size(), 0u);
+}
+
+TEST_F(MultiSinkTest, PopEntriesStopsWhenFull) {
+  multisink_.AttachDrain(drains_[0]);
+  for (int i = 0; i < 4; ++i) {
+    multisink_.HandleEntry(kMessage);
+  }
+
+  // Limited by the number of entries.
+  std::array<ConstByteSpan, 2> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  StatusWithSize result = drains_[0].PopEntries(
+      entry_buffer_, entries, drop_count, ingress_drop_count);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 2u);
+
+  // Limited by the buffer size. The entry that doesn't fit is kept.
+  result = drains_[0].PopEntries(span(entry_buffer_).first(sizeof(kMessage)),
+                                 entries,
+                                 drop_count,
+                                 ingress_drop_count);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 1u);
+
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 0);
+}
+
+TEST_F(MultiSinkTest, PopEntriesReportsDropCounts) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleDropped(3);
+  multisink_.HandleEntry(kMessageOther);
+  multisink_.HandleDropped(1);
+
+  std::array<ConstByteSpan, 4> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  StatusWithSize result = drains_[0].PopEntries(
+      entry_buffer_, entries, drop_count, ingress_drop_count);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 2u);
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 4u);
+
+  // An entry too large for the whole buffer is discarded, like PopEntry.
+  multisink_.HandleEntry(kMessage);
+  std::byte small_buffer[sizeof(kMessage) - 1];
+  result = drains_[0].PopEntries(
+      small_buffer, entries, drop_count, ingress_drop_count);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(result.size(), 0u);
+}
+
+TEST_F(MultiSinkTest, IngressEntriesAvailableToDrains) {
+  LockFreeIngressBuffer<4, sizeof(kMessage)> ingress;
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachDrain(drains_[1]);
+  multisink_.AttachIngress(ingress);
+
+  ASSERT_EQ(ingress.Push(kMessage), OkStatus());
+  ASSERT_EQ(ingress.Push(kMessageOther), OkStatus());
+
+  // Drains pull committed entries from the ingress queue.
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  VerifyPopEntry(drains_[0], kMessageOther, 0, 0);
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 0);
+  VerifyPopEntry(drains_[1], kMessage, 0, 0);
+  VerifyPopEntry(drains_[1], kMessageOther, 0, 0);
+  VerifyPopEntry(drains_[1], std::nullopt, 0, 0);
+
+  // Entries pushed through HandleEntry share the same sequence.
+  multisink_.HandleEntry(kMessageOther);
+  ASSERT_EQ(ingress.Push(kMessage), OkStatus());
+  VerifyPopEntry(drains_[0], kMessageOther, 0, 0);
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 0);
+
+  multisink_.DetachIngress();
+}
+
+TEST_F(MultiSinkTest, IngressSlotsReusedAfterDraining) {
+  LockFreeIngressBuffer<2, sizeof(kMessage)> ingress;
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachIngress(ingress);
+
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(ingress.Push(kMessage), OkStatus());
+    ASSERT_EQ(ingress.Push(kMessageOther), OkStatus());
+    VerifyPopEntry(drains_[0], kMessage, 0, 0);
+    VerifyPopEntry(drains_[0], kMessageOther, 0, 0);
+  }
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 0);
+
+  multisink_.DetachIngress();
+}
+
+TEST_F(MultiSinkTest, IngressReportsDrops) {
+  LockFreeIngressBuffer<2, sizeof(kMessage)> ingress;
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachIngress(ingress);
+
+  constexpr std::byte kTooLarge[sizeof(kMessage) + 1] = {};
+  EXPECT_EQ(ingress.Push(kTooLarge), Status::InvalidArgument());
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 1);
+
+  ASSERT_EQ(ingress.Push(kMessage), OkStatus());
+  ASSERT_EQ(ingress.Push(kMessageOther), OkStatus());
+  EXPECT_EQ(ingress.Push(kMessage), Status::ResourceExhausted());
+  EXPECT_EQ(ingress.Push(kMessage), Status::ResourceExhausted());
+
+  // Drops are reported after the entries that were committed before the queue
+  // filled up.
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  VerifyPopEntry(drains_[0], kMessageOther, 0, 0);
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 2);
+
+  multisink_.DetachIngress();
+}
+
+TEST_F(MultiSinkTest, FlushIngressNotifiesListeners) {
+  LockFreeIngressBuffer<4, sizeof(kMessage)> ingress;
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachListener(listeners_[0]);
+  ExpectNotificationCount(listeners_[0], 1u);
+
+  // Flushing without an ingress queue or without entries does not notify.
+  multisink_.FlushIngress();
+  multisink_.AttachIngress(ingress);
+  multisink_.FlushIngress();
+  ExpectNotificationCount(listeners_[0], 0u);
+
+  // Pushing to the ingress queue does not notify listeners by itself.
+  ASSERT_EQ(ingress.Push(kMessage), OkStatus());
+  ASSERT_EQ(ingress.Push(kMessageOther), OkStatus());
+  ExpectNotificationCount(listeners_[0], 0u);
+
+  multisink_.FlushIngress();
+  ExpectNotificationCount(listeners_[0], 1u);
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  VerifyPopEntry(drains_[0], kMessageOther, 0, 0);
+
+  // Detaching flushes the remaining entries.
+  ASSERT_EQ(ingress.Push(kMessage), OkStatus());
+  multisink_.DetachIngress();
+  ExpectNotificationCount(listeners_[0], 1u);
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 0);
+
+  multisink_.DetachListener(listeners_[0]);
+}
+
 TEST(UnsafeIteration, NoLimit) {
   constexpr std::array<std::string_view, 5> kExpectedEntries{
       "one", "two", "three", "four", "five"};
@@ -17,6 +17,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_containers/vector.h"
+#include "pw_multisink/lock_free_ingress.h"
 #include "pw_multisink/multisink.h"
 #include "pw_multisink/test_thread.h"
 #include "pw_span/span.h"
@@ -181,6 +182,26 @@ class LogWriterThread : public thread::ThreadCore {
   const MessageSpan& message_stack_;
 };
 
+// Pushes the provided messages to a lock-free ingress queue. Messages that do
+// not fit in the queue are dropped.
+class IngressWriterThread : public thread::ThreadCore {
+ public:
+  IngressWriterThread(LockFreeIngress& ingress,
+                      const MessageSpan& message_stack)
+      : ingress_(ingress), message_stack_(message_stack) {}
+
+  void Run() override {
+    for (const auto& message : message_stack_) {
+      ingress_.Push(as_bytes(span(std::string_view(message)))).IgnoreError();
+      pw::this_thread::yield();
+    }
+  }
+
+ private:
+  LockFreeIngress& ingress_;
+  const MessageSpan& message_stack_;
+};
+
 class MultiSinkTest : public ::testing::Test {
  protected:
   MultiSinkTest() : multisink_(buffer_) {}
@@ -332,6 +353,46 @@ TEST_F(MultiSinkTest, MultipleWritersMultipleReaders) {
             expected_message_and_drop_count - drop_count);
 }
 
+TEST_F(MultiSinkTest, MultipleIngressWritersMultipleReaders) {
+  const uint32_t log_count = 100;
+  const uint32_t expected_message_and_drop_count = 2 * log_count;
+  const auto message_stack = MessagePool::Instance().GetMessages(log_count);
+  LockFreeIngressBuffer<16, kEntryBufferSize> ingress;
+  multisink_.AttachIngress(ingress);
+
+  // Start reader threads.
+  LogPopReaderThread reader_thread_core1(multisink_,
+                                         expected_message_and_drop_count);
+  thread::Thread reader_thread1(test::MultiSinkTestThreadOptions(),
+                                reader_thread_core1);
+  LogPeekAndCommitReaderThread reader_thread_core2(
+      multisink_, expected_message_and_drop_count);
+  thread::Thread reader_thread2(test::MultiSinkTestThreadOptions(),
+                                reader_thread_core2);
+  // Start writer threads.
+  IngressWriterThread writer_thread_core1(ingress, message_stack);
+  thread::Thread writer_thread1(test::MultiSinkTestThreadOptions(),
+                                writer_thread_core1);
+  IngressWriterThread writer_thread_core2(ingress, message_stack);
+  thread::Thread writer_thread2(test::MultiSinkTestThreadOptions(),
+                                writer_thread_core2);
+
+  writer_thread1.join();
+  writer_thread2.join();
+  reader_thread1.join();
+  reader_thread2.join();
+  multisink_.DetachIngress();
+
+  // Messages that did not fit in the ingress queue are reported as drops, so
+  // every message is accounted for by each reader.
+  EXPECT_EQ(reader_thread_core1.received_messages().size() +
+                reader_thread_core1.drop_count(),
+            expected_message_and_drop_count);
+  EXPECT_EQ(reader_thread_core2.received_messages().size() +
+                reader_thread_core2.drop_count(),
+            expected_message_and_drop_count);
+}
+
 TEST_F(MultiSinkTest, OverflowMultisink) {
   // Expect the multisink to overflow and readers to not fail when poping, or
   // peeking and commiting entries.
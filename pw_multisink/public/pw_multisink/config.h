@@ -22,6 +22,23 @@
 #define PW_MULTISINK_CONFIG_LOCK_INTERRUPT_SAFE 1
 #endif  // !defined(PW_MULTISINK_CONFIG_LOCK_INTERRUPT_SAFE)
 
+// PW_MULTISINK_CONFIG_LISTENER_NOTIFY_ENTRIES is the default number of entries
+// after which a listener that was notified, but has not called
+// MultiSink::RearmListener since, is notified again. The default of 1 notifies
+// listeners of every entry. Larger values coalesce the notifications sent
+// during bursts of entries. See MultiSink::SetListenerNotificationCoalescing.
+#if !defined(PW_MULTISINK_CONFIG_LISTENER_NOTIFY_ENTRIES)
+#define PW_MULTISINK_CONFIG_LISTENER_NOTIFY_ENTRIES 1
+#endif  // !defined(PW_MULTISINK_CONFIG_LISTENER_NOTIFY_ENTRIES)
+
+// PW_MULTISINK_CONFIG_LISTENER_NOTIFY_TIMEOUT_MS is the default time after
+// which a listener that was notified, but has not called
+// MultiSink::RearmListener since, is notified of the next entry. 0 disables
+// the timeout.
+#if !defined(PW_MULTISINK_CONFIG_LISTENER_NOTIFY_TIMEOUT_MS)
+#define PW_MULTISINK_CONFIG_LISTENER_NOTIFY_TIMEOUT_MS 0
+#endif  // !defined(PW_MULTISINK_CONFIG_LISTENER_NOTIFY_TIMEOUT_MS)
+
 #if PW_MULTISINK_CONFIG_LOCK_INTERRUPT_SAFE
 #include "pw_sync/interrupt_spin_lock.h"
 #else  // !PW_MULTISINK_CONFIG_LOCK_INTERRUPT_SAFE
@@ -0,0 +1,136 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_alignment/alignment.h"
+#include "pw_bytes/span.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw {
+namespace multisink {
+
+class MultiSink;
+
+// A bounded multi-producer single-consumer queue that stages entries for a
+// MultiSink without taking the multisink's lock.
+//
+// Producers reserve a slot with an atomic compare-and-swap, copy the entry into
+// it, and commit it with a release store. Push never blocks and never waits on
+// another producer, so it may be called from any thread or interrupt context,
+// even when PW_MULTISINK_CONFIG_LOCK_INTERRUPT_SAFE is disabled. Entries that
+// do not fit are dropped and reported to drains as ingress drops.
+//
+// The attached MultiSink is the only consumer. It moves committed entries into
+// its ring buffer, in commit order, whenever a drain peeks or pops, or when
+// MultiSink::FlushIngress is called.
+class LockFreeIngress {
+ public:
+  static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                "LockFreeIngress requires lock-free 32-bit atomics");
+
+  LockFreeIngress(const LockFreeIngress&) = delete;
+  LockFreeIngress& operator=(const LockFreeIngress&) = delete;
+
+  // Copies an entry into the queue. Lock-free and interrupt-safe.
+  //
+  // Returns:
+  //   OK - The entry was committed to the queue.
+  //   RESOURCE_EXHAUSTED - Every slot is in use; the entry was dropped.
+  //   INVALID_ARGUMENT - The entry is larger than max_entry_size(); the entry
+  //       was dropped.
+  Status Push(ConstByteSpan entry);
+
+  // The number of entries that can be staged before they are flushed.
+  size_t capacity() const { return sequences_.size(); }
+
+  // The largest entry that may be pushed.
+  size_t max_entry_size() const { return max_entry_size_; }
+
+ protected:
+  // The number of slots must be a power of two so that slot indices stay
+  // consistent when the 32-bit positions wrap.
+  LockFreeIngress(span<std::atomic<uint32_t>> sequences,
+                  span<size_t> sizes,
+                  ByteSpan data,
+                  size_t max_entry_size);
+
+  // Marks every slot as free. Derived classes that own the storage must call
+  // this once the storage is constructed.
+  void Initialize();
+
+ private:
+  friend MultiSink;
+
+  // Consumer-side operations, called only by the attached MultiSink with its
+  // lock held.
+
+  // Sets `entry` to the oldest committed entry. Returns false if the next
+  // slot has not been committed yet.
+  bool PeekFront(ConstByteSpan& entry) const;
+
+  // Releases the slot returned by PeekFront back to producers.
+  void PopFront();
+
+  // Returns the number of entries dropped since the last call.
+  uint32_t TakeDropCount() {
+    return drop_count_.exchange(0, std::memory_order_relaxed);
+  }
+
+  ByteSpan slot_data(size_t slot) const {
+    return data_.subspan(slot * max_entry_size_, max_entry_size_);
+  }
+
+  // Each slot's sequence number encodes its state for a given position:
+  // `position` when free, `position + 1` once committed.
+  const span<std::atomic<uint32_t>> sequences_;
+  const span<size_t> sizes_;
+  const ByteSpan data_;
+  const size_t max_entry_size_;
+
+  // Producers and the consumer write different cache lines, if
+  // PW_ALIGNMENT_CACHE_LINE_PADDING is enabled.
+  PW_CACHELINE_ALIGNED_IF_PADDED std::atomic<uint32_t> enqueue_position_;
+  std::atomic<uint32_t> drop_count_;
+  PW_CACHELINE_ALIGNED_IF_PADDED uint32_t dequeue_position_;  // Consumer only.
+};
+
+// LockFreeIngress with internal storage for kMaxEntries entries of up to
+// kMaxEntrySize bytes each.
+template <size_t kMaxEntries, size_t kMaxEntrySize>
+class LockFreeIngressBuffer : public LockFreeIngress {
+ public:
+  static_assert(kMaxEntries > 0 && (kMaxEntries & (kMaxEntries - 1)) == 0,
+                "kMaxEntries must be a power of two");
+  static_assert(kMaxEntrySize > 0, "Entries must be allowed to hold data");
+
+  LockFreeIngressBuffer()
+      : LockFreeIngress(
+            sequence_storage_, size_storage_, data_storage_, kMaxEntrySize) {
+    Initialize();
+  }
+
+ private:
+  std::array<std::atomic<uint32_t>, kMaxEntries> sequence_storage_{};
+  std::array<size_t, kMaxEntries> size_storage_{};
+  std::array<std::byte, kMaxEntries * kMaxEntrySize> data_storage_{};
+};
+
+}  // namespace multisink
+}  // namespace pw
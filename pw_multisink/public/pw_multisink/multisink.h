@@ -16,12 +16,16 @@
 #include <limits>
 #include <mutex>
 
+#include "pw_alignment/alignment.h"
 #include "pw_bytes/span.h"
+#include "pw_chrono/system_clock.h"
 #include "pw_function/function.h"
 #include "pw_multisink/config.h"
+#include "pw_multisink/lock_free_ingress.h"
 #include "pw_result/result.h"
 #include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 #include "pw_sync/lock_annotations.h"
 
 namespace pw {
@@ -32,7 +36,9 @@ namespace multisink {
 // scenarios where readers need to be aware of the input message sequence.
 //
 // This class is thread-safe but NOT IRQ-safe when
-// PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled.
+// PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled. Producers that must never
+// block, such as interrupt handlers, may push entries through an attached
+// LockFreeIngress instead of calling HandleEntry.
 class MultiSink {
  public:
   // An asynchronous reader which is attached to a MultiSink via AttachDrain.
@@ -149,6 +155,43 @@ class MultiSink {
       return result;
     }
 
+    // Pops as many entries as fit in `buffer`, up to `entries_out.size()`,
+    // while acquiring the multisink's lock only once. Entries are copied
+    // back-to-back into `buffer` and `entries_out` is filled with views of
+    // them, in order.
+    //
+    // The drop counts are the totals across all of the popped entries, as if
+    // PopEntry had been called for each one. An entry that does not fit in the
+    // remaining space is left in the multisink for the next call.
+    //
+    // Example Usage:
+    //
+    //  std::array<ConstByteSpan, 8> entries;
+    //  uint32_t drop_count = 0;
+    //  uint32_t ingress_drop_count = 0;
+    //  const StatusWithSize result =
+    //      drain.PopEntries(buffer, entries, drop_count, ingress_drop_count);
+    //  ProcessDropCounts(drop_count, ingress_drop_count);
+    //  for (ConstByteSpan entry : span(entries).first(result.size())) {
+    //    ProcessEntry(entry);
+    //  }
+    //
+    // Precondition: the buffer data must not be corrupt, otherwise there will
+    // be a crash.
+    //
+    // Return values:
+    // OK - One or more entries were read from the multisink; the size is the
+    // number of entries.
+    // OUT_OF_RANGE - No entries were available.
+    // FAILED_PRECONDITION - The drain must be attached to a sink.
+    // RESOURCE_EXHAUSTED - The provided buffer was not large enough to store
+    // the next available entry, which was discarded.
+    StatusWithSize PopEntries(ByteSpan buffer,
+                              span<ConstByteSpan> entries_out,
+                              uint32_t& drain_drop_count_out,
+                              uint32_t& ingress_drop_count_out)
+        PW_LOCKS_EXCLUDED(multisink_->lock_);
+
     // Removes the previously peeked entry from the multisink.
     //
     // Example Usage:
@@ -236,6 +279,21 @@ class MultiSink {
     // available. The multisink lock is held during this call, so neither the
     // multisink nor it's drains can be used during this callback.
     virtual void OnNewEntryAvailable() = 0;
+
+   private:
+    // Returns whether to notify the listener of a new entry, given the
+    // multisink's coalescing settings. Guarded by the multisink's lock.
+    bool ShouldNotify(uint32_t max_entries,
+                      chrono::SystemClock::duration max_delay);
+
+    // Records that the listener was notified. Guarded by the multisink's lock.
+    void MarkNotified(chrono::SystemClock::duration max_delay);
+
+    // Whether the listener is waiting to be notified. The multisink's lock is
+    // held when these are used.
+    bool armed_ = true;
+    uint32_t unnotified_entries_ = 0;
+    chrono::SystemClock::time_point last_notified_;
   };
 
   class iterator {
@@ -311,7 +369,14 @@ class MultiSink {
 
   // Constructs a multisink using a ring buffer backed by the provided buffer.
   MultiSink(ByteSpan buffer)
-      : ring_buffer_(true), sequence_id_(0), total_ingress_drops_(0) {
+      : ring_buffer_(true),
+        ingress_(nullptr),
+        sequence_id_(0),
+        total_ingress_drops_(0),
+        listener_notify_entries_(PW_MULTISINK_CONFIG_LISTENER_NOTIFY_ENTRIES),
+        listener_notify_delay_(chrono::SystemClock::for_at_least(
+            std::chrono::milliseconds(
+                PW_MULTISINK_CONFIG_LISTENER_NOTIFY_TIMEOUT_MS))) {
     ring_buffer_.SetBuffer(buffer)
         .IgnoreError();  // TODO(b/242598609): Handle Status properly
     AttachDrain(oldest_entry_drain_);
@@ -354,7 +419,8 @@ class MultiSink {
   // entries. If draining in response to the notification, ensure that the drain
   // is attached prior to registering the listener; attempting to drain when
   // unattached will crash. Once attached, listeners are invoked on all new
-  // messages.
+  // messages, unless notifications are coalesced as described in
+  // SetListenerNotificationCoalescing.
   //
   // Precondition: The listener must not be attached to a multisink.
   void AttachListener(Listener& listener) PW_LOCKS_EXCLUDED(lock_);
@@ -364,6 +430,53 @@ class MultiSink {
   // Precondition: The listener must be attached to this multisink.
   void DetachListener(Listener& listener) PW_LOCKS_EXCLUDED(lock_);
 
+  // Coalesces the notifications sent to listeners during bursts of entries.
+  //
+  // Once notified, a listener is not notified again until it calls
+  // RearmListener, which it should do right before draining all available
+  // entries. Until then, it is only notified again after max_entries more
+  // entries, or of the first entry that arrives max_delay or more after its
+  // last notification. A zero max_delay disables the timeout.
+  //
+  // A max_entries of 1, the default, notifies listeners of every entry and
+  // makes RearmListener unnecessary. The defaults are set by
+  // PW_MULTISINK_CONFIG_LISTENER_NOTIFY_ENTRIES and
+  // PW_MULTISINK_CONFIG_LISTENER_NOTIFY_TIMEOUT_MS.
+  //
+  // Precondition: max_entries must not be 0.
+  void SetListenerNotificationCoalescing(
+      uint32_t max_entries, chrono::SystemClock::duration max_delay)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Notifies the listener of the next entry, regardless of coalescing. Call
+  // this before draining all available entries in response to a notification,
+  // so that entries added while draining are not missed.
+  //
+  // Precondition: The listener must be attached to this multisink.
+  void RearmListener(Listener& listener) PW_LOCKS_EXCLUDED(lock_);
+
+  // Attaches a lock-free ingress queue to the multisink. Entries pushed to the
+  // queue are moved into the multisink whenever a drain peeks or pops, or when
+  // FlushIngress is called. Entries dropped by the queue are reported to
+  // drains as ingress drops.
+  //
+  // Precondition: No ingress queue is attached to the multisink.
+  // Precondition: ingress.max_entry_size() <= `ring_buffer_` size
+  void AttachIngress(LockFreeIngress& ingress) PW_LOCKS_EXCLUDED(lock_);
+
+  // Flushes and detaches the ingress queue attached to the multisink.
+  //
+  // Precondition: An ingress queue is attached to the multisink and all of its
+  // producers have stopped pushing entries.
+  void DetachIngress() PW_LOCKS_EXCLUDED(lock_);
+
+  // Moves the entries committed to the attached ingress queue into the
+  // multisink and notifies listeners if there were any. Does nothing if no
+  // ingress queue is attached. Ingress producers do not notify listeners, so
+  // call this from a thread context, e.g. periodically or after an interrupt
+  // handler signals that it pushed entries.
+  void FlushIngress() PW_LOCKS_EXCLUDED(lock_);
+
   // Removes all data from the internal buffer. The multisink's sequence ID is
   // not modified, so readers may interpret this event as droppping entries.
   void Clear() PW_LOCKS_EXCLUDED(lock_);
@@ -377,7 +490,8 @@ class MultiSink {
   //   DATA_LOSS - Corruption detected, some entries may have been lost.
   Status UnsafeForEachEntry(
       const Function<void(ConstByteSpan)>& callback,
-      size_t max_num_entries = std::numeric_limits<size_t>::max());
+      size_t max_num_entries = std::numeric_limits<size_t>::max())
+      PW_NO_LOCK_SAFETY_ANALYSIS;
 
  protected:
   friend Drain;
@@ -411,16 +525,43 @@ class MultiSink {
                                        uint32_t& entry_sequence_id_out)
       PW_LOCKS_EXCLUDED(lock_);
 
+  // Pops consecutive entries for the provided drain with a single lock
+  // acquisition. See Drain::PopEntries.
+  StatusWithSize PopEntries(Drain& drain,
+                            ByteSpan buffer,
+                            span<ConstByteSpan> entries_out,
+                            uint32_t& drain_drop_count_out,
+                            uint32_t& ingress_drop_count_out)
+      PW_LOCKS_EXCLUDED(lock_);
+
  private:
+  Result<ConstByteSpan> PeekOrPopEntryLocked(Drain& drain,
+                                             ByteSpan buffer,
+                                             Request request,
+                                             uint32_t& drain_drop_count_out,
+                                             uint32_t& ingress_drop_count_out,
+                                             uint32_t& entry_sequence_id_out)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Notifies attached listeners of new entries or an updated drop count.
   void NotifyListeners() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Moves committed entries and drops from the ingress queue, if any, into the
+  // ring buffer. Returns true if the multisink changed.
+  bool FlushIngressLocked() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   IntrusiveList<Listener> listeners_ PW_GUARDED_BY(lock_);
   ring_buffer::PrefixedEntryRingBufferMulti ring_buffer_ PW_GUARDED_BY(lock_);
   Drain oldest_entry_drain_ PW_GUARDED_BY(lock_);
+  LockFreeIngress* ingress_ PW_GUARDED_BY(lock_);
   uint32_t sequence_id_ PW_GUARDED_BY(lock_);
   uint32_t total_ingress_drops_ PW_GUARDED_BY(lock_);
-  LockType lock_;
+  uint32_t listener_notify_entries_ PW_GUARDED_BY(lock_);
+  chrono::SystemClock::duration listener_notify_delay_ PW_GUARDED_BY(lock_);
+
+  // Threads waiting for the lock do not contend for the ring buffer's cache
+  // lines, if PW_ALIGNMENT_CACHE_LINE_PADDING is enabled.
+  PW_CACHELINE_ALIGNED_IF_PADDED LockType lock_;
 };
 
 }  // namespace multisink
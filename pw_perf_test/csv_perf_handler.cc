@@ -0,0 +1,73 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_perf_test/csv_perf_handler.h"
+
+#include "pw_bytes/span.h"
+#include "pw_perf_test/internal/timer.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::perf_test {
+namespace {
+
+constexpr char kHeader[] =
+    "name,parameter,unit,iterations,outliers,mean,min,max,median,p90,p99,"
+    "stddev,ci95";
+
+}  // namespace
+
+void CsvEventHandler::RunAllTestsStart(const TestRunInfo&) {
+  header_written_ = false;
+}
+
+void CsvEventHandler::TestCaseEnd(const TestCase& info,
+                                  const Results& end_result) {
+  // Every test reports the same counters, so the header is written with the
+  // first test's results.
+  if (!header_written_) {
+    StringBuffer<256> header;
+    header << kHeader;
+    for (const CounterResult& counter : end_result.counters) {
+      header << ',' << counter.name;
+    }
+    header << '\n';
+    writer_.Write(as_bytes(span(header.data(), header.size()))).IgnoreError();
+    header_written_ = true;
+  }
+
+  StringBuffer<256> row;
+  row.Format("%s,", info.name);
+  if (info.has_parameter) {
+    row.Format("%lld", static_cast<long long>(info.parameter));
+  }
+  row.Format(",%s,%d,%d,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%lld",
+             internal::GetDurationUnitStr(),
+             end_result.iterations,
+             end_result.outliers,
+             static_cast<long long>(end_result.mean),
+             static_cast<long long>(end_result.min),
+             static_cast<long long>(end_result.max),
+             static_cast<long long>(end_result.median),
+             static_cast<long long>(end_result.p90),
+             static_cast<long long>(end_result.p99),
+             static_cast<long long>(end_result.standard_deviation),
+             static_cast<long long>(end_result.confidence_interval));
+  for (const CounterResult& counter : end_result.counters) {
+    row.Format(",%lld", static_cast<long long>(counter.mean));
+  }
+  row << '\n';
+  writer_.Write(as_bytes(span(row.data(), row.size()))).IgnoreError();
+}
+
+}  // namespace pw::perf_test
@@ -0,0 +1,61 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_perf_test/json_perf_handler.h"
+
+#include "pw_bytes/span.h"
+#include "pw_perf_test/internal/timer.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::perf_test {
+
+void JsonEventHandler::TestCaseEnd(const TestCase& info,
+                                   const Results& end_result) {
+  // Test names are C++ identifiers, so need no escaping.
+  StringBuffer<512> line;
+  line.Format("{\"name\": \"%s\", ", info.name);
+  if (info.has_parameter) {
+    line.Format("\"parameter\": %lld, ",
+                static_cast<long long>(info.parameter));
+  }
+  line.Format(
+      "\"unit\": \"%s\", \"iterations\": %d, \"outliers\": %d, "
+      "\"mean\": %lld, \"min\": %lld, \"max\": %lld, \"median\": %lld, "
+      "\"p90\": %lld, \"p99\": %lld, \"stddev\": %lld, \"ci95\": %lld",
+      internal::GetDurationUnitStr(),
+      end_result.iterations,
+      end_result.outliers,
+      static_cast<long long>(end_result.mean),
+      static_cast<long long>(end_result.min),
+      static_cast<long long>(end_result.max),
+      static_cast<long long>(end_result.median),
+      static_cast<long long>(end_result.p90),
+      static_cast<long long>(end_result.p99),
+      static_cast<long long>(end_result.standard_deviation),
+      static_cast<long long>(end_result.confidence_interval));
+  if (!end_result.counters.empty()) {
+    line << ", \"counters\": {";
+    for (size_t i = 0; i < end_result.counters.size(); ++i) {
+      line.Format("%s\"%s\": %lld",
+                  i == 0 ? "" : ", ",
+                  end_result.counters[i].name,
+                  static_cast<long long>(end_result.counters[i].mean));
+    }
+    line << '}';
+  }
+  line << "}\n";
+  writer_.Write(as_bytes(span(line.data(), line.size()))).IgnoreError();
+}
+
+}  // namespace pw::perf_test
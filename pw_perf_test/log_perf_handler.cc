@@ -30,7 +30,13 @@ void LoggingEventHandler::RunAllTestsStart(const TestRunInfo& summary) {
 }
 
 void LoggingEventHandler::TestCaseStart(const TestCase& info) {
-  PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_CASE_START, info.name);
+  if (info.has_parameter) {
+    PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_PARAMETERIZED_CASE_START,
+                info.name,
+                static_cast<long>(info.parameter));
+  } else {
+    PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_CASE_START, info.name);
+  }
 }
 
 void LoggingEventHandler::TestCaseEnd(const TestCase& info,
@@ -43,7 +49,25 @@ void LoggingEventHandler::TestCaseEnd(const TestCase& info,
               static_cast<long>(end_result.max),
               internal::GetDurationUnitStr(),
               end_result.iterations);
-  PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_CASE_END, info.name);
+  PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_CASE_STATISTICS,
+              static_cast<long>(end_result.median),
+              static_cast<long>(end_result.p90),
+              static_cast<long>(end_result.p99),
+              static_cast<long>(end_result.standard_deviation),
+              static_cast<long>(end_result.confidence_interval),
+              end_result.outliers);
+  for (const CounterResult& counter : end_result.counters) {
+    PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_CASE_COUNTER,
+                counter.name,
+                static_cast<long>(counter.mean));
+  }
+  if (info.has_parameter) {
+    PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_PARAMETERIZED_CASE_END,
+                info.name,
+                static_cast<long>(info.parameter));
+  } else {
+    PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_CASE_END, info.name);
+  }
 }
 
 void LoggingEventHandler::RunAllTestsEnd() {
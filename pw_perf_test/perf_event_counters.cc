@@ -0,0 +1,91 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "pw_perf_test/internal/perf_event_counters_interface.h"
+
+namespace pw::perf_test::internal::counters_backend {
+namespace {
+
+// The events counted, in the order of kCounterNames.
+constexpr std::array<uint64_t, kCounterCount> kEvents = {
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+// The counters are opened as a group led by the first, so they are started
+// together and read with a single system call.
+std::array<int, kCounterCount> counter_fds = {-1, -1, -1};
+
+int OpenCounter(uint64_t event, int group_fd) {
+  perf_event_attr attributes = {};
+  attributes.size = sizeof(attributes);
+  attributes.type = PERF_TYPE_HARDWARE;
+  attributes.config = event;
+  attributes.disabled = group_fd == -1 ? 1 : 0;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  attributes.read_format = PERF_FORMAT_GROUP;
+  return static_cast<int>(syscall(SYS_perf_event_open,
+                                  &attributes,
+                                  0,   // The calling thread,
+                                  -1,  // on any CPU.
+                                  group_fd,
+                                  0));
+}
+
+}  // namespace
+
+bool CountersPrepare() {
+  for (size_t i = 0; i < kCounterCount; ++i) {
+    counter_fds[i] = OpenCounter(kEvents[i], i == 0 ? -1 : counter_fds[0]);
+    if (counter_fds[i] < 0) {
+      CountersCleanup();
+      return false;
+    }
+  }
+  ioctl(counter_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(counter_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+}
+
+void CountersCleanup() {
+  for (int& fd : counter_fds) {
+    if (fd >= 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+}
+
+void ReadCounters(CounterSnapshot& snapshot) {
+  // A group is read as the number of counters followed by their values.
+  std::array<uint64_t, kCounterCount + 1> values;
+  if (counter_fds[0] < 0 ||
+      read(counter_fds[0], values.data(), sizeof(values)) !=
+          static_cast<ssize_t>(sizeof(values))) {
+    snapshot = {};
+    return;
+  }
+  std::copy(values.begin() + 1, values.end(), snapshot.begin());
+}
+
+}  // namespace pw::perf_test::internal::counters_backend
@@ -0,0 +1,114 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_perf_test/csv_perf_handler.h"
+#include "pw_perf_test/json_perf_handler.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::perf_test {
+namespace {
+
+constexpr Results kResults = {.mean = 100,
+                              .max = 120,
+                              .min = 90,
+                              .iterations = 12,
+                              .median = 99,
+                              .p90 = 110,
+                              .p99 = 500,
+                              .standard_deviation = 8,
+                              .confidence_interval = 5,
+                              .outliers = 1,
+                              .counters = {}};
+
+constexpr CounterResult kCounters[] = {{.name = "instructions", .mean = 42},
+                                       {.name = "cache_misses", .mean = 3}};
+
+Results WithCounters() {
+  Results results = kResults;
+  results.counters = kCounters;
+  return results;
+}
+
+std::string_view Written(const stream::MemoryWriter& writer) {
+  return std::string_view(reinterpret_cast<const char*>(writer.data()),
+                          writer.bytes_written());
+}
+
+TEST(JsonEventHandler, WritesOneLinePerTest) {
+  stream::MemoryWriterBuffer<512> writer;
+  JsonEventHandler handler(writer);
+  handler.TestCaseEnd({.name = "Copy", .has_parameter = true, .parameter = 64},
+                      kResults);
+  handler.TestCaseEnd({.name = "Sum", .has_parameter = false, .parameter = 0},
+                      kResults);
+
+  EXPECT_EQ(Written(writer),
+            "{\"name\": \"Copy\", \"parameter\": 64, \"unit\": \"ns\", "
+            "\"iterations\": 12, \"outliers\": 1, \"mean\": 100, \"min\": 90, "
+            "\"max\": 120, \"median\": 99, \"p90\": 110, \"p99\": 500, "
+            "\"stddev\": 8, \"ci95\": 5}\n"
+            "{\"name\": \"Sum\", \"unit\": \"ns\", "
+            "\"iterations\": 12, \"outliers\": 1, \"mean\": 100, \"min\": 90, "
+            "\"max\": 120, \"median\": 99, \"p90\": 110, \"p99\": 500, "
+            "\"stddev\": 8, \"ci95\": 5}\n");
+}
+
+TEST(CsvEventHandler, WritesHeaderAndRows) {
+  stream::MemoryWriterBuffer<512> writer;
+  CsvEventHandler handler(writer);
+  handler.RunAllTestsStart({.total_tests = 2, .default_iterations = 10});
+  handler.TestCaseEnd({.name = "Copy", .has_parameter = true, .parameter = 64},
+                      kResults);
+  handler.TestCaseEnd({.name = "Sum", .has_parameter = false, .parameter = 0},
+                      kResults);
+
+  EXPECT_EQ(Written(writer),
+            "name,parameter,unit,iterations,outliers,mean,min,max,median,p90,"
+            "p99,stddev,ci95\n"
+            "Copy,64,ns,12,1,100,90,120,99,110,500,8,5\n"
+            "Sum,,ns,12,1,100,90,120,99,110,500,8,5\n");
+}
+
+TEST(JsonEventHandler, WritesCounters) {
+  stream::MemoryWriterBuffer<512> writer;
+  JsonEventHandler handler(writer);
+  handler.TestCaseEnd({.name = "Sum", .has_parameter = false, .parameter = 0},
+                      WithCounters());
+
+  EXPECT_EQ(Written(writer),
+            "{\"name\": \"Sum\", \"unit\": \"ns\", "
+            "\"iterations\": 12, \"outliers\": 1, \"mean\": 100, \"min\": 90, "
+            "\"max\": 120, \"median\": 99, \"p90\": 110, \"p99\": 500, "
+            "\"stddev\": 8, \"ci95\": 5, "
+            "\"counters\": {\"instructions\": 42, \"cache_misses\": 3}}\n");
+}
+
+TEST(CsvEventHandler, WritesCounterColumns) {
+  stream::MemoryWriterBuffer<512> writer;
+  CsvEventHandler handler(writer);
+  handler.RunAllTestsStart({.total_tests = 1, .default_iterations = 10});
+  handler.TestCaseEnd({.name = "Sum", .has_parameter = false, .parameter = 0},
+                      WithCounters());
+
+  EXPECT_EQ(Written(writer),
+            "name,parameter,unit,iterations,outliers,mean,min,max,median,p90,"
+            "p99,stddev,ci95,instructions,cache_misses\n"
+            "Sum,,ns,12,1,100,90,120,99,110,500,8,5,42,3\n");
+}
+
+}  // namespace
+}  // namespace pw::perf_test
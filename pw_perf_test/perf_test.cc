@@ -16,14 +16,70 @@
 
 #include "pw_perf_test/perf_test.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <limits>
 
 #include "pw_log/log.h"
 #include "pw_perf_test/event_handler.h"
+#include "pw_perf_test/internal/counters.h"
 #include "pw_perf_test/internal/timer.h"
 
 namespace pw::perf_test {
 namespace internal {
+namespace {
+
+// The z-score of a two-sided 95% confidence interval.
+constexpr float kZScore95 = 1.96f;
+
+// Scales the median absolute deviation to estimate the standard deviation of
+// normally distributed durations.
+constexpr float kMadToStandardDeviation = 1.4826f;
+
+// Returns the nearest-rank percentile of sorted durations.
+int64_t Percentile(span<const int64_t> sorted, size_t percent) {
+  const size_t rank = (percent * sorted.size() + 99) / 100;
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+int64_t Median(span<const int64_t> sorted) {
+  const size_t middle = sorted.size() / 2;
+  if (sorted.size() % 2 == 1) {
+    return sorted[middle];
+  }
+  return sorted[middle - 1] + (sorted[middle] - sorted[middle - 1]) / 2;
+}
+
+// Returns the median absolute deviation from the median of sorted durations,
+// without extra storage. The deviations of durations below and above the
+// median ascend moving outwards from it, so they are merged in order.
+int64_t MedianAbsoluteDeviation(span<const int64_t> sorted, int64_t median) {
+  const size_t count = sorted.size();
+  size_t above = static_cast<size_t>(
+      std::lower_bound(sorted.begin(), sorted.end(), median) - sorted.begin());
+  size_t below = above;  // The index after the next duration below.
+
+  const size_t last = count / 2;
+  int64_t previous = 0;
+  for (size_t i = 0; i <= last; ++i) {
+    int64_t deviation;
+    if (below == 0 || (above < count && sorted[above] - median <=
+                                            median - sorted[below - 1])) {
+      deviation = sorted[above++] - median;
+    } else {
+      deviation = median - sorted[--below];
+    }
+    if (i == last) {
+      return count % 2 == 1 ? deviation
+                            : previous + (deviation - previous) / 2;
+    }
+    previous = deviation;
+  }
+  return 0;
+}
+
+}  // namespace
 
 Framework Framework::framework_;
 
@@ -32,20 +88,54 @@ int Framework::RunAllTests() {
     return false;
   }
 
+  counters_prepared_ = internal::CountersPrepare();
+  if (!counters_prepared_) {
+    PW_LOG_WARN("Hardware event counters are unavailable");
+  }
+
   event_handler_->RunAllTestsStart(run_info_);
 
   for (const TestInfo* test = tests_; test != nullptr; test = test->next()) {
-    State test_state =
-        CreateState(kDefaultIterations, *event_handler_, test->test_name());
-    test->Run(test_state);
+    if (!test->has_parameters()) {
+      RunTestCase(*test,
+                  TestCase{.name = test->test_name(),
+                           .has_parameter = false,
+                           .parameter = 0});
+      continue;
+    }
+
+    const ParameterRange& parameters = test->parameters();
+    for (int64_t parameter = parameters.start;;
+         parameter = parameters.Next(parameter)) {
+      RunTestCase(*test,
+                  TestCase{.name = test->test_name(),
+                           .has_parameter = true,
+                           .parameter = parameter});
+      if (parameter >= parameters.limit) {
+        break;
+      }
+    }
+  }
+  if (counters_prepared_) {
+    internal::CountersCleanup();
   }
   internal::TimerCleanup();
   event_handler_->RunAllTestsEnd();
   return true;
 }
 
+void Framework::RunTestCase(const TestInfo& test, const TestCase& test_case) {
+  State test_state = CreateState(
+      kDefaultLimits, *event_handler_, test_case, counters_prepared_);
+  if (test_case.has_parameter) {
+    test.Run(test_state, test_case.parameter);
+  } else {
+    test.Run(test_state);
+  }
+}
+
 void Framework::RegisterTest(TestInfo& new_test) {
-  ++run_info_.total_tests;
+  run_info_.total_tests += new_test.test_cases();
   if (tests_ == nullptr) {
     tests_ = &new_test;
     return;
@@ -59,8 +149,70 @@ void Framework::RegisterTest(TestInfo& new_test) {
 State CreateState(int durations,
                   EventHandler& event_handler,
                   const char* test_name) {
-  return State(durations, event_handler, test_name);
+  return CreateState(
+      IterationLimits{.warmup = 0, .min = durations, .max = durations},
+      event_handler,
+      TestCase{.name = test_name, .has_parameter = false, .parameter = 0});
+}
+
+State CreateState(const IterationLimits& limits,
+                  EventHandler& event_handler,
+                  const TestCase& test_case,
+                  bool read_counters) {
+  return State(limits, event_handler, test_case, read_counters);
+}
+
+Results Summarize(span<int64_t> durations) {
+  PW_ASSERT(!durations.empty());
+  std::sort(durations.begin(), durations.end());
+
+  Results results{};
+  results.iterations = static_cast<int>(durations.size());
+  results.median = Median(durations);
+  results.p90 = Percentile(durations, 90);
+  results.p99 = Percentile(durations, 99);
+
+  // Keep the durations within the outlier threshold of the median. They are
+  // sorted, so these are contiguous.
+  const int64_t deviation =
+      MedianAbsoluteDeviation(durations, results.median);
+  span<const int64_t> kept = durations;
+  if (deviation > 0) {
+    const auto threshold = static_cast<int64_t>(
+        static_cast<float>(deviation) * kMadToStandardDeviation *
+        static_cast<float>(PW_PERF_TEST_OUTLIER_THRESHOLD));
+    const auto first = std::lower_bound(
+        durations.begin(), durations.end(), results.median - threshold);
+    const auto last = std::upper_bound(
+        first, durations.end(), results.median + threshold);
+    kept = span<const int64_t>(&*first, static_cast<size_t>(last - first));
+  }
+  results.outliers = static_cast<int>(durations.size() - kept.size());
+  results.min = kept.front();
+  results.max = kept.back();
+
+  int64_t total = 0;
+  for (int64_t duration : kept) {
+    total += duration;
+  }
+  results.mean = total / static_cast<int64_t>(kept.size());
+
+  if (kept.size() > 1) {
+    float squares = 0.0f;
+    for (int64_t duration : kept) {
+      const auto difference = static_cast<float>(duration - results.mean);
+      squares += difference * difference;
+    }
+    const float standard_deviation =
+        std::sqrt(squares / static_cast<float>(kept.size() - 1));
+    results.standard_deviation = static_cast<int64_t>(standard_deviation);
+    results.confidence_interval = static_cast<int64_t>(
+        kZScore95 * standard_deviation /
+        std::sqrt(static_cast<float>(kept.size())));
+  }
+  return results;
 }
+
 }  // namespace internal
 
 bool State::KeepRunning() {
@@ -68,36 +220,87 @@ bool State::KeepRunning() {
   if (current_iteration_ == -1) {
     ++current_iteration_;
     event_handler_->TestCaseStart(test_info);
-    iteration_start_ = internal::GetCurrentTimestamp();
+    StartIteration();
     return true;
   }
+  if (warmup_remaining_ > 0) {
+    --warmup_remaining_;
+    StartIteration();
+    return true;
+  }
+  RecordCounters();
   int64_t duration = internal::GetDuration(iteration_start_, iteration_end);
-  if (duration > max_) {
-    max_ = duration;
+  if (RecordDuration(duration)) {
+    Results results = internal::Summarize(
+        span(durations_.data(), static_cast<size_t>(current_iteration_)));
+    if (read_counters_) {
+      for (size_t i = 0; i < internal::kCounterCount; ++i) {
+        counter_results_[i] = {
+            .name = internal::GetCounterName(i),
+            .mean = counter_totals_[i] / current_iteration_,
+        };
+      }
+      results.counters = counter_results_;
+    }
+    PW_LOG_DEBUG("Mean: %ld, Median: %ld, Outliers: %d",
+                 static_cast<long>(results.mean),
+                 static_cast<long>(results.median),
+                 results.outliers);
+    event_handler_->TestCaseEnd(test_info, results);
+    return false;
+  }
+  StartIteration();
+  return true;
+}
+
+void State::StartIteration() {
+  // The counters are read outside of the timed section, so that reading them
+  // does not add to the duration.
+  if (read_counters_) {
+    internal::ReadCounters(counters_start_);
   }
-  if (duration < min_) {
-    min_ = duration;
+  iteration_start_ = internal::GetCurrentTimestamp();
+}
+
+void State::RecordCounters() {
+  if (!read_counters_) {
+    return;
   }
-  total_duration_ += duration;
+  internal::CounterSnapshot counters_end;
+  internal::ReadCounters(counters_end);
+  for (size_t i = 0; i < internal::kCounterCount; ++i) {
+    counter_totals_[i] +=
+        internal::GetCounterDelta(counters_start_, counters_end, i);
+  }
+}
+
+bool State::RecordDuration(int64_t duration) {
+  durations_[static_cast<size_t>(current_iteration_)] = duration;
   ++current_iteration_;
   PW_LOG_DEBUG("Iteration number: %d - Duration: %ld",
                current_iteration_,
                static_cast<long>(duration));
   event_handler_->TestCaseIteration({current_iteration_, duration});
-  if (current_iteration_ == test_iterations_) {
-    PW_LOG_DEBUG("Total Duration: %ld  Total Iterations: %d",
-                 static_cast<long>(total_duration_),
-                 test_iterations_);
-    mean_ = total_duration_ / test_iterations_;
-    PW_LOG_DEBUG("Mean: %ld: ", static_cast<long>(mean_));
-    PW_LOG_DEBUG("Minimum: %ld", static_cast<long>(min_));
-    PW_LOG_DEBUG("Maxmimum: %ld", static_cast<long>(max_));
-    event_handler_->TestCaseEnd(test_info,
-                                Results{mean_, max_, min_, test_iterations_});
+
+  const auto count = static_cast<float>(current_iteration_);
+  const float difference = static_cast<float>(duration) - running_mean_;
+  running_mean_ += difference / count;
+  running_m2_ += difference * (static_cast<float>(duration) - running_mean_);
+
+  if (current_iteration_ >= max_iterations_) {
+    return true;
+  }
+  if (current_iteration_ < min_iterations_ || current_iteration_ < 2) {
     return false;
   }
-  iteration_start_ = internal::GetCurrentTimestamp();
-  return true;
+  // Stop once the 95% confidence interval of the mean is narrow enough.
+  const float variance = running_m2_ / (count - 1.0f);
+  const float confidence_interval =
+      internal::kZScore95 * std::sqrt(variance / count);
+  return confidence_interval <=
+         running_mean_ *
+             static_cast<float>(PW_PERF_TEST_TARGET_CONFIDENCE_PERCENT) /
+             100.0f;
 }
 
 void RunAllTests(EventHandler& handler) {
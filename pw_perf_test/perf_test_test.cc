@@ -27,6 +27,13 @@ void SimpleFunction() {}
 
 void SimpleFunctionWithArgs(int, bool) {}
 
+void ParameterizedFunction(pw::perf_test::State& state, int64_t size, bool) {
+  while (state.KeepRunning()) {
+    for (volatile int64_t i = 0; i < size; i = i + 1) {
+    }
+  }
+}
+
 namespace pw::perf_test {
 namespace {
 
@@ -39,5 +46,12 @@ PW_PERF_TEST_SIMPLE(TestingSimpleRegistrationArgs,
                     123,
                     false);
 
+PW_PERF_TEST_RANGE(TestingRangeRegistration,
+                   ParameterizedFunction,
+                   1,
+                   64,
+                   4,
+                   true);
+
 }  // namespace
 }  // namespace pw::perf_test
@@ -0,0 +1,49 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// The number of iterations run before each test is measured, to warm up
+// caches and branch predictors. Their durations are discarded.
+#ifndef PW_PERF_TEST_WARMUP_ITERATIONS
+#define PW_PERF_TEST_WARMUP_ITERATIONS 2
+#endif  // PW_PERF_TEST_WARMUP_ITERATIONS
+
+// The number of iterations measured before a test may stop.
+#ifndef PW_PERF_TEST_MIN_ITERATIONS
+#define PW_PERF_TEST_MIN_ITERATIONS 10
+#endif  // PW_PERF_TEST_MIN_ITERATIONS
+
+// The most iterations measured per test. Each test's State stores this many
+// 8-byte durations, so this bounds the stack used by the framework.
+#ifndef PW_PERF_TEST_MAX_ITERATIONS
+#define PW_PERF_TEST_MAX_ITERATIONS 100
+#endif  // PW_PERF_TEST_MAX_ITERATIONS
+
+// Tests stop after the minimum number of iterations once the 95% confidence
+// interval of the mean duration is within this percentage of the mean.
+#ifndef PW_PERF_TEST_TARGET_CONFIDENCE_PERCENT
+#define PW_PERF_TEST_TARGET_CONFIDENCE_PERCENT 2
+#endif  // PW_PERF_TEST_TARGET_CONFIDENCE_PERCENT
+
+// Durations further than this many (scaled) median absolute deviations from
+// the median are outliers, such as iterations interrupted by the OS, and are
+// excluded from the mean, minimum, maximum and standard deviation.
+#ifndef PW_PERF_TEST_OUTLIER_THRESHOLD
+#define PW_PERF_TEST_OUTLIER_THRESHOLD 3
+#endif  // PW_PERF_TEST_OUTLIER_THRESHOLD
+
+static_assert(PW_PERF_TEST_MIN_ITERATIONS > 0 &&
+                  PW_PERF_TEST_MIN_ITERATIONS <= PW_PERF_TEST_MAX_ITERATIONS,
+              "PW_PERF_TEST_MIN_ITERATIONS must be from 1 to "
+              "PW_PERF_TEST_MAX_ITERATIONS");
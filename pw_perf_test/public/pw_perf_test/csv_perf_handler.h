@@ -0,0 +1,39 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_perf_test/event_handler.h"
+#include "pw_stream/stream.h"
+
+namespace pw::perf_test {
+
+// Writes the results of each test as a row of CSV, after a header row naming
+// the columns. The parameter column is empty for tests not registered with
+// PW_PERF_TEST_RANGE(). Each hardware event counter adds a column.
+class CsvEventHandler : public EventHandler {
+ public:
+  explicit CsvEventHandler(stream::Writer& writer) : writer_(writer) {}
+
+  void RunAllTestsStart(const TestRunInfo&) override;
+  void RunAllTestsEnd() override {}
+  void TestCaseStart(const TestCase&) override {}
+  void TestCaseEnd(const TestCase& info, const Results& end_result) override;
+  void TestCaseIteration(const IterationResult&) override {}
+
+ private:
+  stream::Writer& writer_;
+  bool header_written_ = false;
+};
+
+}  // namespace pw::perf_test
@@ -15,6 +15,8 @@
 
 #include <cstdint>
 
+#include "pw_span/span.h"
+
 namespace pw::perf_test {
 
 // The data that will be reported on completion of an iteration.
@@ -23,22 +25,47 @@ struct IterationResult {
   int64_t result;
 };
 
-// The data that will be reported upon the completion of an iteration.
+// The mean number of events per iteration counted by a hardware event counter,
+// such as cache misses.
+struct CounterResult {
+  const char* name;
+  int64_t mean;
+};
+
+// The data that will be reported upon the completion of a test. Durations are
+// in the unit of the timer backend. The mean, minimum, maximum and standard
+// deviation exclude outliers; the median and percentiles include them.
 struct Results {
   int64_t mean;
   int64_t max;
   int64_t min;
   int iterations;
+  int64_t median;
+  int64_t p90;
+  int64_t p99;
+  int64_t standard_deviation;
+  // Half the width of the 95% confidence interval of the mean.
+  int64_t confidence_interval;
+  // The number of iterations excluded from the mean as outliers.
+  int outliers;
+  // The counters provided by the counters backend, if any. Counters are
+  // averaged over all measured iterations, including outliers.
+  span<const CounterResult> counters;
 };
 
 // Stores information on the upcoming collection of tests.
 struct TestRunInfo {
+  // The number of tests, counting each parameter of a parameterized test.
   int total_tests;
+  // The minimum number of iterations measured for each test.
   int default_iterations;
 };
 
 struct TestCase {
   const char* name;
+  // True if the test was registered with PW_PERF_TEST_RANGE().
+  bool has_parameter;
+  int64_t parameter;
 };
 
 // This is a declaration of the base EventHandler class. An EventHandler
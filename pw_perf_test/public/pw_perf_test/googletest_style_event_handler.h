@@ -21,7 +21,14 @@
   "[==========] Done running all tests."
 
 #define PW_PERF_TEST_GOOGLESTYLE_CASE_START "[ RUN      ] %s"
+#define PW_PERF_TEST_GOOGLESTYLE_PARAMETERIZED_CASE_START "[ RUN      ] %s/%ld"
 #define PW_PERF_TEST_GOOGLESTYLE_CASE_RESULT \
   "[  RESULT  ] MEAN: %ld %s, MIN: %ld %s, MAX: %ld %s, ITERATIONS: %d"
+#define PW_PERF_TEST_GOOGLESTYLE_CASE_STATISTICS                           \
+  "[  RESULT  ] MEDIAN: %ld, P90: %ld, P99: %ld, STDDEV: %ld, CI95: +/-%ld, " \
+  "OUTLIERS: %d"
+#define PW_PERF_TEST_GOOGLESTYLE_CASE_COUNTER \
+  "[  RESULT  ] %s: %ld per iteration"
 #define PW_PERF_TEST_GOOGLESTYLE_CASE_END "[     DONE ] %s"
+#define PW_PERF_TEST_GOOGLESTYLE_PARAMETERIZED_CASE_END "[     DONE ] %s/%ld"
 #define PW_PERF_TEST_GOOGLESTYLE_ITERATION_REPORT "[ Iteration ] #%ld: %ld %s"
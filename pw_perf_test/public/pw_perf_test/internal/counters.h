@@ -0,0 +1,53 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_perf_test_counters_backend/counters.h"
+
+namespace pw::perf_test::internal {
+
+// A reading of every hardware event counter, such as instructions retired or
+// cache misses.
+using CounterSnapshot = counters_backend::CounterSnapshot;
+
+// The number of counters provided by the backend, which may be 0.
+inline constexpr size_t kCounterCount = counters_backend::kCounterCount;
+
+// Starts the counters. Returns false if they are not available, in which case
+// tests run without them.
+[[nodiscard]] inline bool CountersPrepare() {
+  return counters_backend::CountersPrepare();
+}
+
+inline void CountersCleanup() { counters_backend::CountersCleanup(); }
+
+inline void ReadCounters(CounterSnapshot& snapshot) {
+  counters_backend::ReadCounters(snapshot);
+}
+
+// Returns the number of events counted by a counter between two readings.
+inline int64_t GetCounterDelta(const CounterSnapshot& begin,
+                               const CounterSnapshot& end,
+                               size_t index) {
+  return counters_backend::GetCounterDelta(begin, end, index);
+}
+
+inline const char* GetCounterName(size_t index) {
+  return counters_backend::kCounterNames[index];
+}
+
+}  // namespace pw::perf_test::internal
@@ -0,0 +1,93 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pw::perf_test::internal::counters_backend {
+
+// Counts events with the Data Watchpoint and Trace (DWT) unit of ARMv7-M and
+// ARMv8-M Mainline cores. See ARMv7-M Section C1.8.
+//
+// The DWT counters are 8 bits wide and wrap, so an iteration must have fewer
+// than 256 of each event to be counted correctly.
+
+inline volatile uint32_t& kDwtCtrl =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001000);
+inline volatile uint32_t& kDemcr =
+    *reinterpret_cast<volatile uint32_t*>(0xE000EDFC);
+
+// The counter registers, in the order of kCounterNames.
+inline constexpr std::array<uintptr_t, 5> kDwtCounterAddresses = {
+    0xE0001008,  // DWT_CPICNT
+    0xE000100C,  // DWT_EXCCNT
+    0xE0001010,  // DWT_SLEEPCNT
+    0xE0001014,  // DWT_LSUCNT
+    0xE0001018,  // DWT_FOLDCNT
+};
+
+inline constexpr uint32_t kDemcrTrcEna = 1u << 24;
+inline constexpr uint32_t kDwtCtrlNoPrfCnt = 1u << 24;
+// CPIEVTENA, EXCEVTENA, SLEEPEVTENA, LSUEVTENA and FOLDEVTENA.
+inline constexpr uint32_t kDwtCtrlEventEnables = 0x1Fu << 17;
+
+inline constexpr size_t kCounterCount = kDwtCounterAddresses.size();
+
+using CounterSnapshot = std::array<uint32_t, kCounterCount>;
+
+// Extra cycles spent by multi-cycle instructions and instruction fetch stalls,
+// such as flash wait states; cycles in exception entry and exit; cycles
+// sleeping; extra cycles in load and store instructions; and instructions
+// folded into others, which took no cycles.
+inline constexpr std::array<const char*, kCounterCount> kCounterNames = {
+    "cpi_cycles",
+    "exception_cycles",
+    "sleep_cycles",
+    "lsu_cycles",
+    "folded_instructions",
+};
+
+inline volatile uint32_t& CounterRegister(size_t index) {
+  return *reinterpret_cast<volatile uint32_t*>(kDwtCounterAddresses[index]);
+}
+
+[[nodiscard]] inline bool CountersPrepare() {
+  kDemcr |= kDemcrTrcEna;
+  if ((kDwtCtrl & kDwtCtrlNoPrfCnt) != 0) {
+    return false;  // The profiling counters are not implemented.
+  }
+  for (size_t i = 0; i < kCounterCount; ++i) {
+    CounterRegister(i) = 0;
+  }
+  kDwtCtrl |= kDwtCtrlEventEnables;
+  return (kDwtCtrl & kDwtCtrlEventEnables) == kDwtCtrlEventEnables;
+}
+
+inline void CountersCleanup() { kDwtCtrl &= ~kDwtCtrlEventEnables; }
+
+inline void ReadCounters(CounterSnapshot& snapshot) {
+  for (size_t i = 0; i < kCounterCount; ++i) {
+    snapshot[i] = CounterRegister(i);
+  }
+}
+
+inline int64_t GetCounterDelta(const CounterSnapshot& begin,
+                               const CounterSnapshot& end,
+                               size_t index) {
+  return static_cast<int64_t>((end[index] - begin[index]) & 0xFFu);
+}
+
+}  // namespace pw::perf_test::internal::counters_backend
@@ -0,0 +1,43 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pw::perf_test::internal::counters_backend {
+
+// A counters backend for targets without hardware event counters, or where
+// they are not wanted. Tests only report durations.
+
+inline constexpr size_t kCounterCount = 0;
+
+using CounterSnapshot = std::array<uint32_t, kCounterCount>;
+
+inline constexpr std::array<const char*, kCounterCount> kCounterNames = {};
+
+[[nodiscard]] inline bool CountersPrepare() { return true; }
+
+inline void CountersCleanup() {}
+
+inline void ReadCounters(CounterSnapshot&) {}
+
+inline int64_t GetCounterDelta(const CounterSnapshot&,
+                               const CounterSnapshot&,
+                               size_t) {
+  return 0;
+}
+
+}  // namespace pw::perf_test::internal::counters_backend
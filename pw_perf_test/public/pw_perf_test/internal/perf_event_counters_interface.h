@@ -0,0 +1,49 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pw::perf_test::internal::counters_backend {
+
+// Counts events of the calling thread in user space with Linux's
+// perf_event_open(). Counters are unavailable if the kernel does not allow
+// it, such as in some containers or when /proc/sys/kernel/perf_event_paranoid
+// is too high.
+
+inline constexpr size_t kCounterCount = 3;
+
+using CounterSnapshot = std::array<uint64_t, kCounterCount>;
+
+inline constexpr std::array<const char*, kCounterCount> kCounterNames = {
+    "instructions",
+    "cache_misses",
+    "branch_misses",
+};
+
+[[nodiscard]] bool CountersPrepare();
+
+void CountersCleanup();
+
+void ReadCounters(CounterSnapshot& snapshot);
+
+inline int64_t GetCounterDelta(const CounterSnapshot& begin,
+                               const CounterSnapshot& end,
+                               size_t index) {
+  return static_cast<int64_t>(end[index] - begin[index]);
+}
+
+}  // namespace pw::perf_test::internal::counters_backend
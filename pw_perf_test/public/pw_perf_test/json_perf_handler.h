@@ -0,0 +1,44 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_perf_test/event_handler.h"
+#include "pw_stream/stream.h"
+
+namespace pw::perf_test {
+
+// Writes the results of each test as a line of JSON, for tools such as
+// pw_perf_test.compare to read. For example:
+//
+//   {"name": "Copy", "parameter": 64, "unit": "ns", "iterations": 20, ...}
+//
+// The parameter is only included for tests registered with
+// PW_PERF_TEST_RANGE(), and "counters" only if hardware event counters were
+// read, as an object mapping each counter's name to its mean. Other output,
+// such as logs, may be written to the same stream between lines.
+class JsonEventHandler : public EventHandler {
+ public:
+  explicit JsonEventHandler(stream::Writer& writer) : writer_(writer) {}
+
+  void RunAllTestsStart(const TestRunInfo&) override {}
+  void RunAllTestsEnd() override {}
+  void TestCaseStart(const TestCase&) override {}
+  void TestCaseEnd(const TestCase& info, const Results& end_result) override;
+  void TestCaseIteration(const IterationResult&) override {}
+
+ private:
+  stream::Writer& writer_;
+};
+
+}  // namespace pw::perf_test
@@ -13,14 +13,17 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstdint>
-#include <limits>
 
 #include "pw_assert/assert.h"
+#include "pw_perf_test/config.h"
 #include "pw_perf_test/event_handler.h"
+#include "pw_perf_test/internal/counters.h"
 #include "pw_perf_test/internal/duration_unit.h"
 #include "pw_perf_test/internal/timer.h"
 #include "pw_preprocessor/arguments.h"
+#include "pw_span/span.h"
 
 #define PW_PERF_TEST(name, function, ...)                             \
   const ::pw::perf_test::internal::TestInfo PwPerfTest_##name(        \
@@ -40,6 +43,25 @@
       },                                                    \
       __VA_ARGS__)
 
+// Registers a performance test which is run once for each parameter in a
+// range, such as a range of input sizes. The parameters start at start and are
+// multiplied by multiplier up to limit, which is always included. The
+// parameter is passed to the test function after the state, followed by any
+// additional arguments.
+//
+//   // Runs with sizes of 8, 64, 512 and 1000.
+//   PW_PERF_TEST_RANGE(Copy, CopyBytes, 8, 1000, 8);
+#define PW_PERF_TEST_RANGE(name, function, start, limit, multiplier, ...) \
+  const ::pw::perf_test::internal::TestInfo PwPerfTest_##name(             \
+      #name,                                                               \
+      ::pw::perf_test::internal::ParameterRange{start, limit, multiplier}, \
+      [](::pw::perf_test::State& pw_perf_test_state,                       \
+         int64_t pw_perf_test_parameter) {                                 \
+        static_cast<void>(function(pw_perf_test_state,                     \
+                                   pw_perf_test_parameter                  \
+                                       PW_COMMA_ARGS(__VA_ARGS__)));       \
+      })
+
 namespace pw::perf_test {
 
 class State;
@@ -48,17 +70,63 @@ namespace internal {
 
 class TestInfo;
 
-// Allows access to the private State object constructor
+// The number of iterations a State runs.
+struct IterationLimits {
+  // Iterations run before measuring, whose durations are discarded.
+  int warmup;
+  // The test stops between min and max iterations, once the mean converges.
+  int min;
+  int max;
+};
+
+// The parameters of a test registered with PW_PERF_TEST_RANGE().
+struct ParameterRange {
+  int64_t start;
+  int64_t limit;
+  int64_t multiplier;
+
+  // Returns the number of parameters in the range.
+  constexpr int count() const {
+    int parameters = 1;
+    for (int64_t parameter = start; parameter < limit;
+         parameter = Next(parameter)) {
+      ++parameters;
+    }
+    return parameters;
+  }
+
+  // Returns the parameter after the given one, which must be below limit.
+  constexpr int64_t Next(int64_t parameter) const {
+    return parameter > limit / multiplier ? limit : parameter * multiplier;
+  }
+};
+
+// Allows access to the private State object constructor. This overload
+// measures exactly the given number of iterations, without warmup.
 State CreateState(int durations,
                   EventHandler& event_handler,
                   const char* test_name);
 
+// Reads the hardware event counters around each iteration if read_counters is
+// true. They must have been prepared.
+State CreateState(const IterationLimits& limits,
+                  EventHandler& event_handler,
+                  const TestCase& test_case,
+                  bool read_counters = false);
+
+// Computes the results of a test from its measured durations, which are sorted
+// in place. Durations further from the median than
+// PW_PERF_TEST_OUTLIER_THRESHOLD scaled median absolute deviations are
+// excluded from the mean, minimum, maximum and standard deviation.
+Results Summarize(span<int64_t> durations);
+
 class Framework {
  public:
   constexpr Framework()
       : event_handler_(nullptr),
         tests_(nullptr),
-        run_info_{.total_tests = 0, .default_iterations = kDefaultIterations} {}
+        run_info_{.total_tests = 0,
+                  .default_iterations = PW_PERF_TEST_MIN_ITERATIONS} {}
 
   static Framework& Get() { return framework_; }
 
@@ -71,7 +139,14 @@ class Framework {
   int RunAllTests();
 
  private:
-  static constexpr int kDefaultIterations = 10;
+  // Runs a test case, reading the counters if they were prepared.
+  void RunTestCase(const TestInfo& test, const TestCase& test_case);
+
+  static constexpr IterationLimits kDefaultLimits = {
+      .warmup = PW_PERF_TEST_WARMUP_ITERATIONS,
+      .min = PW_PERF_TEST_MIN_ITERATIONS,
+      .max = PW_PERF_TEST_MAX_ITERATIONS,
+  };
 
   EventHandler* event_handler_;
 
@@ -80,6 +155,8 @@ class Framework {
 
   TestRunInfo run_info_;
 
+  bool counters_prepared_ = false;
+
   static Framework framework_;
 };
 
@@ -92,18 +169,41 @@ class TestInfo {
     Framework::Get().RegisterTest(*this);
   }
 
+  TestInfo(const char* test_name,
+           const ParameterRange& parameters,
+           void (*function_body)(State&, int64_t))
+      : run_with_parameter_(function_body),
+        parameters_(parameters),
+        test_name_(test_name) {
+    PW_ASSERT(parameters.start > 0 && parameters.start <= parameters.limit &&
+              parameters.multiplier > 1);
+    Framework::Get().RegisterTest(*this);
+  }
+
   // Returns the next registered test
   TestInfo* next() const { return next_; }
 
   void SetNext(TestInfo* next) { next_ = next; }
 
   void Run(State& state) const { run_(state); }
+  void Run(State& state, int64_t parameter) const {
+    run_with_parameter_(state, parameter);
+  }
 
   const char* test_name() const { return test_name_; }
 
+  // True if the test was registered with PW_PERF_TEST_RANGE().
+  bool has_parameters() const { return run_with_parameter_ != nullptr; }
+  const ParameterRange& parameters() const { return parameters_; }
+
+  // The number of test cases run for this test.
+  int test_cases() const { return has_parameters() ? parameters_.count() : 1; }
+
  private:
   // Function pointer to the code that will be measured
-  void (*run_)(State&);
+  void (*run_)(State&) = nullptr;
+  void (*run_with_parameter_)(State&, int64_t) = nullptr;
+  ParameterRange parameters_ = {};
 
   // Intrusively linked list, this acts as a pointer to the next test
   TestInfo* next_ = nullptr;
@@ -122,45 +222,67 @@ class State {
  private:
   // Allows the framework to create state objects and unit tests for the state
   // class
-  friend State internal::CreateState(int durations,
+  friend State internal::CreateState(const internal::IterationLimits& limits,
                                      EventHandler& event_handler,
-                                     const char* test_name);
+                                     const TestCase& test_case,
+                                     bool read_counters);
 
   // Privated constructor to prevent unauthorized instances of the state class.
-  constexpr State(int iterations,
+  constexpr State(const internal::IterationLimits& limits,
                   EventHandler& event_handler,
-                  const char* test_name)
-      : mean_(-1),
-        test_iterations_(iterations),
-        total_duration_(0),
-        min_(std::numeric_limits<int64_t>::max()),
-        max_(std::numeric_limits<int64_t>::min()),
+                  const TestCase& test_case,
+                  bool read_counters)
+      : read_counters_(read_counters),
+        warmup_remaining_(limits.warmup),
+        min_iterations_(limits.min),
+        max_iterations_(limits.max),
+        running_mean_(0.0f),
+        running_m2_(0.0f),
+        durations_{},
+        counter_totals_{},
+        counter_results_{},
+        counters_start_{},
         iteration_start_(),
         current_iteration_(-1),
         event_handler_(&event_handler),
-        test_info{.name = test_name} {
-    PW_ASSERT(test_iterations_ > 0);
-  }
-  // Set public after deciding how exactly to set user-defined iterations
-  void SetIterations(int iterations) {
-    PW_ASSERT(current_iteration_ == -1);
-    test_iterations_ = iterations;
-    PW_ASSERT(test_iterations_ > 0);
+        test_info(test_case) {
+    PW_ASSERT(limits.warmup >= 0 && limits.min > 0 &&
+              limits.min <= limits.max &&
+              limits.max <= PW_PERF_TEST_MAX_ITERATIONS);
   }
 
-  int64_t mean_;
+  // Records a measured duration and returns true if the test is done.
+  bool RecordDuration(int64_t duration);
+
+  // Adds the events counted since the start of the iteration to the totals.
+  void RecordCounters();
+
+  // Starts timing, and counting if enabled, an iteration.
+  void StartIteration();
+
+  bool read_counters_;
+
+  // Iterations left to run before measuring.
+  int warmup_remaining_;
+
+  int min_iterations_;
+  int max_iterations_;
 
-  // Stores the total number of iterations wanted
-  int test_iterations_;
+  // The mean of the durations and the sum of their squared differences from
+  // it, updated with Welford's algorithm to check for convergence.
+  float running_mean_;
+  float running_m2_;
 
-  // Stores the total duration of the tests.
-  int64_t total_duration_;
+  // The measured durations.
+  std::array<int64_t, PW_PERF_TEST_MAX_ITERATIONS> durations_;
 
-  // Smallest value of the iterations
-  int64_t min_;
+  // The events counted by each counter over the measured iterations, and
+  // their means once the test ends.
+  std::array<int64_t, internal::kCounterCount> counter_totals_;
+  std::array<CounterResult, internal::kCounterCount> counter_results_;
 
-  // Largest value of the iterations
-  int64_t max_;
+  // Counter readings at the start of the iteration
+  internal::CounterSnapshot counters_start_;
 
   // Time at the start of the iteration
   internal::Timestamp iteration_start_;
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for comparing perf test runs."""
+
+import json
+import unittest
+from typing import List, Optional
+
+from pw_perf_test.compare import compare, parse_results
+
+
+def _result(
+    name: str, median: int, ci95: int, parameter: Optional[int] = None
+) -> str:
+    """Formats a result line as written by the JSON event handler."""
+    entry: dict = {'name': name}
+    if parameter is not None:
+        entry['parameter'] = parameter
+    entry.update(
+        unit='ns',
+        iterations=10,
+        outliers=0,
+        mean=median,
+        min=median,
+        max=median,
+        median=median,
+        p90=median,
+        p99=median,
+        stddev=ci95,
+        ci95=ci95,
+    )
+    return json.dumps(entry)
+
+
+BASELINE: List[str] = [
+    'INF  [==========] Running all tests.',
+    _result('Copy', 100, 2),
+    _result('Sort', 50, 4, parameter=8),
+    _result('Sort', 400, 8, parameter=64),
+]
+
+CANDIDATE: List[str] = [
+    _result('Copy', 130, 2),
+    _result('Sort', 55, 10, parameter=8),
+    _result('Sort', 390, 4, parameter=64),
+    _result('New', 5, 0),
+]
+
+
+class CompareTest(unittest.TestCase):
+    """Tests comparing two runs."""
+
+    def setUp(self) -> None:
+        self.baseline = parse_results(BASELINE)
+        self.candidate = parse_results(CANDIDATE)
+
+    def test_parse_skips_logs_and_keys_by_parameter(self) -> None:
+        self.assertEqual(
+            set(self.baseline),
+            {('Copy', None), ('Sort', 8), ('Sort', 64)},
+        )
+        self.assertEqual(self.baseline[('Sort', 64)].median, 400)
+
+    def test_only_tests_in_both_runs_are_compared(self) -> None:
+        comparisons = compare(self.baseline, self.candidate)
+        self.assertEqual(len(comparisons), 3)
+
+    def test_regression_needs_threshold_and_separate_intervals(self) -> None:
+        results = {
+            c.baseline.key: c for c in compare(self.baseline, self.candidate)
+        }
+        self.assertAlmostEqual(results[('Copy', None)].change_percent, 30.0)
+        self.assertTrue(results[('Copy', None)].regressed(5.0))
+        self.assertFalse(results[('Copy', None)].regressed(50.0))
+
+        # Slower by 10%, but within the noise of the measurements.
+        self.assertTrue(results[('Sort', 8)].intervals_overlap())
+        self.assertFalse(results[('Sort', 8)].regressed(5.0))
+
+        # Faster is never a regression.
+        self.assertFalse(results[('Sort', 64)].regressed(0.0))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Compares two runs of performance tests recorded by the JSON event handler.
+
+Each run is the output of a perf test built with
+pw_perf_test:json_perf_handler_main, one JSON object per line. Lines which are
+not JSON objects, such as logs, are ignored. Tests are matched by name and
+parameter. A test regressed if its median grew by more than the threshold and
+the 95% confidence intervals of the two runs do not overlap.
+"""
+
+import argparse
+import json
+from dataclasses import dataclass
+from pathlib import Path
+import sys
+from typing import Dict, Iterable, List, Optional, TextIO, Tuple
+
+TestKey = Tuple[str, Optional[int]]
+
+
+@dataclass(frozen=True)
+class Result:
+    """The statistics of one test case."""
+
+    name: str
+    parameter: Optional[int]
+    unit: str
+    median: int
+    mean: int
+    ci95: int
+
+    @property
+    def key(self) -> TestKey:
+        return (self.name, self.parameter)
+
+    def display_name(self) -> str:
+        if self.parameter is None:
+            return self.name
+        return f'{self.name}/{self.parameter}'
+
+
+@dataclass(frozen=True)
+class Comparison:
+    """A test case present in both runs."""
+
+    baseline: Result
+    candidate: Result
+
+    @property
+    def change_percent(self) -> float:
+        if self.baseline.median == 0:
+            return 0.0
+        return (
+            100.0
+            * (self.candidate.median - self.baseline.median)
+            / self.baseline.median
+        )
+
+    def intervals_overlap(self) -> bool:
+        return (
+            self.candidate.mean - self.candidate.ci95
+            <= self.baseline.mean + self.baseline.ci95
+            and self.baseline.mean - self.baseline.ci95
+            <= self.candidate.mean + self.candidate.ci95
+        )
+
+    def regressed(self, threshold_percent: float) -> bool:
+        return (
+            self.change_percent > threshold_percent
+            and not self.intervals_overlap()
+        )
+
+
+def parse_results(lines: Iterable[str]) -> Dict[TestKey, Result]:
+    """Reads the results of a run, skipping lines that are not results."""
+    results: Dict[TestKey, Result] = {}
+    for line in lines:
+        line = line.strip()
+        if not line.startswith('{'):
+            continue
+        try:
+            entry = json.loads(line)
+            result = Result(
+                name=entry['name'],
+                parameter=entry.get('parameter'),
+                unit=entry['unit'],
+                median=entry['median'],
+                mean=entry['mean'],
+                ci95=entry['ci95'],
+            )
+        except (json.JSONDecodeError, KeyError, TypeError):
+            continue
+        results[result.key] = result
+    return results
+
+
+def compare(
+    baseline: Dict[TestKey, Result], candidate: Dict[TestKey, Result]
+) -> List[Comparison]:
+    """Pairs up the tests present in both runs."""
+    return [
+        Comparison(baseline[key], candidate[key])
+        for key in baseline
+        if key in candidate
+    ]
+
+
+def _print_report(
+    comparisons: List[Comparison], threshold_percent: float, output: TextIO
+) -> None:
+    width = max(
+        (len(c.baseline.display_name()) for c in comparisons), default=4
+    )
+    output.write(
+        f'{"Test":<{width}}  {"Baseline":>12}  {"Candidate":>12}  '
+        f'{"Change":>8}\n'
+    )
+    for comparison in comparisons:
+        baseline = comparison.baseline
+        candidate = comparison.candidate
+        status = ''
+        if comparison.regressed(threshold_percent):
+            status = '  REGRESSED'
+        output.write(
+            f'{baseline.display_name():<{width}}  '
+            f'{baseline.median:>9} {baseline.unit:<2}  '
+            f'{candidate.median:>9} {candidate.unit:<2}  '
+            f'{comparison.change_percent:>+7.1f}%{status}\n'
+        )
+
+
+def _parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('baseline', type=Path, help='Results of the baseline')
+    parser.add_argument(
+        'candidate', type=Path, help='Results of the run to check'
+    )
+    parser.add_argument(
+        '--threshold',
+        type=float,
+        default=5.0,
+        help='Median increase, in percent, that counts as a regression',
+    )
+    return parser.parse_args()
+
+
+def main(baseline: Path, candidate: Path, threshold: float) -> int:
+    with baseline.open() as file:
+        baseline_results = parse_results(file)
+    with candidate.open() as file:
+        candidate_results = parse_results(file)
+
+    comparisons = compare(baseline_results, candidate_results)
+    _print_report(comparisons, threshold, sys.stdout)
+
+    regressions = [c for c in comparisons if c.regressed(threshold)]
+    if regressions:
+        print(f'{len(regressions)} of {len(comparisons)} tests regressed')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(**vars(_parse_args())))
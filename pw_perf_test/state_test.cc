@@ -12,6 +12,9 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
+#include <cstdint>
+
 #include "gtest/gtest.h"
 #include "pw_perf_test/event_handler.h"
 #include "pw_perf_test/perf_test.h"
@@ -23,9 +26,14 @@ class EmptyEventHandler : public EventHandler {
  public:
   void RunAllTestsStart(const TestRunInfo&) override {}
   void TestCaseStart(const TestCase&) override {}
-  void TestCaseEnd(const TestCase&, const Results&) override {}
-  void TestCaseIteration(const IterationResult&) override {}
+  void TestCaseEnd(const TestCase&, const Results& results) override {
+    last_results = results;
+  }
+  void TestCaseIteration(const IterationResult&) override { ++iterations; }
   void RunAllTestsEnd() override {}
+
+  Results last_results{};
+  int iterations = 0;
 };
 
 EmptyEventHandler handler;
@@ -57,5 +65,111 @@ TEST(StateTest, SingleTest) {
   EXPECT_EQ(total_iterations, test_iterations);
 }
 
+TEST(StateTest, WarmupIterationsAreNotMeasured) {
+  EmptyEventHandler warmup_handler;
+  State state_obj = internal::CreateState(
+      internal::IterationLimits{.warmup = 3, .min = 5, .max = 5},
+      warmup_handler,
+      TestCase{.name = "", .has_parameter = false, .parameter = 0});
+  int total_iterations = 0;
+  while (state_obj.KeepRunning()) {
+    ++total_iterations;
+    TestFunction();
+  }
+  EXPECT_EQ(total_iterations, 8);
+  EXPECT_EQ(warmup_handler.iterations, 5);
+  EXPECT_EQ(warmup_handler.last_results.iterations, 5);
+}
+
+TEST(StateTest, AdaptiveIterationsStayWithinLimits) {
+  EmptyEventHandler adaptive_handler;
+  State state_obj = internal::CreateState(
+      internal::IterationLimits{.warmup = 0, .min = 4, .max = 20},
+      adaptive_handler,
+      TestCase{.name = "", .has_parameter = false, .parameter = 0});
+  int total_iterations = 0;
+  while (state_obj.KeepRunning()) {
+    ++total_iterations;
+    TestFunction();
+  }
+  EXPECT_GE(total_iterations, 4);
+  EXPECT_LE(total_iterations, 20);
+  EXPECT_EQ(adaptive_handler.last_results.iterations, total_iterations);
+}
+
+TEST(StateTest, CountersOnlyReportedWhenRead) {
+  EmptyEventHandler counter_handler;
+  const internal::IterationLimits limits{.warmup = 0, .min = 2, .max = 2};
+  const TestCase test_case{.name = "", .has_parameter = false, .parameter = 0};
+
+  State without_counters =
+      internal::CreateState(limits, counter_handler, test_case);
+  while (without_counters.KeepRunning()) {
+    TestFunction();
+  }
+  EXPECT_TRUE(counter_handler.last_results.counters.empty());
+
+  if (!internal::CountersPrepare()) {
+    return;  // This host does not allow reading the counters.
+  }
+  State with_counters =
+      internal::CreateState(limits, counter_handler, test_case, true);
+  while (with_counters.KeepRunning()) {
+    TestFunction();
+  }
+  internal::CountersCleanup();
+  ASSERT_EQ(counter_handler.last_results.counters.size(),
+            internal::kCounterCount);
+  for (const CounterResult& counter : counter_handler.last_results.counters) {
+    EXPECT_NE(counter.name, nullptr);
+    EXPECT_GE(counter.mean, 0);
+  }
+}
+
+TEST(Summarize, MedianAndPercentiles) {
+  std::array<int64_t, 10> durations = {10, 1, 9, 2, 8, 3, 7, 4, 6, 5};
+  const Results results = internal::Summarize(durations);
+  EXPECT_EQ(results.iterations, 10);
+  EXPECT_EQ(results.median, 5);  // Halfway between 5 and 6, rounded down.
+  EXPECT_EQ(results.p90, 9);
+  EXPECT_EQ(results.p99, 10);
+  EXPECT_EQ(results.min, 1);
+  EXPECT_EQ(results.max, 10);
+  EXPECT_EQ(results.mean, 5);
+  EXPECT_EQ(results.outliers, 0);
+}
+
+TEST(Summarize, RejectsOutliers) {
+  std::array<int64_t, 9> durations = {100, 101, 99, 100, 102, 98, 100, 5000,
+                                      1};
+  const Results results = internal::Summarize(durations);
+  EXPECT_EQ(results.iterations, 9);
+  EXPECT_EQ(results.median, 100);
+  EXPECT_EQ(results.outliers, 2);
+  EXPECT_EQ(results.min, 98);
+  EXPECT_EQ(results.max, 102);
+  EXPECT_EQ(results.mean, 100);
+  EXPECT_EQ(results.p99, 5000);
+  EXPECT_EQ(results.standard_deviation, 1);  // 1.29, truncated.
+  EXPECT_LE(results.confidence_interval, results.standard_deviation);
+}
+
+TEST(Summarize, IdenticalDurations) {
+  std::array<int64_t, 3> durations = {7, 7, 7};
+  const Results results = internal::Summarize(durations);
+  EXPECT_EQ(results.median, 7);
+  EXPECT_EQ(results.mean, 7);
+  EXPECT_EQ(results.outliers, 0);
+  EXPECT_EQ(results.standard_deviation, 0);
+}
+
+TEST(ParameterRange, IncludesLimit) {
+  constexpr internal::ParameterRange kRange{8, 1000, 8};
+  static_assert(kRange.count() == 4);
+  EXPECT_EQ(kRange.Next(8), 64);
+  EXPECT_EQ(kRange.Next(64), 512);
+  EXPECT_EQ(kRange.Next(512), 1000);
+}
+
 }  // namespace
 }  // namespace pw::perf_test
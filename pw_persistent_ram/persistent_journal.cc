@@ -0,0 +1,135 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_persistent_ram/persistent_journal.h"
+
+#include <cstring>
+
+#include "pw_bytes/endian.h"
+#include "pw_checksum/crc16_ccitt.h"
+#include "pw_span/span.h"
+
+namespace pw::persistent_ram::internal {
+
+Status PersistentJournalImpl::Append(ConstByteSpan record) {
+  if (record.empty() || record.size() > kMaxRecordSizeBytes) {
+    return Status::InvalidArgument();
+  }
+
+  const size_t end = End();
+  if (!EndIsValid()) {
+    if (end == 0u) {
+      // No intact records, so the epoch may be garbage too. Start over.
+      Clear();
+    } else {
+      SetEnd(end);
+    }
+  }
+
+  if (kRecordHeaderSizeBytes + record.size() > buffer_.size() - end) {
+    return Status::ResourceExhausted();
+  }
+
+  // Write the data before the header. Until the header's CRC matches, the
+  // record is not intact, so a reset at any point leaves earlier records as
+  // they were.
+  std::byte* const header = buffer_.data() + end;
+  std::memcpy(header + kRecordHeaderSizeBytes, record.data(), record.size());
+
+  const uint16_t size = static_cast<uint16_t>(record.size());
+  const auto size_bytes = bytes::CopyInOrder(endian::little, size);
+  const auto checksum_bytes = bytes::CopyInOrder(
+      endian::little, RecordChecksum(size, record));
+  std::memcpy(header, size_bytes.data(), size_bytes.size());
+  std::memcpy(header + size_bytes.size(),
+              checksum_bytes.data(),
+              checksum_bytes.size());
+
+  SetEnd(end + kRecordHeaderSizeBytes + record.size());
+  return OkStatus();
+}
+
+void PersistentJournalImpl::Clear() {
+  // Records from the previous epoch fail their CRC checks.
+  epoch_ = epoch_ + 1;  // ++ on a volatile is deprecated in C++20
+  SetEnd(0);
+}
+
+size_t PersistentJournalImpl::End() const {
+  if (EndIsValid()) {
+    return end_;
+  }
+
+  // The end was not updated completely. Scan for the last intact record.
+  size_t offset = 0;
+  for (ConstByteSpan record = RecordAt(offset, buffer_.size());
+       !record.empty();
+       record = RecordAt(offset, buffer_.size())) {
+    offset += kRecordHeaderSizeBytes + record.size();
+  }
+  return offset;
+}
+
+ConstByteSpan PersistentJournalImpl::RecordAt(size_t offset,
+                                              size_t end) const {
+  if (end > buffer_.size() || offset > end ||
+      end - offset < kRecordHeaderSizeBytes) {
+    return {};
+  }
+
+  const std::byte* const header = buffer_.data() + offset;
+  const uint16_t size = bytes::ReadInOrder<uint16_t>(endian::little, header);
+  const uint16_t checksum =
+      bytes::ReadInOrder<uint16_t>(endian::little, header + sizeof(size));
+  if (size == 0u || size > end - offset - kRecordHeaderSizeBytes) {
+    return {};
+  }
+
+  const ConstByteSpan data(header + kRecordHeaderSizeBytes, size);
+  if (checksum != RecordChecksum(size, data)) {
+    return {};
+  }
+  return data;
+}
+
+bool PersistentJournalImpl::EndIsValid() const {
+  const size_t end = end_;
+  return end <= buffer_.size() && end_checksum_ == EndChecksum(end);
+}
+
+uint16_t PersistentJournalImpl::EndChecksum(size_t end) const {
+  const uint32_t epoch = epoch_;
+  const uint16_t checksum =
+      checksum::Crc16Ccitt::Calculate(as_bytes(span(&epoch, 1)));
+  return checksum::Crc16Ccitt::Calculate(as_bytes(span(&end, 1)), checksum);
+}
+
+uint16_t PersistentJournalImpl::RecordChecksum(uint16_t size,
+                                               ConstByteSpan data) const {
+  const uint32_t epoch = epoch_;
+  uint16_t checksum =
+      checksum::Crc16Ccitt::Calculate(as_bytes(span(&epoch, 1)));
+  checksum =
+      checksum::Crc16Ccitt::Calculate(as_bytes(span(&size, 1)), checksum);
+  return checksum::Crc16Ccitt::Calculate(data, checksum);
+}
+
+void PersistentJournalImpl::SetEnd(size_t end) {
+  // If a reset lands between these stores, the checksum does not match and the
+  // end is recovered by scanning.
+  end_ = end;
+  end_checksum_ = EndChecksum(end);
+}
+
+}  // namespace pw::persistent_ram::internal
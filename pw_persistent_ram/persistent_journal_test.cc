@@ -0,0 +1,184 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_persistent_ram/persistent_journal.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/span.h"
+#include "pw_random/xor_shift.h"
+#include "pw_span/span.h"
+
+namespace pw::persistent_ram {
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+constexpr size_t kHeader = PersistentJournal<0>::kRecordHeaderSizeBytes;
+
+ConstByteSpan AsBytes(std::string_view string) {
+  return as_bytes(span(string.data(), string.size()));
+}
+
+class PersistentJournalTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kBufferSize = 64;
+  using Journal = PersistentJournal<kBufferSize>;
+
+  PersistentJournalTest() { ZeroPersistentMemory(); }
+
+  // Emulate invalidation of persistent section(s).
+  void ZeroPersistentMemory() { memset(buffer_, 0, sizeof(buffer_)); }
+  void RandomFillMemory() {
+    random::XorShiftStarRng64 rng(0x9ad75);
+    rng.Get(buffer_);
+  }
+
+  Journal& GetJournal() { return *(new (buffer_) Journal()); }
+
+  // Returns the records in the journal, joined with '|'.
+  std::string_view Records(const Journal& journal) {
+    size_t size = 0;
+    journal.ForEachRecord([&](ConstByteSpan record) {
+      if (size != 0u) {
+        contents_[size++] = '|';
+      }
+      std::memcpy(&contents_[size], record.data(), record.size());
+      size += record.size();
+    });
+    return std::string_view(contents_.data(), size);
+  }
+
+  // Returns the offset of a string in the persistent memory.
+  size_t Find(std::string_view string) {
+    const std::string_view memory(reinterpret_cast<const char*>(buffer_),
+                                  sizeof(buffer_));
+    return memory.find(string);
+  }
+
+  alignas(Journal) std::byte buffer_[sizeof(Journal)];
+  std::array<char, kBufferSize> contents_;
+};
+
+TEST_F(PersistentJournalTest, ZeroedMemoryIsEmpty) {
+  Journal& journal = GetJournal();
+  EXPECT_TRUE(journal.empty());
+  EXPECT_EQ(""sv, Records(journal));
+}
+
+TEST_F(PersistentJournalTest, RandomMemoryIsEmpty) {
+  RandomFillMemory();
+  Journal& journal = GetJournal();
+  EXPECT_TRUE(journal.empty());
+  EXPECT_EQ(""sv, Records(journal));
+}
+
+TEST_F(PersistentJournalTest, AppendAndRead) {
+  Journal& journal = GetJournal();
+  ASSERT_EQ(OkStatus(), journal.Append(AsBytes("first")));
+  ASSERT_EQ(OkStatus(), journal.Append(AsBytes("second")));
+
+  EXPECT_EQ(2 * kHeader + 11, journal.size());
+  EXPECT_EQ("first|second"sv, Records(journal));
+}
+
+TEST_F(PersistentJournalTest, RecordsPersistAcrossReset) {
+  {
+    RandomFillMemory();
+    Journal& journal = GetJournal();
+    ASSERT_EQ(OkStatus(), journal.Append(AsBytes("boot 1")));
+    journal.~PersistentJournal();  // Emulate shutdown / global destructors.
+  }
+  {
+    Journal& journal = GetJournal();
+    EXPECT_EQ("boot 1"sv, Records(journal));
+    ASSERT_EQ(OkStatus(), journal.Append(AsBytes("boot 2")));
+    journal.~PersistentJournal();
+  }
+  {
+    Journal& journal = GetJournal();
+    EXPECT_EQ("boot 1|boot 2"sv, Records(journal));
+  }
+}
+
+TEST_F(PersistentJournalTest, InvalidArguments) {
+  Journal& journal = GetJournal();
+  EXPECT_EQ(Status::InvalidArgument(), journal.Append(ConstByteSpan()));
+  EXPECT_TRUE(journal.empty());
+}
+
+TEST_F(PersistentJournalTest, Full) {
+  Journal& journal = GetJournal();
+  constexpr std::array<std::byte, kBufferSize - 2 * kHeader> kLarge{};
+  ASSERT_EQ(OkStatus(), journal.Append(kLarge));
+  EXPECT_EQ(Status::ResourceExhausted(), journal.Append(AsBytes("x")));
+  EXPECT_EQ(kBufferSize - kHeader, journal.size());
+}
+
+TEST_F(PersistentJournalTest, Clear_OldRecordsAreNotRecovered) {
+  Journal& journal = GetJournal();
+  ASSERT_EQ(OkStatus(), journal.Append(AsBytes("old")));
+  journal.clear();
+  EXPECT_TRUE(journal.empty());
+
+  // Corrupt the end offset to force a scan, which must not find the old
+  // record from the previous epoch.
+  buffer_[Find("old") - kHeader - 1] ^= std::byte{0xFF};
+  Journal& after_reset = GetJournal();
+  EXPECT_EQ(""sv, Records(after_reset));
+}
+
+TEST_F(PersistentJournalTest, InterruptedEndUpdate_RecoversAllRecords) {
+  Journal& journal = GetJournal();
+  ASSERT_EQ(OkStatus(), journal.Append(AsBytes("one")));
+  ASSERT_EQ(OkStatus(), journal.Append(AsBytes("two")));
+
+  // Emulate a reset after the record was written but before the end offset's
+  // checksum was updated by corrupting the checksum, which directly precedes
+  // the buffer.
+  buffer_[Find("one") - kHeader - 1] ^= std::byte{0x5A};
+
+  Journal& after_reset = GetJournal();
+  EXPECT_EQ("one|two"sv, Records(after_reset));
+  EXPECT_EQ(2 * kHeader + 6, after_reset.size());
+
+  ASSERT_EQ(OkStatus(), after_reset.Append(AsBytes("three")));
+  EXPECT_EQ("one|two|three"sv, Records(after_reset));
+}
+
+TEST_F(PersistentJournalTest, InterruptedRecordWrite_KeepsEarlierRecords) {
+  Journal& journal = GetJournal();
+  ASSERT_EQ(OkStatus(), journal.Append(AsBytes("kept")));
+  ASSERT_EQ(OkStatus(), journal.Append(AsBytes("torn")));
+
+  // Emulate a reset partway through writing the second record's data, after
+  // which the end offset would not have been updated either.
+  const size_t torn = Find("torn");
+  buffer_[torn + 2] = std::byte{'?'};
+  buffer_[Find("kept") - kHeader - 1] ^= std::byte{0x5A};
+
+  Journal& after_reset = GetJournal();
+  EXPECT_EQ("kept"sv, Records(after_reset));
+
+  // The torn record is overwritten by the next append.
+  ASSERT_EQ(OkStatus(), after_reset.Append(AsBytes("next")));
+  EXPECT_EQ("kept|next"sv, Records(after_reset));
+}
+
+}  // namespace
+}  // namespace pw::persistent_ram
@@ -0,0 +1,158 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_status/status.h"
+
+namespace pw::persistent_ram {
+namespace internal {
+
+// Untemplated implementation of PersistentJournal, which operates on the
+// journal's members through references.
+class PersistentJournalImpl {
+ public:
+  // Each record starts with its 16-bit size and 16-bit CRC.
+  static constexpr size_t kRecordHeaderSizeBytes = 4;
+  static constexpr size_t kMaxRecordSizeBytes = 0xFFFF;
+
+  PersistentJournalImpl(ByteSpan buffer,
+                        volatile uint32_t& epoch,
+                        volatile size_t& end,
+                        volatile uint16_t& end_checksum)
+      : buffer_(buffer),
+        epoch_(epoch),
+        end_(end),
+        end_checksum_(end_checksum) {}
+
+  Status Append(ConstByteSpan record);
+
+  void Clear();
+
+  // Returns the offset just past the last intact record.
+  size_t End() const;
+
+  // Returns the data of the intact record at offset, or an empty span if there
+  // is no intact record there.
+  ConstByteSpan RecordAt(size_t offset, size_t end) const;
+
+ private:
+  bool EndIsValid() const;
+  uint16_t EndChecksum(size_t end) const;
+  uint16_t RecordChecksum(uint16_t size, ConstByteSpan data) const;
+  void SetEnd(size_t end);
+
+  ByteSpan buffer_;
+  volatile uint32_t& epoch_;
+  volatile size_t& end_;
+  volatile uint16_t& end_checksum_;
+};
+
+}  // namespace internal
+
+// The PersistentJournal class intentionally uses uninitialized memory, which
+// triggers compiler warnings. Disable those warnings for this file.
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC(ignored, "-Wuninitialized");
+PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wmaybe-uninitialized");
+
+// A PersistentJournal stores a sequence of variable-length records, such as
+// crash log entries, in persistent RAM. Unlike PersistentBuffer, which protects
+// its whole contents with one CRC, each record carries its own CRC16:
+//
+// - Appending a record only checksums that record, so it is O(record size)
+//   regardless of how much the journal already holds.
+// - If the device resets partway through an append, only that record is lost.
+//   The records before it remain valid and readable after the reset.
+//
+// The offset of the end of the journal is kept with a small checksum of its
+// own. If that checksum does not match, for example because a reset
+// interrupted an update, the end is recovered by scanning the records. The
+// scan stops at the first record that is not intact.
+//
+// Clearing the journal advances an epoch counter that is included in every
+// record's CRC, so records left over from before the clear are not mistaken
+// for new ones.
+//
+// Like PersistentBuffer, this object is safe to use before static constructors
+// run, since its constructor and destructor do nothing.
+template <size_t kMaxSizeBytes>
+class PersistentJournal {
+ public:
+  static constexpr size_t kRecordHeaderSizeBytes =
+      internal::PersistentJournalImpl::kRecordHeaderSizeBytes;
+
+  // The default constructor intentionally does not initialize anything, so
+  // that records persist across resets. See PersistentBuffer.
+  PersistentJournal() {}
+  PersistentJournal(const PersistentJournal&) = delete;
+  PersistentJournal(PersistentJournal&&) = delete;
+  ~PersistentJournal() {}
+
+  // Appends a record. Returns:
+  //
+  //   OK - the record was appended
+  //   INVALID_ARGUMENT - the record is empty or larger than 65535 bytes
+  //   RESOURCE_EXHAUSTED - the record and its header do not fit
+  //
+  Status Append(ConstByteSpan record) { return Impl().Append(record); }
+
+  // Calls function(ConstByteSpan) with the data of each intact record, oldest
+  // first. Each record's CRC is checked as it is read.
+  template <typename Function>
+  void ForEachRecord(Function&& function) const {
+    const internal::PersistentJournalImpl impl = Impl();
+    const size_t end = impl.End();
+    size_t offset = 0;
+    for (ConstByteSpan record = impl.RecordAt(offset, end); !record.empty();
+         record = impl.RecordAt(offset, end)) {
+      function(record);
+      offset += kRecordHeaderSizeBytes + record.size();
+    }
+  }
+
+  // The number of bytes used by records, including their headers.
+  size_t size() const { return Impl().End(); }
+
+  bool empty() const { return size() == 0u; }
+
+  static constexpr size_t max_size() { return kMaxSizeBytes; }
+
+  // Discards all records.
+  void clear() { Impl().Clear(); }
+
+ private:
+  internal::PersistentJournalImpl Impl() const {
+    auto& self = const_cast<PersistentJournal&>(*this);
+    return internal::PersistentJournalImpl(
+        ByteSpan(const_cast<std::byte*>(self.buffer_), kMaxSizeBytes),
+        self.epoch_,
+        self.end_,
+        self.end_checksum_);
+  }
+
+  // None of these members are initialized by the constructor by design.
+  volatile uint32_t epoch_;
+  volatile size_t end_;
+  volatile uint16_t end_checksum_;
+  volatile std::byte buffer_[kMaxSizeBytes];
+};
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
+}  // namespace pw::persistent_ram
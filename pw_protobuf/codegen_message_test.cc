@@ -17,6 +17,7 @@
 #include <tuple>
 
 #include "gtest/gtest.h"
+#include "pw_allocator/arena.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_protobuf/internal/codegen.h"
 #include "pw_span/span.h"
@@ -31,6 +32,7 @@
 // The purpose of the tests in this file is primarily to verify that the
 // generated C++ interface is valid rather than the correctness of the
 // low-level encoder.
+#include "pw_protobuf_test_protos/arena.pwpb.h"
 #include "pw_protobuf_test_protos/full_test.pwpb.h"
 #include "pw_protobuf_test_protos/importer.pwpb.h"
 #include "pw_protobuf_test_protos/optional.pwpb.h"
@@ -1646,6 +1648,86 @@ TEST(CodegenMessage, WriteNestedImported) {
             0);
 }
 
+TEST(CodegenMessage, WriteNestedWithoutScratchBuffer) {
+  Period::Message message{};
+  message.start.seconds = 1517949900u;
+  message.end.seconds = 1517950378u;
+
+  // Nested messages without callbacks are sized up front and written directly
+  // to the stream, so no scratch buffer is needed.
+  std::byte encode_buffer[Period::kMaxEncodedSizeBytes];
+
+  stream::MemoryWriter writer(encode_buffer);
+  Period::StreamEncoder period(writer, ByteSpan());
+
+  const auto status = period.Write(message);
+  ASSERT_EQ(status, OkStatus());
+
+  // clang-format off
+  constexpr uint8_t expected_proto[] = {
+    // period.start
+    0x0a, 0x06,
+    // period.start.seconds v=1517949900
+    0x08, 0xcc, 0xa7, 0xe8, 0xd3, 0x05,
+    // period.end
+    0x12, 0x06,
+    // period.end.seconds, v=1517950378
+    0x08, 0xaa, 0xab, 0xe8, 0xd3, 0x05,
+  };
+  // clang-format on
+
+  ConstByteSpan result = writer.WrittenData();
+  EXPECT_EQ(result.size(), sizeof(expected_proto));
+  EXPECT_EQ(std::memcmp(result.data(), expected_proto, sizeof(expected_proto)),
+            0);
+}
+
+TEST(CodegenMessage, WriteNestedCallbackWithoutScratchBuffer) {
+  Pigweed::Message message{};
+  message.proto.meta.file_name = "/etc/passwd";
+
+  // Proto has a callback field to break its dependency cycle with Pigweed, so
+  // it is still staged in the scratch buffer.
+  std::byte encode_buffer[Pigweed::kMaxEncodedSizeBytes];
+
+  stream::MemoryWriter writer(encode_buffer);
+  Pigweed::StreamEncoder pigweed(writer, ByteSpan());
+
+  const auto status = pigweed.Write(message);
+  ASSERT_EQ(status, Status::ResourceExhausted());
+}
+
+TEST(CodegenMessage, EncodedSize) {
+  Period::Message message{};
+  message.start.seconds = 1517949900u;
+  message.end.seconds = 1517950378u;
+
+  const StatusWithSize size = Period::StreamEncoder::EncodedSize(message);
+  ASSERT_EQ(size.status(), OkStatus());
+  EXPECT_EQ(size.size(), 16u);
+
+  std::byte encode_buffer[Period::kMaxEncodedSizeBytes];
+  Period::MemoryEncoder period(encode_buffer);
+  ASSERT_EQ(period.Write(message), OkStatus());
+  EXPECT_EQ(period.size(), size.size());
+}
+
+TEST(CodegenMessage, EncodedSizeDefaults) {
+  Period::Message message{};
+
+  const StatusWithSize size = Period::StreamEncoder::EncodedSize(message);
+  ASSERT_EQ(size.status(), OkStatus());
+  EXPECT_EQ(size.size(), 0u);
+}
+
+TEST(CodegenMessage, EncodedSizeCallback) {
+  Pigweed::Message message{};
+
+  // Message structures with callbacks can't be sized without calling them.
+  const StatusWithSize size = Pigweed::StreamEncoder::EncodedSize(message);
+  EXPECT_EQ(size.status(), Status::Unimplemented());
+}
+
 TEST(CodegenMessage, WriteNestedRepeated) {
   RepeatedTest::Message message{};
   // Repeated nested messages require a callback since there would otherwise be
@@ -2052,5 +2134,162 @@ TEST(CodegenMessage, CallbackInSubclass) {
   }
 }
 
+// clang-format off
+constexpr uint8_t kArenaProto[] = {
+  // uint32s[], v={1, 300}
+  0x0a, 0x03, 0x01, 0xac, 0x02,
+  // sint64s[], v={-2}
+  0x12, 0x01, 0x03,
+  // fixed32s[], v={5}
+  0x1a, 0x04, 0x05, 0x00, 0x00, 0x00,
+  // bools[], v={true, false}
+  0x22, 0x02, 0x01, 0x00,
+  // data, v={0xab, 0xcd}
+  0x2a, 0x02, 0xab, 0xcd,
+  // name, v="pw"
+  0x32, 0x02, 'p', 'w',
+  // nested
+  0x3a, 0x06,
+  // nested.values[], v={7}
+  0x0a, 0x01, 0x07,
+  // nested.label, v="x"
+  0x12, 0x01, 'x',
+};
+// clang-format on
+
+TEST(CodegenMessage, ReadArena) {
+  stream::MemoryReader reader(as_bytes(span(kArenaProto)));
+  ArenaTest::StreamDecoder arena_test(reader);
+
+  alignas(uint64_t) std::array<std::byte, 64> buffer;
+  allocator::Arena arena(buffer);
+  ArenaTest::Message message{};
+  const auto status = arena_test.Read(message, arena);
+  ASSERT_EQ(status, OkStatus());
+
+  ASSERT_EQ(message.uint32s.size(), 2u);
+  EXPECT_EQ(message.uint32s[0], 1u);
+  EXPECT_EQ(message.uint32s[1], 300u);
+  ASSERT_EQ(message.sint64s.size(), 1u);
+  EXPECT_EQ(message.sint64s[0], -2);
+  ASSERT_EQ(message.fixed32s.size(), 1u);
+  EXPECT_EQ(message.fixed32s[0], 5u);
+  ASSERT_EQ(message.bools.size(), 2u);
+  EXPECT_TRUE(message.bools[0]);
+  EXPECT_FALSE(message.bools[1]);
+  ASSERT_EQ(message.data.size(), 2u);
+  EXPECT_EQ(message.data[0], std::byte{0xab});
+  EXPECT_EQ(message.data[1], std::byte{0xcd});
+  EXPECT_EQ(message.name, "pw");
+  ASSERT_EQ(message.nested.values.size(), 1u);
+  EXPECT_EQ(message.nested.values[0], 7u);
+  EXPECT_EQ(message.nested.label, "x");
+
+  // Unused space reserved for packed varints is returned to the arena.
+  EXPECT_LT(arena.used(), buffer.size());
+}
+
+TEST(CodegenMessage, ReadArenaUnpacked) {
+  // clang-format off
+  constexpr uint8_t proto_data[] = {
+    // uint32s[], v={1, 2} unpacked
+    0x08, 0x01,
+    0x08, 0x02,
+    // name, v="pw"
+    0x32, 0x02, 'p', 'w',
+    // uint32s[], v={3} packed
+    0x0a, 0x01, 0x03,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(proto_data)));
+  ArenaTest::StreamDecoder arena_test(reader);
+
+  alignas(uint64_t) std::array<std::byte, 64> buffer;
+  allocator::Arena arena(buffer);
+  ArenaTest::Message message{};
+  const auto status = arena_test.Read(message, arena);
+  ASSERT_EQ(status, OkStatus());
+
+  ASSERT_EQ(message.uint32s.size(), 3u);
+  for (unsigned short i = 0; i < 3; ++i) {
+    EXPECT_EQ(message.uint32s[i], i + 1u);
+  }
+  EXPECT_EQ(message.name, "pw");
+}
+
+TEST(CodegenMessage, ReadArenaWithoutArena) {
+  stream::MemoryReader reader(as_bytes(span(kArenaProto)));
+  ArenaTest::StreamDecoder arena_test(reader);
+
+  ArenaTest::Message message{};
+  const auto status = arena_test.Read(message);
+  EXPECT_EQ(status, Status::FailedPrecondition());
+}
+
+TEST(CodegenMessage, ReadArenaExhausted) {
+  stream::MemoryReader reader(as_bytes(span(kArenaProto)));
+  ArenaTest::StreamDecoder arena_test(reader);
+
+  alignas(uint64_t) std::array<std::byte, 8> buffer;
+  allocator::Arena arena(buffer);
+  ArenaTest::Message message{};
+  const auto status = arena_test.Read(message, arena);
+  EXPECT_EQ(status, Status::ResourceExhausted());
+}
+
+TEST(CodegenMessage, WriteArena) {
+  constexpr uint32_t kUint32s[] = {1, 300};
+  constexpr int64_t kSint64s[] = {-2};
+  constexpr uint32_t kFixed32s[] = {5};
+  constexpr bool kBools[] = {true, false};
+  constexpr std::byte kData[] = {std::byte{0xab}, std::byte{0xcd}};
+  constexpr uint32_t kNestedValues[] = {7};
+
+  ArenaTest::Message message{};
+  message.uint32s = kUint32s;
+  message.sint64s = kSint64s;
+  message.fixed32s = kFixed32s;
+  message.bools = kBools;
+  message.data = kData;
+  message.name = "pw";
+  message.nested.values = kNestedValues;
+  message.nested.label = "x";
+
+  std::byte encode_buffer[ArenaTest::kMaxEncodedSizeBytes + 32];
+  stream::MemoryWriter writer(encode_buffer);
+  ArenaTest::StreamEncoder arena_test(writer, ByteSpan());
+  const auto status = arena_test.Write(message);
+  ASSERT_EQ(status, OkStatus());
+
+  ConstByteSpan result = writer.WrittenData();
+  ConstByteSpan expected = as_bytes(span(kArenaProto));
+  EXPECT_EQ(result.size(), expected.size());
+  EXPECT_EQ(std::memcmp(result.data(), expected.data(), expected.size()), 0);
+
+  const StatusWithSize size = ArenaTest::StreamEncoder::EncodedSize(message);
+  ASSERT_EQ(size.status(), OkStatus());
+  EXPECT_EQ(size.size(), expected.size());
+}
+
+TEST(CodegenMessage, ArenaEquality) {
+  constexpr uint32_t kOne[] = {1, 2, 3};
+  constexpr uint32_t kTwo[] = {1, 2, 3};
+  constexpr uint32_t kThree[] = {1, 2};
+
+  ArenaTest::Message one{};
+  one.uint32s = kOne;
+  one.name = "pw";
+  ArenaTest::Message two{};
+  two.uint32s = kTwo;
+  two.name = "pw";
+
+  // Fields stored in an arena compare their values, not their storage.
+  EXPECT_TRUE(one == two);
+
+  two.uint32s = kThree;
+  EXPECT_FALSE(one == two);
+}
+
 }  // namespace
 }  // namespace pw::protobuf
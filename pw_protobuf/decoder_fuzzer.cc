@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "fuzz.h"
+#include "pw_fuzzer/cost_feedback.h"
 #include "pw_fuzzer/fuzzed_data_provider.h"
 #include "pw_protobuf/stream_decoder.h"
 #include "pw_span/span.h"
@@ -212,8 +213,11 @@ void TestOneInput(FuzzedDataProvider& provider) {
 }  // namespace
 }  // namespace pw::protobuf::fuzz
 
+// Set PW_FUZZER_COST_FEEDBACK=1 to search for inputs that are slow to decode.
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
-  FuzzedDataProvider provider(data, size);
-  pw::protobuf::fuzz::TestOneInput(provider);
-  return 0;
+  return pw::fuzzer::RunWithCostFeedback(
+      data, size, [](const uint8_t* input, size_t input_size) {
+        FuzzedDataProvider provider(input, input_size);
+        pw::protobuf::fuzz::TestOneInput(provider);
+      });
 }
@@ -0,0 +1,90 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_protobuf/stream_decoder.h"
+#include "pw_status/status.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::protobuf {
+namespace {
+
+constexpr size_t kFieldCount = 16;
+
+// A message with kFieldCount fields, alternating between integers and
+// strings, like a typical log or metric entry.
+struct Message {
+  Message() {
+    MemoryEncoder encoder(buffer);
+    for (uint32_t field = 1; field <= kFieldCount; ++field) {
+      if (field % 2 == 1) {
+        encoder.WriteUint32(field, field * 100000).IgnoreError();
+      } else {
+        encoder.WriteString(field, "pigweed").IgnoreError();
+      }
+    }
+    size = encoder.size();
+  }
+
+  ConstByteSpan encoded() const { return span(buffer).first(size); }
+
+  std::array<std::byte, 256> buffer{};
+  size_t size = 0;
+};
+
+void MemoryDecoderTest(perf_test::State& state) {
+  const Message message;
+  uint32_t value = 0;
+  std::string_view text;
+  while (state.KeepRunning()) {
+    Decoder decoder(message.encoded());
+    while (decoder.Next().ok()) {
+      if (decoder.FieldNumber() % 2 == 1) {
+        decoder.ReadUint32(&value).IgnoreError();
+      } else {
+        decoder.ReadString(&text).IgnoreError();
+      }
+    }
+  }
+}
+
+void StreamDecoderTest(perf_test::State& state) {
+  const Message message;
+  std::array<char, 16> text;
+  while (state.KeepRunning()) {
+    stream::MemoryReader reader(message.encoded());
+    StreamDecoder decoder(reader);
+    while (decoder.Next().ok()) {
+      if (decoder.FieldNumber().value() % 2 == 1) {
+        decoder.ReadUint32().IgnoreError();
+      } else {
+        decoder.ReadString(text).IgnoreError();
+      }
+    }
+  }
+}
+
+PW_PERF_TEST(MemoryDecoderMessage, MemoryDecoderTest);
+PW_PERF_TEST(StreamDecoderMessage, StreamDecoderTest);
+
+}  // namespace
+}  // namespace pw::protobuf
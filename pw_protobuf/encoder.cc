@@ -15,9 +15,11 @@
 #include "pw_protobuf/encoder.h"
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <optional>
+#include <string_view>
 
 #include "pw_assert/check.h"
 #include "pw_bytes/span.h"
@@ -37,11 +39,140 @@ namespace pw::protobuf {
 
 using internal::VarintType;
 
+namespace {
+
+// Encodes a length prefix that always occupies config::kMaxVarintSize bytes,
+// so that it can be overwritten in place once the final length is known.
+std::array<std::byte, config::kMaxVarintSize> PaddedLengthPrefix(
+    size_t length) {
+  std::array<std::byte, config::kMaxVarintSize> prefix;
+  for (std::byte& b : prefix) {
+    b = static_cast<std::byte>((length & 0x7f) | 0x80);
+    length >>= 7;
+  }
+  prefix.back() &= std::byte{0x7f};
+  return prefix;
+}
+
+bool AllZero(span<const std::byte> values) {
+  return static_cast<size_t>(std::count(
+             values.begin(), values.end(), std::byte{0})) == values.size();
+}
+
+// Returns the payload size of a packed varint field, matching
+// StreamEncoder::WritePackedVarints().
+template <typename T>
+size_t PackedVarintsSize(span<T> values, VarintType encode_type) {
+  size_t payload_size = 0;
+  for (T val : values) {
+    if (encode_type == VarintType::kZigZag) {
+      int64_t integer =
+          static_cast<int64_t>(static_cast<std::make_signed_t<T>>(val));
+      payload_size += varint::EncodedSize(varint::ZigZagEncode(integer));
+    } else {
+      payload_size += varint::EncodedSize(static_cast<uint64_t>(val));
+    }
+  }
+  return payload_size;
+}
+
+// Returns the values of a field stored in an arena. The struct member is a
+// std::string_view for string fields, and a pw::span of the element type
+// otherwise.
+ConstByteSpan ArenaFieldBytes(const internal::MessageField& field,
+                              span<const std::byte> values) {
+  if (field.is_string()) {
+    const auto* string =
+        reinterpret_cast<const std::string_view*>(values.data());
+    return as_bytes(span(string->data(), string->size()));
+  }
+  if (field.elem_size() == sizeof(uint64_t)) {
+    return as_bytes(
+        *reinterpret_cast<const span<const uint64_t>*>(values.data()));
+  }
+  if (field.elem_size() == sizeof(uint32_t)) {
+    return as_bytes(
+        *reinterpret_cast<const span<const uint32_t>*>(values.data()));
+  }
+  return as_bytes(
+      *reinterpret_cast<const span<const uint8_t>*>(values.data()));
+}
+
+// Returns the value of a singular or optional varint struct member as it is
+// written to the wire, or std::nullopt if StreamEncoder::Write() skips it.
+std::optional<uint64_t> VarintFieldValue(const internal::MessageField& field,
+                                         span<const std::byte> values) {
+  if (field.is_optional()) {
+    if (field.elem_size() == sizeof(uint64_t)) {
+      if (field.varint_type() == VarintType::kUnsigned) {
+        return *reinterpret_cast<const std::optional<uint64_t>*>(
+            values.data());
+      }
+      const auto* optional =
+          reinterpret_cast<const std::optional<int64_t>*>(values.data());
+      if (!optional->has_value()) {
+        return std::nullopt;
+      }
+      return field.varint_type() == VarintType::kZigZag
+                 ? varint::ZigZagEncode(optional->value())
+                 : static_cast<uint64_t>(optional->value());
+    }
+    if (field.elem_size() == sizeof(uint32_t)) {
+      if (field.varint_type() == VarintType::kUnsigned) {
+        return *reinterpret_cast<const std::optional<uint32_t>*>(
+            values.data());
+      }
+      const auto* optional =
+          reinterpret_cast<const std::optional<int32_t>*>(values.data());
+      if (!optional->has_value()) {
+        return std::nullopt;
+      }
+      return field.varint_type() == VarintType::kZigZag
+                 ? varint::ZigZagEncode(optional->value())
+                 : static_cast<uint64_t>(optional->value());
+    }
+    return *reinterpret_cast<const std::optional<bool>*>(values.data());
+  }
+
+  uint64_t value = 0;
+  if (field.elem_size() == sizeof(uint64_t)) {
+    if (field.varint_type() == VarintType::kZigZag) {
+      value = varint::ZigZagEncode(
+          *reinterpret_cast<const int64_t*>(values.data()));
+    } else if (field.varint_type() == VarintType::kNormal) {
+      value = *reinterpret_cast<const int64_t*>(values.data());
+    } else {
+      value = *reinterpret_cast<const uint64_t*>(values.data());
+    }
+  } else if (field.elem_size() == sizeof(uint32_t)) {
+    if (field.varint_type() == VarintType::kZigZag) {
+      value = varint::ZigZagEncode(
+          *reinterpret_cast<const int32_t*>(values.data()));
+    } else if (field.varint_type() == VarintType::kNormal) {
+      value = *reinterpret_cast<const int32_t*>(values.data());
+    } else {
+      value = *reinterpret_cast<const uint32_t*>(values.data());
+    }
+  } else if (field.elem_size() == sizeof(bool)) {
+    value = *reinterpret_cast<const bool*>(values.data());
+  }
+  if (!value) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+}  // namespace
+
 StreamEncoder StreamEncoder::GetNestedEncoder(uint32_t field_number,
                                               bool write_when_empty) {
   PW_CHECK(!nested_encoder_open());
   PW_CHECK(ValidFieldNumber(field_number));
 
+  if (seekable_writer_ != nullptr) {
+    return GetSeekableNestedEncoder(field_number, write_when_empty);
+  }
+
   nested_field_number_ = field_number;
 
   // Pass the unused space of the scratch buffer to the nested encoder to use
@@ -68,6 +199,25 @@ StreamEncoder StreamEncoder::GetNestedEncoder(uint32_t field_number,
   return StreamEncoder(*this, nested_buffer, write_when_empty);
 }
 
+StreamEncoder StreamEncoder::GetSeekableNestedEncoder(uint32_t field_number,
+                                                      bool write_when_empty) {
+  size_t length_prefix_offset = 0;
+  if (UpdateStatusForWrite(
+          field_number, WireType::kDelimited, config::kMaxVarintSize)
+          .ok() &&
+      WriteVarint(FieldKey(field_number, WireType::kDelimited)).ok()) {
+    length_prefix_offset = seekable_writer_->Tell();
+    if (length_prefix_offset == stream::Stream::kUnknownPosition) {
+      status_ = Status::Unimplemented();
+    } else {
+      status_.Update(writer_.Write(PaddedLengthPrefix(0)));
+    }
+  }
+
+  nested_field_number_ = field_number;
+  return StreamEncoder(*this, status_, length_prefix_offset, write_when_empty);
+}
+
 void StreamEncoder::CloseEncoder() {
   // If this was an invalidated StreamEncoder which cannot be used, permit the
   // object to be cleanly destructed by doing nothing.
@@ -106,6 +256,11 @@ void StreamEncoder::CloseNestedMessage(StreamEncoder& nested) {
     return;
   }
 
+  if (seekable_writer_ != nullptr) {
+    status_ = BackPatchLengthPrefix(temp_field_number, nested);
+    return;
+  }
+
   if (varint::EncodedSize(nested.memory_writer_.bytes_written()) >
       config::kMaxVarintSize) {
     status_ = Status::OutOfRange();
@@ -120,6 +275,31 @@ void StreamEncoder::CloseNestedMessage(StreamEncoder& nested) {
                                       nested.memory_writer_.WrittenData());
 }
 
+Status StreamEncoder::BackPatchLengthPrefix(uint32_t field_number,
+                                            const StreamEncoder& nested) {
+  stream::SeekableWriter& writer = *seekable_writer_;
+  const size_t payload_start =
+      nested.length_prefix_offset_ + config::kMaxVarintSize;
+  const size_t end = writer.Tell();
+  const size_t payload_size = end - payload_start;
+
+  if (payload_size == 0 && !nested.write_when_empty_) {
+    // Rewind over the key and placeholder so that the field is omitted.
+    const size_t key_size =
+        varint::EncodedSize(FieldKey(field_number, WireType::kDelimited));
+    return writer.Seek(
+        static_cast<ptrdiff_t>(nested.length_prefix_offset_ - key_size));
+  }
+
+  if (varint::EncodedSize(payload_size) > config::kMaxVarintSize) {
+    return Status::OutOfRange();
+  }
+
+  PW_TRY(writer.Seek(static_cast<ptrdiff_t>(nested.length_prefix_offset_)));
+  PW_TRY(writer.Write(PaddedLengthPrefix(payload_size)));
+  return writer.Seek(static_cast<ptrdiff_t>(end));
+}
+
 Status StreamEncoder::WriteVarintField(uint32_t field_number, uint64_t value) {
   PW_TRY(UpdateStatusForWrite(
       field_number, WireType::kVarint, varint::EncodedSize(value)));
@@ -241,6 +421,43 @@ Status StreamEncoder::UpdateStatusForWrite(uint32_t field_number,
   return status_;
 }
 
+Status StreamEncoder::WriteArenaField(const internal::MessageField& field,
+                                      span<const std::byte> values) {
+  const ConstByteSpan bytes = ArenaFieldBytes(field, values);
+  if (bytes.empty()) {
+    return OkStatus();
+  }
+
+  switch (field.wire_type()) {
+    case WireType::kFixed64:
+    case WireType::kFixed32:
+      return WritePackedFixed(field.field_number(), bytes, field.elem_size());
+    case WireType::kVarint:
+      if (field.elem_size() == sizeof(uint64_t)) {
+        return WritePackedVarints(
+            field.field_number(),
+            span(reinterpret_cast<const uint64_t*>(bytes.data()),
+                 bytes.size() / sizeof(uint64_t)),
+            field.varint_type());
+      }
+      if (field.elem_size() == sizeof(uint32_t)) {
+        return WritePackedVarints(
+            field.field_number(),
+            span(reinterpret_cast<const uint32_t*>(bytes.data()),
+                 bytes.size() / sizeof(uint32_t)),
+            field.varint_type());
+      }
+      return WritePackedVarints(
+          field.field_number(),
+          span(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()),
+          field.varint_type());
+    case WireType::kDelimited:
+      return WriteLengthDelimitedField(field.field_number(), bytes);
+  }
+
+  return OkStatus();
+}
+
 Status StreamEncoder::Write(span<const std::byte> message,
                             span<const internal::MessageField> table) {
   PW_CHECK(!nested_encoder_open());
@@ -264,6 +481,13 @@ Status StreamEncoder::Write(span<const std::byte> message,
       continue;
     }
 
+    // Repeated, bytes, and string fields stored in an arena are spans over
+    // their values, written with packed encoding or as a delimited field.
+    if (field.use_arena()) {
+      PW_TRY(WriteArenaField(field, values));
+      continue;
+    }
+
     switch (field.wire_type()) {
       case WireType::kFixed64:
       case WireType::kFixed32: {
@@ -415,102 +639,17 @@ Status StreamEncoder::Write(span<const std::byte> message,
                                         field.varint_type()));
             }
           }
-        } else if (field.is_optional()) {
-          // The struct member for this field is a std::optional of a type
-          // corresponding to the field element size. Cast to the correct
-          // optional type so we're not performing type aliasing (except for
-          // unsigned vs signed which is explicitly allowed), and write from
-          // a temporary.
-          uint64_t value = 0;
-          if (field.elem_size() == sizeof(uint64_t)) {
-            if (field.varint_type() == VarintType::kUnsigned) {
-              const auto* optional =
-                  reinterpret_cast<const std::optional<uint64_t>*>(
-                      values.data());
-              if (!optional->has_value()) {
-                continue;
-              }
-              value = optional->value();
-            } else {
-              const auto* optional =
-                  reinterpret_cast<const std::optional<int64_t>*>(
-                      values.data());
-              if (!optional->has_value()) {
-                continue;
-              }
-              value = field.varint_type() == VarintType::kZigZag
-                          ? varint::ZigZagEncode(optional->value())
-                          : optional->value();
-            }
-          } else if (field.elem_size() == sizeof(uint32_t)) {
-            if (field.varint_type() == VarintType::kUnsigned) {
-              const auto* optional =
-                  reinterpret_cast<const std::optional<uint32_t>*>(
-                      values.data());
-              if (!optional->has_value()) {
-                continue;
-              }
-              value = optional->value();
-            } else {
-              const auto* optional =
-                  reinterpret_cast<const std::optional<int32_t>*>(
-                      values.data());
-              if (!optional->has_value()) {
-                continue;
-              }
-              value = field.varint_type() == VarintType::kZigZag
-                          ? varint::ZigZagEncode(optional->value())
-                          : optional->value();
-            }
-          } else if (field.elem_size() == sizeof(bool)) {
-            const auto* optional =
-                reinterpret_cast<const std::optional<bool>*>(values.data());
-            if (!optional->has_value()) {
-              continue;
-            }
-            value = optional->value();
-          }
-          PW_TRY(WriteVarintField(field.field_number(), value));
         } else {
-          // The struct member for this field is a scalar of a type
-          // corresponding to the field element size. Cast to the correct
-          // type to retrieve the value before passing to WriteVarintField()
-          // so we're not performing type aliasing (except for unsigned vs
-          // signed which is explicitly allowed).
-          PW_CHECK(values.size() == field.elem_size(),
+          // The struct member for this field is a scalar or a std::optional of
+          // a type corresponding to the field element size. Retrieve the value
+          // with the correct type so we're not performing type aliasing
+          // (except for unsigned vs signed which is explicitly allowed).
+          PW_CHECK(field.is_optional() || values.size() == field.elem_size(),
                    "Mismatched message field type and size");
-          uint64_t value = 0;
-          if (field.elem_size() == sizeof(uint64_t)) {
-            if (field.varint_type() == VarintType::kZigZag) {
-              value = varint::ZigZagEncode(
-                  *reinterpret_cast<const int64_t*>(values.data()));
-            } else if (field.varint_type() == VarintType::kNormal) {
-              value = *reinterpret_cast<const int64_t*>(values.data());
-            } else {
-              value = *reinterpret_cast<const uint64_t*>(values.data());
-            }
-            if (!value) {
-              continue;
-            }
-          } else if (field.elem_size() == sizeof(uint32_t)) {
-            if (field.varint_type() == VarintType::kZigZag) {
-              value = varint::ZigZagEncode(
-                  *reinterpret_cast<const int32_t*>(values.data()));
-            } else if (field.varint_type() == VarintType::kNormal) {
-              value = *reinterpret_cast<const int32_t*>(values.data());
-            } else {
-              value = *reinterpret_cast<const uint32_t*>(values.data());
-            }
-            if (!value) {
-              continue;
-            }
-          } else if (field.elem_size() == sizeof(bool)) {
-            value = *reinterpret_cast<const bool*>(values.data());
-            if (!value) {
-              continue;
-            }
+          const std::optional<uint64_t> value = VarintFieldValue(field, values);
+          if (value.has_value()) {
+            PW_TRY(WriteVarintField(field.field_number(), value.value()));
           }
-          PW_TRY(WriteVarintField(field.field_number(), value));
         }
         break;
       }
@@ -522,11 +661,33 @@ Status StreamEncoder::Write(span<const std::byte> message,
                  "Repeated delimited messages always require a callback");
         if (field.nested_message_fields()) {
           // Nested Message. Struct member is an embedded struct for the
-          // nested field. Obtain a nested encoder and recursively call Write()
-          // using the fields table pointer from this field.
-          auto nested_encoder = GetNestedEncoder(field.field_number(),
-                                                 /*write_when_empty=*/false);
-          PW_TRY(nested_encoder.Write(values, *field.nested_message_fields()));
+          // nested field. If the nested message has no callbacks, calculate
+          // its size up front and write the key and length prefix, then
+          // recursively call Write() on this encoder using the fields table
+          // pointer from this field, so the nested fields are written straight
+          // to the stream.
+          const auto& nested_fields = *field.nested_message_fields();
+          const StatusWithSize nested_size = EncodedSize(values, nested_fields);
+          if (nested_size.IsUnimplemented()) {
+            // Callbacks may write anything, so obtain a nested encoder that
+            // stages the nested message in the scratch buffer instead.
+            auto nested_encoder = GetNestedEncoder(field.field_number(),
+                                                   /*write_when_empty=*/false);
+            PW_TRY(nested_encoder.Write(values, nested_fields));
+            continue;
+          }
+          status_.Update(nested_size.status());
+          PW_TRY(status_);
+          if (nested_size.size() == 0) {
+            continue;
+          }
+          PW_TRY(UpdateStatusForWrite(field.field_number(),
+                                      WireType::kDelimited,
+                                      nested_size.size()));
+          status_.Update(WriteLengthDelimitedKeyAndLengthPrefix(
+              field.field_number(), nested_size.size(), writer_));
+          PW_TRY(status_);
+          PW_TRY(Write(values, nested_fields));
         } else if (field.is_fixed_size()) {
           // Fixed-length bytes field. Struct member is a std::array<std::byte>.
           // Call WriteLengthDelimitedField() to output it to the stream.
@@ -560,4 +721,182 @@ Status StreamEncoder::Write(span<const std::byte> message,
   return status_;
 }
 
+StatusWithSize StreamEncoder::EncodedSize(
+    span<const std::byte> message, span<const internal::MessageField> table) {
+  // Mirrors Write(), adding up the size of each field that it would write.
+  size_t size = 0;
+
+  for (const auto& field : table) {
+    const auto values =
+        message.subspan(field.field_offset(), field.field_size());
+    PW_CHECK(values.begin() >= message.begin() &&
+             values.end() <= message.end());
+
+    // Callbacks can write anything, and calling them here as well as from
+    // Write() could have side effects.
+    if (field.use_callback()) {
+      return StatusWithSize::Unimplemented();
+    }
+
+    if (!ValidFieldNumber(field.field_number())) {
+      return StatusWithSize::InvalidArgument();
+    }
+
+    if (field.use_arena()) {
+      const ConstByteSpan bytes = ArenaFieldBytes(field, values);
+      if (bytes.empty()) {
+        continue;
+      }
+      size_t payload_size = bytes.size();
+      if (field.wire_type() == WireType::kVarint) {
+        if (field.elem_size() == sizeof(uint64_t)) {
+          payload_size = PackedVarintsSize(
+              span(reinterpret_cast<const uint64_t*>(bytes.data()),
+                   bytes.size() / sizeof(uint64_t)),
+              field.varint_type());
+        } else if (field.elem_size() == sizeof(uint32_t)) {
+          payload_size = PackedVarintsSize(
+              span(reinterpret_cast<const uint32_t*>(bytes.data()),
+                   bytes.size() / sizeof(uint32_t)),
+              field.varint_type());
+        } else {
+          payload_size = PackedVarintsSize(
+              span(reinterpret_cast<const uint8_t*>(bytes.data()),
+                   bytes.size()),
+              field.varint_type());
+        }
+      }
+      size += SizeOfDelimitedField(field.field_number(), payload_size);
+      continue;
+    }
+
+    switch (field.wire_type()) {
+      case WireType::kFixed64:
+      case WireType::kFixed32: {
+        if (field.is_fixed_size()) {
+          if (!AllZero(values)) {
+            size += SizeOfDelimitedField(field.field_number(), values.size());
+          }
+        } else if (field.is_repeated()) {
+          const size_t count =
+              field.elem_size() == sizeof(uint64_t)
+                  ? reinterpret_cast<const pw::Vector<const uint64_t>*>(
+                        values.data())
+                        ->size()
+                  : reinterpret_cast<const pw::Vector<const uint32_t>*>(
+                        values.data())
+                        ->size();
+          if (count != 0) {
+            size += SizeOfDelimitedField(field.field_number(),
+                                         count * field.elem_size());
+          }
+        } else if (field.is_optional()) {
+          const bool has_value =
+              field.elem_size() == sizeof(uint64_t)
+                  ? reinterpret_cast<const std::optional<uint64_t>*>(
+                        values.data())
+                        ->has_value()
+                  : reinterpret_cast<const std::optional<uint32_t>*>(
+                        values.data())
+                        ->has_value();
+          if (has_value) {
+            size += SizeOfField(
+                field.field_number(), field.wire_type(), field.elem_size());
+          }
+        } else if (!AllZero(values)) {
+          size += SizeOfField(
+              field.field_number(), field.wire_type(), field.elem_size());
+        }
+        break;
+      }
+      case WireType::kVarint: {
+        size_t payload_size = 0;
+        if (field.is_fixed_size()) {
+          if (AllZero(values)) {
+            continue;
+          }
+          const size_t count = values.size() / field.elem_size();
+          if (field.elem_size() == sizeof(uint64_t)) {
+            payload_size = PackedVarintsSize(
+                span(reinterpret_cast<const uint64_t*>(values.data()), count),
+                field.varint_type());
+          } else if (field.elem_size() == sizeof(uint32_t)) {
+            payload_size = PackedVarintsSize(
+                span(reinterpret_cast<const uint32_t*>(values.data()), count),
+                field.varint_type());
+          } else {
+            payload_size = PackedVarintsSize(
+                span(reinterpret_cast<const uint8_t*>(values.data()), count),
+                field.varint_type());
+          }
+        } else if (field.is_repeated()) {
+          if (field.elem_size() == sizeof(uint64_t)) {
+            const auto* vector =
+                reinterpret_cast<const pw::Vector<const uint64_t>*>(
+                    values.data());
+            if (vector->empty()) {
+              continue;
+            }
+            payload_size = PackedVarintsSize(
+                span(vector->data(), vector->size()), field.varint_type());
+          } else if (field.elem_size() == sizeof(uint32_t)) {
+            const auto* vector =
+                reinterpret_cast<const pw::Vector<const uint32_t>*>(
+                    values.data());
+            if (vector->empty()) {
+              continue;
+            }
+            payload_size = PackedVarintsSize(
+                span(vector->data(), vector->size()), field.varint_type());
+          } else {
+            const auto* vector =
+                reinterpret_cast<const pw::Vector<const uint8_t>*>(
+                    values.data());
+            if (vector->empty()) {
+              continue;
+            }
+            payload_size = PackedVarintsSize(
+                span(vector->data(), vector->size()), field.varint_type());
+          }
+        } else {
+          const std::optional<uint64_t> value = VarintFieldValue(field, values);
+          if (value.has_value()) {
+            size += SizeOfVarintField(field.field_number(), value.value());
+          }
+          continue;
+        }
+        size += SizeOfDelimitedField(field.field_number(), payload_size);
+        break;
+      }
+      case WireType::kDelimited: {
+        size_t payload_size = 0;
+        if (field.nested_message_fields()) {
+          const StatusWithSize nested =
+              EncodedSize(values, *field.nested_message_fields());
+          PW_TRY_WITH_SIZE(nested);
+          if (varint::EncodedSize(nested.size()) > config::kMaxVarintSize) {
+            return StatusWithSize::OutOfRange();
+          }
+          payload_size = nested.size();
+        } else if (field.is_fixed_size()) {
+          payload_size = AllZero(values) ? 0 : values.size();
+        } else if (field.is_string()) {
+          payload_size =
+              reinterpret_cast<const InlineString<>*>(values.data())->size();
+        } else {
+          payload_size =
+              reinterpret_cast<const Vector<const std::byte>*>(values.data())
+                  ->size();
+        }
+        if (payload_size != 0) {
+          size += SizeOfDelimitedField(field.field_number(), payload_size);
+        }
+        break;
+      }
+    }
+  }
+
+  return StatusWithSize(size);
+}
+
 }  // namespace pw::protobuf
@@ -15,6 +15,7 @@
 #include "pw_protobuf/encoder.h"
 
 #include "gtest/gtest.h"
+#include "pw_bytes/array.h"
 #include "pw_bytes/span.h"
 #include "pw_span/span.h"
 #include "pw_stream/memory_stream.h"
@@ -528,5 +529,99 @@ TEST(StreamEncoder, ManualCloseEncoderWrites) {
   ASSERT_EQ(parent.size(), kExpectedSize);
 }
 
+TEST(StreamEncoder, SeekableWriterNested) {
+  std::byte dest_buffer[64];
+  MemoryWriter writer(dest_buffer);
+  StreamEncoder encoder(writer);
+
+  EXPECT_EQ(encoder.WriteUint32(kTestProtoMagicNumberField, 42), OkStatus());
+  {
+    StreamEncoder nested_proto =
+        encoder.GetNestedEncoder(kTestProtoNestedField);
+    EXPECT_EQ(nested_proto.WriteString(kNestedProtoHelloField, "world"),
+              OkStatus());
+    {
+      StreamEncoder double_nested_proto =
+          nested_proto.GetNestedEncoder(kNestedProtoPairField);
+      EXPECT_EQ(double_nested_proto.WriteString(kDoubleNestedProtoKeyField,
+                                                "version"),
+                OkStatus());
+    }
+    EXPECT_EQ(nested_proto.WriteUint32(kNestedProtoIdField, 999), OkStatus());
+  }
+  EXPECT_EQ(encoder.WriteSint32(kTestProtoZiggyField, -13), OkStatus());
+
+  // Length prefixes are padded to config::kMaxVarintSize bytes.
+  std::byte expected_buffer[64];
+  MemoryWriter expected(expected_buffer);
+  auto write_padded_size = [&expected](uint8_t size) {
+    ASSERT_EQ(expected.Write(std::byte(size | 0x80)), OkStatus());
+    for (size_t i = 2; i < config::kMaxVarintSize; ++i) {
+      ASSERT_EQ(expected.Write(std::byte{0x80}), OkStatus());
+    }
+    ASSERT_EQ(expected.Write(std::byte{0x00}), OkStatus());
+  };
+
+  // magic_number
+  ASSERT_EQ(expected.Write(bytes::Array<0x08, 0x2a>()), OkStatus());
+  // nested header (key, padded size)
+  ASSERT_EQ(expected.Write(std::byte{0x32}), OkStatus());
+  write_padded_size(0x14 + config::kMaxVarintSize);
+  // nested.hello
+  ASSERT_EQ(expected.Write(bytes::String("\x0a\x05world")), OkStatus());
+  // nested.pair[0] header (key, padded size)
+  ASSERT_EQ(expected.Write(std::byte{0x1a}), OkStatus());
+  write_padded_size(0x09);
+  // nested.pair[0].key
+  ASSERT_EQ(expected.Write(bytes::String("\x0a\x07version")), OkStatus());
+  // nested.id
+  ASSERT_EQ(expected.Write(bytes::Array<0x10, 0xe7, 0x07>()), OkStatus());
+  // ziggy
+  ASSERT_EQ(expected.Write(bytes::Array<0x10, 0x19>()), OkStatus());
+
+  ASSERT_EQ(encoder.status(), OkStatus());
+  ASSERT_EQ(writer.bytes_written(), expected.bytes_written());
+  EXPECT_EQ(std::memcmp(writer.data(), expected.data(), expected.size()), 0);
+}
+
+TEST(StreamEncoder, SeekableWriterEmptyChild) {
+  std::byte dest_buffer[32];
+  MemoryWriter writer(dest_buffer);
+  StreamEncoder encoder(writer);
+  {
+    StreamEncoder child = encoder.GetNestedEncoder(
+        kTestProtoNestedField,
+        StreamEncoder::EmptyEncoderBehavior::kWriteNothing);
+  }
+  ASSERT_EQ(encoder.status(), OkStatus());
+  EXPECT_EQ(writer.bytes_written(), 0u);
+
+  { StreamEncoder child = encoder.GetNestedEncoder(kTestProtoNestedField); }
+  ASSERT_EQ(encoder.status(), OkStatus());
+  EXPECT_EQ(writer.bytes_written(), 1 + config::kMaxVarintSize);
+}
+
+TEST(StreamEncoder, SeekableWriterNestedStatusPropagates) {
+  std::byte dest_buffer[32];
+  MemoryWriter writer(dest_buffer);
+  StreamEncoder encoder(writer);
+  {
+    StreamEncoder child = encoder.GetNestedEncoder(kTestProtoNestedField);
+    ASSERT_EQ(child.WriteUint32(0, 0), Status::InvalidArgument());
+  }
+  ASSERT_EQ(encoder.status(), Status::InvalidArgument());
+}
+
+TEST(StreamEncoder, SeekableWriterInsufficientSpace) {
+  std::byte dest_buffer[4];
+  MemoryWriter writer(dest_buffer);
+  StreamEncoder encoder(writer);
+  {
+    StreamEncoder child = encoder.GetNestedEncoder(kTestProtoNestedField);
+    ASSERT_EQ(child.status(), Status::ResourceExhausted());
+  }
+  ASSERT_EQ(encoder.status(), Status::ResourceExhausted());
+}
+
 }  // namespace
 }  // namespace pw::protobuf
@@ -14,9 +14,58 @@
 
 #include "pw_protobuf/find.h"
 
+#include <algorithm>
+
+#include "pw_bytes/endian.h"
+#include "pw_protobuf/encoder.h"
 #include "pw_protobuf/wire_format.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::protobuf::internal {
+namespace {
+
+// Validates the arguments to FindFields() and clears the output fields.
+Status StartFindFields(span<const uint32_t> field_numbers,
+                       span<ConstByteSpan> fields) {
+  if (field_numbers.size() != fields.size() ||
+      !std::all_of(field_numbers.begin(), field_numbers.end(), [](uint32_t n) {
+        return ValidFieldNumber(n);
+      })) {
+    return Status::InvalidArgument();
+  }
+  std::fill(fields.begin(), fields.end(), ConstByteSpan());
+  return OkStatus();
+}
+
+// Returns whether a field number was requested and has not been found yet.
+bool IsWanted(span<const uint32_t> field_numbers,
+              span<const ConstByteSpan> fields,
+              uint32_t field_number) {
+  for (size_t i = 0; i < field_numbers.size(); ++i) {
+    if (field_numbers[i] == field_number && fields[i].empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Sets the output for each request for a field number, returning how many were
+// set. Field numbers may be requested more than once.
+size_t SetFound(span<const uint32_t> field_numbers,
+                span<ConstByteSpan> fields,
+                uint32_t field_number,
+                ConstByteSpan field) {
+  size_t found = 0;
+  for (size_t i = 0; i < field_numbers.size(); ++i) {
+    if (field_numbers[i] == field_number && fields[i].empty()) {
+      fields[i] = field;
+      found += 1;
+    }
+  }
+  return found;
+}
+
+}  // namespace
 
 Status AdvanceToField(Decoder& decoder, uint32_t field_number) {
   if (!ValidFieldNumber(field_number)) {
@@ -53,4 +102,93 @@ Status AdvanceToField(StreamDecoder& decoder, uint32_t field_number) {
   return status.IsOutOfRange() ? Status::NotFound() : status;
 }
 
+Status FindFields(Decoder& decoder,
+                  span<const uint32_t> field_numbers,
+                  span<ConstByteSpan> fields) {
+  PW_TRY(StartFindFields(field_numbers, fields));
+
+  size_t remaining = field_numbers.size();
+  Status status;
+
+  while (remaining > 0 && (status = decoder.Next()).ok()) {
+    // Next() guarantees there is a valid field at the cursor.
+    remaining -= SetFound(field_numbers,
+                          fields,
+                          decoder.FieldNumber(),
+                          decoder.proto_.first(decoder.FieldSize()));
+  }
+
+  if (remaining == 0) {
+    return OkStatus();
+  }
+
+  // As this is a backend for the Find() APIs, remap OUT_OF_RANGE to NOT_FOUND.
+  return status.IsOutOfRange() ? Status::NotFound() : status;
+}
+
+Status FindFields(StreamDecoder& decoder,
+                  span<const uint32_t> field_numbers,
+                  ByteSpan buffer,
+                  span<ConstByteSpan> fields) {
+  PW_TRY(StartFindFields(field_numbers, fields));
+
+  size_t remaining = field_numbers.size();
+  size_t buffer_used = 0;
+  Status status;
+
+  while (remaining > 0 && (status = decoder.Next()).ok()) {
+    PW_TRY_ASSIGN(const uint32_t field_number, decoder.FieldNumber());
+    if (!IsWanted(field_numbers, fields, field_number)) {
+      continue;
+    }
+
+    // The stream can't be revisited, so write the field into the buffer.
+    // Varints are rewritten in their shortest form, which the typed Find*()
+    // functions read identically.
+    const WireType wire_type = decoder.current_field_.wire_type();
+    const ByteSpan available = buffer.subspan(buffer_used);
+    stream::MemoryWriter writer(available);
+    PW_TRY(WriteVarint(FieldKey(field_number, wire_type), writer));
+    size_t payload_size = 0;
+
+    switch (wire_type) {
+      case WireType::kVarint: {
+        PW_TRY_ASSIGN(const uint64_t value, decoder.ReadUint64());
+        PW_TRY(WriteVarint(value, writer));
+        break;
+      }
+      case WireType::kFixed32: {
+        PW_TRY_ASSIGN(const uint32_t value, decoder.ReadFixed32());
+        PW_TRY(writer.Write(bytes::CopyInOrder(endian::little, value)));
+        break;
+      }
+      case WireType::kFixed64: {
+        PW_TRY_ASSIGN(const uint64_t value, decoder.ReadFixed64());
+        PW_TRY(writer.Write(bytes::CopyInOrder(endian::little, value)));
+        break;
+      }
+      case WireType::kDelimited: {
+        PW_TRY(WriteVarint(decoder.delimited_field_size_, writer));
+        const StatusWithSize read =
+            decoder.ReadBytes(available.subspan(writer.bytes_written()));
+        PW_TRY(read.status());
+        payload_size = read.size();
+        break;
+      }
+    }
+
+    const size_t field_size = writer.bytes_written() + payload_size;
+    buffer_used += field_size;
+    remaining -= SetFound(
+        field_numbers, fields, field_number, available.first(field_size));
+  }
+
+  if (remaining == 0) {
+    return OkStatus();
+  }
+
+  // As this is a backend for the Find() APIs, remap OUT_OF_RANGE to NOT_FOUND.
+  return status.IsOutOfRange() ? Status::NotFound() : status;
+}
+
 }  // namespace pw::protobuf::internal
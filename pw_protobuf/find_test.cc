@@ -14,6 +14,8 @@
 
 #include "pw_protobuf/find.h"
 
+#include <array>
+
 #include "gtest/gtest.h"
 #include "pw_stream/memory_stream.h"
 #include "pw_string/string.h"
@@ -125,6 +127,96 @@ TEST(FindStream, WrongWireType) {
   EXPECT_EQ(FindUint32(reader, 5).status(), Status::FailedPrecondition());
 }
 
+TEST(FindFields, PresentFields) {
+  std::array<ConstByteSpan, 4> fields;
+  ASSERT_EQ(FindFields(encoded_proto, {{6, 2, 5, 7}}, fields), OkStatus());
+
+  Result<std::string_view> str = FindString(fields[0], 6);
+  ASSERT_EQ(str.status(), OkStatus());
+  EXPECT_EQ(*str, "Hello world");
+  EXPECT_EQ(FindSint32(fields[1], 2).value(), -13);
+  EXPECT_EQ(FindFixed32(fields[2], 5).value(), 0xdeadbeef);
+
+  Result<ConstByteSpan> submessage = FindSubmessage(fields[3], 7);
+  ASSERT_EQ(submessage.status(), OkStatus());
+  EXPECT_EQ(FindUint32(*submessage, 1).value(), 3u);
+
+  // Each field is a view of only that field in the message.
+  EXPECT_EQ(fields[1].data(), encoded_proto.data() + 2);
+  EXPECT_EQ(fields[1].size(), 2u);
+}
+
+TEST(FindFields, MissingField) {
+  std::array<ConstByteSpan, 3> fields;
+  EXPECT_EQ(FindFields(encoded_proto, {{1, 8, 4}}, fields),
+            Status::NotFound());
+
+  EXPECT_EQ(FindInt32(fields[0], 1).value(), 42);
+  EXPECT_TRUE(fields[1].empty());
+  EXPECT_EQ(FindDouble(fields[2], 4).value(), 3.14159);
+}
+
+TEST(FindFields, RepeatedFieldNumber) {
+  std::array<ConstByteSpan, 2> fields;
+  ASSERT_EQ(FindFields(encoded_proto, {{3, 3}}, fields), OkStatus());
+  EXPECT_EQ(FindBool(fields[0], 3).value(), false);
+  EXPECT_EQ(fields[0].data(), fields[1].data());
+}
+
+TEST(FindFields, InvalidArguments) {
+  std::array<ConstByteSpan, 2> fields;
+  EXPECT_EQ(FindFields(encoded_proto, {{1, 0}}, fields),
+            Status::InvalidArgument());
+  EXPECT_EQ(FindFields(encoded_proto, {{1, 2, 3}}, fields),
+            Status::InvalidArgument());
+}
+
+TEST(FindFields, StopsAfterLastField) {
+  // Everything after field 2 is corrupt, but is never read.
+  constexpr uint8_t kProto[] = {0x08, 0x2a, 0x10, 0x19, 0xff, 0xff};
+  std::array<ConstByteSpan, 2> fields;
+  EXPECT_EQ(FindFields(as_bytes(span(kProto)), {{2, 1}}, fields), OkStatus());
+  EXPECT_EQ(FindFields(as_bytes(span(kProto)), {{3, 1}}, fields),
+            Status::DataLoss());
+}
+
+TEST(FindFieldsStream, PresentFields) {
+  stream::MemoryReader reader(encoded_proto);
+  std::byte buffer[32];
+  std::array<ConstByteSpan, 5> fields;
+  ASSERT_EQ(FindFields(reader, {{6, 1, 2, 4, 5}}, buffer, fields), OkStatus());
+
+  Result<std::string_view> str = FindString(fields[0], 6);
+  ASSERT_EQ(str.status(), OkStatus());
+  EXPECT_EQ(*str, "Hello world");
+  EXPECT_EQ(FindInt32(fields[1], 1).value(), 42);
+  EXPECT_EQ(FindSint32(fields[2], 2).value(), -13);
+  EXPECT_EQ(FindDouble(fields[3], 4).value(), 3.14159);
+  EXPECT_EQ(FindFixed32(fields[4], 5).value(), 0xdeadbeef);
+
+  // Reading stops once the last field is found.
+  EXPECT_EQ(reader.ConservativeReadLimit(), 4u);
+}
+
+TEST(FindFieldsStream, MissingField) {
+  stream::MemoryReader reader(encoded_proto);
+  std::byte buffer[32];
+  std::array<ConstByteSpan, 2> fields;
+  EXPECT_EQ(FindFields(reader, {{3, 8}}, buffer, fields), Status::NotFound());
+  EXPECT_EQ(FindBool(fields[0], 3).value(), false);
+  EXPECT_TRUE(fields[1].empty());
+}
+
+TEST(FindFieldsStream, BufferTooSmall) {
+  stream::MemoryReader reader(encoded_proto);
+  std::byte buffer[8];
+  std::array<ConstByteSpan, 2> fields;
+  EXPECT_EQ(FindFields(reader, {{1, 6}}, buffer, fields),
+            Status::ResourceExhausted());
+  EXPECT_EQ(FindInt32(fields[0], 1).value(), 42);
+  EXPECT_TRUE(fields[1].empty());
+}
+
 enum class Fields : uint32_t {
   kField1 = 1,
   kField2 = 2,
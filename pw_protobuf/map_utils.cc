@@ -14,14 +14,175 @@
 
 #include "pw_protobuf/map_utils.h"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstring>
+#include <limits>
 
 #include "pw_bytes/span.h"
 #include "pw_protobuf/encoder.h"
 #include "pw_protobuf/serialized_size.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_stream/stream.h"
+#include "pw_varint/varint.h"
 
 namespace pw::protobuf {
+namespace {
+
+constexpr uint32_t kMapKeyFieldNumber = 1;
+constexpr uint32_t kMapValueFieldNumber = 2;
+
+// A varint read from a stream, along with its encoding, so that it can be
+// copied verbatim even if it was not minimally encoded.
+struct RawVarint {
+  ConstByteSpan encoded() const { return span(bytes).first(size); }
+
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> bytes;
+  size_t size = 0;
+  uint64_t value = 0;
+};
+
+// Returns OUT_OF_RANGE if the reader is at its end, or DATA_LOSS if it ends
+// within the varint.
+Status ReadRawVarint(stream::Reader& reader, RawVarint& varint) {
+  varint.size = 0;
+  do {
+    if (varint.size == varint.bytes.size()) {
+      return Status::DataLoss();
+    }
+    Result<ByteSpan> result =
+        reader.Read(span(varint.bytes).subspan(varint.size, 1));
+    if (result.ok() && result->empty()) {
+      result = Status::OutOfRange();
+    }
+    if (!result.ok()) {
+      return result.status().IsOutOfRange() && varint.size != 0u
+                 ? Status::DataLoss()
+                 : result.status();
+    }
+    varint.size += 1;
+  } while ((varint.bytes[varint.size - 1] & std::byte{0x80}) != std::byte{0});
+
+  if (varint::Decode(varint.encoded(), &varint.value) == 0u) {
+    return Status::DataLoss();
+  }
+  return OkStatus();
+}
+
+// Reads a varint that the message requires to be present.
+Status ReadRequiredRawVarint(stream::Reader& reader, RawVarint& varint) {
+  Status status = ReadRawVarint(reader, varint);
+  return status.IsOutOfRange() ? Status::DataLoss() : status;
+}
+
+Status ReadExactly(stream::Reader& reader, ByteSpan destination) {
+  while (!destination.empty()) {
+    Result<ByteSpan> result = reader.Read(destination);
+    if (result.ok() && result->empty()) {
+      result = Status::OutOfRange();
+    }
+    if (!result.ok()) {
+      return result.status().IsOutOfRange() ? Status::DataLoss()
+                                            : result.status();
+    }
+    destination = destination.subspan(result->size());
+  }
+  return OkStatus();
+}
+
+// Reads size bytes from the reader and writes them to the writer, if given.
+Status CopyBytes(stream::Reader& reader,
+                 size_t size,
+                 ByteSpan stream_pipe_buffer,
+                 stream::Writer* writer) {
+  while (size != 0u) {
+    const ByteSpan chunk =
+        stream_pipe_buffer.first(std::min(size, stream_pipe_buffer.size()));
+    PW_TRY(ReadExactly(reader, chunk));
+    if (writer != nullptr) {
+      PW_TRY(writer->Write(chunk));
+    }
+    size -= chunk.size();
+  }
+  return OkStatus();
+}
+
+// Copies a map entry, whose field key and length were already read, from the
+// message to the writer. If the entry's key is `key`, the entry is skipped
+// instead. Returns whether the entry was skipped.
+//
+// Only as much of the entry as needed to tell its key apart from `key` is
+// read before deciding. Those bytes are the entry's header and a prefix of
+// `key` plus the last chunk read, so they are written out from there.
+Result<bool> CopyOrSkipMapEntry(stream::Reader& message,
+                                const RawVarint& field_key,
+                                const RawVarint& length,
+                                std::string_view key,
+                                ByteSpan stream_pipe_buffer,
+                                stream::Writer& writer) {
+  if (length.value > std::numeric_limits<size_t>::max()) {
+    return Status::DataLoss();
+  }
+  size_t remaining = static_cast<size_t>(length.value);
+  auto consume = [&remaining](size_t size) {
+    if (size > remaining) {
+      return Status::DataLoss();
+    }
+    remaining -= size;
+    return OkStatus();
+  };
+
+  RawVarint key_field_key;
+  RawVarint key_length;
+  size_t matched = 0;
+  ConstByteSpan chunk;
+  bool is_match = false;
+
+  if (remaining != 0u) {
+    PW_TRY(ReadRequiredRawVarint(message, key_field_key));
+    PW_TRY(consume(key_field_key.size));
+    if (key_field_key.value ==
+        FieldKey(kMapKeyFieldNumber, WireType::kDelimited)) {
+      PW_TRY(ReadRequiredRawVarint(message, key_length));
+      PW_TRY(consume(key_length.size));
+      is_match = key_length.value == key.size() && key.size() <= remaining;
+    }
+  }
+
+  while (is_match && matched < key.size()) {
+    const ByteSpan read = stream_pipe_buffer.first(
+        std::min(key.size() - matched, stream_pipe_buffer.size()));
+    PW_TRY(ReadExactly(message, read));
+    PW_TRY(consume(read.size()));
+    chunk = read;
+    if (std::memcmp(read.data(), key.data() + matched, read.size()) != 0) {
+      is_match = false;
+      break;
+    }
+    matched += read.size();
+  }
+
+  if (is_match) {
+    PW_TRY(CopyBytes(message, remaining, stream_pipe_buffer, nullptr));
+    return true;
+  }
+
+  const std::array<ConstByteSpan, 6> consumed = {
+      field_key.encoded(),
+      length.encoded(),
+      key_field_key.encoded(),
+      key_length.encoded(),
+      as_bytes(span(key.data(), matched)),
+      chunk,
+  };
+  PW_TRY(writer.WriteV(consumed));
+  PW_TRY(CopyBytes(message, remaining, stream_pipe_buffer, &writer));
+  return false;
+}
+
+}  // namespace
 
 // Note that a map<string, bytes> is essentially
 //
@@ -40,9 +201,6 @@ Status WriteProtoStringToBytesMapEntry(uint32_t field_number,
                                        size_t value_size,
                                        ByteSpan stream_pipe_buffer,
                                        stream::Writer& writer) {
-  constexpr uint32_t kMapKeyFieldNumber = 1;
-  constexpr uint32_t kMapValueFieldNumber = 2;
-
   if (!protobuf::ValidFieldNumber(field_number) ||
       key_size >= std::numeric_limits<uint32_t>::max() ||
       value_size >= std::numeric_limits<uint32_t>::max()) {
@@ -84,4 +242,88 @@ Status WriteProtoStringToBytesMapEntry(uint32_t field_number,
   return OkStatus();
 }
 
+Status UpdateProtoStringToBytesMapEntry(stream::Reader& message,
+                                        uint32_t field_number,
+                                        std::string_view key,
+                                        stream::Reader& value,
+                                        size_t value_size,
+                                        ByteSpan stream_pipe_buffer,
+                                        stream::Writer& writer) {
+  if (!protobuf::ValidFieldNumber(field_number) ||
+      stream_pipe_buffer.empty()) {
+    return Status::InvalidArgument();
+  }
+
+  const uint32_t entry_field_key = FieldKey(field_number, WireType::kDelimited);
+  bool entry_written = false;
+  auto write_entry = [&]() {
+    entry_written = true;
+    stream::MemoryReader key_reader(as_bytes(span(key)));
+    return WriteProtoStringToBytesMapEntry(field_number,
+                                           key_reader,
+                                           key.size(),
+                                           value,
+                                           value_size,
+                                           stream_pipe_buffer,
+                                           writer);
+  };
+
+  RawVarint field_key;
+  RawVarint field_value;
+  while (true) {
+    if (Status status = ReadRawVarint(message, field_key); !status.ok()) {
+      if (status.IsOutOfRange()) {
+        break;
+      }
+      return status;
+    }
+    if (field_key.value > std::numeric_limits<uint32_t>::max() ||
+        !FieldKey::IsValidKey(field_key.value)) {
+      return Status::DataLoss();
+    }
+
+    size_t payload_size = 0;
+    switch (FieldKey(static_cast<uint32_t>(field_key.value)).wire_type()) {
+      case WireType::kVarint:
+        PW_TRY(ReadRequiredRawVarint(message, field_value));
+        break;
+      case WireType::kFixed64:
+        field_value.size = 0;
+        payload_size = sizeof(uint64_t);
+        break;
+      case WireType::kFixed32:
+        field_value.size = 0;
+        payload_size = sizeof(uint32_t);
+        break;
+      case WireType::kDelimited:
+        PW_TRY(ReadRequiredRawVarint(message, field_value));
+        if (field_value.value > std::numeric_limits<size_t>::max()) {
+          return Status::DataLoss();
+        }
+        payload_size = static_cast<size_t>(field_value.value);
+        break;
+    }
+
+    if (field_key.value == entry_field_key) {
+      Result<bool> skipped = CopyOrSkipMapEntry(
+          message, field_key, field_value, key, stream_pipe_buffer, writer);
+      PW_TRY(skipped.status());
+      if (skipped.value() && !entry_written) {
+        PW_TRY(write_entry());
+      }
+      continue;
+    }
+
+    const std::array<ConstByteSpan, 2> header = {field_key.encoded(),
+                                                 field_value.encoded()};
+    PW_TRY(writer.WriteV(header));
+    PW_TRY(CopyBytes(message, payload_size, stream_pipe_buffer, &writer));
+  }
+
+  if (!entry_written) {
+    PW_TRY(write_entry());
+  }
+  return OkStatus();
+}
+
 }  // namespace pw::protobuf
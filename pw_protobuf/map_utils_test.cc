@@ -14,6 +14,7 @@
 
 #include "pw_protobuf/map_utils.h"
 
+#include <cstring>
 #include <string_view>
 
 #include "gtest/gtest.h"
@@ -153,4 +154,161 @@ TEST(ProtoHelper, WriteProtoStringToBytesMapEntryInvalidArgument) {
       Status::InvalidArgument());
 }
 
+// message Maps {
+//   uint32 id = 1;
+//   map<string, string> map_a = 2;
+//   map<string, string> map_b = 3;
+// }
+//
+// with map_a['key_foo'] = 'foo_a', map_a['key_bar'] = 'bar_a', and
+// map_b['key_foo'] = 'foo_b'.
+// clang-format off
+constexpr uint8_t kMaps[] = {
+  // id = 300
+  0x08, 0xac, 0x02,
+
+  // map_a["key_foo"] = "foo_a"
+  0x12, 0x10,
+  0x0a, 0x07, 'k', 'e', 'y', '_', 'f', 'o', 'o',
+  0x12, 0x05, 'f', 'o', 'o', '_', 'a',
+
+  // map_b["key_foo"] = "foo_b"
+  0x1a, 0x10,
+  0x0a, 0x07, 'k', 'e', 'y', '_', 'f', 'o', 'o',
+  0x12, 0x05, 'f', 'o', 'o', '_', 'b',
+
+  // map_a["key_bar"] = "bar_a"
+  0x12, 0x10,
+  0x0a, 0x07, 'k', 'e', 'y', '_', 'b', 'a', 'r',
+  0x12, 0x05, 'b', 'a', 'r', '_', 'a',
+};
+// clang-format on
+
+// Updates kMaps with a one byte pipe buffer, so that keys are compared a byte
+// at a time.
+template <size_t kSize>
+Status UpdateMaps(uint32_t field_number,
+                  std::string_view key,
+                  std::string_view value,
+                  stream::MemoryWriterBuffer<kSize>& writer) {
+  stream::MemoryReader message(as_bytes(span(kMaps)));
+  stream::MemoryReader value_reader(as_bytes(span<const char>{value}));
+  std::byte stream_pipe_buffer[1];
+  return UpdateProtoStringToBytesMapEntry(message,
+                                          field_number,
+                                          key,
+                                          value_reader,
+                                          value.size(),
+                                          stream_pipe_buffer,
+                                          writer);
+}
+
+TEST(ProtoHelper, UpdateProtoStringToBytesMapEntryReplacesEntry) {
+  // clang-format off
+  constexpr uint8_t kExpected[] = {
+    0x08, 0xac, 0x02,
+
+    // map_a["key_foo"] = "new_value"
+    0x12, 0x14,
+    0x0a, 0x07, 'k', 'e', 'y', '_', 'f', 'o', 'o',
+    0x12, 0x09, 'n', 'e', 'w', '_', 'v', 'a', 'l', 'u', 'e',
+
+    0x1a, 0x10,
+    0x0a, 0x07, 'k', 'e', 'y', '_', 'f', 'o', 'o',
+    0x12, 0x05, 'f', 'o', 'o', '_', 'b',
+
+    0x12, 0x10,
+    0x0a, 0x07, 'k', 'e', 'y', '_', 'b', 'a', 'r',
+    0x12, 0x05, 'b', 'a', 'r', '_', 'a',
+  };
+  // clang-format on
+
+  stream::MemoryWriterBuffer<64> writer;
+  ASSERT_OK(UpdateMaps(2, "key_foo", "new_value", writer));
+  ASSERT_EQ(writer.bytes_written(), sizeof(kExpected));
+  EXPECT_EQ(std::memcmp(writer.data(), kExpected, sizeof(kExpected)), 0);
+}
+
+TEST(ProtoHelper, UpdateProtoStringToBytesMapEntryAppendsEntry) {
+  // clang-format off
+  constexpr uint8_t kEntry[] = {
+    // map_a["key_baz"] = "baz_a"
+    0x12, 0x10,
+    0x0a, 0x07, 'k', 'e', 'y', '_', 'b', 'a', 'z',
+    0x12, 0x05, 'b', 'a', 'z', '_', 'a',
+  };
+  // clang-format on
+
+  stream::MemoryWriterBuffer<80> writer;
+  ASSERT_OK(UpdateMaps(2, "key_baz", "baz_a", writer));
+  ASSERT_EQ(writer.bytes_written(), sizeof(kMaps) + sizeof(kEntry));
+  EXPECT_EQ(std::memcmp(writer.data(), kMaps, sizeof(kMaps)), 0);
+  EXPECT_EQ(
+      std::memcmp(writer.data() + sizeof(kMaps), kEntry, sizeof(kEntry)), 0);
+}
+
+TEST(ProtoHelper, UpdateProtoStringToBytesMapEntryKeyPrefix) {
+  // "key_fo" is a prefix of "key_foo", so no entry matches.
+  stream::MemoryWriterBuffer<80> writer;
+  ASSERT_OK(UpdateMaps(2, "key_fo", "x", writer));
+  ASSERT_GT(writer.bytes_written(), sizeof(kMaps));
+  EXPECT_EQ(std::memcmp(writer.data(), kMaps, sizeof(kMaps)), 0);
+}
+
+TEST(ProtoHelper, UpdateProtoStringToBytesMapEntryRemovesDuplicates) {
+  // clang-format off
+  constexpr uint8_t kMessage[] = {
+    0x0a, 0x08, 0x0a, 0x01, 'k', 0x12, 0x03, 'o', 'n', 'e',
+    0x0a, 0x08, 0x0a, 0x01, 'j', 0x12, 0x03, 't', 'w', 'o',
+    0x0a, 0x0a, 0x0a, 0x01, 'k', 0x12, 0x05, 't', 'h', 'r', 'e', 'e',
+  };
+  constexpr uint8_t kExpected[] = {
+    0x0a, 0x09, 0x0a, 0x01, 'k', 0x12, 0x04, 'f', 'o', 'u', 'r',
+    0x0a, 0x08, 0x0a, 0x01, 'j', 0x12, 0x03, 't', 'w', 'o',
+  };
+  // clang-format on
+
+  stream::MemoryReader message(as_bytes(span(kMessage)));
+  std::string_view value = "four";
+  stream::MemoryReader value_reader(as_bytes(span<const char>{value}));
+  std::byte stream_pipe_buffer[4];
+  stream::MemoryWriterBuffer<64> writer;
+  ASSERT_OK(UpdateProtoStringToBytesMapEntry(message,
+                                             1,
+                                             "k",
+                                             value_reader,
+                                             value.size(),
+                                             stream_pipe_buffer,
+                                             writer));
+  ASSERT_EQ(writer.bytes_written(), sizeof(kExpected));
+  EXPECT_EQ(std::memcmp(writer.data(), kExpected, sizeof(kExpected)), 0);
+}
+
+TEST(ProtoHelper, UpdateProtoStringToBytesMapEntryExceedsWriteLimit) {
+  // The new entry fits, but the rest of the message does not.
+  stream::MemoryWriterBuffer<sizeof(kMaps)> writer;
+  EXPECT_EQ(UpdateMaps(2, "key_foo", "longer_value", writer),
+            Status::OutOfRange());
+
+  // The new entry does not fit.
+  stream::MemoryWriterBuffer<8> small_writer;
+  EXPECT_EQ(UpdateMaps(2, "key_foo", "longer_value", small_writer),
+            Status::ResourceExhausted());
+}
+
+TEST(ProtoHelper, UpdateProtoStringToBytesMapEntryTruncatedMessage) {
+  stream::MemoryReader message(as_bytes(span(kMaps).first(sizeof(kMaps) - 1)));
+  stream::MemoryReader value_reader(ConstByteSpan{});
+  std::byte stream_pipe_buffer[8];
+  stream::MemoryWriterBuffer<64> writer;
+  EXPECT_EQ(UpdateProtoStringToBytesMapEntry(message,
+                                             2,
+                                             "key_foo",
+                                             value_reader,
+                                             0,
+                                             stream_pipe_buffer,
+                                             writer),
+            Status::DataLoss());
+}
+
 }  // namespace pw::protobuf
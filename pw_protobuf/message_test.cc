@@ -769,4 +769,100 @@ TEST(ProtoHelper, AsStringToBytesMapMalformed) {
   ASSERT_EQ(count, 2ULL);
 }
 
+TEST(ProtoHelper, MessageView) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=uint32, k=1, v=1
+    0x08, 0x01,
+    // type=string, k=2, v="foo"
+    0x12, 0x03, 'f', 'o', 'o',
+    // type=message, k=3, v={type=uint32, k=1, v=3}
+    0x1a, 0x02, 0x08, 0x03,
+    // type=uint32, k=1, v=4 (repeated field number)
+    0x08, 0x04,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(encoded_proto)));
+  MessageView<4> view(Message(reader, sizeof(encoded_proto)));
+  ASSERT_TRUE(view.ok());
+
+  // Access fields out of order and more than once.
+  for (int i = 0; i < 2; ++i) {
+    Message nested = view.AsMessage(3);
+    ASSERT_OK(nested.status());
+    Uint32 nested_value = nested.AsUint32(1);
+    ASSERT_OK(nested_value.status());
+    EXPECT_EQ(nested_value.value(), 3u);
+
+    String str = view.AsString(2);
+    ASSERT_OK(str.status());
+    Result<bool> cmp = str.Equal("foo");
+    ASSERT_OK(cmp.status());
+    EXPECT_TRUE(cmp.value());
+
+    // Like Message::As(), the first occurrence of a field is returned.
+    Uint32 value = view.AsUint32(1);
+    ASSERT_OK(value.status());
+    EXPECT_EQ(value.value(), 1u);
+
+    EXPECT_EQ(view.AsUint32(4).status(), Status::NotFound());
+  }
+
+  EXPECT_EQ(view.indexed_fields(), 3u);
+}
+
+TEST(ProtoHelper, MessageViewMoreFieldsThanIndex) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=uint32, k=1, v=1
+    0x08, 0x01,
+    // type=uint32, k=2, v=2
+    0x10, 0x02,
+    // type=uint32, k=3, v=3
+    0x18, 0x03,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(encoded_proto)));
+  MessageView<2> view(Message(reader, sizeof(encoded_proto)));
+
+  // Fields beyond the index capacity are found by parsing the message.
+  for (uint32_t field_number : {3u, 1u, 2u}) {
+    Uint32 value = view.AsUint32(field_number);
+    ASSERT_OK(value.status());
+    EXPECT_EQ(value.value(), field_number);
+  }
+
+  EXPECT_EQ(view.AsUint32(4).status(), Status::NotFound());
+  EXPECT_EQ(view.indexed_fields(), 2u);
+}
+
+TEST(ProtoHelper, MessageViewMalformedProto) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=uint32, k=1, v=1
+    0x08, 0x01,
+    // type=string, k=2, length exceeds the message
+    0x12, 0x10, 'f', 'o', 'o',
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(encoded_proto)));
+  MessageView<4> view(Message(reader, sizeof(encoded_proto)));
+
+  Uint32 value = view.AsUint32(1);
+  ASSERT_OK(value.status());
+  EXPECT_EQ(value.value(), 1u);
+  EXPECT_EQ(view.indexed_fields(), 1u);
+  EXPECT_FALSE(view.AsString(2).ok());
+}
+
+TEST(ProtoHelper, MessageViewInvalidMessage) {
+  MessageView<> view(Status::DataLoss());
+  EXPECT_FALSE(view.ok());
+  EXPECT_FALSE(view.AsUint32(1).ok());
+  EXPECT_EQ(view.indexed_fields(), 0u);
+}
+
 }  // namespace pw::protobuf
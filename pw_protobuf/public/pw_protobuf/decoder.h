@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 #include "pw_protobuf/wire_format.h"
@@ -42,6 +44,17 @@
 //
 namespace pw::protobuf {
 
+class Decoder;
+
+namespace internal {
+
+// Backend for FindFields() in find.h.
+Status FindFields(Decoder& decoder,
+                  span<const uint32_t> field_numbers,
+                  span<span<const std::byte>> fields);
+
+}  // namespace internal
+
 // TODO(frolv): Rename this to MemoryDecoder to match the encoder naming.
 class Decoder {
  public:
@@ -169,6 +182,10 @@ class Decoder {
 
   Status ReadDelimited(span<const std::byte>* out);
 
+  friend Status internal::FindFields(Decoder& decoder,
+                                     span<const uint32_t> field_numbers,
+                                     span<span<const std::byte>> fields);
+
   span<const std::byte> proto_;
   bool previous_field_consumed_;
 };
@@ -29,6 +29,7 @@
 #include "pw_protobuf/wire_format.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 #include "pw_status/try.h"
 #include "pw_stream/memory_stream.h"
 #include "pw_stream/stream.h"
@@ -115,14 +116,46 @@ class StreamEncoder {
   // must exist for the lifetime of the StreamEncoder object.
   //
   // StreamEncoder objects that do not write nested proto messages can
-  // provide a zero-length scratch buffer.
+  // provide a zero-length scratch buffer. This includes nested messages
+  // written from a message structure by the codegen Write() method, unless
+  // they contain callbacks.
   constexpr StreamEncoder(stream::Writer& writer, ByteSpan scratch_buffer)
       : status_(OkStatus()),
         write_when_empty_(true),
         parent_(nullptr),
         nested_field_number_(0),
         memory_writer_(scratch_buffer),
-        writer_(writer) {}
+        writer_(writer),
+        seekable_writer_(nullptr),
+        length_prefix_offset_(0) {}
+
+  // Creates a StreamEncoder that writes nested messages straight to a seekable
+  // writer instead of staging them in a scratch buffer, so messages of any size
+  // can be encoded with a constant amount of RAM.
+  //
+  // Each nested encoder reserves a length prefix of config::kMaxVarintSize
+  // bytes when it is opened. When it is closed, the encoder seeks back and
+  // overwrites the prefix with the nested message's size, padded to the
+  // reserved width, and then seeks back to the end. Padded varints are valid
+  // protobuf encodings, but the output is larger than the canonical encoding
+  // by up to config::kMaxVarintSize - 1 bytes per nested message.
+  //
+  // If a nested encoder created with EmptyEncoderBehavior::kWriteNothing is
+  // closed without writing anything, the writer is rewound to before its key.
+  // Bytes past the writer's final position should not be treated as part of
+  // the message.
+  //
+  // The writer must support Tell(). If it does not, nested encoders fail with
+  // UNIMPLEMENTED.
+  constexpr explicit StreamEncoder(stream::SeekableWriter& writer)
+      : status_(OkStatus()),
+        write_when_empty_(true),
+        parent_(nullptr),
+        nested_field_number_(0),
+        memory_writer_(ByteSpan()),
+        writer_(writer),
+        seekable_writer_(&writer),
+        length_prefix_offset_(0) {}
 
   // Precondition: Encoder has no active child encoder.
   //
@@ -630,7 +663,9 @@ class StreamEncoder {
         nested_field_number_(other.nested_field_number_),
         memory_writer_(std::move(other.memory_writer_)),
         writer_(&other.writer_ == &other.memory_writer_ ? memory_writer_
-                                                        : other.writer_) {
+                                                        : other.writer_),
+        seekable_writer_(other.seekable_writer_),
+        length_prefix_offset_(other.length_prefix_offset_) {
     PW_ASSERT(nested_field_number_ == 0);
     // Make the nested encoder look like it has an open child to block writes
     // for the remainder of the object's life.
@@ -644,9 +679,29 @@ class StreamEncoder {
   // This is called by codegen subclass Write() functions that accept a typed
   // struct Message reference, using the appropriate codegen MessageField table
   // corresponding to that type.
+  //
+  // Nested messages whose tables contain no callbacks, at any depth, are sized
+  // with EncodedSize() and written straight to the stream, so they do not use
+  // the scratch buffer. Nested messages that contain callbacks are staged in
+  // the scratch buffer as usual, since sizing them would require running the
+  // callbacks twice.
   Status Write(span<const std::byte> message,
                span<const internal::MessageField> table);
 
+  // Returns the number of bytes that Write() would produce for the structure
+  // contained within message, according to the description of fields in table.
+  //
+  // This is called by codegen subclass EncodedSize() functions.
+  //
+  // Returns:
+  //   OK - The size of the encoded message.
+  //   UNIMPLEMENTED - The table or a nested table uses callbacks, so the size
+  //     cannot be calculated without running them.
+  //   Other errors encountered while encoding the message, such as invalid
+  //   field numbers.
+  static StatusWithSize EncodedSize(span<const std::byte> message,
+                                    span<const internal::MessageField> table);
+
   // Protected method to create a nested encoder, specifying whether the field
   // should be written when no fields were added to the nested encoder. Exposed
   // using an enum in the public API, for better readability.
@@ -664,7 +719,24 @@ class StreamEncoder {
         parent_(&parent),
         nested_field_number_(0),
         memory_writer_(scratch_buffer),
-        writer_(memory_writer_) {}
+        writer_(memory_writer_),
+        seekable_writer_(nullptr),
+        length_prefix_offset_(0) {}
+
+  // Creates a nested encoder that writes directly to the parent's seekable
+  // writer, after a length prefix reserved at length_prefix_offset.
+  constexpr StreamEncoder(StreamEncoder& parent,
+                          Status status,
+                          size_t length_prefix_offset,
+                          bool write_when_empty)
+      : status_(status),
+        write_when_empty_(write_when_empty),
+        parent_(&parent),
+        nested_field_number_(0),
+        memory_writer_(ByteSpan()),
+        writer_(parent.writer_),
+        seekable_writer_(parent.seekable_writer_),
+        length_prefix_offset_(length_prefix_offset) {}
 
   bool nested_encoder_open() const { return nested_field_number_ != 0; }
 
@@ -672,6 +744,16 @@ class StreamEncoder {
   // encoder destructor.
   void CloseNestedMessage(StreamEncoder& nested);
 
+  // Writes the key and a placeholder length prefix for a nested message,
+  // then returns a nested encoder that writes to the seekable writer.
+  StreamEncoder GetSeekableNestedEncoder(uint32_t field_number,
+                                         bool write_when_empty);
+
+  // Overwrites the placeholder length prefix of a closed nested encoder that
+  // wrote to the seekable writer.
+  Status BackPatchLengthPrefix(uint32_t field_number,
+                               const StreamEncoder& nested);
+
   // Implementation for encoding all varint field types.
   Status WriteVarintField(uint32_t field_number, uint64_t value);
 
@@ -687,6 +769,10 @@ class StreamEncoder {
   // Implementation for encoding all fixed-length integer types.
   Status WriteFixed(uint32_t field_number, ConstByteSpan data);
 
+  // Writes a struct member whose values are stored in an arena.
+  Status WriteArenaField(const internal::MessageField& field,
+                         span<const std::byte> values);
+
   // Encodes a base-128 varint to the buffer. This function assumes the caller
   // has already checked UpdateStatusForWrite() to ensure the writer's
   // conservative write limit indicates the Writer has sufficient buffer space.
@@ -805,6 +891,14 @@ class StreamEncoder {
 
   // All proto encode operations are directly written to this writer.
   stream::Writer& writer_;
+
+  // Set if writer_ is a seekable writer that nested messages are written to
+  // directly, with back-patched length prefixes.
+  stream::SeekableWriter* seekable_writer_;
+
+  // For nested encoders that write to a seekable writer, the offset of the
+  // reserved length prefix.
+  size_t length_prefix_offset_;
 };
 
 // A protobuf encoder that writes directly to a provided buffer.
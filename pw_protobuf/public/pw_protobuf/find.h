@@ -21,8 +21,8 @@
 /// functions which handle this for you.
 ///
 /// @note Each call to ``Find*()`` linearly scans through the message. If you
-/// have to read multiple fields, it is more efficient to instantiate your own
-/// decoder as described above.
+/// have to read multiple fields, use ``FindFields()`` to locate all of them in
+/// a single pass, or instantiate your own decoder as described above.
 ///
 /// @code{.cpp}
 ///
@@ -745,4 +745,72 @@ inline Result<ConstByteSpan> FindSubmessage(ConstByteSpan message, T field) {
   return FindSubmessage(message, static_cast<uint32_t>(field));
 }
 
+/// @brief Scans a serialized protobuf message once for several fields.
+///
+/// Scanning stops as soon as every requested field has been found. Like the
+/// other `Find*()` functions, the first occurrence of each field is used.
+///
+/// Each entry of `fields` is set to the serialized field, key included, for
+/// the corresponding entry of `field_numbers`, or to an empty span if the field
+/// was not found. Pass an entry to the typed `Find*()` functions to read its
+/// value; since it holds only the one field, this does not rescan the message.
+///
+/// @code{.cpp}
+///   std::array<pw::ConstByteSpan, 2> fields;
+///   PW_TRY(pw::protobuf::FindFields(
+///       packet, {{kAddressField, kPayloadField}}, fields));
+///   PW_TRY_ASSIGN(uint32_t address,
+///                 pw::protobuf::FindUint32(fields[0], kAddressField));
+///   PW_TRY_ASSIGN(pw::ConstByteSpan payload,
+///                 pw::protobuf::FindBytes(fields[1], kPayloadField));
+/// @endcode
+///
+/// @param message The serialized message to search.
+/// @param field_numbers Protobuf field numbers of the fields.
+/// @param fields Receives the serialized fields. Must be the same size as
+///     `field_numbers`.
+///
+/// @returns
+/// * `OK` - All of the fields were found.
+/// * `NOT_FOUND` - Some of the fields are not present. The fields that were
+///   found are still set.
+/// * `DATA_LOSS` - The serialized message not a valid protobuf.
+/// * `INVALID_ARGUMENT` - A field number is invalid, or `fields` is not the
+///   same size as `field_numbers`.
+inline Status FindFields(ConstByteSpan message,
+                         span<const uint32_t> field_numbers,
+                         span<ConstByteSpan> fields) {
+  Decoder decoder(message);
+  return internal::FindFields(decoder, field_numbers, fields);
+}
+
+/// @brief Scans a serialized protobuf message once for several fields,
+/// copying them into the provided buffer.
+///
+/// This works like `FindFields()` for a `ConstByteSpan` message, except that
+/// the serialized fields are copied into `buffer`, and `fields` refers to
+/// them there.
+///
+/// @param message_stream The serialized message to search.
+/// @param field_numbers Protobuf field numbers of the fields.
+/// @param buffer Holds the serialized fields that are found.
+/// @param fields Receives the serialized fields. Must be the same size as
+///     `field_numbers`.
+///
+/// @returns
+/// * `OK` - All of the fields were found.
+/// * `NOT_FOUND` - Some of the fields are not present. The fields that were
+///   found are still set.
+/// * `DATA_LOSS` - The serialized message not a valid protobuf.
+/// * `RESOURCE_EXHAUSTED` - The fields do not fit in `buffer`.
+/// * `INVALID_ARGUMENT` - A field number is invalid, or `fields` is not the
+///   same size as `field_numbers`.
+inline Status FindFields(stream::Reader& message_stream,
+                         span<const uint32_t> field_numbers,
+                         ByteSpan buffer,
+                         span<ConstByteSpan> fields) {
+  StreamDecoder decoder(message_stream);
+  return internal::FindFields(decoder, field_numbers, buffer, fields);
+}
+
 }  // namespace pw::protobuf
@@ -59,6 +59,11 @@ enum class VarintType {
 // parent to a pointer to the (global data) span. Since the size of the nested
 // message is stored as part of the global span, the cost of a nested message
 // is only the size of a pointer to that span.
+//
+// Repeated scalar fields and bytes fields with use_arena set are pw::span
+// members, and string fields with it set are std::string_view members. They
+// refer to the values rather than holding them, and the decoder allocates the
+// storage for them from an allocator::Arena.
 class MessageField {
  public:
   static constexpr unsigned int kMaxFieldSize = (1u << 16) - 1;
@@ -72,6 +77,7 @@ class MessageField {
                          bool is_repeated,
                          bool is_optional,
                          bool use_callback,
+                         bool use_arena,
                          size_t field_offset,
                          size_t field_size,
                          const span<const MessageField>* nested_message_fields)
@@ -84,6 +90,7 @@ class MessageField {
                     static_cast<uint32_t>(is_repeated) << kIsRepeatedShift |
                     static_cast<uint32_t>(is_optional) << kIsOptionalShift |
                     static_cast<uint32_t>(use_callback) << kUseCallbackShift |
+                    static_cast<uint32_t>(use_arena) << kUseArenaShift |
                     static_cast<uint32_t>(field_size) << kFieldSizeShift),
         field_offset_(field_offset),
         nested_message_fields_(nested_message_fields) {}
@@ -115,6 +122,9 @@ class MessageField {
   constexpr bool use_callback() const {
     return (field_info_ >> kUseCallbackShift) & 1;
   }
+  constexpr bool use_arena() const {
+    return (field_info_ >> kUseArenaShift) & 1;
+  }
   constexpr size_t field_offset() const { return field_offset_; }
   constexpr size_t field_size() const {
     return (field_info_ >> kFieldSizeShift) & kFieldSizeMask;
@@ -139,7 +149,8 @@ class MessageField {
   //   -
   //   elem_size      : 4
   //   is_optional    : 1
-  //   [unused space] : 2
+  //   use_arena      : 1
+  //   [unused space] : 1
   //   -
   //   field_size     : 16
   //
@@ -159,6 +170,7 @@ class MessageField {
   static constexpr unsigned int kElemSizeShift = 19u;
   static constexpr unsigned int kElemSizeMask = (1u << 4) - 1;
   static constexpr unsigned int kIsOptionalShift = 16u;
+  static constexpr unsigned int kUseArenaShift = 17u;
   static constexpr unsigned int kFieldSizeShift = 0u;
   static constexpr unsigned int kFieldSizeMask = kMaxFieldSize;
 
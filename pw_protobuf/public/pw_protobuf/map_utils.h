@@ -56,4 +56,43 @@ Status WriteProtoStringToBytesMapEntry(uint32_t field_number,
                                        ByteSpan stream_pipe_buffer,
                                        stream::Writer& writer);
 
+// The function copies the serialized message read from `message` to `writer`,
+// setting the entry with the given key in the map<string, bytes> field
+// `field_number` to the value read from `value`.
+//
+// All other fields and map entries are copied verbatim, so the message is
+// updated in a single pass using only `stream_pipe_buffer`, without decoding
+// or re-encoding it. Existing entries with the key are replaced by one new
+// entry at the position of the first of them. If there are none, the entry is
+// appended to the end of the message.
+//
+// Map entries are matched by their first field, which all encoders write as
+// the key. `message` is read until it returns OUT_OF_RANGE.
+//
+// Args:
+//   message - The serialized message to update.
+//   field_number - The field number for the map.
+//   key - The key of the entry to update.
+//   value - The value payload for the entry.
+//   value_size - Number of bytes in the value.
+//   stream_pipe_buffer - A non-zero size buffer for the function to read and
+//     store data from the readers and write to the given writer.
+//   writer - The output writer to write to.
+//
+// Returns:
+// OK - The updated message is successfully written.
+// RESOURCE_EXHAUSTED - The new entry would exceed the write limit.
+// INVALID_ARGUMENT - Field number is invalid.
+// DATA_LOSS - `message` is not a valid serialized message.
+//
+// Other errors are returned from reading `message` or writing to `writer`. A
+// MemoryWriter returns OUT_OF_RANGE once it is full.
+Status UpdateProtoStringToBytesMapEntry(stream::Reader& message,
+                                        uint32_t field_number,
+                                        std::string_view key,
+                                        stream::Reader& value,
+                                        size_t value_size,
+                                        ByteSpan stream_pipe_buffer,
+                                        stream::Writer& writer);
+
 }  // namespace pw::protobuf
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <string_view>
 
@@ -145,6 +146,8 @@ class StringMapEntryParser;
 template <typename FieldType>
 class StringMapParser;
 class Message;
+template <size_t kMaxFields>
+class MessageView;
 
 using RepeatedBytes = RepeatedFieldParser<Bytes>;
 using RepeatedStrings = RepeatedFieldParser<String>;
@@ -289,6 +292,8 @@ class Message {
     uint32_t field_number_;
 
     friend class Message;
+    template <size_t>
+    friend class MessageView;
   };
 
   class iterator {
@@ -616,4 +621,135 @@ class StringMapParser
   }
 };
 
+// A wrapper around `Message` that remembers where its fields are.
+//
+// The first `AsXXX()` call traverses the message once and records the
+// location of the first occurrence of up to `kMaxFields` distinct field
+// numbers. Later lookups of those fields search only this small index instead
+// of re-parsing the message from the start, which makes repeated accesses to
+// the same message cheap on slow readers.
+//
+// If the message contains more than `kMaxFields` distinct field numbers, or is
+// malformed partway through, lookups of fields that were not indexed fall back
+// to `Message::As()`, so results are always the same as with `Message`.
+//
+// Repeated and map fields have multiple entries and should be parsed with the
+// `Message` returned by `message()`.
+//
+//   MessageView<4> view(message);
+//   Uint32 version = view.AsUint32(1);  // Indexes the message.
+//   String name = view.AsString(2);     // Does not re-parse the message.
+template <size_t kMaxFields = 8>
+class MessageView {
+ public:
+  static_assert(kMaxFields > 0, "A MessageView must index at least one field");
+
+  MessageView() = default;
+  MessageView(Status status) : message_(status) {}
+  MessageView(Message message) : message_(message) {}
+
+  Message& message() { return message_; }
+
+  bool ok() { return message_.ok(); }
+  Status status() { return message_.status(); }
+
+  Bytes AsBytes(uint32_t field_number) { return As<Bytes>(field_number); }
+  String AsString(uint32_t field_number) { return As<String>(field_number); }
+  Int32 AsInt32(uint32_t field_number) { return As<Int32>(field_number); }
+  Sint32 AsSint32(uint32_t field_number) { return As<Sint32>(field_number); }
+  Uint32 AsUint32(uint32_t field_number) { return As<Uint32>(field_number); }
+  Fixed32 AsFixed32(uint32_t field_number) { return As<Fixed32>(field_number); }
+  Int64 AsInt64(uint32_t field_number) { return As<Int64>(field_number); }
+  Sint64 AsSint64(uint32_t field_number) { return As<Sint64>(field_number); }
+  Uint64 AsUint64(uint32_t field_number) { return As<Uint64>(field_number); }
+  Fixed64 AsFixed64(uint32_t field_number) { return As<Fixed64>(field_number); }
+
+  Sfixed32 AsSfixed32(uint32_t field_number) {
+    return As<Sfixed32>(field_number);
+  }
+
+  Sfixed64 AsSfixed64(uint32_t field_number) {
+    return As<Sfixed64>(field_number);
+  }
+
+  Float AsFloat(uint32_t field_number) { return As<Float>(field_number); }
+  Double AsDouble(uint32_t field_number) { return As<Double>(field_number); }
+  Bool AsBool(uint32_t field_number) { return As<Bool>(field_number); }
+  Message AsMessage(uint32_t field_number) { return As<Message>(field_number); }
+
+  // Parse the first field given by `field_number` as the target parser type
+  // `FieldType`, using the field index.
+  template <typename FieldType>
+  FieldType As(uint32_t field_number) {
+    if (!indexed_) {
+      Index();
+    }
+
+    for (size_t i = 0; i < num_fields_; ++i) {
+      if (fields_[i].field_number == field_number) {
+        return Message::Field(fields_[i].reader, field_number)
+            .template As<FieldType>();
+      }
+    }
+
+    if (complete_) {
+      return FieldType(Status::NotFound());
+    }
+    return message_.As<FieldType>(field_number);
+  }
+
+  // Returns the number of fields in the index, building it if necessary.
+  size_t indexed_fields() {
+    if (!indexed_) {
+      Index();
+    }
+    return num_fields_;
+  }
+
+ private:
+  struct IndexedField {
+    stream::IntervalReader reader;
+    uint32_t field_number = 0;
+  };
+
+  // Traverses the message and records the first occurrence of each field
+  // number. `complete_` is set if every field in the message was considered.
+  void Index() {
+    indexed_ = true;
+    if (!message_.ok()) {
+      return;
+    }
+
+    for (Message::Field field : message_) {
+      if (!field.ok()) {
+        return;
+      }
+      if (IsIndexed(field.field_number())) {
+        continue;
+      }
+      if (num_fields_ == kMaxFields) {
+        return;
+      }
+      fields_[num_fields_++] = {field.field_reader(), field.field_number()};
+    }
+
+    complete_ = true;
+  }
+
+  bool IsIndexed(uint32_t field_number) const {
+    for (size_t i = 0; i < num_fields_; ++i) {
+      if (fields_[i].field_number == field_number) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Message message_;
+  std::array<IndexedField, kMaxFields> fields_{};
+  size_t num_fields_ = 0;
+  bool indexed_ = false;
+  bool complete_ = false;
+};
+
 }  // namespace pw::protobuf
@@ -18,6 +18,7 @@
 #include <limits>
 #include <type_traits>
 
+#include "pw_allocator/arena.h"
 #include "pw_assert/assert.h"
 #include "pw_containers/vector.h"
 #include "pw_protobuf/internal/codegen.h"
@@ -31,6 +32,18 @@
 
 namespace pw::protobuf {
 
+class StreamDecoder;
+
+namespace internal {
+
+// Backend for FindFields() in find.h.
+Status FindFields(StreamDecoder& decoder,
+                  span<const uint32_t> field_numbers,
+                  span<std::byte> buffer,
+                  span<span<const std::byte>> fields);
+
+}  // namespace internal
+
 // A low-level, event-based protobuf wire format decoder that operates on a
 // stream.
 //
@@ -535,7 +548,20 @@ class StreamDecoder {
   // struct Message reference, using the appropriate codegen MessageField table
   // corresponding to that type.
   Status Read(span<std::byte> message,
-              span<const internal::MessageField> table);
+              span<const internal::MessageField> table) {
+    return Read(message, table, nullptr);
+  }
+
+  // Reads proto values into the structure contained within message, as above.
+  // Storage for fields with the use_arena codegen option is allocated from
+  // arena. Those fields are set to refer to the allocated values, which
+  // remain valid until the arena is rewound or reset.
+  //
+  // Returns FAILED_PRECONDITION if a field uses an arena but arena is null, and
+  // RESOURCE_EXHAUSTED if the arena runs out of space.
+  Status Read(span<std::byte> message,
+              span<const internal::MessageField> table,
+              allocator::Arena* arena);
 
  private:
   friend class BytesReader;
@@ -708,6 +734,19 @@ class StreamDecoder {
     return sws.status();
   }
 
+  // Decodes a field with the use_arena codegen option into storage allocated
+  // from arena, and points the struct member at it.
+  Status ReadArenaField(span<std::byte> out,
+                        const internal::MessageField& field,
+                        allocator::Arena& arena);
+
+  // Appends the values of the current field, packed or not, to a repeated
+  // field stored in arena.
+  template <typename T>
+  Status ReadArenaRepeatedField(span<const T>& values,
+                                const internal::MessageField& field,
+                                allocator::Arena& arena);
+
   Status CheckOkToRead(WireType type);
 
   stream::Reader& reader_;
@@ -726,6 +765,10 @@ class StreamDecoder {
   Status status_;
 
   friend class Message;
+  friend Status internal::FindFields(StreamDecoder& decoder,
+                                     span<const uint32_t> field_numbers,
+                                     span<std::byte> buffer,
+                                     span<span<const std::byte>> fields);
 };
 
 }  // namespace pw::protobuf
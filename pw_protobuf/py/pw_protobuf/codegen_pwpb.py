@@ -424,12 +424,33 @@ class MessageProperty(ProtoMember):
         """
         return f'::pw::Vector<{type_name}, {max_size}>'
 
+    @staticmethod
+    def arena_field_container(type_name: str) -> str:
+        """Returns the type used for fields stored in an arena.
+
+        Defaults to ::pw::span<const type>. String fields use
+        std::basic_string_view<type> instead.
+        """
+        return f'::pw::span<const {type_name}>'
+
     def use_callback(self) -> bool:  # pylint: disable=no-self-use
         """Returns whether the decoder should use a callback."""
         options = self._field.options()
         assert options is not None
         return options.use_callback or (
-            self._field.is_repeated() and self.max_size() == 0
+            self._field.is_repeated()
+            and self.max_size() == 0
+            and not self.use_arena()
+        )
+
+    def use_arena(self) -> bool:
+        """Returns whether the field's storage is allocated from an arena."""
+        options = self._field.options()
+        assert options is not None
+        return (
+            self._field.is_repeated()
+            and options.use_arena
+            and not options.use_callback
         )
 
     def is_optional(self) -> bool:
@@ -457,7 +478,7 @@ class MessageProperty(ProtoMember):
         if self._field.is_repeated():
             options = self._field.options()
             assert options is not None
-            return options.fixed_count
+            return options.fixed_count and not self.use_arena()
 
         return False
 
@@ -473,6 +494,13 @@ class MessageProperty(ProtoMember):
                 self.name(),
             )
 
+        # Fields stored in an arena refer to their values with a span.
+        if self.use_arena():
+            return (
+                self.arena_field_container(self.type_name(from_root)),
+                self.name(),
+            )
+
         # Optional fields are wrapped in std::optional
         if self.is_optional():
             return (
@@ -530,6 +558,7 @@ class MessageProperty(ProtoMember):
             self._bool_attr('is_repeated'),
             self._bool_attr('is_optional'),
             self._bool_attr('use_callback'),
+            self._bool_attr('use_arena'),
             'offsetof(Message, {})'.format(self.name()),
             'sizeof(Message::{})'.format(self.name()),
             self.sub_table(),
@@ -660,6 +689,10 @@ class SubMessageProperty(MessageProperty):
             or self._field.is_repeated()
         )
 
+    def use_arena(self) -> bool:  # pylint: disable=no-self-use
+        # Nested messages are embedded in the parent structure.
+        return False
+
     def wire_type(self) -> str:
         return 'kDelimited'
 
@@ -1991,7 +2024,12 @@ class BytesProperty(MessageProperty):
         return 'std::byte'
 
     def use_callback(self) -> bool:
-        return self.max_size() == 0
+        return self.max_size() == 0 and not self.use_arena()
+
+    def use_arena(self) -> bool:
+        options = self._field.options()
+        assert options is not None
+        return not self._field.is_repeated() and options.use_arena
 
     def max_size(self) -> int:
         if not self._field.is_repeated():
@@ -2005,7 +2043,7 @@ class BytesProperty(MessageProperty):
         if not self._field.is_repeated():
             options = self._field.options()
             assert options is not None
-            return options.fixed_size
+            return options.fixed_size and not self.use_arena()
 
         return False
 
@@ -2019,7 +2057,7 @@ class BytesProperty(MessageProperty):
         return 'SizeOfDelimitedFieldWithoutValue'
 
     def _size_length(self) -> Optional[str]:
-        if self.use_callback():
+        if self.use_callback() or self.max_size() == 0:
             return None
         return f'{self.max_size()}'
 
@@ -2122,7 +2160,12 @@ class StringProperty(MessageProperty):
         return 'char'
 
     def use_callback(self) -> bool:
-        return self.max_size() == 0
+        return self.max_size() == 0 and not self.use_arena()
+
+    def use_arena(self) -> bool:
+        options = self._field.options()
+        assert options is not None
+        return not self._field.is_repeated() and options.use_arena
 
     def max_size(self) -> int:
         if not self._field.is_repeated():
@@ -2145,6 +2188,10 @@ class StringProperty(MessageProperty):
     def repeated_field_container(type_name: str, max_size: int) -> str:
         return f'::pw::InlineBasicString<{type_name}, {max_size}>'
 
+    @staticmethod
+    def arena_field_container(type_name: str) -> str:
+        return f'std::basic_string_view<{type_name}>'
+
     def _size_fn(self) -> str:
         # This uses the WithoutValue method to ensure that the maximum length
         # of the delimited field size varint is used. This accounts for scratch
@@ -2152,7 +2199,7 @@ class StringProperty(MessageProperty):
         return 'SizeOfDelimitedFieldWithoutValue'
 
     def _size_length(self) -> Optional[str]:
-        if self.use_callback():
+        if self.use_callback() or self.max_size() == 0:
             return None
         return f'{self.max_size()}'
 
@@ -2658,6 +2705,19 @@ def generate_class_for_message(
                     'kMessageFields);'
                 )
             output.write_line('}')
+
+            output.write_line()
+            output.write_line(
+                '::pw::Status Read(Message& message, '
+                '::pw::allocator::Arena& arena) {'
+            )
+            with output.indent():
+                output.write_line(
+                    f'return {base_class}::Read('
+                    'pw::as_writable_bytes(pw::span(&message, 1)), '
+                    'kMessageFields, &arena);'
+                )
+            output.write_line('}')
         elif class_type in (
             ClassType.STREAMING_ENCODER,
             ClassType.MEMORY_ENCODER,
@@ -2671,6 +2731,18 @@ def generate_class_for_message(
                 )
             output.write_line('}')
 
+            output.write_line()
+            output.write_line(
+                'static ::pw::StatusWithSize EncodedSize('
+                'const Message& message) {'
+            )
+            with output.indent():
+                output.write_line(
+                    f'return {base_class}::EncodedSize('
+                    'pw::as_bytes(pw::span(&message, 1)), kMessageFields);'
+                )
+            output.write_line('}')
+
         # Generate methods for each of the message's fields.
         for field in message.fields():
             for method_class in proto_field_methods(class_type, field.type()):
@@ -2907,7 +2979,13 @@ def generate_struct_for_message(
                 (type_name, name) = prop.struct_member()
                 output.write_line(f'{type_name} {name};')
 
-                if not prop.use_callback():
+                if prop.use_arena():
+                    # Fields stored in an arena compare their contents.
+                    cmp.append(
+                        f'std::equal({name}.begin(), {name}.end(), '
+                        f'other.{name}.begin(), other.{name}.end())'
+                    )
+                elif not prop.use_callback():
                     cmp.append(f'{name} == other.{name}')
 
         # Equality operator
@@ -3181,6 +3259,7 @@ def generate_code_for_package(
     output.write_line('#include <cstdint>')
     output.write_line('#include <optional>')
     output.write_line('#include <string_view>\n')
+    output.write_line('#include "pw_allocator/arena.h"')
     output.write_line('#include "pw_assert/assert.h"')
     output.write_line('#include "pw_containers/vector.h"')
     output.write_line('#include "pw_preprocessor/compiler.h"')
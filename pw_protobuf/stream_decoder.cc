@@ -15,11 +15,14 @@
 #include "pw_protobuf/stream_decoder.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstring>
 #include <limits>
 #include <optional>
+#include <string_view>
 
+#include "pw_allocator/arena.h"
 #include "pw_assert/assert.h"
 #include "pw_assert/check.h"
 #include "pw_bytes/bit.h"
@@ -40,6 +43,116 @@ namespace pw::protobuf {
 
 using internal::VarintType;
 
+namespace {
+
+// Packed varint fields are read from the stream in chunks of this size and
+// decoded from memory. This must fit the largest varint.
+constexpr size_t kPackedVarintChunkSizeBytes = 16;
+static_assert(kPackedVarintChunkSizeBytes >= varint::kMaxVarint64SizeBytes);
+
+// Stores a decoded varint value in a bool, 32-bit, or 64-bit integer.
+Status StoreVarint(span<std::byte> out,
+                   uint64_t value,
+                   VarintType decode_type) {
+  if (out.size() == sizeof(uint64_t)) {
+    if (decode_type == VarintType::kUnsigned) {
+      std::memcpy(out.data(), &value, out.size());
+    } else {
+      const int64_t signed_value = decode_type == VarintType::kZigZag
+                                       ? varint::ZigZagDecode(value)
+                                       : static_cast<int64_t>(value);
+      std::memcpy(out.data(), &signed_value, out.size());
+    }
+  } else if (out.size() == sizeof(uint32_t)) {
+    if (decode_type == VarintType::kUnsigned) {
+      if (value > std::numeric_limits<uint32_t>::max()) {
+        return Status::FailedPrecondition();
+      }
+      std::memcpy(out.data(), &value, out.size());
+    } else {
+      const int64_t signed_value = decode_type == VarintType::kZigZag
+                                       ? varint::ZigZagDecode(value)
+                                       : static_cast<int64_t>(value);
+      if (signed_value > std::numeric_limits<int32_t>::max() ||
+          signed_value < std::numeric_limits<int32_t>::min()) {
+        return Status::FailedPrecondition();
+      }
+      std::memcpy(out.data(), &signed_value, out.size());
+    }
+  } else if (out.size() == sizeof(bool)) {
+    PW_CHECK(decode_type == VarintType::kUnsigned,
+             "Protobuf bool can never be signed");
+    std::memcpy(out.data(), &value, out.size());
+  }
+  return OkStatus();
+}
+
+// Finds the entry for a field number in a message table.
+//
+// Tables for messages that number their fields 1 to N in declaration order are
+// indexed directly by field number. Otherwise, fields are usually encoded in
+// table order, so the entries after and at the previously found field,
+// indicated by hint, are checked before searching the whole table.
+const internal::MessageField* FindField(
+    span<const internal::MessageField> table,
+    uint32_t field_number,
+    size_t& hint) {
+  const size_t index = field_number - 1;
+  if (index < table.size() && table[index] == field_number) {
+    hint = index;
+    return &table[index];
+  }
+
+  if (hint + 1 < table.size() && table[hint + 1] == field_number) {
+    ++hint;
+    return &table[hint];
+  }
+  if (hint < table.size() && table[hint] == field_number) {
+    return &table[hint];
+  }
+
+  const auto field = std::find(table.begin(), table.end(), field_number);
+  if (field == table.end()) {
+    return nullptr;
+  }
+  hint = static_cast<size_t>(field - table.begin());
+  return &*field;
+}
+
+// Makes room for count more elements after the existing values of a repeated
+// field stored in an arena, and returns them. The existing values are extended
+// in place if they were the arena's last allocation, and otherwise copied to a
+// new array, which values is updated to point to. Returns an empty span if the
+// arena is out of space.
+template <typename T>
+span<T> GrowArenaArray(allocator::Arena& arena,
+                       span<const T>& values,
+                       size_t count) {
+  if (count > arena.remaining() / sizeof(T)) {
+    return span<T>();
+  }
+
+  // The values can only be resized in place if they were allocated by the
+  // arena, so they were not const when allocated.
+  T* data = const_cast<T*>(values.data());
+  if (!values.empty() &&
+      arena.Resize(data,
+                   values.size_bytes(),
+                   values.size_bytes() + count * sizeof(T))) {
+    return span<T>(data + values.size(), count);
+  }
+
+  const span<T> array = arena.NewArray<T>(values.size() + count);
+  if (array.empty()) {
+    return span<T>();
+  }
+  std::copy(values.begin(), values.end(), array.begin());
+  values = span<const T>(array.data(), values.size());
+  return array.subspan(values.size());
+}
+
+}  // namespace
+
 Status StreamDecoder::BytesReader::DoSeek(ptrdiff_t offset, Whence origin) {
   PW_TRY(status_);
   if (!decoder_.reader_.seekable()) {
@@ -340,35 +453,8 @@ StatusWithSize StreamDecoder::ReadOneVarint(span<std::byte> out,
 
   position_ += sws.size();
 
-  if (out.size() == sizeof(uint64_t)) {
-    if (decode_type == VarintType::kUnsigned) {
-      std::memcpy(out.data(), &value, out.size());
-    } else {
-      const int64_t signed_value = decode_type == VarintType::kZigZag
-                                       ? varint::ZigZagDecode(value)
-                                       : static_cast<int64_t>(value);
-      std::memcpy(out.data(), &signed_value, out.size());
-    }
-  } else if (out.size() == sizeof(uint32_t)) {
-    if (decode_type == VarintType::kUnsigned) {
-      if (value > std::numeric_limits<uint32_t>::max()) {
-        return StatusWithSize(Status::FailedPrecondition(), sws.size());
-      }
-      std::memcpy(out.data(), &value, out.size());
-    } else {
-      const int64_t signed_value = decode_type == VarintType::kZigZag
-                                       ? varint::ZigZagDecode(value)
-                                       : static_cast<int64_t>(value);
-      if (signed_value > std::numeric_limits<int32_t>::max() ||
-          signed_value < std::numeric_limits<int32_t>::min()) {
-        return StatusWithSize(Status::FailedPrecondition(), sws.size());
-      }
-      std::memcpy(out.data(), &signed_value, out.size());
-    }
-  } else if (out.size() == sizeof(bool)) {
-    PW_CHECK(decode_type == VarintType::kUnsigned,
-             "Protobuf bool can never be signed");
-    std::memcpy(out.data(), &value, out.size());
+  if (Status status = StoreVarint(out, value, decode_type); !status.ok()) {
+    return StatusWithSize(status, sws.size());
   }
 
   return sws;
@@ -481,20 +567,68 @@ StatusWithSize StreamDecoder::ReadPackedVarintField(span<std::byte> out,
     return StatusWithSize(status_, 0);
   }
 
+  // Rather than reading the varints one byte at a time from the stream, read
+  // the packed field in chunks and decode the varints from memory. Bytes of a
+  // varint split across chunks are carried over to the next chunk.
+  std::array<std::byte, kPackedVarintChunkSizeBytes> chunk;
+  size_t buffered = 0;
   size_t bytes_read = 0;
   size_t number_out = 0;
-  while (bytes_read < delimited_field_size_ && !out.empty()) {
-    const StatusWithSize sws = ReadOneVarint(out.first(elem_size), decode_type);
-    if (!sws.ok()) {
-      return StatusWithSize(sws.status(), number_out);
+  while (!out.empty()) {
+    const size_t read_size = std::min(chunk.size() - buffered,
+                                      delimited_field_size_ - bytes_read);
+    if (read_size > 0) {
+      const Result<ByteSpan> result =
+          reader_.Read(span(chunk).subspan(buffered, read_size));
+      if (!result.ok()) {
+        return StatusWithSize(result.status(), number_out);
+      }
+      if (result.value().empty()) {
+        status_ = Status::DataLoss();
+        return StatusWithSize(status_, number_out);
+      }
+      bytes_read += result.value().size();
+      position_ += result.value().size();
+      buffered += result.value().size();
     }
 
-    bytes_read += sws.size();
-    out = out.subspan(elem_size);
-    ++number_out;
+    if (buffered == 0) {
+      break;
+    }
+
+    // Each varint takes at least one byte, so a chunk holds at most
+    // kPackedVarintChunkSizeBytes of them.
+    std::array<uint64_t, kPackedVarintChunkSizeBytes> values;
+    size_t decoded_bytes = 0;
+    const size_t decoded = varint::DecodePacked(
+        span(chunk).first(buffered),
+        span(values).first(std::min(values.size(), out.size() / elem_size)),
+        &decoded_bytes);
+    for (size_t i = 0; i < decoded; ++i) {
+      if (Status status =
+              StoreVarint(out.first(elem_size), values[i], decode_type);
+          !status.ok()) {
+        return StatusWithSize(status, number_out);
+      }
+      out = out.subspan(elem_size);
+      ++number_out;
+    }
+    ConstByteSpan data =
+        span(chunk).subspan(decoded_bytes, buffered - decoded_bytes);
+
+    // A varint that doesn't decode from a full chunk, or that is cut off by
+    // the end of the field, is corrupt.
+    if (!out.empty() && !data.empty() &&
+        (data.size() == chunk.size() || bytes_read == delimited_field_size_)) {
+      status_ = Status::DataLoss();
+      return StatusWithSize(status_, number_out);
+    }
+
+    std::memmove(chunk.data(), data.data(), data.size());
+    buffered = data.size();
   }
 
-  if (bytes_read < delimited_field_size_) {
+  if (buffered > 0 || bytes_read < delimited_field_size_) {
     return StatusWithSize(Status::ResourceExhausted(), number_out);
   }
 
@@ -520,16 +654,112 @@ Status StreamDecoder::CheckOkToRead(WireType type) {
   return status_;
 }
 
+template <typename T>
+Status StreamDecoder::ReadArenaRepeatedField(
+    span<const T>& values,
+    const internal::MessageField& field,
+    allocator::Arena& arena) {
+  // Allocate room for as many values as the field could hold, and give back
+  // what isn't used once they are decoded. Each packed varint is at least one
+  // byte.
+  const bool packed = current_field_.wire_type() == WireType::kDelimited;
+  size_t max_count = 1;
+  if (packed) {
+    max_count = field.wire_type() == WireType::kVarint
+                    ? delimited_field_size_
+                    : delimited_field_size_ / sizeof(T);
+  }
+
+  span<T> new_values;
+  if (max_count > 0) {
+    new_values = GrowArenaArray(arena, values, max_count);
+    if (new_values.empty()) {
+      return Status::ResourceExhausted();
+    }
+  }
+
+  const ByteSpan out = as_writable_bytes(new_values);
+  StatusWithSize result;
+  if (field.wire_type() == WireType::kVarint) {
+    if (packed) {
+      result = ReadPackedVarintField(out, sizeof(T), field.varint_type());
+    } else {
+      const Status status = ReadVarintField(out, field.varint_type());
+      result = StatusWithSize(status, status.ok() ? 1 : 0);
+    }
+  } else {
+    if (packed) {
+      result = ReadPackedFixedField(out, sizeof(T));
+    } else {
+      const Status status = ReadFixedField(out);
+      result = StatusWithSize(status, status.ok() ? 1 : 0);
+    }
+  }
+
+  const size_t old_count = values.size();
+  if (max_count > 0) {
+    arena.Resize(const_cast<T*>(values.data()),
+                 (old_count + max_count) * sizeof(T),
+                 (old_count + result.size()) * sizeof(T));
+  }
+  values = span<const T>(values.data(), old_count + result.size());
+  return result.status();
+}
+
+Status StreamDecoder::ReadArenaField(span<std::byte> out,
+                                     const internal::MessageField& field,
+                                     allocator::Arena& arena) {
+  if (field.wire_type() != WireType::kDelimited) {
+    // Repeated scalar field. The struct member is a span of a type
+    // corresponding to the field element size. Cast to the correct span type
+    // so we're not performing type aliasing (except for unsigned vs signed
+    // which is explicitly allowed).
+    if (field.elem_size() == sizeof(uint64_t)) {
+      return ReadArenaRepeatedField(
+          *reinterpret_cast<span<const uint64_t>*>(out.data()), field, arena);
+    }
+    if (field.elem_size() == sizeof(uint32_t)) {
+      return ReadArenaRepeatedField(
+          *reinterpret_cast<span<const uint32_t>*>(out.data()), field, arena);
+    }
+    PW_CHECK(field.elem_size() == sizeof(bool),
+             "Mismatched message field type and size");
+    return ReadArenaRepeatedField(
+        *reinterpret_cast<span<const bool>*>(out.data()), field, arena);
+  }
+
+  // bytes or string field. The struct member is pw::span<const std::byte> for
+  // bytes or std::string_view for string.
+  PW_TRY(CheckOkToRead(WireType::kDelimited));
+  const ByteSpan buffer = arena.AllocateBuffer(delimited_field_size_);
+  if (buffer.size() < delimited_field_size_) {
+    return Status::ResourceExhausted();
+  }
+  const StatusWithSize sws = ReadDelimitedField(buffer);
+  arena.Resize(buffer.data(), buffer.size(), sws.size());
+  PW_TRY(sws);
+
+  const ConstByteSpan value = buffer.first(sws.size());
+  if (field.is_string()) {
+    *reinterpret_cast<std::string_view*>(out.data()) = std::string_view(
+        reinterpret_cast<const char*>(value.data()), value.size());
+  } else {
+    *reinterpret_cast<span<const std::byte>*>(out.data()) = value;
+  }
+  return OkStatus();
+}
+
 Status StreamDecoder::Read(span<std::byte> message,
-                           span<const internal::MessageField> table) {
+                           span<const internal::MessageField> table,
+                           allocator::Arena* arena) {
   PW_TRY(status_);
 
+  size_t hint = 0;
   while (Next().ok()) {
-    // Find the field in the table,
-    // TODO(b/234876102): Finding the field can be made more efficient.
-    const auto field =
-        std::find(table.begin(), table.end(), current_field_.field_number());
-    if (field == table.end()) {
+    // Find the field in the table.
+    const internal::MessageField* field =
+        FindField(table, current_field_.field_number(), hint);
+    if (field == nullptr) {
       // If the field is not found, skip to the next one.
       // TODO(b/234873295): Provide a way to allow the caller to inspect unknown
       // fields, and serialize them back out later.
@@ -552,6 +782,16 @@ Status StreamDecoder::Read(span<std::byte> message,
       continue;
     }
 
+    // Repeated, bytes, and string fields may draw their storage from an arena
+    // provided by the caller rather than a fixed-size container.
+    if (field->use_arena()) {
+      if (arena == nullptr) {
+        return Status::FailedPrecondition();
+      }
+      PW_TRY(ReadArenaField(out, *field, *arena));
+      continue;
+    }
+
     // Switch on the expected wire type of the field, not the actual, to ensure
     // the remote encoder doesn't influence our decoding unexpectedly.
     switch (field->wire_type()) {
@@ -677,7 +917,8 @@ Status StreamDecoder::Read(span<std::byte> message,
           // nested field. Obtain a nested decoder and recursively call Read()
           // using the fields table pointer from this field.
           auto nested_decoder = GetNestedDecoder();
-          PW_TRY(nested_decoder.Read(out, *field->nested_message_fields()));
+          PW_TRY(nested_decoder.Read(
+              out, *field->nested_message_fields(), arena));
         } else if (field->is_fixed_size()) {
           // Fixed-length bytes field. Struct member is a std::array<std::byte>.
           // Call ReadDelimitedField() to populate it from the stream.
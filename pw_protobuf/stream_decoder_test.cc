@@ -1294,6 +1294,90 @@ TEST(StreamDecoder, PackedVarintInsufficientSpace) {
   EXPECT_EQ(uint32[1], 50u);
 }
 
+TEST(StreamDecoder, PackedVarintSpansChunks) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=uint64[], k=1, v={2^63, 1, 2^63, 1, 2^63}
+    0x0a, 0x20,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01,
+    0x01,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01,
+    0x01,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01,
+    // type=uint32, k=2, v=7
+    0x10, 0x07,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber().value(), 1u);
+  std::array<uint64_t, 8> uint64{};
+  StatusWithSize size = decoder.ReadPackedUint64(uint64);
+  ASSERT_EQ(size.status(), OkStatus());
+  EXPECT_EQ(size.size(), 5u);
+
+  EXPECT_EQ(uint64[0], 1ull << 63);
+  EXPECT_EQ(uint64[1], 1u);
+  EXPECT_EQ(uint64[2], 1ull << 63);
+  EXPECT_EQ(uint64[3], 1u);
+  EXPECT_EQ(uint64[4], 1ull << 63);
+
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber().value(), 2u);
+  Result<uint32_t> uint32 = decoder.ReadUint32();
+  ASSERT_EQ(uint32.status(), OkStatus());
+  EXPECT_EQ(uint32.value(), 7u);
+}
+
+TEST(StreamDecoder, PackedVarintTruncated) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=uint32[], k=1, v={50, <truncated>}
+    0x0a, 0x02,
+    0x32,
+    0x96,
+    // type=uint32, k=2, v=1
+    0x10, 0x01,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber().value(), 1u);
+  std::array<uint32_t, 8> uint32{};
+  StatusWithSize size = decoder.ReadPackedUint32(uint32);
+  ASSERT_EQ(size.status(), Status::DataLoss());
+  EXPECT_EQ(size.size(), 1u);
+  EXPECT_EQ(uint32[0], 50u);
+}
+
+TEST(StreamDecoder, PackedVarintOutOfRange) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=uint64[], k=1, v={1, 2^32}
+    0x0a, 0x06,
+    0x01,
+    0x80, 0x80, 0x80, 0x80, 0x10,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber().value(), 1u);
+  std::array<uint32_t, 8> uint32{};
+  StatusWithSize size = decoder.ReadPackedUint32(uint32);
+  ASSERT_EQ(size.status(), Status::FailedPrecondition());
+  EXPECT_EQ(size.size(), 1u);
+  EXPECT_EQ(uint32[0], 1u);
+}
+
 TEST(StreamDecoder, PackedVarintVector) {
   // clang-format off
   constexpr uint8_t encoded_proto[] = {
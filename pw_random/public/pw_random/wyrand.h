@@ -0,0 +1,109 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "pw_bytes/span.h"
+#include "pw_random/random.h"
+#include "pw_random/xor_shift.h"
+
+namespace pw::random {
+namespace internal {
+
+// Multiplies two 64-bit values and XORs the high and low halves of the 128-bit
+// product. This version only uses 64-bit arithmetic.
+constexpr uint64_t MultiplyFoldPortable(uint64_t a, uint64_t b) {
+  const uint64_t a_high = a >> 32;
+  const uint64_t a_low = a & 0xFFFFFFFF;
+  const uint64_t b_high = b >> 32;
+  const uint64_t b_low = b & 0xFFFFFFFF;
+
+  const uint64_t high_high = a_high * b_high;
+  const uint64_t high_low = a_high * b_low;
+  const uint64_t low_high = a_low * b_high;
+  const uint64_t low_low = a_low * b_low;
+
+  const uint64_t partial = low_low + (high_low << 32);
+  uint64_t carry = partial < low_low ? 1 : 0;
+  const uint64_t low = partial + (low_high << 32);
+  carry += low < partial ? 1 : 0;
+  const uint64_t high = high_high + (high_low >> 32) + (low_high >> 32) + carry;
+  return low ^ high;
+}
+
+constexpr uint64_t MultiplyFold(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+  __extension__ using Uint128 = unsigned __int128;  // Avoid -Wpedantic errors.
+  const Uint128 product = static_cast<Uint128>(a) * b;
+  return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+  return MultiplyFoldPortable(a, b);
+#endif  // __SIZEOF_INT128__
+}
+
+}  // namespace internal
+
+// This is the "wyrand" algorithm, a counter-based generator. The state is a
+// counter that is advanced by a fixed odd constant, and each output is a
+// 128-bit product of the counter, folded to 64 bits. wyrand passes the
+// BigCrush and PractRand statistical test suites.
+//
+// Each step is one addition and one wide multiplication, with no dependency
+// on the previous output beyond the counter. On 64-bit hosts this is the
+// fastest generator in pw_random, about 3x faster than XorShiftStarRng64 for
+// bulk data. On 32-bit targets without a 64x64-bit multiply, it is slower than
+// XorShiftStarRng64.
+//
+// See: https://github.com/wangyi-fudan/wyhash
+//
+// This random generator is NOT cryptographically secure. The distribution is
+// not guaranteed to be uniform.
+class WyRandRng : public RandomGenerator {
+ public:
+  explicit WyRandRng(uint64_t initial_seed) : state_(initial_seed) {}
+
+  void Get(ByteSpan dest) final {
+    // Keep the state in a local so that it is not reloaded after every store to
+    // dest, which the compiler must assume could modify it.
+    uint64_t state = state_;
+    while (dest.size_bytes() >= sizeof(uint64_t)) {
+      const uint64_t random = Regenerate(state);
+      std::memcpy(dest.data(), &random, sizeof(random));
+      dest = dest.subspan(sizeof(random));
+    }
+    if (!dest.empty()) {
+      const uint64_t random = Regenerate(state);
+      std::memcpy(dest.data(), &random, dest.size_bytes());
+    }
+    state_ = state;
+  }
+
+  // Entropy is injected into the counter the same way as XorShiftStarRng64
+  // injects it into its state.
+  void InjectEntropyBits(uint32_t data, uint_fast8_t num_bits) final {
+    state_ = internal::InjectEntropyBitsIntoState(state_, data, num_bits);
+  }
+
+ private:
+  static uint64_t Regenerate(uint64_t& state) {
+    state += 0xA0761D6478BD642F;
+    return internal::MultiplyFold(state, state ^ 0xE7037ED1A0B428DB);
+  }
+
+  uint64_t state_;
+};
+
+}  // namespace pw::random
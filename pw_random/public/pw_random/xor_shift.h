@@ -23,6 +23,45 @@
 #include "pw_status/status_with_size.h"
 
 namespace pw::random {
+namespace internal {
+
+// One step of the "xorshift*" algorithm: advances the state and returns the
+// output. The state must be nonzero.
+inline uint64_t XorShiftStarStep(uint64_t& state) {
+  // For information on why this constant was selected, see:
+  // https://www.jstatsoft.org/article/view/v008i14
+  // http://vigna.di.unimi.it/ftp/papers/xorshift.pdf
+  constexpr uint64_t kMultConst = 0x2545F4914F6CDD1D;
+
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * kMultConst;
+}
+
+// Rotates entropy bits into a generator's state. Rotating before XORing
+// ensures injecting single bits progressively fills the state with entropy,
+// and that injecting bits one at a time or all at once has the same result.
+inline uint64_t InjectEntropyBitsIntoState(uint64_t state,
+                                           uint32_t data,
+                                           uint_fast8_t num_bits) {
+  if (num_bits == 0) {
+    return state;
+  } else if (num_bits > 32) {
+    num_bits = 32;
+  }
+
+  // Rotate state.
+  constexpr uint_fast8_t kNumStateBits = sizeof(state) * 8;
+  uint64_t untouched_state = state >> (kNumStateBits - num_bits);
+  state = untouched_state | (state << num_bits);
+  // Zero-out all irrelevant bits, then XOR entropy into state.
+  uint32_t mask =
+      static_cast<uint32_t>((static_cast<uint64_t>(1) << num_bits) - 1);
+  return state ^ (data & mask);
+}
+
+}  // namespace internal
 
 // This is the "xorshift*" algorithm which is a bit stronger than plain XOR
 // shift thanks to the nonlinear transformation at the end (multiplication).
@@ -52,19 +91,7 @@ class XorShiftStarRng64 : public RandomGenerator {
   // the random value with single bits will progressively fill the state with
   // more entropy.
   void InjectEntropyBits(uint32_t data, uint_fast8_t num_bits) final {
-    if (num_bits == 0) {
-      return;
-    } else if (num_bits > 32) {
-      num_bits = 32;
-    }
-
-    // Rotate state.
-    uint64_t untouched_state = state_ >> (kNumStateBits - num_bits);
-    state_ = untouched_state | (state_ << num_bits);
-    // Zero-out all irrelevant bits, then XOR entropy into state.
-    uint32_t mask =
-        static_cast<uint32_t>((static_cast<uint64_t>(1) << num_bits) - 1);
-    state_ ^= (data & mask);
+    state_ = internal::InjectEntropyBitsIntoState(state_, data, num_bits);
   }
 
  private:
@@ -75,18 +102,71 @@ class XorShiftStarRng64 : public RandomGenerator {
     if (state_ == 0) {
       state_--;
     }
-    state_ ^= state_ >> 12;
-    state_ ^= state_ << 25;
-    state_ ^= state_ >> 27;
-    return state_ * kMultConst;
+    return internal::XorShiftStarStep(state_);
   }
   uint64_t state_;
-  static constexpr uint8_t kNumStateBits = sizeof(state_) * 8;
+};
 
-  // For information on why this constant was selected, see:
-  // https://www.jstatsoft.org/article/view/v008i14
-  // http://vigna.di.unimi.it/ftp/papers/xorshift.pdf
-  static constexpr uint64_t kMultConst = 0x2545F4914F6CDD1D;
+// Runs kLanes independent xorshift* generators and interleaves their outputs,
+// one 64-bit value from each lane in turn. Since the lanes do not depend on one
+// another, the compiler can compute them in parallel, with SIMD instructions or
+// by overlapping them in the pipeline. This makes Get() with large buffers
+// about twice as fast as XorShiftStarRng64 on a host, at the cost of
+// kLanes * 8 bytes of state. The output differs from XorShiftStarRng64's.
+//
+// Like XorShiftStarRng64, this generator is NOT cryptographically secure.
+template <size_t kLanes = 4>
+class MultiLaneXorShiftStarRng64 : public RandomGenerator {
+ public:
+  static_assert(kLanes > 0u);
+
+  // Each lane is seeded from initial_seed with the splitmix64 function, so
+  // lanes start at unrelated points in the xorshift* sequence.
+  explicit MultiLaneXorShiftStarRng64(uint64_t initial_seed) {
+    for (uint64_t& lane : lanes_) {
+      initial_seed += 0x9E3779B97F4A7C15;
+      uint64_t z = initial_seed;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+      lane = NonZero(z ^ (z >> 31));
+    }
+  }
+
+  void Get(ByteSpan dest) final {
+    uint64_t block[kLanes];
+    while (dest.size_bytes() >= sizeof(block)) {
+      Regenerate(block);
+      std::memcpy(dest.data(), block, sizeof(block));
+      dest = dest.subspan(sizeof(block));
+    }
+    if (!dest.empty()) {
+      Regenerate(block);
+      std::memcpy(dest.data(), block, dest.size_bytes());
+    }
+  }
+
+  // Injects the entropy into every lane, as XorShiftStarRng64 does.
+  void InjectEntropyBits(uint32_t data, uint_fast8_t num_bits) final {
+    for (uint64_t& lane : lanes_) {
+      lane =
+          NonZero(internal::InjectEntropyBitsIntoState(lane, data, num_bits));
+    }
+  }
+
+ private:
+  // xorshift* never reaches a zero state from a nonzero one, so zero states
+  // are only checked for when the state is set, not in the loop.
+  static constexpr uint64_t NonZero(uint64_t state) {
+    return state == 0u ? ~uint64_t{0} : state;
+  }
+
+  void Regenerate(uint64_t (&block)[kLanes]) {
+    for (size_t i = 0; i < kLanes; ++i) {
+      block[i] = internal::XorShiftStarStep(lanes_[i]);
+    }
+  }
+
+  uint64_t lanes_[kLanes];
 };
 
 }  // namespace pw::random
@@ -0,0 +1,57 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures the throughput of each generator filling a 4 KiB buffer.
+
+#include <array>
+#include <cstddef>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_random/wyrand.h"
+#include "pw_random/xor_shift.h"
+
+namespace pw::random {
+namespace {
+
+constexpr uint64_t kSeed = 0x21feabcd5fb37474u;
+
+std::array<std::byte, 4096> buffer;
+
+void FillBuffer(perf_test::State& state, RandomGenerator& rng) {
+  while (state.KeepRunning()) {
+    rng.Get(buffer);
+  }
+}
+
+void XorShiftStarTest(perf_test::State& state) {
+  XorShiftStarRng64 rng(kSeed);
+  FillBuffer(state, rng);
+}
+
+void MultiLaneXorShiftStarTest(perf_test::State& state) {
+  MultiLaneXorShiftStarRng64<4> rng(kSeed);
+  FillBuffer(state, rng);
+}
+
+void WyRandTest(perf_test::State& state) {
+  WyRandRng rng(kSeed);
+  FillBuffer(state, rng);
+}
+
+PW_PERF_TEST(XorShiftStar, XorShiftStarTest);
+PW_PERF_TEST(MultiLaneXorShiftStar, MultiLaneXorShiftStarTest);
+PW_PERF_TEST(WyRand, WyRandTest);
+
+}  // namespace
+}  // namespace pw::random
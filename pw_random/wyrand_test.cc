@@ -0,0 +1,122 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_random/wyrand.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::random {
+namespace {
+
+constexpr uint64_t kSeed = 5;
+
+TEST(MultiplyFold, PortableMatchesNative) {
+  constexpr uint64_t kValues[] = {
+      0,
+      1,
+      0xFFFFFFFF,
+      0x100000000,
+      0xA0761D6478BD642F,
+      0xE7037ED1A0B428DB,
+      0xFFFFFFFFFFFFFFFF,
+  };
+  for (uint64_t a : kValues) {
+    for (uint64_t b : kValues) {
+      EXPECT_EQ(internal::MultiplyFold(a, b),
+                internal::MultiplyFoldPortable(a, b));
+    }
+  }
+}
+
+TEST(MultiplyFold, KnownValues) {
+  static_assert(internal::MultiplyFoldPortable(0xFFFFFFFFFFFFFFFF, 2) ==
+                (0xFFFFFFFFFFFFFFFE ^ 1));
+  static_assert(internal::MultiplyFoldPortable(0x100000000, 0x100000000) == 1);
+  static_assert(internal::MultiplyFoldPortable(0xFFFFFFFFFFFFFFFF,
+                                               0xFFFFFFFFFFFFFFFF) ==
+                (0x0000000000000001 ^ 0xFFFFFFFFFFFFFFFE));
+}
+
+TEST(WyRandRng, SameSeedSameSeries) {
+  WyRandRng rng_1(kSeed);
+  WyRandRng rng_2(kSeed);
+  for (int i = 0; i < 16; ++i) {
+    uint64_t val_1 = 0;
+    uint64_t val_2 = 0;
+    rng_1.GetInt(val_1);
+    rng_2.GetInt(val_2);
+    EXPECT_EQ(val_1, val_2);
+  }
+}
+
+TEST(WyRandRng, DifferentSeedsDiffer) {
+  WyRandRng rng_1(kSeed);
+  WyRandRng rng_2(kSeed + 1);
+  uint64_t val_1 = 0;
+  uint64_t val_2 = 0;
+  rng_1.GetInt(val_1);
+  rng_2.GetInt(val_2);
+  EXPECT_NE(val_1, val_2);
+}
+
+TEST(WyRandRng, GetMatchesGetInt) {
+  WyRandRng rng_1(kSeed);
+  std::array<uint64_t, 3> expected;
+  for (uint64_t& value : expected) {
+    rng_1.GetInt(value);
+  }
+
+  // The final partial value is the low bytes of the next output.
+  WyRandRng rng_2(kSeed);
+  std::array<std::byte, 20> bytes;
+  rng_2.Get(bytes);
+  EXPECT_EQ(0, std::memcmp(bytes.data(), expected.data(), bytes.size()));
+}
+
+TEST(WyRandRng, IncrementalEntropy) {
+  WyRandRng rng_1(kSeed);
+  rng_1.InjectEntropyBits(0x6, 3);
+  uint64_t first_val = 0;
+  rng_1.GetInt(first_val);
+
+  WyRandRng rng_2(kSeed);
+  rng_2.InjectEntropyBits(0x1, 1);
+  rng_2.InjectEntropyBits(0x1, 1);
+  rng_2.InjectEntropyBits(0x0, 1);
+  uint64_t second_val = 0;
+  rng_2.GetInt(second_val);
+
+  EXPECT_EQ(first_val, second_val);
+
+  WyRandRng rng_3(kSeed);
+  uint64_t no_entropy_val = 0;
+  rng_3.GetInt(no_entropy_val);
+  EXPECT_NE(first_val, no_entropy_val);
+}
+
+TEST(WyRandRng, GetIntBounded) {
+  WyRandRng rng(kSeed);
+  for (int i = 0; i < 100; ++i) {
+    uint16_t value = 0;
+    rng.GetInt(value, uint16_t{400});
+    EXPECT_LT(value, 400u);
+  }
+}
+
+}  // namespace
+}  // namespace pw::random
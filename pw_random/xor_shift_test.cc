@@ -13,10 +13,12 @@
 // the License.
 #include "pw_random/xor_shift.h"
 
+#include <array>
 #include <cinttypes>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -295,5 +297,68 @@ TEST(XorShiftStarRng64, GetIntBoundedHasHighBitSetSometimes) {
   EXPECT_TRUE(high_bit);
 }
 
+TEST(MultiLaneXorShiftStarRng64, LanesAreIndependentXorShiftStar) {
+  MultiLaneXorShiftStarRng64<4> rng(seed1);
+  std::array<uint64_t, 8> values;
+  rng.Get(as_writable_bytes(span(values)));
+
+  // Outputs are the state times an odd constant. Undo the multiplication
+  // with the constant's inverse modulo 2^64, found with Newton's method.
+  constexpr uint64_t kMultConst = 0x2545F4914F6CDD1D;
+  uint64_t inverse = kMultConst;
+  for (int i = 0; i < 5; ++i) {
+    inverse *= 2 - kMultConst * inverse;
+  }
+  ASSERT_EQ(1u, kMultConst * inverse);
+
+  // Each lane runs xorshift*, so its second output follows from its first.
+  for (size_t lane = 0; lane < 4; ++lane) {
+    uint64_t state = values[lane] * inverse;
+    EXPECT_EQ(values[lane + 4], internal::XorShiftStarStep(state));
+    for (size_t other = lane + 1; other < 4; ++other) {
+      EXPECT_NE(values[lane], values[other]);
+    }
+  }
+}
+
+TEST(MultiLaneXorShiftStarRng64, SameSeedSameSeries) {
+  MultiLaneXorShiftStarRng64<4> rng_1(seed1);
+  MultiLaneXorShiftStarRng64<4> rng_2(seed1);
+
+  // Splitting the output at a multiple of the block size does not change it.
+  std::array<std::byte, 100> bytes_1;
+  rng_1.Get(bytes_1);
+  std::array<std::byte, 100> bytes_2;
+  rng_2.Get(span(bytes_2).first(64));
+  rng_2.Get(span(bytes_2).subspan(64));
+
+  EXPECT_EQ(bytes_1, bytes_2);
+}
+
+TEST(MultiLaneXorShiftStarRng64, IncrementalEntropy) {
+  MultiLaneXorShiftStarRng64<2> rng_1(seed1);
+  rng_1.InjectEntropyBits(0x6, 3);
+  uint64_t first_val = 0;
+  rng_1.GetInt(first_val);
+
+  MultiLaneXorShiftStarRng64<2> rng_2(seed1);
+  rng_2.InjectEntropyBits(0x1, 1);
+  rng_2.InjectEntropyBits(0x1, 1);
+  rng_2.InjectEntropyBits(0x0, 1);
+  uint64_t second_val = 0;
+  rng_2.GetInt(second_val);
+
+  EXPECT_EQ(first_val, second_val);
+}
+
+TEST(MultiLaneXorShiftStarRng64, GetIntBounded) {
+  MultiLaneXorShiftStarRng64<> rng(seed2);
+  for (int i = 0; i < 100; ++i) {
+    uint32_t value = 0;
+    rng.GetInt(value, uint32_t{3'000'000'000});
+    EXPECT_LT(value, 3'000'000'000u);
+  }
+}
+
 }  // namespace
 }  // namespace pw::random
@@ -154,34 +154,27 @@ void PlacementNew(void* p, Args&&... args) {
 // Pigweed addition: Specialize StatusOrData for trivially destructible types.
 // This makes a Result usable in a constexpr statement.
 //
+// Pigweed addition: Specialize StatusOrData for trivially copyable types, with
+// defaulted copy and move operations. This keeps Result<T> trivially copyable,
+// so ABIs such as AArch64 and x86-64 System V return small Results in registers
+// instead of through a pointer to caller-allocated memory.
+//
 // Note: in C++20, this entire file can be greatly simplfied with the requires
 // statement.
-template <typename T, bool = std::is_trivially_destructible<T>::value>
+template <typename T,
+          bool = std::is_trivially_destructible<T>::value,
+          bool = std::is_trivially_copyable<T>::value>
 class StatusOrData;
 
 // Place the implementation of StatusOrData in a macro so it can be shared
-// between both specializations.
+// between all specializations.
 #define PW_RESULT_STATUS_OR_DATA_IMPL                                          \
-  template <typename U, bool>                                                  \
+  template <typename U, bool, bool>                                            \
   friend class StatusOrData;                                                   \
                                                                                \
  public:                                                                       \
   StatusOrData() = delete;                                                     \
                                                                                \
-  constexpr StatusOrData(const StatusOrData& other)                            \
-      : status_(other.status_), unused_() {                                    \
-    if (other.ok()) {                                                          \
-      MakeValue(other.data_);                                                  \
-    }                                                                          \
-  }                                                                            \
-                                                                               \
-  constexpr StatusOrData(StatusOrData&& other) noexcept                        \
-      : status_(std::move(other.status_)), unused_() {                         \
-    if (other.ok()) {                                                          \
-      MakeValue(std::move(other.data_));                                       \
-    }                                                                          \
-  }                                                                            \
-                                                                               \
   template <typename U>                                                        \
   explicit constexpr StatusOrData(const StatusOrData<U>& other) {              \
     if (other.ok()) {                                                          \
@@ -218,32 +211,6 @@ class StatusOrData;
     PW_ASSERT(!status_.ok());                                                  \
   }                                                                            \
                                                                                \
-  constexpr StatusOrData& operator=(const StatusOrData& other) {               \
-    if (this == &other) {                                                      \
-      return *this;                                                            \
-    }                                                                          \
-                                                                               \
-    if (other.ok()) {                                                          \
-      Assign(other.data_);                                                     \
-    } else {                                                                   \
-      AssignStatus(other.status_);                                             \
-    }                                                                          \
-    return *this;                                                              \
-  }                                                                            \
-                                                                               \
-  constexpr StatusOrData& operator=(StatusOrData&& other) {                    \
-    if (this == &other) {                                                      \
-      return *this;                                                            \
-    }                                                                          \
-                                                                               \
-    if (other.ok()) {                                                          \
-      Assign(std::move(other.data_));                                          \
-    } else {                                                                   \
-      AssignStatus(std::move(other.status_));                                  \
-    }                                                                          \
-    return *this;                                                              \
-  }                                                                            \
-                                                                               \
   template <typename U>                                                        \
   constexpr void Assign(U&& value) {                                           \
     if (ok()) {                                                                \
@@ -286,14 +253,71 @@ class StatusOrData;
   }                                                                            \
   static_assert(true, "Macros must be terminated with a semicolon")
 
+// Copy and move operations for types that are not trivially copyable.
+#define PW_RESULT_STATUS_OR_DATA_COPY_IMPL                                     \
+ public:                                                                       \
+  constexpr StatusOrData(const StatusOrData& other)                            \
+      : status_(other.status_), unused_() {                                    \
+    if (other.ok()) {                                                          \
+      MakeValue(other.data_);                                                  \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  constexpr StatusOrData(StatusOrData&& other) noexcept                        \
+      : status_(std::move(other.status_)), unused_() {                         \
+    if (other.ok()) {                                                          \
+      MakeValue(std::move(other.data_));                                       \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  constexpr StatusOrData& operator=(const StatusOrData& other) {               \
+    if (this == &other) {                                                      \
+      return *this;                                                            \
+    }                                                                          \
+                                                                               \
+    if (other.ok()) {                                                          \
+      Assign(other.data_);                                                     \
+    } else {                                                                   \
+      AssignStatus(other.status_);                                             \
+    }                                                                          \
+    return *this;                                                              \
+  }                                                                            \
+                                                                               \
+  constexpr StatusOrData& operator=(StatusOrData&& other) {                    \
+    if (this == &other) {                                                      \
+      return *this;                                                            \
+    }                                                                          \
+                                                                               \
+    if (other.ok()) {                                                          \
+      Assign(std::move(other.data_));                                          \
+    } else {                                                                   \
+      AssignStatus(std::move(other.status_));                                  \
+    }                                                                          \
+    return *this;                                                              \
+  }                                                                            \
+  static_assert(true, "Macros must be terminated with a semicolon")
+
+template <typename T>
+class StatusOrData<T, true, true> {
+  PW_RESULT_STATUS_OR_DATA_IMPL;
+
+ public:
+  constexpr StatusOrData(const StatusOrData&) = default;
+  constexpr StatusOrData(StatusOrData&&) = default;
+  constexpr StatusOrData& operator=(const StatusOrData&) = default;
+  constexpr StatusOrData& operator=(StatusOrData&&) = default;
+};
+
 template <typename T>
-class StatusOrData<T, true> {
+class StatusOrData<T, true, false> {
   PW_RESULT_STATUS_OR_DATA_IMPL;
+  PW_RESULT_STATUS_OR_DATA_COPY_IMPL;
 };
 
 template <typename T>
-class StatusOrData<T, false> {
+class StatusOrData<T, false, false> {
   PW_RESULT_STATUS_OR_DATA_IMPL;
+  PW_RESULT_STATUS_OR_DATA_COPY_IMPL;
 
  public:
   // Add a destructor since T is not trivially destructible.
@@ -305,6 +329,7 @@ class StatusOrData<T, false> {
 };
 
 #undef PW_RESULT_STATUS_OR_DATA_IMPL
+#undef PW_RESULT_STATUS_OR_DATA_COPY_IMPL
 
 PW_MODIFY_DIAGNOSTICS_POP();
 
@@ -0,0 +1,76 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <cstdint>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw {
+namespace {
+
+constexpr uint32_t kCalls = 64;
+
+uint32_t volatile sink;
+
+// Compares returning a small value through a Result with the equivalent Status
+// and out pointer. The functions are not inlined, so the calling convention is
+// what is measured.
+PW_NO_INLINE Result<uint32_t> HalveResult(uint32_t value) {
+  if ((value & 1u) != 0u) {
+    return Status::InvalidArgument();
+  }
+  return value / 2;
+}
+
+PW_NO_INLINE Status HalvePointer(uint32_t value, uint32_t* out) {
+  if ((value & 1u) != 0u) {
+    return Status::InvalidArgument();
+  }
+  *out = value / 2;
+  return OkStatus();
+}
+
+void ReturnResult(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < kCalls; ++i) {
+      if (Result<uint32_t> result = HalveResult(i); result.ok()) {
+        total += *result;
+      }
+    }
+    sink = total;
+  }
+}
+
+void ReturnStatusAndPointer(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < kCalls; ++i) {
+      uint32_t value;
+      if (HalvePointer(i, &value).ok()) {
+        total += value;
+      }
+    }
+    sink = total;
+  }
+}
+
+PW_PERF_TEST(ResultUint32, ReturnResult);
+PW_PERF_TEST(StatusAndPointerUint32, ReturnStatusAndPointer);
+
+}  // namespace
+}  // namespace pw
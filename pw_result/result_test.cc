@@ -22,6 +22,8 @@
 
 #include "pw_result/result.h"
 
+#include <type_traits>
+
 #include "gtest/gtest.h"
 #include "pw_status/status.h"
 #include "pw_status/try.h"
@@ -177,6 +179,34 @@ TEST(Result, ConstexprNotOkCopy) {
   static_assert(std::move(kResultCopy).value_or(Value{99}).number == 99);
 }
 
+// Results of trivially copyable types are trivially copyable, so they can be
+// returned in registers.
+static_assert(std::is_trivially_copyable_v<Result<int>>);
+static_assert(std::is_trivially_copyable_v<Result<Value>>);
+static_assert(std::is_trivially_copyable_v<Result<const char*>>);
+
+struct NotTriviallyCopyable {
+  NotTriviallyCopyable() = default;
+  NotTriviallyCopyable(const NotTriviallyCopyable&) {}
+};
+static_assert(!std::is_trivially_copyable_v<Result<NotTriviallyCopyable>>);
+
+TEST(Result, TriviallyCopyableCopyAndAssign) {
+  Result<int> ok_result(3);
+  Result<int> error_result(Status::NotFound());
+
+  Result<int> copy = ok_result;
+  ASSERT_TRUE(copy.ok());
+  EXPECT_EQ(*copy, 3);
+
+  copy = error_result;
+  EXPECT_EQ(copy.status(), Status::NotFound());
+
+  copy = std::move(ok_result);
+  ASSERT_TRUE(copy.ok());
+  EXPECT_EQ(*copy, 3);
+}
+
 auto multiply = [](int x) -> Result<int> { return x * 2; };
 auto add_two = [](int x) -> Result<int> { return x + 2; };
 auto fail_unknown = [](int) -> Result<int> { return Status::Unknown(); };
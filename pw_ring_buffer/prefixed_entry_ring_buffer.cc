@@ -30,8 +30,23 @@ using Entry = PrefixedEntryRingBufferMulti::Entry;
 using Reader = PrefixedEntryRingBufferMulti::Reader;
 using iterator = PrefixedEntryRingBufferMulti::iterator;
 
+namespace {
+
+// Encodes a varint using exactly `output.size()` bytes, padding it with
+// continuation bytes as needed. Readers decode padded varints like any other.
+void EncodePaddedVarint(uint32_t value, span<byte> output) {
+  for (size_t i = 0; i < output.size(); ++i) {
+    const bool last = i + 1 == output.size();
+    output[i] = static_cast<byte>((value & 0x7fu) | (last ? 0u : 0x80u));
+    value >>= 7;
+  }
+}
+
+}  // namespace
+
 void PrefixedEntryRingBufferMulti::Clear() {
   write_idx_ = 0;
+  reservation_active_ = false;
   for (Reader& reader : readers_) {
     reader.read_idx_ = 0;
     reader.entry_count_ = 0;
@@ -86,7 +101,7 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
     span<const byte> data,
     uint32_t user_preamble_data,
     bool pop_front_if_needed) {
-  if (buffer_ == nullptr) {
+  if (buffer_ == nullptr || reservation_active_) {
     return Status::FailedPrecondition();
   }
 
@@ -109,10 +124,7 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
 
   if (pop_front_if_needed) {
     // PushBack() case: evict items as needed.
-    // Drop old entries until we have space for the new entry.
-    while (RawAvailableBytes() < total_write_bytes) {
-      InternalPopFrontAll();
-    }
+    MakeSpace(total_write_bytes);
   } else if (RawAvailableBytes() < total_write_bytes) {
     // TryPushBack() case: don't evict items.
     return Status::ResourceExhausted();
@@ -129,6 +141,84 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
   return OkStatus();
 }
 
+size_t PrefixedEntryRingBufferMulti::PreambleSizeBytes(
+    size_t data_size_bytes, uint32_t user_preamble_data) const {
+  return (user_preamble_ ? varint::EncodedSize(user_preamble_data) : 0u) +
+         varint::EncodedSize(data_size_bytes);
+}
+
+void PrefixedEntryRingBufferMulti::MakeSpace(size_t total_write_bytes) {
+  // Drop old entries until we have space for the new entry.
+  while (RawAvailableBytes() < total_write_bytes) {
+    InternalPopFrontAll();
+  }
+}
+
+Result<span<byte>> PrefixedEntryRingBufferMulti::ReserveBack(
+    size_t max_size_bytes, uint32_t user_preamble_data) {
+  if (buffer_ == nullptr || reservation_active_) {
+    return Status::FailedPrecondition();
+  }
+  if (max_size_bytes > std::numeric_limits<uint32_t>::max()) {
+    return Status::OutOfRange();
+  }
+
+  // The length varint is sized for the largest entry so that the data can be
+  // written in place before its final size is known.
+  const size_t preamble_bytes =
+      PreambleSizeBytes(max_size_bytes, user_preamble_data);
+  const size_t total_write_bytes = preamble_bytes + max_size_bytes;
+  if (buffer_bytes_ < total_write_bytes) {
+    return Status::OutOfRange();
+  }
+
+  size_t data_idx = IncrementIndex(write_idx_, preamble_bytes);
+  if (data_idx == buffer_bytes_) {
+    data_idx = 0;
+  }
+  if (data_idx + max_size_bytes > buffer_bytes_) {
+    return Status::Unavailable();
+  }
+
+  MakeSpace(total_write_bytes);
+
+  reservation_active_ = true;
+  reserved_user_preamble_ = user_preamble_data;
+  reserved_size_bytes_ = max_size_bytes;
+  return span(buffer_ + data_idx, max_size_bytes);
+}
+
+Status PrefixedEntryRingBufferMulti::CommitBack(size_t size_bytes) {
+  if (!reservation_active_) {
+    return Status::FailedPrecondition();
+  }
+  if (size_bytes > reserved_size_bytes_) {
+    return Status::InvalidArgument();
+  }
+
+  byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
+  size_t user_preamble_bytes = 0;
+  if (user_preamble_) {
+    user_preamble_bytes =
+        varint::Encode<uint32_t>(reserved_user_preamble_, preamble_buf);
+  }
+  // Encode the length in the space reserved for it, which may be larger than
+  // needed, so the data does not have to move.
+  const size_t length_bytes = varint::EncodedSize(reserved_size_bytes_);
+  EncodePaddedVarint(
+      static_cast<uint32_t>(size_bytes),
+      span(preamble_buf).subspan(user_preamble_bytes, length_bytes));
+
+  RawWrite(span(preamble_buf, user_preamble_bytes + length_bytes));
+  write_idx_ = IncrementIndex(write_idx_, size_bytes);
+  reservation_active_ = false;
+
+  for (Reader& reader : readers_) {
+    reader.entry_count_++;
+  }
+  return OkStatus();
+}
+
 auto GetOutput(span<byte> data_out, size_t* write_index) {
   return [data_out, write_index](span<const byte> src) -> Status {
     size_t copy_size = std::min(data_out.size_bytes(), src.size_bytes());
@@ -163,6 +253,30 @@ Status PrefixedEntryRingBufferMulti::InternalPeekFrontWithPreamble(
   return InternalRead(reader, output, true);
 }
 
+Result<PrefixedEntryRingBufferMulti::EntrySegments>
+PrefixedEntryRingBufferMulti::InternalPeekFrontInPlace(
+    const Reader& reader) const {
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  if (reader.entry_count_ == 0) {
+    return Status::OutOfRange();
+  }
+
+  const EntryInfo info = FrontEntryInfo(reader);
+  size_t data_idx = IncrementIndex(reader.read_idx_, info.preamble_bytes);
+  if (data_idx == buffer_bytes_) {
+    data_idx = 0;
+  }
+  const size_t first_bytes =
+      std::min(info.data_bytes, buffer_bytes_ - data_idx);
+  return EntrySegments{
+      .first = span<const byte>(buffer_ + data_idx, first_bytes),
+      .second = span<const byte>(buffer_, info.data_bytes - first_bytes),
+      .preamble = info.user_preamble,
+  };
+}
+
 Status PrefixedEntryRingBufferMulti::InternalPeekFrontPreamble(
     const Reader& reader, uint32_t& user_preamble_out) const {
   if (reader.entry_count_ == 0) {
@@ -259,7 +373,7 @@ Status PrefixedEntryRingBufferMulti::Dering() {
 }
 
 Status PrefixedEntryRingBufferMulti::InternalDering(Reader& dering_reader) {
-  if (buffer_ == nullptr || readers_.empty()) {
+  if (buffer_ == nullptr || readers_.empty() || reservation_active_) {
     return Status::FailedPrecondition();
   }
 
@@ -308,6 +422,34 @@ Status PrefixedEntryRingBufferMulti::InternalPopFront(Reader& reader) {
   return OkStatus();
 }
 
+Status PrefixedEntryRingBufferMulti::InternalPopMany(Reader& reader,
+                                                     size_t count) {
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  if (reader.entry_count_ < count) {
+    return Status::OutOfRange();
+  }
+
+  // The newest entry ends at the write index, so popping every entry does not
+  // need to read them.
+  if (count == reader.entry_count_) {
+    reader.read_idx_ = write_idx_;
+    reader.entry_count_ = 0;
+    return OkStatus();
+  }
+
+  size_t read_idx = reader.read_idx_;
+  for (size_t i = 0; i < count; ++i) {
+    const Result<EntryInfo> info = RawFrontEntryInfo(read_idx);
+    PW_CHECK_OK(info.status());
+    read_idx = IncrementIndex(read_idx, info->preamble_bytes + info->data_bytes);
+  }
+  reader.read_idx_ = read_idx;
+  reader.entry_count_ -= count;
+  return OkStatus();
+}
+
 size_t PrefixedEntryRingBufferMulti::InternalFrontEntryDataSizeBytes(
     const Reader& reader) const {
   if (reader.entry_count_ == 0) {
@@ -340,21 +482,17 @@ PrefixedEntryRingBufferMulti::RawFrontEntryInfo(size_t source_idx) const {
   // If a preamble exists, extract the varint and it's bytes in bytes.
   size_t user_preamble_bytes = 0;
   uint64_t user_preamble_data = 0;
-  byte varint_buf[varint::kMaxVarint32SizeBytes];
   if (user_preamble_) {
-    RawRead(varint_buf, source_idx, varint::kMaxVarint32SizeBytes);
-    user_preamble_bytes = varint::Decode(varint_buf, &user_preamble_data);
+    user_preamble_bytes = RawDecodeVarint(source_idx, &user_preamble_data);
     if (user_preamble_bytes == 0u) {
       return Status::DataLoss();
     }
   }
 
   // Read the entry header; extract the varint and it's bytes in bytes.
-  RawRead(varint_buf,
-          IncrementIndex(source_idx, user_preamble_bytes),
-          varint::kMaxVarint32SizeBytes);
   uint64_t entry_bytes;
-  size_t length_bytes = varint::Decode(varint_buf, &entry_bytes);
+  size_t length_bytes = RawDecodeVarint(
+      IncrementIndex(source_idx, user_preamble_bytes), &entry_bytes);
   if (length_bytes == 0u) {
     return Status::DataLoss();
   }
@@ -366,6 +504,18 @@ PrefixedEntryRingBufferMulti::RawFrontEntryInfo(size_t source_idx) const {
   return info;
 }
 
+size_t PrefixedEntryRingBufferMulti::RawDecodeVarint(size_t source_idx,
+                                                     uint64_t* value) const {
+  // Decode in place, unless the varint may wrap around the end of the buffer.
+  if (buffer_bytes_ - source_idx >= varint::kMaxVarint32SizeBytes) {
+    return varint::Decode(
+        span(buffer_ + source_idx, varint::kMaxVarint32SizeBytes), value);
+  }
+  byte varint_buf[varint::kMaxVarint32SizeBytes];
+  RawRead(varint_buf, source_idx, varint::kMaxVarint32SizeBytes);
+  return varint::Decode(varint_buf, value);
+}
+
 // Comparisons ordered for more probable early exits, assuming the reader is
 // not far behind the writer compared to the size of the ring.
 size_t PrefixedEntryRingBufferMulti::RawAvailableBytes() const {
@@ -449,18 +599,26 @@ Status PrefixedEntryRingBufferMulti::Reader::PeekFrontWithPreamble(
       *this, GetOutput(data, &entry_bytes_read_out), false, &user_preamble_out);
 }
 
+iterator::iterator(Reader& reader)
+    : ring_buffer_(reader.buffer_),
+      read_idx_(0),
+      entry_count_(reader.entry_count_),
+      entry_bytes_(0) {
+  Status dering_result = ring_buffer_->InternalDering(reader);
+  PW_DASSERT(dering_result.ok());
+  if (entry_count_ == 0) {
+    SkipToEnd(OkStatus());
+    return;
+  }
+  ReadEntry();
+}
+
 iterator& iterator::operator++() {
   PW_DCHECK_OK(iteration_status_);
   PW_DCHECK_INT_NE(entry_count_, 0);
 
-  Result<EntryInfo> info = ring_buffer_->RawFrontEntryInfo(read_idx_);
-  if (!info.status().ok()) {
-    SkipToEnd(info.status());
-    return *this;
-  }
-
   // It is guaranteed that the buffer is deringed at this point.
-  read_idx_ += info.value().preamble_bytes + info.value().data_bytes;
+  read_idx_ += entry_bytes_;
   entry_count_--;
 
   if (entry_count_ == 0) {
@@ -468,33 +626,40 @@ iterator& iterator::operator++() {
     return *this;
   }
 
-  if (read_idx_ >= ring_buffer_->TotalUsedBytes()) {
-    SkipToEnd(Status::DataLoss());
-    return *this;
-  }
-
-  info = ring_buffer_->RawFrontEntryInfo(read_idx_);
-  if (!info.status().ok()) {
-    SkipToEnd(info.status());
-    return *this;
-  }
+  ReadEntry();
   return *this;
 }
 
 const Entry& iterator::operator*() const {
   PW_DCHECK_OK(iteration_status_);
   PW_DCHECK_INT_NE(entry_count_, 0);
+  return entry_;
+}
+
+void iterator::ReadEntry() {
+  const size_t used_bytes = ring_buffer_->TotalUsedBytes();
+  if (read_idx_ >= used_bytes) {
+    SkipToEnd(Status::DataLoss());
+    return;
+  }
 
   Result<EntryInfo> info = ring_buffer_->RawFrontEntryInfo(read_idx_);
-  PW_DCHECK_OK(info.status());
+  if (!info.status().ok()) {
+    SkipToEnd(info.status());
+    return;
+  }
 
+  entry_bytes_ = info->preamble_bytes + info->data_bytes;
+  if (entry_bytes_ > used_bytes - read_idx_) {
+    SkipToEnd(Status::DataLoss());
+    return;
+  }
   entry_ = {
       .buffer = span<const byte>(
-          ring_buffer_->buffer_ + read_idx_ + info.value().preamble_bytes,
-          info.value().data_bytes),
-      .preamble = info.value().user_preamble,
+          ring_buffer_->buffer_ + read_idx_ + info->preamble_bytes,
+          info->data_bytes),
+      .preamble = info->user_preamble,
   };
-  return entry_;
 }
 
 }  // namespace ring_buffer
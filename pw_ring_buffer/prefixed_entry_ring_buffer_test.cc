@@ -534,6 +534,131 @@ TEST(PrefixedEntryRingBuffer, Iterator) {
   EXPECT_EQ(validated_entries, entry_count);
 }
 
+TEST(PrefixedEntryRingBuffer, ReserveAndCommit) {
+  PrefixedEntryRingBuffer ring(true);
+  byte test_buffer[32];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Reserve more than is written; the entry only holds the committed bytes.
+  Result<span<byte>> reserved = ring.ReserveBack(200, 7);
+  ASSERT_EQ(reserved.status(), Status::OutOfRange());
+  reserved = ring.ReserveBack(16, 7);
+  ASSERT_EQ(reserved.status(), OkStatus());
+  ASSERT_EQ(reserved.value().size(), 16u);
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  std::memcpy(reserved.value().data(), "hello", 5);
+
+  // No other entries may be written while a reservation is outstanding.
+  EXPECT_EQ(ring.PushBack(single_entry_data), Status::FailedPrecondition());
+  EXPECT_EQ(ring.ReserveBack(4).status(), Status::FailedPrecondition());
+  EXPECT_EQ(ring.CommitBack(17), Status::InvalidArgument());
+
+  EXPECT_EQ(ring.CommitBack(5), OkStatus());
+  EXPECT_EQ(ring.CommitBack(5), Status::FailedPrecondition());
+  ASSERT_EQ(ring.EntryCount(), 1u);
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 5u);
+
+  byte peek_buffer[16];
+  uint32_t preamble = 0;
+  size_t bytes_read = 0;
+  EXPECT_EQ(ring.PeekFrontWithPreamble(peek_buffer, preamble, bytes_read),
+            OkStatus());
+  EXPECT_EQ(preamble, 7u);
+  ASSERT_EQ(bytes_read, 5u);
+  EXPECT_EQ(std::memcmp(peek_buffer, "hello", 5), 0);
+
+  // The entry is read back like any other.
+  EXPECT_EQ(ring.PushBack(single_entry_data), OkStatus());
+  EXPECT_EQ(ring.PopFront(), OkStatus());
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), sizeof(single_entry_data));
+}
+
+TEST(PrefixedEntryRingBuffer, ReserveCancel) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[16];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  ASSERT_EQ(ring.ReserveBack(4).status(), OkStatus());
+  ring.CancelBack();
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.CommitBack(0), Status::FailedPrecondition());
+  EXPECT_EQ(ring.PushBack(single_entry_data), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+}
+
+TEST(PrefixedEntryRingBuffer, ReserveEvictsAndRejectsWrap) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[16];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Fill the buffer so the reservation must evict the oldest entry.
+  constexpr byte kEntry[7] = {};
+  EXPECT_EQ(ring.PushBack(kEntry), OkStatus());
+  EXPECT_EQ(ring.PushBack(kEntry), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+
+  // The write head is at the end of the buffer, so the data is contiguous.
+  Result<span<byte>> reserved = ring.ReserveBack(7);
+  ASSERT_EQ(reserved.status(), OkStatus());
+  EXPECT_EQ(reserved.value().data(), &test_buffer[1]);
+  EXPECT_EQ(ring.CommitBack(7), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+
+  // An entry that would wrap around the end of the buffer is rejected without
+  // evicting anything.
+  EXPECT_EQ(ring.ReserveBack(8).status(), Status::Unavailable());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+}
+
+TEST(PrefixedEntryRingBuffer, PeekFrontInPlace) {
+  PrefixedEntryRingBuffer ring(true);
+  byte test_buffer[16];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+  EXPECT_EQ(ring.PeekFrontInPlace().status(), Status::OutOfRange());
+
+  constexpr byte kEntry[6] = {
+      byte(1), byte(2), byte(3), byte(4), byte(5), byte(6)};
+  EXPECT_EQ(ring.PushBack(kEntry, 3u), OkStatus());
+
+  Result<PrefixedEntryRingBuffer::EntrySegments> segments =
+      ring.PeekFrontInPlace();
+  ASSERT_EQ(segments.status(), OkStatus());
+  EXPECT_EQ(segments.value().preamble, 3u);
+  EXPECT_EQ(segments.value().first.data(), &test_buffer[2]);
+  ASSERT_EQ(segments.value().first.size(), sizeof(kEntry));
+  EXPECT_TRUE(segments.value().second.empty());
+  EXPECT_EQ(std::memcmp(segments.value().first.data(), kEntry, sizeof(kEntry)),
+            0);
+
+  // Move the write head so the next entry wraps around the end of the buffer.
+  EXPECT_EQ(ring.PushBack(span(kEntry).first(2), 4u), OkStatus());
+  EXPECT_EQ(ring.PopFront(), OkStatus());
+  segments = ring.PeekFrontInPlace();
+  ASSERT_EQ(segments.status(), OkStatus());
+  EXPECT_EQ(segments.value().preamble, 4u);
+  EXPECT_EQ(segments.value().first.data(), &test_buffer[10]);
+  EXPECT_EQ(segments.value().first.size(), 2u);
+  EXPECT_TRUE(segments.value().second.empty());
+  EXPECT_EQ(ring.PopFront(), OkStatus());
+
+  EXPECT_EQ(ring.PushBack(kEntry, 5u), OkStatus());
+  segments = ring.PeekFrontInPlace();
+  ASSERT_EQ(segments.status(), OkStatus());
+  EXPECT_EQ(segments.value().preamble, 5u);
+  ASSERT_EQ(segments.value().size_bytes(), sizeof(kEntry));
+  EXPECT_EQ(segments.value().first.size(), 2u);
+  EXPECT_EQ(segments.value().first.data(), &test_buffer[14]);
+  EXPECT_EQ(segments.value().second.data(), &test_buffer[0]);
+  byte joined[sizeof(kEntry)];
+  std::memcpy(joined,
+              segments.value().first.data(),
+              segments.value().first.size());
+  std::memcpy(joined + segments.value().first.size(),
+              segments.value().second.data(),
+              segments.value().second.size());
+  EXPECT_EQ(std::memcmp(joined, kEntry, sizeof(kEntry)), 0);
+}
+
 TEST(PrefixedEntryRingBufferMulti, TryPushBack) {
   PrefixedEntryRingBufferMulti ring;
   byte test_buffer[kTestBufferSize];
@@ -640,6 +765,53 @@ TEST(PrefixedEntryRingBufferMulti, PushBack) {
   EXPECT_EQ(fast_reader.EntryCount(), total_items - 1);
 }
 
+TEST(PrefixedEntryRingBufferMulti, PopMany) {
+  PrefixedEntryRingBufferMulti ring(true);
+  byte test_buffer[kTestBufferSize];
+  EXPECT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Reader fast_reader;
+  PrefixedEntryRingBufferMulti::Reader slow_reader;
+  EXPECT_EQ(ring.AttachReader(fast_reader), OkStatus());
+  EXPECT_EQ(ring.AttachReader(slow_reader), OkStatus());
+
+  // Write enough entries that they wrap around the end of the buffer.
+  uint32_t total_items = 0;
+  for (; total_items < 3 * kTestBufferSize / 4; ++total_items) {
+    EXPECT_EQ(PushBack<uint32_t>(ring, total_items, total_items), OkStatus());
+  }
+  const size_t entry_count = slow_reader.EntryCount();
+  ASSERT_EQ(fast_reader.EntryCount(), entry_count);
+  const uint32_t first_item = total_items - static_cast<uint32_t>(entry_count);
+
+  EXPECT_EQ(fast_reader.PopMany(3), OkStatus());
+  uint32_t user_preamble = 0;
+  EXPECT_EQ(PeekFront<uint32_t>(fast_reader, &user_preamble), first_item + 3);
+  EXPECT_EQ(user_preamble, first_item + 3);
+  EXPECT_EQ(fast_reader.EntryCount(), entry_count - 3);
+
+  // Popping more entries than are available pops none.
+  EXPECT_EQ(fast_reader.PopMany(entry_count), Status::OutOfRange());
+  EXPECT_EQ(fast_reader.EntryCount(), entry_count - 3);
+
+  // Catching up leaves the slow reader's entries in place.
+  const size_t total_used_bytes = ring.TotalUsedBytes();
+  EXPECT_EQ(fast_reader.PopMany(fast_reader.EntryCount()), OkStatus());
+  EXPECT_EQ(fast_reader.EntryCount(), 0u);
+  EXPECT_EQ(fast_reader.PopFront(), Status::OutOfRange());
+  EXPECT_EQ(ring.TotalUsedBytes(), total_used_bytes);
+  EXPECT_EQ(PeekFront<uint32_t>(slow_reader), first_item);
+
+  EXPECT_EQ(slow_reader.PopMany(0), OkStatus());
+  EXPECT_EQ(slow_reader.PopMany(entry_count), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+
+  // Both readers see entries written after catching up.
+  EXPECT_EQ(PushBack<uint32_t>(ring, total_items), OkStatus());
+  EXPECT_EQ(PeekFront<uint32_t>(fast_reader), total_items);
+  EXPECT_EQ(PeekFront<uint32_t>(slow_reader), total_items);
+}
+
 TEST(PrefixedEntryRingBufferMulti, ReaderAddRemove) {
   PrefixedEntryRingBufferMulti ring;
   byte test_buffer[kTestBufferSize];
@@ -44,6 +44,16 @@ class PrefixedEntryRingBufferMulti {
  public:
   typedef Status (*ReadOutput)(span<const std::byte>);
 
+  // The data of an entry viewed in place in the ring buffer. Entries that wrap
+  // around the end of the buffer are split into two segments.
+  struct EntrySegments {
+    span<const std::byte> first;
+    span<const std::byte> second;  // Empty unless the entry wraps.
+    uint32_t preamble;
+
+    size_t size_bytes() const { return first.size() + second.size(); }
+  };
+
   // A reader that provides a single-reader interface into the multi-reader ring
   // buffer it has been attached to via AttachReader(). Readers maintain their
   // read position in the ring buffer as well as the remaining count of entries
@@ -120,6 +130,22 @@ class PrefixedEntryRingBufferMulti {
       return buffer_->InternalPeekFrontWithPreamble(*this, output);
     }
 
+    // Returns views of the oldest entry's data and its user preamble without
+    // copying the data. The views are invalidated by the next write, Clear(),
+    // or Dering() of the ring buffer; popping the entry does not invalidate
+    // them.
+    //
+    // Precondition: the buffer data must not be corrupt, otherwise there will
+    // be a crash.
+    //
+    // Return values:
+    // OK - Views of the entry's data were returned.
+    // FAILED_PRECONDITION - Buffer not initialized.
+    // OUT_OF_RANGE - No entries in ring buffer to read.
+    Result<EntrySegments> PeekFrontInPlace() const {
+      return buffer_->InternalPeekFrontInPlace(*this);
+    }
+
     // Pop and discard the oldest stored data chunk of data from the ring
     // buffer.
     //
@@ -132,6 +158,22 @@ class PrefixedEntryRingBufferMulti {
     // OUT_OF_RANGE - No entries in ring buffer to pop.
     Status PopFront() { return buffer_->InternalPopFront(*this); }
 
+    // Pop and discard the `count` oldest entries from the ring buffer. Popping
+    // every entry, to catch up with the writer, takes constant time. Otherwise
+    // only the header of each popped entry is read.
+    //
+    // Precondition: the buffer data must not be corrupt, otherwise there will
+    // be a crash.
+    //
+    // Return values:
+    // OK - Entries successfully popped from the ring buffer.
+    // FAILED_PRECONDITION - Buffer not initialized.
+    // OUT_OF_RANGE - Fewer than `count` entries in ring buffer; no entries were
+    // popped.
+    Status PopMany(size_t count) {
+      return buffer_->InternalPopMany(*this, count);
+    }
+
     // Get the size in bytes of the next chunk, not including preamble, to be
     // read.
     //
@@ -185,16 +227,15 @@ class PrefixedEntryRingBufferMulti {
   // Reader position, without mutating the underlying buffer. This is useful in
   // crash contexts where all available entries in the buffer must be acquired,
   // even those that have already been consumed by all attached readers.
+  //
+  // Creating the iterator derings the buffer, so that each entry is
+  // contiguous. Each entry's header is then decoded once, as the iterator
+  // reaches it.
   class iterator {
    public:
-    iterator() : ring_buffer_(nullptr), read_idx_(0), entry_count_(0) {}
-    iterator(Reader& reader)
-        : ring_buffer_(reader.buffer_),
-          read_idx_(0),
-          entry_count_(reader.entry_count_) {
-      Status dering_result = ring_buffer_->InternalDering(reader);
-      PW_DASSERT(dering_result.ok());
-    }
+    iterator()
+        : ring_buffer_(nullptr), read_idx_(0), entry_count_(0), entry_bytes_(0) {}
+    iterator(Reader& reader);
 
     iterator& operator++();
     iterator operator++(int) {
@@ -232,11 +273,17 @@ class PrefixedEntryRingBufferMulti {
       entry_count_ = 0;
     }
 
+    // Decodes the header of the entry at read_idx_, or moves to the end if it
+    // is invalid.
+    void ReadEntry();
+
     PrefixedEntryRingBufferMulti* ring_buffer_;
     size_t read_idx_;
     size_t entry_count_;
 
-    mutable Entry entry_;
+    // The current entry, and its size including its preamble.
+    Entry entry_;
+    size_t entry_bytes_;
     Status iteration_status_;
   };
 
@@ -257,7 +304,10 @@ class PrefixedEntryRingBufferMulti {
       : buffer_(nullptr),
         buffer_bytes_(0),
         write_idx_(0),
-        user_preamble_(user_preamble) {}
+        user_preamble_(user_preamble),
+        reservation_active_(false),
+        reserved_user_preamble_(0),
+        reserved_size_bytes_(0) {}
 
   // Set the raw buffer to be used by the ring buffer.
   //
@@ -348,6 +398,40 @@ class PrefixedEntryRingBufferMulti {
     return TryPushBack(data, static_cast<uint32_t>(user_preamble_data));
   }
 
+  // Reserves space for an entry of up to `max_size_bytes` and returns a
+  // contiguous span within the ring buffer for the caller to write the entry's
+  // data into directly. The entry becomes visible to readers once CommitBack()
+  // is called. Like PushBack(), the oldest entries are discarded as needed to
+  // make space.
+  //
+  // Only one reservation may be outstanding at a time. No other entries may be
+  // pushed, and the buffer must not be deringed or iterated, until the
+  // reservation is committed or cancelled.
+  //
+  // Return values:
+  // OK - The returned span may be written to until CommitBack() or
+  // CancelBack() is called.
+  // FAILED_PRECONDITION - Buffer not initialized, or a reservation is already
+  // outstanding.
+  // OUT_OF_RANGE - The entry is larger than the buffer.
+  // UNAVAILABLE - The entry would wrap around the end of the buffer, so no
+  // contiguous span is available; use PushBack() instead.
+  Result<span<std::byte>> ReserveBack(size_t max_size_bytes,
+                                      uint32_t user_preamble_data = 0);
+
+  // Commits the first `size_bytes` of the reserved span as a new entry.
+  //
+  // Return values:
+  // OK - The entry was added to the ring buffer.
+  // FAILED_PRECONDITION - No reservation is outstanding.
+  // INVALID_ARGUMENT - `size_bytes` is larger than the reservation, which is
+  // left outstanding.
+  Status CommitBack(size_t size_bytes);
+
+  // Releases an outstanding reservation without adding an entry. Entries that
+  // were discarded to make space for the reservation are not restored.
+  void CancelBack() { reservation_active_ = false; }
+
   // Get the size in bytes of all the current entries in the ring buffer,
   // including preamble and data chunk.
   size_t TotalUsedBytes() const { return buffer_bytes_ - RawAvailableBytes(); }
@@ -394,6 +478,7 @@ class PrefixedEntryRingBufferMulti {
                                        size_t* bytes_read_out) const;
   Status InternalPeekFrontWithPreamble(const Reader& reader,
                                        ReadOutput output) const;
+  Result<EntrySegments> InternalPeekFrontInPlace(const Reader& reader) const;
 
   // Pop and discard the oldest stored data chunk of data from the ring buffer.
   //
@@ -406,6 +491,9 @@ class PrefixedEntryRingBufferMulti {
   // OUT_OF_RANGE - No entries in ring buffer to pop.
   Status InternalPopFront(Reader& reader);
 
+  // Pop and discard the `count` oldest entries, or none if there are fewer.
+  Status InternalPopMany(Reader& reader, size_t count);
+
   // Get the size in bytes of the next chunk, not including preamble, to be
   // read.
   size_t InternalFrontEntryDataSizeBytes(const Reader& reader) const;
@@ -438,6 +526,14 @@ class PrefixedEntryRingBufferMulti {
     size_t data_bytes;
   };
 
+  // Returns the number of preamble bytes needed for an entry with the given
+  // data size and user preamble.
+  size_t PreambleSizeBytes(size_t data_size_bytes,
+                           uint32_t user_preamble_data) const;
+
+  // Discards the oldest entries until `total_write_bytes` are available.
+  void MakeSpace(size_t total_write_bytes);
+
   // Push back implementation, which optionally discards front elements to fit
   // the incoming element.
   Status InternalPushBack(span<const std::byte> data,
@@ -475,6 +571,10 @@ class PrefixedEntryRingBufferMulti {
   // DATA_LOSS - Failed to read the metadata at this location.
   Result<EntryInfo> RawFrontEntryInfo(size_t source_idx) const;
 
+  // Decodes the varint at the given index, handling any wrap-around of the
+  // ring buffer. Returns the number of bytes decoded, or 0 if it is invalid.
+  size_t RawDecodeVarint(size_t source_idx, uint64_t* value) const;
+
   // Get the raw number of available bytes free in the ring buffer. This is
   // not available bytes for data, since there is a variable size preamble for
   // each entry.
@@ -500,6 +600,11 @@ class PrefixedEntryRingBufferMulti {
   size_t write_idx_;
   const bool user_preamble_;
 
+  // State of the outstanding ReserveBack() call, if any.
+  bool reservation_active_;
+  uint32_t reserved_user_preamble_;
+  size_t reserved_size_bytes_;
+
   // List of attached readers.
   IntrusiveList<Reader> readers_;
 
@@ -0,0 +1,22 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// The maximum number of packets StaticRouter::RoutePackets() groups by egress
+// at once. Larger batches are split into groups of this size, so an egress may
+// receive several bursts from one call. Each packet in a group takes a span and
+// a pointer of stack space.
+#ifndef PW_ROUTER_MAX_BURST_SIZE
+#define PW_ROUTER_MAX_BURST_SIZE 16
+#endif  // PW_ROUTER_MAX_BURST_SIZE
@@ -13,12 +13,14 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <optional>
 
 #include "pw_bytes/span.h"
 #include "pw_router/packet_parser.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 
 namespace pw::router {
 
@@ -34,6 +36,32 @@ class Egress {
   // TODO(frolv): Document possible return values.
   virtual Status SendPacket(ConstByteSpan packet,
                             const PacketParser& parser) = 0;
+
+  // Sends a burst of packets, in order, from a RoutePackets() call. Returns the
+  // number of packets sent, with OK if all were sent or the first error
+  // otherwise.
+  //
+  // The parser holds the last packet parsed, so the default implementation
+  // parses each packet again before passing it to SendPacket(). Egresses which
+  // can send several packets at once, or which do not use the parser, should
+  // override this.
+  virtual StatusWithSize SendPackets(span<const ConstByteSpan> packets,
+                                     PacketParser& parser) {
+    Status status;
+    size_t sent = 0;
+    for (ConstByteSpan packet : packets) {
+      if (!parser.Parse(packet)) {
+        status.Update(Status::DataLoss());
+        continue;
+      }
+      if (Status send_status = SendPacket(packet, parser); send_status.ok()) {
+        sent += 1;
+      } else {
+        status.Update(send_status);
+      }
+    }
+    return StatusWithSize(status, sent);
+  }
 };
 
 }  // namespace pw::router
@@ -13,12 +13,17 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "pw_bytes/span.h"
+#include "pw_containers/flat_map.h"
 #include "pw_metric/metric.h"
 #include "pw_router/egress.h"
 #include "pw_router/packet_parser.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 
 namespace pw::router {
 
@@ -39,6 +44,8 @@ class StaticRouter {
 
   StaticRouter(span<const Route> routes) : routes_(routes) {}
 
+  virtual ~StaticRouter() = default;
+
   StaticRouter(const StaticRouter&) = delete;
   StaticRouter(StaticRouter&&) = delete;
   StaticRouter& operator=(const StaticRouter&) = delete;
@@ -61,7 +68,20 @@ class StaticRouter {
   //
   Status RoutePacket(ConstByteSpan packet, PacketParser& parser);
 
+  // Routes a batch of packets, sending the packets for each egress together in
+  // one SendPackets() burst. Packets to the same egress are sent in order.
+  // Returns the number of packets sent, with OK if all were sent or the first
+  // error otherwise, using the same statuses as RoutePacket().
+  StatusWithSize RoutePackets(span<const ConstByteSpan> packets,
+                              PacketParser& parser);
+
  private:
+  // Returns the egress for an address, or nullptr if there is no route.
+  virtual Egress* FindEgress(uint32_t address) const;
+
+  // Parses a packet and looks up its egress.
+  Status FindRoute(ConstByteSpan packet, PacketParser& parser, Egress*& egress);
+
   const span<const Route> routes_;
   PW_METRIC_GROUP(metrics_, "static_router");
   PW_METRIC(metrics_, parser_errors_, "parser_errors", 0u);
@@ -69,4 +89,33 @@ class StaticRouter {
   PW_METRIC(metrics_, egress_errors_, "egress_errors", 0u);
 };
 
+// A StaticRouter which looks up routes in a FlatMap keyed by address instead
+// of searching them in order, for routers with many routes. FlatMap sorts its
+// entries when constructed, so a constexpr route map is indexed at compile
+// time:
+//
+//   constexpr containers::FlatMap<uint32_t, Egress*, 2> kRoutes({{
+//       {1, &radio_egress},
+//       {2, &uart_egress},
+//   }});
+//   IndexedStaticRouter router(kRoutes);
+//
+template <size_t kNumRoutes>
+class IndexedStaticRouter final : public StaticRouter {
+ public:
+  using RouteMap = containers::FlatMap<uint32_t, Egress*, kNumRoutes>;
+
+  explicit IndexedStaticRouter(
+      const containers::FlatMap<uint32_t, Egress*, kNumRoutes>& routes)
+      : StaticRouter(span<const Route>()), routes_(routes) {}
+
+ private:
+  Egress* FindEgress(uint32_t address) const final {
+    auto route = routes_.find(address);
+    return route == routes_.end() ? nullptr : route->second;
+  }
+
+  const RouteMap& routes_;
+};
+
 }  // namespace pw::router
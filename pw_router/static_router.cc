@@ -15,10 +15,83 @@
 #include "pw_router/static_router.h"
 
 #include <algorithm>
+#include <array>
+
+#include "pw_router/config.h"
 
 namespace pw::router {
 
 Status StaticRouter::RoutePacket(ConstByteSpan packet, PacketParser& parser) {
+  Egress* egress;
+  if (Status status = FindRoute(packet, parser, egress); !status.ok()) {
+    return status;
+  }
+
+  if (Status status = egress->SendPacket(packet, parser); !status.ok()) {
+    egress_errors_.Increment();
+    return Status::Unavailable();
+  }
+
+  return OkStatus();
+}
+
+StatusWithSize StaticRouter::RoutePackets(span<const ConstByteSpan> packets,
+                                          PacketParser& parser) {
+  Status status;
+  size_t sent = 0;
+
+  while (!packets.empty()) {
+    const span<const ConstByteSpan> group = packets.first(
+        std::min<size_t>(packets.size(), PW_ROUTER_MAX_BURST_SIZE));
+    packets = packets.subspan(group.size());
+
+    std::array<Egress*, PW_ROUTER_MAX_BURST_SIZE> egresses;
+    for (size_t i = 0; i < group.size(); ++i) {
+      status.Update(FindRoute(group[i], parser, egresses[i]));
+    }
+
+    // Send each egress's packets together, clearing them as they are taken.
+    std::array<ConstByteSpan, PW_ROUTER_MAX_BURST_SIZE> burst;
+    for (size_t i = 0; i < group.size(); ++i) {
+      Egress* const egress = egresses[i];
+      if (egress == nullptr) {
+        continue;
+      }
+
+      size_t burst_size = 0;
+      for (size_t j = i; j < group.size(); ++j) {
+        if (egresses[j] == egress) {
+          burst[burst_size++] = group[j];
+          egresses[j] = nullptr;
+        }
+      }
+
+      const StatusWithSize result =
+          egress->SendPackets(span(burst.data(), burst_size), parser);
+      sent += result.size();
+      if (!result.ok()) {
+        egress_errors_.Increment(
+            static_cast<uint32_t>(burst_size - result.size()));
+        status.Update(Status::Unavailable());
+      }
+    }
+  }
+
+  return StatusWithSize(status, sent);
+}
+
+Egress* StaticRouter::FindEgress(uint32_t address) const {
+  auto route = std::find_if(routes_.begin(), routes_.end(), [&](auto r) {
+    return r.address == address;
+  });
+  return route == routes_.end() ? nullptr : &route->egress;
+}
+
+Status StaticRouter::FindRoute(ConstByteSpan packet,
+                               PacketParser& parser,
+                               Egress*& egress) {
+  egress = nullptr;
+
   if (!parser.Parse(packet)) {
     parser_errors_.Increment();
     return Status::DataLoss();
@@ -30,19 +103,12 @@ Status StaticRouter::RoutePacket(ConstByteSpan packet, PacketParser& parser) {
     return Status::DataLoss();
   }
 
-  auto route = std::find_if(routes_.begin(), routes_.end(), [&](auto r) {
-    return r.address == *maybe_address;
-  });
-  if (route == routes_.end()) {
+  egress = FindEgress(*maybe_address);
+  if (egress == nullptr) {
     route_errors_.Increment();
     return Status::NotFound();
   }
 
-  if (Status status = route->egress.SendPacket(packet, parser); !status.ok()) {
-    egress_errors_.Increment();
-    return Status::Unavailable();
-  }
-
   return OkStatus();
 }
 
@@ -14,8 +14,11 @@
 
 #include "pw_router/static_router.h"
 
+#include <array>
+
 #include "gtest/gtest.h"
 #include "pw_assert/check.h"
+#include "pw_router/config.h"
 #include "pw_router/egress_function.h"
 
 namespace pw::router {
@@ -147,5 +150,154 @@ TEST(StaticRouter, RoutePacket_TracksNumberOfDrops) {
   EXPECT_EQ(router.dropped_packets(), 3u);
 }
 
+// Records the bursts it receives, failing packets with a payload of 0.
+class BurstEgress final : public Egress {
+ public:
+  Status SendPacket(ConstByteSpan, const PacketParser&) final {
+    return OkStatus();
+  }
+
+  StatusWithSize SendPackets(span<const ConstByteSpan> packets,
+                             PacketParser&) final {
+    bursts_ += 1;
+    size_t sent = 0;
+    for (ConstByteSpan packet : packets) {
+      const auto& basic_packet =
+          *reinterpret_cast<const BasicPacket*>(packet.data());
+      if (basic_packet.payload != 0u) {
+        payloads_[packets_++] = basic_packet.payload;
+        sent += 1;
+      }
+    }
+    return StatusWithSize(
+        sent == packets.size() ? OkStatus() : Status::ResourceExhausted(),
+        sent);
+  }
+
+  size_t bursts() const { return bursts_; }
+  span<const uint64_t> payloads() const {
+    return span(payloads_.data(), packets_);
+  }
+
+ private:
+  size_t bursts_ = 0;
+  size_t packets_ = 0;
+  std::array<uint64_t, 64> payloads_ = {};
+};
+
+TEST(StaticRouter, RoutePackets_GroupsPacketsByEgress) {
+  BasicPacketParser parser;
+  BurstEgress egress_1;
+  BurstEgress egress_2;
+  StaticRouter::Route routes[] = {{1, egress_1}, {2, egress_2}};
+  StaticRouter router(routes);
+
+  const BasicPacket packets[] = {{1, 10}, {2, 20}, {1, 11}, {2, 21}, {1, 12}};
+  const ConstByteSpan packet_data[] = {packets[0].data(),
+                                       packets[1].data(),
+                                       packets[2].data(),
+                                       packets[3].data(),
+                                       packets[4].data()};
+
+  const StatusWithSize result = router.RoutePackets(packet_data, parser);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 5u);
+
+  EXPECT_EQ(egress_1.bursts(), 1u);
+  ASSERT_EQ(egress_1.payloads().size(), 3u);
+  EXPECT_EQ(egress_1.payloads()[0], 10u);
+  EXPECT_EQ(egress_1.payloads()[1], 11u);
+  EXPECT_EQ(egress_1.payloads()[2], 12u);
+
+  EXPECT_EQ(egress_2.bursts(), 1u);
+  ASSERT_EQ(egress_2.payloads().size(), 2u);
+  EXPECT_EQ(egress_2.payloads()[0], 20u);
+  EXPECT_EQ(egress_2.payloads()[1], 21u);
+}
+
+TEST(StaticRouter, RoutePackets_SplitsLargeBatches) {
+  BasicPacketParser parser;
+  BurstEgress egress;
+  StaticRouter::Route routes[] = {{1, egress}};
+  StaticRouter router(routes);
+
+  constexpr size_t kPackets = PW_ROUTER_MAX_BURST_SIZE + 1;
+  const BasicPacket packet(1, 0xdddd);
+  std::array<ConstByteSpan, kPackets> packet_data;
+  packet_data.fill(packet.data());
+
+  const StatusWithSize result = router.RoutePackets(packet_data, parser);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), kPackets);
+  EXPECT_EQ(egress.bursts(), 2u);
+  EXPECT_EQ(egress.payloads().size(), kPackets);
+}
+
+TEST(StaticRouter, RoutePackets_TracksNumberOfDrops) {
+  BasicPacketParser parser;
+  BurstEgress egress;
+  StaticRouter::Route routes[] = {{1, egress}};
+  StaticRouter router(routes);
+
+  BasicPacket bad_magic(1, 0xdddd);
+  bad_magic.magic = 0x1badda7a;
+  const BasicPacket packets[] = {{1, 10}, {42, 20}, {1, 0}};
+  const ConstByteSpan packet_data[] = {packets[0].data(),
+                                       bad_magic.data(),
+                                       packets[1].data(),
+                                       packets[2].data()};
+
+  const StatusWithSize result = router.RoutePackets(packet_data, parser);
+  EXPECT_EQ(result.status(), Status::DataLoss());
+  EXPECT_EQ(result.size(), 1u);
+  EXPECT_EQ(router.dropped_packets(), 3u);
+}
+
+TEST(StaticRouter, RoutePackets_DefaultEgressSendsEachPacket) {
+  BasicPacketParser parser;
+  constexpr StaticRouter::Route routes[] = {{1, GoodEgress}, {2, BadEgress}};
+  StaticRouter router(routes);
+
+  const BasicPacket packets[] = {{1, 10}, {2, 20}, {1, 11}};
+  const ConstByteSpan packet_data[] = {
+      packets[0].data(), packets[1].data(), packets[2].data()};
+
+  const StatusWithSize result = router.RoutePackets(packet_data, parser);
+  EXPECT_EQ(result.status(), Status::Unavailable());
+  EXPECT_EQ(result.size(), 2u);
+  EXPECT_EQ(router.dropped_packets(), 1u);
+}
+
+constexpr containers::FlatMap<uint32_t, Egress*, 2> kIndexedRoutes({{
+    {2, &BadEgress},
+    {1, &GoodEgress},
+}});
+
+TEST(IndexedStaticRouter, RoutePacket_RoutesToAnEgress) {
+  BasicPacketParser parser;
+  IndexedStaticRouter router(kIndexedRoutes);
+
+  EXPECT_EQ(router.RoutePacket(BasicPacket(1, 0xdddd).data(), parser),
+            OkStatus());
+  EXPECT_EQ(router.RoutePacket(BasicPacket(2, 0xdddd).data(), parser),
+            Status::Unavailable());
+  EXPECT_EQ(router.RoutePacket(BasicPacket(42, 0xdddd).data(), parser),
+            Status::NotFound());
+  EXPECT_EQ(router.dropped_packets(), 2u);
+}
+
+TEST(IndexedStaticRouter, RoutePackets_RoutesToEgresses) {
+  BasicPacketParser parser;
+  IndexedStaticRouter router(kIndexedRoutes);
+
+  const BasicPacket packets[] = {{1, 10}, {42, 20}, {1, 11}};
+  const ConstByteSpan packet_data[] = {
+      packets[0].data(), packets[1].data(), packets[2].data()};
+
+  const StatusWithSize result = router.RoutePackets(packet_data, parser);
+  EXPECT_EQ(result.status(), Status::NotFound());
+  EXPECT_EQ(result.size(), 2u);
+}
+
 }  // namespace
 }  // namespace pw::router
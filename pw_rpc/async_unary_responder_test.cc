@@ -0,0 +1,116 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/async_unary_responder.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_async/fake_dispatcher_fixture.h"
+#include "pw_bytes/array.h"
+#include "pw_rpc/raw/fake_channel_output.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc_test_protos/test.raw_rpc.pb.h"
+
+namespace pw::rpc {
+namespace {
+
+using test::pw_rpc::raw::TestService;
+
+class TestServiceImpl final : public TestService::Service<TestServiceImpl> {
+ public:
+  static void TestUnaryRpc(ConstByteSpan, RawUnaryResponder&) {}
+  void TestAnotherUnaryRpc(ConstByteSpan, RawUnaryResponder&) {}
+  void TestServerStreamRpc(ConstByteSpan, RawServerWriter&) {}
+  void TestClientStreamRpc(RawServerReader&) {}
+  void TestBidirectionalStreamRpc(RawServerReaderWriter&) {}
+};
+
+constexpr auto kResponse = bytes::Array<0x0a, 0x0b>();
+
+class AsyncUnaryResponderTest : public async::test::FakeDispatcherFixture {
+ protected:
+  static constexpr uint32_t kChannelId = 1;
+
+  AsyncUnaryResponderTest()
+      : channel_(Channel::Create<kChannelId>(&output_)),
+        server_(span(&channel_, 1)),
+        responder_(dispatcher()) {
+    server_.RegisterService(service_);
+  }
+
+  RawUnaryResponder OpenCall() {
+    return RawUnaryResponder::Open<TestService::TestUnaryRpc>(
+        server_, kChannelId, service_);
+  }
+
+  RawFakeChannelOutput<4> output_;
+  Channel channel_;
+  Server server_;
+  TestServiceImpl service_;
+  AsyncUnaryResponder<RawUnaryResponder> responder_;
+};
+
+TEST_F(AsyncUnaryResponderTest, Resolve_FinishesCallOnDispatcher) {
+  ASSERT_EQ(OkStatus(), responder_.Defer(OpenCall()));
+  EXPECT_TRUE(responder_.pending());
+
+  responder_.Resolve([](RawUnaryResponder& call) {
+    EXPECT_EQ(OkStatus(), call.Finish(kResponse, Status::NotFound()));
+  });
+
+  // Nothing is sent until the dispatcher runs the completion.
+  EXPECT_EQ(0u, output_.total_packets());
+  EXPECT_TRUE(responder_.pending());
+
+  RunUntilIdle();
+
+  EXPECT_FALSE(responder_.pending());
+  ASSERT_EQ(1u, output_.total_packets());
+  EXPECT_EQ(Status::NotFound(), output_.last_status());
+
+  const auto& payloads = output_.payloads<TestService::TestUnaryRpc>();
+  ASSERT_EQ(1u, payloads.size());
+  ASSERT_EQ(kResponse.size(), payloads.back().size());
+  EXPECT_EQ(0,
+            std::memcmp(
+                kResponse.data(), payloads.back().data(), kResponse.size()));
+}
+
+TEST_F(AsyncUnaryResponderTest, Defer_WhilePending_FinishesNewCall) {
+  ASSERT_EQ(OkStatus(), responder_.Defer(OpenCall()));
+
+  EXPECT_EQ(Status::ResourceExhausted(), responder_.Defer(OpenCall()));
+  EXPECT_EQ(Status::ResourceExhausted(), output_.last_status());
+
+  // The first call is still deferred.
+  EXPECT_TRUE(responder_.pending());
+}
+
+TEST_F(AsyncUnaryResponderTest, Resolve_CanDeferAnotherCallAfterCompletion) {
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(OkStatus(), responder_.Defer(OpenCall()));
+    responder_.Resolve([](RawUnaryResponder& call) {
+      EXPECT_EQ(OkStatus(), call.Finish({}, OkStatus()));
+    });
+    RunUntilIdle();
+    EXPECT_FALSE(responder_.pending());
+  }
+
+  EXPECT_EQ(2u, output_.total_packets());
+}
+
+}  // namespace
+}  // namespace pw::rpc
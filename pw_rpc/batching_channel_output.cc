@@ -0,0 +1,74 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/batching_channel_output.h"
+
+#include <cstring>
+
+#include "pw_status/try.h"
+
+namespace pw::rpc::internal {
+
+void BatchingChannelOutputBase::Cork() {
+  RpcLockGuard lock;
+  corked_ = true;
+}
+
+Status BatchingChannelOutputBase::Uncork() {
+  RpcLockGuard lock;
+  corked_ = false;
+  return FlushLocked();
+}
+
+Status BatchingChannelOutputBase::Flush() {
+  RpcLockGuard lock;
+  return FlushLocked();
+}
+
+Status BatchingChannelOutputBase::Send(span<const std::byte> packet) {
+  if (!corked_) {
+    return output_.Send(packet);
+  }
+
+  // Send the buffered packets first if this one does not fit with them.
+  if (packet.size() > buffer_.size() - buffer_used_ ||
+      packet_count_ == packets_.size()) {
+    PW_TRY(FlushLocked());
+  }
+
+  if (packet.size() > buffer_.size()) {
+    return output_.Send(packet);
+  }
+
+  std::byte* const destination = buffer_.data() + buffer_used_;
+  std::memcpy(destination, packet.data(), packet.size());
+  packets_[packet_count_] = ConstByteSpan(destination, packet.size());
+
+  buffer_used_ += packet.size();
+  packet_count_ += 1;
+  return OkStatus();
+}
+
+Status BatchingChannelOutputBase::FlushLocked() {
+  if (packet_count_ == 0u) {
+    return OkStatus();
+  }
+
+  const Status status = output_.SendBatch(packets_.first(packet_count_));
+  buffer_used_ = 0;
+  packet_count_ = 0;
+  return status;
+}
+
+}  // namespace pw::rpc::internal
@@ -0,0 +1,214 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/batching_channel_output.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::rpc {
+namespace {
+
+// Records the packets sent to it and how many transport writes were made.
+class RecordingOutput : public ChannelOutput {
+ public:
+  RecordingOutput() : ChannelOutput("RecordingOutput") {}
+
+  Status Send(span<const std::byte> packet) override {
+    writes += 1;
+    Record(packet);
+    return send_status;
+  }
+
+  Status SendBatch(span<const ConstByteSpan> packets) override {
+    writes += 1;
+    batches += 1;
+    for (ConstByteSpan packet : packets) {
+      Record(packet);
+    }
+    return send_status;
+  }
+
+  bool PacketEquals(size_t index, ConstByteSpan expected) const {
+    return sizes[index] == expected.size() &&
+           std::memcmp(&data[offsets[index]], expected.data(), sizes[index]) ==
+               0;
+  }
+
+  size_t writes = 0;
+  size_t batches = 0;
+  size_t packet_count = 0;
+  Status send_status;
+
+ private:
+  void Record(ConstByteSpan packet) {
+    offsets[packet_count] = used;
+    sizes[packet_count] = packet.size();
+    std::memcpy(&data[used], packet.data(), packet.size());
+    used += packet.size();
+    packet_count += 1;
+  }
+
+  std::array<std::byte, 128> data{};
+  std::array<size_t, 16> offsets{};
+  std::array<size_t, 16> sizes{};
+  size_t used = 0;
+};
+
+Status SendPacket(ChannelOutput& output, ConstByteSpan packet) {
+  internal::RpcLockGuard lock;
+  return output.Send(packet);
+}
+
+constexpr auto kPacket1 = bytes::Array<0x01, 0x02, 0x03>();
+constexpr auto kPacket2 = bytes::Array<0x04, 0x05>();
+constexpr auto kPacket3 = bytes::Array<0x06, 0x07, 0x08, 0x09>();
+
+TEST(BatchingChannelOutput, Uncorked_SendsImmediately) {
+  RecordingOutput transport;
+  BatchingChannelOutput<16, 4> output(transport);
+
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket1));
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket2));
+
+  EXPECT_EQ(2u, transport.writes);
+  EXPECT_EQ(0u, transport.batches);
+  EXPECT_TRUE(transport.PacketEquals(0, kPacket1));
+  EXPECT_TRUE(transport.PacketEquals(1, kPacket2));
+}
+
+TEST(BatchingChannelOutput, Corked_SendsOneBatchOnUncork) {
+  RecordingOutput transport;
+  BatchingChannelOutput<16, 4> output(transport);
+
+  output.Cork();
+  EXPECT_TRUE(output.corked());
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket1));
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket2));
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket3));
+  EXPECT_EQ(0u, transport.writes);
+
+  EXPECT_EQ(OkStatus(), output.Uncork());
+  EXPECT_FALSE(output.corked());
+
+  EXPECT_EQ(1u, transport.writes);
+  ASSERT_EQ(3u, transport.packet_count);
+  EXPECT_TRUE(transport.PacketEquals(0, kPacket1));
+  EXPECT_TRUE(transport.PacketEquals(1, kPacket2));
+  EXPECT_TRUE(transport.PacketEquals(2, kPacket3));
+}
+
+TEST(BatchingChannelOutput, Flush_StaysCorked) {
+  RecordingOutput transport;
+  BatchingChannelOutput<16, 4> output(transport);
+
+  output.Cork();
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket1));
+  EXPECT_EQ(OkStatus(), output.Flush());
+  EXPECT_EQ(1u, transport.batches);
+
+  EXPECT_TRUE(output.corked());
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket2));
+  EXPECT_EQ(1u, transport.writes);
+
+  EXPECT_EQ(OkStatus(), output.Uncork());
+  EXPECT_EQ(2u, transport.writes);
+
+  // Flushing with nothing buffered does not write to the transport.
+  EXPECT_EQ(OkStatus(), output.Flush());
+  EXPECT_EQ(2u, transport.writes);
+}
+
+TEST(BatchingChannelOutput, Corked_FlushesWhenBufferIsFull) {
+  RecordingOutput transport;
+  BatchingChannelOutput<6, 4> output(transport);
+
+  output.Cork();
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket1));
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket2));
+  EXPECT_EQ(0u, transport.writes);
+
+  // kPacket3 does not fit in the remaining byte, so the others are sent first.
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket3));
+  EXPECT_EQ(1u, transport.writes);
+  EXPECT_EQ(2u, transport.packet_count);
+
+  EXPECT_EQ(OkStatus(), output.Uncork());
+  ASSERT_EQ(3u, transport.packet_count);
+  EXPECT_TRUE(transport.PacketEquals(2, kPacket3));
+}
+
+TEST(BatchingChannelOutput, Corked_FlushesAtMaxPackets) {
+  RecordingOutput transport;
+  BatchingChannelOutput<16, 2> output(transport);
+
+  output.Cork();
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket1));
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket2));
+  EXPECT_EQ(0u, transport.writes);
+
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket3));
+  EXPECT_EQ(1u, transport.writes);
+  EXPECT_EQ(2u, transport.packet_count);
+}
+
+TEST(BatchingChannelOutput, Corked_PacketLargerThanBufferIsSentDirectly) {
+  RecordingOutput transport;
+  BatchingChannelOutput<3, 4> output(transport);
+
+  output.Cork();
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket2));
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket3));
+
+  EXPECT_EQ(2u, transport.writes);
+  EXPECT_EQ(1u, transport.batches);
+  ASSERT_EQ(2u, transport.packet_count);
+  EXPECT_TRUE(transport.PacketEquals(0, kPacket2));
+  EXPECT_TRUE(transport.PacketEquals(1, kPacket3));
+}
+
+TEST(BatchingChannelOutput, Corked_ReturnsTransportError) {
+  RecordingOutput transport;
+  BatchingChannelOutput<16, 4> output(transport);
+  transport.send_status = Status::Unavailable();
+
+  output.Cork();
+  EXPECT_EQ(OkStatus(), SendPacket(output, kPacket1));
+  EXPECT_EQ(Status::Unavailable(), output.Uncork());
+}
+
+TEST(ChannelOutput, SendBatch_DefaultSendsEachPacket) {
+  class CountingOutput : public ChannelOutput {
+   public:
+    CountingOutput() : ChannelOutput("CountingOutput") {}
+    Status Send(span<const std::byte>) override {
+      sends += 1;
+      return sends == 2 ? Status::Unavailable() : OkStatus();
+    }
+    int sends = 0;
+  } output;
+
+  const ConstByteSpan packets[] = {kPacket1, kPacket2, kPacket3};
+
+  internal::RpcLockGuard lock;
+  EXPECT_EQ(Status::Unavailable(), output.SendBatch(packets));
+  EXPECT_EQ(2, output.sends);
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -14,6 +14,8 @@
 
 #include "pw_rpc/internal/call.h"
 
+#include <algorithm>
+
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
 #include "pw_preprocessor/util.h"
@@ -100,14 +102,14 @@ void Call::DestroyServerCall() {
   // Any errors are logged in Channel::Send.
   CloseAndSendResponseLocked(OkStatus()).IgnoreError();
   WaitForCallbacksToComplete();
-  state_ |= kHasBeenDestroyed;
+  set_state(state() | kHasBeenDestroyed);
 }
 
 void Call::DestroyClientCall() {
   RpcLockGuard lock;
   CloseClientCall();
   WaitForCallbacksToComplete();
-  state_ |= kHasBeenDestroyed;
+  set_state(state() | kHasBeenDestroyed);
 }
 
 void Call::WaitForCallbacksToComplete() {
@@ -140,10 +142,14 @@ void Call::MoveFrom(Call& other) {
   service_id_ = other.service_id_;
   method_id_ = other.method_id_;
 
-  state_ = other.state_;
+  set_state(other.state());
 
   // No need to move awaiting_cleanup_, since it is 0 in both calls here.
 
+#if PW_RPC_FLOW_CONTROL
+  credits_ = other.credits_;
+#endif  // PW_RPC_FLOW_CONTROL
+
   properties_ = other.properties_;
 
   // callbacks_executing_ is not moved since it is associated with the object in
@@ -152,10 +158,12 @@ void Call::MoveFrom(Call& other) {
   on_error_ = std::move(other.on_error_);
   on_next_ = std::move(other.on_next_);
 
-  // Mark the other call inactive, unregister it, and register this one.
+  // Unregister the other call and mark it inactive, then register this one.
+  // The other call is unregistered first so the endpoint can still find it by
+  // its IDs.
+  endpoint().UnregisterCall(other);
   other.MarkClosed();
 
-  endpoint().UnregisterCall(other);
   endpoint().RegisterUniqueCall(*this);
 }
 
@@ -198,7 +206,7 @@ bool Call::CleanUpIfRequired() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
   return true;
 }
 
-Status Call::SendPacket(PacketType type, ConstByteSpan payload, Status status) {
+Status Call::SendPacket(const Packet& packet) {
   if (!active_locked()) {
     encoding_buffer.ReleaseIfAllocated();
     return Status::FailedPrecondition();
@@ -209,7 +217,7 @@ Status Call::SendPacket(PacketType type, ConstByteSpan payload, Status status) {
     encoding_buffer.ReleaseIfAllocated();
     return Status::Unavailable();
   }
-  return channel->Send(MakePacket(type, payload, status));
+  return channel->Send(packet);
 }
 
 Status Call::CloseAndSendFinalPacketLocked(PacketType type,
@@ -221,11 +229,46 @@ Status Call::CloseAndSendFinalPacketLocked(PacketType type,
 }
 
 Status Call::WriteLocked(ConstByteSpan payload) {
-  return SendPacket(properties_.call_type() == kServerCall
-                        ? PacketType::SERVER_STREAM
-                        : PacketType::CLIENT_STREAM,
-                    payload);
+  if (properties_.call_type() == kClientCall) {
+    return SendPacket(PacketType::CLIENT_STREAM, payload);
+  }
+
+#if PW_RPC_FLOW_CONTROL
+  if (active_locked() && credits_ == 0u) {
+    encoding_buffer.ReleaseIfAllocated();
+    return Status::ResourceExhausted();
+  }
+#endif  // PW_RPC_FLOW_CONTROL
+
+  const Status status = SendPacket(PacketType::SERVER_STREAM, payload);
+
+#if PW_RPC_FLOW_CONTROL
+  if (status.ok() && credits_ != kUnlimitedCredits) {
+    credits_ -= 1;
+  }
+#endif  // PW_RPC_FLOW_CONTROL
+
+  return status;
+}
+
+Status Call::GrantCreditsLocked(uint32_t credits) {
+  Packet packet = MakePacket(PacketType::CLIENT_CREDIT, {});
+  packet.set_credits(credits);
+  return SendPacket(packet);
+}
+
+#if PW_RPC_FLOW_CONTROL
+bool Call::AddCredits(uint32_t credits) {
+  if (credits_ == kUnlimitedCredits) {
+    credits_ = std::min(credits, kUnlimitedCredits - 1);
+    return false;
+  }
+
+  const bool was_exhausted = credits_ == 0u;
+  credits_ += std::min(credits, kUnlimitedCredits - 1 - credits_);
+  return was_exhausted && credits_ != 0u;
 }
+#endif  // PW_RPC_FLOW_CONTROL
 
 // This definition is in the .cc file because the Endpoint class is not defined
 // in the Call header, due to circular dependencies between the two.
@@ -324,7 +367,7 @@ void Call::DebugLog() const PW_NO_LOCK_SAFETY_ANALYSIS {
       static_cast<unsigned>(channel_id_),
       static_cast<unsigned>(service_id_),
       static_cast<unsigned>(method_id_),
-      static_cast<int>(state_),
+      static_cast<int>(state_.load(std::memory_order_relaxed)),
       Status(static_cast<Status::Code>(awaiting_cleanup_)).str(),
       static_cast<int>(callbacks_executing_),
       static_cast<int>(properties_.method_type()),
@@ -0,0 +1,101 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/internal/config.h"
+
+#if PW_RPC_CALL_INDEX_SIZE > 0
+
+#include "pw_rpc/internal/call.h"
+#include "pw_rpc/internal/call_index.h"
+
+namespace pw::rpc::internal {
+
+char CallIndex::tombstone_;
+
+size_t CallIndex::Home(uint32_t channel_id,
+                       uint32_t service_id,
+                       uint32_t method_id,
+                       uint32_t call_id) {
+  // Service and method IDs are already hashes, but channel and call IDs are
+  // small sequential numbers, so mix everything together.
+  uint32_t hash = channel_id;
+  for (uint32_t id : {service_id, method_id, call_id}) {
+    hash = (hash ^ id) * 0x9e3779b1u;
+  }
+  return (hash ^ (hash >> 16)) & (kCapacity - 1);
+}
+
+bool CallIndex::Insert(Call& call) {
+  size_t slot = Home(
+      call.channel_id_locked(), call.service_id(), call.method_id(), call.id());
+
+  for (size_t i = 0; i < kCapacity; ++i) {
+    if (slots_[slot] == nullptr || slots_[slot] == Tombstone()) {
+      if (slots_[slot] == Tombstone()) {
+        tombstones_ -= 1;
+      }
+      slots_[slot] = &call;
+      return true;
+    }
+    slot = (slot + 1) & (kCapacity - 1);
+  }
+  return false;
+}
+
+bool CallIndex::Remove(const Call& call) {
+  size_t slot = Home(
+      call.channel_id_locked(), call.service_id(), call.method_id(), call.id());
+
+  for (size_t i = 0; i < kCapacity && slots_[slot] != nullptr; ++i) {
+    if (slots_[slot] == &call) {
+      slots_[slot] = Tombstone();
+      tombstones_ += 1;
+      return true;
+    }
+    slot = (slot + 1) & (kCapacity - 1);
+  }
+
+  // The call's IDs may have changed since it was added, e.g. when a call is
+  // closed, so check every slot before giving up.
+  for (Call*& entry : slots_) {
+    if (entry == &call) {
+      entry = Tombstone();
+      tombstones_ += 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+Call* CallIndex::Find(uint32_t channel_id,
+                      uint32_t service_id,
+                      uint32_t method_id,
+                      uint32_t call_id) const {
+  size_t slot = Home(channel_id, service_id, method_id, call_id);
+
+  for (size_t i = 0; i < kCapacity && slots_[slot] != nullptr; ++i) {
+    Call* call = slots_[slot];
+    if (call != Tombstone() && call->channel_id_locked() == channel_id &&
+        call->service_id() == service_id && call->method_id() == method_id &&
+        call->id() == call_id) {
+      return call;
+    }
+    slot = (slot + 1) & (kCapacity - 1);
+  }
+  return nullptr;
+}
+
+}  // namespace pw::rpc::internal
+
+#endif  // PW_RPC_CALL_INDEX_SIZE > 0
@@ -0,0 +1,153 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/call_pool.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+#include "pw_rpc/raw/fake_channel_output.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc_test_protos/test.raw_rpc.pb.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::rpc {
+namespace {
+
+using test::pw_rpc::raw::TestService;
+
+class TestServiceImpl final
+    : public TestService::Service<TestServiceImpl> {
+ public:
+  static void TestUnaryRpc(ConstByteSpan, RawUnaryResponder&) {}
+
+  void TestAnotherUnaryRpc(ConstByteSpan, RawUnaryResponder&) {}
+
+  void TestServerStreamRpc(ConstByteSpan, RawServerWriter&) {}
+
+  void TestClientStreamRpc(RawServerReader&) {}
+
+  void TestBidirectionalStreamRpc(RawServerReaderWriter&) {}
+};
+
+// Unrequested calls on the same channel and method replace each other, so
+// each call is opened on its own channel.
+class CallPoolTest : public ::testing::Test {
+ protected:
+  CallPoolTest()
+      : channels_{Channel::Create<1>(&output_),
+                  Channel::Create<2>(&output_),
+                  Channel::Create<3>(&output_)},
+        server_(channels_) {}
+
+  RawServerWriter OpenWriter(uint32_t channel_id) {
+    return RawServerWriter::Open<TestService::TestServerStreamRpc>(
+        server_, channel_id, service_);
+  }
+
+  RawFakeChannelOutput<8> output_;
+  std::array<Channel, 3> channels_;
+  Server server_;
+  TestServiceImpl service_;
+  CallPool<RawServerWriter, 2> pool_;
+};
+
+TEST_F(CallPoolTest, StoresCalls) {
+  RawServerWriter* first = pool_.Store(OpenWriter(1));
+  ASSERT_NE(first, nullptr);
+  EXPECT_TRUE(first->active());
+  EXPECT_EQ(first->channel_id(), 1u);
+
+  RawServerWriter* second = pool_.Store(OpenWriter(2));
+  ASSERT_NE(second, nullptr);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(pool_.active_count(), 2u);
+}
+
+TEST_F(CallPoolTest, ExhaustedWhenAllCallsActive) {
+  ASSERT_NE(pool_.Store(OpenWriter(1)), nullptr);
+  ASSERT_NE(pool_.Store(OpenWriter(2)), nullptr);
+
+  RawServerWriter writer = OpenWriter(3);
+  EXPECT_EQ(pool_.Store(std::move(writer)), nullptr);
+  EXPECT_TRUE(writer.active());  // Not moved from.
+  EXPECT_EQ(writer.Finish(Status::ResourceExhausted()), OkStatus());
+}
+
+TEST_F(CallPoolTest, ReusesSlotsOfFinishedCalls) {
+  RawServerWriter* first = pool_.Store(OpenWriter(1));
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(pool_.Store(OpenWriter(2)), nullptr);
+  ASSERT_EQ(first->Finish(), OkStatus());
+  EXPECT_EQ(pool_.active_count(), 1u);
+
+  RawServerWriter* third = pool_.Store(OpenWriter(3));
+  EXPECT_EQ(third, first);
+  EXPECT_TRUE(third->active());
+  EXPECT_EQ(third->channel_id(), 3u);
+}
+
+TEST_F(CallPoolTest, ForEachActive) {
+  ASSERT_NE(pool_.Store(OpenWriter(1)), nullptr);
+  RawServerWriter* second = pool_.Store(OpenWriter(2));
+  ASSERT_NE(second, nullptr);
+  ASSERT_EQ(second->Finish(), OkStatus());
+
+  int calls = 0;
+  pool_.ForEachActive([&calls](RawServerWriter& writer) {
+    EXPECT_EQ(writer.channel_id(), 1u);
+    calls += 1;
+  });
+  EXPECT_EQ(calls, 1);
+}
+
+// Metric names are tokenized with the top two bits masked off.
+constexpr uint32_t kMetricTokenMask = 0x3fffffff;
+constexpr metric::Token kStored =
+    PW_TOKENIZE_STRING_MASK("metrics", kMetricTokenMask, "stored");
+constexpr metric::Token kReused =
+    PW_TOKENIZE_STRING_MASK("metrics", kMetricTokenMask, "reused");
+constexpr metric::Token kExhausted =
+    PW_TOKENIZE_STRING_MASK("metrics", kMetricTokenMask, "exhausted");
+constexpr metric::Token kPeakActive =
+    PW_TOKENIZE_STRING_MASK("metrics", kMetricTokenMask, "peak_active");
+
+uint32_t MetricValue(const metric::Group& group, metric::Token name) {
+  for (const metric::Metric& metric : group.metrics()) {
+    if (metric.name() == name) {
+      return metric.as_int();
+    }
+  }
+  ADD_FAILURE();
+  return 0;
+}
+
+TEST_F(CallPoolTest, Metrics) {
+  RawServerWriter* first = pool_.Store(OpenWriter(1));
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(pool_.Store(OpenWriter(2)), nullptr);
+  EXPECT_EQ(pool_.Store(OpenWriter(3)), nullptr);
+  ASSERT_EQ(first->Finish(), OkStatus());
+  ASSERT_NE(pool_.Store(OpenWriter(3)), nullptr);
+
+  const metric::Group& metrics = pool_.metrics();
+  EXPECT_EQ(MetricValue(metrics, kStored), 3u);
+  EXPECT_EQ(MetricValue(metrics, kReused), 1u);
+  EXPECT_EQ(MetricValue(metrics, kExhausted), 1u);
+  EXPECT_EQ(MetricValue(metrics, kPeakActive), 2u);
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -53,8 +53,9 @@ static_assert(sizeof(Call) ==
                       sizeof(Endpoint*) +
                       // call_id, channel_id, service_id, method_id
                       4 * sizeof(uint32_t) +
-                      // Packed state and properties
-                      sizeof(void*) +
+                      // Packed state and properties, plus credits if enabled
+                      (PW_RPC_FLOW_CONTROL ? 2 * sizeof(uint32_t)
+                                           : sizeof(void*)) +
                       // on_error and on_next callbacks
                       2 * sizeof(Function<void(Status)>),
               "Unexpected padding in Call!");
@@ -98,6 +99,12 @@ TEST_F(ServerWriterTest, ConstructWithContext_StartsOpen) {
   EXPECT_TRUE(writer_.active());
 }
 
+TEST_F(ServerWriterTest, Active_DoesNotAcquireLock) {
+  RpcLockGuard lock;
+  EXPECT_TRUE(writer_.active());
+  EXPECT_TRUE(writer_.as_server_call().active_locked());
+}
+
 TEST_F(ServerWriterTest, Move_ClosesOriginal) {
   FakeServerWriter moved(std::move(writer_));
 
@@ -114,9 +121,9 @@ TEST_F(ServerWriterTest, DefaultConstruct_Closed) {
 
 TEST_F(ServerWriterTest, Construct_RegistersWithServer) {
   RpcLockGuard lock;
-  IntrusiveList<Call>::iterator call = context_.server().FindCall(kPacket);
-  ASSERT_NE(call, context_.server().calls_end());
-  EXPECT_EQ(static_cast<void*>(&*call), static_cast<void*>(&writer_));
+  Call* call = context_.server().FindCall(kPacket);
+  ASSERT_NE(call, nullptr);
+  EXPECT_EQ(static_cast<void*>(call), static_cast<void*>(&writer_));
 }
 
 TEST_F(ServerWriterTest, Destruct_RemovesFromServer) {
@@ -130,13 +137,42 @@ TEST_F(ServerWriterTest, Destruct_RemovesFromServer) {
   }
 
   RpcLockGuard lock;
-  EXPECT_EQ(context_.server().FindCall(kPacket), context_.server().calls_end());
+  EXPECT_EQ(context_.server().FindCall(kPacket), nullptr);
 }
 
 TEST_F(ServerWriterTest, Finish_RemovesFromServer) {
   EXPECT_EQ(OkStatus(), writer_.Finish());
   RpcLockGuard lock;
-  EXPECT_EQ(context_.server().FindCall(kPacket), context_.server().calls_end());
+  EXPECT_EQ(context_.server().FindCall(kPacket), nullptr);
+}
+
+TEST_F(ServerWriterTest, FindCall_MatchesCallId) {
+  std::array<FakeServerWriter, 4> writers;
+  for (uint32_t i = 0; i < writers.size(); ++i) {
+    rpc_lock().lock();
+    FakeServerWriter writer(context_.get(i + 1).ClaimLocked());
+    rpc_lock().unlock();
+    writers[i] = std::move(writer);
+  }
+
+  for (size_t i = 0; i < writers.size(); i += 2) {
+    EXPECT_EQ(OkStatus(), writers[i].Finish());
+  }
+
+  // The test output only holds a few packets, and the remaining writers send
+  // responses when they are destroyed.
+  context_.output().clear();
+
+  RpcLockGuard lock;
+  for (uint32_t i = 0; i < writers.size(); ++i) {
+    const Packet packet(pwpb::PacketType::CLIENT_STREAM, 99, 16, 8, i + 1);
+    Call* call = context_.server().FindCall(packet);
+    if (i % 2 == 0) {
+      EXPECT_EQ(call, nullptr);
+    } else {
+      EXPECT_EQ(static_cast<void*>(call), static_cast<void*>(&writers[i]));
+    }
+  }
 }
 
 TEST_F(ServerWriterTest, Finish_SendsResponse) {
@@ -23,6 +23,7 @@
 #include "pw_protobuf/decoder.h"
 #include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/encoding_buffer.h"
+#include "pw_status/try.h"
 
 namespace pw::rpc {
 
@@ -42,11 +43,35 @@ Result<uint32_t> ExtractChannelId(ConstByteSpan packet) {
   return Status::DataLoss();
 }
 
+Status ChannelOutput::SendBatch(span<const ConstByteSpan> packets) {
+  for (ConstByteSpan packet : packets) {
+    PW_TRY(Send(packet));
+  }
+  return OkStatus();
+}
+
 namespace internal {
 
 Status Channel::Send(const Packet& packet) {
+#if PW_RPC_ENCODING_BUFFER_POOL
+  Result<ByteSpan> allocated =
+      encoding_buffer.GetPacketBuffer(packet.payload().size());
+  if (!allocated.ok()) {
+    PW_LOG_WARN("Failed to allocate a buffer for RPC packet type %u, status %u",
+                static_cast<unsigned>(packet.type()),
+                allocated.status().code());
+    return allocated.status();
+  }
+  ByteSpan buffer = *allocated;
+#else
   ByteSpan buffer = encoding_buffer.GetPacketBuffer(packet.payload().size());
-  Result encoded = packet.Encode(buffer);
+#endif  // PW_RPC_ENCODING_BUFFER_POOL
+
+  // Payloads encoded directly into the encoding buffer are not copied; the
+  // rest of the packet is encoded in front of them.
+  Result encoded = packet.CanEncodeInPlace(buffer)
+                       ? packet.EncodeInPlace(buffer)
+                       : packet.Encode(buffer);
 
   if (!encoded.ok()) {
     encoding_buffer.Release();
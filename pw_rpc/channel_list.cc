@@ -14,26 +14,104 @@
 
 #include "pw_rpc/internal/channel_list.h"
 
+#include <utility>
+
 namespace pw::rpc::internal {
 
-const Channel* ChannelList::Get(uint32_t channel_id) const {
-  for (const Channel& channel : channels_) {
-    if (channel.id() == channel_id) {
-      return &channel;
+size_t ChannelList::FindSlot(uint32_t channel_id) const {
+  if (channel_id == Channel::kUnassignedChannelId) {
+    return channels_.size();
+  }
+
+  const size_t probed = ProbeSlot(channel_id);
+  if (probed != channels_.size()) {
+    return probed;
+  }
+
+  // Channels configured directly in the span may be anywhere.
+  for (size_t slot = 0; slot < channels_.size(); ++slot) {
+    if (channels_[slot].id() == channel_id) {
+      return slot;
     }
   }
+  return channels_.size();
+}
+
+size_t ChannelList::ProbeSlot(uint32_t channel_id) const {
+  if (channel_id == Channel::kUnassignedChannelId || channels_.size() == 0u) {
+    return channels_.size();
+  }
+
+  size_t slot = HomeSlot(channel_id);
+  for (size_t i = 0; i < channels_.size(); ++i) {
+    if (channels_[slot].id() == channel_id) {
+      return slot;
+    }
+    if (channels_[slot].id() == Channel::kUnassignedChannelId) {
+      break;
+    }
+    slot = NextSlot(slot);
+  }
+  return channels_.size();
+}
+
+Channel* ChannelList::FindUnassigned(uint32_t channel_id, size_t max_distance) {
+  if (channels_.size() == 0u) {
+    return nullptr;
+  }
+  size_t slot = HomeSlot(channel_id);
+  for (size_t i = 0; i <= max_distance && i < channels_.size(); ++i) {
+    if (channels_[slot].id() == Channel::kUnassignedChannelId) {
+      return &channels_[slot];
+    }
+    slot = NextSlot(slot);
+  }
   return nullptr;
 }
 
+void ChannelList::PlaceMisplacedChannels() {
+  size_t slot = 0;
+  while (slot < channels_.size()) {
+    const uint32_t channel_id = channels_[slot].id();
+    if (channel_id == Channel::kUnassignedChannelId ||
+        ProbeSlot(channel_id) != channels_.size()) {
+      slot += 1;
+      continue;
+    }
+
+    // A lookup stops at an unassigned slot before reaching this channel. Move
+    // the channel there and fill the slot it leaves. Filling the slot may move
+    // other channels, so start over; channels that are placed stay placed.
+    Channel* unassigned = FindUnassigned(channel_id, channels_.size());
+    std::swap(*unassigned, channels_[slot]);
+    CloseGap(slot);
+    slot = 0;
+  }
+}
+
+void ChannelList::CloseGap(size_t gap) {
+  for (size_t slot = NextSlot(gap);
+       channels_[slot].id() != Channel::kUnassignedChannelId;
+       slot = NextSlot(slot)) {
+    // Move the channel back if the gap is between its home slot and its slot.
+    const size_t home = HomeSlot(channels_[slot].id());
+    if (ProbeDistance(home, slot) >= ProbeDistance(gap, slot)) {
+      std::swap(channels_[gap], channels_[slot]);
+      gap = slot;
+    }
+  }
+}
+
 Status ChannelList::Add(uint32_t channel_id, ChannelOutput& output) {
-  if (Get(channel_id) != nullptr) {
+  PlaceMisplacedChannels();
+  if (ProbeSlot(channel_id) != channels_.size()) {
     return Status::AlreadyExists();
   }
 
 #if PW_RPC_DYNAMIC_ALLOCATION
-  channels_.emplace_back(channel_id, &output);
+  Insert(Channel(channel_id, &output));
 #else
-  Channel* new_channel = Get(Channel::kUnassignedChannelId);
+  Channel* new_channel = FindUnassigned(channel_id, channels_.size());
   if (new_channel == nullptr) {
     return Status::ResourceExhausted();
   }
@@ -45,20 +123,47 @@ Status ChannelList::Add(uint32_t channel_id, ChannelOutput& output) {
 }
 
 Status ChannelList::Remove(uint32_t channel_id) {
-  Channel* channel = Get(channel_id);
+  PlaceMisplacedChannels();
+  const size_t slot = ProbeSlot(channel_id);
 
-  if (channel == nullptr) {
+  if (slot == channels_.size()) {
     return Status::NotFound();
   }
-  channel->Close();
+  channels_[slot].Close();
+  CloseGap(slot);
+
+  return OkStatus();
+}
 
 #if PW_RPC_DYNAMIC_ALLOCATION
-  // Order isn't important, so move the channel to the back then pop it.
-  std::swap(*channel, channels_.back());
-  channels_.pop_back();
-#endif  // PW_RPC_DYNAMIC_ALLOCATION
 
-  return OkStatus();
+void ChannelList::Insert(const Channel& channel) {
+  Channel* slot = FindUnassigned(channel.id(), kMaxProbeDistance);
+  while (slot == nullptr) {
+    Grow();
+    slot = FindUnassigned(channel.id(), kMaxProbeDistance);
+  }
+  *slot = channel;
+}
+
+void ChannelList::Grow() {
+  PW_RPC_DYNAMIC_CONTAINER(Channel) old_channels;
+  std::swap(old_channels, channels_);
+
+  const size_t size = old_channels.size() < kMinTableSize
+                          ? kMinTableSize
+                          : 2 * old_channels.size();
+  for (size_t i = 0; i < size; ++i) {
+    channels_.emplace_back(Channel::Unassigned());
+  }
+
+  for (const Channel& channel : old_channels) {
+    if (channel.id() != Channel::kUnassignedChannelId) {
+      *FindUnassigned(channel.id(), channels_.size()) = channel;
+    }
+  }
 }
 
+#endif  // PW_RPC_DYNAMIC_ALLOCATION
+
 }  // namespace pw::rpc::internal
@@ -0,0 +1,194 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/internal/channel_list.h"
+
+#include <array>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::rpc::internal {
+namespace {
+
+class NullOutput : public ChannelOutput {
+ public:
+  constexpr NullOutput() : ChannelOutput("null") {}
+  Status Send(span<const std::byte>) override { return OkStatus(); }
+};
+
+constexpr size_t kSlots = 16;
+
+class ChannelListTest : public ::testing::Test {
+ protected:
+  ChannelListTest() : channels_(UnassignedChannels()), list_(channels_) {}
+
+  static std::array<Channel, kSlots> UnassignedChannels() {
+    return {
+        Channel::Unassigned(), Channel::Unassigned(), Channel::Unassigned(),
+        Channel::Unassigned(), Channel::Unassigned(), Channel::Unassigned(),
+        Channel::Unassigned(), Channel::Unassigned(), Channel::Unassigned(),
+        Channel::Unassigned(), Channel::Unassigned(), Channel::Unassigned(),
+        Channel::Unassigned(), Channel::Unassigned(), Channel::Unassigned(),
+        Channel::Unassigned(),
+    };
+  }
+
+  // Returns the ID of the channel found for channel_id, or 0 if none was.
+  uint32_t FoundId(uint32_t channel_id) {
+    const Channel* channel = list_.Get(channel_id);
+    return channel == nullptr ? Channel::kUnassignedChannelId : channel->id();
+  }
+
+  NullOutput output_;
+  std::array<Channel, kSlots> channels_;
+  ChannelList list_;
+};
+
+TEST_F(ChannelListTest, Get_UnassignedId_ReturnsNull) {
+  EXPECT_EQ(list_.Get(Channel::kUnassignedChannelId), nullptr);
+  ASSERT_EQ(list_.Add(1, output_), OkStatus());
+  EXPECT_EQ(list_.Get(Channel::kUnassignedChannelId), nullptr);
+}
+
+TEST_F(ChannelListTest, Add_SparseAndCollidingIds) {
+  // 1, 17, 33 and 49 share a home slot in a table of 16.
+  constexpr uint32_t kIds[] = {1, 17, 2, 33, 1000, 0xffffffff, 49, 16};
+  for (uint32_t id : kIds) {
+    ASSERT_EQ(list_.Add(id, output_), OkStatus());
+  }
+  for (uint32_t id : kIds) {
+    EXPECT_EQ(FoundId(id), id);
+  }
+  EXPECT_EQ(list_.Get(3), nullptr);
+  EXPECT_EQ(list_.Get(65), nullptr);
+}
+
+TEST_F(ChannelListTest, Add_Duplicate_AlreadyExists) {
+  ASSERT_EQ(list_.Add(5, output_), OkStatus());
+  EXPECT_EQ(list_.Add(5, output_), Status::AlreadyExists());
+}
+
+TEST_F(ChannelListTest, Remove_CollidingChannelsStillFound) {
+  ASSERT_EQ(list_.Add(1, output_), OkStatus());
+  ASSERT_EQ(list_.Add(17, output_), OkStatus());
+  ASSERT_EQ(list_.Add(2, output_), OkStatus());
+  ASSERT_EQ(list_.Add(33, output_), OkStatus());
+
+  ASSERT_EQ(list_.Remove(17), OkStatus());
+  EXPECT_EQ(list_.Get(17), nullptr);
+  EXPECT_EQ(FoundId(1), 1u);
+  EXPECT_EQ(FoundId(2), 2u);
+  EXPECT_EQ(FoundId(33), 33u);
+
+  ASSERT_EQ(list_.Remove(1), OkStatus());
+  EXPECT_EQ(FoundId(33), 33u);
+  EXPECT_EQ(list_.Remove(1), Status::NotFound());
+}
+
+#if !PW_RPC_DYNAMIC_ALLOCATION
+
+TEST_F(ChannelListTest, SequentialIdsUseTheirHomeSlots) {
+  for (uint32_t id = kSlots; id > 0; --id) {
+    ASSERT_EQ(list_.Add(id, output_), OkStatus());
+  }
+  for (size_t slot = 0; slot < kSlots; ++slot) {
+    EXPECT_EQ(channels_[slot].id(), slot + 1);
+  }
+}
+
+TEST_F(ChannelListTest, Remove_FreedSlotsAreReused) {
+  for (uint32_t id = 100; id < 100 + kSlots; ++id) {
+    ASSERT_EQ(list_.Add(id, output_), OkStatus());
+  }
+  EXPECT_EQ(list_.Add(200, output_), Status::ResourceExhausted());
+
+  ASSERT_EQ(list_.Remove(105), OkStatus());
+  ASSERT_EQ(list_.Add(200, output_), OkStatus());
+  EXPECT_EQ(FoundId(200), 200u);
+  EXPECT_EQ(list_.Get(105), nullptr);
+  EXPECT_EQ(list_.Add(105, output_), Status::ResourceExhausted());
+}
+
+TEST_F(ChannelListTest, Remove_ShiftsCollidingChannelsBack) {
+  ASSERT_EQ(list_.Add(1, output_), OkStatus());
+  ASSERT_EQ(list_.Add(17, output_), OkStatus());
+  ASSERT_EQ(list_.Add(33, output_), OkStatus());
+  ASSERT_EQ(channels_[2].id(), 33u);
+
+  ASSERT_EQ(list_.Remove(1), OkStatus());
+  EXPECT_EQ(channels_[0].id(), 17u);
+  EXPECT_EQ(channels_[1].id(), 33u);
+  EXPECT_EQ(channels_[2].id(), Channel::kUnassignedChannelId);
+}
+
+TEST_F(ChannelListTest, Get_ChannelConfiguredInSpan_IsFoundWithoutMoving) {
+  // Configure channels directly, away from their home slots.
+  channels_[7].Configure(1, output_);
+  channels_[9].Configure(2, output_);
+
+  const ChannelList& const_list = list_;
+  EXPECT_EQ(const_list.Get(1), &channels_[7]);
+  EXPECT_EQ(list_.Get(2), &channels_[9]);
+  EXPECT_EQ(channels_[0].id(), Channel::kUnassignedChannelId);
+  EXPECT_EQ(channels_[1].id(), Channel::kUnassignedChannelId);
+}
+
+TEST_F(ChannelListTest, Add_MovesChannelsConfiguredInSpan) {
+  channels_[7].Configure(1, output_);
+  channels_[9].Configure(2, output_);
+
+  EXPECT_EQ(list_.Add(2, output_), Status::AlreadyExists());
+  EXPECT_EQ(channels_[0].id(), 1u);
+  EXPECT_EQ(channels_[1].id(), 2u);
+  EXPECT_EQ(channels_[7].id(), Channel::kUnassignedChannelId);
+  EXPECT_EQ(channels_[9].id(), Channel::kUnassignedChannelId);
+  EXPECT_EQ(list_.Get(1), &channels_[0]);
+  EXPECT_EQ(list_.Get(2), &channels_[1]);
+}
+
+TEST_F(ChannelListTest, Remove_ChannelConfiguredInSpan) {
+  channels_[7].Configure(1, output_);
+  channels_[9].Configure(2, output_);
+
+  ASSERT_EQ(list_.Remove(1), OkStatus());
+  EXPECT_EQ(list_.Get(1), nullptr);
+  EXPECT_EQ(FoundId(2), 2u);
+  EXPECT_EQ(list_.Remove(1), Status::NotFound());
+}
+
+#else  // PW_RPC_DYNAMIC_ALLOCATION
+
+TEST_F(ChannelListTest, Add_GrowsTable) {
+  constexpr uint32_t kChannels = 300;
+  for (uint32_t id = 1; id <= kChannels; ++id) {
+    // Mix sequential IDs with IDs that collide.
+    ASSERT_EQ(list_.Add(id % 2 == 0 ? id : id * 1024, output_), OkStatus());
+  }
+  for (uint32_t id = 1; id <= kChannels; id += 2) {
+    ASSERT_EQ(list_.Remove(id * 1024), OkStatus());
+  }
+  for (uint32_t id = 1; id <= kChannels; ++id) {
+    if (id % 2 == 0) {
+      EXPECT_EQ(FoundId(id), id);
+    } else {
+      EXPECT_EQ(list_.Get(id * 1024), nullptr);
+    }
+  }
+}
+
+#endif  // !PW_RPC_DYNAMIC_ALLOCATION
+
+}  // namespace
+}  // namespace pw::rpc::internal
@@ -17,6 +17,7 @@
 #include <cstddef>
 
 #include "gtest/gtest.h"
+#include "pw_rpc/encoding_buffer_pool.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_rpc/internal/test_utils.h"
 
@@ -137,5 +138,67 @@ TEST(ExtractChannelId, InvalidPacket) {
   EXPECT_EQ(channel_id.status(), Status::DataLoss());
 }
 
+#if PW_RPC_ENCODING_BUFFER_POOL
+
+class EncodingBufferPool : public ::testing::Test {
+ protected:
+  class CountingOutput : public ChannelOutput {
+   public:
+    CountingOutput() : ChannelOutput("CountingOutput") {}
+
+    Status Send(span<const std::byte>) override {
+      sends += 1;
+      return OkStatus();
+    }
+
+    int sends = 0;
+  };
+
+  EncodingBufferPool() : channel_(1, &output_) { SetEncodingBufferPool(pool_); }
+
+  Status Send(const Packet& packet) {
+    RpcLockGuard lock;
+    return channel_.Send(packet);
+  }
+
+  // The pool must outlive the global encoding buffer, which keeps a pointer to
+  // the most recently set pool.
+  static allocator::FixedBytePool<64, 1> pool_;
+  CountingOutput output_;
+  Channel channel_;
+};
+
+allocator::FixedBytePool<64, 1> EncodingBufferPool::pool_;
+
+TEST_F(EncodingBufferPool, Send_ReturnsBlockToPool) {
+  EXPECT_EQ(OkStatus(), Send(kTestPacket));
+  EXPECT_EQ(OkStatus(), Send(kTestPacket));
+
+  EXPECT_EQ(2, output_.sends);
+  EXPECT_EQ(1u, pool_.available());
+}
+
+TEST_F(EncodingBufferPool, Send_PoolExhausted_ReturnsUnavailable) {
+  void* block = pool_.Allocate();
+  ASSERT_NE(nullptr, block);
+
+  EXPECT_EQ(Status::Unavailable(), Send(kTestPacket));
+  EXPECT_EQ(0, output_.sends);
+
+  pool_.Free(block);
+  EXPECT_EQ(OkStatus(), Send(kTestPacket));
+}
+
+TEST_F(EncodingBufferPool, Send_PacketTooLarge_ReturnsResourceExhausted) {
+  constexpr std::byte kPayload[64] = {};
+  const Packet packet(pwpb::PacketType::SERVER_STREAM, 1, 42, 100, 0, kPayload);
+
+  EXPECT_EQ(Status::ResourceExhausted(), Send(packet));
+  EXPECT_EQ(0, output_.sends);
+  EXPECT_EQ(1u, pool_.available());
+}
+
+#endif  // PW_RPC_ENCODING_BUFFER_POOL
+
 }  // namespace
 }  // namespace pw::rpc::internal
@@ -36,7 +36,7 @@ Status Client::ProcessPacket(ConstByteSpan data) {
 
   // Find an existing call for this RPC, if any.
   internal::rpc_lock().lock();
-  IntrusiveList<internal::Call>::iterator call = FindCall(packet);
+  internal::Call* call = FindCall(packet);
 
   internal::Channel* channel = GetInternalChannel(packet.channel_id());
 
@@ -46,7 +46,7 @@ Status Client::ProcessPacket(ConstByteSpan data) {
     return Status::Unavailable();
   }
 
-  if (call == calls_end()) {
+  if (call == nullptr) {
     // The call for the packet does not exist. If the packet is a server stream
     // message, notify the server so that it can kill the stream. Otherwise,
     // silently drop the packet (as it would terminate the RPC anyway).
@@ -89,6 +89,7 @@ Status Client::ProcessPacket(ConstByteSpan data) {
     case PacketType::CLIENT_STREAM:
     case PacketType::CLIENT_ERROR:
     case PacketType::CLIENT_REQUEST_COMPLETION:
+    case PacketType::CLIENT_CREDIT:
     default:
       internal::rpc_lock().unlock();
       PW_LOG_WARN("pw_rpc client unable to handle packet of type %u",
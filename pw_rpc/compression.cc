@@ -0,0 +1,224 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "pw_rpc/internal/config.h"
+
+namespace pw::rpc {
+namespace {
+
+// LZSS data is a series of groups of up to 8 items. Each group starts with a
+// flags byte; bit N (from the LSB) is set if item N is a match and clear if it
+// is a literal byte. A match is 2 bytes: a 12-bit offset back into the output
+// followed by a 4-bit length, less kMinMatch.
+constexpr size_t kItemsPerGroup = 8;
+constexpr size_t kMinMatch = 3;
+constexpr size_t kMaxMatch = kMinMatch + 0xf;
+constexpr size_t kMaxOffset = 0xfff;
+
+constexpr size_t kHashBits = cfg::kCompressionHashBits;
+
+struct Match {
+  size_t offset;
+  size_t length;
+};
+
+// Finds earlier occurrences of the data at each position by hashing the
+// kMinMatch bytes that start there. Only the most recent position with each
+// hash is checked, so finding a match takes constant time, at the cost of
+// missing matches whose hashes collide.
+class MatchFinder {
+ public:
+  constexpr MatchFinder(ConstByteSpan input) : input_(input), positions_{} {}
+
+  // Returns the match for the bytes at position and records position. Matches
+  // may overlap the current position, since they are decoded one byte at a
+  // time.
+  Match FindAndInsert(size_t position) {
+    if (input_.size() - position < kMinMatch) {
+      return {0, 0};
+    }
+    uint32_t& entry = positions_[Hash(position)];
+    const size_t candidate = entry;
+    entry = static_cast<uint32_t>(position + 1);
+
+    // Positions are stored plus one, so 0 means no position.
+    if (candidate == 0u || position + 1 - candidate > kMaxOffset) {
+      return {0, 0};
+    }
+
+    const size_t offset = position + 1 - candidate;
+    const size_t max_length = std::min(kMaxMatch, input_.size() - position);
+    size_t length = 0;
+    while (length < max_length &&
+           input_[position - offset + length] == input_[position + length]) {
+      length += 1;
+    }
+    return {offset, length};
+  }
+
+  // Records a position inside a match so later data can refer back to it.
+  void Insert(size_t position) {
+    if (input_.size() - position >= kMinMatch) {
+      positions_[Hash(position)] = static_cast<uint32_t>(position + 1);
+    }
+  }
+
+ private:
+  size_t Hash(size_t position) const {
+    const uint32_t sequence = static_cast<uint32_t>(input_[position]) |
+                              static_cast<uint32_t>(input_[position + 1]) << 8 |
+                              static_cast<uint32_t>(input_[position + 2]) << 16;
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+  }
+
+  ConstByteSpan input_;
+  std::array<uint32_t, size_t{1} << kHashBits> positions_;
+};
+
+}  // namespace
+
+StatusWithSize LzssCodec::Compress(ConstByteSpan input, ByteSpan output) {
+  MatchFinder finder(input);
+  size_t in = 0;
+  size_t out = 0;
+
+  while (in < input.size()) {
+    if (out == output.size()) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    const size_t flags_index = out++;
+    uint8_t flags = 0;
+
+    for (size_t item = 0; item < kItemsPerGroup && in < input.size(); ++item) {
+      const Match match = finder.FindAndInsert(in);
+
+      if (match.length >= kMinMatch) {
+        if (output.size() - out < 2) {
+          return StatusWithSize::ResourceExhausted();
+        }
+        output[out++] = static_cast<std::byte>(match.offset >> 4);
+        output[out++] = static_cast<std::byte>(((match.offset & 0xf) << 4) |
+                                               (match.length - kMinMatch));
+        flags |= static_cast<uint8_t>(1u << item);
+        for (size_t i = 1; i < match.length; ++i) {
+          finder.Insert(in + i);
+        }
+        in += match.length;
+      } else {
+        if (out == output.size()) {
+          return StatusWithSize::ResourceExhausted();
+        }
+        output[out++] = input[in++];
+      }
+    }
+
+    output[flags_index] = static_cast<std::byte>(flags);
+  }
+
+  return StatusWithSize(out);
+}
+
+StatusWithSize LzssCodec::Decompress(ConstByteSpan input, ByteSpan output) {
+  size_t in = 0;
+  size_t out = 0;
+
+  while (in < input.size()) {
+    const auto flags = static_cast<uint8_t>(input[in++]);
+
+    for (size_t item = 0; item < kItemsPerGroup && in < input.size(); ++item) {
+      if ((flags & (1u << item)) == 0u) {
+        if (out == output.size()) {
+          return StatusWithSize::ResourceExhausted();
+        }
+        output[out++] = input[in++];
+        continue;
+      }
+
+      if (input.size() - in < 2) {
+        return StatusWithSize::DataLoss();
+      }
+      const auto high = static_cast<size_t>(input[in]);
+      const auto low = static_cast<size_t>(input[in + 1]);
+      in += 2;
+
+      const size_t offset = (high << 4) | (low >> 4);
+      const size_t length = (low & 0xf) + kMinMatch;
+
+      if (offset == 0u || offset > out) {
+        return StatusWithSize::DataLoss();
+      }
+      if (output.size() - out < length) {
+        return StatusWithSize::ResourceExhausted();
+      }
+      for (size_t i = 0; i < length; ++i, ++out) {
+        output[out] = output[out - offset];
+      }
+    }
+  }
+
+  return StatusWithSize(out);
+}
+
+Result<ConstByteSpan> DecompressPacket(Codec& codec,
+                                       ConstByteSpan packet,
+                                       ByteSpan buffer) {
+  if (packet.empty() || packet[0] != kCompressedPacketMarker) {
+    return packet;
+  }
+  if (packet.size() < kCompressedPacketHeaderSize) {
+    return Status::DataLoss();
+  }
+  if (static_cast<uint8_t>(packet[1]) != codec.id()) {
+    return Status::Unimplemented();
+  }
+
+  const StatusWithSize result =
+      codec.Decompress(packet.subspan(kCompressedPacketHeaderSize), buffer);
+  if (!result.ok()) {
+    return result.status();
+  }
+  return ConstByteSpan(buffer.first(result.size()));
+}
+
+namespace internal {
+
+Status CompressingChannelOutputBase::Send(span<const std::byte> packet) {
+  // Only send compressed data if it is smaller than the original packet.
+  if (packet.size() > kCompressedPacketHeaderSize + 1) {
+    const size_t max_compressed_size =
+        std::min(buffer_.size(), packet.size() - 1) -
+        kCompressedPacketHeaderSize;
+    const StatusWithSize compressed = codec_.Compress(
+        packet,
+        buffer_.subspan(kCompressedPacketHeaderSize, max_compressed_size));
+
+    if (compressed.ok()) {
+      buffer_[0] = kCompressedPacketMarker;
+      buffer_[1] = static_cast<std::byte>(codec_.id());
+      return output_.Send(
+          buffer_.first(kCompressedPacketHeaderSize + compressed.size()));
+    }
+  }
+
+  return output_.Send(packet);
+}
+
+}  // namespace internal
+}  // namespace pw::rpc
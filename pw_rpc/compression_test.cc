@@ -0,0 +1,204 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/compression.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::rpc {
+namespace {
+
+// Records the most recent packet sent to it.
+class RecordingOutput : public ChannelOutput {
+ public:
+  RecordingOutput() : ChannelOutput("RecordingOutput") {}
+
+  Status Send(span<const std::byte> packet) override {
+    sends += 1;
+    std::memcpy(data.data(), packet.data(), packet.size());
+    last_packet = span(data).first(packet.size());
+    return OkStatus();
+  }
+
+  size_t sends = 0;
+  ConstByteSpan last_packet;
+
+ private:
+  std::array<std::byte, 256> data{};
+};
+
+Status SendPacket(ChannelOutput& output, ConstByteSpan packet) {
+  internal::RpcLockGuard lock;
+  return output.Send(packet);
+}
+
+bool Equal(ConstByteSpan lhs, ConstByteSpan rhs) {
+  return lhs.size() == rhs.size() &&
+         std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+// Repetitive data, like a payload with many zeroed or repeated fields.
+std::array<std::byte, 100> RepetitivePacket() {
+  std::array<std::byte, 100> packet{};
+  for (size_t i = 0; i < packet.size(); ++i) {
+    packet[i] = static_cast<std::byte>(0x08 + i % 5);
+  }
+  return packet;
+}
+
+constexpr auto kShortPacket = bytes::Array<0x08, 0x01, 0x10, 0x02>();
+
+TEST(LzssCodec, RoundTrip) {
+  LzssCodec codec;
+  const auto packet = RepetitivePacket();
+
+  std::array<std::byte, 128> compressed{};
+  StatusWithSize result = codec.Compress(packet, compressed);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_LT(result.size(), packet.size());
+
+  std::array<std::byte, 128> decompressed{};
+  result = codec.Decompress(span(compressed).first(result.size()),
+                            decompressed);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_TRUE(Equal(packet, span(decompressed).first(result.size())));
+}
+
+TEST(LzssCodec, RoundTrip_Incompressible) {
+  LzssCodec codec;
+  constexpr auto kData = bytes::Array<1, 2, 3, 4, 5, 6, 7, 8, 9, 10>();
+
+  std::array<std::byte, 16> compressed{};
+  StatusWithSize result = codec.Compress(kData, compressed);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_GT(result.size(), kData.size());
+
+  std::array<std::byte, 16> decompressed{};
+  result = codec.Decompress(span(compressed).first(result.size()),
+                            decompressed);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_TRUE(Equal(kData, span(decompressed).first(result.size())));
+}
+
+TEST(LzssCodec, Compress_OutputTooSmall) {
+  LzssCodec codec;
+  std::array<std::byte, 3> compressed{};
+  EXPECT_EQ(Status::ResourceExhausted(),
+            codec.Compress(kShortPacket, compressed).status());
+}
+
+TEST(LzssCodec, Decompress_OutputTooSmall) {
+  LzssCodec codec;
+  const auto packet = RepetitivePacket();
+
+  std::array<std::byte, 128> compressed{};
+  StatusWithSize result = codec.Compress(packet, compressed);
+  ASSERT_EQ(OkStatus(), result.status());
+
+  std::array<std::byte, 50> decompressed{};
+  EXPECT_EQ(Status::ResourceExhausted(),
+            codec
+                .Decompress(span(compressed).first(result.size()),
+                            decompressed)
+                .status());
+}
+
+TEST(LzssCodec, Decompress_Malformed) {
+  LzssCodec codec;
+  std::array<std::byte, 32> output{};
+
+  // A match that refers to data before the start of the output.
+  constexpr auto kBadOffset = bytes::Array<0x01, 0x00, 0x10>();
+  EXPECT_EQ(Status::DataLoss(), codec.Decompress(kBadOffset, output).status());
+
+  // A match that is missing its second byte.
+  constexpr auto kTruncated = bytes::Array<0x02, 0x41, 0x00>();
+  EXPECT_EQ(Status::DataLoss(), codec.Decompress(kTruncated, output).status());
+}
+
+TEST(DecompressPacket, UncompressedPacket_ReturnedAsIs) {
+  LzssCodec codec;
+  std::array<std::byte, 16> buffer{};
+
+  Result<ConstByteSpan> result = DecompressPacket(codec, kShortPacket, buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(result->data(), kShortPacket.data());
+  EXPECT_EQ(result->size(), kShortPacket.size());
+}
+
+TEST(DecompressPacket, DifferentCodec_Unimplemented) {
+  LzssCodec codec;
+  std::array<std::byte, 16> buffer{};
+  constexpr auto kPacket = bytes::Array<0x00, 0x7f, 0x00, 0x08>();
+
+  EXPECT_EQ(Status::Unimplemented(),
+            DecompressPacket(codec, kPacket, buffer).status());
+}
+
+TEST(DecompressPacket, TruncatedHeader_DataLoss) {
+  LzssCodec codec;
+  std::array<std::byte, 16> buffer{};
+  constexpr auto kPacket = bytes::Array<0x00>();
+
+  EXPECT_EQ(Status::DataLoss(),
+            DecompressPacket(codec, kPacket, buffer).status());
+}
+
+TEST(CompressingChannelOutput, CompressiblePacket_SentCompressed) {
+  RecordingOutput transport;
+  LzssCodec codec;
+  CompressingChannelOutput<128> output(transport, codec);
+  const auto packet = RepetitivePacket();
+
+  EXPECT_EQ(OkStatus(), SendPacket(output, packet));
+  ASSERT_EQ(1u, transport.sends);
+  ASSERT_LT(transport.last_packet.size(), packet.size());
+  EXPECT_EQ(kCompressedPacketMarker, transport.last_packet[0]);
+  EXPECT_EQ(LzssCodec::kId, static_cast<uint8_t>(transport.last_packet[1]));
+
+  std::array<std::byte, 128> buffer{};
+  Result<ConstByteSpan> result =
+      DecompressPacket(codec, transport.last_packet, buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_TRUE(Equal(packet, *result));
+}
+
+TEST(CompressingChannelOutput, IncompressiblePacket_SentAsIs) {
+  RecordingOutput transport;
+  LzssCodec codec;
+  CompressingChannelOutput<128> output(transport, codec);
+
+  EXPECT_EQ(OkStatus(), SendPacket(output, kShortPacket));
+  ASSERT_EQ(1u, transport.sends);
+  EXPECT_TRUE(Equal(kShortPacket, transport.last_packet));
+}
+
+TEST(CompressingChannelOutput, CompressedPacketTooLarge_SentAsIs) {
+  RecordingOutput transport;
+  LzssCodec codec;
+  CompressingChannelOutput<8> output(transport, codec);
+  const auto packet = RepetitivePacket();
+
+  EXPECT_EQ(OkStatus(), SendPacket(output, packet));
+  ASSERT_EQ(1u, transport.sends);
+  EXPECT_TRUE(Equal(packet, transport.last_packet));
+}
+
+}  // namespace
+}  // namespace pw::rpc
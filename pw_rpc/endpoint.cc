@@ -111,52 +111,110 @@ Result<Packet> Endpoint::ProcessPacket(span<const std::byte> data,
 
 void Endpoint::RegisterCall(Call& new_call) {
   // Mark any exisitng duplicate calls as cancelled.
-  auto [before_call, call] = FindIteratorsForCall(new_call);
-  if (call != calls_.end()) {
-    CloseCallAndMarkForCleanup(before_call, call, Status::Cancelled());
+  Call* existing_call = LookUpCall(new_call.channel_id_locked(),
+                                   new_call.service_id(),
+                                   new_call.method_id(),
+                                   new_call.id());
+  if (existing_call != nullptr) {
+    CloseCallAndMarkForCleanup(*existing_call, Status::Cancelled());
   }
 
   // Register the new call.
   calls_.push_front(new_call);
+  AddToIndex(new_call);
 }
 
-std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-Endpoint::FindIteratorsForCall(uint32_t channel_id,
-                               uint32_t service_id,
-                               uint32_t method_id,
-                               uint32_t call_id) {
-  auto previous = calls_.before_begin();
-  auto call = calls_.begin();
-
-  while (call != calls_.end()) {
-    if (channel_id == call->channel_id_locked() &&
-        service_id == call->service_id() && method_id == call->method_id()) {
-      if (call_id == call->id() || call_id == kOpenCallId) {
-        break;
-      }
-      if (call->id() == kOpenCallId) {
-        // Calls with ID of `kOpenCallId` were unrequested, and
-        // are updated to have the call ID of the first matching request.
-        call->set_id(call_id);
-        break;
-      }
+Call* Endpoint::LookUpCall(uint32_t channel_id,
+                           uint32_t service_id,
+                           uint32_t method_id,
+                           uint32_t call_id) {
+#if PW_RPC_CALL_INDEX_SIZE > 0
+  // The index and calls_ always match here, so clear out tombstones first.
+  if (call_index_.needs_rebuild()) {
+    RebuildIndex();
+  }
+
+  // Wildcard lookups cannot use the index, since it is keyed by call ID.
+  if (call_id != kOpenCallId) {
+    Call* call = call_index_.Find(channel_id, service_id, method_id, call_id);
+    if (call != nullptr) {
+      return call;
+    }
+
+    call = call_index_.Find(channel_id, service_id, method_id, kOpenCallId);
+    if (call != nullptr) {
+      RemoveFromIndex(*call);
+      call->set_id(call_id);
+      AddToIndex(*call);
+      return call;
+    }
+
+    if (unindexed_calls_ == 0u) {
+      return nullptr;
+    }
+  }
+#endif  // PW_RPC_CALL_INDEX_SIZE > 0
+
+  Call* call = SearchCalls(channel_id, service_id, method_id, call_id);
+  if (call != nullptr && call->id() == kOpenCallId) {
+    // Calls with ID of `kOpenCallId` were unrequested, and are updated to have
+    // the call ID of the first matching request.
+    RemoveFromIndex(*call);
+    call->set_id(call_id);
+    AddToIndex(*call);
+  }
+  return call;
+}
+
+Call* Endpoint::SearchCalls(uint32_t channel_id,
+                            uint32_t service_id,
+                            uint32_t method_id,
+                            uint32_t call_id) {
+  for (Call& call : calls_) {
+    if (channel_id == call.channel_id_locked() &&
+        service_id == call.service_id() && method_id == call.method_id() &&
+        (call_id == call.id() || call_id == kOpenCallId ||
+         call.id() == kOpenCallId)) {
+      return &call;
     }
-    previous = call;
-    ++call;
   }
+  return nullptr;
+}
+
+#if PW_RPC_CALL_INDEX_SIZE > 0
+
+void Endpoint::AddToIndex(Call& call) {
+  if (!call_index_.Insert(call)) {
+    unindexed_calls_ += 1;
+  }
+}
+
+void Endpoint::RemoveFromIndex(const Call& call) {
+  if (!call_index_.Remove(call)) {
+    PW_DASSERT(unindexed_calls_ > 0u);
+    unindexed_calls_ -= 1;
+  }
+}
 
-  return {previous, call};
+void Endpoint::RebuildIndex() {
+  call_index_.Clear();
+  unindexed_calls_ = 0;
+  for (Call& call : calls_) {
+    if (!call_index_.Insert(call)) {
+      unindexed_calls_ += 1;
+    }
+  }
 }
 
+#endif  // PW_RPC_CALL_INDEX_SIZE > 0
+
 Status Endpoint::CloseChannel(uint32_t channel_id) {
   rpc_lock().lock();
 
-  Channel* channel = channels_.Get(channel_id);
-  if (channel == nullptr) {
+  if (!channels_.Remove(channel_id).ok()) {
     rpc_lock().unlock();
     return Status::NotFound();
   }
-  channel->Close();
 
   // Close pending calls on the channel that's going away.
   AbortCalls(AbortIdType::kChannel, channel_id);
@@ -219,6 +277,11 @@ void Endpoint::RemoveAllCalls() {
     to_cleanup_.front().CloseFromDeletedEndpoint();
     to_cleanup_.pop_front();
   }
+
+#if PW_RPC_CALL_INDEX_SIZE > 0
+  call_index_.Clear();
+  unindexed_calls_ = 0;
+#endif  // PW_RPC_CALL_INDEX_SIZE > 0
 }
 
 }  // namespace pw::rpc::internal
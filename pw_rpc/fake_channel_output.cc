@@ -80,6 +80,7 @@ Status FakeChannelOutput::HandlePacket(span<const std::byte> buffer) {
       return OkStatus();
     case pwpb::PacketType::SERVER_STREAM:
     case pwpb::PacketType::CLIENT_REQUEST_COMPLETION:
+    case pwpb::PacketType::CLIENT_CREDIT:
       return OkStatus();
   }
   PW_CRASH("Unhandled PacketType %d", static_cast<int>(result.value().type()));
@@ -25,6 +25,7 @@
 #include "pw_result/result.h"
 #include "pw_rpc/internal/client_call.h"
 #include "pw_rpc/internal/encoding_buffer.h"
+#include "pw_rpc/nanopb/bytes_view.h"
 #include "pw_rpc/nanopb/server_reader_writer.h"
 #include "pw_status/try.h"
 
@@ -137,3 +138,29 @@ Status SendFinalResponse(NanopbServerCall& call,
 }
 
 }  // namespace pw::rpc::internal
+
+extern "C" bool pw_rpc_nanopb_BytesViewCallback(pb_istream_t* istream,
+                                                pb_ostream_t* ostream,
+                                                const pb_field_iter_t* field) {
+  const pb_type_t ltype = PB_LTYPE(field->type);
+  if ((ltype != PB_LTYPE_BYTES && ltype != PB_LTYPE_STRING) ||
+      PB_HTYPE(field->type) == PB_HTYPE_REPEATED) {
+    return false;
+  }
+  auto& view = *static_cast<pw_rpc_nanopb_BytesView*>(field->pData);
+
+  if (istream != nullptr) {
+    // The callback receives a substream limited to the field's data. Buffer
+    // streams point to their current position, so refer to the data there and
+    // skip over it without copying.
+    view.data = static_cast<const pb_byte_t*>(istream->state);
+    view.size = istream->bytes_left;
+    return pb_read(istream, nullptr, istream->bytes_left);
+  }
+
+  if (ostream != nullptr && view.size != 0u) {
+    return pb_encode_tag_for_field(ostream, field) &&
+           pb_encode_string(ostream, view.data, view.size);
+  }
+  return true;
+}
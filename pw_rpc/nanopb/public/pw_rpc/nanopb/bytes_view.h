@@ -0,0 +1,71 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <stddef.h>
+
+#include "pb.h"
+
+#ifdef __cplusplus
+
+#include "pw_bytes/span.h"
+
+extern "C" {
+#endif  // __cplusplus
+
+// A bytes or string field that refers to its data in the encoded message
+// instead of copying it into the struct. This avoids copying large payloads,
+// such as data to write to flash, into fixed-size arrays in request structs.
+//
+// To use views for the bytes fields of a message, set these Nanopb options:
+//
+//   my/pkg/write.proto include:"pw_rpc/nanopb/bytes_view.h"
+//   my.pkg.WriteRequest callback_function:"pw_rpc_nanopb_BytesViewCallback"
+//   my.pkg.WriteRequest.data type:FT_CALLBACK
+//   my.pkg.WriteRequest.data callback_datatype:"pw_rpc_nanopb_BytesView"
+//
+// When decoding, the view refers to the buffer that was decoded, so it is only
+// valid while that buffer is. For RPC requests, that is for the duration of
+// the handler call. When encoding, the view's data is written to the message.
+//
+// Every callback field in the message must be a non-repeated bytes or string
+// field that uses this type. Requires Nanopb 0.4 or newer.
+typedef struct {
+  const pb_byte_t* data;
+  size_t size;
+} pw_rpc_nanopb_BytesView;
+
+// Nanopb field callback that decodes and encodes pw_rpc_nanopb_BytesView
+// fields. Decoding only works with streams from pb_istream_from_buffer, which
+// pw_rpc always uses.
+bool pw_rpc_nanopb_BytesViewCallback(pb_istream_t* istream,
+                                     pb_ostream_t* ostream,
+                                     const pb_field_iter_t* field);
+
+#ifdef __cplusplus
+}  // extern "C"
+
+namespace pw::rpc {
+
+inline ConstByteSpan AsByteSpan(const pw_rpc_nanopb_BytesView& view) {
+  return as_bytes(span(view.data, view.size));
+}
+
+inline pw_rpc_nanopb_BytesView AsBytesView(ConstByteSpan bytes) {
+  return {reinterpret_cast<const pb_byte_t*>(bytes.data()), bytes.size()};
+}
+
+}  // namespace pw::rpc
+
+#endif  // __cplusplus
@@ -198,6 +198,7 @@ class NanopbServerReaderWriter
   using internal::Call::set_on_error;
   using internal::ServerCall::set_on_completion_requested;
   using internal::ServerCall::set_on_completion_requested_if_enabled;
+  using internal::ServerCall::set_on_credits_available;
   using internal::BaseNanopbServerReader<Request>::set_on_next;
 
  private:
@@ -330,6 +331,7 @@ class NanopbServerWriter : private internal::NanopbServerCall {
   using internal::Call::set_on_error;
   using internal::ServerCall::set_on_completion_requested;
   using internal::ServerCall::set_on_completion_requested_if_enabled;
+  using internal::ServerCall::set_on_credits_available;
 
  private:
   friend class internal::NanopbMethod;
@@ -13,6 +13,9 @@
 // the License.
 
 #include "gtest/gtest.h"
+#include "pb_decode.h"
+#include "pb_encode.h"
+#include "pw_rpc/nanopb/bytes_view.h"
 #include "pw_rpc/nanopb/internal/common.h"
 #include "pw_rpc_test_protos/test.pb.h"
 
@@ -53,5 +56,64 @@ TEST(NanopbSerde, Decode) {
   EXPECT_EQ(0u, proto.status_code);
 }
 
+// Describes an optional bytes field 2 stored as a pw_rpc_nanopb_BytesView.
+pb_field_iter_t BytesViewField(pw_rpc_nanopb_BytesView& view) {
+  pb_field_iter_t field = {};
+  field.tag = 2;
+  field.type = PB_ATYPE_CALLBACK | PB_HTYPE_OPTIONAL | PB_LTYPE_BYTES;
+  field.data_size = sizeof(view);
+  field.pData = &view;
+  return field;
+}
+
+TEST(NanopbBytesView, Decode_RefersToBuffer) {
+  constexpr std::byte kData[]{std::byte{1}, std::byte{2}, std::byte{3}};
+  pw_rpc_nanopb_BytesView view = {};
+  const pb_field_iter_t field = BytesViewField(view);
+  pb_istream_t input = pb_istream_from_buffer(
+      reinterpret_cast<const pb_byte_t*>(kData), sizeof(kData));
+
+  ASSERT_TRUE(pw_rpc_nanopb_BytesViewCallback(&input, nullptr, &field));
+  EXPECT_EQ(AsByteSpan(view).data(), kData);
+  EXPECT_EQ(AsByteSpan(view).size(), sizeof(kData));
+  EXPECT_EQ(input.bytes_left, 0u);
+}
+
+TEST(NanopbBytesView, Encode) {
+  constexpr std::byte kData[]{std::byte{1}, std::byte{2}, std::byte{3}};
+  pw_rpc_nanopb_BytesView view = AsBytesView(kData);
+  const pb_field_iter_t field = BytesViewField(view);
+  std::byte buffer[8] = {};
+  pb_ostream_t output = pb_ostream_from_buffer(
+      reinterpret_cast<pb_byte_t*>(buffer), sizeof(buffer));
+
+  ASSERT_TRUE(pw_rpc_nanopb_BytesViewCallback(nullptr, &output, &field));
+  ASSERT_EQ(output.bytes_written, 5u);
+  EXPECT_EQ(buffer[0], std::byte{2 << 3 | PB_WT_STRING});
+  EXPECT_EQ(buffer[1], std::byte{3});
+  EXPECT_EQ(buffer[2], std::byte{1});
+  EXPECT_EQ(buffer[4], std::byte{3});
+}
+
+TEST(NanopbBytesView, Encode_EmptyIsOmitted) {
+  pw_rpc_nanopb_BytesView view = {};
+  const pb_field_iter_t field = BytesViewField(view);
+  std::byte buffer[8] = {};
+  pb_ostream_t output = pb_ostream_from_buffer(
+      reinterpret_cast<pb_byte_t*>(buffer), sizeof(buffer));
+
+  ASSERT_TRUE(pw_rpc_nanopb_BytesViewCallback(nullptr, &output, &field));
+  EXPECT_EQ(output.bytes_written, 0u);
+}
+
+TEST(NanopbBytesView, RepeatedFieldIsRejected) {
+  pw_rpc_nanopb_BytesView view = {};
+  pb_field_iter_t field = BytesViewField(view);
+  field.type = PB_ATYPE_CALLBACK | PB_HTYPE_REPEATED | PB_LTYPE_BYTES;
+  pb_istream_t input = pb_istream_from_buffer(nullptr, 0);
+
+  EXPECT_FALSE(pw_rpc_nanopb_BytesViewCallback(&input, nullptr, &field));
+}
+
 }  // namespace
 }  // namespace pw::rpc::internal
@@ -14,8 +14,13 @@
 
 #include "pw_rpc/internal/packet.h"
 
+#include <array>
+#include <cstring>
+
 #include "pw_log/log.h"
 #include "pw_protobuf/decoder.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_varint/varint.h"
 
 namespace pw::rpc::internal {
 
@@ -73,6 +78,11 @@ Result<Packet> Packet::FromBuffer(ConstByteSpan data) {
         // A decode error will propagate from Next() and terminate the loop.
         decoder.ReadUint32(&packet.call_id_).IgnoreError();
         break;
+
+      case RpcPacket::Fields::kCredits:
+        // A decode error will propagate from Next() and terminate the loop.
+        decoder.ReadUint32(&packet.credits_).IgnoreError();
+        break;
     }
   }
 
@@ -106,12 +116,61 @@ Result<ConstByteSpan> Packet::Encode(ByteSpan buffer) const {
     rpc_packet.WriteCallId(call_id_).IgnoreError();
   }
 
+  if (credits_ != 0) {
+    rpc_packet.WriteCredits(credits_).IgnoreError();
+  }
+
   if (rpc_packet.status().ok()) {
     return ConstByteSpan(rpc_packet);
   }
   return rpc_packet.status();
 }
 
+Result<ConstByteSpan> Packet::EncodeInPlace(ByteSpan buffer) const {
+  if (!CanEncodeInPlace(buffer)) {
+    return Status::FailedPrecondition();
+  }
+
+  // Encode the fields other than the payload into a separate buffer, since
+  // their size isn't known until they are encoded.
+  std::array<std::byte, kMinEncodedSizeWithoutPayload> header;
+  RpcPacket::MemoryEncoder rpc_packet(header);
+
+  rpc_packet.WriteType(type_).IgnoreError();
+  rpc_packet.WriteChannelId(channel_id_).IgnoreError();
+  rpc_packet.WriteServiceId(service_id_).IgnoreError();
+  rpc_packet.WriteMethodId(method_id_).IgnoreError();
+
+  // As in Encode(), skip the status and call ID if they are zero.
+  if (status_.code() != 0) {
+    rpc_packet.WriteStatus(status_.code()).IgnoreError();
+  }
+
+  if (call_id_ != 0) {
+    rpc_packet.WriteCallId(call_id_).IgnoreError();
+  }
+
+  PW_TRY(rpc_packet.status());
+
+  // The payload field is written last, so that its key and length prefix end
+  // immediately before the payload.
+  size_t header_size = rpc_packet.size();
+  header_size += varint::Encode(
+      static_cast<uint32_t>(protobuf::FieldKey(
+          static_cast<uint32_t>(RpcPacket::Fields::kPayload),
+          protobuf::WireType::kDelimited)),
+      span(header).subspan(header_size));
+  header_size +=
+      varint::Encode(payload_.size(), span(header).subspan(header_size));
+
+  // CanEncodeInPlace() checked that the payload is in the buffer, so this
+  // recovers a mutable pointer to it.
+  std::byte* const payload = buffer.data() + (payload_.data() - buffer.data());
+  std::byte* const start = payload - header_size;
+  std::memcpy(start, header.data(), header_size);
+  return ConstByteSpan(start, header_size + payload_.size());
+}
+
 size_t Packet::MinEncodedSizeBytes() const {
   size_t reserved_size = 0;
 
@@ -149,6 +149,45 @@ TEST(Packet, EncodeDecode) {
   EXPECT_EQ(decoded.status(), Status::Unavailable());
 }
 
+TEST(Packet, EncodeInPlace_PayloadIsNotMoved) {
+  byte buffer[128] = {};
+  ByteSpan payload =
+      span(buffer).subspan(Packet::kMinEncodedSizeWithoutPayload, 4);
+  std::memcpy(payload.data(), kPayload.data(), kPayload.size());
+
+  Packet packet(PacketType::RESPONSE, 1, 42, 100, 7, payload);
+  ASSERT_TRUE(packet.CanEncodeInPlace(buffer));
+
+  Result result = packet.EncodeInPlace(buffer);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(result.value().data() + result.value().size(),
+            payload.data() + payload.size());
+
+  auto decode_result = Packet::FromBuffer(result.value());
+  ASSERT_TRUE(decode_result.ok());
+
+  auto& decoded = decode_result.value();
+  EXPECT_EQ(PacketType::RESPONSE, decoded.type());
+  EXPECT_EQ(1u, decoded.channel_id());
+  EXPECT_EQ(42u, decoded.service_id());
+  EXPECT_EQ(100u, decoded.method_id());
+  EXPECT_EQ(7u, decoded.call_id());
+  EXPECT_EQ(decoded.payload().data(), payload.data());
+  ASSERT_EQ(kPayload.size(), decoded.payload().size());
+  EXPECT_EQ(
+      0,
+      std::memcmp(decoded.payload().data(), kPayload.data(), kPayload.size()));
+}
+
+TEST(Packet, EncodeInPlace_PayloadOutsideBuffer) {
+  byte buffer[128];
+  Packet packet(PacketType::RESPONSE, 1, 42, 100, 7, kPayload);
+
+  EXPECT_FALSE(packet.CanEncodeInPlace(buffer));
+  EXPECT_EQ(Status::FailedPrecondition(),
+            packet.EncodeInPlace(buffer).status());
+}
+
 constexpr size_t kReservedSize = 2 /* type */ + 2 /* channel */ +
                                  5 /* service */ + 5 /* method */ +
                                  2 /* payload key */ + 2 /* status */;
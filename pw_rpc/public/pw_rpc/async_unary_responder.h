@@ -0,0 +1,105 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <utility>
+
+#include "pw_async/dispatcher.h"
+#include "pw_async/task.h"
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+/// Finishes a deferred unary RPC on a `pw::async::Dispatcher`.
+///
+/// A unary handler hands its responder to `Defer()` and returns immediately,
+/// without blocking a thread while it waits for I/O. When the I/O completes,
+/// the completion handler calls `Resolve()` with a function that finishes the
+/// call. That function runs on the dispatcher's thread, so the handler, the I/O
+/// completion, and the response never need a thread of their own.
+///
+/// `Responder` is the unary responder type for the method, e.g.
+/// `RawUnaryResponder` or `PwpbUnaryResponder<Response>`. Each
+/// `AsyncUnaryResponder` holds one call at a time; `Defer()` and `Resolve()`
+/// are called once per call, in that order.
+///
+/// @code{.cpp}
+///   void BlobService::Read(ConstByteSpan request, RawUnaryResponder& call) {
+///     async_read_.Defer(std::move(call)).IgnoreError();
+///     storage_.StartRead(ParseOffset(request), buffer_, [this](Status s) {
+///       async_read_.Resolve([this, s](RawUnaryResponder& responder) {
+///         responder.Finish(buffer_, s).IgnoreError();
+///       });
+///     });
+///   }
+/// @endcode
+template <typename Responder>
+class AsyncUnaryResponder {
+ public:
+  /// Finishes the call with the deferred responder.
+  using Completion = Function<void(Responder&)>;
+
+  explicit AsyncUnaryResponder(async::Dispatcher& dispatcher)
+      : dispatcher_(dispatcher),
+        task_([this](async::Context&, Status status) { Complete(status); }) {}
+
+  AsyncUnaryResponder(const AsyncUnaryResponder&) = delete;
+  AsyncUnaryResponder& operator=(const AsyncUnaryResponder&) = delete;
+
+  ~AsyncUnaryResponder() { dispatcher_.Cancel(task_); }
+
+  /// Takes over a unary call so that it can be finished later.
+  ///
+  /// @returns `RESOURCE_EXHAUSTED` if another call is already deferred. The new
+  /// call is finished with that status.
+  Status Defer(Responder&& responder) {
+    if (responder_.active()) {
+      responder.Finish({}, Status::ResourceExhausted()).IgnoreError();
+      return Status::ResourceExhausted();
+    }
+    responder_ = std::move(responder);
+    return OkStatus();
+  }
+
+  /// Posts `completion` to the dispatcher, which invokes it with the deferred
+  /// responder. May be called from any thread that may post to the dispatcher.
+  ///
+  /// If the dispatcher cancels the task instead of running it, the call is
+  /// finished with `CANCELLED`.
+  void Resolve(Completion&& completion) {
+    completion_ = std::move(completion);
+    dispatcher_.Post(task_);
+  }
+
+  /// True if a call is deferred and has not been finished.
+  bool pending() const { return responder_.active(); }
+
+ private:
+  void Complete(Status status) {
+    Completion completion = std::move(completion_);
+    if (!status.ok()) {
+      responder_.Finish({}, Status::Cancelled()).IgnoreError();
+      return;
+    }
+    completion(responder_);
+  }
+
+  async::Dispatcher& dispatcher_;
+  async::Task task_;
+  Responder responder_;
+  Completion completion_;
+};
+
+}  // namespace pw::rpc
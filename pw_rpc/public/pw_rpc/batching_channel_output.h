@@ -0,0 +1,111 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+namespace internal {
+
+// Non-templated implementation of BatchingChannelOutput.
+class BatchingChannelOutputBase : public ChannelOutput {
+ public:
+  BatchingChannelOutputBase(const BatchingChannelOutputBase&) = delete;
+  BatchingChannelOutputBase& operator=(const BatchingChannelOutputBase&) =
+      delete;
+
+  // Starts buffering packets instead of sending them immediately.
+  void Cork() PW_LOCKS_EXCLUDED(rpc_lock());
+
+  // Sends any buffered packets and resumes sending packets immediately.
+  Status Uncork() PW_LOCKS_EXCLUDED(rpc_lock());
+
+  // Sends any buffered packets. The output remains corked if it was corked.
+  // Call this periodically (e.g. from a timer) to bound the latency of buffered
+  // packets.
+  Status Flush() PW_LOCKS_EXCLUDED(rpc_lock());
+
+  bool corked() const PW_LOCKS_EXCLUDED(rpc_lock()) {
+    RpcLockGuard lock;
+    return corked_;
+  }
+
+  size_t MaximumTransmissionUnit() override {
+    return output_.MaximumTransmissionUnit();
+  }
+
+  Status Send(span<const std::byte> packet) override
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+ protected:
+  BatchingChannelOutputBase(ChannelOutput& output,
+                            ByteSpan buffer,
+                            span<ConstByteSpan> packets)
+      : ChannelOutput(output.name()),
+        output_(output),
+        buffer_(buffer),
+        packets_(packets) {}
+
+  ~BatchingChannelOutputBase() override = default;
+
+ private:
+  Status FlushLocked() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  ChannelOutput& output_;
+  const ByteSpan buffer_;
+  const span<ConstByteSpan> packets_;
+
+  size_t buffer_used_ PW_GUARDED_BY(rpc_lock()) = 0;
+  size_t packet_count_ PW_GUARDED_BY(rpc_lock()) = 0;
+  bool corked_ PW_GUARDED_BY(rpc_lock()) = false;
+};
+
+}  // namespace internal
+
+// ChannelOutput that can coalesce bursts of packets into a single
+// ChannelOutput::SendBatch() call on another output. Use this with an output
+// that overrides SendBatch() to write several packets to its transport at once,
+// so that streaming many small messages does not pay the transport's
+// per-packet overhead for each one.
+//
+// While corked, packets are copied into a kBufferSizeBytes buffer. The buffered
+// packets are sent when Uncork() or Flush() is called, or when the next packet
+// does not fit in the buffer or would exceed kMaxPackets. Packets larger than
+// the buffer are sent directly, after any buffered packets. Buffered packets
+// are discarded if the output is destroyed.
+//
+// Cork(), Uncork(), and Flush() acquire the RPC lock, so they must not be
+// called from within a ChannelOutput::Send() implementation.
+template <size_t kBufferSizeBytes, size_t kMaxPackets>
+class BatchingChannelOutput : public internal::BatchingChannelOutputBase {
+ public:
+  static_assert(kBufferSizeBytes > 0u);
+  static_assert(kMaxPackets > 0u);
+
+  explicit BatchingChannelOutput(ChannelOutput& output)
+      : internal::BatchingChannelOutputBase(output, buffer_, packets_) {}
+
+ private:
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+  std::array<ConstByteSpan, kMaxPackets> packets_;
+};
+
+}  // namespace pw::rpc
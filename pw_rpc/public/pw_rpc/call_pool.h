@@ -0,0 +1,135 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pw_metric/metric.h"
+
+namespace pw::rpc {
+
+/// Holds the calls of a streaming RPC method in a fixed set of slots, which
+/// are reused once their calls complete.
+///
+/// Servers with many short-lived streams need somewhere to keep each
+/// `ServerWriter` or `ServerReaderWriter` while its stream is open. A
+/// `CallPool` provides that storage without allocating: `Store()` moves a call
+/// into the first slot whose call is no longer active. The pool's metrics
+/// count stored calls, slot reuse, exhaustion, and the peak number of active
+/// calls, so the pool can be sized from field data.
+///
+/// `Call` is any server call type, e.g. `RawServerWriter` or
+/// `NanopbServerReaderWriter<Request, Response>`. The pool is not
+/// synchronized; use it from the thread that handles the RPCs, or guard it
+/// with a lock.
+///
+/// @code{.cpp}
+///   void LogService::Tail(const pw_log_TailRequest&,
+///                         NanopbServerWriter<pw_log_LogEntry>& writer) {
+///     if (streams_.Store(std::move(writer)) == nullptr) {
+///       writer.Finish(Status::ResourceExhausted()).IgnoreError();
+///     }
+///   }
+///
+///   void LogService::Publish(const pw_log_LogEntry& entry) {
+///     streams_.ForEachActive([&entry](auto& stream) {
+///       stream.Write(entry).IgnoreError();
+///     });
+///   }
+/// @endcode
+template <typename Call, size_t kCapacity>
+class CallPool {
+ public:
+  static_assert(kCapacity > 0u, "A CallPool must have at least one slot");
+
+  CallPool() = default;
+
+  CallPool(const CallPool&) = delete;
+  CallPool& operator=(const CallPool&) = delete;
+
+  /// Moves `call` into a slot whose call is not active.
+  ///
+  /// @returns The stored call, or `nullptr` if every slot holds an active
+  /// call. In that case, `call` is left unchanged.
+  Call* Store(Call&& call) {
+    size_t free_slot = kCapacity;
+    uint32_t active = 1;  // Includes the new call.
+    for (size_t i = 0; i < kCapacity; ++i) {
+      if (calls_[i].active()) {
+        active += 1;
+      } else if (free_slot == kCapacity) {
+        free_slot = i;
+      }
+    }
+
+    if (free_slot == kCapacity) {
+      exhausted_.Increment();
+      return nullptr;
+    }
+
+    // Free slots are taken in order, so slots below used_slots_ have held a
+    // call before.
+    if (free_slot < used_slots_) {
+      reused_.Increment();
+    } else {
+      used_slots_ = free_slot + 1;
+    }
+    stored_.Increment();
+    if (active > peak_active_.value()) {
+      peak_active_.Set(active);
+    }
+
+    calls_[free_slot] = std::move(call);
+    return &calls_[free_slot];
+  }
+
+  /// Invokes `function` with each active call.
+  template <typename Function>
+  void ForEachActive(Function&& function) {
+    for (Call& call : calls_) {
+      if (call.active()) {
+        function(call);
+      }
+    }
+  }
+
+  /// Returns the number of active calls in the pool.
+  size_t active_count() const {
+    size_t count = 0;
+    for (const Call& call : calls_) {
+      count += call.active() ? 1 : 0;
+    }
+    return count;
+  }
+
+  static constexpr size_t capacity() { return kCapacity; }
+
+  /// The pool's metrics, to be added to a parent group.
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  std::array<Call, kCapacity> calls_;
+  size_t used_slots_ = 0;
+
+  PW_METRIC_GROUP(metrics_, "call_pool");
+  PW_METRIC(metrics_, stored_, "stored", 0u);
+  PW_METRIC(metrics_, reused_, "reused", 0u);
+  PW_METRIC(metrics_, exhausted_, "exhausted", 0u);
+  PW_METRIC(metrics_, peak_active_, "peak_active", 0u);
+};
+
+}  // namespace pw::rpc
@@ -84,6 +84,16 @@ class ChannelOutput {
   virtual Status Send(span<const std::byte> buffer)
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) = 0;
 
+  // Sends several encoded RPC packets, in order. Outputs that can write
+  // multiple packets to their transport at once (e.g. in one frame, syscall, or
+  // DMA transfer) may override this to reduce per-packet overhead. The default
+  // implementation calls Send() for each packet and stops at the first packet
+  // that returns an error.
+  //
+  // The same restrictions apply as for Send(), including the DANGER above.
+  virtual Status SendBatch(span<const ConstByteSpan> packets)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
  private:
   const char* name_;
 };
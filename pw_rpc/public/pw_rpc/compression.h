@@ -0,0 +1,139 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::rpc {
+
+// Compresses and decompresses whole RPC packets. Implementations must be
+// stateless between calls, since each packet is compressed independently.
+class Codec {
+ public:
+  virtual ~Codec() = default;
+
+  // Identifies the codec in compressed packets. IDs 0 and 0xff are reserved.
+  uint8_t id() const { return id_; }
+
+  // Compresses input into output. Returns RESOURCE_EXHAUSTED if the compressed
+  // data does not fit in output.
+  virtual StatusWithSize Compress(ConstByteSpan input, ByteSpan output) = 0;
+
+  // Decompresses input into output. Returns RESOURCE_EXHAUSTED if output is
+  // too small or DATA_LOSS if input is malformed.
+  virtual StatusWithSize Decompress(ConstByteSpan input, ByteSpan output) = 0;
+
+ protected:
+  constexpr Codec(uint8_t id) : id_(id) {}
+
+ private:
+  uint8_t id_;
+};
+
+// LZSS codec suited to microcontrollers: besides its input and output buffers,
+// it only uses a small hash table on the stack while compressing (see
+// PW_RPC_COMPRESSION_HASH_BITS). Matches reference up to 4095 bytes back in
+// the packet.
+class LzssCodec final : public Codec {
+ public:
+  static constexpr uint8_t kId = 1;
+
+  constexpr LzssCodec() : Codec(kId) {}
+
+  StatusWithSize Compress(ConstByteSpan input, ByteSpan output) override;
+  StatusWithSize Decompress(ConstByteSpan input, ByteSpan output) override;
+};
+
+// The first byte of a compressed packet. RPC packets never start with 0, since
+// protobuf field numbers start at 1. The codec ID follows this byte.
+inline constexpr std::byte kCompressedPacketMarker{0};
+
+// Size of the header that precedes compressed packet data.
+inline constexpr size_t kCompressedPacketHeaderSize = 2;
+
+// Returns the RPC packet to pass to ProcessPacket() for a received packet.
+// Compressed packets are decompressed into buffer; other packets are returned
+// as is, so endpoints can receive from peers with and without compression.
+//
+// Returns UNIMPLEMENTED if the packet was compressed with a different codec.
+Result<ConstByteSpan> DecompressPacket(Codec& codec,
+                                       ConstByteSpan packet,
+                                       ByteSpan buffer);
+
+namespace internal {
+
+// Non-templated implementation of CompressingChannelOutput.
+class CompressingChannelOutputBase : public ChannelOutput {
+ public:
+  CompressingChannelOutputBase(const CompressingChannelOutputBase&) = delete;
+  CompressingChannelOutputBase& operator=(const CompressingChannelOutputBase&) =
+      delete;
+
+  size_t MaximumTransmissionUnit() override {
+    return output_.MaximumTransmissionUnit();
+  }
+
+  Status Send(span<const std::byte> packet) override
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+ protected:
+  CompressingChannelOutputBase(ChannelOutput& output,
+                               Codec& codec,
+                               ByteSpan buffer)
+      : ChannelOutput(output.name()),
+        output_(output),
+        codec_(codec),
+        buffer_(buffer) {}
+
+  ~CompressingChannelOutputBase() override = default;
+
+ private:
+  ChannelOutput& output_;
+  Codec& codec_;
+  const ByteSpan buffer_;
+};
+
+}  // namespace internal
+
+// ChannelOutput that compresses packets before passing them to another output.
+// Packets that do not get smaller, or do not fit in kBufferSizeBytes once
+// compressed, are sent uncompressed. The receiving endpoint must pass incoming
+// packets through DecompressPacket() with the same codec.
+//
+// Since pw_transfer chunks are sent as RPC packets, transfers over a channel
+// with this output are compressed as well.
+template <size_t kBufferSizeBytes>
+class CompressingChannelOutput
+    : public internal::CompressingChannelOutputBase {
+ public:
+  static_assert(kBufferSizeBytes > kCompressedPacketHeaderSize);
+
+  CompressingChannelOutput(ChannelOutput& output, Codec& codec)
+      : internal::CompressingChannelOutputBase(output, codec, buffer_) {}
+
+ private:
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+};
+
+}  // namespace pw::rpc
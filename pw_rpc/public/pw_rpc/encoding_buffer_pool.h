@@ -0,0 +1,40 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_rpc/internal/config.h"
+
+#if PW_RPC_ENCODING_BUFFER_POOL
+
+#include "pw_allocator/block_pool.h"
+#include "pw_rpc/internal/encoding_buffer.h"
+#include "pw_rpc/internal/lock.h"
+
+namespace pw::rpc {
+
+/// Sets the pool from which pw_rpc takes its encoding buffers. This must not be
+/// called while a packet is being encoded, and the pool must outlive all pw_rpc
+/// endpoints. Packets are encoded one at a time while holding the RPC lock, so
+/// at most one block is in use and a pool with a single block is sufficient.
+///
+/// Only available if @c_macro{PW_RPC_ENCODING_BUFFER_POOL} is enabled.
+inline void SetEncodingBufferPool(allocator::BlockPool& pool)
+    PW_LOCKS_EXCLUDED(internal::rpc_lock()) {
+  internal::RpcLockGuard lock;
+  internal::encoding_buffer.set_pool(pool);
+}
+
+}  // namespace pw::rpc
+
+#endif  // PW_RPC_ENCODING_BUFFER_POOL
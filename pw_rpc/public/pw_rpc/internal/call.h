@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <limits>
@@ -128,19 +129,23 @@ class Call : public IntrusiveList<Call>::Item {
   ~Call() {
     // Ensure that calls have already been closed and unregistered.
     // See class IMPLEMENTATION NOTE for further details.
-    PW_DASSERT((state_ & kHasBeenDestroyed) != 0);
+    PW_DASSERT((state_.load(std::memory_order_relaxed) & kHasBeenDestroyed) !=
+               0);
     PW_DASSERT(!active_locked() && !CallbacksAreRunning());
   }
 
   // True if the Call is active and ready to send responses.
-  [[nodiscard]] bool active() const PW_LOCKS_EXCLUDED(rpc_lock()) {
-    RpcLockGuard lock;
-    return active_locked();
+  //
+  // This reads the call's state without acquiring the RPC lock, so it is cheap
+  // to poll from any thread. The call may close at any time after this
+  // returns, so operations on the call must still check for errors.
+  [[nodiscard]] bool active() const {
+    return (state_.load(std::memory_order_relaxed) & kActive) != 0;
   }
 
   [[nodiscard]] bool active_locked() const
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return (state_ & kActive) != 0;
+    return (state() & kActive) != 0;
   }
 
   [[nodiscard]] bool awaiting_cleanup() const
@@ -230,6 +235,18 @@ class Call : public IntrusiveList<Call>::Item {
   Status WriteLocked(ConstByteSpan payload)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
+  // Public function for client calls that sends a CLIENT_CREDIT packet,
+  // allowing the server to send this many more server stream packets. The
+  // first call enables flow control for the server stream. Servers that do not
+  // support flow control ignore the credits.
+  Status GrantCredits(uint32_t credits) PW_LOCKS_EXCLUDED(rpc_lock()) {
+    RpcLockGuard lock;
+    return GrantCreditsLocked(credits);
+  }
+
+  Status GrantCreditsLocked(uint32_t credits)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
   // Sends the initial request for a client call. If the request fails, the call
   // is closed.
   void SendInitialClientRequest(ConstByteSpan payload)
@@ -283,7 +300,7 @@ class Call : public IntrusiveList<Call>::Item {
   // Returns true if the client has already requested completion.
   bool client_requested_completion() const
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return (state_ & kClientRequestedCompletion) != 0;
+    return (state() & kClientRequestedCompletion) != 0;
   }
 
   // Closes a call without doing anything else. Called from the Endpoint
@@ -368,7 +385,7 @@ class Call : public IntrusiveList<Call>::Item {
   }
 
   void MarkStreamCompleted() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    state_ |= kClientRequestedCompletion;
+    set_state(state() | kClientRequestedCompletion);
   }
 
   // Closes a client call. Sends a CLIENT_REQUEST_COMPLETION for client /
@@ -472,6 +489,13 @@ class Call : public IntrusiveList<Call>::Item {
     }
   }
 
+#if PW_RPC_FLOW_CONTROL
+  // Adds credits received in a CLIENT_CREDIT packet. The first packet enables
+  // flow control for the call. Returns true if the call had run out of credits
+  // and now has some.
+  bool AddCredits(uint32_t credits) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+#endif  // PW_RPC_FLOW_CONTROL
+
   // An active call cannot be moved if its callbacks are running. This function
   // must be called on the call being moved before updating any state.
   static void WaitUntilReadyForMove(Call& destination, Call& source)
@@ -505,12 +529,18 @@ class Call : public IntrusiveList<Call>::Item {
                   status);
   }
 
+#if PW_RPC_FLOW_CONTROL
+  // Indicates that the client has not enabled flow control for the call.
+  static constexpr uint32_t kUnlimitedCredits =
+      std::numeric_limits<uint32_t>::max();
+#endif  // PW_RPC_FLOW_CONTROL
+
   // Marks a call object closed without doing anything else. The call is not
   // removed from the calls list and no callbacks are called.
   void MarkClosed() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     channel_id_ = Channel::kUnassignedChannelId;
     id_ = 0;
-    state_ = kClientRequestedCompletion;
+    set_state(kClientRequestedCompletion);
   }
 
   // Calls the on_error callback without closing the RPC. This is used when the
@@ -529,6 +559,11 @@ class Call : public IntrusiveList<Call>::Item {
   Status SendPacket(pwpb::PacketType type,
                     ConstByteSpan payload,
                     Status status = OkStatus())
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return SendPacket(MakePacket(type, payload, status));
+  }
+
+  Status SendPacket(const Packet& packet)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
   Status CloseAndSendFinalPacketLocked(pwpb::PacketType type,
@@ -536,6 +571,16 @@ class Call : public IntrusiveList<Call>::Item {
                                        Status status)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
+  // Writers hold the RPC lock, so the state does not need atomic
+  // read-modify-write operations, only atomic loads and stores.
+  uint8_t state() const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return state_.load(std::memory_order_relaxed);
+  }
+
+  void set_state(uint8_t state) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    state_.store(state, std::memory_order_relaxed);
+  }
+
   bool CallbacksAreRunning() const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     return callbacks_executing_ != 0u;
   }
@@ -554,7 +599,11 @@ class Call : public IntrusiveList<Call>::Item {
   //   bit 0: call is active
   //   bit 1: client stream is active
   //   bit 2: call has been destroyed
-  uint8_t state_ PW_GUARDED_BY(rpc_lock());
+  //
+  // The state is atomic so that active() can read it without the RPC lock.
+  // It is not annotated as guarded by the lock for that reason, but it is only
+  // modified through set_state(), which requires the lock.
+  std::atomic<uint8_t> state_;
 
   // If non-OK, indicates that the call was closed and needs to have its
   // on_error called with this Status code. Uses a uint8_t for compactness.
@@ -566,6 +615,12 @@ class Call : public IntrusiveList<Call>::Item {
 
   CallProperties properties_ PW_GUARDED_BY(rpc_lock());
 
+#if PW_RPC_FLOW_CONTROL
+  // Number of server stream packets the client has granted, or
+  // kUnlimitedCredits if the client has not enabled flow control.
+  uint32_t credits_ PW_GUARDED_BY(rpc_lock()) = kUnlimitedCredits;
+#endif  // PW_RPC_FLOW_CONTROL
+
   // Called when the RPC is terminated due to an error.
   Function<void(Status error)> on_error_ PW_GUARDED_BY(rpc_lock());
 
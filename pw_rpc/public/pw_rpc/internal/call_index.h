@@ -0,0 +1,83 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::rpc::internal {
+
+class Call;
+
+// Hash table of an endpoint's active calls, keyed by channel, service, method,
+// and call ID, for finding the call for an incoming packet without walking the
+// endpoint's list of calls.
+//
+// The table has a fixed number of slots and uses linear probing. Removed calls
+// leave a tombstone behind, which the endpoint clears by rebuilding the index
+// from its list of calls when needs_rebuild() returns true. Calls are found by
+// their current IDs, so a call's IDs must not change while it is in the index.
+class CallIndex {
+ public:
+  static constexpr size_t kCapacity = cfg::kCallIndexSize;
+
+  static_assert(kCapacity > 0u && (kCapacity & (kCapacity - 1)) == 0u,
+                "PW_RPC_CALL_INDEX_SIZE must be a power of two");
+
+  constexpr CallIndex() = default;
+
+  CallIndex(const CallIndex&) = delete;
+  CallIndex& operator=(const CallIndex&) = delete;
+
+  // Adds a call to the index. Returns false if every slot holds a call.
+  bool Insert(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Removes a call from the index. Returns false if the call was not found.
+  bool Remove(const Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Returns the call with exactly these IDs, or nullptr if there is none.
+  Call* Find(uint32_t channel_id,
+             uint32_t service_id,
+             uint32_t method_id,
+             uint32_t call_id) const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  void Clear() {
+    slots_.fill(nullptr);
+    tombstones_ = 0;
+  }
+
+  // True if enough calls were removed that lookups are slowed down by the
+  // tombstones they left.
+  bool needs_rebuild() const { return tombstones_ > kCapacity / 4; }
+
+ private:
+  static size_t Home(uint32_t channel_id,
+                     uint32_t service_id,
+                     uint32_t method_id,
+                     uint32_t call_id);
+
+  static Call* Tombstone() { return reinterpret_cast<Call*>(&tombstone_); }
+
+  static char tombstone_;
+
+  std::array<Call*, kCapacity> slots_{};
+  size_t tombstones_ = 0;
+};
+
+}  // namespace pw::rpc::internal
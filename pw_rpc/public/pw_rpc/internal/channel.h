@@ -27,6 +27,9 @@ class Channel : public rpc::Channel {
   constexpr Channel(uint32_t id, ChannelOutput* output)
       : rpc::Channel(id, output) {}
 
+  // Creates an unassigned channel, such as an empty slot in a ChannelList.
+  static constexpr Channel Unassigned() { return Channel(rpc::Channel()); }
+
   // Allow closing a channel for internal API users.
   using rpc::Channel::Close;
 
@@ -34,6 +37,10 @@ class Channel : public rpc::Channel {
   using rpc::Channel::set_channel_id;
 
   Status Send(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+ private:
+  explicit constexpr Channel(const rpc::Channel& channel)
+      : rpc::Channel(channel) {}
 };
 
 }  // namespace pw::rpc::internal
@@ -33,32 +33,50 @@
 
 namespace pw::rpc::internal {
 
+// Channels are stored in an open-addressed hash table with linear probing,
+// using the channel span (or dynamic container) itself as the table, so no
+// memory is used beyond the channels. A channel's home slot is its ID minus one
+// modulo the table size, so channels numbered sequentially from 1 each occupy
+// their own slot. Finding an open channel takes constant time as long as the
+// table is not nearly full.
+//
+// Get() never modifies the table. Add() and Remove() may move channels within
+// the table, which invalidates Channel pointers previously returned by Get().
+// Channels configured directly in the span, rather than through Add(), may not
+// be in the slot a lookup probes first. Lookups that miss fall back to
+// searching the whole table, and the next Add() or Remove() moves such channels
+// to where lookups will find them.
 class ChannelList {
  public:
   _PW_RPC_CONSTEXPR ChannelList() = default;
 
   _PW_RPC_CONSTEXPR ChannelList(span<Channel> channels)
   // If dynamic allocation is enabled, channels aren't typically allocated
-  // beforehand, though they can be. If they are, push them one-by-one to the
-  // vector to avoid requiring a constructor that does that.
+  // beforehand, though they can be. If they are, insert them one-by-one into
+  // the table to avoid requiring a constructor that does that.
 #if PW_RPC_DYNAMIC_ALLOCATION
   {
     for (const Channel& channel : channels) {
-      channels_.emplace_back(channel);
+      if (channel.id() != Channel::kUnassignedChannelId) {
+        Insert(channel);
+      }
     }
 #else   // Without dynamic allocation, simply initialize the span.
       : channels_(channels) {
 #endif  // PW_RPC_DYNAMIC_ALLOCATION
   }
 
-  // Returns the first channel with the matching ID or nullptr if none match.
-  // Except for Channel::kUnassignedChannelId, there should be no duplicate
-  // channels.
-  const Channel* Get(uint32_t channel_id) const;
+  // Returns the channel with the matching ID or nullptr if none match. There
+  // should be no duplicate channels. Channel::kUnassignedChannelId never
+  // matches. The pointer is valid until the next Add() or Remove().
+  const Channel* Get(uint32_t channel_id) const {
+    const size_t slot = FindSlot(channel_id);
+    return slot < channels_.size() ? &channels_[slot] : nullptr;
+  }
 
   Channel* Get(uint32_t channel_id) {
-    return const_cast<Channel*>(
-        static_cast<const ChannelList&>(*this).Get(channel_id));
+    const size_t slot = FindSlot(channel_id);
+    return slot < channels_.size() ? &channels_[slot] : nullptr;
   }
 
   // Adds the channel with the requested ID to the list. Returns:
@@ -83,6 +101,54 @@ class ChannelList {
 #else
   span<Channel> channels_;
 #endif  // PW_RPC_DYNAMIC_ALLOCATION
+
+ private:
+#if PW_RPC_DYNAMIC_ALLOCATION
+  // The table grows when a new channel would be further than this from its
+  // home slot.
+  static constexpr size_t kMaxProbeDistance = 8;
+
+  static constexpr size_t kMinTableSize = 8;
+
+  // Adds a copy of an assigned channel, growing the table if necessary.
+  void Insert(const Channel& channel);
+
+  // Doubles the size of the table and reinserts its channels.
+  void Grow();
+#endif  // PW_RPC_DYNAMIC_ALLOCATION
+
+  size_t HomeSlot(uint32_t channel_id) const {
+    return (channel_id - 1) % channels_.size();
+  }
+
+  size_t NextSlot(size_t slot) const {
+    return slot + 1 == channels_.size() ? 0 : slot + 1;
+  }
+
+  // The number of slots between a channel's home slot and the slot it is in.
+  size_t ProbeDistance(size_t home, size_t slot) const {
+    return slot >= home ? slot - home : slot + channels_.size() - home;
+  }
+
+  // Returns the slot of the channel with the matching ID, or the table size if
+  // there is none.
+  size_t FindSlot(uint32_t channel_id) const;
+
+  // Returns the slot of the channel with the matching ID if a lookup from its
+  // home slot reaches it, or the table size if it does not.
+  size_t ProbeSlot(uint32_t channel_id) const;
+
+  // Returns the first unassigned slot within max_distance of the home slot of
+  // channel_id, or nullptr if there is none.
+  Channel* FindUnassigned(uint32_t channel_id, size_t max_distance);
+
+  // Moves channels that a lookup from their home slot does not reach to where
+  // lookups will find them.
+  void PlaceMisplacedChannels();
+
+  // Moves channels that follow an unassigned slot back into it, so that
+  // lookups that would have probed past the slot still find them.
+  void CloseGap(size_t gap);
 };
 
 }  // namespace pw::rpc::internal
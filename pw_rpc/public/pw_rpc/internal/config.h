@@ -43,6 +43,21 @@
 #define PW_RPC_COMPLETION_REQUEST_CALLBACK 0
 #endif  // PW_RPC_COMPLETION_REQUEST_CALLBACK
 
+/// pw_rpc clients may limit how many server stream messages a server sends by
+/// granting it credits with `CLIENT_CREDIT` packets. Server stream writes fail
+/// with `RESOURCE_EXHAUSTED` while a call has no credits, and servers may be
+/// notified when more credits arrive.
+///
+/// This option controls whether servers track credits. It adds a counter to all
+/// calls and a @cpp_type{pw::Function} callback to all server calls, so may
+/// have a significant cost. When disabled, `CLIENT_CREDIT` packets are ignored
+/// and server streams are not limited.
+///
+/// This is disabled by default.
+#ifndef PW_RPC_FLOW_CONTROL
+#define PW_RPC_FLOW_CONTROL 0
+#endif  // PW_RPC_FLOW_CONTROL
+
 /// The Nanopb-based pw_rpc implementation allocates memory to use for Nanopb
 /// structs for the request and response protobufs. The template function that
 /// allocates these structs rounds struct sizes up to this value so that
@@ -184,6 +199,8 @@ static_assert(
 ///   - `back()`
 ///   - `resize()`
 ///   - `clear()`
+///   - `size()`
+///   - Indexing with `operator[]`
 ///   - Range-based for loop iteration (`begin()`, `end()`)
 ///
 #ifndef PW_RPC_DYNAMIC_CONTAINER
@@ -199,6 +216,24 @@ static_assert(
 #define PW_RPC_DYNAMIC_CONTAINER_INCLUDE <vector>
 #endif  // PW_RPC_DYNAMIC_CONTAINER_INCLUDE
 
+/// If @c_macro{PW_RPC_DYNAMIC_ALLOCATION} is enabled, setting this to 1 makes
+/// pw_rpc take its encoding buffers from a `pw::allocator::BlockPool` instead
+/// of @c_macro{PW_RPC_DYNAMIC_CONTAINER}. Buffers are taken from and returned
+/// to the pool in constant time, so churning calls does not fragment the heap.
+///
+/// The pool is provided with `pw::rpc::SetEncodingBufferPool()`; until then,
+/// buffers are allocated as usual. Each block must fit a whole packet. Packets
+/// are encoded one at a time under the RPC lock, so pw_rpc uses at most one
+/// block. Sending a packet fails with `UNAVAILABLE` if the pool has no free
+/// blocks, or with `RESOURCE_EXHAUSTED` if the packet does not fit in a block.
+#ifndef PW_RPC_ENCODING_BUFFER_POOL
+#define PW_RPC_ENCODING_BUFFER_POOL 0
+#endif  // PW_RPC_ENCODING_BUFFER_POOL
+
+static_assert(PW_RPC_ENCODING_BUFFER_POOL == 0 ||
+                  PW_RPC_DYNAMIC_ALLOCATION == 1,
+              "PW_RPC_ENCODING_BUFFER_POOL requires PW_RPC_DYNAMIC_ALLOCATION");
+
 /// Size of the global RPC packet encoding buffer in bytes. If dynamic
 /// allocation is enabled, this value is only used for test helpers that
 /// allocate RPC encoding buffers.
@@ -206,6 +241,41 @@ static_assert(
 #define PW_RPC_ENCODING_BUFFER_SIZE_BYTES 512
 #endif  // PW_RPC_ENCODING_BUFFER_SIZE_BYTES
 
+/// Number of slots in the hash table each endpoint uses to look up the call for
+/// an incoming packet. When 0 (the default), calls are found by searching the
+/// endpoint's list of active calls, which is linear in the number of calls.
+///
+/// Set this to a power of two somewhat larger than the number of calls that
+/// are active at once, e.g. 32 for up to 24 calls. Each slot is one pointer.
+/// If the table fills up, calls that do not fit are still found by searching
+/// the list.
+#ifndef PW_RPC_CALL_INDEX_SIZE
+#define PW_RPC_CALL_INDEX_SIZE 0
+#endif  // PW_RPC_CALL_INDEX_SIZE
+
+/// Maximum number of services a server keeps in a table sorted by service ID,
+/// for finding the service for an incoming packet with a binary search. When 0
+/// (the default), services are found by searching the server's list of
+/// registered services, which is linear in the number of services.
+///
+/// Each entry is one pointer. Services registered after the table is full are
+/// still found by searching the list.
+#ifndef PW_RPC_SERVICE_INDEX_SIZE
+#define PW_RPC_SERVICE_INDEX_SIZE 0
+#endif  // PW_RPC_SERVICE_INDEX_SIZE
+
+/// The number of bits in the hashes `pw::rpc::LzssCodec` uses to find repeated
+/// data when compressing packets. Compression uses a table of
+/// 2^PW_RPC_COMPRESSION_HASH_BITS 32-bit positions on the stack. Larger tables
+/// find more matches, which may compress packets better.
+#ifndef PW_RPC_COMPRESSION_HASH_BITS
+#define PW_RPC_COMPRESSION_HASH_BITS 7
+#endif  // PW_RPC_COMPRESSION_HASH_BITS
+
+static_assert((PW_RPC_COMPRESSION_HASH_BITS >= 1) &&
+                  (PW_RPC_COMPRESSION_HASH_BITS <= 16),
+              "PW_RPC_COMPRESSION_HASH_BITS must be between 1 and 16");
+
 /// The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_RPC_CONFIG_LOG_LEVEL
 #define PW_RPC_CONFIG_LOG_LEVEL PW_LOG_LEVEL_INFO
@@ -222,6 +292,9 @@ template <typename...>
 constexpr std::bool_constant<PW_RPC_COMPLETION_REQUEST_CALLBACK>
     kClientStreamEndCallbackEnabled;
 
+template <typename...>
+constexpr std::bool_constant<PW_RPC_FLOW_CONTROL> kFlowControlEnabled;
+
 template <typename...>
 constexpr std::bool_constant<PW_RPC_DYNAMIC_ALLOCATION>
     kDynamicAllocationEnabled;
@@ -232,6 +305,12 @@ inline constexpr size_t kNanopbStructMinBufferSize =
 inline constexpr size_t kEncodingBufferSizeBytes =
     PW_RPC_ENCODING_BUFFER_SIZE_BYTES;
 
+inline constexpr size_t kCallIndexSize = PW_RPC_CALL_INDEX_SIZE;
+
+inline constexpr size_t kServiceIndexSize = PW_RPC_SERVICE_INDEX_SIZE;
+
+inline constexpr size_t kCompressionHashBits = PW_RPC_COMPRESSION_HASH_BITS;
+
 #undef PW_RPC_NANOPB_STRUCT_MIN_BUFFER_SIZE
 #undef PW_RPC_ENCODING_BUFFER_SIZE_BYTES
 
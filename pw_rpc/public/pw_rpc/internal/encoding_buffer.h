@@ -32,6 +32,14 @@
 
 #endif  // PW_RPC_DYNAMIC_ALLOCATION
 
+#if PW_RPC_ENCODING_BUFFER_POOL
+
+#include "pw_allocator/block_pool.h"
+#include "pw_result/result.h"
+#include "pw_status/try.h"
+
+#endif  // PW_RPC_ENCODING_BUFFER_POOL
+
 namespace pw::rpc::internal {
 
 constexpr ByteSpan ResizeForPayload(ByteSpan buffer) {
@@ -104,8 +112,90 @@ class DynamicEncodingBuffer {
   PW_RPC_DYNAMIC_CONTAINER(std::byte) buffer_;
 };
 
+#if PW_RPC_ENCODING_BUFFER_POOL
+
+// Wraps an encoding buffer taken from a pw_allocator block pool. Allocating a
+// buffer fails with UNAVAILABLE if the pool has no free blocks, or with
+// RESOURCE_EXHAUSTED if the requested packet is larger than a block. Until a
+// pool is set, buffers are allocated with PW_RPC_DYNAMIC_CONTAINER.
+class PoolEncodingBuffer {
+ public:
+  PoolEncodingBuffer() = default;
+
+  ~PoolEncodingBuffer() { PW_DASSERT(block_ == nullptr); }
+
+  void set_pool(allocator::BlockPool& pool) {
+    PW_DASSERT(block_ == nullptr);
+    pool_ = &pool;
+  }
+
+  // Allocates a new buffer and returns a portion to use to encode the payload.
+  Result<ByteSpan> AllocatePayloadBuffer(size_t payload_size) {
+    if (pool_ == nullptr) {
+      return fallback_.AllocatePayloadBuffer(payload_size);
+    }
+    PW_TRY(Allocate(payload_size));
+    return ResizeForPayload(buffer());
+  }
+
+  // Returns the buffer into which to encode the packet, allocating a new buffer
+  // if necessary.
+  Result<ByteSpan> GetPacketBuffer(size_t payload_size) {
+    if (pool_ == nullptr) {
+      return fallback_.GetPacketBuffer(payload_size);
+    }
+    if (block_ == nullptr) {
+      PW_TRY(Allocate(payload_size));
+    }
+    return buffer();
+  }
+
+  // Frees the payload buffer, which MUST have been allocated previously.
+  void Release() {
+    if (pool_ == nullptr) {
+      fallback_.Release();
+      return;
+    }
+    PW_DASSERT(block_ != nullptr);
+    pool_->Free(block_);
+    block_ = nullptr;
+  }
+
+  // Frees the payload buffer, if one was allocated.
+  void ReleaseIfAllocated() {
+    if (pool_ == nullptr) {
+      fallback_.ReleaseIfAllocated();
+    } else if (block_ != nullptr) {
+      Release();
+    }
+  }
+
+ private:
+  Status Allocate(size_t payload_size) {
+    PW_DASSERT(block_ == nullptr);
+    if (payload_size + Packet::kMinEncodedSizeWithoutPayload >
+        pool_->block_size()) {
+      return Status::ResourceExhausted();
+    }
+    block_ = static_cast<std::byte*>(pool_->Allocate());
+    return block_ == nullptr ? Status::Unavailable() : OkStatus();
+  }
+
+  ByteSpan buffer() const { return ByteSpan(block_, pool_->block_size()); }
+
+  allocator::BlockPool* pool_ = nullptr;
+  std::byte* block_ = nullptr;
+  DynamicEncodingBuffer fallback_;
+};
+
+using EncodingBuffer = PoolEncodingBuffer;
+
+#else
+
 using EncodingBuffer = DynamicEncodingBuffer;
 
+#endif  // PW_RPC_ENCODING_BUFFER_POOL
+
 #else
 
 using EncodingBuffer = StaticEncodingBuffer;
@@ -130,7 +220,12 @@ static Result<ByteSpan> EncodeToPayloadBuffer(Proto& payload,
     return Status::Internal();
   }
 
+#if PW_RPC_ENCODING_BUFFER_POOL
+  PW_TRY_ASSIGN(ByteSpan buffer,
+                encoding_buffer.AllocatePayloadBuffer(payload_size.size()));
+#else
   ByteSpan buffer = encoding_buffer.AllocatePayloadBuffer(payload_size.size());
+#endif  // PW_RPC_ENCODING_BUFFER_POOL
 #else
   ByteSpan buffer = encoding_buffer.AllocatePayloadBuffer();
 #endif  // PW_RPC_DYNAMIC_ALLOCATION
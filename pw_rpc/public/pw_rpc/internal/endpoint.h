@@ -13,19 +13,22 @@
 // the License.
 #pragma once
 
-#include <tuple>
-
 #include "pw_assert/assert.h"
 #include "pw_containers/intrusive_list.h"
 #include "pw_result/result.h"
 #include "pw_rpc/internal/call.h"
 #include "pw_rpc/internal/channel.h"
 #include "pw_rpc/internal/channel_list.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_span/span.h"
 #include "pw_sync/lock_annotations.h"
 
+#if PW_RPC_CALL_INDEX_SIZE > 0
+#include "pw_rpc/internal/call_index.h"
+#endif  // PW_RPC_CALL_INDEX_SIZE > 0
+
 namespace pw::rpc::internal {
 
 class LockedEndpoint;
@@ -118,19 +121,12 @@ class Endpoint {
       PW_LOCKS_EXCLUDED(rpc_lock());
 
   // Finds a call object for an ongoing call associated with this packet, if
-  // any. The iterator will be calls_end() if no match was found.
-  IntrusiveList<Call>::iterator FindCall(const Packet& packet)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return std::get<1>(FindIteratorsForCall(packet.channel_id(),
-                                            packet.service_id(),
-                                            packet.method_id(),
-                                            packet.call_id()));
-  }
-
-  // Used to check if a call iterator is valid or not.
-  IntrusiveList<Call>::const_iterator calls_end() const
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return calls_.end();
+  // any. Returns nullptr if no match was found.
+  Call* FindCall(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return LookUpCall(packet.channel_id(),
+                      packet.service_id(),
+                      packet.method_id(),
+                      packet.call_id());
   }
 
   // Aborts calls associated with a particular service. Calls to
@@ -146,6 +142,7 @@ class Endpoint {
   // This method is protected so it can be exposed in tests.
   void CloseCallAndMarkForCleanup(Call& call, Status error)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    RemoveFromIndex(call);
     call.CloseAndMarkForCleanupFromEndpoint(error);
     calls_.remove(call);
     to_cleanup_.push_front(call);
@@ -158,6 +155,7 @@ class Endpoint {
       IntrusiveList<Call>::iterator call_iterator,
       Status error) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     Call& call = *call_iterator;
+    RemoveFromIndex(call);
     call.CloseAndMarkForCleanupFromEndpoint(error);
     auto next = calls_.erase_after(before_call);
     to_cleanup_.push_front(call);
@@ -191,6 +189,7 @@ class Endpoint {
   // for existing calls.
   void RegisterUniqueCall(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     calls_.push_front(call);
+    AddToIndex(call);
   }
 
   void CleanUpCall(Call& call) PW_UNLOCK_FUNCTION(rpc_lock()) {
@@ -204,23 +203,36 @@ class Endpoint {
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     bool closed_call_was_in_list = calls_.remove(call);
     PW_DASSERT(closed_call_was_in_list);
+    RemoveFromIndex(call);
   }
 
-  std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-  FindIteratorsForCall(uint32_t channel_id,
-                       uint32_t service_id,
-                       uint32_t method_id,
-                       uint32_t call_id)
+  // Finds the active call with these IDs. A call_id of kOpenCallId matches any
+  // call ID. Calls with an ID of kOpenCallId were unrequested, and take the ID
+  // of the first packet that matches them.
+  Call* LookUpCall(uint32_t channel_id,
+                   uint32_t service_id,
+                   uint32_t method_id,
+                   uint32_t call_id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Searches the calls_ list for a call. This is used when the call index is
+  // disabled or incomplete.
+  Call* SearchCalls(uint32_t channel_id,
+                    uint32_t service_id,
+                    uint32_t method_id,
+                    uint32_t call_id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+#if PW_RPC_CALL_INDEX_SIZE > 0
+  void AddToIndex(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  void RemoveFromIndex(const Call& call)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
-  std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-  FindIteratorsForCall(const Call& call)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return FindIteratorsForCall(call.channel_id_locked(),
-                                call.service_id(),
-                                call.method_id(),
-                                call.id());
-  }
+  void RebuildIndex() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+#else
+  void AddToIndex(Call&) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {}
+
+  void RemoveFromIndex(const Call&) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {}
+#endif  // PW_RPC_CALL_INDEX_SIZE > 0
 
   // Silently closes all calls. Called by the destructor. This is a
   // non-destructor function so that Clang's lock safety analysis applies.
@@ -245,6 +257,16 @@ class Endpoint {
   // problematic.
   IntrusiveList<Call> to_cleanup_ PW_GUARDED_BY(rpc_lock());
 
+#if PW_RPC_CALL_INDEX_SIZE > 0
+  // Hash table of the calls in calls_, for finding the call for a packet
+  // without searching the list.
+  CallIndex call_index_ PW_GUARDED_BY(rpc_lock());
+
+  // Number of calls in calls_ that did not fit in call_index_. These can only
+  // be found by searching the list.
+  size_t unindexed_calls_ PW_GUARDED_BY(rpc_lock()) = 0;
+#endif  // PW_RPC_CALL_INDEX_SIZE > 0
+
   uint32_t next_call_id_ PW_GUARDED_BY(rpc_lock()) = 0;
 };
 
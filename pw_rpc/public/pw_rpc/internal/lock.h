@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include "pw_alignment/alignment.h"
 #include "pw_rpc/internal/config.h"
 #include "pw_sync/lock_annotations.h"
 #include "pw_toolchain/no_destructor.h"
@@ -40,8 +41,10 @@ class PW_LOCKABLE("pw::rpc::internal::RpcLock") RpcLock {
 #endif  // PW_RPC_USE_GLOBAL_MUTEX
 
 inline RpcLock& rpc_lock() {
-  static NoDestructor<RpcLock> lock;
-  return *lock;
+  // Every endpoint takes this lock, so keep other globals off its cache line
+  // if PW_ALIGNMENT_CACHE_LINE_PADDING is enabled.
+  static NoDestructor<CacheLinePadded<RpcLock, kCacheLinePadding>> lock;
+  return lock->value;
 }
 
 class PW_SCOPED_LOCKABLE RpcLockGuard {
@@ -102,11 +102,29 @@ class Packet {
         method_id_(method_id),
         call_id_(call_id),
         payload_(payload),
-        status_(status) {}
+        status_(status),
+        credits_(0) {}
 
   // Encodes the packet into its wire format. Returns the encoded size.
   Result<ConstByteSpan> Encode(ByteSpan buffer) const;
 
+  // Encodes the packet around a payload that was already encoded into buffer,
+  // at least kMinEncodedSizeWithoutPayload bytes from its start. The other
+  // fields are written immediately before the payload, so the payload is not
+  // copied. Returns the encoded packet, which ends where the payload ends.
+  //
+  // Returns FAILED_PRECONDITION if the payload is not positioned in buffer
+  // this way; use Encode instead.
+  Result<ConstByteSpan> EncodeInPlace(ByteSpan buffer) const;
+
+  // True if the payload is positioned in buffer such that the packet could be
+  // encoded with EncodeInPlace.
+  bool CanEncodeInPlace(ConstByteSpan buffer) const {
+    return !payload_.empty() && credits_ == 0u &&
+           payload_.data() >= buffer.data() + kMinEncodedSizeWithoutPayload &&
+           payload_.data() + payload_.size() <= buffer.data() + buffer.size();
+  }
+
   // Determines the space required to encode the packet proto fields for a
   // response, excluding the payload. This may be used to split the buffer into
   // reserved space and available space for the payload.
@@ -128,6 +146,7 @@ class Packet {
   constexpr uint32_t call_id() const { return call_id_; }
   constexpr const ConstByteSpan& payload() const { return payload_; }
   constexpr const Status& status() const { return status_; }
+  constexpr uint32_t credits() const { return credits_; }
 
   constexpr void set_type(pwpb::PacketType type) { type_ = type; }
   constexpr void set_channel_id(uint32_t channel_id) {
@@ -141,6 +160,10 @@ class Packet {
   constexpr void set_payload(ConstByteSpan payload) { payload_ = payload; }
   constexpr void set_status(Status status) { status_ = status; }
 
+  // Credits are only sent in CLIENT_CREDIT packets, which have no payload, so
+  // they are not included in kMinEncodedSizeWithoutPayload.
+  constexpr void set_credits(uint32_t credits) { credits_ = credits; }
+
   // Logs detailed info about this packet at INFO level. NOT for production use!
   void DebugLog() const;
 
@@ -152,6 +175,7 @@ class Packet {
   uint32_t call_id_;
   ConstByteSpan payload_;
   Status status_;
+  uint32_t credits_;
 };
 
 }  // namespace pw::rpc::internal
@@ -42,6 +42,10 @@ class ServerCall : public Call {
     rpc_lock().unlock();
   }
 
+  // Adds credits from a CLIENT_CREDIT packet. If the call had run out of
+  // credits, invokes the on_credits_available callback.
+  void HandleCredits(uint32_t credits) PW_UNLOCK_FUNCTION(rpc_lock());
+
  protected:
   constexpr ServerCall() = default;
 
@@ -95,11 +99,37 @@ class ServerCall : public Call {
 #endif  // PW_RPC_COMPLETION_REQUEST_CALLBACK
   }
 
+  // Sets a callback that is invoked when a client that enabled flow control
+  // grants credits after the call ran out of them. Server stream writes fail
+  // with RESOURCE_EXHAUSTED while there are no credits, so a producer may wait
+  // for this callback before writing again.
+  //
+  // set_on_credits_available is templated so that it can be conditionally
+  // disabled with a helpful static_assert message.
+  template <typename UnusedType = void>
+  void set_on_credits_available(
+      [[maybe_unused]] Function<void()>&& on_credits_available)
+      PW_LOCKS_EXCLUDED(rpc_lock()) {
+    static_assert(cfg::kFlowControlEnabled<UnusedType>,
+                  "Flow control is disabled, so set_on_credits_available "
+                  "cannot be called. To enable flow control, set "
+                  "PW_RPC_FLOW_CONTROL to 1.");
+#if PW_RPC_FLOW_CONTROL
+    RpcLockGuard lock;
+    on_credits_available_ = std::move(on_credits_available);
+#endif  // PW_RPC_FLOW_CONTROL
+  }
+
  private:
 #if PW_RPC_COMPLETION_REQUEST_CALLBACK
   // Called when a client stream completes.
   Function<void()> on_client_requested_completion_ PW_GUARDED_BY(rpc_lock());
 #endif  // PW_RPC_COMPLETION_REQUEST_CALLBACK
+
+#if PW_RPC_FLOW_CONTROL
+  // Called when the client grants credits after they ran out.
+  Function<void()> on_credits_available_ PW_GUARDED_BY(rpc_lock());
+#endif  // PW_RPC_FLOW_CONTROL
 };
 
 }  // namespace pw::rpc::internal
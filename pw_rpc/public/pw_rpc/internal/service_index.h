@@ -0,0 +1,61 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_rpc/internal/config.h"
+
+namespace pw::rpc {
+
+class Service;
+
+namespace internal {
+
+// Table of a server's registered services, sorted by service ID so the service
+// for a packet can be found with a binary search.
+//
+// A service registered more than once with the same ID is placed before the
+// existing entries, so the most recently registered service is found first, as
+// when searching the server's list of services.
+class ServiceIndex {
+ public:
+  static constexpr size_t kCapacity = cfg::kServiceIndexSize;
+
+  constexpr ServiceIndex() = default;
+
+  ServiceIndex(const ServiceIndex&) = delete;
+  ServiceIndex& operator=(const ServiceIndex&) = delete;
+
+  // Adds a service to the table. Returns false if the table is full.
+  bool Insert(Service& service);
+
+  // Removes a service from the table. Returns false if it was not found.
+  bool Remove(const Service& service);
+
+  // Returns the service with this ID, or nullptr if there is none.
+  Service* Find(uint32_t service_id) const;
+
+ private:
+  // Returns the index of the first service with an ID of at least service_id.
+  size_t LowerBound(uint32_t service_id) const;
+
+  std::array<Service*, kCapacity> services_{};
+  size_t size_ = 0;
+};
+
+}  // namespace internal
+}  // namespace pw::rpc
@@ -29,6 +29,10 @@
 #include "pw_span/span.h"
 #include "pw_status/status.h"
 
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+#include "pw_rpc/internal/service_index.h"
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
+
 namespace pw::rpc {
 
 class Server : public internal::Endpoint {
@@ -54,11 +58,11 @@ class Server : public internal::Endpoint {
   void RegisterService(Service& service, OtherServices&... services)
       PW_LOCKS_EXCLUDED(internal::rpc_lock()) {
     internal::RpcLockGuard lock;
-    services_.push_front(service);  // Register the first service
+    AddService(service);  // Register the first service
 
     // Register any additional services by expanding the parameter pack. This
     // is a fold expression of the comma operator.
-    (services_.push_front(services), ...);
+    (AddService(services), ...);
   }
 
   // Returns whether a service is registered.
@@ -167,24 +171,49 @@ class Server : public internal::Endpoint {
     return call;
   }
 
+  void AddService(Service& service)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
+    services_.push_front(service);
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+    if (!service_index_.Insert(service)) {
+      unindexed_services_ += 1;
+    }
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
+  }
+
+  void RemoveFromServiceIndex([[maybe_unused]] const Service& service)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+    if (!service_index_.Remove(service)) {
+      unindexed_services_ -= 1;
+    }
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
+  }
+
+  // Finds the registered service with this ID, or nullptr if there is none.
+  Service* FindService(uint32_t service_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
   std::tuple<Service*, const internal::Method*> FindMethod(
       const internal::Packet& packet)
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
 
   void HandleCompletionRequest(const internal::Packet& packet,
                                internal::Channel& channel,
-                               IntrusiveList<internal::Call>::iterator call)
-      const PW_UNLOCK_FUNCTION(internal::rpc_lock());
+                               internal::Call* call) const
+      PW_UNLOCK_FUNCTION(internal::rpc_lock());
 
   void HandleClientStreamPacket(const internal::Packet& packet,
                                 internal::Channel& channel,
-                                IntrusiveList<internal::Call>::iterator call)
-      const PW_UNLOCK_FUNCTION(internal::rpc_lock());
+                                internal::Call* call) const
+      PW_UNLOCK_FUNCTION(internal::rpc_lock());
 
   template <typename... OtherServices>
   void UnregisterServiceLocked(Service& service, OtherServices&... services)
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
-    services_.remove(service);
+    if (services_.remove(service)) {
+      RemoveFromServiceIndex(service);
+    }
     UnregisterServiceLocked(services...);
     AbortCallsForService(service);
   }
@@ -198,6 +227,15 @@ class Server : public internal::Endpoint {
   using Endpoint::GetInternalChannel;
 
   IntrusiveList<Service> services_ PW_GUARDED_BY(internal::rpc_lock());
+
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+  // Registered services sorted by ID, for finding a packet's service without
+  // searching services_.
+  internal::ServiceIndex service_index_ PW_GUARDED_BY(internal::rpc_lock());
+
+  // Number of services in services_ that did not fit in service_index_.
+  size_t unindexed_services_ PW_GUARDED_BY(internal::rpc_lock()) = 0;
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
 };
 
 }  // namespace pw::rpc
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
@@ -42,16 +44,23 @@ class Service : public IntrusiveList<Service>::Item {
   ServiceId service_id() const { return internal::WrapServiceId(id_); }
 
  protected:
+  // Order of a service's method table. Generated services sort their methods
+  // by ID, so that FindMethod can use a binary search.
+  enum class MethodOrder : bool { kUnsorted, kSortedById };
+
   // Note: despite being non-`::internal` and non-`private`, this constructor
   // is not considered part of pigweed's public API: calling it requires
   // constructing `methods`, which must have a `.data()` accessor which returns
   // a `const internal::MethodUnion*`.
   template <typename T, size_t kMethodCount>
-  constexpr Service(uint32_t id, const std::array<T, kMethodCount>& methods)
+  constexpr Service(uint32_t id,
+                    const std::array<T, kMethodCount>& methods,
+                    MethodOrder order = MethodOrder::kUnsorted)
       : id_(id),
         methods_(methods.data()),
         method_size_(sizeof(T)),
-        method_count_(static_cast<uint16_t>(kMethodCount)) {
+        method_count_(static_cast<uint16_t>(kMethodCount)),
+        methods_sorted_(order == MethodOrder::kSortedById) {
     PW_MODIFY_DIAGNOSTICS_PUSH();
     // GCC 10 emits spurious -Wtype-limits warnings for the static_assert.
     PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wtype-limits");
@@ -65,7 +74,11 @@ class Service : public IntrusiveList<Service>::Item {
   // is not considered part of the public API.
   template <typename T>
   constexpr Service(uint32_t id, const T& method)
-      : id_(id), methods_(&method), method_size_(sizeof(T)), method_count_(1) {}
+      : id_(id),
+        methods_(&method),
+        method_size_(sizeof(T)),
+        method_count_(1),
+        methods_sorted_(true) {}
 
  private:
   friend class Server;
@@ -74,10 +87,18 @@ class Service : public IntrusiveList<Service>::Item {
   // Finds the method with the provided method_id. Returns nullptr if no match.
   const internal::Method* FindMethod(uint32_t method_id) const;
 
+  const internal::Method& MethodAt(size_t index) const {
+    const auto raw = reinterpret_cast<const std::byte*>(methods_);
+    return reinterpret_cast<const internal::MethodUnion*>(
+               raw + index * method_size_)
+        ->method();
+  }
+
   const uint32_t id_;
   const internal::MethodUnion* const methods_;
   const uint16_t method_size_;
   const uint16_t method_count_;
+  const bool methods_sorted_;
 };
 
 }  // namespace pw::rpc
@@ -0,0 +1,319 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "pw_assert/assert.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_function/function.h"
+#include "pw_rpc/batching_channel_output.h"
+#include "pw_rpc/client.h"
+#include "pw_rpc/internal/method_info.h"
+#include "pw_rpc/internal/synchronous_call_impl.h"
+#include "pw_rpc/synchronous_call_result.h"
+#include "pw_span/span.h"
+#include "pw_sync/timed_thread_notification.h"
+
+/// @file pw_rpc/synchronous_call_batch.h
+///
+/// `SynchronousCallBatch<RpcMethod, kMaxInFlight>` invokes a unary RPC once
+/// for each of a list of requests and blocks until every call completes. Up to
+/// `kMaxInFlight` calls are outstanding at once, so the round trips of the
+/// calls overlap instead of adding up. As each call completes, the next
+/// request is sent. Results are stored at the same index as their requests,
+/// as `SynchronousCallResult`s, exactly as `SynchronousCall` returns them.
+///
+/// If the channel's output is a `BatchingChannelOutput`, pass it to the batch
+/// call. The requests sent together are then corked and written to the
+/// transport in one `SendBatch()`, rather than one write per request.
+///
+/// @code{.cpp}
+///   std::array<pw_rpc_EchoMessage, 64> requests = ...;
+///   std::array<pw::rpc::SynchronousCallResult<pw_rpc_EchoMessage>, 64>
+///       results;
+///   pw::rpc::SynchronousCallBatch<EchoService::Echo, 8>(
+///       rpc_client, channel_id, batching_output, requests, results);
+///   for (const auto& result : results) {
+///     if (result.ok()) {
+///       PW_LOG_INFO("%s", result.response().msg);
+///     }
+///   }
+/// @endcode
+///
+/// Only the Nanopb and pwpb APIs are supported.
+///
+/// @warning Like `SynchronousCall`, these functions block the calling thread
+/// and must not be called from a context that cannot be blocked, such as an
+/// RPC callback.
+namespace pw::rpc {
+namespace internal {
+
+// One in-flight call of a SynchronousCallBatch. The callbacks only capture the
+// slot, so they fit in a pw::Function.
+template <auto kRpcMethod>
+class BatchedCall {
+ public:
+  using Request = typename MethodInfo<kRpcMethod>::Request;
+  using Response = typename MethodInfo<kRpcMethod>::Response;
+  using Result = SynchronousCallResult<Response>;
+
+  void Start(Client& client,
+             uint32_t channel_id,
+             const Request& request,
+             Result& result,
+             sync::TimedThreadNotification& notify) {
+    result_ = &result;
+    notify_ = &notify;
+    done_.store(false, std::memory_order_relaxed);
+    in_use_ = true;
+    // Destroying the previous call waits for its callbacks to return.
+    call_.reset();
+    call_.emplace(kRpcMethod(client,
+                             channel_id,
+                             request,
+                             OnCompletedCallback(),
+                             OnRpcErrorCallback()));
+  }
+
+  // Closes the call and waits for its callbacks. If it had not completed, its
+  // result is set to error_result.
+  void Cancel(const Result& error_result) {
+    call_.reset();
+    if (!done()) {
+      *result_ = error_result;
+      done_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // True from Start() until Finish(), even if the call was cancelled.
+  bool active() const { return in_use_; }
+
+  bool done() const { return done_.load(std::memory_order_acquire); }
+
+  // Releases the slot for the next call once the result is consumed.
+  void Finish() {
+    call_.reset();
+    in_use_ = false;
+  }
+
+ private:
+  auto OnCompletedCallback() {
+    return [this](const Response& response, Status status) {
+      *result_ = Result(status, response);
+      Complete();
+    };
+  }
+
+  auto OnRpcErrorCallback() {
+    return [this](Status status) {
+      *result_ = Result::RpcError(status);
+      Complete();
+    };
+  }
+
+  void Complete() {
+    done_.store(true, std::memory_order_release);
+    notify_->release();
+  }
+
+  using Call = decltype(kRpcMethod(
+      std::declval<Client&>(),
+      uint32_t{},
+      std::declval<const Request&>(),
+      std::declval<Function<void(const Response&, Status)>>(),
+      std::declval<Function<void(Status)>>()));
+
+  std::optional<Call> call_;
+  Result* result_ = nullptr;
+  sync::TimedThreadNotification* notify_ = nullptr;
+  std::atomic<bool> done_{false};
+  bool in_use_ = false;
+};
+
+template <auto kRpcMethod, size_t kMaxInFlight, typename... TimeoutArg>
+void StructSynchronousCallBatch(
+    Client& client,
+    uint32_t channel_id,
+    BatchingChannelOutputBase* output,
+    span<const typename MethodInfo<kRpcMethod>::Request> requests,
+    span<SynchronousCallResult<typename MethodInfo<kRpcMethod>::Response>>
+        results,
+    TimeoutArg... timeout_arg) {
+  static_assert(MethodInfo<kRpcMethod>::kType == MethodType::kUnary,
+                "Only unary methods can be used with synchronous calls");
+  static_assert(
+      !std::is_same_v<typename MethodInfo<kRpcMethod>::Request, void>,
+      "Batched synchronous calls are not supported for the raw API");
+  static_assert(kMaxInFlight > 0u);
+  PW_ASSERT(results.size() >= requests.size());
+
+  using Result = typename BatchedCall<kRpcMethod>::Result;
+
+  // Declared before the calls, since their callbacks release it.
+  sync::TimedThreadNotification notify;
+  std::array<BatchedCall<kRpcMethod>, kMaxInFlight> calls;
+
+  size_t next_request = 0;
+  size_t outstanding = 0;
+  while (next_request < requests.size() || outstanding > 0u) {
+    // Fill the free slots. With a BatchingChannelOutput, the new requests are
+    // sent together when the output is uncorked.
+    if (output != nullptr) {
+      output->Cork();
+    }
+    std::array<bool, kMaxInFlight> started{};
+    for (size_t i = 0; i < calls.size() && next_request < requests.size();
+         ++i) {
+      if (!calls[i].active()) {
+        calls[i].Start(client,
+                       channel_id,
+                       requests[next_request],
+                       results[next_request],
+                       notify);
+        started[i] = true;
+        next_request += 1;
+        outstanding += 1;
+      }
+    }
+    if (output != nullptr) {
+      if (const Status status = output->Uncork(); !status.ok()) {
+        // The requests may not have been sent, so fail the calls just started.
+        for (size_t i = 0; i < calls.size(); ++i) {
+          if (started[i]) {
+            calls[i].Cancel(Result::RpcError(status));
+          }
+        }
+      }
+    }
+
+    // Wait for a call to complete, unless one already has.
+    bool any_done = false;
+    for (const BatchedCall<kRpcMethod>& call : calls) {
+      any_done = any_done || (call.active() && call.done());
+    }
+    if (!any_done) {
+      if constexpr (sizeof...(TimeoutArg) == 0) {
+        notify.acquire();  // Wait forever, since no timeout was given.
+      } else if (!AcquireNotification(notify, timeout_arg...)) {
+        for (BatchedCall<kRpcMethod>& call : calls) {
+          if (call.active()) {
+            call.Cancel(Result::Timeout());
+          }
+        }
+        for (; next_request < requests.size(); ++next_request) {
+          results[next_request] = Result::Timeout();
+        }
+        return;
+      }
+    }
+
+    for (BatchedCall<kRpcMethod>& call : calls) {
+      if (call.active() && call.done()) {
+        call.Finish();
+        outstanding -= 1;
+      }
+    }
+  }
+}
+
+}  // namespace internal
+
+/// Invokes a unary RPC synchronously for each request, with up to
+/// `kMaxInFlight` calls outstanding at once, using Nanopb or pwpb. Blocks
+/// indefinitely until every call completes.
+///
+/// @param client The `pw::rpc::Client` to use for the calls
+/// @param channel_id The ID of the RPC channel to make the calls on
+/// @param requests The proto structs to send as requests
+/// @param results Receives the result of each request, at the same index;
+///     must be at least as large as `requests`
+template <auto kRpcMethod, size_t kMaxInFlight>
+void SynchronousCallBatch(
+    Client& client,
+    uint32_t channel_id,
+    span<const typename internal::MethodInfo<kRpcMethod>::Request> requests,
+    span<SynchronousCallResult<
+        typename internal::MethodInfo<kRpcMethod>::Response>> results) {
+  internal::StructSynchronousCallBatch<kRpcMethod, kMaxInFlight>(
+      client, channel_id, nullptr, requests, results);
+}
+
+/// Invokes a unary RPC synchronously for each request, as above. Requests
+/// that are started together are corked in `output`, which must be the
+/// channel's output, so they are sent in a single transport write.
+template <auto kRpcMethod,
+          size_t kMaxInFlight,
+          size_t kBufferSizeBytes,
+          size_t kMaxPackets>
+void SynchronousCallBatch(
+    Client& client,
+    uint32_t channel_id,
+    BatchingChannelOutput<kBufferSizeBytes, kMaxPackets>& output,
+    span<const typename internal::MethodInfo<kRpcMethod>::Request> requests,
+    span<SynchronousCallResult<
+        typename internal::MethodInfo<kRpcMethod>::Response>> results) {
+  internal::StructSynchronousCallBatch<kRpcMethod, kMaxInFlight>(
+      client, channel_id, &output, requests, results);
+}
+
+/// Invokes a unary RPC synchronously for each request, with up to
+/// `kMaxInFlight` calls outstanding at once, using Nanopb or pwpb. Blocks
+/// until every call completes or the provided timeout passes. The timeout
+/// applies to each wait for a response. When it passes, the outstanding calls
+/// are abandoned and they and the unsent requests time out.
+///
+/// @param client The `pw::rpc::Client` to use for the calls
+/// @param channel_id The ID of the RPC channel to make the calls on
+/// @param requests The proto structs to send as requests
+/// @param results Receives the result of each request, at the same index;
+///     must be at least as large as `requests`
+/// @param timeout Duration to wait for each response before timing out
+template <auto kRpcMethod, size_t kMaxInFlight>
+void SynchronousCallBatchFor(
+    Client& client,
+    uint32_t channel_id,
+    span<const typename internal::MethodInfo<kRpcMethod>::Request> requests,
+    span<SynchronousCallResult<
+        typename internal::MethodInfo<kRpcMethod>::Response>> results,
+    chrono::SystemClock::duration timeout) {
+  internal::StructSynchronousCallBatch<kRpcMethod, kMaxInFlight>(
+      client, channel_id, nullptr, requests, results, timeout);
+}
+
+/// Invokes a unary RPC synchronously for each request, corking `output`
+/// around the requests that are started together. Times out as above.
+template <auto kRpcMethod,
+          size_t kMaxInFlight,
+          size_t kBufferSizeBytes,
+          size_t kMaxPackets>
+void SynchronousCallBatchFor(
+    Client& client,
+    uint32_t channel_id,
+    BatchingChannelOutput<kBufferSizeBytes, kMaxPackets>& output,
+    span<const typename internal::MethodInfo<kRpcMethod>::Request> requests,
+    span<SynchronousCallResult<
+        typename internal::MethodInfo<kRpcMethod>::Response>> results,
+    chrono::SystemClock::duration timeout) {
+  internal::StructSynchronousCallBatch<kRpcMethod, kMaxInFlight>(
+      client, channel_id, &output, requests, results, timeout);
+}
+
+}  // namespace pw::rpc
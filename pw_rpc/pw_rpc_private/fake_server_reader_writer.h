@@ -59,6 +59,7 @@ class FakeServerReaderWriter : private ServerCall {
   using Call::set_on_next;
   using ServerCall::set_on_completion_requested;
   using ServerCall::set_on_completion_requested_if_enabled;
+  using ServerCall::set_on_credits_available;
 
   Status Finish(Status status = OkStatus()) {
     return CloseAndSendResponse(status);
@@ -89,6 +90,7 @@ class FakeServerWriter : private FakeServerReaderWriter {
   using FakeServerReaderWriter::Finish;
   using FakeServerReaderWriter::set_on_completion_requested;
   using FakeServerReaderWriter::set_on_completion_requested_if_enabled;
+  using FakeServerReaderWriter::set_on_credits_available;
   using FakeServerReaderWriter::set_on_error;
   using FakeServerReaderWriter::Write;
 
@@ -234,6 +234,7 @@ class PwpbServerReaderWriter : private internal::BasePwpbServerReader<Request> {
   using internal::BasePwpbServerReader<Request>::set_on_next;
   using internal::ServerCall::set_on_completion_requested;
   using internal::ServerCall::set_on_completion_requested_if_enabled;
+  using internal::ServerCall::set_on_credits_available;
 
   // Writes a response. Returns the following Status codes:
   //
@@ -378,6 +379,7 @@ class PwpbServerWriter : private internal::PwpbServerCall {
   using internal::Call::set_on_error;
   using internal::ServerCall::set_on_completion_requested;
   using internal::ServerCall::set_on_completion_requested_if_enabled;
+  using internal::ServerCall::set_on_credits_available;
 
   // Writes a response. Returns the following Status codes:
   //
@@ -0,0 +1,249 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/synchronous_call_batch.h"
+
+#include <array>
+#include <chrono>
+#include <mutex>
+
+#include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_containers/vector.h"
+#include "pw_rpc/batching_channel_output.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/pwpb/fake_channel_output.h"
+#include "pw_rpc_test_protos/test.rpc.pwpb.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/thread.h"
+#include "pw_work_queue/test_thread.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::rpc::test {
+namespace {
+
+using pw::rpc::test::pw_rpc::pwpb::TestService;
+using MethodInfo = internal::MethodInfo<TestService::TestUnaryRpc>;
+
+namespace TestRequest = ::pw::rpc::test::pwpb::TestRequest;
+namespace TestResponse = ::pw::rpc::test::pwpb::TestResponse;
+
+using Result = SynchronousCallResult<TestResponse::Message>;
+
+constexpr size_t kMaxRequests = 16;
+
+class SynchronousCallBatchTest : public ::testing::Test {
+ public:
+  SynchronousCallBatchTest()
+      : batching_output_(fake_output_),
+        channels_({{Channel::Create<42>(&batching_output_)}}),
+        client_(channels_) {}
+
+  void SetUp() override {
+    work_thread_ =
+        thread::Thread(work_queue::test::WorkQueueThreadOptions(), work_queue_);
+  }
+
+  void TearDown() override {
+    work_queue_.RequestStop();
+#if PW_THREAD_JOINING_ENABLED
+    work_thread_.join();
+#else
+    work_thread_.detach();
+#endif  // PW_THREAD_JOINING_ENABLED
+  }
+
+ protected:
+  using FakeChannelOutput = PwpbFakeChannelOutput<2 * kMaxRequests>;
+
+  // Responds to each request with twice its integer. The response status is
+  // the request's status_code.
+  void RespondToRequests() {
+    fake_output_.set_on_send(
+        [this](span<const std::byte> buffer, Status status) {
+          OnSend(buffer, status);
+        });
+  }
+
+  void OnSend(span<const std::byte> buffer, Status status) {
+    if (!status.ok()) {
+      return;
+    }
+    auto packet = internal::Packet::FromBuffer(buffer);
+    ASSERT_TRUE(packet.ok());
+    TestRequest::Message request{};
+    ASSERT_EQ(MethodInfo::serde().request().Decode(packet->payload(), request),
+              OkStatus());
+
+    {
+      std::lock_guard lock(mutex_);
+      ASSERT_FALSE(pending_.full());
+      // The payload refers to the output's buffer, which is reused.
+      packet->set_payload({});
+      pending_.push_back({*packet, request});
+      in_flight_ += 1;
+      max_in_flight_ = std::max(max_in_flight_, in_flight_);
+    }
+    EXPECT_TRUE(work_queue_.PushWork([this]() { SendResponse(); }).ok());
+  }
+
+  void SendResponse() {
+    internal::Packet request_packet;
+    TestRequest::Message request;
+    {
+      std::lock_guard lock(mutex_);
+      request_packet = pending_[responses_sent_].packet;
+      request = pending_[responses_sent_].request;
+      responses_sent_ += 1;
+      in_flight_ -= 1;
+    }
+
+    TestResponse::Message response{
+        .value = static_cast<int32_t>(request.integer * 2),
+        .repeated_field{}};
+    std::array<std::byte, 32> payload_buffer;
+    StatusWithSize size_status =
+        MethodInfo::serde().response().Encode(response, payload_buffer);
+    EXPECT_TRUE(size_status.ok());
+
+    auto response_packet = internal::Packet::Response(
+        request_packet, static_cast<Status::Code>(request.status_code));
+    response_packet.set_payload({payload_buffer.data(), size_status.size()});
+    std::array<std::byte, 256> buffer;
+    EXPECT_TRUE(
+        client_.ProcessPacket(response_packet.Encode(buffer).value()).ok());
+  }
+
+  size_t max_in_flight() {
+    std::lock_guard lock(mutex_);
+    return max_in_flight_;
+  }
+
+  FakeChannelOutput& fake_output() { return fake_output_; }
+  BatchingChannelOutput<256, 4>& batching_output() { return batching_output_; }
+  const Channel& channel() const { return channels_.front(); }
+  Client& client() { return client_; }
+
+ private:
+  struct PendingRequest {
+    internal::Packet packet;
+    TestRequest::Message request;
+  };
+
+  FakeChannelOutput fake_output_;
+  BatchingChannelOutput<256, 4> batching_output_;
+  std::array<Channel, 1> channels_;
+  Client client_;
+  thread::Thread work_thread_;
+  work_queue::WorkQueueWithBuffer<kMaxRequests> work_queue_;
+
+  sync::Mutex mutex_;
+  Vector<PendingRequest, kMaxRequests> pending_ PW_GUARDED_BY(mutex_);
+  size_t responses_sent_ PW_GUARDED_BY(mutex_) = 0;
+  size_t in_flight_ PW_GUARDED_BY(mutex_) = 0;
+  size_t max_in_flight_ PW_GUARDED_BY(mutex_) = 0;
+};
+
+TEST_F(SynchronousCallBatchTest, AllCallsSucceed) {
+  std::array<TestRequest::Message, 10> requests{};
+  for (size_t i = 0; i < requests.size(); ++i) {
+    requests[i].integer = static_cast<int64_t>(i);
+  }
+  std::array<Result, 10> results;
+
+  RespondToRequests();
+  SynchronousCallBatch<TestService::TestUnaryRpc, 3>(
+      client(), channel().id(), requests, results);
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    ASSERT_TRUE(results[i].ok());
+    EXPECT_EQ(results[i].response().value, static_cast<int32_t>(2 * i));
+  }
+  EXPECT_LE(max_in_flight(), 3u);
+}
+
+TEST_F(SynchronousCallBatchTest, CorksBatchingOutput) {
+  std::array<TestRequest::Message, 8> requests{};
+  for (size_t i = 0; i < requests.size(); ++i) {
+    requests[i].integer = static_cast<int64_t>(i);
+  }
+  std::array<Result, 8> results;
+
+  RespondToRequests();
+  SynchronousCallBatch<TestService::TestUnaryRpc, 4>(
+      client(), channel().id(), batching_output(), requests, results);
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    ASSERT_TRUE(results[i].ok());
+    EXPECT_EQ(results[i].response().value, static_cast<int32_t>(2 * i));
+  }
+  EXPECT_LE(max_in_flight(), 4u);
+  EXPECT_FALSE(batching_output().corked());
+}
+
+TEST_F(SynchronousCallBatchTest, ServerErrorsArePerCall) {
+  std::array<TestRequest::Message, 3> requests{{
+      {.integer = 1, .status_code = 0},
+      {.integer = 2, .status_code = PW_STATUS_NOT_FOUND},
+      {.integer = 3, .status_code = 0},
+  }};
+  std::array<Result, 3> results;
+
+  RespondToRequests();
+  SynchronousCallBatch<TestService::TestUnaryRpc, 2>(
+      client(), channel().id(), requests, results);
+
+  EXPECT_TRUE(results[0].ok());
+  EXPECT_TRUE(results[1].is_server_response());
+  EXPECT_EQ(results[1].status(), Status::NotFound());
+  EXPECT_EQ(results[1].response().value, 4);
+  EXPECT_TRUE(results[2].ok());
+}
+
+TEST_F(SynchronousCallBatchTest, RpcError) {
+  std::array<TestRequest::Message, 3> requests{};
+  std::array<Result, 3> results;
+
+  fake_output().set_send_status(Status::Unknown());
+  SynchronousCallBatch<TestService::TestUnaryRpc, 2>(
+      client(), channel().id(), requests, results);
+
+  for (const Result& result : results) {
+    EXPECT_TRUE(result.is_rpc_error());
+    EXPECT_EQ(result.status(), Status::Unknown());
+  }
+}
+
+TEST_F(SynchronousCallBatchTest, TimeoutFailsRemainingCalls) {
+  std::array<TestRequest::Message, 5> requests{};
+  std::array<Result, 5> results;
+
+  SynchronousCallBatchFor<TestService::TestUnaryRpc, 2>(
+      client(),
+      channel().id(),
+      requests,
+      results,
+      chrono::SystemClock::for_at_least(std::chrono::milliseconds(1)));
+
+  for (const Result& result : results) {
+    EXPECT_TRUE(result.is_timeout());
+    EXPECT_EQ(result.status(), Status::DeadlineExceeded());
+  }
+}
+
+}  // namespace
+}  // namespace pw::rpc::test
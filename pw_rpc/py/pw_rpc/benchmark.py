@@ -0,0 +1,292 @@
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Measures pw_rpc latency and throughput using the pw.rpc.Benchmark service.
+
+The benchmarks only use the Python RPC client, so they run over any transport
+the client is connected through (e.g. a socket or HDLC over a serial port).
+Pass the Benchmark service from a channel's RPCs, for example
+``client.channel(1).rpcs.pw.rpc.Benchmark``.
+"""
+
+import dataclasses
+import json
+import math
+import threading
+import time
+from typing import Any, Dict, Iterable, List, Optional, Sequence
+
+from pw_status import Status
+
+# The C++ BenchmarkService's UnaryEcho responds with at most this many bytes.
+UNARY_ECHO_MAX_PAYLOAD_SIZE = 32
+
+DEFAULT_PAYLOAD_SIZES = (0, 8, 32, 128, 256)
+DEFAULT_CONCURRENCY_LEVELS = (1, 2, 4, 8)
+
+
+class BenchmarkError(Exception):
+    """Raised when the server does not echo a benchmark payload correctly."""
+
+
+def percentile(samples: Sequence[float], pct: float) -> float:
+    """Returns the nearest-rank percentile of the samples."""
+    if not samples:
+        raise ValueError('Cannot take the percentile of no samples')
+
+    ordered = sorted(samples)
+    rank = math.ceil(pct / 100 * len(ordered))
+    return ordered[max(rank, 1) - 1]
+
+
+@dataclasses.dataclass(frozen=True)
+class LatencyResult:
+    """Round trip latencies of unary calls, in microseconds."""
+
+    payload_size: int
+    calls: int
+    p50_us: float
+    p99_us: float
+    min_us: float
+    max_us: float
+    mean_us: float
+
+    @classmethod
+    def from_samples(
+        cls, payload_size: int, samples_us: Sequence[float]
+    ) -> 'LatencyResult':
+        return cls(
+            payload_size=payload_size,
+            calls=len(samples_us),
+            p50_us=percentile(samples_us, 50),
+            p99_us=percentile(samples_us, 99),
+            min_us=min(samples_us),
+            max_us=max(samples_us),
+            mean_us=sum(samples_us) / len(samples_us),
+        )
+
+
+@dataclasses.dataclass(frozen=True)
+class ThroughputResult:
+    """Echoed bytes per second in a bidirectional stream."""
+
+    payload_size: int
+    messages: int
+    duration_s: float
+    messages_per_s: float
+    bytes_per_s: float
+
+
+@dataclasses.dataclass(frozen=True)
+class ConcurrencyResult:
+    """Aggregate unary call rate with several calls in flight at once."""
+
+    concurrent_calls: int
+    calls_per_s: float
+    latency: LatencyResult
+
+
+@dataclasses.dataclass
+class BenchmarkResults:
+    """All results from a benchmark run."""
+
+    unary_latency: List[LatencyResult] = dataclasses.field(
+        default_factory=list
+    )
+    stream_throughput: List[ThroughputResult] = dataclasses.field(
+        default_factory=list
+    )
+    concurrency: List[ConcurrencyResult] = dataclasses.field(
+        default_factory=list
+    )
+
+    def to_dict(self) -> Dict[str, Any]:
+        return dataclasses.asdict(self)
+
+    def to_json(self, **kwargs) -> str:
+        return json.dumps(self.to_dict(), **kwargs)
+
+
+def _payload(size: int, seed: int = 0) -> bytes:
+    return bytes((seed + i) % 256 for i in range(size))
+
+
+def _unary_echo(service, payload: bytes, timeout_s: Optional[float]) -> None:
+    status, reply = service.UnaryEcho(
+        payload=payload, pw_rpc_timeout_s=timeout_s
+    )
+    if status is not Status.OK or reply.payload != payload:
+        raise BenchmarkError(
+            f'UnaryEcho failed with {status} for a {len(payload)} B payload'
+        )
+
+
+def _measure_unary(
+    service, payload: bytes, calls: int, timeout_s: Optional[float]
+) -> List[float]:
+    samples_us: List[float] = []
+    for _ in range(calls):
+        start = time.perf_counter_ns()
+        _unary_echo(service, payload, timeout_s)
+        samples_us.append((time.perf_counter_ns() - start) / 1000)
+    return samples_us
+
+
+def measure_unary_latency(
+    service,
+    payload_size: int,
+    calls: int = 100,
+    timeout_s: Optional[float] = 5.0,
+) -> LatencyResult:
+    """Measures the round trip latency of sequential UnaryEcho calls."""
+    if payload_size > UNARY_ECHO_MAX_PAYLOAD_SIZE:
+        raise ValueError(
+            f'UnaryEcho payloads are limited to '
+            f'{UNARY_ECHO_MAX_PAYLOAD_SIZE} B; {payload_size} B requested'
+        )
+
+    samples_us = _measure_unary(
+        service, _payload(payload_size), calls, timeout_s
+    )
+    return LatencyResult.from_samples(payload_size, samples_us)
+
+
+def measure_stream_throughput(
+    service,
+    payload_size: int,
+    messages: int = 100,
+    window: int = 4,
+    timeout_s: Optional[float] = 5.0,
+) -> ThroughputResult:
+    """Measures how quickly messages are echoed over BidirectionalEcho.
+
+    Up to ``window`` messages are sent before waiting for their responses, so
+    the transport is kept busy without overflowing the server's buffers.
+    """
+    if window < 1:
+        raise ValueError('At least one message must be allowed in flight')
+
+    payload = _payload(payload_size)
+
+    with service.BidirectionalEcho.invoke(timeout_s=timeout_s) as call:
+        responses = call.get_responses(timeout_s=timeout_s)
+
+        start = time.perf_counter_ns()
+        sent = received = 0
+
+        while received < messages:
+            while sent < messages and sent - received < window:
+                call.send(payload=payload)
+                sent += 1
+
+            if next(responses).payload != payload:
+                raise BenchmarkError('BidirectionalEcho returned a bad payload')
+            received += 1
+
+        duration_s = (time.perf_counter_ns() - start) / 1e9
+
+    return ThroughputResult(
+        payload_size=payload_size,
+        messages=messages,
+        duration_s=duration_s,
+        messages_per_s=messages / duration_s,
+        bytes_per_s=messages * payload_size / duration_s,
+    )
+
+
+def measure_concurrency(
+    service,
+    concurrent_calls: int,
+    calls_per_thread: int = 50,
+    payload_size: int = 8,
+    timeout_s: Optional[float] = 5.0,
+) -> ConcurrencyResult:
+    """Issues UnaryEcho calls from several threads at once."""
+    samples: List[List[float]] = [[] for _ in range(concurrent_calls)]
+    errors: List[Exception] = []
+    start_barrier = threading.Barrier(concurrent_calls + 1)
+
+    def worker(index: int) -> None:
+        start_barrier.wait()
+        try:
+            samples[index] = _measure_unary(
+                service,
+                _payload(payload_size, index),
+                calls_per_thread,
+                timeout_s,
+            )
+        except Exception as err:  # pylint: disable=broad-except
+            errors.append(err)
+
+    threads = [
+        threading.Thread(target=worker, args=(i,), daemon=True)
+        for i in range(concurrent_calls)
+    ]
+    for thread in threads:
+        thread.start()
+
+    start_barrier.wait()
+    start = time.perf_counter_ns()
+    for thread in threads:
+        thread.join()
+    duration_s = (time.perf_counter_ns() - start) / 1e9
+
+    if errors:
+        raise errors[0]
+
+    all_samples = [sample for results in samples for sample in results]
+    return ConcurrencyResult(
+        concurrent_calls=concurrent_calls,
+        calls_per_s=len(all_samples) / duration_s,
+        latency=LatencyResult.from_samples(payload_size, all_samples),
+    )
+
+
+def run(
+    service,
+    payload_sizes: Iterable[int] = DEFAULT_PAYLOAD_SIZES,
+    concurrency_levels: Iterable[int] = DEFAULT_CONCURRENCY_LEVELS,
+    calls: int = 100,
+    timeout_s: Optional[float] = 5.0,
+) -> BenchmarkResults:
+    """Runs every benchmark and returns the results.
+
+    Unary latency is only measured for payload sizes that UnaryEcho supports.
+    """
+    payload_sizes = list(payload_sizes)
+    results = BenchmarkResults()
+
+    for size in payload_sizes:
+        if size <= UNARY_ECHO_MAX_PAYLOAD_SIZE:
+            results.unary_latency.append(
+                measure_unary_latency(service, size, calls, timeout_s)
+            )
+
+    for size in payload_sizes:
+        results.stream_throughput.append(
+            measure_stream_throughput(
+                service, size, messages=calls, timeout_s=timeout_s
+            )
+        )
+
+    for level in concurrency_levels:
+        results.concurrency.append(
+            measure_concurrency(
+                service,
+                level,
+                calls_per_thread=max(calls // level, 1),
+                timeout_s=timeout_s,
+            )
+        )
+
+    return results
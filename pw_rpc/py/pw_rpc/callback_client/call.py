@@ -225,6 +225,12 @@ class Call:
         except queue.Empty:
             raise RpcTimeout(self._rpc, timeout_s)
 
+    def _grant_credits(self, credits: int) -> None:
+        if credits <= 0:
+            raise ValueError('At least one credit must be granted')
+
+        self._rpcs.send_client_credit(self._rpc, credits)
+
     def cancel(self) -> bool:
         """Cancels the RPC; returns whether the RPC was active."""
         if self.completed():
@@ -314,6 +320,15 @@ class ServerStreamingCall(Call):
     ) -> StreamResponse:
         return self._stream_wait(timeout_s)
 
+    def grant_credits(self, credits: int) -> None:
+        """Allows the server to send this many more stream responses.
+
+        Server streams are unlimited until the first credits are granted. After
+        that, servers built with PW_RPC_FLOW_CONTROL stop sending responses when
+        their credits run out. Other servers ignore credits.
+        """
+        self._grant_credits(credits)
+
     def get_responses(
         self,
         *,
@@ -377,6 +392,13 @@ class BidirectionalStreamingCall(Call):
         self._finish_client_stream(requests)
         return self._stream_wait(timeout_s)
 
+    def grant_credits(self, credits: int) -> None:
+        """Allows the server to send this many more stream responses.
+
+        See ServerStreamingCall.grant_credits.
+        """
+        self._grant_credits(credits)
+
     def get_responses(
         self,
         *,
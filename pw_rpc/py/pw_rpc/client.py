@@ -177,6 +177,14 @@ class PendingRpcs:
             packets.encode_client_stream_end(rpc)
         )
 
+    def send_client_credit(self, rpc: PendingRpc, credits: int) -> None:
+        if rpc not in self._pending:
+            raise Error(f'Attempt to send credits for inactive RPC {rpc}')
+
+        rpc.channel.output(  # type: ignore
+            packets.encode_client_credit(rpc, credits)
+        )
+
     def cancel(self, rpc: PendingRpc) -> bytes:
         """Cancels the RPC.
 
@@ -16,7 +16,7 @@
 import abc
 from datetime import datetime
 import os
-from typing import cast, Any, Iterable, Union
+from typing import cast, Any, Iterable, List, Union
 
 from pw_protobuf.output_file import OutputFile
 from pw_protobuf.proto_tree import ProtoNode, ProtoService, ProtoServiceMethod
@@ -365,7 +365,8 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
     with gen.indent():
         gen.line(
             'constexpr Service() : '
-            f'{base_class}(kServiceId, kPwRpcMethods) {{}}'
+            f'{base_class}(kServiceId, kPwRpcMethods, '
+            'MethodOrder::kSortedById) {}'
         )
 
     gen.line()
@@ -375,7 +376,8 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
         gen.line('friend class ::pw::rpc::internal::MethodLookup;')
         gen.line()
 
-        # Generate the method table
+        # Generate the method table. Methods are sorted by ID so the service
+        # can find them with a binary search.
         gen.line(
             'static constexpr std::array<'
             f'{RPC_NAMESPACE}::internal::{gen.method_union_name()},'
@@ -383,7 +385,7 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
         )
 
         with gen.indent(4):
-            for method in service.methods():
+            for method in _methods_by_id(service):
                 gen.method_descriptor(method)
 
         gen.line('};\n')
@@ -402,12 +404,17 @@ def _method_lookup_table(gen: CodeGenerator, service: ProtoService) -> None:
     )
 
     with gen.indent(4):
-        for method in service.methods():
+        for method in _methods_by_id(service):
             gen.line(f'{get_id(method)},  // Hash of "{method.name()}"')
 
     gen.line('};')
 
 
+def _methods_by_id(service: ProtoService) -> List[ProtoServiceMethod]:
+    """Returns the service's methods, sorted by method ID."""
+    return sorted(service.methods(), key=lambda m: ids.calculate(m.name()))
+
+
 class StubGenerator(abc.ABC):
     """Generates stub method implementations that can be copied-and-pasted."""
 
@@ -111,5 +111,16 @@ def encode_client_stream_end(rpc: RpcIds) -> bytes:
     ).SerializeToString()
 
 
+def encode_client_credit(rpc: RpcIds, credits: int) -> bytes:
+    return packet_pb2.RpcPacket(
+        type=packet_pb2.PacketType.CLIENT_CREDIT,
+        channel_id=rpc.channel_id,
+        service_id=rpc.service_id,
+        method_id=rpc.method_id,
+        call_id=rpc.call_id,
+        credits=credits,
+    ).SerializeToString()
+
+
 def for_server(packet: packet_pb2.RpcPacket) -> bool:
     return packet.type % 2 == 0
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests the pw_rpc benchmark runner."""
+
+import json
+from types import SimpleNamespace
+import unittest
+
+from pw_rpc import benchmark
+from pw_status import Status
+
+
+class _FakeEchoCall:
+    def __init__(self) -> None:
+        self._pending: list = []
+
+    def __enter__(self) -> '_FakeEchoCall':
+        return self
+
+    def __exit__(self, *exc_info) -> None:
+        pass
+
+    def send(self, payload: bytes) -> None:
+        self._pending.append(SimpleNamespace(payload=payload))
+
+    def get_responses(self, timeout_s=None):
+        del timeout_s
+        while self._pending:
+            yield self._pending.pop(0)
+
+
+class _FakeBidirectionalEcho:
+    def __init__(self) -> None:
+        self.calls = 0
+
+    def invoke(self, timeout_s=None) -> _FakeEchoCall:
+        del timeout_s
+        self.calls += 1
+        return _FakeEchoCall()
+
+
+class _FakeBenchmarkService:
+    """Echoes payloads like the C++ BenchmarkService."""
+
+    def __init__(self, corrupt: bool = False) -> None:
+        self.unary_calls = 0
+        self.corrupt = corrupt
+        # pylint: disable-next=invalid-name
+        self.BidirectionalEcho = _FakeBidirectionalEcho()
+
+    def UnaryEcho(  # pylint: disable=invalid-name
+        self, payload: bytes, pw_rpc_timeout_s=None
+    ):
+        del pw_rpc_timeout_s
+        self.unary_calls += 1
+        if self.corrupt:
+            payload = payload + b'?'
+        return Status.OK, SimpleNamespace(payload=payload)
+
+
+class PercentileTest(unittest.TestCase):
+    """Tests the percentile helper."""
+
+    def test_nearest_rank(self) -> None:
+        samples = list(range(1, 101))
+        self.assertEqual(benchmark.percentile(samples, 50), 50)
+        self.assertEqual(benchmark.percentile(samples, 99), 99)
+        self.assertEqual(benchmark.percentile(samples, 100), 100)
+        self.assertEqual(benchmark.percentile(samples, 0), 1)
+
+    def test_unsorted(self) -> None:
+        self.assertEqual(benchmark.percentile([3, 1, 2], 50), 2)
+
+    def test_empty(self) -> None:
+        with self.assertRaises(ValueError):
+            benchmark.percentile([], 50)
+
+
+class BenchmarkTest(unittest.TestCase):
+    """Runs the benchmarks against a fake Benchmark service."""
+
+    def setUp(self) -> None:
+        self.service = _FakeBenchmarkService()
+
+    def test_unary_latency(self) -> None:
+        result = benchmark.measure_unary_latency(self.service, 8, calls=10)
+        self.assertEqual(self.service.unary_calls, 10)
+        self.assertEqual(result.calls, 10)
+        self.assertEqual(result.payload_size, 8)
+        self.assertLessEqual(result.min_us, result.p50_us)
+        self.assertLessEqual(result.p50_us, result.p99_us)
+        self.assertLessEqual(result.p99_us, result.max_us)
+
+    def test_unary_latency_payload_too_large(self) -> None:
+        with self.assertRaises(ValueError):
+            benchmark.measure_unary_latency(
+                self.service, benchmark.UNARY_ECHO_MAX_PAYLOAD_SIZE + 1
+            )
+
+    def test_unary_latency_bad_echo(self) -> None:
+        with self.assertRaises(benchmark.BenchmarkError):
+            benchmark.measure_unary_latency(
+                _FakeBenchmarkService(corrupt=True), 4, calls=1
+            )
+
+    def test_stream_throughput(self) -> None:
+        result = benchmark.measure_stream_throughput(
+            self.service, 64, messages=20, window=3
+        )
+        self.assertEqual(result.messages, 20)
+        self.assertGreater(result.messages_per_s, 0)
+        self.assertAlmostEqual(
+            result.bytes_per_s, result.messages_per_s * 64, places=3
+        )
+
+    def test_concurrency(self) -> None:
+        result = benchmark.measure_concurrency(
+            self.service, 4, calls_per_thread=5
+        )
+        self.assertEqual(result.concurrent_calls, 4)
+        self.assertEqual(result.latency.calls, 20)
+        self.assertEqual(self.service.unary_calls, 20)
+
+    def test_run_produces_json(self) -> None:
+        results = benchmark.run(
+            self.service,
+            payload_sizes=(4, 128),
+            concurrency_levels=(1, 2),
+            calls=4,
+        )
+
+        # Unary latency is skipped for payloads larger than UnaryEcho allows.
+        self.assertEqual(len(results.unary_latency), 1)
+        self.assertEqual(len(results.stream_throughput), 2)
+        self.assertEqual(len(results.concurrency), 2)
+
+        decoded = json.loads(results.to_json())
+        self.assertEqual(decoded['unary_latency'][0]['payload_size'], 4)
+        self.assertEqual(decoded['stream_throughput'][1]['payload_size'], 128)
+        self.assertEqual(decoded['concurrency'][1]['concurrent_calls'], 2)
+
+
+if __name__ == '__main__':
+    unittest.main()
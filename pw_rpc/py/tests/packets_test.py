@@ -78,6 +78,24 @@ class PacketsTest(unittest.TestCase):
             ),
         )
 
+    def test_encode_client_credit(self):
+        data = packets.encode_client_credit(packets.RpcIds(9, 8, 7, 6), 5)
+
+        packet = RpcPacket()
+        packet.ParseFromString(data)
+
+        self.assertEqual(
+            packet,
+            RpcPacket(
+                type=PacketType.CLIENT_CREDIT,
+                channel_id=9,
+                service_id=8,
+                method_id=7,
+                call_id=6,
+                credits=5,
+            ),
+        )
+
     def test_encode_client_error(self):
         data = packets.encode_client_error(_TEST_REQUEST, Status.NOT_FOUND)
 
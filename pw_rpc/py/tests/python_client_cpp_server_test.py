@@ -15,15 +15,18 @@
 """Tests using the callback client for pw_rpc."""
 
 import contextlib
+import logging
 from typing import List, Tuple
 import unittest
 
 import pw_hdlc.rpc
-from pw_rpc import benchmark_pb2, testing
+from pw_rpc import benchmark, benchmark_pb2, testing
 from pw_status import Status
 
 ITERATIONS = 50
 
+_LOG = logging.getLogger(__name__)
+
 
 class RpcIntegrationTest(unittest.TestCase):
     """Calls RPCs on an RPC server through a socket."""
@@ -90,6 +93,18 @@ class RpcIntegrationTest(unittest.TestCase):
                     next(first_call_responses), rpc.response(payload=b'def')
                 )
 
+    def test_benchmark(self) -> None:
+        results = benchmark.run(
+            self.rpcs.pw.rpc.Benchmark,
+            payload_sizes=(0, 32, 256),
+            concurrency_levels=(1, 4),
+            calls=ITERATIONS,
+        )
+        self.assertEqual(len(results.unary_latency), 2)
+        self.assertEqual(len(results.stream_throughput), 3)
+        self.assertEqual(len(results.concurrency), 2)
+        _LOG.info('Benchmark results: %s', results.to_json())
+
 
 def _main(
     test_server_command: List[str], port: int, unittest_args: List[str]
@@ -64,6 +64,7 @@ TEST(RawClientReader, DefaultConstructed) {
 
   EXPECT_EQ(Status::FailedPrecondition(), call.Cancel());
   EXPECT_EQ(Status::FailedPrecondition(), call.RequestCompletion());
+  EXPECT_EQ(Status::FailedPrecondition(), call.GrantCredits(1));
 
   call.set_on_completed([](Status) {});
   call.set_on_next([](ConstByteSpan) {});
@@ -123,6 +124,25 @@ TEST(RawClientReader, RequestCompletion) {
   call.set_on_error([](Status) {});
 }
 
+TEST(RawClientReader, GrantCredits_SendsCreditPacket) {
+  RawClientTestContext ctx;
+  RawClientReader call = TestService::TestServerStreamRpc(ctx.client(),
+                                                          ctx.channel().id(),
+                                                          {},
+                                                          FailIfOnNextCalled,
+                                                          FailIfCalled,
+                                                          FailIfCalled);
+  ASSERT_EQ(OkStatus(), call.GrantCredits(3));
+
+  ASSERT_EQ(ctx.output().total_packets(), 2u);  // request & credits
+  const internal::Packet& packet =
+      static_cast<internal::test::FakeChannelOutput&>(ctx.output())
+          .last_packet();
+  EXPECT_EQ(packet.type(), internal::pwpb::PacketType::CLIENT_CREDIT);
+  EXPECT_EQ(packet.credits(), 3u);
+  EXPECT_TRUE(call.active());
+}
+
 TEST(RawClientReaderWriter, RequestCompletion) {
   RawClientTestContext ctx;
   RawClientReaderWriter call =
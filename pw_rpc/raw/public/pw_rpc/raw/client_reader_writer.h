@@ -52,6 +52,10 @@ class RawClientReaderWriter : private internal::StreamResponseClientCall {
   // sending CLIENT_REQUEST_COMPLETION.
   using internal::ClientCall::RequestCompletion;
 
+  // Allows the server to send this many more stream responses. The first call
+  // enables flow control for the server stream.
+  using internal::Call::GrantCredits;
+
   // Cancels this RPC. Closes the call locally and sends a CANCELLED error to
   // the server.
   using internal::Call::Cancel;
@@ -99,6 +103,7 @@ class RawClientReader : private internal::StreamResponseClientCall {
 
   using internal::Call::Cancel;
   using internal::Call::RequestCompletion;
+  using internal::Call::GrantCredits;
   using internal::ClientCall::Abandon;
 
  private:
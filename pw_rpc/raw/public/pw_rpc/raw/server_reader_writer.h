@@ -77,6 +77,7 @@ class RawServerReaderWriter : private internal::ServerCall {
   using internal::Call::set_on_next;
   using internal::ServerCall::set_on_completion_requested;
   using internal::ServerCall::set_on_completion_requested_if_enabled;
+  using internal::ServerCall::set_on_credits_available;
 
   // Sends a response packet with the given raw payload.
   using internal::Call::Write;
@@ -192,6 +193,7 @@ class RawServerWriter : private RawServerReaderWriter {
 
   using RawServerReaderWriter::set_on_completion_requested;
   using RawServerReaderWriter::set_on_completion_requested_if_enabled;
+  using RawServerReaderWriter::set_on_credits_available;
   using RawServerReaderWriter::set_on_error;
 
   using RawServerReaderWriter::Finish;
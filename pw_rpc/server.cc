@@ -79,14 +79,14 @@ Status Server::ProcessPacket(ConstByteSpan packet_data) {
     return OkStatus();
   }
 
-  IntrusiveList<internal::Call>::iterator call = FindCall(packet);
+  internal::Call* call = FindCall(packet);
 
   switch (packet.type()) {
     case PacketType::CLIENT_STREAM:
       HandleClientStreamPacket(packet, *channel, call);
       break;
     case PacketType::CLIENT_ERROR:
-      if (call != calls_end()) {
+      if (call != nullptr) {
         call->HandleError(packet.status());
       } else {
         internal::rpc_lock().unlock();
@@ -95,6 +95,16 @@ Status Server::ProcessPacket(ConstByteSpan packet_data) {
     case PacketType::CLIENT_REQUEST_COMPLETION:
       HandleCompletionRequest(packet, *channel, call);
       break;
+    case PacketType::CLIENT_CREDIT:
+      // Credits for calls that are not pending or have no server stream are
+      // ignored, since the stream may have just finished.
+      if (call != nullptr && call->has_server_stream()) {
+        static_cast<internal::ServerCall&>(*call).HandleCredits(
+            packet.credits());
+      } else {
+        internal::rpc_lock().unlock();
+      }
+      break;
     case PacketType::REQUEST:  // Handled above
     case PacketType::RESPONSE:
     case PacketType::SERVER_ERROR:
@@ -108,25 +118,38 @@ Status Server::ProcessPacket(ConstByteSpan packet_data) {
   return OkStatus();  // OK since the packet was handled
 }
 
+Service* Server::FindService(uint32_t service_id) {
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+  Service* indexed_service = service_index_.Find(service_id);
+  if (indexed_service != nullptr || unindexed_services_ == 0u) {
+    return indexed_service;
+  }
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
+
+  auto service = std::find_if(services_.begin(), services_.end(), [&](auto& s) {
+    return internal::UnwrapServiceId(s.service_id()) == service_id;
+  });
+
+  return service == services_.end() ? nullptr : &(*service);
+}
+
 std::tuple<Service*, const internal::Method*> Server::FindMethod(
     const internal::Packet& packet) {
   // Packets always include service and method IDs.
-  auto service = std::find_if(services_.begin(), services_.end(), [&](auto& s) {
-    return internal::UnwrapServiceId(s.service_id()) == packet.service_id();
-  });
+  Service* service = FindService(packet.service_id());
 
-  if (service == services_.end()) {
+  if (service == nullptr) {
     return {};
   }
 
-  return {&(*service), service->FindMethod(packet.method_id())};
+  return {service, service->FindMethod(packet.method_id())};
 }
 
 void Server::HandleCompletionRequest(
     const internal::Packet& packet,
     internal::Channel& channel,
-    IntrusiveList<internal::Call>::iterator call) const {
-  if (call == calls_end()) {
+    internal::Call* call) const {
+  if (call == nullptr) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
     internal::rpc_lock().unlock();
@@ -154,8 +177,8 @@ void Server::HandleCompletionRequest(
 void Server::HandleClientStreamPacket(
     const internal::Packet& packet,
     internal::Channel& channel,
-    IntrusiveList<internal::Call>::iterator call) const {
-  if (call == calls_end()) {
+    internal::Call* call) const {
+  if (call == nullptr) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
     internal::rpc_lock().unlock();
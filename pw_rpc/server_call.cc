@@ -30,6 +30,35 @@ void ServerCall::MoveServerCallFrom(ServerCall& other) {
   on_client_requested_completion_ =
       std::move(other.on_client_requested_completion_);
 #endif  // PW_RPC_COMPLETION_REQUEST_CALLBACK
+
+#if PW_RPC_FLOW_CONTROL
+  on_credits_available_ = std::move(other.on_credits_available_);
+#endif  // PW_RPC_FLOW_CONTROL
+}
+
+void ServerCall::HandleCredits([[maybe_unused]] uint32_t credits) {
+#if PW_RPC_FLOW_CONTROL
+  if (AddCredits(credits) && on_credits_available_ != nullptr) {
+    const uint32_t original_id = id();
+    auto on_credits_available_local = std::move(on_credits_available_);
+    CallbackStarted();
+    rpc_lock().unlock();
+
+    on_credits_available_local();
+
+    rpc_lock().lock();
+    CallbackFinished();
+
+    // Restore the callback if the call is still active and the callback was
+    // not replaced.
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    if (active_locked() && id() == original_id &&
+        on_credits_available_ == nullptr) {
+      on_credits_available_ = std::move(on_credits_available_local);
+    }
+  }
+#endif  // PW_RPC_FLOW_CONTROL
+  rpc_lock().unlock();
 }
 
 }  // namespace pw::rpc::internal
@@ -0,0 +1,77 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/hash.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/server.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::Packet;
+using internal::pwpb::PacketType;
+
+constexpr uint32_t kChannelId = 1;
+constexpr uint32_t kServiceId = internal::Hash("pw.rpc.Benchmark");
+constexpr uint32_t kUnaryEchoId = internal::Hash("UnaryEcho");
+
+// Discards responses, so that only the server's work is measured.
+class NullOutput : public ChannelOutput {
+ public:
+  constexpr NullOutput() : ChannelOutput("null") {}
+
+  Status Send(span<const std::byte>) override { return OkStatus(); }
+};
+
+// Decodes a unary request packet, dispatches it to the service and encodes
+// and sends the response.
+void UnaryDispatchTest(perf_test::State& state, int64_t payload_size) {
+  NullOutput output;
+  std::array<Channel, 1> channels = {Channel::Create<kChannelId>(&output)};
+  Server server(channels);
+  BenchmarkService service;
+  server.RegisterService(service);
+
+  std::array<std::byte, 256> payload;
+  payload.fill(std::byte{0x5A});
+  std::array<std::byte, 512> packet_buffer;
+  const Result<ConstByteSpan> request =
+      Packet(PacketType::REQUEST,
+             kChannelId,
+             kServiceId,
+             kUnaryEchoId,
+             1,
+             span(payload).first(static_cast<size_t>(payload_size)))
+          .Encode(packet_buffer);
+  PW_ASSERT(request.ok());
+
+  while (state.KeepRunning()) {
+    server.ProcessPacket(*request).IgnoreError();
+  }
+}
+
+PW_PERF_TEST_RANGE(UnaryDispatch, UnaryDispatchTest, 1, 256, 4);
+
+}  // namespace
+}  // namespace pw::rpc
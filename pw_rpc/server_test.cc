@@ -114,6 +114,14 @@ class BasicServer : public ::testing::Test {
                                 Status::Cancelled());
   }
 
+  span<const byte> EncodeCredits(uint32_t credits) {
+    Packet packet(PacketType::CLIENT_CREDIT, 1, 42, 100, kDefaultCallId);
+    packet.set_credits(credits);
+    auto result = packet.Encode(request_buffer_);
+    EXPECT_EQ(OkStatus(), result.status());
+    return result.value_or(ConstByteSpan());
+  }
+
   template <typename T = ConstByteSpan>
   ConstByteSpan PacketForRpc(PacketType type,
                              Status status = OkStatus(),
@@ -123,7 +131,7 @@ class BasicServer : public ::testing::Test {
         type, 1, 42, 100, call_id, as_bytes(span(payload)), status);
   }
 
-  RawFakeChannelOutput<2> output_;
+  RawFakeChannelOutput<4> output_;
   std::array<Channel, 3> channels_;
   Server server_;
   TestService service_1_;
@@ -183,6 +191,43 @@ TEST_F(BasicServer, ProcessPacket_ValidMethodInService42_InvokesMethod) {
             0);
 }
 
+TEST_F(BasicServer, ProcessPacket_ManyServices_InvokesMethodInEach) {
+  TestService services[] = {
+      TestService(0x7000), TestService(3), TestService(0xffff0000),
+      TestService(77), TestService(0x100), TestService(9)};
+  for (TestService& service : services) {
+    server_.RegisterService(service);
+  }
+
+  for (TestService& service : services) {
+    const uint32_t service_id = internal::UnwrapServiceId(service.service_id());
+    EXPECT_EQ(OkStatus(),
+              server_.ProcessPacket(
+                  EncodePacket(PacketType::REQUEST, 2, service_id, 100)));
+    EXPECT_EQ(2u, service.method(100).last_channel_id());
+
+    // Each invocation sends a response when its call object is destroyed.
+    output_.clear();
+  }
+
+  server_.UnregisterService(services[1], services[4]);
+  EXPECT_EQ(
+      OkStatus(),
+      server_.ProcessPacket(EncodePacket(PacketType::REQUEST, 1, 9, 200)));
+  EXPECT_EQ(1u, services[5].method(200).last_channel_id());
+  output_.clear();
+
+  EXPECT_EQ(
+      OkStatus(),
+      server_.ProcessPacket(EncodePacket(PacketType::REQUEST, 1, 3, 100)));
+  const Packet& packet =
+      static_cast<internal::test::FakeChannelOutput&>(output_).last_packet();
+  EXPECT_EQ(packet.type(), PacketType::SERVER_ERROR);
+  EXPECT_EQ(packet.status(), Status::NotFound());
+
+  server_.UnregisterService(services[0], services[2], services[3], services[5]);
+}
+
 TEST_F(BasicServer, UnregisterService_CannotCallMethod) {
   const uint32_t kCallId = 8675309;
   server_.UnregisterService(service_1_, service_42_);
@@ -722,6 +767,59 @@ TEST_F(ServerStreamingMethod,
   EXPECT_EQ(called, PW_RPC_COMPLETION_REQUEST_CALLBACK);
 }
 
+TEST_F(ServerStreamingMethod, Credits_LimitServerStreamWrites) {
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredits(1)));
+
+  EXPECT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  EXPECT_EQ(PW_RPC_FLOW_CONTROL ? Status::ResourceExhausted() : OkStatus(),
+            responder_.Write(kDefaultPayload));
+
+  EXPECT_EQ(output_.total_packets(), PW_RPC_FLOW_CONTROL ? 1u : 2u);
+}
+
+TEST_F(ServerStreamingMethod, Credits_NotLimitedUntilGranted) {
+  EXPECT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  EXPECT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+
+  EXPECT_EQ(output_.total_packets(), 2u);
+}
+
+#if PW_RPC_FLOW_CONTROL
+
+TEST_F(ServerStreamingMethod, Credits_CallsCallbackWhenCreditsAvailable) {
+  int called = 0;
+  responder_.set_on_credits_available([&called]() { called += 1; });
+
+  // Zero credits enables flow control without allowing any writes.
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredits(0)));
+  EXPECT_EQ(Status::ResourceExhausted(), responder_.Write(kDefaultPayload));
+  EXPECT_EQ(called, 0);
+
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredits(1)));
+  EXPECT_EQ(called, 1);
+
+  // The callback is only called when credits were exhausted.
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredits(1)));
+  EXPECT_EQ(called, 1);
+
+  EXPECT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  EXPECT_EQ(OkStatus(), responder_.Write(kDefaultPayload));
+  EXPECT_EQ(Status::ResourceExhausted(), responder_.Write(kDefaultPayload));
+
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredits(5)));
+  EXPECT_EQ(called, 2);
+  EXPECT_EQ(output_.total_packets(), 2u);
+}
+
+#endif  // PW_RPC_FLOW_CONTROL
+
+TEST_F(ServerStreamingMethod, Credits_IgnoredForUnknownCall) {
+  ASSERT_EQ(OkStatus(), responder_.Finish());
+  ASSERT_EQ(OkStatus(), server_.ProcessPacket(EncodeCredits(1)));
+
+  EXPECT_EQ(output_.total_packets(), 1u);  // Only the response
+}
+
 TEST_F(ServerStreamingMethod, ClientRequestedCompletion_ErrorWhenClosed) {
   const auto end = PacketForRpc(PacketType::CLIENT_REQUEST_COMPLETION);
   ASSERT_EQ(OkStatus(), server_.ProcessPacket(end));
@@ -20,17 +20,30 @@
 namespace pw::rpc {
 
 const internal::Method* Service::FindMethod(uint32_t method_id) const {
-  const internal::MethodUnion* method_impl = methods_;
+  if (methods_sorted_) {
+    size_t low = 0;
+    size_t high = method_count_;
+
+    while (low < high) {
+      const size_t middle = low + (high - low) / 2;
+      const internal::Method& method = MethodAt(middle);
+      if (method.id() == method_id) {
+        return &method;
+      }
+      if (method.id() < method_id) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return nullptr;
+  }
 
   for (size_t i = 0; i < method_count_; ++i) {
-    const internal::Method* method = &method_impl->method();
-    if (method->id() == method_id) {
-      return method;
+    const internal::Method& method = MethodAt(i);
+    if (method.id() == method_id) {
+      return &method;
     }
-
-    const auto raw = reinterpret_cast<const std::byte*>(method_impl);
-    method_impl =
-        reinterpret_cast<const internal::MethodUnion*>(raw + method_size_);
   }
 
   return nullptr;
@@ -0,0 +1,88 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/internal/config.h"
+
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+
+#include "pw_rpc/internal/service_index.h"
+#include "pw_rpc/service.h"
+
+namespace pw::rpc::internal {
+namespace {
+
+uint32_t IdOf(const Service& service) {
+  return UnwrapServiceId(service.service_id());
+}
+
+}  // namespace
+
+size_t ServiceIndex::LowerBound(uint32_t service_id) const {
+  size_t low = 0;
+  size_t high = size_;
+
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    if (IdOf(*services_[middle]) < service_id) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+bool ServiceIndex::Insert(Service& service) {
+  if (size_ == kCapacity) {
+    return false;
+  }
+
+  const size_t index = LowerBound(IdOf(service));
+  for (size_t i = size_; i > index; --i) {
+    services_[i] = services_[i - 1];
+  }
+  services_[index] = &service;
+  size_ += 1;
+  return true;
+}
+
+bool ServiceIndex::Remove(const Service& service) {
+  const uint32_t service_id = IdOf(service);
+
+  for (size_t i = LowerBound(service_id);
+       i < size_ && IdOf(*services_[i]) == service_id;
+       ++i) {
+    if (services_[i] == &service) {
+      for (size_t j = i + 1; j < size_; ++j) {
+        services_[j - 1] = services_[j];
+      }
+      size_ -= 1;
+      services_[size_] = nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+Service* ServiceIndex::Find(uint32_t service_id) const {
+  const size_t index = LowerBound(service_id);
+  if (index < size_ && IdOf(*services_[index]) == service_id) {
+    return services_[index];
+  }
+  return nullptr;
+}
+
+}  // namespace pw::rpc::internal
+
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
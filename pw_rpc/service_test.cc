@@ -80,6 +80,38 @@ TEST(Service, MultipleMethods_FindMethod_NotPresent) {
   EXPECT_EQ(ServiceTestHelper::FindMethod(service, 999), nullptr);
 }
 
+class SortedTestService : public Service {
+ public:
+  constexpr SortedTestService()
+      : Service(0xabcd, kMethods, MethodOrder::kSortedById) {}
+
+  static constexpr std::array<ServiceTestMethodUnion, 7> kMethods = {
+      ServiceTestMethod(3, 'a'),
+      ServiceTestMethod(10, 'b'),
+      ServiceTestMethod(123, 'c'),
+      ServiceTestMethod(456, 'd'),
+      ServiceTestMethod(789, 'e'),
+      ServiceTestMethod(0x12345678, 'f'),
+      ServiceTestMethod(0xffffffff, 'g'),
+  };
+};
+
+TEST(Service, SortedMethods_FindMethod_Present) {
+  SortedTestService service;
+  for (const ServiceTestMethodUnion& method : SortedTestService::kMethods) {
+    EXPECT_EQ(ServiceTestHelper::FindMethod(service, method.method().id()),
+              &method.method());
+  }
+}
+
+TEST(Service, SortedMethods_FindMethod_NotPresent) {
+  SortedTestService service;
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 0), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 4), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 457), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 0xfffffffe), nullptr);
+}
+
 class EmptyTestService : public Service {
  public:
   constexpr EmptyTestService() : Service(0xabcd, kMethods) {}
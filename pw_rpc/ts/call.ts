@@ -240,6 +240,13 @@ export class Call {
     this.rpcs.sendClientStream(this.rpc, request);
   }
 
+  protected sendCredits(credits: number) {
+    if (credits <= 0) {
+      throw new Error('At least one credit must be granted');
+    }
+    this.rpcs.sendClientCredit(this.rpc, credits);
+  }
+
   protected finishClientStream(requests: Message[]) {
     for (const request of requests) {
       this.sendClientStream(request);
@@ -288,6 +295,14 @@ export class ServerStreamingCall extends Call {
   complete(timeoutMs?: number): Promise<[Status, Message[]]> {
     return this.streamWait(timeoutMs);
   }
+
+  /**
+   * Allows the server to send this many more stream responses. Server streams
+   * are unlimited until the first credits are granted.
+   */
+  grantCredits(credits: number) {
+    this.sendCredits(credits);
+  }
 }
 
 /** Tracks the state of a bidirectional streaming RPC call. */
@@ -305,4 +320,9 @@ export class BidirectionalStreamingCall extends Call {
     this.finishClientStream(requests);
     return await this.streamWait(timeoutMs);
   }
+
+  /** Allows the server to send this many more stream responses. */
+  grantCredits(credits: number) {
+    this.sendCredits(credits);
+  }
 }
@@ -66,6 +66,16 @@ export function encodeClientStreamEnd(ids: idSet): Uint8Array {
   return streamEnd.serializeBinary();
 }
 
+export function encodeClientCredit(ids: idSet, credits: number): Uint8Array {
+  const credit = new RpcPacket();
+  credit.setType(PacketType.CLIENT_CREDIT);
+  credit.setChannelId(ids[0]);
+  credit.setServiceId(ids[1]);
+  credit.setMethodId(ids[2]);
+  credit.setCredits(credits);
+  return credit.serializeBinary();
+}
+
 export function encodeRequest(ids: idSet, request?: Message): Uint8Array {
   const payload: Uint8Array =
     typeof request !== 'undefined'
@@ -112,6 +112,13 @@ export class PendingCalls {
     rpc.channel.send(packets.encodeClientStreamEnd(rpc.idSet));
   }
 
+  sendClientCredit(rpc: Rpc, credits: number) {
+    if (this.getPending(rpc) === undefined) {
+      throw new Error(`Attempt to send credits for inactive RPC: ${rpc}`);
+    }
+    rpc.channel.send(packets.encodeClientCredit(rpc.idSet, credits));
+  }
+
   /** Cancels the RPC. Returns the CLIENT_ERROR packet to send. */
   cancel(rpc: Rpc): Uint8Array {
     console.debug(`Cancelling ${rpc}`);
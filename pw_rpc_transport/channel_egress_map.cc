@@ -0,0 +1,80 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/channel_egress_map.h"
+
+namespace pw::rpc {
+
+Status ChannelEgressMap::Register(uint32_t channel_id,
+                                  RpcEgressHandler& egress) {
+  if (channel_id <= kMaxDenseChannelId) {
+    if (dense_egresses_[channel_id] != nullptr) {
+      return Status::AlreadyExists();
+    }
+    dense_egresses_[channel_id] = &egress;
+    return OkStatus();
+  }
+
+  if (sparse_entries_.empty()) {
+    return Status::ResourceExhausted();
+  }
+  SparseEntry& entry = sparse_entries_[FindSparseIndex(channel_id)];
+  if (entry.egress != nullptr) {
+    return Status::AlreadyExists();
+  }
+  if (sparse_size_ == sparse_capacity()) {
+    return Status::ResourceExhausted();
+  }
+  entry.channel_id = channel_id;
+  entry.egress = &egress;
+  sparse_size_ += 1;
+  return OkStatus();
+}
+
+Status ChannelEgressMap::Unregister(uint32_t channel_id) {
+  if (channel_id <= kMaxDenseChannelId) {
+    if (dense_egresses_[channel_id] == nullptr) {
+      return Status::NotFound();
+    }
+    dense_egresses_[channel_id] = nullptr;
+    return OkStatus();
+  }
+
+  if (sparse_entries_.empty()) {
+    return Status::NotFound();
+  }
+  size_t hole = FindSparseIndex(channel_id);
+  if (sparse_entries_[hole].egress == nullptr) {
+    return Status::NotFound();
+  }
+
+  // Shift later entries of the probe sequence back into the hole, so lookups
+  // never stop early at a free slot and no tombstones are needed.
+  for (size_t index = NextIndex(hole); sparse_entries_[index].egress != nullptr;
+       index = NextIndex(index)) {
+    const size_t home = HomeIndex(sparse_entries_[index].channel_id);
+    // Entries whose home is cyclically in (hole, index] stay where they are.
+    const bool stays = hole <= index ? (hole < home && home <= index)
+                                     : (hole < home || home <= index);
+    if (!stays) {
+      sparse_entries_[hole] = sparse_entries_[index];
+      hole = index;
+    }
+  }
+  sparse_entries_[hole] = SparseEntry{};
+  sparse_size_ -= 1;
+  return OkStatus();
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,116 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/channel_egress_map.h"
+
+#include <array>
+
+#include "gtest/gtest.h"
+
+namespace pw::rpc {
+namespace {
+
+class TestEgress : public RpcEgressHandler {
+ public:
+  Status SendRpcPacket(ConstByteSpan) override { return OkStatus(); }
+};
+
+TEST(ChannelEgressMap, RegistersDenseChannels) {
+  TestEgress egress_a;
+  TestEgress egress_b;
+  ChannelEgressMap map;
+
+  EXPECT_EQ(map.Register(0, egress_a), OkStatus());
+  EXPECT_EQ(map.Register(ChannelEgressMap::kMaxDenseChannelId, egress_b),
+            OkStatus());
+  EXPECT_EQ(map.Find(0), &egress_a);
+  EXPECT_EQ(map.Find(ChannelEgressMap::kMaxDenseChannelId), &egress_b);
+  EXPECT_EQ(map.Find(1), nullptr);
+  EXPECT_EQ(map.Register(0, egress_b), Status::AlreadyExists());
+}
+
+TEST(ChannelEgressMap, RejectsSparseChannelsWithoutStorage) {
+  TestEgress egress;
+  ChannelEgressMap map;
+
+  EXPECT_FALSE(map.Supports(ChannelEgressMap::kMaxDenseChannelId + 1));
+  EXPECT_EQ(map.Register(ChannelEgressMap::kMaxDenseChannelId + 1, egress),
+            Status::ResourceExhausted());
+  EXPECT_EQ(map.Find(ChannelEgressMap::kMaxDenseChannelId + 1), nullptr);
+}
+
+TEST(ChannelEgressMap, RegistersSparseChannels) {
+  std::array<TestEgress, 3> egresses;
+  ChannelEgressMapBuffer<3> map;
+
+  EXPECT_TRUE(map.Supports(100000));
+  EXPECT_EQ(map.sparse_capacity(), 3u);
+  EXPECT_EQ(map.Register(100, egresses[0]), OkStatus());
+  EXPECT_EQ(map.Register(100000, egresses[1]), OkStatus());
+  EXPECT_EQ(map.Register(0xFFFFFFFF, egresses[2]), OkStatus());
+  EXPECT_EQ(map.sparse_size(), 3u);
+
+  EXPECT_EQ(map.Find(100), &egresses[0]);
+  EXPECT_EQ(map.Find(100000), &egresses[1]);
+  EXPECT_EQ(map.Find(0xFFFFFFFF), &egresses[2]);
+  EXPECT_EQ(map.Find(101), nullptr);
+
+  EXPECT_EQ(map.Register(100, egresses[1]), Status::AlreadyExists());
+  EXPECT_EQ(map.Register(200, egresses[1]), Status::ResourceExhausted());
+}
+
+TEST(ChannelEgressMap, UnregistersChannels) {
+  TestEgress egress;
+  ChannelEgressMapBuffer<2> map;
+
+  ASSERT_EQ(map.Register(1, egress), OkStatus());
+  ASSERT_EQ(map.Register(1000, egress), OkStatus());
+
+  EXPECT_EQ(map.Unregister(1), OkStatus());
+  EXPECT_EQ(map.Unregister(1000), OkStatus());
+  EXPECT_EQ(map.Find(1), nullptr);
+  EXPECT_EQ(map.Find(1000), nullptr);
+  EXPECT_EQ(map.sparse_size(), 0u);
+
+  EXPECT_EQ(map.Unregister(1), Status::NotFound());
+  EXPECT_EQ(map.Unregister(1000), Status::NotFound());
+}
+
+TEST(ChannelEgressMap, FindsChannelsAfterUnregisteringCollisions) {
+  constexpr size_t kChannels = 48;
+  std::array<TestEgress, kChannels> egresses;
+  ChannelEgressMapBuffer<kChannels> map;
+
+  // Register and remove channels in an interleaved order so that probe
+  // sequences collide and entries are shifted on removal.
+  for (uint32_t round = 0; round < 4; ++round) {
+    for (uint32_t i = 0; i < kChannels; ++i) {
+      ASSERT_EQ(map.Register(1000 + i * 7 + round, egresses[i]), OkStatus());
+    }
+    for (uint32_t i = 0; i < kChannels; i += 2) {
+      ASSERT_EQ(map.Unregister(1000 + i * 7 + round), OkStatus());
+    }
+    for (uint32_t i = 0; i < kChannels; ++i) {
+      EXPECT_EQ(map.Find(1000 + i * 7 + round),
+                i % 2 == 0 ? nullptr : &egresses[i]);
+    }
+    for (uint32_t i = 1; i < kChannels; i += 2) {
+      ASSERT_EQ(map.Unregister(1000 + i * 7 + round), OkStatus());
+    }
+    EXPECT_EQ(map.sparse_size(), 0u);
+  }
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -342,6 +342,44 @@ TEST(RpcEgressIngressTest, ChannelIdOverflow) {
   EXPECT_EQ(ingress.num_egress_errors(), 0u);
 }
 
+TEST(RpcEgressIngressTest, HighChannelIdWithStorage) {
+  constexpr uint32_t kHighChannelId = 100000;
+  constexpr size_t kMtu = 128;
+
+  TestTransport transport(kMtu);
+  SimpleRpcEgress<kMaxPacketSize> egress("test", transport);
+
+  std::array sender_tx_channels = {
+      rpc::Channel::Create<kHighChannelId>(&egress)};
+
+  ServiceRegistry registry(sender_tx_channels);
+  auto client =
+      registry
+          .CreateClient<pw_rpc_transport::testing::pw_rpc::pwpb::TestService>(
+              kHighChannelId);
+
+  TestLocalEgress local_egress;
+  ChannelEgressMap::SparseStorage<1> high_channels;
+  SimpleRpcIngress<kMaxPacketSize> ingress({}, high_channels);
+  EXPECT_EQ(ingress.RegisterChannel(kHighChannelId, local_egress), OkStatus());
+  EXPECT_EQ(ingress.RegisterChannel(kHighChannelId + 1, local_egress),
+            Status::ResourceExhausted());
+
+  auto receiver = client.Echo({.msg = "test"});
+
+  // The local egress has no registry, so it fails to handle the packet.
+  EXPECT_EQ(ingress.ProcessIncomingData(transport.buffer()), OkStatus());
+
+  EXPECT_EQ(ingress.num_bad_packets(), 0u);
+  EXPECT_EQ(ingress.num_overflow_channel_ids(), 0u);
+  EXPECT_EQ(ingress.num_missing_egresses(), 0u);
+  EXPECT_EQ(ingress.num_egress_errors(), 1u);
+
+  EXPECT_EQ(ingress.UnregisterChannel(kHighChannelId), OkStatus());
+  EXPECT_EQ(ingress.ProcessIncomingData(transport.buffer()), OkStatus());
+  EXPECT_EQ(ingress.num_missing_egresses(), 1u);
+}
+
 TEST(RpcEgressIngressTest, MissingEgressForIncomingPacket) {
   constexpr uint32_t kChannelA = 22;
   constexpr uint32_t kChannelB = 33;
@@ -0,0 +1,38 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PW_RPC"
+
+#include "pw_rpc_transport/epoll_socket_rpc_transport.h"
+
+#include "pw_log/log.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc::internal {
+
+void LogEpollSocketReadError(pw::Status status) {
+  if (status.IsOutOfRange()) {
+    PW_LOG_INFO("EpollSocketRpcTransport: connection closed by peer");
+    return;
+  }
+  PW_LOG_ERROR("EpollSocketRpcTransport: socket read error. Status %d",
+               status.code());
+}
+
+void LogEpollSocketIngressHandlerError(pw::Status status) {
+  PW_LOG_ERROR("EpollSocketRpcTransport: ingress handler error. Status %d",
+               status.code());
+}
+
+}  // namespace pw::rpc::internal
@@ -0,0 +1,227 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/epoll_socket_rpc_transport.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_async_basic/epoll_dispatcher.h"
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/socket_stream.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr size_t kReadBufferSize = 64;
+using Transport = EpollSocketRpcTransport<kReadBufferSize>;
+
+class TestIngress : public RpcIngressHandler {
+ public:
+  explicit TestIngress(size_t num_bytes_expected)
+      : num_bytes_expected_(num_bytes_expected) {}
+
+  Status ProcessIncomingData(ConstByteSpan buffer) override {
+    std::copy(buffer.begin(), buffer.end(), std::back_inserter(received_));
+    if (received_.size() == num_bytes_expected_) {
+      done_.release();
+    }
+    return OkStatus();
+  }
+
+  const std::vector<std::byte>& received() const { return received_; }
+  void Wait() { done_.acquire(); }
+
+ private:
+  size_t num_bytes_expected_;
+  sync::ThreadNotification done_;
+  std::vector<std::byte> received_;
+};
+
+// Connects a pair of sockets over loopback.
+void ConnectPair(stream::ServerSocket& server,
+                 stream::SocketStream& server_end,
+                 stream::SocketStream& client_end) {
+  Result<stream::SocketStream> accepted = Status::Unknown();
+  std::thread accept_thread([&] { accepted = server.Accept(); });
+  ASSERT_EQ(client_end.Connect("localhost", server.port()), OkStatus());
+  accept_thread.join();
+  ASSERT_EQ(accepted.status(), OkStatus());
+  server_end = std::move(*accepted);
+}
+
+std::vector<std::byte> MakeData(size_t size, uint8_t seed) {
+  std::vector<std::byte> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<std::byte>(seed + i * 7);
+  }
+  return data;
+}
+
+// Sends data in frames with a four byte header.
+void SendFrames(Transport& transport, ConstByteSpan data) {
+  while (!data.empty()) {
+    const size_t size = std::min<size_t>(data.size(), 4 + data.size() % 37);
+    const size_t header_size = std::min<size_t>(size, 4);
+    const RpcFrame frame{
+        .header = data.first(header_size),
+        .payload = data.subspan(header_size, size - header_size)};
+    ASSERT_EQ(transport.Send(frame), OkStatus());
+    data = data.subspan(size);
+  }
+}
+
+TEST(EpollSocketRpcTransportTest, SendAndReceiveFrames) {
+  constexpr size_t kDataSize = 8192;
+  const std::vector<std::byte> client_data = MakeData(kDataSize, 1);
+  const std::vector<std::byte> server_data = MakeData(kDataSize, 2);
+
+  stream::ServerSocket server;
+  ASSERT_EQ(server.Listen(), OkStatus());
+  stream::SocketStream server_socket;
+  stream::SocketStream client_socket;
+  ConnectPair(server, server_socket, client_socket);
+
+  async::EpollDispatcher dispatcher;
+  TestIngress server_ingress(kDataSize);
+  TestIngress client_ingress(kDataSize);
+  Transport server_transport(dispatcher, server_ingress);
+  Transport client_transport(dispatcher, client_ingress);
+  EXPECT_EQ(server_transport.Send({}), Status::FailedPrecondition());
+  ASSERT_EQ(server_transport.Start(std::move(server_socket)), OkStatus());
+  ASSERT_EQ(client_transport.Start(std::move(client_socket)), OkStatus());
+  EXPECT_TRUE(server_transport.connected());
+  EXPECT_EQ(server_transport.Start(stream::SocketStream()),
+            Status::FailedPrecondition());
+
+  // Both ends are read by the same dispatcher thread.
+  thread::Thread dispatcher_thread(thread::stl::Options(), dispatcher);
+
+  std::thread client_sender([&] { SendFrames(client_transport, client_data); });
+  SendFrames(server_transport, server_data);
+  client_sender.join();
+
+  server_ingress.Wait();
+  client_ingress.Wait();
+  dispatcher.RequestStop();
+  dispatcher_thread.join();
+
+  EXPECT_EQ(server_ingress.received(), client_data);
+  EXPECT_EQ(client_ingress.received(), server_data);
+}
+
+TEST(EpollSocketRpcTransportTest, ManyConnectionsShareOneThread) {
+  constexpr size_t kConnections = 16;
+  constexpr size_t kDataSize = 1024;
+
+  stream::ServerSocket server;
+  ASSERT_EQ(server.Listen(), OkStatus());
+
+  async::EpollDispatcher dispatcher;
+  std::array<stream::SocketStream, kConnections> clients;
+  std::vector<std::unique_ptr<TestIngress>> ingresses;
+  std::vector<std::unique_ptr<Transport>> transports;
+  for (size_t i = 0; i < kConnections; ++i) {
+    stream::SocketStream server_socket;
+    ConnectPair(server, server_socket, clients[i]);
+    ingresses.push_back(std::make_unique<TestIngress>(kDataSize));
+    transports.push_back(
+        std::make_unique<Transport>(dispatcher, *ingresses.back()));
+    ASSERT_EQ(transports.back()->Start(std::move(server_socket)), OkStatus());
+  }
+
+  thread::Thread dispatcher_thread(thread::stl::Options(), dispatcher);
+
+  for (size_t i = 0; i < kConnections; ++i) {
+    const std::vector<std::byte> data =
+        MakeData(kDataSize, static_cast<uint8_t>(i));
+    ASSERT_EQ(clients[i].Write(data), OkStatus());
+  }
+  for (size_t i = 0; i < kConnections; ++i) {
+    ingresses[i]->Wait();
+    EXPECT_EQ(ingresses[i]->received(),
+              MakeData(kDataSize, static_cast<uint8_t>(i)));
+  }
+
+  dispatcher.RequestStop();
+  dispatcher_thread.join();
+}
+
+TEST(EpollSocketRpcTransportTest, PeerDisconnectStopsTransport) {
+  stream::ServerSocket server;
+  ASSERT_EQ(server.Listen(), OkStatus());
+  stream::SocketStream server_socket;
+  stream::SocketStream client_socket;
+  ConnectPair(server, server_socket, client_socket);
+
+  async::EpollDispatcher dispatcher;
+  TestIngress ingress(0);
+  Transport transport(dispatcher, ingress);
+  sync::ThreadNotification disconnected;
+  transport.set_disconnect_handler([&disconnected] { disconnected.release(); });
+  ASSERT_EQ(transport.Start(std::move(server_socket)), OkStatus());
+
+  thread::Thread dispatcher_thread(thread::stl::Options(), dispatcher);
+  client_socket.Close();
+  disconnected.acquire();
+
+  EXPECT_FALSE(transport.connected());
+  EXPECT_EQ(transport.Send({}), Status::FailedPrecondition());
+
+  dispatcher.RequestStop();
+  dispatcher_thread.join();
+}
+
+TEST(EpollSocketRpcTransportTest, SendTimesOutWhenPeerStopsReading) {
+  stream::ServerSocket server;
+  ASSERT_EQ(server.Listen(), OkStatus());
+  stream::SocketStream server_socket;
+  stream::SocketStream client_socket;
+  ConnectPair(server, server_socket, client_socket);
+
+  async::EpollDispatcher dispatcher;
+  TestIngress ingress(0);
+  Transport transport(dispatcher, ingress, std::chrono::milliseconds(10));
+  sync::ThreadNotification disconnected;
+  transport.set_disconnect_handler([&disconnected] { disconnected.release(); });
+  ASSERT_EQ(transport.Start(std::move(server_socket)), OkStatus());
+
+  thread::Thread dispatcher_thread(thread::stl::Options(), dispatcher);
+
+  // The client never reads, so the socket buffers eventually fill up.
+  const std::vector<std::byte> payload = MakeData(4096, 3);
+  Status status;
+  while ((status = transport.Send({.header = {}, .payload = payload})).ok()) {
+  }
+  EXPECT_EQ(status, Status::DeadlineExceeded());
+
+  // The partially sent connection is shut down and the transport stopped.
+  disconnected.acquire();
+  EXPECT_FALSE(transport.connected());
+
+  dispatcher.RequestStop();
+  dispatcher_thread.join();
+}
+
+}  // namespace
+}  // namespace pw::rpc
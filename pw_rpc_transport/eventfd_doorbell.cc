@@ -0,0 +1,58 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PW_RPC"
+
+#include "pw_rpc_transport/eventfd_doorbell.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+
+#include "pw_log/log.h"
+
+namespace pw::rpc {
+
+Result<EventfdDoorbell> EventfdDoorbell::Create() {
+  const int fd = eventfd(0, EFD_CLOEXEC);
+  if (fd < 0) {
+    PW_LOG_ERROR("Failed to create eventfd, errno %d", errno);
+    return Status::Internal();
+  }
+  return EventfdDoorbell(fd, /*owned=*/true);
+}
+
+EventfdDoorbell::~EventfdDoorbell() {
+  if (owned_) {
+    close(fd_);
+  }
+}
+
+void EventfdDoorbell::Ring() {
+  const uint64_t count = 1;
+  // Writes only fail if the counter would overflow, in which case the reader
+  // is already awake.
+  [[maybe_unused]] ssize_t result = write(fd_, &count, sizeof(count));
+}
+
+void EventfdDoorbell::Wait() {
+  uint64_t count;
+  // Reading resets the counter, so rings while not waiting wake one Wait().
+  while (read(fd_, &count, sizeof(count)) < 0 && errno == EINTR) {
+  }
+}
+
+}  // namespace pw::rpc
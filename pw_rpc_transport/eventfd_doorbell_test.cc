@@ -0,0 +1,57 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/eventfd_doorbell.h"
+
+#include "gtest/gtest.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/thread_core.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::rpc {
+namespace {
+
+class Ringer : public thread::ThreadCore {
+ public:
+  explicit Ringer(Doorbell& doorbell) : doorbell_(doorbell) {}
+
+ private:
+  void Run() override { doorbell_.Ring(); }
+
+  Doorbell& doorbell_;
+};
+
+TEST(EventfdDoorbell, RingBeforeWaitIsNotLost) {
+  Result<EventfdDoorbell> doorbell = EventfdDoorbell::Create();
+  ASSERT_EQ(doorbell.status(), OkStatus());
+
+  doorbell->Ring();
+  doorbell->Ring();
+  doorbell->Wait();
+}
+
+TEST(EventfdDoorbell, WakesOtherSide) {
+  Result<EventfdDoorbell> doorbell = EventfdDoorbell::Create();
+  ASSERT_EQ(doorbell.status(), OkStatus());
+  // The other side shares the eventfd, as another process would.
+  EventfdDoorbell other_side(doorbell->fd());
+
+  Ringer ringer(other_side);
+  thread::Thread ringer_thread(thread::stl::Options(), ringer);
+  doorbell->Wait();
+  ringer_thread.join();
+}
+
+}  // namespace
+}  // namespace pw::rpc
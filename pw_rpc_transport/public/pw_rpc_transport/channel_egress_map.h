@@ -0,0 +1,130 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_rpc_transport/rpc_transport.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+// Maps RPC channel IDs to the egresses their packets are sent to. IDs up to
+// kMaxDenseChannelId are looked up directly in an array. Higher IDs are kept in
+// an open-addressing hash table in storage provided by the user, which is kept
+// at most three quarters full so lookups take constant time regardless of how
+// many channels are registered.
+//
+// ChannelEgressMap is not thread-safe.
+class ChannelEgressMap {
+ public:
+  static constexpr uint32_t kMaxDenseChannelId = 64;
+
+  // A slot in the hash table for channel IDs above kMaxDenseChannelId. A slot
+  // is free if its egress is null.
+  struct SparseEntry {
+    uint32_t channel_id = 0;
+    RpcEgressHandler* egress = nullptr;
+  };
+
+  // Storage for kChannels channel IDs above kMaxDenseChannelId, sized so the
+  // hash table is at most three quarters full.
+  template <size_t kChannels>
+  using SparseStorage = std::array<SparseEntry, (kChannels * 4 + 2) / 3>;
+
+  // Creates a map which only holds channel IDs up to kMaxDenseChannelId.
+  constexpr ChannelEgressMap() = default;
+
+  // Creates a map which holds higher channel IDs in sparse_entries. At most
+  // three quarters of the entries are used; see SparseStorage.
+  explicit constexpr ChannelEgressMap(span<SparseEntry> sparse_entries)
+      : sparse_entries_(sparse_entries) {}
+
+  ChannelEgressMap(const ChannelEgressMap&) = delete;
+  ChannelEgressMap& operator=(const ChannelEgressMap&) = delete;
+
+  // Sets the egress for a channel. Returns:
+  //
+  //   OK - The channel was registered.
+  //   ALREADY_EXISTS - The channel already has an egress.
+  //   RESOURCE_EXHAUSTED - There is no room for the channel ID.
+  //
+  Status Register(uint32_t channel_id, RpcEgressHandler& egress);
+
+  // Removes the egress for a channel. Returns NOT_FOUND if the channel has no
+  // egress.
+  Status Unregister(uint32_t channel_id);
+
+  // Returns the egress for a channel, or null if it has none.
+  RpcEgressHandler* Find(uint32_t channel_id) const {
+    if (channel_id <= kMaxDenseChannelId) {
+      return dense_egresses_[channel_id];
+    }
+    if (sparse_entries_.empty()) {
+      return nullptr;
+    }
+    // The slot found is free, with a null egress, if the ID is not registered.
+    return sparse_entries_[FindSparseIndex(channel_id)].egress;
+  }
+
+  // Whether the map can hold channel_id at all, ignoring how full it is.
+  bool Supports(uint32_t channel_id) const {
+    return channel_id <= kMaxDenseChannelId || !sparse_entries_.empty();
+  }
+
+  // The number of channel IDs above kMaxDenseChannelId which can be registered.
+  size_t sparse_capacity() const { return sparse_entries_.size() * 3 / 4; }
+
+  size_t sparse_size() const { return sparse_size_; }
+
+ private:
+  // Returns the index of the slot holding channel_id, or of the free slot
+  // where it would go. Must only be called with sparse storage.
+  size_t FindSparseIndex(uint32_t channel_id) const {
+    size_t index = HomeIndex(channel_id);
+    while (sparse_entries_[index].egress != nullptr &&
+           sparse_entries_[index].channel_id != channel_id) {
+      index = NextIndex(index);
+    }
+    return index;
+  }
+
+  size_t HomeIndex(uint32_t channel_id) const {
+    return (channel_id * 0x9E3779B1u) % sparse_entries_.size();
+  }
+
+  size_t NextIndex(size_t index) const {
+    return index + 1 == sparse_entries_.size() ? 0 : index + 1;
+  }
+
+  std::array<RpcEgressHandler*, kMaxDenseChannelId + 1> dense_egresses_{};
+  span<SparseEntry> sparse_entries_;
+  size_t sparse_size_ = 0;
+};
+
+// A ChannelEgressMap with storage for kSparseChannels channel IDs above
+// ChannelEgressMap::kMaxDenseChannelId.
+template <size_t kSparseChannels>
+class ChannelEgressMapBuffer : public ChannelEgressMap {
+ public:
+  constexpr ChannelEgressMapBuffer() : ChannelEgressMap(sparse_entries_) {}
+
+ private:
+  SparseStorage<kSparseChannels> sparse_entries_{};
+};
+
+}  // namespace pw::rpc
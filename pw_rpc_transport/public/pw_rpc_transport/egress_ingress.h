@@ -21,6 +21,7 @@
 #include "pw_metric/metric.h"
 #include "pw_rpc/channel.h"
 #include "pw_rpc/packet_meta.h"
+#include "pw_rpc_transport/channel_egress_map.h"
 #include "pw_rpc_transport/hdlc_framing.h"
 #include "pw_rpc_transport/rpc_transport.h"
 #include "pw_rpc_transport/simple_framing.h"
@@ -90,19 +91,47 @@ struct ChannelEgress {
 
 // Handler for incoming RPC packets. RpcIngress is not thread-safe and must be
 // accessed from a single thread (typically the RPC RX thread).
+//
+// Channel IDs up to kMaxChannelId are looked up in an array. Higher channel IDs
+// are only supported if storage for them is provided, for example:
+//
+//   ChannelEgressMap::SparseStorage<1000> high_channels;
+//   HdlcRpcIngress<kMaxPacketSize> ingress(channels, high_channels);
+//
 template <typename Decoder>
 class RpcIngress : public RpcIngressHandler {
  public:
-  static constexpr size_t kMaxChannelId = 64;
+  static constexpr size_t kMaxChannelId = ChannelEgressMap::kMaxDenseChannelId;
+
   RpcIngress() = default;
 
-  explicit RpcIngress(span<ChannelEgress> channel_egresses) {
+  explicit RpcIngress(span<ChannelEgress> channel_egresses)
+      : RpcIngress(channel_egresses, {}) {}
+
+  RpcIngress(span<ChannelEgress> channel_egresses,
+             span<ChannelEgressMap::SparseEntry> high_channel_storage)
+      : channel_egresses_(high_channel_storage) {
     for (auto& channel : channel_egresses) {
-      PW_ASSERT(channel.channel_id <= kMaxChannelId);
-      channel_egresses_[channel.channel_id] = channel.egress;
+      PW_ASSERT(RegisterChannel(channel.channel_id, *channel.egress).ok());
     }
   }
 
+  // Sends packets received on a channel to egress. Returns:
+  //
+  //   OK - The channel was registered.
+  //   ALREADY_EXISTS - The channel already has an egress.
+  //   RESOURCE_EXHAUSTED - There is no room for the channel ID.
+  //
+  Status RegisterChannel(uint32_t channel_id, RpcEgressHandler& egress) {
+    return channel_egresses_.Register(channel_id, egress);
+  }
+
+  // Stops sending packets received on a channel to its egress. Returns
+  // NOT_FOUND if the channel has no egress.
+  Status UnregisterChannel(uint32_t channel_id) {
+    return channel_egresses_.Unregister(channel_id);
+  }
+
   const metric::Group& metrics() const { return metrics_; }
 
   uint32_t num_bad_packets() const { return bad_packets_.value(); }
@@ -125,13 +154,13 @@ class RpcIngress : public RpcIngressHandler {
         internal::LogBadPacket();
         return;
       }
-      if (packet_meta->channel_id() > kMaxChannelId) {
+      if (!channel_egresses_.Supports(packet_meta->channel_id())) {
         overflow_channel_ids_.Increment();
         internal::LogChannelIdOverflow(packet_meta->channel_id(),
                                        kMaxChannelId);
         return;
       }
-      auto* egress = channel_egresses_[packet_meta->channel_id()];
+      auto* egress = channel_egresses_.Find(packet_meta->channel_id());
       if (egress == nullptr) {
         missing_egresses_.Increment();
         internal::LogMissingEgressForChannel(packet_meta->channel_id());
@@ -146,7 +175,7 @@ class RpcIngress : public RpcIngressHandler {
   }
 
  private:
-  std::array<RpcEgressHandler*, kMaxChannelId + 1> channel_egresses_{};
+  ChannelEgressMap channel_egresses_;
   Decoder decoder_;
   PW_METRIC_GROUP(metrics_, "pw_rpc_transport");
   PW_METRIC(metrics_, bad_packets_, "bad_packets", 0u);
@@ -0,0 +1,203 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <mutex>
+#include <utility>
+
+#include "pw_async_basic/epoll_dispatcher.h"
+#include "pw_bytes/span.h"
+#include "pw_function/function.h"
+#include "pw_rpc_transport/rpc_transport.h"
+#include "pw_status/status.h"
+#include "pw_stream/socket_stream.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::rpc {
+
+namespace internal {
+
+void LogEpollSocketReadError(Status);
+void LogEpollSocketIngressHandlerError(Status);
+
+}  // namespace internal
+
+/// An RPC transport over a connected socket that reads on an
+/// `async::EpollDispatcher` thread.
+///
+/// Unlike `SocketRpcTransport`, which needs a thread for each connection, any
+/// number of `EpollSocketRpcTransport`s can share one dispatcher. The socket is
+/// switched to non-blocking mode, and each time it is readable the dispatcher
+/// thread reads up to `kReadBufferSize` bytes and passes them to the ingress
+/// handler. `Send` may be called from any thread, including the dispatcher
+/// thread from the ingress handler. A send waits at most `send_timeout` for
+/// the peer to make space, so a peer that stops reading cannot stall the
+/// dispatcher indefinitely.
+///
+/// The transport does not establish connections. Connect or accept the socket
+/// separately, for example with `stream::ServerSocket`, and pass it to `Start`.
+template <size_t kReadBufferSize>
+class EpollSocketRpcTransport : public RpcFrameSender {
+ public:
+  static constexpr std::chrono::milliseconds kDefaultSendTimeout{1000};
+
+  EpollSocketRpcTransport(
+      async::EpollDispatcher& dispatcher,
+      RpcIngressHandler& ingress,
+      std::chrono::milliseconds send_timeout = kDefaultSendTimeout)
+      : dispatcher_(dispatcher),
+        ingress_(ingress),
+        watcher_([this] { ReadData(); }),
+        send_timeout_(send_timeout) {}
+
+  /// Must not be destroyed while the dispatcher is running unless it was
+  /// stopped on the dispatcher thread.
+  ~EpollSocketRpcTransport() override { Stop(); }
+
+  EpollSocketRpcTransport(const EpollSocketRpcTransport&) = delete;
+  EpollSocketRpcTransport& operator=(const EpollSocketRpcTransport&) = delete;
+
+  size_t MaximumTransmissionUnit() const override { return kReadBufferSize; }
+
+  /// Sets a function to call on the dispatcher thread when the peer closes the
+  /// connection or reading from the socket fails. The transport is stopped
+  /// before the function is called, so the function may `Start` it again
+  /// with a new socket.
+  void set_disconnect_handler(Function<void()>&& on_disconnect) {
+    on_disconnect_ = std::move(on_disconnect);
+  }
+
+  /// Takes ownership of a connected socket and starts reading from it.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The transport is connected.
+  /// * @pw_status{FAILED_PRECONDITION} - The transport is already connected,
+  ///   or the socket is not.
+  /// * Any error from `SocketStream::SetNonBlocking` or
+  ///   `EpollDispatcher::Watch`.
+  Status Start(stream::SocketStream&& socket) {
+    if (connected_) {
+      return Status::FailedPrecondition();
+    }
+    std::lock_guard lock(write_mutex_);
+    socket_ = std::move(socket);
+    socket_.SetWriteTimeout(send_timeout_);
+    if (Status status = socket_.SetNonBlocking(true); !status.ok()) {
+      socket_.Close();
+      return status;
+    }
+    if (Status status = dispatcher_.Watch(socket_.connection_fd(), watcher_);
+        !status.ok()) {
+      socket_.Close();
+      return status;
+    }
+    connected_ = true;
+    return OkStatus();
+  }
+
+  /// Stops reading and closes the socket. This must be called on the
+  /// dispatcher thread or while the dispatcher is not running.
+  void Stop() {
+    dispatcher_.Unwatch(watcher_);
+    std::lock_guard lock(write_mutex_);
+    socket_.Close();
+    connected_ = false;
+  }
+
+  bool connected() const { return connected_; }
+
+  /// Writes the frame to the socket, waiting up to the send timeout for space
+  /// in the socket's send buffer if needed.
+  ///
+  /// If the frame cannot be sent, part of it may have been, so the connection
+  /// is shut down. Later sends fail, and the dispatcher thread stops the
+  /// transport and calls the disconnect handler.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The frame was sent.
+  /// * @pw_status{FAILED_PRECONDITION} - The transport is not connected.
+  /// * @pw_status{DEADLINE_EXCEEDED} - The peer did not make space for the
+  ///   frame within the send timeout.
+  /// * Any other error from `SocketStream::WriteV`.
+  Status Send(RpcFrame frame) override {
+    std::lock_guard lock(write_mutex_);
+    if (!connected_) {
+      return Status::FailedPrecondition();
+    }
+    const std::array<ConstByteSpan, 2> buffers = {frame.header, frame.payload};
+    const Status status = socket_.WriteV(buffers);
+    if (!status.ok()) {
+      // shutdown() does not release the descriptor, so the dispatcher thread
+      // can still safely read from it until it stops the transport.
+      shutdown(socket_.connection_fd(), SHUT_RDWR);
+    }
+    return status;
+  }
+
+ private:
+  // Called on the dispatcher thread when the socket is readable. Reads once per
+  // call so that a busy connection cannot starve the others; the dispatcher
+  // calls this again if more data is available.
+  //
+  // This reads from the descriptor directly rather than with socket_.Read(),
+  // since SocketStream closes its descriptor when the peer disconnects. The
+  // descriptor must only be closed while holding write_mutex_, so that Send()
+  // never writes to a closed or reused descriptor.
+  void ReadData() {
+    const ssize_t bytes_read = recv(
+        socket_.connection_fd(), read_buffer_.data(), read_buffer_.size(), 0);
+    if (bytes_read < 0 &&
+        (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+      return;  // Spurious wakeup; no data is available.
+    }
+    if (bytes_read <= 0) {
+      // A read of 0 bytes means the peer closed the connection.
+      internal::LogEpollSocketReadError(bytes_read == 0 ? Status::OutOfRange()
+                                                        : Status::Unknown());
+      Stop();
+      if (on_disconnect_ != nullptr) {
+        on_disconnect_();
+      }
+      return;
+    }
+    const Status ingress_status = ingress_.ProcessIncomingData(
+        span(read_buffer_).first(static_cast<size_t>(bytes_read)));
+    if (!ingress_status.ok()) {
+      internal::LogEpollSocketIngressHandlerError(ingress_status);
+    }
+  }
+
+  async::EpollDispatcher& dispatcher_;
+  RpcIngressHandler& ingress_;
+  async::FdWatcher watcher_;
+  Function<void()> on_disconnect_;
+  const std::chrono::milliseconds send_timeout_;
+
+  // write_mutex_ must be held by the thread performing socket writes, and to
+  // replace or close the socket.
+  sync::Mutex write_mutex_;
+  stream::SocketStream socket_;
+  std::atomic<bool> connected_ = false;
+  std::array<std::byte, kReadBufferSize> read_buffer_{};
+};
+
+}  // namespace pw::rpc
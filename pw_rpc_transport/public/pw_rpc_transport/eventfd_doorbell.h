@@ -0,0 +1,52 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_result/result.h"
+#include "pw_rpc_transport/shared_memory_rpc_transport.h"
+
+namespace pw::rpc {
+
+// A Doorbell for processes on the same Linux host, using an eventfd shared
+// between them, such as one created before fork() or passed over a Unix domain
+// socket. Linux only.
+class EventfdDoorbell final : public Doorbell {
+ public:
+  // Creates a new eventfd, which the doorbell owns.
+  static Result<EventfdDoorbell> Create();
+
+  // Uses an existing eventfd, which the doorbell does not close.
+  explicit constexpr EventfdDoorbell(int fd) : fd_(fd), owned_(false) {}
+
+  EventfdDoorbell(EventfdDoorbell&& other)
+      : fd_(other.fd_), owned_(other.owned_) {
+    other.owned_ = false;
+  }
+  EventfdDoorbell& operator=(EventfdDoorbell&&) = delete;
+
+  ~EventfdDoorbell() override;
+
+  void Ring() override;
+  void Wait() override;
+
+  int fd() const { return fd_; }
+
+ private:
+  constexpr EventfdDoorbell(int fd, bool owned) : fd_(fd), owned_(owned) {}
+
+  int fd_;
+  bool owned_;
+};
+
+}  // namespace pw::rpc
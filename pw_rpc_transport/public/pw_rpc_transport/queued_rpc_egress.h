@@ -0,0 +1,164 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc_transport/hdlc_framing.h"
+#include "pw_rpc_transport/internal/packet_buffer_queue.h"
+#include "pw_rpc_transport/rpc_transport.h"
+#include "pw_rpc_transport/simple_framing.h"
+#include "pw_status/status.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread_core.h"
+
+namespace pw::rpc {
+namespace internal {
+
+void LogQueuedEgressPacketTooLarge(size_t packet_size, size_t max_packet_size);
+void LogQueuedEgressQueueFull();
+void LogQueuedEgressStopped();
+void LogQueuedEgressSendFailure(Status status);
+
+}  // namespace internal
+
+// An egress which queues RPC packets and sends them from its own thread, so
+// that RPC producers never block on the transport. Each packet is copied once
+// into a buffer from a fixed pool. The sender thread then encodes queued
+// packets in place, passing the transport frames which point into the queued
+// buffer. With SimpleRpcPacketEncoder, frames refer to the packet itself rather
+// than to copies; HDLC framing escapes the packet, so it is still encoded into
+// a separate buffer.
+//
+// Packets are sent in the order they were queued. If the pool is exhausted,
+// SendRpcPacket() fails rather than waiting for a buffer.
+template <typename Encoder, size_t kPacketQueueSize, size_t kMaxPacketSize>
+class QueuedRpcEgress : public RpcEgressHandler,
+                        public ChannelOutput,
+                        public thread::ThreadCore {
+  using PacketBuffer =
+      typename internal::PacketBufferQueue<kMaxPacketSize>::PacketBuffer;
+
+ public:
+  QueuedRpcEgress(std::string_view channel_name, RpcFrameSender& transport)
+      : ChannelOutput(channel_name.data()), transport_(transport) {}
+
+  ~QueuedRpcEgress() override { Stop(); }
+
+  // Queues the packet to be sent by the sender thread. Returns:
+  //
+  //   OK - The packet was queued.
+  //   INVALID_ARGUMENT - The packet is larger than kMaxPacketSize.
+  //   RESOURCE_EXHAUSTED - All packet buffers are queued.
+  //   FAILED_PRECONDITION - The egress was stopped.
+  //
+  // Implements RpcEgressHandler.
+  Status SendRpcPacket(ConstByteSpan rpc_packet) override;
+
+  // Implements ChannelOutput.
+  Status Send(ConstByteSpan buffer) override { return SendRpcPacket(buffer); }
+
+  // Stops the sender thread. Packets which are still queued are not sent, and
+  // SendRpcPacket() fails from then on.
+  void Stop() {
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+    // Unblock the sender thread and let it finish gracefully.
+    send_queue_.release();
+  }
+
+ private:
+  void Run() override;
+
+  RpcFrameSender& transport_;
+  Encoder encoder_;
+  sync::ThreadNotification send_queue_;
+  std::array<PacketBuffer, kPacketQueueSize> packet_storage_;
+  internal::PacketBufferQueue<kMaxPacketSize> free_queue_{packet_storage_};
+  internal::PacketBufferQueue<kMaxPacketSize> transmit_queue_ = {};
+  std::atomic<bool> stopped_ = false;
+};
+
+template <typename Encoder, size_t kPacketQueueSize, size_t kMaxPacketSize>
+Status QueuedRpcEgress<Encoder, kPacketQueueSize, kMaxPacketSize>::
+    SendRpcPacket(ConstByteSpan rpc_packet) {
+  if (rpc_packet.size() > kMaxPacketSize) {
+    internal::LogQueuedEgressPacketTooLarge(rpc_packet.size(), kMaxPacketSize);
+    return Status::InvalidArgument();
+  }
+  if (stopped_) {
+    internal::LogQueuedEgressStopped();
+    return Status::FailedPrecondition();
+  }
+
+  Result<PacketBuffer*> packet_buffer = free_queue_.Pop();
+  if (!packet_buffer.ok()) {
+    internal::LogQueuedEgressQueueFull();
+    return Status::ResourceExhausted();
+  }
+  if (Status status = (*packet_buffer)->CopyPacket(rpc_packet); !status.ok()) {
+    free_queue_.Push(**packet_buffer);
+    return status;
+  }
+
+  transmit_queue_.Push(**packet_buffer);
+  send_queue_.release();
+  return OkStatus();
+}
+
+template <typename Encoder, size_t kPacketQueueSize, size_t kMaxPacketSize>
+void QueuedRpcEgress<Encoder, kPacketQueueSize, kMaxPacketSize>::Run() {
+  while (!stopped_) {
+    // Wait until a producer has signaled that there are packets to send.
+    send_queue_.acquire();
+
+    while (!stopped_) {
+      Result<PacketBuffer*> packet_buffer = transmit_queue_.Pop();
+      if (!packet_buffer.ok()) {
+        break;
+      }
+      // Only this thread encodes, so the encoder needs no lock. Frames are
+      // passed to the transport inline, while the packet buffer is held.
+      const Status status = encoder_.Encode(
+          *(*packet_buffer)->GetPacket(),
+          transport_.MaximumTransmissionUnit(),
+          [this](RpcFrame& frame) { return transport_.Send(frame); });
+      if (!status.ok()) {
+        internal::LogQueuedEgressSendFailure(status);
+      }
+      free_queue_.Push(**packet_buffer);
+    }
+  }
+}
+
+template <size_t kPacketQueueSize, size_t kMaxPacketSize>
+using HdlcQueuedRpcEgress =
+    QueuedRpcEgress<HdlcRpcPacketEncoder<kMaxPacketSize>,
+                    kPacketQueueSize,
+                    kMaxPacketSize>;
+
+template <size_t kPacketQueueSize, size_t kMaxPacketSize>
+using SimpleQueuedRpcEgress =
+    QueuedRpcEgress<SimpleRpcPacketEncoder<kMaxPacketSize>,
+                    kPacketQueueSize,
+                    kMaxPacketSize>;
+
+}  // namespace pw::rpc
@@ -0,0 +1,115 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+// The indices shared by the two sides of a SharedMemoryRing, at the start of
+// its region.
+struct SharedMemoryRingHeader {
+  std::atomic<uint32_t> write_index;
+  std::atomic<uint32_t> read_index;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "Shared memory rings require address-free atomics");
+
+// A single-producer, single-consumer ring of variable-size records in a memory
+// region shared between cores or processes. Each side constructs a ring over
+// its mapping of the region, which may be at different addresses.
+//
+// Records are stored contiguously, so the reader accesses them in place and
+// the writer may encode them in place. Only the two indices in the header are
+// shared, and they are updated with acquire and release ordering, so the ring
+// needs no locks. Between cores, the region must be coherent or uncached.
+class SharedMemoryRing {
+ public:
+  // Uses region, which must be aligned to 4 bytes, for the header and the
+  // records. The record space is the largest power of two that fits.
+  explicit SharedMemoryRing(ByteSpan region);
+
+  SharedMemoryRing(const SharedMemoryRing&) = delete;
+  SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+  // Empties the ring. Must be called by one side before either side uses the
+  // ring.
+  void Initialize();
+
+  // The largest record which can be written. Records are limited to half of
+  // the ring so that one always fits once the ring is empty.
+  size_t max_record_size() const { return capacity_ / 2 - kLengthSize; }
+
+  // Writer: reserves space for a record of up to size bytes. The record is not
+  // visible to the reader until Commit() is called. Returns:
+  //
+  //   OK - The space to write the record to.
+  //   RESOURCE_EXHAUSTED - The ring has no room for the record at the moment.
+  //   INVALID_ARGUMENT - The record is larger than max_record_size().
+  //
+  Result<ByteSpan> Reserve(size_t size);
+
+  // Writer: publishes the first size bytes of the last reservation.
+  void Commit(size_t size);
+
+  // Writer: copies a record made of two pieces, such as a header and payload,
+  // into the ring.
+  Status Write(ConstByteSpan first, ConstByteSpan second = {});
+
+  // Reader: returns the oldest record without removing it. Returns:
+  //
+  //   OK - The record, which remains valid until Pop() is called.
+  //   UNAVAILABLE - The ring is empty.
+  //   DATA_LOSS - The ring's contents are corrupt.
+  //
+  Result<ConstByteSpan> Peek();
+
+  // Reader: removes the record returned by the last Peek().
+  void Pop();
+
+ private:
+  static constexpr size_t kLengthSize = sizeof(uint32_t);
+
+  // Marks the end of the record space as unused, so the next record starts at
+  // the beginning and is contiguous.
+  static constexpr uint32_t kWrapMarker = 0xFFFFFFFF;
+
+  static constexpr size_t RecordSize(size_t size) {
+    return (kLengthSize + size + 3) & ~size_t{3};
+  }
+
+  size_t Offset(uint32_t index) const { return index & (capacity_ - 1); }
+
+  uint32_t LoadLength(size_t offset) const;
+  void StoreLength(size_t offset, uint32_t length);
+
+  SharedMemoryRingHeader& header_;
+  std::byte* const records_;
+  const size_t capacity_;
+
+  // Writer state: where the reserved record starts.
+  uint32_t reserved_index_ = 0;
+
+  // Reader state: where the record after the peeked one starts.
+  uint32_t next_read_index_ = 0;
+};
+
+}  // namespace pw::rpc
@@ -0,0 +1,101 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "pw_rpc_transport/rpc_transport.h"
+#include "pw_rpc_transport/shared_memory_ring.h"
+#include "pw_status/status.h"
+#include "pw_thread/thread_core.h"
+
+namespace pw::rpc {
+
+// Notifies the reader of a SharedMemoryRing that records were written. Each
+// side has its own Doorbell for the same ring: Ring() on either wakes Wait() on
+// the reader's side. Implementations may raise an IPC mailbox interrupt whose
+// handler wakes the waiting thread, or write to an eventfd shared by two
+// processes.
+class Doorbell {
+ public:
+  virtual ~Doorbell() = default;
+
+  // Wakes the reader. Must not block.
+  virtual void Ring() = 0;
+
+  // Blocks until the doorbell rings. Rings while not waiting must not be lost,
+  // though several may wake a single Wait().
+  virtual void Wait() = 0;
+};
+
+// Sends RPC frames to another core or process through a SharedMemoryRing. Each
+// frame is copied once, into the ring, as a single record, and the doorbell is
+// rung. Sending fails with RESOURCE_EXHAUSTED instead of blocking if the ring
+// is full.
+//
+// Only one thread may send at a time; RpcEgress serializes its sends.
+class SharedMemoryRpcFrameSender : public RpcFrameSender {
+ public:
+  SharedMemoryRpcFrameSender(SharedMemoryRing& ring, Doorbell& doorbell)
+      : ring_(ring), doorbell_(doorbell) {}
+
+  size_t MaximumTransmissionUnit() const override {
+    return ring_.max_record_size();
+  }
+
+  Status Send(RpcFrame frame) override {
+    if (Status status = ring_.Write(frame.header, frame.payload);
+        !status.ok()) {
+      return status;
+    }
+    doorbell_.Ring();
+    return OkStatus();
+  }
+
+ private:
+  SharedMemoryRing& ring_;
+  Doorbell& doorbell_;
+};
+
+// Reads RPC frames from a SharedMemoryRing and passes them to an ingress in
+// place, without copying them out of the ring. When run as a thread, waits on
+// the doorbell while the ring is empty.
+class SharedMemoryRpcReceiver : public thread::ThreadCore {
+ public:
+  SharedMemoryRpcReceiver(SharedMemoryRing& ring,
+                          Doorbell& doorbell,
+                          RpcIngressHandler& ingress)
+      : ring_(ring), doorbell_(doorbell), ingress_(ingress) {}
+
+  // Passes every frame in the ring to the ingress, without blocking. Returns
+  // DATA_LOSS if the ring is corrupt.
+  Status ProcessAvailable();
+
+  // Stops the thread after it processes the frames in the ring.
+  void Stop() {
+    stopped_ = true;
+    doorbell_.Ring();
+  }
+
+ private:
+  void Run() override;
+
+  SharedMemoryRing& ring_;
+  Doorbell& doorbell_;
+  RpcIngressHandler& ingress_;
+  std::atomic<bool> stopped_ = false;
+};
+
+}  // namespace pw::rpc
@@ -0,0 +1,42 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PW_RPC"
+
+#include "pw_rpc_transport/queued_rpc_egress.h"
+
+#include "pw_log/log.h"
+
+namespace pw::rpc::internal {
+
+void LogQueuedEgressPacketTooLarge(size_t packet_size, size_t max_packet_size) {
+  PW_LOG_ERROR("QueuedRpcEgress: packet too large (%d > %d)",
+               static_cast<int>(packet_size),
+               static_cast<int>(max_packet_size));
+}
+
+void LogQueuedEgressQueueFull() {
+  PW_LOG_WARN("QueuedRpcEgress: all packet buffers are queued");
+}
+
+void LogQueuedEgressStopped() {
+  PW_LOG_ERROR("QueuedRpcEgress: sender thread is not running");
+}
+
+void LogQueuedEgressSendFailure(Status status) {
+  PW_LOG_ERROR("QueuedRpcEgress: failed to send packet. Status %d",
+               static_cast<int>(status.code()));
+}
+
+}  // namespace pw::rpc::internal
@@ -0,0 +1,164 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/queued_rpc_egress.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/span.h"
+#include "pw_rpc_transport/simple_framing.h"
+#include "pw_status/status.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_sync/mutex.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr size_t kMaxPacketSize = 64;
+
+// A transport which records the frames it is sent and signals each one. It may
+// be blocked so that frames queue up in the egress.
+class TestTransport : public RpcFrameSender {
+ public:
+  explicit TestTransport(size_t mtu) : mtu_(mtu) {}
+
+  size_t MaximumTransmissionUnit() const override { return mtu_; }
+
+  Status Send(RpcFrame frame) override {
+    if (blocked_) {
+      unblock_.acquire();
+    }
+    {
+      std::lock_guard lock(mutex_);
+      std::copy(frame.header.begin(),
+                frame.header.end(),
+                std::back_inserter(buffer_));
+      std::copy(frame.payload.begin(),
+                frame.payload.end(),
+                std::back_inserter(buffer_));
+    }
+    frames_sent_.release();
+    return OkStatus();
+  }
+
+  void Block() { blocked_ = true; }
+  void Unblock() {
+    blocked_ = false;
+    unblock_.release();
+  }
+
+  void WaitForFrames(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      frames_sent_.acquire();
+    }
+  }
+
+  std::vector<std::byte> buffer() {
+    std::lock_guard lock(mutex_);
+    return buffer_;
+  }
+
+ private:
+  const size_t mtu_;
+  std::atomic<bool> blocked_ = false;
+  sync::ThreadNotification unblock_;
+  sync::CountingSemaphore frames_sent_;
+  sync::Mutex mutex_;
+  std::vector<std::byte> buffer_;
+};
+
+TEST(QueuedRpcEgressTest, SendsPacketsInOrder) {
+  constexpr size_t kNumPackets = 10;
+  TestTransport transport(kMaxPacketSize +
+                          SimpleRpcPacketEncoder<kMaxPacketSize>::kHeaderSize);
+  SimpleQueuedRpcEgress<2 * kNumPackets, kMaxPacketSize> egress("test",
+                                                                 transport);
+  auto egress_thread = thread::Thread(thread::stl::Options(), egress);
+
+  std::array<std::array<std::byte, 8>, kNumPackets> packets;
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    packets[i].fill(static_cast<std::byte>(i));
+    EXPECT_EQ(egress.SendRpcPacket(packets[i]), OkStatus());
+  }
+
+  transport.WaitForFrames(kNumPackets);
+
+  std::vector<std::vector<std::byte>> received;
+  SimpleRpcPacketDecoder<kMaxPacketSize> decoder;
+  EXPECT_EQ(decoder.Decode(transport.buffer(),
+                           [&received](ConstByteSpan packet) {
+                             received.emplace_back(packet.begin(),
+                                                   packet.end());
+                           }),
+            OkStatus());
+
+  ASSERT_EQ(received.size(), kNumPackets);
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    EXPECT_TRUE(std::equal(received[i].begin(),
+                           received[i].end(),
+                           packets[i].begin(),
+                           packets[i].end()));
+  }
+
+  egress.Stop();
+  egress_thread.join();
+}
+
+TEST(QueuedRpcEgressTest, PacketQueueExhausted) {
+  constexpr size_t kPacketQueueSize = 2;
+  TestTransport transport(kMaxPacketSize);
+  SimpleQueuedRpcEgress<kPacketQueueSize, kMaxPacketSize> egress("test",
+                                                                 transport);
+  auto egress_thread = thread::Thread(thread::stl::Options(), egress);
+
+  // The first packet blocks the sender thread in the transport, so it holds
+  // its buffer, and the second waits in the queue.
+  transport.Block();
+  const std::array<std::byte, 4> packet = {};
+  EXPECT_EQ(egress.SendRpcPacket(packet), OkStatus());
+  EXPECT_EQ(egress.SendRpcPacket(packet), OkStatus());
+  EXPECT_EQ(egress.SendRpcPacket(packet), Status::ResourceExhausted());
+
+  transport.Unblock();
+  transport.WaitForFrames(2);
+
+  egress.Stop();
+  egress_thread.join();
+}
+
+TEST(QueuedRpcEgressTest, PacketTooBig) {
+  TestTransport transport(kMaxPacketSize);
+  SimpleQueuedRpcEgress<1, kMaxPacketSize> egress("test", transport);
+
+  const std::array<std::byte, kMaxPacketSize + 1> packet = {};
+  EXPECT_EQ(egress.SendRpcPacket(packet), Status::InvalidArgument());
+}
+
+TEST(QueuedRpcEgressTest, Stopped) {
+  TestTransport transport(kMaxPacketSize);
+  SimpleQueuedRpcEgress<1, kMaxPacketSize> egress("test", transport);
+  egress.Stop();
+
+  const std::array<std::byte, 4> packet = {};
+  EXPECT_EQ(egress.SendRpcPacket(packet), Status::FailedPrecondition());
+}
+
+}  // namespace
+}  // namespace pw::rpc
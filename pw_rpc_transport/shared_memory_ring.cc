@@ -0,0 +1,138 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/shared_memory_ring.h"
+
+#include <cstring>
+
+#include "pw_assert/check.h"
+
+namespace pw::rpc {
+namespace {
+
+size_t PowerOfTwoFloor(size_t value) {
+  size_t power = 1;
+  while (power <= value / 2) {
+    power *= 2;
+  }
+  return power;
+}
+
+}  // namespace
+
+SharedMemoryRing::SharedMemoryRing(ByteSpan region)
+    : header_(*reinterpret_cast<SharedMemoryRingHeader*>(region.data())),
+      records_(region.data() + sizeof(SharedMemoryRingHeader)),
+      capacity_(PowerOfTwoFloor(region.size() -
+                                sizeof(SharedMemoryRingHeader))) {
+  const uintptr_t misalignment = reinterpret_cast<uintptr_t>(region.data()) &
+                                 (alignof(SharedMemoryRingHeader) - 1);
+  PW_CHECK_UINT_EQ(misalignment, 0u);
+  PW_CHECK_UINT_GE(region.size(), sizeof(SharedMemoryRingHeader) + 16);
+  PW_CHECK_UINT_LE(capacity_, uint32_t{1} << 31);
+}
+
+void SharedMemoryRing::Initialize() {
+  header_.write_index.store(0, std::memory_order_relaxed);
+  header_.read_index.store(0, std::memory_order_release);
+}
+
+Result<ByteSpan> SharedMemoryRing::Reserve(size_t size) {
+  if (size > max_record_size()) {
+    return Status::InvalidArgument();
+  }
+
+  const size_t record_size = RecordSize(size);
+  const uint32_t write = header_.write_index.load(std::memory_order_relaxed);
+  const uint32_t read = header_.read_index.load(std::memory_order_acquire);
+  const size_t free_space = capacity_ - static_cast<uint32_t>(write - read);
+  const size_t offset = Offset(write);
+  const size_t to_end = capacity_ - offset;
+
+  // A record which does not fit before the end starts at the beginning.
+  const bool wraps = record_size > to_end;
+  if ((wraps ? to_end + record_size : record_size) > free_space) {
+    return Status::ResourceExhausted();
+  }
+
+  reserved_index_ = write;
+  if (wraps) {
+    StoreLength(offset, kWrapMarker);
+    reserved_index_ += static_cast<uint32_t>(to_end);
+  }
+  return ByteSpan(records_ + Offset(reserved_index_) + kLengthSize, size);
+}
+
+void SharedMemoryRing::Commit(size_t size) {
+  StoreLength(Offset(reserved_index_), static_cast<uint32_t>(size));
+  header_.write_index.store(
+      reserved_index_ + static_cast<uint32_t>(RecordSize(size)),
+      std::memory_order_release);
+}
+
+Status SharedMemoryRing::Write(ConstByteSpan first, ConstByteSpan second) {
+  Result<ByteSpan> record = Reserve(first.size() + second.size());
+  if (!record.ok()) {
+    return record.status();
+  }
+  std::memcpy(record->data(), first.data(), first.size());
+  std::memcpy(record->data() + first.size(), second.data(), second.size());
+  Commit(record->size());
+  return OkStatus();
+}
+
+Result<ConstByteSpan> SharedMemoryRing::Peek() {
+  uint32_t read = header_.read_index.load(std::memory_order_relaxed);
+  const uint32_t write = header_.write_index.load(std::memory_order_acquire);
+  if (read == write) {
+    return Status::Unavailable();
+  }
+
+  size_t offset = Offset(read);
+  uint32_t length = LoadLength(offset);
+  if (length == kWrapMarker) {
+    // The writer publishes the marker together with the record after it.
+    read += static_cast<uint32_t>(capacity_ - offset);
+    offset = 0;
+    if (read == write) {
+      return Status::DataLoss();
+    }
+    length = LoadLength(offset);
+  }
+
+  // Don't trust the other side to stay within the ring.
+  if (length > max_record_size() || RecordSize(length) > capacity_ - offset ||
+      RecordSize(length) > static_cast<uint32_t>(write - read)) {
+    return Status::DataLoss();
+  }
+
+  next_read_index_ = read + static_cast<uint32_t>(RecordSize(length));
+  return ConstByteSpan(records_ + offset + kLengthSize, length);
+}
+
+void SharedMemoryRing::Pop() {
+  header_.read_index.store(next_read_index_, std::memory_order_release);
+}
+
+uint32_t SharedMemoryRing::LoadLength(size_t offset) const {
+  uint32_t length;
+  std::memcpy(&length, records_ + offset, sizeof(length));
+  return length;
+}
+
+void SharedMemoryRing::StoreLength(size_t offset, uint32_t length) {
+  std::memcpy(records_ + offset, &length, sizeof(length));
+}
+
+}  // namespace pw::rpc
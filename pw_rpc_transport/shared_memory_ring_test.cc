@@ -0,0 +1,115 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/shared_memory_ring.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+
+namespace pw::rpc {
+namespace {
+
+// A 64-byte record space after the 8-byte header.
+constexpr size_t kRegionSize = sizeof(SharedMemoryRingHeader) + 64;
+
+class SharedMemoryRingTest : public ::testing::Test {
+ protected:
+  SharedMemoryRingTest() : writer_(region_), reader_(region_) {
+    writer_.Initialize();
+  }
+
+  alignas(SharedMemoryRingHeader) std::array<std::byte, kRegionSize> region_{};
+  SharedMemoryRing writer_;
+  SharedMemoryRing reader_;
+};
+
+TEST_F(SharedMemoryRingTest, EmptyRing) {
+  EXPECT_EQ(reader_.Peek().status(), Status::Unavailable());
+  EXPECT_EQ(writer_.max_record_size(), 28u);
+}
+
+TEST_F(SharedMemoryRingTest, WriteAndRead) {
+  constexpr auto kHeader = bytes::Array<1, 2>();
+  constexpr auto kPayload = bytes::Array<3, 4, 5>();
+  ASSERT_EQ(writer_.Write(kHeader, kPayload), OkStatus());
+
+  Result<ConstByteSpan> record = reader_.Peek();
+  ASSERT_EQ(record.status(), OkStatus());
+  constexpr auto kExpected = bytes::Array<1, 2, 3, 4, 5>();
+  ASSERT_EQ(record->size(), kExpected.size());
+  EXPECT_EQ(std::memcmp(record->data(), kExpected.data(), kExpected.size()),
+            0);
+
+  // Records stay until popped.
+  EXPECT_EQ(reader_.Peek()->data(), record->data());
+  reader_.Pop();
+  EXPECT_EQ(reader_.Peek().status(), Status::Unavailable());
+}
+
+TEST_F(SharedMemoryRingTest, ReserveAndCommitInPlace) {
+  Result<ByteSpan> space = writer_.Reserve(16);
+  ASSERT_EQ(space.status(), OkStatus());
+  (*space)[0] = std::byte{0xAB};
+  (*space)[1] = std::byte{0xCD};
+
+  // Nothing is visible until committed.
+  EXPECT_EQ(reader_.Peek().status(), Status::Unavailable());
+  writer_.Commit(2);
+
+  Result<ConstByteSpan> record = reader_.Peek();
+  ASSERT_EQ(record.status(), OkStatus());
+  ASSERT_EQ(record->size(), 2u);
+  EXPECT_EQ((*record)[1], std::byte{0xCD});
+}
+
+TEST_F(SharedMemoryRingTest, RejectsRecordsWhenFull) {
+  const std::array<std::byte, 12> record{};
+  // Each record takes 16 bytes, with its length.
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(writer_.Write(record), OkStatus());
+  }
+  EXPECT_EQ(writer_.Write(record), Status::ResourceExhausted());
+  EXPECT_EQ(writer_.Reserve(29).status(), Status::InvalidArgument());
+
+  ASSERT_EQ(reader_.Peek().status(), OkStatus());
+  reader_.Pop();
+  EXPECT_EQ(writer_.Write(record), OkStatus());
+}
+
+TEST_F(SharedMemoryRingTest, RecordsWrapContiguously) {
+  std::array<std::byte, 20> record;
+  for (uint8_t i = 0; i < 40; ++i) {
+    record.fill(std::byte{i});
+    ASSERT_EQ(writer_.Write(record), OkStatus());
+
+    Result<ConstByteSpan> read = reader_.Peek();
+    ASSERT_EQ(read.status(), OkStatus());
+    ASSERT_EQ(read->size(), record.size());
+    EXPECT_EQ(std::memcmp(read->data(), record.data(), record.size()), 0);
+    reader_.Pop();
+  }
+}
+
+TEST_F(SharedMemoryRingTest, CorruptLength) {
+  ASSERT_EQ(writer_.Write(bytes::Array<1, 2, 3>()), OkStatus());
+  // Overwrite the record's length.
+  region_[sizeof(SharedMemoryRingHeader)] = std::byte{0x7F};
+  EXPECT_EQ(reader_.Peek().status(), Status::DataLoss());
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -0,0 +1,49 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PW_RPC"
+
+#include "pw_rpc_transport/shared_memory_rpc_transport.h"
+
+#include "pw_log/log.h"
+
+namespace pw::rpc {
+
+Status SharedMemoryRpcReceiver::ProcessAvailable() {
+  while (true) {
+    Result<ConstByteSpan> frame = ring_.Peek();
+    if (!frame.ok()) {
+      return frame.status().IsUnavailable() ? OkStatus() : frame.status();
+    }
+    if (Status status = ingress_.ProcessIncomingData(*frame); !status.ok()) {
+      PW_LOG_WARN("Failed to process RPC frame from shared memory, status %d",
+                  static_cast<int>(status.code()));
+    }
+    ring_.Pop();
+  }
+}
+
+void SharedMemoryRpcReceiver::Run() {
+  while (!stopped_) {
+    if (Status status = ProcessAvailable(); !status.ok()) {
+      PW_LOG_ERROR("Shared memory RPC ring is corrupt, status %d",
+                   static_cast<int>(status.code()));
+      return;
+    }
+    doorbell_.Wait();
+  }
+  ProcessAvailable().IgnoreError();
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,138 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/shared_memory_rpc_transport.h"
+
+#include <array>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_sync/mutex.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr size_t kRegionSize = sizeof(SharedMemoryRingHeader) + 256;
+
+// A doorbell for threads in one process.
+class TestDoorbell : public Doorbell {
+ public:
+  void Ring() override { notification_.release(); }
+  void Wait() override { notification_.acquire(); }
+
+ private:
+  sync::ThreadNotification notification_;
+};
+
+class TestIngress : public RpcIngressHandler {
+ public:
+  Status ProcessIncomingData(ConstByteSpan buffer) override {
+    {
+      std::lock_guard lock(mutex_);
+      frames_.emplace_back(buffer.begin(), buffer.end());
+    }
+    received_.release();
+    return OkStatus();
+  }
+
+  void WaitForFrames(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      received_.acquire();
+    }
+  }
+
+  std::vector<std::vector<std::byte>> frames() {
+    std::lock_guard lock(mutex_);
+    return frames_;
+  }
+
+ private:
+  sync::Mutex mutex_;
+  sync::CountingSemaphore received_;
+  std::vector<std::vector<std::byte>> frames_;
+};
+
+TEST(SharedMemoryRpcTransport, SendsFramesToReceiver) {
+  alignas(SharedMemoryRingHeader) std::array<std::byte, kRegionSize> region{};
+  SharedMemoryRing sender_ring(region);
+  SharedMemoryRing receiver_ring(region);
+  sender_ring.Initialize();
+
+  TestDoorbell doorbell;
+  TestIngress ingress;
+  SharedMemoryRpcFrameSender sender(sender_ring, doorbell);
+  SharedMemoryRpcReceiver receiver(receiver_ring, doorbell, ingress);
+  auto receiver_thread = thread::Thread(thread::stl::Options(), receiver);
+
+  constexpr auto kHeader = bytes::Array<0xAA>();
+  constexpr size_t kFrames = 100;
+  for (uint8_t i = 0; i < kFrames; ++i) {
+    const std::array<std::byte, 3> payload = {
+        std::byte{i}, std::byte{i}, std::byte{i}};
+    // The ring may fill up before the receiver catches up.
+    while (sender.Send({.header = kHeader, .payload = payload}) ==
+           Status::ResourceExhausted()) {
+    }
+  }
+
+  ingress.WaitForFrames(kFrames);
+  receiver.Stop();
+  receiver_thread.join();
+
+  const auto frames = ingress.frames();
+  ASSERT_EQ(frames.size(), kFrames);
+  for (uint8_t i = 0; i < kFrames; ++i) {
+    const std::vector<std::byte> expected = {
+        std::byte{0xAA}, std::byte{i}, std::byte{i}, std::byte{i}};
+    EXPECT_EQ(frames[i], expected);
+  }
+}
+
+TEST(SharedMemoryRpcTransport, MtuIsMaxRecordSize) {
+  alignas(SharedMemoryRingHeader) std::array<std::byte, kRegionSize> region{};
+  SharedMemoryRing ring(region);
+  ring.Initialize();
+  TestDoorbell doorbell;
+  SharedMemoryRpcFrameSender sender(ring, doorbell);
+
+  EXPECT_EQ(sender.MaximumTransmissionUnit(), ring.max_record_size());
+  const std::array<std::byte, kRegionSize> too_large{};
+  EXPECT_EQ(sender.Send({.header = {}, .payload = too_large}),
+            Status::InvalidArgument());
+}
+
+TEST(SharedMemoryRpcTransport, ProcessAvailableWithoutThread) {
+  alignas(SharedMemoryRingHeader) std::array<std::byte, kRegionSize> region{};
+  SharedMemoryRing ring(region);
+  ring.Initialize();
+  TestDoorbell doorbell;
+  TestIngress ingress;
+  SharedMemoryRpcFrameSender sender(ring, doorbell);
+  SharedMemoryRpcReceiver receiver(ring, doorbell, ingress);
+
+  EXPECT_EQ(sender.Send({.header = {}, .payload = bytes::Array<1>()}),
+            OkStatus());
+  EXPECT_EQ(sender.Send({.header = {}, .payload = bytes::Array<2>()}),
+            OkStatus());
+  EXPECT_EQ(receiver.ProcessAvailable(), OkStatus());
+  EXPECT_EQ(ingress.frames().size(), 2u);
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -0,0 +1,85 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sampling_profiler/cortex_m.h"
+
+#include <atomic>
+#include <cstdint>
+
+#include "pw_cpu_exception_cortex_m/cpu_state.h"
+#include "pw_preprocessor/compiler.h"
+
+namespace pw::sampling_profiler::cortex_m {
+namespace {
+
+// SysTick registers, see ARMv7-M Section B3.3.
+volatile uint32_t& kSystCsr =
+    *reinterpret_cast<volatile uint32_t*>(0xE000E010);
+volatile uint32_t& kSystRvr =
+    *reinterpret_cast<volatile uint32_t*>(0xE000E014);
+volatile uint32_t& kSystCvr =
+    *reinterpret_cast<volatile uint32_t*>(0xE000E018);
+
+constexpr uint32_t kSystCsrEnable = 1u << 0;
+constexpr uint32_t kSystCsrTickInt = 1u << 1;
+constexpr uint32_t kSystCsrClkSource = 1u << 2;  // Processor clock.
+constexpr uint32_t kSystRvrMax = 0x00FF'FFFF;
+
+std::atomic<Profiler*> interrupt_profiler = nullptr;
+
+}  // namespace
+
+void SetInterruptProfiler(Profiler* profiler) {
+  interrupt_profiler.store(profiler, std::memory_order_release);
+}
+
+void StartSysTickSampling(uint32_t cycles_per_sample) {
+  kSystCsr = 0;
+  kSystRvr = (cycles_per_sample - 1) & kSystRvrMax;
+  kSystCvr = 0;
+  kSystCsr = kSystCsrClkSource | kSystCsrTickInt | kSystCsrEnable;
+}
+
+void StopSysTickSampling() { kSystCsr = 0; }
+
+}  // namespace pw::sampling_profiler::cortex_m
+
+PW_EXTERN_C PW_USED void pw_sampling_profiler_RecordFrame(
+    const pw::cpu_exception::cortex_m::ExceptionRegisters* frame) {
+  pw::sampling_profiler::Profiler* profiler =
+      pw::sampling_profiler::cortex_m::interrupt_profiler.load(
+          std::memory_order_acquire);
+  if (profiler != nullptr) {
+    profiler->RecordSample(frame->pc, frame->lr);
+  }
+  pw_sampling_profiler_AcknowledgeInterrupt();
+}
+
+PW_EXTERN_C PW_WEAK void pw_sampling_profiler_AcknowledgeInterrupt(void) {}
+
+// The hardware pushed the interrupted code's registers to the stack it was
+// using, which bit 2 of the EXC_RETURN value in lr identifies. That frame is
+// passed to pw_sampling_profiler_RecordFrame(), which is branched to rather
+// than called so that it returns from the interrupt with lr intact.
+void pw_sampling_profiler_SampleIsr(void) {
+  asm volatile(
+      // clang-format off
+      " tst lr, #(1 << 2)                                     \n"
+      " ite eq                                                \n"
+      " mrseq r0, msp                                         \n"
+      " mrsne r0, psp                                         \n"
+      " b pw_sampling_profiler_RecordFrame                    \n"
+      // clang-format on
+  );
+}
@@ -0,0 +1,26 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// The maximum number of slots the sample table checks when recording a sample,
+// which bounds the time spent in the sampling interrupt. Samples which do not
+// find their slot, or a free one, within this many slots are dropped.
+#ifndef PW_SAMPLING_PROFILER_MAX_PROBES
+#define PW_SAMPLING_PROFILER_MAX_PROBES 8
+#endif  // PW_SAMPLING_PROFILER_MAX_PROBES
+
+// The number of samples the SamplingProfilerService sends in each message.
+#ifndef PW_SAMPLING_PROFILER_SAMPLES_PER_MESSAGE
+#define PW_SAMPLING_PROFILER_SAMPLES_PER_MESSAGE 16
+#endif  // PW_SAMPLING_PROFILER_SAMPLES_PER_MESSAGE
@@ -0,0 +1,47 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_preprocessor/compiler.h"
+#include "pw_preprocessor/util.h"
+#include "pw_sampling_profiler/profiler.h"
+
+// Samples the code interrupted by the current interrupt into the profiler set
+// by SetInterruptProfiler(). Install this as the handler of the sampling
+// interrupt: SysTick_Handler when using StartSysTickSampling(), or the handler
+// of another periodic timer. Requires ARMv7-M or ARMv8-M Mainline.
+PW_EXTERN_C PW_NO_PROLOGUE void pw_sampling_profiler_SampleIsr(void);
+
+// Called by pw_sampling_profiler_SampleIsr() after taking a sample. Timers
+// other than SysTick must acknowledge their interrupt here; the default does
+// nothing.
+PW_EXTERN_C void pw_sampling_profiler_AcknowledgeInterrupt(void);
+
+namespace pw::sampling_profiler::cortex_m {
+
+// Sets the profiler pw_sampling_profiler_SampleIsr() records into, or nullptr
+// to stop recording.
+void SetInterruptProfiler(Profiler* profiler);
+
+// Raises the SysTick interrupt every cycles_per_sample processor clock cycles,
+// from 1 to 2^24. Only for targets where nothing else uses SysTick, such as an
+// RTOS tick.
+void StartSysTickSampling(uint32_t cycles_per_sample);
+
+// Stops the SysTick interrupt.
+void StopSysTickSampling();
+
+}  // namespace pw::sampling_profiler::cortex_m
@@ -0,0 +1,63 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "pw_sampling_profiler/sample_table.h"
+
+namespace pw::sampling_profiler {
+
+// Collects PC and LR samples into a SampleTable while running. Samples are
+// taken by a periodic interrupt, such as the Cortex-M sampler in
+// pw_sampling_profiler/cortex_m.h, which calls RecordSample().
+class Profiler {
+ public:
+  explicit constexpr Profiler(SampleTable& samples) : samples_(samples) {}
+
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  void Start() { running_.store(true, std::memory_order_relaxed); }
+  void Stop() { running_.store(false, std::memory_order_relaxed); }
+  bool running() const { return running_.load(std::memory_order_relaxed); }
+
+  // Records the PC and LR of the interrupted code, if running. Called from the
+  // sampling interrupt.
+  void RecordSample(uint32_t pc, uint32_t lr) {
+    if (running()) {
+      samples_.Record(pc, lr);
+    }
+  }
+
+  // Discards the samples taken so far. Must not be called from the sampling
+  // interrupt; it is stopped while clearing.
+  void Reset() {
+    const bool was_running = running();
+    Stop();
+    samples_.Clear();
+    if (was_running) {
+      Start();
+    }
+  }
+
+  const SampleTable& samples() const { return samples_; }
+
+ private:
+  SampleTable& samples_;
+  std::atomic<bool> running_ = false;
+};
+
+}  // namespace pw::sampling_profiler
@@ -0,0 +1,113 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+
+namespace pw::sampling_profiler {
+
+// A slot in a SampleTable. A slot is free while its count is 0.
+struct SampleSlot {
+  uint32_t pc;
+  uint32_t lr;
+  std::atomic<uint32_t> count;
+};
+
+// A fixed-size hash table counting the samples of each PC and LR pair.
+//
+// Samples are recorded by a single context, usually the sampling interrupt,
+// while the table may be read from another. Recording a sample takes bounded
+// time and needs no atomic read-modify-write instructions. Samples which do not
+// fit, because the slots they may use are taken, are dropped and counted.
+class SampleTable {
+ public:
+  explicit constexpr SampleTable(span<SampleSlot> slots) : slots_(slots) {}
+
+  SampleTable(const SampleTable&) = delete;
+  SampleTable& operator=(const SampleTable&) = delete;
+
+  // Counts a sample. Must only be called from one context at a time.
+  void Record(uint32_t pc, uint32_t lr);
+
+  // Calls callback(pc, lr, count) for each PC and LR pair sampled so far.
+  template <typename Callback>
+  void ForEach(Callback&& callback) const {
+    for (const SampleSlot& slot : slots_) {
+      const uint32_t count = slot.count.load(std::memory_order_acquire);
+      if (count != 0) {
+        callback(slot.pc, slot.lr, count);
+      }
+    }
+  }
+
+  // Calls callback(pc, lr, count) for up to max_samples sampled PC and LR
+  // pairs, starting at slot first_slot. Returns the slot after the last one
+  // visited, which is capacity() once every slot has been visited.
+  //
+  // Paging through the table by slot visits each slot at most once, even if
+  // samples are recorded between calls. Pairs first recorded in slots before
+  // first_slot are not visited.
+  template <typename Callback>
+  size_t ForEachFrom(size_t first_slot,
+                     size_t max_samples,
+                     Callback&& callback) const {
+    size_t slot = first_slot;
+    for (size_t visited = 0; slot < slots_.size() && visited < max_samples;
+         ++slot) {
+      const uint32_t count = slots_[slot].count.load(std::memory_order_acquire);
+      if (count != 0) {
+        callback(slots_[slot].pc, slots_[slot].lr, count);
+        visited += 1;
+      }
+    }
+    return slot;
+  }
+
+  // Discards all samples. Must not be called while samples are recorded.
+  void Clear();
+
+  // The number of samples recorded, including those dropped.
+  uint32_t total_samples() const {
+    return total_samples_.load(std::memory_order_relaxed);
+  }
+
+  // The number of samples dropped because the table was too full.
+  uint32_t dropped_samples() const {
+    return dropped_samples_.load(std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return slots_.size(); }
+
+ private:
+  span<SampleSlot> slots_;
+  std::atomic<uint32_t> total_samples_ = 0;
+  std::atomic<uint32_t> dropped_samples_ = 0;
+};
+
+// A SampleTable with storage for kCapacity PC and LR pairs.
+template <size_t kCapacity>
+class SampleTableBuffer : public SampleTable {
+ public:
+  constexpr SampleTableBuffer() : SampleTable(slots_) {}
+
+ private:
+  std::array<SampleSlot, kCapacity> slots_ = {};
+};
+
+}  // namespace pw::sampling_profiler
@@ -0,0 +1,66 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_protobuf/serialized_size.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_sampling_profiler/config.h"
+#include "pw_sampling_profiler/profiler.h"
+#include "pw_sampling_profiler_protos/sampling_profiler.pwpb.h"
+#include "pw_sampling_profiler_protos/sampling_profiler.raw_rpc.pb.h"
+
+namespace pw::sampling_profiler {
+
+// Calculates the encode buffer size needed for a GetSamplesResponse of
+// num_samples samples.
+constexpr size_t RequiredResponseBufferSize(
+    size_t num_samples = PW_SAMPLING_PROFILER_SAMPLES_PER_MESSAGE) {
+  const size_t sample_size =
+      protobuf::SizeOfFieldUint32(pwpb::Sample::Fields::kPc) +
+      protobuf::SizeOfFieldUint32(pwpb::Sample::Fields::kLr) +
+      protobuf::SizeOfFieldUint32(pwpb::Sample::Fields::kCount);
+  return num_samples * protobuf::SizeOfDelimitedField(
+                           pwpb::GetSamplesResponse::Fields::kSamples,
+                           static_cast<uint32_t>(sample_size)) +
+         protobuf::SizeOfFieldUint32(
+             pwpb::GetSamplesResponse::Fields::kTotalSamples) +
+         protobuf::SizeOfFieldUint32(
+             pwpb::GetSamplesResponse::Fields::kDroppedSamples);
+}
+
+// Starts and stops a Profiler and returns its samples over RPC. GetSamples()
+// streams the samples in messages of PW_SAMPLING_PROFILER_SAMPLES_PER_MESSAGE
+// samples, encoded one at a time into a buffer owned by the service.
+class SamplingProfilerService
+    : public pw_rpc::raw::SamplingProfiler::Service<SamplingProfilerService> {
+ public:
+  explicit constexpr SamplingProfilerService(Profiler& profiler)
+      : profiler_(profiler), encode_buffer_{} {}
+
+  void Start(ConstByteSpan, rpc::RawUnaryResponder& responder);
+
+  void Stop(ConstByteSpan, rpc::RawUnaryResponder& responder);
+
+  void GetSamples(ConstByteSpan request, rpc::RawServerWriter& writer);
+
+ private:
+  Profiler& profiler_;
+  std::array<std::byte, RequiredResponseBufferSize()> encode_buffer_;
+};
+
+}  // namespace pw::sampling_profiler
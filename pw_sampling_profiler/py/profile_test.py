@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for aggregating sampling profiles."""
+
+import unittest
+
+from pw_sampling_profiler.profile import Sample, aggregate, format_profile
+from pw_symbolizer import FakeSymbolizer, Symbol
+
+_SYMBOLIZER = FakeSymbolizer(
+    [
+        Symbol(0x1000, 'Compute'),
+        Symbol(0x1004, 'Compute'),
+        Symbol(0x2000, 'main'),
+        Symbol(0x3000, 'Idle'),
+    ]
+)
+
+
+class AggregateTest(unittest.TestCase):
+    """Tests grouping samples by function."""
+
+    def test_groups_by_function(self):
+        functions = aggregate(
+            [
+                Sample(pc=0x1000, lr=0x2001, count=3),
+                Sample(pc=0x1004, lr=0x2001, count=2),
+                Sample(pc=0x3000, lr=0x2001, count=1),
+            ],
+            _SYMBOLIZER,
+        )
+        self.assertEqual(['Compute', 'Idle'], [f.name for f in functions])
+        self.assertEqual(5, functions[0].count)
+        self.assertEqual({'main': 5}, dict(functions[0].callers))
+
+    def test_unknown_addresses(self):
+        functions = aggregate([Sample(0x4000, 0x5001, 1)], _SYMBOLIZER)
+        self.assertEqual('0x00004000', functions[0].name)
+        self.assertEqual({'0x00005000': 1}, dict(functions[0].callers))
+
+    def test_empty(self):
+        self.assertEqual([], aggregate([], _SYMBOLIZER))
+
+
+class FormatProfileTest(unittest.TestCase):
+    """Tests formatting aggregated samples."""
+
+    def test_format(self):
+        functions = aggregate([Sample(0x1000, 0x2001, 3)], _SYMBOLIZER)
+        self.assertEqual(
+            '\n'.join(
+                (
+                    ' Samples      %  Function',
+                    '       3  75.00  Compute',
+                    '       3           <- main',
+                )
+            ),
+            format_profile(functions, total_samples=4),
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,105 @@
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Reads samples from a device and aggregates them by function."""
+
+from collections import Counter
+from dataclasses import dataclass, field
+from typing import Counter as CounterType, Iterable, List
+
+from pw_symbolizer import Symbolizer
+
+
+@dataclass(frozen=True)
+class Sample:
+    """The number of samples taken at a PC and LR pair."""
+
+    pc: int
+    lr: int
+    count: int
+
+
+@dataclass
+class Samples:
+    """The samples read from a device."""
+
+    samples: List[Sample] = field(default_factory=list)
+    total_samples: int = 0
+    dropped_samples: int = 0
+
+
+@dataclass
+class FunctionProfile:
+    """The samples taken in one function, and the functions it was called
+    from."""
+
+    name: str
+    count: int = 0
+    callers: CounterType[str] = field(default_factory=Counter)
+
+
+def read_samples(rpcs, reset: bool = False) -> Samples:
+    """Reads the samples taken so far through the SamplingProfiler service.
+
+    Args:
+      rpcs: The RPC client's services, containing pw.sampling_profiler.
+      reset: Whether the device discards the samples once they are read.
+    """
+    service = rpcs.pw.sampling_profiler.SamplingProfiler
+    status, responses = service.GetSamples(reset=reset)
+    if not status.ok():
+        raise RuntimeError(f'GetSamples() failed with status {status}')
+
+    result = Samples()
+    for response in responses:
+        if response.HasField('total_samples'):
+            result.total_samples = response.total_samples
+            result.dropped_samples = response.dropped_samples
+        result.samples.extend(
+            Sample(s.pc, s.lr, s.count) for s in response.samples
+        )
+    return result
+
+
+def _function_name(symbolizer: Symbolizer, address: int) -> str:
+    # Return addresses in LR have the Thumb bit set.
+    symbol = symbolizer.symbolize(address & ~1)
+    return symbol.name if symbol.name else f'0x{symbol.address:08X}'
+
+
+def aggregate(
+    samples: Iterable[Sample], symbolizer: Symbolizer
+) -> List[FunctionProfile]:
+    """Groups samples by the function sampled, most sampled first."""
+    functions = {}
+    for sample in samples:
+        name = _function_name(symbolizer, sample.pc)
+        profile = functions.setdefault(name, FunctionProfile(name))
+        profile.count += sample.count
+        profile.callers[_function_name(symbolizer, sample.lr)] += sample.count
+
+    return sorted(functions.values(), key=lambda f: (-f.count, f.name))
+
+
+def format_profile(
+    functions: Iterable[FunctionProfile], total_samples: int
+) -> str:
+    """Formats aggregated samples as a flat profile, listing each function's
+    share of the samples and its callers."""
+    lines = [f'{"Samples":>8} {"%":>6}  Function']
+    for function in functions:
+        percent = 100 * function.count / total_samples if total_samples else 0
+        lines.append(f'{function.count:>8} {percent:>6.2f}  {function.name}')
+        for caller, count in function.callers.most_common():
+            lines.append(f'{count:>8} {"":>6}    <- {caller}')
+    return '\n'.join(lines)
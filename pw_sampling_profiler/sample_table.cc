@@ -0,0 +1,72 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sampling_profiler/sample_table.h"
+
+#include <algorithm>
+
+#include "pw_sampling_profiler/config.h"
+
+namespace pw::sampling_profiler {
+namespace {
+
+// Mixes the PC and LR with multiplicative hashing. Instructions are at least
+// 2 byte aligned, so the low bit carries no information.
+size_t Hash(uint32_t pc, uint32_t lr) {
+  return ((pc >> 1) ^ (lr * 0x9E3779B1u)) * 0x9E3779B1u;
+}
+
+}  // namespace
+
+void SampleTable::Record(uint32_t pc, uint32_t lr) {
+  // Only this context writes, so a load and store is enough to increment.
+  total_samples_.store(total_samples_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+  if (slots_.empty()) {
+    dropped_samples_.store(dropped_samples_.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    return;
+  }
+
+  const size_t start = Hash(pc, lr) % slots_.size();
+  const size_t probes =
+      std::min<size_t>(PW_SAMPLING_PROFILER_MAX_PROBES, slots_.size());
+  for (size_t i = 0; i < probes; ++i) {
+    SampleSlot& slot = slots_[(start + i) % slots_.size()];
+    const uint32_t count = slot.count.load(std::memory_order_relaxed);
+    if (count == 0) {
+      // The key is written before the count publishes the slot to readers.
+      slot.pc = pc;
+      slot.lr = lr;
+      slot.count.store(1, std::memory_order_release);
+      return;
+    }
+    if (slot.pc == pc && slot.lr == lr) {
+      slot.count.store(count + 1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  dropped_samples_.store(dropped_samples_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+}
+
+void SampleTable::Clear() {
+  for (SampleSlot& slot : slots_) {
+    slot.count.store(0, std::memory_order_relaxed);
+  }
+  total_samples_.store(0, std::memory_order_relaxed);
+  dropped_samples_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace pw::sampling_profiler
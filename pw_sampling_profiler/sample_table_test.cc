@@ -0,0 +1,172 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+
+#include "pw_sampling_profiler/sample_table.h"
+
+#include "gtest/gtest.h"
+#include "pw_containers/vector.h"
+#include "pw_sampling_profiler/config.h"
+#include "pw_sampling_profiler/profiler.h"
+
+namespace pw::sampling_profiler {
+namespace {
+
+struct Sample {
+  uint32_t pc;
+  uint32_t lr;
+  uint32_t count;
+};
+
+Vector<Sample, 64> Samples(const SampleTable& table) {
+  Vector<Sample, 64> samples;
+  table.ForEach([&samples](uint32_t pc, uint32_t lr, uint32_t count) {
+    samples.push_back({pc, lr, count});
+  });
+  return samples;
+}
+
+TEST(SampleTable, Empty) {
+  SampleTableBuffer<4> table;
+  EXPECT_EQ(4u, table.capacity());
+  EXPECT_EQ(0u, table.total_samples());
+  EXPECT_EQ(0u, table.dropped_samples());
+  EXPECT_TRUE(Samples(table).empty());
+}
+
+TEST(SampleTable, Record_CountsEachPair) {
+  SampleTableBuffer<16> table;
+  table.Record(0x1000, 0x2000);
+  table.Record(0x1000, 0x2000);
+  table.Record(0x1000, 0x3000);
+  table.Record(0x1004, 0x2000);
+  table.Record(0x1000, 0x2000);
+
+  EXPECT_EQ(5u, table.total_samples());
+  EXPECT_EQ(0u, table.dropped_samples());
+
+  uint32_t found = 0;
+  for (const Sample& sample : Samples(table)) {
+    if (sample.pc == 0x1000 && sample.lr == 0x2000) {
+      EXPECT_EQ(3u, sample.count);
+    } else {
+      EXPECT_EQ(1u, sample.count);
+    }
+    found += sample.count;
+  }
+  EXPECT_EQ(5u, found);
+  EXPECT_EQ(3u, Samples(table).size());
+}
+
+TEST(SampleTable, Record_DropsWhenFull) {
+  SampleTableBuffer<4> table;
+  for (uint32_t pc = 0; pc < 6; ++pc) {
+    table.Record(0x1000 + pc * 2, 0x2000);
+  }
+  EXPECT_EQ(6u, table.total_samples());
+  EXPECT_EQ(2u, table.dropped_samples());
+  EXPECT_EQ(4u, Samples(table).size());
+
+  // Pairs already in the table are still counted.
+  const Sample first = Samples(table).front();
+  table.Record(first.pc, first.lr);
+  EXPECT_EQ(2u, table.dropped_samples());
+}
+
+TEST(SampleTable, Record_ProbesAreBounded) {
+  SampleTableBuffer<64> table;
+  for (uint32_t pc = 0; pc < 64; ++pc) {
+    table.Record(0x1000 + pc * 2, 0x2000);
+  }
+  // Some slots are left empty because samples may only use a few slots each.
+  EXPECT_EQ(64u, Samples(table).size() + table.dropped_samples());
+}
+
+TEST(SampleTable, Clear) {
+  SampleTableBuffer<4> table;
+  table.Record(0x1000, 0x2000);
+  table.Clear();
+  EXPECT_EQ(0u, table.total_samples());
+  EXPECT_TRUE(Samples(table).empty());
+
+  table.Record(0x1004, 0x2000);
+  ASSERT_EQ(1u, Samples(table).size());
+  EXPECT_EQ(0x1004u, Samples(table)[0].pc);
+}
+
+TEST(SampleTable, ForEachFrom_PagesBySlot) {
+  SampleTableBuffer<16> table;
+  for (uint32_t pc = 0; pc < 6; ++pc) {
+    table.Record(0x1000 + pc * 2, 0x2000);
+  }
+
+  Vector<Sample, 16> paged;
+  auto add = [&paged](uint32_t pc, uint32_t lr, uint32_t count) {
+    paged.push_back({pc, lr, count});
+  };
+  size_t next_slot = table.ForEachFrom(0, 4, add);
+  EXPECT_EQ(4u, paged.size());
+  EXPECT_LT(next_slot, table.capacity());
+
+  // Pairs recorded between pages do not cause pairs to be visited twice.
+  for (uint32_t pc = 6; pc < 10; ++pc) {
+    table.Record(0x1000 + pc * 2, 0x2000);
+  }
+  while (next_slot < table.capacity()) {
+    next_slot = table.ForEachFrom(next_slot, 4, add);
+  }
+  EXPECT_EQ(table.capacity(), next_slot);
+
+  for (size_t i = 0; i < paged.size(); ++i) {
+    for (size_t j = i + 1; j < paged.size(); ++j) {
+      EXPECT_FALSE(paged[i].pc == paged[j].pc && paged[i].lr == paged[j].lr);
+    }
+  }
+  EXPECT_GE(paged.size(), 6u);
+  EXPECT_LE(paged.size(), Samples(table).size());
+}
+
+TEST(SampleTable, ZeroCapacity_DropsAll) {
+  SampleTable table(span<SampleSlot>{});
+  table.Record(0x1000, 0x2000);
+  EXPECT_EQ(1u, table.total_samples());
+  EXPECT_EQ(1u, table.dropped_samples());
+}
+
+TEST(Profiler, RecordsOnlyWhileRunning) {
+  SampleTableBuffer<4> table;
+  Profiler profiler(table);
+  profiler.RecordSample(0x1000, 0x2000);
+  EXPECT_EQ(0u, table.total_samples());
+
+  profiler.Start();
+  EXPECT_TRUE(profiler.running());
+  profiler.RecordSample(0x1000, 0x2000);
+  profiler.Stop();
+  profiler.RecordSample(0x1000, 0x2000);
+  EXPECT_EQ(1u, table.total_samples());
+}
+
+TEST(Profiler, Reset_KeepsRunning) {
+  SampleTableBuffer<4> table;
+  Profiler profiler(table);
+  profiler.Start();
+  profiler.RecordSample(0x1000, 0x2000);
+  profiler.Reset();
+  EXPECT_EQ(0u, profiler.samples().total_samples());
+  EXPECT_TRUE(profiler.running());
+}
+
+}  // namespace
+}  // namespace pw::sampling_profiler
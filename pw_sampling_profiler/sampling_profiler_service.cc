@@ -0,0 +1,108 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+
+#include "pw_sampling_profiler/sampling_profiler_service.h"
+
+#include "pw_log/log.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_status/status.h"
+
+namespace pw::sampling_profiler {
+namespace {
+
+Status DecodeReset(ConstByteSpan request, bool& reset) {
+  protobuf::Decoder decoder(request);
+  Status status;
+  while (decoder.Next().ok()) {
+    switch (decoder.FieldNumber()) {
+      case static_cast<uint32_t>(pwpb::GetSamplesRequest::Fields::kReset): {
+        status.Update(decoder.ReadBool(&reset));
+      }
+    }
+  }
+  return status;
+}
+
+}  // namespace
+
+void SamplingProfilerService::Start(ConstByteSpan,
+                                    rpc::RawUnaryResponder& responder) {
+  profiler_.Start();
+  responder.Finish({}, OkStatus()).IgnoreError();
+}
+
+void SamplingProfilerService::Stop(ConstByteSpan,
+                                   rpc::RawUnaryResponder& responder) {
+  profiler_.Stop();
+  responder.Finish({}, OkStatus()).IgnoreError();
+}
+
+void SamplingProfilerService::GetSamples(ConstByteSpan request,
+                                         rpc::RawServerWriter& writer) {
+  bool reset = false;
+  if (const Status status = DecodeReset(request, reset); !status.ok()) {
+    PW_LOG_ERROR("Failed to decode GetSamples() request, error %d",
+                 status.code());
+  }
+
+  // Each message continues from the table slot where the last one stopped, so
+  // that only one message is buffered at a time. Samples may be recorded while
+  // the messages are sent; paging by slot rather than by the number of samples
+  // sent keeps new pairs from shifting pairs into or out of later messages.
+  const SampleTable& samples = profiler_.samples();
+  Status status;
+  size_t next_slot = 0;
+  bool first_message = true;
+  while (status.ok()) {
+    pwpb::GetSamplesResponse::MemoryEncoder encoder(encode_buffer_);
+    if (first_message) {
+      encoder.WriteTotalSamples(samples.total_samples()).IgnoreError();
+      encoder.WriteDroppedSamples(samples.dropped_samples()).IgnoreError();
+    }
+    size_t samples_in_message = 0;
+    next_slot = samples.ForEachFrom(
+        next_slot,
+        PW_SAMPLING_PROFILER_SAMPLES_PER_MESSAGE,
+        [&](uint32_t pc, uint32_t lr, uint32_t count) {
+          pwpb::Sample::StreamEncoder sample = encoder.GetSamplesEncoder();
+          sample.WritePc(pc).IgnoreError();
+          sample.WriteLr(lr).IgnoreError();
+          sample.WriteCount(count).IgnoreError();
+          samples_in_message += 1;
+        });
+
+    if (samples_in_message == 0 && !first_message) {
+      break;
+    }
+    status.Update(encoder.status());
+    if (status.ok()) {
+      status.Update(
+          writer.Write(ConstByteSpan(encoder.data(), encoder.size())));
+    }
+    first_message = false;
+    if (next_slot == samples.capacity()) {
+      break;
+    }
+  }
+
+  if (!status.ok()) {
+    PW_LOG_ERROR("Failed to send samples, error %d", status.code());
+  } else if (reset) {
+    profiler_.Reset();
+  }
+  writer.Finish(status).IgnoreError();
+}
+
+}  // namespace pw::sampling_profiler
@@ -0,0 +1,144 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+
+#include "pw_sampling_profiler/sampling_profiler_service.h"
+
+#include "gtest/gtest.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_rpc/raw/test_method_context.h"
+#include "pw_sampling_profiler_protos/sampling_profiler.pwpb.h"
+
+namespace pw::sampling_profiler {
+namespace {
+
+struct DecodedResponse {
+  size_t num_samples = 0;
+  uint32_t sample_count = 0;
+  bool has_total = false;
+  uint32_t total_samples = 0;
+};
+
+DecodedResponse Decode(ConstByteSpan response) {
+  DecodedResponse decoded;
+  protobuf::Decoder decoder(response);
+  while (decoder.Next().ok()) {
+    switch (static_cast<pwpb::GetSamplesResponse::Fields>(
+        decoder.FieldNumber())) {
+      case pwpb::GetSamplesResponse::Fields::kSamples: {
+        ConstByteSpan sample_bytes;
+        EXPECT_EQ(OkStatus(), decoder.ReadBytes(&sample_bytes));
+        protobuf::Decoder sample(sample_bytes);
+        while (sample.Next().ok()) {
+          if (sample.FieldNumber() ==
+              static_cast<uint32_t>(pwpb::Sample::Fields::kCount)) {
+            uint32_t count = 0;
+            EXPECT_EQ(OkStatus(), sample.ReadUint32(&count));
+            decoded.sample_count += count;
+          }
+        }
+        decoded.num_samples += 1;
+        break;
+      }
+      case pwpb::GetSamplesResponse::Fields::kTotalSamples:
+        decoded.has_total = true;
+        EXPECT_EQ(OkStatus(), decoder.ReadUint32(&decoded.total_samples));
+        break;
+      case pwpb::GetSamplesResponse::Fields::kDroppedSamples:
+        break;
+    }
+  }
+  return decoded;
+}
+
+TEST(SamplingProfilerService, StartAndStop) {
+  SampleTableBuffer<4> table;
+  Profiler profiler(table);
+
+  PW_RAW_TEST_METHOD_CONTEXT(SamplingProfilerService, Start) start(profiler);
+  start.call({});
+  EXPECT_EQ(OkStatus(), start.status());
+  EXPECT_TRUE(profiler.running());
+
+  PW_RAW_TEST_METHOD_CONTEXT(SamplingProfilerService, Stop) stop(profiler);
+  stop.call({});
+  EXPECT_EQ(OkStatus(), stop.status());
+  EXPECT_FALSE(profiler.running());
+}
+
+TEST(SamplingProfilerService, GetSamples_Empty) {
+  SampleTableBuffer<4> table;
+  Profiler profiler(table);
+
+  PW_RAW_TEST_METHOD_CONTEXT(SamplingProfilerService, GetSamples)
+  ctx(profiler);
+  ctx.call({});
+  EXPECT_TRUE(ctx.done());
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_EQ(1u, ctx.responses().size());
+
+  const DecodedResponse response = Decode(ctx.responses()[0]);
+  EXPECT_TRUE(response.has_total);
+  EXPECT_EQ(0u, response.total_samples);
+  EXPECT_EQ(0u, response.num_samples);
+}
+
+TEST(SamplingProfilerService, GetSamples_SplitsIntoMessages) {
+  constexpr uint32_t kSamples = PW_SAMPLING_PROFILER_SAMPLES_PER_MESSAGE + 4;
+  SampleTableBuffer<64> table;
+  Profiler profiler(table);
+  profiler.Start();
+  for (uint32_t i = 0; i < kSamples; ++i) {
+    profiler.RecordSample(0x1000 + 2 * i, 0x2000);
+  }
+  size_t num_pairs = 0;
+  table.ForEach([&num_pairs](uint32_t, uint32_t, uint32_t) { num_pairs += 1; });
+  ASSERT_GT(num_pairs, PW_SAMPLING_PROFILER_SAMPLES_PER_MESSAGE);
+
+  PW_RAW_TEST_METHOD_CONTEXT(SamplingProfilerService, GetSamples)
+  ctx(profiler);
+  ctx.call({});
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_EQ(2u, ctx.responses().size());
+
+  const DecodedResponse first = Decode(ctx.responses()[0]);
+  const DecodedResponse second = Decode(ctx.responses()[1]);
+  EXPECT_TRUE(first.has_total);
+  EXPECT_EQ(kSamples, first.total_samples);
+  EXPECT_FALSE(second.has_total);
+  EXPECT_EQ(PW_SAMPLING_PROFILER_SAMPLES_PER_MESSAGE, first.num_samples);
+  EXPECT_EQ(num_pairs, first.num_samples + second.num_samples);
+}
+
+TEST(SamplingProfilerService, GetSamples_Reset) {
+  SampleTableBuffer<4> table;
+  Profiler profiler(table);
+  profiler.Start();
+  profiler.RecordSample(0x1000, 0x2000);
+
+  std::array<std::byte, 8> request;
+  pwpb::GetSamplesRequest::MemoryEncoder encoder(request);
+  ASSERT_EQ(OkStatus(), encoder.WriteReset(true));
+
+  PW_RAW_TEST_METHOD_CONTEXT(SamplingProfilerService, GetSamples)
+  ctx(profiler);
+  ctx.call(ConstByteSpan(encoder.data(), encoder.size()));
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_EQ(1u, ctx.responses().size());
+  EXPECT_EQ(1u, Decode(ctx.responses()[0]).sample_count);
+  EXPECT_EQ(0u, table.total_samples());
+}
+
+}  // namespace
+}  // namespace pw::sampling_profiler
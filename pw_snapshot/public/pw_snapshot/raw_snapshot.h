@@ -0,0 +1,153 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Raw snapshots capture memory regions, such as CPU register state and stacks,
+// at fault time with nothing more than a few copies. No protobuf encoding is
+// done at capture; the regions are converted to a snapshot proto on the next
+// boot or on the host.
+//
+// A raw snapshot is a flat layout in a caller-provided buffer, typically in
+// persistent RAM or a reserved flash region:
+//
+//   Header:  magic (u32) | version (u16) | region count (u16) | size (u32)
+//   Regions: tag (u32) | data size (u32) | address (u64) | data
+//
+// All integers are little endian. The magic is written last, by Commit(), so a
+// capture interrupted by a reset is never mistaken for a complete one.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::snapshot {
+
+inline constexpr size_t kRawSnapshotHeaderSizeBytes = 12;
+inline constexpr size_t kRawSnapshotRegionHeaderSizeBytes = 16;
+
+// Returns the buffer size needed for a raw snapshot with the given number of
+// regions and total region data size.
+constexpr size_t RawSnapshotSizeBytes(size_t regions, size_t data_bytes) {
+  return kRawSnapshotHeaderSizeBytes +
+         regions * kRawSnapshotRegionHeaderSizeBytes + data_bytes;
+}
+
+// A single captured region.
+struct RawSnapshotRegion {
+  uint32_t tag;
+  uint64_t address;
+  ConstByteSpan data;
+};
+
+// Captures regions into a raw snapshot. The writer does no allocation,
+// encoding, or checksumming, so it is safe to use from a fault handler.
+class RawSnapshotWriter {
+ public:
+  // Invalidates any raw snapshot already in the buffer.
+  explicit RawSnapshotWriter(ByteSpan buffer);
+
+  RawSnapshotWriter(const RawSnapshotWriter&) = delete;
+  RawSnapshotWriter& operator=(const RawSnapshotWriter&) = delete;
+
+  // Copies a region into the snapshot. address is where the region was in
+  // memory, so it can be symbolized later. Returns:
+  //
+  //   OK - the region was captured
+  //   RESOURCE_EXHAUSTED - the region does not fit; nothing was captured
+  //   FAILED_PRECONDITION - the snapshot was already committed
+  //
+  Status AddRegion(uint32_t tag, uint64_t address, ConstByteSpan data);
+
+  // Copies as much of the start of a region as fits. Useful for stacks, where
+  // the most recent frames are at the start. Returns the number of data bytes
+  // captured and:
+  //
+  //   OK - the whole region was captured
+  //   RESOURCE_EXHAUSTED - the region was truncated, or nothing was captured
+  //       because not even its region header fits
+  //   FAILED_PRECONDITION - the snapshot was already committed
+  //
+  StatusWithSize AddTruncatedRegion(uint32_t tag,
+                                    uint64_t address,
+                                    ConstByteSpan data);
+
+  // Writes the header, which marks the snapshot as complete. No regions may be
+  // added after this. Returns the size of the snapshot in bytes and:
+  //
+  //   OK - the snapshot was committed
+  //   RESOURCE_EXHAUSTED - the buffer is too small for even the header
+  //   FAILED_PRECONDITION - the snapshot was already committed
+  //
+  StatusWithSize Commit();
+
+  size_t size() const { return size_; }
+
+ private:
+  Status Append(uint32_t tag, uint64_t address, ConstByteSpan data);
+
+  const ByteSpan buffer_;
+  size_t size_;
+  uint16_t region_count_ = 0;
+  bool committed_ = false;
+};
+
+// Reads a committed raw snapshot.
+class RawSnapshotReader {
+ public:
+  // Validates the snapshot's header and region layout. Check status() before
+  // reading regions.
+  explicit RawSnapshotReader(ConstByteSpan buffer);
+
+  // Returns:
+  //
+  //   OK - the buffer holds a complete raw snapshot
+  //   NOT_FOUND - the buffer does not hold a committed raw snapshot
+  //   DATA_LOSS - the snapshot's layout is corrupt
+  //
+  Status status() const { return status_; }
+
+  uint16_t region_count() const { return region_count_; }
+
+  // Calls function(const RawSnapshotRegion&) for each region, in the order
+  // they were added. Does nothing if status() is not OK.
+  template <typename Function>
+  void ForEachRegion(Function&& function) const {
+    size_t offset = kRawSnapshotHeaderSizeBytes;
+    for (uint16_t i = 0; i < region_count_; ++i) {
+      const RawSnapshotRegion region = RegionAt(offset);
+      function(region);
+      offset += kRawSnapshotRegionHeaderSizeBytes + region.data.size();
+    }
+  }
+
+  // Returns the first region with the given tag, or NOT_FOUND.
+  Result<RawSnapshotRegion> Find(uint32_t tag) const;
+
+ private:
+  RawSnapshotRegion RegionAt(size_t offset) const;
+
+  ConstByteSpan snapshot_;
+  uint16_t region_count_ = 0;
+  Status status_;
+};
+
+// Invalidates the raw snapshot in a buffer, if any, by clearing its magic.
+// Call this once a snapshot has been converted or sent off device.
+void ClearRawSnapshot(ByteSpan buffer);
+
+}  // namespace pw::snapshot
@@ -0,0 +1,201 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_snapshot/raw_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_bytes/endian.h"
+
+namespace pw::snapshot {
+namespace {
+
+constexpr uint32_t kMagic = 0x504e5352;  // "RSNP" in little endian
+constexpr uint16_t kVersion = 1;
+
+constexpr size_t kMagicOffset = 0;
+constexpr size_t kVersionOffset = 4;
+constexpr size_t kRegionCountOffset = 6;
+constexpr size_t kSizeOffset = 8;
+
+template <typename T>
+void Put(std::byte* destination, T value) {
+  const auto bytes = bytes::CopyInOrder(endian::little, value);
+  std::memcpy(destination, bytes.data(), bytes.size());
+}
+
+template <typename T>
+T Get(const std::byte* source) {
+  return bytes::ReadInOrder<T>(endian::little, source);
+}
+
+}  // namespace
+
+RawSnapshotWriter::RawSnapshotWriter(ByteSpan buffer)
+    : buffer_(buffer), size_(kRawSnapshotHeaderSizeBytes) {
+  ClearRawSnapshot(buffer_);
+}
+
+Status RawSnapshotWriter::AddRegion(uint32_t tag,
+                                    uint64_t address,
+                                    ConstByteSpan data) {
+  if (committed_) {
+    return Status::FailedPrecondition();
+  }
+  if (size_ > buffer_.size() ||
+      buffer_.size() - size_ <
+          kRawSnapshotRegionHeaderSizeBytes + data.size()) {
+    return Status::ResourceExhausted();
+  }
+  return Append(tag, address, data);
+}
+
+StatusWithSize RawSnapshotWriter::AddTruncatedRegion(uint32_t tag,
+                                                     uint64_t address,
+                                                     ConstByteSpan data) {
+  if (committed_) {
+    return StatusWithSize::FailedPrecondition();
+  }
+  if (size_ > buffer_.size() ||
+      buffer_.size() - size_ < kRawSnapshotRegionHeaderSizeBytes) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  const size_t available =
+      buffer_.size() - size_ - kRawSnapshotRegionHeaderSizeBytes;
+  const size_t captured = std::min(data.size(), available);
+  const Status status = Append(tag, address, data.first(captured));
+  if (!status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+  if (captured < data.size()) {
+    return StatusWithSize::ResourceExhausted(captured);
+  }
+  return StatusWithSize(captured);
+}
+
+StatusWithSize RawSnapshotWriter::Commit() {
+  if (committed_) {
+    return StatusWithSize::FailedPrecondition();
+  }
+  if (buffer_.size() < kRawSnapshotHeaderSizeBytes) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  std::byte* const header = buffer_.data();
+  Put(header + kVersionOffset, kVersion);
+  Put(header + kRegionCountOffset, region_count_);
+  Put(header + kSizeOffset, static_cast<uint32_t>(size_));
+  // The magic goes last, so the snapshot is only valid once it is complete.
+  Put(header + kMagicOffset, kMagic);
+
+  committed_ = true;
+  return StatusWithSize(size_);
+}
+
+Status RawSnapshotWriter::Append(uint32_t tag,
+                                 uint64_t address,
+                                 ConstByteSpan data) {
+  if (region_count_ == UINT16_MAX || data.size() > UINT32_MAX) {
+    return Status::ResourceExhausted();
+  }
+
+  std::byte* const region = buffer_.data() + size_;
+  Put(region, tag);
+  Put(region + 4, static_cast<uint32_t>(data.size()));
+  Put(region + 8, address);
+  std::memcpy(region + kRawSnapshotRegionHeaderSizeBytes,
+              data.data(),
+              data.size());
+
+  size_ += kRawSnapshotRegionHeaderSizeBytes + data.size();
+  region_count_ += 1;
+  return OkStatus();
+}
+
+RawSnapshotReader::RawSnapshotReader(ConstByteSpan buffer) {
+  if (buffer.size() < kRawSnapshotHeaderSizeBytes ||
+      Get<uint32_t>(buffer.data() + kMagicOffset) != kMagic) {
+    status_ = Status::NotFound();
+    return;
+  }
+
+  const uint16_t version = Get<uint16_t>(buffer.data() + kVersionOffset);
+  const uint16_t region_count =
+      Get<uint16_t>(buffer.data() + kRegionCountOffset);
+  const uint32_t size = Get<uint32_t>(buffer.data() + kSizeOffset);
+  if (version != kVersion || size < kRawSnapshotHeaderSizeBytes ||
+      size > buffer.size()) {
+    status_ = Status::DataLoss();
+    return;
+  }
+
+  // Check that the regions exactly fill the snapshot, so they can be read
+  // without further bounds checks.
+  size_t offset = kRawSnapshotHeaderSizeBytes;
+  for (uint16_t i = 0; i < region_count; ++i) {
+    if (size - offset < kRawSnapshotRegionHeaderSizeBytes) {
+      status_ = Status::DataLoss();
+      return;
+    }
+    const uint32_t data_size = Get<uint32_t>(buffer.data() + offset + 4);
+    offset += kRawSnapshotRegionHeaderSizeBytes;
+    if (size - offset < data_size) {
+      status_ = Status::DataLoss();
+      return;
+    }
+    offset += data_size;
+  }
+  if (offset != size) {
+    status_ = Status::DataLoss();
+    return;
+  }
+
+  snapshot_ = buffer.first(size);
+  region_count_ = region_count;
+}
+
+Result<RawSnapshotRegion> RawSnapshotReader::Find(uint32_t tag) const {
+  if (!status_.ok()) {
+    return status_;
+  }
+  size_t offset = kRawSnapshotHeaderSizeBytes;
+  for (uint16_t i = 0; i < region_count_; ++i) {
+    const RawSnapshotRegion region = RegionAt(offset);
+    if (region.tag == tag) {
+      return region;
+    }
+    offset += kRawSnapshotRegionHeaderSizeBytes + region.data.size();
+  }
+  return Status::NotFound();
+}
+
+RawSnapshotRegion RawSnapshotReader::RegionAt(size_t offset) const {
+  const std::byte* const region = snapshot_.data() + offset;
+  return RawSnapshotRegion{
+      .tag = Get<uint32_t>(region),
+      .address = Get<uint64_t>(region + 8),
+      .data = snapshot_.subspan(offset + kRawSnapshotRegionHeaderSizeBytes,
+                                Get<uint32_t>(region + 4)),
+  };
+}
+
+void ClearRawSnapshot(ByteSpan buffer) {
+  if (buffer.size() >= kRawSnapshotHeaderSizeBytes) {
+    Put(buffer.data() + kMagicOffset, uint32_t{0});
+  }
+}
+
+}  // namespace pw::snapshot
@@ -0,0 +1,176 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_snapshot/raw_snapshot.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_bytes/span.h"
+
+namespace pw::snapshot {
+namespace {
+
+constexpr uint32_t kRegisterTag = 1;
+constexpr uint32_t kStackTag = 2;
+
+constexpr auto kRegisters = bytes::Array<0x01, 0x02, 0x03, 0x04>();
+constexpr auto kStack = bytes::Array<0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5>();
+
+bool Equal(ConstByteSpan lhs, ConstByteSpan rhs) {
+  return lhs.size() == rhs.size() &&
+         std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+TEST(RawSnapshot, EmptyBuffer_NotFound) {
+  std::array<std::byte, 64> buffer{};
+  EXPECT_EQ(Status::NotFound(), RawSnapshotReader(buffer).status());
+  EXPECT_EQ(Status::NotFound(), RawSnapshotReader(ConstByteSpan()).status());
+}
+
+TEST(RawSnapshot, WriteAndRead) {
+  std::array<std::byte, RawSnapshotSizeBytes(2, 10)> buffer;
+  RawSnapshotWriter writer(buffer);
+  ASSERT_EQ(OkStatus(), writer.AddRegion(kRegisterTag, 0x1000, kRegisters));
+  ASSERT_EQ(OkStatus(), writer.AddRegion(kStackTag, 0x2000, kStack));
+  const StatusWithSize committed = writer.Commit();
+  ASSERT_EQ(OkStatus(), committed.status());
+  EXPECT_EQ(buffer.size(), committed.size());
+
+  RawSnapshotReader reader(buffer);
+  ASSERT_EQ(OkStatus(), reader.status());
+  EXPECT_EQ(2u, reader.region_count());
+
+  size_t index = 0;
+  reader.ForEachRegion([&index](const RawSnapshotRegion& region) {
+    if (index == 0) {
+      EXPECT_EQ(kRegisterTag, region.tag);
+      EXPECT_EQ(0x1000u, region.address);
+      EXPECT_TRUE(Equal(kRegisters, region.data));
+    } else {
+      EXPECT_EQ(kStackTag, region.tag);
+      EXPECT_EQ(0x2000u, region.address);
+      EXPECT_TRUE(Equal(kStack, region.data));
+    }
+    index += 1;
+  });
+  EXPECT_EQ(2u, index);
+}
+
+TEST(RawSnapshot, Find) {
+  std::array<std::byte, 64> buffer;
+  RawSnapshotWriter writer(buffer);
+  ASSERT_EQ(OkStatus(), writer.AddRegion(kRegisterTag, 0x1000, kRegisters));
+  ASSERT_EQ(OkStatus(), writer.AddRegion(kStackTag, 0x2000, kStack));
+  ASSERT_EQ(OkStatus(), writer.Commit().status());
+
+  RawSnapshotReader reader(buffer);
+  Result<RawSnapshotRegion> stack = reader.Find(kStackTag);
+  ASSERT_EQ(OkStatus(), stack.status());
+  EXPECT_EQ(0x2000u, stack->address);
+  EXPECT_TRUE(Equal(kStack, stack->data));
+
+  EXPECT_EQ(Status::NotFound(), reader.Find(3).status());
+}
+
+TEST(RawSnapshot, Uncommitted_NotFound) {
+  std::array<std::byte, 64> buffer;
+  {
+    RawSnapshotWriter writer(buffer);
+    ASSERT_EQ(OkStatus(), writer.AddRegion(kRegisterTag, 0, kRegisters));
+    ASSERT_EQ(OkStatus(), writer.Commit().status());
+  }
+  ASSERT_EQ(OkStatus(), RawSnapshotReader(buffer).status());
+
+  // A new capture that is interrupted before Commit() leaves no snapshot.
+  RawSnapshotWriter writer(buffer);
+  ASSERT_EQ(OkStatus(), writer.AddRegion(kStackTag, 0, kStack));
+  EXPECT_EQ(Status::NotFound(), RawSnapshotReader(buffer).status());
+}
+
+TEST(RawSnapshot, RegionTooLarge) {
+  std::array<std::byte, RawSnapshotSizeBytes(1, 5)> buffer;
+  RawSnapshotWriter writer(buffer);
+  EXPECT_EQ(Status::ResourceExhausted(),
+            writer.AddRegion(kStackTag, 0, kStack));
+  ASSERT_EQ(OkStatus(), writer.AddRegion(kRegisterTag, 0, kRegisters));
+  ASSERT_EQ(OkStatus(), writer.Commit().status());
+
+  RawSnapshotReader reader(ConstByteSpan(buffer).first(writer.size()));
+  ASSERT_EQ(OkStatus(), reader.status());
+  EXPECT_EQ(1u, reader.region_count());
+}
+
+TEST(RawSnapshot, AddTruncatedRegion) {
+  std::array<std::byte, RawSnapshotSizeBytes(1, 4)> buffer;
+  RawSnapshotWriter writer(buffer);
+  const StatusWithSize result = writer.AddTruncatedRegion(kStackTag, 0, kStack);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(4u, result.size());
+  ASSERT_EQ(OkStatus(), writer.Commit().status());
+
+  Result<RawSnapshotRegion> stack = RawSnapshotReader(buffer).Find(kStackTag);
+  ASSERT_EQ(OkStatus(), stack.status());
+  EXPECT_TRUE(Equal(ConstByteSpan(kStack).first(4), stack->data));
+
+  EXPECT_EQ(Status::FailedPrecondition(),
+            writer.AddTruncatedRegion(kStackTag, 0, kStack).status());
+}
+
+TEST(RawSnapshot, AddTruncatedRegion_NoRoomForHeader) {
+  std::array<std::byte, RawSnapshotSizeBytes(1, 0) - 1> buffer;
+  RawSnapshotWriter writer(buffer);
+  const StatusWithSize result = writer.AddTruncatedRegion(kStackTag, 0, kStack);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST(RawSnapshot, CommitTwice_FailsPrecondition) {
+  std::array<std::byte, 32> buffer;
+  RawSnapshotWriter writer(buffer);
+  ASSERT_EQ(OkStatus(), writer.Commit().status());
+  EXPECT_EQ(Status::FailedPrecondition(), writer.Commit().status());
+  EXPECT_EQ(Status::FailedPrecondition(),
+            writer.AddRegion(kRegisterTag, 0, kRegisters));
+}
+
+TEST(RawSnapshot, CorruptRegionSize_DataLoss) {
+  std::array<std::byte, 64> buffer;
+  RawSnapshotWriter writer(buffer);
+  ASSERT_EQ(OkStatus(), writer.AddRegion(kRegisterTag, 0, kRegisters));
+  ASSERT_EQ(OkStatus(), writer.Commit().status());
+
+  // The first region's size directly follows its tag.
+  buffer[kRawSnapshotHeaderSizeBytes + 4] = std::byte{0xff};
+  RawSnapshotReader reader(buffer);
+  EXPECT_EQ(Status::DataLoss(), reader.status());
+  EXPECT_EQ(0u, reader.region_count());
+  EXPECT_EQ(Status::DataLoss(), reader.Find(kRegisterTag).status());
+}
+
+TEST(RawSnapshot, Clear) {
+  std::array<std::byte, 64> buffer;
+  RawSnapshotWriter writer(buffer);
+  ASSERT_EQ(OkStatus(), writer.AddRegion(kRegisterTag, 0, kRegisters));
+  ASSERT_EQ(OkStatus(), writer.Commit().status());
+
+  ClearRawSnapshot(buffer);
+  EXPECT_EQ(Status::NotFound(), RawSnapshotReader(buffer).status());
+}
+
+}  // namespace
+}  // namespace pw::snapshot
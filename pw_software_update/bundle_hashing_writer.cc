@@ -0,0 +1,253 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_software_update/bundle_hashing_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_software_update/update_bundle.pwpb.h"
+
+namespace pw::software_update {
+namespace {
+
+// Protobuf wire types.
+constexpr uint32_t kVarint = 0;
+constexpr uint32_t kFixed64 = 1;
+constexpr uint32_t kDelimited = 2;
+constexpr uint32_t kFixed32 = 5;
+
+// Field numbers of a `map<string, bytes>` entry.
+constexpr uint32_t kMapKey = 1;
+constexpr uint32_t kMapValue = 2;
+
+constexpr uint32_t kTargetPayloads =
+    static_cast<uint32_t>(UpdateBundle::Fields::kTargetPayloads);
+
+}  // namespace
+
+void BundleHashingWriter::Reset() {
+  digest_count_ = 0;
+  state_ = State::kFieldKey;
+  offset_ = 0;
+  varint_ = 0;
+  varint_shift_ = 0;
+  field_ = 0;
+  field_remaining_ = 0;
+  entry_remaining_ = 0;
+}
+
+const TargetPayloadDigest* BundleHashingWriter::FindDigest(
+    std::string_view name, size_t offset, size_t length) const {
+  for (const TargetPayloadDigest& digest : digests_.first(digest_count_)) {
+    if (digest.offset == offset && digest.length == length &&
+        digest.name() == name) {
+      return &digest;
+    }
+  }
+  return nullptr;
+}
+
+Status BundleHashingWriter::DoWrite(ConstByteSpan data) {
+  if (Status status = writer_.Write(data); !status.ok()) {
+    // The staged bundle no longer matches what was hashed.
+    state_ = State::kFailed;
+    digest_count_ = 0;
+    return status;
+  }
+  Parse(data);
+  return OkStatus();
+}
+
+void BundleHashingWriter::Parse(ConstByteSpan data) {
+  while (!data.empty() && state_ != State::kFailed) {
+    const bool in_entry = IsEntryState(state_);
+    size_t consumed = 1;
+
+    switch (state_) {
+      case State::kFieldKey:
+      case State::kFieldLength:
+      case State::kSkipVarint:
+      case State::kEntryFieldKey:
+      case State::kEntryFieldLength:
+      case State::kEntrySkipVarint: {
+        const uint8_t byte = static_cast<uint8_t>(data[0]);
+        offset_ += 1;
+        if (varint_shift_ >= 64) {
+          state_ = State::kFailed;
+          break;
+        }
+        varint_ |= static_cast<uint64_t>(byte & 0x7f) << varint_shift_;
+        varint_shift_ += 7;
+        if ((byte & 0x80) == 0) {
+          const uint64_t value = varint_;
+          varint_ = 0;
+          varint_shift_ = 0;
+          HandleVarint(value);
+        }
+        break;
+      }
+      case State::kSkipBytes:
+      case State::kEntrySkipBytes:
+      case State::kEntryName:
+      case State::kEntryPayload:
+        consumed = std::min(data.size(), field_remaining_);
+        offset_ += consumed;
+        HandleBytes(data.first(consumed));
+        field_remaining_ -= consumed;
+        if (field_remaining_ == 0) {
+          HandleFieldEnd();
+        }
+        break;
+      case State::kFailed:
+        break;
+    }
+
+    // Every field of a map entry lies within the entry, so the entry ends
+    // between two of its fields.
+    if (in_entry && state_ != State::kFailed) {
+      entry_remaining_ -= consumed;
+      if (entry_remaining_ == 0) {
+        if (state_ == State::kEntryFieldKey && varint_shift_ == 0) {
+          FinishEntry();
+        } else {
+          state_ = State::kFailed;
+        }
+      }
+    }
+
+    data = data.subspan(consumed);
+  }
+}
+
+void BundleHashingWriter::HandleVarint(uint64_t value) {
+  switch (state_) {
+    case State::kFieldKey:
+    case State::kEntryFieldKey: {
+      const bool in_entry = state_ == State::kEntryFieldKey;
+      field_ = static_cast<uint32_t>(value >> 3);
+      switch (static_cast<uint32_t>(value & 0x7)) {
+        case kVarint:
+          state_ = in_entry ? State::kEntrySkipVarint : State::kSkipVarint;
+          return;
+        case kFixed64:
+        case kFixed32:
+          field_remaining_ = (value & 0x7) == kFixed64 ? 8 : 4;
+          state_ = in_entry ? State::kEntrySkipBytes : State::kSkipBytes;
+          return;
+        case kDelimited:
+          state_ = in_entry ? State::kEntryFieldLength : State::kFieldLength;
+          return;
+        default:  // Groups are not used by the bundle protos.
+          state_ = State::kFailed;
+          return;
+      }
+    }
+    case State::kFieldLength:
+      if (field_ == kTargetPayloads) {
+        entry_remaining_ = value;
+        entry_valid_ = true;
+        entry_has_name_ = false;
+        entry_has_payload_ = false;
+        state_ = State::kEntryFieldKey;
+        if (entry_remaining_ == 0) {
+          FinishEntry();
+        }
+        return;
+      }
+      field_remaining_ = value;
+      state_ = State::kSkipBytes;
+      if (field_remaining_ == 0) {
+        HandleFieldEnd();
+      }
+      return;
+    case State::kEntryFieldLength:
+      HandleEntryLength(value);
+      return;
+    case State::kSkipVarint:
+      state_ = State::kFieldKey;
+      return;
+    case State::kEntrySkipVarint:
+      state_ = State::kEntryFieldKey;
+      return;
+    default:
+      state_ = State::kFailed;
+      return;
+  }
+}
+
+void BundleHashingWriter::HandleEntryLength(uint64_t length) {
+  // This byte is counted against the entry only after it is handled.
+  if (length >= entry_remaining_) {
+    state_ = State::kFailed;
+    return;
+  }
+  field_remaining_ = length;
+
+  if (field_ == kMapKey) {
+    if (entry_has_name_ || length > sizeof(entry_.name_buffer)) {
+      entry_valid_ = false;
+      state_ = State::kEntrySkipBytes;
+    } else {
+      entry_has_name_ = true;
+      entry_.name_size = 0;
+      state_ = State::kEntryName;
+    }
+  } else if (field_ == kMapValue) {
+    if (entry_has_payload_) {
+      entry_valid_ = false;
+      state_ = State::kEntrySkipBytes;
+    } else {
+      entry_has_payload_ = true;
+      entry_.offset = offset_;
+      entry_.length = length;
+      entry_sha256_ = crypto::sha256::Sha256();
+      state_ = State::kEntryPayload;
+    }
+  } else {
+    state_ = State::kEntrySkipBytes;
+  }
+
+  if (field_remaining_ == 0) {
+    HandleFieldEnd();
+  }
+}
+
+void BundleHashingWriter::HandleBytes(ConstByteSpan data) {
+  if (state_ == State::kEntryName) {
+    std::memcpy(
+        &entry_.name_buffer[entry_.name_size], data.data(), data.size());
+    entry_.name_size += data.size();
+  } else if (state_ == State::kEntryPayload) {
+    entry_sha256_.Update(data);
+  }
+}
+
+void BundleHashingWriter::HandleFieldEnd() {
+  state_ = IsEntryState(state_) ? State::kEntryFieldKey : State::kFieldKey;
+}
+
+void BundleHashingWriter::FinishEntry() {
+  state_ = State::kFieldKey;
+  if (!entry_valid_ || !entry_has_name_ || !entry_has_payload_ ||
+      digest_count_ == digests_.size()) {
+    return;
+  }
+  if (!entry_sha256_.Final(entry_.sha256).ok()) {
+    return;
+  }
+  digests_[digest_count_++] = entry_;
+}
+
+}  // namespace pw::software_update
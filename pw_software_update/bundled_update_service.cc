@@ -23,6 +23,7 @@
 #include "pw_log/log.h"
 #include "pw_result/result.h"
 #include "pw_software_update/config.h"
+#include "pw_software_update/delta_target.h"
 #include "pw_software_update/manifest_accessor.h"
 #include "pw_software_update/update_bundle.pwpb.h"
 #include "pw_status/status.h"
@@ -379,9 +380,13 @@ void BundledUpdateService::DoApply() {
     }
 
     const size_t bundle_offset = file_reader.start();
-    if (const Status status = backend_.ApplyTargetFile(
-            file_name_view, file_reader, bundle_offset);
-        !status.ok()) {
+    const Status status =
+        IsDeltaTarget(file_name)
+            ? backend_.ApplyDeltaTargetFile(
+                  file_name_view, file_name, file_reader, bundle_offset)
+            : backend_.ApplyTargetFile(
+                  file_name_view, file_reader, bundle_offset);
+    if (!status.ok()) {
       SET_ERROR(pw_software_update_BundledUpdateResult_Enum_APPLY_FAILED,
                 "Failed to apply target file: %d",
                 static_cast<int>(status.code()));
@@ -0,0 +1,146 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_software_update/delta_patch.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "pw_result/result.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw::software_update {
+namespace {
+
+// These must match pw_software_update/delta.py.
+constexpr std::array<std::byte, 4> kMagic = {
+    std::byte{'P'}, std::byte{'W'}, std::byte{'D'}, std::byte{'P'}};
+constexpr uint64_t kVersion = 1;
+constexpr uint64_t kCopy = 0;
+constexpr uint64_t kAdd = 1;
+
+// Fills `data` from `reader`, returning `truncated` if it ends first.
+Status ReadExactly(stream::Reader& reader, ByteSpan data, Status truncated) {
+  while (!data.empty()) {
+    Result<ByteSpan> read = reader.Read(data);
+    if (read.status().IsOutOfRange()) {
+      return truncated;
+    }
+    PW_TRY(read.status());
+    data = data.subspan(read.value().size());
+  }
+  return OkStatus();
+}
+
+Result<uint64_t> ReadVarint(stream::Reader& patch) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < varint::kMaxVarint64SizeBytes; ++i) {
+    std::byte byte;
+    PW_TRY(ReadExactly(patch, span(&byte, 1), Status::DataLoss()));
+    value |= static_cast<uint64_t>(byte & std::byte{0x7f}) << (7 * i);
+    if ((byte & std::byte{0x80}) == std::byte{0}) {
+      return value;
+    }
+  }
+  return Status::DataLoss();
+}
+
+// Copies `length` bytes from `reader` to `destination` through `buffer`.
+Status Forward(stream::Reader& reader,
+               stream::Writer& destination,
+               uint64_t length,
+               ByteSpan buffer,
+               Status truncated) {
+  while (length > 0) {
+    const ByteSpan chunk = buffer.first(
+        static_cast<size_t>(std::min<uint64_t>(buffer.size(), length)));
+    PW_TRY(ReadExactly(reader, chunk, truncated));
+    PW_TRY(destination.Write(chunk));
+    length -= chunk.size();
+  }
+  return OkStatus();
+}
+
+}  // namespace
+
+Status ApplyDeltaPatch(stream::Reader& patch,
+                       stream::SeekableReader& source,
+                       stream::Writer& destination,
+                       ByteSpan buffer) {
+  if (buffer.empty()) {
+    return Status::InvalidArgument();
+  }
+
+  std::array<std::byte, kMagic.size()> magic;
+  PW_TRY(ReadExactly(patch, magic, Status::DataLoss()));
+  if (magic != kMagic) {
+    return Status::DataLoss();
+  }
+  PW_TRY_ASSIGN(const uint64_t version, ReadVarint(patch));
+  if (version != kVersion) {
+    return Status::Unimplemented();
+  }
+  PW_TRY_ASSIGN(uint64_t remaining, ReadVarint(patch));
+
+  uint64_t source_position = 0;
+  while (remaining > 0) {
+    PW_TRY_ASSIGN(const uint64_t command, ReadVarint(patch));
+    const uint64_t length = command >> 2;
+    if (length > remaining) {
+      return Status::DataLoss();
+    }
+
+    switch (command & 0x3) {
+      case kCopy: {
+        PW_TRY_ASSIGN(const uint64_t encoded, ReadVarint(patch));
+        const int64_t adjustment = varint::ZigZagDecode(encoded);
+        // Adding the two's complement of a negative adjustment wraps, so a
+        // move before the start of the source shows up as a larger position.
+        const uint64_t position =
+            source_position + static_cast<uint64_t>(adjustment);
+        if ((adjustment < 0) != (position < source_position) ||
+            position >
+                static_cast<uint64_t>(std::numeric_limits<ptrdiff_t>::max())) {
+          return Status::DataLoss();
+        }
+        PW_TRY(source.Seek(static_cast<ptrdiff_t>(position)));
+        PW_TRY(Forward(
+            source, destination, length, buffer, Status::OutOfRange()));
+        source_position = position + length;
+        break;
+      }
+      case kAdd:
+        PW_TRY(
+            Forward(patch, destination, length, buffer, Status::DataLoss()));
+        break;
+      default:
+        return Status::DataLoss();
+    }
+    remaining -= length;
+  }
+
+  // Anything after the last command means the patch is not what was signed
+  // for this target.
+  std::byte extra;
+  Result<ByteSpan> read = patch.Read(span(&extra, 1));
+  if (read.ok() && !read.value().empty()) {
+    return Status::DataLoss();
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::software_update
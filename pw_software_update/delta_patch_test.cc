@@ -0,0 +1,132 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_software_update/delta_patch.h"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::software_update {
+namespace {
+
+constexpr std::string_view kSource =
+    "Hello, Pigweed! Hello, world! This is version 1.0 of the firmware image.";
+constexpr std::string_view kTarget =
+    "Hello, world! Hello, Pigweed! This is version 1.1 of the firmware image, "
+    "now with delta updates.";
+
+// Generated in Python with `delta.make_patch(kSource, kTarget)`.
+constexpr auto kPatch = bytes::Array<
+    0x50, 0x57, 0x44, 0x50, 0x01, 0x60, 0x39, 0x48, 0x65, 0x6c, 0x6c,
+    0x6f, 0x2c, 0x20, 0x77, 0x6f, 0x72, 0x6c, 0x64, 0x21, 0x20, 0x40,
+    0x00, 0x48, 0x1c, 0x05, 0x31, 0x58, 0x02, 0x65, 0x2c, 0x20, 0x6e,
+    0x6f, 0x77, 0x20, 0x77, 0x69, 0x74, 0x68, 0x20, 0x64, 0x65, 0x6c,
+    0x74, 0x61, 0x20, 0x75, 0x70, 0x64, 0x61, 0x74, 0x65, 0x73, 0x2e>();
+
+class DeltaPatchTest : public ::testing::Test {
+ protected:
+  DeltaPatchTest() : source_(as_bytes(span(kSource))), destination_(result_) {}
+
+  Status Apply(ConstByteSpan patch, size_t buffer_size = 16) {
+    stream::MemoryReader patch_reader(patch);
+    return ApplyDeltaPatch(patch_reader,
+                           source_,
+                           destination_,
+                           span(buffer_).first(buffer_size));
+  }
+
+  std::string_view result() const {
+    return std::string_view(reinterpret_cast<const char*>(result_.data()),
+                            destination_.bytes_written());
+  }
+
+  stream::MemoryReader source_;
+  std::array<std::byte, 128> result_;
+  stream::MemoryWriter destination_;
+  std::array<std::byte, 64> buffer_;
+};
+
+TEST_F(DeltaPatchTest, RebuildsTarget) {
+  ASSERT_EQ(OkStatus(), Apply(kPatch));
+  EXPECT_EQ(result(), kTarget);
+}
+
+TEST_F(DeltaPatchTest, RebuildsTargetWithAnyBufferSize) {
+  for (size_t buffer_size : {1u, 3u, 64u}) {
+    destination_ = stream::MemoryWriter(result_);
+    ASSERT_EQ(OkStatus(), Apply(kPatch, buffer_size));
+    EXPECT_EQ(result(), kTarget);
+  }
+}
+
+TEST_F(DeltaPatchTest, EmptyBufferIsInvalid) {
+  EXPECT_EQ(Status::InvalidArgument(), Apply(kPatch, 0));
+}
+
+TEST_F(DeltaPatchTest, RejectsBadMagic) {
+  constexpr auto kBadMagic = bytes::Array<'P', 'W', 'D', 'X', 0x01, 0x00>();
+  EXPECT_EQ(Status::DataLoss(), Apply(kBadMagic));
+}
+
+TEST_F(DeltaPatchTest, RejectsUnknownVersion) {
+  constexpr auto kVersion2 = bytes::Array<'P', 'W', 'D', 'P', 0x02, 0x00>();
+  EXPECT_EQ(Status::Unimplemented(), Apply(kVersion2));
+}
+
+TEST_F(DeltaPatchTest, RejectsTruncatedPatch) {
+  EXPECT_EQ(Status::DataLoss(),
+            Apply(span(kPatch).first(kPatch.size() - 1)));
+}
+
+TEST_F(DeltaPatchTest, RejectsTrailingBytes) {
+  // ADD "ab" to a 2 byte result, followed by an extra byte.
+  constexpr auto kTrailing =
+      bytes::Array<'P', 'W', 'D', 'P', 0x01, 0x02, 0x09, 'a', 'b', 'c'>();
+  EXPECT_EQ(Status::DataLoss(), Apply(kTrailing));
+}
+
+TEST_F(DeltaPatchTest, RejectsCommandLongerThanResult) {
+  // ADD of 3 bytes to a 2 byte result.
+  constexpr auto kOverrun =
+      bytes::Array<'P', 'W', 'D', 'P', 0x01, 0x02, 0x0d, 'a', 'b', 'c'>();
+  EXPECT_EQ(Status::DataLoss(), Apply(kOverrun));
+}
+
+TEST_F(DeltaPatchTest, RejectsUnknownCommand) {
+  constexpr auto kUnknown =
+      bytes::Array<'P', 'W', 'D', 'P', 0x01, 0x02, 0x0a, 'a', 'b'>();
+  EXPECT_EQ(Status::DataLoss(), Apply(kUnknown));
+}
+
+TEST_F(DeltaPatchTest, RejectsCopyBeforeSource) {
+  // COPY of 4 bytes, moving the source position by -1.
+  constexpr auto kBeforeStart =
+      bytes::Array<'P', 'W', 'D', 'P', 0x01, 0x04, 0x10, 0x01>();
+  EXPECT_EQ(Status::DataLoss(), Apply(kBeforeStart));
+}
+
+TEST_F(DeltaPatchTest, RejectsCopyPastSource) {
+  // COPY of 4 bytes starting 70 bytes in, which runs past the source.
+  constexpr auto kPastEnd =
+      bytes::Array<'P', 'W', 'D', 'P', 0x01, 0x04, 0x10, 0x8c, 0x01>();
+  EXPECT_EQ(Status::OutOfRange(), Apply(kPastEnd));
+}
+
+}  // namespace
+}  // namespace pw::software_update
@@ -0,0 +1,153 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PWSU"
+#define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
+
+#include "pw_software_update/delta_target.h"
+
+#include <algorithm>
+
+#include "pw_crypto/sha256.h"
+#include "pw_log/log.h"
+#include "pw_result/result.h"
+#include "pw_software_update/delta_patch.h"
+#include "pw_software_update/tuf.pwpb.h"
+#include "pw_status/try.h"
+#include "pw_stream/interval_reader.h"
+
+namespace pw::software_update {
+namespace {
+
+// Passes writes through while measuring them.
+class MeasuringWriter final : public stream::NonSeekableWriter {
+ public:
+  explicit MeasuringWriter(stream::Writer& writer) : writer_(writer) {}
+
+  size_t bytes_written() const { return bytes_written_; }
+  Status Final(ByteSpan digest) { return sha256_.Final(digest); }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    PW_TRY(writer_.Write(data));
+    sha256_.Update(data);
+    bytes_written_ += data.size();
+    return OkStatus();
+  }
+
+  stream::Writer& writer_;
+  crypto::sha256::Sha256 sha256_;
+  size_t bytes_written_ = 0;
+};
+
+// Returns the SHA256 hash from a list of `Hash` messages.
+protobuf::Bytes GetSha256(protobuf::RepeatedMessages hashes) {
+  for (protobuf::Message hash : hashes) {
+    protobuf::Uint32 hash_function =
+        hash.AsUint32(static_cast<uint32_t>(Hash::Fields::kFunction));
+    PW_TRY(hash_function.status());
+    if (hash_function.value() == static_cast<uint32_t>(HashFunction::SHA256)) {
+      return hash.AsBytes(static_cast<uint32_t>(Hash::Fields::kHash));
+    }
+  }
+  return Status::NotFound();
+}
+
+// Checks that the first `length` bytes of `source` hash to `expected_sha256`.
+Status CheckSource(stream::SeekableReader& source,
+                   uint64_t length,
+                   protobuf::Bytes expected_sha256,
+                   ByteSpan buffer) {
+  PW_TRY(source.Seek(0));
+  crypto::sha256::Sha256 sha256;
+  while (length > 0) {
+    const ByteSpan chunk = buffer.first(
+        static_cast<size_t>(std::min<uint64_t>(buffer.size(), length)));
+    Result<ByteSpan> read = source.Read(chunk);
+    if (read.status().IsOutOfRange()) {
+      return Status::FailedPrecondition();
+    }
+    PW_TRY(read.status());
+    sha256.Update(read.value());
+    length -= read.value().size();
+  }
+
+  std::byte digest[crypto::sha256::kDigestSizeBytes];
+  PW_TRY(sha256.Final(digest));
+  PW_TRY_ASSIGN(const bool equal, expected_sha256.Equal(digest));
+  return equal ? OkStatus() : Status::FailedPrecondition();
+}
+
+}  // namespace
+
+bool IsDeltaTarget(protobuf::Message target_file) {
+  return target_file
+      .AsMessage(static_cast<uint32_t>(TargetFile::Fields::kDelta))
+      .ok();
+}
+
+Status ApplyDeltaTarget(protobuf::Message target_file,
+                        stream::Reader& patch,
+                        stream::SeekableReader& source,
+                        stream::Writer& destination,
+                        ByteSpan buffer) {
+  if (buffer.empty()) {
+    return Status::InvalidArgument();
+  }
+
+  protobuf::Message delta =
+      target_file.AsMessage(static_cast<uint32_t>(TargetFile::Fields::kDelta));
+  if (!delta.ok()) {
+    return Status::FailedPrecondition();
+  }
+
+  protobuf::Uint64 source_length = delta.AsUint64(
+      static_cast<uint32_t>(DeltaEncoding::Fields::kSourceLength));
+  PW_TRY(source_length.status());
+  protobuf::Bytes source_sha256 = GetSha256(delta.AsRepeatedMessages(
+      static_cast<uint32_t>(DeltaEncoding::Fields::kSourceHashes)));
+  PW_TRY(source_sha256.status());
+  protobuf::Uint64 result_length = delta.AsUint64(
+      static_cast<uint32_t>(DeltaEncoding::Fields::kResultLength));
+  PW_TRY(result_length.status());
+  protobuf::Bytes result_sha256 = GetSha256(delta.AsRepeatedMessages(
+      static_cast<uint32_t>(DeltaEncoding::Fields::kResultHashes)));
+  PW_TRY(result_sha256.status());
+
+  // Patching a different image would produce garbage, so check the source
+  // before anything is written.
+  if (Status status = CheckSource(
+          source, source_length.value(), source_sha256, buffer);
+      !status.ok()) {
+    PW_LOG_ERROR("Delta source image does not match");
+    return status;
+  }
+
+  // Confine the patch to the checked part of the source.
+  stream::IntervalReader checked_source(
+      source, 0, static_cast<size_t>(source_length.value()));
+  MeasuringWriter measured_destination(destination);
+  PW_TRY(ApplyDeltaPatch(patch, checked_source, measured_destination, buffer));
+
+  std::byte digest[crypto::sha256::kDigestSizeBytes];
+  PW_TRY(measured_destination.Final(digest));
+  PW_TRY_ASSIGN(const bool equal, result_sha256.Equal(digest));
+  if (!equal || measured_destination.bytes_written() != result_length.value()) {
+    PW_LOG_ERROR("Delta result image does not match");
+    return Status::DataLoss();
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::software_update
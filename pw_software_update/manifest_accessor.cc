@@ -47,7 +47,7 @@ ManifestAccessor ManifestAccessor::FromManifest(protobuf::Message manifest) {
 
 protobuf::RepeatedMessages ManifestAccessor::GetTargetFiles() {
   PW_TRY(status());
-  return targets_metadata_.AsRepeatedMessages(
+  return targets_metadata_.message().AsRepeatedMessages(
       static_cast<uint32_t>(TargetsMetadata::Fields::kTargetFiles));
 }
 
@@ -65,7 +65,7 @@ Status ManifestAccessor::Export(stream::Writer& writer) {
   // Write out the targets metadata map.
   stream::MemoryReader name_reader(as_bytes(span(kTopLevelTargetsName)));
   stream::IntervalReader metadata_reader =
-      targets_metadata_.ToBytes().GetBytesReader();
+      targets_metadata_.message().ToBytes().GetBytesReader();
   std::byte stream_pipe_buffer[WRITE_MANIFEST_STREAM_PIPE_BUFFER_SIZE];
   PW_TRY(protobuf::WriteProtoStringToBytesMapEntry(
       static_cast<uint32_t>(Manifest::Fields::kTargetsMetadata),
@@ -0,0 +1,140 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_crypto/sha256.h"
+#include "pw_software_update/config.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::software_update {
+
+// The SHA256 digest of a target payload in a staged bundle, measured while the
+// bundle was written.
+struct TargetPayloadDigest {
+  std::string_view name() const {
+    return std::string_view(name_buffer, name_size);
+  }
+
+  char name_buffer[MAX_TARGET_NAME_LENGTH];
+  size_t name_size;
+  // Position of the payload bytes from the start of the bundle.
+  size_t offset;
+  size_t length;
+  std::array<std::byte, crypto::sha256::kDigestSizeBytes> sha256;
+};
+
+// BundleHashingWriter forwards an incoming update bundle to the writer that
+// stages it, typically a blob_store::BlobStore::BlobWriter, and hashes each
+// target payload in `UpdateBundle.target_payloads` as it passes through. This
+// pipelines payload hashing with the transfer, so that an UpdateBundleAccessor
+// given the writer through UseStreamedDigests() verifies payloads without
+// reading them back from the staging storage.
+//
+// Only the digests of the first `digests.size()` payloads are kept; the rest
+// are hashed at verification as usual. The same happens for every payload if
+// the bundle is malformed or a write fails.
+//
+// The writer must see the bundle from its first byte: call Reset() whenever
+// the staging storage is erased or rewritten.
+class BundleHashingWriter final : public stream::NonSeekableWriter {
+ public:
+  BundleHashingWriter(stream::Writer& writer,
+                      span<TargetPayloadDigest> digests)
+      : writer_(writer), digests_(digests) {
+    Reset();
+  }
+
+  // Discards all digests and starts over with a new bundle.
+  void Reset();
+
+  // Returns the digest of the payload of target `name` that occupies
+  // [offset, offset + length) in the bundle, or nullptr if it is not known.
+  const TargetPayloadDigest* FindDigest(std::string_view name,
+                                        size_t offset,
+                                        size_t length) const;
+
+  // Number of bundle bytes written through this writer since Reset().
+  size_t bytes_written() const { return offset_; }
+
+ private:
+  enum class State : uint8_t {
+    // Top-level UpdateBundle fields.
+    kFieldKey,
+    kFieldLength,
+    kSkipVarint,
+    kSkipBytes,
+
+    // Fields of a `target_payloads` map entry.
+    kEntryFieldKey,
+    kEntryFieldLength,
+    kEntrySkipVarint,
+    kEntrySkipBytes,
+    kEntryName,
+    kEntryPayload,
+
+    // Malformed bundle or failed write; nothing more is hashed.
+    kFailed,
+  };
+
+  Status DoWrite(ConstByteSpan data) override;
+
+  size_t ConservativeLimit(LimitType limit_type) const override {
+    return limit_type == LimitType::kWrite ? writer_.ConservativeWriteLimit()
+                                           : 0;
+  }
+
+  void Parse(ConstByteSpan data);
+  void HandleVarint(uint64_t value);
+  void HandleBytes(ConstByteSpan data);
+  void HandleFieldEnd();
+  void HandleEntryLength(uint64_t length);
+  void FinishEntry();
+
+  static bool IsEntryState(State state) {
+    return state >= State::kEntryFieldKey && state <= State::kEntryPayload;
+  }
+
+  stream::Writer& writer_;
+  span<TargetPayloadDigest> digests_;
+  size_t digest_count_;
+
+  State state_;
+  size_t offset_;
+
+  // Varint being decoded.
+  uint64_t varint_;
+  uint8_t varint_shift_;
+
+  // Field number of the current field, and the bytes left in it when it is
+  // length delimited.
+  uint32_t field_;
+  size_t field_remaining_;
+
+  // The `target_payloads` map entry being parsed.
+  size_t entry_remaining_;
+  bool entry_valid_;
+  bool entry_has_name_;
+  bool entry_has_payload_;
+  TargetPayloadDigest entry_;
+  crypto::sha256::Sha256 entry_sha256_;
+};
+
+}  // namespace pw::software_update
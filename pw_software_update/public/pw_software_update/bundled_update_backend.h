@@ -16,6 +16,7 @@
 
 #include <string_view>
 
+#include "pw_protobuf/message.h"
 #include "pw_result/result.h"
 #include "pw_software_update/manifest_accessor.h"
 #include "pw_software_update/update_bundle_accessor.h"
@@ -90,6 +91,20 @@ class BundledUpdateBackend {
                                  stream::SeekableReader& target_payload,
                                  size_t update_bundle_offset) = 0;
 
+  // Update the specific target file on the device from a delta patch. Called
+  // instead of ApplyTargetFile() for target files whose metadata has `delta`
+  // set; target_payload is the patch, not the new image. Implementations open
+  // the currently installed image and the destination slot and call
+  // ApplyDeltaTarget() from pw_software_update/delta_target.h, which checks
+  // the installed image and the result against the signed hashes.
+  virtual Status ApplyDeltaTargetFile(
+      [[maybe_unused]] std::string_view target_file_name,
+      [[maybe_unused]] protobuf::Message target_file,
+      [[maybe_unused]] stream::SeekableReader& target_payload,
+      [[maybe_unused]] size_t update_bundle_offset) {
+    return Status::Unimplemented();
+  }
+
   // Backend to probe the device manifest and prepare a ready-to-go reader
   // for it. See the comments to `GetCurrentManfestReader()` for more context.
   virtual Status BeforeManifestRead() {
@@ -0,0 +1,40 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::software_update {
+
+// Rebuilds a target image by applying a delta patch, as generated by
+// pw_software_update/delta.py, to the image it was made against. The patch is
+// consumed in one pass and the result written in order, so `destination` can
+// write straight to the inactive slot. `buffer` is the only working memory;
+// larger buffers mean fewer, larger reads and writes.
+//
+// Returns:
+// OK - The result was written to `destination`.
+// INVALID_ARGUMENT - `buffer` is empty.
+// DATA_LOSS - The patch is malformed or truncated.
+// OUT_OF_RANGE - The patch reads beyond the end of `source`.
+// UNIMPLEMENTED - The patch format version is not supported.
+// Any error returned by the streams.
+Status ApplyDeltaPatch(stream::Reader& patch,
+                       stream::SeekableReader& source,
+                       stream::Writer& destination,
+                       ByteSpan buffer);
+
+}  // namespace pw::software_update
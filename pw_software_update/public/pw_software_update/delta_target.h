@@ -0,0 +1,44 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_bytes/span.h"
+#include "pw_protobuf/message.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::software_update {
+
+// Returns whether the payload of `target_file`, a `TargetFile` message from
+// a verified manifest, is a delta patch rather than the target image.
+bool IsDeltaTarget(protobuf::Message target_file);
+
+// Applies the delta patch payload of a delta target with ApplyDeltaPatch(),
+// checking the images on either side against the target's signed
+// `DeltaEncoding`. `source` is read from its start, and only the length of the
+// source image is read from it, so it may be a whole slot.
+//
+// Returns:
+// OK - The rebuilt image was written to `destination` and matches.
+// FAILED_PRECONDITION - `target_file` is not a delta target, or `source` does
+//     not hold the image the patch was made against. Nothing was written.
+// DATA_LOSS - The patch is malformed or the rebuilt image does not match.
+// Any other error from ApplyDeltaPatch() or the streams.
+Status ApplyDeltaTarget(protobuf::Message target_file,
+                        stream::Reader& patch,
+                        stream::SeekableReader& source,
+                        stream::Writer& destination,
+                        ByteSpan buffer);
+
+}  // namespace pw::software_update
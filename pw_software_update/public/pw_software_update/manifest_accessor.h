@@ -56,7 +56,9 @@ class ManifestAccessor {
  private:
   friend class UpdateBundleAccessor;
 
-  protobuf::Message targets_metadata_;
+  // Indexed so that repeated lookups of the metadata's fields, such as the
+  // version, don't re-parse the list of target files.
+  protobuf::MessageView<2> targets_metadata_;
   protobuf::Bytes user_manifest_;
 
   ManifestAccessor(Status status) : targets_metadata_(status) {}
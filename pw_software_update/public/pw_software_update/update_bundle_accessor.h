@@ -20,6 +20,7 @@
 #include "pw_protobuf/map_utils.h"
 #include "pw_protobuf/message.h"
 #include "pw_software_update/blob_store_openable_reader.h"
+#include "pw_software_update/bundle_hashing_writer.h"
 #include "pw_software_update/bundled_update_backend.h"
 #include "pw_software_update/manifest_accessor.h"
 #include "pw_software_update/openable_reader.h"
@@ -138,6 +139,15 @@ class UpdateBundleAccessor {
   // manifest *AND* exists in the bundle.
   Result<uint64_t> GetTotalPayloadSize();
 
+  // Verifies in-bundle target payloads against the digests `hasher` measured
+  // while the bundle was staged through it, rather than reading the payloads
+  // back to hash them. Digests are only used when the hasher saw as many bytes
+  // as the staged bundle holds; payloads without one are hashed as usual.
+  // Set before OpenAndVerify().
+  void UseStreamedDigests(const BundleHashingWriter& hasher) {
+    streamed_digests_ = &hasher;
+  }
+
  private:
   // Union is a temporary measure to allow for migration from the BlobStore
   // constructor to the OpenableReader constructor. The BlobStoreOpenableReader
@@ -154,6 +164,9 @@ class UpdateBundleAccessor {
   protobuf::Message trusted_root_;
   bool self_verification_;
   bool bundle_verified_ = false;
+  // Size in bytes of the staged bundle, once opened.
+  size_t bundle_size_ = 0;
+  const BundleHashingWriter* streamed_digests_ = nullptr;
 
   // Opens the bundle for read-only access and readies the parser.
   Status DoOpen();
@@ -228,7 +241,8 @@ class UpdateBundleAccessor {
 
   // For a target the payload of which is included in the bundle, verify
   // it measures up to the expected length and sha256 hash.
-  Status VerifyInBundleTargetPayload(protobuf::Uint64 expected_length,
+  Status VerifyInBundleTargetPayload(std::string_view name,
+                                     protobuf::Uint64 expected_length,
                                      protobuf::Bytes expected_sha256,
                                      stream::IntervalReader payload_reader);
 
@@ -0,0 +1,85 @@
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Unit tests for pw_software_update/delta.py."""
+
+import random
+import unittest
+
+from pw_software_update import delta
+
+
+class DeltaPatchTest(unittest.TestCase):
+    """Test generating and applying delta patches."""
+
+    def setUp(self):
+        self._random = random.Random(1234)
+
+    def _random_bytes(self, size: int) -> bytes:
+        return bytes(self._random.getrandbits(8) for _ in range(size))
+
+    def _check_round_trip(self, source: bytes, target: bytes) -> bytes:
+        patch = delta.make_patch(source, target)
+        self.assertEqual(target, delta.apply_patch(source, patch))
+        return patch
+
+    def test_identical_images(self):
+        image = self._random_bytes(4096)
+        patch = self._check_round_trip(image, image)
+        self.assertLess(len(patch), 16)
+
+    def test_small_edits_give_small_patch(self):
+        source = self._random_bytes(8192)
+        target = bytearray(source)
+        # Patch a few 32-bit "addresses" and insert and remove some bytes.
+        for offset in (100, 2000, 5000):
+            target[offset : offset + 4] = self._random_bytes(4)
+        target[3000:3000] = b'inserted'
+        del target[6000:6100]
+        patch = self._check_round_trip(source, bytes(target))
+        self.assertLess(len(patch), 128)
+
+    def test_unrelated_images(self):
+        source = self._random_bytes(1024)
+        target = self._random_bytes(1024)
+        patch = self._check_round_trip(source, target)
+        self.assertGreater(len(patch), len(target))
+
+    def test_empty_images(self):
+        self._check_round_trip(b'', b'')
+        self._check_round_trip(b'source', b'')
+        self._check_round_trip(b'', b'target')
+
+    def test_moved_blocks_copy_backwards(self):
+        first = self._random_bytes(512)
+        second = self._random_bytes(512)
+        patch = self._check_round_trip(first + second, second + first)
+        self.assertLess(len(patch), 32)
+
+    def test_rejects_bad_magic(self):
+        with self.assertRaises(delta.DeltaPatchError):
+            delta.apply_patch(b'', b'XXXX\x01\x00')
+
+    def test_rejects_truncated_patch(self):
+        patch = delta.make_patch(b'', b'target')
+        with self.assertRaises(delta.DeltaPatchError):
+            delta.apply_patch(b'', patch[:-1])
+
+    def test_rejects_copy_outside_source(self):
+        patch = delta.make_patch(b'0123456789abcdef' * 2, b'0123456789abcdef')
+        with self.assertRaises(delta.DeltaPatchError):
+            delta.apply_patch(b'0123456789', patch)
+
+
+if __name__ == '__main__':
+    unittest.main()
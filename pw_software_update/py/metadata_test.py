@@ -38,6 +38,24 @@ class GenTargetsMetadataTest(unittest.TestCase):
         )
         self.assertEqual(42, targets_metadata.common_metadata.version)
 
+    def test_delta_target(self):
+        """Checks that delta targets describe the images they connect."""
+        target_payloads = {
+            'foo': b'patch',
+            'bar': b'\x12\x34',
+        }
+        deltas = {'foo': metadata.gen_delta_encoding(b'old', b'new image')}
+        targets_metadata = metadata.gen_targets_metadata(
+            target_payloads, (HashFunction.SHA256,), deltas=deltas
+        )
+        foo, bar = targets_metadata.target_files
+        self.assertTrue(foo.HasField('delta'))
+        self.assertEqual(5, foo.length)
+        self.assertEqual(3, foo.delta.source_length)
+        self.assertEqual(9, foo.delta.result_length)
+        self.assertEqual(1, len(foo.delta.result_hashes))
+        self.assertFalse(bar.HasField('delta'))
+
 
 class GenHashesTest(unittest.TestCase):
     """Test the generation of hashes."""
@@ -0,0 +1,171 @@
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Generates and applies delta patches for delta update targets.
+
+A delta patch rebuilds a target image from the image already on the device,
+so that an update only ships the bytes that changed. The format is applied in
+a single streaming pass by pw::software_update::ApplyDeltaPatch():
+
+  patch   := "PWDP" varint(version) varint(result_length) command*
+  command := varint(length << 2 | kind) operand
+
+  COPY (kind 0): operand is a zigzag varint added to the source position
+                 before `length` source bytes are copied. The source position
+                 then advances past them. It starts at 0.
+  ADD (kind 1):  operand is `length` literal bytes.
+
+Varints are unsigned LEB128. Commands repeat until `result_length` bytes have
+been produced.
+"""
+
+from typing import Dict
+
+MAGIC = b'PWDP'
+VERSION = 1
+
+KIND_COPY = 0
+KIND_ADD = 1
+
+# Shortest run of source bytes worth a COPY command, and the stride at which
+# source blocks of that length are indexed.
+_BLOCK_SIZE = 16
+_INDEX_STRIDE = 4
+
+
+class DeltaPatchError(Exception):
+    """Raised when a delta patch is malformed or does not fit its source."""
+
+
+def _varint(value: int) -> bytes:
+    encoded = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            encoded.append(byte | 0x80)
+        else:
+            encoded.append(byte)
+            return bytes(encoded)
+
+
+def _zigzag(value: int) -> int:
+    return (value << 1) if value >= 0 else ((-value << 1) - 1)
+
+
+def _unzigzag(value: int) -> int:
+    return (value >> 1) if not value & 1 else -((value + 1) >> 1)
+
+
+def make_patch(source: bytes, target: bytes) -> bytes:
+    """Returns a delta patch that rebuilds `target` from `source`."""
+    index: Dict[bytes, int] = {}
+    for offset in range(0, len(source) - _BLOCK_SIZE + 1, _INDEX_STRIDE):
+        index.setdefault(source[offset : offset + _BLOCK_SIZE], offset)
+
+    patch = bytearray(MAGIC)
+    patch += _varint(VERSION)
+    patch += _varint(len(target))
+
+    def add(data: bytes) -> None:
+        if data:
+            patch.extend(_varint(len(data) << 2 | KIND_ADD))
+            patch.extend(data)
+
+    source_position = 0
+    literal_start = 0
+    position = 0
+    while position + _BLOCK_SIZE <= len(target):
+        match = index.get(target[position : position + _BLOCK_SIZE])
+        if match is None:
+            position += 1
+            continue
+
+        # Grow the match backwards into the pending literal, then forwards.
+        while (
+            position > literal_start
+            and match > 0
+            and target[position - 1] == source[match - 1]
+        ):
+            position -= 1
+            match -= 1
+        length = 0
+        while (
+            position + length < len(target)
+            and match + length < len(source)
+            and target[position + length] == source[match + length]
+        ):
+            length += 1
+
+        add(target[literal_start:position])
+        patch += _varint(length << 2 | KIND_COPY)
+        patch += _varint(_zigzag(match - source_position))
+        source_position = match + length
+        position += length
+        literal_start = position
+
+    add(target[literal_start:])
+    return bytes(patch)
+
+
+def apply_patch(source: bytes, patch: bytes) -> bytes:
+    """Rebuilds the target image from `source` and a delta patch."""
+    position = 0
+
+    def read_varint() -> int:
+        nonlocal position
+        value = 0
+        shift = 0
+        while True:
+            if position >= len(patch):
+                raise DeltaPatchError('Truncated varint')
+            byte = patch[position]
+            position += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    if patch[: len(MAGIC)] != MAGIC:
+        raise DeltaPatchError('Not a delta patch')
+    position = len(MAGIC)
+    if read_varint() != VERSION:
+        raise DeltaPatchError('Unsupported delta patch version')
+    remaining = read_varint()
+
+    result = bytearray()
+    source_position = 0
+    while remaining:
+        command = read_varint()
+        length = command >> 2
+        if length > remaining:
+            raise DeltaPatchError('Command overruns the result')
+        kind = command & 0x3
+        if kind == KIND_COPY:
+            source_position += _unzigzag(read_varint())
+            if source_position < 0 or source_position + length > len(source):
+                raise DeltaPatchError('Copy outside of the source')
+            result += source[source_position : source_position + length]
+            source_position += length
+        elif kind == KIND_ADD:
+            if position + length > len(patch):
+                raise DeltaPatchError('Truncated literal')
+            result += patch[position : position + length]
+            position += length
+        else:
+            raise DeltaPatchError(f'Unknown command kind {kind}')
+        remaining -= length
+
+    if position != len(patch):
+        raise DeltaPatchError('Trailing bytes after the last command')
+    return bytes(result)
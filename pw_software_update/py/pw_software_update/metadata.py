@@ -15,10 +15,11 @@
 
 import enum
 import hashlib
-from typing import Dict, Iterable
+from typing import Dict, Iterable, Optional
 
 from pw_software_update.tuf_pb2 import (
     CommonMetadata,
+    DeltaEncoding,
     Hash,
     HashFunction,
     TargetFile,
@@ -52,12 +53,30 @@ def gen_common_metadata(
 
 
 def gen_target_file(
-    file_name: str, file_contents: bytes, hash_funcs=DEFAULT_HASHES
+    file_name: str,
+    file_contents: bytes,
+    hash_funcs=DEFAULT_HASHES,
+    delta: Optional[DeltaEncoding] = None,
 ) -> TargetFile:
     return TargetFile(
         file_name=file_name,
         length=len(file_contents),
         hashes=gen_hashes(file_contents, hash_funcs),
+        delta=delta,
+    )
+
+
+def gen_delta_encoding(
+    source: bytes,
+    result: bytes,
+    hash_funcs: Iterable['HashFunction.V'] = DEFAULT_HASHES,
+) -> DeltaEncoding:
+    """Describes the images on either side of a delta patch."""
+    return DeltaEncoding(
+        source_length=len(source),
+        source_hashes=gen_hashes(source, hash_funcs),
+        result_length=len(result),
+        result_hashes=gen_hashes(result, hash_funcs),
     )
 
 
@@ -65,14 +84,19 @@ def gen_targets_metadata(
     target_payloads: Dict[str, bytes],
     hash_funcs: Iterable['HashFunction.V'] = DEFAULT_HASHES,
     version: int = DEFAULT_METADATA_VERSION,
+    deltas: Optional[Dict[str, DeltaEncoding]] = None,
 ) -> TargetsMetadata:
-    """Generates TargetsMetadata the given target payloads."""
+    """Generates TargetsMetadata the given target payloads.
+
+    Targets named in `deltas` have delta patches as their payloads.
+    """
     target_files = []
     for target_file_name, target_payload in target_payloads.items():
         new_target_file = gen_target_file(
             file_name=target_file_name,
             file_contents=target_payload,
             hash_funcs=hash_funcs,
+            delta=(deltas or {}).get(target_file_name),
         )
 
         target_files.append(new_target_file)
@@ -20,7 +20,7 @@ from pathlib import Path
 import shutil
 from typing import Dict, Iterable, Optional, Tuple
 
-from pw_software_update import metadata
+from pw_software_update import delta, metadata
 from pw_software_update.tuf_pb2 import SignedRootMetadata, SignedTargetsMetadata
 from pw_software_update.update_bundle_pb2 import UpdateBundle
 
@@ -111,6 +111,7 @@ def gen_unsigned_update_bundle(
     persist: Optional[Path] = None,
     targets_metadata_version: int = metadata.DEFAULT_METADATA_VERSION,
     root_metadata: Optional[SignedRootMetadata] = None,
+    delta_sources: Optional[Dict[str, Path]] = None,
 ) -> UpdateBundle:
     """Given a set of targets, generates an unsigned UpdateBundle.
 
@@ -119,6 +120,9 @@ def gen_unsigned_update_bundle(
       persist: If not None, persist the raw TUF repository to this directory.
       targets_metadata_version: version number for the targets metadata.
       root_metadata: Optional signed Root metadata.
+      delta_sources: Optional dict mapping target names to the Paths of the
+        images devices currently have for them. Those targets are bundled as
+        delta patches against these images.
 
     The input targets will be treated as an ephemeral TUF repository for the
     purposes of building an UpdateBundle instance. This approach differs
@@ -147,15 +151,24 @@ def gen_unsigned_update_bundle(
         os.makedirs(persist)
 
     target_payloads = {}
+    deltas = {}
     for path, target_name in targets.items():
         target_payloads[target_name] = path.read_bytes()
+        if delta_sources and target_name in delta_sources:
+            source = delta_sources[target_name].read_bytes()
+            deltas[target_name] = metadata.gen_delta_encoding(
+                source, target_payloads[target_name]
+            )
+            target_payloads[target_name] = delta.make_patch(
+                source, target_payloads[target_name]
+            )
         if persist:
             target_persist_path = persist / target_name
             os.makedirs(target_persist_path.parent, exist_ok=True)
-            shutil.copy(path, target_persist_path)
+            target_persist_path.write_bytes(target_payloads[target_name])
 
     targets_metadata = metadata.gen_targets_metadata(
-        target_payloads, version=targets_metadata_version
+        target_payloads, version=targets_metadata_version, deltas=deltas
     )
     unsigned_targets_metadata = SignedTargetsMetadata(
         serialized_targets_metadata=targets_metadata.SerializeToString()
@@ -234,6 +247,16 @@ def parse_args() -> argparse.Namespace:
         default=None,
         help='Path to the signed Root metadata',
     )
+    parser.add_argument(
+        '--delta-sources',
+        type=str,
+        nargs='+',
+        default=[],
+        help=(
+            'Strings of the same form as --targets naming the on-device '
+            'image of a target. Those targets are bundled as delta patches.'
+        ),
+    )
     return parser.parse_args()
 
 
@@ -244,6 +267,7 @@ def main(
     targets_metadata_version: int = metadata.DEFAULT_METADATA_VERSION,
     targets_metadata_version_file: Optional[Path] = None,
     signed_root_metadata: Optional[Path] = None,
+    delta_sources: Iterable[str] = tuple(),
 ) -> None:
     """Generates an UpdateBundle and serializes it to disk."""
     target_dict = {}
@@ -251,6 +275,11 @@ def main(
         path, target_name = parse_target_arg(target_arg)
         target_dict[path] = target_name
 
+    delta_source_dict = {}
+    for delta_source_arg in delta_sources:
+        path, target_name = parse_target_arg(delta_source_arg)
+        delta_source_dict[target_name] = path
+
     root_metadata = None
     if signed_root_metadata:
         root_metadata = SignedRootMetadata.FromString(
@@ -262,7 +291,11 @@ def main(
             targets_metadata_version = int(version_file.read().strip())
 
     bundle = gen_unsigned_update_bundle(
-        target_dict, persist, targets_metadata_version, root_metadata
+        target_dict,
+        persist,
+        targets_metadata_version,
+        root_metadata,
+        delta_source_dict,
     )
 
     out.write_bytes(bundle.SerializeToString())
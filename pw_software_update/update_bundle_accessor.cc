@@ -351,8 +351,8 @@ Status UpdateBundleAccessor::Close() {
 
 Status UpdateBundleAccessor::DoOpen() {
   PW_TRY(update_reader_.Open());
-  bundle_ = protobuf::Message(update_reader_.reader(),
-                              update_reader_.reader().ConservativeReadLimit());
+  bundle_size_ = update_reader_.reader().ConservativeReadLimit();
+  bundle_ = protobuf::Message(update_reader_.reader(), bundle_size_);
   if (!bundle_.ok()) {
     update_reader_.Close().IgnoreError();
     return bundle_.status();
@@ -712,7 +712,7 @@ Status UpdateBundleAccessor::VerifyTargetPayload(
 
   if (payload_reader.ok()) {
     status = VerifyInBundleTargetPayload(
-        expected_length, expected_sha256, payload_reader);
+        target_name, expected_length, expected_sha256, payload_reader);
   } else {
     status = VerifyOutOfBundleTargetPayload(
         target_name, expected_length, expected_sha256);
@@ -789,6 +789,7 @@ Status UpdateBundleAccessor::VerifyOutOfBundleTargetPayload(
 }
 
 Status UpdateBundleAccessor::VerifyInBundleTargetPayload(
+    std::string_view target_name,
     protobuf::Uint64 expected_length,
     protobuf::Bytes expected_sha256,
     stream::IntervalReader payload_reader) {
@@ -802,8 +803,23 @@ Status UpdateBundleAccessor::VerifyInBundleTargetPayload(
     return Status::Unauthenticated();
   }
 
+  // Use the digest measured while the bundle was staged, if there is one, to
+  // avoid reading the payload back.
+  const TargetPayloadDigest* streamed_digest = nullptr;
+  if (streamed_digests_ != nullptr &&
+      streamed_digests_->bytes_written() == bundle_size_) {
+    streamed_digest = streamed_digests_->FindDigest(
+        target_name, payload_reader.start(), payload_reader.interval_size());
+  }
+
   std::byte actual_sha256[crypto::sha256::kDigestSizeBytes] = {};
-  PW_TRY(crypto::sha256::Hash(payload_reader, actual_sha256));
+  if (streamed_digest != nullptr) {
+    std::memcpy(actual_sha256,
+                streamed_digest->sha256.data(),
+                streamed_digest->sha256.size());
+  } else {
+    PW_TRY(crypto::sha256::Hash(payload_reader, actual_sha256));
+  }
   Result<bool> hash_equal = expected_sha256.Equal(actual_sha256);
   PW_TRY(hash_equal.status());
   if (!hash_equal.value()) {
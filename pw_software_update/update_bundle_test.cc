@@ -12,6 +12,7 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <algorithm>
 #include <array>
 
 #include "gtest/gtest.h"
@@ -19,6 +20,7 @@
 #include "pw_kvs/fake_flash_memory.h"
 #include "pw_kvs/test_key_value_store.h"
 #include "pw_software_update/blob_store_openable_reader.h"
+#include "pw_software_update/bundle_hashing_writer.h"
 #include "pw_software_update/bundled_update_backend.h"
 #include "pw_software_update/update_bundle_accessor.h"
 #include "pw_stream/memory_stream.h"
@@ -140,7 +142,9 @@ class UpdateBundleTest : public testing::Test {
                      nullptr,
                      kvs::TestKvs(),
                      kBufferSize),
-        blob_reader_(bundle_blob_) {}
+        blob_reader_(bundle_blob_),
+        bundle_writer_(bundle_blob_, metadata_buffer_),
+        hasher_(bundle_writer_, digests_) {}
 
   blob_store::BlobStoreBuffer<kBufferSize>& bundle_blob() {
     return bundle_blob_;
@@ -150,6 +154,8 @@ class UpdateBundleTest : public testing::Test {
 
   TestBundledUpdateBackend& backend() { return backend_; }
 
+  BundleHashingWriter& hasher() { return hasher_; }
+
   void StageTestBundle(ConstByteSpan bundle_data) {
     ASSERT_OK(bundle_blob_.Init());
     blob_store::BlobStore::BlobWriter blob_writer(bundle_blob(),
@@ -159,6 +165,20 @@ class UpdateBundleTest : public testing::Test {
     ASSERT_OK(blob_writer.Close());
   }
 
+  // Stages `bundle_data` through hasher() in small chunks, as a transfer
+  // would write it.
+  void StageTestBundleThroughHasher(ConstByteSpan bundle_data) {
+    constexpr size_t kChunkSize = 37;
+    ASSERT_OK(bundle_blob_.Init());
+    hasher_.Reset();
+    ASSERT_OK(bundle_writer_.Open());
+    for (size_t offset = 0; offset < bundle_data.size(); offset += kChunkSize) {
+      ASSERT_OK(hasher_.Write(bundle_data.subspan(
+          offset, std::min(kChunkSize, bundle_data.size() - offset))));
+    }
+    ASSERT_OK(bundle_writer_.Close());
+  }
+
   // A helper to verify that all bundle operations are disallowed because
   // the bundle is not open or verified.
   void VerifyAllBundleOperationsDisallowed(
@@ -196,6 +216,9 @@ class UpdateBundleTest : public testing::Test {
   blob_store::BlobStoreBuffer<kBufferSize> bundle_blob_;
   BlobStoreOpenableReader blob_reader_;
   std::array<std::byte, kMetadataBufferSize> metadata_buffer_;
+  blob_store::BlobStore::BlobWriter bundle_writer_;
+  std::array<TargetPayloadDigest, 4> digests_;
+  BundleHashingWriter hasher_;
   TestBundledUpdateBackend backend_;
 };
 
@@ -527,4 +550,33 @@ TEST_F(UpdateBundleTest,
   ASSERT_FAIL(update_bundle.OpenAndVerify());
 }
 
+TEST_F(UpdateBundleTest, OpenAndVerifySucceedsWithStreamedDigests) {
+  backend().SetTrustedRoot(kDevSignedRoot);
+  backend().SetCurrentManifest(kTestBundleManifest);
+  StageTestBundleThroughHasher(kTestProdBundle);
+  UpdateBundleAccessor update_bundle(blob_reader(), backend());
+  update_bundle.UseStreamedDigests(hasher());
+
+  ASSERT_OK(update_bundle.OpenAndVerify());
+
+  // Both payloads were hashed as they were staged.
+  for (std::string_view name : {"file1", "file2"}) {
+    stream::IntervalReader payload = update_bundle.GetTargetPayload(name);
+    ASSERT_OK(payload.status());
+    EXPECT_NE(hasher().FindDigest(
+                  name, payload.start(), payload.interval_size()),
+              nullptr);
+  }
+}
+
+TEST_F(UpdateBundleTest,
+       OpenAndVerifyFailsOnMismatchedTargetHashWithStreamedDigests) {
+  backend().SetTrustedRoot(kDevSignedRoot);
+  backend().SetCurrentManifest(kTestBundleManifest);
+  StageTestBundleThroughHasher(kTestBundleMismatchedTargetHashFile0);
+  UpdateBundleAccessor update_bundle(blob_reader(), backend());
+  update_bundle.UseStreamedDigests(hasher());
+  CheckOpenAndVerifyFail(update_bundle, true);
+}
+
 }  // namespace pw::software_update
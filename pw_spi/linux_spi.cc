@@ -20,6 +20,7 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstring>
 
 #include "pw_log/log.h"
@@ -95,15 +96,64 @@ Status LinuxInitiator::WriteRead(ConstByteSpan write_buffer,
   return OkStatus();
 }
 
+Status LinuxInitiator::WriteReadSequence(span<const Transfer> transfers) {
+  if (transfers.size() > kMaxSequenceTransfers) {
+    PW_LOG_ERROR("Too many SPI transfers in sequence");
+    return Status::InvalidArgument();
+  }
+
+  // A spidev transfer has one length for both directions, so a transfer with
+  // buffers of different sizes is split into a full-duplex part followed by
+  // the rest of the longer buffer.
+  struct spi_ioc_transfer messages[kMaxSequenceTransfers * 2];
+  memset(messages, 0, sizeof(messages));
+  size_t count = 0;
+  for (const Transfer& transfer : transfers) {
+    const size_t write_size = transfer.write_buffer.size();
+    const size_t read_size = transfer.read_buffer.size();
+    const size_t common_size = std::min(write_size, read_size);
+
+    if (common_size > 0) {
+      messages[count].tx_buf =
+          reinterpret_cast<uintptr_t>(transfer.write_buffer.data());
+      messages[count].rx_buf =
+          reinterpret_cast<uintptr_t>(transfer.read_buffer.data());
+      messages[count].len = common_size;
+      count += 1;
+    }
+    if (write_size > common_size) {
+      messages[count].tx_buf = reinterpret_cast<uintptr_t>(
+          transfer.write_buffer.data() + common_size);
+      messages[count].len = write_size - common_size;
+      count += 1;
+    } else if (read_size > common_size) {
+      messages[count].rx_buf = reinterpret_cast<uintptr_t>(
+          transfer.read_buffer.data() + common_size);
+      messages[count].len = read_size - common_size;
+      count += 1;
+    }
+  }
+  if (count == 0) {
+    return OkStatus();
+  }
+
+  if (ioctl(fd_, SPI_IOC_MESSAGE(count), messages) < 0) {
+    PW_LOG_ERROR("Unable to perform SPI transfer sequence");
+    return Status::Unknown();
+  }
+
+  return OkStatus();
+}
+
 Status LinuxChipSelector::SetActive(bool /*active*/) {
   // Note: For Linux' SPI userspace support, chip-select control is not exposed
   // directly to the user.  This limits our ability to use the SPI HAL to do
   // composite (multi read-write) transactions with the PW SPI HAL, as Linux
   // performs composite transactions with a single ioctl() call using an array
   // of descriptors provided as a parameter -- there's no way of separating
-  // individual operations from userspace.  This could be addressed with a
-  // direct "Composite" transaction HAL API, or by using a raw GPIO
-  // to control of chip select from userspace (which is not common practice).
+  // individual operations from userspace.  Use WriteReadSequence() for
+  // composite transactions, or a raw GPIO to control chip select from
+  // userspace (which is not common practice).
   return OkStatus();
 }
 
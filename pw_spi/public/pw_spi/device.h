@@ -19,6 +19,7 @@
 #include "pw_bytes/span.h"
 #include "pw_spi/chip_selector.h"
 #include "pw_spi/initiator.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
 #include "pw_status/try.h"
 #include "pw_sync/borrow.h"
@@ -81,6 +82,19 @@ class Device {
         .WriteRead(write_buffer, read_buffer);
   }
 
+  // Perform a sequence of synchronous read/write transfers with the SPI
+  // responder, holding chip select active for the whole sequence. This call
+  // will configure the bus and activate/deactivate chip select once.
+  //
+  // Note: This call will block in the event that other clients
+  // are currently performing transactions using the same SPI Initiator.
+  // Returns OkStatus() on success, and implementation-specific values on
+  // failure.
+  Status WriteReadSequence(span<const Transfer> transfers) {
+    return StartTransaction(ChipSelectBehavior::kPerWriteRead)
+        .WriteReadSequence(transfers);
+  }
+
   // RAII Object providing exclusive access to the SPI device.  Enables
   // thread-safe Read()/Write()/WriteRead() operations, as well as composite
   // operations consisting of multiple, uninterrupted transfers, with
@@ -147,24 +161,22 @@ class Device {
     // Returns OkStatus() on success, and implementation-specific values on
     // failure.
     Status WriteRead(ConstByteSpan write_buffer, ByteSpan read_buffer) {
-      // Lazy-init: Configure the SPI bus when performing the first transfer in
-      // a transaction.
-      if (first_write_read_) {
-        PW_TRY(initiator_->Configure(config_));
-      }
-
-      if ((behavior_ == ChipSelectBehavior::kPerWriteRead) ||
-          (first_write_read_)) {
-        PW_TRY(selector_->Activate());
-        first_write_read_ = false;
-      }
-
+      PW_TRY(BeginWriteRead());
       auto status = initiator_->WriteRead(write_buffer, read_buffer);
+      PW_TRY(EndWriteRead());
+      return status;
+    }
 
-      if (behavior_ == ChipSelectBehavior::kPerWriteRead) {
-        PW_TRY(selector_->Deactivate());
-      }
-
+    // Perform a sequence of synchronous read/write transfers on the SPI bus,
+    // which the initiator may submit all at once. Chip select is applied
+    // around the whole sequence as it is around a single WriteRead() call.
+    //
+    // Returns OkStatus() on success, and implementation-specific values on
+    // failure.
+    Status WriteReadSequence(span<const Transfer> transfers) {
+      PW_TRY(BeginWriteRead());
+      auto status = initiator_->WriteReadSequence(transfers);
+      PW_TRY(EndWriteRead());
       return status;
     }
 
@@ -180,6 +192,28 @@ class Device {
           behavior_(behavior),
           first_write_read_(true) {}
 
+    Status BeginWriteRead() {
+      // Lazy-init: Configure the SPI bus when performing the first transfer in
+      // a transaction.
+      if (first_write_read_) {
+        PW_TRY(initiator_->Configure(config_));
+      }
+
+      if ((behavior_ == ChipSelectBehavior::kPerWriteRead) ||
+          (first_write_read_)) {
+        PW_TRY(selector_->Activate());
+        first_write_read_ = false;
+      }
+      return OkStatus();
+    }
+
+    Status EndWriteRead() {
+      if (behavior_ == ChipSelectBehavior::kPerWriteRead) {
+        PW_TRY(selector_->Deactivate());
+      }
+      return OkStatus();
+    }
+
     sync::BorrowedPointer<Initiator> initiator_;
     Config config_;
     ChipSelector* selector_;
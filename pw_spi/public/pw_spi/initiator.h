@@ -19,7 +19,9 @@
 
 #include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 
 namespace pw::spi {
 
@@ -76,6 +78,14 @@ struct Config {
 static_assert(sizeof(Config) == sizeof(uint32_t),
               "Ensure that the config struct fits in 32-bits");
 
+// One read/write transfer in a sequence passed to
+// Initiator::WriteReadSequence(). The buffers follow the same rules as those of
+// Initiator::WriteRead().
+struct Transfer {
+  ConstByteSpan write_buffer;
+  ByteSpan read_buffer;
+};
+
 // The Initiator class provides an abstract interface used to configure and
 // transmit data using a SPI bus.
 class Initiator {
@@ -101,6 +111,21 @@ class Initiator {
   // failure.
   virtual Status WriteRead(ConstByteSpan write_buffer,
                            ByteSpan read_buffer) = 0;
+
+  // Perform a sequence of synchronous read/write transfers back to back, with
+  // the same chip-select assertion. Backends that support it submit the whole
+  // sequence to the driver at once (e.g. as one spidev ioctl, or one chain of
+  // DMA or interrupt driven transfers), avoiding the per-transfer overhead of
+  // calling WriteRead() repeatedly. Stops at the first transfer that fails.
+  // The default implementation calls WriteRead() for each transfer.
+  // Returns OkStatus() on success, and implementation-specific values on
+  // failure.
+  virtual Status WriteReadSequence(span<const Transfer> transfers) {
+    for (const Transfer& transfer : transfers) {
+      PW_TRY(WriteRead(transfer.write_buffer, transfer.read_buffer));
+    }
+    return OkStatus();
+  }
 };
 
 }  // namespace pw::spi
@@ -31,6 +31,10 @@ class LinuxInitiator : public Initiator {
  public:
   // Configure the Linux Initiator object for use with a bus file descriptor,
   // and maximum bus-speed (in hz).
+  // The most transfers WriteReadSequence() accepts, since they are submitted
+  // with a single ioctl().
+  static constexpr size_t kMaxSequenceTransfers = 16;
+
   constexpr LinuxInitiator(int fd, uint32_t max_speed_hz)
       : max_speed_hz_(max_speed_hz), fd_(fd) {}
   ~LinuxInitiator();
@@ -39,6 +43,11 @@ class LinuxInitiator : public Initiator {
   Status Configure(const Config& config) override;
   Status WriteRead(ConstByteSpan write_buffer, ByteSpan read_buffer) override;
 
+  // Submits up to kMaxSequenceTransfers transfers with one SPI_IOC_MESSAGE
+  // ioctl(), which keeps chip select active between them. Returns
+  // InvalidArgument if there are more.
+  Status WriteReadSequence(span<const Transfer> transfers) override;
+
  private:
   uint32_t max_speed_hz_;
   int fd_;
@@ -12,6 +12,7 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <algorithm>
 #include <array>
 #include <optional>
 
@@ -71,5 +72,61 @@ TEST_F(SpiTestDevice, CompilationSucceeds) {
   EXPECT_TRUE(true);
 }
 
+// Records the calls made by a Device.
+class RecordingInitiator : public Initiator {
+ public:
+  Status Configure(const Config& /*config */) override { return OkStatus(); }
+  Status WriteRead(ConstByteSpan write_buffer, ByteSpan read_buffer) override {
+    write_reads += 1;
+    std::fill(read_buffer.begin(), read_buffer.end(), std::byte{0xA5});
+    return write_buffer.empty() && read_buffer.empty()
+               ? Status::InvalidArgument()
+               : OkStatus();
+  }
+
+  int write_reads = 0;
+};
+
+class RecordingChipSelector : public ChipSelector {
+ public:
+  Status SetActive(bool active) override {
+    activations += active ? 1 : 0;
+    return OkStatus();
+  }
+
+  int activations = 0;
+};
+
+TEST(SpiDevice, WriteReadSequenceSelectsOnce) {
+  RecordingInitiator initiator;
+  RecordingChipSelector selector;
+  sync::VirtualMutex lock;
+  sync::Borrowable<Initiator> borrowable(initiator, lock);
+  Device device(borrowable, kConfig, selector);
+
+  constexpr std::array<std::byte, 2> kCommand = {std::byte{1}, std::byte{2}};
+  std::array<std::byte, 4> response{};
+  const std::array<Transfer, 2> transfers = {
+      Transfer{kCommand, {}},
+      Transfer{{}, response},
+  };
+  EXPECT_EQ(device.WriteReadSequence(transfers), OkStatus());
+  EXPECT_EQ(selector.activations, 1);
+  EXPECT_EQ(initiator.write_reads, 2);
+  EXPECT_EQ(response[3], std::byte{0xA5});
+}
+
+TEST(SpiDevice, WriteReadSequenceStopsAtFailure) {
+  RecordingInitiator initiator;
+  RecordingChipSelector selector;
+  sync::VirtualMutex lock;
+  sync::Borrowable<Initiator> borrowable(initiator, lock);
+  Device device(borrowable, kConfig, selector);
+
+  const std::array<Transfer, 2> transfers = {Transfer{}, Transfer{}};
+  EXPECT_EQ(device.WriteReadSequence(transfers), Status::InvalidArgument());
+  EXPECT_EQ(initiator.write_reads, 1);
+}
+
 }  // namespace
 }  // namespace pw::spi
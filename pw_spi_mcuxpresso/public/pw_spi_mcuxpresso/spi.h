@@ -45,6 +45,10 @@ class McuxpressoInitiator : public Initiator {
   Status Configure(const Config& config) PW_LOCKS_EXCLUDED(mutex_) override;
   Status WriteRead(ConstByteSpan write_buffer, ByteSpan read_buffer)
       PW_LOCKS_EXCLUDED(mutex_) override;
+  // Chains the transfers, keeping chip select asserted until the last one
+  // completes.
+  Status WriteReadSequence(span<const Transfer> transfers)
+      PW_LOCKS_EXCLUDED(mutex_) override;
 
   Status SetChipSelect(uint32_t pin) PW_LOCKS_EXCLUDED(mutex_);
 
@@ -58,6 +62,11 @@ class McuxpressoInitiator : public Initiator {
   Status DoConfigure(const Config& config,
                      const std::lock_guard<sync::Mutex>& lock);
 
+  Status DoWriteRead(ConstByteSpan write_buffer,
+                     ByteSpan read_buffer,
+                     bool end_of_frame,
+                     const std::lock_guard<sync::Mutex>& lock);
+
   bool is_initialized() { return !!current_config_; }
 
   SPI_Type* register_map_;
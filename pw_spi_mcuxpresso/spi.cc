@@ -129,6 +129,35 @@ Status McuxpressoInitiator::DoConfigure(const Config& config,
 
 Status McuxpressoInitiator::WriteRead(ConstByteSpan write_buffer,
                                       ByteSpan read_buffer) {
+  std::lock_guard lock(mutex_);
+  if (!current_config_) {
+    PW_LOG_ERROR("Mcuxpresso SPI must be configured before use.");
+    return Status::FailedPrecondition();
+  }
+  return DoWriteRead(write_buffer, read_buffer, /*end_of_frame=*/true, lock);
+}
+
+Status McuxpressoInitiator::WriteReadSequence(span<const Transfer> transfers) {
+  std::lock_guard lock(mutex_);
+  if (!current_config_) {
+    PW_LOG_ERROR("Mcuxpresso SPI must be configured before use.");
+    return Status::FailedPrecondition();
+  }
+  // Only the last transfer deasserts chip select, so the sequence is one
+  // frame on the bus.
+  for (size_t i = 0; i < transfers.size(); ++i) {
+    PW_TRY(DoWriteRead(transfers[i].write_buffer,
+                       transfers[i].read_buffer,
+                       /*end_of_frame=*/i + 1 == transfers.size(),
+                       lock));
+  }
+  return OkStatus();
+}
+
+Status McuxpressoInitiator::DoWriteRead(ConstByteSpan write_buffer,
+                                        ByteSpan read_buffer,
+                                        bool end_of_frame,
+                                        const std::lock_guard<sync::Mutex>&) {
   spi_transfer_t transfer = {};
 
   transfer.txData =
@@ -146,13 +175,8 @@ Status McuxpressoInitiator::WriteRead(ConstByteSpan write_buffer,
                             ? write_buffer.size()
                             : read_buffer.size();
   }
-  transfer.configFlags = kSPI_FrameAssert;
+  transfer.configFlags = end_of_frame ? kSPI_FrameAssert : 0;
 
-  std::lock_guard lock(mutex_);
-  if (!current_config_) {
-    PW_LOG_ERROR("Mcuxpresso SPI must be configured before use.");
-    return Status::FailedPrecondition();
-  }
   if (blocking_) {
     return ToPwStatus(SPI_MasterTransferBlocking(register_map_, &transfer));
   }
@@ -50,6 +50,27 @@
     }                                                         \
   } while (0)
 
+// Equivalents of PW_TRY and PW_TRY_ASSIGN for C++20 coroutines, which must
+// co_return rather than return.
+#define PW_CO_TRY(expr) _PW_CO_TRY(_PW_TRY_UNIQUE(__LINE__), expr)
+
+#define _PW_CO_TRY(result, expr)                         \
+  do {                                                   \
+    if (auto result = (expr); !result.ok()) {            \
+      co_return ::pw::internal::ConvertToStatus(result); \
+    }                                                    \
+  } while (0)
+
+#define PW_CO_TRY_ASSIGN(assignment_lhs, expression) \
+  _PW_CO_TRY_ASSIGN(_PW_TRY_UNIQUE(__LINE__), assignment_lhs, expression)
+
+#define _PW_CO_TRY_ASSIGN(result, lhs, expr)           \
+  auto result = (expr);                                \
+  if (!result.ok()) {                                  \
+    co_return ::pw::internal::ConvertToStatus(result); \
+  }                                                    \
+  lhs = ::pw::internal::ConvertToValue(result);
+
 #define _PW_TRY_UNIQUE(line) _PW_TRY_UNIQUE_EXPANDED(line)
 #define _PW_TRY_UNIQUE_EXPANDED(line) _pw_try_unique_name_##line
 
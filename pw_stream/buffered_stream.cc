@@ -0,0 +1,114 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/buffered_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::stream {
+
+Result<ConstByteSpan> BufferedReader::Peek() {
+  if (buffered() == 0) {
+    PW_TRY(Fill());
+  }
+  return ConstByteSpan(buffer_.subspan(position_, buffered()));
+}
+
+void BufferedReader::Consume(size_t bytes) {
+  PW_CHECK_UINT_LE(bytes, buffered());
+  position_ += bytes;
+}
+
+Status BufferedReader::Fill() {
+  position_ = 0;
+  end_ = 0;
+  Result<ByteSpan> result = source_.Read(buffer_);
+  PW_TRY(result.status());
+  end_ = result->size();
+  return OkStatus();
+}
+
+StatusWithSize BufferedReader::DoRead(ByteSpan destination) {
+  if (destination.empty()) {
+    return StatusWithSize(0);
+  }
+
+  if (buffered() == 0) {
+    // Large reads skip the buffer. Each one already reaches the source in a
+    // single call, so copying through the buffer would only add work.
+    if (destination.size() >= buffer_.size()) {
+      Result<ByteSpan> result = source_.Read(destination);
+      return StatusWithSize(result.status(), result.ok() ? result->size() : 0);
+    }
+    if (Status status = Fill(); !status.ok()) {
+      return StatusWithSize(status, 0);
+    }
+  }
+
+  const size_t bytes = std::min(destination.size(), buffered());
+  std::memcpy(destination.data(), buffer_.data() + position_, bytes);
+  position_ += bytes;
+  return StatusWithSize(bytes);
+}
+
+size_t BufferedReader::ConservativeLimit(LimitType limit) const {
+  if (limit != LimitType::kRead) {
+    return 0;
+  }
+  const size_t source_limit = source_.ConservativeReadLimit();
+  return source_limit == kUnlimited ? kUnlimited : source_limit + buffered();
+}
+
+Status BufferedWriter::Flush() {
+  if (size_ == 0) {
+    return OkStatus();
+  }
+  PW_TRY(sink_.Write(buffer_.first(size_)));
+  size_ = 0;
+  return OkStatus();
+}
+
+Status BufferedWriter::DoWrite(ConstByteSpan data) {
+  if (data.size() > buffer_.size() - size_) {
+    PW_TRY(Flush());
+
+    // Writes that would fill the buffer on their own go straight to the sink.
+    if (data.size() >= buffer_.size()) {
+      return sink_.Write(data);
+    }
+  }
+
+  if (!data.empty()) {
+    std::memcpy(buffer_.data() + size_, data.data(), data.size());
+    size_ += data.size();
+  }
+  return OkStatus();
+}
+
+size_t BufferedWriter::ConservativeLimit(LimitType limit) const {
+  if (limit != LimitType::kWrite) {
+    return 0;
+  }
+  const size_t sink_limit = sink_.ConservativeWriteLimit();
+  if (sink_limit == kUnlimited) {
+    return kUnlimited;
+  }
+  return sink_limit > size_ ? sink_limit - size_ : 0;
+}
+
+}  // namespace pw::stream
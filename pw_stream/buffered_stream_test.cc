@@ -0,0 +1,224 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/buffered_stream.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::stream {
+namespace {
+
+// Counts the reads that reach a MemoryReader.
+class CountingReader : public NonSeekableReader {
+ public:
+  CountingReader(ConstByteSpan data) : reader_(data) {}
+
+  size_t reads() const { return reads_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    reads_ += 1;
+    Result<ByteSpan> result = reader_.Read(destination);
+    return StatusWithSize(result.status(), result.ok() ? result->size() : 0);
+  }
+
+  size_t ConservativeLimit(LimitType limit) const override {
+    return limit == LimitType::kRead ? reader_.ConservativeReadLimit() : 0;
+  }
+
+  MemoryReader reader_;
+  size_t reads_ = 0;
+};
+
+// Counts the writes that reach a MemoryWriter.
+class CountingWriter : public NonSeekableWriter {
+ public:
+  CountingWriter(ByteSpan dest) : writer_(dest) {}
+
+  ConstByteSpan WrittenData() const { return writer_.WrittenData(); }
+  size_t writes() const { return writes_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+
+  size_t ConservativeLimit(LimitType limit) const override {
+    return limit == LimitType::kWrite ? writer_.ConservativeWriteLimit() : 0;
+  }
+
+  MemoryWriter writer_;
+  size_t writes_ = 0;
+};
+
+constexpr auto kData = bytes::Array<0, 1, 2, 3, 4, 5, 6, 7, 8, 9>();
+
+TEST(BufferedReader, SmallReadsAreBatched) {
+  CountingReader source(kData);
+  std::array<std::byte, 4> buffer;
+  BufferedReader reader(source, buffer);
+
+  for (size_t i = 0; i < kData.size(); ++i) {
+    std::byte b;
+    Result<ByteSpan> result = reader.Read(span(&b, 1));
+    ASSERT_EQ(result.status(), OkStatus());
+    EXPECT_EQ(b, kData[i]);
+  }
+  EXPECT_EQ(source.reads(), 3u);
+
+  std::byte b;
+  EXPECT_EQ(reader.Read(span(&b, 1)).status(), Status::OutOfRange());
+}
+
+TEST(BufferedReader, LargeReadsBypassBuffer) {
+  CountingReader source(kData);
+  std::array<std::byte, 4> buffer;
+  BufferedReader reader(source, buffer);
+
+  std::array<std::byte, 2> small;
+  ASSERT_EQ(reader.Read(small).status(), OkStatus());
+  EXPECT_EQ(reader.buffered(), 2u);
+
+  // A large read returns the buffered bytes first.
+  std::array<std::byte, 8> large;
+  Result<ByteSpan> result = reader.Read(large);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result->size(), 2u);
+  EXPECT_EQ(result->data()[0], kData[2]);
+
+  result = reader.Read(large);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result->size(), 6u);
+  EXPECT_EQ(std::memcmp(large.data(), kData.data() + 4, 6), 0);
+  EXPECT_EQ(reader.buffered(), 0u);
+  EXPECT_EQ(source.reads(), 2u);
+}
+
+TEST(BufferedReader, PeekAndConsume) {
+  CountingReader source(kData);
+  std::array<std::byte, 4> buffer;
+  BufferedReader reader(source, buffer);
+
+  Result<ConstByteSpan> peeked = reader.Peek();
+  ASSERT_EQ(peeked.status(), OkStatus());
+  ASSERT_EQ(peeked->size(), 4u);
+  EXPECT_EQ((*peeked)[0], kData[0]);
+
+  // Peeking again returns the same bytes without reading.
+  EXPECT_EQ(reader.Peek()->size(), 4u);
+  EXPECT_EQ(source.reads(), 1u);
+
+  reader.Consume(3);
+  peeked = reader.Peek();
+  ASSERT_EQ(peeked->size(), 1u);
+  EXPECT_EQ((*peeked)[0], kData[3]);
+
+  reader.Consume(1);
+  peeked = reader.Peek();
+  ASSERT_EQ(peeked->size(), 4u);
+  EXPECT_EQ((*peeked)[0], kData[4]);
+  EXPECT_EQ(source.reads(), 2u);
+
+  reader.Consume(4);
+  std::array<std::byte, 4> rest;
+  Result<ByteSpan> result = reader.Read(rest);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result->size(), 2u);
+  EXPECT_EQ(rest[0], kData[8]);
+
+  EXPECT_EQ(reader.Peek().status(), Status::OutOfRange());
+}
+
+TEST(BufferedReader, ConservativeLimitIncludesBufferedBytes) {
+  CountingReader source(kData);
+  std::array<std::byte, 4> buffer;
+  BufferedReader reader(source, buffer);
+  EXPECT_EQ(reader.ConservativeReadLimit(), kData.size());
+
+  ASSERT_EQ(reader.Peek().status(), OkStatus());
+  EXPECT_EQ(reader.ConservativeReadLimit(), kData.size());
+
+  reader.Consume(1);
+  EXPECT_EQ(reader.ConservativeReadLimit(), kData.size() - 1);
+}
+
+TEST(BufferedWriter, SmallWritesAreBatched) {
+  std::array<std::byte, 16> dest{};
+  CountingWriter sink(dest);
+  std::array<std::byte, 4> buffer;
+  {
+    BufferedWriter writer(sink, buffer);
+    for (std::byte b : kData) {
+      ASSERT_EQ(writer.Write(b), OkStatus());
+    }
+    EXPECT_EQ(sink.writes(), 2u);
+    EXPECT_EQ(writer.buffered(), 2u);
+
+    EXPECT_EQ(writer.Flush(), OkStatus());
+    EXPECT_EQ(writer.buffered(), 0u);
+    EXPECT_EQ(sink.writes(), 3u);
+
+    // Flushing an empty buffer does not write.
+    EXPECT_EQ(writer.Flush(), OkStatus());
+    EXPECT_EQ(sink.writes(), 3u);
+
+    ASSERT_EQ(writer.Write(std::byte{0xff}), OkStatus());
+  }
+
+  // The destructor flushes the last byte.
+  EXPECT_EQ(sink.writes(), 4u);
+  ASSERT_EQ(sink.WrittenData().size(), kData.size() + 1);
+  EXPECT_EQ(std::memcmp(sink.WrittenData().data(), kData.data(), kData.size()),
+            0);
+  EXPECT_EQ(sink.WrittenData()[kData.size()], std::byte{0xff});
+}
+
+TEST(BufferedWriter, LargeWritesBypassBuffer) {
+  std::array<std::byte, 16> dest{};
+  CountingWriter sink(dest);
+  std::array<std::byte, 4> buffer;
+  BufferedWriter writer(sink, buffer);
+
+  ASSERT_EQ(writer.Write(span(kData).first(1)), OkStatus());
+  ASSERT_EQ(writer.Write(span(kData).subspan(1)), OkStatus());
+
+  // The buffered byte is written first, followed by the large write.
+  EXPECT_EQ(sink.writes(), 2u);
+  EXPECT_EQ(writer.buffered(), 0u);
+  ASSERT_EQ(sink.WrittenData().size(), kData.size());
+  EXPECT_EQ(std::memcmp(sink.WrittenData().data(), kData.data(), kData.size()),
+            0);
+}
+
+TEST(BufferedWriter, FailedFlushKeepsData) {
+  std::array<std::byte, 2> dest{};
+  CountingWriter sink(dest);
+  std::array<std::byte, 4> buffer;
+  BufferedWriter writer(sink, buffer);
+
+  ASSERT_EQ(writer.Write(span(kData).first(3)), OkStatus());
+  EXPECT_EQ(writer.Flush(), Status::ResourceExhausted());
+  EXPECT_EQ(writer.buffered(), 3u);
+  EXPECT_EQ(writer.ConservativeWriteLimit(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::stream
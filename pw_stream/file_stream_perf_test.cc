@@ -0,0 +1,130 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares the throughput of the std::fstream, mmap, and io_uring file streams. Each
+// iteration reads or writes a whole file, so the throughput is kFileSize
+// divided by the time per iteration.
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+#include "pw_assert/assert.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_stream/io_uring_file_stream.h"
+#include "pw_stream/mapped_file_stream.h"
+#include "pw_stream/std_file_stream.h"
+
+namespace pw::stream {
+namespace {
+
+constexpr size_t kFileSize = 16 << 20;
+
+// Data is read and written in chunks like those of a trace or snapshot dump.
+constexpr size_t kChunkSize = 64 << 10;
+
+// io_uring blocks are larger than the chunks, so several chunks are read or
+// written per system call.
+constexpr size_t kQueueDepth = 4;
+constexpr size_t kBlockSize = 256 << 10;
+
+std::array<std::byte, kChunkSize> chunk;
+std::array<std::byte, kQueueDepth * kBlockSize> io_uring_buffer;
+
+// A file with kFileSize bytes, which is deleted when the test exits.
+class TestFile {
+ public:
+  TestFile()
+      : path_((std::filesystem::temp_directory_path() /
+               "pw_stream_file_stream_perf_test")
+                  .string()) {
+    StdFileWriter writer(path());
+    for (size_t i = 0; i < kFileSize / kChunkSize; ++i) {
+      PW_ASSERT(writer.Write(chunk).ok());
+    }
+    writer.Close();
+  }
+
+  ~TestFile() { std::filesystem::remove(path_); }
+
+  const char* path() const { return path_.c_str(); }
+
+ private:
+  std::string path_;
+};
+
+const TestFile test_file;
+
+template <typename Reader>
+void ReadAll(Reader& reader) {
+  while (reader.Read(chunk).ok()) {
+  }
+}
+
+template <typename Writer>
+void WriteAll(Writer& writer) {
+  for (size_t i = 0; i < kFileSize / kChunkSize; ++i) {
+    PW_ASSERT(writer.Write(chunk).ok());
+  }
+}
+
+void StdFileReadTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    StdFileReader reader(test_file.path());
+    ReadAll(reader);
+  }
+}
+
+void IoUringFileReadTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    IoUringFileReader reader(io_uring_buffer, kQueueDepth);
+    PW_ASSERT(reader.Open(test_file.path()).ok());
+    ReadAll(reader);
+  }
+}
+
+void MappedFileReadTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    MappedFileReader reader;
+    PW_ASSERT(reader.Open(test_file.path()).ok());
+    ReadAll(reader);
+  }
+}
+
+void StdFileWriteTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    StdFileWriter writer(test_file.path());
+    WriteAll(writer);
+    writer.Close();
+  }
+}
+
+void IoUringFileWriteTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    IoUringFileWriter writer(io_uring_buffer, kQueueDepth);
+    PW_ASSERT(writer.Open(test_file.path()).ok());
+    WriteAll(writer);
+    PW_ASSERT(writer.Close().ok());
+  }
+}
+
+PW_PERF_TEST(StdFileRead, StdFileReadTest);
+PW_PERF_TEST(IoUringFileRead, IoUringFileReadTest);
+PW_PERF_TEST(MappedFileRead, MappedFileReadTest);
+PW_PERF_TEST(StdFileWrite, StdFileWriteTest);
+PW_PERF_TEST(IoUringFileWrite, IoUringFileWriteTest);
+
+}  // namespace
+}  // namespace pw::stream
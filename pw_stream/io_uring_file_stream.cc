@@ -0,0 +1,584 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/io_uring_file_stream.h"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::stream {
+namespace {
+
+Status ErrnoToStatus(int error) {
+  switch (error) {
+    case ENOENT:
+      return Status::NotFound();
+    case EACCES:
+    case EPERM:
+    case EROFS:
+      return Status::PermissionDenied();
+    case ENOSPC:
+    case EDQUOT:
+      return Status::ResourceExhausted();
+    default:
+      return Status::Unknown();
+  }
+}
+
+void* MapRing(int ring_fd, size_t size, off_t offset) {
+  void* memory = mmap(nullptr,
+                      size,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE,
+                      ring_fd,
+                      offset);
+  return memory == MAP_FAILED ? nullptr : memory;
+}
+
+template <typename T>
+T* RingField(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<std::byte*>(ring) + offset);
+}
+
+Result<uint64_t> FileSize(int fd) {
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    return ErrnoToStatus(errno);
+  }
+  return static_cast<uint64_t>(file_stat.st_size);
+}
+
+Result<uint64_t> SeekTarget(int fd,
+                            uint64_t position,
+                            ptrdiff_t offset,
+                            Stream::Whence origin) {
+  uint64_t base = 0;
+  switch (origin) {
+    case Stream::kBeginning:
+      break;
+    case Stream::kCurrent:
+      base = position;
+      break;
+    case Stream::kEnd:
+      PW_TRY_ASSIGN(base, FileSize(fd));
+      break;
+  }
+  if (offset < 0 && static_cast<uint64_t>(-offset) > base) {
+    return Status::OutOfRange();
+  }
+  return base + static_cast<uint64_t>(offset);
+}
+
+}  // namespace
+
+namespace internal {
+
+Status IoUring::Init(span<const ByteSpan> buffers) {
+  PW_CHECK(ring_fd_ == -1);
+  PW_CHECK_UINT_LE(buffers.size(), kMaxBuffers);
+
+  io_uring_params params = {};
+  ring_fd_ = static_cast<int>(syscall(
+      __NR_io_uring_setup, static_cast<unsigned>(buffers.size()), &params));
+  if (ring_fd_ < 0) {
+    ring_fd_ = -1;
+    return Status::Unavailable();
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+
+  // Newer kernels map both rings with a single mapping.
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    cq_ring_size_ = sq_ring_size_;
+  }
+
+  sq_ring_ = MapRing(ring_fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+  cq_ring_ = single_mmap ? sq_ring_
+                         : MapRing(ring_fd_, cq_ring_size_, IORING_OFF_CQ_RING);
+  sqes_ = MapRing(ring_fd_, sqes_size_, IORING_OFF_SQES);
+  if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes_ == nullptr) {
+    Close();
+    return Status::Unavailable();
+  }
+
+  sq_tail_ = RingField<uint32_t>(sq_ring_, params.sq_off.tail);
+  sq_array_ = RingField<uint32_t>(sq_ring_, params.sq_off.array);
+  sq_mask_ = *RingField<uint32_t>(sq_ring_, params.sq_off.ring_mask);
+  cq_head_ = RingField<uint32_t>(cq_ring_, params.cq_off.head);
+  cq_tail_ = RingField<uint32_t>(cq_ring_, params.cq_off.tail);
+  cqes_ = RingField<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+  cq_mask_ = *RingField<uint32_t>(cq_ring_, params.cq_off.ring_mask);
+
+  // Registering the buffers pins them, which may exceed RLIMIT_MEMLOCK. That
+  // only costs performance, so fall back to unregistered buffers.
+  std::array<iovec, kMaxBuffers> iovecs;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    iovecs[i].iov_base = buffers[i].data();
+    iovecs[i].iov_len = buffers[i].size();
+  }
+  buffers_registered_ = syscall(__NR_io_uring_register,
+                                ring_fd_,
+                                IORING_REGISTER_BUFFERS,
+                                iovecs.data(),
+                                static_cast<unsigned>(buffers.size())) == 0;
+  return OkStatus();
+}
+
+void IoUring::Close() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ != -1) {
+    // Closing the ring unregisters the buffers.
+    close(ring_fd_);
+  }
+  ring_fd_ = -1;
+  buffers_registered_ = false;
+  sq_ring_ = nullptr;
+  cq_ring_ = nullptr;
+  sqes_ = nullptr;
+}
+
+Status IoUring::SubmitRead(int fd,
+                           size_t buffer_index,
+                           ByteSpan dest,
+                           uint64_t offset,
+                           uint64_t user_data) {
+  return Submit(buffers_registered_ ? IORING_OP_READ_FIXED : IORING_OP_READ,
+                fd,
+                buffer_index,
+                dest.data(),
+                dest.size(),
+                offset,
+                user_data);
+}
+
+Status IoUring::SubmitWrite(int fd,
+                            size_t buffer_index,
+                            ConstByteSpan data,
+                            uint64_t offset,
+                            uint64_t user_data) {
+  return Submit(buffers_registered_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE,
+                fd,
+                buffer_index,
+                data.data(),
+                data.size(),
+                offset,
+                user_data);
+}
+
+Status IoUring::Submit(uint8_t opcode,
+                       int fd,
+                       size_t buffer_index,
+                       const std::byte* buffer,
+                       size_t size,
+                       uint64_t offset,
+                       uint64_t user_data) {
+  // Only this thread writes the submission queue tail.
+  const uint32_t tail = *sq_tail_;
+  const uint32_t index = tail & sq_mask_;
+
+  io_uring_sqe& sqe = static_cast<io_uring_sqe*>(sqes_)[index];
+  std::memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = opcode;
+  sqe.fd = fd;
+  sqe.addr = reinterpret_cast<uintptr_t>(buffer);
+  sqe.len = static_cast<uint32_t>(size);
+  sqe.off = offset;
+  sqe.buf_index = static_cast<uint16_t>(buffer_index);
+  sqe.user_data = user_data;
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+  while (syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0) < 0) {
+    if (errno != EINTR && errno != EAGAIN) {
+      return Status::Unknown();
+    }
+  }
+  return OkStatus();
+}
+
+Result<IoUring::Completion> IoUring::Wait() {
+  while (true) {
+    // Only this thread writes the completion queue head.
+    const uint32_t head = *cq_head_;
+    if (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      const io_uring_cqe& cqe =
+          static_cast<const io_uring_cqe*>(cqes_)[head & cq_mask_];
+      const Completion completion{cqe.user_data, cqe.res};
+      __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+      return completion;
+    }
+
+    if (syscall(__NR_io_uring_enter,
+                ring_fd_,
+                0,
+                1,
+                IORING_ENTER_GETEVENTS,
+                nullptr,
+                0) < 0 &&
+        errno != EINTR) {
+      return Status::Unknown();
+    }
+  }
+}
+
+}  // namespace internal
+
+IoUringFileReader::IoUringFileReader(ByteSpan buffer, size_t queue_depth)
+    : buffer_(buffer),
+      queue_depth_(queue_depth),
+      block_size_(queue_depth == 0 ? 0 : buffer.size() / queue_depth) {
+  PW_CHECK_UINT_GT(queue_depth_, 0);
+  PW_CHECK_UINT_LE(queue_depth_, kMaxQueueDepth);
+  PW_CHECK_UINT_GT(block_size_, 0, "The buffer is too small");
+}
+
+Status IoUringFileReader::Open(const char* path) {
+  Close();
+
+  fd_ = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd_ < 0) {
+    fd_ = -1;
+    return ErrnoToStatus(errno);
+  }
+
+  std::array<ByteSpan, kMaxQueueDepth> blocks;
+  for (size_t i = 0; i < queue_depth_; ++i) {
+    blocks[i] = block_buffer(i);
+  }
+  if (Status status = ring_.Init(span(blocks).first(queue_depth_));
+      !status.ok()) {
+    close(fd_);
+    fd_ = -1;
+    return status;
+  }
+
+  position_ = 0;
+  restart_ = true;
+  return OkStatus();
+}
+
+void IoUringFileReader::Close() {
+  if (fd_ == -1) {
+    return;
+  }
+  // The kernel may write to the buffer until reads in flight complete.
+  while (pending_ > 0 && WaitForCompletion().ok()) {
+  }
+  ring_.Close();
+  close(fd_);
+  fd_ = -1;
+  pending_ = 0;
+}
+
+Status IoUringFileReader::WaitForCompletion() {
+  PW_TRY_ASSIGN(const internal::IoUring::Completion completion, ring_.Wait());
+  Block& block = blocks_[completion.user_data];
+  block.result = completion.result;
+  block.pending = false;
+  pending_ -= 1;
+  return OkStatus();
+}
+
+Status IoUringFileReader::StartRead(size_t index) {
+  Block& block = blocks_[index];
+  block.offset = next_offset_;
+  block.consumed = 0;
+  next_offset_ += block_size_;
+
+  PW_TRY(
+      ring_.SubmitRead(fd_, index, block_buffer(index), block.offset, index));
+  block.pending = true;
+  pending_ += 1;
+  return OkStatus();
+}
+
+Status IoUringFileReader::Restart() {
+  while (pending_ > 0) {
+    PW_TRY(WaitForCompletion());
+  }
+
+  head_ = 0;
+  next_offset_ = position_;
+  for (size_t i = 0; i < queue_depth_; ++i) {
+    PW_TRY(StartRead(i));
+  }
+  restart_ = false;
+  return OkStatus();
+}
+
+StatusWithSize IoUringFileReader::DoRead(ByteSpan dest) {
+  if (fd_ == -1) {
+    return StatusWithSize::FailedPrecondition();
+  }
+
+  size_t copied = 0;
+  while (copied < dest.size()) {
+    if (restart_) {
+      if (Status status = Restart(); !status.ok()) {
+        return StatusWithSize(status, copied);
+      }
+    }
+
+    Block& block = blocks_[head_];
+    while (block.pending) {
+      if (Status status = WaitForCompletion(); !status.ok()) {
+        return StatusWithSize(status, copied);
+      }
+    }
+
+    if (block.result < 0) {
+      // Retry from the current position on the next read.
+      restart_ = true;
+      if (copied > 0) {
+        break;
+      }
+      return StatusWithSize(ErrnoToStatus(-block.result), 0);
+    }
+
+    const size_t block_size = static_cast<size_t>(block.result);
+    if (block.consumed == block_size) {
+      // An empty read is the end of the file. Read again next time, in case
+      // the file grows.
+      restart_ = true;
+      break;
+    }
+
+    const size_t to_copy = std::min(dest.size() - copied,
+                                    block_size - block.consumed);
+    std::memcpy(dest.data() + copied,
+                block_buffer(head_).data() + block.consumed,
+                to_copy);
+    block.consumed += to_copy;
+    copied += to_copy;
+    position_ += to_copy;
+
+    if (block.consumed == block_size) {
+      if (block_size < block_size_) {
+        // The reads that follow a short read started at the wrong offsets.
+        restart_ = true;
+      } else {
+        if (Status status = StartRead(head_); !status.ok()) {
+          restart_ = true;
+          return StatusWithSize(status, copied);
+        }
+        head_ = (head_ + 1) % queue_depth_;
+      }
+    }
+  }
+
+  if (copied == 0 && !dest.empty()) {
+    return StatusWithSize::OutOfRange();
+  }
+  return StatusWithSize(copied);
+}
+
+Status IoUringFileReader::DoSeek(ptrdiff_t offset, Whence origin) {
+  if (fd_ == -1) {
+    return Status::FailedPrecondition();
+  }
+  PW_TRY_ASSIGN(const uint64_t position,
+                SeekTarget(fd_, position_, offset, origin));
+  if (position != position_) {
+    position_ = position;
+    restart_ = true;
+  }
+  return OkStatus();
+}
+
+size_t IoUringFileReader::ConservativeLimit(LimitType limit) const {
+  if (limit == LimitType::kWrite || fd_ == -1) {
+    return 0;
+  }
+  Result<uint64_t> size = FileSize(fd_);
+  if (!size.ok() || *size <= position_) {
+    return 0;
+  }
+  return static_cast<size_t>(*size - position_);
+}
+
+IoUringFileWriter::IoUringFileWriter(ByteSpan buffer, size_t queue_depth)
+    : buffer_(buffer),
+      queue_depth_(queue_depth),
+      block_size_(queue_depth == 0 ? 0 : buffer.size() / queue_depth) {
+  PW_CHECK_UINT_GT(queue_depth_, 0);
+  PW_CHECK_UINT_LE(queue_depth_, kMaxQueueDepth);
+  PW_CHECK_UINT_GT(block_size_, 0, "The buffer is too small");
+}
+
+Status IoUringFileWriter::Open(const char* path) {
+  Close().IgnoreError();
+
+  fd_ = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+  if (fd_ < 0) {
+    fd_ = -1;
+    return ErrnoToStatus(errno);
+  }
+
+  std::array<ByteSpan, kMaxQueueDepth> blocks;
+  for (size_t i = 0; i < queue_depth_; ++i) {
+    blocks[i] = block_buffer(i);
+  }
+  if (Status status = ring_.Init(span(blocks).first(queue_depth_));
+      !status.ok()) {
+    close(fd_);
+    fd_ = -1;
+    return status;
+  }
+
+  current_ = 0;
+  filled_ = 0;
+  position_ = 0;
+  status_ = OkStatus();
+  return OkStatus();
+}
+
+Status IoUringFileWriter::Flush() {
+  if (fd_ == -1) {
+    return Status::FailedPrecondition();
+  }
+  PW_TRY(SubmitCurrentBlock());
+  while (pending_ > 0) {
+    PW_TRY(WaitForCompletion());
+  }
+  return status_;
+}
+
+Status IoUringFileWriter::Close() {
+  if (fd_ == -1) {
+    return OkStatus();
+  }
+  Status status = Flush();
+  // Writes may still be in flight if waiting failed.
+  while (pending_ > 0 && WaitForCompletion().ok()) {
+  }
+  ring_.Close();
+  if (close(fd_) != 0 && status.ok()) {
+    status = ErrnoToStatus(errno);
+  }
+  fd_ = -1;
+  pending_ = 0;
+  return status;
+}
+
+Status IoUringFileWriter::WaitForCompletion() {
+  PW_TRY_ASSIGN(const internal::IoUring::Completion completion, ring_.Wait());
+  const size_t index = static_cast<size_t>(completion.user_data);
+  Block& block = blocks_[index];
+  block.pending = false;
+  pending_ -= 1;
+
+  if (completion.result < 0) {
+    if (status_.ok()) {
+      status_ = ErrnoToStatus(-completion.result);
+    }
+    return OkStatus();
+  }
+
+  // Write whatever was left by a short write.
+  const size_t written = static_cast<size_t>(completion.result);
+  block.offset += written;
+  block.start += written;
+  block.size -= std::min(written, block.size);
+  if (block.size > 0) {
+    return SubmitBlock(index);
+  }
+  return OkStatus();
+}
+
+Status IoUringFileWriter::SubmitBlock(size_t index) {
+  Block& block = blocks_[index];
+  PW_TRY(ring_.SubmitWrite(fd_,
+                           index,
+                           block_buffer(index).subspan(block.start, block.size),
+                           block.offset,
+                           index));
+  block.pending = true;
+  pending_ += 1;
+  return OkStatus();
+}
+
+Status IoUringFileWriter::SubmitCurrentBlock() {
+  if (filled_ == 0) {
+    return OkStatus();
+  }
+  Block& block = blocks_[current_];
+  block.offset = position_ - filled_;
+  block.start = 0;
+  block.size = filled_;
+  PW_TRY(SubmitBlock(current_));
+
+  current_ = (current_ + 1) % queue_depth_;
+  filled_ = 0;
+  return OkStatus();
+}
+
+Status IoUringFileWriter::DoWrite(ConstByteSpan data) {
+  if (fd_ == -1) {
+    return Status::FailedPrecondition();
+  }
+  PW_TRY(status_);
+
+  while (!data.empty()) {
+    // Wait for the block's previous write before reusing it.
+    while (blocks_[current_].pending) {
+      PW_TRY(WaitForCompletion());
+    }
+    PW_TRY(status_);
+
+    const size_t to_copy = std::min(data.size(), block_size_ - filled_);
+    std::memcpy(block_buffer(current_).data() + filled_, data.data(), to_copy);
+    filled_ += to_copy;
+    position_ += to_copy;
+    data = data.subspan(to_copy);
+
+    if (filled_ == block_size_) {
+      PW_TRY(SubmitCurrentBlock());
+    }
+  }
+  return OkStatus();
+}
+
+Status IoUringFileWriter::DoSeek(ptrdiff_t offset, Whence origin) {
+  // Writes in flight may complete in any order, so finish them before writing
+  // somewhere else in the file.
+  PW_TRY(Flush());
+  PW_TRY_ASSIGN(position_, SeekTarget(fd_, position_, offset, origin));
+  return OkStatus();
+}
+
+}  // namespace pw::stream
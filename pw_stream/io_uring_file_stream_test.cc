@@ -0,0 +1,187 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/io_uring_file_stream.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+
+namespace pw::stream {
+namespace {
+
+// Several blocks per buffer, so reads and writes cross block boundaries.
+constexpr size_t kQueueDepth = 4;
+constexpr size_t kBlockSize = 512;
+
+std::vector<std::byte> TestData(size_t size) {
+  std::vector<std::byte> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<std::byte>(i * 31 + (i >> 8));
+  }
+  return data;
+}
+
+class IoUringFileStreamTest : public ::testing::Test {
+ protected:
+  IoUringFileStreamTest() {
+    std::string dir =
+        (std::filesystem::temp_directory_path() / "IoUringFileStreamTestXXXXXX")
+            .string();
+    PW_ASSERT(mkdtemp(dir.data()) != nullptr);
+    temp_dir_ = dir;
+    path_ = (temp_dir_ / "file").string();
+  }
+
+  ~IoUringFileStreamTest() override {
+    PW_ASSERT(std::filesystem::remove_all(temp_dir_) > 0);
+  }
+
+  const char* path() const { return path_.c_str(); }
+
+  void WriteFile(ConstByteSpan data) {
+    IoUringFileWriter writer(write_buffer_, kQueueDepth);
+    ASSERT_EQ(writer.Open(path()), OkStatus());
+    ASSERT_EQ(writer.Write(data), OkStatus());
+    ASSERT_EQ(writer.Close(), OkStatus());
+  }
+
+  std::vector<std::byte> ReadFile(size_t read_size) {
+    IoUringFileReader reader(read_buffer_, kQueueDepth);
+    PW_ASSERT(reader.Open(path()).ok());
+
+    std::vector<std::byte> contents;
+    std::vector<std::byte> chunk(read_size);
+    while (true) {
+      Result<ByteSpan> result = reader.Read(chunk);
+      if (!result.ok()) {
+        EXPECT_EQ(result.status(), Status::OutOfRange());
+        break;
+      }
+      contents.insert(contents.end(), result->begin(), result->end());
+    }
+    return contents;
+  }
+
+  std::array<std::byte, kQueueDepth * kBlockSize> read_buffer_;
+  std::array<std::byte, kQueueDepth * kBlockSize> write_buffer_;
+
+ private:
+  std::filesystem::path temp_dir_;
+  std::string path_;
+};
+
+TEST_F(IoUringFileStreamTest, WriteAndReadBack) {
+  const std::vector<std::byte> data = TestData(100 * kBlockSize + 123);
+
+  IoUringFileWriter writer(write_buffer_, kQueueDepth);
+  ASSERT_EQ(writer.Open(path()), OkStatus());
+  for (size_t offset = 0; offset < data.size(); offset += 777) {
+    const size_t size = std::min<size_t>(777, data.size() - offset);
+    ASSERT_EQ(writer.Write(span(data).subspan(offset, size)), OkStatus());
+  }
+  EXPECT_EQ(writer.Tell(), data.size());
+  ASSERT_EQ(writer.Close(), OkStatus());
+
+  // Read with sizes smaller than, equal to, and larger than a block.
+  for (size_t read_size : {size_t{100}, kBlockSize, 3 * kBlockSize + 1}) {
+    EXPECT_EQ(ReadFile(read_size), data);
+  }
+}
+
+TEST_F(IoUringFileStreamTest, EmptyFile) {
+  WriteFile({});
+
+  IoUringFileReader reader(read_buffer_, kQueueDepth);
+  ASSERT_EQ(reader.Open(path()), OkStatus());
+  EXPECT_EQ(reader.ConservativeReadLimit(), 0u);
+  std::array<std::byte, 16> dest;
+  EXPECT_EQ(reader.Read(dest).status(), Status::OutOfRange());
+  EXPECT_EQ(reader.Read(dest).status(), Status::OutOfRange());
+}
+
+TEST_F(IoUringFileStreamTest, ReaderSeek) {
+  const std::vector<std::byte> data = TestData(10 * kBlockSize);
+  WriteFile(data);
+
+  IoUringFileReader reader(read_buffer_, kQueueDepth);
+  ASSERT_EQ(reader.Open(path()), OkStatus());
+  EXPECT_EQ(reader.ConservativeReadLimit(), data.size());
+
+  std::array<std::byte, 10> dest;
+  ASSERT_EQ(reader.Seek(5000), OkStatus());
+  EXPECT_EQ(reader.Tell(), 5000u);
+  ASSERT_EQ(reader.Read(dest).status(), OkStatus());
+  EXPECT_TRUE(std::equal(dest.begin(), dest.end(), data.begin() + 5000));
+  EXPECT_EQ(reader.ConservativeReadLimit(), data.size() - 5010);
+
+  ASSERT_EQ(reader.Seek(-4000, Stream::kCurrent), OkStatus());
+  EXPECT_EQ(reader.Tell(), 1010u);
+  ASSERT_EQ(reader.Read(dest).status(), OkStatus());
+  EXPECT_TRUE(std::equal(dest.begin(), dest.end(), data.begin() + 1010));
+
+  ASSERT_EQ(reader.Seek(-3, Stream::kEnd), OkStatus());
+  Result<ByteSpan> result = reader.Read(dest);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result->size(), 3u);
+  EXPECT_TRUE(std::equal(result->begin(), result->end(), data.end() - 3));
+  EXPECT_EQ(reader.Read(dest).status(), Status::OutOfRange());
+
+  EXPECT_EQ(reader.Seek(-1, Stream::kBeginning), Status::OutOfRange());
+}
+
+TEST_F(IoUringFileStreamTest, WriterSeek) {
+  std::vector<std::byte> data = TestData(3 * kBlockSize);
+  const std::array<std::byte, 4> kPatch = {
+      std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}};
+
+  IoUringFileWriter writer(write_buffer_, kQueueDepth);
+  ASSERT_EQ(writer.Open(path()), OkStatus());
+  ASSERT_EQ(writer.Write(data), OkStatus());
+  ASSERT_EQ(writer.Seek(100), OkStatus());
+  EXPECT_EQ(writer.Tell(), 100u);
+  ASSERT_EQ(writer.Write(kPatch), OkStatus());
+  ASSERT_EQ(writer.Seek(0, Stream::kEnd), OkStatus());
+  ASSERT_EQ(writer.Write(kPatch), OkStatus());
+  ASSERT_EQ(writer.Close(), OkStatus());
+
+  std::copy(kPatch.begin(), kPatch.end(), data.begin() + 100);
+  data.insert(data.end(), kPatch.begin(), kPatch.end());
+  EXPECT_EQ(ReadFile(kBlockSize), data);
+}
+
+TEST_F(IoUringFileStreamTest, NotOpen) {
+  IoUringFileReader reader(read_buffer_, kQueueDepth);
+  std::array<std::byte, 1> dest;
+  EXPECT_EQ(reader.Read(dest).status(), Status::FailedPrecondition());
+  EXPECT_EQ(reader.Open("/nonexistent/file"), Status::NotFound());
+
+  IoUringFileWriter writer(write_buffer_, kQueueDepth);
+  EXPECT_EQ(writer.Write(dest), Status::FailedPrecondition());
+  EXPECT_EQ(writer.Flush(), Status::FailedPrecondition());
+  EXPECT_EQ(writer.Open("/nonexistent/file"), Status::NotFound());
+  EXPECT_EQ(writer.Close(), OkStatus());
+}
+
+}  // namespace
+}  // namespace pw::stream
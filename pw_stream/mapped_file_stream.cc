@@ -0,0 +1,132 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/mapped_file_stream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "pw_stream/seek.h"
+
+namespace pw::stream {
+namespace {
+
+Status ErrnoToStatus(int error) {
+  switch (error) {
+    case ENOENT:
+    case ENOTDIR:
+      return Status::NotFound();
+    case EACCES:
+    case EPERM:
+      return Status::PermissionDenied();
+    case ENODEV:  // The file system does not support mapping.
+      return Status::FailedPrecondition();
+    case ENOMEM:
+    case EMFILE:
+    case ENFILE:
+      return Status::ResourceExhausted();
+    default:
+      return Status::Unknown();
+  }
+}
+
+}  // namespace
+
+Status MappedFileReader::Open(const char* path) {
+  Close();
+
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return ErrnoToStatus(errno);
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    const int error = errno;
+    close(fd);
+    return ErrnoToStatus(error);
+  }
+  if (!S_ISREG(file_stat.st_mode)) {
+    close(fd);
+    return Status::FailedPrecondition();
+  }
+
+  const size_t size = static_cast<size_t>(file_stat.st_size);
+
+  // Empty files cannot be mapped, but are still valid files to read.
+  void* mapping = nullptr;
+  if (size != 0u) {
+    mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      const int error = errno;
+      close(fd);
+      return ErrnoToStatus(error);
+    }
+    // Reads usually walk the file from start to end, so ask the kernel to read
+    // ahead aggressively. This is only a hint, so errors are ignored.
+    madvise(mapping, size, MADV_SEQUENTIAL);
+  }
+
+  // The mapping holds its own reference to the file.
+  close(fd);
+
+  data_ = static_cast<const std::byte*>(mapping);
+  size_ = size;
+  position_ = 0;
+  open_ = true;
+  return OkStatus();
+}
+
+void MappedFileReader::Close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<std::byte*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  position_ = 0;
+  open_ = false;
+}
+
+StatusWithSize MappedFileReader::DoRead(ByteSpan dest) {
+  if (!open_) {
+    return StatusWithSize::FailedPrecondition();
+  }
+  if (position_ == size_) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  const size_t bytes_to_read = std::min(dest.size(), size_ - position_);
+  if (bytes_to_read == 0u) {
+    return StatusWithSize(0);
+  }
+
+  std::memcpy(dest.data(), data_ + position_, bytes_to_read);
+  position_ += bytes_to_read;
+  return StatusWithSize(bytes_to_read);
+}
+
+Status MappedFileReader::DoSeek(ptrdiff_t offset, Whence origin) {
+  if (!open_) {
+    return Status::FailedPrecondition();
+  }
+  return CalculateSeek(offset, origin, size_, position_);
+}
+
+}  // namespace pw::stream
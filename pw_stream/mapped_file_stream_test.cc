@@ -0,0 +1,181 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/mapped_file_stream.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+
+namespace pw::stream {
+namespace {
+
+std::vector<std::byte> TestData(size_t size) {
+  std::vector<std::byte> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<std::byte>(i * 31 + (i >> 8));
+  }
+  return data;
+}
+
+class MappedFileReaderTest : public ::testing::Test {
+ protected:
+  MappedFileReaderTest() {
+    std::string dir =
+        (std::filesystem::temp_directory_path() / "MappedFileReaderTestXXXXXX")
+            .string();
+    PW_ASSERT(mkdtemp(dir.data()) != nullptr);
+    temp_dir_ = dir;
+    path_ = (temp_dir_ / "file").string();
+  }
+
+  ~MappedFileReaderTest() override {
+    PW_ASSERT(std::filesystem::remove_all(temp_dir_) > 0);
+  }
+
+  const char* path() const { return path_.c_str(); }
+
+  void WriteFile(ConstByteSpan data) {
+    std::FILE* file = std::fopen(path(), "wb");
+    PW_ASSERT(file != nullptr);
+    PW_ASSERT(std::fwrite(data.data(), 1, data.size(), file) == data.size());
+    PW_ASSERT(std::fclose(file) == 0);
+  }
+
+  std::filesystem::path temp_dir_;
+
+ private:
+  std::string path_;
+};
+
+TEST_F(MappedFileReaderTest, ReadsWholeFile) {
+  const std::vector<std::byte> data = TestData(10000);
+  WriteFile(data);
+
+  MappedFileReader reader;
+  ASSERT_EQ(reader.Open(path()), OkStatus());
+  EXPECT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.ConservativeReadLimit(), data.size());
+
+  std::vector<std::byte> contents;
+  std::array<std::byte, 333> chunk;
+  while (true) {
+    Result<ByteSpan> result = reader.Read(chunk);
+    if (!result.ok()) {
+      EXPECT_EQ(result.status(), Status::OutOfRange());
+      break;
+    }
+    contents.insert(contents.end(), result->begin(), result->end());
+  }
+  EXPECT_EQ(contents, data);
+  EXPECT_EQ(reader.Tell(), data.size());
+  EXPECT_EQ(reader.ConservativeReadLimit(), 0u);
+}
+
+TEST_F(MappedFileReaderTest, MappedData) {
+  const std::vector<std::byte> data = TestData(5000);
+  WriteFile(data);
+
+  MappedFileReader reader;
+  ASSERT_EQ(reader.Open(path()), OkStatus());
+
+  ConstByteSpan mapped = reader.mapped_data();
+  ASSERT_EQ(mapped.size(), data.size());
+  EXPECT_TRUE(std::equal(mapped.begin(), mapped.end(), data.begin()));
+
+  // Reading does not change the mapping.
+  std::array<std::byte, 100> chunk;
+  ASSERT_TRUE(reader.Read(chunk).ok());
+  EXPECT_EQ(reader.mapped_data().data(), mapped.data());
+
+  reader.Close();
+  EXPECT_FALSE(reader.is_open());
+  EXPECT_TRUE(reader.mapped_data().empty());
+}
+
+TEST_F(MappedFileReaderTest, Seek) {
+  const std::vector<std::byte> data = TestData(4096);
+  WriteFile(data);
+
+  MappedFileReader reader;
+  ASSERT_EQ(reader.Open(path()), OkStatus());
+
+  std::array<std::byte, 16> chunk;
+  ASSERT_EQ(reader.Seek(1000), OkStatus());
+  Result<ByteSpan> result = reader.Read(chunk);
+  ASSERT_TRUE(result.ok());
+  EXPECT_TRUE(std::equal(result->begin(), result->end(), data.begin() + 1000));
+
+  ASSERT_EQ(reader.Seek(-16, Stream::kEnd), OkStatus());
+  result = reader.Read(chunk);
+  ASSERT_TRUE(result.ok());
+  EXPECT_TRUE(std::equal(result->begin(), result->end(), data.end() - 16));
+  EXPECT_EQ(reader.Read(chunk).status(), Status::OutOfRange());
+
+  EXPECT_EQ(reader.Seek(-1), Status::OutOfRange());
+  EXPECT_EQ(reader.Seek(1, Stream::kEnd), Status::OutOfRange());
+  EXPECT_EQ(reader.Tell(), data.size());
+}
+
+TEST_F(MappedFileReaderTest, EmptyFile) {
+  WriteFile({});
+
+  MappedFileReader reader;
+  ASSERT_EQ(reader.Open(path()), OkStatus());
+  EXPECT_TRUE(reader.is_open());
+  EXPECT_TRUE(reader.mapped_data().empty());
+
+  std::array<std::byte, 16> chunk;
+  EXPECT_EQ(reader.Read(chunk).status(), Status::OutOfRange());
+}
+
+TEST_F(MappedFileReaderTest, Reopen) {
+  const std::vector<std::byte> first = TestData(100);
+  WriteFile(first);
+
+  MappedFileReader reader;
+  ASSERT_EQ(reader.Open(path()), OkStatus());
+  std::array<std::byte, 10> chunk;
+  ASSERT_TRUE(reader.Read(chunk).ok());
+
+  const std::vector<std::byte> second = TestData(200);
+  WriteFile(second);
+  ASSERT_EQ(reader.Open(path()), OkStatus());
+  EXPECT_EQ(reader.Tell(), 0u);
+  EXPECT_EQ(reader.mapped_data().size(), second.size());
+}
+
+TEST_F(MappedFileReaderTest, OpenErrors) {
+  MappedFileReader reader;
+  EXPECT_EQ(reader.Open(path()), Status::NotFound());
+  EXPECT_EQ(reader.Open(temp_dir_.c_str()), Status::FailedPrecondition());
+  EXPECT_FALSE(reader.is_open());
+
+  std::array<std::byte, 16> chunk;
+  EXPECT_EQ(reader.Read(chunk).status(), Status::FailedPrecondition());
+  EXPECT_EQ(reader.Seek(0), Status::FailedPrecondition());
+}
+
+}  // namespace
+}  // namespace pw::stream
@@ -42,6 +42,31 @@ Status MemoryWriter::DoWrite(ConstByteSpan data) {
   return OkStatus();
 }
 
+Status MemoryWriter::DoWriteV(span<const ConstByteSpan> data) {
+  size_t size = 0;
+  for (ConstByteSpan buffer : data) {
+    size += buffer.size_bytes();
+  }
+
+  if (size == 0) {
+    return OkStatus();
+  }
+  if (ConservativeWriteLimit() == 0) {
+    return Status::OutOfRange();
+  }
+  if (ConservativeWriteLimit() < size) {
+    return Status::ResourceExhausted();
+  }
+
+  for (ConstByteSpan buffer : data) {
+    if (!buffer.empty()) {
+      std::memmove(dest_.data() + position_, buffer.data(), buffer.size());
+      position_ += buffer.size();
+    }
+  }
+  return OkStatus();
+}
+
 StatusWithSize MemoryReader::DoRead(ByteSpan dest) {
   if (source_.size_bytes() == position_) {
     return StatusWithSize::OutOfRange();
@@ -14,6 +14,7 @@
 
 #include "pw_stream/memory_stream.h"
 
+#include <array>
 #include <cstring>
 
 #include "gtest/gtest.h"
@@ -125,6 +126,38 @@ TEST_F(MemoryWriterTest, FullWriter) {
   }
 }
 
+TEST_F(MemoryWriterTest, WriteV) {
+  constexpr std::array<std::byte, 2> kHeader = {std::byte{1}, std::byte{2}};
+  constexpr std::array<std::byte, 3> kPayload = {
+      std::byte{3}, std::byte{4}, std::byte{5}};
+  const std::array<ConstByteSpan, 3> buffers = {
+      ConstByteSpan(kHeader), ConstByteSpan(), ConstByteSpan(kPayload)};
+
+  MemoryWriter memory_writer(memory_buffer_);
+  EXPECT_EQ(memory_writer.WriteV(buffers), OkStatus());
+  ASSERT_EQ(memory_writer.bytes_written(), 5u);
+  for (size_t i = 0; i < 5u; ++i) {
+    EXPECT_EQ(memory_writer[i], std::byte(i + 1));
+  }
+}
+
+TEST_F(MemoryWriterTest, WriteV_WritesNothingIfBuffersDoNotFit) {
+  std::array<std::byte, 4> small_buffer{};
+  constexpr std::array<std::byte, 3> kData = {
+      std::byte{1}, std::byte{2}, std::byte{3}};
+  const std::array<ConstByteSpan, 2> buffers = {ConstByteSpan(kData),
+                                                ConstByteSpan(kData)};
+
+  MemoryWriter memory_writer(small_buffer);
+  EXPECT_EQ(memory_writer.WriteV(buffers), Status::ResourceExhausted());
+  EXPECT_EQ(memory_writer.bytes_written(), 0u);
+
+  EXPECT_EQ(memory_writer.WriteV(span(buffers).first(1)), OkStatus());
+  EXPECT_EQ(memory_writer.Write(std::byte{0}), OkStatus());
+  EXPECT_EQ(memory_writer.WriteV(buffers), Status::OutOfRange());
+  EXPECT_EQ(memory_writer.WriteV({}), OkStatus());
+}
+
 TEST_F(MemoryWriterTest, EmptyData) {
   std::byte buffer[5] = {};
 
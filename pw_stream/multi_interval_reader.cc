@@ -0,0 +1,145 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/multi_interval_reader.h"
+
+#include <algorithm>
+
+namespace pw::stream {
+
+MultiIntervalReader::MultiIntervalReader(SeekableReader& source_reader,
+                                         span<Interval> intervals)
+    : source_reader_(&source_reader) {
+  std::sort(intervals.begin(),
+            intervals.end(),
+            [](const Interval& lhs, const Interval& rhs) {
+              return lhs.start < rhs.start;
+            });
+
+  // Merge adjacent intervals and drop empty ones.
+  size_t count = 0;
+  for (const Interval& interval : intervals) {
+    if (interval.end < interval.start) {
+      status_ = Status::InvalidArgument();
+      return;
+    }
+    if (interval.end == interval.start) {
+      continue;
+    }
+    if (count > 0u) {
+      Interval& last = intervals[count - 1];
+      if (interval.start < last.end) {
+        status_ = Status::InvalidArgument();
+        return;
+      }
+      if (interval.start == last.end) {
+        last.end = interval.end;
+        continue;
+      }
+    }
+    intervals[count++] = interval;
+  }
+
+  intervals_ = intervals.first(count);
+  for (const Interval& interval : intervals_) {
+    size_ += interval.end - interval.start;
+  }
+}
+
+StatusWithSize MultiIntervalReader::DoRead(ByteSpan destination) {
+  if (!source_reader_) {
+    return StatusWithSize(Status::FailedPrecondition(), 0);
+  }
+
+  if (!status_.ok()) {
+    return StatusWithSize(status_, 0);
+  }
+
+  if (position_ == size_) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  size_t read = 0;
+  while (read < destination.size() && position_ < size_) {
+    const Interval& interval = intervals_[interval_];
+    const size_t source_offset = interval.start + interval_offset_;
+
+    // Only seek if the source is not already at the offset, which it is when
+    // continuing a read and no other reader used the source in between.
+    if (source_reader_->Tell() != source_offset) {
+      Status status = source_reader_->Seek(source_offset, Whence::kBeginning);
+      if (!status.ok()) {
+        return StatusWithSize(status, read);
+      }
+    }
+
+    const size_t to_read = std::min(destination.size() - read,
+                                    interval.end - source_offset);
+    Result<ByteSpan> res =
+        source_reader_->Read(destination.subspan(read, to_read));
+    if (!res.ok()) {
+      return StatusWithSize(res.status(), read);
+    }
+
+    read += res.value().size();
+    position_ += res.value().size();
+    interval_offset_ += res.value().size();
+    if (interval.start + interval_offset_ == interval.end) {
+      interval_ += 1;
+      interval_offset_ = 0;
+    }
+
+    // The source may return fewer bytes than requested; return those rather
+    // than reading again.
+    if (res.value().size() < to_read) {
+      break;
+    }
+  }
+  return StatusWithSize(read);
+}
+
+Status MultiIntervalReader::DoSeek(ptrdiff_t offset, Whence origin) {
+  ptrdiff_t position = 0;
+  switch (origin) {
+    case Whence::kBeginning:
+      position = offset;
+      break;
+
+    case Whence::kCurrent:
+      position = static_cast<ptrdiff_t>(position_) + offset;
+      break;
+
+    case Whence::kEnd:
+      position = static_cast<ptrdiff_t>(size_) + offset;
+      break;
+  }
+
+  if (position < 0 || static_cast<size_t>(position) > size_) {
+    return Status::InvalidArgument();
+  }
+
+  // Find the interval that contains the new position.
+  position_ = static_cast<size_t>(position);
+  interval_ = 0;
+  interval_offset_ = position_;
+  while (interval_ < intervals_.size() &&
+         interval_offset_ >= intervals_[interval_].end -
+                                 intervals_[interval_].start) {
+    interval_offset_ -= intervals_[interval_].end - intervals_[interval_].start;
+    interval_ += 1;
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::stream
@@ -0,0 +1,194 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/multi_interval_reader.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_result/result.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::stream {
+namespace {
+
+using Interval = MultiIntervalReader::Interval;
+
+constexpr std::array<uint8_t, 16> kData = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+// A MemoryReader that counts the seeks and reads that reach it.
+class CountingReader : public SeekableReader {
+ public:
+  CountingReader() : reader_(as_bytes(span(kData))) {}
+
+  size_t seeks = 0;
+  size_t reads = 0;
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    reads += 1;
+    Result<ByteSpan> result = reader_.Read(destination);
+    return StatusWithSize(result.status(),
+                          result.ok() ? result.value().size() : 0);
+  }
+
+  Status DoSeek(ptrdiff_t offset, Whence origin) override {
+    seeks += 1;
+    return reader_.Seek(offset, origin);
+  }
+
+  size_t DoTell() override { return reader_.Tell(); }
+
+  MemoryReader reader_;
+};
+
+TEST(MultiIntervalReader, ReadsIntervalsInOrder) {
+  MemoryReader source(as_bytes(span(kData)));
+  std::array<Interval, 3> intervals = {{{12, 14}, {2, 4}, {7, 9}}};
+  MultiIntervalReader reader(source, intervals);
+  ASSERT_TRUE(reader.ok());
+  EXPECT_EQ(reader.size(), 6u);
+  EXPECT_EQ(reader.ConservativeReadLimit(), 6u);
+
+  std::array<std::byte, 8> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result->size(), 6u);
+  constexpr uint8_t kExpected[] = {2, 3, 7, 8, 12, 13};
+  EXPECT_EQ(std::memcmp(result->data(), kExpected, sizeof(kExpected)), 0);
+  EXPECT_EQ(reader.Tell(), 6u);
+  EXPECT_EQ(reader.Read(buffer).status(), Status::OutOfRange());
+}
+
+TEST(MultiIntervalReader, MergesAdjacentIntervals) {
+  CountingReader source;
+  std::array<Interval, 5> intervals = {
+      {{4, 6}, {0, 2}, {2, 4}, {8, 8}, {10, 12}}};
+  MultiIntervalReader reader(source, intervals);
+  ASSERT_TRUE(reader.ok());
+  ASSERT_EQ(reader.intervals().size(), 2u);
+  EXPECT_EQ(reader.intervals()[0].start, 0u);
+  EXPECT_EQ(reader.intervals()[0].end, 6u);
+  EXPECT_EQ(reader.intervals()[1].start, 10u);
+  EXPECT_EQ(reader.intervals()[1].end, 12u);
+
+  // The merged run is read with one read and no seek, since the source is
+  // already at its start.
+  std::array<std::byte, 8> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result->size(), 8u);
+  EXPECT_EQ(source.seeks, 1u);
+  EXPECT_EQ(source.reads, 2u);
+}
+
+TEST(MultiIntervalReader, SequentialReadsDoNotSeek) {
+  CountingReader source;
+  std::array<Interval, 2> intervals = {{{2, 10}, {12, 16}}};
+  MultiIntervalReader reader(source, intervals);
+
+  std::array<std::byte, 3> buffer;
+  std::array<uint8_t, 12> read_data;
+  size_t read = 0;
+  while (true) {
+    Result<ByteSpan> result = reader.Read(buffer);
+    if (!result.ok()) {
+      EXPECT_EQ(result.status(), Status::OutOfRange());
+      break;
+    }
+    std::memcpy(&read_data[read], result->data(), result->size());
+    read += result->size();
+  }
+  ASSERT_EQ(read, read_data.size());
+  constexpr uint8_t kExpected[] = {2, 3, 4, 5, 6, 7, 8, 9, 12, 13, 14, 15};
+  EXPECT_EQ(std::memcmp(read_data.data(), kExpected, sizeof(kExpected)), 0);
+
+  // One seek to the start of each run.
+  EXPECT_EQ(source.seeks, 2u);
+}
+
+TEST(MultiIntervalReader, SharedSource) {
+  CountingReader source;
+  std::array<Interval, 1> first_intervals = {{{0, 4}}};
+  std::array<Interval, 1> second_intervals = {{{8, 12}}};
+  MultiIntervalReader first(source, first_intervals);
+  MultiIntervalReader second(source, second_intervals);
+
+  std::array<std::byte, 2> buffer;
+  ASSERT_EQ(first.Read(buffer).status(), OkStatus());
+  ASSERT_EQ(second.Read(buffer).status(), OkStatus());
+
+  // The first reader seeks back, since the second moved the source.
+  Result<ByteSpan> result = first.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result->data()[0], std::byte{2});
+  EXPECT_EQ(source.seeks, 2u);
+}
+
+TEST(MultiIntervalReader, Seek) {
+  MemoryReader source(as_bytes(span(kData)));
+  std::array<Interval, 2> intervals = {{{2, 6}, {10, 14}}};
+  MultiIntervalReader reader(source, intervals);
+
+  std::array<std::byte, 2> buffer;
+  ASSERT_EQ(reader.Seek(3), OkStatus());
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result->data()[0], std::byte{5});
+  EXPECT_EQ(result->data()[1], std::byte{10});
+
+  ASSERT_EQ(reader.Seek(-1, Stream::kEnd), OkStatus());
+  result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result->size(), 1u);
+  EXPECT_EQ(result->data()[0], std::byte{13});
+
+  ASSERT_EQ(reader.Seek(-8, Stream::kCurrent), OkStatus());
+  EXPECT_EQ(reader.Tell(), 0u);
+  result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result->data()[0], std::byte{2});
+
+  ASSERT_EQ(reader.Seek(8), OkStatus());
+  EXPECT_EQ(reader.Read(buffer).status(), Status::OutOfRange());
+  EXPECT_EQ(reader.Seek(9), Status::InvalidArgument());
+  EXPECT_EQ(reader.Seek(-1), Status::InvalidArgument());
+
+  reader.Reset();
+  result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result->data()[0], std::byte{2});
+}
+
+TEST(MultiIntervalReader, InvalidIntervals) {
+  MemoryReader source(as_bytes(span(kData)));
+  std::array<Interval, 2> overlapping = {{{0, 4}, {3, 6}}};
+  MultiIntervalReader overlapping_reader(source, overlapping);
+  EXPECT_EQ(overlapping_reader.status(), Status::InvalidArgument());
+
+  std::array<Interval, 1> reversed = {{{4, 2}}};
+  MultiIntervalReader reversed_reader(source, reversed);
+  EXPECT_EQ(reversed_reader.status(), Status::InvalidArgument());
+
+  std::array<std::byte, 2> buffer;
+  EXPECT_EQ(reversed_reader.Read(buffer).status(), Status::InvalidArgument());
+
+  MultiIntervalReader default_reader;
+  EXPECT_EQ(default_reader.Read(buffer).status(), Status::FailedPrecondition());
+}
+
+}  // namespace
+}  // namespace pw::stream
@@ -0,0 +1,129 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+/// Reads from another reader through a caller-provided buffer.
+///
+/// Each read from the source fills as much of the buffer as the source
+/// provides, so a series of small reads, such as decoding a stream one varint
+/// byte at a time, costs one read of the source rather than one per byte.
+/// Reads that are at least as large as the buffer bypass it.
+///
+/// `Peek()` and `Consume()` give access to the buffered bytes in place.
+///
+/// @code{.cpp}
+///   std::array<std::byte, 64> buffer;
+///   pw::stream::BufferedReader reader(socket_stream, buffer);
+///   pw::protobuf::StreamDecoder decoder(reader);
+/// @endcode
+///
+/// Bytes read ahead from the source are only available through the
+/// `BufferedReader`. Do not read from the source directly while a
+/// `BufferedReader` wraps it.
+class BufferedReader : public NonSeekableReader {
+ public:
+  BufferedReader(Reader& source, ByteSpan buffer)
+      : source_(source), buffer_(buffer) {}
+
+  /// Returns the buffered bytes, reading from the source once if the buffer
+  /// is empty. The bytes stay buffered until they are consumed.
+  ///
+  /// @returns The buffered bytes, or the status from reading the source if
+  ///     the buffer was empty and the read failed.
+  Result<ConstByteSpan> Peek();
+
+  /// Removes bytes returned by `Peek()` from the front of the buffer.
+  ///
+  /// @pre `bytes` must not exceed `buffered()`.
+  void Consume(size_t bytes);
+
+  /// The number of bytes that have been read from the source but not yet
+  /// consumed.
+  size_t buffered() const { return end_ - position_; }
+
+  Reader& source() { return source_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) final;
+
+  size_t ConservativeLimit(LimitType limit) const final;
+
+  // Refills the empty buffer with one read from the source.
+  Status Fill();
+
+  Reader& source_;
+  ByteSpan buffer_;
+  size_t position_ = 0;
+  size_t end_ = 0;
+};
+
+/// Writes to another writer through a caller-provided buffer.
+///
+/// Small writes, such as HDLC frames written a few bytes at a time, are
+/// collected in the buffer and written to the sink together. Writes that do
+/// not fit in the buffer write out the buffered data first; writes that are
+/// at least as large as the buffer then go straight to the sink.
+///
+/// Data stays in the buffer until it fills or `Flush()` is called:
+///
+/// @code{.cpp}
+///   std::array<std::byte, 64> buffer;
+///   pw::stream::BufferedWriter writer(sys_io_writer, buffer);
+///   PW_TRY(pw::hdlc::WriteUIFrame(address, payload, writer));
+///   PW_TRY(writer.Flush());
+/// @endcode
+///
+/// The destructor flushes remaining data, but cannot report errors.
+class BufferedWriter : public NonSeekableWriter {
+ public:
+  BufferedWriter(Writer& sink, ByteSpan buffer)
+      : sink_(sink), buffer_(buffer) {}
+
+  BufferedWriter(const BufferedWriter&) = delete;
+  BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+  ~BufferedWriter() override { Flush().IgnoreError(); }
+
+  /// Writes buffered data to the sink.
+  ///
+  /// @returns The status from writing to the sink. On failure, the data stays
+  ///     buffered so the flush can be retried.
+  Status Flush();
+
+  /// The number of bytes waiting to be written to the sink.
+  size_t buffered() const { return size_; }
+
+  Writer& sink() { return sink_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) final;
+
+  size_t ConservativeLimit(LimitType limit) const final;
+
+  Writer& sink_;
+  ByteSpan buffer_;
+  size_t size_ = 0;
+};
+
+}  // namespace pw::stream
@@ -0,0 +1,256 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+namespace internal {
+
+// A minimal io_uring instance that uses the kernel interface directly, so
+// liburing is not required. Operations are submitted as soon as they are
+// queued. Not thread safe.
+class IoUring {
+ public:
+  // The most buffers that can be registered, which limits the queue depth.
+  static constexpr size_t kMaxBuffers = 16;
+
+  struct Completion {
+    uint64_t user_data;
+    int32_t result;  // Bytes transferred, or a negative errno value.
+  };
+
+  constexpr IoUring() = default;
+  ~IoUring() { Close(); }
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+
+  // Creates a ring for up to `buffers.size()` operations at once and tries to
+  // register the buffers with the kernel. Unregistered buffers still work, but
+  // the kernel maps them for every operation.
+  Status Init(span<const ByteSpan> buffers);
+
+  void Close();
+
+  // Starts reading into or writing from part of buffers[buffer_index].
+  Status SubmitRead(int fd,
+                    size_t buffer_index,
+                    ByteSpan dest,
+                    uint64_t offset,
+                    uint64_t user_data);
+  Status SubmitWrite(int fd,
+                     size_t buffer_index,
+                     ConstByteSpan data,
+                     uint64_t offset,
+                     uint64_t user_data);
+
+  // Waits for an operation to complete.
+  Result<Completion> Wait();
+
+  bool buffers_registered() const { return buffers_registered_; }
+
+ private:
+  Status Submit(uint8_t opcode,
+                int fd,
+                size_t buffer_index,
+                const std::byte* buffer,
+                size_t size,
+                uint64_t offset,
+                uint64_t user_data);
+
+  int ring_fd_ = -1;
+  bool buffers_registered_ = false;
+
+  // Memory shared with the kernel.
+  void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  void* cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  void* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t* sq_array_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t* cq_head_ = nullptr;
+  const uint32_t* cq_tail_ = nullptr;
+  const void* cqes_ = nullptr;
+  uint32_t cq_mask_ = 0;
+};
+
+}  // namespace internal
+
+/// Reads a file with Linux io_uring, keeping reads of the data after the
+/// current position in flight while earlier data is consumed.
+///
+/// The caller provides the buffer, which is split into `queue_depth` blocks
+/// that are registered with the kernel. Each block holds one read, so larger
+/// blocks mean fewer system calls and more queue depth means more reads in
+/// flight. Blocks of at least 64 KiB work well for bulk reads.
+///
+/// @code{.cpp}
+///   std::array<std::byte, 4 * 128 * 1024> buffer;
+///   pw::stream::IoUringFileReader reader(buffer, /*queue_depth=*/4);
+///   PW_TRY(reader.Open("trace.bin"));
+///   PW_TRY(ProcessTrace(reader));
+/// @endcode
+class IoUringFileReader final : public SeekableReader {
+ public:
+  static constexpr size_t kMaxQueueDepth = internal::IoUring::kMaxBuffers;
+
+  /// @pre `queue_depth` must be between 1 and `kMaxQueueDepth`, and `buffer`
+  ///     must hold at least one byte per block.
+  IoUringFileReader(ByteSpan buffer, size_t queue_depth = 4);
+
+  ~IoUringFileReader() override { Close(); }
+
+  /// Opens a file for reading from the beginning.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The file is open.
+  /// * @pw_status{NOT_FOUND} - The file does not exist.
+  /// * @pw_status{PERMISSION_DENIED} - The file cannot be read.
+  /// * @pw_status{UNAVAILABLE} - io_uring is not supported or is disabled.
+  Status Open(const char* path);
+
+  /// Waits for reads in flight and closes the file.
+  void Close();
+
+  /// Returns true if the buffer is registered with the kernel.
+  bool buffers_registered() const { return ring_.buffers_registered(); }
+
+ private:
+  struct Block {
+    uint64_t offset = 0;
+    int32_t result = 0;
+    size_t consumed = 0;
+    bool pending = false;
+  };
+
+  StatusWithSize DoRead(ByteSpan dest) override;
+  Status DoSeek(ptrdiff_t offset, Whence origin) override;
+  size_t DoTell() override { return position_; }
+  size_t ConservativeLimit(LimitType limit) const override;
+
+  ByteSpan block_buffer(size_t index) const {
+    return buffer_.subspan(index * block_size_, block_size_);
+  }
+
+  // Discards any data read ahead and starts reading at position_.
+  Status Restart();
+
+  // Starts reading the next block of the file into a block.
+  Status StartRead(size_t index);
+
+  Status WaitForCompletion();
+
+  ByteSpan buffer_;
+  size_t queue_depth_;
+  size_t block_size_;
+  internal::IoUring ring_;
+  int fd_ = -1;
+
+  std::array<Block, kMaxQueueDepth> blocks_{};
+  size_t pending_ = 0;
+  size_t head_ = 0;  // The block that holds the data at position_.
+  uint64_t position_ = 0;
+  uint64_t next_offset_ = 0;  // Where the next block read starts.
+  bool restart_ = false;
+};
+
+/// Writes a file with Linux io_uring. Data is copied into a block of the
+/// caller's buffer, and each full block is written while the next one fills.
+///
+/// Writes complete asynchronously, so an error may be reported by a later
+/// `Write`, `Flush`, or `Close` call. Call `Close` or `Flush` to make sure all
+/// data was written; the destructor closes the file but cannot report errors.
+class IoUringFileWriter final : public SeekableWriter {
+ public:
+  static constexpr size_t kMaxQueueDepth = internal::IoUring::kMaxBuffers;
+
+  /// @pre `queue_depth` must be between 1 and `kMaxQueueDepth`, and `buffer`
+  ///     must hold at least one byte per block.
+  IoUringFileWriter(ByteSpan buffer, size_t queue_depth = 4);
+
+  ~IoUringFileWriter() override { Close().IgnoreError(); }
+
+  /// Creates a file, or truncates it if it exists.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The file is open.
+  /// * @pw_status{NOT_FOUND} - The file's directory does not exist.
+  /// * @pw_status{PERMISSION_DENIED} - The file cannot be written.
+  /// * @pw_status{UNAVAILABLE} - io_uring is not supported or is disabled.
+  Status Open(const char* path);
+
+  /// Writes any partially filled block and waits for all writes to finish.
+  ///
+  /// @returns The first error from any write since the file was opened.
+  Status Flush();
+
+  /// Flushes and closes the file.
+  Status Close();
+
+  /// Returns true if the buffer is registered with the kernel.
+  bool buffers_registered() const { return ring_.buffers_registered(); }
+
+ private:
+  struct Block {
+    uint64_t offset = 0;
+    size_t start = 0;  // The unwritten data in the block.
+    size_t size = 0;
+    bool pending = false;
+  };
+
+  Status DoWrite(ConstByteSpan data) override;
+  Status DoSeek(ptrdiff_t offset, Whence origin) override;
+  size_t DoTell() override { return position_; }
+
+  ByteSpan block_buffer(size_t index) const {
+    return buffer_.subspan(index * block_size_, block_size_);
+  }
+
+  // Starts writing the current block if it holds any data.
+  Status SubmitCurrentBlock();
+
+  Status SubmitBlock(size_t index);
+
+  Status WaitForCompletion();
+
+  ByteSpan buffer_;
+  size_t queue_depth_;
+  size_t block_size_;
+  internal::IoUring ring_;
+  int fd_ = -1;
+
+  std::array<Block, kMaxQueueDepth> blocks_{};
+  size_t pending_ = 0;
+  size_t current_ = 0;  // The block being filled.
+  size_t filled_ = 0;   // Bytes in the current block.
+  uint64_t position_ = 0;
+
+  // The first write error, which is reported until the file is closed.
+  Status status_;
+};
+
+}  // namespace pw::stream
@@ -0,0 +1,88 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+/// Reads a file by mapping it into memory with `mmap()`.
+///
+/// Reads copy directly from the mapping, without a system call or an
+/// intermediate buffer. The whole file is also available as a span with
+/// `mapped_data()`, so parsers that work on memory can use it in place:
+///
+/// @code{.cpp}
+///   pw::stream::MappedFileReader file;
+///   PW_TRY(file.Open("tokens.bin"));
+///
+///   auto bytes = pw::span(
+///       reinterpret_cast<const uint8_t*>(file.mapped_data().data()),
+///       file.mapped_data().size());
+///   pw::tokenizer::TokenDatabase database =
+///       pw::tokenizer::TokenDatabase::Create(bytes);
+/// @endcode
+///
+/// The mapping is read-only and private. Spans returned by `mapped_data()`
+/// remain valid until the reader is closed or destroyed. The file should not
+/// be truncated while it is mapped, since accessing pages past the new end of
+/// the file raises `SIGBUS`.
+class MappedFileReader final : public SeekableReader {
+ public:
+  MappedFileReader() = default;
+
+  MappedFileReader(const MappedFileReader&) = delete;
+  MappedFileReader& operator=(const MappedFileReader&) = delete;
+
+  ~MappedFileReader() override { Close(); }
+
+  /// Maps a file for reading from the beginning. Closes the previously opened
+  /// file, if any.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The file is mapped.
+  /// * @pw_status{NOT_FOUND} - The file does not exist.
+  /// * @pw_status{PERMISSION_DENIED} - The file cannot be read.
+  /// * @pw_status{FAILED_PRECONDITION} - The path is not a regular file, or
+  ///   the file cannot be mapped.
+  /// * @pw_status{RESOURCE_EXHAUSTED} - The file could not be mapped.
+  Status Open(const char* path);
+
+  /// Unmaps the file. Spans returned by `mapped_data()` become invalid.
+  void Close();
+
+  bool is_open() const { return open_; }
+
+  /// Returns the contents of the file. Empty if no file is open.
+  ConstByteSpan mapped_data() const { return ConstByteSpan(data_, size_); }
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override;
+  Status DoSeek(ptrdiff_t offset, Whence origin) override;
+  size_t DoTell() override { return position_; }
+  size_t ConservativeLimit(LimitType limit) const override {
+    return limit == LimitType::kRead ? size_ - position_ : 0;
+  }
+
+  const std::byte* data_ = nullptr;
+  size_t size_ = 0;
+  size_t position_ = 0;
+  bool open_ = false;
+};
+
+}  // namespace pw::stream
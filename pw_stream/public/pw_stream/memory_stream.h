@@ -76,6 +76,9 @@ class MemoryWriter : public SeekableWriter {
   // perform a partial write and Status::ResourceExhausted() will be returned.
   Status DoWrite(ConstByteSpan data) final;
 
+  // Copies all buffers, or none of them if they do not fit.
+  Status DoWriteV(span<const ConstByteSpan> data) final;
+
   Status DoSeek(ptrdiff_t offset, Whence origin) final {
     return CalculateSeek(offset, origin, dest_.size(), position_);
   }
@@ -0,0 +1,90 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+// A reader that presents several intervals of a seekable source reader as one
+// stream, which reads the intervals in order of their offset in the source.
+//
+// The intervals are sorted, and adjacent intervals are merged, when the reader
+// is constructed. Each contiguous run of the source is then read with at most
+// one seek: the source is only sought if it is not already at the offset to
+// read, so reading the runs in order does not seek for each interval. Like
+// IntervalReader, the reader tracks its own position, so it may share the
+// source with other readers.
+class MultiIntervalReader : public SeekableReader {
+ public:
+  // A [start, end) range of offsets in the source reader.
+  struct Interval {
+    size_t start;
+    size_t end;
+  };
+
+  constexpr MultiIntervalReader() : status_(Status::Unavailable()) {}
+
+  // source_reader -- The source reader to read from.
+  // intervals -- The intervals of `source_reader` to read. They are sorted and
+  //   merged in place, so the storage must outlive the reader. The status is
+  //   INVALID_ARGUMENT if an interval ends before it starts or if intervals
+  //   overlap.
+  MultiIntervalReader(SeekableReader& source_reader, span<Interval> intervals);
+
+  // Resets the read offset to the start of the first interval.
+  MultiIntervalReader& Reset() {
+    position_ = 0;
+    interval_ = 0;
+    interval_offset_ = 0;
+    return *this;
+  }
+
+  // The sorted, merged intervals.
+  span<const Interval> intervals() const { return intervals_; }
+
+  // The total size of the intervals.
+  size_t size() const { return size_; }
+
+  bool ok() const { return status_.ok(); }
+  Status status() const { return status_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) final;
+  Status DoSeek(ptrdiff_t offset, Whence origin) final;
+  size_t DoTell() final { return position_; }
+  size_t ConservativeLimit(LimitType limit) const override {
+    if (limit == LimitType::kRead) {
+      return size_ - position_;
+    }
+    return 0;
+  }
+
+  SeekableReader* source_reader_ = nullptr;
+  span<Interval> intervals_;
+  size_t size_ = 0;
+
+  // The read offset within the stream, and the interval and offset within that
+  // interval that it corresponds to.
+  size_t position_ = 0;
+  size_t interval_ = 0;
+  size_t interval_offset_ = 0;
+  Status status_ = OkStatus();
+};
+
+}  // namespace pw::stream
@@ -14,7 +14,9 @@
 #pragma once
 
 #include <netinet/in.h>
+#include <sys/socket.h>
 
+#include <chrono>
 #include <cstdint>
 
 #include "pw_result/result.h"
@@ -30,11 +32,13 @@ class SocketStream : public NonSeekableReaderWriter {
   // SocketStream objects are moveable but not copyable.
   SocketStream& operator=(SocketStream&& other) {
     connection_fd_ = other.connection_fd_;
+    write_timeout_ = other.write_timeout_;
     other.connection_fd_ = kInvalidFd;
     return *this;
   }
   SocketStream(SocketStream&& other) noexcept
-      : connection_fd_(other.connection_fd_) {
+      : connection_fd_(other.connection_fd_),
+        write_timeout_(other.write_timeout_) {
     other.connection_fd_ = kInvalidFd;
   }
   SocketStream(const SocketStream&) = delete;
@@ -50,6 +54,24 @@ class SocketStream : public NonSeekableReaderWriter {
   // Close the socket stream and release all resources
   void Close();
 
+  // Sets whether the active connection blocks. In non-blocking mode, Read()
+  // returns RESOURCE_EXHAUSTED instead of waiting when no data is available,
+  // so the caller can wait for the socket to become readable (e.g. with
+  // poll() or epoll) and read again. Writes always send all of their data; in
+  // non-blocking mode, a write waits for space if the send buffer is full, up
+  // to the timeout set with SetWriteTimeout().
+  //
+  // Returns FAILED_PRECONDITION if there is no active connection.
+  Status SetNonBlocking(bool non_blocking);
+
+  // Limits how long a write in non-blocking mode waits in total for space in
+  // the send buffer. If the limit is reached, the write returns
+  // DEADLINE_EXCEEDED, and part of the data may have been sent. A negative
+  // timeout, the default, waits indefinitely.
+  void SetWriteTimeout(std::chrono::milliseconds timeout) {
+    write_timeout_ = timeout;
+  }
+
   // Exposes the file descriptor for the active connection. This is exposed to
   // allow configuration and introspection of this socket's current
   // configuration using setsockopt() and getsockopt().
@@ -64,9 +86,16 @@ class SocketStream : public NonSeekableReaderWriter {
 
   Status DoWrite(span<const std::byte> data) override;
 
+  // Sends the buffers with as few sendmsg() calls as possible.
+  Status DoWriteV(span<const ConstByteSpan> data) override;
+
+  // Sends all of the message's buffers, continuing after partial sends.
+  Status SendMessage(msghdr& message);
+
   StatusWithSize DoRead(ByteSpan dest) override;
 
   int connection_fd_ = kInvalidFd;
+  std::chrono::milliseconds write_timeout_{-1};
 };
 
 /// `ServerSocket` wraps a POSIX-style server socket, producing a `SocketStream`
@@ -45,6 +45,7 @@ class StdFileWriter final : public stream::SeekableWriter {
 
  private:
   Status DoWrite(ConstByteSpan data) override;
+  Status DoWriteV(span<const ConstByteSpan> data) override;
   Status DoSeek(ptrdiff_t offset, Whence origin) override;
   size_t DoTell() override;
 
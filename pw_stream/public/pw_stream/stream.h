@@ -159,6 +159,26 @@ class Stream {
   /// @overload
   Status Write(const std::byte b) { return Write(&b, 1); }
 
+  /// Writes a sequence of buffers to this stream, in order, as if they were
+  /// one contiguous buffer. Streams that can pass the whole list to the
+  /// underlying sink at once, such as `writev()` on a socket, write it with a
+  /// single call.
+  ///
+  /// Derived classes should NOT try to override the public WriteV method.
+  /// Instead, provide an implementation by overriding DoWriteV(). The default
+  /// calls Write() for each buffer.
+  ///
+  /// @retval OK All buffers were successfully accepted by the stream, or the
+  ///            buffers were all empty.
+  /// @retval UNIMPLEMENTED This stream does not support writing.
+  /// @retval RESOURCE_EXHAUSTED The combined size of the buffers exceeds
+  ///                            ConservativeWriteLimit(). No data was written.
+  /// @retval OUT_OF_RANGE The Writer has been exhausted. No data was written.
+  ///
+  /// Other errors are returned from the write that failed. Buffers before the
+  /// failed one may have been written.
+  Status WriteV(span<const ConstByteSpan> data) { return DoWriteV(data); }
+
   /// Changes the current position in the stream for both reading and writing,
   /// if supported.
   ///
@@ -257,6 +277,39 @@ class Stream {
   /// Virtual Write() function implemented by derived classes.
   virtual Status DoWrite(ConstByteSpan data) = 0;
 
+  /// Virtual WriteV() function optionally implemented by derived classes.
+  ///
+  /// The default implementation checks the combined size against
+  /// ConservativeWriteLimit() and then calls DoWrite() for each buffer. Writing
+  /// no data succeeds without calling DoWrite().
+  virtual Status DoWriteV(span<const ConstByteSpan> data) {
+    if (!writable()) {
+      return Status::Unimplemented();
+    }
+
+    size_t size = 0;
+    for (ConstByteSpan buffer : data) {
+      size += buffer.size();
+    }
+    if (size == 0) {
+      return OkStatus();
+    }
+    const size_t limit = ConservativeWriteLimit();
+    if (limit == 0) {
+      return Status::OutOfRange();
+    }
+    if (size > limit) {
+      return Status::ResourceExhausted();
+    }
+
+    for (ConstByteSpan buffer : data) {
+      if (Status status = DoWrite(buffer); !status.ok()) {
+        return status;
+      }
+    }
+    return OkStatus();
+  }
+
   /// Virtual Seek() function implemented by derived classes.
   virtual Status DoSeek(ptrdiff_t offset, Whence origin) = 0;
 
@@ -304,6 +357,7 @@ class Reader : public Stream {
       : Stream(true, false, seekability) {}
 
   using Stream::Write;
+  using Stream::WriteV;
 
   Status DoWrite(ConstByteSpan) final { return Status::Unimplemented(); }
 };
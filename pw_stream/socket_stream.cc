@@ -16,17 +16,23 @@
 
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <fcntl.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cstring>
 
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 #include "pw_string/to_string.h"
 
 namespace pw::stream {
@@ -35,6 +41,47 @@ namespace {
 constexpr uint32_t kServerBacklogLength = 1;
 constexpr const char* kLocalhostAddress = "localhost";
 
+// The number of buffers passed to each sendmsg() call by DoWriteV().
+constexpr size_t kMaxIoVecs = 16;
+
+int SendFlags() {
+  int send_flags = 0;
+#if defined(__linux__)
+  // Use MSG_NOSIGNAL to avoid getting a SIGPIPE signal when the remote
+  // peer drops the connection. This is supported on Linux only.
+  send_flags |= MSG_NOSIGNAL;
+#endif  // defined(__linux__)
+  return send_flags;
+}
+
+Status SendError() {
+  if (errno == EPIPE) {
+    // An EPIPE indicates that the connection is closed.  Return an OutOfRange
+    // error.
+    return Status::OutOfRange();
+  }
+  return Status::Unknown();
+}
+
+// Waits for a socket with a full send buffer to accept more data. Waits
+// indefinitely if timeout_ms is negative.
+Status WaitUntilWritable(int socket, int timeout_ms) {
+  struct pollfd poll_fd = {};
+  poll_fd.fd = socket;
+  poll_fd.events = POLLOUT;
+  int result;
+  while ((result = poll(&poll_fd, 1, timeout_ms)) < 0) {
+    if (errno != EINTR) {
+      return Status::Unknown();
+    }
+  }
+  if (result == 0) {
+    return Status::DeadlineExceeded();
+  }
+  // If the connection was closed, the next send reports the error.
+  return OkStatus();
+}
+
 // Set necessary options on a socket file descriptor.
 void ConfigureSocket([[maybe_unused]] int socket) {
 #if defined(__APPLE__)
@@ -103,25 +150,83 @@ void SocketStream::Close() {
   }
 }
 
+Status SocketStream::SetNonBlocking(bool non_blocking) {
+  if (connection_fd_ == kInvalidFd) {
+    return Status::FailedPrecondition();
+  }
+  int flags = fcntl(connection_fd_, F_GETFL);
+  if (flags < 0) {
+    return Status::Unknown();
+  }
+  flags = non_blocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+  if (fcntl(connection_fd_, F_SETFL, flags) < 0) {
+    return Status::Unknown();
+  }
+  return OkStatus();
+}
+
 Status SocketStream::DoWrite(span<const std::byte> data) {
-  int send_flags = 0;
-#if defined(__linux__)
-  // Use MSG_NOSIGNAL to avoid getting a SIGPIPE signal when the remote
-  // peer drops the connection. This is supported on Linux only.
-  send_flags |= MSG_NOSIGNAL;
-#endif  // defined(__linux__)
+  return DoWriteV(span(&data, 1));
+}
+
+Status SocketStream::DoWriteV(span<const ConstByteSpan> data) {
+  while (!data.empty()) {
+    const size_t count = std::min(data.size(), kMaxIoVecs);
+    iovec iov[kMaxIoVecs];
+    for (size_t i = 0; i < count; ++i) {
+      // sendmsg() does not modify the buffers, but iovec is shared with
+      // readv(), so its pointer is not const.
+      iov[i].iov_base = const_cast<std::byte*>(data[i].data());
+      iov[i].iov_len = data[i].size();
+    }
 
-  ssize_t bytes_sent =
-      send(connection_fd_, data.data(), data.size_bytes(), send_flags);
+    msghdr message = {};
+    message.msg_iov = iov;
+    message.msg_iovlen = static_cast<decltype(message.msg_iovlen)>(count);
+    PW_TRY(SendMessage(message));
+    data = data.subspan(count);
+  }
+  return OkStatus();
+}
 
-  if (bytes_sent < 0 || static_cast<size_t>(bytes_sent) != data.size()) {
-    if (errno == EPIPE) {
-      // An EPIPE indicates that the connection is closed.  Return an OutOfRange
-      // error.
-      return Status::OutOfRange();
+Status SocketStream::SendMessage(msghdr& message) {
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point deadline = Clock::now() + write_timeout_;
+
+  while (message.msg_iovlen > 0) {
+    ssize_t bytes_sent = sendmsg(connection_fd_, &message, SendFlags());
+    if (bytes_sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // The socket is non-blocking and its send buffer is full.
+        int timeout_ms = -1;
+        if (write_timeout_ >= std::chrono::milliseconds(0)) {
+          const auto remaining =
+              std::chrono::ceil<std::chrono::milliseconds>(deadline -
+                                                           Clock::now());
+          timeout_ms = static_cast<int>(
+              std::max<std::chrono::milliseconds::rep>(remaining.count(), 0));
+        }
+        PW_TRY(WaitUntilWritable(connection_fd_, timeout_ms));
+        continue;
+      }
+      return SendError();
     }
 
-    return Status::Unknown();
+    // Skip the buffers that were sent and resume from the first unsent byte.
+    size_t remaining = static_cast<size_t>(bytes_sent);
+    while (message.msg_iovlen > 0 && remaining >= message.msg_iov->iov_len) {
+      remaining -= message.msg_iov->iov_len;
+      message.msg_iov += 1;
+      message.msg_iovlen -= 1;
+    }
+    if (message.msg_iovlen > 0) {
+      message.msg_iov->iov_base =
+          static_cast<std::byte*>(message.msg_iov->iov_base) + remaining;
+      message.msg_iov->iov_len -= remaining;
+    }
   }
   return OkStatus();
 }
@@ -129,17 +234,15 @@ Status SocketStream::DoWrite(span<const std::byte> data) {
 StatusWithSize SocketStream::DoRead(ByteSpan dest) {
   ssize_t bytes_rcvd = recv(connection_fd_, dest.data(), dest.size_bytes(), 0);
   if (bytes_rcvd == 0) {
-    if (errno == EAGAIN || errno == EWOULDBLOCK) {
-      // Socket timed out when trying to read.
-      // This should only occur if SO_RCVTIMEO was configured to be nonzero, or
-      // if the socket was opened with the O_NONBLOCK flag to prevent any
-      // blocking when performing reads or writes.
-      return StatusWithSize::ResourceExhausted();
-    }
     // Remote peer has closed the connection.
     Close();
     return StatusWithSize::OutOfRange();
   } else if (bytes_rcvd < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      // No data is available. This occurs if the socket is non-blocking, or if
+      // SO_RCVTIMEO was configured and the read timed out.
+      return StatusWithSize::ResourceExhausted();
+    }
     return StatusWithSize::Unknown();
   }
   return StatusWithSize(bytes_rcvd);
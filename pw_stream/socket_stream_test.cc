@@ -14,6 +14,8 @@
 
 #include "pw_stream/socket_stream.h"
 
+#include <algorithm>
+#include <array>
 #include <thread>
 
 #include "gtest/gtest.h"
@@ -136,6 +138,97 @@ TEST(SocketStreamTest, ReadWrite) {
   server.Close();
 }
 
+TEST(SocketStreamTest, WriteV) {
+  ServerSocket server;
+  EXPECT_EQ(server.Listen(), OkStatus());
+
+  Result<SocketStream> server_stream = Status::Unavailable();
+  auto accept_thread = std::thread{[&]() { server_stream = server.Accept(); }};
+
+  SocketStream client;
+  EXPECT_EQ(client.Connect("localhost", server.port()), OkStatus());
+
+  accept_thread.join();
+  ASSERT_EQ(server_stream.status(), OkStatus());
+
+  // Send more buffers than fit in one sendmsg() call.
+  constexpr std::array<std::byte, 2> kData = {std::byte{'a'}, std::byte{'b'}};
+  std::array<ConstByteSpan, 40> buffers;
+  buffers.fill(kData);
+  EXPECT_EQ(client.WriteV(buffers), OkStatus());
+  client.Close();
+
+  std::array<std::byte, 2 * buffers.size()> received{};
+  size_t received_size = 0;
+  while (received_size < received.size()) {
+    Result<ByteSpan> result =
+        server_stream->Read(span(received).subspan(received_size));
+    ASSERT_EQ(result.status(), OkStatus());
+    received_size += result->size();
+  }
+  for (size_t i = 0; i < received.size(); ++i) {
+    EXPECT_EQ(received[i], kData[i % 2]);
+  }
+
+  server_stream->Close();
+  server.Close();
+}
+
+TEST(SocketStreamTest, NonBlocking) {
+  SocketStream unconnected;
+  EXPECT_EQ(unconnected.SetNonBlocking(true), Status::FailedPrecondition());
+
+  ServerSocket server;
+  EXPECT_EQ(server.Listen(), OkStatus());
+
+  Result<SocketStream> server_stream = Status::Unavailable();
+  auto accept_thread = std::thread{[&]() { server_stream = server.Accept(); }};
+
+  SocketStream client;
+  EXPECT_EQ(client.Connect("localhost", server.port()), OkStatus());
+
+  accept_thread.join();
+  ASSERT_EQ(server_stream.status(), OkStatus());
+  ASSERT_EQ(server_stream->SetNonBlocking(true), OkStatus());
+
+  std::array<std::byte, 1024> buffer{};
+  EXPECT_EQ(server_stream->Read(buffer).status(), Status::ResourceExhausted());
+
+  // Write more than fits in the socket buffers, so the non-blocking writer has
+  // to wait for the reader.
+  constexpr size_t kTotalSize = 8 * 1024 * 1024;
+  Status write_status = Status::Unknown();
+  auto write_thread = std::thread{[&]() {
+    buffer.fill(std::byte{0x5a});
+    size_t written = 0;
+    while (written < kTotalSize) {
+      write_status = server_stream->Write(buffer);
+      if (!write_status.ok()) {
+        return;
+      }
+      written += buffer.size();
+    }
+  }};
+
+  std::array<std::byte, 4096> received;
+  size_t received_size = 0;
+  while (received_size < kTotalSize) {
+    Result<ByteSpan> result = client.Read(received);
+    ASSERT_EQ(result.status(), OkStatus());
+    ASSERT_TRUE(std::all_of(result->begin(), result->end(), [](std::byte b) {
+      return b == std::byte{0x5a};
+    }));
+    received_size += result->size();
+  }
+  write_thread.join();
+  EXPECT_EQ(write_status, OkStatus());
+  EXPECT_EQ(received_size, kTotalSize);
+
+  client.Close();
+  server_stream->Close();
+  server.Close();
+}
+
 TEST(SocketStreamTest, MultipleClients) {
   ServerSocket server;
   EXPECT_EQ(server.Listen(), OkStatus());
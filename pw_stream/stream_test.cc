@@ -14,6 +14,7 @@
 
 #include "pw_stream/stream.h"
 
+#include <array>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -132,6 +133,7 @@ void TestStreamImpl() {
   ASSERT_EQ(readable ? OkStatus() : Status::Unimplemented(),
             stream.Read({}).status());
   ASSERT_EQ(writable ? OkStatus() : Status::Unimplemented(), stream.Write({}));
+  ASSERT_EQ(writable ? OkStatus() : Status::Unimplemented(), stream.WriteV({}));
   ASSERT_EQ(seekable ? OkStatus() : Status::Unimplemented(), stream.Seek(0));
 
   // Check ConservativeLimits()
@@ -193,5 +195,54 @@ TEST(Stream, SeekableReaderWriter) {
   TestStreamImpl<TestSeekableReaderWriter, kReadable, kWritable, kSeekable>();
 }
 
+// Counts writes against a fixed write limit.
+class LimitedWriter : public NonSeekableWriter {
+ public:
+  LimitedWriter(size_t limit) : limit_(limit) {}
+
+  size_t writes() const { return writes_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    limit_ -= data.size();
+    return OkStatus();
+  }
+
+  size_t ConservativeLimit(LimitType type) const override {
+    return type == LimitType::kWrite ? limit_ : 0;
+  }
+
+  size_t limit_;
+  size_t writes_ = 0;
+};
+
+TEST(Stream, WriteV_DefaultWritesEachBuffer) {
+  constexpr std::array<std::byte, 3> kData{};
+  const std::array<ConstByteSpan, 3> buffers = {
+      ConstByteSpan(kData), ConstByteSpan(kData), ConstByteSpan(kData)};
+
+  LimitedWriter writer(8);
+  EXPECT_EQ(writer.WriteV(buffers), Status::ResourceExhausted());
+  EXPECT_EQ(writer.writes(), 0u);
+
+  EXPECT_EQ(writer.WriteV(span(buffers).first(2)), OkStatus());
+  EXPECT_EQ(writer.writes(), 2u);
+  EXPECT_EQ(writer.ConservativeWriteLimit(), 2u);
+
+  EXPECT_EQ(writer.Write(span(kData).first(2)), OkStatus());
+  EXPECT_EQ(writer.WriteV(buffers), Status::OutOfRange());
+}
+
+TEST(Stream, WriteV_EmptyDataSucceedsWhenExhausted) {
+  LimitedWriter writer(0);
+  EXPECT_EQ(writer.WriteV({}), OkStatus());
+
+  const std::array<ConstByteSpan, 2> buffers = {ConstByteSpan(),
+                                                ConstByteSpan()};
+  EXPECT_EQ(writer.WriteV(buffers), OkStatus());
+  EXPECT_EQ(writer.writes(), 0u);
+}
+
 }  // namespace
 }  // namespace pw::stream
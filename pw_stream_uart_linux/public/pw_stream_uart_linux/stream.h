@@ -24,6 +24,34 @@ namespace pw::stream {
 /// `pw::stream::NonSeekableReaderWriter` implementation for UARTs on Linux.
 class UartStreamLinux : public NonSeekableReaderWriter {
  public:
+  /// Options for opening a UART device.
+  struct Config {
+    /// Baud rate to use for the device.
+    uint32_t baud_rate;
+
+    /// Minimum number of bytes that a read waits for (the termios `VMIN`).
+    /// Larger values batch received data into fewer reads at high baud rates.
+    uint8_t min_read_bytes = 1;
+
+    /// Time to wait for more data after a byte is received, in tenths of a
+    /// second (the termios `VTIME`). A read returns once `min_read_bytes` are
+    /// received or this time passes without data. If `min_read_bytes` is 0,
+    /// this is the time to wait for any data, after which the read returns 0
+    /// bytes. 0 waits without a time limit.
+    uint8_t read_timeout_deciseconds = 0;
+
+    /// Asks the serial driver to pass received data to reads immediately
+    /// (`ASYNC_LOW_LATENCY`) rather than buffering it for a few milliseconds.
+    /// Drivers that don't support it log a warning and are opened anyway.
+    bool low_latency = false;
+
+    /// Opens the device in non-blocking mode. Reads return
+    /// @pw_status{UNAVAILABLE} instead of waiting for data, so the stream can
+    /// be read when `fd()` becomes readable in an event loop such as `epoll`.
+    /// Writes still wait until all data is accepted by the driver.
+    bool non_blocking = false;
+  };
+
   constexpr UartStreamLinux() = default;
 
   // UartStream objects are moveable but not copyable.
@@ -50,9 +78,25 @@ class UartStreamLinux : public NonSeekableReaderWriter {
   /// * @pw_status{INVALID_ARGUMENT} - An unsupported baud rate was supplied.
   /// * @pw_status{FAILED_PRECONDITION} - A device was already open.
   /// * @pw_status{UNKNOWN} - An error was returned by the operating system.
-  Status Open(const char* path, uint32_t baud_rate);
+  Status Open(const char* path, uint32_t baud_rate) {
+    return Open(path, Config{.baud_rate = baud_rate});
+  }
+
+  /// Open a UART device using the specified configuration.
+  ///
+  /// @param[in] path Path to the TTY device.
+  /// @param[in] config Baud rate and read options to use for the device.
+  ///
+  /// @returns The same statuses as `Open(const char*, uint32_t)`.
+  Status Open(const char* path, const Config& config);
+
   void Close();
 
+  /// Returns the file descriptor of the open device, or -1 if none is open.
+  /// Use it to wait for the device to become readable, for example with
+  /// `epoll`, when it is opened with `Config::non_blocking`.
+  int fd() const { return fd_; }
+
  private:
   static constexpr int kInvalidFd = -1;
 
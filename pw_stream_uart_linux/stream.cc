@@ -15,43 +15,71 @@
 #include "pw_stream_uart_linux/stream.h"
 
 #include <fcntl.h>
+#include <linux/serial.h>
+#include <poll.h>
+#include <sys/ioctl.h>
 #include <termios.h>
 #include <unistd.h>
 
 #include <cerrno>
 #include <cinttypes>
+#include <cstring>
 
 #include "pw_log/log.h"
 
 namespace pw::stream {
+namespace {
 
-Status UartStreamLinux::Open(const char* path, uint32_t baud_rate) {
-  speed_t speed;
-
-  // Extend switch statement as needed to support additional baud rates.
+// Extend as needed to support additional baud rates.
+bool BaudRateToSpeed(uint32_t baud_rate, speed_t* speed) {
   switch (baud_rate) {
+    case 9600:
+      *speed = B9600;
+      return true;
+    case 19200:
+      *speed = B19200;
+      return true;
+    case 38400:
+      *speed = B38400;
+      return true;
+    case 57600:
+      *speed = B57600;
+      return true;
     case 115200:
-      speed = B115200;
-      break;
+      *speed = B115200;
+      return true;
+    case 230400:
+      *speed = B230400;
+      return true;
+    case 460800:
+      *speed = B460800;
+      return true;
+    case 921600:
+      *speed = B921600;
+      return true;
+    case 1000000:
+      *speed = B1000000;
+      return true;
+    case 2000000:
+      *speed = B2000000;
+      return true;
+    case 3000000:
+      *speed = B3000000;
+      return true;
+    case 4000000:
+      *speed = B4000000;
+      return true;
     default:
-      PW_LOG_ERROR("Unsupported baud rate: %" PRIu32, baud_rate);
-      return Status::InvalidArgument();
-  }
-
-  if (fd_ != kInvalidFd) {
-    PW_LOG_ERROR("UART device already open");
-    return Status::FailedPrecondition();
-  }
-
-  fd_ = open(path, O_RDWR);
-  if (fd_ < 0) {
-    PW_LOG_ERROR(
-        "Failed to open UART device '%s', %s", path, std::strerror(errno));
-    return Status::Unknown();
+      return false;
   }
+}
 
+Status Configure(int fd,
+                 const char* path,
+                 speed_t speed,
+                 const UartStreamLinux::Config& config) {
   struct termios tty;
-  int result = tcgetattr(fd_, &tty);
+  int result = tcgetattr(fd, &tty);
   if (result < 0) {
     PW_LOG_ERROR("Failed to get TTY attributes for '%s', %s",
                  path,
@@ -60,6 +88,8 @@ Status UartStreamLinux::Open(const char* path, uint32_t baud_rate) {
   }
 
   cfmakeraw(&tty);
+  tty.c_cc[VMIN] = config.min_read_bytes;
+  tty.c_cc[VTIME] = config.read_timeout_deciseconds;
   result = cfsetspeed(&tty, speed);
   if (result < 0) {
     PW_LOG_ERROR(
@@ -67,7 +97,7 @@ Status UartStreamLinux::Open(const char* path, uint32_t baud_rate) {
     return Status::Unknown();
   }
 
-  result = tcsetattr(fd_, TCSANOW, &tty);
+  result = tcsetattr(fd, TCSANOW, &tty);
   if (result < 0) {
     PW_LOG_ERROR("Failed to set TTY attributes for '%s', %s",
                  path,
@@ -75,6 +105,49 @@ Status UartStreamLinux::Open(const char* path, uint32_t baud_rate) {
     return Status::Unknown();
   }
 
+  if (config.low_latency) {
+    // Not all TTY drivers support this, and it only affects latency.
+    struct serial_struct serial;
+    result = ioctl(fd, TIOCGSERIAL, &serial);
+    if (result >= 0) {
+      serial.flags |= ASYNC_LOW_LATENCY;
+      result = ioctl(fd, TIOCSSERIAL, &serial);
+    }
+    if (result < 0) {
+      PW_LOG_WARN("Failed to enable low latency mode for '%s', %s",
+                  path,
+                  std::strerror(errno));
+    }
+  }
+
+  return OkStatus();
+}
+
+}  // namespace
+
+Status UartStreamLinux::Open(const char* path, const Config& config) {
+  speed_t speed;
+  if (!BaudRateToSpeed(config.baud_rate, &speed)) {
+    PW_LOG_ERROR("Unsupported baud rate: %" PRIu32, config.baud_rate);
+    return Status::InvalidArgument();
+  }
+
+  if (fd_ != kInvalidFd) {
+    PW_LOG_ERROR("UART device already open");
+    return Status::FailedPrecondition();
+  }
+
+  fd_ = open(path, O_RDWR | O_NOCTTY | (config.non_blocking ? O_NONBLOCK : 0));
+  if (fd_ < 0) {
+    PW_LOG_ERROR(
+        "Failed to open UART device '%s', %s", path, std::strerror(errno));
+    return Status::Unknown();
+  }
+
+  if (Status status = Configure(fd_, path, speed, config); !status.ok()) {
+    Close();
+    return status;
+  }
   return OkStatus();
 }
 
@@ -89,23 +162,35 @@ Status UartStreamLinux::DoWrite(ConstByteSpan data) {
   const size_t size = data.size_bytes();
   size_t written = 0;
   while (written < size) {
-    int bytes = write(fd_, &data[written], size - written);
+    ssize_t bytes = write(fd_, &data[written], size - written);
     if (bytes < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // In non-blocking mode, wait for the driver to accept more data.
+        struct pollfd writable = {.fd = fd_, .events = POLLOUT, .revents = 0};
+        if (poll(&writable, 1, -1) >= 0 || errno == EINTR) {
+          continue;
+        }
+      } else if (errno == EINTR) {
+        continue;
+      }
       PW_LOG_ERROR("Failed to write to UART, %s", std::strerror(errno));
       return Status::Unknown();
     }
-    written += bytes;
+    written += static_cast<size_t>(bytes);
   }
   return OkStatus();
 }
 
 StatusWithSize UartStreamLinux::DoRead(ByteSpan dest) {
-  int bytes = read(fd_, &dest[0], dest.size_bytes());
+  ssize_t bytes = read(fd_, dest.data(), dest.size_bytes());
   if (bytes < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return StatusWithSize::Unavailable();
+    }
     PW_LOG_ERROR("Failed to read from UART, %s", std::strerror(errno));
     return StatusWithSize::Unknown();
   }
-  return StatusWithSize(bytes);
+  return StatusWithSize(static_cast<size_t>(bytes));
 }
 
 }  // namespace pw::stream
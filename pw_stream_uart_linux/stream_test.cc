@@ -14,6 +14,13 @@
 
 #include "pw_stream_uart_linux/stream.h"
 
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstring>
+
 #include "gtest/gtest.h"
 #include "public/pw_stream_uart_linux/stream.h"
 
@@ -35,5 +42,120 @@ TEST(UartStreamLinuxTest, TestOpenInvalidBaudRate) {
   EXPECT_EQ(status, Status::InvalidArgument());
 }
 
+// Opens a pseudo-terminal, whose device behaves like a UART.
+class UartStreamLinuxPtyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    controller_ = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(controller_, 0);
+    ASSERT_EQ(grantpt(controller_), 0);
+    ASSERT_EQ(unlockpt(controller_), 0);
+    device_path_ = ptsname(controller_);
+    ASSERT_NE(device_path_, nullptr);
+  }
+
+  void TearDown() override { close(controller_); }
+
+  // Sends data to the UART device.
+  void Send(const char* data) {
+    const size_t size = std::strlen(data);
+    ASSERT_EQ(write(controller_, data, size), static_cast<ssize_t>(size));
+  }
+
+  int controller_ = -1;
+  const char* device_path_ = nullptr;
+};
+
+TEST_F(UartStreamLinuxPtyTest, OpenTwiceFails) {
+  UartStreamLinux uart;
+  ASSERT_EQ(uart.Open(device_path_, 115200), OkStatus());
+  EXPECT_NE(uart.fd(), -1);
+  EXPECT_EQ(uart.Open(device_path_, 115200), Status::FailedPrecondition());
+
+  uart.Close();
+  EXPECT_EQ(uart.fd(), -1);
+}
+
+TEST_F(UartStreamLinuxPtyTest, ReadWaitsForMinReadBytes) {
+  UartStreamLinux uart;
+  ASSERT_EQ(uart.Open(device_path_,
+                      {.baud_rate = 3000000,
+                       .min_read_bytes = 4,
+                       .read_timeout_deciseconds = 1,
+                       .low_latency = true}),
+            OkStatus());
+
+  Send("0123456789");
+  std::array<std::byte, 16> buffer;
+  Result<ByteSpan> result = uart.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  // Reads wait for at least min_read_bytes.
+  EXPECT_GE(result->size(), 4u);
+
+  size_t received = result->size();
+  while (received < 10u) {
+    result = uart.Read(span(buffer).subspan(received));
+    ASSERT_EQ(result.status(), OkStatus());
+    received += result->size();
+  }
+  ASSERT_EQ(received, 10u);
+  EXPECT_EQ(std::memcmp(buffer.data(), "0123456789", 10), 0);
+}
+
+TEST_F(UartStreamLinuxPtyTest, ReadTimesOutWithFewerBytes) {
+  UartStreamLinux uart;
+  ASSERT_EQ(uart.Open(device_path_,
+                      {.baud_rate = 115200,
+                       .min_read_bytes = 8,
+                       .read_timeout_deciseconds = 1}),
+            OkStatus());
+
+  // Fewer than min_read_bytes are returned once no more data arrives.
+  Send("abc");
+  std::array<std::byte, 16> buffer;
+  Result<ByteSpan> result = uart.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result->size(), 3u);
+  EXPECT_EQ(std::memcmp(buffer.data(), "abc", 3), 0);
+}
+
+TEST_F(UartStreamLinuxPtyTest, NonBlockingRead) {
+  UartStreamLinux uart;
+  ASSERT_EQ(
+      uart.Open(device_path_, {.baud_rate = 115200, .non_blocking = true}),
+      OkStatus());
+
+  std::array<std::byte, 16> buffer;
+  EXPECT_EQ(uart.Read(buffer).status(), Status::Unavailable());
+
+  Send("xyz");
+  // Wait for the data to reach the device.
+  Result<ByteSpan> result = Status::Unavailable();
+  for (int i = 0; i < 100; ++i) {
+    result = uart.Read(buffer);
+    if (!result.status().IsUnavailable()) {
+      break;
+    }
+    usleep(1000);
+  }
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result->size(), 3u);
+  EXPECT_EQ(std::memcmp(buffer.data(), "xyz", 3), 0);
+}
+
+TEST_F(UartStreamLinuxPtyTest, Write) {
+  UartStreamLinux uart;
+  ASSERT_EQ(
+      uart.Open(device_path_, {.baud_rate = 115200, .non_blocking = true}),
+      OkStatus());
+
+  constexpr char kData[] = "hello";
+  ASSERT_EQ(uart.Write(as_bytes(span(kData, 5))), OkStatus());
+
+  std::array<char, 8> received{};
+  ASSERT_EQ(read(controller_, received.data(), received.size()), 5);
+  EXPECT_EQ(std::memcmp(received.data(), kData, 5), 0);
+}
+
 }  // namespace
 }  // namespace pw::stream
\ No newline at end of file
@@ -0,0 +1,199 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/format_to.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "pw_string/type_to_string.h"
+#include "pw_string/util.h"
+
+namespace pw::string::internal {
+namespace {
+
+constexpr std::array<uint32_t, 10> kPowersOf10{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+// Writes value rounded to precision digits after the decimal point. Values
+// that are not finite, or too large for the scaled value to fit in 63 bits,
+// are written as by FloatAsIntToString().
+StatusWithSize FixedPointToString(double value,
+                                  uint_fast8_t precision,
+                                  span<char> buffer) {
+  const uint32_t scale = kPowersOf10[precision];
+  const double magnitude = std::fabs(value) * scale;
+  if (!(magnitude < 9.2e18)) {
+    return FloatAsIntToString(static_cast<float>(value), buffer);
+  }
+
+  uint64_t fraction = static_cast<uint64_t>(magnitude + 0.5);
+  const uint64_t integer = fraction / scale;
+  fraction %= scale;
+
+  const size_t sign = std::signbit(value) ? 1 : 0;
+  const size_t size = sign + DecimalDigitCount(integer) +
+                      (precision > 0u ? 1u + precision : 0u);
+  if (size >= buffer.size()) {
+    if (!buffer.empty()) {
+      buffer[0] = '\0';
+    }
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  if (sign != 0u) {
+    buffer[0] = '-';
+  }
+  IntToString(integer, buffer.subspan(sign));
+  if (precision > 0u) {
+    buffer[size - precision - 1] = '.';
+    for (size_t i = size; i > size - precision; --i) {
+      buffer[i - 1] = static_cast<char>('0' + fraction % 10);
+      fraction /= 10;
+    }
+  }
+  buffer[size] = '\0';
+  return StatusWithSize(size);
+}
+
+}  // namespace
+
+void FormatWriter::Literal(const char* data, size_t size) {
+  if (!status_.ok()) {
+    return;
+  }
+  const StatusWithSize written =
+      CopyStringOrNull(std::string_view(data, size), remaining());
+  size_ += written.size();
+  status_ = written.status();
+}
+
+void FormatWriter::Signed(int64_t value, FormatSpec spec) {
+  if (!status_.ok()) {
+    return;
+  }
+  Commit(IntToString(value, remaining()), spec);
+}
+
+void FormatWriter::Unsigned(uint64_t value, FormatSpec spec) {
+  if (!status_.ok()) {
+    return;
+  }
+  if (spec.conversion == 'u') {
+    Commit(IntToString(value, remaining()), spec);
+    return;
+  }
+
+  char* const field = remaining().data();
+  const StatusWithSize written = IntToHexString(value, remaining());
+  if (spec.conversion == 'X') {
+    for (size_t i = 0; i < written.size(); ++i) {
+      if (field[i] >= 'a') {
+        field[i] = static_cast<char>(field[i] - 'a' + 'A');
+      }
+    }
+  }
+  Commit(written, spec);
+}
+
+void FormatWriter::Char(char value, FormatSpec spec) {
+  if (!status_.ok()) {
+    return;
+  }
+  Commit(CopyEntireStringOrNull(std::string_view(&value, 1), remaining()),
+         spec);
+}
+
+void FormatWriter::String(const char* value, FormatSpec spec) {
+  if (!status_.ok()) {
+    return;
+  }
+  if (value == nullptr) {
+    Commit(PointerToString(value, remaining()), spec);
+    return;
+  }
+  size_t max_size = remaining().size();
+  if (spec.precision != FormatSpec::kNoPrecision) {
+    max_size = std::min(max_size, static_cast<size_t>(spec.precision));
+  }
+  String(ClampedCString(value, max_size), spec);
+}
+
+void FormatWriter::String(std::string_view value, FormatSpec spec) {
+  if (!status_.ok()) {
+    return;
+  }
+  if (spec.precision != FormatSpec::kNoPrecision) {
+    value = value.substr(0, static_cast<size_t>(spec.precision));
+  }
+  Commit(CopyStringOrNull(value, remaining()), spec);
+}
+
+void FormatWriter::Pointer(const void* value, FormatSpec spec) {
+  if (!status_.ok()) {
+    return;
+  }
+  Commit(PointerToString(value, remaining()), spec);
+}
+
+void FormatWriter::Float(double value, FormatSpec spec) {
+  if (!status_.ok()) {
+    return;
+  }
+  Commit(FixedPointToString(
+             value, static_cast<uint_fast8_t>(spec.precision), remaining()),
+         spec);
+}
+
+void FormatWriter::Commit(StatusWithSize written, FormatSpec spec) {
+  size_ += written.size();
+  if (!written.ok()) {
+    status_ = written.status();
+    return;
+  }
+  if (written.size() >= spec.width) {
+    return;
+  }
+
+  const size_t padding = spec.width - written.size();
+  char* const field = buffer_.data() + size_ - written.size();
+  if (size_ + padding >= buffer_.size()) {
+    // Padded fields are not split; end the output before this one.
+    size_ -= written.size();
+    field[0] = '\0';
+    status_ = Status::ResourceExhausted();
+    return;
+  }
+
+  if ((spec.flags & FormatSpec::kLeftAlign) != 0u) {
+    std::memset(field + written.size(), ' ', padding);
+  } else {
+    const size_t sign = field[0] == '-' ? 1 : 0;
+    // Like printf, only numbers are zero padded, and not "inf" or "NaN".
+    const bool zero_pad = (spec.flags & FormatSpec::kZeroPad) != 0u &&
+                          spec.conversion != 's' && spec.conversion != 'c' &&
+                          spec.conversion != 'p' &&
+                          (spec.conversion != 'f' || IsDigit(field[sign]));
+    const size_t fixed = zero_pad ? sign : 0;
+    std::memmove(
+        field + fixed + padding, field + fixed, written.size() - fixed);
+    std::memset(field + fixed, zero_pad ? '0' : ' ', padding);
+  }
+  size_ += padding;
+  buffer_[size_] = '\0';
+}
+
+}  // namespace pw::string::internal
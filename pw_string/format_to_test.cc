@@ -0,0 +1,257 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/format_to.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_compilation_testing/negative_compilation.h"
+#include "pw_span/span.h"
+
+namespace pw::string {
+namespace {
+
+// Checks that PW_FORMAT_TO matches std::snprintf for a format and arguments.
+#define EXPECT_MATCHES_SNPRINTF(format, ...)                                   \
+  do {                                                                         \
+    char expected[64];                                                         \
+    std::snprintf(expected, sizeof(expected), format, __VA_ARGS__);            \
+    char actual[64];                                                           \
+    const StatusWithSize result =                                              \
+        PW_FORMAT_TO(actual, format, __VA_ARGS__);                             \
+    EXPECT_EQ(OkStatus(), result.status());                                    \
+    EXPECT_EQ(std::string_view(expected).size(), result.size());               \
+    EXPECT_STREQ(expected, actual);                                            \
+  } while (0)
+
+TEST(FormatTo, LiteralOnly) {
+  char buffer[32];
+  const StatusWithSize result = PW_FORMAT_TO(buffer, "-_-");
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(3u, result.size());
+  EXPECT_STREQ("-_-", buffer);
+}
+
+TEST(FormatTo, EmptyFormat) {
+  char buffer[4] = {'x', 'x', 'x', 'x'};
+  const StatusWithSize result = PW_FORMAT_TO(buffer, "");
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+  EXPECT_STREQ("", buffer);
+}
+
+TEST(FormatTo, Percent) {
+  char buffer[32];
+  const StatusWithSize result = PW_FORMAT_TO(buffer, "%d%% %%done", 50);
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_STREQ("50% %done", buffer);
+}
+
+TEST(FormatTo, Integers_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%d", 0);
+  EXPECT_MATCHES_SNPRINTF("%d", -2147483647 - 1);
+  EXPECT_MATCHES_SNPRINTF("%i|%u", 42, 42u);
+  EXPECT_MATCHES_SNPRINTF("%lld", static_cast<long long>(INT64_MIN));
+  EXPECT_MATCHES_SNPRINTF("%llu", static_cast<unsigned long long>(UINT64_MAX));
+  EXPECT_MATCHES_SNPRINTF("%zu", sizeof(uint64_t));
+  EXPECT_MATCHES_SNPRINTF("%hhu", static_cast<unsigned char>(255));
+  EXPECT_MATCHES_SNPRINTF("%u", static_cast<unsigned>(-1));
+}
+
+TEST(FormatTo, Hex_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%x", 0u);
+  EXPECT_MATCHES_SNPRINTF("%x", 0xc0ffeeu);
+  EXPECT_MATCHES_SNPRINTF("%X", 0xc0ffeeu);
+  EXPECT_MATCHES_SNPRINTF("%x", static_cast<unsigned>(-42));
+  EXPECT_MATCHES_SNPRINTF("%08x", 0xbeefu);
+  EXPECT_MATCHES_SNPRINTF("%02X", 0xau);
+  EXPECT_MATCHES_SNPRINTF("%llx", 0x123456789abcdefull);
+}
+
+TEST(FormatTo, SignedValueAsHex_UsesSameSizedUnsignedType) {
+  char buffer[32];
+  const int8_t value = -1;
+  EXPECT_EQ(OkStatus(), PW_FORMAT_TO(buffer, "%x", value).status());
+  EXPECT_STREQ("ff", buffer);
+}
+
+TEST(FormatTo, Width_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("[%5d]", 42);
+  EXPECT_MATCHES_SNPRINTF("[%-5d]", 42);
+  EXPECT_MATCHES_SNPRINTF("[%05d]", -42);
+  EXPECT_MATCHES_SNPRINTF("[%2d]", 12345);
+  EXPECT_MATCHES_SNPRINTF("[%8s]", "abc");
+  EXPECT_MATCHES_SNPRINTF("[%-8s]", "abc");
+  EXPECT_MATCHES_SNPRINTF("[%3c]", 'z');
+}
+
+TEST(FormatTo, Strings_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%s", "");
+  EXPECT_MATCHES_SNPRINTF("hello %s!", "world");
+  EXPECT_MATCHES_SNPRINTF("%.3s", "abcdef");
+  EXPECT_MATCHES_SNPRINTF("%.10s", "abc");
+  EXPECT_MATCHES_SNPRINTF("%c%c", 'o', 'k');
+}
+
+TEST(FormatTo, StringView) {
+  char buffer[32];
+  constexpr std::string_view kView("abcdef", 4);
+  EXPECT_EQ(OkStatus(), PW_FORMAT_TO(buffer, "<%s>", kView).status());
+  EXPECT_STREQ("<abcd>", buffer);
+}
+
+TEST(FormatTo, NullString) {
+  char buffer[32];
+  const char* string = nullptr;
+  EXPECT_EQ(OkStatus(), PW_FORMAT_TO(buffer, "%s", string).status());
+  EXPECT_STREQ("(null)", buffer);
+}
+
+TEST(FormatTo, Pointer) {
+  char buffer[32];
+  EXPECT_EQ(OkStatus(),
+            PW_FORMAT_TO(buffer, "%p", reinterpret_cast<void*>(0x1234))
+                .status());
+  EXPECT_STREQ("1234", buffer);
+
+  EXPECT_EQ(OkStatus(), PW_FORMAT_TO(buffer, "%p", nullptr).status());
+  EXPECT_STREQ("(null)", buffer);
+}
+
+TEST(FormatTo, Float_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("%f", 0.0);
+  EXPECT_MATCHES_SNPRINTF("%f", 1.5);
+  EXPECT_MATCHES_SNPRINTF("%f", -1.5);
+  EXPECT_MATCHES_SNPRINTF("%.2f", 3.14159);
+  EXPECT_MATCHES_SNPRINTF("%.0f", 2.75);
+  EXPECT_MATCHES_SNPRINTF("%.3f", -0.0004);
+  EXPECT_MATCHES_SNPRINTF("%.1f", 1e9);
+  EXPECT_MATCHES_SNPRINTF("%8.3f", 2.5f);
+  EXPECT_MATCHES_SNPRINTF("%08.3f", -2.5f);
+}
+
+TEST(FormatTo, Float_NotFinite) {
+  char buffer[32];
+  EXPECT_EQ(OkStatus(), PW_FORMAT_TO(buffer, "%f", 1e300).status());
+  EXPECT_STREQ("inf", buffer);
+  EXPECT_EQ(OkStatus(), PW_FORMAT_TO(buffer, "%f", -1e300).status());
+  EXPECT_STREQ("-inf", buffer);
+}
+
+TEST(FormatTo, ManyArguments_MatchSnprintf) {
+  EXPECT_MATCHES_SNPRINTF("Queue %d: %u of %u used (%s, %.1f%%)",
+                          -3,
+                          1000u,
+                          4096u,
+                          "rx",
+                          24.4);
+}
+
+TEST(FormatTo, EmptyBuffer_ReturnsResourceExhausted) {
+  const StatusWithSize result = PW_FORMAT_TO(span<char>(), "?");
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST(FormatTo, LiteralLargerThanBuffer_Truncates) {
+  char buffer[5];
+  const StatusWithSize result = PW_FORMAT_TO(buffer, "2big!");
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(4u, result.size());
+  EXPECT_STREQ("2big", buffer);
+}
+
+TEST(FormatTo, StringLargerThanBuffer_Truncates) {
+  char buffer[5];
+  const StatusWithSize result = PW_FORMAT_TO(buffer, "%s", "2big!");
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(4u, result.size());
+  EXPECT_STREQ("2big", buffer);
+}
+
+TEST(FormatTo, NumberLargerThanBuffer_IsNotSplit) {
+  char buffer[8];
+  const StatusWithSize result = PW_FORMAT_TO(buffer, "n=%d, m=%d", 1, 12345);
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(7u, result.size());
+  EXPECT_STREQ("n=1, m=", buffer);
+}
+
+TEST(FormatTo, PaddingLargerThanBuffer_IsNotSplit) {
+  char buffer[8];
+  const StatusWithSize result = PW_FORMAT_TO(buffer, "ab%8d", 1);
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(2u, result.size());
+  EXPECT_STREQ("ab", buffer);
+}
+
+TEST(FormatTo, OutputAfterExhaustion_IsNotWritten) {
+  char buffer[4];
+  const StatusWithSize result = PW_FORMAT_TO(buffer, "%d%s", 12345, "x");
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(0u, result.size());
+  EXPECT_STREQ("", buffer);
+}
+
+#if defined(__cpp_nontype_template_args) && \
+    __cpp_nontype_template_args >= 201911L
+
+TEST(FormatTo, TemplateArgumentFormat) {
+  char buffer[32];
+  const StatusWithSize result = FormatTo<"%s=%d">(buffer, "x", 7);
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(3u, result.size());
+  EXPECT_STREQ("x=7", buffer);
+}
+
+#endif  // __cpp_nontype_template_args >= 201911L
+
+[[maybe_unused]] void NegativeCompilationTests() {
+  [[maybe_unused]] char buffer[16];
+#if PW_NC_TEST(TooFewArguments)
+  PW_NC_EXPECT("number of arguments does not match");
+  PW_FORMAT_TO(buffer, "%d %d", 1);
+#elif PW_NC_TEST(TooManyArguments)
+  PW_NC_EXPECT("number of arguments does not match");
+  PW_FORMAT_TO(buffer, "%d", 1, 2);
+#elif PW_NC_TEST(WrongArgumentType)
+  PW_NC_EXPECT("type does not match its conversion");
+  PW_FORMAT_TO(buffer, "%d", "one");
+#elif PW_NC_TEST(UnsupportedConversion)
+  PW_NC_EXPECT("unsupported conversion");
+  PW_FORMAT_TO(buffer, "%e", 1.0);
+#elif PW_NC_TEST(IncompleteConversion)
+  PW_NC_EXPECT("ends in the middle of a conversion");
+  PW_FORMAT_TO(buffer, "100%");
+#elif PW_NC_TEST(PrecisionForInteger)
+  PW_NC_EXPECT("precision may only be given");
+  PW_FORMAT_TO(buffer, "%.2d", 1);
+#endif  // PW_NC_TEST
+}
+
+}  // namespace
+}  // namespace pw::string
@@ -0,0 +1,463 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+/// @file pw_string/format_to.h
+///
+/// `PW_FORMAT_TO` and `pw::string::FormatTo` write printf-style formatted
+/// strings without `std::vsnprintf`. The format string is parsed at compile
+/// time, so a format string that does not match its arguments fails to
+/// compile, and each conversion becomes a direct call to the
+/// `pw_string/type_to_string.h` routine for that type.
+///
+/// The supported syntax is `%[flags][width][.precision][length]conversion`:
+///
+/// - Conversions: `d`, `i`, `u`, `x`, `X`, `c`, `s`, `p`, `f` and `%%`.
+/// - Flags: `-` (left align) and `0` (pad numbers with zeroes).
+/// - Precision: digits after the point for `f` (default 6, at most 9), or the
+///   maximum number of characters for `s`.
+/// - Length modifiers (`hh`, `h`, `l`, `ll`, `z`, `j`, `t`) are accepted and
+///   ignored, since the argument types are known.
+///
+/// `*` widths and other conversions are rejected at compile time.
+///
+/// Results follow `pw::string::Format()`, except that numbers and padded fields
+/// are never split: if one does not fit, the output stops before it.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "pw_preprocessor/arguments.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+/// Writes a printf-style formatted string to a `pw::span<char>`, parsing the
+/// format string literal at compile time.
+///
+/// @code{.cpp}
+///   char buffer[32];
+///   pw::StatusWithSize result =
+///       PW_FORMAT_TO(buffer, "Queue %d: %u of %u used", id, used, size);
+/// @endcode
+///
+/// @returns See `pw::string::Format()`.
+#define PW_FORMAT_TO(buffer, format, ...)                                      \
+  [&] {                                                                        \
+    struct PwFormatString {                                                    \
+      static constexpr std::string_view Get() { return format; }               \
+    };                                                                         \
+    return ::pw::string::internal::FormatTo<PwFormatString>(                   \
+        buffer PW_COMMA_ARGS(__VA_ARGS__));                                    \
+  }()
+
+namespace pw::string {
+namespace internal {
+
+// One conversion parsed from a format string. Kept to 4 bytes so that it is
+// passed to the appenders in a register.
+struct FormatSpec {
+  static constexpr uint8_t kLeftAlign = 1u << 0;
+  static constexpr uint8_t kZeroPad = 1u << 1;
+  static constexpr int8_t kNoPrecision = -1;
+
+  char conversion = '\0';
+  uint8_t flags = 0;
+  uint8_t width = 0;
+  int8_t precision = kNoPrecision;
+};
+
+enum class FormatError {
+  kNone,
+  kIncompleteConversion,
+  kUnsupportedConversion,
+  kWidthTooLarge,
+  kPrecisionTooLarge,
+  kPrecisionNotSupported,
+};
+
+// A literal run of the format string followed by the conversion after it. The
+// final segment has no conversion.
+struct FormatSegment {
+  size_t literal_begin = 0;
+  size_t literal_size = 0;
+  FormatSpec spec;
+};
+
+constexpr bool IsDigit(char c) { return '0' <= c && c <= '9'; }
+
+constexpr bool ConsumesArgument(char conversion) {
+  return conversion != '\0' && conversion != '%';
+}
+
+// Parses the conversion starting at the '%' at format[index], storing it in
+// spec and returning the index after it, or setting error.
+constexpr size_t ParseConversion(std::string_view format,
+                                 size_t index,
+                                 FormatSpec& spec,
+                                 FormatError& error) {
+  constexpr size_t kMaxWidth = 255;
+  constexpr size_t kMaxPrecision = 99;
+  ++index;  // Skip the '%'.
+
+  for (; index < format.size(); ++index) {
+    if (format[index] == '-') {
+      spec.flags |= FormatSpec::kLeftAlign;
+    } else if (format[index] == '0') {
+      spec.flags |= FormatSpec::kZeroPad;
+    } else {
+      break;
+    }
+  }
+
+  size_t width = 0;
+  for (; index < format.size() && IsDigit(format[index]); ++index) {
+    width = width * 10 + static_cast<size_t>(format[index] - '0');
+    if (width > kMaxWidth) {
+      error = FormatError::kWidthTooLarge;
+      return index;
+    }
+  }
+  spec.width = static_cast<uint8_t>(width);
+
+  if (index < format.size() && format[index] == '.') {
+    size_t precision = 0;
+    for (++index; index < format.size() && IsDigit(format[index]); ++index) {
+      precision = precision * 10 + static_cast<size_t>(format[index] - '0');
+      if (precision > kMaxPrecision) {
+        error = FormatError::kPrecisionTooLarge;
+        return index;
+      }
+    }
+    spec.precision = static_cast<int8_t>(precision);
+  }
+
+  for (; index < format.size(); ++index) {
+    const char c = format[index];
+    if (c != 'h' && c != 'l' && c != 'z' && c != 'j' && c != 't') {
+      break;
+    }
+  }
+
+  if (index == format.size()) {
+    error = FormatError::kIncompleteConversion;
+    return index;
+  }
+
+  spec.conversion = format[index];
+  switch (spec.conversion) {
+    case 'f':
+      if (spec.precision == FormatSpec::kNoPrecision) {
+        spec.precision = 6;
+      } else if (spec.precision > 9) {
+        error = FormatError::kPrecisionTooLarge;
+      }
+      break;
+    case 's':
+      break;
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'c':
+    case 'p':
+    case '%':
+      if (spec.precision != FormatSpec::kNoPrecision) {
+        error = FormatError::kPrecisionNotSupported;
+      }
+      break;
+    default:
+      error = FormatError::kUnsupportedConversion;
+  }
+  return index + 1;
+}
+
+// The parsed form of a format string: kSegmentCount segments, the last of
+// which is only a literal.
+template <size_t kSegmentCount>
+struct ParsedFormat {
+  std::array<FormatSegment, kSegmentCount> segments;
+  std::array<size_t, kSegmentCount> argument_index;
+  size_t argument_count = 0;
+  FormatError error = FormatError::kNone;
+};
+
+constexpr size_t CountSegments(std::string_view format) {
+  size_t count = 1;
+  for (size_t i = 0; i < format.size(); ++i) {
+    if (format[i] == '%') {
+      FormatSpec spec;
+      FormatError error = FormatError::kNone;
+      i = ParseConversion(format, i, spec, error) - 1;
+      if (error != FormatError::kNone) {
+        return count + 1;  // Include the invalid conversion to report it.
+      }
+      count += 1;
+    }
+  }
+  return count;
+}
+
+template <size_t kSegmentCount>
+constexpr ParsedFormat<kSegmentCount> ParseFormat(std::string_view format) {
+  ParsedFormat<kSegmentCount> parsed{};
+  size_t segment = 0;
+  size_t literal_begin = 0;
+
+  for (size_t i = 0; i < format.size() && segment < kSegmentCount - 1;) {
+    if (format[i] != '%') {
+      ++i;
+      continue;
+    }
+    FormatSegment& current = parsed.segments[segment];
+    current.literal_begin = literal_begin;
+    current.literal_size = i - literal_begin;
+    i = ParseConversion(format, i, current.spec, parsed.error);
+    if (parsed.error != FormatError::kNone) {
+      return parsed;
+    }
+    parsed.argument_index[segment] = parsed.argument_count;
+    if (ConsumesArgument(current.spec.conversion)) {
+      parsed.argument_count += 1;
+    }
+    literal_begin = i;
+    segment += 1;
+  }
+
+  FormatSegment& last = parsed.segments[kSegmentCount - 1];
+  last.literal_begin = literal_begin;
+  last.literal_size = format.size() - literal_begin;
+  return parsed;
+}
+
+template <typename T>
+constexpr bool ArgumentMatches(char conversion) {
+  using Arg = std::remove_cv_t<std::remove_reference_t<T>>;
+  switch (conversion) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'c':
+      return std::is_integral_v<Arg>;
+    case 's':
+      return std::is_convertible_v<const Arg&, std::string_view> ||
+             std::is_same_v<std::decay_t<Arg>, char*> ||
+             std::is_same_v<std::decay_t<Arg>, const char*>;
+    case 'p':
+      return std::is_pointer_v<std::decay_t<Arg>> ||
+             std::is_null_pointer_v<Arg>;
+    case 'f':
+      return std::is_floating_point_v<Arg>;
+    default:
+      return false;
+  }
+}
+
+// Accumulates formatted output in a buffer. The appenders are out of line and
+// shared by every format string, so each FormatTo() call site only costs the
+// calls themselves. Once the output is truncated, the appenders do nothing.
+class FormatWriter {
+ public:
+  explicit FormatWriter(span<char> buffer) : buffer_(buffer) {
+    if (buffer_.empty()) {
+      status_ = Status::ResourceExhausted();
+    } else {
+      buffer_[0] = '\0';
+    }
+  }
+
+  void Literal(const char* data, size_t size);
+  void Signed(int64_t value, FormatSpec spec);
+  void Unsigned(uint64_t value, FormatSpec spec);
+  void Char(char value, FormatSpec spec);
+  void String(const char* value, FormatSpec spec);
+  void String(std::string_view value, FormatSpec spec);
+  void Pointer(const void* value, FormatSpec spec);
+  void Float(double value, FormatSpec spec);
+
+  StatusWithSize result() const { return StatusWithSize(status_, size_); }
+
+ private:
+  span<char> remaining() const { return buffer_.subspan(size_); }
+
+  // Records a field written at the end of the output, padding it to the spec's
+  // width.
+  void Commit(StatusWithSize written, FormatSpec spec);
+
+  span<char> buffer_;
+  size_t size_ = 0;
+  Status status_;
+};
+
+// The compile-time results of parsing a format string.
+template <typename FormatString>
+struct CompiledFormat {
+  static constexpr std::string_view kFormat = FormatString::Get();
+  static constexpr size_t kSegmentCount = CountSegments(kFormat);
+  static constexpr ParsedFormat<kSegmentCount> kParsed =
+      ParseFormat<kSegmentCount>(kFormat);
+};
+
+template <char kConversion, typename T>
+void AppendArgument(FormatWriter& writer, FormatSpec spec, const T& value) {
+  using Arg = std::remove_cv_t<T>;
+  if constexpr (kConversion == 'c') {
+    writer.Char(static_cast<char>(value), spec);
+  } else if constexpr (kConversion == 'd' || kConversion == 'i') {
+    writer.Signed(static_cast<int64_t>(value), spec);
+  } else if constexpr (kConversion == 'u' || kConversion == 'x' ||
+                       kConversion == 'X') {
+    // Like printf, reinterpret signed values as the same-sized unsigned type.
+    using Unsigned = std::make_unsigned_t<
+        std::conditional_t<std::is_same_v<Arg, bool>, unsigned char, Arg>>;
+    writer.Unsigned(static_cast<uint64_t>(static_cast<Unsigned>(value)), spec);
+  } else if constexpr (kConversion == 'f') {
+    writer.Float(static_cast<double>(value), spec);
+  } else if constexpr (kConversion == 's') {
+    if constexpr (std::is_pointer_v<std::decay_t<Arg>>) {
+      writer.String(static_cast<const char*>(value), spec);
+    } else {
+      writer.String(std::string_view(value), spec);
+    }
+  } else if constexpr (std::is_null_pointer_v<Arg>) {
+    writer.Pointer(nullptr, spec);
+  } else {
+    writer.Pointer(static_cast<const void*>(value), spec);
+  }
+}
+
+template <typename FormatString, size_t kIndex, typename Arguments>
+void AppendSegment(FormatWriter& writer, const Arguments& arguments) {
+  using Format = CompiledFormat<FormatString>;
+  constexpr FormatSegment kSegment = Format::kParsed.segments[kIndex];
+  constexpr FormatSpec kSpec = kSegment.spec;
+
+  if constexpr (kSegment.literal_size > 0u) {
+    writer.Literal(Format::kFormat.data() + kSegment.literal_begin,
+                   kSegment.literal_size);
+  }
+
+  if constexpr (kSpec.conversion == '%') {
+    writer.Literal("%", 1);
+  } else {
+    constexpr size_t kArgument = Format::kParsed.argument_index[kIndex];
+    using Arg = std::remove_cv_t<std::remove_reference_t<
+        std::tuple_element_t<kArgument, Arguments>>>;
+    static_assert(ArgumentMatches<Arg>(kSpec.conversion),
+                  "An argument's type does not match its conversion");
+    AppendArgument<kSpec.conversion>(
+        writer, kSpec, std::get<kArgument>(arguments));
+  }
+}
+
+template <typename FormatString, typename Arguments, size_t... kIndices>
+void AppendSegments(FormatWriter& writer,
+                    const Arguments& arguments,
+                    std::index_sequence<kIndices...>) {
+  (AppendSegment<FormatString, kIndices>(writer, arguments), ...);
+}
+
+template <typename FormatString, typename... Args>
+StatusWithSize FormatTo(span<char> buffer, const Args&... args) {
+  using Format = CompiledFormat<FormatString>;
+  constexpr FormatError kError = Format::kParsed.error;
+
+  static_assert(kError != FormatError::kIncompleteConversion,
+                "The format string ends in the middle of a conversion");
+  static_assert(kError != FormatError::kUnsupportedConversion,
+                "The format string uses an unsupported conversion");
+  static_assert(kError != FormatError::kWidthTooLarge,
+                "Format widths may be at most 255");
+  static_assert(kError != FormatError::kPrecisionTooLarge,
+                "Format precisions may be at most 9 for %f and 99 for %s");
+  static_assert(kError != FormatError::kPrecisionNotSupported,
+                "A precision may only be given for %f and %s");
+  static_assert(kError != FormatError::kNone ||
+                    Format::kParsed.argument_count == sizeof...(Args),
+                "The number of arguments does not match the format string");
+
+  if constexpr (kError != FormatError::kNone ||
+                Format::kParsed.argument_count != sizeof...(Args)) {
+    return StatusWithSize::InvalidArgument();
+  } else {
+    FormatWriter writer(buffer);
+    const std::tuple<const Args&...> arguments(args...);
+    AppendSegments<FormatString>(
+        writer,
+        arguments,
+        std::make_index_sequence<Format::kSegmentCount - 1>());
+
+    constexpr FormatSegment kLast =
+        Format::kParsed.segments[Format::kSegmentCount - 1];
+    if constexpr (kLast.literal_size > 0u) {
+      writer.Literal(Format::kFormat.data() + kLast.literal_begin,
+                     kLast.literal_size);
+    }
+    return writer.result();
+  }
+}
+
+}  // namespace internal
+
+#if defined(__cpp_nontype_template_args) && \
+    __cpp_nontype_template_args >= 201911L
+
+namespace internal {
+
+// Holds a string literal as a template argument. Only used by FormatTo().
+template <size_t kSize>
+struct FormatStringLiteral {
+  constexpr FormatStringLiteral(const char (&string)[kSize]) {
+    for (size_t i = 0; i < kSize; ++i) {
+      chars[i] = string[i];
+    }
+  }
+
+  char chars[kSize];
+};
+
+template <FormatStringLiteral kFormat>
+struct FormatStringConstant {
+  static constexpr std::string_view Get() {
+    return std::string_view(kFormat.chars, sizeof(kFormat.chars) - 1);
+  }
+};
+
+}  // namespace internal
+
+/// Writes a printf-style formatted string to the provided buffer. The same as
+/// `PW_FORMAT_TO`, for C++20 and newer.
+///
+/// @code{.cpp}
+///   pw::string::FormatTo<"Queue %d: %u of %u used">(buffer, id, used, size);
+/// @endcode
+///
+/// @returns See `pw::string::Format()`.
+template <internal::FormatStringLiteral kFormat, typename... Args>
+StatusWithSize FormatTo(span<char> buffer, const Args&... args) {
+  return internal::FormatTo<internal::FormatStringConstant<kFormat>>(buffer,
+                                                                     args...);
+}
+
+#endif  // __cpp_nontype_template_args >= 201911L
+
+}  // namespace pw::string
@@ -25,11 +25,25 @@
 #define PW_STRING_ENABLE_DECIMAL_FLOAT_EXPANSION 0
 #endif
 
+// PW_STRING_ENABLE_SHORTEST_FLOAT_TO_STRING controls whether floating point
+// values passed to the ToString function are written as the shortest string
+// that round-trips to the same float, using pw::string::FloatToString. This
+// takes precedence over PW_STRING_ENABLE_DECIMAL_FLOAT_EXPANSION. Unlike
+// decimal float expansion, it does not use snprintf, but it adds about 2 KB of
+// code and tables. Doubles are converted to float before they are written.
+#ifndef PW_STRING_ENABLE_SHORTEST_FLOAT_TO_STRING
+#define PW_STRING_ENABLE_SHORTEST_FLOAT_TO_STRING 0
+#endif
+
 namespace pw::string::internal::config {
 
 constexpr bool kEnableDecimalFloatExpansion =
     PW_STRING_ENABLE_DECIMAL_FLOAT_EXPANSION;
 
+constexpr bool kEnableShortestFloatToString =
+    PW_STRING_ENABLE_SHORTEST_FLOAT_TO_STRING;
+
 }
 
 #undef PW_STRING_ENABLE_DECIMAL_FLOAT_EXPANSION
+#undef PW_STRING_ENABLE_SHORTEST_FLOAT_TO_STRING
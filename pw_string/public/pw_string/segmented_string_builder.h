@@ -0,0 +1,239 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+#include "pw_allocator/block_pool.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+#include "pw_string/to_string.h"
+
+namespace pw {
+
+/// @class SegmentedStringBuilder
+///
+/// `pw::SegmentedStringBuilder` builds a string in a chain of fixed-size
+/// segments drawn from a `pw::allocator::BlockPool`, rather than in one
+/// contiguous buffer. It supports the same `<<`, `append`, and `Format`
+/// operations as `pw::StringBuilder`.
+///
+/// Large text output does not need a buffer sized for the worst case:
+///
+/// - Without a writer, segments are chained as the string grows, up to the
+///   capacity of the pool. The result is read with `ForEachSegment`,
+///   `WriteTo`, or `CopyTo`.
+/// - With a `pw::stream::Writer`, each segment is written out as soon as it
+///   fills and is then reused, so at most one segment is ever held. Call
+///   `Flush` to write the final, partially filled segment.
+///
+/// Strings are split across segments, but values written with `<<` and
+/// `Format` are not. If a value does not fit in the rest of the current
+/// segment, it is written to the start of the next one. Since conversions
+/// null terminate their output, a value must be shorter than
+/// `segment_capacity()`; longer values set the status to `RESOURCE_EXHAUSTED`
+/// and are not written.
+///
+/// @code{.cpp}
+///   pw::allocator::FixedBytePool<128, 4> pool;
+///
+///   void DumpMetrics(pw::stream::Writer& uart) {
+///     pw::SegmentedStringBuilder sb(pool, uart);
+///     for (const Metric& metric : metrics) {
+///       sb << metric.name() << ": " << metric.value() << '\n';
+///     }
+///     sb.Flush();
+///   }
+/// @endcode
+///
+/// Like `pw::StringBuilder`, status is tracked for each operation, and an
+/// overall status reflects the most recent error.
+class SegmentedStringBuilder {
+ public:
+  /// Creates a builder that chains segments from `pool`. Blocks must be larger
+  /// than the per-segment header, `kSegmentOverhead`.
+  explicit SegmentedStringBuilder(allocator::BlockPool& pool)
+      : SegmentedStringBuilder(pool, nullptr) {}
+
+  /// Creates a builder that writes each segment to `writer` as it fills.
+  SegmentedStringBuilder(allocator::BlockPool& pool, stream::Writer& writer)
+      : SegmentedStringBuilder(pool, &writer) {}
+
+  SegmentedStringBuilder(const SegmentedStringBuilder&) = delete;
+  SegmentedStringBuilder& operator=(const SegmentedStringBuilder&) = delete;
+
+  /// Returns all segments to the pool. Unflushed output is discarded.
+  ~SegmentedStringBuilder() { clear(); }
+
+  /// Bytes of each pool block used for bookkeeping.
+  static constexpr size_t kSegmentOverhead = 2 * sizeof(void*);
+
+  /// Total number of characters appended, including those already flushed.
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0u; }
+
+  /// Number of characters each segment holds.
+  size_t segment_capacity() const { return segment_capacity_; }
+
+  /// The overall status, which reflects the most recent error.
+  Status status() const { return status_; }
+
+  /// The status of the most recent operation.
+  Status last_status() const { return last_status_; }
+
+  bool ok() const { return status_.ok(); }
+
+  /// Returns all segments to the pool and resets the size and status.
+  void clear();
+
+  void clear_status() {
+    status_ = OkStatus();
+    last_status_ = OkStatus();
+  }
+
+  void push_back(char ch) { append(1, ch); }
+
+  /// Appends `count` copies of `ch`.
+  SegmentedStringBuilder& append(size_t count, char ch);
+
+  /// Appends characters, splitting them across segments as needed. If the
+  /// pool runs out of blocks, the string is truncated and the status is
+  /// `RESOURCE_EXHAUSTED`.
+  SegmentedStringBuilder& append(const char* str, size_t count);
+
+  SegmentedStringBuilder& append(const std::string_view& str) {
+    return append(str.data(), str.size());
+  }
+
+  /// Appends a value using the same `ToString` conversions as
+  /// `pw::StringBuilder`.
+  template <typename T>
+  SegmentedStringBuilder& operator<<(const T& value) {
+    if constexpr (std::is_convertible_v<T, std::string_view>) {
+      append(value);
+    } else {
+      // A captureless lambda keeps the segment handling out of the template.
+      WriteValue(
+          [](const void* item, span<char> buffer) {
+            return ToString(*static_cast<const T*>(item), buffer);
+          },
+          &value);
+    }
+    return *this;
+  }
+
+  SegmentedStringBuilder& operator<<(bool value) {
+    return append(value ? "true" : "false");
+  }
+
+  SegmentedStringBuilder& operator<<(char value) {
+    push_back(value);
+    return *this;
+  }
+
+  SegmentedStringBuilder& operator<<(std::nullptr_t) {
+    return append(string::kNullPointerString);
+  }
+
+  SegmentedStringBuilder& operator<<(Status status) {
+    return append(status.str());
+  }
+
+  /// Appends a `printf`-style string. Like other values, the formatted string
+  /// is not split across segments. If it does not fit in a segment, it is
+  /// truncated and the status is `RESOURCE_EXHAUSTED`.
+  PW_PRINTF_FORMAT(2, 3)
+  SegmentedStringBuilder& Format(const char* format, ...);
+
+  PW_PRINTF_FORMAT(2, 0)
+  SegmentedStringBuilder& FormatVaList(const char* format, va_list args);
+
+  /// Writes the current segment to the writer and empties it. Returns the
+  /// overall status. Without a writer, returns `FAILED_PRECONDITION`.
+  Status Flush();
+
+  /// Calls `function(std::string_view)` for each segment, in order. With a
+  /// writer, only the unflushed segment remains.
+  template <typename Function>
+  void ForEachSegment(Function&& function) const {
+    for (const Segment* segment = head_; segment != nullptr;
+         segment = segment->next) {
+      function(std::string_view(segment->data(), segment->size));
+    }
+  }
+
+  /// Writes the segments to `writer` without releasing them.
+  Status WriteTo(stream::Writer& writer) const;
+
+  /// Copies the segments into a contiguous, null-terminated buffer. Like
+  /// `pw::string::Copy`, truncates and returns `RESOURCE_EXHAUSTED` if the
+  /// string does not fit.
+  StatusWithSize CopyTo(span<char> buffer) const;
+
+ private:
+  // Bookkeeping at the start of each block, followed by the characters.
+  struct Segment {
+    Segment* next;
+    size_t size;
+
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+    const char* data() const {
+      return reinterpret_cast<const char*>(this + 1);
+    }
+  };
+  static_assert(sizeof(Segment) == kSegmentOverhead);
+
+  using ValueWriter = StatusWithSize (*)(const void*, span<char>);
+
+  SegmentedStringBuilder(allocator::BlockPool& pool, stream::Writer* writer);
+
+  // Returns the unused part of the current segment, allocating or flushing
+  // to make room if it is full. Returns an empty span if that fails.
+  span<char> Available();
+
+  // Moves to an empty segment by flushing the current one to the writer or
+  // chaining a new one from the pool.
+  bool NextSegment();
+
+  // Writes the current segment to the writer and empties it.
+  bool WriteSegment();
+
+  void WriteValue(ValueWriter write, const void* value);
+
+  void Commit(StatusWithSize written);
+
+  void SetErrorStatus(Status status) {
+    last_status_ = status;
+    status_ = status;
+  }
+
+  allocator::BlockPool& pool_;
+  stream::Writer* const writer_;
+  const size_t segment_capacity_;
+
+  Segment* head_ = nullptr;
+  Segment* tail_ = nullptr;
+  size_t size_ = 0;
+
+  Status status_;
+  Status last_status_;
+};
+
+}  // namespace pw
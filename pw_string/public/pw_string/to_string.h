@@ -77,7 +77,10 @@ StatusWithSize ToString(const T& value, span<char> buffer) {
   } else if constexpr (std::is_enum_v<T>) {
     return string::IntToString(std::underlying_type_t<T>(value), buffer);
   } else if constexpr (std::is_floating_point_v<T>) {
-    if constexpr (string::internal::config::kEnableDecimalFloatExpansion) {
+    if constexpr (string::internal::config::kEnableShortestFloatToString) {
+      return string::FloatToString(static_cast<float>(value), buffer);
+    } else if constexpr (string::internal::config::
+                             kEnableDecimalFloatExpansion) {
       // TODO(hepler): Look into using the float overload of std::to_chars when
       // it is available.
       return string::Format(buffer, "%.3f", value);
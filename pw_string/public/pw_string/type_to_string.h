@@ -99,6 +99,27 @@ StatusWithSize IntToHexString(uint64_t value,
 //
 StatusWithSize FloatAsIntToString(float value, span<char> buffer);
 
+// Writes the shortest decimal string that parses back to exactly the same
+// float. Like std::to_chars, fixed notation is used unless scientific notation
+// is shorter. "inf" and "NaN" are written as by FloatAsIntToString. Returns the
+// number of characters written, excluding the null terminator, and the status.
+//
+// Numbers are never truncated; if the entire number does not fit, only a null
+// terminator is written and the status is RESOURCE_EXHAUSTED. A 15-character
+// buffer fits any float, including the null terminator.
+//
+// Unlike snprintf("%g"), this uses no floating point arithmetic and no
+// big-integer arithmetic, so it is fast and small on targets without an FPU.
+//
+// Examples:
+//
+//   FloatToString(1.25f, buffer)   -> writes "1.25" to the buffer
+//   FloatToString(0.1f, buffer)    -> writes "0.1" to the buffer
+//   FloatToString(-3e-7f, buffer)  -> writes "-3e-07" to the buffer
+//   FloatToString(1e10f, buffer)   -> writes "1e+10" to the buffer
+//
+StatusWithSize FloatToString(float value, span<char> buffer);
+
 // Writes a bool as "true" or "false". Semantics match CopyEntireString.
 StatusWithSize BoolToString(bool value, span<char> buffer);
 
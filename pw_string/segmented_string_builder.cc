@@ -0,0 +1,216 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/segmented_string_builder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
+#include "pw_status/try.h"
+#include "pw_string/format.h"
+#include "pw_string/util.h"
+
+namespace pw {
+
+SegmentedStringBuilder::SegmentedStringBuilder(allocator::BlockPool& pool,
+                                               stream::Writer* writer)
+    : pool_(pool),
+      writer_(writer),
+      segment_capacity_(pool.block_size() - sizeof(Segment)) {
+  // Each block must hold the segment header and at least one character.
+  PW_ASSERT(pool.block_size() > sizeof(Segment));
+}
+
+void SegmentedStringBuilder::clear() {
+  while (head_ != nullptr) {
+    Segment* next = head_->next;
+    pool_.Free(head_);
+    head_ = next;
+  }
+  tail_ = nullptr;
+  size_ = 0;
+  clear_status();
+}
+
+SegmentedStringBuilder& SegmentedStringBuilder::append(size_t count, char ch) {
+  last_status_ = OkStatus();
+  while (count > 0u) {
+    const span<char> available = Available();
+    if (available.empty()) {
+      break;
+    }
+    const size_t chunk = std::min(count, available.size());
+    std::memset(available.data(), ch, chunk);
+    tail_->size += chunk;
+    size_ += chunk;
+    count -= chunk;
+  }
+  return *this;
+}
+
+SegmentedStringBuilder& SegmentedStringBuilder::append(const char* str,
+                                                       size_t count) {
+  last_status_ = OkStatus();
+  while (count > 0u) {
+    const span<char> available = Available();
+    if (available.empty()) {
+      break;
+    }
+    const size_t chunk = std::min(count, available.size());
+    std::memcpy(available.data(), str, chunk);
+    tail_->size += chunk;
+    size_ += chunk;
+    str += chunk;
+    count -= chunk;
+  }
+  return *this;
+}
+
+SegmentedStringBuilder& SegmentedStringBuilder::Format(const char* format,
+                                                       ...) {
+  va_list args;
+  va_start(args, format);
+  FormatVaList(format, args);
+  va_end(args);
+  return *this;
+}
+
+SegmentedStringBuilder& SegmentedStringBuilder::FormatVaList(
+    const char* format, va_list args) {
+  // The arguments may be needed twice if the output moves to a new segment.
+  va_list retry_args;
+  va_copy(retry_args, args);
+
+  span<char> available = Available();
+  if (!available.empty()) {
+    StatusWithSize written = string::FormatVaList(available, format, args);
+    if (written.IsResourceExhausted() && tail_->size != 0u && NextSegment()) {
+      written = string::FormatVaList(Available(), format, retry_args);
+    }
+    Commit(written);
+  }
+
+  va_end(retry_args);
+  return *this;
+}
+
+Status SegmentedStringBuilder::Flush() {
+  if (writer_ == nullptr) {
+    SetErrorStatus(Status::FailedPrecondition());
+  } else {
+    WriteSegment();
+  }
+  return status_;
+}
+
+Status SegmentedStringBuilder::WriteTo(stream::Writer& writer) const {
+  for (const Segment* segment = head_; segment != nullptr;
+       segment = segment->next) {
+    PW_TRY(writer.Write(as_bytes(span(segment->data(), segment->size))));
+  }
+  return OkStatus();
+}
+
+StatusWithSize SegmentedStringBuilder::CopyTo(span<char> buffer) const {
+  if (buffer.empty()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  size_t copied = 0;
+  for (const Segment* segment = head_; segment != nullptr;
+       segment = segment->next) {
+    const StatusWithSize result =
+        string::Copy(std::string_view(segment->data(), segment->size),
+                     buffer.subspan(copied));
+    copied += result.size();
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), copied);
+    }
+  }
+  buffer[copied] = '\0';
+  return StatusWithSize(copied);
+}
+
+span<char> SegmentedStringBuilder::Available() {
+  if (tail_ == nullptr || tail_->size == segment_capacity_) {
+    if (!NextSegment()) {
+      return {};
+    }
+  }
+  return {tail_->data() + tail_->size, segment_capacity_ - tail_->size};
+}
+
+bool SegmentedStringBuilder::WriteSegment() {
+  if (tail_ == nullptr || tail_->size == 0u) {
+    return true;
+  }
+  const Status status =
+      writer_->Write(as_bytes(span(tail_->data(), tail_->size)));
+  // The segment is emptied even if the write fails, so that later output is
+  // not stuck behind it.
+  tail_->size = 0;
+  if (!status.ok()) {
+    SetErrorStatus(status);
+    return false;
+  }
+  return true;
+}
+
+bool SegmentedStringBuilder::NextSegment() {
+  if (writer_ != nullptr && tail_ != nullptr) {
+    // Reuse the only segment once its contents are written out.
+    return WriteSegment();
+  }
+
+  Segment* segment = static_cast<Segment*>(pool_.Allocate());
+  if (segment == nullptr) {
+    SetErrorStatus(Status::ResourceExhausted());
+    return false;
+  }
+  segment->next = nullptr;
+  segment->size = 0;
+  if (tail_ == nullptr) {
+    head_ = segment;
+  } else {
+    tail_->next = segment;
+  }
+  tail_ = segment;
+  return true;
+}
+
+void SegmentedStringBuilder::WriteValue(ValueWriter write, const void* value) {
+  span<char> available = Available();
+  if (available.empty()) {
+    return;
+  }
+  StatusWithSize written = write(value, available);
+  if (written.IsResourceExhausted() && tail_->size != 0u && NextSegment()) {
+    // Values are not split; retry at the start of an empty segment.
+    written = write(value, Available());
+  }
+  Commit(written);
+}
+
+void SegmentedStringBuilder::Commit(StatusWithSize written) {
+  last_status_ = written.status();
+  if (!written.ok()) {
+    status_ = written.status();
+  }
+  // Like pw::StringBuilder, keep whatever a truncated Format call wrote.
+  tail_->size += written.size();
+  size_ += written.size();
+}
+
+}  // namespace pw
@@ -0,0 +1,199 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/segmented_string_builder.h"
+
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw {
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+// Each block holds 8 characters after the segment header.
+constexpr size_t kSegmentSize = 8;
+constexpr size_t kBlockSize =
+    SegmentedStringBuilder::kSegmentOverhead + kSegmentSize;
+
+class SegmentedStringBuilderTest : public ::testing::Test {
+ protected:
+  // Returns the builder's contents as a contiguous string.
+  std::string_view Contents(const SegmentedStringBuilder& sb) {
+    const StatusWithSize result = sb.CopyTo(contents_);
+    EXPECT_EQ(OkStatus(), result.status());
+    return std::string_view(contents_, result.size());
+  }
+
+  allocator::FixedBytePool<kBlockSize, 4, false, alignof(void*)> pool_;
+  char contents_[64];
+};
+
+TEST_F(SegmentedStringBuilderTest, Empty) {
+  SegmentedStringBuilder sb(pool_);
+  EXPECT_TRUE(sb.empty());
+  EXPECT_EQ(OkStatus(), sb.status());
+  EXPECT_EQ(kSegmentSize, sb.segment_capacity());
+  EXPECT_EQ(""sv, Contents(sb));
+  EXPECT_EQ(pool_.capacity(), pool_.available());
+}
+
+TEST_F(SegmentedStringBuilderTest, Append_SplitsAcrossSegments) {
+  SegmentedStringBuilder sb(pool_);
+  sb.append("The quick brown fox"sv);
+
+  EXPECT_EQ(OkStatus(), sb.status());
+  EXPECT_EQ(19u, sb.size());
+  EXPECT_EQ("The quick brown fox"sv, Contents(sb));
+  EXPECT_EQ(pool_.capacity() - 3, pool_.available());
+
+  size_t segments = 0;
+  sb.ForEachSegment([&segments](std::string_view segment) {
+    EXPECT_LE(segment.size(), kSegmentSize);
+    ++segments;
+  });
+  EXPECT_EQ(3u, segments);
+}
+
+TEST_F(SegmentedStringBuilderTest, AppendCount_SplitsAcrossSegments) {
+  SegmentedStringBuilder sb(pool_);
+  sb.append(10, '-');
+  sb.push_back('>');
+
+  EXPECT_EQ(OkStatus(), sb.status());
+  EXPECT_EQ("---------->"sv, Contents(sb));
+}
+
+TEST_F(SegmentedStringBuilderTest, Values_AreNotSplit) {
+  SegmentedStringBuilder sb(pool_);
+  sb << "abcde" << 123456 << ' ' << true;
+
+  EXPECT_EQ(OkStatus(), sb.status());
+  EXPECT_EQ("abcde123456 true"sv, Contents(sb));
+
+  std::string_view first;
+  sb.ForEachSegment([&first](std::string_view segment) {
+    if (first.empty()) {
+      first = segment;
+    }
+  });
+  EXPECT_EQ("abcde"sv, first);
+}
+
+TEST_F(SegmentedStringBuilderTest, ValueTooLargeForSegment) {
+  SegmentedStringBuilder sb(pool_);
+  sb << "x" << 123456789u << "y";
+
+  EXPECT_EQ(Status::ResourceExhausted(), sb.status());
+  EXPECT_EQ(OkStatus(), sb.last_status());
+  EXPECT_EQ("xy"sv, Contents(sb));
+}
+
+TEST_F(SegmentedStringBuilderTest, Format) {
+  SegmentedStringBuilder sb(pool_);
+  sb.Format("%d%s", 12, "ab");
+  sb.Format("[%04x]", 0xbeefu);
+
+  EXPECT_EQ(OkStatus(), sb.status());
+  EXPECT_EQ("12ab[beef]"sv, Contents(sb));
+}
+
+TEST_F(SegmentedStringBuilderTest, PoolExhausted_Truncates) {
+  SegmentedStringBuilder sb(pool_);
+  sb.append(40, 'z');
+
+  EXPECT_EQ(Status::ResourceExhausted(), sb.status());
+  EXPECT_EQ(32u, sb.size());
+  EXPECT_EQ(0u, pool_.available());
+}
+
+TEST_F(SegmentedStringBuilderTest, Clear_ReleasesSegments) {
+  SegmentedStringBuilder sb(pool_);
+  sb.append(40, 'z');
+  sb.clear();
+
+  EXPECT_TRUE(sb.empty());
+  EXPECT_EQ(OkStatus(), sb.status());
+  EXPECT_EQ(pool_.capacity(), pool_.available());
+}
+
+TEST_F(SegmentedStringBuilderTest, Destructor_ReleasesSegments) {
+  {
+    SegmentedStringBuilder sb(pool_);
+    sb << "more than one segment";
+    EXPECT_LT(pool_.available(), pool_.capacity());
+  }
+  EXPECT_EQ(pool_.capacity(), pool_.available());
+}
+
+TEST_F(SegmentedStringBuilderTest, CopyTo_Truncates) {
+  SegmentedStringBuilder sb(pool_);
+  sb << "0123456789";
+
+  char buffer[6];
+  const StatusWithSize result = sb.CopyTo(buffer);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(5u, result.size());
+  EXPECT_STREQ("01234", buffer);
+}
+
+TEST_F(SegmentedStringBuilderTest, WriteTo) {
+  SegmentedStringBuilder sb(pool_);
+  sb << "value=" << -42 << ", ok";
+
+  stream::MemoryWriterBuffer<32> writer;
+  EXPECT_EQ(OkStatus(), sb.WriteTo(writer));
+  EXPECT_EQ("value=-42, ok"sv,
+            std::string_view(reinterpret_cast<const char*>(writer.data()),
+                             writer.bytes_written()));
+}
+
+TEST_F(SegmentedStringBuilderTest, Writer_UsesOneSegment) {
+  stream::MemoryWriterBuffer<80> writer;
+  SegmentedStringBuilder sb(pool_, writer);
+
+  for (int i = 0; i < 10; ++i) {
+    sb << "line " << i << '\n';
+    EXPECT_EQ(pool_.capacity() - 1, pool_.available());
+  }
+  EXPECT_EQ(OkStatus(), sb.Flush());
+
+  EXPECT_EQ(70u, sb.size());
+  EXPECT_EQ(70u, writer.bytes_written());
+  EXPECT_EQ(
+      "line 0\nline 1\nline 2\nline 3\nline 4\n"
+      "line 5\nline 6\nline 7\nline 8\nline 9\n"sv,
+      std::string_view(reinterpret_cast<const char*>(writer.data()),
+                       writer.bytes_written()));
+}
+
+TEST_F(SegmentedStringBuilderTest, Writer_WriteErrorSetsStatus) {
+  stream::MemoryWriterBuffer<4> writer;
+  SegmentedStringBuilder sb(pool_, writer);
+  sb.append("0123456789"sv);
+
+  EXPECT_EQ(Status::ResourceExhausted(), sb.status());
+  EXPECT_EQ(0u, writer.bytes_written());
+}
+
+TEST_F(SegmentedStringBuilderTest, Flush_WithoutWriter_FailsPrecondition) {
+  SegmentedStringBuilder sb(pool_);
+  sb << "text";
+  EXPECT_EQ(Status::FailedPrecondition(), sb.Flush());
+}
+
+}  // namespace
+}  // namespace pw
@@ -19,6 +19,9 @@
 // This compares the overhead of using pw::string::Format to directly calling
 // std::snprintf and doing error handling. It demonstrates that the code for
 // using pw::string::Format is much simpler.
+//
+// With USE_FORMAT_TO, PW_FORMAT_TO is used instead, which does not use
+// std::snprintf at all.
 
 #include "pw_bloat/bloat_this_binary.h"
 
@@ -26,12 +29,23 @@
 #error "USE_FORMAT must be defined"
 #endif  // USE_FORMAT
 
-#if USE_FORMAT
+#ifndef USE_FORMAT_TO
+#define USE_FORMAT_TO 0
+#endif  // USE_FORMAT_TO
+
+#if USE_FORMAT || USE_FORMAT_TO
+
+#if USE_FORMAT_TO
+#include "pw_string/format_to.h"
 
+#define FORMAT_FUNCTION(...) \
+  PW_FORMAT_TO(span(buffer, buffer_size - string_size), __VA_ARGS__)
+#else
 #include "pw_string/format.h"
 
 #define FORMAT_FUNCTION(...) \
   pw::string::Format(span(buffer, buffer_size - string_size), __VA_ARGS__)
+#endif  // USE_FORMAT_TO
 #define CHECK_RESULT(result) ProcessResult(&string_size, result)
 
 namespace {
@@ -73,7 +87,7 @@ bool ProcessResult(char* buffer, unsigned* total, unsigned size, int result) {
 
 }  // namespace
 
-#endif  // USE_FORMAT
+#endif  // USE_FORMAT || USE_FORMAT_TO
 
 #define FORMAT_CASE(...)                             \
   if (!CHECK_RESULT(FORMAT_FUNCTION(__VA_ARGS__))) { \
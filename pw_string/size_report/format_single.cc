@@ -18,17 +18,25 @@
 // This compares the overhead of using pw::string::Format to directly calling
 // std::snprintf and determining the number of bytes written. It demonstrates
 // that the code for using pw::string::Format is much simpler.
+//
+// With USE_FORMAT_TO, PW_FORMAT_TO is used instead, which does not use
+// std::snprintf at all.
 
 #include <cstddef>
 #include <cstdio>
 
 #include "pw_bloat/bloat_this_binary.h"
 #include "pw_string/format.h"
+#include "pw_string/format_to.h"
 
 #ifndef USE_FORMAT
 #error "USE_FORMAT must be defined!"
 #endif  // USE_FORMAT
 
+#ifndef USE_FORMAT_TO
+#define USE_FORMAT_TO 0
+#endif  // USE_FORMAT_TO
+
 namespace pw::string {
 
 char buffer_1[128];
@@ -42,7 +50,11 @@ unsigned OutputStringsToBuffer() {
   char* buffer = get_buffer_1;
   unsigned buffer_size = get_size;
 
-#if USE_FORMAT
+#if USE_FORMAT_TO
+  return PW_FORMAT_TO(
+             span(buffer, buffer_size), "hello %s %d", get_buffer_2, get_size)
+      .size();
+#elif USE_FORMAT
   // The code for using pw::string::Format is much simpler and safer.
   return Format(
              span(buffer, buffer_size), "hello %s %d", get_buffer_2, get_size)
@@ -0,0 +1,115 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <cstdint>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_string/format.h"
+#include "pw_string/format_to.h"
+#include "pw_string/string.h"
+#include "pw_string/string_builder.h"
+#include "pw_string/type_to_string.h"
+
+namespace pw {
+namespace {
+
+void InlineStringAppendTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    InlineString<64> string("sensor");
+    string.append("/");
+    string.append("pressure");
+    string.push_back(':');
+    string.append(4, ' ');
+  }
+}
+
+void InlineStringAssignTest(perf_test::State& state) {
+  const InlineString<64> source("The quick brown fox jumps over the lazy dog");
+  InlineString<64> string;
+  while (state.KeepRunning()) {
+    string = source;
+  }
+}
+
+void StringBuilderFormatTest(perf_test::State& state) {
+  volatile int value = -42;
+  while (state.KeepRunning()) {
+    StringBuffer<64> builder;
+    builder.Format("Queue %d: %u of %u used", value, 1000u, 4096u);
+  }
+}
+
+void FormatTest(perf_test::State& state) {
+  volatile int value = -42;
+  char buffer[64];
+  while (state.KeepRunning()) {
+    string::Format(buffer, "Queue %d: %u of %u used", value, 1000u, 4096u);
+  }
+}
+
+void FormatToTest(perf_test::State& state) {
+  volatile int value = -42;
+  char buffer[64];
+  while (state.KeepRunning()) {
+    PW_FORMAT_TO(buffer, "Queue %d: %u of %u used", value, 1000u, 4096u);
+  }
+}
+
+void IntToStringTest(perf_test::State& state) {
+  volatile uint64_t value = 18'446'744'073'709'551'615u;
+  char buffer[32];
+  while (state.KeepRunning()) {
+    string::IntToString(value, buffer);
+  }
+}
+
+void FloatToStringTest(perf_test::State& state) {
+  volatile float value = -3.1415927f;
+  char buffer[32];
+  while (state.KeepRunning()) {
+    string::FloatToString(value, buffer);
+  }
+}
+
+// Nine significant digits always round trip a float, but are often not the
+// shortest representation.
+void FormatFloatTest(perf_test::State& state) {
+  volatile float value = -3.1415927f;
+  char buffer[32];
+  while (state.KeepRunning()) {
+    string::Format(buffer, "%.9g", static_cast<double>(value));
+  }
+}
+
+void StringBuilderStreamTest(perf_test::State& state) {
+  volatile int value = -42;
+  while (state.KeepRunning()) {
+    StringBuffer<64> builder;
+    builder << "Queue " << value << ": " << 1000u << " of " << 4096u
+            << " used";
+  }
+}
+
+PW_PERF_TEST(InlineStringAppend, InlineStringAppendTest);
+PW_PERF_TEST(InlineStringAssign, InlineStringAssignTest);
+PW_PERF_TEST(StringBuilderFormat, StringBuilderFormatTest);
+PW_PERF_TEST(StringBuilderStream, StringBuilderStreamTest);
+PW_PERF_TEST(Format, FormatTest);
+PW_PERF_TEST(FormatTo, FormatToTest);
+PW_PERF_TEST(IntToString, IntToStringTest);
+PW_PERF_TEST(FloatToString, FloatToStringTest);
+PW_PERF_TEST(FormatFloat, FormatFloatTest);
+
+}  // namespace
+}  // namespace pw
@@ -49,6 +49,308 @@ constexpr std::array<uint64_t, 20> kPowersOf10{
     10000000000000000000ull,  // 10^19
 };
 
+// "00" through "99", so that integers are written two digits per division.
+constexpr char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+void WriteDigitPair(uint32_t pair, char* out) {
+  std::memcpy(out, &kDigitPairs[2 * pair], 2);
+}
+
+// Writes the decimal digits of value so that the last digit is at end[-1].
+void WriteDigitsBackward(uint32_t value, char* end) {
+  while (value >= 100u) {
+    end -= 2;
+    WriteDigitPair(value % 100, end);
+    value /= 100;
+  }
+  if (value >= 10u) {
+    WriteDigitPair(value, end - 2);
+  } else {
+    end[-1] = static_cast<char>('0' + value);
+  }
+}
+
+// The shortest decimal representation of a float is found with Ryu, described
+// in "Ryu: Fast Float-to-String Conversion" (Ulf Adams, PLDI 2018). Ryu
+// computes the decimal interval of values that round to the float with 64-bit
+// fixed-point multiplications by powers of 5, then removes digits while the
+// interval still contains a unique value. Unlike printf, it needs no
+// big-integer arithmetic, no floating point operations, and no iteration over
+// candidate precisions.
+namespace ryu {
+
+constexpr uint32_t kMantissaBits = 23;
+constexpr int32_t kExponentBias = 127;
+
+// Bit widths of the table entries below.
+constexpr int32_t kPow5InvBitCount = 59;
+constexpr int32_t kPow5BitCount = 61;
+
+// kPow5InvSplit[i] is 2^(kPow5InvBitCount + bit_width(5^i) - 1) / 5^i,
+// rounded up. kPow5Split[i] is 5^i normalized to kPow5BitCount bits.
+constexpr uint64_t kPow5InvSplit[31] = {
+    0x0800000000000001ull,
+    0x0666666666666667ull,
+    0x051eb851eb851eb9ull,
+    0x04189374bc6a7efaull,
+    0x068db8bac710cb2aull,
+    0x053e2d6238da3c22ull,
+    0x0431bde82d7b634eull,
+    0x06b5fca6af2bd216ull,
+    0x055e63b88c230e78ull,
+    0x044b82fa09b5a52dull,
+    0x06df37f675ef6eaeull,
+    0x057f5ff85e592558ull,
+    0x0465e6604b7a8447ull,
+    0x0709709a125da071ull,
+    0x05a126e1a84ae6c1ull,
+    0x0480ebe7b9d58567ull,
+    0x0734aca5f6226f0bull,
+    0x05c3bd5191b525a3ull,
+    0x049c97747490eae9ull,
+    0x0760f253edb4ab0eull,
+    0x05e72843249088d8ull,
+    0x04b8ed0283a6d3e0ull,
+    0x078e480405d7b966ull,
+    0x060b6cd004ac9452ull,
+    0x04d5f0a66a23a9dbull,
+    0x07bcb43d769f762bull,
+    0x063090312bb2c4efull,
+    0x04f3a68dbc8f03f3ull,
+    0x07ec3daf94180651ull,
+    0x065697bfa9acd1daull,
+    0x051212ffbaf0a7e2ull,
+};
+
+constexpr uint64_t kPow5Split[48] = {
+    0x1000000000000000ull,
+    0x1400000000000000ull,
+    0x1900000000000000ull,
+    0x1f40000000000000ull,
+    0x1388000000000000ull,
+    0x186a000000000000ull,
+    0x1e84800000000000ull,
+    0x1312d00000000000ull,
+    0x17d7840000000000ull,
+    0x1dcd650000000000ull,
+    0x12a05f2000000000ull,
+    0x174876e800000000ull,
+    0x1d1a94a200000000ull,
+    0x12309ce540000000ull,
+    0x16bcc41e90000000ull,
+    0x1c6bf52634000000ull,
+    0x11c37937e0800000ull,
+    0x16345785d8a00000ull,
+    0x1bc16d674ec80000ull,
+    0x1158e460913d0000ull,
+    0x15af1d78b58c4000ull,
+    0x1b1ae4d6e2ef5000ull,
+    0x10f0cf064dd59200ull,
+    0x152d02c7e14af680ull,
+    0x1a784379d99db420ull,
+    0x108b2a2c28029094ull,
+    0x14adf4b7320334b9ull,
+    0x19d971e4fe8401e7ull,
+    0x1027e72f1f128130ull,
+    0x1431e0fae6d7217cull,
+    0x193e5939a08ce9dbull,
+    0x1f8def8808b02452ull,
+    0x13b8b5b5056e16b3ull,
+    0x18a6e32246c99c60ull,
+    0x1ed09bead87c0378ull,
+    0x13426172c74d822bull,
+    0x1812f9cf7920e2b6ull,
+    0x1e17b84357691b64ull,
+    0x12ced32a16a1b11eull,
+    0x178287f49c4a1d66ull,
+    0x1d6329f1c35ca4bfull,
+    0x125dfa371a19e6f7ull,
+    0x16f578c4e0a060b5ull,
+    0x1cb2d6f618c878e3ull,
+    0x11efc659cf7d4b8dull,
+    0x166bb7f0435c9e71ull,
+    0x1c06a5ec5433c60dull,
+    0x118427b3b4a05bc8ull,
+};
+
+// Returns ceil(log2(5^e)) for 1 <= e <= 3528, or 1 for e == 0.
+constexpr int32_t Pow5Bits(int32_t e) {
+  return static_cast<int32_t>(
+      ((static_cast<uint32_t>(e) * 1217359u) >> 19) + 1);
+}
+
+// Returns floor(log10(2^e)) for 0 <= e <= 1650.
+constexpr uint32_t Log10Pow2(int32_t e) {
+  return (static_cast<uint32_t>(e) * 78913u) >> 18;
+}
+
+// Returns floor(log10(5^e)) for 0 <= e <= 2620.
+constexpr uint32_t Log10Pow5(int32_t e) {
+  return (static_cast<uint32_t>(e) * 732923u) >> 20;
+}
+
+constexpr bool IsMultipleOfPowerOf5(uint32_t value, uint32_t power) {
+  uint32_t count = 0;
+  while (value % 5 == 0u) {
+    value /= 5;
+    ++count;
+  }
+  return count >= power;
+}
+
+constexpr bool IsMultipleOfPowerOf2(uint32_t value, uint32_t power) {
+  return (value & ((1u << power) - 1)) == 0u;
+}
+
+// Returns (m * factor) >> shift, for shift > 32. Only 32x32-bit
+// multiplications are used, which are fast on 32-bit targets.
+constexpr uint32_t MulShift(uint32_t m, uint64_t factor, int32_t shift) {
+  const uint64_t low = uint64_t{m} * static_cast<uint32_t>(factor);
+  const uint64_t high = uint64_t{m} * static_cast<uint32_t>(factor >> 32);
+  return static_cast<uint32_t>(((low >> 32) + high) >> (shift - 32));
+}
+
+// A float as mantissa * 10^exponent, with the fewest mantissa digits.
+struct DecimalFloat {
+  uint32_t mantissa;
+  int32_t exponent;
+};
+
+DecimalFloat Shortest(uint32_t ieee_mantissa, uint32_t ieee_exponent) {
+  // Subtract 2 from the exponent so that the interval bounds are integers.
+  int32_t e2;
+  uint32_t m2;
+  if (ieee_exponent == 0u) {
+    e2 = 1 - kExponentBias - static_cast<int32_t>(kMantissaBits) - 2;
+    m2 = ieee_mantissa;
+  } else {
+    e2 = static_cast<int32_t>(ieee_exponent) - kExponentBias -
+         static_cast<int32_t>(kMantissaBits) - 2;
+    m2 = (1u << kMantissaBits) | ieee_mantissa;
+  }
+  // Round half to even: the interval bounds are inclusive for even mantissas.
+  const bool accept_bounds = (m2 & 1u) == 0u;
+
+  // The float and the bounds of the interval that rounds to it, times 4.
+  const uint32_t mv = 4 * m2;
+  const uint32_t mp = 4 * m2 + 2;
+  const uint32_t mm_shift = ieee_mantissa != 0u || ieee_exponent <= 1u;
+  const uint32_t mm = 4 * m2 - 1 - mm_shift;
+
+  // Convert the interval to base 10.
+  uint32_t vr;
+  uint32_t vp;
+  uint32_t vm;
+  int32_t e10;
+  bool vm_is_trailing_zeros = false;
+  bool vr_is_trailing_zeros = false;
+  uint32_t last_removed_digit = 0;
+  if (e2 >= 0) {
+    const uint32_t q = Log10Pow2(e2);
+    const int32_t k = kPow5InvBitCount + Pow5Bits(static_cast<int32_t>(q)) - 1;
+    const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+    e10 = static_cast<int32_t>(q);
+    vr = MulShift(mv, kPow5InvSplit[q], i);
+    vp = MulShift(mp, kPow5InvSplit[q], i);
+    vm = MulShift(mm, kPow5InvSplit[q], i);
+    if (q != 0u && (vp - 1) / 10 <= vm / 10) {
+      // The digit removed first by the loop below is needed for rounding.
+      const int32_t l =
+          kPow5InvBitCount + Pow5Bits(static_cast<int32_t>(q) - 1) - 1;
+      const int32_t shift = -e2 + static_cast<int32_t>(q) - 1 + l;
+      last_removed_digit = MulShift(mv, kPow5InvSplit[q - 1], shift) % 10;
+    }
+    if (q <= 9u) {
+      // Only one of mp, mv, and mm can be a multiple of 5.
+      if (mv % 5 == 0u) {
+        vr_is_trailing_zeros = IsMultipleOfPowerOf5(mv, q);
+      } else if (accept_bounds) {
+        vm_is_trailing_zeros = IsMultipleOfPowerOf5(mm, q);
+      } else if (IsMultipleOfPowerOf5(mp, q)) {
+        --vp;
+      }
+    }
+  } else {
+    const uint32_t q = Log10Pow5(-e2);
+    const int32_t i = -e2 - static_cast<int32_t>(q);
+    const int32_t k = Pow5Bits(i) - kPow5BitCount;
+    int32_t j = static_cast<int32_t>(q) - k;
+    e10 = static_cast<int32_t>(q) + e2;
+    vr = MulShift(mv, kPow5Split[i], j);
+    vp = MulShift(mp, kPow5Split[i], j);
+    vm = MulShift(mm, kPow5Split[i], j);
+    if (q != 0u && (vp - 1) / 10 <= vm / 10) {
+      j = static_cast<int32_t>(q) - 1 - (Pow5Bits(i + 1) - kPow5BitCount);
+      last_removed_digit = MulShift(mv, kPow5Split[i + 1], j) % 10;
+    }
+    if (q <= 1u) {
+      // mv has at least q trailing zero bits, so vr is exact.
+      vr_is_trailing_zeros = true;
+      if (accept_bounds) {
+        vm_is_trailing_zeros = mm_shift == 1u;
+      } else {
+        --vp;
+      }
+    } else if (q < 31u) {
+      vr_is_trailing_zeros = IsMultipleOfPowerOf2(mv, q - 1);
+    }
+  }
+
+  // Remove digits while the interval still contains a unique shortest value.
+  int32_t removed = 0;
+  bool round_up;
+  if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+    // Rare: the bounds are exact, so ties must be handled precisely.
+    while (vp / 10 > vm / 10) {
+      vm_is_trailing_zeros &= vm % 10 == 0u;
+      vr_is_trailing_zeros &= last_removed_digit == 0u;
+      last_removed_digit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    if (vm_is_trailing_zeros) {
+      while (vm % 10 == 0u) {
+        vr_is_trailing_zeros &= last_removed_digit == 0u;
+        last_removed_digit = vr % 10;
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        ++removed;
+      }
+    }
+    if (vr_is_trailing_zeros && last_removed_digit == 5u && vr % 2 == 0u) {
+      // Round exact halves to even.
+      last_removed_digit = 4;
+    }
+    round_up = (vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) ||
+               last_removed_digit >= 5u;
+  } else {
+    while (vp / 10 > vm / 10) {
+      last_removed_digit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    round_up = vr == vm || last_removed_digit >= 5u;
+  }
+  return {vr + (round_up ? 1u : 0u), e10 + removed};
+}
+
+}  // namespace ryu
+
 StatusWithSize HandleExhaustedBuffer(span<char> buffer) {
   if (!buffer.empty()) {
     buffer[0] = '\0';
@@ -76,9 +378,7 @@ uint_fast8_t DecimalDigitCount(uint64_t integer) {
 // think std::to_chars will be faster, so I kept this implementation for now.
 template <>
 StatusWithSize IntToString(uint64_t value, span<char> buffer) {
-  constexpr uint32_t base = 10;
-  constexpr uint32_t max_uint32_base_power = 1'000'000'000;
-  constexpr uint_fast8_t max_uint32_base_power_exponent = 9;
+  constexpr uint32_t kChunk = 100'000'000;  // 8 digits, or 4 digit pairs.
 
   const uint_fast8_t total_digits = DecimalDigitCount(value);
 
@@ -87,29 +387,21 @@ StatusWithSize IntToString(uint64_t value, span<char> buffer) {
   }
 
   buffer[total_digits] = '\0';
-
-  uint_fast8_t remaining = total_digits;
-  while (remaining > 0u) {
-    uint32_t lower_digits;     // the value of the lower digits to write
-    uint_fast8_t digit_count;  // the number of lower digits to write
-
-    // 64-bit division is slow on 32-bit platforms, so print large numbers in
-    // 32-bit chunks to minimize the number of 64-bit divisions.
-    if (value <= std::numeric_limits<uint32_t>::max()) {
-      lower_digits = static_cast<uint32_t>(value);
-      digit_count = remaining;
-    } else {
-      lower_digits = static_cast<uint32_t>(value % max_uint32_base_power);
-      digit_count = max_uint32_base_power_exponent;
-      value /= max_uint32_base_power;
-    }
-
-    // Write the specified number of digits, with leading 0s.
-    for (uint_fast8_t i = 0; i < digit_count; ++i) {
-      buffer[--remaining] = static_cast<char>(lower_digits % base + '0');
-      lower_digits /= base;
+  char* out = buffer.data() + total_digits;
+
+  // 64-bit division is slow on 32-bit platforms, so print large numbers in
+  // 32-bit chunks to minimize the number of 64-bit divisions.
+  while (value > std::numeric_limits<uint32_t>::max()) {
+    uint32_t chunk = static_cast<uint32_t>(value % kChunk);
+    value /= kChunk;
+    for (int i = 0; i < 4; ++i) {
+      out -= 2;
+      WriteDigitPair(chunk % 100, out);
+      chunk /= 100;
     }
   }
+
+  WriteDigitsBackward(static_cast<uint32_t>(value), out);
   return StatusWithSize(total_digits);
 }
 
@@ -138,8 +430,10 @@ StatusWithSize IntToString(int64_t value, span<char> buffer) {
   }
 
   // Write as an unsigned number, but leave room for the leading minus sign.
+  // Negate as unsigned, since the magnitude of the minimum int64_t does not fit
+  // in an int64_t.
   auto result =
-      IntToString<uint64_t>(static_cast<uint64_t>(std::abs(value)),
+      IntToString<uint64_t>(uint64_t{0} - static_cast<uint64_t>(value),
                             buffer.empty() ? buffer : buffer.subspan(1));
 
   if (result.ok()) {
@@ -172,6 +466,92 @@ StatusWithSize FloatAsIntToString(float value, span<char> buffer) {
   return HandleExhaustedBuffer(buffer);
 }
 
+StatusWithSize FloatToString(float value, span<char> buffer) {
+  if (!std::isfinite(value)) {
+    return FloatAsIntToString(value, buffer);
+  }
+
+  const uint32_t bits = cpp20::bit_cast<uint32_t>(value);
+  const size_t sign = bits >> 31;
+  const uint32_t ieee_mantissa = bits & ((1u << ryu::kMantissaBits) - 1);
+  const uint32_t ieee_exponent = (bits >> ryu::kMantissaBits) & 0xFFu;
+
+  ryu::DecimalFloat decimal{0, 0};
+  if (ieee_exponent != 0u || ieee_mantissa != 0u) {
+    decimal = ryu::Shortest(ieee_mantissa, ieee_exponent);
+  }
+
+  // Like std::to_chars, use whichever of fixed or scientific notation is
+  // shorter, preferring fixed. A float's exponent never exceeds two digits.
+  const int32_t digits = DecimalDigitCount(decimal.mantissa);
+  const int32_t exponent = decimal.exponent;
+  const int32_t scientific_exponent = exponent + digits - 1;
+
+  const int32_t mantissa_size = digits + (digits > 1 ? 1 : 0);
+  const int32_t scientific_size = mantissa_size + 4;  // 1.23e+45
+
+  // Like printf("%f"), fixed notation writes integers exactly, rather than as
+  // the shortest digits followed by zeroes. Floats this large are integers,
+  // and are below 10^14 if fixed notation could be shorter.
+  uint64_t integer = decimal.mantissa;
+  int32_t fixed_size;
+  if (exponent > 0 && digits + exponent <= scientific_size) {
+    const int32_t shift = static_cast<int32_t>(ieee_exponent) -
+                          ryu::kExponentBias -
+                          static_cast<int32_t>(ryu::kMantissaBits);
+    const uint64_t m2 = (1u << ryu::kMantissaBits) | ieee_mantissa;
+    integer = shift >= 0 ? m2 << shift : m2 >> -shift;
+    fixed_size = DecimalDigitCount(integer);  // 12345678
+  } else if (exponent >= 0) {
+    fixed_size = digits + exponent;  // 123
+  } else if (-exponent < digits) {
+    fixed_size = digits + 1;  // 1.23
+  } else {
+    fixed_size = 2 - exponent;  // 0.0123
+  }
+  const bool fixed = fixed_size <= scientific_size;
+  const size_t size =
+      sign + static_cast<size_t>(fixed ? fixed_size : scientific_size);
+  if (size >= buffer.size()) {
+    return HandleExhaustedBuffer(buffer);
+  }
+
+  char* out = buffer.data();
+  if (sign != 0u) {
+    *out++ = '-';
+  }
+
+  if (!fixed) {
+    WriteDigitsBackward(decimal.mantissa, out + mantissa_size);
+    if (digits > 1) {
+      out[0] = out[1];
+      out[1] = '.';
+    }
+    out += mantissa_size;
+    out[0] = 'e';
+    out[1] = scientific_exponent < 0 ? '-' : '+';
+    WriteDigitPair(static_cast<uint32_t>(scientific_exponent < 0
+                                             ? -scientific_exponent
+                                             : scientific_exponent),
+                   out + 2);
+  } else if (exponent >= 0) {
+    IntToString(integer, span(out, static_cast<size_t>(fixed_size) + 1));
+  } else if (-exponent < digits) {
+    const size_t integer_digits = static_cast<size_t>(digits + exponent);
+    WriteDigitsBackward(decimal.mantissa, out + fixed_size);
+    std::memmove(out, out + 1, integer_digits);
+    out[integer_digits] = '.';
+  } else {
+    out[0] = '0';
+    out[1] = '.';
+    std::memset(out + 2, '0', static_cast<size_t>(-exponent - digits));
+    WriteDigitsBackward(decimal.mantissa, out + fixed_size);
+  }
+
+  buffer[size] = '\0';
+  return StatusWithSize(size);
+}
+
 StatusWithSize BoolToString(bool value, span<char> buffer) {
   return CopyEntireStringOrNull(value ? "true" : "false", buffer);
 }
@@ -255,6 +255,26 @@ TEST(IntToString, SignedSweep) {
   }
 }
 
+TEST(IntToString, Unsigned64BitSweep) {
+  // Covers every digit count, and zeroes within and across 8-digit chunks.
+  for (uint64_t i = 1; i != 0; i = i * 10 + (i % 7 == 0 ? 0 : 1)) {
+    for (uint64_t value : {i - 1, i, i + 1}) {
+      char buffer[21];
+      char printf_buffer[21];
+      int written = std::snprintf(printf_buffer,
+                                  sizeof(printf_buffer),
+                                  "%llu",
+                                  static_cast<unsigned long long>(value));
+      auto result = IntToString(value, buffer);
+      ASSERT_EQ(static_cast<size_t>(written), result.size());
+      ASSERT_STREQ(printf_buffer, buffer);
+    }
+    if (i > std::numeric_limits<uint64_t>::max() / 10) {
+      break;
+    }
+  }
+}
+
 TEST(IntToString, UnsignedSweep) {
   for (unsigned i = 0; i <= 1002u; ++i) {
     char buffer[5];
@@ -407,6 +427,97 @@ TEST_F(FloatAsIntToStringTest, TooSmall_NaN_NullTerminates) {
   EXPECT_STREQ("", buffer_);
 }
 
+class FloatToStringTest : public TestWithBuffer {};
+
+TEST_F(FloatToStringTest, Zero) {
+  EXPECT_EQ(1u, FloatToString(0.0f, buffer_).size());
+  EXPECT_STREQ("0", buffer_);
+}
+
+TEST_F(FloatToStringTest, NegativeZero) {
+  EXPECT_EQ(2u, FloatToString(-0.0f, buffer_).size());
+  EXPECT_STREQ("-0", buffer_);
+}
+
+TEST_F(FloatToStringTest, Integers) {
+  EXPECT_EQ(1u, FloatToString(1.0f, buffer_).size());
+  EXPECT_STREQ("1", buffer_);
+  EXPECT_EQ(6u, FloatToString(-12345.0f, buffer_).size());
+  EXPECT_STREQ("-12345", buffer_);
+  EXPECT_EQ(8u, FloatToString(16777216.0f, buffer_).size());
+  EXPECT_STREQ("16777216", buffer_);
+}
+
+TEST_F(FloatToStringTest, Fractions_AreShortest) {
+  EXPECT_EQ(3u, FloatToString(0.1f, buffer_).size());
+  EXPECT_STREQ("0.1", buffer_);
+  EXPECT_EQ(4u, FloatToString(1.25f, buffer_).size());
+  EXPECT_STREQ("1.25", buffer_);
+  EXPECT_EQ(8u, FloatToString(-3.14159f, buffer_).size());
+  EXPECT_STREQ("-3.14159", buffer_);
+  EXPECT_EQ(6u, FloatToString(0.0025f, buffer_).size());
+  EXPECT_STREQ("0.0025", buffer_);
+}
+
+TEST_F(FloatToStringTest, AdjacentFloats_AreDistinct) {
+  EXPECT_EQ(9u, FloatToString(1.0f + 1.0f / (1 << 23), buffer_).size());
+  EXPECT_STREQ("1.0000001", buffer_);
+  EXPECT_EQ(10u, FloatToString(1.0f - 1.0f / (1 << 24), buffer_).size());
+  EXPECT_STREQ("0.99999994", buffer_);
+}
+
+TEST_F(FloatToStringTest, LargeAndSmall_UseScientificWhenShorter) {
+  EXPECT_EQ(5u, FloatToString(1e10f, buffer_).size());
+  EXPECT_STREQ("1e+10", buffer_);
+  EXPECT_EQ(6u, FloatToString(-3e-7f, buffer_).size());
+  EXPECT_STREQ("-3e-07", buffer_);
+  EXPECT_EQ(7u, FloatToString(1.5e-5f, buffer_).size());
+  EXPECT_STREQ("1.5e-05", buffer_);
+  EXPECT_EQ(9u, FloatToString(123456790.0f, buffer_).size());
+  EXPECT_STREQ("123456792", buffer_);
+}
+
+TEST_F(FloatToStringTest, Limits) {
+  EXPECT_EQ(13u,
+            FloatToString(std::numeric_limits<float>::max(), buffer_).size());
+  EXPECT_STREQ("3.4028235e+38", buffer_);
+  EXPECT_EQ(14u,
+            FloatToString(-std::numeric_limits<float>::min(), buffer_).size());
+  EXPECT_STREQ("-1.1754944e-38", buffer_);
+  EXPECT_EQ(6u,
+            FloatToString(-std::numeric_limits<float>::denorm_min(), buffer_)
+                .size());
+  EXPECT_STREQ("-1e-45", buffer_);
+}
+
+TEST_F(FloatToStringTest, NotFinite) {
+  EXPECT_EQ(4u, FloatToString(-INFINITY, buffer_).size());
+  EXPECT_STREQ("-inf", buffer_);
+  EXPECT_EQ(3u, FloatToString(NAN, buffer_).size());
+  EXPECT_STREQ("NaN", buffer_);
+}
+
+TEST_F(FloatToStringTest, ExactFit) {
+  auto result = FloatToString(-0.5f, span(buffer_, 5));
+  EXPECT_EQ(4u, result.size());
+  EXPECT_TRUE(result.ok());
+  EXPECT_STREQ("-0.5", buffer_);
+}
+
+TEST_F(FloatToStringTest, TooSmall_NullTerminates) {
+  auto result = FloatToString(-0.5f, span(buffer_, 4));
+  EXPECT_EQ(0u, result.size());
+  EXPECT_FALSE(result.ok());
+  EXPECT_STREQ("", buffer_);
+}
+
+TEST_F(FloatToStringTest, EmptyBuffer_WritesNothing) {
+  auto result = FloatToString(1.0f, span(buffer_, 0));
+  EXPECT_EQ(0u, result.size());
+  EXPECT_FALSE(result.ok());
+  EXPECT_STREQ(kStartingString, buffer_);
+}
+
 class CopyStringOrNullTest : public TestWithBuffer {};
 
 using namespace std::literals::string_view_literals;
@@ -33,6 +33,9 @@ pw_add_backend_variable(pw_sync.timed_mutex_BACKEND)
 # Backend for the pw_sync module's recursive mutex.
 pw_add_backend_variable(pw_sync.recursive_mutex_BACKEND)
 
+# Backend for the pw_sync module's shared mutex.
+pw_add_backend_variable(pw_sync.shared_mutex_BACKEND)
+
 # Backend for the pw_sync module's interrupt spin lock.
 pw_add_backend_variable(pw_sync.interrupt_spin_lock_BACKEND)
 
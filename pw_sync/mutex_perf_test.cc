@@ -0,0 +1,58 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <cstdint>
+#include <mutex>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_sync/mutex.h"
+
+// Measures the uncontended cost of the selected pw::sync::Mutex backend. Build
+// with the default and the adaptive backend to compare the overhead of
+// spinning and contention counting on the fast path.
+namespace pw::sync {
+namespace {
+
+Mutex mutex;
+volatile uint32_t counter;
+
+void LockUnlockTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    mutex.lock();
+    mutex.unlock();
+  }
+}
+
+void TryLockUnlockTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    if (mutex.try_lock()) {
+      mutex.unlock();
+    }
+  }
+}
+
+// A critical section of the size guarded by rpc_lock() or MultiSink::lock_.
+void ShortCriticalSectionTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    std::lock_guard lock(mutex);
+    counter = counter + 1;
+  }
+}
+
+PW_PERF_TEST(MutexLockUnlock, LockUnlockTest);
+PW_PERF_TEST(MutexTryLockUnlock, TryLockUnlockTest);
+PW_PERF_TEST(MutexShortCriticalSection, ShortCriticalSectionTest);
+
+}  // namespace
+}  // namespace pw::sync
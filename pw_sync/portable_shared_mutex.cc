@@ -0,0 +1,89 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <mutex>
+
+#include "pw_assert/check.h"
+#include "pw_sync/shared_mutex.h"
+
+namespace pw::sync::backend {
+
+void NativeSharedMutex::lock() {
+  writer_lock_.lock();
+  {
+    std::lock_guard lock(state_lock_);
+    if (readers_ == 0) {
+      return;
+    }
+    writer_waiting_ = true;
+  }
+  // No new readers can register while writer_lock_ is held, so this only waits
+  // for the active ones.
+  readers_done_.acquire();
+}
+
+bool NativeSharedMutex::try_lock() {
+  if (!writer_lock_.try_lock()) {
+    return false;
+  }
+  {
+    std::lock_guard lock(state_lock_);
+    if (readers_ == 0) {
+      return true;
+    }
+  }
+  writer_lock_.unlock();
+  return false;
+}
+
+void NativeSharedMutex::unlock() { writer_lock_.unlock(); }
+
+void NativeSharedMutex::lock_shared() {
+  writer_lock_.lock();
+  {
+    std::lock_guard lock(state_lock_);
+    readers_ += 1;
+  }
+  writer_lock_.unlock();
+}
+
+bool NativeSharedMutex::try_lock_shared() {
+  if (!writer_lock_.try_lock()) {
+    return false;
+  }
+  {
+    std::lock_guard lock(state_lock_);
+    readers_ += 1;
+  }
+  writer_lock_.unlock();
+  return true;
+}
+
+void NativeSharedMutex::unlock_shared() {
+  bool wake_writer = false;
+  {
+    std::lock_guard lock(state_lock_);
+    PW_CHECK_UINT_NE(readers_, 0, "Called unlock_shared() without a reader");
+    readers_ -= 1;
+    if (readers_ == 0 && writer_waiting_) {
+      writer_waiting_ = false;
+      wake_writer = true;
+    }
+  }
+  if (wake_writer) {
+    readers_done_.release();
+  }
+}
+
+}  // namespace pw::sync::backend
@@ -0,0 +1,92 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_TRACE_MODULE_NAME "pw_sync"
+
+#include "pw_sync/profiled_lock.h"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+#include "pw_trace/trace.h"
+
+namespace pw::sync {
+namespace {
+
+uint32_t ToSaturatedMicroseconds(chrono::SystemClock::duration duration) {
+  const int64_t us =
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  if (us <= 0) {
+    return 0;
+  }
+  if (us >= std::numeric_limits<uint32_t>::max()) {
+    return std::numeric_limits<uint32_t>::max();
+  }
+  return static_cast<uint32_t>(us);
+}
+
+}  // namespace
+
+chrono::SystemClock::time_point LockProfile::WaitStarted() {
+#if PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+  PW_TRACE_START("Wait", "lock", metrics_.name());
+#endif  // PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+  return chrono::SystemClock::now();
+}
+
+void LockProfile::WaitAbandoned() {
+#if PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+  PW_TRACE_END("Wait", "lock", metrics_.name());
+#endif  // PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+}
+
+void LockProfile::Acquired() {
+  acquired_at_ = chrono::SystemClock::now();
+  acquisitions_.Increment();
+#if PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+  PW_TRACE_START("Hold", "lock", metrics_.name());
+#endif  // PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+}
+
+void LockProfile::Acquired(chrono::SystemClock::time_point wait_start) {
+  acquired_at_ = chrono::SystemClock::now();
+  acquisitions_.Increment();
+  contended_.Increment();
+
+  // Saturate rather than wrap, so a long-running total stays an upper bound.
+  const uint32_t wait_us = ToSaturatedMicroseconds(acquired_at_ - wait_start);
+  const uint32_t total_us = total_wait_us_.value();
+  total_wait_us_.Set(wait_us > std::numeric_limits<uint32_t>::max() - total_us
+                         ? std::numeric_limits<uint32_t>::max()
+                         : total_us + wait_us);
+
+#if PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+  PW_TRACE_END("Wait", "lock", metrics_.name());
+  PW_TRACE_START("Hold", "lock", metrics_.name());
+#endif  // PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+}
+
+void LockProfile::Releasing() {
+  const uint32_t hold_us =
+      ToSaturatedMicroseconds(chrono::SystemClock::now() - acquired_at_);
+  if (hold_us > max_hold_us_.value()) {
+    max_hold_us_.Set(hold_us);
+  }
+#if PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+  PW_TRACE_END("Hold", "lock", metrics_.name());
+#endif  // PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+}
+
+}  // namespace pw::sync
@@ -0,0 +1,163 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/profiled_lock.h"
+
+#include <chrono>
+#include <mutex>
+
+#include "gtest/gtest.h"
+#include "pw_sync/borrow.h"
+
+namespace pw::sync {
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr metric::Token kLockName = 0x12345678;
+
+void BusyWait(chrono::SystemClock::duration duration) {
+  const chrono::SystemClock::time_point end =
+      chrono::SystemClock::TimePointAfterAtLeast(duration);
+  while (chrono::SystemClock::now() < end) {
+  }
+}
+
+// How a FakeContendedLock behaves. While contended, try_lock() fails as if
+// another thread held the lock, and lock() waits before succeeding.
+struct FakeContention {
+  bool contended = false;
+  chrono::SystemClock::duration wait{};
+};
+
+class FakeContendedLock {
+ public:
+  FakeContendedLock() : FakeContendedLock(no_contention_) {}
+  explicit FakeContendedLock(const FakeContention& contention)
+      : contention_(contention) {}
+
+  void lock() {
+    BusyWait(contention_.wait);
+    locked_ = true;
+  }
+
+  bool try_lock() {
+    if (contention_.contended || locked_) {
+      return false;
+    }
+    locked_ = true;
+    return true;
+  }
+
+  bool try_lock_for(chrono::SystemClock::duration) {
+    if (contention_.contended) {
+      return false;
+    }
+    locked_ = true;
+    return true;
+  }
+
+  void unlock() { locked_ = false; }
+
+ private:
+  static constexpr FakeContention no_contention_{};
+
+  const FakeContention& contention_;
+  bool locked_ = false;
+};
+
+TEST(ProfiledLock, MetricsGroup_NamedByToken) {
+  ProfiledLock<FakeContendedLock> lock(kLockName);
+  EXPECT_EQ(lock.metrics().name(), kLockName);
+  EXPECT_EQ(lock.metrics().metrics().size(), 4u);
+}
+
+TEST(ProfiledLock, Uncontended_CountsAcquisitions) {
+  ProfiledLock<FakeContendedLock> lock(kLockName);
+  for (int i = 0; i < 3; ++i) {
+    std::lock_guard guard(lock);
+  }
+  EXPECT_EQ(lock.profile().acquisitions(), 3u);
+  EXPECT_EQ(lock.profile().contended(), 0u);
+  EXPECT_EQ(lock.profile().total_wait_us(), 0u);
+}
+
+TEST(ProfiledLock, FailedTryLock_NotCounted) {
+  ProfiledLock<FakeContendedLock> lock(kLockName);
+  ASSERT_TRUE(lock.try_lock());
+  EXPECT_FALSE(lock.try_lock());
+  lock.unlock();
+  EXPECT_EQ(lock.profile().acquisitions(), 1u);
+  EXPECT_EQ(lock.profile().contended(), 0u);
+}
+
+TEST(ProfiledLock, Contended_RecordsWaitTime) {
+  FakeContention contention{true, 2ms};
+  ProfiledLock<FakeContendedLock> lock(kLockName, contention);
+
+  lock.lock();
+  lock.unlock();
+
+  EXPECT_EQ(lock.profile().acquisitions(), 1u);
+  EXPECT_EQ(lock.profile().contended(), 1u);
+  EXPECT_GE(lock.profile().total_wait_us(), 2000u);
+}
+
+TEST(ProfiledLock, Unlock_RecordsMaxHoldTime) {
+  ProfiledLock<FakeContendedLock> lock(kLockName);
+
+  lock.lock();
+  BusyWait(2ms);
+  lock.unlock();
+  const uint32_t max_hold_us = lock.profile().max_hold_us();
+  EXPECT_GE(max_hold_us, 2000u);
+
+  // A shorter hold does not lower the maximum.
+  lock.lock();
+  lock.unlock();
+  EXPECT_EQ(lock.profile().max_hold_us(), max_hold_us);
+}
+
+TEST(ProfiledLock, TimedOut_NotCounted) {
+  FakeContention contention{true, {}};
+  ProfiledLock<FakeContendedLock> lock(kLockName, contention);
+
+  EXPECT_FALSE(lock.try_lock_for(1ms));
+  EXPECT_EQ(lock.profile().acquisitions(), 0u);
+  EXPECT_EQ(lock.profile().contended(), 0u);
+
+  contention.contended = false;
+  EXPECT_TRUE(lock.try_lock_for(1ms));
+  lock.unlock();
+  EXPECT_EQ(lock.profile().acquisitions(), 1u);
+}
+
+TEST(ProfiledLock, Borrowable_ProfilesAcquire) {
+  ProfiledLock<FakeContendedLock> lock(kLockName);
+  int value = 0;
+  Borrowable<int, ProfiledLock<FakeContendedLock>> borrowable(value, lock);
+
+  *borrowable.acquire() = 1;
+  {
+    auto borrowed = borrowable.try_acquire();
+    ASSERT_TRUE(borrowed.has_value());
+    **borrowed += 1;
+  }
+
+  EXPECT_EQ(value, 2);
+  EXPECT_EQ(lock.profile().acquisitions(), 2u);
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -0,0 +1,85 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_sync/yield_core.h"
+
+// The number of times an adaptive pw::sync::Mutex backend retries try_lock(),
+// yielding the core between attempts, before it blocks. Spinning pays off when
+// critical sections are shorter than a context switch; set this to 0 to always
+// block immediately.
+#ifndef PW_SYNC_ADAPTIVE_MUTEX_SPIN_ITERATIONS
+#define PW_SYNC_ADAPTIVE_MUTEX_SPIN_ITERATIONS 100
+#endif  // PW_SYNC_ADAPTIVE_MUTEX_SPIN_ITERATIONS
+
+namespace pw::sync {
+
+/// Contention counters kept by the adaptive `pw::sync::Mutex` backends.
+///
+/// The counters are updated while the mutex is held, so they are only
+/// consistent with each other when read with the mutex held.
+struct MutexContentionStats {
+  /// Successful `lock()` and `try_lock()` calls.
+  uint32_t acquisitions = 0;
+
+  /// `lock()` calls that found the mutex held by another thread.
+  uint32_t contended = 0;
+
+  /// Contended `lock()` calls that acquired the mutex while spinning, without
+  /// blocking.
+  uint32_t spin_acquisitions = 0;
+
+  /// Contended `lock()` calls that had to block.
+  uint32_t blocked() const { return contended - spin_acquisitions; }
+};
+
+namespace internal {
+
+// Acquires a lock by trying once, then retrying up to spin_iterations times,
+// then blocking, and records the outcome in stats once the lock is held.
+template <typename TryLock, typename Lock>
+void AdaptiveLock(MutexContentionStats& stats,
+                  uint32_t spin_iterations,
+                  TryLock&& try_lock,
+                  Lock&& lock) {
+  bool contended = false;
+  bool acquired_spinning = false;
+  if (!try_lock()) {
+    contended = true;
+    for (uint32_t i = 0; i < spin_iterations; ++i) {
+      PW_SYNC_YIELD_CORE_FOR_SMT();
+      if (try_lock()) {
+        acquired_spinning = true;
+        break;
+      }
+    }
+    if (!acquired_spinning) {
+      lock();
+    }
+  }
+
+  // The lock is held, which protects the counters.
+  stats.acquisitions += 1;
+  if (contended) {
+    stats.contended += 1;
+    if (acquired_spinning) {
+      stats.spin_acquisitions += 1;
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace pw::sync
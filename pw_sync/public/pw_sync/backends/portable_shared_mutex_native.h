@@ -0,0 +1,51 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_sync/binary_semaphore.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::sync::backend {
+
+// A writer-preferring reader-writer lock built from pw::sync::Mutex,
+// BinarySemaphore and InterruptSpinLock, for RTOSes without a native one.
+//
+// Writers hold writer_lock_ for the whole critical section. Readers only hold
+// it long enough to register, so a waiting writer keeps new readers out and
+// cannot be starved. The last reader to leave wakes a writer that is waiting
+// for the active readers to finish.
+class NativeSharedMutex {
+ public:
+  void lock() PW_NO_LOCK_SAFETY_ANALYSIS;
+  bool try_lock() PW_NO_LOCK_SAFETY_ANALYSIS;
+  void unlock() PW_NO_LOCK_SAFETY_ANALYSIS;
+  void lock_shared() PW_NO_LOCK_SAFETY_ANALYSIS;
+  bool try_lock_shared() PW_NO_LOCK_SAFETY_ANALYSIS;
+  void unlock_shared() PW_NO_LOCK_SAFETY_ANALYSIS;
+
+ private:
+  Mutex writer_lock_;
+  BinarySemaphore readers_done_;
+  InterruptSpinLock state_lock_;
+  uint32_t readers_ PW_GUARDED_BY(state_lock_) = 0;
+  bool writer_waiting_ PW_GUARDED_BY(state_lock_) = false;
+};
+
+using NativeSharedMutexHandle = NativeSharedMutex&;
+
+}  // namespace pw::sync::backend
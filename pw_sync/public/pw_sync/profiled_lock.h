@@ -0,0 +1,178 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/metric.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/lock_traits.h"
+
+// Whether pw::sync::ProfiledLock emits pw_trace events for contended waits and
+// for each hold of the lock, in addition to updating its metrics. The events
+// use the lock's name token as their trace ID.
+#ifndef PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+#define PW_SYNC_PROFILED_LOCK_TRACE_ENABLED 1
+#endif  // PW_SYNC_PROFILED_LOCK_TRACE_ENABLED
+
+namespace pw::sync {
+
+/// Contention metrics for one named lock, updated by `pw::sync::ProfiledLock`.
+///
+/// The metrics are only written while the lock is held, so they are
+/// consistent with each other when read with the lock held.
+class LockProfile {
+ public:
+  /// @param name The token of the lock's name, for example from
+  ///   `PW_TOKENIZE_STRING_DOMAIN("metrics", "flash_lock")`. It names the
+  ///   metric group and is the trace ID of the lock's trace events.
+  explicit LockProfile(metric::Token name) : metrics_(name) {}
+
+  LockProfile(const LockProfile&) = delete;
+  LockProfile& operator=(const LockProfile&) = delete;
+
+  metric::Group& metrics() { return metrics_; }
+  const metric::Group& metrics() const { return metrics_; }
+
+  uint32_t acquisitions() const { return acquisitions_.value(); }
+  uint32_t contended() const { return contended_.value(); }
+  uint32_t total_wait_us() const { return total_wait_us_.value(); }
+  uint32_t max_hold_us() const { return max_hold_us_.value(); }
+
+  // Hooks called by ProfiledLock.
+
+  // Called before blocking on a lock that is held elsewhere. Returns the time
+  // the wait started.
+  chrono::SystemClock::time_point WaitStarted();
+
+  // Called if a timed wait gives up. Does not touch the metrics, since the
+  // lock is not held.
+  void WaitAbandoned();
+
+  // Called with the lock held, after it was taken without waiting.
+  void Acquired();
+
+  // Called with the lock held, after it was taken following a wait that
+  // started at wait_start.
+  void Acquired(chrono::SystemClock::time_point wait_start);
+
+  // Called with the lock held, just before it is released.
+  void Releasing();
+
+ private:
+  chrono::SystemClock::time_point acquired_at_;
+
+  PW_METRIC_GROUP(metrics_, "lock");
+  PW_METRIC(metrics_, acquisitions_, "acquisitions", 0u);
+  PW_METRIC(metrics_, contended_, "contended", 0u);
+  PW_METRIC(metrics_, total_wait_us_, "total_wait_us", 0u);
+  PW_METRIC(metrics_, max_hold_us_, "max_hold_us", 0u);
+};
+
+/// Wraps a lock, such as a `pw::sync::Mutex`, `pw::sync::TimedMutex` or
+/// `pw::sync::InterruptSpinLock`, and profiles how it is contended.
+///
+/// Every acquisition first tries the lock without blocking; only when that
+/// fails does it count as contended and measure the wait. The lock's
+/// `pw::sync::LockProfile` records acquisitions, contended acquisitions, total
+/// wait time and maximum hold time, and may emit pw_trace events. A
+/// `ProfiledLock` is a drop-in replacement for the lock it wraps, including as
+/// the lock of a `pw::sync::Borrowable`.
+///
+/// Profiling reads the system clock on every acquisition and release, so use
+/// it on the locks under investigation rather than everywhere.
+template <typename Lock>
+class PW_LOCKABLE("pw::sync::ProfiledLock") ProfiledLock {
+ public:
+  static_assert(is_lockable_v<Lock>, "lock type must satisfy Lockable");
+
+  /// @param name The token of the lock's name; see `LockProfile`.
+  /// @param lock_args Arguments for the wrapped lock's constructor.
+  template <typename... LockArgs>
+  explicit ProfiledLock(metric::Token name, LockArgs&&... lock_args)
+      : lock_(std::forward<LockArgs>(lock_args)...), profile_(name) {}
+
+  ProfiledLock(const ProfiledLock&) = delete;
+  ProfiledLock& operator=(const ProfiledLock&) = delete;
+
+  void lock() PW_EXCLUSIVE_LOCK_FUNCTION() PW_NO_LOCK_SAFETY_ANALYSIS {
+    if (try_lock()) {
+      return;
+    }
+    const chrono::SystemClock::time_point wait_start = profile_.WaitStarted();
+    lock_.lock();
+    profile_.Acquired(wait_start);
+  }
+
+  bool try_lock() PW_EXCLUSIVE_TRYLOCK_FUNCTION(true)
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    if (!lock_.try_lock()) {
+      return false;
+    }
+    profile_.Acquired();
+    return true;
+  }
+
+  template <typename Duration,
+            int&... ExplicitArgumentBarrier,
+            typename T = Lock,
+            typename = std::enable_if_t<is_lockable_for_v<T, Duration>>>
+  bool try_lock_for(Duration timeout) PW_EXCLUSIVE_TRYLOCK_FUNCTION(true)
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    if (try_lock()) {
+      return true;
+    }
+    const chrono::SystemClock::time_point wait_start = profile_.WaitStarted();
+    return FinishTimedWait(lock_.try_lock_for(timeout), wait_start);
+  }
+
+  template <typename TimePoint,
+            int&... ExplicitArgumentBarrier,
+            typename T = Lock,
+            typename = std::enable_if_t<is_lockable_until_v<T, TimePoint>>>
+  bool try_lock_until(TimePoint deadline) PW_EXCLUSIVE_TRYLOCK_FUNCTION(true)
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    if (try_lock()) {
+      return true;
+    }
+    const chrono::SystemClock::time_point wait_start = profile_.WaitStarted();
+    return FinishTimedWait(lock_.try_lock_until(deadline), wait_start);
+  }
+
+  void unlock() PW_UNLOCK_FUNCTION() PW_NO_LOCK_SAFETY_ANALYSIS {
+    profile_.Releasing();
+    lock_.unlock();
+  }
+
+  LockProfile& profile() { return profile_; }
+  metric::Group& metrics() { return profile_.metrics(); }
+
+ private:
+  bool FinishTimedWait(bool acquired,
+                       chrono::SystemClock::time_point wait_start) {
+    if (!acquired) {
+      profile_.WaitAbandoned();
+      return false;
+    }
+    profile_.Acquired(wait_start);
+    return true;
+  }
+
+  Lock lock_;
+  LockProfile profile_;
+};
+
+}  // namespace pw::sync
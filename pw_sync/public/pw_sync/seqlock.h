@@ -0,0 +1,108 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::sync {
+
+/// A sequence lock, which protects a small value that is read far more often
+/// than it is written, including from interrupts.
+///
+/// Readers never block or mask interrupts. They copy the value and retry if a
+/// write happened during the copy, which they detect with a sequence counter
+/// that is odd while a write is in progress. Writers are serialized by an
+/// `InterruptSpinLock`, which also keeps readers on the same core from
+/// interrupting a write and spinning forever.
+///
+/// Both reads and writes are IRQ safe. `T` must be trivially copyable, and
+/// should be small, since every read copies it.
+template <typename T>
+class SeqLock {
+ public:
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SeqLock values are copied word by word");
+
+  SeqLock() : SeqLock(T{}) {}
+  explicit SeqLock(const T& value) { StoreWords(value); }
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  /// Replaces the value.
+  void Write(const T& value) PW_LOCKS_EXCLUDED(write_lock_) {
+    std::lock_guard lock(write_lock_);
+    const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    StoreWords(value);
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  /// Copies the value into `value` if no write was in progress or happened
+  /// during the copy. Returns false, leaving `value` unchanged, otherwise.
+  bool TryRead(T& value) const {
+    const uint32_t before = sequence_.load(std::memory_order_acquire);
+    if ((before & 1) != 0) {
+      return false;
+    }
+    std::array<uint32_t, kWords> words;
+    for (size_t i = 0; i < kWords; ++i) {
+      words[i] = words_[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) != before) {
+      return false;
+    }
+    std::memcpy(&value, words.data(), sizeof(T));
+    return true;
+  }
+
+  /// Returns a consistent copy of the value, retrying while writes interfere.
+  T Read() const {
+    T value;
+    while (!TryRead(value)) {
+    }
+    return value;
+  }
+
+ private:
+  static constexpr size_t kWords =
+      (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+  void StoreWords(const T& value) {
+    std::array<uint32_t, kWords> words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+    for (size_t i = 0; i < kWords; ++i) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+  }
+
+  InterruptSpinLock write_lock_;
+  std::atomic<uint32_t> sequence_{0};
+  // The value is stored as atomic words so that reads racing with a write are
+  // well defined; the sequence check discards any torn copy.
+  std::array<std::atomic<uint32_t>, kWords> words_{};
+};
+
+}  // namespace pw::sync
@@ -0,0 +1,64 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/seqlock.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace pw::sync {
+namespace {
+
+struct Sample {
+  uint32_t timestamp;
+  int16_t x;
+  int16_t y;
+  uint8_t flags;
+};
+
+TEST(SeqLock, DefaultConstructed_ReadsZero) {
+  SeqLock<uint64_t> seqlock;
+  EXPECT_EQ(seqlock.Read(), 0u);
+}
+
+TEST(SeqLock, Write_ThenRead) {
+  SeqLock<Sample> seqlock({1, 2, 3, 4});
+  Sample sample = seqlock.Read();
+  EXPECT_EQ(sample.timestamp, 1u);
+  EXPECT_EQ(sample.x, 2);
+
+  seqlock.Write({5, -6, 7, 8});
+  sample = seqlock.Read();
+  EXPECT_EQ(sample.timestamp, 5u);
+  EXPECT_EQ(sample.x, -6);
+  EXPECT_EQ(sample.y, 7);
+  EXPECT_EQ(sample.flags, 8u);
+}
+
+TEST(SeqLock, TryRead_SucceedsWithoutWriter) {
+  SeqLock<uint16_t> seqlock(42);
+  uint16_t value = 0;
+  ASSERT_TRUE(seqlock.TryRead(value));
+  EXPECT_EQ(value, 42u);
+}
+
+SeqLock<uint32_t> static_seqlock;
+TEST(SeqLock, Static) {
+  static_seqlock.Write(7);
+  EXPECT_EQ(static_seqlock.Read(), 7u);
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -0,0 +1,84 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <mutex>
+#include <shared_mutex>
+
+#include "gtest/gtest.h"
+#include "pw_sync/shared_mutex.h"
+
+namespace pw::sync {
+namespace {
+
+// TODO(b/235284163): Add real concurrency tests once we have pw::thread.
+
+TEST(SharedMutex, LockUnlock) {
+  SharedMutex mutex;
+  mutex.lock();
+  mutex.unlock();
+}
+
+SharedMutex static_shared_mutex;
+TEST(SharedMutex, LockUnlockStatic) {
+  static_shared_mutex.lock();
+  static_shared_mutex.unlock();
+}
+
+TEST(SharedMutex, TryLockUnlock) {
+  SharedMutex mutex;
+  const bool locked = mutex.try_lock();
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock();
+  }
+}
+
+TEST(SharedMutex, LockSharedUnlockShared) {
+  SharedMutex mutex;
+  mutex.lock_shared();
+  mutex.unlock_shared();
+}
+
+TEST(SharedMutex, TryLockSharedUnlockShared) {
+  SharedMutex mutex;
+  const bool locked = mutex.try_lock_shared();
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock_shared();
+  }
+}
+
+TEST(SharedMutex, ExclusiveAfterShared) {
+  SharedMutex mutex;
+  mutex.lock_shared();
+  mutex.unlock_shared();
+  mutex.lock();
+  mutex.unlock();
+}
+
+TEST(SharedMutex, StdLockHelpers) {
+  SharedMutex mutex;
+  int value = 0;
+  {
+    std::lock_guard lock(mutex);
+    value = 1;
+  }
+  {
+    std::shared_lock lock(mutex);
+    EXPECT_EQ(value, 1);
+  }
+}
+
+}  // namespace
+}  // namespace pw::sync
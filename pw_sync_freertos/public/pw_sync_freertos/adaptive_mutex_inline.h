@@ -0,0 +1,97 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "FreeRTOS.h"
+#include "pw_assert/assert.h"
+#include "pw_interrupt/context.h"
+#include "pw_sync/adaptive_lock.h"
+#include "pw_sync/mutex.h"
+#include "semphr.h"
+
+namespace pw::sync {
+namespace backend {
+
+static_assert(configUSE_MUTEXES != 0, "FreeRTOS mutexes aren't enabled.");
+
+static_assert(configSUPPORT_STATIC_ALLOCATION != 0,
+              "FreeRTOS static allocations are required for this backend.");
+
+// On a single core the owner cannot run while another task spins, so spinning
+// only delays blocking. Spin only on SMP builds of FreeRTOS.
+#if defined(configNUMBER_OF_CORES) && configNUMBER_OF_CORES > 1
+inline constexpr uint32_t kMutexSpinIterations =
+    PW_SYNC_ADAPTIVE_MUTEX_SPIN_ITERATIONS;
+#else
+inline constexpr uint32_t kMutexSpinIterations = 0;
+#endif  // configNUMBER_OF_CORES > 1
+
+}  // namespace backend
+
+inline Mutex::Mutex() : native_type_() {
+  const SemaphoreHandle_t handle =
+      xSemaphoreCreateMutexStatic(&native_type_.semaphore);
+  // This should never fail since the pointer provided was not null and it
+  // should return a pointer to the StaticSemaphore_t.
+  PW_DASSERT(handle == backend::MutexSemaphore(native_type_));
+}
+
+inline Mutex::~Mutex() {
+  vSemaphoreDelete(backend::MutexSemaphore(native_type_));
+}
+
+inline void Mutex::lock() {
+  // Enforce the pw::sync::Mutex IRQ contract.
+  PW_DASSERT(!interrupt::InInterruptContext());
+  const SemaphoreHandle_t handle = backend::MutexSemaphore(native_type_);
+  internal::AdaptiveLock(
+      native_type_.stats,
+      backend::kMutexSpinIterations,
+      [handle] { return xSemaphoreTake(handle, 0) == pdTRUE; },
+      [handle] {
+#if INCLUDE_vTaskSuspend == 1  // This means portMAX_DELAY is indefinite.
+        const BaseType_t result = xSemaphoreTake(handle, portMAX_DELAY);
+        PW_DASSERT(result == pdTRUE);
+#else
+        // In case we need to block for longer than the FreeRTOS delay can
+        // represent repeatedly hit take until success.
+        while (xSemaphoreTake(handle, chrono::freertos::kMaxTimeout.count()) ==
+               pdFALSE) {
+        }
+#endif  // INCLUDE_vTaskSuspend
+      });
+}
+
+inline bool Mutex::try_lock() {
+  // Enforce the pw::sync::Mutex IRQ contract.
+  PW_DASSERT(!interrupt::InInterruptContext());
+  if (xSemaphoreTake(backend::MutexSemaphore(native_type_), 0) == pdTRUE) {
+    native_type_.stats.acquisitions += 1;
+    return true;
+  }
+  return false;
+}
+
+inline void Mutex::unlock() {
+  // Enforce the pw::sync::Mutex IRQ contract.
+  PW_DASSERT(!interrupt::InInterruptContext());
+  // Unlocking only fails if it was not locked first.
+  PW_ASSERT(xSemaphoreGive(backend::MutexSemaphore(native_type_)) == pdTRUE);
+}
+
+inline Mutex::native_handle_type Mutex::native_handle() { return native_type_; }
+
+}  // namespace pw::sync
@@ -0,0 +1,38 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "FreeRTOS.h"
+#include "pw_sync/adaptive_lock.h"
+#include "semphr.h"
+
+namespace pw::sync::backend {
+
+// Adaptive variant of the FreeRTOS NativeMutex, which spins before blocking
+// and counts contention.
+struct NativeMutex {
+  const MutexContentionStats& contention_stats() const { return stats; }
+
+  StaticSemaphore_t semaphore;
+  MutexContentionStats stats;
+};
+
+// The whole NativeMutex is exposed so that callers can read contention_stats().
+using NativeMutexHandle = NativeMutex&;
+
+inline SemaphoreHandle_t MutexSemaphore(NativeMutex& mutex) {
+  return reinterpret_cast<SemaphoreHandle_t>(&mutex.semaphore);
+}
+
+}  // namespace pw::sync::backend
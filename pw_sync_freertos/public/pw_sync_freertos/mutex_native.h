@@ -21,4 +21,8 @@ namespace pw::sync::backend {
 using NativeMutex = StaticSemaphore_t;
 using NativeMutexHandle = NativeMutex&;
 
+inline SemaphoreHandle_t MutexSemaphore(NativeMutex& mutex) {
+  return reinterpret_cast<SemaphoreHandle_t>(&mutex);
+}
+
 }  // namespace pw::sync::backend
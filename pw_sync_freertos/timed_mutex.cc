@@ -44,7 +44,7 @@ bool TimedMutex::try_lock_for(SystemClock::duration timeout) {
   constexpr SystemClock::duration kMaxTimeoutMinusOne =
       pw::chrono::freertos::kMaxTimeout - SystemClock::duration(1);
   while (timeout > kMaxTimeoutMinusOne) {
-    if (xSemaphoreTake(reinterpret_cast<SemaphoreHandle_t>(&native_handle()),
+    if (xSemaphoreTake(backend::MutexSemaphore(native_type()),
                        static_cast<TickType_t>(kMaxTimeoutMinusOne.count())) ==
         pdTRUE) {
       return true;
@@ -53,7 +53,7 @@ bool TimedMutex::try_lock_for(SystemClock::duration timeout) {
   }
   // On a tick based kernel we cannot tell how far along we are on the current
   // tick, ergo we add one whole tick to the final duration.
-  return xSemaphoreTake(reinterpret_cast<SemaphoreHandle_t>(&native_handle()),
+  return xSemaphoreTake(backend::MutexSemaphore(native_type()),
                         static_cast<TickType_t>(timeout.count() + 1)) == pdTRUE;
 }
 
@@ -0,0 +1,73 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <mutex>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::sync {
+namespace {
+
+TEST(AdaptiveMutex, Uncontended_CountsAcquisitions) {
+  Mutex mutex;
+  mutex.lock();
+  mutex.unlock();
+  ASSERT_TRUE(mutex.try_lock());
+  mutex.unlock();
+
+  const MutexContentionStats& stats = mutex.native_handle().contention_stats();
+  EXPECT_EQ(stats.acquisitions, 2u);
+  EXPECT_EQ(stats.contended, 0u);
+  EXPECT_EQ(stats.spin_acquisitions, 0u);
+}
+
+TEST(AdaptiveMutex, FailedTryLock_NotCounted) {
+  Mutex mutex;
+  mutex.lock();
+  std::thread other([&mutex] { EXPECT_FALSE(mutex.try_lock()); });
+  other.join();
+  mutex.unlock();
+
+  EXPECT_EQ(mutex.native_handle().contention_stats().acquisitions, 1u);
+}
+
+TEST(AdaptiveMutex, Contended_CountsEveryAcquisition) {
+  constexpr uint32_t kIterations = 10000;
+  Mutex mutex;
+  uint32_t counter = 0;
+
+  auto increment = [&mutex, &counter] {
+    for (uint32_t i = 0; i < kIterations; ++i) {
+      std::lock_guard lock(mutex);
+      counter += 1;
+    }
+  };
+  std::thread first(increment);
+  std::thread second(increment);
+  first.join();
+  second.join();
+
+  std::lock_guard lock(mutex);
+  const MutexContentionStats& stats = mutex.native_handle().contention_stats();
+  EXPECT_EQ(counter, 2 * kIterations);
+  EXPECT_EQ(stats.acquisitions, 2 * kIterations + 1);
+  EXPECT_LE(stats.contended, stats.acquisitions);
+  EXPECT_LE(stats.spin_acquisitions, stats.contended);
+  EXPECT_EQ(stats.blocked(), stats.contended - stats.spin_acquisitions);
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -0,0 +1,40 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <mutex>
+
+#include "pw_sync/adaptive_lock.h"
+
+namespace pw::sync::backend {
+
+// Adaptive variant of the STL NativeMutex, which spins before blocking and
+// counts contention. Like NativeMutex, it tracks the locked state so that
+// misuse hits a PW_CHECK.
+struct NativeMutex {
+  // The locked state is tracked in a variable. This function asserts if the
+  // state is inconsistent (e.g. unlocking an unlocked mutex).
+  void SetLockedState(bool new_state);
+
+  const MutexContentionStats& contention_stats() const { return stats; }
+
+  std::timed_mutex mutex;
+  bool locked = false;
+  MutexContentionStats stats;
+};
+
+// The whole NativeMutex is exposed so that callers can read contention_stats().
+using NativeMutexHandle = NativeMutex&;
+
+}  // namespace pw::sync::backend
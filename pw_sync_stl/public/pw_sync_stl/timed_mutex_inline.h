@@ -19,7 +19,7 @@
 namespace pw::sync {
 
 inline bool TimedMutex::try_lock_for(chrono::SystemClock::duration timeout) {
-  if (native_handle().try_lock_for(timeout)) {
+  if (native_type().mutex.try_lock_for(timeout)) {
     native_type().SetLockedState(true);
     return true;
   }
@@ -28,7 +28,7 @@ inline bool TimedMutex::try_lock_for(chrono::SystemClock::duration timeout) {
 
 inline bool TimedMutex::try_lock_until(
     chrono::SystemClock::time_point deadline) {
-  if (native_handle().try_lock_until(deadline)) {
+  if (native_type().mutex.try_lock_until(deadline)) {
     native_type().SetLockedState(true);
     return true;
   }
@@ -99,11 +99,12 @@ StatusWithSize WriteLine(const std::string_view& s);
 
 /// Fills a byte span from the `pw_sys_io` backend using `ReadByte()`.
 ///
-/// This function is implemented by the facade and simply uses `ReadByte()` to
-/// read enough bytes to fill the destination span. If there's an error reading
-/// a byte, the read is aborted and the contents of the destination span are
-/// undefined. This function blocks until either an error occurs or all bytes
-/// are successfully read from the backend's `ReadByte()` implementation.
+/// The default implementation, from the `default_putget_bytes` target, simply
+/// uses `ReadByte()` to read enough bytes to fill the destination span.
+/// Backends may instead implement this function to read in bulk. If there's an
+/// error reading a byte, the read is aborted and the contents of the
+/// destination span are undefined. This function blocks until either an error
+/// occurs or all bytes are successfully read.
 ///
 /// @returns
 /// * @pw_status{OK} if the destination span was successfully filled. In all
@@ -113,11 +114,12 @@ StatusWithSize ReadBytes(ByteSpan dest);
 
 /// Writes a span of bytes out the `pw_sys_io` backend using `WriteByte()`.
 ///
-/// This function is implemented by the facade and simply writes the source
-/// contents using `WriteByte()`. If an error writing a byte is encountered, the
-/// write is aborted and the error status is returned. This function blocks
-/// until either an error occurs, or all bytes are successfully written from the
-/// backend's `WriteByte()` implementation.
+/// The default implementation, from the `default_putget_bytes` target, simply
+/// writes the source contents using `WriteByte()`. Backends may instead
+/// implement this function to write in bulk. If an error writing a byte is
+/// encountered, the write is aborted and the error status is returned. This
+/// function blocks until either an error occurs, or all bytes are successfully
+/// written.
 ///
 /// @returns
 /// * @pw_status{OK} if all the bytes from the source span were successfully
@@ -57,3 +57,27 @@
 #ifndef PW_SYS_IO_STM32CUBE_USART_PREFIX
 #define PW_SYS_IO_STM32CUBE_USART_PREFIX USART
 #endif  // PW_SYS_IO_STM32CUBE_GPIO_AF
+
+// Whether to transmit and receive from the USART interrupt instead of polling.
+// Received bytes are queued in a ring buffer, and writes return once the data
+// is queued for transmission. This defines the USART's IRQ handler.
+#ifndef PW_SYS_IO_STM32CUBE_INTERRUPT_DRIVEN
+#define PW_SYS_IO_STM32CUBE_INTERRUPT_DRIVEN 0
+#endif  // PW_SYS_IO_STM32CUBE_INTERRUPT_DRIVEN
+
+// The size of the receive ring buffer in interrupt-driven mode. Must be a power
+// of two. Bytes received while the buffer is full are dropped.
+#ifndef PW_SYS_IO_STM32CUBE_RX_BUFFER_SIZE
+#define PW_SYS_IO_STM32CUBE_RX_BUFFER_SIZE 256
+#endif  // PW_SYS_IO_STM32CUBE_RX_BUFFER_SIZE
+
+// The size of the transmit ring buffer in interrupt-driven mode. Must be a
+// power of two. Writes block while the buffer is full.
+#ifndef PW_SYS_IO_STM32CUBE_TX_BUFFER_SIZE
+#define PW_SYS_IO_STM32CUBE_TX_BUFFER_SIZE 256
+#endif  // PW_SYS_IO_STM32CUBE_TX_BUFFER_SIZE
+
+// The NVIC priority of the USART interrupt in interrupt-driven mode.
+#ifndef PW_SYS_IO_STM32CUBE_IRQ_PRIORITY
+#define PW_SYS_IO_STM32CUBE_IRQ_PRIORITY 5
+#endif  // PW_SYS_IO_STM32CUBE_IRQ_PRIORITY
@@ -14,7 +14,10 @@
 
 #include "pw_sys_io/sys_io.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <cstdint>
 
 #include "pw_preprocessor/concat.h"
 #include "pw_status/status.h"
@@ -59,8 +62,157 @@
             PW_SYS_IO_STM32CUBE_USART_NUM,    \
             _CLK_ENABLE)
 
+// USART_IRQN defined to USARTn_IRQn, and USART_IRQ_HANDLER to
+// USARTn_IRQHandler, where n is the USART peripheral index.
+#define USART_IRQN                            \
+  PW_CONCAT(PW_SYS_IO_STM32CUBE_USART_PREFIX, \
+            PW_SYS_IO_STM32CUBE_USART_NUM,    \
+            _IRQn)
+
+#define USART_IRQ_HANDLER                     \
+  PW_CONCAT(PW_SYS_IO_STM32CUBE_USART_PREFIX, \
+            PW_SYS_IO_STM32CUBE_USART_NUM,    \
+            _IRQHandler)
+
 static UART_HandleTypeDef uart;
 
+#if PW_SYS_IO_STM32CUBE_INTERRUPT_DRIVEN
+
+namespace {
+
+// A ring buffer of bytes with one producer and one consumer, one of which is
+// the USART interrupt. The positions count up freely; kSize must be a power of
+// two so that they index the buffer correctly when they wrap.
+template <uint32_t kSize>
+class ByteQueue {
+ public:
+  static_assert(kSize > 0u && (kSize & (kSize - 1u)) == 0u,
+                "The buffer size must be a power of two");
+
+  uint32_t size() const {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0u; }
+  bool full() const { return size() == kSize; }
+
+  // Producer side.
+  void push(std::byte b) {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    buffer_[head % kSize] = b;
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  // Consumer side.
+  std::byte pop() {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    const std::byte b = buffer_[tail % kSize];
+    tail_.store(tail + 1, std::memory_order_release);
+    return b;
+  }
+
+  // Returns the queued bytes that are contiguous in the buffer.
+  uint8_t* contiguous_data(uint32_t* size_bytes) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    *size_bytes = std::min(size(), kSize - tail % kSize);
+    return reinterpret_cast<uint8_t*>(&buffer_[tail % kSize]);
+  }
+
+  void discard(uint32_t size_bytes) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    tail_.store(tail + size_bytes, std::memory_order_release);
+  }
+
+ private:
+  std::byte buffer_[kSize];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+};
+
+ByteQueue<PW_SYS_IO_STM32CUBE_RX_BUFFER_SIZE> rx_queue;
+ByteQueue<PW_SYS_IO_STM32CUBE_TX_BUFFER_SIZE> tx_queue;
+
+uint8_t rx_byte;
+uint32_t tx_in_flight = 0;  // Bytes passed to HAL_UART_Transmit_IT().
+
+void ReceiveNextByte() { HAL_UART_Receive_IT(&uart, &rx_byte, 1); }
+
+// Starts transmitting the queued data if no transmission is in progress. Must
+// be called from the USART interrupt or with it disabled.
+void TransmitQueuedData() {
+  if (tx_in_flight != 0u || tx_queue.empty()) {
+    return;
+  }
+  uint32_t size;
+  uint8_t* data = tx_queue.contiguous_data(&size);
+  tx_in_flight = std::min<uint32_t>(size, UINT16_MAX);
+  HAL_UART_Transmit_IT(&uart, data, static_cast<uint16_t>(tx_in_flight));
+}
+
+void OnReceiveComplete(UART_HandleTypeDef* huart) {
+  if (huart != &uart) {
+    return;
+  }
+  // There is nowhere to wait in an interrupt, so bytes that do not fit are
+  // dropped.
+  if (!rx_queue.full()) {
+    rx_queue.push(static_cast<std::byte>(rx_byte));
+  }
+  ReceiveNextByte();
+}
+
+void OnTransmitComplete(UART_HandleTypeDef* huart) {
+  if (huart != &uart) {
+    return;
+  }
+  tx_queue.discard(tx_in_flight);
+  tx_in_flight = 0;
+  TransmitQueuedData();
+}
+
+// The HAL stops receiving after errors such as overruns, so start again.
+void OnError(UART_HandleTypeDef* huart) {
+  if (huart == &uart && huart->RxState == HAL_UART_STATE_READY) {
+    ReceiveNextByte();
+  }
+}
+
+}  // namespace
+
+extern "C" void USART_IRQ_HANDLER() { HAL_UART_IRQHandler(&uart); }
+
+#if defined(USE_HAL_UART_REGISTER_CALLBACKS) && USE_HAL_UART_REGISTER_CALLBACKS
+
+static void RegisterCallbacks() {
+  HAL_UART_RegisterCallback(
+      &uart, HAL_UART_RX_COMPLETE_CB_ID, OnReceiveComplete);
+  HAL_UART_RegisterCallback(
+      &uart, HAL_UART_TX_COMPLETE_CB_ID, OnTransmitComplete);
+  HAL_UART_RegisterCallback(&uart, HAL_UART_ERROR_CB_ID, OnError);
+}
+
+#else
+
+static void RegisterCallbacks() {}
+
+// Without registered callbacks, the HAL calls these weak functions for every
+// UART. They ignore UARTs other than the one used by pw_sys_io.
+extern "C" void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart) {
+  OnReceiveComplete(huart);
+}
+
+extern "C" void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+  OnTransmitComplete(huart);
+}
+
+extern "C" void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) {
+  OnError(huart);
+}
+
+#endif  // USE_HAL_UART_REGISTER_CALLBACKS
+
+#endif  // PW_SYS_IO_STM32CUBE_INTERRUPT_DRIVEN
+
 extern "C" void pw_sys_io_Init() {
   GPIO_InitTypeDef GPIO_InitStruct = {};
 
@@ -91,30 +243,107 @@ extern "C" void pw_sys_io_Init() {
   uart.Init.HwFlowCtl = UART_HWCONTROL_NONE;
   uart.Init.OverSampling = UART_OVERSAMPLING_16;
   HAL_UART_Init(&uart);
+
+#if PW_SYS_IO_STM32CUBE_INTERRUPT_DRIVEN
+  RegisterCallbacks();
+  HAL_NVIC_SetPriority(USART_IRQN, PW_SYS_IO_STM32CUBE_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(USART_IRQN);
+  ReceiveNextByte();
+#endif  // PW_SYS_IO_STM32CUBE_INTERRUPT_DRIVEN
 }
 
-// This whole implementation is very inefficient because it uses the synchronous
-// polling UART API and only reads / writes 1 byte at a time.
 namespace pw::sys_io {
+
+#if PW_SYS_IO_STM32CUBE_INTERRUPT_DRIVEN
+
 Status ReadByte(std::byte* dest) {
-  if (HAL_UART_Receive(
-          &uart, reinterpret_cast<uint8_t*>(dest), 1, HAL_MAX_DELAY) !=
-      HAL_OK) {
-    return Status::ResourceExhausted();
+  while (rx_queue.empty()) {
   }
+  *dest = rx_queue.pop();
   return OkStatus();
 }
 
-Status TryReadByte(std::byte* dest) { return Status::Unimplemented(); }
-
-Status WriteByte(std::byte b) {
-  if (HAL_UART_Transmit(
-          &uart, reinterpret_cast<uint8_t*>(&b), 1, HAL_MAX_DELAY) != HAL_OK) {
-    return Status::ResourceExhausted();
+Status TryReadByte(std::byte* dest) {
+  if (rx_queue.empty()) {
+    return Status::Unavailable();
   }
+  *dest = rx_queue.pop();
   return OkStatus();
 }
 
+StatusWithSize ReadBytes(ByteSpan dest) {
+  for (std::byte& b : dest) {
+    ReadByte(&b).IgnoreError();  // Always succeeds.
+  }
+  return StatusWithSize(dest.size_bytes());
+}
+
+Status WriteByte(std::byte b) { return WriteBytes(span(&b, 1)).status(); }
+
+StatusWithSize WriteBytes(ConstByteSpan src) {
+  for (size_t i = 0; i < src.size_bytes();) {
+    // Wait for the interrupt to make room if the queue is full.
+    while (tx_queue.full()) {
+    }
+    while (i < src.size_bytes() && !tx_queue.full()) {
+      tx_queue.push(src[i++]);
+    }
+
+    HAL_NVIC_DisableIRQ(USART_IRQN);
+    TransmitQueuedData();
+    HAL_NVIC_EnableIRQ(USART_IRQN);
+  }
+  return StatusWithSize(src.size_bytes());
+}
+
+#else
+
+// This implementation uses the synchronous polling UART API, so the CPU is
+// busy for the duration of every read and write.
+Status ReadByte(std::byte* dest) {
+  return ReadBytes(span(dest, 1)).status();
+}
+
+Status TryReadByte(std::byte*) { return Status::Unimplemented(); }
+
+StatusWithSize ReadBytes(ByteSpan dest) {
+  size_t read = 0;
+  while (read < dest.size_bytes()) {
+    const uint16_t size = static_cast<uint16_t>(
+        std::min<size_t>(dest.size_bytes() - read, UINT16_MAX));
+    if (HAL_UART_Receive(&uart,
+                         reinterpret_cast<uint8_t*>(dest.data() + read),
+                         size,
+                         HAL_MAX_DELAY) != HAL_OK) {
+      return StatusWithSize::ResourceExhausted(read);
+    }
+    read += size;
+  }
+  return StatusWithSize(read);
+}
+
+Status WriteByte(std::byte b) { return WriteBytes(span(&b, 1)).status(); }
+
+StatusWithSize WriteBytes(ConstByteSpan src) {
+  size_t written = 0;
+  while (written < src.size_bytes()) {
+    const uint16_t size = static_cast<uint16_t>(
+        std::min<size_t>(src.size_bytes() - written, UINT16_MAX));
+    // Older HAL versions take a non-const pointer, but don't modify the data.
+    if (HAL_UART_Transmit(&uart,
+                          reinterpret_cast<uint8_t*>(
+                              const_cast<std::byte*>(src.data() + written)),
+                          size,
+                          HAL_MAX_DELAY) != HAL_OK) {
+      return StatusWithSize::ResourceExhausted(written);
+    }
+    written += size;
+  }
+  return StatusWithSize(written);
+}
+
+#endif  // PW_SYS_IO_STM32CUBE_INTERRUPT_DRIVEN
+
 // Writes a string using pw::sys_io, and add newline characters at the end.
 StatusWithSize WriteLine(const std::string_view& s) {
   size_t chars_written = 0;
@@ -27,16 +27,57 @@
 #include "pw_system/io.h"
 #include "pw_system/rpc_server.h"
 
+#if PW_SYSTEM_ENABLE_PIPELINE_METRICS
+#include "pw_metric/global.h"
+#include "pw_stream/stream.h"
+#include "pw_system_private/pipeline_metrics.h"
+#endif  // PW_SYSTEM_ENABLE_PIPELINE_METRICS
+
 namespace pw::system {
 namespace {
 
 constexpr size_t kMaxTransmissionUnit = PW_SYSTEM_MAX_TRANSMISSION_UNIT;
 
+#if PW_SYSTEM_ENABLE_PIPELINE_METRICS
+
+PW_METRIC_GROUP_GLOBAL(transport_metric_group, "transport");
+PW_METRIC(transport_metric_group, bytes_written, "bytes_written", 0u);
+PW_METRIC(transport_metric_group, write_errors, "write_errors", 0u);
+// Time spent writing HDLC frames, which carry RPC packets and logs, to the
+// target's I/O.
+PW_METRIC(transport_metric_group, write_ticks_total, "write_ticks_total", 0u);
+PW_METRIC(transport_metric_group, write_ticks_max, "write_ticks_max", 0u);
+
+// Forwards writes to the target's I/O writer, timing each one.
+class TimedWriter final : public stream::NonSeekableWriter {
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    StageTimer timer(write_ticks_total, write_ticks_max);
+    const Status status = GetWriter().Write(data);
+    if (status.ok()) {
+      bytes_written.Increment(static_cast<uint32_t>(data.size()));
+    } else {
+      write_errors.Increment();
+    }
+    return status;
+  }
+};
+
+TimedWriter timed_writer;
+
+stream::Writer& OutputWriter() { return timed_writer; }
+
+#else
+
+stream::Writer& OutputWriter() { return GetWriter(); }
+
+#endif  // PW_SYSTEM_ENABLE_PIPELINE_METRICS
+
 static_assert(kMaxTransmissionUnit ==
               hdlc::MaxEncodedFrameSize(rpc::cfg::kEncodingBufferSizeBytes));
 
 hdlc::FixedMtuChannelOutput<kMaxTransmissionUnit> hdlc_channel_output(
-    GetWriter(), PW_SYSTEM_DEFAULT_RPC_HDLC_ADDRESS, "HDLC channel");
+    OutputWriter(), PW_SYSTEM_DEFAULT_RPC_HDLC_ADDRESS, "HDLC channel");
 rpc::Channel channels[] = {
     rpc::Channel::Create<kDefaultRpcChannelId>(&hdlc_channel_output)};
 rpc::Server server(channels);
@@ -15,6 +15,10 @@
 
 #include "pw_system/init.h"
 
+#include <chrono>
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
 #include "pw_log/log.h"
 #include "pw_metric/global.h"
 #include "pw_metric/metric_service_pwpb.h"
@@ -25,11 +29,16 @@
 #include "pw_system/work_queue.h"
 #include "pw_system_private/log.h"
 #include "pw_thread/detached_thread.h"
+#include "pw_trace/trace.h"
 
 #if PW_SYSTEM_ENABLE_THREAD_SNAPSHOT_SERVICE
 #include "pw_system/thread_snapshot_service.h"
 #endif  // PW_SYSTEM_ENABLE_THREAD_SNAPSHOT_SERVICE
 
+#if PW_SYSTEM_ENABLE_LOAD_GENERATOR
+#include "pw_system_private/load_generator.h"
+#endif  // PW_SYSTEM_ENABLE_LOAD_GENERATOR
+
 namespace pw::system {
 namespace {
 metric::MetricService metric_service(metric::global_metrics,
@@ -37,8 +46,65 @@ metric::MetricService metric_service(metric::global_metrics,
 
 rpc::EchoService echo_service;
 
-void InitImpl() {
-  PW_LOG_INFO("System init");
+// How long each step of init took, in microseconds. The steps are also traced
+// with pw_trace.
+PW_METRIC_GROUP_GLOBAL(boot_metric_group, "boot");
+PW_METRIC(boot_metric_group, start_work_queue_us, "start_work_queue_us", 0u);
+PW_METRIC(boot_metric_group, core_services_us, "core_services_us", 0u);
+PW_METRIC(boot_metric_group,
+          noncritical_services_us,
+          "noncritical_services_us",
+          0u);
+PW_METRIC(boot_metric_group, user_app_init_us, "user_app_init_us", 0u);
+// From the call to Init() until UserAppInit() starts.
+PW_METRIC(boot_metric_group,
+          time_to_user_app_init_us,
+          "time_to_user_app_init_us",
+          0u);
+
+chrono::SystemClock::time_point init_start;
+
+uint32_t MicrosecondsSince(chrono::SystemClock::time_point start) {
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          chrono::SystemClock::now() - start)
+          .count());
+}
+
+// Records how long a step of init takes, from construction to destruction.
+class BootStepTimer {
+ public:
+  explicit BootStepTimer(metric::TypedMetric<uint32_t>& duration_us)
+      : duration_us_(duration_us), start_(chrono::SystemClock::now()) {}
+
+  BootStepTimer(const BootStepTimer&) = delete;
+  BootStepTimer& operator=(const BootStepTimer&) = delete;
+
+  ~BootStepTimer() { duration_us_.Set(MicrosecondsSince(start_)); }
+
+ private:
+  metric::TypedMetric<uint32_t>& duration_us_;
+  const chrono::SystemClock::time_point start_;
+};
+
+// Starts the services needed to communicate with the device.
+void StartCoreServices() {
+  PW_TRACE_SCOPE("StartCoreServices", "pw_system");
+  BootStepTimer timer(core_services_us);
+
+  PW_LOG_INFO("Registering RPC services");
+  GetRpcServer().RegisterService(echo_service);
+  GetRpcServer().RegisterService(GetLogService());
+
+  PW_LOG_INFO("Starting RPC thread");
+  thread::DetachedThread(system::RpcThreadOptions(), GetRpcDispatchThread());
+}
+
+// Starts the log drain and the services that only report on the system. Logs
+// are buffered until the log thread starts.
+void StartNoncriticalServices() {
+  PW_TRACE_SCOPE("StartNoncriticalServices", "pw_system");
+  BootStepTimer timer(noncritical_services_us);
 
   // Setup logging.
   const Status status = GetLogThread().OpenUnrequestedLogStream(
@@ -48,26 +114,64 @@ void InitImpl() {
                  static_cast<int>(status.code()));
   }
 
-  PW_LOG_INFO("Registering RPC services");
-  GetRpcServer().RegisterService(echo_service);
-  GetRpcServer().RegisterService(GetLogService());
   GetRpcServer().RegisterService(metric_service);
 #if PW_SYSTEM_ENABLE_THREAD_SNAPSHOT_SERVICE
   RegisterThreadSnapshotService(GetRpcServer());
 #endif  // PW_SYSTEM_ENABLE_THREAD_SNAPSHOT_SERVICE
 
-  PW_LOG_INFO("Starting threads");
-  // Start threads.
+  PW_LOG_INFO("Starting log thread");
   thread::DetachedThread(system::LogThreadOptions(), GetLogThread());
-  thread::DetachedThread(system::RpcThreadOptions(), GetRpcDispatchThread());
 
-  GetWorkQueue().CheckPushWork(UserAppInit);
+#if PW_SYSTEM_ENABLE_LOAD_GENERATOR
+  StartLoadGenerator();
+#endif  // PW_SYSTEM_ENABLE_LOAD_GENERATOR
+}
+
+void RunUserAppInit() {
+  time_to_user_app_init_us.Set(MicrosecondsSince(init_start));
+
+  PW_TRACE_SCOPE("UserAppInit", "pw_system");
+  BootStepTimer timer(user_app_init_us);
+  UserAppInit();
+}
+
+void ReportBootTimes() {
+  PW_LOG_INFO(
+      "Boot times (us): work queue %u, core services %u, noncritical services "
+      "%u, time to user init %u, user init %u",
+      static_cast<unsigned>(start_work_queue_us.value()),
+      static_cast<unsigned>(core_services_us.value()),
+      static_cast<unsigned>(noncritical_services_us.value()),
+      static_cast<unsigned>(time_to_user_app_init_us.value()),
+      static_cast<unsigned>(user_app_init_us.value()));
+}
+
+void InitImpl() {
+  PW_LOG_INFO("System init");
+
+  StartCoreServices();
+
+#if PW_SYSTEM_DEFER_NONCRITICAL_SERVICES
+  // Run the user's init first, and start the other services once it returns.
+  GetWorkQueue().CheckPushWork(RunUserAppInit);
+  GetWorkQueue().CheckPushWork(StartNoncriticalServices);
+#else
+  StartNoncriticalServices();
+  GetWorkQueue().CheckPushWork(RunUserAppInit);
+#endif  // PW_SYSTEM_DEFER_NONCRITICAL_SERVICES
+
+  GetWorkQueue().CheckPushWork(ReportBootTimes);
 }
 
 }  // namespace
 
 void Init() {
-  thread::DetachedThread(system::WorkQueueThreadOptions(), GetWorkQueue());
+  PW_TRACE_SCOPE("Init", "pw_system");
+  init_start = chrono::SystemClock::now();
+  {
+    BootStepTimer timer(start_work_queue_us);
+    thread::DetachedThread(system::WorkQueueThreadOptions(), GetWorkQueue());
+  }
   GetWorkQueue().CheckPushWork(InitImpl);
 }
 
@@ -0,0 +1,85 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "LOAD"
+
+#include "pw_system_private/load_generator.h"
+
+#include <chrono>
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_log/log.h"
+#include "pw_metric/global.h"
+#include "pw_system/config.h"
+#include "pw_system/work_queue.h"
+#include "pw_thread/sleep.h"
+
+namespace pw::system {
+namespace {
+
+constexpr uint32_t kLogsPerBurst = PW_SYSTEM_LOAD_GENERATOR_LOGS_PER_BURST;
+constexpr uint32_t kBursts = PW_SYSTEM_LOAD_GENERATOR_BURSTS;
+constexpr auto kBurstPeriod = chrono::SystemClock::for_at_least(
+    std::chrono::milliseconds(PW_SYSTEM_LOAD_GENERATOR_BURST_PERIOD_MS));
+
+PW_METRIC_GROUP_GLOBAL(load_metric_group, "load_generator");
+PW_METRIC(load_metric_group, bursts, "bursts", 0u);
+PW_METRIC(load_metric_group, logs_emitted, "logs_emitted", 0u);
+// Ticks spent in PW_LOG calls, and ticks since the load generator started. The
+// ratio between the two is the share of CPU time taken by emitting logs.
+PW_METRIC(load_metric_group, busy_ticks, "busy_ticks", 0u);
+PW_METRIC(load_metric_group, elapsed_ticks, "elapsed_ticks", 0u);
+
+chrono::SystemClock::time_point start_time;
+
+void RunBurst() {
+  const chrono::SystemClock::time_point burst_start =
+      chrono::SystemClock::now();
+  for (uint32_t i = 0; i < kLogsPerBurst; ++i) {
+    PW_LOG_INFO("Synthetic load %u.%u with payload %08x",
+                static_cast<unsigned>(bursts.value()),
+                static_cast<unsigned>(i),
+                static_cast<unsigned>(0x5eed0000u + i));
+  }
+  const chrono::SystemClock::time_point burst_end = chrono::SystemClock::now();
+
+  busy_ticks.Increment(
+      static_cast<uint32_t>((burst_end - burst_start).count()));
+  elapsed_ticks.Set(static_cast<uint32_t>((burst_end - start_time).count()));
+  logs_emitted.Increment(kLogsPerBurst);
+  bursts.Increment();
+
+  if (bursts.value() == kBursts) {
+    PW_LOG_INFO("Load generation complete; read results from metrics");
+    return;
+  }
+
+  // Wait out the period before queueing the next burst, so the log drain can
+  // catch up. Work queued in the meantime runs before the next burst.
+  this_thread::sleep_for(kBurstPeriod);
+  GetWorkQueue().CheckPushWork(RunBurst);
+}
+
+}  // namespace
+
+void StartLoadGenerator() {
+  PW_LOG_INFO("Starting load generation: %u bursts of %u logs",
+              static_cast<unsigned>(kBursts),
+              static_cast<unsigned>(kLogsPerBurst));
+  start_time = chrono::SystemClock::now();
+  GetWorkQueue().CheckPushWork(RunBurst);
+}
+
+}  // namespace pw::system
@@ -31,6 +31,10 @@
 #include "pw_system/config.h"
 #include "pw_system_private/log.h"
 
+#if PW_SYSTEM_ENABLE_PIPELINE_METRICS
+#include "pw_system_private/pipeline_metrics.h"
+#endif  // PW_SYSTEM_ENABLE_PIPELINE_METRICS
+
 namespace pw::system {
 namespace {
 
@@ -39,6 +43,12 @@ PW_METRIC_GROUP_GLOBAL(log_metric_group, "log");
 PW_METRIC(log_metric_group, total_created, "total_created", 0u);
 PW_METRIC(log_metric_group, total_dropped, "total_dropped", 0u);
 
+#if PW_SYSTEM_ENABLE_PIPELINE_METRICS
+// Time spent encoding each log and adding it to the log buffer.
+PW_METRIC(log_metric_group, ingest_ticks_total, "ingest_ticks_total", 0u);
+PW_METRIC(log_metric_group, ingest_ticks_max, "ingest_ticks_max", 0u);
+#endif  // PW_SYSTEM_ENABLE_PIPELINE_METRICS
+
 // Buffer used to encode each log entry before saving into log buffer.
 sync::InterruptSpinLock log_encode_lock;
 std::array<std::byte, PW_SYSTEM_MAX_LOG_ENTRY_SIZE> log_encode_buffer
@@ -69,6 +79,9 @@ extern "C" void pw_log_tokenized_HandleLog(uint32_t payload,
   const int64_t timestamp = GetTimestamp();
 
   std::lock_guard lock(log_encode_lock);
+#if PW_SYSTEM_ENABLE_PIPELINE_METRICS
+  StageTimer ingest_timer(ingest_ticks_total, ingest_ticks_max);
+#endif  // PW_SYSTEM_ENABLE_PIPELINE_METRICS
   Result<ConstByteSpan> encoded_log_result = log::EncodeTokenizedLog(
       metadata, message, size_bytes, timestamp, log_encode_buffer);
   if (!encoded_log_result.ok()) {
@@ -92,6 +105,9 @@ extern "C" void pw_log_string_HandleMessageVaList(int level,
   const int64_t timestamp = GetTimestamp();
 
   std::lock_guard lock(log_encode_lock);
+#if PW_SYSTEM_ENABLE_PIPELINE_METRICS
+  StageTimer ingest_timer(ingest_ticks_total, ingest_ticks_max);
+#endif  // PW_SYSTEM_ENABLE_PIPELINE_METRICS
   StringBuilder message_builder(log_format_buffer);
   message_builder.FormatVaList(message, args);
 
@@ -67,6 +67,61 @@
 #define PW_SYSTEM_WORK_QUEUE_MAX_ENTRIES 32
 #endif  // PW_SYSTEM_WORK_QUEUE_MAX_ENTRIES
 
+// PW_SYSTEM_ENABLE_LOAD_GENERATOR specifies if pw_system emits synthetic log
+// traffic after init, to measure the cost and throughput of the log pipeline
+// on a target. Results are reported through the metric service in the
+// "load_generator" group, alongside the pipeline metrics.
+//
+// Defaults to 0.
+#ifndef PW_SYSTEM_ENABLE_LOAD_GENERATOR
+#define PW_SYSTEM_ENABLE_LOAD_GENERATOR 0
+#endif  // PW_SYSTEM_ENABLE_LOAD_GENERATOR
+
+// PW_SYSTEM_LOAD_GENERATOR_LOGS_PER_BURST specifies how many logs the load
+// generator emits back to back in each burst.
+//
+// Defaults to 32.
+#ifndef PW_SYSTEM_LOAD_GENERATOR_LOGS_PER_BURST
+#define PW_SYSTEM_LOAD_GENERATOR_LOGS_PER_BURST 32
+#endif  // PW_SYSTEM_LOAD_GENERATOR_LOGS_PER_BURST
+
+// PW_SYSTEM_LOAD_GENERATOR_BURST_PERIOD_MS specifies the delay between the
+// load generator's bursts, in milliseconds.
+//
+// Defaults to 100.
+#ifndef PW_SYSTEM_LOAD_GENERATOR_BURST_PERIOD_MS
+#define PW_SYSTEM_LOAD_GENERATOR_BURST_PERIOD_MS 100
+#endif  // PW_SYSTEM_LOAD_GENERATOR_BURST_PERIOD_MS
+
+// PW_SYSTEM_LOAD_GENERATOR_BURSTS specifies how many bursts the load generator
+// emits before stopping.
+//
+// Defaults to 100.
+#ifndef PW_SYSTEM_LOAD_GENERATOR_BURSTS
+#define PW_SYSTEM_LOAD_GENERATOR_BURSTS 100
+#endif  // PW_SYSTEM_LOAD_GENERATOR_BURSTS
+
+// PW_SYSTEM_ENABLE_PIPELINE_METRICS specifies if pw_system times each stage of
+// the log pipeline: encoding logs into the log buffer, and writing packets to
+// the transport. Times are reported through the metric service in ticks of the
+// pw_chrono system clock. This adds two clock reads to every log and write.
+//
+// Defaults to PW_SYSTEM_ENABLE_LOAD_GENERATOR.
+#ifndef PW_SYSTEM_ENABLE_PIPELINE_METRICS
+#define PW_SYSTEM_ENABLE_PIPELINE_METRICS PW_SYSTEM_ENABLE_LOAD_GENERATOR
+#endif  // PW_SYSTEM_ENABLE_PIPELINE_METRICS
+
+// PW_SYSTEM_DEFER_NONCRITICAL_SERVICES specifies if pw_system runs
+// UserAppInit() before starting the log thread and registering the metric and
+// thread snapshot services, rather than after. This gets to user code sooner.
+// Logs from before the log thread starts are buffered, and are dropped if
+// they overflow the log buffer.
+//
+// Defaults to 0.
+#ifndef PW_SYSTEM_DEFER_NONCRITICAL_SERVICES
+#define PW_SYSTEM_DEFER_NONCRITICAL_SERVICES 0
+#endif  // PW_SYSTEM_DEFER_NONCRITICAL_SERVICES
+
 // PW_SYSTEM_SOCKET_IO_PORT specifies the port number to use for the socket
 // stream implementation of pw_system's I/O interface.
 //
@@ -0,0 +1,51 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/metric.h"
+
+namespace pw::system {
+
+// Records how long a pipeline stage takes, from construction to destruction,
+// in the total and max metrics for the stage.
+class StageTimer {
+ public:
+  StageTimer(metric::TypedMetric<uint32_t>& total_ticks,
+             metric::TypedMetric<uint32_t>& max_ticks)
+      : total_ticks_(total_ticks),
+        max_ticks_(max_ticks),
+        start_(chrono::SystemClock::now()) {}
+
+  StageTimer(const StageTimer&) = delete;
+  StageTimer& operator=(const StageTimer&) = delete;
+
+  ~StageTimer() {
+    const uint32_t elapsed =
+        static_cast<uint32_t>((chrono::SystemClock::now() - start_).count());
+    total_ticks_.Increment(elapsed);
+    if (elapsed > max_ticks_.value()) {
+      max_ticks_.Set(elapsed);
+    }
+  }
+
+ private:
+  metric::TypedMetric<uint32_t>& total_ticks_;
+  metric::TypedMetric<uint32_t>& max_ticks_;
+  const chrono::SystemClock::time_point start_;
+};
+
+}  // namespace pw::system
@@ -27,3 +27,15 @@
 #ifndef PW_THREAD_NUM_BUNDLED_THREADS
 #define PW_THREAD_NUM_BUNDLED_THREADS 3
 #endif  // PW_THREAD_MAXIMUM_THREADS
+
+// The max number of threads whose scheduling statistics are recorded by
+// pw::thread::SchedulerStats. Threads beyond this are not tracked.
+#ifndef PW_THREAD_STATS_MAXIMUM_THREADS
+#define PW_THREAD_STATS_MAXIMUM_THREADS PW_THREAD_MAXIMUM_THREADS
+#endif  // PW_THREAD_STATS_MAXIMUM_THREADS
+
+// The number of power-of-two buckets in each thread's wake-up latency
+// histogram. The last bucket also counts all longer latencies.
+#ifndef PW_THREAD_STATS_LATENCY_BUCKETS
+#define PW_THREAD_STATS_LATENCY_BUCKETS 16
+#endif  // PW_THREAD_STATS_LATENCY_BUCKETS
@@ -0,0 +1,95 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "pw_thread/config.h"
+#include "pw_thread/thread_stats.h"
+
+namespace pw::thread {
+
+// Records per-thread CPU time, context switches and wake-up latency from RTOS
+// scheduler hooks. The pw_thread thread_stats backends feed one of these from
+// their RTOS's trace hooks, so the statistics mean the same thing on every
+// RTOS.
+//
+// Threads are identified by an opaque handle, typically the RTOS's thread
+// control block, and timestamps come from a free-running 32-bit counter whose
+// unit is chosen by the backend. Intervals longer than the counter's period
+// are not measured correctly.
+//
+// This class does no locking. The hooks must be called with the scheduler's
+// own serialization, e.g. from the context switch with interrupts masked, and
+// readers must prevent hooks from running while they read.
+class SchedulerStats {
+ public:
+  static constexpr size_t kMaxThreads = PW_THREAD_STATS_MAXIMUM_THREADS;
+
+  constexpr SchedulerStats() = default;
+
+  SchedulerStats(const SchedulerStats&) = delete;
+  SchedulerStats& operator=(const SchedulerStats&) = delete;
+
+  // Call when a thread becomes ready to run, e.g. when it is unblocked.
+  void ThreadReady(const void* thread, uint32_t now);
+
+  // Call when a thread starts running.
+  void ThreadSwitchedIn(const void* thread, uint32_t now);
+
+  // Call when a thread stops running.
+  void ThreadSwitchedOut(const void* thread, uint32_t now);
+
+  // Call when a thread is deleted, so its slot can be reused.
+  void ThreadDeleted(const void* thread);
+
+  // Fills in the statistics recorded for thread, including the current run of
+  // a thread that is running at now. Returns false, leaving stats unchanged,
+  // if the thread has never been switched in or was not tracked.
+  bool GetStats(const void* thread, uint32_t now, ThreadStats& stats) const;
+
+  // Returns the total runtime of all tracked threads at now.
+  uint64_t TotalRuntime(uint32_t now) const;
+
+  // Number of times a thread could not be tracked because all slots were in
+  // use.
+  uint32_t untracked() const { return untracked_; }
+
+ private:
+  struct Entry {
+    const void* thread = nullptr;
+    uint64_t runtime = 0;
+    uint32_t context_switches = 0;
+    uint32_t ready_at = 0;
+    uint32_t switched_in_at = 0;
+    bool ready = false;
+    bool running = false;
+    WakeLatencyHistogram wake_latency;
+
+    uint64_t RuntimeAt(uint32_t now) const {
+      return running ? runtime + static_cast<uint32_t>(now - switched_in_at)
+                     : runtime;
+    }
+  };
+
+  Entry* Find(const void* thread);
+  const Entry* Find(const void* thread) const;
+  Entry* FindOrAdd(const void* thread);
+
+  std::array<Entry, kMaxThreads> entries_{};
+  uint32_t untracked_ = 0;
+};
+
+}  // namespace pw::thread
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string_view>
 
@@ -51,4 +53,47 @@ Status SnapshotStack(const StackContext& stack,
                      proto::pwpb::Thread::StreamEncoder& encoder,
                      const ProcessThreadStackCallback& thread_stack_callback);
 
+// Like SnapshotStack() above, but passes stack_contents to the
+// thread_stack_callback instead of reading the live stack memory at
+// stack.stack_pointer. Use this to encode a stack that was copied earlier, such
+// as one captured in a raw snapshot at fault time.
+Status SnapshotStack(const StackContext& stack,
+                     ConstByteSpan stack_contents,
+                     proto::pwpb::Thread::StreamEncoder& encoder,
+                     const ProcessThreadStackCallback& thread_stack_callback);
+
+// Options for EncodeRawStack().
+struct RawStackOptions {
+  // The most bytes of the stack to capture. The bytes nearest the stack
+  // pointer, which hold the most recent frames, are kept.
+  size_t max_bytes = SIZE_MAX;
+
+  // Whether to write the zero-run encoded raw_stack_zero_run_encoded field
+  // instead of raw_stack. This typically shrinks a stack several times over,
+  // since stacks are mostly zero bytes, and needs only a small buffer on the
+  // stack to encode.
+  bool compress = false;
+};
+
+// Writes the contents of a stack, as passed to a ProcessThreadStackCallback, to
+// the raw_stack or raw_stack_zero_run_encoded field.
+Status EncodeRawStack(proto::pwpb::Thread::StreamEncoder& encoder,
+                      ConstByteSpan stack,
+                      const RawStackOptions& options = {});
+
+// Scans a stack for pointer-aligned words that point into a code region, such
+// as .text, and writes them to the raw_backtrace field, most recent first.
+// These are return address candidates: not every one is a real return address,
+// but the host can symbolize them to reconstruct the call stack. This captures
+// a small fraction of the bytes of the raw stack.
+//
+// Stops after max_candidates words. The range is [code_low_addr,
+// code_high_addr).
+Status EncodeReturnAddressCandidates(
+    proto::pwpb::Thread::StreamEncoder& encoder,
+    ConstByteSpan stack,
+    uintptr_t code_low_addr,
+    uintptr_t code_high_addr,
+    size_t max_candidates = SIZE_MAX);
+
 }  // namespace pw::thread
@@ -0,0 +1,124 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "pw_containers/inline_queue.h"
+#include "pw_function/function.h"
+#include "pw_status/status.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_thread/thread_core.h"
+
+namespace pw::thread {
+
+/// `ThreadPool` runs tasks from a bounded queue on a fixed set of worker
+/// threads, and splits loops across them with `ParallelFor()`.
+///
+/// The pool is a `ThreadCore` that every worker thread runs. The worker count
+/// is the number of threads started with the pool, each with its own
+/// `Options`, which select the backend's priority, stack, and CPU affinity for
+/// the worker. The pool works with any `pw_thread` backend.
+///
+/// @code{.cpp}
+///   pw::thread::ThreadPoolWithBuffer<16> pool;
+///   for (const pw::thread::Options& options : worker_options) {
+///     pw::thread::Thread(options, pool).detach();
+///   }
+///
+///   pool.ParallelFor(0, blob.size(), 4096, [&](size_t begin, size_t end) {
+///     checksums[begin / 4096] = Crc32(blob.subspan(begin, end - begin));
+///   });
+/// @endcode
+///
+/// The entire API is thread safe. `Submit()` is also interrupt safe.
+class ThreadPool : public ThreadCore {
+ public:
+  using Task = Function<void()>;
+
+  /// Called with each chunk `[begin, end)` of a `ParallelFor()` range.
+  using ChunkFunction = Function<void(size_t begin, size_t end)>;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Enqueues a task for a worker to run.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - The task was enqueued.
+  /// * @pw_status{FAILED_PRECONDITION} - The pool is stopping.
+  /// * @pw_status{RESOURCE_EXHAUSTED} - The queue is full.
+  Status Submit(Task&& task) PW_LOCKS_EXCLUDED(lock_);
+
+  /// Runs `function` on consecutive chunks of at most `grain` indices that
+  /// cover `[begin, end)`, in parallel on the calling thread and the workers,
+  /// and returns once every chunk has run. `function` is called concurrently,
+  /// so it must be thread safe.
+  ///
+  /// While waiting for workers, the calling thread runs queued tasks, so pool
+  /// tasks may call `ParallelFor()` too. If the queue is full or no workers
+  /// are running, the calling thread runs the remaining chunks itself.
+  ///
+  /// @pre `grain` must not be 0.
+  void ParallelFor(size_t begin,
+                   size_t end,
+                   size_t grain,
+                   const ChunkFunction& function) PW_LOCKS_EXCLUDED(lock_);
+
+  /// Stops accepting tasks. The workers finish the queued tasks and then
+  /// return, after which the threads may be joined. The pool cannot be
+  /// restarted.
+  void RequestStop() PW_LOCKS_EXCLUDED(lock_);
+
+  /// Returns the number of worker threads running the pool.
+  size_t worker_count() const {
+    return workers_.load(std::memory_order_relaxed);
+  }
+
+ protected:
+  explicit ThreadPool(InlineQueue<Task>& queue) : queue_(queue) {}
+
+ private:
+  struct ParallelForState;
+
+  void Run() override PW_LOCKS_EXCLUDED(lock_);
+
+  // Pops and runs a queued task, if there is one. Returns whether it did.
+  bool RunQueuedTask() PW_LOCKS_EXCLUDED(lock_);
+
+  static void RunChunks(ParallelForState& state);
+
+  sync::InterruptSpinLock lock_;
+  InlineQueue<Task>& queue_ PW_GUARDED_BY(lock_);
+  bool stop_requested_ PW_GUARDED_BY(lock_) = false;
+
+  // Released once per queued task, and once when stopping.
+  sync::CountingSemaphore tasks_available_;
+  std::atomic<size_t> workers_{0};
+};
+
+/// A `ThreadPool` whose queue holds up to `kQueueCapacity` tasks.
+template <size_t kQueueCapacity>
+class ThreadPoolWithBuffer : public ThreadPool {
+ public:
+  ThreadPoolWithBuffer() : ThreadPool(queue_) {}
+
+ private:
+  InlineQueue<Task, kQueueCapacity> queue_;
+};
+
+}  // namespace pw::thread
@@ -0,0 +1,130 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_function/function.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_thread/config.h"
+
+namespace pw::thread {
+
+// Counts how long a thread waited between becoming ready and running.
+//
+// Bucket 0 counts zero-tick latencies, and bucket i counts latencies in
+// [2^(i-1), 2^i) ticks of the backend's timestamp counter. The last bucket also
+// counts every longer latency.
+class WakeLatencyHistogram {
+ public:
+  static constexpr size_t kBuckets = PW_THREAD_STATS_LATENCY_BUCKETS;
+  static_assert(kBuckets > 0);
+
+  constexpr WakeLatencyHistogram() = default;
+
+  void Record(uint32_t latency) {
+    size_t bucket = 0;
+    while (latency != 0 && bucket < kBuckets - 1) {
+      latency >>= 1;
+      ++bucket;
+    }
+    counts_[bucket] += 1;
+  }
+
+  span<const uint32_t> buckets() const { return counts_; }
+
+  void Clear() { counts_ = {}; }
+
+ private:
+  std::array<uint32_t, kBuckets> counts_{};
+};
+
+// The class ThreadStats summarizes the CPU time and scheduling behavior of one
+// thread, as reported by ForEachThreadStats().
+//
+// Times are in ticks of the backend's timestamp counter, which varies by RTOS
+// and configuration. Divide runtime by total_runtime for the thread's share of
+// the CPU.
+//
+// Captures the following fields, each of which may be unsupported by a
+// backend:
+//     thread_name
+//     runtime: time the thread has spent running
+//     total_runtime: time all tracked threads have spent running
+//     context_switches: number of times the thread was switched in
+//     wake_latency: histogram of ready-to-running latencies
+class ThreadStats {
+ public:
+  ThreadStats() = default;
+
+  constexpr std::optional<span<const std::byte>> thread_name() const {
+    return thread_name_;
+  }
+  void set_thread_name(span<const std::byte> val) { thread_name_ = val; }
+
+  constexpr std::optional<uint64_t> runtime() const { return runtime_; }
+  void set_runtime(uint64_t val) { runtime_ = val; }
+
+  constexpr std::optional<uint64_t> total_runtime() const {
+    return total_runtime_;
+  }
+  void set_total_runtime(uint64_t val) { total_runtime_ = val; }
+
+  constexpr std::optional<uint32_t> context_switches() const {
+    return context_switches_;
+  }
+  void set_context_switches(uint32_t val) { context_switches_ = val; }
+
+  // Returns nullptr if the backend does not record wake-up latency.
+  constexpr const WakeLatencyHistogram* wake_latency() const {
+    return wake_latency_;
+  }
+  void set_wake_latency(const WakeLatencyHistogram& val) {
+    wake_latency_ = &val;
+  }
+
+ private:
+  std::optional<span<const std::byte>> thread_name_;
+  std::optional<uint64_t> runtime_;
+  std::optional<uint64_t> total_runtime_;
+  std::optional<uint32_t> context_switches_;
+  const WakeLatencyHistogram* wake_latency_ = nullptr;
+};
+
+// A callback that is executed for each thread when using ForEachThreadStats().
+// The callback should return true to continue iterating.
+//
+// As with ThreadCallback, the scheduler may be disabled while this runs:
+// - Processing inside of the callback should be kept to a minimum.
+// - Callback should never attempt to block.
+// - The ThreadStats and the data it refers to are only valid during the call.
+using ThreadStatsCallback = pw::Function<bool(const ThreadStats&)>;
+
+// Iterates through all threads that haven't been deleted, calling the provided
+// callback with each thread's statistics.
+//
+// Returns:
+//   Unimplemented - The backend does not support thread statistics.
+//   FailedPrecondition - The scheduler has not been started.
+//   Aborted - The callback requested an early-termination of iteration.
+//   OkStatus - Successfully iterated over all threads.
+//
+// Warning: This may disable the scheduler.
+Status ForEachThreadStats(const ThreadStatsCallback& cb);
+
+}  // namespace pw::thread
@@ -0,0 +1,103 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_containers/vector.h"
+#include "pw_protobuf/serialized_size.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_thread/config.h"
+#include "pw_thread/thread_stats.h"
+#include "pw_thread_protos/thread_stats_service.pwpb.h"
+#include "pw_thread_protos/thread_stats_service.raw_rpc.pb.h"
+
+namespace pw::thread::proto {
+
+Status ProtoEncodeThreadStats(pwpb::ThreadStatsResponse::StreamEncoder& encoder,
+                              const ThreadStats& thread_stats);
+
+// Calculates the encode buffer size needed for num_threads threads with names
+// of up to max_name_size bytes.
+constexpr size_t RequiredStatsServiceBufferSize(
+    size_t num_threads = PW_THREAD_MAXIMUM_THREADS,
+    size_t max_name_size = 32) {
+  const size_t thread_stats_size =
+      protobuf::SizeOfFieldBytes(pwpb::ThreadStats::Fields::kName,
+                                 static_cast<uint32_t>(max_name_size)) +
+      protobuf::SizeOfFieldUint64(pwpb::ThreadStats::Fields::kRuntime) +
+      protobuf::SizeOfFieldUint64(pwpb::ThreadStats::Fields::kTotalRuntime) +
+      protobuf::SizeOfFieldUint32(
+          pwpb::ThreadStats::Fields::kContextSwitches) +
+      protobuf::SizeOfDelimitedField(
+          pwpb::ThreadStats::Fields::kWakeLatencyHistogram,
+          static_cast<uint32_t>(WakeLatencyHistogram::kBuckets *
+                                varint::kMaxVarint32SizeBytes));
+  return num_threads * protobuf::SizeOfDelimitedField(
+                           pwpb::ThreadStatsResponse::Fields::kThreads,
+                           static_cast<uint32_t>(thread_stats_size));
+}
+
+// The ThreadStatsService returns the CPU time and scheduling statistics of
+// each thread, as reported by ForEachThreadStats(), when requested by
+// GetThreadStats().
+//
+// Parameter encode_buffer: buffer where thread statistics are encoded. Size
+// depends on RequiredStatsServiceBufferSize().
+//
+// Parameter thread_proto_indices: array keeping track of thread boundaries in
+// the encode buffer. The service uses these indices to send response data out
+// in bundles.
+//
+// Parameter num_bundled_threads: constant describing number of threads per
+// bundle in response.
+class ThreadStatsService
+    : public pw_rpc::raw::ThreadStatsService::Service<ThreadStatsService> {
+ public:
+  constexpr ThreadStatsService(
+      span<std::byte> encode_buffer,
+      Vector<size_t>& thread_proto_indices,
+      size_t num_bundled_threads = PW_THREAD_NUM_BUNDLED_THREADS)
+      : encode_buffer_(encode_buffer),
+        thread_proto_indices_(thread_proto_indices),
+        num_bundled_threads_(num_bundled_threads) {}
+
+  void GetThreadStats(ConstByteSpan request, rpc::RawServerWriter& response);
+
+ private:
+  span<std::byte> encode_buffer_;
+  Vector<size_t>& thread_proto_indices_;
+  size_t num_bundled_threads_;
+};
+
+// A ThreadStatsService that allocates required buffers based on the number of
+// running threads on a device.
+template <size_t kNumThreads = PW_THREAD_MAXIMUM_THREADS>
+class ThreadStatsServiceBuffer : public ThreadStatsService {
+ public:
+  ThreadStatsServiceBuffer()
+      : ThreadStatsService(encode_buffer_, thread_proto_indices_) {}
+
+ private:
+  std::array<std::byte, RequiredStatsServiceBufferSize(kNumThreads)>
+      encode_buffer_;
+  // + 1 is needed to account for extra index that comes with the first
+  // submessage start or the last submessage end.
+  Vector<size_t, kNumThreads + 1> thread_proto_indices_;
+};
+
+}  // namespace pw::thread::proto
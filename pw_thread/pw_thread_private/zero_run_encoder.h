@@ -0,0 +1,63 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::thread::internal {
+
+// Encodes bytes with the zero-run encoding used by the Thread proto's
+// raw_stack_zero_run_encoded field. Stacks are dominated by zero bytes from
+// cleared locals, padding, and small integers, which this encoding removes
+// with no tables or scratch memory.
+//
+// The encoded data is a sequence of chunks, each starting with a control byte:
+//
+//   0x00-0x7F: control + 1 literal bytes follow.
+//   0x80-0xFF: (control & 0x7F) + 1 zero bytes; nothing follows.
+//
+// The encoding is produced incrementally through the stream::Reader interface,
+// so it can be written to a proto field with WriteBytesFromStream() without
+// buffering the whole output.
+class ZeroRunEncoder : public stream::NonSeekableReader {
+ public:
+  static constexpr size_t kMaxRunSizeBytes = 128;
+
+  explicit ZeroRunEncoder(ConstByteSpan input) : input_(input) {}
+
+  // Returns the size of the encoded form of input.
+  static size_t EncodedSize(ConstByteSpan input);
+
+ private:
+  // The next chunk of input starting at an offset.
+  struct Chunk {
+    bool zeros;
+    size_t size;
+  };
+
+  static Chunk NextChunk(ConstByteSpan input, size_t offset);
+
+  StatusWithSize DoRead(ByteSpan destination) override;
+
+  ConstByteSpan input_;
+  size_t offset_ = 0;
+  size_t literal_bytes_remaining_ = 0;
+};
+
+}  // namespace pw::thread::internal
@@ -31,6 +31,24 @@ THREAD_STATE_TO_STRING: Mapping[int, str] = {
 }
 
 
+def decode_zero_run_encoded_stack(encoded: bytes) -> bytes:
+    """Decodes a Thread's raw_stack_zero_run_encoded field."""
+    decoded = bytearray()
+    i = 0
+    while i < len(encoded):
+        control = encoded[i]
+        i += 1
+        if control & 0x80:
+            decoded.extend(bytes((control & 0x7F) + 1))
+        else:
+            size = control + 1
+            if i + size > len(encoded):
+                raise ValueError('Truncated zero-run encoded stack')
+            decoded.extend(encoded[i : i + size])
+            i += size
+    return bytes(decoded)
+
+
 def process_snapshot(
     serialized_snapshot: bytes,
     tokenizer_db: Optional[pw_tokenizer.Detokenizer] = None,
@@ -281,12 +299,15 @@ class ThreadSnapshotAnalyzer:
                 output.append(
                     self._symbolizer.dump_stack_trace(thread.raw_backtrace)
                 )
-            if thread.raw_stack:
+            raw_stack = thread.raw_stack
+            if thread.raw_stack_zero_run_encoded:
+                raw_stack = decode_zero_run_encoded_stack(
+                    thread.raw_stack_zero_run_encoded
+                )
+            if raw_stack:
                 output.append('Raw Stack')
                 output.append(
-                    binascii.hexlify(thread.raw_stack, b'\n', 32).decode(
-                        'utf-8'
-                    )
+                    binascii.hexlify(raw_stack, b'\n', 32).decode('utf-8')
                 )
             # Blank line between threads for nicer formatting.
             output.append('')
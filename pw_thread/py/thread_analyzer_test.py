@@ -15,7 +15,11 @@
 """Tests for the thread analyzer."""
 
 import unittest
-from pw_thread.thread_analyzer import ThreadInfo, ThreadSnapshotAnalyzer
+from pw_thread.thread_analyzer import (
+    ThreadInfo,
+    ThreadSnapshotAnalyzer,
+    decode_zero_run_encoded_stack,
+)
 from pw_thread_protos import thread_pb2
 
 
@@ -293,5 +297,25 @@ class ThreadSnapshotAnalyzerTest(unittest.TestCase):
         self.assertEqual(str(ThreadSnapshotAnalyzer(snapshot)), expected)
 
 
+class ZeroRunEncodingTest(unittest.TestCase):
+    """Tests decoding of raw_stack_zero_run_encoded."""
+
+    def test_empty(self):
+        self.assertEqual(b'', decode_zero_run_encoded_stack(b''))
+
+    def test_literals_and_zeros(self):
+        self.assertEqual(
+            b'\x12\x34\x00\x00\x00\x00\x56',
+            decode_zero_run_encoded_stack(b'\x01\x12\x34\x83\x00\x56'),
+        )
+
+    def test_max_zero_run(self):
+        self.assertEqual(bytes(128), decode_zero_run_encoded_stack(b'\xff'))
+
+    def test_truncated(self):
+        with self.assertRaises(ValueError):
+            decode_zero_run_encoded_stack(b'\x03\x01')
+
+
 if __name__ == '__main__':
     unittest.main()
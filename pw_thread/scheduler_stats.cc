@@ -0,0 +1,115 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/scheduler_stats.h"
+
+namespace pw::thread {
+
+void SchedulerStats::ThreadReady(const void* thread, uint32_t now) {
+  Entry* entry = FindOrAdd(thread);
+  // A running thread may be made ready again, e.g. by a priority change; only
+  // the first wake-up of a waiting thread starts a latency measurement.
+  if (entry == nullptr || entry->ready || entry->running) {
+    return;
+  }
+  entry->ready = true;
+  entry->ready_at = now;
+}
+
+void SchedulerStats::ThreadSwitchedIn(const void* thread, uint32_t now) {
+  Entry* entry = FindOrAdd(thread);
+  if (entry == nullptr) {
+    return;
+  }
+  if (entry->ready) {
+    entry->wake_latency.Record(now - entry->ready_at);
+    entry->ready = false;
+  }
+  entry->context_switches += 1;
+  entry->switched_in_at = now;
+  entry->running = true;
+}
+
+void SchedulerStats::ThreadSwitchedOut(const void* thread, uint32_t now) {
+  Entry* entry = Find(thread);
+  if (entry == nullptr || !entry->running) {
+    return;
+  }
+  entry->runtime = entry->RuntimeAt(now);
+  entry->running = false;
+}
+
+void SchedulerStats::ThreadDeleted(const void* thread) {
+  if (Entry* entry = Find(thread); entry != nullptr) {
+    *entry = Entry();
+  }
+}
+
+bool SchedulerStats::GetStats(const void* thread,
+                              uint32_t now,
+                              ThreadStats& stats) const {
+  const Entry* entry = Find(thread);
+  if (entry == nullptr || entry->context_switches == 0) {
+    return false;
+  }
+  stats.set_runtime(entry->RuntimeAt(now));
+  stats.set_context_switches(entry->context_switches);
+  stats.set_wake_latency(entry->wake_latency);
+  return true;
+}
+
+uint64_t SchedulerStats::TotalRuntime(uint32_t now) const {
+  uint64_t total = 0;
+  for (const Entry& entry : entries_) {
+    if (entry.thread != nullptr) {
+      total += entry.RuntimeAt(now);
+    }
+  }
+  return total;
+}
+
+SchedulerStats::Entry* SchedulerStats::Find(const void* thread) {
+  for (Entry& entry : entries_) {
+    if (entry.thread == thread) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+const SchedulerStats::Entry* SchedulerStats::Find(const void* thread) const {
+  for (const Entry& entry : entries_) {
+    if (entry.thread == thread) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+SchedulerStats::Entry* SchedulerStats::FindOrAdd(const void* thread) {
+  if (thread == nullptr) {
+    return nullptr;
+  }
+  if (Entry* entry = Find(thread); entry != nullptr) {
+    return entry;
+  }
+  if (Entry* entry = Find(nullptr); entry != nullptr) {
+    entry->thread = thread;
+    return entry;
+  }
+  untracked_ += 1;
+  return nullptr;
+}
+
+}  // namespace pw::thread
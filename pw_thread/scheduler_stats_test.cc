@@ -0,0 +1,127 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/scheduler_stats.h"
+
+#include "gtest/gtest.h"
+
+namespace pw::thread {
+namespace {
+
+int thread_a;
+int thread_b;
+
+TEST(WakeLatencyHistogram, Record_PowerOfTwoBuckets) {
+  WakeLatencyHistogram histogram;
+  histogram.Record(0);
+  histogram.Record(1);
+  histogram.Record(2);
+  histogram.Record(3);
+  histogram.Record(4);
+  histogram.Record(UINT32_MAX);
+
+  span<const uint32_t> buckets = histogram.buckets();
+  EXPECT_EQ(buckets[0], 1u);
+  EXPECT_EQ(buckets[1], 1u);
+  EXPECT_EQ(buckets[2], 2u);
+  EXPECT_EQ(buckets[3], 1u);
+  EXPECT_EQ(buckets[WakeLatencyHistogram::kBuckets - 1], 1u);
+}
+
+TEST(SchedulerStats, NeverSwitchedIn_NoStats) {
+  SchedulerStats stats;
+  ThreadStats thread_stats;
+  EXPECT_FALSE(stats.GetStats(&thread_a, 0, thread_stats));
+
+  stats.ThreadReady(&thread_a, 0);
+  EXPECT_FALSE(stats.GetStats(&thread_a, 0, thread_stats));
+  EXPECT_FALSE(thread_stats.runtime().has_value());
+}
+
+TEST(SchedulerStats, SwitchedInAndOut_AccumulatesRuntime) {
+  SchedulerStats stats;
+  stats.ThreadSwitchedIn(&thread_a, 100);
+  stats.ThreadSwitchedOut(&thread_a, 150);
+  stats.ThreadSwitchedIn(&thread_b, 150);
+  stats.ThreadSwitchedOut(&thread_b, 160);
+  stats.ThreadSwitchedIn(&thread_a, 160);
+
+  ThreadStats a;
+  ASSERT_TRUE(stats.GetStats(&thread_a, 170, a));
+  EXPECT_EQ(a.runtime(), 60u);  // Includes the current run.
+  EXPECT_EQ(a.context_switches(), 2u);
+
+  ThreadStats b;
+  ASSERT_TRUE(stats.GetStats(&thread_b, 170, b));
+  EXPECT_EQ(b.runtime(), 10u);
+  EXPECT_EQ(b.context_switches(), 1u);
+
+  EXPECT_EQ(stats.TotalRuntime(170), 70u);
+}
+
+TEST(SchedulerStats, TimestampWrap_MeasuredCorrectly) {
+  SchedulerStats stats;
+  stats.ThreadReady(&thread_a, UINT32_MAX - 1);
+  stats.ThreadSwitchedIn(&thread_a, UINT32_MAX);
+  stats.ThreadSwitchedOut(&thread_a, 9);
+
+  ThreadStats a;
+  ASSERT_TRUE(stats.GetStats(&thread_a, 9, a));
+  EXPECT_EQ(a.runtime(), 10u);
+  ASSERT_NE(a.wake_latency(), nullptr);
+  EXPECT_EQ(a.wake_latency()->buckets()[1], 1u);
+}
+
+TEST(SchedulerStats, ReadyToRunning_RecordsWakeLatency) {
+  SchedulerStats stats;
+  stats.ThreadReady(&thread_a, 10);
+  stats.ThreadReady(&thread_a, 12);  // Already ready; ignored.
+  stats.ThreadSwitchedIn(&thread_a, 14);
+
+  // A preempted thread switched back in has no wake-up to measure.
+  stats.ThreadSwitchedOut(&thread_a, 20);
+  stats.ThreadSwitchedIn(&thread_a, 30);
+
+  ThreadStats a;
+  ASSERT_TRUE(stats.GetStats(&thread_a, 30, a));
+  ASSERT_NE(a.wake_latency(), nullptr);
+  span<const uint32_t> buckets = a.wake_latency()->buckets();
+  EXPECT_EQ(buckets[3], 1u);  // Latency 4 is in [4, 8).
+  uint32_t total = 0;
+  for (uint32_t count : buckets) {
+    total += count;
+  }
+  EXPECT_EQ(total, 1u);
+}
+
+TEST(SchedulerStats, ThreadDeleted_FreesSlot) {
+  SchedulerStats stats;
+  int threads[SchedulerStats::kMaxThreads];
+  for (int& thread : threads) {
+    stats.ThreadSwitchedIn(&thread, 0);
+  }
+  stats.ThreadSwitchedIn(&thread_a, 0);
+  EXPECT_EQ(stats.untracked(), 1u);
+
+  stats.ThreadDeleted(&threads[0]);
+  stats.ThreadSwitchedIn(&thread_a, 0);
+  EXPECT_EQ(stats.untracked(), 1u);
+
+  ThreadStats a;
+  EXPECT_TRUE(stats.GetStats(&thread_a, 0, a));
+  EXPECT_FALSE(stats.GetStats(&threads[0], 0, a));
+}
+
+}  // namespace
+}  // namespace pw::thread
@@ -16,15 +16,21 @@
 
 #include "pw_thread/snapshot.h"
 
+#include <algorithm>
+#include <array>
 #include <cinttypes>
+#include <cstring>
 #include <string_view>
 
 #include "pw_bytes/span.h"
 #include "pw_function/function.h"
 #include "pw_log/log.h"
 #include "pw_protobuf/encoder.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 #include "pw_thread/config.h"
+#include "pw_thread_private/zero_run_encoder.h"
 #include "pw_thread_protos/thread.pwpb.h"
 
 namespace pw::thread {
@@ -32,6 +38,19 @@ namespace pw::thread {
 Status SnapshotStack(const StackContext& stack,
                      proto::pwpb::Thread::StreamEncoder& encoder,
                      const ProcessThreadStackCallback& thread_stack_callback) {
+  ConstByteSpan stack_contents;
+  if (stack.stack_pointer <= stack.stack_high_addr) {
+    stack_contents =
+        ConstByteSpan(reinterpret_cast<const std::byte*>(stack.stack_pointer),
+                      stack.stack_high_addr - stack.stack_pointer);
+  }
+  return SnapshotStack(stack, stack_contents, encoder, thread_stack_callback);
+}
+
+Status SnapshotStack(const StackContext& stack,
+                     ConstByteSpan stack_contents,
+                     proto::pwpb::Thread::StreamEncoder& encoder,
+                     const ProcessThreadStackCallback& thread_stack_callback) {
   // TODO(b/234890430): Add support for ascending stacks.
   encoder.WriteStackStartPointer(stack.stack_high_addr).IgnoreError();
   encoder.WriteStackEndPointer(stack.stack_low_addr).IgnoreError();
@@ -76,10 +95,61 @@ Status SnapshotStack(const StackContext& stack,
         static_cast<long unsigned>(stack.stack_low_addr - stack.stack_pointer));
   }
 
-  return thread_stack_callback(
-      encoder,
-      ConstByteSpan(reinterpret_cast<const std::byte*>(stack.stack_pointer),
-                    stack.stack_high_addr - stack.stack_pointer));
+  return thread_stack_callback(encoder, stack_contents);
+}
+
+Status EncodeRawStack(proto::pwpb::Thread::StreamEncoder& encoder,
+                      ConstByteSpan stack,
+                      const RawStackOptions& options) {
+  stack = stack.first(std::min(stack.size(), options.max_bytes));
+  if (!options.compress) {
+    return encoder.WriteRawStack(stack);
+  }
+
+  internal::ZeroRunEncoder zero_run_encoder(stack);
+  std::array<std::byte, 32> pipe_buffer;
+  return encoder.WriteBytesFromStream(
+      static_cast<uint32_t>(
+          proto::pwpb::Thread::Fields::kRawStackZeroRunEncoded),
+      zero_run_encoder,
+      internal::ZeroRunEncoder::EncodedSize(stack),
+      pipe_buffer);
+}
+
+Status EncodeReturnAddressCandidates(
+    proto::pwpb::Thread::StreamEncoder& encoder,
+    ConstByteSpan stack,
+    uintptr_t code_low_addr,
+    uintptr_t code_high_addr,
+    size_t max_candidates) {
+  // Candidates are written in packed batches, which decode the same as a
+  // single packed field.
+  std::array<uint64_t, 16> batch;
+  size_t batch_size = 0;
+  size_t candidates = 0;
+
+  // The stack pointer is pointer-aligned, so the words of the stack are too.
+  for (size_t offset = 0; offset + sizeof(uintptr_t) <= stack.size() &&
+                          candidates < max_candidates;
+       offset += sizeof(uintptr_t)) {
+    uintptr_t word;
+    std::memcpy(&word, &stack[offset], sizeof(word));
+    if (word < code_low_addr || word >= code_high_addr) {
+      continue;
+    }
+
+    batch[batch_size++] = word;
+    candidates += 1;
+    if (batch_size == batch.size()) {
+      PW_TRY(encoder.WriteRawBacktrace(batch));
+      batch_size = 0;
+    }
+  }
+
+  if (batch_size == 0u) {
+    return OkStatus();
+  }
+  return encoder.WriteRawBacktrace(span(batch).first(batch_size));
 }
 
 }  // namespace pw::thread
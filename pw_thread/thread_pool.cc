@@ -0,0 +1,166 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_pool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+
+#include "pw_assert/check.h"
+
+namespace pw::thread {
+
+struct ThreadPool::ParallelForState {
+  ParallelForState(const ChunkFunction& function_arg,
+                   size_t begin_arg,
+                   size_t end_arg,
+                   size_t grain_arg)
+      : function(function_arg),
+        begin(begin_arg),
+        end(end_arg),
+        grain(grain_arg),
+        chunk_count((end - begin) / grain +
+                    ((end - begin) % grain != 0 ? 1 : 0)) {}
+
+  const ChunkFunction& function;
+  const size_t begin;
+  const size_t end;
+  const size_t grain;
+  const size_t chunk_count;
+  std::atomic<size_t> next_chunk{0};
+
+  // Released by each helper task when it finishes.
+  sync::CountingSemaphore helpers_done;
+};
+
+Status ThreadPool::Submit(Task&& task) {
+  {
+    std::lock_guard lock(lock_);
+    if (stop_requested_) {
+      return Status::FailedPrecondition();
+    }
+    if (queue_.full()) {
+      return Status::ResourceExhausted();
+    }
+    queue_.push(std::move(task));
+  }
+  tasks_available_.release();
+  return OkStatus();
+}
+
+void ThreadPool::ParallelFor(size_t begin,
+                             size_t end,
+                             size_t grain,
+                             const ChunkFunction& function) {
+  PW_DCHECK_UINT_NE(grain, 0u);
+  if (begin >= end) {
+    return;
+  }
+
+  ParallelForState state(function, begin, end, grain);
+
+  // Ask each worker to help, as long as there are chunks left for it.
+  const size_t helpers = std::min(state.chunk_count - 1, worker_count());
+  size_t submitted = 0;
+  for (; submitted < helpers; ++submitted) {
+    const Status status = Submit([&state] {
+      RunChunks(state);
+      state.helpers_done.release();
+    });
+    if (!status.ok()) {
+      break;
+    }
+  }
+
+  RunChunks(state);
+
+  // The helpers reference state, so wait for all of them, including any that
+  // have not started yet. Run queued tasks meanwhile, which may include the
+  // helpers themselves if every worker is busy.
+  for (size_t finished = 0; finished < submitted; ++finished) {
+    while (!state.helpers_done.try_acquire()) {
+      if (!RunQueuedTask()) {
+        state.helpers_done.acquire();
+        break;
+      }
+    }
+  }
+}
+
+void ThreadPool::RequestStop() {
+  {
+    std::lock_guard lock(lock_);
+    stop_requested_ = true;
+  }
+  tasks_available_.release();
+}
+
+void ThreadPool::Run() {
+  workers_.fetch_add(1, std::memory_order_relaxed);
+  while (true) {
+    tasks_available_.acquire();
+    std::optional<Task> task;
+    bool stop_requested;
+    {
+      std::lock_guard lock(lock_);
+      if (!queue_.empty()) {
+        task.emplace(std::move(queue_.front()));
+        queue_.pop();
+      }
+      stop_requested = stop_requested_;
+    }
+
+    if (task.has_value()) {
+      (*task)();
+    } else if (stop_requested) {
+      // Pass the stop on to the next worker.
+      tasks_available_.release();
+      break;
+    }
+  }
+  workers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool ThreadPool::RunQueuedTask() {
+  std::optional<Task> task;
+  {
+    std::lock_guard lock(lock_);
+    if (queue_.empty()) {
+      return false;
+    }
+    task.emplace(std::move(queue_.front()));
+    queue_.pop();
+  }
+  // Take the task's release of the semaphore, unless a worker already woke up
+  // for it, to keep the count bounded by the queue capacity.
+  static_cast<void>(tasks_available_.try_acquire());
+  (*task)();
+  return true;
+}
+
+void ThreadPool::RunChunks(ParallelForState& state) {
+  while (true) {
+    const size_t chunk =
+        state.next_chunk.fetch_add(1, std::memory_order_relaxed);
+    if (chunk >= state.chunk_count) {
+      return;
+    }
+    const size_t chunk_begin = state.begin + chunk * state.grain;
+    state.function(chunk_begin,
+                   std::min(chunk_begin + state.grain, state.end));
+  }
+}
+
+}  // namespace pw::thread
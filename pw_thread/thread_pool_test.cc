@@ -0,0 +1,140 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_pool.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+#include "pw_sync/binary_semaphore.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+
+namespace pw::thread {
+namespace {
+
+using pw::thread::test::TestThreadContext;
+
+TEST(ThreadPool, ParallelForWithoutWorkers) {
+  ThreadPoolWithBuffer<4> pool;
+  std::array<int, 10> visits{};
+  pool.ParallelFor(0, visits.size(), 3, [&visits](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      visits[i] += 1;
+    }
+  });
+  for (int count : visits) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+TEST(ThreadPool, ParallelForEmptyRange) {
+  ThreadPoolWithBuffer<4> pool;
+  bool called = false;
+  pool.ParallelFor(5, 5, 1, [&called](size_t, size_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+TEST(ThreadPool, SubmitFailsWhenFull) {
+  ThreadPoolWithBuffer<2> pool;
+  EXPECT_EQ(pool.Submit([] {}), OkStatus());
+  EXPECT_EQ(pool.Submit([] {}), OkStatus());
+  EXPECT_EQ(pool.Submit([] {}), Status::ResourceExhausted());
+}
+
+TEST(ThreadPool, SubmitFailsAfterStop) {
+  ThreadPoolWithBuffer<2> pool;
+  pool.RequestStop();
+  EXPECT_EQ(pool.Submit([] {}), Status::FailedPrecondition());
+}
+
+#if PW_THREAD_JOINING_ENABLED
+
+class ThreadPoolWithWorkers : public ::testing::Test {
+ protected:
+  ThreadPoolWithWorkers()
+      : worker_0_(context_0_.options(), pool_),
+        worker_1_(context_1_.options(), pool_) {}
+
+  ~ThreadPoolWithWorkers() override {
+    pool_.RequestStop();
+    if (worker_0_.joinable()) {
+      worker_0_.join();
+    }
+    if (worker_1_.joinable()) {
+      worker_1_.join();
+    }
+  }
+
+  TestThreadContext context_0_;
+  TestThreadContext context_1_;
+  ThreadPoolWithBuffer<8> pool_;
+  Thread worker_0_;
+  Thread worker_1_;
+};
+
+TEST_F(ThreadPoolWithWorkers, Submit) {
+  sync::BinarySemaphore ran;
+  ASSERT_EQ(pool_.Submit([&ran] { ran.release(); }), OkStatus());
+  ran.acquire();
+}
+
+TEST_F(ThreadPoolWithWorkers, ParallelForVisitsEachIndexOnce) {
+  std::array<std::atomic<int>, 1000> visits{};
+  pool_.ParallelFor(0, visits.size(), 7, [&visits](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      visits[i].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  for (const std::atomic<int>& count : visits) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST_F(ThreadPoolWithWorkers, NestedParallelFor) {
+  struct {
+    ThreadPool& pool;
+    std::array<std::atomic<size_t>, 8> sums{};
+  } nested{pool_};
+
+  nested.pool.ParallelFor(0, 8, 1, [&nested](size_t outer, size_t) {
+    std::atomic<size_t>& sum = nested.sums[outer];
+    nested.pool.ParallelFor(0, 100, 10, [&sum](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        sum.fetch_add(i, std::memory_order_relaxed);
+      }
+    });
+  });
+  for (const std::atomic<size_t>& sum : nested.sums) {
+    EXPECT_EQ(sum.load(), 100u * 99u / 2u);
+  }
+}
+
+TEST_F(ThreadPoolWithWorkers, QueuedTasksRunBeforeStop) {
+  std::atomic<int> ran{0};
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_EQ(pool_.Submit([&ran] { ran.fetch_add(1); }), OkStatus());
+  }
+  pool_.RequestStop();
+  worker_0_.join();
+  worker_1_.join();
+  EXPECT_EQ(ran.load(), 8);
+}
+
+#endif  // PW_THREAD_JOINING_ENABLED
+
+}  // namespace
+}  // namespace pw::thread
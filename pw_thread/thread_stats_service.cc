@@ -0,0 +1,154 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_stats_service.h"
+
+#include <algorithm>
+
+#include "pw_containers/vector.h"
+#include "pw_log/log.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/try.h"
+#include "pw_thread/thread_stats.h"
+#include "pw_thread_protos/thread_stats_service.pwpb.h"
+
+namespace pw::thread::proto {
+namespace {
+
+Status DecodeRequestedName(ConstByteSpan request, ConstByteSpan& name) {
+  protobuf::Decoder decoder(request);
+  Status status;
+  while (decoder.Next().ok()) {
+    switch (decoder.FieldNumber()) {
+      case static_cast<uint32_t>(pwpb::ThreadStatsRequest::Fields::kName): {
+        status.Update(decoder.ReadBytes(&name));
+      }
+    }
+  }
+  return status;
+}
+
+bool NameMatches(const ThreadStats& thread_stats, ConstByteSpan name) {
+  if (!thread_stats.thread_name().has_value()) {
+    return false;
+  }
+  ConstByteSpan thread_name = thread_stats.thread_name().value();
+  return std::equal(
+      thread_name.begin(), thread_name.end(), name.begin(), name.end());
+}
+
+}  // namespace
+
+Status ProtoEncodeThreadStats(pwpb::ThreadStatsResponse::StreamEncoder& encoder,
+                              const ThreadStats& thread_stats) {
+  // Grab the next available ThreadStats slot to write to in the response.
+  pwpb::ThreadStats::StreamEncoder proto_encoder = encoder.GetThreadsEncoder();
+  if (thread_stats.thread_name().has_value()) {
+    PW_TRY(proto_encoder.WriteName(thread_stats.thread_name().value()));
+  } else {
+    // Name is necessary to identify thread.
+    return Status::FailedPrecondition();
+  }
+  if (thread_stats.runtime().has_value()) {
+    PW_TRY(proto_encoder.WriteRuntime(thread_stats.runtime().value()));
+  }
+  if (thread_stats.total_runtime().has_value()) {
+    PW_TRY(
+        proto_encoder.WriteTotalRuntime(thread_stats.total_runtime().value()));
+  }
+  if (thread_stats.context_switches().has_value()) {
+    PW_TRY(proto_encoder.WriteContextSwitches(
+        thread_stats.context_switches().value()));
+  }
+  if (thread_stats.wake_latency() != nullptr) {
+    PW_TRY(proto_encoder.WriteWakeLatencyHistogram(
+        thread_stats.wake_latency()->buckets()));
+  }
+  return proto_encoder.status();
+}
+
+void ThreadStatsService::GetThreadStats(ConstByteSpan request,
+                                        rpc::RawServerWriter& response_writer) {
+  ConstByteSpan name_request;
+  if (!request.empty()) {
+    if (const auto status = DecodeRequestedName(request, name_request);
+        !status.ok()) {
+      PW_LOG_ERROR("Service unable to decode thread name with error code %d",
+                   status.code());
+    }
+  }
+
+  pwpb::ThreadStatsResponse::MemoryEncoder encoder(encode_buffer_);
+  Status encode_status;
+  thread_proto_indices_.clear();
+  thread_proto_indices_.push_back(encoder.size());
+
+  auto cb = [&](const ThreadStats& thread_stats) {
+    if (!name_request.empty() && !NameMatches(thread_stats, name_request)) {
+      return true;
+    }
+    if (thread_proto_indices_.full()) {
+      encode_status.Update(Status::ResourceExhausted());
+      return false;
+    }
+    encode_status.Update(ProtoEncodeThreadStats(encoder, thread_stats));
+    thread_proto_indices_.push_back(encoder.size());
+    // Stop once the requested thread is found, or on the first failure.
+    return name_request.empty() && encode_status.ok();
+  };
+  const Status iteration_status = ForEachThreadStats(cb);
+
+  // Logging is external to thread iteration because it is unsafe to log
+  // within ForEachThreadStats() when the scheduler is disabled.
+  if (!iteration_status.ok() && !iteration_status.IsAborted()) {
+    PW_LOG_ERROR("Failed to capture thread statistics, error %d",
+                 iteration_status.code());
+  }
+  if (!encode_status.ok()) {
+    PW_LOG_ERROR("Failed to encode thread statistics, error %d",
+                 encode_status.code());
+  }
+
+  Status status = iteration_status.IsAborted() ? OkStatus() : iteration_status;
+  status.Update(encode_status);
+  if (status.ok()) {
+    // The last index is the end of the last submessage, not the start of
+    // another.
+    const size_t last_start_index = thread_proto_indices_.size() - 1;
+    for (size_t i = 0; i < last_start_index; i += num_bundled_threads_) {
+      const size_t num_threads =
+          std::min(num_bundled_threads_, last_start_index - i);
+      const size_t bundle_start = thread_proto_indices_[i];
+      const size_t bundle_size =
+          thread_proto_indices_[i + num_threads] - bundle_start;
+      status.Update(response_writer.Write(
+          ConstByteSpan(encoder.data() + bundle_start, bundle_size)));
+    }
+    if (!status.ok()) {
+      PW_LOG_ERROR("Failed to send thread statistics with error code %d",
+                   status.code());
+    }
+  }
+
+  if (response_writer.Finish(status) != OkStatus()) {
+    PW_LOG_ERROR(
+        "Failed to close stream for GetThreadStats() with error code %d",
+        status.code());
+  }
+}
+
+}  // namespace pw::thread::proto
@@ -0,0 +1,120 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_stats_service.h"
+
+#include "gtest/gtest.h"
+#include "pw_bytes/span.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_span/span.h"
+#include "pw_thread/thread_stats.h"
+#include "pw_thread_protos/thread_stats_service.pwpb.h"
+
+namespace pw::thread::proto {
+namespace {
+
+constexpr std::byte kName[] = {
+    std::byte('w'), std::byte('o'), std::byte('r'), std::byte('k')};
+
+// Decodes the single ThreadStats in an encoded ThreadStatsResponse.
+ConstByteSpan FirstThread(ConstByteSpan response) {
+  protobuf::Decoder decoder(response);
+  ConstByteSpan thread;
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() ==
+        static_cast<uint32_t>(pwpb::ThreadStatsResponse::Fields::kThreads)) {
+      EXPECT_EQ(OkStatus(), decoder.ReadBytes(&thread));
+      break;
+    }
+  }
+  return thread;
+}
+
+TEST(ThreadStatsService, EncodeThreadStats_AllFields) {
+  std::array<std::byte, RequiredStatsServiceBufferSize(1)> buffer;
+  pwpb::ThreadStatsResponse::MemoryEncoder encoder(buffer);
+
+  WakeLatencyHistogram histogram;
+  histogram.Record(3);
+  ThreadStats stats;
+  stats.set_thread_name(kName);
+  stats.set_runtime(250);
+  stats.set_total_runtime(1000);
+  stats.set_context_switches(7);
+  stats.set_wake_latency(histogram);
+  ASSERT_EQ(OkStatus(), ProtoEncodeThreadStats(encoder, stats));
+
+  protobuf::Decoder decoder(FirstThread(encoder));
+  ConstByteSpan name;
+  uint64_t runtime = 0;
+  uint64_t total_runtime = 0;
+  uint32_t context_switches = 0;
+  ConstByteSpan histogram_bytes;
+  while (decoder.Next().ok()) {
+    switch (static_cast<pwpb::ThreadStats::Fields>(decoder.FieldNumber())) {
+      case pwpb::ThreadStats::Fields::kName:
+        EXPECT_EQ(OkStatus(), decoder.ReadBytes(&name));
+        break;
+      case pwpb::ThreadStats::Fields::kRuntime:
+        EXPECT_EQ(OkStatus(), decoder.ReadUint64(&runtime));
+        break;
+      case pwpb::ThreadStats::Fields::kTotalRuntime:
+        EXPECT_EQ(OkStatus(), decoder.ReadUint64(&total_runtime));
+        break;
+      case pwpb::ThreadStats::Fields::kContextSwitches:
+        EXPECT_EQ(OkStatus(), decoder.ReadUint32(&context_switches));
+        break;
+      case pwpb::ThreadStats::Fields::kWakeLatencyHistogram:
+        EXPECT_EQ(OkStatus(), decoder.ReadBytes(&histogram_bytes));
+        break;
+    }
+  }
+
+  EXPECT_EQ(name.size(), sizeof(kName));
+  EXPECT_EQ(runtime, 250u);
+  EXPECT_EQ(total_runtime, 1000u);
+  EXPECT_EQ(context_switches, 7u);
+  // One single-byte varint per bucket, with a 1 in bucket 2.
+  ASSERT_EQ(histogram_bytes.size(), WakeLatencyHistogram::kBuckets);
+  EXPECT_EQ(histogram_bytes[2], std::byte{1});
+}
+
+TEST(ThreadStatsService, EncodeThreadStats_OptionalFieldsOmitted) {
+  std::array<std::byte, RequiredStatsServiceBufferSize(1)> buffer;
+  pwpb::ThreadStatsResponse::MemoryEncoder encoder(buffer);
+
+  ThreadStats stats;
+  stats.set_thread_name(kName);
+  ASSERT_EQ(OkStatus(), ProtoEncodeThreadStats(encoder, stats));
+
+  protobuf::Decoder decoder(FirstThread(encoder));
+  size_t fields = 0;
+  while (decoder.Next().ok()) {
+    ++fields;
+  }
+  EXPECT_EQ(fields, 1u);
+}
+
+TEST(ThreadStatsService, EncodeThreadStats_MissingName) {
+  std::array<std::byte, RequiredStatsServiceBufferSize(1)> buffer;
+  pwpb::ThreadStatsResponse::MemoryEncoder encoder(buffer);
+
+  ThreadStats stats;
+  stats.set_runtime(1);
+  EXPECT_EQ(Status::FailedPrecondition(),
+            ProtoEncodeThreadStats(encoder, stats));
+}
+
+}  // namespace
+}  // namespace pw::thread::proto
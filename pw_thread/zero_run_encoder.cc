@@ -0,0 +1,96 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread_private/zero_run_encoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw::thread::internal {
+namespace {
+
+// A literal chunk ends at a run of this many zeros. Shorter runs cost the same
+// or less to keep in the literal.
+constexpr size_t kMinZeroRunInLiteral = 3;
+
+}  // namespace
+
+ZeroRunEncoder::Chunk ZeroRunEncoder::NextChunk(ConstByteSpan input,
+                                                size_t offset) {
+  const size_t limit = std::min(input.size() - offset, kMaxRunSizeBytes);
+  size_t size = 0;
+
+  if (input[offset] == std::byte{0}) {
+    while (size < limit && input[offset + size] == std::byte{0}) {
+      size += 1;
+    }
+    return Chunk{.zeros = true, .size = size};
+  }
+
+  size_t zeros = 0;
+  while (size < limit) {
+    zeros = input[offset + size] == std::byte{0} ? zeros + 1 : 0;
+    size += 1;
+    if (zeros == kMinZeroRunInLiteral) {
+      size -= zeros;
+      break;
+    }
+  }
+  return Chunk{.zeros = false, .size = size};
+}
+
+size_t ZeroRunEncoder::EncodedSize(ConstByteSpan input) {
+  size_t encoded_size = 0;
+  for (size_t offset = 0; offset < input.size();) {
+    const Chunk chunk = NextChunk(input, offset);
+    encoded_size += chunk.zeros ? 1 : 1 + chunk.size;
+    offset += chunk.size;
+  }
+  return encoded_size;
+}
+
+StatusWithSize ZeroRunEncoder::DoRead(ByteSpan destination) {
+  size_t written = 0;
+  while (written < destination.size()) {
+    if (literal_bytes_remaining_ != 0u) {
+      const size_t size =
+          std::min(literal_bytes_remaining_, destination.size() - written);
+      std::memcpy(&destination[written], &input_[offset_], size);
+      written += size;
+      offset_ += size;
+      literal_bytes_remaining_ -= size;
+      continue;
+    }
+    if (offset_ == input_.size()) {
+      break;
+    }
+
+    const Chunk chunk = NextChunk(input_, offset_);
+    if (chunk.zeros) {
+      destination[written] = static_cast<std::byte>(0x80 | (chunk.size - 1));
+      offset_ += chunk.size;
+    } else {
+      destination[written] = static_cast<std::byte>(chunk.size - 1);
+      literal_bytes_remaining_ = chunk.size;
+    }
+    written += 1;
+  }
+
+  if (written == 0u && !destination.empty()) {
+    return StatusWithSize::OutOfRange();
+  }
+  return StatusWithSize(written);
+}
+
+}  // namespace pw::thread::internal
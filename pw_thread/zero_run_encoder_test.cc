@@ -0,0 +1,146 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread_private/zero_run_encoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_bytes/span.h"
+
+namespace pw::thread::internal {
+namespace {
+
+// Reads all of the encoder's output, `chunk_size` bytes at a time.
+ConstByteSpan EncodeAll(ZeroRunEncoder& encoder,
+                        ByteSpan output,
+                        size_t chunk_size) {
+  size_t size = 0;
+  while (size < output.size()) {
+    Result<ByteSpan> result = encoder.Read(
+        output.subspan(size, std::min(chunk_size, output.size() - size)));
+    if (!result.ok()) {
+      EXPECT_EQ(Status::OutOfRange(), result.status());
+      break;
+    }
+    size += result->size();
+  }
+  return output.first(size);
+}
+
+// Decodes zero-run encoded data, as the host-side tooling does.
+ConstByteSpan Decode(ConstByteSpan encoded, ByteSpan output) {
+  size_t size = 0;
+  for (size_t i = 0; i < encoded.size();) {
+    const uint8_t control = static_cast<uint8_t>(encoded[i++]);
+    const size_t run = (control & 0x7fu) + 1;
+    if ((control & 0x80u) != 0u) {
+      std::memset(&output[size], 0, run);
+    } else {
+      std::memcpy(&output[size], &encoded[i], run);
+      i += run;
+    }
+    size += run;
+  }
+  return output.first(size);
+}
+
+bool Equal(ConstByteSpan lhs, ConstByteSpan rhs) {
+  return lhs.size() == rhs.size() &&
+         std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+TEST(ZeroRunEncoder, Empty) {
+  EXPECT_EQ(0u, ZeroRunEncoder::EncodedSize({}));
+
+  ZeroRunEncoder encoder({});
+  std::array<std::byte, 4> output;
+  EXPECT_EQ(Status::OutOfRange(), encoder.Read(output).status());
+}
+
+TEST(ZeroRunEncoder, LiteralsAndZeros) {
+  constexpr auto kInput = bytes::Array<0x12, 0x34, 0, 0, 0, 0, 0x56>();
+  constexpr auto kExpected = bytes::Array<0x01, 0x12, 0x34, 0x83, 0x00, 0x56>();
+  EXPECT_EQ(kExpected.size(), ZeroRunEncoder::EncodedSize(kInput));
+
+  ZeroRunEncoder encoder(kInput);
+  std::array<std::byte, 16> output;
+  EXPECT_TRUE(Equal(kExpected, EncodeAll(encoder, output, output.size())));
+}
+
+TEST(ZeroRunEncoder, ShortZeroRunsStayInLiteral) {
+  constexpr auto kInput = bytes::Array<0x01, 0, 0, 0x02, 0, 0x03>();
+  constexpr auto kExpected =
+      bytes::Array<0x05, 0x01, 0, 0, 0x02, 0, 0x03>();
+  ZeroRunEncoder encoder(kInput);
+  std::array<std::byte, 16> output;
+  EXPECT_TRUE(Equal(kExpected, EncodeAll(encoder, output, output.size())));
+}
+
+TEST(ZeroRunEncoder, LongRunsAreSplit) {
+  std::array<std::byte, 300> input{};
+  for (size_t i = 200; i < input.size(); ++i) {
+    input[i] = std::byte{0xaa};
+  }
+
+  // 200 zeros take two chunks, 100 literal bytes take one.
+  EXPECT_EQ(2u + 1u + 100u, ZeroRunEncoder::EncodedSize(input));
+
+  ZeroRunEncoder encoder(input);
+  std::array<std::byte, 128> encoded;
+  std::array<std::byte, 300> decoded;
+  EXPECT_TRUE(
+      Equal(input, Decode(EncodeAll(encoder, encoded, 7), decoded)));
+}
+
+TEST(ZeroRunEncoder, StackLikeData_RoundTripsInSmallReads) {
+  // Words that look like a Cortex-M stack: small integers, zeros, and
+  // pointers into RAM and flash.
+  std::array<uint32_t, 256> words;
+  for (size_t i = 0; i < words.size(); ++i) {
+    switch (i % 8) {
+      case 0:
+        words[i] = 0x20001000 + static_cast<uint32_t>(i) * 8;
+        break;
+      case 1:
+        words[i] = 0x08004321 + static_cast<uint32_t>(i) * 2;
+        break;
+      case 2:
+        words[i] = static_cast<uint32_t>(i);
+        break;
+      default:
+        words[i] = 0;
+    }
+  }
+  const ConstByteSpan input = as_bytes(span(words));
+
+  const size_t encoded_size = ZeroRunEncoder::EncodedSize(input);
+  EXPECT_LT(encoded_size, input.size() / 2);
+
+  for (size_t chunk_size : {1u, 3u, 32u, 1024u}) {
+    ZeroRunEncoder encoder(input);
+    std::array<std::byte, sizeof(words)> encoded;
+    std::array<std::byte, sizeof(words)> decoded;
+    const ConstByteSpan result = EncodeAll(encoder, encoded, chunk_size);
+    EXPECT_EQ(encoded_size, result.size());
+    EXPECT_TRUE(Equal(input, Decode(result, decoded)));
+  }
+}
+
+}  // namespace
+}  // namespace pw::thread::internal
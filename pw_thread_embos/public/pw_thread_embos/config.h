@@ -68,6 +68,14 @@
 #define PW_THREAD_EMBOS_CONFIG_DEFAULT_TIME_SLICE_INTERVAL 2
 #endif  // PW_THREAD_EMBOS_CONFIG_DEFAULT_TIME_SLICE_INTERVAL
 
+// The timestamp used by the thread statistics backend, as a uint32_t. By
+// default this is the embOS system time; OS_GetTime_Cycles() gives finer
+// runtime accounting.
+#ifndef PW_THREAD_EMBOS_CONFIG_STATS_TIMESTAMP
+#define PW_THREAD_EMBOS_CONFIG_STATS_TIMESTAMP() \
+  static_cast<uint32_t>(OS_GetTime32())
+#endif  // PW_THREAD_EMBOS_CONFIG_STATS_TIMESTAMP
+
 // The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_THREAD_EMBOS_CONFIG_LOG_LEVEL
 #define PW_THREAD_EMBOS_CONFIG_LOG_LEVEL PW_LOG_LEVEL_DEBUG
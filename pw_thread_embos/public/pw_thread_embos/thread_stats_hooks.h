@@ -0,0 +1,35 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_preprocessor/util.h"
+
+// Scheduler hooks which feed the pw_thread_embos:thread_stats backend. Call
+// these from the matching callbacks of the OS_TRACE_API installed with
+// OS_SetTraceAPI(); embOS task IDs are the OS_TASK pointers:
+//
+//   OnTaskStartReady(TaskId) -> pw_thread_embos_TaskStartReady(TaskId)
+//   OnTaskStartExec(TaskId)  -> pw_thread_embos_TaskStartExec(TaskId)
+//   OnTaskStopExec()         -> pw_thread_embos_TaskStopExec(
+//                                   OS_GetpCurrentTask())
+//   OnTaskTerminate(TaskId)  -> pw_thread_embos_TaskTerminate(TaskId)
+
+PW_EXTERN_C_START
+
+void pw_thread_embos_TaskStartReady(void* task);
+void pw_thread_embos_TaskStartExec(void* task);
+void pw_thread_embos_TaskStopExec(void* task);
+void pw_thread_embos_TaskTerminate(void* task);
+
+PW_EXTERN_C_END
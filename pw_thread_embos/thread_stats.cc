@@ -0,0 +1,77 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_stats.h"
+
+#include <string_view>
+
+#include "RTOS.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_thread/scheduler_stats.h"
+#include "pw_thread_embos/config.h"
+#include "pw_thread_embos/thread_stats_hooks.h"
+#include "pw_thread_embos/util.h"
+
+namespace pw::thread {
+namespace {
+
+// Only accessed from the trace API callbacks, which embOS runs from the
+// scheduler, or with interrupts disabled.
+SchedulerStats scheduler_stats;
+
+}  // namespace
+
+// This will disable interrupts.
+Status ForEachThreadStats(const pw::thread::ThreadStatsCallback& cb) {
+  OS_IncDI();
+  const uint32_t now = PW_THREAD_EMBOS_CONFIG_STATS_TIMESTAMP();
+  const uint64_t total_runtime = scheduler_stats.TotalRuntime(now);
+  Status status = pw::thread::embos::ForEachThread(
+      [&cb, now, total_runtime](const OS_TASK& thread) -> bool {
+        ThreadStats thread_stats;
+#if OS_TRACKNAME
+        if (thread.Name != nullptr) {
+          thread_stats.set_thread_name(
+              as_bytes(span(std::string_view(thread.Name))));
+        }
+#endif  // OS_TRACKNAME
+        thread_stats.set_total_runtime(total_runtime);
+        scheduler_stats.GetStats(&thread, now, thread_stats);
+        return cb(thread_stats);
+      });
+  OS_DecRI();
+  return status;
+}
+
+}  // namespace pw::thread
+
+extern "C" void pw_thread_embos_TaskStartReady(void* task) {
+  pw::thread::scheduler_stats.ThreadReady(
+      task, PW_THREAD_EMBOS_CONFIG_STATS_TIMESTAMP());
+}
+
+extern "C" void pw_thread_embos_TaskStartExec(void* task) {
+  pw::thread::scheduler_stats.ThreadSwitchedIn(
+      task, PW_THREAD_EMBOS_CONFIG_STATS_TIMESTAMP());
+}
+
+extern "C" void pw_thread_embos_TaskStopExec(void* task) {
+  pw::thread::scheduler_stats.ThreadSwitchedOut(
+      task, PW_THREAD_EMBOS_CONFIG_STATS_TIMESTAMP());
+}
+
+extern "C" void pw_thread_embos_TaskTerminate(void* task) {
+  pw::thread::scheduler_stats.ThreadDeleted(task);
+}
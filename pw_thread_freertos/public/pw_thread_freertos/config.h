@@ -68,6 +68,19 @@
 #define PW_THREAD_FREERTOS_CONFIG_LOG_LEVEL PW_LOG_LEVEL_DEBUG
 #endif  // PW_THREAD_FREERTOS_CONFIG_LOG_LEVEL
 
+// The timestamp used by the thread statistics backend, as a uint32_t. By
+// default this is the run time stats counter if FreeRTOS generates run time
+// stats, otherwise it is the tick count.
+#ifndef PW_THREAD_FREERTOS_CONFIG_STATS_TIMESTAMP
+#if configGENERATE_RUN_TIME_STATS == 1
+#define PW_THREAD_FREERTOS_CONFIG_STATS_TIMESTAMP() \
+  static_cast<uint32_t>(portGET_RUN_TIME_COUNTER_VALUE())
+#else
+#define PW_THREAD_FREERTOS_CONFIG_STATS_TIMESTAMP() \
+  static_cast<uint32_t>(xTaskGetTickCountFromISR())
+#endif  // configGENERATE_RUN_TIME_STATS
+#endif  // PW_THREAD_FREERTOS_CONFIG_STATS_TIMESTAMP
+
 namespace pw::thread::freertos::config {
 
 inline constexpr size_t kMinimumStackSizeWords = configMINIMAL_STACK_SIZE;
@@ -0,0 +1,39 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_preprocessor/util.h"
+
+// Scheduler hooks which feed the pw_thread_freertos:thread_stats backend. This
+// header is included from FreeRTOSConfig.h, so it must not include FreeRTOS
+// headers. Route the FreeRTOS trace macros to these hooks:
+//
+//   #include "pw_thread_freertos/thread_stats_hooks.h"
+//
+//   #define traceMOVED_TASK_TO_READY_STATE(pxTCB) \
+//     pw_thread_freertos_TaskReady(pxTCB)
+//   #define traceTASK_SWITCHED_IN() \
+//     pw_thread_freertos_TaskSwitchedIn(pxCurrentTCB)
+//   #define traceTASK_SWITCHED_OUT() \
+//     pw_thread_freertos_TaskSwitchedOut(pxCurrentTCB)
+//   #define traceTASK_DELETE(pxTCB) pw_thread_freertos_TaskDeleted(pxTCB)
+
+PW_EXTERN_C_START
+
+void pw_thread_freertos_TaskReady(void* task);
+void pw_thread_freertos_TaskSwitchedIn(void* task);
+void pw_thread_freertos_TaskSwitchedOut(void* task);
+void pw_thread_freertos_TaskDeleted(void* task);
+
+PW_EXTERN_C_END
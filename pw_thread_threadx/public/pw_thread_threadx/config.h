@@ -53,6 +53,14 @@
 #define PW_THREAD_THREADX_CONFIG_DEFAULT_TIME_SLICE_INTERVAL TX_NO_TIME_SLICE
 #endif  // PW_THREAD_THREADX_CONFIG_DEFAULT_TIME_SLICE_INTERVAL
 
+// The timestamp used by the thread statistics backend, as a uint32_t. By
+// default this is the ThreadX tick count; a cycle counter gives finer runtime
+// accounting.
+#ifndef PW_THREAD_THREADX_CONFIG_STATS_TIMESTAMP
+#define PW_THREAD_THREADX_CONFIG_STATS_TIMESTAMP() \
+  static_cast<uint32_t>(tx_time_get())
+#endif  // PW_THREAD_THREADX_CONFIG_STATS_TIMESTAMP
+
 // The minimum priority level, this is normally based on the number of priority
 // levels.
 #ifndef PW_THREAD_THREADX_CONFIG_MIN_PRIORITY
@@ -0,0 +1,32 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_preprocessor/util.h"
+
+// The pw_thread_threadx:thread_stats backend implements the ThreadX execution
+// profile hooks, so ThreadX must be built with TX_EXECUTION_PROFILE_ENABLE and
+// without tx_execution_profile.c. To reclaim the statistics of deleted
+// threads, also route the thread delete extension to this hook in tx_user.h:
+//
+//   #include "pw_thread_threadx/thread_stats_hooks.h"
+//
+//   #define TX_THREAD_DELETE_EXTENSION(thread_ptr) \
+//     pw_thread_threadx_ThreadDeleted(thread_ptr)
+
+PW_EXTERN_C_START
+
+void pw_thread_threadx_ThreadDeleted(void* thread);
+
+PW_EXTERN_C_END
@@ -0,0 +1,80 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_stats.h"
+
+#include <string_view>
+
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_thread/scheduler_stats.h"
+#include "pw_thread_threadx/config.h"
+#include "pw_thread_threadx/thread_stats_hooks.h"
+#include "pw_thread_threadx/util.h"
+#include "tx_api.h"
+#include "tx_thread.h"
+
+namespace pw::thread {
+namespace {
+
+// Only accessed from the execution profile hooks, which ThreadX runs during
+// context switches, or with interrupts disabled.
+SchedulerStats scheduler_stats;
+
+}  // namespace
+
+// This will disable interrupts.
+Status ForEachThreadStats(const pw::thread::ThreadStatsCallback& cb) {
+  const UINT previous_posture = tx_interrupt_control(TX_INT_DISABLE);
+  const uint32_t now = PW_THREAD_THREADX_CONFIG_STATS_TIMESTAMP();
+  const uint64_t total_runtime = scheduler_stats.TotalRuntime(now);
+  Status status = pw::thread::threadx::ForEachThread(
+      [&cb, now, total_runtime](const TX_THREAD& thread) -> bool {
+        ThreadStats thread_stats;
+        if (thread.tx_thread_name != nullptr) {
+          thread_stats.set_thread_name(
+              as_bytes(span(std::string_view(thread.tx_thread_name))));
+        }
+        thread_stats.set_total_runtime(total_runtime);
+        scheduler_stats.GetStats(&thread, now, thread_stats);
+        return cb(thread_stats);
+      });
+  tx_interrupt_control(previous_posture);
+  return status;
+}
+
+}  // namespace pw::thread
+
+// ThreadX execution profile hooks, see TX_EXECUTION_PROFILE_ENABLE. ThreadX
+// has no hook for a thread becoming ready, so no wake-up latency is recorded.
+
+extern "C" void _tx_execution_initialize(void) {}
+
+extern "C" void _tx_execution_thread_enter(void) {
+  pw::thread::scheduler_stats.ThreadSwitchedIn(
+      _tx_thread_current_ptr, PW_THREAD_THREADX_CONFIG_STATS_TIMESTAMP());
+}
+
+extern "C" void _tx_execution_thread_exit(void) {
+  pw::thread::scheduler_stats.ThreadSwitchedOut(
+      _tx_thread_current_ptr, PW_THREAD_THREADX_CONFIG_STATS_TIMESTAMP());
+}
+
+extern "C" void _tx_execution_isr_enter(void) {}
+
+extern "C" void _tx_execution_isr_exit(void) {}
+
+extern "C" void pw_thread_threadx_ThreadDeleted(void* thread) {
+  pw::thread::scheduler_stats.ThreadDeleted(thread);
+}
@@ -0,0 +1,105 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_stats.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+
+#include <string_view>
+
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_thread/scheduler_stats.h"
+
+namespace pw::thread {
+namespace {
+
+// The tracing hooks run on every CPU with the scheduler lock held, so the
+// recorder gets its own spin lock.
+k_spinlock stats_lock;
+SchedulerStats scheduler_stats;
+
+struct Context {
+  const ThreadStatsCallback* cb;
+  uint64_t total_runtime;
+  uint32_t now;
+};
+
+void ZephyrAdapter(const struct k_thread* thread, void* user_data) {
+  const Context& context = *static_cast<const Context*>(user_data);
+
+  ThreadStats thread_stats;
+  const char* name = k_thread_name_get(const_cast<k_tid_t>(thread));
+  if (name != nullptr) {
+    thread_stats.set_thread_name(as_bytes(span(std::string_view(name))));
+  }
+  thread_stats.set_total_runtime(context.total_runtime);
+
+  // Copy the histogram so the callback runs without the lock held.
+  WakeLatencyHistogram wake_latency;
+  k_spinlock_key_t key = k_spin_lock(&stats_lock);
+  if (scheduler_stats.GetStats(thread, context.now, thread_stats)) {
+    wake_latency = *thread_stats.wake_latency();
+    thread_stats.set_wake_latency(wake_latency);
+  }
+  k_spin_unlock(&stats_lock, key);
+
+  // k_thread_foreach() can't be stopped early, so the callback's result is
+  // ignored as in ForEachThread().
+  (*context.cb)(thread_stats);
+}
+
+}  // namespace
+
+Status ForEachThreadStats(const pw::thread::ThreadStatsCallback& cb) {
+  Context context{&cb, 0, 0};
+  k_spinlock_key_t key = k_spin_lock(&stats_lock);
+  context.now = k_cycle_get_32();
+  context.total_runtime = scheduler_stats.TotalRuntime(context.now);
+  k_spin_unlock(&stats_lock, key);
+
+  k_thread_foreach(ZephyrAdapter, &context);
+  return OkStatus();
+}
+
+}  // namespace pw::thread
+
+// CONFIG_TRACING_USER hooks, which override Zephyr's weak definitions.
+
+extern "C" void sys_trace_thread_sched_ready_user(struct k_thread* thread) {
+  k_spinlock_key_t key = k_spin_lock(&pw::thread::stats_lock);
+  pw::thread::scheduler_stats.ThreadReady(thread, k_cycle_get_32());
+  k_spin_unlock(&pw::thread::stats_lock, key);
+}
+
+extern "C" void sys_trace_thread_switched_in_user(void) {
+  k_spinlock_key_t key = k_spin_lock(&pw::thread::stats_lock);
+  pw::thread::scheduler_stats.ThreadSwitchedIn(k_current_get(),
+                                               k_cycle_get_32());
+  k_spin_unlock(&pw::thread::stats_lock, key);
+}
+
+extern "C" void sys_trace_thread_switched_out_user(void) {
+  k_spinlock_key_t key = k_spin_lock(&pw::thread::stats_lock);
+  pw::thread::scheduler_stats.ThreadSwitchedOut(k_current_get(),
+                                                k_cycle_get_32());
+  k_spin_unlock(&pw::thread::stats_lock, key);
+}
+
+extern "C" void sys_trace_thread_abort_user(struct k_thread* thread) {
+  k_spinlock_key_t key = k_spin_lock(&pw::thread::stats_lock);
+  pw::thread::scheduler_stats.ThreadDeleted(thread);
+  k_spin_unlock(&pw::thread::stats_lock, key);
+}
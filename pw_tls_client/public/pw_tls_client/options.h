@@ -47,13 +47,24 @@ class SessionOptions {
     return *this;
   }
 
+  // Enables session tickets (RFC 5077). The server may then send a ticket that
+  // lets the session be resumed without the server keeping any state. This
+  // only takes effect if the backend is built with ticket support.
+  constexpr SessionOptions& set_session_tickets(bool enable) {
+    session_tickets_ = enable;
+    return *this;
+  }
+
   constexpr pw::stream::ReaderWriter* transport() const { return transport_; }
 
   constexpr std::string_view server_name() const { return server_name_; }
 
+  constexpr bool session_tickets() const { return session_tickets_; }
+
  private:
   std::string_view server_name_;
   pw::stream::ReaderWriter* transport_ = nullptr;
+  bool session_tickets_ = false;
 
   // TODO(zyecheng): Expand the list as necessary to cover aspects such as
   // certificate verification/revocation check policies.
@@ -144,6 +144,14 @@ Status SessionImplementation::Setup() {
   // The API does not fail.
   mbedtls_ssl_conf_authmode(&ssl_config_, MBEDTLS_SSL_VERIFY_REQUIRED);
 
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+  // The API does not fail.
+  mbedtls_ssl_conf_session_tickets(&ssl_config_,
+                                   session_options_.session_tickets()
+                                       ? MBEDTLS_SSL_SESSION_TICKETS_ENABLED
+                                       : MBEDTLS_SSL_SESSION_TICKETS_DISABLED);
+#endif  // defined(MBEDTLS_SSL_SESSION_TICKETS)
+
   // TODO(b/235289501): Add logic for loading trust anchors.
 
   // Load configuration to SSL.
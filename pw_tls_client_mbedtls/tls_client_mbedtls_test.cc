@@ -31,6 +31,15 @@ TEST(TLSClientMbedTLS, CreateFailOnMissingTransport) {
   ASSERT_NE(res.status(), OkStatus());
 }
 
+TEST(TLSClientMbedTLS, CreateWithSessionTickets) {
+  auto options = SessionOptions()
+                     .set_transport(stream::NullStream::Instance())
+                     .set_session_tickets(true);
+  auto res = Session::Create(options);
+  ASSERT_EQ(res.status(), OkStatus());
+  ASSERT_NE(res.value(), nullptr);
+}
+
 TEST(TLSClientMbedTLS, EntropySourceFail) {
   backend::SessionImplementation::SetEntropySourceStatus(Status::Internal());
   auto options = SessionOptions().set_transport(stream::NullStream::Instance());
@@ -68,6 +68,12 @@ bool IsBetterResult(const DecodingResult& lhs, const DecodingResult& rhs) {
   return lhs.second > rhs.second;
 }
 
+// Tokens are already hashes, but they may be hand-picked values, so mix the
+// bits before using them as a hash table index.
+constexpr size_t HashToken(uint32_t token) {
+  return static_cast<uint32_t>(token * 0x9E3779B1u) ^ (token >> 16);
+}
+
 }  // namespace
 
 DetokenizedString::DetokenizedString(
@@ -106,6 +112,85 @@ Detokenizer::Detokenizer(const TokenDatabase& database) {
   }
 }
 
+Detokenizer Detokenizer::InPlace(const TokenDatabase& database) {
+  Detokenizer detokenizer;
+  detokenizer.in_place_ = true;
+
+  std::vector<TokenDatabase::Entry>& entries = detokenizer.entries_;
+  entries.reserve(database.size());
+  for (const auto& entry : database) {
+    entries.push_back(entry);
+  }
+
+  // Binary databases are written sorted by token, but sort in case they are
+  // not. Keep the database order of entries with the same token.
+  std::stable_sort(entries.begin(),
+                   entries.end(),
+                   [](const TokenDatabase::Entry& lhs,
+                      const TokenDatabase::Entry& rhs) {
+                     return lhs.token < rhs.token;
+                   });
+
+  if (entries.empty()) {
+    return detokenizer;
+  }
+
+  detokenizer.parsed_ = std::make_unique<LazyEntries[]>(entries.size());
+
+  // Size the table to a power of two that keeps it at most half full.
+  size_t slots = 1;
+  while (slots < entries.size() * 2) {
+    slots *= 2;
+  }
+  detokenizer.index_.assign(slots, kEmptySlot);
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (i != 0u && entries[i].token == entries[i - 1].token) {
+      continue;  // Only index the first entry for each token.
+    }
+
+    size_t slot = HashToken(entries[i].token) & (slots - 1);
+    while (detokenizer.index_[slot] != kEmptySlot) {
+      slot = (slot + 1) & (slots - 1);
+    }
+    detokenizer.index_[slot] = static_cast<uint32_t>(i);
+  }
+
+  return detokenizer;
+}
+
+Detokenizer::Detokenizer(const Detokenizer& other)
+    : database_(other.database_),
+      in_place_(other.in_place_),
+      entries_(other.entries_),
+      index_(other.index_) {
+  if (other.parsed_ != nullptr) {
+    parsed_ = std::make_unique<LazyEntries[]>(entries_.size());
+  }
+}
+
+Detokenizer& Detokenizer::operator=(const Detokenizer& other) {
+  if (this != &other) {
+    *this = Detokenizer(other);
+  }
+  return *this;
+}
+
+size_t Detokenizer::FindInPlace(uint32_t token) const {
+  if (index_.empty()) {
+    return entries_.size();
+  }
+
+  const size_t mask = index_.size() - 1;
+  for (size_t slot = HashToken(token) & mask; index_[slot] != kEmptySlot;
+       slot = (slot + 1) & mask) {
+    if (entries_[index_[slot]].token == token) {
+      return index_[slot];
+    }
+  }
+  return entries_.size();
+}
+
 DetokenizedString Detokenizer::Detokenize(
     const span<const uint8_t>& encoded) const {
   // The token is missing from the encoded data; there is nothing to do.
@@ -116,14 +201,78 @@ DetokenizedString Detokenizer::Detokenize(
   uint32_t token = bytes::ReadInOrder<uint32_t>(
       endian::little, encoded.data(), encoded.size());
 
-  const auto result = database_.find(token);
+  return DetokenizedString(token,
+                           Find(token),
+                           encoded.size() < sizeof(token)
+                               ? span<const uint8_t>()
+                               : encoded.subspan(sizeof(token)));
+}
 
-  return DetokenizedString(
-      token,
-      result == database_.end() ? span<TokenizedStringEntry>()
-                                : span(result->second),
-      encoded.size() < sizeof(token) ? span<const uint8_t>()
-                                     : encoded.subspan(sizeof(token)));
+span<const TokenizedStringEntry> Detokenizer::Find(uint32_t token) const {
+  if (!in_place_) {
+    const auto result = database_.find(token);
+    return result == database_.end() ? span<TokenizedStringEntry>()
+                                     : span(result->second);
+  }
+
+  const size_t first = FindInPlace(token);
+  if (first == entries_.size()) {
+    return span<TokenizedStringEntry>();
+  }
+
+  std::atomic<const std::vector<TokenizedStringEntry>*>& slot =
+      parsed_[first].parsed;
+  const std::vector<TokenizedStringEntry>* parsed =
+      slot.load(std::memory_order_acquire);
+
+  if (parsed == nullptr) {
+    auto new_entries = std::make_unique<std::vector<TokenizedStringEntry>>();
+    for (size_t i = first; i < entries_.size() && entries_[i].token == token;
+         ++i) {
+      new_entries->emplace_back(entries_[i].string, entries_[i].date_removed);
+    }
+
+    // If another thread parsed this token first, use its entries instead.
+    if (slot.compare_exchange_strong(parsed,
+                                     new_entries.get(),
+                                     std::memory_order_acq_rel,
+                                     std::memory_order_acquire)) {
+      parsed = new_entries.release();
+    }
+  }
+  return *parsed;
+}
+
+void Detokenizer::DetokenizeBatch(span<const span<const uint8_t>> messages,
+                                  DetokenizedBatch& batch) const {
+  batch.ends_.reserve(batch.ends_.size() + messages.size());
+
+  for (const span<const uint8_t>& encoded : messages) {
+    if (encoded.empty()) {
+      batch.strings_.append(PW_TOKENIZER_ARG_DECODING_ERROR("missing token"));
+      batch.ends_.push_back(batch.strings_.size());
+      continue;
+    }
+
+    const uint32_t token = bytes::ReadInOrder<uint32_t>(
+        endian::little, encoded.data(), encoded.size());
+    const span<const uint8_t> arguments = encoded.size() < sizeof(token)
+                                              ? span<const uint8_t>()
+                                              : encoded.subspan(sizeof(token));
+    const span<const TokenizedStringEntry> entries = Find(token);
+
+    if (entries.empty()) {
+      batch.strings_.append(UnknownTokenMessage(token));
+    } else if (entries.size() == 1u) {
+      // Without collisions, there is no need to rank the results.
+      batch.strings_.append(
+          entries[0].first.Format(arguments).value_with_errors());
+    } else {
+      batch.strings_.append(
+          DetokenizedString(token, entries, arguments).BestStringWithErrors());
+    }
+    batch.ends_.push_back(batch.strings_.size());
+  }
 }
 
 }  // namespace pw::tokenizer
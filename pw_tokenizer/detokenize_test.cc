@@ -15,6 +15,8 @@
 #include "pw_tokenizer/detokenize.h"
 
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -290,5 +292,144 @@ TEST_F(DetokenizeWithCollisions, Collision_TracksAllMatches) {
   EXPECT_EQ(result.matches().size(), 7u);
 }
 
+TEST(DetokenizeInPlace, MatchesCopiedDatabase) {
+  const Detokenizer copied(TokenDatabase::Create<kBasicData>());
+  const Detokenizer in_place =
+      Detokenizer::InPlace(TokenDatabase::Create<kBasicData>());
+
+  for (std::string_view data : {"\1\0\0\0"sv,
+                                "\5\0\0\0"sv,
+                                "\xff"sv,
+                                "\xff\xee\xee\xdd"sv,
+                                "\xff\xee\xee\xdd\xeeLikes"sv,
+                                "\2\0\0\0"sv,
+                                ""sv}) {
+    EXPECT_EQ(in_place.Detokenize(data).BestString(),
+              copied.Detokenize(data).BestString());
+    EXPECT_EQ(in_place.Detokenize(data).BestStringWithErrors(),
+              copied.Detokenize(data).BestStringWithErrors());
+  }
+}
+
+TEST(DetokenizeInPlace, Collisions) {
+  const Detokenizer detok = Detokenizer::InPlace(kWithCollisions);
+
+  EXPECT_EQ(detok.Detokenize("\0\0\0\0"sv).matches().size(), 7u);
+  EXPECT_EQ(detok.Detokenize("\0\0\0\0"sv).BestString(),
+            "This string is present");
+  EXPECT_EQ(detok.Detokenize("\xAA\xAA\xAA\xAA"sv).BestString(),
+            "This one is present");
+  EXPECT_EQ(detok.Detokenize("\xBB\xBB\xBB\xBB\x00"sv).BestString(),
+            "Two ints 0 %d");
+  EXPECT_TRUE(detok.Detokenize("\xEE\xEE\xEE\xEE"sv).matches().empty());
+}
+
+span<const uint8_t> AsBytes(std::string_view data) {
+  return span(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+TEST(DetokenizeBatch, MatchesBestStringWithErrors) {
+  const Detokenizer copied(kWithCollisions);
+  const Detokenizer in_place = Detokenizer::InPlace(kWithCollisions);
+
+  constexpr std::string_view kMessages[] = {
+      "\0\0\0\0"sv,
+      "\0\0\0\0\x01"sv,
+      "\xBB\xBB\xBB\xBB\x00"sv,
+      "\xCC\xCC\xCC\xCC\2Yo\5?"sv,
+      "\0\0\0\0\x01"sv,
+      "\x12\x34\x56\x78"sv,
+      ""sv,
+  };
+  std::vector<span<const uint8_t>> messages;
+  for (std::string_view message : kMessages) {
+    messages.push_back(AsBytes(message));
+  }
+
+  for (const Detokenizer* detok : {&copied, &in_place}) {
+    DetokenizedBatch batch;
+    detok->DetokenizeBatch(messages, batch);
+
+    ASSERT_EQ(batch.size(), messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+      EXPECT_EQ(std::string(batch[i]),
+                detok->Detokenize(kMessages[i]).BestStringWithErrors());
+    }
+  }
+}
+
+TEST(DetokenizeBatch, AppendsAndClears) {
+  const Detokenizer detok = Detokenizer::InPlace(kWithCollisions);
+  const span<const uint8_t> messages[] = {AsBytes("\xAA\xAA\xAA\xAA"sv)};
+
+  DetokenizedBatch batch;
+  detok.DetokenizeBatch(messages, batch);
+  detok.DetokenizeBatch(messages, batch);
+  ASSERT_EQ(batch.size(), 2u);
+  EXPECT_EQ(batch[0], "This one is present"sv);
+  EXPECT_EQ(batch[1], "This one is present"sv);
+
+  batch.clear();
+  EXPECT_TRUE(batch.empty());
+
+  // A batch may be used with multiple detokenizers.
+  const Detokenizer other =
+      Detokenizer::InPlace(TokenDatabase::Create<kBasicData>());
+  other.DetokenizeBatch(messages, batch);
+  ASSERT_EQ(batch.size(), 1u);
+  EXPECT_EQ(batch[0], ERR("unknown token aaaaaaaa"));
+}
+
+TEST(DetokenizeInPlace, RepeatedTokensReuseParsedEntries) {
+  const Detokenizer detok = Detokenizer::InPlace(kWithCollisions);
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(detok.Detokenize("\0\0\0\0\x01"sv).BestString(), "One arg -1");
+    EXPECT_EQ(detok.Detokenize("\xAA\xAA\xAA\xAA"sv).BestString(),
+              "This one is present");
+  }
+  EXPECT_EQ(detok.Detokenize("\0\0\0\0"sv).matches().size(), 7u);
+}
+
+TEST(DetokenizeInPlace, MoveKeepsParsedEntries) {
+  Detokenizer original = Detokenizer::InPlace(kWithCollisions);
+  EXPECT_EQ(original.Detokenize("\xAA\xAA\xAA\xAA"sv).BestString(),
+            "This one is present");
+
+  const Detokenizer moved = std::move(original);
+  EXPECT_EQ(moved.Detokenize("\xAA\xAA\xAA\xAA"sv).BestString(),
+            "This one is present");
+  EXPECT_EQ(moved.Detokenize("\xBB\xBB\xBB\xBB\x00"sv).BestString(),
+            "Two ints 0 %d");
+}
+
+TEST(DetokenizeInPlace, CopyParsesEntriesSeparately) {
+  Detokenizer original = Detokenizer::InPlace(kWithCollisions);
+  EXPECT_EQ(original.Detokenize("\xAA\xAA\xAA\xAA"sv).BestString(),
+            "This one is present");
+
+  Detokenizer copy = original;
+  EXPECT_EQ(copy.Detokenize("\xAA\xAA\xAA\xAA"sv).BestString(),
+            "This one is present");
+
+  // Each copy owns its parsed entries, so the original may be destroyed.
+  original = Detokenizer(TokenDatabase::Create<kBasicData>());
+  EXPECT_EQ(copy.Detokenize("\0\0\0\0\x01"sv).BestString(), "One arg -1");
+  EXPECT_EQ(copy.Detokenize("\xBB\xBB\xBB\xBB\x00"sv).BestString(),
+            "Two ints 0 %d");
+
+  original = copy;
+  EXPECT_EQ(original.Detokenize("\xAA\xAA\xAA\xAA"sv).BestString(),
+            "This one is present");
+}
+
+TEST(DetokenizeInPlace, EmptyDatabase) {
+  const Detokenizer detok = Detokenizer::InPlace(TokenDatabase());
+
+  EXPECT_TRUE(detok.Detokenize("\0\0\0\0"sv).matches().empty());
+  EXPECT_EQ(detok.Detokenize("\1\2\3\4"sv).BestStringWithErrors(),
+            ERR("unknown token 04030201"));
+}
+
 }  // namespace
 }  // namespace pw::tokenizer
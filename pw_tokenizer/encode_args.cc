@@ -32,6 +32,10 @@ enum class ArgType : uint8_t {
   kString = PW_TOKENIZER_ARG_TYPE_STRING,
 };
 
+}  // namespace
+
+namespace internal {
+
 size_t EncodeInt(int value, const span<std::byte>& output) {
   return varint::Encode(value, as_writable_bytes(output));
 }
@@ -82,7 +86,7 @@ size_t EncodeString(const char* string, const span<std::byte>& output) {
   return bytes_to_copy + 1;  // include the status byte in the total
 }
 
-}  // namespace
+}  // namespace internal
 
 size_t EncodeArgs(pw_tokenizer_ArgTypes types,
                   va_list args,
@@ -97,17 +101,18 @@ size_t EncodeArgs(pw_tokenizer_ArgTypes types,
 
     switch (static_cast<ArgType>(types & 0b11u)) {
       case ArgType::kInt:
-        argument_bytes = EncodeInt(va_arg(args, int), output);
+        argument_bytes = internal::EncodeInt(va_arg(args, int), output);
         break;
       case ArgType::kInt64:
-        argument_bytes = EncodeInt64(va_arg(args, int64_t), output);
+        argument_bytes = internal::EncodeInt64(va_arg(args, int64_t), output);
         break;
       case ArgType::kDouble:
-        argument_bytes =
-            EncodeFloat(static_cast<float>(va_arg(args, double)), output);
+        argument_bytes = internal::EncodeFloat(
+            static_cast<float>(va_arg(args, double)), output);
         break;
       case ArgType::kString:
-        argument_bytes = EncodeString(va_arg(args, const char*), output);
+        argument_bytes =
+            internal::EncodeString(va_arg(args, const char*), output);
         break;
     }
 
@@ -14,6 +14,11 @@
 
 #include "pw_tokenizer/encode_args.h"
 
+#include <array>
+#include <cstdarg>
+#include <cstddef>
+#include <cstring>
+
 #include "gtest/gtest.h"
 
 namespace pw {
@@ -38,5 +43,67 @@ static_assert(
     MinEncodingBufferSizeBytes<const char*, long long, int, short>() ==
     4 + 1 + 10 + 5 + 3);
 
+namespace {
+
+size_t EncodeVarargs(span<std::byte> output, pw_tokenizer_ArgTypes types, ...) {
+  va_list args;
+  va_start(args, types);
+  const size_t result = EncodeArgs(types, args, output);
+  va_end(args);
+  return result;
+}
+
+// Checks that the template and va_list versions of EncodeArgs match.
+#define EXPECT_ENCODINGS_MATCH(buffer_size, ...)                             \
+  do {                                                                       \
+    std::array<std::byte, buffer_size> from_varargs{};                       \
+    std::array<std::byte, buffer_size> from_template{};                      \
+    const size_t varargs_size =                                              \
+        EncodeVarargs(from_varargs, PW_TOKENIZER_ARG_TYPES(__VA_ARGS__),     \
+                      __VA_ARGS__);                                          \
+    const size_t template_size = EncodeArgs(from_template, __VA_ARGS__);     \
+    ASSERT_EQ(varargs_size, template_size);                                  \
+    EXPECT_EQ(std::memcmp(                                                   \
+                  from_varargs.data(), from_template.data(), varargs_size),  \
+              0);                                                            \
+  } while (0)
+
+TEST(EncodeArgs, Template_NoArgs) {
+  std::array<std::byte, 4> buffer{};
+  EXPECT_EQ(EncodeArgs(buffer), 0u);
+}
+
+TEST(EncodeArgs, Template_MatchesVarargs) {
+  const char kString[] = "hello";
+  const char* null_string = nullptr;
+  enum Color { kRed = 3 };
+  int value = 0;
+
+  EXPECT_ENCODINGS_MATCH(32, 0, -1, 123456789, INT32_MIN, INT32_MAX);
+  EXPECT_ENCODINGS_MATCH(32, 0u, UINT32_MAX, 'c', static_cast<short>(-5));
+  EXPECT_ENCODINGS_MATCH(32, true, false, kRed);
+  EXPECT_ENCODINGS_MATCH(32, INT64_MIN, INT64_MAX, UINT64_MAX, -1ll);
+  EXPECT_ENCODINGS_MATCH(32, 1.5f, -2.25, 1e30);
+  EXPECT_ENCODINGS_MATCH(32, "literal", kString, null_string);
+  EXPECT_ENCODINGS_MATCH(32, 1, "mixed", 2.0f, 3ll, kString);
+  EXPECT_ENCODINGS_MATCH(32, static_cast<void*>(&value), nullptr);
+}
+
+TEST(EncodeArgs, Template_MatchesVarargsWhenTruncated) {
+  EXPECT_ENCODINGS_MATCH(3, 1, 1000000, 2);
+  EXPECT_ENCODINGS_MATCH(4, "this string is truncated", 1);
+  EXPECT_ENCODINGS_MATCH(6, 1.0f, 2.0f);
+  EXPECT_ENCODINGS_MATCH(1, INT64_MAX);
+}
+
+TEST(EncodeArgs, Template_StopsAtFirstArgumentThatDoesNotFit) {
+  std::array<std::byte, 3> buffer{};
+  // The float does not fit, so the int after it is not encoded.
+  EXPECT_EQ(EncodeArgs(buffer, 1.0f, 1), 0u);
+  EXPECT_EQ(EncodeArgs(buffer, 1, 1.0f, 1), 1u);
+}
+
+}  // namespace
+
 }  // namespace tokenizer
 }  // namespace pw
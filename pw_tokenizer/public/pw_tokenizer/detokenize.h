@@ -22,11 +22,22 @@
 //   DetokenizedString result = detok.Detokenize(my_data);
 //   std::cout << result.BestString() << '\n';
 //
+// To avoid copying large databases, a Detokenizer can instead index a database
+// in place, for example from a memory-mapped file. The database memory must
+// outlive the Detokenizer:
+//
+//   const void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+//   Detokenizer detok = Detokenizer::InPlace(TokenDatabase::Create(
+//       span(static_cast<const char*>(data), size)));
+//
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -72,6 +83,49 @@ class DetokenizedString {
   std::vector<DecodedFormatString> matches_;
 };
 
+class Detokenizer;
+
+// Stores the results of Detokenizer::DetokenizeBatch. The detokenized strings
+// are packed into a single buffer, which keeps its capacity when the batch is
+// cleared, so a batch can be reused to avoid allocating for each message.
+//
+// A DetokenizedBatch is not thread safe. To shard detokenization across
+// threads, give each thread its own batch; a Detokenizer may be shared.
+class DetokenizedBatch {
+ public:
+  DetokenizedBatch() = default;
+
+  // The number of detokenized strings in the batch.
+  size_t size() const { return ends_.size(); }
+
+  bool empty() const { return ends_.empty(); }
+
+  // Returns a detokenized string. The view is valid until the batch is cleared
+  // or more messages are detokenized into it.
+  std::string_view operator[](size_t index) const {
+    const size_t begin = index == 0u ? 0u : ends_[index - 1];
+    return std::string_view(strings_).substr(begin, ends_[index] - begin);
+  }
+
+  // Removes all strings, but keeps the allocated memory.
+  void clear() {
+    strings_.clear();
+    ends_.clear();
+  }
+
+  // Reserves space for the given number of strings and bytes of string data.
+  void reserve(size_t strings, size_t string_bytes) {
+    ends_.reserve(strings);
+    strings_.reserve(string_bytes);
+  }
+
+ private:
+  friend class Detokenizer;
+
+  std::string strings_;
+  std::vector<size_t> ends_;
+};
+
 // Decodes and detokenizes strings from a TokenDatabase. This class builds a
 // hash table from the TokenDatabase to give O(1) token lookups.
 class Detokenizer {
@@ -80,6 +134,25 @@ class Detokenizer {
   // referenced by the Detokenizer after construction; its memory can be freed.
   Detokenizer(const TokenDatabase& database);
 
+  // Constructs a detokenizer that references the TokenDatabase's strings in
+  // place rather than copying them. The database's memory must outlive the
+  // Detokenizer.
+  //
+  // Instead of a hash table with an allocation per entry, this builds a flat,
+  // open-addressed index with a fixed number of allocations, so construction
+  // time and memory are proportional to the number of entries but not to the
+  // size of the strings. The format strings for a token are parsed the first
+  // time the token is detokenized and reused after that.
+  static Detokenizer InPlace(const TokenDatabase& database);
+
+  // Copies of an in-place detokenizer reference the same TokenDatabase, but
+  // parse their format strings again on first use.
+  Detokenizer(const Detokenizer& other);
+  Detokenizer& operator=(const Detokenizer& other);
+
+  Detokenizer(Detokenizer&&) = default;
+  Detokenizer& operator=(Detokenizer&&) = default;
+
   // Decodes and detokenizes the encoded message. Returns a DetokenizedString
   // that stores all possible detokenized string results.
   DetokenizedString Detokenize(const span<const uint8_t>& encoded) const;
@@ -92,8 +165,46 @@ class Detokenizer {
     return Detokenize(span(static_cast<const uint8_t*>(encoded), size_bytes));
   }
 
+  // Detokenizes a series of encoded messages and appends the best string for
+  // each, including any error messages, to the batch. This produces the same
+  // strings as DetokenizedString::BestStringWithErrors, but stores them in the
+  // batch's string buffer instead of allocating a DetokenizedString for each.
+  //
+  // This function may be called from multiple threads at once, as long as each
+  // uses a different batch.
+  void DetokenizeBatch(span<const span<const uint8_t>> messages,
+                       DetokenizedBatch& batch) const;
+
  private:
+  Detokenizer() = default;
+
+  // Returns the index of the first entry with this token in entries_, or
+  // entries_.size() if the token is not present.
+  size_t FindInPlace(uint32_t token) const;
+
+  // Returns the parsed entries for a token.
+  span<const TokenizedStringEntry> Find(uint32_t token) const;
+
+  // The parsed entries for a token in an in-place detokenizer. Entries are
+  // parsed on first use; concurrent lookups may both parse a token, but only
+  // one result is kept.
+  struct LazyEntries {
+    ~LazyEntries() { delete parsed.load(std::memory_order_relaxed); }
+
+    std::atomic<const std::vector<TokenizedStringEntry>*> parsed{nullptr};
+  };
+
   std::unordered_map<uint32_t, std::vector<TokenizedStringEntry>> database_;
+
+  // For in-place detokenizers, the database entries sorted by token and an
+  // open-addressed hash table that maps each token to its first entry.
+  // kEmptySlot marks unused slots in the table. The parsed entries for each
+  // token are stored in parsed_ at the index of the token's first entry.
+  static constexpr uint32_t kEmptySlot = UINT32_MAX;
+  bool in_place_ = false;
+  std::vector<TokenDatabase::Entry> entries_;
+  std::vector<uint32_t> index_;
+  std::unique_ptr<LazyEntries[]> parsed_;
 };
 
 }  // namespace pw::tokenizer
@@ -24,6 +24,7 @@
 #if PW_CXX_STANDARD_IS_SUPPORTED(17)
 
 #include <cstring>
+#include <type_traits>
 
 #include "pw_polyfill/standard.h"
 #include "pw_span/span.h"
@@ -50,6 +51,41 @@ constexpr size_t ArgEncodedSizeBytes() {
   }
 }
 
+// Encode individual arguments. Each returns the number of bytes written, or 0
+// if the argument does not fit.
+size_t EncodeInt(int value, const span<std::byte>& output);
+size_t EncodeInt64(int64_t value, const span<std::byte>& output);
+size_t EncodeFloat(float value, const span<std::byte>& output);
+size_t EncodeString(const char* string, const span<std::byte>& output);
+
+// Converts an argument to the integer type it is encoded as. Pointers are
+// encoded as their address, as they are when passed through varargs.
+template <typename Integer, typename T>
+constexpr Integer ArgAsInteger(const T& value) {
+  if constexpr (std::is_null_pointer_v<T>) {
+    return 0;
+  } else if constexpr (std::is_pointer_v<T>) {
+    return static_cast<Integer>(reinterpret_cast<uintptr_t>(value));
+  } else {
+    return static_cast<Integer>(value);
+  }
+}
+
+// Encodes one argument, selecting its encoding at compile time.
+template <typename T>
+size_t EncodeArg(const T& value, const span<std::byte>& output) {
+  constexpr pw_tokenizer_ArgTypes kType = VarargsType<T>();
+  if constexpr (kType == PW_TOKENIZER_ARG_TYPE_DOUBLE) {
+    return EncodeFloat(static_cast<float>(value), output);
+  } else if constexpr (kType == PW_TOKENIZER_ARG_TYPE_STRING) {
+    return EncodeString(value, output);
+  } else if constexpr (kType == PW_TOKENIZER_ARG_TYPE_INT64) {
+    return EncodeInt64(ArgAsInteger<int64_t>(value), output);
+  } else {
+    return EncodeInt(ArgAsInteger<int>(value), output);
+  }
+}
+
 }  // namespace internal
 
 /// Calculates the minimum buffer size to allocate that is guaranteed to support
@@ -82,6 +118,53 @@ size_t EncodeArgs(pw_tokenizer_ArgTypes types,
                   va_list args,
                   span<std::byte> output);
 
+/// Encodes a tokenized string's arguments to a buffer, selecting each
+/// argument's encoding at compile time from its type. This produces the same
+/// output as the `va_list` version of `EncodeArgs`, but avoids varargs and
+/// decoding the @cpp_type{pw_tokenizer_ArgTypes} at runtime. Use it in C++ code
+/// that encodes tokenized messages directly.
+///
+/// `MinEncodingBufferSizeBytes` gives the buffer size needed for the arguments,
+/// excluding string contents, so the buffer can be sized at compile time:
+///
+/// @code{.cpp}
+///   template <typename... Args>
+///   void LogValues(pw_tokenizer_Token token, const Args&... args) {
+///     std::array<std::byte, MinEncodingBufferSizeBytes<Args...>()> buffer;
+///     std::memcpy(buffer.data(), &token, sizeof(token));
+///     const size_t size = sizeof(token) + EncodeArgs(
+///         span(buffer).subspan(sizeof(token)), args...);
+///     SendLogMessage(span(buffer).first(size));
+///   }
+/// @endcode
+template <typename... Args>
+size_t EncodeArgs(span<std::byte> output, const Args&... args) {
+  static_assert(sizeof...(Args) <= PW_TOKENIZER_MAX_SUPPORTED_ARGS,
+                "Too many arguments for a tokenized string");
+  if constexpr (sizeof...(Args) == 0u) {
+    static_cast<void>(output);
+    return 0;
+  } else {
+    size_t encoded_bytes = 0;
+    bool full = false;
+
+    // Encode each argument in order. Stop once an argument does not fit.
+    (
+        [&] {
+          if (full) {
+            return;
+          }
+          const size_t argument_bytes =
+              internal::EncodeArg(args, output.subspan(encoded_bytes));
+          full = argument_bytes == 0u;
+          encoded_bytes += argument_bytes;
+        }(),
+        ...);
+
+    return encoded_bytes;
+  }
+}
+
 /// Encodes a tokenized message to a fixed size buffer. By default, the buffer
 /// size is set by the @c_macro{PW_TOKENIZER_CFG_ENCODING_BUFFER_SIZE_BYTES}
 /// config macro. This class is used to encode tokenized messages passed in from
@@ -25,6 +25,7 @@
 
 #include <string_view>
 
+#include "pw_polyfill/language_feature_macros.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_tokenizer/config.h"
 
@@ -79,6 +80,19 @@ constexpr uint32_t Hash(const char (&string)[kSize]) {
   return Hash(std::string_view(string, kSize - 1));
 }
 
+namespace internal {
+
+// Calculates tokens for the tokenization macros. When consteval is supported
+// (C++20), the hash is always calculated by the compiler, even if the token is
+// not used in a constant expression (e.g. as a function argument). Otherwise,
+// this is the same as Hash.
+template <typename T>
+PW_CONSTEVAL uint32_t TokenHash(const T& string) {
+  return Hash(string);
+}
+
+}  // namespace internal
+
 // This hash function is equivalent to the C hashing macros. It hashses a string
 // up to a maximum length.
 constexpr uint32_t PwTokenizer65599FixedLengthHash(
@@ -16,7 +16,8 @@
 // depends on the language (C or C++) and value of
 // PW_TOKENIZER_CFG_C_HASH_LENGTH. The options are:
 //
-//   - C++ hash constexpr function, which works for any hash length
+//   - C++ hash constexpr function, which works for any hash length; in C++20
+//     it is consteval, so tokens are always calculated at compile time
 //   - C 80-character hash macro
 //   - C 96-character hash macro
 //   - C 128-character hash macro
@@ -106,13 +107,15 @@ constexpr Entry<kDomainSize, kStringSize> MakeEntry(
 
 #endif  // __cplusplus
 
-// In C++17, use a constexpr function to calculate the hash.
+// In C++17, use a constexpr function to calculate the hash. In C++20, the
+// function is consteval.
 #if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L && \
     defined(__cpp_inline_variables)
 
 #include "pw_tokenizer/hash.h"
 
-#define PW_TOKENIZER_STRING_TOKEN(format) ::pw::tokenizer::Hash(format)
+#define PW_TOKENIZER_STRING_TOKEN(format) \
+  ::pw::tokenizer::internal::TokenHash(format)
 
 #else  // In C or older C++ code, use the hashing macro.
 
@@ -34,7 +34,7 @@ namespace pw::tokenizer {
 //   Offset  Size  Field
 //   -----------------------------------
 //        0     6  Magic number (TOKENS)
-//        6     2  Version (00 00)
+//        6     2  Version (00 00 or 01 00)
 //        8     4  Entry count
 //       12     4  Reserved
 //
@@ -48,9 +48,16 @@ namespace pw::tokenizer {
 // Entries are sorted by token. A string table with a null-terminated string for
 // each entry in order follows the entries.
 //
-// Entries are accessed by iterating over the database. A O(n) Find function is
-// also provided. In typical use, a TokenDatabase is preprocessed by a
-// Detokenizer into a std::unordered_map.
+// Version 1 databases add a string offset table between the entries and the
+// string table. It has a 4-byte offset for each entry, which locates the
+// entry's string relative to the start of the string table. Version 1 entries
+// must be sorted by token, which IsValid() checks.
+//
+// Entries are accessed by iterating over the database. A Find function is also
+// provided. Find is O(log n) for version 1 databases and O(n) for version 0
+// databases. In typical use, a version 0 TokenDatabase is preprocessed by a
+// Detokenizer into a std::unordered_map; a version 1 database can be searched
+// in place instead.
 class TokenDatabase {
  public:
   // Internal struct that describes how the underlying binary token database
@@ -84,22 +91,34 @@ class TokenDatabase {
   class Iterator {
    public:
     constexpr Iterator(const RawEntry* raw_entry, const char* string)
-        : raw_(raw_entry), string_(string) {}
+        : Iterator(raw_entry, string, nullptr) {}
+
+    // Constructs an iterator for a database with a string offset table.
+    // strings points to the string table and string_offset to the string
+    // offset for raw_entry.
+    constexpr Iterator(const RawEntry* raw_entry,
+                       const char* strings,
+                       const char* string_offset)
+        : raw_(raw_entry), string_(strings), string_offset_(string_offset) {}
 
     // Constructs a TokenDatabase::Entry for the entry this iterator refers to.
     constexpr Entry entry() const {
-      return {raw_->token, raw_->date_removed, string_};
+      return {raw_->token, raw_->date_removed, string()};
     }
 
     constexpr Iterator& operator++() {
       raw_ += 1;
+      if (string_offset_ != nullptr) {
+        string_offset_ += sizeof(uint32_t);
+        return *this;
+      }
       // Move string_ to the character beyond the next null terminator.
       while (*string_++ != '\0') {
       }
       return *this;
     }
     constexpr Iterator operator++(int) {
-      Iterator previous(raw_, string_);
+      Iterator previous = *this;
       operator++();
       return previous;
     }
@@ -122,8 +141,33 @@ class TokenDatabase {
     }
 
    private:
+    friend class TokenDatabase;
+
+    constexpr const char* string() const {
+      return string_offset_ == nullptr
+                 ? string_
+                 : string_ + ReadUint32(string_offset_);
+    }
+
+    // Advances the iterator by count entries. This is O(1) if the database has
+    // a string offset table and O(count) otherwise.
+    constexpr Iterator& Advance(size_t count) {
+      if (string_offset_ == nullptr) {
+        for (size_t i = 0; i < count; ++i) {
+          operator++();
+        }
+      } else {
+        raw_ += count;
+        string_offset_ += count * sizeof(uint32_t);
+      }
+      return *this;
+    }
+
     const RawEntry* raw_;
+    // The entry's string, or the string table if string offsets are used.
     const char* string_;
+    // The entry's string offset, or nullptr if there is no offset table.
+    const char* string_offset_;
   };
 
   // A list of token entries returned from a Find operation. This object can be
@@ -141,7 +185,8 @@ class TokenDatabase {
 
     // Accesses the specified entry in this set. Returns an Entry object, which
     // is constructed from the underlying raw entry. The index must be less than
-    // size(). This operation is O(n) in size().
+    // size(). This operation is O(1) for databases with a string offset table
+    // and O(n) in size() otherwise.
     Entry operator[](size_t index) const;
 
     constexpr const Iterator& begin() const { return begin_; }
@@ -153,12 +198,14 @@ class TokenDatabase {
   };
 
   // Returns true if the provided data is a valid token database. This checks
-  // the magic number ("TOKENS"), version (which must be 0), and that there is
-  // is one string for each entry in the database. A database with extra strings
-  // or other trailing data is considered valid.
+  // the magic number ("TOKENS"), version (which must be 0 or 1), and that there
+  // is one string for each entry in the database. Version 1 databases must also
+  // be sorted by token. A database with extra strings or other trailing data is
+  // considered valid.
   template <typename ByteArray>
   static constexpr bool IsValid(const ByteArray& bytes) {
-    return HasValidHeader(bytes) && EachEntryHasAString(bytes);
+    return HasValidHeader(bytes) && EachEntryHasAString(bytes) &&
+           EntriesAreSorted(bytes);
   }
 
   // Creates a TokenDatabase and checks if the provided data is valid at compile
@@ -177,6 +224,9 @@ class TokenDatabase {
     static_assert(EachEntryHasAString<decltype(kDatabaseBytes)>(kDatabaseBytes),
                   "The database must have at least one string for each entry.");
 
+    static_assert(EntriesAreSorted<decltype(kDatabaseBytes)>(kDatabaseBytes),
+                  "Databases with string offsets must be sorted by token.");
+
     return TokenDatabase(std::data(kDatabaseBytes));
   }
 
@@ -194,9 +244,13 @@ class TokenDatabase {
                : TokenDatabase();  // Invalid database.
   }
   // Creates a database with no data. ok() returns false.
-  constexpr TokenDatabase() : begin_{.data = nullptr}, end_{.data = nullptr} {}
+  constexpr TokenDatabase()
+      : begin_{.data = nullptr},
+        end_{.data = nullptr},
+        has_string_offsets_(false) {}
 
-  // Returns all entries associated with this token. This is a O(n) operation.
+  // Returns all entries associated with this token. This is a O(log n)
+  // operation if the database has a string offset table and O(n) otherwise.
   Entries Find(uint32_t token) const;
 
   // Returns the total number of entries (unique token-string pairs).
@@ -207,7 +261,17 @@ class TokenDatabase {
   // True if this database was constructed with valid data.
   constexpr bool ok() const { return begin_.data != nullptr; }
 
-  Iterator begin() const { return Iterator(begin_.entry, end_.data); }
+  // True if this is a version 1 database with a string offset table.
+  constexpr bool has_string_offsets() const { return has_string_offsets_; }
+
+  Iterator begin() const {
+    if (has_string_offsets_) {
+      return Iterator(begin_.entry,
+                      end_.data + size() * sizeof(uint32_t),
+                      end_.data);
+    }
+    return Iterator(begin_.entry, end_.data);
+  }
   Iterator end() const { return Iterator(end_.entry, nullptr); }
 
  private:
@@ -228,29 +292,36 @@ class TokenDatabase {
       return false;
     }
 
-    // Check the magic number and version.
-    for (size_t i = 0; i < kMagicAndVersion.size(); ++i) {
-      if (bytes[i] != kMagicAndVersion[i]) {
+    // Check the magic number.
+    for (size_t i = 0; i < kMagic.size(); ++i) {
+      if (bytes[i] != kMagic[i]) {
         return false;
       }
     }
 
-    return true;
+    const uint16_t version = ReadVersion(std::data(bytes));
+    return version == kVersion0 || version == kVersionWithStringOffsets;
   }
 
   template <typename ByteArray>
   static constexpr bool EachEntryHasAString(const ByteArray& bytes) {
     const size_t entries = ReadEntryCount(std::data(bytes));
+    const bool has_string_offsets =
+        ReadVersion(std::data(bytes)) == kVersionWithStringOffsets;
+    const size_t string_table = StringTable(entries, has_string_offsets);
 
     // Check that the data is large enough to have a string table.
-    if (std::size(bytes) < StringTable(entries)) {
+    if (std::size(bytes) < string_table) {
       return false;
     }
 
+    if (has_string_offsets) {
+      return EachStringOffsetIsValid(bytes, entries);
+    }
+
     // Count the strings in the string table.
     size_t string_count = 0;
-    for (auto i = std::begin(bytes) + StringTable(entries); i < std::end(bytes);
-         ++i) {
+    for (auto i = std::begin(bytes) + string_table; i < std::end(bytes); ++i) {
       string_count += (*i == '\0') ? 1 : 0;
     }
 
@@ -258,31 +329,96 @@ class TokenDatabase {
     return string_count >= entries;
   }
 
-  // Reads the number of entries from a database header. Cast to the bytes to
-  // uint8_t to avoid sign extension if T is signed.
+  // Checks that each string offset refers to a null-terminated string within
+  // the string table.
+  template <typename ByteArray>
+  static constexpr bool EachStringOffsetIsValid(const ByteArray& bytes,
+                                                size_t entries) {
+    const size_t string_table = StringTable(entries, true);
+    const auto* offsets = std::data(bytes) + StringTable(entries, false);
+
+    // If the string at the furthest offset has a null terminator, every string
+    // does.
+    size_t last_string = 0;
+    for (size_t i = 0; i < entries; ++i) {
+      const size_t offset = ReadUint32(offsets + i * sizeof(uint32_t));
+      last_string = offset > last_string ? offset : last_string;
+    }
+
+    if (entries == 0u) {
+      return true;
+    }
+
+    for (size_t i = string_table + last_string; i < std::size(bytes); ++i) {
+      if (bytes[i] == '\0') {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Checks that version 1 databases are sorted by token, as required by the
+  // binary search in Find(). Version 0 databases are not checked.
+  template <typename ByteArray>
+  static constexpr bool EntriesAreSorted(const ByteArray& bytes) {
+    if (ReadVersion(std::data(bytes)) != kVersionWithStringOffsets) {
+      return true;
+    }
+
+    const size_t entries = ReadEntryCount(std::data(bytes));
+    const auto* raw_entries = std::data(bytes) + sizeof(Header);
+    for (size_t i = 1; i < entries; ++i) {
+      if (ReadUint32(raw_entries + i * sizeof(RawEntry)) <
+          ReadUint32(raw_entries + (i - 1) * sizeof(RawEntry))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Reads a little-endian uint32_t. Cast to the bytes to uint8_t to avoid sign
+  // extension if T is signed.
+  template <typename T>
+  static constexpr uint32_t ReadUint32(const T* bytes) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(bytes[0])) |
+           static_cast<uint32_t>(static_cast<uint8_t>(bytes[1])) << 8 |
+           static_cast<uint32_t>(static_cast<uint8_t>(bytes[2])) << 16 |
+           static_cast<uint32_t>(static_cast<uint8_t>(bytes[3])) << 24;
+  }
+
+  // Reads the number of entries from a database header.
   template <typename T>
   static constexpr uint32_t ReadEntryCount(const T* header_bytes) {
-    const T* bytes = header_bytes + offsetof(Header, entry_count);
-    return static_cast<uint8_t>(bytes[0]) |
-           static_cast<uint8_t>(bytes[1]) << 8 |
-           static_cast<uint8_t>(bytes[2]) << 16 |
-           static_cast<uint8_t>(bytes[3]) << 24;
+    return ReadUint32(header_bytes + offsetof(Header, entry_count));
+  }
+
+  // Reads the version from a database header.
+  template <typename T>
+  static constexpr uint16_t ReadVersion(const T* header_bytes) {
+    const T* bytes = header_bytes + offsetof(Header, version);
+    return static_cast<uint16_t>(static_cast<uint8_t>(bytes[0]) |
+                                 static_cast<uint8_t>(bytes[1]) << 8);
   }
 
   // Calculates the offset of the string table.
-  static constexpr size_t StringTable(size_t entries) {
-    return sizeof(Header) + entries * sizeof(RawEntry);
+  static constexpr size_t StringTable(size_t entries,
+                                      bool has_string_offsets = false) {
+    return sizeof(Header) + entries * sizeof(RawEntry) +
+           (has_string_offsets ? entries * sizeof(uint32_t) : 0);
   }
 
   // The magic number that starts the table is "TOKENS". The version is encoded
   // next as two bytes.
-  static constexpr std::array<char, 8> kMagicAndVersion = {
-      'T', 'O', 'K', 'E', 'N', 'S', '\0', '\0'};
+  static constexpr std::array<char, 6> kMagic = {'T', 'O', 'K', 'E', 'N', 'S'};
+  static constexpr uint16_t kVersion0 = 0;
+  static constexpr uint16_t kVersionWithStringOffsets = 1;
 
   template <typename Byte>
   constexpr TokenDatabase(const Byte bytes[])
-      : TokenDatabase(bytes + sizeof(Header),
-                      bytes + StringTable(ReadEntryCount(bytes))) {
+      : TokenDatabase(
+            bytes + sizeof(Header),
+            bytes + StringTable(ReadEntryCount(bytes)),
+            ReadVersion(bytes) == kVersionWithStringOffsets) {
     static_assert(sizeof(Byte) == 1u);
   }
 
@@ -290,14 +426,31 @@ class TokenDatabase {
   // use unions. Instead of using a reinterpret_cast to change the byte pointer
   // to a RawEntry pointer, have a separate overload for each byte pointer type
   // and store them in a union.
-  constexpr TokenDatabase(const char* begin, const char* end)
-      : begin_{.data = begin}, end_{.data = end} {}
-
-  constexpr TokenDatabase(const unsigned char* begin, const unsigned char* end)
-      : begin_{.unsigned_data = begin}, end_{.unsigned_data = end} {}
-
-  constexpr TokenDatabase(const signed char* begin, const signed char* end)
-      : begin_{.signed_data = begin}, end_{.signed_data = end} {}
+  constexpr TokenDatabase(const char* begin,
+                          const char* end,
+                          bool has_string_offsets)
+      : begin_{.data = begin},
+        end_{.data = end},
+        has_string_offsets_(has_string_offsets) {}
+
+  constexpr TokenDatabase(const unsigned char* begin,
+                          const unsigned char* end,
+                          bool has_string_offsets)
+      : begin_{.unsigned_data = begin},
+        end_{.unsigned_data = end},
+        has_string_offsets_(has_string_offsets) {}
+
+  constexpr TokenDatabase(const signed char* begin,
+                          const signed char* end,
+                          bool has_string_offsets)
+      : begin_{.signed_data = begin},
+        end_{.signed_data = end},
+        has_string_offsets_(has_string_offsets) {}
+
+  // Returns an iterator for the entry at the given index.
+  Iterator IteratorAt(size_t index) const {
+    return begin().Advance(index);
+  }
 
   // Store the beginning and end pointers as a union to avoid breaking constexpr
   // rules for reinterpret_cast.
@@ -307,6 +460,8 @@ class TokenDatabase {
     const unsigned char* unsigned_data;
     const signed char* signed_data;
   } begin_, end_;
+
+  bool has_string_offsets_;
 };
 
 }  // namespace pw::tokenizer
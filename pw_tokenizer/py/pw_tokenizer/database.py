@@ -321,6 +321,8 @@ def _handle_create(
             tokens.write_csv(db, fd)
         elif output_type == 'binary':
             tokens.write_binary(db, fd)
+        elif output_type == 'binary_v1':
+            tokens.write_binary(db, fd, string_offsets=True)
         else:
             raise ValueError(f'Unknown database type "{output_type}"')
 
@@ -556,9 +558,13 @@ def _parse_args():
         '-t',
         '--type',
         dest='output_type',
-        choices=('csv', 'binary', 'directory'),
+        choices=('csv', 'binary', 'binary_v1', 'directory'),
         default='csv',
-        help='Which type of database to create. (default: csv)',
+        help=(
+            'Which type of database to create. binary_v1 is a binary database '
+            'with a string offset table, which supports O(log n) lookups on '
+            'device. (default: csv)'
+        ),
     )
     subparser.add_argument(
         '-f',
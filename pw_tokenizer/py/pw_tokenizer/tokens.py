@@ -399,8 +399,11 @@ class _BinaryFileFormat(NamedTuple):
     """Attributes of the binary token database file format."""
 
     magic: bytes = b'TOKENS\0\0'
+    # Version 1 adds a string offset table and requires sorted entries.
+    magic_with_string_offsets: bytes = b'TOKENS\1\0'
     header: struct.Struct = struct.Struct('<8sI4x')
     entry: struct.Struct = struct.Struct('<IBBH')
+    string_offset: struct.Struct = struct.Struct('<I')
 
 
 BINARY_FORMAT = _BinaryFileFormat()
@@ -416,7 +419,10 @@ def file_is_binary_database(fd: BinaryIO) -> bool:
         fd.seek(0)
         magic = fd.read(len(BINARY_FORMAT.magic))
         fd.seek(0)
-        return BINARY_FORMAT.magic == magic
+        return magic in (
+            BINARY_FORMAT.magic,
+            BINARY_FORMAT.magic_with_string_offsets,
+        )
     except IOError:
         return False
 
@@ -450,7 +456,10 @@ def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
         fd.read(BINARY_FORMAT.header.size)
     )
 
-    if magic != BINARY_FORMAT.magic:
+    if magic not in (
+        BINARY_FORMAT.magic,
+        BINARY_FORMAT.magic_with_string_offsets,
+    ):
         raise DatabaseFormatError(
             f'Binary token database magic number mismatch (found {magic!r}, '
             f'expected {BINARY_FORMAT.magic!r}) while reading from {fd}'
@@ -470,6 +479,15 @@ def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
 
         entries.append((token, date_removed))
 
+    string_offsets: Optional[List[int]] = None
+    if magic == BINARY_FORMAT.magic_with_string_offsets:
+        string_offsets = [
+            BINARY_FORMAT.string_offset.unpack(
+                fd.read(BINARY_FORMAT.string_offset.size)
+            )[0]
+            for _ in range(entry_count)
+        ]
+
     # Read the entire string table and define a function for looking up strings.
     string_table = fd.read()
 
@@ -480,19 +498,41 @@ def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
             end + 1,
         )
 
+    if string_offsets is not None:
+        for (token, removed), offset in zip(entries, string_offsets):
+            string, _ = read_string(offset)
+            yield TokenizedStringEntry(token, string, DEFAULT_DOMAIN, removed)
+        return
+
     offset = 0
     for token, removed in entries:
         string, offset = read_string(offset)
         yield TokenizedStringEntry(token, string, DEFAULT_DOMAIN, removed)
 
 
-def write_binary(database: Database, fd: BinaryIO) -> None:
-    """Writes the database as packed binary to the provided binary file."""
+def write_binary(
+    database: Database, fd: BinaryIO, string_offsets: bool = False
+) -> None:
+    """Writes the database as packed binary to the provided binary file.
+
+    If string_offsets is True, writes a version 1 database, which has a table of
+    offsets into the string table. Version 1 databases support binary search and
+    random access on device, and share storage between identical strings.
+    """
     entries = sorted(database.entries())
 
-    fd.write(BINARY_FORMAT.header.pack(BINARY_FORMAT.magic, len(entries)))
+    fd.write(
+        BINARY_FORMAT.header.pack(
+            BINARY_FORMAT.magic_with_string_offsets
+            if string_offsets
+            else BINARY_FORMAT.magic,
+            len(entries),
+        )
+    )
 
     string_table = bytearray()
+    offset_table = bytearray()
+    offsets: Dict[str, int] = {}
 
     for entry in entries:
         if entry.date_removed:
@@ -507,8 +547,18 @@ def write_binary(database: Database, fd: BinaryIO) -> None:
             removed_month = 0xFF
             removed_year = 0xFFFF
 
-        string_table += entry.string.encode()
-        string_table.append(0)
+        if not string_offsets:
+            string_table += entry.string.encode()
+            string_table.append(0)
+        else:
+            if entry.string not in offsets:
+                offsets[entry.string] = len(string_table)
+                string_table += entry.string.encode()
+                string_table.append(0)
+
+            offset_table += BINARY_FORMAT.string_offset.pack(
+                offsets[entry.string]
+            )
 
         fd.write(
             BINARY_FORMAT.entry.pack(
@@ -516,6 +566,7 @@ def write_binary(database: Database, fd: BinaryIO) -> None:
             )
         )
 
+    fd.write(offset_table)
     fd.write(string_table)
 
 
@@ -564,13 +615,20 @@ class DatabaseFile(Database):
 
 class _BinaryDatabase(DatabaseFile):
     def __init__(self, path: Path, fd: BinaryIO) -> None:
+        # Preserve the format version when the database is rewritten.
+        fd.seek(0)
+        self._string_offsets = (
+            fd.read(len(BINARY_FORMAT.magic_with_string_offsets))
+            == BINARY_FORMAT.magic_with_string_offsets
+        )
+        fd.seek(0)
         super().__init__(path, parse_binary(fd))
 
     def write_to_file(self, *, rewrite: bool = False) -> None:
         """Exports in the binary format to the original path."""
         del rewrite  # Binary databases are always rewritten
         with self.path.open('wb') as fd:
-            write_binary(self, fd)
+            write_binary(self, fd, string_offsets=self._string_offsets)
 
     def add_and_discard_temporary(
         self, entries: Iterable[TokenizedStringEntry], commit: str
@@ -556,6 +556,45 @@ class TokenDatabaseTest(unittest.TestCase):
 
         self.assertEqual(str(db), CSV_DATABASE)
 
+    def test_binary_format_with_string_offsets(self) -> None:
+        db = tokens.Database(
+            [
+                tokens.TokenizedStringEntry(2, 'two'),
+                tokens.TokenizedStringEntry(1, 'one'),
+                tokens.TokenizedStringEntry(3, 'one'),
+            ]
+        )
+
+        with io.BytesIO() as fd:
+            tokens.write_binary(db, fd, string_offsets=True)
+            binary_db = fd.getvalue()
+
+        self.assertEqual(
+            binary_db,
+            b'TOKENS\x01\x00\x03\x00\x00\x00\0\0\0\0'
+            b'\x01\x00\x00\x00\xff\xff\xff\xff'
+            b'\x02\x00\x00\x00\xff\xff\xff\xff'
+            b'\x03\x00\x00\x00\xff\xff\xff\xff'
+            b'\x00\x00\x00\x00\x04\x00\x00\x00\x00\x00\x00\x00'
+            b'one\x00two\x00',
+        )
+
+        with io.BytesIO(binary_db) as fd:
+            self.assertTrue(tokens.file_is_binary_database(fd))
+            parsed = tokens.Database(tokens.parse_binary(fd))
+
+        self.assertEqual(str(parsed), str(db))
+
+    def test_binary_format_with_string_offsets_round_trip(self) -> None:
+        db = read_db_from_csv(CSV_DATABASE)
+
+        with io.BytesIO() as fd:
+            tokens.write_binary(db, fd, string_offsets=True)
+            fd.seek(0)
+            parsed = tokens.Database(tokens.parse_binary(fd))
+
+        self.assertEqual(str(parsed), CSV_DATABASE)
+
 
 class TestDatabaseFile(unittest.TestCase):
     """Tests the DatabaseFile class."""
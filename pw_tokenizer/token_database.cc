@@ -14,17 +14,36 @@
 
 #include "pw_tokenizer/token_database.h"
 
+#include <algorithm>
+
 namespace pw::tokenizer {
 
 TokenDatabase::Entry TokenDatabase::Entries::operator[](size_t index) const {
   Iterator it = begin();
-  for (size_t i = 0; i < index; ++i) {
-    ++it;
-  }
-  return it.entry();
+  return it.Advance(index).entry();
 }
 
 TokenDatabase::Entries TokenDatabase::Find(const uint32_t token) const {
+  if (has_string_offsets_) {
+    // Version 1 databases are sorted by token, so binary search the entries.
+    const RawEntry* first_entry = std::lower_bound(
+        begin_.entry,
+        end_.entry,
+        token,
+        [](const RawEntry& entry, uint32_t value) {
+          return entry.token < value;
+        });
+    const RawEntry* last_entry = std::upper_bound(
+        first_entry,
+        end_.entry,
+        token,
+        [](uint32_t value, const RawEntry& entry) {
+          return value < entry.token;
+        });
+    return Entries(IteratorAt(first_entry - begin_.entry),
+                   IteratorAt(last_entry - begin_.entry));
+  }
+
   Iterator first = begin();
   while (first != end() && token > first->token) {
     ++first;
@@ -238,6 +238,95 @@ TEST(TokenDatabase, MultipleEntriesWithSameToken) {
   }
 }
 
+// Version 1 database with a string offset table. The strings are stored out of
+// order, and the two entries for token 2 share a string.
+alignas(TokenDatabase::RawEntry) constexpr char kStringOffsetsData[] =
+    "TOKENS\1\0\x05\0\0\0\0\0\0\0"
+    "\x01\0\0\0date"
+    "\x02\0\0\0date"
+    "\x02\0\0\0date"
+    "\x03\0\0\0date"
+    "\xFF\0\0\0date"
+    "\x0c\0\0\0"  // Offsets
+    "\x04\0\0\0"
+    "\x04\0\0\0"
+    "\x00\0\0\0"
+    "\x0f\0\0\0"
+    ":)!\0goodbye\0hi!\0";  // String table
+
+constexpr TokenDatabase kStringOffsets =
+    TokenDatabase::Create<kStringOffsetsData>();
+static_assert(kStringOffsets.size() == 5u);
+static_assert(kStringOffsets.has_string_offsets());
+static_assert(!kBasicDatabase.has_string_offsets());
+
+alignas(TokenDatabase::RawEntry) constexpr char kStringOffsetsUnsorted[] =
+    "TOKENS\1\0\x02\0\0\0\0\0\0\0"
+    "\x02\0\0\0date"
+    "\x01\0\0\0date"
+    "\0\0\0\0\0\0\0\0"
+    "\0";
+
+alignas(TokenDatabase::RawEntry) constexpr char kStringOffsetsOutOfRange[] =
+    "TOKENS\1\0\x02\0\0\0\0\0\0\0"
+    "\x01\0\0\0date"
+    "\x02\0\0\0date"
+    "\0\0\0\0\x04\0\0\0"
+    "hi!";  // The literal's null terminator is at offset 3.
+
+TEST(TokenDatabase, StringOffsets_ValidCheck) {
+  static_assert(TokenDatabase::IsValid(kStringOffsetsData));
+  static_assert(!TokenDatabase::IsValid(kStringOffsetsUnsorted));
+  static_assert(!TokenDatabase::IsValid(kStringOffsetsOutOfRange));
+
+  EXPECT_FALSE(TokenDatabase::Create(kStringOffsetsUnsorted).ok());
+  EXPECT_FALSE(TokenDatabase::Create(kStringOffsetsOutOfRange).ok());
+}
+
+TEST(TokenDatabase, StringOffsets_Iterator) {
+  auto it = kStringOffsets.begin();
+  EXPECT_EQ(it->token, 1u);
+  EXPECT_STREQ(it.entry().string, "hi!");
+
+  ++it;
+  EXPECT_EQ(it->token, 2u);
+  EXPECT_STREQ(it.entry().string, "goodbye");
+
+  auto previous = it++;
+  EXPECT_STREQ(previous.entry().string, "goodbye");
+  EXPECT_STREQ(it.entry().string, "goodbye");
+
+  EXPECT_STREQ((++it).entry().string, ":)!");
+  EXPECT_STREQ((++it).entry().string, "");
+  EXPECT_EQ(++it, kStringOffsets.end());
+}
+
+TEST(TokenDatabase, StringOffsets_Find) {
+  EXPECT_STREQ(kStringOffsets.Find(1)[0].string, "hi!");
+  EXPECT_STREQ(kStringOffsets.Find(3)[0].string, ":)!");
+  EXPECT_STREQ(kStringOffsets.Find(0xFF)[0].string, "");
+
+  EXPECT_TRUE(kStringOffsets.Find(0).empty());
+  EXPECT_TRUE(kStringOffsets.Find(4).empty());
+  EXPECT_TRUE(kStringOffsets.Find(0x100).empty());
+
+  TokenDatabase::Entries match = kStringOffsets.Find(2);
+  ASSERT_EQ(match.size(), 2u);
+  EXPECT_EQ(match.end()->token, 3u);
+  for (const auto& entry : match) {
+    EXPECT_EQ(entry.token, 2u);
+    EXPECT_STREQ(entry.string, "goodbye");
+  }
+}
+
+TEST(TokenDatabase, StringOffsets_EntriesIndex) {
+  TokenDatabase::Entries all(kStringOffsets.begin(), kStringOffsets.end());
+  ASSERT_EQ(all.size(), 5u);
+  EXPECT_STREQ(all[0].string, "hi!");
+  EXPECT_STREQ(all[3].string, ":)!");
+  EXPECT_EQ(all[4].token, 0xFFu);
+}
+
 TEST(TokenDatabase, Empty) {
   constexpr TokenDatabase empty_db = TokenDatabase::Create<kEmptyData>();
   static_assert(empty_db.size() == 0u);
@@ -0,0 +1,77 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::tokenizer {
+namespace {
+
+// Tokenizes messages with arguments like those of typical log statements.
+
+std::array<std::byte, 64> buffer;
+
+void NoArgumentsTest(perf_test::State& state) {
+  while (state.KeepRunning()) {
+    size_t size = buffer.size();
+    PW_TOKENIZE_TO_BUFFER(buffer.data(), &size, "Sensor initialized");
+  }
+}
+
+void IntegerArgumentsTest(perf_test::State& state) {
+  volatile int queue = 3;
+  while (state.KeepRunning()) {
+    size_t size = buffer.size();
+    PW_TOKENIZE_TO_BUFFER(buffer.data(),
+                          &size,
+                          "Queue %d: %u of %u entries used, %d dropped",
+                          queue,
+                          1000u,
+                          4096u,
+                          -12);
+  }
+}
+
+void StringArgumentTest(perf_test::State& state) {
+  volatile const char* name = "pressure_sensor";
+  while (state.KeepRunning()) {
+    size_t size = buffer.size();
+    PW_TOKENIZE_TO_BUFFER(buffer.data(),
+                          &size,
+                          "Device %s failed with status %d",
+                          const_cast<const char*>(name),
+                          5);
+  }
+}
+
+void FloatArgumentTest(perf_test::State& state) {
+  volatile float temperature = 21.5f;
+  while (state.KeepRunning()) {
+    size_t size = buffer.size();
+    PW_TOKENIZE_TO_BUFFER(
+        buffer.data(), &size, "Temperature (C): %0.2f", temperature);
+  }
+}
+
+PW_PERF_TEST(NoArguments, NoArgumentsTest);
+PW_PERF_TEST(IntegerArguments, IntegerArgumentsTest);
+PW_PERF_TEST(StringArgument, StringArgumentTest);
+PW_PERF_TEST(FloatArgument, FloatArgumentTest);
+
+}  // namespace
+}  // namespace pw::tokenizer
@@ -179,6 +179,27 @@ TEST(TokenizeString, NullInString) {
   static_assert(Hash("abc\0def") != Hash("abc\0def\0"));
 }
 
+constexpr uint32_t PassToken(uint32_t token) { return token; }
+
+TEST(TokenizeString, TokenAsFunctionArgument) {
+  // In C++20, the token is calculated at compile time even when it is passed
+  // as a function argument rather than used in a constant expression.
+  EXPECT_EQ(PassToken(PW_TOKENIZER_STRING_TOKEN("argument")), Hash("argument"));
+}
+
+TEST(TokenizeString, LongerThanLongestHashMacro) {
+  constexpr char kLong[] =
+      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+      "The C hash macros stop hashing before this point";
+
+  static_assert(PW_TOKENIZER_STRING_TOKEN(kLong) == Hash(kLong));
+  static_assert(PW_TOKENIZER_STRING_TOKEN(kLong) !=
+                PwTokenizer65599FixedLengthHash(kLong, 256));
+}
+
 // Verify that we can tokenize multiple strings from one source line.
 #define THREE_FOR_ONE(first, second, third)             \
   [[maybe_unused]] constexpr uint32_t token_1 =         \
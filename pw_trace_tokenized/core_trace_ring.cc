@@ -0,0 +1,257 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+#include "pw_trace_tokenized/internal/core_trace_ring.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace trace {
+namespace internal {
+namespace {
+
+// Each record is its size, whether it has a trace ID, the time, the token, the
+// optional trace ID and the data.
+constexpr size_t kRecordHeaderSize = 2;
+constexpr size_t kMaxRecordSize =
+    kRecordHeaderSize + sizeof(PW_TRACE_TIME_TYPE) + sizeof(uint32_t) +
+    sizeof(uint32_t) + PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES;
+static_assert(kMaxRecordSize <= UINT8_MAX,
+              "PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES is too large for the "
+              "per-core trace rings");
+
+// Returns whether time a is before time b, allowing for wrapping.
+bool IsBefore(PW_TRACE_TIME_TYPE a, PW_TRACE_TIME_TYPE b) {
+  using SignedTime = std::make_signed_t<PW_TRACE_TIME_TYPE>;
+  return static_cast<SignedTime>(PW_TRACE_GET_TIME_DELTA(b, a)) < 0;
+}
+
+}  // namespace
+
+void CoreTraceRing::SetBuffer(span<std::byte> buffer) {
+  // Positions wrap at 2^32, so only a power of two number of bytes can be
+  // indexed by them.
+  size_t size = buffer.empty() ? 0 : 1;
+  while (size * 2 <= buffer.size() && size * 2 <= (size_t{1} << 31)) {
+    size *= 2;
+  }
+  buffer_ = buffer.first(size);
+  Clear();
+}
+
+bool CoreTraceRing::TryPush(const CoreTraceEvent& event) {
+  if (event.data_size > sizeof(event.data)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  std::byte record[kMaxRecordSize];
+  size_t size = kRecordHeaderSize;
+  std::memcpy(&record[size], &event.time, sizeof(event.time));
+  size += sizeof(event.time);
+  std::memcpy(&record[size], &event.trace_token, sizeof(event.trace_token));
+  size += sizeof(event.trace_token);
+  if (event.has_trace_id) {
+    std::memcpy(&record[size], &event.trace_id, sizeof(event.trace_id));
+    size += sizeof(event.trace_id);
+  }
+  std::memcpy(&record[size], event.data, event.data_size);
+  size += event.data_size;
+  record[0] = static_cast<std::byte>(size);
+  record[1] = static_cast<std::byte>(event.has_trace_id);
+
+  writers_.fetch_add(1);
+  uint32_t start = reserved_.load();
+  bool reserved = false;
+  while (buffer_.size() - (start - read_.load(std::memory_order_acquire)) >=
+         size) {
+    if (reserved_.compare_exchange_weak(start, start + size)) {
+      reserved = true;
+      break;
+    }
+  }
+  if (reserved) {
+    CopyIn(start, span<const std::byte>(record, size));
+  } else {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Everything reserved before the last writer finishes has been written, so
+  // the last writer publishes it. Reservations made after the load belong to
+  // writers which will publish them themselves.
+  const uint32_t end = reserved_.load();
+  if (writers_.fetch_sub(1) == 1) {
+    Publish(end);
+  }
+  return reserved;
+}
+
+bool CoreTraceRing::Peek(CoreTraceEvent& event) const {
+  const uint32_t read = read_.load(std::memory_order_relaxed);
+  if (published_.load(std::memory_order_acquire) == read) {
+    return false;
+  }
+
+  std::byte record[kMaxRecordSize];
+  CopyOut(read, span(record, kRecordHeaderSize));
+  const size_t size = static_cast<size_t>(record[0]);
+  CopyOut(read, span(record, size));
+
+  event.has_trace_id = record[1] != std::byte{0};
+  size_t offset = kRecordHeaderSize;
+  std::memcpy(&event.time, &record[offset], sizeof(event.time));
+  offset += sizeof(event.time);
+  std::memcpy(&event.trace_token, &record[offset], sizeof(event.trace_token));
+  offset += sizeof(event.trace_token);
+  event.trace_id = 0;
+  if (event.has_trace_id) {
+    std::memcpy(&event.trace_id, &record[offset], sizeof(event.trace_id));
+    offset += sizeof(event.trace_id);
+  }
+  event.data_size = static_cast<uint8_t>(size - offset);
+  std::memcpy(event.data, &record[offset], event.data_size);
+  return true;
+}
+
+void CoreTraceRing::Pop() {
+  const uint32_t read = read_.load(std::memory_order_relaxed);
+  if (published_.load(std::memory_order_acquire) == read) {
+    return;
+  }
+  std::byte size;
+  CopyOut(read, span(&size, 1));
+  read_.store(read + static_cast<uint32_t>(size), std::memory_order_release);
+}
+
+void CoreTraceRing::Clear() {
+  reserved_.store(0);
+  published_.store(0);
+  read_.store(0);
+  dropped_.store(0);
+}
+
+void CoreTraceRing::CopyIn(uint32_t position, span<const std::byte> bytes) {
+  const size_t offset = position & (buffer_.size() - 1);
+  const size_t first = std::min(bytes.size(), buffer_.size() - offset);
+  std::memcpy(&buffer_[offset], bytes.data(), first);
+  std::memcpy(buffer_.data(), bytes.data() + first, bytes.size() - first);
+}
+
+void CoreTraceRing::CopyOut(uint32_t position, span<std::byte> bytes) const {
+  const size_t offset = position & (buffer_.size() - 1);
+  const size_t first = std::min(bytes.size(), buffer_.size() - offset);
+  std::memcpy(bytes.data(), &buffer_[offset], first);
+  std::memcpy(bytes.data() + first, buffer_.data(), bytes.size() - first);
+}
+
+void CoreTraceRing::Publish(uint32_t end) {
+  // A writer interrupted before publishing may publish an older end after a
+  // nested writer published a newer one, so never move backwards.
+  uint32_t published = published_.load(std::memory_order_relaxed);
+  while (static_cast<int32_t>(end - published) > 0 &&
+         !published_.compare_exchange_weak(
+             published, end, std::memory_order_release)) {
+  }
+}
+
+namespace {
+
+// Pops the visible events of all rings in timestamp order, passing each to
+// emit with its time delta from the previous event.
+template <typename Emit>
+void MergeInTimeOrder(span<CoreTraceRing> rings,
+                      PW_TRACE_TIME_TYPE& last_time,
+                      Emit&& emit) {
+  CoreTraceEvent head;
+  CoreTraceEvent earliest;
+
+  while (true) {
+    CoreTraceRing* earliest_ring = nullptr;
+    for (CoreTraceRing& ring : rings) {
+      if (ring.Peek(head) &&
+          (earliest_ring == nullptr || IsBefore(head.time, earliest.time))) {
+        earliest = head;
+        earliest_ring = &ring;
+      }
+    }
+    if (earliest_ring == nullptr) {
+      return;
+    }
+    earliest_ring->Pop();
+
+    // An event captured by an interrupt nested in another capture on the same
+    // core may be slightly out of order; give it the previous event's time.
+    PW_TRACE_TIME_TYPE delta = 0;
+    if (last_time == 0) {
+      last_time = earliest.time;
+    } else if (!IsBefore(earliest.time, last_time)) {
+      delta = PW_TRACE_GET_TIME_DELTA(last_time, earliest.time);
+      last_time = earliest.time;
+    }
+    emit(delta, earliest);
+  }
+}
+
+}  // namespace
+
+void MergeCoreTraceRings(span<CoreTraceRing> rings,
+                         PW_TRACE_TIME_TYPE& last_time,
+                         TraceEntryWriter& output) {
+  static constexpr size_t kMaxHeaderSize =
+      sizeof(uint32_t) + pw::varint::kMaxVarint64SizeBytes +  // time
+      pw::varint::kMaxVarint64SizeBytes;                      // trace_id
+  std::byte entry[kMaxHeaderSize + PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES];
+
+  MergeInTimeOrder(
+      rings,
+      last_time,
+      [&](PW_TRACE_TIME_TYPE delta, const CoreTraceEvent& event) {
+        std::memcpy(entry, &event.trace_token, sizeof(event.trace_token));
+        size_t size = sizeof(event.trace_token);
+        size += pw::varint::Encode(delta, span(entry).subspan(size));
+        if (event.has_trace_id) {
+          size += pw::varint::Encode(event.trace_id, span(entry).subspan(size));
+        }
+        std::memcpy(&entry[size], event.data, event.data_size);
+        size += event.data_size;
+
+        output.Push(span<const std::byte>(entry, size));
+      });
+}
+
+void MergeCoreTraceRings(span<CoreTraceRing> rings,
+                         PW_TRACE_TIME_TYPE& last_time,
+                         TraceBlockEncoder& encoder,
+                         TraceEntryWriter& output) {
+  MergeInTimeOrder(
+      rings,
+      last_time,
+      [&](PW_TRACE_TIME_TYPE delta, const CoreTraceEvent& event) {
+        encoder.Add(delta,
+                    event.trace_token,
+                    event.has_trace_id,
+                    event.trace_id,
+                    span(event.data, event.data_size),
+                    output);
+      });
+}
+
+}  // namespace internal
+}  // namespace trace
+}  // namespace pw
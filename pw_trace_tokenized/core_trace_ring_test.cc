@@ -0,0 +1,240 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/internal/core_trace_ring.h"
+
+#include <cstring>
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "pw_varint/varint.h"
+
+namespace pw::trace::internal {
+namespace {
+
+CoreTraceEvent MakeEvent(PW_TRACE_TIME_TYPE time,
+                         uint32_t token,
+                         bool has_trace_id = false,
+                         uint32_t trace_id = 0) {
+  CoreTraceEvent event{};
+  event.time = time;
+  event.trace_token = token;
+  event.has_trace_id = has_trace_id;
+  event.trace_id = trace_id;
+  return event;
+}
+
+// Decoded form of an entry written by MergeCoreTraceRings().
+struct Entry {
+  uint32_t token;
+  uint64_t delta;
+};
+
+Entry PopEntry(ring_buffer::PrefixedEntryRingBuffer& buffer) {
+  std::byte bytes[64];
+  size_t size = 0;
+  EXPECT_EQ(OkStatus(), buffer.PeekFront(bytes, &size));
+  EXPECT_EQ(OkStatus(), buffer.PopFront());
+  Entry entry{};
+  std::memcpy(&entry.token, bytes, sizeof(entry.token));
+  varint::Decode(span(bytes, size).subspan(sizeof(entry.token)),
+                 &entry.delta);
+  return entry;
+}
+
+TEST(CoreTraceRing, PushPeekPop_RoundTrips) {
+  std::byte storage[128];
+  CoreTraceRing ring;
+  ring.SetBuffer(storage);
+
+  CoreTraceEvent event = MakeEvent(10, 0x1234, true, 77);
+  event.data_size = 3;
+  event.data[0] = std::byte{1};
+  event.data[1] = std::byte{2};
+  event.data[2] = std::byte{3};
+  ASSERT_TRUE(ring.TryPush(event));
+
+  CoreTraceEvent out;
+  ASSERT_TRUE(ring.Peek(out));
+  EXPECT_EQ(out.time, 10u);
+  EXPECT_EQ(out.trace_token, 0x1234u);
+  EXPECT_TRUE(out.has_trace_id);
+  EXPECT_EQ(out.trace_id, 77u);
+  ASSERT_EQ(out.data_size, 3u);
+  EXPECT_EQ(out.data[2], std::byte{3});
+
+  ring.Pop();
+  EXPECT_FALSE(ring.Peek(out));
+}
+
+TEST(CoreTraceRing, Full_DropsNewEvents) {
+  std::byte storage[32];
+  CoreTraceRing ring;
+  ring.SetBuffer(storage);
+
+  // Each record without data is 2 + 4 + 4 = 10 bytes.
+  EXPECT_TRUE(ring.TryPush(MakeEvent(1, 1)));
+  EXPECT_TRUE(ring.TryPush(MakeEvent(2, 2)));
+  EXPECT_TRUE(ring.TryPush(MakeEvent(3, 3)));
+  EXPECT_FALSE(ring.TryPush(MakeEvent(4, 4)));
+  EXPECT_EQ(ring.dropped(), 1u);
+
+  CoreTraceEvent out;
+  ASSERT_TRUE(ring.Peek(out));
+  EXPECT_EQ(out.trace_token, 1u);
+}
+
+TEST(CoreTraceRing, WrapAround_KeepsRecordsIntact) {
+  std::byte storage[32];
+  CoreTraceRing ring;
+  ring.SetBuffer(storage);
+
+  CoreTraceEvent out;
+  for (uint32_t i = 0; i < 20; ++i) {
+    ASSERT_TRUE(ring.TryPush(MakeEvent(i, i, true, i * 3)));
+    ASSERT_TRUE(ring.Peek(out));
+    EXPECT_EQ(out.trace_token, i);
+    EXPECT_EQ(out.trace_id, i * 3);
+    ring.Pop();
+  }
+  EXPECT_EQ(ring.dropped(), 0u);
+}
+
+TEST(CoreTraceRing, SetBuffer_UsesPowerOfTwoBytes) {
+  std::byte storage[40];
+  CoreTraceRing ring;
+  ring.SetBuffer(storage);
+
+  // Only 32 bytes are used, which fit three records.
+  EXPECT_TRUE(ring.TryPush(MakeEvent(1, 1)));
+  EXPECT_TRUE(ring.TryPush(MakeEvent(2, 2)));
+  EXPECT_TRUE(ring.TryPush(MakeEvent(3, 3)));
+  EXPECT_FALSE(ring.TryPush(MakeEvent(4, 4)));
+}
+
+TEST(MergeCoreTraceRings, OrdersByTimeAcrossRings) {
+  std::byte storage[2][128];
+  CoreTraceRing rings[2];
+  rings[0].SetBuffer(storage[0]);
+  rings[1].SetBuffer(storage[1]);
+  rings[0].TryPush(MakeEvent(100, 1));
+  rings[0].TryPush(MakeEvent(130, 3));
+  rings[1].TryPush(MakeEvent(110, 2));
+  rings[1].TryPush(MakeEvent(150, 4));
+
+  std::byte output_storage[256];
+  ring_buffer::PrefixedEntryRingBuffer output;
+  ASSERT_EQ(OkStatus(), output.SetBuffer(output_storage));
+  TraceEntryWriter writer(output);
+  PW_TRACE_TIME_TYPE last_time = 0;
+  MergeCoreTraceRings(rings, last_time, writer);
+
+  ASSERT_EQ(output.EntryCount(), 4u);
+  Entry entry = PopEntry(output);
+  EXPECT_EQ(entry.token, 1u);
+  EXPECT_EQ(entry.delta, 0u);
+  entry = PopEntry(output);
+  EXPECT_EQ(entry.token, 2u);
+  EXPECT_EQ(entry.delta, 10u);
+  entry = PopEntry(output);
+  EXPECT_EQ(entry.token, 3u);
+  EXPECT_EQ(entry.delta, 20u);
+  entry = PopEntry(output);
+  EXPECT_EQ(entry.token, 4u);
+  EXPECT_EQ(entry.delta, 20u);
+  EXPECT_EQ(last_time, 150u);
+
+  CoreTraceEvent out;
+  EXPECT_FALSE(rings[0].Peek(out));
+  EXPECT_FALSE(rings[1].Peek(out));
+}
+
+TEST(MergeCoreTraceRings, OutOfOrderEvent_GetsZeroDelta) {
+  std::byte storage[128];
+  CoreTraceRing rings[1];
+  rings[0].SetBuffer(storage);
+  rings[0].TryPush(MakeEvent(100, 1));
+  rings[0].TryPush(MakeEvent(90, 2));
+  rings[0].TryPush(MakeEvent(105, 3));
+
+  std::byte output_storage[256];
+  ring_buffer::PrefixedEntryRingBuffer output;
+  ASSERT_EQ(OkStatus(), output.SetBuffer(output_storage));
+  TraceEntryWriter writer(output);
+  PW_TRACE_TIME_TYPE last_time = 95;
+  MergeCoreTraceRings(rings, last_time, writer);
+
+  ASSERT_EQ(output.EntryCount(), 3u);
+  EXPECT_EQ(PopEntry(output).delta, 5u);
+  EXPECT_EQ(PopEntry(output).delta, 0u);
+  EXPECT_EQ(PopEntry(output).delta, 5u);
+}
+
+TEST(MergeCoreTraceRings, TimeWrap_OrderedCorrectly) {
+  std::byte storage[2][128];
+  CoreTraceRing rings[2];
+  rings[0].SetBuffer(storage[0]);
+  rings[1].SetBuffer(storage[1]);
+  const PW_TRACE_TIME_TYPE near_wrap =
+      std::numeric_limits<PW_TRACE_TIME_TYPE>::max() - 4;
+  rings[0].TryPush(MakeEvent(5, 2));
+  rings[1].TryPush(MakeEvent(near_wrap, 1));
+
+  std::byte output_storage[256];
+  ring_buffer::PrefixedEntryRingBuffer output;
+  ASSERT_EQ(OkStatus(), output.SetBuffer(output_storage));
+  TraceEntryWriter writer(output);
+  PW_TRACE_TIME_TYPE last_time = near_wrap - 1;
+  MergeCoreTraceRings(rings, last_time, writer);
+
+  ASSERT_EQ(output.EntryCount(), 2u);
+  EXPECT_EQ(PopEntry(output).token, 1u);
+  Entry entry = PopEntry(output);
+  EXPECT_EQ(entry.token, 2u);
+  EXPECT_EQ(entry.delta, 10u);
+}
+
+TEST(MergeCoreTraceRings, BlockFormat_PacksEventsIntoBlock) {
+  std::byte storage[2][128];
+  CoreTraceRing rings[2];
+  rings[0].SetBuffer(storage[0]);
+  rings[1].SetBuffer(storage[1]);
+  rings[0].TryPush(MakeEvent(100, 1));
+  rings[1].TryPush(MakeEvent(104, 2));
+
+  std::byte output_storage[256];
+  ring_buffer::PrefixedEntryRingBuffer output;
+  ASSERT_EQ(OkStatus(), output.SetBuffer(output_storage));
+  TraceEntryWriter writer(output);
+  TraceBlockEncoder encoder;
+  PW_TRACE_TIME_TYPE last_time = 90;
+  MergeCoreTraceRings(rings, last_time, encoder, writer);
+  EXPECT_EQ(output.EntryCount(), 0u);
+  encoder.Flush(writer);
+  ASSERT_EQ(output.EntryCount(), 1u);
+
+  std::byte block[64];
+  size_t size = 0;
+  ASSERT_EQ(OkStatus(), output.PeekFront(block, &size));
+  // Base delta, token 1 with offset 0, token 2 with offset 4 << 1.
+  ASSERT_EQ(size, 1u + 5u + 5u);
+  EXPECT_EQ(block[0], std::byte{10});
+  EXPECT_EQ(block[1], std::byte{1});
+  EXPECT_EQ(block[5], std::byte{0});
+  EXPECT_EQ(block[6], std::byte{2});
+  EXPECT_EQ(block[10], std::byte{4 << 1});
+}
+
+}  // namespace
+}  // namespace pw::trace::internal
@@ -147,3 +147,46 @@ static_assert(
 #define PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES \
   PW_TRACE_BUFFER_MAX_HEADER_SIZE_BYTES + PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES
 #endif  // PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES
+
+// --- Config options for per-core trace buffers ---
+
+// PW_TRACE_BUFFER_PER_CORE_ENABLED makes the optional trace buffer capture
+// events into a lock-free ring per core instead of the shared event queue. The
+// rings are merged by timestamp into the trace buffer when it is read out.
+#ifndef PW_TRACE_BUFFER_PER_CORE_ENABLED
+#define PW_TRACE_BUFFER_PER_CORE_ENABLED 0
+#endif  // PW_TRACE_BUFFER_PER_CORE_ENABLED
+
+// PW_TRACE_BUFFER_NUM_CORES is the number of per-core rings.
+#ifndef PW_TRACE_BUFFER_NUM_CORES
+#define PW_TRACE_BUFFER_NUM_CORES 1
+#endif  // PW_TRACE_BUFFER_NUM_CORES
+
+// PW_TRACE_GET_CORE_ID returns the index, below PW_TRACE_BUFFER_NUM_CORES, of
+// the core the caller is running on. Events from other IDs are dropped.
+#ifndef PW_TRACE_GET_CORE_ID
+#define PW_TRACE_GET_CORE_ID() (0)
+#endif  // PW_TRACE_GET_CORE_ID
+
+// PW_TRACE_BUFFER_PER_CORE_SIZE_BYTES is the size in bytes of each per-core
+// ring. Events are dropped while a ring is full.
+#ifndef PW_TRACE_BUFFER_PER_CORE_SIZE_BYTES
+#define PW_TRACE_BUFFER_PER_CORE_SIZE_BYTES PW_TRACE_BUFFER_SIZE_BYTES
+#endif  // PW_TRACE_BUFFER_PER_CORE_SIZE_BYTES
+
+// --- Config options for the block trace format ---
+
+// PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED makes the optional trace buffer pack
+// many events into each entry of its ring buffer, with a shared base
+// timestamp, instead of storing one event per entry. Readers must decode the
+// entries as blocks, for example trace_tokenized.py with --block_format.
+#ifndef PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+#define PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED 0
+#endif  // PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+
+// PW_TRACE_BUFFER_BLOCK_SIZE_BYTES is the maximum size in bytes of a block.
+// Each block is sent as a single TraceDataMessage by the TraceService, so it
+// must fit in its data field.
+#ifndef PW_TRACE_BUFFER_BLOCK_SIZE_BYTES
+#define PW_TRACE_BUFFER_BLOCK_SIZE_BYTES 64
+#endif  // PW_TRACE_BUFFER_BLOCK_SIZE_BYTES
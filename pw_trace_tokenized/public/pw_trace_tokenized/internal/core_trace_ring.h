@@ -0,0 +1,116 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// The per-core rings used by the trace buffer when
+// PW_TRACE_BUFFER_PER_CORE_ENABLED is set.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+#include "pw_trace_tokenized/config.h"
+#include "pw_trace_tokenized/internal/trace_block.h"
+#include "pw_trace_tokenized/internal/trace_entry_writer.h"
+#include "pw_trace_tokenized/trace_tokenized.h"
+
+namespace pw {
+namespace trace {
+namespace internal {
+
+// A trace event as held in a CoreTraceRing, timestamped when captured.
+struct CoreTraceEvent {
+  PW_TRACE_TIME_TYPE time;
+  uint32_t trace_token;
+  uint32_t trace_id;
+  bool has_trace_id;
+  uint8_t data_size;
+  std::byte data[PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES];
+};
+
+// A ring of trace events written by one core and read by one reader.
+//
+// Writers never block. Space is reserved with a compare-and-swap, so an
+// interrupt which traces while the same core is mid-write is safe. Written
+// events become visible to the reader once no write into the ring is in
+// progress. New events are dropped while the ring is full.
+class CoreTraceRing {
+ public:
+  constexpr CoreTraceRing() = default;
+
+  CoreTraceRing(const CoreTraceRing&) = delete;
+  CoreTraceRing& operator=(const CoreTraceRing&) = delete;
+
+  // Sets the storage of the ring and clears it. Must not be called while the
+  // ring is in use.
+  void SetBuffer(span<std::byte> buffer);
+
+  // Copies an event into the ring. Returns false, counting a drop, if the ring
+  // is full or the event's data is too large.
+  bool TryPush(const CoreTraceEvent& event);
+
+  // Reads the oldest visible event without removing it. Returns false if
+  // there is none.
+  bool Peek(CoreTraceEvent& event) const;
+
+  // Removes the oldest visible event, if any.
+  void Pop();
+
+  // Discards all events. Must not be called while events are being written.
+  void Clear();
+
+  uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  // Returns the number of dropped events and resets the count.
+  uint32_t TakeDropped() {
+    return dropped_.exchange(0, std::memory_order_relaxed);
+  }
+
+ private:
+  void CopyIn(uint32_t position, span<const std::byte> bytes);
+  void CopyOut(uint32_t position, span<std::byte> bytes) const;
+  void Publish(uint32_t end);
+
+  span<std::byte> buffer_;
+  // Positions are byte counts which wrap at 2^32, taken modulo the buffer size
+  // to index it.
+  std::atomic<uint32_t> reserved_{0};   // End of the reserved bytes.
+  std::atomic<uint32_t> published_{0};  // End of the fully written bytes.
+  std::atomic<uint32_t> read_{0};       // Start of the unread bytes.
+  std::atomic<uint32_t> writers_{0};    // Writes in progress.
+  std::atomic<uint32_t> dropped_{0};
+};
+
+// Moves the visible events of all rings into the output buffer in timestamp
+// order. Each event is encoded as the tokenized tracer encodes events: the
+// token, the varint time delta from the previous event, the varint trace ID if
+// any, then the data. last_time is the time of the previous event, or 0 if
+// there is none, and is updated.
+void MergeCoreTraceRings(span<CoreTraceRing> rings,
+                         PW_TRACE_TIME_TYPE& last_time,
+                         TraceEntryWriter& output);
+
+// Moves the visible events of all rings into blocks in the output buffer, in
+// timestamp order. The open block is left in the encoder.
+void MergeCoreTraceRings(span<CoreTraceRing> rings,
+                         PW_TRACE_TIME_TYPE& last_time,
+                         TraceBlockEncoder& encoder,
+                         TraceEntryWriter& output);
+
+}  // namespace internal
+}  // namespace trace
+}  // namespace pw
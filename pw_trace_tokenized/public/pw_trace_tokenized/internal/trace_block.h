@@ -0,0 +1,81 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// The block encoder used by the trace buffer when
+// PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED is set.
+//
+// A block is a single ring buffer entry holding one or more events:
+//
+//   block: varint base time delta from the previous event, then events
+//   event: token (4 bytes, little endian)
+//          varint (time delta from the previous event in the block << 1 |
+//                  has data)
+//          varint trace ID, if the event type has one
+//          varint data size and the data, if has data is set
+//
+// The first event in a block is relative to the base time, so its delta is
+// normally 0.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_trace_tokenized/config.h"
+#include "pw_trace_tokenized/internal/trace_entry_writer.h"
+
+namespace pw {
+namespace trace {
+namespace internal {
+
+static_assert(PW_TRACE_BUFFER_BLOCK_SIZE_BYTES < 128,
+              "Blocks must have a single byte size prefix for the host tools");
+
+class TraceBlockEncoder {
+ public:
+  constexpr TraceBlockEncoder() = default;
+
+  TraceBlockEncoder(const TraceBlockEncoder&) = delete;
+  TraceBlockEncoder& operator=(const TraceBlockEncoder&) = delete;
+
+  // Appends an event to the open block. The open block is first pushed to the
+  // output if the event does not fit in it. Returns false, dropping the event,
+  // if it does not fit in an empty block either.
+  bool Add(PW_TRACE_TIME_TYPE delta,
+           uint32_t trace_token,
+           bool has_trace_id,
+           uint32_t trace_id,
+           ConstByteSpan data,
+           TraceEntryWriter& output);
+
+  // Pushes the open block, if it has any events, to the output.
+  void Flush(TraceEntryWriter& output);
+
+  // Discards the open block.
+  void Clear() {
+    size_ = 0;
+    num_events_ = 0;
+  }
+
+ private:
+  std::byte block_[PW_TRACE_BUFFER_BLOCK_SIZE_BYTES] = {};
+  size_t size_ = 0;
+  size_t num_events_ = 0;
+};
+
+}  // namespace internal
+}  // namespace trace
+}  // namespace pw
@@ -0,0 +1,80 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// Writes encoded trace entries into the trace buffer's ring buffer.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+
+namespace pw {
+namespace trace {
+namespace internal {
+
+// Pushes entries into a ring buffer. By default the oldest entries are
+// overwritten when the buffer is full. When drop_when_full is set, new entries
+// are dropped instead, and the events in them counted.
+class TraceEntryWriter {
+ public:
+  explicit constexpr TraceEntryWriter(
+      ring_buffer::PrefixedEntryRingBuffer& buffer)
+      : buffer_(buffer) {}
+
+  TraceEntryWriter(const TraceEntryWriter&) = delete;
+  TraceEntryWriter& operator=(const TraceEntryWriter&) = delete;
+
+  // Pushes an entry holding num_events events.
+  void Push(ConstByteSpan entry, size_t num_events = 1) {
+    if (!drop_when_full_) {
+      buffer_.PushBack(entry)
+          .IgnoreError();  // TODO(b/242598609): Handle Status properly
+      return;
+    }
+    if (!buffer_.TryPushBack(entry).ok()) {
+      AddDropped(num_events);
+    }
+  }
+
+  // Counts events dropped before reaching the writer.
+  void AddDropped(size_t num_events) {
+    dropped_ += static_cast<uint32_t>(num_events);
+  }
+
+  // Returns the number of dropped events since the last call.
+  uint32_t TakeDropped() {
+    const uint32_t dropped = dropped_;
+    dropped_ = 0;
+    return dropped;
+  }
+
+  void set_drop_when_full(bool drop_when_full) {
+    drop_when_full_ = drop_when_full;
+  }
+
+  ring_buffer::PrefixedEntryRingBuffer& buffer() { return buffer_; }
+
+ private:
+  ring_buffer::PrefixedEntryRingBuffer& buffer_;
+  bool drop_when_full_ = false;
+  uint32_t dropped_ = 0;
+};
+
+}  // namespace internal
+}  // namespace trace
+}  // namespace pw
@@ -16,6 +16,8 @@
 // This file provides an optional trace buffer which can be used with the
 #pragma once
 
+#include <cstdint>
+
 #include "pw_bytes/span.h"
 #include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
 #include "pw_trace_tokenized/config.h"
@@ -38,5 +40,15 @@ pw::ring_buffer::PrefixedEntryRingBuffer* GetBuffer();
 // when calling this function.
 ConstByteSpan DeringAndViewRawBuffer();
 
+// Sets whether new trace entries are dropped, rather than overwriting the
+// oldest entries, while the buffer is full. Streaming readers set this so that
+// entries are not lost while they are being sent.
+void SetBufferDropWhenFull(bool drop_when_full);
+
+// Returns the number of trace events dropped since the last call, because the
+// buffer was full while dropping when full, a per-core buffer was full, or the
+// event was too large.
+uint32_t TakeBufferDropCount();
+
 }  // namespace trace
 }  // namespace pw
@@ -170,9 +170,26 @@ class Callbacks {
     return called_on_every_event_count_;
   }
 
+  // An event capture replaces the tracer's shared event queue and sinks: each
+  // event which passes the event callbacks is handed to the capture directly,
+  // without taking PW_TRACE_QUEUE_LOCK or PW_TRACE_TRY_LOCK. The capture must
+  // be safe to call concurrently. Only one capture can be registered.
+  using EventCapture = void (*)(void* user_data, const TraceEvent& event);
+  struct EventCaptureCallback {
+    void* user_data;
+    EventCapture capture;
+  };
+
+  pw::Status RegisterEventCapture(EventCapture capture,
+                                  void* user_data = nullptr);
+  pw::Status UnregisterEventCapture();
+  // Returns false if no event capture is registered.
+  bool CallEventCapture(const TraceEvent& event);
+
  private:
   EventCallbacks event_callbacks_[PW_TRACE_CONFIG_MAX_EVENT_CALLBACKS];
   SinkCallbacks sink_callbacks_[PW_TRACE_CONFIG_MAX_SINKS];
+  EventCaptureCallback event_capture_;
   size_t called_on_every_event_count_ = 0;
 
   bool IsSinkFree(pw_trace_SinkHandle handle) {
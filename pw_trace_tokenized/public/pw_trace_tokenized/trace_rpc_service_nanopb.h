@@ -13,6 +13,10 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
 #include "pw_trace_protos/trace_rpc.rpc.pb.h"
 
 namespace pw::trace {
@@ -33,8 +37,28 @@ class TraceService final
   void GetTraceData(const pw_trace_Empty& request,
                     ServerWriter<pw_trace_TraceDataMessage>& writer);
 
+  // Opens a stream of trace data, replacing any open stream. The trace data is
+  // sent by DrainToStream(), which the application must call periodically.
+  void StreamTraceData(const pw_trace_Empty& request,
+                       ServerWriter<pw_trace_TraceDataMessage>& writer);
+
+  // Sends up to max_messages entries from the trace buffer to the open stream.
+  // Entries are only removed from the buffer once sent, so if the host falls
+  // behind the buffer fills and new events are dropped. The number of dropped
+  // events is sent with the next message.
+  //
+  // Returns:
+  //   OK - All entries, up to max_messages, were sent.
+  //   FAILED_PRECONDITION - No stream is open.
+  //   Any error from writing to the stream, with the unsent entries left in
+  //   the buffer.
+  pw::Status DrainToStream(
+      size_t max_messages = std::numeric_limits<size_t>::max());
+
  private:
   TokenizedTracer& tokenized_tracer_;
+  ServerWriter<pw_trace_TraceDataMessage> stream_writer_;
+  uint32_t pending_drop_count_ = 0;
 };
 
 }  // namespace pw::trace
@@ -131,6 +131,32 @@ def get_trace_data_from_device(client):
     return data
 
 
+def stream_trace_data_from_device(client):
+    """Stream the trace data using RPC from a Client until interrupted"""
+    data = b''
+    dropped = 0
+    service = client.client.channel(1).rpcs.pw.trace.TraceService
+    call = service.StreamTraceData.invoke()
+    _LOG.info('Streaming trace data, press Ctrl-C to stop')
+    try:
+        for streamed_data in call.get_responses(timeout_s=None):
+            dropped += streamed_data.drop_count
+            if streamed_data.drop_count:
+                _LOG.warning(
+                    'Device dropped %d trace events', streamed_data.drop_count
+                )
+            if streamed_data.data:
+                data = data + bytes([len(streamed_data.data)])
+                data = data + streamed_data.data
+    except KeyboardInterrupt:
+        pass
+    finally:
+        call.cancel()
+    if dropped:
+        _LOG.warning('%d trace events were dropped in total', dropped)
+    return data
+
+
 def _parse_args():
     """Parse and return command line arguments."""
 
@@ -183,6 +209,22 @@ def _parse_args():
         default=0,
         help=('Time offset (us) of the trace events (Default 0).'),
     )
+    parser.add_argument(
+        '--stream',
+        action='store_true',
+        help=(
+            'Stream trace data as it is captured until interrupted, rather '
+            'than reading the trace buffer once.'
+        ),
+    )
+    parser.add_argument(
+        '--block_format',
+        action='store_true',
+        help=(
+            'Decode the trace as blocks of events, as written when '
+            'PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED is set.'
+        ),
+    )
     return parser.parse_args()
 
 
@@ -192,9 +234,16 @@ def _main(args):
     )
     _LOG.info(database.database_summary(token_database))
     client = get_hdlc_rpc_client(**vars(args))
-    data = get_trace_data_from_device(client)
+    if args.stream:
+        data = stream_trace_data_from_device(client)
+    else:
+        data = get_trace_data_from_device(client)
     events = trace_tokenized.get_trace_events(
-        [token_database], data, args.ticks_per_second, args.time_offset
+        [token_database],
+        data,
+        args.ticks_per_second,
+        args.time_offset,
+        args.block_format,
     )
     json_lines = trace.generate_trace_json(events)
     trace_tokenized.save_trace_file(json_lines, args.trace_output_file)
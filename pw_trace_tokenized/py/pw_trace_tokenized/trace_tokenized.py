@@ -145,10 +145,70 @@ def parse_trace_event(buffer, db, last_time, ticks_per_second):
     return create_trace_event(token_string, timestamp_us, trace_id, data)
 
 
+def parse_trace_block(buffer, db, last_time, ticks_per_second):
+    """Parse the trace events in a block from bytes.
+
+    A block starts with the varint time delta of its base time from the
+    previous event. Each event is then the token, the varint time delta from
+    the previous event shifted left by one with a has-data flag in bit 0, the
+    varint trace ID if the event has one, and the varint data size and data if
+    the has-data flag is set.
+    """
+    us_per_tick = 1000000 / ticks_per_second
+    events = []
+
+    base_delta, idx = varint_decode(buffer)
+    timestamp_us = last_time + us_per_tick * base_delta
+
+    while idx + 4 < len(buffer):
+        # Read token
+        token = struct.unpack('I', buffer[idx : idx + 4])[0]
+        idx += 4
+
+        # The rest of the block cannot be parsed without the token's format.
+        if len(db.token_to_entries[token]) == 0:
+            _LOG.error("token not found: %08x", token)
+            break
+
+        token_string = str(db.token_to_entries[token][0])
+
+        # Read time and data flag
+        time_and_flag, time_bytes = varint_decode(buffer[idx:])
+        timestamp_us += us_per_tick * (time_and_flag >> 1)
+        idx += time_bytes
+
+        # Trace ID
+        trace_id = None
+        if has_trace_id(token_string):
+            trace_id, trace_id_bytes = varint_decode(buffer[idx:])
+            idx += trace_id_bytes
+
+        # Data
+        data = None
+        if time_and_flag & 1:
+            data_size, data_size_bytes = varint_decode(buffer[idx:])
+            idx += data_size_bytes
+            data = buffer[idx : idx + data_size]
+            idx += data_size
+
+        events.append(
+            create_trace_event(token_string, timestamp_us, trace_id, data)
+        )
+    return events
+
+
 def get_trace_events(
-    databases, raw_trace_data, ticks_per_second, time_offset: int
+    databases,
+    raw_trace_data,
+    ticks_per_second,
+    time_offset: int,
+    block_format: bool = False,
 ):
-    """Handles the decoding traces."""
+    """Handles the decoding traces.
+
+    Set block_format if the trace buffer was built with
+    PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED, so each entry is a block of events.
+    """
 
     db = tokens.Database.merged(*databases)
     last_timestamp = time_offset
@@ -162,15 +222,19 @@ def get_trace_events(
             _LOG.error("incomplete file")
             break
 
-        event = parse_trace_event(
-            raw_trace_data[idx + 1 : idx + 1 + size],
-            db,
-            last_timestamp,
-            ticks_per_second,
-        )
-        if event:
-            last_timestamp = event.timestamp_us
-            events.append(event)
+        entry = raw_trace_data[idx + 1 : idx + 1 + size]
+        if block_format:
+            entry_events = parse_trace_block(
+                entry, db, last_timestamp, ticks_per_second
+            )
+        else:
+            event = parse_trace_event(
+                entry, db, last_timestamp, ticks_per_second
+            )
+            entry_events = [event] if event else []
+        if entry_events:
+            last_timestamp = entry_events[-1].timestamp_us
+            events.extend(entry_events)
         idx = idx + size + 1
     return events
 
@@ -192,12 +256,16 @@ def save_trace_file(trace_lines, file_name):
 
 
 def get_trace_events_from_file(
-    databases, input_file_name, ticks_per_second, time_offset: int
+    databases,
+    input_file_name,
+    ticks_per_second,
+    time_offset: int,
+    block_format: bool = False,
 ):
     """Get trace events from a file."""
     raw_trace_data = get_trace_data_from_file(input_file_name)
     return get_trace_events(
-        databases, raw_trace_data, ticks_per_second, time_offset
+        databases, raw_trace_data, ticks_per_second, time_offset, block_format
     )
 
 
@@ -241,13 +309,25 @@ def _parse_args():
         default=0,
         help=('Time offset (us) of the trace events (Default 0).'),
     )
+    parser.add_argument(
+        '--block_format',
+        action='store_true',
+        help=(
+            'Decode the trace as blocks of events, as written when '
+            'PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED is set.'
+        ),
+    )
 
     return parser.parse_args()
 
 
 def _main(args):
     events = get_trace_events_from_file(
-        args.databases, args.input_file, args.ticks_per_second, args.time_offset
+        args.databases,
+        args.input_file,
+        args.ticks_per_second,
+        args.time_offset,
+        args.block_format,
     )
     json_lines = trace.generate_trace_json(events)
     save_trace_file(json_lines, args.output_file)
@@ -73,6 +73,14 @@ void TokenizedTracer::HandleTraceEvent(uint32_t trace_token,
     return;
   }
 
+  // An event capture, if registered, takes the event instead of the queue.
+  if (callbacks_.CallEventCapture(event)) {
+    if (PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING & ret_flags) {
+      enabled_ = false;
+    }
+    return;
+  }
+
   // Create trace event
   PW_TRACE_QUEUE_LOCK();
   if (!event_queue_
@@ -281,6 +289,36 @@ pw::Status Callbacks::UnregisterAllEventCallbacks() {
   return PW_STATUS_OK;
 }
 
+pw::Status Callbacks::RegisterEventCapture(EventCapture capture,
+                                           void* user_data) {
+  pw_Status status = PW_STATUS_RESOURCE_EXHAUSTED;
+  PW_TRACE_LOCK();
+  if (event_capture_.capture == nullptr) {
+    event_capture_.user_data = user_data;
+    event_capture_.capture = capture;
+    status = PW_STATUS_OK;
+  }
+  PW_TRACE_UNLOCK();
+  return status;
+}
+
+pw::Status Callbacks::UnregisterEventCapture() {
+  PW_TRACE_LOCK();
+  event_capture_.capture = nullptr;
+  event_capture_.user_data = nullptr;
+  PW_TRACE_UNLOCK();
+  return PW_STATUS_OK;
+}
+
+bool Callbacks::CallEventCapture(const TraceEvent& event) {
+  EventCapture capture = event_capture_.capture;
+  if (capture == nullptr) {
+    return false;
+  }
+  capture(event_capture_.user_data, event);
+  return true;
+}
+
 Callbacks::EventCallbacks* Callbacks::GetEventCallback(
     EventCallbackHandle handle) {
   if (handle >= PW_TRACE_CONFIG_MAX_EVENT_CALLBACKS) {
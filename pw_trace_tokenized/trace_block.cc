@@ -0,0 +1,102 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+#include "pw_trace_tokenized/internal/trace_block.h"
+
+#include <cstring>
+
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace trace {
+namespace internal {
+namespace {
+
+constexpr size_t kMaxEventHeaderSize =
+    sizeof(uint32_t) + pw::varint::kMaxVarint64SizeBytes +  // token, time
+    pw::varint::kMaxVarint32SizeBytes +                     // trace_id
+    pw::varint::kMaxVarint32SizeBytes;                      // data size
+
+}  // namespace
+
+bool TraceBlockEncoder::Add(PW_TRACE_TIME_TYPE delta,
+                            uint32_t trace_token,
+                            bool has_trace_id,
+                            uint32_t trace_id,
+                            ConstByteSpan data,
+                            TraceEntryWriter& output) {
+  std::byte base[pw::varint::kMaxVarint64SizeBytes];
+  size_t base_size = 0;
+  std::byte header[kMaxEventHeaderSize];
+  size_t header_size = 0;
+
+  // Encodes the event as the first in a new block, or as the next in the open
+  // block.
+  auto encode = [&](bool first_in_block) {
+    base_size = first_in_block ? pw::varint::Encode(delta, span(base)) : 0;
+    const uint64_t event_delta = first_in_block ? 0 : delta;
+    std::memcpy(header, &trace_token, sizeof(trace_token));
+    header_size = sizeof(trace_token);
+    header_size += pw::varint::Encode(
+        (event_delta << 1) | (data.empty() ? 0u : 1u),
+        span(header).subspan(header_size));
+    if (has_trace_id) {
+      header_size +=
+          pw::varint::Encode(trace_id, span(header).subspan(header_size));
+    }
+    if (!data.empty()) {
+      header_size +=
+          pw::varint::Encode(data.size(), span(header).subspan(header_size));
+    }
+    return base_size + header_size + data.size();
+  };
+
+  size_t event_size = encode(size_ == 0);
+  if (size_ + event_size > sizeof(block_)) {
+    if (size_ == 0) {
+      output.AddDropped(1);
+      return false;
+    }
+    Flush(output);
+    event_size = encode(true);
+    if (event_size > sizeof(block_)) {
+      output.AddDropped(1);
+      return false;
+    }
+  }
+
+  std::memcpy(&block_[size_], base, base_size);
+  size_ += base_size;
+  std::memcpy(&block_[size_], header, header_size);
+  size_ += header_size;
+  if (!data.empty()) {
+    std::memcpy(&block_[size_], data.data(), data.size());
+    size_ += data.size();
+  }
+  ++num_events_;
+  return true;
+}
+
+void TraceBlockEncoder::Flush(TraceEntryWriter& output) {
+  if (size_ == 0) {
+    return;
+  }
+  output.Push(span<const std::byte>(block_, size_), num_events_);
+  Clear();
+}
+
+}  // namespace internal
+}  // namespace trace
+}  // namespace pw
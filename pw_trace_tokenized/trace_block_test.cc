@@ -0,0 +1,144 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/internal/trace_block.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_varint/varint.h"
+
+namespace pw::trace::internal {
+namespace {
+
+class TraceBlockTest : public ::testing::Test {
+ protected:
+  TraceBlockTest() { EXPECT_EQ(OkStatus(), output_.SetBuffer(storage_)); }
+
+  // Pops the next block from the output.
+  ConstByteSpan PopBlock() {
+    size_t size = 0;
+    EXPECT_EQ(OkStatus(), output_.PeekFront(block_, &size));
+    EXPECT_EQ(OkStatus(), output_.PopFront());
+    return ConstByteSpan(block_, size);
+  }
+
+  uint64_t ReadVarint(ConstByteSpan block, size_t& idx) {
+    uint64_t value = 0;
+    idx += varint::Decode(block.subspan(idx), &value);
+    return value;
+  }
+
+  uint32_t ReadToken(ConstByteSpan block, size_t& idx) {
+    uint32_t token;
+    std::memcpy(&token, &block[idx], sizeof(token));
+    idx += sizeof(token);
+    return token;
+  }
+
+  std::byte storage_[512];
+  std::byte block_[PW_TRACE_BUFFER_BLOCK_SIZE_BYTES];
+  ring_buffer::PrefixedEntryRingBuffer output_;
+  TraceEntryWriter writer_{output_};
+  TraceBlockEncoder encoder_;
+};
+
+TEST_F(TraceBlockTest, Flush_EmptyBlock_PushesNothing) {
+  encoder_.Flush(writer_);
+  EXPECT_EQ(output_.EntryCount(), 0u);
+}
+
+TEST_F(TraceBlockTest, Add_PacksEventsWithSharedBase) {
+  constexpr std::array<std::byte, 2> kData = {std::byte{0xaa}, std::byte{0xbb}};
+  ASSERT_TRUE(encoder_.Add(100, 0x11111111, false, 0, {}, writer_));
+  ASSERT_TRUE(encoder_.Add(3, 0x22222222, true, 9, {}, writer_));
+  ASSERT_TRUE(encoder_.Add(5, 0x33333333, false, 0, kData, writer_));
+  EXPECT_EQ(output_.EntryCount(), 0u);
+  encoder_.Flush(writer_);
+  ASSERT_EQ(output_.EntryCount(), 1u);
+
+  ConstByteSpan block = PopBlock();
+  size_t idx = 0;
+  EXPECT_EQ(ReadVarint(block, idx), 100u);  // Base time delta.
+
+  EXPECT_EQ(ReadToken(block, idx), 0x11111111u);
+  EXPECT_EQ(ReadVarint(block, idx), 0u);
+
+  EXPECT_EQ(ReadToken(block, idx), 0x22222222u);
+  EXPECT_EQ(ReadVarint(block, idx), 3u << 1);
+  EXPECT_EQ(ReadVarint(block, idx), 9u);
+
+  EXPECT_EQ(ReadToken(block, idx), 0x33333333u);
+  EXPECT_EQ(ReadVarint(block, idx), (5u << 1) | 1);
+  EXPECT_EQ(ReadVarint(block, idx), 2u);
+  EXPECT_EQ(block[idx++], std::byte{0xaa});
+  EXPECT_EQ(block[idx++], std::byte{0xbb});
+  EXPECT_EQ(idx, block.size());
+}
+
+TEST_F(TraceBlockTest, Add_FullBlock_StartsNewBlock) {
+  // Each event after the first is 5 bytes; the first also has a 1 byte base.
+  constexpr size_t kEventsPerBlock = (PW_TRACE_BUFFER_BLOCK_SIZE_BYTES - 1) / 5;
+  for (size_t i = 0; i < kEventsPerBlock; ++i) {
+    ASSERT_TRUE(encoder_.Add(1, 0x12345678, false, 0, {}, writer_));
+  }
+  EXPECT_EQ(output_.EntryCount(), 0u);
+
+  ASSERT_TRUE(encoder_.Add(7, 0x87654321, false, 0, {}, writer_));
+  ASSERT_EQ(output_.EntryCount(), 1u);
+  EXPECT_EQ(PopBlock().size(), 1 + kEventsPerBlock * 5);
+
+  encoder_.Flush(writer_);
+  ConstByteSpan block = PopBlock();
+  size_t idx = 0;
+  EXPECT_EQ(ReadVarint(block, idx), 7u);
+  EXPECT_EQ(ReadToken(block, idx), 0x87654321u);
+  EXPECT_EQ(ReadVarint(block, idx), 0u);
+}
+
+TEST_F(TraceBlockTest, Add_EventLargerThanBlock_Dropped) {
+  std::array<std::byte, PW_TRACE_BUFFER_BLOCK_SIZE_BYTES> data = {};
+  EXPECT_FALSE(encoder_.Add(1, 0x12345678, false, 0, data, writer_));
+  encoder_.Flush(writer_);
+  EXPECT_EQ(output_.EntryCount(), 0u);
+  EXPECT_EQ(writer_.TakeDropped(), 1u);
+}
+
+TEST_F(TraceBlockTest, DropWhenFull_CountsEventsInDroppedBlock) {
+  std::byte small_storage[16];
+  ring_buffer::PrefixedEntryRingBuffer small_output;
+  ASSERT_EQ(OkStatus(), small_output.SetBuffer(small_storage));
+  TraceEntryWriter small_writer(small_output);
+  small_writer.set_drop_when_full(true);
+
+  // A 16 byte block does not fit with its size prefix.
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(encoder_.Add(1, 0x12345678, false, 0, {}, small_writer));
+  }
+  encoder_.Flush(small_writer);
+  EXPECT_EQ(small_output.EntryCount(), 0u);
+  EXPECT_EQ(small_writer.TakeDropped(), 3u);
+  EXPECT_EQ(small_writer.TakeDropped(), 0u);
+}
+
+TEST_F(TraceBlockTest, Clear_DiscardsOpenBlock) {
+  ASSERT_TRUE(encoder_.Add(1, 0x12345678, false, 0, {}, writer_));
+  encoder_.Clear();
+  encoder_.Flush(writer_);
+  EXPECT_EQ(output_.EntryCount(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::trace::internal
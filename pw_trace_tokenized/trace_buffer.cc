@@ -17,6 +17,10 @@
 
 #include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
 #include "pw_span/span.h"
+#include "pw_trace/trace.h"
+#include "pw_trace_tokenized/internal/core_trace_ring.h"
+#include "pw_trace_tokenized/internal/trace_block.h"
+#include "pw_trace_tokenized/internal/trace_entry_writer.h"
 #include "pw_trace_tokenized/trace_callback.h"
 
 namespace pw {
@@ -28,11 +32,42 @@ class TraceBuffer {
   TraceBuffer(Callbacks& callbacks) : callbacks_(callbacks) {
     ring_buffer_.SetBuffer(raw_buffer_)
         .IgnoreError();  // TODO(b/242598609): Handle Status properly
+#if PW_TRACE_BUFFER_PER_CORE_ENABLED
+    for (size_t core = 0; core < PW_TRACE_BUFFER_NUM_CORES; ++core) {
+      core_rings_[core].SetBuffer(core_buffers_[core]);
+    }
+    callbacks_.RegisterEventCapture(TraceCapture, this)
+        .IgnoreError();  // TODO(b/242598609): Handle Status properly
+#else
     callbacks_
         .RegisterSink(
             TraceSinkStartBlock, TraceSinkAddBytes, TraceSinkEndBlock, this)
         .IgnoreError();  // TODO(b/242598609): Handle Status properly
+#endif  // PW_TRACE_BUFFER_PER_CORE_ENABLED
+  }
+
+#if PW_TRACE_BUFFER_PER_CORE_ENABLED
+  // Captures an event into the ring of the current core, without locking.
+  static void TraceCapture(void* user_data,
+                           const Callbacks::TraceEvent& event) {
+    TraceBuffer* buffer = reinterpret_cast<TraceBuffer*>(user_data);
+    const size_t core = PW_TRACE_GET_CORE_ID();
+    if (core >= PW_TRACE_BUFFER_NUM_CORES ||
+        event.data_size > PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES) {
+      return;
+    }
+    internal::CoreTraceEvent core_event;
+    core_event.time = PW_TRACE_GET_TIME();
+    core_event.trace_token = event.trace_token;
+    core_event.trace_id = event.trace_id;
+    core_event.has_trace_id = PW_TRACE_HAS_TRACE_ID(event.event_type);
+    core_event.data_size = static_cast<uint8_t>(event.data_size);
+    if (event.data_size > 0) {
+      memcpy(core_event.data, event.data_buffer, event.data_size);
+    }
+    buffer->core_rings_[core].TryPush(core_event);
   }
+#endif  // PW_TRACE_BUFFER_PER_CORE_ENABLED
 
   static void TraceSinkStartBlock(void* user_data, size_t size) {
     TraceBuffer* buffer = reinterpret_cast<TraceBuffer*>(user_data);
@@ -42,6 +77,7 @@ class TraceBuffer {
     }
     buffer->block_size_ = static_cast<uint16_t>(size);
     buffer->block_idx_ = 0;
+    buffer->header_size_ = 0;
   }
 
   static void TraceSinkAddBytes(void* user_data,
@@ -52,27 +88,104 @@ class TraceBuffer {
         buffer->block_idx_ + size > buffer->block_size_) {
       return;  // Block is too large, skipping.
     }
+    // The header of the event is always added first, separately from the data.
+    if (buffer->block_idx_ == 0) {
+      buffer->header_size_ = static_cast<uint16_t>(size);
+    }
     memcpy(&buffer->current_block_[buffer->block_idx_], bytes, size);
     buffer->block_idx_ += size;
   }
 
   static void TraceSinkEndBlock(void* user_data) {
     TraceBuffer* buffer = reinterpret_cast<TraceBuffer*>(user_data);
-    if (buffer->block_idx_ != buffer->block_size_) {
+    if (buffer->block_size_ == 0 ||
+        buffer->block_idx_ != buffer->block_size_) {
+      buffer->writer_.AddDropped(1);
       return;  // Block is too large, skipping.
     }
-    buffer->ring_buffer_
-        .PushBack(span<const std::byte>(&buffer->current_block_[0],
-                                        buffer->block_size_))
-        .IgnoreError();  // TODO(b/242598609): Handle Status properly
+#if PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+    buffer->AddToBlock();
+#else
+    buffer->writer_.Push(span<const std::byte>(&buffer->current_block_[0],
+                                               buffer->block_size_));
+#endif  // PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
   }
 
+#if PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+  // Re-encodes the event in current_block_ into the open block.
+  void AddToBlock() {
+    const ConstByteSpan event(current_block_, block_size_);
+    const ConstByteSpan header = event.first(header_size_);
+    uint32_t trace_token;
+    if (header.size() < sizeof(trace_token)) {
+      return;
+    }
+    memcpy(&trace_token, header.data(), sizeof(trace_token));
+    size_t idx = sizeof(trace_token);
+
+    uint64_t delta = 0;
+    idx += pw::varint::Decode(header.subspan(idx), &delta);
+    // Anything left in the header after the time is the trace ID.
+    uint64_t trace_id = 0;
+    const bool has_trace_id = idx < header.size();
+    if (has_trace_id) {
+      pw::varint::Decode(header.subspan(idx), &trace_id);
+    }
+
+    block_encoder_.Add(static_cast<PW_TRACE_TIME_TYPE>(delta),
+                       trace_token,
+                       has_trace_id,
+                       static_cast<uint32_t>(trace_id),
+                       event.subspan(header_size_),
+                       writer_);
+  }
+#endif  // PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+
+  // Per-core events, and the open block, are moved into the ring buffer when
+  // it is read out.
   pw::ring_buffer::PrefixedEntryRingBuffer& RingBuffer() {
+#if PW_TRACE_BUFFER_PER_CORE_ENABLED && PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+    internal::MergeCoreTraceRings(
+        core_rings_, last_trace_time_, block_encoder_, writer_);
+#elif PW_TRACE_BUFFER_PER_CORE_ENABLED
+    internal::MergeCoreTraceRings(core_rings_, last_trace_time_, writer_);
+#endif  // PW_TRACE_BUFFER_PER_CORE_ENABLED
+#if PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+    block_encoder_.Flush(writer_);
+#endif  // PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
     return ring_buffer_;
   }
 
+  void SetDropWhenFull(bool drop_when_full) {
+    writer_.set_drop_when_full(drop_when_full);
+  }
+
+  uint32_t TakeDropCount() {
+#if PW_TRACE_BUFFER_PER_CORE_ENABLED
+    for (internal::CoreTraceRing& core_ring : core_rings_) {
+      writer_.AddDropped(core_ring.TakeDropped());
+    }
+#endif  // PW_TRACE_BUFFER_PER_CORE_ENABLED
+    return writer_.TakeDropped();
+  }
+
+  void Clear() {
+#if PW_TRACE_BUFFER_PER_CORE_ENABLED
+    for (internal::CoreTraceRing& core_ring : core_rings_) {
+      core_ring.Clear();
+    }
+    last_trace_time_ = 0;
+#endif  // PW_TRACE_BUFFER_PER_CORE_ENABLED
+#if PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+    block_encoder_.Clear();
+#endif  // PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+    writer_.TakeDropped();
+    ring_buffer_.Clear();
+  }
+
   ConstByteSpan DeringAndViewRawBuffer() {
-    ring_buffer_.Dering()
+    RingBuffer()
+        .Dering()
         .IgnoreError();  // TODO(b/242598609): Handle Status properly
     return ByteSpan(raw_buffer_, ring_buffer_.TotalUsedBytes());
   }
@@ -81,9 +194,20 @@ class TraceBuffer {
   Callbacks& callbacks_;
   uint16_t block_size_ = 0;
   uint16_t block_idx_ = 0;
+  uint16_t header_size_ = 0;
   std::byte current_block_[PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES];
   std::byte raw_buffer_[PW_TRACE_BUFFER_SIZE_BYTES];
   pw::ring_buffer::PrefixedEntryRingBuffer ring_buffer_{false};
+  internal::TraceEntryWriter writer_{ring_buffer_};
+#if PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+  internal::TraceBlockEncoder block_encoder_;
+#endif  // PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+#if PW_TRACE_BUFFER_PER_CORE_ENABLED
+  std::byte core_buffers_[PW_TRACE_BUFFER_NUM_CORES]
+                         [PW_TRACE_BUFFER_PER_CORE_SIZE_BYTES];
+  internal::CoreTraceRing core_rings_[PW_TRACE_BUFFER_NUM_CORES];
+  PW_TRACE_TIME_TYPE last_trace_time_ = 0;
+#endif  // PW_TRACE_BUFFER_PER_CORE_ENABLED
 };
 
 #if PW_TRACE_BUFFER_SIZE_BYTES > 0
@@ -92,7 +216,7 @@ TraceBuffer trace_buffer_instance(GetCallbacks());
 
 }  // namespace
 
-void ClearBuffer() { trace_buffer_instance.RingBuffer().Clear(); }
+void ClearBuffer() { trace_buffer_instance.Clear(); }
 
 pw::ring_buffer::PrefixedEntryRingBuffer* GetBuffer() {
   return &trace_buffer_instance.RingBuffer();
@@ -102,5 +226,11 @@ ConstByteSpan DeringAndViewRawBuffer() {
   return trace_buffer_instance.DeringAndViewRawBuffer();
 }
 
+void SetBufferDropWhenFull(bool drop_when_full) {
+  trace_buffer_instance.SetDropWhenFull(drop_when_full);
+}
+
+uint32_t TakeBufferDropCount() { return trace_buffer_instance.TakeDropCount(); }
+
 }  // namespace trace
 }  // namespace pw
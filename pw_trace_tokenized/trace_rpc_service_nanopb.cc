@@ -15,12 +15,21 @@
 
 #include "pw_trace_tokenized/trace_rpc_service_nanopb.h"
 
+#include <utility>
+
 #include "pw_log/log.h"
 #include "pw_trace_tokenized/trace_buffer.h"
 #include "pw_trace_tokenized/trace_tokenized.h"
 
 namespace pw::trace {
 
+#if PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+// Each block is sent in a single message.
+static_assert(PW_TRACE_BUFFER_BLOCK_SIZE_BYTES <=
+                  sizeof(decltype(pw_trace_TraceDataMessage::data)::bytes),
+              "PW_TRACE_BUFFER_BLOCK_SIZE_BYTES must fit in TraceDataMessage");
+#endif  // PW_TRACE_BUFFER_BLOCK_FORMAT_ENABLED
+
 TraceService::TraceService(TokenizedTracer& tokenized_tracer)
     : tokenized_tracer_(tokenized_tracer) {}
 
@@ -58,4 +67,53 @@ void TraceService::GetTraceData(
   }
   writer.Finish().IgnoreError();  // TODO(b/242598609): Handle Status properly
 }
+
+void TraceService::StreamTraceData(
+    const pw_trace_Empty&, ServerWriter<pw_trace_TraceDataMessage>& writer) {
+  stream_writer_ = std::move(writer);
+  // Only report drops from while streaming.
+  pw::trace::TakeBufferDropCount();
+  pending_drop_count_ = 0;
+  pw::trace::SetBufferDropWhenFull(true);
+}
+
+pw::Status TraceService::DrainToStream(size_t max_messages) {
+  if (!stream_writer_.active()) {
+    pw::trace::SetBufferDropWhenFull(false);
+    return pw::Status::FailedPrecondition();
+  }
+
+  pending_drop_count_ += pw::trace::TakeBufferDropCount();
+  pw::ring_buffer::PrefixedEntryRingBuffer* trace_buffer =
+      pw::trace::GetBuffer();
+  pw_trace_TraceDataMessage message = pw_trace_TraceDataMessage_init_default;
+
+  for (size_t sent = 0; sent < max_messages; ++sent) {
+    size_t size = 0;
+    const pw::Status peek_status = trace_buffer->PeekFront(
+        as_writable_bytes(span(message.data.bytes)), &size);
+    const bool has_entry = !peek_status.IsOutOfRange();
+    if (!has_entry && pending_drop_count_ == 0) {
+      break;
+    }
+    // Drops are reported in a message without data if the buffer is empty.
+    message.data.size = has_entry ? size : 0;
+    message.drop_count = pending_drop_count_;
+
+    const pw::Status status = stream_writer_.Write(message);
+    if (!status.ok()) {
+      if (!stream_writer_.active()) {
+        pw::trace::SetBufferDropWhenFull(false);
+      }
+      return status;
+    }
+    pending_drop_count_ = 0;
+    if (!has_entry) {
+      break;
+    }
+    trace_buffer->PopFront()
+        .IgnoreError();  // TODO(b/242598609): Handle Status properly
+  }
+  return pw::OkStatus();
+}
 }  // namespace pw::trace
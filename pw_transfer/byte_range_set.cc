@@ -0,0 +1,89 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/byte_range_set.h"
+
+#include <algorithm>
+
+namespace pw::transfer::internal {
+
+bool ByteRangeSet::Add(uint32_t start, uint32_t end) {
+  if (start >= end) {
+    return true;
+  }
+
+  // Skip the ranges which end before the new one starts.
+  size_t first = 0;
+  while (first < size_ && ranges_[first].end < start) {
+    ++first;
+  }
+
+  // Fold every range that overlaps or touches the new one into it.
+  size_t last = first;
+  while (last < size_ && ranges_[last].start <= end) {
+    start = std::min(start, ranges_[last].start);
+    end = std::max(end, ranges_[last].end);
+    ++last;
+  }
+
+  if (first == last) {
+    if (full()) {
+      return false;
+    }
+
+    std::move_backward(ranges_.begin() + first,
+                       ranges_.begin() + size_,
+                       ranges_.begin() + size_ + 1);
+    size_ += 1;
+  } else {
+    Erase(first + 1, last - first - 1);
+  }
+
+  ranges_[first] = {start, end};
+  return true;
+}
+
+uint32_t ByteRangeSet::Advance(uint32_t offset) {
+  size_t consumed = 0;
+  while (consumed < size_ && ranges_[consumed].start <= offset) {
+    offset = std::max(offset, ranges_[consumed].end);
+    ++consumed;
+  }
+
+  Erase(0, consumed);
+  return offset;
+}
+
+void ByteRangeSet::Truncate(uint32_t end) {
+  while (size_ > 0 && ranges_[size_ - 1].start >= end) {
+    size_ -= 1;
+  }
+
+  if (size_ > 0) {
+    ranges_[size_ - 1].end = std::min(ranges_[size_ - 1].end, end);
+  }
+}
+
+void ByteRangeSet::Erase(size_t index, size_t count) {
+  if (count == 0) {
+    return;
+  }
+
+  std::move(ranges_.begin() + index + count,
+            ranges_.begin() + size_,
+            ranges_.begin() + index);
+  size_ -= count;
+}
+
+}  // namespace pw::transfer::internal
@@ -0,0 +1,113 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/byte_range_set.h"
+
+#include "gtest/gtest.h"
+
+namespace pw::transfer::internal {
+namespace {
+
+static_assert(ByteRangeSet::kCapacity >= 3,
+              "These tests require space for at least 3 ranges");
+
+void ExpectRanges(const ByteRangeSet& set,
+                  std::initializer_list<ByteRange> expected) {
+  ASSERT_EQ(set.size(), expected.size());
+  size_t i = 0;
+  for (const ByteRange& range : expected) {
+    EXPECT_EQ(set.ranges()[i].start, range.start);
+    EXPECT_EQ(set.ranges()[i].end, range.end);
+    ++i;
+  }
+}
+
+TEST(ByteRangeSet, Add_KeepsRangesSorted) {
+  ByteRangeSet set;
+  EXPECT_TRUE(set.Add(300, 400));
+  EXPECT_TRUE(set.Add(100, 200));
+  EXPECT_TRUE(set.Add(500, 600));
+  ExpectRanges(set, {{100, 200}, {300, 400}, {500, 600}});
+}
+
+TEST(ByteRangeSet, Add_MergesAdjacentAndOverlappingRanges) {
+  ByteRangeSet set;
+  EXPECT_TRUE(set.Add(100, 200));
+  EXPECT_TRUE(set.Add(200, 300));
+  ExpectRanges(set, {{100, 300}});
+
+  EXPECT_TRUE(set.Add(250, 350));
+  ExpectRanges(set, {{100, 350}});
+}
+
+TEST(ByteRangeSet, Add_BridgesSeveralRanges) {
+  ByteRangeSet set;
+  EXPECT_TRUE(set.Add(100, 200));
+  EXPECT_TRUE(set.Add(300, 400));
+  EXPECT_TRUE(set.Add(500, 600));
+
+  EXPECT_TRUE(set.Add(150, 550));
+  ExpectRanges(set, {{100, 600}});
+}
+
+TEST(ByteRangeSet, Add_EmptyRangeIsIgnored) {
+  ByteRangeSet set;
+  EXPECT_TRUE(set.Add(100, 100));
+  EXPECT_TRUE(set.empty());
+}
+
+TEST(ByteRangeSet, Add_FullSetRejectsNewRange) {
+  ByteRangeSet set;
+  for (uint32_t i = 0; i < ByteRangeSet::kCapacity; ++i) {
+    ASSERT_TRUE(set.Add(100 * (i + 1), 100 * (i + 1) + 50));
+  }
+  EXPECT_TRUE(set.full());
+
+  EXPECT_FALSE(set.Add(10, 20));
+  EXPECT_EQ(set.size(), ByteRangeSet::kCapacity);
+
+  // Ranges that merge with an existing entry still fit.
+  EXPECT_TRUE(set.Add(150, 160));
+  EXPECT_EQ(set.ranges()[0].end, 160u);
+}
+
+TEST(ByteRangeSet, Advance_ConsumesContiguousRanges) {
+  ByteRangeSet set;
+  EXPECT_TRUE(set.Add(100, 200));
+  EXPECT_TRUE(set.Add(300, 400));
+
+  EXPECT_EQ(set.Advance(50), 50u);
+  ExpectRanges(set, {{100, 200}, {300, 400}});
+
+  EXPECT_EQ(set.Advance(100), 200u);
+  ExpectRanges(set, {{300, 400}});
+
+  EXPECT_EQ(set.Advance(350), 400u);
+  EXPECT_TRUE(set.empty());
+}
+
+TEST(ByteRangeSet, Truncate_DropsDataBeyondEnd) {
+  ByteRangeSet set;
+  EXPECT_TRUE(set.Add(100, 200));
+  EXPECT_TRUE(set.Add(300, 400));
+
+  set.Truncate(350);
+  ExpectRanges(set, {{100, 200}, {300, 350}});
+
+  set.Truncate(300);
+  ExpectRanges(set, {{100, 200}});
+}
+
+}  // namespace
+}  // namespace pw::transfer::internal
@@ -14,15 +14,67 @@
 
 #include "pw_transfer/internal/chunk.h"
 
+#include <array>
+#include <limits>
+
 #include "pw_assert/check.h"
 #include "pw_protobuf/decoder.h"
 #include "pw_protobuf/serialized_size.h"
 #include "pw_status/try.h"
+#include "pw_varint/varint.h"
 
 namespace pw::transfer::internal {
 
 namespace ProtoChunk = transfer::pwpb::Chunk;
 
+namespace {
+
+// Decodes packed [start, end) pairs into the range set. Ranges which don't fit
+// are dropped; the peer simply retransmits that data.
+Status ParseReceivedRanges(ConstByteSpan packed, ByteRangeSet& ranges) {
+  while (!packed.empty()) {
+    uint64_t start;
+    uint64_t end;
+
+    size_t bytes_read = varint::Decode(packed, &start);
+    if (bytes_read == 0) {
+      return Status::DataLoss();
+    }
+    packed = packed.subspan(bytes_read);
+
+    bytes_read = varint::Decode(packed, &end);
+    if (bytes_read == 0) {
+      return Status::DataLoss();
+    }
+    packed = packed.subspan(bytes_read);
+
+    if (start >= end || end > std::numeric_limits<uint32_t>::max()) {
+      return Status::DataLoss();
+    }
+
+    if (!ranges.Add(static_cast<uint32_t>(start), static_cast<uint32_t>(end))) {
+      break;
+    }
+  }
+
+  return OkStatus();
+}
+
+// Flattens a range set into the [start, end) pairs of the received_ranges
+// field.
+span<const uint64_t> FlattenReceivedRanges(
+    const ByteRangeSet& ranges,
+    std::array<uint64_t, ByteRangeSet::kCapacity * 2>& buffer) {
+  size_t i = 0;
+  for (const ByteRange& range : ranges.ranges()) {
+    buffer[i++] = range.start;
+    buffer[i++] = range.end;
+  }
+  return span(buffer.data(), i);
+}
+
+}  // namespace
+
 Result<Chunk::Identifier> Chunk::ExtractIdentifier(ConstByteSpan message) {
   protobuf::Decoder decoder(message);
 
@@ -182,6 +234,17 @@ Result<Chunk> Chunk::Parse(ConstByteSpan message) {
         chunk.desired_session_id_ = value;
         break;
 
+      case ProtoChunk::Fields::kFeatures:
+        PW_TRY(decoder.ReadUint32(&chunk.features_));
+        break;
+
+      case ProtoChunk::Fields::kReceivedRanges: {
+        ConstByteSpan packed;
+        PW_TRY(decoder.ReadBytes(&packed));
+        PW_TRY(ParseReceivedRanges(packed, chunk.received_ranges_));
+        break;
+      }
+
         // Silently ignore any unrecognized fields.
     }
   }
@@ -291,6 +354,17 @@ Result<ConstByteSpan> Chunk::Encode(ByteSpan buffer) const {
     encoder.WriteStatus(status_.value().code()).IgnoreError();
   }
 
+  if (features_ != 0) {
+    encoder.WriteFeatures(features_).IgnoreError();
+  }
+
+  if (!received_ranges_.empty()) {
+    std::array<uint64_t, ByteRangeSet::kCapacity * 2> ranges;
+    encoder
+        .WriteReceivedRanges(FlattenReceivedRanges(received_ranges_, ranges))
+        .IgnoreError();
+  }
+
   PW_TRY(encoder.status());
   return ConstByteSpan(encoder);
 }
@@ -377,6 +451,21 @@ size_t Chunk::EncodedSize() const {
                                         status_.value().code());
   }
 
+  if (features_ != 0) {
+    size +=
+        protobuf::SizeOfVarintField(ProtoChunk::Fields::kFeatures, features_);
+  }
+
+  if (!received_ranges_.empty()) {
+    size_t packed_size = 0;
+    for (const ByteRange& range : received_ranges_.ranges()) {
+      packed_size += varint::EncodedSize(range.start);
+      packed_size += varint::EncodedSize(range.end);
+    }
+    size += protobuf::SizeOfDelimitedField(ProtoChunk::Fields::kReceivedRanges,
+                                           packed_size);
+  }
+
   return size;
 }
 
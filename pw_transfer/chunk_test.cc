@@ -62,5 +62,56 @@ TEST(Chunk, EncodedSizeMatchesBuffer) {
   EXPECT_EQ(chunk.EncodedSize(), result->size_bytes());
 }
 
+TEST(Chunk, Features_RoundTrip) {
+  Chunk chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStartAck);
+  chunk.set_session_id(42).set_resource_id(7).set_features(
+      static_cast<uint32_t>(Chunk::Feature::kSelectiveRetransmit));
+
+  std::array<std::byte, 64> buffer;
+  auto result = chunk.Encode(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(chunk.EncodedSize(), result->size_bytes());
+
+  auto parsed = Chunk::Parse(*result);
+  ASSERT_EQ(parsed.status(), OkStatus());
+  EXPECT_TRUE(parsed->has_feature(Chunk::Feature::kSelectiveRetransmit));
+}
+
+TEST(Chunk, ReceivedRanges_RoundTrip) {
+  ByteRangeSet ranges;
+  ASSERT_TRUE(ranges.Add(512, 1024));
+  ASSERT_TRUE(ranges.Add(2048, 70000));
+
+  Chunk chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kParametersRetransmit);
+  chunk.set_session_id(42)
+      .set_offset(256)
+      .set_window_end_offset(80000)
+      .set_received_ranges(ranges);
+
+  std::array<std::byte, 64> buffer;
+  auto result = chunk.Encode(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(chunk.EncodedSize(), result->size_bytes());
+
+  auto parsed = Chunk::Parse(*result);
+  ASSERT_EQ(parsed.status(), OkStatus());
+  EXPECT_FALSE(parsed->has_feature(Chunk::Feature::kSelectiveRetransmit));
+
+  const ByteRangeSet& parsed_ranges = parsed->received_ranges();
+  ASSERT_EQ(parsed_ranges.size(), 2u);
+  EXPECT_EQ(parsed_ranges.ranges()[0].start, 512u);
+  EXPECT_EQ(parsed_ranges.ranges()[0].end, 1024u);
+  EXPECT_EQ(parsed_ranges.ranges()[1].start, 2048u);
+  EXPECT_EQ(parsed_ranges.ranges()[1].end, 70000u);
+}
+
+TEST(Chunk, ReceivedRanges_InvalidRangeIsDataLoss) {
+  // received_ranges = [300, 200]
+  constexpr auto kMessage =
+      bytes::Array<0x60, 0x2a, 0x82, 0x01, 0x04, 0xac, 0x02, 0xc8, 0x01>();
+
+  EXPECT_EQ(Chunk::Parse(kMessage).status(), Status::DataLoss());
+}
+
 }  // namespace
 }  // namespace pw::transfer::internal
@@ -25,12 +25,18 @@ Status Client::Read(uint32_t resource_id,
                     CompletionFunc&& on_completion,
                     chrono::SystemClock::duration timeout,
                     chrono::SystemClock::duration initial_chunk_timeout,
-                    ProtocolVersion protocol_version) {
+                    ProtocolVersion protocol_version,
+                    uint32_t initial_offset) {
   if (on_completion == nullptr ||
       protocol_version == ProtocolVersion::kUnknown) {
     return Status::InvalidArgument();
   }
 
+  // Legacy transfers have no way to ask the server to start at an offset.
+  if (protocol_version == ProtocolVersion::kLegacy && initial_offset != 0u) {
+    return Status::InvalidArgument();
+  }
+
   if (!has_read_stream_) {
     rpc::RawClientReaderWriter read_stream = client_.Read(
         [this](ConstByteSpan chunk) {
@@ -52,7 +58,8 @@ Status Client::Read(uint32_t resource_id,
                                        timeout,
                                        initial_chunk_timeout,
                                        max_retries_,
-                                       max_lifetime_retries_);
+                                       max_lifetime_retries_,
+                                       initial_offset);
   return OkStatus();
 }
 
@@ -2588,5 +2588,124 @@ TEST_F(WriteTransfer, Version2_ServerErrorDuringHandshake) {
   EXPECT_EQ(transfer_status, Status::NotFound());
 }
 
+TEST_F(ReadTransfer, Version2_ResumesAtInitialOffset) {
+  stream::MemoryWriterBuffer<64> writer;
+  ASSERT_EQ(OkStatus(), writer.Write(span(kData32).first(16)));
+  Status transfer_status = Status::Unknown();
+
+  ASSERT_EQ(OkStatus(),
+            client_.Read(
+                3,
+                writer,
+                [&transfer_status](Status status) { transfer_status = status; },
+                cfg::kDefaultChunkTimeout,
+                cfg::kDefaultChunkTimeout,
+                ProtocolVersion::kVersionTwo,
+                /*initial_offset=*/16));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  rpc::PayloadsView payloads =
+      context_.output().payloads<Transfer::Read>(context_.channel().id());
+  ASSERT_EQ(payloads.size(), 1u);
+
+  Chunk chunk = DecodeChunk(payloads[0]);
+  EXPECT_EQ(chunk.type(), Chunk::Type::kStart);
+  EXPECT_TRUE(chunk.has_feature(Chunk::Feature::kResume));
+  EXPECT_EQ(chunk.offset(), 16u);
+
+  context_.server().SendServerStream<Transfer::Read>(
+      EncodeChunk(Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStartAck)
+                      .set_session_id(1)
+                      .set_resource_id(3)
+                      .set_features(static_cast<uint32_t>(
+                          Chunk::Feature::kResume))));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  // The client asks the server to start at the initial offset.
+  ASSERT_EQ(payloads.size(), 2u);
+  chunk = DecodeChunk(payloads.back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kStartAckConfirmation);
+  EXPECT_EQ(chunk.offset(), 16u);
+  EXPECT_EQ(chunk.window_end_offset(), 64u);
+
+  context_.server().SendServerStream<Transfer::Read>(
+      EncodeChunk(Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kData)
+                      .set_session_id(1)
+                      .set_offset(16)
+                      .set_payload(span(kData32).subspan(16))
+                      .set_remaining_bytes(0)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(payloads.size(), 3u);
+  chunk = DecodeChunk(payloads.back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kCompletion);
+  ASSERT_TRUE(chunk.status().has_value());
+  EXPECT_EQ(chunk.status().value(), OkStatus());
+
+  EXPECT_EQ(transfer_status, OkStatus());
+  ASSERT_EQ(writer.bytes_written(), kData32.size());
+  EXPECT_EQ(std::memcmp(writer.data(), kData32.data(), kData32.size()), 0);
+
+  context_.server().SendServerStream<Transfer::Read>(EncodeChunk(
+      Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kCompletionAck)
+          .set_session_id(1)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+}
+
+TEST_F(ReadTransfer, Legacy_InitialOffset_InvalidArgument) {
+  stream::MemoryWriterBuffer<64> writer;
+  ASSERT_EQ(OkStatus(), writer.Write(span(kData32).first(16)));
+
+  EXPECT_EQ(Status::InvalidArgument(),
+            client_.Read(
+                3,
+                writer,
+                [](Status) {},
+                cfg::kDefaultChunkTimeout,
+                cfg::kDefaultChunkTimeout,
+                ProtocolVersion::kLegacy,
+                /*initial_offset=*/16));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  // No transfer is started.
+  EXPECT_EQ(0u,
+            context_.output()
+                .payloads<Transfer::Read>(context_.channel().id())
+                .size());
+}
+
+TEST_F(ReadTransfer, Version2_ServerCannotResume) {
+  stream::MemoryWriterBuffer<64> writer;
+  ASSERT_EQ(OkStatus(), writer.Write(span(kData32).first(16)));
+  Status transfer_status = Status::Unknown();
+
+  ASSERT_EQ(OkStatus(),
+            client_.Read(
+                3,
+                writer,
+                [&transfer_status](Status status) { transfer_status = status; },
+                cfg::kDefaultChunkTimeout,
+                cfg::kDefaultChunkTimeout,
+                ProtocolVersion::kVersionTwo,
+                /*initial_offset=*/16));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  // The server does not enable resuming, so the client ends the transfer.
+  context_.server().SendServerStream<Transfer::Read>(
+      EncodeChunk(Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStartAck)
+                      .set_session_id(1)
+                      .set_resource_id(3)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  rpc::PayloadsView payloads =
+      context_.output().payloads<Transfer::Read>(context_.channel().id());
+  ASSERT_EQ(payloads.size(), 2u);
+  Chunk chunk = DecodeChunk(payloads.back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kCompletion);
+  ASSERT_TRUE(chunk.status().has_value());
+  EXPECT_EQ(chunk.status().value(), Status::Unimplemented());
+  EXPECT_EQ(transfer_status, Status::Unimplemented());
+}
+
 }  // namespace
 }  // namespace pw::transfer::test
@@ -0,0 +1,183 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/congestion_control.h"
+
+#include <algorithm>
+
+namespace pw::transfer {
+namespace {
+
+uint32_t MinChunkSize(const CongestionState& state) {
+  return std::min(CongestionController::kMinChunkSizeBytes,
+                  state.max_chunk_size_bytes);
+}
+
+// Keeps the window between one chunk and the maximum window size.
+void ClampWindow(CongestionState& state) {
+  state.chunk_size_bytes = std::clamp(
+      state.chunk_size_bytes, MinChunkSize(state), state.max_chunk_size_bytes);
+  state.window_size_bytes =
+      std::max(state.window_size_bytes,
+               std::min(state.chunk_size_bytes, state.max_window_size_bytes));
+  state.window_size_bytes =
+      std::min(state.window_size_bytes, state.max_window_size_bytes);
+}
+
+uint32_t SaturatingAdd(uint32_t lhs, uint32_t rhs) {
+  const uint64_t sum = static_cast<uint64_t>(lhs) + rhs;
+  return static_cast<uint32_t>(std::min<uint64_t>(sum, UINT32_MAX));
+}
+
+}  // namespace
+
+void CongestionController::Start(CongestionState& state,
+                                 uint32_t max_window_size_bytes,
+                                 uint32_t max_chunk_size_bytes) const {
+  state = {};
+  state.max_window_size_bytes = max_window_size_bytes;
+  state.max_chunk_size_bytes = max_chunk_size_bytes;
+  state.chunk_size_bytes = max_chunk_size_bytes;
+  state.slow_start_threshold_bytes = max_window_size_bytes;
+
+  const uint64_t initial_window =
+      static_cast<uint64_t>(initial_window_chunks_) * max_chunk_size_bytes;
+  state.window_size_bytes = static_cast<uint32_t>(
+      std::min<uint64_t>(initial_window, max_window_size_bytes));
+
+  ClampWindow(state);
+}
+
+void CongestionController::OnProgress(CongestionState& state,
+                                      const CongestionSample& sample) const {
+  if (sample.rtt_us != 0) {
+    state.last_rtt_us = sample.rtt_us;
+    if (state.min_rtt_us == 0 || sample.rtt_us < state.min_rtt_us) {
+      state.min_rtt_us = sample.rtt_us;
+    }
+    // Smooth the round trip time as TCP does, with a gain of 1/8.
+    state.smoothed_rtt_us =
+        state.smoothed_rtt_us == 0
+            ? sample.rtt_us
+            : static_cast<uint32_t>(
+                  (static_cast<uint64_t>(state.smoothed_rtt_us) * 7 +
+                   sample.rtt_us) /
+                  8);
+  }
+  state.rate_bytes_per_second = sample.rate_bytes_per_second;
+
+  DoProgress(state, sample);
+  ClampWindow(state);
+}
+
+void CongestionController::OnLoss(CongestionState& state) const {
+  state.losses += 1;
+  DoLoss(state);
+  ClampWindow(state);
+}
+
+void CongestionController::GrowChunkSize(CongestionState& state) {
+  state.chunk_size_bytes = static_cast<uint32_t>(
+      std::min<uint64_t>(static_cast<uint64_t>(state.chunk_size_bytes) * 2,
+                         state.max_chunk_size_bytes));
+}
+
+void AimdCongestionController::DoProgress(
+    CongestionState& state, const CongestionSample& sample) const {
+  if (state.window_size_bytes < state.slow_start_threshold_bytes) {
+    // Slow start: growing by the acknowledged bytes doubles the window each
+    // round trip.
+    state.window_size_bytes =
+        SaturatingAdd(state.window_size_bytes, sample.bytes_received);
+  } else {
+    // Congestion avoidance: grow by about one chunk per window.
+    const uint64_t increase =
+        static_cast<uint64_t>(state.chunk_size_bytes) * sample.bytes_received /
+        std::max<uint32_t>(state.window_size_bytes, 1);
+    state.window_size_bytes = SaturatingAdd(
+        state.window_size_bytes,
+        static_cast<uint32_t>(std::clamp<uint64_t>(increase, 1, UINT32_MAX)));
+  }
+
+  GrowChunkSize(state);
+}
+
+void AimdCongestionController::DoLoss(CongestionState& state) const {
+  if (state.window_size_bytes <= state.chunk_size_bytes) {
+    // The window can't shrink further, so send smaller chunks, which are less
+    // likely to be dropped.
+    state.chunk_size_bytes = state.chunk_size_bytes / 2;
+  }
+
+  state.slow_start_threshold_bytes =
+      std::max(state.window_size_bytes / 2, MinChunkSize(state));
+  state.window_size_bytes = state.slow_start_threshold_bytes;
+}
+
+void RttCongestionController::DoProgress(
+    CongestionState& state, const CongestionSample& sample) const {
+  if (state.min_rtt_us == 0 || state.smoothed_rtt_us == 0) {
+    // No round trip has been measured yet.
+    AimdCongestionController::DoProgress(state, sample);
+    return;
+  }
+
+  const uint32_t previous_window = state.window_size_bytes;
+
+  // Bytes queued in the link, from the window's expected and actual rates:
+  // window / min_rtt - window / rtt, over min_rtt.
+  const uint64_t rtt_increase = state.smoothed_rtt_us > state.min_rtt_us
+                                    ? state.smoothed_rtt_us - state.min_rtt_us
+                                    : 0;
+  const uint64_t queued_bytes =
+      static_cast<uint64_t>(state.window_size_bytes) * rtt_increase /
+      state.smoothed_rtt_us;
+
+  const uint64_t alpha =
+      static_cast<uint64_t>(alpha_chunks_) * state.chunk_size_bytes;
+  const uint64_t beta =
+      static_cast<uint64_t>(beta_chunks_) * state.chunk_size_bytes;
+
+  if (queued_bytes < alpha) {
+    if (state.window_size_bytes < state.slow_start_threshold_bytes) {
+      state.window_size_bytes =
+          SaturatingAdd(state.window_size_bytes, sample.bytes_received);
+    } else {
+      state.window_size_bytes =
+          SaturatingAdd(state.window_size_bytes, state.chunk_size_bytes);
+    }
+  } else if (queued_bytes > beta) {
+    state.window_size_bytes -=
+        std::min(state.window_size_bytes, state.chunk_size_bytes);
+    state.slow_start_threshold_bytes =
+        std::min(state.slow_start_threshold_bytes, state.window_size_bytes);
+  }
+
+  // Don't grow the window beyond twice the measured bandwidth-delay product.
+  if (state.rate_bytes_per_second != 0 &&
+      state.window_size_bytes > previous_window) {
+    constexpr uint64_t kMicrosecondsPerSecond = 1'000'000;
+    const uint64_t bandwidth_delay_product =
+        static_cast<uint64_t>(state.rate_bytes_per_second) * state.min_rtt_us /
+        kMicrosecondsPerSecond;
+    const uint64_t limit = std::max<uint64_t>(2 * bandwidth_delay_product,
+                                              previous_window);
+    state.window_size_bytes = static_cast<uint32_t>(
+        std::min<uint64_t>(state.window_size_bytes, limit));
+  }
+
+  GrowChunkSize(state);
+}
+
+}  // namespace pw::transfer
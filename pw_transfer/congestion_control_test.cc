@@ -0,0 +1,162 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/congestion_control.h"
+
+#include "gtest/gtest.h"
+
+namespace pw::transfer {
+namespace {
+
+constexpr uint32_t kMaxWindow = 1024;
+constexpr uint32_t kMaxChunk = 64;
+
+CongestionSample Received(uint32_t bytes, uint32_t rtt_us = 0) {
+  return {
+      .bytes_received = bytes, .rtt_us = rtt_us, .rate_bytes_per_second = 0};
+}
+
+TEST(AimdCongestionController, Start_InitialWindow) {
+  AimdCongestionController controller(2);
+  CongestionState state;
+  controller.Start(state, kMaxWindow, kMaxChunk);
+
+  EXPECT_EQ(state.window_size_bytes, 2 * kMaxChunk);
+  EXPECT_EQ(state.chunk_size_bytes, kMaxChunk);
+  EXPECT_EQ(state.slow_start_threshold_bytes, kMaxWindow);
+  EXPECT_EQ(state.losses, 0u);
+}
+
+TEST(AimdCongestionController, Start_WindowLimitedToMax) {
+  AimdCongestionController controller(100);
+  CongestionState state;
+  controller.Start(state, kMaxWindow, kMaxChunk);
+
+  EXPECT_EQ(state.window_size_bytes, kMaxWindow);
+}
+
+TEST(AimdCongestionController, SlowStart_DoublesEachWindow) {
+  AimdCongestionController controller(1);
+  CongestionState state;
+  controller.Start(state, kMaxWindow, kMaxChunk);
+
+  controller.OnProgress(state, Received(state.window_size_bytes));
+  EXPECT_EQ(state.window_size_bytes, 2 * kMaxChunk);
+  controller.OnProgress(state, Received(state.window_size_bytes));
+  EXPECT_EQ(state.window_size_bytes, 4 * kMaxChunk);
+
+  for (int i = 0; i < 10; ++i) {
+    controller.OnProgress(state, Received(state.window_size_bytes));
+  }
+  EXPECT_EQ(state.window_size_bytes, kMaxWindow);
+}
+
+TEST(AimdCongestionController, Loss_HalvesWindow) {
+  AimdCongestionController controller(8);
+  CongestionState state;
+  controller.Start(state, kMaxWindow, kMaxChunk);
+
+  controller.OnLoss(state);
+  EXPECT_EQ(state.window_size_bytes, 4 * kMaxChunk);
+  EXPECT_EQ(state.slow_start_threshold_bytes, 4 * kMaxChunk);
+  EXPECT_EQ(state.losses, 1u);
+
+  // Above the slow start threshold, the window grows by a chunk per window.
+  controller.OnProgress(state, Received(state.window_size_bytes));
+  EXPECT_EQ(state.window_size_bytes, 5 * kMaxChunk);
+}
+
+TEST(AimdCongestionController, LossAtMinimumWindow_ShrinksChunks) {
+  AimdCongestionController controller(1);
+  CongestionState state;
+  controller.Start(state, kMaxWindow, kMaxChunk);
+
+  controller.OnLoss(state);
+  EXPECT_EQ(state.chunk_size_bytes, kMaxChunk / 2);
+  EXPECT_EQ(state.window_size_bytes, kMaxChunk / 2);
+
+  controller.OnLoss(state);
+  controller.OnLoss(state);
+  EXPECT_EQ(state.chunk_size_bytes, CongestionController::kMinChunkSizeBytes);
+  EXPECT_GE(state.window_size_bytes, state.chunk_size_bytes);
+
+  // Chunks grow back as data arrives.
+  controller.OnProgress(state, Received(state.window_size_bytes));
+  EXPECT_EQ(state.chunk_size_bytes, kMaxChunk);
+}
+
+TEST(CongestionController, OnProgress_TracksRoundTripTime) {
+  AimdCongestionController controller;
+  CongestionState state;
+  controller.Start(state, kMaxWindow, kMaxChunk);
+
+  controller.OnProgress(state, Received(64, 800));
+  EXPECT_EQ(state.last_rtt_us, 800u);
+  EXPECT_EQ(state.min_rtt_us, 800u);
+  EXPECT_EQ(state.smoothed_rtt_us, 800u);
+
+  controller.OnProgress(state, Received(64, 1600));
+  EXPECT_EQ(state.last_rtt_us, 1600u);
+  EXPECT_EQ(state.min_rtt_us, 800u);
+  EXPECT_EQ(state.smoothed_rtt_us, 900u);
+
+  // Samples without a round trip leave the measurements alone.
+  controller.OnProgress(state, Received(64));
+  EXPECT_EQ(state.last_rtt_us, 1600u);
+}
+
+TEST(RttCongestionController, StableRtt_Grows) {
+  RttCongestionController controller(1, 3, 4);
+  CongestionState state;
+  controller.Start(state, kMaxWindow, kMaxChunk);
+  state.slow_start_threshold_bytes = 0;
+
+  controller.OnProgress(state, Received(state.window_size_bytes, 1000));
+  controller.OnProgress(state, Received(state.window_size_bytes, 1000));
+  EXPECT_EQ(state.window_size_bytes, 6 * kMaxChunk);
+}
+
+TEST(RttCongestionController, QueueingDelay_Shrinks) {
+  RttCongestionController controller(1, 3, 8);
+  CongestionState state;
+  controller.Start(state, kMaxWindow, kMaxChunk);
+  state.slow_start_threshold_bytes = 0;
+
+  controller.OnProgress(state, Received(state.window_size_bytes, 1000));
+  EXPECT_EQ(state.window_size_bytes, 9 * kMaxChunk);
+
+  // The round trip time doubles, so about half the window is queued.
+  for (int i = 0; i < 8; ++i) {
+    controller.OnProgress(state, Received(state.window_size_bytes, 3000));
+  }
+  EXPECT_LT(state.window_size_bytes, 9 * kMaxChunk);
+  EXPECT_EQ(state.losses, 0u);
+}
+
+TEST(RttCongestionController, LimitedByBandwidthDelayProduct) {
+  RttCongestionController controller(1, 3, 4);
+  CongestionState state;
+  controller.Start(state, kMaxWindow, kMaxChunk);
+
+  // 128 kB/s over a 1 ms round trip is a 128 B bandwidth-delay product.
+  controller.OnProgress(state,
+                        {.bytes_received = state.window_size_bytes,
+                         .rtt_us = 1000,
+                         .rate_bytes_per_second = 128'000});
+  EXPECT_EQ(state.window_size_bytes, 4 * kMaxChunk);
+  EXPECT_EQ(state.rate_bytes_per_second, 128'000u);
+}
+
+}  // namespace
+}  // namespace pw::transfer
@@ -16,6 +16,7 @@
 
 #include "pw_transfer/internal/context.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include "pw_assert/check.h"
@@ -87,12 +88,27 @@ void Context::HandleEvent(const Event& event) {
     case EventType::kAddTransferHandler:
     case EventType::kRemoveTransferHandler:
     case EventType::kTerminate:
+    case EventType::kFlushChunkQueue:
       // These events are intended for the transfer thread and should never be
       // forwarded through to a context.
       PW_CRASH("Transfer context received a transfer thread event");
   }
 }
 
+namespace {
+
+// Returns whether the START chunk of a new server transfer advertises support
+// for starting at a non-zero offset.
+bool ClientSupportsResume(const NewTransferEvent& new_transfer) {
+  Result<Chunk> chunk = Chunk::Parse(
+      ConstByteSpan(new_transfer.raw_chunk_data, new_transfer.raw_chunk_size));
+  return chunk.ok() && chunk->type() == Chunk::Type::kStart &&
+         chunk->protocol_version() >= ProtocolVersion::kVersionTwo &&
+         chunk->has_feature(Chunk::Feature::kResume);
+}
+
+}  // namespace
+
 void Context::InitiateTransferAsClient() {
   PW_DCHECK(active());
 
@@ -124,6 +140,7 @@ void Context::InitiateTransferAsClient() {
   Chunk start_chunk(desired_protocol_version_, Chunk::Type::kStart);
   start_chunk.set_desired_session_id(session_id_);
   start_chunk.set_resource_id(resource_id_);
+  start_chunk.set_features(LocalFeatures());
 
   if (type() == TransferType::kReceive) {
     // Parameters should still be set on the initial chunk for backwards
@@ -143,8 +160,23 @@ bool Context::StartTransferAsServer(const NewTransferEvent& new_transfer) {
 
   flags_ |= kFlagsContactMade;
 
-  if (Status status = new_transfer.handler->Prepare(new_transfer.type);
-      !status.ok()) {
+  Status status;
+  if (new_transfer.type == TransferType::kReceive &&
+      desired_protocol_version_ >= ProtocolVersion::kVersionTwo &&
+      ClientSupportsResume(new_transfer)) {
+    // Let the handler pick up an interrupted write where it left off.
+    Result<uint32_t> resume_offset =
+        new_transfer.handler->PrepareResumableWrite();
+    status = resume_offset.status();
+    if (status.ok()) {
+      offset_ = *resume_offset;
+      flags_ |= kFlagsResume;
+    }
+  } else {
+    status = new_transfer.handler->Prepare(new_transfer.type);
+  }
+
+  if (!status.ok()) {
     PW_LOG_WARN("Transfer handler %u prepare failed with status %u",
                 static_cast<unsigned>(new_transfer.handler->id()),
                 status.code());
@@ -166,6 +198,10 @@ bool Context::StartTransferAsServer(const NewTransferEvent& new_transfer) {
   // stream included in the NewTransferEvent.
   stream_ = &new_transfer.handler->stream();
 
+  if (new_transfer.type == TransferType::kTransmit) {
+    readable_memory_ = new_transfer.handler->ReadableMemory();
+  }
+
   return true;
 }
 
@@ -182,19 +218,36 @@ void Context::UpdateTransferParameters() {
   size_t pending_bytes =
       std::min(max_parameters_->pending_bytes(),
                static_cast<uint32_t>(writer().ConservativeWriteLimit()));
+  uint32_t max_chunk_size_bytes = max_parameters_->max_chunk_size_bytes();
+
+  if (max_parameters_->congestion_controller() != nullptr) {
+    pending_bytes =
+        std::min<size_t>(pending_bytes, congestion_state_.window_size_bytes);
+    max_chunk_size_bytes =
+        std::min(max_chunk_size_bytes, congestion_state_.chunk_size_bytes);
+  }
 
   window_size_ = pending_bytes;
   window_end_offset_ = offset_ + pending_bytes;
+  parameters_offset_ = offset_;
 
-  max_chunk_size_bytes_ = MaxWriteChunkSize(
-      max_parameters_->max_chunk_size_bytes(), rpc_writer_->channel_id());
+  // Forget any out-of-order data that no longer fits in the window. It is sent
+  // again once the window reaches it.
+  received_ranges_.Truncate(window_end_offset_);
+  if (final_offset_ > window_end_offset_) {
+    final_offset_ = 0;
+  }
+
+  max_chunk_size_bytes_ =
+      MaxWriteChunkSize(max_chunk_size_bytes, rpc_writer_->channel_id());
 }
 
 void Context::SetTransferParameters(Chunk& parameters) {
   parameters.set_window_end_offset(window_end_offset_)
       .set_max_chunk_size_bytes(max_chunk_size_bytes_)
       .set_min_delay_microseconds(kDefaultChunkDelayMicroseconds)
-      .set_offset(offset_);
+      .set_offset(offset_)
+      .set_received_ranges(received_ranges_);
 }
 
 void Context::UpdateAndSendTransferParameters(TransmitAction action) {
@@ -203,9 +256,58 @@ void Context::UpdateAndSendTransferParameters(TransmitAction action) {
   PW_LOG_INFO("Transfer rate: %u B/s",
               static_cast<unsigned>(transfer_rate_.GetRateBytesPerSecond()));
 
+  if (max_parameters_->congestion_controller() != nullptr) {
+    PW_LOG_DEBUG(
+        "Transfer %u congestion state: window=%u chunk=%u ssthresh=%u "
+        "srtt=%uus min_rtt=%uus losses=%u",
+        static_cast<unsigned>(session_id_),
+        static_cast<unsigned>(congestion_state_.window_size_bytes),
+        static_cast<unsigned>(congestion_state_.chunk_size_bytes),
+        static_cast<unsigned>(congestion_state_.slow_start_threshold_bytes),
+        static_cast<unsigned>(congestion_state_.smoothed_rtt_us),
+        static_cast<unsigned>(congestion_state_.min_rtt_us),
+        static_cast<unsigned>(congestion_state_.losses));
+  }
+
   return SendTransferParameters(action);
 }
 
+void Context::RecordCongestionProgress() {
+  const CongestionController* controller =
+      max_parameters_->congestion_controller();
+  if (controller == nullptr) {
+    return;
+  }
+
+  CongestionSample sample{
+      .bytes_received = offset_ - parameters_offset_,
+      .rtt_us = 0,
+      .rate_bytes_per_second = transfer_rate_.GetRateBytesPerSecond(),
+  };
+
+  if (parameters_sent_time_.has_value()) {
+    const auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+        chrono::SystemClock::now() - *parameters_sent_time_);
+    sample.rtt_us = static_cast<uint32_t>(std::clamp<int64_t>(
+        rtt.count(), 1, std::numeric_limits<uint32_t>::max()));
+    parameters_sent_time_.reset();
+  }
+
+  controller->OnProgress(congestion_state_, sample);
+}
+
+void Context::RecordCongestionLoss() {
+  const CongestionController* controller =
+      max_parameters_->congestion_controller();
+  if (controller == nullptr) {
+    return;
+  }
+
+  // A round trip can't be measured across a retransmission.
+  parameters_sent_time_.reset();
+  controller->OnLoss(congestion_state_);
+}
+
 void Context::SendTransferParameters(TransmitAction action) {
   Chunk::Type type = Chunk::Type::kParametersRetransmit;
 
@@ -225,6 +327,12 @@ void Context::SendTransferParameters(TransmitAction action) {
   parameters.set_session_id(session_id_);
   SetTransferParameters(parameters);
 
+  // Data is already in flight when a window is extended, so only time the
+  // round trip from parameters that start a new window.
+  if (action != TransmitAction::kExtend) {
+    parameters_sent_time_ = chrono::SystemClock::now();
+  }
+
   PW_LOG_DEBUG(
       "Transfer %u sending transfer parameters: "
       "offset=%u, window_end_offset=%u, max_chunk_size=%u",
@@ -292,8 +400,9 @@ void Context::Initialize(const NewTransferEvent& new_transfer) {
 
   rpc_writer_ = new_transfer.rpc_writer;
   stream_ = new_transfer.stream;
+  readable_memory_ = ConstByteSpan();
 
-  offset_ = 0;
+  offset_ = new_transfer.initial_offset;
   window_size_ = 0;
   window_end_offset_ = 0;
   max_chunk_size_bytes_ = new_transfer.max_parameters->max_chunk_size_bytes();
@@ -310,6 +419,19 @@ void Context::Initialize(const NewTransferEvent& new_transfer) {
   next_timeout_ = kNoTimeout;
 
   transfer_rate_.Reset();
+
+  congestion_state_ = {};
+  parameters_offset_ = 0;
+  parameters_sent_time_.reset();
+  received_ranges_.clear();
+  final_offset_ = 0;
+  if (const CongestionController* controller =
+          max_parameters_->congestion_controller();
+      controller != nullptr && type() == TransferType::kReceive) {
+    controller->Start(congestion_state_,
+                      max_parameters_->pending_bytes(),
+                      max_parameters_->max_chunk_size_bytes());
+  }
 }
 
 void Context::HandleChunkEvent(const ChunkEvent& event) {
@@ -353,7 +475,9 @@ void Context::PerformInitialHandshake(const Chunk& chunk) {
       uint32_t resource_id = static_cast<ServerContext&>(*this).handler()->id();
 
       Chunk start_ack(configured_protocol_version_, Chunk::Type::kStartAck);
-      start_ack.set_session_id(session_id_).set_resource_id(resource_id);
+      start_ack.set_session_id(session_id_)
+          .set_resource_id(resource_id)
+          .set_features(NegotiatedFeatures());
 
       EncodeAndSendChunk(start_ack);
       break;
@@ -364,6 +488,14 @@ void Context::PerformInitialHandshake(const Chunk& chunk) {
     case Chunk::Type::kStartAck: {
       UpdateLocalProtocolConfigurationFromPeer(chunk);
 
+      if (offset_ != 0 && !resume()) {
+        PW_LOG_WARN("Transfer %u: server cannot resume at offset %u",
+                    id_for_log(),
+                    static_cast<unsigned>(offset_));
+        TerminateTransfer(Status::Unimplemented());
+        return;
+      }
+
       Chunk start_ack_confirmation(configured_protocol_version_,
                                    Chunk::Type::kStartAckConfirmation);
       start_ack_confirmation.set_session_id(session_id_);
@@ -387,6 +519,18 @@ void Context::PerformInitialHandshake(const Chunk& chunk) {
     case Chunk::Type::kStartAckConfirmation: {
       set_transfer_state(TransferState::kWaiting);
 
+      if (type() == TransferType::kReceive && offset_ != 0) {
+        // The handler resumed a previous write. Ask the client to continue
+        // from where it left off instead of processing the confirmation's
+        // offset.
+        PW_LOG_INFO("Transfer %u: resuming at offset %u",
+                    id_for_log(),
+                    static_cast<unsigned>(offset_));
+        SetTimeout(chunk_timeout_);
+        UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
+        break;
+      }
+
       if (type() == TransferType::kTransmit) {
         HandleTransmitChunk(chunk);
       } else {
@@ -442,6 +586,44 @@ void Context::UpdateLocalProtocolConfigurationFromPeer(const Chunk& chunk) {
   PW_LOG_INFO("Transfer %u: using protocol version %d",
               id_for_log(),
               static_cast<int>(configured_protocol_version_));
+
+  // Protocol features are only enabled if both ends of the transfer support
+  // them. A server replies with the features it enabled, which the client then
+  // adopts.
+  if (configured_protocol_version_ >= ProtocolVersion::kVersionTwo &&
+      chunk.has_feature(Chunk::Feature::kSelectiveRetransmit) &&
+      (LocalFeatures() &
+       static_cast<uint32_t>(Chunk::Feature::kSelectiveRetransmit)) != 0) {
+    flags_ |= kFlagsSelectiveRetransmit;
+    PW_LOG_DEBUG("Transfer %u: selective retransmission enabled",
+                 id_for_log());
+  }
+
+  if (configured_protocol_version_ >= ProtocolVersion::kVersionTwo &&
+      chunk.has_feature(Chunk::Feature::kResume) &&
+      (LocalFeatures() & static_cast<uint32_t>(Chunk::Feature::kResume)) !=
+          0) {
+    flags_ |= kFlagsResume;
+  }
+}
+
+uint32_t Context::LocalFeatures() const {
+  const bool seekable = !readable_memory_.empty() ||
+                        stream_->seekable(stream::Stream::kBeginning);
+  uint32_t features = 0;
+
+  // Selective retransmission reads or writes data out of order, so it requires
+  // a seekable stream.
+  if (seekable && ByteRangeSet::kCapacity != 0) {
+    features |= static_cast<uint32_t>(Chunk::Feature::kSelectiveRetransmit);
+  }
+
+  // Starting a transmit transfer at a non-zero offset requires seeking. A
+  // receiver only has to accept the offset it asked for.
+  if (seekable || type() == TransferType::kReceive) {
+    features |= static_cast<uint32_t>(Chunk::Feature::kResume);
+  }
+  return features;
 }
 
 void Context::HandleTransmitChunk(const Chunk& chunk) {
@@ -496,35 +678,25 @@ void Context::HandleTransferParametersUpdate(const Chunk& chunk) {
     // If the offsets don't match, attempt to seek on the reader. Not all
     // readers support seeking; abort with UNIMPLEMENTED if this handler
     // doesn't.
-    if (offset_ != chunk.offset()) {
-      if (Status seek_status = reader().Seek(chunk.offset());
-          !seek_status.ok()) {
-        PW_LOG_WARN("Transfer %u seek to %u failed with status %u",
-                    static_cast<unsigned>(session_id_),
-                    static_cast<unsigned>(chunk.offset()),
-                    seek_status.code());
-
-        // Remap status codes to return one of the following:
-        //
-        //   INTERNAL: invalid seek, never should happen
-        //   DATA_LOSS: the reader is in a bad state
-        //   UNIMPLEMENTED: seeking is not supported
-        //
-        if (seek_status.IsOutOfRange()) {
-          seek_status = Status::Internal();
-        } else if (!seek_status.IsUnimplemented()) {
-          seek_status = Status::DataLoss();
-        }
-
-        TerminateTransfer(seek_status);
-        return;
-      }
+    if (offset_ != chunk.offset() && !SeekReader(chunk.offset())) {
+      return;
     }
 
     offset_ = chunk.offset();
+
+    // With selective retransmission, the receiver lists the data it already
+    // has beyond the offset, which doesn't need to be sent again.
+    if (selective_retransmit()) {
+      received_ranges_ = chunk.received_ranges();
+    }
   }
 
   window_end_offset_ = chunk.window_end_offset();
+  received_ranges_.Truncate(window_end_offset_);
+
+  if (!SkipReceivedRanges()) {
+    return;
+  }
 
   if (chunk.max_chunk_size_bytes().has_value()) {
     max_chunk_size_bytes_ = std::min(chunk.max_chunk_size_bytes().value(),
@@ -549,6 +721,82 @@ void Context::HandleTransferParametersUpdate(const Chunk& chunk) {
   TransmitNextChunk(retransmit);
 }
 
+bool Context::SeekReader(uint32_t offset) {
+  Status seek_status = SeekData(offset);
+  if (seek_status.ok()) {
+    return true;
+  }
+
+  PW_LOG_WARN("Transfer %u seek to %u failed with status %u",
+              static_cast<unsigned>(session_id_),
+              static_cast<unsigned>(offset),
+              seek_status.code());
+
+  // Remap status codes to return one of the following:
+  //
+  //   INTERNAL: invalid seek, never should happen
+  //   DATA_LOSS: the reader is in a bad state
+  //   UNIMPLEMENTED: seeking is not supported
+  //
+  if (seek_status.IsOutOfRange()) {
+    seek_status = Status::Internal();
+  } else if (!seek_status.IsUnimplemented()) {
+    seek_status = Status::DataLoss();
+  }
+
+  TerminateTransfer(seek_status);
+  return false;
+}
+
+Status Context::SeekData(uint32_t offset) {
+  if (readable_memory_.empty()) {
+    return reader().Seek(offset);
+  }
+  return offset <= readable_memory_.size() ? OkStatus() : Status::OutOfRange();
+}
+
+Result<ConstByteSpan> Context::ReadData(ByteSpan buffer) {
+  if (readable_memory_.empty()) {
+    Result<ByteSpan> data = reader().Read(buffer);
+    if (!data.ok()) {
+      return data.status();
+    }
+    return ConstByteSpan(*data);
+  }
+
+  // Behave like a stream::Reader, which returns OUT_OF_RANGE once there is no
+  // more data to read. Only the buffer's size is used; the chunk payload points
+  // straight at the readable memory.
+  if (offset_ >= readable_memory_.size()) {
+    return Status::OutOfRange();
+  }
+  ConstByteSpan data = readable_memory_.subspan(offset_);
+  return data.first(std::min(data.size(), buffer.size()));
+}
+
+bool Context::SkipReceivedRanges() {
+  if (received_ranges_.empty()) {
+    return true;
+  }
+
+  const uint32_t next_offset = received_ranges_.Advance(offset_);
+  if (next_offset == offset_) {
+    return true;
+  }
+
+  PW_LOG_DEBUG("Transfer %u skipping received data from offset %u to %u",
+               id_for_log(),
+               static_cast<unsigned>(offset_),
+               static_cast<unsigned>(next_offset));
+
+  if (!SeekReader(next_offset)) {
+    return false;
+  }
+
+  offset_ = next_offset;
+  return true;
+}
+
 void Context::TransmitNextChunk(bool retransmit_requested) {
   Chunk chunk(configured_protocol_version_, Chunk::Type::kData);
   chunk.set_session_id(session_id_);
@@ -565,11 +813,17 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
   size_t max_bytes_to_send =
       std::min(window_end_offset_ - offset_, max_chunk_size_bytes_);
 
+  // Stop at the start of the next range that the receiver already has.
+  if (!received_ranges_.empty()) {
+    max_bytes_to_send = std::min<size_t>(
+        max_bytes_to_send, received_ranges_.front().start - offset_);
+  }
+
   if (max_bytes_to_send < data_buffer.size()) {
     data_buffer = data_buffer.first(max_bytes_to_send);
   }
 
-  Result<ByteSpan> data = reader().Read(data_buffer);
+  Result<ConstByteSpan> data = ReadData(data_buffer);
   if (data.status().IsOutOfRange()) {
     // No more data to read.
     chunk.set_remaining_bytes(0);
@@ -630,6 +884,10 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
   last_chunk_sent_ = chunk.type();
   flags_ |= kFlagsDataSent;
 
+  if (!SkipReceivedRanges()) {
+    return;
+  }
+
   if (offset_ == window_end_offset_) {
     // Sent all requested data. Must now wait for next parameters from the
     // receiver.
@@ -719,6 +977,11 @@ void Context::HandleReceiveChunk(const Chunk& chunk) {
 }
 
 void Context::HandleReceivedData(const Chunk& chunk) {
+  if (chunk.offset() > offset_ && selective_retransmit()) {
+    HandleOutOfOrderData(chunk);
+    return;
+  }
+
   if (chunk.offset() != offset_) {
     // Bad offset; reset pending_bytes to send another parameters chunk.
     PW_LOG_DEBUG(
@@ -730,6 +993,7 @@ void Context::HandleReceivedData(const Chunk& chunk) {
     set_transfer_state(TransferState::kRecovery);
     SetTimeout(chunk_timeout_);
 
+    RecordCongestionLoss();
     UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
     return;
   }
@@ -752,19 +1016,8 @@ void Context::HandleReceivedData(const Chunk& chunk) {
   last_chunk_offset_ = chunk.offset();
 
   // Write staged data from the buffer to the stream.
-  if (chunk.has_payload()) {
-    if (Status status = writer().Write(chunk.payload()); !status.ok()) {
-      PW_LOG_ERROR(
-          "Transfer %u write of %u B chunk failed with status %u; aborting "
-          "with DATA_LOSS",
-          static_cast<unsigned>(session_id_),
-          static_cast<unsigned>(chunk.payload().size()),
-          status.code());
-      TerminateTransfer(Status::DataLoss());
-      return;
-    }
-
-    transfer_rate_.Update(chunk.payload().size());
+  if (!WriteChunkData(chunk)) {
+    return;
   }
 
   // When the client sets remaining_bytes to 0, it indicates completion of the
@@ -777,6 +1030,21 @@ void Context::HandleReceivedData(const Chunk& chunk) {
   // Update the transfer state.
   offset_ += chunk.payload().size();
 
+  // Filling a gap may join the data up with ranges that arrived out of order.
+  if (!received_ranges_.empty()) {
+    const uint32_t next_offset = received_ranges_.Advance(offset_);
+    if (next_offset != offset_) {
+      offset_ = next_offset;
+      flags_ |= kFlagsSeekRequired;
+    }
+  }
+
+  if (final_offset_ != 0 && offset_ >= final_offset_) {
+    // All data up to an out-of-order final chunk has now been received.
+    TerminateTransfer(OkStatus());
+    return;
+  }
+
   if (chunk.window_end_offset() != 0) {
     if (chunk.window_end_offset() < offset_) {
       PW_LOG_ERROR(
@@ -809,22 +1077,112 @@ void Context::HandleReceivedData(const Chunk& chunk) {
 
   if (offset_ == window_end_offset_) {
     // Received all pending data. Advance the transfer parameters.
+    RecordCongestionProgress();
     UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
     return;
   }
 
   // Once the transmitter has sent a sufficient amount of data, try to extend
-  // the window to allow it to continue sending data without blocking.
+  // the window to allow it to continue sending data without blocking. Missing
+  // data is requested at the end of the window instead, so the window is not
+  // extended while there are gaps in it.
   uint32_t remaining_window_size = window_end_offset_ - offset_;
-  bool extend_window = remaining_window_size <=
-                       window_size_ / max_parameters_->extend_window_divisor();
+  bool extend_window =
+      received_ranges_.empty() &&
+      remaining_window_size <=
+          window_size_ / max_parameters_->extend_window_divisor();
 
   if (extend_window) {
+    RecordCongestionProgress();
     UpdateAndSendTransferParameters(TransmitAction::kExtend);
     return;
   }
 }
 
+void Context::HandleOutOfOrderData(const Chunk& chunk) {
+  const uint32_t end_offset = chunk.offset() + chunk.payload().size();
+
+  if (end_offset > window_end_offset_) {
+    // Data beyond the window may have been sent against a previous, larger
+    // window. It will be sent again once the window reaches it.
+    PW_LOG_DEBUG("Transfer %u dropping chunk [%u, %u) outside of window",
+                 id_for_log(),
+                 static_cast<unsigned>(chunk.offset()),
+                 static_cast<unsigned>(end_offset));
+    SetTimeout(chunk_timeout_);
+    return;
+  }
+
+  PW_LOG_DEBUG("Transfer %u expected offset %u, received [%u, %u)",
+               id_for_log(),
+               static_cast<unsigned>(offset_),
+               static_cast<unsigned>(chunk.offset()),
+               static_cast<unsigned>(end_offset));
+
+  if (!received_ranges_.Add(chunk.offset(), end_offset)) {
+    // There is no room to track the range, so the data will be retransmitted
+    // with the rest of the gap.
+    PW_LOG_DEBUG("Transfer %u has no room for another received range",
+                 id_for_log());
+  } else if (!WriteChunkData(chunk)) {
+    return;
+  }
+
+  if (chunk.IsFinalTransmitChunk()) {
+    final_offset_ = end_offset;
+  }
+
+  last_chunk_offset_ = chunk.offset();
+  SetTimeout(chunk_timeout_);
+
+  // Once the transmitter has sent all of the data it was asked for, request
+  // only the data which is missing.
+  if (end_offset == window_end_offset_ || chunk.IsFinalTransmitChunk()) {
+    RecordCongestionLoss();
+    UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
+  }
+}
+
+bool Context::WriteChunkData(const Chunk& chunk) {
+  if (!chunk.has_payload()) {
+    return true;
+  }
+
+  // The stream is positioned after the most recent write. Seek if the data
+  // does not immediately follow it.
+  if (chunk.offset() != offset_ || (flags_ & kFlagsSeekRequired) != 0) {
+    if (Status status = writer().Seek(chunk.offset()); !status.ok()) {
+      PW_LOG_ERROR(
+          "Transfer %u seek to %u failed with status %u; aborting with "
+          "DATA_LOSS",
+          id_for_log(),
+          static_cast<unsigned>(chunk.offset()),
+          status.code());
+      TerminateTransfer(Status::DataLoss());
+      return false;
+    }
+    flags_ &= static_cast<uint8_t>(~kFlagsSeekRequired);
+  }
+
+  if (Status status = writer().Write(chunk.payload()); !status.ok()) {
+    PW_LOG_ERROR(
+        "Transfer %u write of %u B chunk failed with status %u; aborting "
+        "with DATA_LOSS",
+        static_cast<unsigned>(session_id_),
+        static_cast<unsigned>(chunk.payload().size()),
+        status.code());
+    TerminateTransfer(Status::DataLoss());
+    return false;
+  }
+
+  if (chunk.offset() != offset_) {
+    flags_ |= kFlagsSeekRequired;
+  }
+
+  transfer_rate_.Update(chunk.payload().size());
+  return true;
+}
+
 void Context::HandleTerminatingChunk(const Chunk& chunk) {
   switch (chunk.type()) {
     case Chunk::Type::kCompletion:
@@ -1005,6 +1363,11 @@ void Context::Retry() {
         "Receive transfer %u timed out waiting for chunk; resending parameters",
         static_cast<unsigned>(session_id_));
 
+    if (max_parameters_->congestion_controller() != nullptr) {
+      // A timeout indicates the link is congested; shrink the window.
+      RecordCongestionLoss();
+      UpdateTransferParameters();
+    }
     SendTransferParameters(TransmitAction::kRetransmit);
     return;
   }
@@ -1021,7 +1384,7 @@ void Context::Retry() {
 
   // Otherwise, resend the most recent chunk. If the reader doesn't support
   // seeking, this isn't possible, so just terminate the transfer immediately.
-  if (!reader().Seek(last_chunk_offset_).ok()) {
+  if (!SeekData(last_chunk_offset_).ok()) {
     PW_LOG_ERROR("Transmit transfer %u timed out waiting for new parameters.",
                  id_for_log());
     PW_LOG_ERROR("Retrying requires a seekable reader. Alas, ours is not.");
@@ -1044,7 +1407,8 @@ void Context::RetryHandshake() {
       // chunk, so we use the client's desired version instead.
       retry_chunk.set_protocol_version(desired_protocol_version_)
           .set_desired_session_id(session_id_)
-          .set_resource_id(resource_id_);
+          .set_resource_id(resource_id_)
+          .set_features(LocalFeatures());
       if (type() == TransferType::kReceive) {
         SetTransferParameters(retry_chunk);
       }
@@ -1052,7 +1416,8 @@ void Context::RetryHandshake() {
 
     case Chunk::Type::kStartAck:
       retry_chunk.set_session_id(session_id_)
-          .set_resource_id(static_cast<ServerContext&>(*this).handler()->id());
+          .set_resource_id(static_cast<ServerContext&>(*this).handler()->id())
+          .set_features(NegotiatedFeatures());
       break;
 
     case Chunk::Type::kStartAckConfirmation:
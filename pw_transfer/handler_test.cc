@@ -14,6 +14,8 @@
 
 #include "pw_transfer/handler.h"
 
+#include <array>
+
 #include "gtest/gtest.h"
 
 namespace pw::transfer {
@@ -25,6 +27,16 @@ TEST(Handlers, ReadOnly) {
   EXPECT_EQ(Status::PermissionDenied(), handler.PrepareWrite());
 }
 
+TEST(Handlers, ReadOnlyMemory) {
+  constexpr std::array<std::byte, 3> kData = {
+      std::byte{1}, std::byte{2}, std::byte{3}};
+  ReadOnlyMemoryHandler handler(123, kData);
+  EXPECT_EQ(OkStatus(), handler.PrepareRead());
+  EXPECT_EQ(Status::PermissionDenied(), handler.PrepareWrite());
+  EXPECT_EQ(handler.ReadableMemory().data(), kData.data());
+  EXPECT_EQ(handler.ReadableMemory().size(), kData.size());
+}
+
 TEST(Handlers, WriteOnly) {
   WriteOnlyHandler handler(123);
   EXPECT_EQ(Status::PermissionDenied(), handler.PrepareRead());
@@ -17,12 +17,18 @@ package dev.pigweed.pw_transfer;
 import static dev.pigweed.pw_transfer.TransferProgress.UNKNOWN_TRANSFER_SIZE;
 import static java.lang.Math.max;
 
+import com.google.common.collect.ImmutableList;
+import com.google.common.collect.Range;
+import com.google.common.collect.TreeRangeSet;
+import com.google.protobuf.ByteString;
 import dev.pigweed.pw_log.Logger;
 import dev.pigweed.pw_rpc.Status;
 import dev.pigweed.pw_transfer.TransferEventHandler.TransferInterface;
 import java.nio.ByteBuffer;
 import java.util.ArrayList;
 import java.util.List;
+import java.util.Map;
+import java.util.TreeMap;
 import java.util.function.BooleanSupplier;
 import java.util.function.Consumer;
 
@@ -38,6 +44,9 @@ class ReadTransfer extends Transfer<byte[]> {
   // of the window, and so on.
   private static final int EXTEND_WINDOW_DIVISOR = 2;
 
+  // Placeholder for finalOffset until the chunk with remaining_bytes = 0 is received.
+  private static final int UNKNOWN_FINAL_OFFSET = -1;
+
   // To minimize copies, store the ByteBuffers directly from the chunk protos in a list.
   private final List<ByteBuffer> dataChunks = new ArrayList<>();
   private int totalDataSize = 0;
@@ -51,6 +60,11 @@ class ReadTransfer extends Transfer<byte[]> {
 
   private int lastReceivedOffset = 0;
 
+  // With selective retransmission, data received beyond the offset is held here by offset until
+  // the gap before it is filled.
+  private final TreeMap<Integer, ByteString> outOfOrderData = new TreeMap<>();
+  private int finalOffset = UNKNOWN_FINAL_OFFSET;
+
   ReadTransfer(int resourceId,
       int sessionId,
       ProtocolVersion desiredProtocolVersion,
@@ -101,6 +115,11 @@ class ReadTransfer extends Transfer<byte[]> {
       // Track the last seen offset so the DropRecovery state can detect retried packets.
       lastReceivedOffset = chunk.offset();
 
+      if (chunk.offset() > offset && selectiveRetransmit()) {
+        handleOutOfOrderData(chunk);
+        return;
+      }
+
       if (chunk.offset() != offset) {
         logger.atFine().log("%s expected offset %d, received %d; resending transfer parameters",
             ReadTransfer.this,
@@ -133,6 +152,12 @@ class ReadTransfer extends Transfer<byte[]> {
         remainingTransferSize = max(remainingTransferSize - chunk.data().size(), 0);
       }
 
+      mergeOutOfOrderData();
+      if (finalOffset != UNKNOWN_FINAL_OFFSET && offset >= finalOffset) {
+        setStateTerminatingAndSendFinalChunk(Status.OK);
+        return;
+      }
+
       if (remainingTransferSize == UNKNOWN_TRANSFER_SIZE || remainingTransferSize == 0) {
         updateProgress(offset, offset, UNKNOWN_TRANSFER_SIZE);
       } else {
@@ -140,8 +165,9 @@ class ReadTransfer extends Transfer<byte[]> {
       }
 
       int remainingWindowSize = windowEndOffset - offset;
-      boolean extendWindow =
-          remainingWindowSize <= parameters.maxPendingBytes() / EXTEND_WINDOW_DIVISOR;
+      // Don't extend the window while there are gaps; the next update reports them instead.
+      boolean extendWindow = outOfOrderData.isEmpty()
+          && remainingWindowSize <= parameters.maxPendingBytes() / EXTEND_WINDOW_DIVISOR;
 
       if (remainingWindowSize == 0) {
         logger.atFinest().log(
@@ -154,6 +180,55 @@ class ReadTransfer extends Transfer<byte[]> {
     }
   }
 
+  /** Holds data that arrived after a gap and requests the gaps at the end of the window. */
+  private void handleOutOfOrderData(VersionedChunk chunk) throws TransferAbortedException {
+    int endOffset = chunk.offset() + chunk.data().size();
+    if (endOffset > windowEndOffset) {
+      logger.atFiner().log("%s ignoring bytes %d-%d outside of window ending at %d",
+          this,
+          chunk.offset(),
+          endOffset - 1,
+          windowEndOffset);
+      setNextChunkTimeout();
+      return;
+    }
+
+    logger.atFine().log("%s expected offset %d, received %d; holding %d B out-of-order data",
+        this,
+        offset,
+        chunk.offset(),
+        chunk.data().size());
+    outOfOrderData.put(chunk.offset(), chunk.data());
+
+    boolean finalChunk =
+        chunk.remainingBytes().isPresent() && chunk.remainingBytes().getAsLong() == 0;
+    if (finalChunk) {
+      finalOffset = endOffset;
+    }
+
+    // Request the missing data once the transmitter has sent everything it is going to send.
+    if (endOffset == windowEndOffset || finalChunk) {
+      sendChunk(prepareTransferParameters(/*extend=*/false));
+    }
+    setNextChunkTimeout();
+  }
+
+  /** Appends any held out-of-order data that is now contiguous with the offset. */
+  private void mergeOutOfOrderData() {
+    while (!outOfOrderData.isEmpty() && outOfOrderData.firstKey() <= offset) {
+      Map.Entry<Integer, ByteString> entry = outOfOrderData.pollFirstEntry();
+      int endOffset = entry.getKey() + entry.getValue().size();
+      if (endOffset <= offset) {
+        continue; // Already received through retransmission.
+      }
+
+      ByteString newData = entry.getValue().substring(offset - entry.getKey());
+      dataChunks.addAll(newData.asReadOnlyByteBufferList());
+      totalDataSize += newData.size();
+      offset = endOffset;
+    }
+  }
+
   /** State for recovering from dropped packets. */
   private class DropRecovery extends ActiveState {
     @Override
@@ -204,6 +279,12 @@ class ReadTransfer extends Transfer<byte[]> {
         .setMaxChunkSizeBytes(parameters.maxChunkSizeBytes())
         .setOffset(offset)
         .setWindowEndOffset(windowEndOffset);
+    if (!outOfOrderData.isEmpty()) {
+      TreeRangeSet<Integer> receivedRanges = TreeRangeSet.create();
+      outOfOrderData.forEach(
+          (start, data) -> receivedRanges.add(Range.closedOpen(start, start + data.size())));
+      chunk.setReceivedRanges(ImmutableList.copyOf(receivedRanges.asRanges()));
+    }
     if (parameters.chunkDelayMicroseconds() > 0) {
       chunk.setMinDelayMicroseconds(parameters.chunkDelayMicroseconds());
     }
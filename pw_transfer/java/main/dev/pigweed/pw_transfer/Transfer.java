@@ -38,6 +38,9 @@ abstract class Transfer<T> extends AbstractFuture<T> {
   // Whether to output some particularly noisy logs.
   static final boolean VERBOSE_LOGGING = false;
 
+  // Optional protocol features this client supports, advertised in the START chunk.
+  static final int SUPPORTED_FEATURES = Chunk.Feature.SELECTIVE_RETRANSMIT.getNumber();
+
   private final int resourceId;
   private final int sessionId;
   private final ProtocolVersion desiredProtocolVersion;
@@ -48,6 +51,7 @@ abstract class Transfer<T> extends AbstractFuture<T> {
   private final Instant startTime;
 
   private ProtocolVersion configuredProtocolVersion = ProtocolVersion.UNKNOWN;
+  private int negotiatedFeatures = 0;
   private Instant deadline = NO_TIMEOUT;
   private State state;
   private VersionedChunk lastChunkSent;
@@ -123,6 +127,11 @@ abstract class Transfer<T> extends AbstractFuture<T> {
     return desiredProtocolVersion;
   }
 
+  /** Whether both sides agreed to report and skip out-of-order data during the handshake. */
+  final boolean selectiveRetransmit() {
+    return (negotiatedFeatures & Chunk.Feature.SELECTIVE_RETRANSMIT.getNumber()) != 0;
+  }
+
   /** Terminates the transfer without sending any packets. */
   public final void terminate(TransferError error) {
     changeState(new Completed(error));
@@ -153,6 +162,9 @@ abstract class Transfer<T> extends AbstractFuture<T> {
         timeoutSettings.maxRetries());
     VersionedChunk.Builder chunk =
         VersionedChunk.createInitialChunk(desiredProtocolVersion, resourceId, sessionId);
+    if (desiredProtocolVersion != ProtocolVersion.LEGACY) {
+      chunk.setFeatures(SUPPORTED_FEATURES);
+    }
     prepareInitialChunk(chunk);
     try {
       sendChunk(chunk.build());
@@ -412,11 +424,14 @@ abstract class Transfer<T> extends AbstractFuture<T> {
         configuredProtocolVersion = desiredProtocolVersion;
       }
 
-      logger.atFine().log("%s negotiated protocol %s (ours=%s, theirs=%s)",
+      negotiatedFeatures = chunk.features() & SUPPORTED_FEATURES;
+
+      logger.atFine().log("%s negotiated protocol %s (ours=%s, theirs=%s), features 0x%x",
           Transfer.this,
           configuredProtocolVersion,
           desiredProtocolVersion,
-          chunk.version());
+          chunk.version(),
+          negotiatedFeatures);
 
       VersionedChunk.Builder startAckConfirmation = newChunk(Chunk.Type.START_ACK_CONFIRMATION);
       prepareInitialChunk(startAckConfirmation);
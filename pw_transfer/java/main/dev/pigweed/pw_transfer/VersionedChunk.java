@@ -15,8 +15,11 @@
 package dev.pigweed.pw_transfer;
 
 import com.google.auto.value.AutoValue;
+import com.google.common.collect.ImmutableList;
+import com.google.common.collect.Range;
 import com.google.protobuf.ByteString;
 import dev.pigweed.pw_rpc.Status;
+import java.util.List;
 import java.util.Map;
 import java.util.OptionalInt;
 import java.util.OptionalLong;
@@ -53,12 +56,20 @@ abstract class VersionedChunk {
 
   public abstract OptionalInt desiredSessionId();
 
+  /** Bitmask of Chunk.Feature values; only meaningful in handshake chunks. */
+  public abstract int features();
+
+  /** Data received beyond the offset, as [start, end) ranges; sent with retransmits. */
+  public abstract ImmutableList<Range<Integer>> receivedRanges();
+
   public static Builder builder() {
     return new AutoValue_VersionedChunk.Builder()
         .setSessionId(UNKNOWN_SESSION_ID)
         .setOffset(0)
         .setWindowEndOffset(0)
-        .setData(ByteString.EMPTY);
+        .setData(ByteString.EMPTY)
+        .setFeatures(0)
+        .setReceivedRanges(ImmutableList.of());
   }
 
   @AutoValue.Builder
@@ -91,6 +102,10 @@ abstract class VersionedChunk {
 
     abstract Builder setDesiredSessionId(int desiredSessionId);
 
+    public abstract Builder setFeatures(int features);
+
+    public abstract Builder setReceivedRanges(List<Range<Integer>> receivedRanges);
+
     public abstract VersionedChunk build();
   }
 
@@ -161,6 +176,18 @@ abstract class VersionedChunk {
     if (chunk.hasStatus()) {
       builder.setStatus(chunk.getStatus());
     }
+    if (chunk.hasFeatures()) {
+      builder.setFeatures(chunk.getFeatures());
+    }
+
+    // Received ranges are packed as [start, end) pairs; ignore a trailing unpaired value.
+    List<Long> ranges = chunk.getReceivedRangesList();
+    ImmutableList.Builder<Range<Integer>> receivedRanges = ImmutableList.builder();
+    for (int i = 0; i + 1 < ranges.size(); i += 2) {
+      receivedRanges.add(
+          Range.closedOpen(ranges.get(i).intValue(), ranges.get(i + 1).intValue()));
+    }
+    builder.setReceivedRanges(receivedRanges.build());
     return builder.build();
   }
 
@@ -189,6 +216,13 @@ abstract class VersionedChunk {
     status().ifPresent(chunk::setStatus);
     desiredSessionId().ifPresent(chunk::setDesiredSessionId);
 
+    if (features() != 0) {
+      chunk.setFeatures(features());
+    }
+    for (Range<Integer> range : receivedRanges()) {
+      chunk.addReceivedRanges(range.lowerEndpoint()).addReceivedRanges(range.upperEndpoint());
+    }
+
     // The resourceId is only needed for START chunks.
     if (type() == Chunk.Type.START) {
       chunk.setResourceId(resourceId().getAsInt()); // resourceId must be set for start chunks
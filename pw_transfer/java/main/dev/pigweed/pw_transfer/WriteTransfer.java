@@ -16,10 +16,13 @@ package dev.pigweed.pw_transfer;
 
 import static java.lang.Math.min;
 
+import com.google.common.collect.Range;
 import com.google.protobuf.ByteString;
 import dev.pigweed.pw_log.Logger;
 import dev.pigweed.pw_rpc.Status;
 import dev.pigweed.pw_transfer.TransferEventHandler.TransferInterface;
+import java.util.ArrayDeque;
+import java.util.Deque;
 import java.util.function.BooleanSupplier;
 import java.util.function.Consumer;
 
@@ -35,6 +38,9 @@ class WriteTransfer extends Transfer<Void> {
   private int sentOffset;
   private long totalDroppedBytes;
 
+  // Ranges the receiver already has beyond sentOffset, reported with selective retransmission.
+  private final Deque<Range<Integer>> receivedRanges = new ArrayDeque<>();
+
   private final byte[] data;
 
   protected WriteTransfer(int resourceId,
@@ -89,8 +95,11 @@ class WriteTransfer extends Transfer<Void> {
 
     @Override
     public void handleTimeout() throws TransferAbortedException {
-      ByteString chunkData = ByteString.copyFrom(
-          data, sentOffset, min(windowEndOffset - sentOffset, maxChunkSizeBytes));
+      int chunkSize = min(windowEndOffset - sentOffset, maxChunkSizeBytes);
+      if (!receivedRanges.isEmpty()) {
+        chunkSize = min(chunkSize, receivedRanges.peekFirst().lowerEndpoint() - sentOffset);
+      }
+      ByteString chunkData = ByteString.copyFrom(data, sentOffset, chunkSize);
 
       if (VERBOSE_LOGGING) {
         logger.atFinest().log("%s sending bytes %d-%d (%d B chunk, max size %d B)",
@@ -104,6 +113,7 @@ class WriteTransfer extends Transfer<Void> {
       sendChunk(buildDataChunk(chunkData));
 
       sentOffset += chunkData.size();
+      skipReceivedRanges();
       updateProgress(sentOffset, windowStartOffset, data.length);
 
       if (sentOffset < windowEndOffset) {
@@ -149,6 +159,16 @@ class WriteTransfer extends Transfer<Void> {
             sentOffset);
       }
       sentOffset = chunk.offset();
+
+      receivedRanges.clear();
+      if (selectiveRetransmit()) {
+        for (Range<Integer> range : chunk.receivedRanges()) {
+          if (range.lowerEndpoint() > sentOffset && range.lowerEndpoint() < windowEndOffset) {
+            receivedRanges.addLast(Range.closedOpen(
+                range.lowerEndpoint(), min(range.upperEndpoint(), windowEndOffset)));
+          }
+        }
+      }
     } else if (windowEndOffset <= sentOffset) {
       logger.atFiner().log("%s ignoring old rolling window packet", this);
       setNextChunkTimeout();
@@ -177,6 +197,20 @@ class WriteTransfer extends Transfer<Void> {
     changeState(new Transmitting(chunk.offset(), windowEndOffset)).handleTimeout();
   }
 
+  /** Advances sentOffset past data the receiver reported that it already has. */
+  private void skipReceivedRanges() {
+    while (!receivedRanges.isEmpty() && receivedRanges.peekFirst().lowerEndpoint() <= sentOffset) {
+      Range<Integer> range = receivedRanges.removeFirst();
+      if (range.upperEndpoint() > sentOffset) {
+        logger.atFiner().log("%s skipping bytes %d-%d already received",
+            this,
+            sentOffset,
+            range.upperEndpoint() - 1);
+        sentOffset = range.upperEndpoint();
+      }
+    }
+  }
+
   private VersionedChunk buildDataChunk(ByteString chunkData) {
     VersionedChunk.Builder chunk =
         newChunk(Chunk.Type.DATA).setOffset(sentOffset).setData(chunkData);
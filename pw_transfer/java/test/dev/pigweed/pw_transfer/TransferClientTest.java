@@ -1210,6 +1210,59 @@ public final class TransferClientTest {
     assertThat(future.get()).isEqualTo(TEST_DATA_100B.toByteArray());
   }
 
+  @Test
+  public void read_selectiveRetransmit_holdsOutOfOrderData() throws Exception {
+    createTransferClientForTransferThatWillNotTimeOut(ProtocolVersion.VERSION_TWO);
+    ListenableFuture<byte[]> future = transferClient.read(8, TRANSFER_PARAMETERS);
+    ReadTransfer transfer = transferClient.getReadTransferForTest(future);
+
+    assertThat(lastChunks()).containsExactly(initialReadChunk(transfer));
+
+    receiveReadChunks(newChunk(Chunk.Type.START_ACK, transfer.getSessionId())
+                          .setResourceId(transfer.getResourceId())
+                          .setProtocolVersion(ProtocolVersion.VERSION_TWO.ordinal())
+                          .setFeatures(Chunk.Feature.SELECTIVE_RETRANSMIT.getNumber()));
+
+    assertThat(lastChunks())
+        .containsExactly(
+            readStartAckConfirmation(transfer.getSessionId(), transfer.getParametersForTest()));
+
+    // Bytes 20-29 are dropped. The data after the gap is kept and reported in the retransmit.
+    receiveReadChunks(newChunk(Chunk.Type.DATA, transfer.getSessionId())
+                          .setOffset(0)
+                          .setData(range(0, 20))
+                          .setRemainingBytes(80),
+        newChunk(Chunk.Type.DATA, transfer.getSessionId()).setOffset(30).setData(range(30, 50)));
+
+    assertThat(lastChunks())
+        .containsExactly(newChunk(Chunk.Type.PARAMETERS_RETRANSMIT, transfer.getSessionId())
+                             .setOffset(20)
+                             .setMaxChunkSizeBytes(30)
+                             .setWindowEndOffset(70)
+                             .addReceivedRanges(30)
+                             .addReceivedRanges(50)
+                             .build());
+
+    receiveReadChunks(
+        newChunk(Chunk.Type.DATA, transfer.getSessionId()).setOffset(20).setData(range(20, 30)));
+
+    assertThat(lastChunks())
+        .containsExactly(newChunk(Chunk.Type.PARAMETERS_CONTINUE, transfer.getSessionId())
+                             .setOffset(50)
+                             .setMaxChunkSizeBytes(30)
+                             .setWindowEndOffset(100)
+                             .build());
+
+    receiveReadChunks(newChunk(Chunk.Type.DATA, transfer.getSessionId())
+                          .setOffset(50)
+                          .setData(range(50, 100))
+                          .setRemainingBytes(0));
+
+    performReadCompletionHandshake(transfer.getSessionId(), Status.OK);
+
+    assertThat(future.get()).isEqualTo(TEST_DATA_100B.toByteArray());
+  }
+
   @Test
   public void read_onlySendsOneUpdateAfterDrops() throws Exception {
     createTransferClientThatMayTimeOut(ProtocolVersion.VERSION_TWO);
@@ -1821,6 +1874,81 @@ public final class TransferClientTest {
     assertThat(future.get()).isNull(); // Ensure that no exceptions are thrown.
   }
 
+  @Test
+  public void write_selectiveRetransmit_skipsReceivedRanges() throws Exception {
+    createTransferClientForTransferThatWillNotTimeOut(ProtocolVersion.VERSION_TWO);
+    ListenableFuture<Void> future = transferClient.write(501, TEST_DATA_100B.toByteArray());
+    WriteTransfer transfer = transferClient.getWriteTransferForTest(future);
+
+    assertThat(lastChunks()).containsExactly(initialWriteChunk(transfer, TEST_DATA_100B.size()));
+
+    receiveWriteChunks(newChunk(Chunk.Type.START_ACK, transfer.getSessionId())
+                           .setResourceId(transfer.getResourceId())
+                           .setProtocolVersion(ProtocolVersion.VERSION_TWO.ordinal())
+                           .setFeatures(Chunk.Feature.SELECTIVE_RETRANSMIT.getNumber()));
+
+    assertThat(lastChunks())
+        .containsExactly(newChunk(Chunk.Type.START_ACK_CONFIRMATION, transfer.getSessionId())
+                             .setProtocolVersion(ProtocolVersion.VERSION_TWO.ordinal())
+                             .setRemainingBytes(TEST_DATA_100B.size())
+                             .build());
+
+    receiveWriteChunks(newChunk(Chunk.Type.PARAMETERS_RETRANSMIT, transfer.getSessionId())
+                           .setOffset(0)
+                           .setWindowEndOffset(50)
+                           .setMaxChunkSizeBytes(30));
+
+    assertThat(lastChunks())
+        .containsExactly(newChunk(Chunk.Type.DATA, transfer.getSessionId())
+                             .setOffset(0)
+                             .setData(range(0, 30))
+                             .build(),
+            newChunk(Chunk.Type.DATA, transfer.getSessionId())
+                .setOffset(30)
+                .setData(range(30, 50))
+                .build());
+
+    // The receiver lost bytes 10-19 and 40-49, so only those are sent again.
+    receiveWriteChunks(newChunk(Chunk.Type.PARAMETERS_RETRANSMIT, transfer.getSessionId())
+                           .setOffset(10)
+                           .setWindowEndOffset(80)
+                           .setMaxChunkSizeBytes(30)
+                           .addReceivedRanges(20)
+                           .addReceivedRanges(40));
+
+    assertThat(lastChunks())
+        .containsExactly(newChunk(Chunk.Type.DATA, transfer.getSessionId())
+                             .setOffset(10)
+                             .setData(range(10, 20))
+                             .build(),
+            newChunk(Chunk.Type.DATA, transfer.getSessionId())
+                .setOffset(40)
+                .setData(range(40, 70))
+                .build(),
+            newChunk(Chunk.Type.DATA, transfer.getSessionId())
+                .setOffset(70)
+                .setData(range(70, 80))
+                .build());
+
+    receiveWriteChunks(newChunk(Chunk.Type.PARAMETERS_RETRANSMIT, transfer.getSessionId())
+                           .setOffset(80)
+                           .setWindowEndOffset(130));
+
+    assertThat(lastChunks())
+        .containsExactly(newChunk(Chunk.Type.DATA, transfer.getSessionId())
+                             .setOffset(80)
+                             .setData(range(80, 100))
+                             .setRemainingBytes(0)
+                             .build());
+
+    receiveWriteChunks(finalChunk(transfer.getSessionId(), Status.OK));
+
+    assertThat(lastChunks())
+        .containsExactly(newChunk(Chunk.Type.COMPLETION_ACK, transfer.getSessionId()).build());
+
+    assertThat(future.get()).isNull(); // Ensure that no exceptions are thrown.
+  }
+
   @Test
   public void write_parametersContinue() throws Exception {
     createTransferClientForTransferThatWillNotTimeOut(ProtocolVersion.VERSION_TWO);
@@ -2464,6 +2592,7 @@ public final class TransferClientTest {
     if (transfer.getDesiredProtocolVersionForTest() != ProtocolVersion.LEGACY) {
       chunk.setProtocolVersion(transfer.getDesiredProtocolVersionForTest().ordinal());
       chunk.setDesiredSessionId(transfer.getSessionId());
+      chunk.setFeatures(Chunk.Feature.SELECTIVE_RETRANSMIT.getNumber());
     }
     if (transfer.getParametersForTest().chunkDelayMicroseconds() > 0) {
       chunk.setMinDelayMicroseconds(transfer.getParametersForTest().chunkDelayMicroseconds());
@@ -2514,6 +2643,7 @@ public final class TransferClientTest {
     if (transfer.getDesiredProtocolVersionForTest() != ProtocolVersion.LEGACY) {
       chunk.setProtocolVersion(ProtocolVersion.VERSION_TWO.ordinal());
       chunk.setDesiredSessionId(transfer.getSessionId());
+      chunk.setFeatures(Chunk.Feature.SELECTIVE_RETRANSMIT.getNumber());
     }
     return chunk.build();
   }
@@ -0,0 +1,191 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/prefetching_handler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace pw::transfer {
+
+void PrefetchingReader::Start() {
+  {
+    std::lock_guard lock(lock_);
+    Reset(0);
+    active_ = true;
+    seek_pending_ = source_.seekable(Whence::kBeginning);
+  }
+  prefetch_notification_.release();
+}
+
+void PrefetchingReader::Stop() {
+  {
+    std::lock_guard lock(lock_);
+    Reset(position_);
+    active_ = false;
+  }
+  // Wake a reader waiting for data, which returns FAILED_PRECONDITION.
+  data_notification_.release();
+}
+
+void PrefetchingReader::Terminate() {
+  {
+    std::lock_guard lock(lock_);
+    Reset(position_);
+    active_ = false;
+    terminated_ = true;
+  }
+  prefetch_notification_.release();
+  data_notification_.release();
+}
+
+size_t PrefetchingReader::buffered_bytes() const {
+  std::lock_guard lock(lock_);
+  return count_;
+}
+
+StatusWithSize PrefetchingReader::DoRead(ByteSpan destination) {
+  std::unique_lock lock(lock_);
+
+  // Only wait if there is nothing to return. Wake-ups may be spurious, since
+  // the prefetch thread notifies on every read from the source.
+  while (count_ == 0u && active_ && source_status_.ok()) {
+    lock.unlock();
+    data_notification_.acquire();
+    lock.lock();
+  }
+
+  if (count_ == 0u) {
+    return StatusWithSize(
+        active_ ? source_status_ : Status::FailedPrecondition(), 0);
+  }
+
+  const size_t size = std::min(destination.size(), count_);
+  const size_t first = std::min(size, buffer_.size() - head_);
+  std::memcpy(destination.data(), &buffer_[head_], first);
+  std::memcpy(destination.data() + first, buffer_.data(), size - first);
+
+  head_ = (head_ + size) % buffer_.size();
+  count_ -= size;
+  position_ += size;
+  lock.unlock();
+
+  // There is room in the buffer again.
+  prefetch_notification_.release();
+  return StatusWithSize(size);
+}
+
+Status PrefetchingReader::DoSeek(ptrdiff_t offset, Whence origin) {
+  std::lock_guard lock(lock_);
+
+  ptrdiff_t target = offset;
+  if (origin == Whence::kCurrent) {
+    target += static_cast<ptrdiff_t>(position_);
+  } else if (origin != Whence::kBeginning) {
+    return Status::Unimplemented();
+  }
+  if (target < 0) {
+    return Status::InvalidArgument();
+  }
+
+  const size_t new_position = static_cast<size_t>(target);
+  if (active_ && new_position >= position_ &&
+      new_position - position_ <= count_) {
+    // Skip over buffered data.
+    const size_t skipped = new_position - position_;
+    head_ = (head_ + skipped) % buffer_.size();
+    count_ -= skipped;
+    position_ = new_position;
+  } else {
+    if (!source_.seekable(Whence::kBeginning)) {
+      return Status::Unimplemented();
+    }
+    Reset(new_position);
+    active_ = true;
+    seek_pending_ = true;
+  }
+
+  prefetch_notification_.release();
+  return OkStatus();
+}
+
+size_t PrefetchingReader::DoTell() {
+  std::lock_guard lock(lock_);
+  return position_;
+}
+
+void PrefetchingReader::Run() {
+  while (true) {
+    ByteSpan space;
+    uint32_t generation;
+    bool seek;
+    size_t seek_position;
+    {
+      std::unique_lock lock(lock_);
+      if (terminated_) {
+        return;
+      }
+      if (!active_ || !source_status_.ok() || count_ == buffer_.size()) {
+        lock.unlock();
+        prefetch_notification_.acquire();
+        continue;
+      }
+
+      // Fill the free space up to the end of the buffer. The rest is filled on
+      // the next iteration.
+      const size_t tail = (head_ + count_) % buffer_.size();
+      space = buffer_.subspan(
+          tail, std::min(buffer_.size() - count_, buffer_.size() - tail));
+      generation = generation_;
+      seek = seek_pending_;
+      seek_pending_ = false;
+      seek_position = position_;
+    }
+
+    // Access the source without holding the lock, so the buffered data can be
+    // read in the meantime.
+    Status status;
+    size_t bytes_read = 0;
+    if (seek) {
+      status = source_.Seek(static_cast<ptrdiff_t>(seek_position));
+    }
+    if (status.ok()) {
+      Result<ByteSpan> result = source_.Read(space);
+      status = result.status();
+      bytes_read = result.ok() ? result->size() : 0u;
+    }
+
+    {
+      std::lock_guard lock(lock_);
+      if (generation != generation_) {
+        continue;  // The data was discarded while it was being read.
+      }
+      count_ += bytes_read;
+      source_status_ = status;
+    }
+    data_notification_.release();
+  }
+}
+
+void PrefetchingReader::Reset(size_t position) {
+  head_ = 0;
+  count_ = 0;
+  position_ = position;
+  generation_ += 1;
+  seek_pending_ = false;
+  source_status_ = OkStatus();
+}
+
+}  // namespace pw::transfer
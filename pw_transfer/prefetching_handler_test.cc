@@ -0,0 +1,187 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/prefetching_handler.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::transfer {
+namespace {
+
+constexpr auto kData = bytes::Initialized<64>([](size_t i) { return i; });
+
+thread::Options& PrefetchThreadOptions() {
+  static thread::stl::Options options;
+  return options;
+}
+
+// Returns the source data in pieces of up to 8 bytes, then an error.
+class FailingReader final : public stream::NonSeekableReader {
+ public:
+  FailingReader(size_t bytes_before_error, Status error)
+      : remaining_(bytes_before_error), error_(error) {}
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    if (remaining_ == 0u) {
+      return StatusWithSize(error_, 0);
+    }
+    const size_t size =
+        std::min({destination.size(), remaining_, size_t{8}});
+    std::memset(destination.data(), 0x5a, size);
+    remaining_ -= size;
+    return StatusWithSize(size);
+  }
+
+  size_t remaining_;
+  Status error_;
+};
+
+class PrefetchingReaderTest : public ::testing::Test {
+ protected:
+  PrefetchingReaderTest()
+      : source_(kData),
+        reader_(source_, buffer_),
+        thread_(PrefetchThreadOptions(), reader_) {}
+
+  ~PrefetchingReaderTest() override {
+    reader_.Terminate();
+    thread_.join();
+  }
+
+  // Reads size bytes, which may take several reads.
+  void ExpectRead(size_t offset, size_t size) {
+    std::array<std::byte, kData.size()> read{};
+    size_t total = 0;
+    while (total < size) {
+      Result<ByteSpan> result =
+          reader_.Read(span(read).subspan(total, size - total));
+      ASSERT_EQ(result.status(), OkStatus());
+      total += result->size();
+    }
+    EXPECT_EQ(std::memcmp(read.data(), kData.data() + offset, size), 0);
+  }
+
+  stream::MemoryReader source_;
+  std::array<std::byte, 16> buffer_;
+  PrefetchingReader reader_;
+  thread::Thread thread_;
+};
+
+TEST_F(PrefetchingReaderTest, ReadBeforeStart_FailedPrecondition) {
+  std::array<std::byte, 8> read{};
+  EXPECT_EQ(reader_.Read(read).status(), Status::FailedPrecondition());
+}
+
+TEST_F(PrefetchingReaderTest, ReadsAllData) {
+  reader_.Start();
+  ExpectRead(0, kData.size());
+  EXPECT_EQ(reader_.Tell(), kData.size());
+
+  std::array<std::byte, 8> read{};
+  EXPECT_EQ(reader_.Read(read).status(), Status::OutOfRange());
+}
+
+TEST_F(PrefetchingReaderTest, ReadsAreLimitedToBufferedData) {
+  reader_.Start();
+
+  std::array<std::byte, kData.size()> read{};
+  Result<ByteSpan> result = reader_.Read(read);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_GT(result->size(), 0u);
+  EXPECT_LE(result->size(), buffer_.size());
+}
+
+TEST_F(PrefetchingReaderTest, Seek) {
+  reader_.Start();
+  ExpectRead(0, 8);
+
+  ASSERT_EQ(reader_.Seek(40), OkStatus());
+  EXPECT_EQ(reader_.Tell(), 40u);
+  ExpectRead(40, 16);
+
+  ASSERT_EQ(reader_.Seek(4), OkStatus());
+  ExpectRead(4, 8);
+
+  ASSERT_EQ(reader_.Seek(4, stream::Stream::kCurrent), OkStatus());
+  ExpectRead(16, 8);
+}
+
+TEST_F(PrefetchingReaderTest, StartRestartsFromBeginning) {
+  reader_.Start();
+  ExpectRead(0, 24);
+
+  reader_.Stop();
+  std::array<std::byte, 8> read{};
+  EXPECT_EQ(reader_.Read(read).status(), Status::FailedPrecondition());
+
+  reader_.Start();
+  ExpectRead(0, 24);
+}
+
+TEST(PrefetchingReader, SourceError_ReturnedAfterData) {
+  FailingReader source(20, Status::DataLoss());
+  std::array<std::byte, 16> buffer;
+  PrefetchingReader reader(source, buffer);
+  thread::Thread thread(PrefetchThreadOptions(), reader);
+
+  reader.Start();
+
+  std::array<std::byte, 32> read{};
+  size_t total = 0;
+  Status status;
+  while (status.ok()) {
+    Result<ByteSpan> result = reader.Read(read);
+    status = result.status();
+    total += result.ok() ? result->size() : 0u;
+  }
+  EXPECT_EQ(status, Status::DataLoss());
+  EXPECT_EQ(total, 20u);
+
+  // Non-seekable sources can only skip over buffered data.
+  EXPECT_EQ(reader.Seek(0), Status::Unimplemented());
+
+  reader.Terminate();
+  thread.join();
+}
+
+TEST(PrefetchingReadOnlyHandler, PrepareReadStartsPrefetching) {
+  stream::MemoryReader source(kData);
+  std::array<std::byte, 16> buffer;
+  PrefetchingReadOnlyHandler handler(7, source, buffer);
+  thread::Thread thread(PrefetchThreadOptions(), handler.prefetcher());
+
+  std::array<std::byte, 8> read{};
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(handler.PrepareRead(), OkStatus());
+    Result<ByteSpan> result = handler.prefetcher().Read(read);
+    ASSERT_EQ(result.status(), OkStatus());
+    EXPECT_EQ(std::memcmp(result->data(), kData.data(), result->size()), 0);
+    handler.FinalizeRead(OkStatus());
+  }
+  EXPECT_EQ(handler.PrepareWrite(), Status::PermissionDenied());
+
+  handler.prefetcher().Terminate();
+  thread.join();
+}
+
+}  // namespace
+}  // namespace pw::transfer
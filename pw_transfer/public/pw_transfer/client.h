@@ -73,13 +73,21 @@ class Client {
   // the server is written to the provided writer. Returns OK if the transfer is
   // successfully started. When the transfer finishes (successfully or not), the
   // completion callback is invoked with the overall status.
+  //
+  // A non-zero initial_offset resumes an interrupted read: the server starts
+  // sending data from that offset, and the output writer must already be
+  // positioned there. If the server cannot start at the offset, the transfer
+  // fails with UNIMPLEMENTED. Legacy transfers cannot resume, so Read() with
+  // ProtocolVersion::kLegacy returns INVALID_ARGUMENT for a non-zero
+  // initial_offset.
   Status Read(uint32_t resource_id,
               stream::Writer& output,
               CompletionFunc&& on_completion,
               chrono::SystemClock::duration timeout = cfg::kDefaultChunkTimeout,
               chrono::SystemClock::duration initial_chunk_timeout =
                   cfg::kDefaultInitialChunkTimeout,
-              ProtocolVersion version = kDefaultProtocolVersion);
+              ProtocolVersion version = kDefaultProtocolVersion,
+              uint32_t initial_offset = 0);
 
   // Begins a new write transfer for the given resource ID. Data from the
   // provided reader is sent to the server. When the transfer finishes
@@ -109,6 +117,13 @@ class Client {
     return OkStatus();
   }
 
+  // Sizes the windows and chunks of read transfers at runtime, within
+  // max_bytes_to_receive and the max chunk size. The controller must outlive
+  // the client. Pass nullptr to use the static configuration.
+  void set_congestion_controller(const CongestionController* controller) {
+    max_parameters_.set_congestion_controller(controller);
+  }
+
   constexpr Status set_max_retries(uint32_t max_retries) {
     if (max_retries < 1 || max_retries > max_lifetime_retries_) {
       return Status::InvalidArgument();
@@ -0,0 +1,136 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pw::transfer {
+
+// Per-transfer state of a congestion controller. Receiving transfers keep one
+// of these, which may be inspected for debugging.
+struct CongestionState {
+  // Number of bytes the receiver currently requests in each window.
+  uint32_t window_size_bytes = 0;
+  uint32_t max_window_size_bytes = 0;
+
+  // Largest chunk the receiver currently allows the transmitter to send.
+  uint32_t chunk_size_bytes = 0;
+  uint32_t max_chunk_size_bytes = 0;
+
+  // Window size above which the window grows linearly rather than doubling.
+  uint32_t slow_start_threshold_bytes = 0;
+
+  // Time between sending transfer parameters and receiving the first chunk
+  // they requested. 0 if no round trip has been measured.
+  uint32_t last_rtt_us = 0;
+  uint32_t min_rtt_us = 0;
+  uint32_t smoothed_rtt_us = 0;
+
+  // Throughput reported by the transfer's RateEstimate.
+  size_t rate_bytes_per_second = 0;
+
+  // Number of times data was lost, either from an out of order chunk or a
+  // timeout.
+  uint32_t losses = 0;
+};
+
+// Measurements passed to a congestion controller when data is received.
+struct CongestionSample {
+  // Bytes received since the transfer parameters were last updated.
+  uint32_t bytes_received;
+
+  // Newly measured round trip time, or 0 if none was measured.
+  uint32_t rtt_us;
+
+  size_t rate_bytes_per_second;
+};
+
+// Sizes a receiving transfer's window and maximum chunk size at runtime. A
+// controller holds no per-transfer state, so one controller may be shared by
+// all transfers, including those running on different transfer threads.
+class CongestionController {
+ public:
+  // Smallest chunk size to which a controller shrinks chunks after losses.
+  static constexpr uint32_t kMinChunkSizeBytes = 32;
+
+  virtual ~CongestionController() = default;
+
+  // Initializes the state at the start of a transfer.
+  void Start(CongestionState& state,
+             uint32_t max_window_size_bytes,
+             uint32_t max_chunk_size_bytes) const;
+
+  // Called when in-order data is received, before the receiver extends or
+  // advances its window.
+  void OnProgress(CongestionState& state, const CongestionSample& sample) const;
+
+  // Called when data is lost, before the receiver requests a retransmission.
+  void OnLoss(CongestionState& state) const;
+
+ protected:
+  constexpr CongestionController(uint32_t initial_window_chunks)
+      : initial_window_chunks_(initial_window_chunks) {}
+
+  // Doubles the chunk size after it was reduced by losses.
+  static void GrowChunkSize(CongestionState& state);
+
+ private:
+  virtual void DoProgress(CongestionState& state,
+                          const CongestionSample& sample) const = 0;
+  virtual void DoLoss(CongestionState& state) const = 0;
+
+  uint32_t initial_window_chunks_;
+};
+
+// Additive increase, multiplicative decrease congestion control, as in TCP
+// Reno. The window doubles each round trip until it reaches the slow start
+// threshold, then grows by one chunk per window. A loss halves the window; a
+// loss when the window is a single chunk also halves the chunk size.
+class AimdCongestionController : public CongestionController {
+ public:
+  constexpr AimdCongestionController(uint32_t initial_window_chunks = 2)
+      : CongestionController(initial_window_chunks) {}
+
+ protected:
+  void DoProgress(CongestionState& state,
+                  const CongestionSample& sample) const override;
+  void DoLoss(CongestionState& state) const override;
+};
+
+// Delay-based congestion control, as in TCP Vegas. The controller estimates how
+// much data is queued in the link from the increase of the round trip time over
+// the minimum seen. The window grows while fewer than alpha chunks are queued
+// and shrinks when more than beta chunks are, so the window settles before the
+// link starts dropping data. The window is also kept within twice the
+// bandwidth-delay product measured by the transfer's RateEstimate. Losses are
+// handled as by AimdCongestionController.
+class RttCongestionController final : public AimdCongestionController {
+ public:
+  constexpr RttCongestionController(uint32_t alpha_chunks = 1,
+                                    uint32_t beta_chunks = 3,
+                                    uint32_t initial_window_chunks = 2)
+      : AimdCongestionController(initial_window_chunks),
+        alpha_chunks_(alpha_chunks),
+        beta_chunks_(beta_chunks) {}
+
+ private:
+  void DoProgress(CongestionState& state,
+                  const CongestionSample& sample) const override;
+
+  uint32_t alpha_chunks_;
+  uint32_t beta_chunks_;
+};
+
+}  // namespace pw::transfer
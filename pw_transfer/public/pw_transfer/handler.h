@@ -14,8 +14,12 @@
 #pragma once
 
 #include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
 #include "pw_containers/intrusive_list.h"
+#include "pw_result/result.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_stream/stream.h"
 #include "pw_transfer/internal/event.h"
 
@@ -56,6 +60,17 @@ class Handler : public IntrusiveList<Handler>::Item {
   // Status::Unimplemented() indicates that writes are not supported.
   virtual Status PrepareWrite() = 0;
 
+  // Called instead of PrepareWrite() when the client can resume an interrupted
+  // write. Returns the offset at which the write continues, with the
+  // stream::Writer positioned there. The client sends data starting from this
+  // offset rather than from the beginning.
+  //
+  // By default, writes are not resumed and start at offset 0.
+  virtual Result<uint32_t> PrepareResumableWrite() {
+    PW_TRY(PrepareWrite());
+    return 0u;
+  }
+
   // FinalizeWrite() is called at the end of a write transfer. The status
   // argument indicates whether the data transfer was successful or not.
   //
@@ -63,6 +78,17 @@ class Handler : public IntrusiveList<Handler>::Item {
   // succeeded up to this point.
   virtual Status FinalizeWrite(Status) { return OkStatus(); }
 
+  // Returns memory holding the resource's data that can be read in place, such
+  // as a memory-mapped or execute-in-place flash region (for example, from
+  // BlobReader::GetMemoryMappedBlob()). Called after a successful
+  // PrepareRead().
+  //
+  // If the returned span is non-empty, read transfers encode chunk data
+  // directly from it rather than reading it through the stream::Reader into an
+  // intermediate buffer. The memory must remain valid and unchanged until
+  // FinalizeRead() is called. By default, data is read from the stream.
+  virtual ConstByteSpan ReadableMemory() { return {}; }
+
  protected:
   constexpr Handler(uint32_t resource_id, stream::Reader* reader)
       : resource_id_(resource_id), reader_(reader) {}
@@ -118,6 +144,27 @@ class ReadOnlyHandler : public Handler {
   using Handler::set_writer;
 };
 
+// A read-only handler for data that resides in directly readable memory. Read
+// transfers encode chunks straight from the memory instead of copying them out
+// through a stream::Reader first.
+class ReadOnlyMemoryHandler : public ReadOnlyHandler {
+ public:
+  ReadOnlyMemoryHandler(uint32_t resource_id, ConstByteSpan data)
+      : ReadOnlyHandler(resource_id), data_(data), memory_reader_(data) {
+    set_reader(memory_reader_);
+  }
+
+  ~ReadOnlyMemoryHandler() override = default;
+
+  Status PrepareRead() override { return memory_reader_.Seek(0); }
+
+  ConstByteSpan ReadableMemory() final { return data_; }
+
+ private:
+  ConstByteSpan data_;
+  stream::MemoryReader memory_reader_;
+};
+
 class WriteOnlyHandler : public Handler {
  public:
   constexpr WriteOnlyHandler(uint32_t resource_id)
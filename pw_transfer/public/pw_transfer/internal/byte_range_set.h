@@ -0,0 +1,75 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+#include "pw_transfer/internal/config.h"
+
+namespace pw::transfer::internal {
+
+// A half-open range of transfer data offsets, [start, end).
+struct ByteRange {
+  uint32_t start;
+  uint32_t end;
+
+  constexpr uint32_t size() const { return end - start; }
+};
+
+// A fixed-capacity set of disjoint byte ranges, kept sorted by offset. Used by
+// selective retransmission to track the data beyond a transfer's offset that
+// the receiver already has.
+class ByteRangeSet {
+ public:
+  static constexpr size_t kCapacity = cfg::kMaxReceivedRanges;
+
+  constexpr ByteRangeSet() : ranges_{}, size_(0) {}
+
+  // Adds the range [start, end) to the set, merging it with any ranges it
+  // overlaps or touches. Returns false without modifying the set if the range
+  // would need a new entry and the set is full.
+  bool Add(uint32_t start, uint32_t end);
+
+  // Consumes every range that starts at or before offset, returning the end of
+  // the contiguous data from offset. Returns offset itself if no range
+  // includes it.
+  uint32_t Advance(uint32_t offset);
+
+  // Removes any data at or beyond end from the set.
+  void Truncate(uint32_t end);
+
+  constexpr void clear() { size_ = 0; }
+
+  constexpr bool empty() const { return size_ == 0; }
+  constexpr bool full() const { return size_ == kCapacity; }
+  constexpr size_t size() const { return size_; }
+
+  constexpr span<const ByteRange> ranges() const {
+    return span(ranges_.data(), size_);
+  }
+
+  // The first range in the set. The set must not be empty.
+  constexpr const ByteRange& front() const { return ranges_[0]; }
+
+ private:
+  void Erase(size_t index, size_t count);
+
+  std::array<ByteRange, kCapacity> ranges_;
+  size_t size_;
+};
+
+}  // namespace pw::transfer::internal
@@ -17,6 +17,7 @@
 
 #include "pw_bytes/span.h"
 #include "pw_result/result.h"
+#include "pw_transfer/internal/byte_range_set.h"
 #include "pw_transfer/internal/protocol.h"
 #include "pw_transfer/transfer.pwpb.h"
 
@@ -25,6 +26,7 @@ namespace pw::transfer::internal {
 class Chunk {
  public:
   using Type = transfer::pwpb::Chunk::Type;
+  using Feature = transfer::pwpb::Chunk::Feature;
 
   class Identifier {
    public:
@@ -140,6 +142,17 @@ class Chunk {
     return *this;
   }
 
+  // Sets the bitmask of protocol features sent during the initial handshake.
+  constexpr Chunk& set_features(uint32_t features) {
+    features_ = features;
+    return *this;
+  }
+
+  constexpr Chunk& set_received_ranges(const ByteRangeSet& received_ranges) {
+    received_ranges_ = received_ranges;
+    return *this;
+  }
+
   // TODO(frolv): For some reason, the compiler complains if this setter is
   // marked constexpr. Leaving it off for now, but this should be investigated
   // and fixed.
@@ -190,6 +203,18 @@ class Chunk {
     return protocol_version_;
   }
 
+  constexpr uint32_t features() const { return features_; }
+
+  constexpr bool has_feature(Feature feature) const {
+    return (features_ & static_cast<uint32_t>(feature)) != 0u;
+  }
+
+  // Ranges of data beyond offset() which the receiver already has. Only the
+  // first ByteRangeSet::kCapacity ranges of a parsed chunk are kept.
+  constexpr const ByteRangeSet& received_ranges() const {
+    return received_ranges_;
+  }
+
   constexpr bool is_legacy() const {
     return protocol_version_ == ProtocolVersion::kLegacy;
   }
@@ -266,7 +291,9 @@ class Chunk {
         remaining_bytes_(std::nullopt),
         status_(std::nullopt),
         type_(type),
-        protocol_version_(version) {}
+        protocol_version_(version),
+        features_(0),
+        received_ranges_() {}
 
   constexpr Chunk() : Chunk(ProtocolVersion::kUnknown, std::nullopt) {}
 
@@ -294,6 +321,8 @@ class Chunk {
   std::optional<Status> status_;
   std::optional<Type> type_;
   ProtocolVersion protocol_version_;
+  uint32_t features_;
+  ByteRangeSet received_ranges_;
 };
 
 }  // namespace pw::transfer::internal
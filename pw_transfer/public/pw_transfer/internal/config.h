@@ -17,6 +17,7 @@
 
 #include <chrono>
 #include <cinttypes>
+#include <cstddef>
 #include <limits>
 
 #include "pw_chrono/system_clock.h"
@@ -80,6 +81,21 @@ static_assert(PW_TRANSFER_DEFAULT_INITIAL_TIMEOUT_MS > 0);
 
 static_assert(PW_TRANSFER_DEFAULT_EXTEND_WINDOW_DIVISOR > 1);
 
+// The maximum number of out-of-order byte ranges a receive transfer tracks
+// when selective retransmission is negotiated. The receiver reports these
+// ranges to the transmitter, which skips them when it resends a window. This
+// also bounds the number of ranges a transmitter accepts from its peer.
+//
+// Each range costs 8 bytes in every transfer context and chunk. Setting this
+// to 0 disables selective retransmission.
+#ifndef PW_TRANSFER_MAX_RECEIVED_RANGES
+#define PW_TRANSFER_MAX_RECEIVED_RANGES 4
+#endif  // PW_TRANSFER_MAX_RECEIVED_RANGES
+
+static_assert(PW_TRANSFER_MAX_RECEIVED_RANGES >= 0 &&
+              PW_TRANSFER_MAX_RECEIVED_RANGES <=
+                  std::numeric_limits<uint8_t>::max());
+
 namespace pw::transfer::cfg {
 
 inline constexpr uint8_t kDefaultMaxRetries = PW_TRANSFER_DEFAULT_MAX_RETRIES;
@@ -94,4 +110,6 @@ inline constexpr chrono::SystemClock::duration kDefaultInitialChunkTimeout =
 inline constexpr uint32_t kDefaultExtendWindowDivisor =
     PW_TRANSFER_DEFAULT_EXTEND_WINDOW_DIVISOR;
 
+inline constexpr size_t kMaxReceivedRanges = PW_TRANSFER_MAX_RECEIVED_RANGES;
+
 }  // namespace pw::transfer::cfg
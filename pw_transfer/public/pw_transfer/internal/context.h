@@ -19,10 +19,14 @@
 #include <optional>
 
 #include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
 #include "pw_chrono/system_clock.h"
+#include "pw_result/result.h"
 #include "pw_rpc/writer.h"
 #include "pw_status/status.h"
 #include "pw_stream/stream.h"
+#include "pw_transfer/congestion_control.h"
+#include "pw_transfer/internal/byte_range_set.h"
 #include "pw_transfer/internal/chunk.h"
 #include "pw_transfer/internal/event.h"
 #include "pw_transfer/internal/protocol.h"
@@ -39,7 +43,8 @@ class TransferParameters {
                                uint32_t extend_window_divisor)
       : pending_bytes_(pending_bytes),
         max_chunk_size_bytes_(max_chunk_size_bytes),
-        extend_window_divisor_(extend_window_divisor) {
+        extend_window_divisor_(extend_window_divisor),
+        congestion_controller_(nullptr) {
     PW_ASSERT(pending_bytes > 0);
     PW_ASSERT(max_chunk_size_bytes > 0);
     PW_ASSERT(extend_window_divisor > 1);
@@ -61,10 +66,21 @@ class TransferParameters {
     extend_window_divisor_ = extend_window_divisor;
   }
 
+  // If set, receive transfers size their windows and chunks with this
+  // controller, within pending_bytes and max_chunk_size_bytes.
+  const CongestionController* congestion_controller() const {
+    return congestion_controller_;
+  }
+  void set_congestion_controller(
+      const CongestionController* congestion_controller) {
+    congestion_controller_ = congestion_controller;
+  }
+
  private:
   uint32_t pending_bytes_;
   uint32_t max_chunk_size_bytes_;
   uint32_t extend_window_divisor_;
+  const CongestionController* congestion_controller_;
 };
 
 // Information about a single transfer.
@@ -104,6 +120,10 @@ class Context {
   // Processes an event for this transfer.
   void HandleEvent(const Event& event);
 
+  // Congestion control state of a receive transfer, if a congestion controller
+  // is configured.
+  const CongestionState& congestion_state() const { return congestion_state_; }
+
  protected:
   ~Context() = default;
 
@@ -120,6 +140,7 @@ class Context {
         max_lifetime_retries_(0),
         stream_(nullptr),
         rpc_writer_(nullptr),
+        readable_memory_(),
         offset_(0),
         window_size_(0),
         window_end_offset_(0),
@@ -132,7 +153,11 @@ class Context {
         initial_chunk_timeout_(chrono::SystemClock::duration::zero()),
         interchunk_delay_(chrono::SystemClock::for_at_least(
             std::chrono::microseconds(kDefaultChunkDelayMicroseconds))),
-        next_timeout_(kNoTimeout) {}
+        next_timeout_(kNoTimeout),
+        congestion_state_{},
+        parameters_offset_(0),
+        received_ranges_(),
+        final_offset_(0) {}
 
   constexpr TransferType type() const {
     return static_cast<TransferType>(flags_ & kFlagsType);
@@ -262,6 +287,40 @@ class Context {
 
   void UpdateLocalProtocolConfigurationFromPeer(const Chunk& chunk);
 
+  // Returns the protocol features this end of the transfer can support.
+  uint32_t LocalFeatures() const;
+
+  // Returns the protocol features negotiated for the transfer.
+  uint32_t NegotiatedFeatures() const {
+    uint32_t features = 0;
+    if (selective_retransmit()) {
+      features |= static_cast<uint32_t>(Chunk::Feature::kSelectiveRetransmit);
+    }
+    if (resume()) {
+      features |= static_cast<uint32_t>(Chunk::Feature::kResume);
+    }
+    return features;
+  }
+
+  bool selective_retransmit() const {
+    return (flags_ & kFlagsSelectiveRetransmit) != 0;
+  }
+
+  bool resume() const { return (flags_ & kFlagsResume) != 0; }
+
+  // Seeks the reader of a transmit transfer to the specified offset. Returns
+  // false and terminates the transfer if the seek fails.
+  bool SeekReader(uint32_t offset);
+
+  // Seeks or reads the data of a transmit transfer. Data is taken in place from
+  // the handler's readable memory if it provided any, or from the reader.
+  Status SeekData(uint32_t offset);
+  Result<ConstByteSpan> ReadData(ByteSpan buffer);
+
+  // Moves the offset of a transmit transfer past any data that the receiver
+  // has reported it already has. Returns false if seeking failed.
+  bool SkipReceivedRanges();
+
   // Processes a chunk in a transmit transfer.
   void HandleTransmitChunk(const Chunk& chunk);
 
@@ -277,6 +336,14 @@ class Context {
   // Processes a data chunk in a received while in the kWaiting state.
   void HandleReceivedData(const Chunk& chunk);
 
+  // Writes a chunk beyond the current offset of a receive transfer that has
+  // negotiated selective retransmission, recording its range.
+  void HandleOutOfOrderData(const Chunk& chunk);
+
+  // Writes a chunk's data to the stream at the chunk's offset. Returns false
+  // and terminates the transfer if the write fails.
+  bool WriteChunkData(const Chunk& chunk);
+
   // Sends the first chunk in a legacy transmit transfer.
   void SendInitialLegacyTransmitChunk();
 
@@ -294,6 +361,11 @@ class Context {
   // Updates the current receive transfer parameters, then sends them.
   void UpdateAndSendTransferParameters(TransmitAction action);
 
+  // Informs the congestion controller, if any, that in-order data was received
+  // or that data was lost.
+  void RecordCongestionProgress();
+  void RecordCongestionLoss();
+
   // Processes a chunk in a terminating state.
   void HandleTerminatingChunk(const Chunk& chunk);
 
@@ -340,6 +412,9 @@ class Context {
   static constexpr uint8_t kFlagsType = 1 << 0;
   static constexpr uint8_t kFlagsDataSent = 1 << 1;
   static constexpr uint8_t kFlagsContactMade = 1 << 2;
+  static constexpr uint8_t kFlagsSelectiveRetransmit = 1 << 3;
+  static constexpr uint8_t kFlagsSeekRequired = 1 << 4;
+  static constexpr uint8_t kFlagsResume = 1 << 5;
 
   static constexpr uint32_t kDefaultChunkDelayMicroseconds = 2000;
 
@@ -374,6 +449,10 @@ class Context {
   stream::Stream* stream_;
   rpc::Writer* rpc_writer_;
 
+  // Memory backing a server read transfer's data, if its handler exposes any.
+  // Chunks are encoded directly from this instead of read through stream_.
+  ConstByteSpan readable_memory_;
+
   uint32_t offset_;
   uint32_t window_size_;
   uint32_t window_end_offset_;
@@ -403,6 +482,25 @@ class Context {
   chrono::SystemClock::time_point next_timeout_;
 
   RateEstimate transfer_rate_;
+
+  CongestionState congestion_state_;
+
+  // Offset at which the transfer parameters were last updated, used to count
+  // the bytes received since.
+  uint32_t parameters_offset_;
+
+  // When the transfer parameters that started the current window were sent,
+  // used to measure the round trip time.
+  std::optional<chrono::SystemClock::time_point> parameters_sent_time_;
+
+  // With selective retransmission, the ranges of data beyond offset_ that the
+  // receiver already has. A receiver records the out-of-order data it writes;
+  // a transmitter holds the ranges most recently reported by the receiver.
+  ByteRangeSet received_ranges_;
+
+  // In a receive transfer, the end offset of the transfer's final chunk if it
+  // arrived out of order, or 0 if it has not been received.
+  uint32_t final_offset_;
 };
 
 }  // namespace pw::transfer::internal
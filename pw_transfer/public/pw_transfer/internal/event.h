@@ -61,6 +61,10 @@ enum class EventType {
 
   // For testing only: aborts the transfer thread.
   kTerminate,
+
+  // For testing only: processed once all previously queued chunks have been
+  // processed.
+  kFlushChunkQueue,
 };
 
 // Forward declarations required for events.
@@ -72,6 +76,7 @@ struct NewTransferEvent {
   ProtocolVersion protocol_version;
   uint32_t session_id;
   uint32_t resource_id;
+  uint32_t initial_offset;  // Offset at which a client receive transfer starts.
   rpc::Writer* rpc_writer;
   const TransferParameters* max_parameters;
   chrono::SystemClock::duration timeout;
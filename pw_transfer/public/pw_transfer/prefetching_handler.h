@@ -0,0 +1,152 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread_core.h"
+#include "pw_transfer/handler.h"
+
+namespace pw::transfer {
+
+// A stream::Reader that reads ahead from a slow source reader, such as SPI
+// flash or a file system, into a ring buffer. The source is read on a separate
+// thread, which runs the PrefetchingReader as its ThreadCore.
+//
+// Read() returns the buffered data without waiting for the source, even if
+// less data is buffered than requested. It only blocks if no data is buffered
+// yet. Source errors, including OUT_OF_RANGE at the end of the data, are
+// returned once the data read before them has been consumed.
+//
+// Nothing is read until Start() is called. Seeking within the buffered data
+// discards it without accessing the source. Seeking elsewhere discards the
+// buffer and seeks the source from the prefetch thread; if that fails, the
+// next Read() returns the error. Seeking is only supported if the source
+// supports seeking from its beginning.
+class PrefetchingReader : public stream::SeekableReader,
+                          public thread::ThreadCore {
+ public:
+  // The buffer must not be empty.
+  PrefetchingReader(stream::Reader& source, ByteSpan buffer)
+      : source_(source), buffer_(buffer) {
+    PW_ASSERT(!buffer_.empty());
+  }
+
+  PrefetchingReader(const PrefetchingReader&) = delete;
+  PrefetchingReader& operator=(const PrefetchingReader&) = delete;
+
+  // Discards any buffered data and starts prefetching from the beginning of
+  // the source. If the source is not seekable, prefetching continues from its
+  // current position, which becomes offset 0.
+  void Start();
+
+  // Discards any buffered data and stops prefetching until the next Start() or
+  // Seek(). Read() returns FAILED_PRECONDITION while stopped.
+  void Stop();
+
+  // Stops prefetching and makes the prefetch thread's Run() return.
+  void Terminate();
+
+  // Number of bytes that are buffered and can be read without waiting.
+  size_t buffered_bytes() const;
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override;
+
+  Status DoSeek(ptrdiff_t offset, Whence origin) override;
+
+  size_t DoTell() override;
+
+  void Run() override;
+
+  // Discards the buffered data and any source read in progress.
+  void Reset(size_t position) PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  stream::Reader& source_;
+  const ByteSpan buffer_;
+
+  mutable sync::Mutex lock_;
+
+  // The buffered data is buffer_[head_, head_ + count_), wrapping around the
+  // end of the buffer. It starts at offset position_ of the source.
+  size_t head_ PW_GUARDED_BY(lock_) = 0;
+  size_t count_ PW_GUARDED_BY(lock_) = 0;
+  size_t position_ PW_GUARDED_BY(lock_) = 0;
+
+  // Incremented whenever the buffered data is discarded, so that a source read
+  // that was in progress at the time is discarded as well.
+  uint32_t generation_ PW_GUARDED_BY(lock_) = 0;
+
+  // Result of the last source read. Prefetching pauses on an error.
+  Status source_status_ PW_GUARDED_BY(lock_);
+
+  bool active_ PW_GUARDED_BY(lock_) = false;
+  bool seek_pending_ PW_GUARDED_BY(lock_) = false;
+  bool terminated_ PW_GUARDED_BY(lock_) = false;
+
+  // Wakes the prefetch thread when there is room in the buffer or prefetching
+  // is restarted.
+  sync::ThreadNotification prefetch_notification_;
+
+  // Wakes a reader waiting for data.
+  sync::ThreadNotification data_notification_;
+};
+
+// A read-only transfer handler that prefetches its data from a slow source, so
+// that building a chunk in the transfer thread does not wait on source I/O and
+// stall other transfers. The buffer should be at least as large as the
+// transfer window, so that the next window is read while the previous one is
+// in flight.
+//
+// The handler's prefetcher() must be run on its own thread:
+//
+//   PrefetchingReadOnlyHandler handler(kResourceId, flash_reader, buffer);
+//   thread::Thread prefetch_thread(options, handler.prefetcher());
+//
+class PrefetchingReadOnlyHandler : public ReadOnlyHandler {
+ public:
+  PrefetchingReadOnlyHandler(uint32_t resource_id,
+                             stream::Reader& source,
+                             ByteSpan buffer)
+      : ReadOnlyHandler(resource_id), reader_(source, buffer) {
+    set_reader(reader_);
+  }
+
+  ~PrefetchingReadOnlyHandler() override = default;
+
+  // Derived classes that override these must call them.
+  Status PrepareRead() override {
+    reader_.Start();
+    return OkStatus();
+  }
+
+  void FinalizeRead(Status) override { reader_.Stop(); }
+
+  // The thread core that reads from the source.
+  PrefetchingReader& prefetcher() { return reader_; }
+
+ private:
+  PrefetchingReader reader_;
+};
+
+}  // namespace pw::transfer
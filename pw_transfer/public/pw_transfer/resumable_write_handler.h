@@ -0,0 +1,137 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+#include "pw_transfer/handler.h"
+
+namespace pw::transfer {
+
+// A write handler that records the progress of writes in a KVS, so that a write
+// interrupted by a disconnect or reboot resumes where it stopped instead of
+// starting over.
+//
+// Every save_interval_bytes written, the handler stores the number of bytes
+// written and a CRC32 of them under kvs_key. When a client that supports
+// resuming starts a new write, PrepareResumableWrite() loads the record and
+// asks PrepareDestination() to continue from the saved offset. The record is
+// deleted when a write completes successfully, or when a client starts a write
+// from the beginning.
+//
+// Up to save_interval_bytes of data written since the last save are sent again
+// after a resume; the destination must tolerate them being overwritten.
+class ResumableWriteHandler : public WriteOnlyHandler {
+ public:
+  // The key must outlive the handler.
+  ResumableWriteHandler(uint32_t resource_id,
+                        stream::Writer& destination,
+                        kvs::KeyValueStore& kvs,
+                        std::string_view kvs_key,
+                        size_t save_interval_bytes)
+      : WriteOnlyHandler(resource_id),
+        kvs_(kvs),
+        kvs_key_(kvs_key),
+        save_interval_bytes_(save_interval_bytes),
+        writer_(*this, destination) {
+    set_writer(writer_);
+  }
+
+  ResumableWriteHandler(const ResumableWriteHandler&) = delete;
+  ResumableWriteHandler& operator=(const ResumableWriteHandler&) = delete;
+
+  ~ResumableWriteHandler() override = default;
+
+  // Starts the write from the beginning, discarding any saved progress.
+  Status PrepareWrite() override;
+
+  // Continues from the saved offset if there is one and the destination can
+  // be prepared for it. Otherwise, starts from the beginning.
+  Result<uint32_t> PrepareResumableWrite() override;
+
+  // Deletes the saved progress if the write succeeded, or saves it if not.
+  Status FinalizeWrite(Status status) override;
+
+  // Number of bytes written to the destination by this and resumed writes.
+  uint32_t offset() const { return offset_; }
+
+  // CRC32 of the bytes written to the destination by this and resumed writes.
+  uint32_t checksum() const { return checksum_; }
+
+  // The writer that transfers write to. Writes through it are forwarded to the
+  // destination and update the progress.
+  stream::Writer& writer() { return writer_; }
+
+ protected:
+  // Prepares the destination to continue writing at offset. checksum is the
+  // CRC32 of the data that was written before offset, which can be used to
+  // check that the destination still holds it. Returning an error starts the
+  // write from the beginning instead.
+  //
+  // By default, the destination is seeked to offset if it supports seeking,
+  // and writes can only be resumed if it does.
+  virtual Status PrepareDestination(uint32_t offset, uint32_t checksum);
+
+  stream::Writer& destination() { return writer_.destination(); }
+
+ private:
+  // Stored under kvs_key.
+  struct Progress {
+    uint32_t resource_id;
+    uint32_t offset;
+    uint32_t checksum;
+  };
+
+  // Forwards writes to the destination, tracking the progress of the write.
+  class ProgressWriter : public stream::NonSeekableWriter {
+   public:
+    ProgressWriter(ResumableWriteHandler& handler, stream::Writer& destination)
+        : handler_(handler), destination_(destination) {}
+
+    stream::Writer& destination() { return destination_; }
+
+   private:
+    Status DoWrite(ConstByteSpan data) override;
+
+    size_t ConservativeLimit(LimitType type) const override {
+      return type == LimitType::kWrite ? destination_.ConservativeWriteLimit()
+                                       : 0;
+    }
+
+    ResumableWriteHandler& handler_;
+    stream::Writer& destination_;
+  };
+
+  Status SaveProgress();
+
+  void ClearProgress();
+
+  kvs::KeyValueStore& kvs_;
+  const std::string_view kvs_key_;
+  const size_t save_interval_bytes_;
+  ProgressWriter writer_;
+
+  uint32_t offset_ = 0;
+  uint32_t checksum_ = 0;
+  uint32_t saved_offset_ = 0;
+};
+
+}  // namespace pw::transfer
@@ -120,6 +120,13 @@ class TransferService : public pw_rpc::raw::Transfer::Service<TransferService> {
     return OkStatus();
   }
 
+  // Sizes the windows and chunks of write transfers at runtime, within
+  // max_pending_bytes and the max chunk size. The controller must outlive the
+  // service. Pass nullptr to use the static configuration.
+  void set_congestion_controller(const CongestionController* controller) {
+    max_parameters_.set_congestion_controller(controller);
+  }
+
  private:
   void HandleChunk(ConstByteSpan message, internal::TransferType type);
 
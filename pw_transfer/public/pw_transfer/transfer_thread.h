@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstdint>
 
 #include "pw_assert/assert.h"
@@ -23,6 +24,8 @@
 #include "pw_rpc/raw/server_reader_writer.h"
 #include "pw_span/span.h"
 #include "pw_sync/binary_semaphore.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
 #include "pw_sync/timed_thread_notification.h"
 #include "pw_thread/thread_core.h"
 #include "pw_transfer/handler.h"
@@ -32,19 +35,30 @@
 #include "pw_transfer/internal/server_context.h"
 
 namespace pw::transfer {
+
+template <size_t, size_t, size_t, size_t, size_t>
+class ParallelThread;
+
 namespace internal {
 
 class TransferThread : public thread::ThreadCore {
  public:
+  // If a chunk_queue_buffer is provided, incoming chunks are copied into it
+  // without waiting for the transfer thread, which processes all queued chunks
+  // each time it wakes up. Each queued chunk takes chunk_queue_slot_size()
+  // bytes of the buffer. Otherwise, each chunk waits for the previous event to
+  // be processed.
   TransferThread(span<ClientContext> client_transfers,
                  span<ServerContext> server_transfers,
                  ByteSpan chunk_buffer,
-                 ByteSpan encode_buffer)
-      : client_transfers_(client_transfers),
-        server_transfers_(server_transfers),
-        next_session_id_(1),
-        chunk_buffer_(chunk_buffer),
-        encode_buffer_(encode_buffer) {}
+                 ByteSpan encode_buffer,
+                 ByteSpan chunk_queue_buffer = {})
+      : TransferThread(client_transfers,
+                       server_transfers,
+                       chunk_buffer,
+                       encode_buffer,
+                       chunk_queue_buffer,
+                       /*workers=*/{}) {}
 
   void StartClientTransfer(TransferType type,
                            ProtocolVersion version,
@@ -55,7 +69,8 @@ class TransferThread : public thread::ThreadCore {
                            chrono::SystemClock::duration timeout,
                            chrono::SystemClock::duration initial_timeout,
                            uint8_t max_retries,
-                           uint32_t max_lifetime_retries) {
+                           uint32_t max_lifetime_retries,
+                           uint32_t initial_offset = 0) {
     StartTransfer(type,
                   version,
                   Context::kUnassignedSessionId,  // Assigned later.
@@ -67,7 +82,8 @@ class TransferThread : public thread::ThreadCore {
                   timeout,
                   initial_timeout,
                   max_retries,
-                  max_lifetime_retries);
+                  max_lifetime_retries,
+                  initial_offset);
   }
 
   void StartServerTransfer(TransferType type,
@@ -90,7 +106,8 @@ class TransferThread : public thread::ThreadCore {
                   timeout,
                   timeout,
                   max_retries,
-                  max_lifetime_retries);
+                  max_lifetime_retries,
+                  /*initial_offset=*/0);
   }
 
   void ProcessClientChunk(ConstByteSpan chunk) {
@@ -151,6 +168,10 @@ class TransferThread : public thread::ThreadCore {
 
   void RemoveTransferHandler(Handler& handler) {
     TransferHandlerEvent(EventType::kRemoveTransferHandler, handler);
+    // Transfers using the handler may be running on any worker.
+    for (TransferThread* worker : workers_) {
+      worker->TransferHandlerEvent(EventType::kRemoveTransferHandler, handler);
+    }
     // Ensure this function blocks until the transfer handler is fully cleaned
     // up.
     WaitUntilEventIsProcessed();
@@ -158,15 +179,22 @@ class TransferThread : public thread::ThreadCore {
 
   size_t max_chunk_size() const { return chunk_buffer_.size(); }
 
-  // For testing only: terminates the transfer thread with a kTerminate event.
+  // Size of the space a queued chunk takes in the chunk_queue_buffer.
+  static constexpr size_t chunk_queue_slot_size(size_t max_chunk_size) {
+    return sizeof(QueuedChunk) + max_chunk_size;
+  }
+
+  // Number of chunks that can be queued for the transfer thread.
+  size_t chunk_queue_capacity() const { return chunk_queue_slots_; }
+
+  // For testing only: terminates the transfer thread and any workers with a
+  // kTerminate event.
   void Terminate();
 
   // For testing only: blocks until the next event can be acquired, which means
-  // a previously enqueued event has been processed.
-  void WaitUntilEventIsProcessed() {
-    next_event_ownership_.acquire();
-    next_event_ownership_.release();
-  }
+  // a previously enqueued event has been processed, and until all queued chunks
+  // have been processed. Waits for all workers.
+  void WaitUntilEventIsProcessed();
 
   // For testing only: simulates a timeout event for a client transfer.
   void SimulateClientTimeout(uint32_t session_id) {
@@ -178,9 +206,40 @@ class TransferThread : public thread::ThreadCore {
     SimulateTimeout(EventType::kServerTimeout, session_id);
   }
 
+ protected:
+  // Constructs the primary thread of a ParallelThread. Events for a transfer
+  // are handed to this thread or one of the workers based on its session ID.
+  TransferThread(span<ClientContext> client_transfers,
+                 span<ServerContext> server_transfers,
+                 ByteSpan chunk_buffer,
+                 ByteSpan encode_buffer,
+                 ByteSpan chunk_queue_buffer,
+                 span<TransferThread*> workers)
+      : client_transfers_(client_transfers),
+        server_transfers_(server_transfers),
+        next_session_id_(1),
+        chunk_buffer_(chunk_buffer),
+        encode_buffer_(encode_buffer),
+        chunk_queue_(chunk_queue_buffer),
+        chunk_queue_slots_(chunk_queue_buffer.size() /
+                           chunk_queue_slot_size(chunk_buffer.size())),
+        primary_(nullptr),
+        workers_(workers) {}
+
  private:
   friend class Context;
 
+  template <size_t, size_t, size_t, size_t, size_t>
+  friend class ::pw::transfer::ParallelThread;
+
+  // Header of a chunk in the chunk queue, which is followed by the chunk data.
+  struct QueuedChunk {
+    EventType type;
+    bool match_resource_id;
+    uint32_t context_identifier;
+    uint32_t size;
+  };
+
   // Maximum amount of time between transfer thread runs.
   static constexpr chrono::SystemClock::duration kMaxTimeout =
       std::chrono::seconds(2);
@@ -233,20 +292,38 @@ class TransferThread : public thread::ThreadCore {
 
   const ByteSpan& encode_buffer() const { return encode_buffer_; }
 
+  // Returns the thread which handles events for a session: either this thread
+  // or one of its workers.
+  TransferThread& WorkerFor(uint32_t session_id) {
+    if (workers_.empty()) {
+      return *this;
+    }
+    const size_t index = session_id % (workers_.size() + 1);
+    return index == 0 ? *this : *workers_[index - 1];
+  }
+
+  // The thread that owns the RPC streams and transfer handlers.
+  TransferThread& primary() { return primary_ == nullptr ? *this : *primary_; }
+
+  Handler* FindHandler(uint32_t resource_id);
+
   void Run() final;
 
   void HandleTimeouts();
 
   rpc::Writer& stream_for(TransferStream stream) {
+    // Workers share the primary thread's streams. Writes to RPC call objects
+    // are synchronized by pw_rpc.
+    TransferThread& owner = primary();
     switch (stream) {
       case TransferStream::kClientRead:
-        return client_read_stream_;
+        return owner.client_read_stream_;
       case TransferStream::kClientWrite:
-        return client_write_stream_;
+        return owner.client_write_stream_;
       case TransferStream::kServerRead:
-        return server_read_stream_;
+        return owner.server_read_stream_;
       case TransferStream::kServerWrite:
-        return server_write_stream_;
+        return owner.server_write_stream_;
     }
     // An unknown TransferStream value was passed, which means this function
     // was passed an invalid enum value.
@@ -269,10 +346,24 @@ class TransferThread : public thread::ThreadCore {
                      chrono::SystemClock::duration timeout,
                      chrono::SystemClock::duration initial_timeout,
                      uint8_t max_retries,
-                     uint32_t max_lifetime_retries);
+                     uint32_t max_lifetime_retries,
+                     uint32_t initial_offset);
 
   void ProcessChunk(EventType type, ConstByteSpan chunk);
 
+  // Copies a chunk into the chunk queue. Returns false if the queue is full.
+  bool QueueChunk(EventType type,
+                  const Chunk::Identifier& identifier,
+                  ConstByteSpan chunk);
+
+  // Signals the transfer thread that next_event_ has been filled in. The event
+  // is processed after any chunks that were queued before it.
+  void PostEvent();
+
+  // Handles next_event_ and the queued chunks in the order in which they were
+  // posted. Returns true if the thread was terminated.
+  bool ProcessEvents();
+
   void SendStatus(TransferStream stream,
                   uint32_t session_id,
                   ProtocolVersion version,
@@ -320,6 +411,25 @@ class TransferThread : public thread::ThreadCore {
   // Buffer into which responses are encoded. Only ever used from within the
   // transfer thread, so no locking is required.
   ByteSpan encode_buffer_;
+
+  // Ring of chunk_queue_slots_ slots in which incoming chunks are queued.
+  ByteSpan chunk_queue_;
+  const size_t chunk_queue_slots_;
+
+  // State of the chunk queue and of next_event_, shared with the threads that
+  // post events. The transfer thread processes next_event_ once the
+  // chunks_before_event_ chunks queued before it have been processed.
+  sync::Mutex queue_lock_;
+  size_t queue_read_ PW_GUARDED_BY(queue_lock_) = 0;
+  size_t queued_chunks_ PW_GUARDED_BY(queue_lock_) = 0;
+  size_t chunks_before_event_ PW_GUARDED_BY(queue_lock_) = 0;
+  bool event_ready_ PW_GUARDED_BY(queue_lock_) = false;
+
+  // For workers of a ParallelThread, the thread that routes events to them.
+  TransferThread* primary_;
+
+  // For the primary thread of a ParallelThread, the other worker threads.
+  span<TransferThread*> workers_;
 };
 
 }  // namespace internal
@@ -330,9 +440,14 @@ template <size_t kMaxConcurrentClientTransfers,
           size_t kMaxConcurrentServerTransfers>
 class Thread final : public internal::TransferThread {
  public:
-  Thread(ByteSpan chunk_buffer, ByteSpan encode_buffer)
-      : internal::TransferThread(
-            client_contexts_, server_contexts_, chunk_buffer, encode_buffer) {}
+  Thread(ByteSpan chunk_buffer,
+         ByteSpan encode_buffer,
+         ByteSpan chunk_queue_buffer = {})
+      : internal::TransferThread(client_contexts_,
+                                 server_contexts_,
+                                 chunk_buffer,
+                                 encode_buffer,
+                                 chunk_queue_buffer) {}
 
  private:
   std::array<internal::ClientContext, kMaxConcurrentClientTransfers>
@@ -341,4 +456,79 @@ class Thread final : public internal::TransferThread {
       server_contexts_;
 };
 
+// Transfer thread which processes transfers on kWorkers threads, so that
+// transfers on different sessions can progress in parallel. Each worker has its
+// own transfer contexts and chunk and encode buffers; transfers are assigned to
+// workers by session ID.
+//
+// The ParallelThread is used like a Thread: it is passed to the TransferService
+// and Client and run as worker 0. Each other worker must be run on its own
+// thread.
+//
+//   transfer::ParallelThread<2, 1, 2, 256, 256> transfer_thread;
+//   thread::Thread primary(options, transfer_thread.worker(0));
+//   thread::Thread secondary(options, transfer_thread.worker(1));
+//
+template <size_t kWorkers,
+          size_t kMaxConcurrentClientTransfersPerWorker,
+          size_t kMaxConcurrentServerTransfersPerWorker,
+          size_t kChunkBufferSizeBytes,
+          size_t kEncodeBufferSizeBytes>
+class ParallelThread final : public internal::TransferThread {
+ public:
+  static_assert(kWorkers > 0, "A ParallelThread needs at least one worker");
+
+  ParallelThread()
+      : internal::TransferThread(client_contexts_,
+                                 server_contexts_,
+                                 chunk_buffer_,
+                                 encode_buffer_,
+                                 /*chunk_queue_buffer=*/{},
+                                 worker_pointers_) {
+    for (size_t i = 0; i < worker_threads_.size(); ++i) {
+      worker_threads_[i].primary_ = this;
+      worker_pointers_[i] = &worker_threads_[i];
+    }
+  }
+
+  // Returns the thread core for a worker. Worker 0 is this object.
+  thread::ThreadCore& worker(size_t index) {
+    PW_ASSERT(index < kWorkers);
+    if (index == 0) {
+      return *this;
+    }
+    return worker_threads_[index - 1];
+  }
+
+ private:
+  class Worker final : public internal::TransferThread {
+   public:
+    Worker()
+        : internal::TransferThread(client_contexts_,
+                                   server_contexts_,
+                                   chunk_buffer_,
+                                   encode_buffer_) {}
+
+   private:
+    std::array<internal::ClientContext,
+               kMaxConcurrentClientTransfersPerWorker>
+        client_contexts_;
+    std::array<internal::ServerContext,
+               kMaxConcurrentServerTransfersPerWorker>
+        server_contexts_;
+    std::array<std::byte, kChunkBufferSizeBytes> chunk_buffer_;
+    std::array<std::byte, kEncodeBufferSizeBytes> encode_buffer_;
+  };
+
+  std::array<internal::ClientContext, kMaxConcurrentClientTransfersPerWorker>
+      client_contexts_;
+  std::array<internal::ServerContext, kMaxConcurrentServerTransfersPerWorker>
+      server_contexts_;
+  std::array<std::byte, kChunkBufferSizeBytes> chunk_buffer_;
+  std::array<std::byte, kEncodeBufferSizeBytes> encode_buffer_;
+
+  std::array<Worker, kWorkers - 1> worker_threads_;
+  std::array<internal::TransferThread*, kWorkers - 1> worker_pointers_;
+};
+
 }  // namespace pw::transfer
@@ -14,7 +14,7 @@
 """Protocol version-aware chunk message wrapper."""
 
 import enum
-from typing import Any, Optional
+from typing import Any, List, Optional, Sequence, Tuple
 
 from pw_status import Status
 
@@ -70,11 +70,17 @@ class Chunk:
         max_chunk_size_bytes: Maximum number of bytes to send in a single data
             chunk.
         min_delay_microseconds: Delay between data chunks to be sent.
+        features: During the initial handshake, bitmask of Chunk.Feature
+            protocol extensions.
+        received_ranges: In a parameters chunk with selective retransmission,
+            [start, end) ranges of data beyond offset that the receiver already
+            has.
     """
 
     # pylint: disable=too-many-instance-attributes
 
     Type = transfer_pb2.Chunk.Type
+    Feature = transfer_pb2.Chunk.Feature
 
     # TODO(frolv): Figure out how to make the chunk type annotation work.
     # pylint: disable=too-many-arguments
@@ -92,6 +98,8 @@ class Chunk:
         max_chunk_size_bytes: Optional[int] = None,
         min_delay_microseconds: Optional[int] = None,
         status: Optional[Status] = None,
+        features: int = 0,
+        received_ranges: Sequence[Tuple[int, int]] = (),
     ):
         """Creates a new transfer chunk.
 
@@ -113,6 +121,11 @@ class Chunk:
                 data chunk.
             min_delay_microseconds: Delay between data chunks to be sent.
             status: In a COMPLETION chunk, final status of the transfer.
+            features: During the initial handshake, bitmask of Chunk.Feature
+                protocol extensions.
+            received_ranges: In a parameters chunk with selective
+                retransmission, [start, end) ranges of data beyond offset that
+                the receiver already has.
         """
         self.protocol_version = protocol_version
         self.type = chunk_type
@@ -126,6 +139,8 @@ class Chunk:
         self.max_chunk_size_bytes = max_chunk_size_bytes
         self.min_delay_microseconds = min_delay_microseconds
         self.status = status
+        self.features = features
+        self.received_ranges: List[Tuple[int, int]] = list(received_ranges)
 
     @classmethod
     def from_message(cls, message: transfer_pb2.Chunk) -> 'Chunk':
@@ -192,6 +207,14 @@ class Chunk:
         if message.HasField('status'):
             chunk.status = Status(message.status)
 
+        if message.HasField('features'):
+            chunk.features = message.features
+
+        # The received ranges are encoded as a flat list of offset pairs.
+        chunk.received_ranges = list(
+            zip(message.received_ranges[::2], message.received_ranges[1::2])
+        )
+
         if chunk.protocol_version is ProtocolVersion.UNKNOWN:
             # If no fields in the chunk specified its protocol version,
             # assume it is a legacy chunk.
@@ -246,6 +269,12 @@ class Chunk:
         if self.status is not None:
             message.status = self.status.value
 
+        if self.features:
+            message.features = self.features
+
+        for start, end in self.received_ranges:
+            message.received_ranges.extend((start, end))
+
         if self._is_initial_handshake_chunk():
             # During the initial handshake, the desired protocol version is
             # explictly encoded.
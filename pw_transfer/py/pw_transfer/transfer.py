@@ -20,7 +20,7 @@ import enum
 import logging
 import math
 import threading
-from typing import Any, Callable, Optional
+from typing import Any, Callable, Dict, List, Optional, Tuple
 
 from pw_status import Status
 from pw_transfer.chunk import Chunk, ProtocolVersion
@@ -119,6 +119,11 @@ class Transfer(abc.ABC):
         # A transfer has fully completed.
         COMPLETE = 5
 
+    # Protocol features supported by the client. Transfer data is held in
+    # memory, so it can always be read or written out of order as required by
+    # selective retransmission.
+    _SUPPORTED_FEATURES = Chunk.Feature.SELECTIVE_RETRANSMIT
+
     def __init__(  # pylint: disable=too-many-arguments
         self,
         session_id: int,
@@ -143,6 +148,7 @@ class Transfer(abc.ABC):
 
         self._desired_protocol_version = protocol_version
         self._configured_protocol_version = ProtocolVersion.UNKNOWN
+        self._features = 0
 
         if self._desired_protocol_version is ProtocolVersion.LEGACY:
             # In a legacy transfer, there is no protocol negotiation stage.
@@ -188,6 +194,7 @@ class Transfer(abc.ABC):
 
         if self._desired_protocol_version is ProtocolVersion.VERSION_TWO:
             initial_chunk.desired_session_id = self._session_id
+            initial_chunk.features = Transfer._SUPPORTED_FEATURES
 
         # Regardless of the desired protocol version, set any additional fields
         # on the opening chunk, in case the server only runs legacy.
@@ -206,6 +213,11 @@ class Transfer(abc.ABC):
         """Returns the identifier of the resource being transferred."""
         return self._resource_id
 
+    @property
+    def _selective_retransmit(self) -> bool:
+        """Whether selective retransmission was negotiated."""
+        return bool(self._features & Chunk.Feature.SELECTIVE_RETRANSMIT)
+
     @property
     @abc.abstractmethod
     def data(self) -> bytes:
@@ -298,6 +310,12 @@ class Transfer(abc.ABC):
             chunk.protocol_version.value,
         )
 
+        # The server replies with the features enabled for the transfer out of
+        # those requested by the client.
+        self._features = chunk.features & Transfer._SUPPORTED_FEATURES
+        if self._selective_retransmit:
+            _LOG.debug('Transfer %d: selective retransmission enabled', self.id)
+
         # Send a confirmation chunk to the server accepting the assigned session
         # ID and protocol version. Tag any initial transfer parameters onto the
         # chunk to begin the data transfer.
@@ -458,6 +476,9 @@ class WriteTransfer(Transfer):
         # The window ID increments for each parameters update.
         self._window_id = 0
 
+        # Data within the window that the server reported it already has.
+        self._received_ranges: List[Tuple[int, int]] = []
+
         self._bytes_confirmed_received = 0
 
     @property
@@ -510,6 +531,7 @@ class WriteTransfer(Transfer):
 
         chunk = self._next_chunk()
         self._offset += len(chunk.data)
+        self._skip_received_ranges()
 
         sent_requested_bytes = self._offset == self._window_end_offset
 
@@ -566,6 +588,17 @@ class WriteTransfer(Transfer):
 
             self._offset = chunk.offset
 
+            # With selective retransmission, the server lists the data beyond
+            # the offset it already has, which doesn't need to be sent again.
+            self._received_ranges = []
+            if self._selective_retransmit:
+                self._received_ranges = [
+                    (start, min(end, self._window_end_offset))
+                    for start, end in sorted(chunk.received_ranges)
+                    if start < self._window_end_offset
+                ]
+            self._skip_received_ranges()
+
         if chunk.max_chunk_size_bytes is not None:
             self._max_chunk_size = chunk.max_chunk_size_bytes
 
@@ -574,6 +607,23 @@ class WriteTransfer(Transfer):
 
         return True
 
+    def _skip_received_ranges(self) -> None:
+        """Moves the offset past data that the server already has."""
+        while self._received_ranges:
+            start, end = self._received_ranges[0]
+            if start > self._offset:
+                break
+
+            self._received_ranges.pop(0)
+            if end > self._offset:
+                _LOG.debug(
+                    'Transfer %d skipping received data from %d to %d',
+                    self.id,
+                    self._offset,
+                    end,
+                )
+                self._offset = end
+
     def _retry_after_data_timeout(self) -> None:
         if (
             self._state is Transfer._State.WAITING
@@ -593,6 +643,12 @@ class WriteTransfer(Transfer):
         max_bytes_in_chunk = min(
             self._max_chunk_size, self._window_end_offset - self._offset
         )
+
+        # Stop at the start of the next range that the server already has.
+        if self._received_ranges:
+            max_bytes_in_chunk = min(
+                max_bytes_in_chunk, self._received_ranges[0][0] - self._offset
+            )
         chunk.data = self.data[self._offset : self._offset + max_bytes_in_chunk]
 
         # Mark the final chunk of the transfer.
@@ -657,6 +713,12 @@ class ReadTransfer(Transfer):
         self._window_end_offset = max_bytes_to_receive
         self._last_chunk_offset: Optional[int] = None
 
+        # With selective retransmission, data received beyond the current
+        # offset, keyed by its offset, and the end of the final chunk if it
+        # arrived out of order.
+        self._out_of_order_data: Dict[int, bytes] = {}
+        self._final_offset: Optional[int] = None
+
     @property
     def data(self) -> bytes:
         """Returns an immutable copy of the data that has been read."""
@@ -705,6 +767,10 @@ class ReadTransfer(Transfer):
 
         assert self._state is Transfer._State.WAITING
 
+        if chunk.offset > self._offset and self._selective_retransmit:
+            self._handle_out_of_order_data(chunk)
+            return
+
         if chunk.offset != self._offset:
             # Initially, the transfer service only supports in-order transfers.
             # If data is received out of order, request that the server
@@ -777,8 +843,21 @@ class ReadTransfer(Transfer):
 
             self._window_end_offset = chunk.window_end_offset
 
+        # Filling a gap may join the data up with data that arrived out of
+        # order.
+        self._merge_out_of_order_data()
+
+        if (
+            self._final_offset is not None
+            and self._offset >= self._final_offset
+        ):
+            self._send_final_chunk(Status.OK)
+            return
+
+        # Missing data is requested at the end of the window, so the window is
+        # not extended while there are gaps in it.
         remaining_window_size = self._window_end_offset - self._offset
-        extend_window = (
+        extend_window = not self._out_of_order_data and (
             remaining_window_size
             <= self._max_bytes_to_receive / ReadTransfer.EXTEND_WINDOW_DIVISOR
         )
@@ -794,6 +873,62 @@ class ReadTransfer(Transfer):
                 self._transfer_parameters(Chunk.Type.PARAMETERS_CONTINUE)
             )
 
+    def _handle_out_of_order_data(self, chunk: Chunk) -> None:
+        """Stores data received beyond the current offset.
+
+        Once the server has sent its whole window, requests only the missing
+        data.
+        """
+        end_offset = chunk.offset + len(chunk.data)
+
+        if end_offset > self._window_end_offset:
+            # Data sent against an earlier window. It will be sent again once
+            # the window reaches it.
+            return
+
+        _LOG.debug(
+            'Transfer %d expected offset %d, received [%d, %d)',
+            self.id,
+            self._offset,
+            chunk.offset,
+            end_offset,
+        )
+
+        self._out_of_order_data[chunk.offset] = chunk.data
+        self._last_chunk_offset = chunk.offset
+
+        final_chunk = chunk.remaining_bytes == 0
+        if final_chunk:
+            self._final_offset = end_offset
+
+        if end_offset == self._window_end_offset or final_chunk:
+            self._send_chunk(
+                self._transfer_parameters(Chunk.Type.PARAMETERS_RETRANSMIT)
+            )
+
+    def _merge_out_of_order_data(self) -> None:
+        """Appends out-of-order data that now follows the current offset."""
+        for start in sorted(self._out_of_order_data):
+            if start > self._offset:
+                break
+
+            data = self._out_of_order_data.pop(start)
+            end = start + len(data)
+            if end > self._offset:
+                self._data += data[self._offset - start :]
+                self._offset = end
+
+    def _received_ranges(self) -> List[Tuple[int, int]]:
+        """Returns the merged ranges of data received out of order."""
+        ranges: List[Tuple[int, int]] = []
+        for start in sorted(self._out_of_order_data):
+            end = start + len(self._out_of_order_data[start])
+            if ranges and start <= ranges[-1][1]:
+                ranges[-1] = (ranges[-1][0], max(end, ranges[-1][1]))
+            else:
+                ranges.append((start, end))
+        return ranges
+
     def _retry_after_data_timeout(self) -> None:
         if (
             self._state is Transfer._State.WAITING
@@ -809,6 +944,7 @@ class ReadTransfer(Transfer):
         chunk.offset = self._offset
         chunk.window_end_offset = self._window_end_offset
         chunk.max_chunk_size_bytes = self._max_chunk_size
+        chunk.received_ranges = self._received_ranges()
 
         if self._chunk_delay_us:
             chunk.min_delay_microseconds = self._chunk_delay_us
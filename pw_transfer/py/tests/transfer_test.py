@@ -826,6 +826,7 @@ class TransferManagerTest(unittest.TestCase):
                     window_end_offset=8192,
                     type=transfer_pb2.Chunk.Type.START,
                     protocol_version=ProtocolVersion.VERSION_TWO.value,
+                    features=transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT,
                 ),
                 transfer_pb2.Chunk(
                     session_id=_FIRST_SESSION_ID,
@@ -885,6 +886,7 @@ class TransferManagerTest(unittest.TestCase):
                     window_end_offset=8192,
                     type=transfer_pb2.Chunk.Type.START,
                     protocol_version=ProtocolVersion.VERSION_TWO.value,
+                    features=transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT,
                 ),
                 transfer_pb2.Chunk(
                     transfer_id=40,
@@ -946,6 +948,7 @@ class TransferManagerTest(unittest.TestCase):
                     desired_session_id=_FIRST_SESSION_ID,
                     type=transfer_pb2.Chunk.Type.START,
                     protocol_version=ProtocolVersion.VERSION_TWO.value,
+                    features=transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT,
                 ),
                 transfer_pb2.Chunk(
                     session_id=_FIRST_SESSION_ID,
@@ -1018,6 +1021,7 @@ class TransferManagerTest(unittest.TestCase):
                     desired_session_id=_FIRST_SESSION_ID,
                     type=transfer_pb2.Chunk.Type.START,
                     protocol_version=ProtocolVersion.VERSION_TWO.value,
+                    features=transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT,
                 ),
                 transfer_pb2.Chunk(
                     transfer_id=76,
@@ -1037,6 +1041,155 @@ class TransferManagerTest(unittest.TestCase):
 
         self.assertEqual(self._received_data(), b'write v... NOPE')
 
+    def test_v2_read_transfer_selective_retransmit(self) -> None:
+        """Tests a v2 read transfer which only re-requests missing data."""
+        manager = pw_transfer.Manager(
+            self._service,
+            default_response_timeout_s=DEFAULT_TIMEOUT_S,
+            default_protocol_version=ProtocolVersion.VERSION_TWO,
+        )
+
+        self._enqueue_server_responses(
+            _Method.READ,
+            (
+                (
+                    transfer_pb2.Chunk(
+                        resource_id=44,
+                        session_id=_FIRST_SESSION_ID,
+                        type=transfer_pb2.Chunk.Type.START_ACK,
+                        protocol_version=ProtocolVersion.VERSION_TWO.value,
+                        features=(
+                            transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT
+                        ),
+                    ),
+                ),
+                (
+                    transfer_pb2.Chunk(
+                        session_id=_FIRST_SESSION_ID,
+                        type=transfer_pb2.Chunk.Type.DATA,
+                        offset=0,
+                        data=b'abc',
+                    ),
+                    # The chunk at offset 3 is lost.
+                    transfer_pb2.Chunk(
+                        session_id=_FIRST_SESSION_ID,
+                        type=transfer_pb2.Chunk.Type.DATA,
+                        offset=6,
+                        data=b'ghi',
+                        remaining_bytes=0,
+                    ),
+                ),
+                (
+                    transfer_pb2.Chunk(
+                        session_id=_FIRST_SESSION_ID,
+                        type=transfer_pb2.Chunk.Type.DATA,
+                        offset=3,
+                        data=b'def',
+                    ),
+                ),
+                (
+                    transfer_pb2.Chunk(
+                        session_id=_FIRST_SESSION_ID,
+                        type=transfer_pb2.Chunk.Type.COMPLETION_ACK,
+                    ),
+                ),
+            ),
+        )
+
+        data = manager.read(44)
+        self.assertEqual(data, b'abcdefghi')
+
+        self.assertEqual(len(self._sent_chunks), 4)
+        self.assertEqual(
+            self._sent_chunks[2],
+            transfer_pb2.Chunk(
+                session_id=_FIRST_SESSION_ID,
+                type=transfer_pb2.Chunk.Type.PARAMETERS_RETRANSMIT,
+                offset=3,
+                window_end_offset=8195,
+                max_chunk_size_bytes=1024,
+                received_ranges=[6, 9],
+            ),
+        )
+        self.assertEqual(
+            self._sent_chunks[3].type, transfer_pb2.Chunk.Type.COMPLETION
+        )
+        self.assertEqual(self._sent_chunks[3].status, Status.OK.value)
+
+    def test_v2_write_transfer_selective_retransmit(self) -> None:
+        """Tests a v2 write transfer which skips data the server has."""
+        manager = pw_transfer.Manager(
+            self._service,
+            default_response_timeout_s=DEFAULT_TIMEOUT_S,
+            default_protocol_version=ProtocolVersion.VERSION_TWO,
+        )
+
+        self._enqueue_server_responses(
+            _Method.WRITE,
+            (
+                (
+                    transfer_pb2.Chunk(
+                        resource_id=73,
+                        session_id=_FIRST_SESSION_ID,
+                        type=transfer_pb2.Chunk.Type.START_ACK,
+                        protocol_version=ProtocolVersion.VERSION_TWO.value,
+                        features=(
+                            transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT
+                        ),
+                    ),
+                ),
+                (
+                    transfer_pb2.Chunk(
+                        session_id=_FIRST_SESSION_ID,
+                        type=transfer_pb2.Chunk.Type.PARAMETERS_RETRANSMIT,
+                        offset=0,
+                        window_end_offset=32,
+                        max_chunk_size_bytes=8,
+                    ),
+                ),
+                (),  # In response to the first data chunk.
+                (),  # In response to the second data chunk.
+                (
+                    # The second chunk was lost, but the final one arrived.
+                    transfer_pb2.Chunk(
+                        session_id=_FIRST_SESSION_ID,
+                        type=transfer_pb2.Chunk.Type.PARAMETERS_RETRANSMIT,
+                        offset=8,
+                        window_end_offset=40,
+                        max_chunk_size_bytes=8,
+                        received_ranges=[16, 21],
+                    ),
+                ),
+                (
+                    transfer_pb2.Chunk(
+                        session_id=_FIRST_SESSION_ID,
+                        type=transfer_pb2.Chunk.Type.COMPLETION,
+                        status=Status.OK.value,
+                    ),
+                ),
+            ),
+        )
+
+        manager.write(73, b'pigweed data transfer')
+
+        data_chunks = [
+            chunk
+            for chunk in self._sent_chunks
+            if chunk.type == transfer_pb2.Chunk.Type.DATA
+        ]
+        self.assertEqual(
+            [(chunk.offset, chunk.data) for chunk in data_chunks],
+            [
+                (0, b'pigweed '),
+                (8, b'data tra'),
+                (16, b'nsfer'),
+                (8, b'data tra'),
+            ],
+        )
+        self.assertEqual(
+            self._sent_chunks[-1].type, transfer_pb2.Chunk.Type.COMPLETION_ACK
+        )
+
     def test_v2_server_error(self) -> None:
         """Tests a server error occurring during the opening handshake."""
 
@@ -1082,6 +1235,7 @@ class TransferManagerTest(unittest.TestCase):
                     window_end_offset=8192,
                     type=transfer_pb2.Chunk.Type.START,
                     protocol_version=ProtocolVersion.VERSION_TWO.value,
+                    features=transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT,
                 ),
                 transfer_pb2.Chunk(
                     session_id=_FIRST_SESSION_ID,
@@ -1124,6 +1278,7 @@ class TransferManagerTest(unittest.TestCase):
             window_end_offset=8192,
             type=transfer_pb2.Chunk.Type.START,
             protocol_version=ProtocolVersion.VERSION_TWO.value,
+            features=transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT,
         )
 
         # The opening chunk should be sent initially, then retried three times.
@@ -1191,6 +1346,7 @@ class TransferManagerTest(unittest.TestCase):
                     desired_session_id=_FIRST_SESSION_ID,
                     type=transfer_pb2.Chunk.Type.START,
                     protocol_version=ProtocolVersion.VERSION_TWO.value,
+                    features=transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT,
                 ),
                 start_ack_confirmation,  # Initial transmission
                 start_ack_confirmation,  # Retry 1
@@ -1279,6 +1435,7 @@ class TransferManagerTest(unittest.TestCase):
                     window_end_offset=8192,
                     type=transfer_pb2.Chunk.Type.START,
                     protocol_version=ProtocolVersion.VERSION_TWO.value,
+                    features=transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT,
                 ),
                 transfer_pb2.Chunk(
                     session_id=_FIRST_SESSION_ID,
@@ -1349,6 +1506,7 @@ class TransferManagerTest(unittest.TestCase):
                     window_end_offset=8192,
                     type=transfer_pb2.Chunk.Type.START,
                     protocol_version=ProtocolVersion.VERSION_TWO.value,
+                    features=transfer_pb2.Chunk.Feature.SELECTIVE_RETRANSMIT,
                 ),
                 transfer_pb2.Chunk(
                     session_id=_FIRST_SESSION_ID,
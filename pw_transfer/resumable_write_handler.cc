@@ -0,0 +1,110 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/resumable_write_handler.h"
+
+#include "pw_checksum/crc32.h"
+#include "pw_log/log.h"
+#include "pw_status/try.h"
+
+namespace pw::transfer {
+
+Status ResumableWriteHandler::PrepareWrite() {
+  ClearProgress();
+  return PrepareDestination(0, 0);
+}
+
+Result<uint32_t> ResumableWriteHandler::PrepareResumableWrite() {
+  Progress progress;
+  if (Status status = kvs_.Get(kvs_key_, &progress);
+      status.ok() && progress.resource_id == id() && progress.offset != 0) {
+    status = PrepareDestination(progress.offset, progress.checksum);
+    if (status.ok()) {
+      PW_LOG_INFO("Resuming write to resource %u at offset %u",
+                  static_cast<unsigned>(id()),
+                  static_cast<unsigned>(progress.offset));
+      offset_ = progress.offset;
+      checksum_ = progress.checksum;
+      saved_offset_ = progress.offset;
+      return offset_;
+    }
+    PW_LOG_WARN("Cannot resume write to resource %u at offset %u (status %u)",
+                static_cast<unsigned>(id()),
+                static_cast<unsigned>(progress.offset),
+                status.code());
+  }
+
+  PW_TRY(PrepareWrite());
+  return 0u;
+}
+
+Status ResumableWriteHandler::FinalizeWrite(Status status) {
+  if (status.ok()) {
+    ClearProgress();
+  } else {
+    SaveProgress().IgnoreError();  // Resuming is best effort.
+  }
+  return OkStatus();
+}
+
+Status ResumableWriteHandler::PrepareDestination(uint32_t offset, uint32_t) {
+  stream::Writer& writer = destination();
+  if (offset == 0) {
+    return writer.seekable(stream::Stream::kBeginning) ? writer.Seek(0)
+                                                       : OkStatus();
+  }
+  if (!writer.seekable(stream::Stream::kBeginning)) {
+    return Status::Unimplemented();
+  }
+  return writer.Seek(static_cast<ptrdiff_t>(offset));
+}
+
+Status ResumableWriteHandler::SaveProgress() {
+  if (offset_ == saved_offset_) {
+    return OkStatus();
+  }
+  PW_TRY(kvs_.Put(kvs_key_,
+                  Progress{
+                      .resource_id = id(),
+                      .offset = offset_,
+                      .checksum = checksum_,
+                  }));
+  saved_offset_ = offset_;
+  return OkStatus();
+}
+
+void ResumableWriteHandler::ClearProgress() {
+  // NOT_FOUND is expected if no progress was saved.
+  kvs_.Delete(kvs_key_).IgnoreError();
+  offset_ = 0;
+  checksum_ = 0;
+  saved_offset_ = 0;
+}
+
+Status ResumableWriteHandler::ProgressWriter::DoWrite(ConstByteSpan data) {
+  PW_TRY(destination_.Write(data));
+
+  handler_.checksum_ =
+      pw_checksum_Crc32Append(data.data(), data.size(), handler_.checksum_);
+  handler_.offset_ += static_cast<uint32_t>(data.size());
+
+  if (handler_.offset_ - handler_.saved_offset_ >=
+      handler_.save_interval_bytes_) {
+    // A failed save only means that more data is sent again after a resume.
+    handler_.SaveProgress().IgnoreError();
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::transfer
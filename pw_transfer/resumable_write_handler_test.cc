@@ -0,0 +1,179 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/resumable_write_handler.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/array.h"
+#include "pw_checksum/crc32.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::transfer {
+namespace {
+
+constexpr auto kData = bytes::Initialized<64>([](size_t i) { return i; });
+constexpr uint32_t kResourceId = 7;
+constexpr size_t kSaveInterval = 16;
+
+class ResumableWriteHandlerTest : public ::testing::Test {
+ protected:
+  ResumableWriteHandlerTest()
+      : partition_(&flash_),
+        kvs_(&partition_, {.magic = 0x600dc0de, .checksum = &checksum_}),
+        destination_(buffer_) {
+    EXPECT_EQ(kvs_.Init(), OkStatus());
+  }
+
+  // Writes kData[start, end) through the handler's writer.
+  void Write(ResumableWriteHandler& handler, size_t start, size_t end) {
+    for (size_t i = start; i < end; i += 8) {
+      ASSERT_EQ(handler.writer().Write(span(kData).subspan(i, 8)), OkStatus());
+    }
+  }
+
+  kvs::FakeFlashMemoryBuffer<512, 4> flash_;
+  kvs::FlashPartition partition_;
+  kvs::ChecksumCrc16 checksum_;
+  kvs::KeyValueStoreBuffer<8, 4> kvs_;
+  std::array<std::byte, kData.size()> buffer_{};
+  stream::MemoryWriter destination_;
+};
+
+TEST_F(ResumableWriteHandlerTest, ResumesAtSavedOffset) {
+  {
+    ResumableWriteHandler handler(
+        kResourceId, destination_, kvs_, "resume", kSaveInterval);
+    Result<uint32_t> offset = handler.PrepareResumableWrite();
+    ASSERT_EQ(offset.status(), OkStatus());
+    EXPECT_EQ(*offset, 0u);
+
+    // Progress is saved every 16 bytes.
+    Write(handler, 0, 40);
+    EXPECT_EQ(handler.offset(), 40u);
+  }
+
+  ResumableWriteHandler handler(
+      kResourceId, destination_, kvs_, "resume", kSaveInterval);
+  Result<uint32_t> offset = handler.PrepareResumableWrite();
+  ASSERT_EQ(offset.status(), OkStatus());
+  EXPECT_EQ(*offset, 32u);
+  EXPECT_EQ(destination_.bytes_written(), 32u);
+  EXPECT_EQ(handler.checksum(),
+            checksum::Crc32::Calculate(span(kData).first(32)));
+
+  Write(handler, 32, kData.size());
+  EXPECT_EQ(handler.checksum(), checksum::Crc32::Calculate(kData));
+  EXPECT_EQ(handler.FinalizeWrite(OkStatus()), OkStatus());
+  EXPECT_EQ(std::memcmp(buffer_.data(), kData.data(), kData.size()), 0);
+}
+
+TEST_F(ResumableWriteHandlerTest, FailedWriteSavesProgress) {
+  {
+    ResumableWriteHandler handler(
+        kResourceId, destination_, kvs_, "resume", kSaveInterval);
+    ASSERT_EQ(handler.PrepareResumableWrite().status(), OkStatus());
+    Write(handler, 0, 24);
+    EXPECT_EQ(handler.FinalizeWrite(Status::DeadlineExceeded()), OkStatus());
+  }
+
+  ResumableWriteHandler handler(
+      kResourceId, destination_, kvs_, "resume", kSaveInterval);
+  Result<uint32_t> offset = handler.PrepareResumableWrite();
+  ASSERT_EQ(offset.status(), OkStatus());
+  EXPECT_EQ(*offset, 24u);
+}
+
+TEST_F(ResumableWriteHandlerTest, CompletedWriteStartsOver) {
+  {
+    ResumableWriteHandler handler(
+        kResourceId, destination_, kvs_, "resume", kSaveInterval);
+    ASSERT_EQ(handler.PrepareResumableWrite().status(), OkStatus());
+    Write(handler, 0, 32);
+    EXPECT_EQ(handler.FinalizeWrite(OkStatus()), OkStatus());
+  }
+
+  ResumableWriteHandler handler(
+      kResourceId, destination_, kvs_, "resume", kSaveInterval);
+  Result<uint32_t> offset = handler.PrepareResumableWrite();
+  ASSERT_EQ(offset.status(), OkStatus());
+  EXPECT_EQ(*offset, 0u);
+  EXPECT_EQ(destination_.bytes_written(), 0u);
+}
+
+TEST_F(ResumableWriteHandlerTest, PrepareWriteDiscardsProgress) {
+  ResumableWriteHandler handler(
+      kResourceId, destination_, kvs_, "resume", kSaveInterval);
+  ASSERT_EQ(handler.PrepareResumableWrite().status(), OkStatus());
+  Write(handler, 0, 32);
+
+  ASSERT_EQ(handler.PrepareWrite(), OkStatus());
+  EXPECT_EQ(handler.offset(), 0u);
+  EXPECT_EQ(handler.checksum(), 0u);
+
+  Result<uint32_t> offset = handler.PrepareResumableWrite();
+  ASSERT_EQ(offset.status(), OkStatus());
+  EXPECT_EQ(*offset, 0u);
+}
+
+TEST_F(ResumableWriteHandlerTest, OtherResourceIsNotResumed) {
+  {
+    ResumableWriteHandler handler(
+        kResourceId, destination_, kvs_, "resume", kSaveInterval);
+    ASSERT_EQ(handler.PrepareResumableWrite().status(), OkStatus());
+    Write(handler, 0, 32);
+  }
+
+  ResumableWriteHandler handler(
+      kResourceId + 1, destination_, kvs_, "resume", kSaveInterval);
+  Result<uint32_t> offset = handler.PrepareResumableWrite();
+  ASSERT_EQ(offset.status(), OkStatus());
+  EXPECT_EQ(*offset, 0u);
+}
+
+// Only appends to the destination, so writes cannot be resumed.
+class AppendingWriter final : public stream::NonSeekableWriter {
+ public:
+  size_t bytes_written = 0;
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    bytes_written += data.size();
+    return OkStatus();
+  }
+};
+
+TEST_F(ResumableWriteHandlerTest, NonSeekableDestinationStartsOver) {
+  AppendingWriter writer;
+  {
+    ResumableWriteHandler handler(
+        kResourceId, writer, kvs_, "resume", kSaveInterval);
+    ASSERT_EQ(handler.PrepareResumableWrite().status(), OkStatus());
+    Write(handler, 0, 32);
+  }
+
+  ResumableWriteHandler handler(
+      kResourceId, writer, kvs_, "resume", kSaveInterval);
+  Result<uint32_t> offset = handler.PrepareResumableWrite();
+  ASSERT_EQ(offset.status(), OkStatus());
+  EXPECT_EQ(*offset, 0u);
+}
+
+}  // namespace
+}  // namespace pw::transfer
@@ -426,6 +426,68 @@ TEST_F(ReadTransfer, HandlerIsClearedAfterTransfer) {
   ASSERT_FALSE(handler_.finalize_read_called);
 }
 
+// Serves data from readable memory. Its reader always fails, so a transfer only
+// succeeds if chunks are encoded directly from the memory.
+class MemoryMappedReadHandler final : public ReadOnlyHandler {
+ public:
+  MemoryMappedReadHandler(uint32_t resource_id, ConstByteSpan data)
+      : ReadOnlyHandler(resource_id), data_(data), reader_(data) {
+    reader_.read_status = Status::Internal();
+    set_reader(reader_);
+  }
+
+  ConstByteSpan ReadableMemory() final { return data_; }
+
+ private:
+  ConstByteSpan data_;
+  TestMemoryReader reader_;
+};
+
+TEST_F(ReadTransfer, ReadableMemory_EncodesChunksFromMemory) {
+  MemoryMappedReadHandler handler(7, kData);
+  ctx_.service().RegisterHandler(handler);
+
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kStart)
+                      .set_session_id(7)
+                      .set_window_end_offset(20)
+                      .set_offset(0)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk c0 = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(c0.session_id(), 7u);
+  EXPECT_EQ(c0.offset(), 0u);
+  ASSERT_EQ(c0.payload().size(), 20u);
+  EXPECT_EQ(std::memcmp(c0.payload().data(), kData.data(), 20), 0);
+
+  // Rewinding is supported without seeking the reader.
+  rpc::test::WaitForPackets(ctx_.output(), 2, [this] {
+    ctx_.SendClientStream(EncodeChunk(
+        Chunk(ProtocolVersion::kLegacy, Chunk::Type::kParametersRetransmit)
+            .set_session_id(7)
+            .set_window_end_offset(64)
+            .set_offset(10)));
+  });
+
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  Chunk c1 = DecodeChunk(ctx_.responses()[1]);
+  EXPECT_EQ(c1.offset(), 10u);
+  ASSERT_EQ(c1.payload().size(), 22u);
+  EXPECT_EQ(std::memcmp(c1.payload().data(), kData.data() + 10, 22), 0);
+
+  Chunk c2 = DecodeChunk(ctx_.responses()[2]);
+  EXPECT_FALSE(c2.has_payload());
+  ASSERT_TRUE(c2.remaining_bytes().has_value());
+  EXPECT_EQ(c2.remaining_bytes().value(), 0u);
+
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk::Final(ProtocolVersion::kLegacy, 7, OkStatus())));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ctx_.service().UnregisterHandler(handler);
+}
+
 class ReadTransferMaxChunkSize8 : public ReadTransfer {
  protected:
   ReadTransferMaxChunkSize8() : ReadTransfer(/*max_chunk_size_bytes=*/8) {}
@@ -2592,5 +2654,112 @@ TEST_F(WriteTransfer, Version2_RegularSessionIdInStartChunk) {
   EXPECT_EQ(chunk.status().value(), Status::DataLoss());
 }
 
+// Resumes writes at offset 16, as if the first 16 bytes were written by an
+// earlier, interrupted transfer.
+class ResumingWriteHandler final : public WriteOnlyHandler {
+ public:
+  ResumingWriteHandler(uint32_t resource_id, ByteSpan data)
+      : WriteOnlyHandler(resource_id), writer_(data) {
+    set_writer(writer_);
+  }
+
+  Status PrepareWrite() final { return writer_.Seek(0); }
+
+  Result<uint32_t> PrepareResumableWrite() final {
+    PW_TRY(writer_.Seek(16));
+    return 16u;
+  }
+
+ private:
+  stream::MemoryWriter writer_;
+};
+
+TEST_F(WriteTransfer, Version2_ResumesWriteIfClientSupportsIt) {
+  std::array<std::byte, kData.size()> resumed_buffer{};
+  std::memcpy(resumed_buffer.data(), kData.data(), 16);
+  ResumingWriteHandler handler(8, resumed_buffer);
+  ctx_.service().RegisterHandler(handler);
+
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStart)
+                      .set_desired_session_id(kArbitrarySessionId)
+                      .set_resource_id(8)
+                      .set_features(static_cast<uint32_t>(
+                          Chunk::Feature::kResume))));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kStartAck);
+  EXPECT_TRUE(chunk.has_feature(Chunk::Feature::kResume));
+
+  ctx_.SendClientStream(EncodeChunk(
+      Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStartAckConfirmation)
+          .set_session_id(kArbitrarySessionId)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  // The server asks for the data following what it already has.
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.offset(), 16u);
+  EXPECT_EQ(chunk.window_end_offset(), 32u);
+
+  ctx_.SendClientStream<64>(
+      EncodeChunk(Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kData)
+                      .set_session_id(kArbitrarySessionId)
+                      .set_offset(16)
+                      .set_payload(span(kData).subspan(16))
+                      .set_remaining_bytes(0)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kCompletion);
+  ASSERT_TRUE(chunk.status().has_value());
+  EXPECT_EQ(chunk.status().value(), OkStatus());
+  EXPECT_EQ(std::memcmp(resumed_buffer.data(), kData.data(), kData.size()), 0);
+
+  ctx_.SendClientStream(EncodeChunk(
+      Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kCompletionAck)
+          .set_session_id(kArbitrarySessionId)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ctx_.service().UnregisterHandler(handler);
+}
+
+TEST_F(WriteTransfer, Version2_DoesNotResumeIfClientDoesNotSupportIt) {
+  std::array<std::byte, kData.size()> resumed_buffer{};
+  ResumingWriteHandler handler(8, resumed_buffer);
+  ctx_.service().RegisterHandler(handler);
+
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStart)
+                      .set_desired_session_id(kArbitrarySessionId)
+                      .set_resource_id(8)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kStartAck);
+  EXPECT_FALSE(chunk.has_feature(Chunk::Feature::kResume));
+
+  ctx_.SendClientStream(EncodeChunk(
+      Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStartAckConfirmation)
+          .set_session_id(kArbitrarySessionId)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.offset(), 0u);
+
+  ctx_.SendClientStream(EncodeChunk(Chunk::Final(
+      ProtocolVersion::kVersionTwo, kArbitrarySessionId, Status::Cancelled())));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ctx_.service().UnregisterHandler(handler);
+}
+
 }  // namespace
 }  // namespace pw::transfer::test
@@ -16,6 +16,8 @@
 
 #include "pw_transfer/transfer_thread.h"
 
+#include <mutex>
+
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
 #include "pw_transfer/internal/chunk.h"
@@ -26,19 +28,28 @@ PW_MODIFY_DIAGNOSTIC(ignored, "-Wmissing-field-initializers");
 namespace pw::transfer::internal {
 
 void TransferThread::Terminate() {
+  for (TransferThread* worker : workers_) {
+    worker->Terminate();
+  }
+
   next_event_ownership_.acquire();
   next_event_.type = EventType::kTerminate;
-  event_notification_.release();
+  PostEvent();
 }
 
 void TransferThread::SimulateTimeout(EventType type, uint32_t session_id) {
+  if (TransferThread& worker = WorkerFor(session_id); &worker != this) {
+    worker.SimulateTimeout(type, session_id);
+    return;
+  }
+
   next_event_ownership_.acquire();
 
   next_event_.type = type;
   next_event_.chunk = {};
   next_event_.chunk.context_identifier = session_id;
 
-  event_notification_.release();
+  PostEvent();
 
   WaitUntilEventIsProcessed();
 }
@@ -49,16 +60,7 @@ void TransferThread::Run() {
 
   while (true) {
     if (event_notification_.try_acquire_until(GetNextTransferTimeout())) {
-      HandleEvent(next_event_);
-
-      // Sample event type before we release ownership of next_event_.
-      bool is_terminating = next_event_.type == EventType::kTerminate;
-
-      // Finished processing the event. Allow the next_event struct to be
-      // overwritten.
-      next_event_ownership_.release();
-
-      if (is_terminating) {
+      if (ProcessEvents()) {
         return;
       }
     }
@@ -78,6 +80,124 @@ void TransferThread::Run() {
   }
 }
 
+bool TransferThread::ProcessEvents() {
+  const size_t slot_size = chunk_queue_slot_size(chunk_buffer_.size());
+
+  while (true) {
+    std::byte* slot = nullptr;
+    {
+      std::lock_guard lock(queue_lock_);
+      if (event_ready_ && chunks_before_event_ == 0u) {
+        event_ready_ = false;
+      } else if (queued_chunks_ > 0u) {
+        slot = &chunk_queue_[queue_read_ * slot_size];
+      } else {
+        return false;
+      }
+    }
+
+    if (slot == nullptr) {
+      HandleEvent(next_event_);
+
+      // Sample event type before we release ownership of next_event_.
+      bool is_terminating = next_event_.type == EventType::kTerminate;
+
+      // Finished processing the event. Allow the next_event struct to be
+      // overwritten.
+      next_event_ownership_.release();
+
+      if (is_terminating) {
+        return true;
+      }
+      continue;
+    }
+
+    // The chunk is processed in place. Its slot is not reused until it is
+    // released below.
+    QueuedChunk header;
+    std::memcpy(&header, slot, sizeof(header));
+    HandleEvent(Event{
+        .type = header.type,
+        .chunk =
+            ChunkEvent{
+                .context_identifier = header.context_identifier,
+                .match_resource_id = header.match_resource_id,
+                .data = slot + sizeof(header),
+                .size = header.size,
+            },
+    });
+
+    std::lock_guard lock(queue_lock_);
+    queue_read_ = (queue_read_ + 1) % chunk_queue_slots_;
+    queued_chunks_ -= 1;
+    if (event_ready_ && chunks_before_event_ > 0u) {
+      chunks_before_event_ -= 1;
+    }
+  }
+}
+
+void TransferThread::PostEvent() {
+  {
+    std::lock_guard lock(queue_lock_);
+    event_ready_ = true;
+    chunks_before_event_ = queued_chunks_;
+  }
+  event_notification_.release();
+}
+
+bool TransferThread::QueueChunk(EventType type,
+                                const Chunk::Identifier& identifier,
+                                ConstByteSpan chunk) {
+  const QueuedChunk header = {
+      .type = type,
+      .match_resource_id = identifier.is_legacy(),
+      .context_identifier = identifier.value(),
+      .size = static_cast<uint32_t>(chunk.size()),
+  };
+
+  std::lock_guard lock(queue_lock_);
+  if (queued_chunks_ == chunk_queue_slots_) {
+    return false;
+  }
+
+  const size_t index = (queue_read_ + queued_chunks_) % chunk_queue_slots_;
+  std::byte* slot =
+      &chunk_queue_[index * chunk_queue_slot_size(chunk_buffer_.size())];
+  std::memcpy(slot, &header, sizeof(header));
+  std::memcpy(slot + sizeof(header), chunk.data(), chunk.size());
+
+  // The transfer thread keeps processing chunks until the queue is empty, so it
+  // only has to be woken up for the first one.
+  queued_chunks_ += 1;
+  if (queued_chunks_ == 1u) {
+    event_notification_.release();
+  }
+  return true;
+}
+
+void TransferThread::WaitUntilEventIsProcessed() {
+  next_event_ownership_.acquire();
+
+  bool chunks_queued;
+  {
+    std::lock_guard lock(queue_lock_);
+    chunks_queued = queued_chunks_ != 0u;
+  }
+
+  // Queued chunks are processed before any event posted after them.
+  if (chunks_queued) {
+    next_event_.type = EventType::kFlushChunkQueue;
+    PostEvent();
+    next_event_ownership_.acquire();
+  }
+
+  next_event_ownership_.release();
+
+  for (TransferThread* worker : workers_) {
+    worker->WaitUntilEventIsProcessed();
+  }
+}
+
 chrono::SystemClock::time_point TransferThread::GetNextTransferTimeout() const {
   chrono::SystemClock::time_point timeout =
       chrono::SystemClock::TimePointAfterAtLeast(kMaxTimeout);
@@ -110,12 +230,44 @@ void TransferThread::StartTransfer(
     chrono::SystemClock::duration timeout,
     chrono::SystemClock::duration initial_timeout,
     uint8_t max_retries,
-    uint32_t max_lifetime_retries) {
+    uint32_t max_lifetime_retries,
+    uint32_t initial_offset) {
+  bool is_client_transfer = stream != nullptr;
+
+  if (!workers_.empty()) {
+    // Session IDs must be unique across all workers, so they are assigned here
+    // before picking the worker for the transfer.
+    if (is_client_transfer && version != ProtocolVersion::kLegacy &&
+        session_id == Context::kUnassignedSessionId) {
+      next_event_ownership_.acquire();
+      session_id = AssignSessionId();
+      next_event_ownership_.release();
+    }
+
+    // Legacy transfers are identified by their resource ID.
+    const uint32_t worker_id =
+        version == ProtocolVersion::kLegacy ? resource_id : session_id;
+    if (TransferThread& worker = WorkerFor(worker_id); &worker != this) {
+      worker.StartTransfer(type,
+                           version,
+                           session_id,
+                           resource_id,
+                           raw_chunk,
+                           stream,
+                           max_parameters,
+                           std::move(on_completion),
+                           timeout,
+                           initial_timeout,
+                           max_retries,
+                           max_lifetime_retries,
+                           initial_offset);
+      return;
+    }
+  }
+
   // Block until the last event has been processed.
   next_event_ownership_.acquire();
 
-  bool is_client_transfer = stream != nullptr;
-
   if (is_client_transfer) {
     if (version == ProtocolVersion::kLegacy) {
       session_id = resource_id;
@@ -136,6 +288,7 @@ void TransferThread::StartTransfer(
       .protocol_version = version,
       .session_id = session_id,
       .resource_id = resource_id,
+      .initial_offset = initial_offset,
       .max_parameters = &max_parameters,
       .timeout = timeout,
       .initial_timeout = initial_timeout,
@@ -153,18 +306,18 @@ void TransferThread::StartTransfer(
   // with the specified ID.
   if (is_client_transfer) {
     next_event_.new_transfer.stream = stream;
-    next_event_.new_transfer.rpc_writer = &static_cast<rpc::Writer&>(
-        type == TransferType::kTransmit ? client_write_stream_
-                                        : client_read_stream_);
+    next_event_.new_transfer.rpc_writer =
+        &stream_for(type == TransferType::kTransmit
+                        ? TransferStream::kClientWrite
+                        : TransferStream::kClientRead);
   } else {
-    auto handler = std::find_if(handlers_.begin(),
-                                handlers_.end(),
-                                [&](auto& h) { return h.id() == resource_id; });
-    if (handler != handlers_.end()) {
-      next_event_.new_transfer.handler = &*handler;
-      next_event_.new_transfer.rpc_writer = &static_cast<rpc::Writer&>(
-          type == TransferType::kTransmit ? server_read_stream_
-                                          : server_write_stream_);
+    Handler* handler = FindHandler(resource_id);
+    if (handler != nullptr) {
+      next_event_.new_transfer.handler = handler;
+      next_event_.new_transfer.rpc_writer =
+          &stream_for(type == TransferType::kTransmit
+                          ? TransferStream::kServerRead
+                          : TransferStream::kServerWrite);
     } else {
       // No handler exists for the transfer: return a NOT_FOUND.
       next_event_.type = EventType::kSendStatusChunk;
@@ -179,7 +332,7 @@ void TransferThread::StartTransfer(
     }
   }
 
-  event_notification_.release();
+  PostEvent();
 }
 
 void TransferThread::ProcessChunk(EventType type, ConstByteSpan chunk) {
@@ -195,7 +348,18 @@ void TransferThread::ProcessChunk(EventType type, ConstByteSpan chunk) {
     return;
   }
 
-  // Block until the last event has been processed.
+  if (TransferThread& worker = WorkerFor(identifier->value());
+      &worker != this) {
+    worker.ProcessChunk(type, chunk);
+    return;
+  }
+
+  if (QueueChunk(type, *identifier, chunk)) {
+    return;
+  }
+
+  // The chunk queue is full or disabled. Block until the last event has been
+  // processed.
   next_event_ownership_.acquire();
 
   std::memcpy(chunk_buffer_.data(), chunk.data(), chunk.size());
@@ -208,13 +372,18 @@ void TransferThread::ProcessChunk(EventType type, ConstByteSpan chunk) {
       .size = chunk.size(),
   };
 
-  event_notification_.release();
+  PostEvent();
 }
 
 void TransferThread::SendStatus(TransferStream stream,
                                 uint32_t session_id,
                                 ProtocolVersion version,
                                 Status status) {
+  if (TransferThread& worker = WorkerFor(session_id); &worker != this) {
+    worker.SendStatus(stream, session_id, version, status);
+    return;
+  }
+
   // Block until the last event has been processed.
   next_event_ownership_.acquire();
 
@@ -226,13 +395,18 @@ void TransferThread::SendStatus(TransferStream stream,
       .stream = stream,
   };
 
-  event_notification_.release();
+  PostEvent();
 }
 
 void TransferThread::EndTransfer(EventType type,
                                  uint32_t session_id,
                                  Status status,
                                  bool send_status_chunk) {
+  if (TransferThread& worker = WorkerFor(session_id); &worker != this) {
+    worker.EndTransfer(type, session_id, status, send_status_chunk);
+    return;
+  }
+
   // Block until the last event has been processed.
   next_event_ownership_.acquire();
 
@@ -243,7 +417,7 @@ void TransferThread::EndTransfer(EventType type,
       .send_status_chunk = send_status_chunk,
   };
 
-  event_notification_.release();
+  PostEvent();
 }
 
 void TransferThread::TransferHandlerEvent(EventType type, Handler& handler) {
@@ -257,7 +431,7 @@ void TransferThread::TransferHandlerEvent(EventType type, Handler& handler) {
     next_event_.remove_transfer_handler = &handler;
   }
 
-  event_notification_.release();
+  PostEvent();
 }
 
 void TransferThread::HandleEvent(const internal::Event& event) {
@@ -289,6 +463,11 @@ void TransferThread::HandleEvent(const internal::Event& event) {
         });
       }
 
+      // Workers share the primary thread's streams, which it closes.
+      if (primary_ != nullptr) {
+        return;
+      }
+
       // Cancel/Finish streams.
       client_read_stream_.Cancel().IgnoreError();
       client_write_stream_.Cancel().IgnoreError();
@@ -304,6 +483,9 @@ void TransferThread::HandleEvent(const internal::Event& event) {
       handlers_.push_front(*event.add_transfer_handler);
       return;
 
+    case EventType::kFlushChunkQueue:
+      return;
+
     case EventType::kRemoveTransferHandler:
       for (ServerContext& server_context : server_transfers_) {
         if (server_context.handler() == event.remove_transfer_handler) {
@@ -318,7 +500,9 @@ void TransferThread::HandleEvent(const internal::Event& event) {
           });
         }
       }
-      handlers_.remove(*event.remove_transfer_handler);
+      if (primary_ == nullptr) {
+        handlers_.remove(*event.remove_transfer_handler);
+      }
       return;
 
     case EventType::kNewClientTransfer:
@@ -405,6 +589,7 @@ Context* TransferThread::FindContextForEvent(
     case EventType::kAddTransferHandler:
     case EventType::kRemoveTransferHandler:
     case EventType::kTerminate:
+    case EventType::kFlushChunkQueue:
     default:
       return nullptr;
   }
@@ -431,6 +616,23 @@ void TransferThread::SendStatusChunk(
   }
 }
 
+// Should only be called with the `next_event_ownership_` lock held.
+Handler* TransferThread::FindHandler(uint32_t resource_id) {
+  if (primary_ != nullptr) {
+    // Handlers are registered with the primary thread. Hold its event lock so
+    // the list is not modified while it is searched.
+    primary_->next_event_ownership_.acquire();
+    Handler* handler = primary_->FindHandler(resource_id);
+    primary_->next_event_ownership_.release();
+    return handler;
+  }
+
+  auto handler = std::find_if(handlers_.begin(),
+                              handlers_.end(),
+                              [&](auto& h) { return h.id() == resource_id; });
+  return handler != handlers_.end() ? &*handler : nullptr;
+}
+
 // Should only be called with the `next_event_ownership_` lock held.
 uint32_t TransferThread::AssignSessionId() {
   uint32_t session_id = next_session_id_++;
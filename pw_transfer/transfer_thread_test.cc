@@ -345,5 +345,185 @@ TEST_F(TransferThreadTest, VersionTwo_NoHandler) {
   transfer_thread_.RemoveTransferHandler(handler);
 }
 
+class QueuedTransferThreadTest : public ::testing::Test {
+ public:
+  QueuedTransferThreadTest()
+      : ctx_(transfer_thread_, 512),
+        max_parameters_(chunk_buffer_.size(),
+                        chunk_buffer_.size(),
+                        cfg::kDefaultExtendWindowDivisor),
+        transfer_thread_(chunk_buffer_, encode_buffer_, chunk_queue_buffer_),
+        system_thread_(TransferThreadOptions(), transfer_thread_) {}
+
+  ~QueuedTransferThreadTest() override {
+    transfer_thread_.Terminate();
+    system_thread_.join();
+  }
+
+ protected:
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Read) ctx_;
+
+  std::array<std::byte, 64> chunk_buffer_;
+  std::array<std::byte, 64> encode_buffer_;
+  std::array<std::byte, 4 * TransferThread::chunk_queue_slot_size(64)>
+      chunk_queue_buffer_;
+
+  internal::TransferParameters max_parameters_;
+
+  transfer::Thread<1, 1> transfer_thread_;
+
+  thread::Thread system_thread_;
+};
+
+TEST_F(QueuedTransferThreadTest, ChunkQueueCapacity) {
+  EXPECT_EQ(transfer_thread_.chunk_queue_capacity(), 4u);
+}
+
+TEST_F(QueuedTransferThreadTest, QueuedChunksProcessedInOrder) {
+  auto reader_writer = ctx_.reader_writer();
+  transfer_thread_.SetServerReadStream(reader_writer);
+
+  SimpleReadTransfer handler(3, kData);
+  transfer_thread_.AddTransferHandler(handler);
+
+  transfer_thread_.StartServerTransfer(
+      internal::TransferType::kTransmit,
+      ProtocolVersion::kLegacy,
+      3,
+      3,
+      EncodeChunk(
+          Chunk(ProtocolVersion::kLegacy, Chunk::Type::kParametersRetransmit)
+              .set_session_id(3)
+              .set_window_end_offset(16)
+              .set_max_chunk_size_bytes(8)
+              .set_offset(0)),
+      max_parameters_,
+      std::chrono::seconds(2),
+      3,
+      10);
+
+  // Both chunks are queued without waiting for the transfer thread, and are
+  // processed after the transfer starts.
+  transfer_thread_.ProcessServerChunk(EncodeChunk(
+      Chunk(ProtocolVersion::kLegacy, Chunk::Type::kParametersRetransmit)
+          .set_session_id(3)
+          .set_window_end_offset(32)
+          .set_max_chunk_size_bytes(8)
+          .set_offset(16)));
+  transfer_thread_.ProcessServerChunk(
+      EncodeChunk(Chunk::Final(ProtocolVersion::kLegacy, 3, OkStatus())));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 4u);
+  for (size_t i = 0; i < 4; ++i) {
+    Chunk chunk = DecodeChunk(ctx_.responses()[i]);
+    EXPECT_EQ(chunk.session_id(), 3u);
+    EXPECT_EQ(chunk.offset(), 8 * i);
+    EXPECT_EQ(chunk.payload().size(), 8u);
+  }
+
+  EXPECT_TRUE(handler.finalize_read_called);
+  EXPECT_EQ(handler.finalize_read_status, OkStatus());
+
+  transfer_thread_.RemoveTransferHandler(handler);
+}
+
+class ParallelTransferThreadTest : public ::testing::Test {
+ public:
+  ParallelTransferThreadTest()
+      : ctx_(transfer_thread_, 512),
+        max_parameters_(64, 64, cfg::kDefaultExtendWindowDivisor),
+        primary_thread_(TransferThreadOptions(), transfer_thread_.worker(0)),
+        worker_thread_(TransferThreadOptions(), transfer_thread_.worker(1)) {}
+
+  ~ParallelTransferThreadTest() override {
+    transfer_thread_.Terminate();
+    primary_thread_.join();
+    worker_thread_.join();
+  }
+
+ protected:
+  // Two workers, each with a single server transfer context.
+  transfer::ParallelThread<2, 1, 1, 64, 64> transfer_thread_;
+
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Read) ctx_;
+  internal::TransferParameters max_parameters_;
+
+  thread::Thread primary_thread_;
+  thread::Thread worker_thread_;
+};
+
+TEST_F(ParallelTransferThreadTest, TransfersOnDifferentWorkersRunConcurrently) {
+  auto reader_writer = ctx_.reader_writer();
+  transfer_thread_.SetServerReadStream(reader_writer);
+
+  SimpleReadTransfer handler3(3, kData);
+  SimpleReadTransfer handler4(4, kData);
+  transfer_thread_.AddTransferHandler(handler3);
+  transfer_thread_.AddTransferHandler(handler4);
+
+  // Sessions 3 and 4 are assigned to different workers, so both transfers
+  // find a free context.
+  for (uint32_t id : {3u, 4u}) {
+    transfer_thread_.StartServerTransfer(internal::TransferType::kTransmit,
+                                         ProtocolVersion::kLegacy,
+                                         id,
+                                         id,
+                                         {},
+                                         max_parameters_,
+                                         std::chrono::seconds(2),
+                                         3,
+                                         10);
+  }
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  EXPECT_TRUE(handler3.prepare_read_called);
+  EXPECT_TRUE(handler4.prepare_read_called);
+
+  transfer_thread_.RemoveTransferHandler(handler3);
+  transfer_thread_.RemoveTransferHandler(handler4);
+
+  // Removing the handlers ends the transfers on both workers.
+  EXPECT_TRUE(handler3.finalize_read_called);
+  EXPECT_TRUE(handler4.finalize_read_called);
+}
+
+TEST_F(ParallelTransferThreadTest, SameWorker_Exhausted) {
+  auto reader_writer = ctx_.reader_writer();
+  transfer_thread_.SetServerReadStream(reader_writer);
+
+  SimpleReadTransfer handler3(3, kData);
+  SimpleReadTransfer handler5(5, kData);
+  transfer_thread_.AddTransferHandler(handler3);
+  transfer_thread_.AddTransferHandler(handler5);
+
+  // Sessions 3 and 5 are assigned to the same worker, which only has one
+  // context.
+  for (uint32_t id : {3u, 5u}) {
+    transfer_thread_.StartServerTransfer(internal::TransferType::kTransmit,
+                                         ProtocolVersion::kLegacy,
+                                         id,
+                                         id,
+                                         {},
+                                         max_parameters_,
+                                         std::chrono::seconds(2),
+                                         3,
+                                         10);
+    transfer_thread_.WaitUntilEventIsProcessed();
+  }
+
+  EXPECT_TRUE(handler3.prepare_read_called);
+  EXPECT_FALSE(handler5.prepare_read_called);
+
+  ASSERT_GE(ctx_.total_responses(), 1u);
+  auto chunk = DecodeChunk(ctx_.response());
+  EXPECT_EQ(chunk.session_id(), 5u);
+  ASSERT_TRUE(chunk.status().has_value());
+  EXPECT_EQ(chunk.status().value(), Status::ResourceExhausted());
+
+  transfer_thread_.RemoveTransferHandler(handler3);
+  transfer_thread_.RemoveTransferHandler(handler5);
+}
+
 }  // namespace
 }  // namespace pw::transfer::test
@@ -50,6 +50,8 @@ void Framework::RegisterTest(TestInfo* new_test) const {
 }
 
 int Framework::RunAllTests() {
+  PW_CHECK_UINT_LT(shard_index_, total_shards_);
+
   exit_status_ = 0;
   run_tests_summary_.passed_tests = 0;
   run_tests_summary_.failed_tests = 0;
@@ -59,8 +61,17 @@ int Framework::RunAllTests() {
   if (event_handler_ != nullptr) {
     event_handler_->RunAllTestsStart();
   }
+  // Tests that run and tests that do not are assigned to shards separately,
+  // so that each shard runs about the same number of tests.
+  size_t tests_to_run = 0;
+  size_t tests_not_run = 0;
   for (const TestInfo* test = tests_; test != nullptr; test = test->next()) {
-    if (ShouldRunTest(*test)) {
+    const bool should_run = ShouldRunTest(*test);
+    if ((should_run ? tests_to_run++ : tests_not_run++) % total_shards_ !=
+        shard_index_) {
+      continue;  // The test belongs to another shard.
+    }
+    if (should_run) {
       test->run();
     } else if (!test->enabled()) {
       run_tests_summary_.disabled_tests++;
@@ -0,0 +1,25 @@
+// Copyright 2019 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_unit_test/multi_process_runner.h"
+#include "pw_unit_test/printf_event_handler.h"
+
+int main() {
+  if (!pw::unit_test::SetShardFromEnvironment()) {
+    return 1;
+  }
+  pw::unit_test::PrintfEventHandler handler;
+  return pw::unit_test::RunAllTestsInWorkerProcesses(
+      handler, pw::unit_test::WorkerCountFromEnvironment());
+}
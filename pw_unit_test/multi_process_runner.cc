@@ -0,0 +1,251 @@
+// Copyright 2019 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_unit_test/multi_process_runner.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "pw_assert/check.h"
+#include "pw_unit_test/internal/framework.h"
+
+namespace pw {
+namespace unit_test {
+namespace {
+
+// Parses a non-negative decimal number. Returns false if value is not one.
+bool ParseSize(const char* value, size_t& result) {
+  char* end;
+  const unsigned long long parsed = std::strtoull(value, &end, 10);
+  if (*value < '0' || *value > '9' || *end != '\0') {
+    return false;
+  }
+  result = static_cast<size_t>(parsed);
+  return true;
+}
+
+// Forwards the test events of a worker process to the handler, except for the
+// start and end of the test run, which the parent process reports once for all
+// workers. The worker's results are written to a pipe to the parent instead.
+class WorkerEventHandler final : public EventHandler {
+ public:
+  WorkerEventHandler(EventHandler& handler, int summary_fd)
+      : handler_(handler), summary_fd_(summary_fd) {}
+
+  void TestProgramStart(const ProgramSummary& program_summary) override {
+    handler_.TestProgramStart(program_summary);
+  }
+  void EnvironmentsSetUpEnd() override { handler_.EnvironmentsSetUpEnd(); }
+  void TestSuiteStart(const TestSuite& test_suite) override {
+    handler_.TestSuiteStart(test_suite);
+  }
+  void TestSuiteEnd(const TestSuite& test_suite) override {
+    handler_.TestSuiteEnd(test_suite);
+  }
+  void EnvironmentsTearDownEnd() override {
+    handler_.EnvironmentsTearDownEnd();
+  }
+  void TestProgramEnd(const ProgramSummary& program_summary) override {
+    handler_.TestProgramEnd(program_summary);
+  }
+
+  void RunAllTestsStart() override {}
+
+  void RunAllTestsEnd(const RunTestsSummary& run_tests_summary) override {
+    const ssize_t written =
+        write(summary_fd_, &run_tests_summary, sizeof(run_tests_summary));
+    PW_CHECK_INT_EQ(written, sizeof(run_tests_summary));
+  }
+
+  void TestCaseStart(const TestCase& test_case) override {
+    handler_.TestCaseStart(test_case);
+  }
+  void TestCaseEnd(const TestCase& test_case, TestResult result) override {
+    handler_.TestCaseEnd(test_case, result);
+  }
+  void TestCaseDisabled(const TestCase& test_case) override {
+    handler_.TestCaseDisabled(test_case);
+  }
+  void TestCaseExpect(const TestCase& test_case,
+                      const TestExpectation& expectation) override {
+    handler_.TestCaseExpect(test_case, expectation);
+  }
+
+ private:
+  EventHandler& handler_;
+  const int summary_fd_;
+};
+
+struct Worker {
+  pid_t pid;
+  std::FILE* output;  // The worker's stdout and stderr.
+  int summary_fd;     // Read end of the pipe for the worker's results.
+};
+
+// Runs the tests of one shard in this worker process and exits.
+[[noreturn]] void RunWorker(EventHandler& handler,
+                            const Worker& worker,
+                            int summary_fd,
+                            size_t shard_index,
+                            size_t total_shards) {
+  close(worker.summary_fd);
+  PW_CHECK_INT_GE(dup2(fileno(worker.output), STDOUT_FILENO), 0);
+  PW_CHECK_INT_GE(dup2(fileno(worker.output), STDERR_FILENO), 0);
+  // Line buffer the output, so it shows which test was running if the worker
+  // crashes.
+  static char buffer[BUFSIZ];
+  std::setvbuf(stdout, buffer, _IOLBF, sizeof(buffer));
+
+  WorkerEventHandler worker_handler(handler, summary_fd);
+  internal::Framework& framework = internal::Framework::Get();
+  framework.RegisterEventHandler(&worker_handler);
+  framework.SetShard(shard_index, total_shards);
+  const int exit_status = framework.RunAllTests();
+
+  std::fflush(stdout);
+  std::fflush(stderr);
+  std::_Exit(exit_status);
+}
+
+// Copies the worker's buffered output to stdout.
+void WriteOutput(std::FILE* output) {
+  std::rewind(output);
+  char buffer[4096];
+  size_t size;
+  while ((size = std::fread(buffer, 1, sizeof(buffer), output)) != 0u) {
+    std::fwrite(buffer, 1, size, stdout);
+  }
+  std::fclose(output);
+}
+
+}  // namespace
+
+bool SetShardFromEnvironment() {
+  const char* total_shards_value = std::getenv("GTEST_TOTAL_SHARDS");
+  const char* shard_index_value = std::getenv("GTEST_SHARD_INDEX");
+  if (total_shards_value == nullptr && shard_index_value == nullptr) {
+    return true;
+  }
+
+  size_t total_shards;
+  size_t shard_index;
+  if (total_shards_value == nullptr || shard_index_value == nullptr ||
+      !ParseSize(total_shards_value, total_shards) ||
+      !ParseSize(shard_index_value, shard_index) ||
+      shard_index >= total_shards) {
+    std::fprintf(stderr,
+                 "Invalid GTEST_SHARD_INDEX and GTEST_TOTAL_SHARDS\n");
+    return false;
+  }
+
+  if (const char* status_file = std::getenv("GTEST_SHARD_STATUS_FILE");
+      status_file != nullptr) {
+    std::FILE* file = std::fopen(status_file, "w");
+    if (file != nullptr) {
+      std::fclose(file);
+    }
+  }
+
+  SetShard(shard_index, total_shards);
+  return true;
+}
+
+size_t WorkerCountFromEnvironment() {
+  size_t workers;
+  if (const char* value = std::getenv("PW_UNIT_TEST_WORKERS");
+      value != nullptr && ParseSize(value, workers) && workers != 0u) {
+    return workers;
+  }
+  workers = std::thread::hardware_concurrency();
+  return workers == 0u ? 1 : workers;
+}
+
+int RunAllTestsInWorkerProcesses(EventHandler& handler, size_t workers) {
+  internal::Framework& framework = internal::Framework::Get();
+  if (workers <= 1u) {
+    framework.RegisterEventHandler(&handler);
+    return framework.RunAllTests();
+  }
+
+  // Each worker runs a shard of the current shard. Tests are assigned to
+  // shards round-robin, so the workers' shards together cover it exactly.
+  const size_t shard_index = framework.shard_index();
+  const size_t total_shards = framework.total_shards();
+
+  handler.RunAllTestsStart();
+
+  // Flush before forking so buffered output is not written by every worker.
+  std::fflush(stdout);
+  std::fflush(stderr);
+
+  std::vector<Worker> running(workers);
+  for (size_t i = 0; i < workers; ++i) {
+    Worker& worker = running[i];
+    worker.output = std::tmpfile();
+    PW_CHECK_NOTNULL(worker.output);
+
+    int summary_pipe[2];
+    PW_CHECK_INT_EQ(pipe(summary_pipe), 0);
+    worker.summary_fd = summary_pipe[0];
+
+    worker.pid = fork();
+    PW_CHECK_INT_GE(worker.pid, 0);
+    if (worker.pid == 0) {
+      RunWorker(handler,
+                worker,
+                summary_pipe[1],
+                shard_index + i * total_shards,
+                workers * total_shards);
+    }
+    close(summary_pipe[1]);
+  }
+
+  RunTestsSummary total = {};
+  int exit_status = 0;
+  for (size_t i = 0; i < workers; ++i) {
+    Worker& worker = running[i];
+    int status;
+    PW_CHECK_INT_EQ(waitpid(worker.pid, &status, 0), worker.pid);
+    WriteOutput(worker.output);
+
+    RunTestsSummary summary;
+    if (read(worker.summary_fd, &summary, sizeof(summary)) ==
+        sizeof(summary)) {
+      total.passed_tests += summary.passed_tests;
+      total.failed_tests += summary.failed_tests;
+      total.skipped_tests += summary.skipped_tests;
+      total.disabled_tests += summary.disabled_tests;
+    } else {
+      // The worker crashed before finishing its tests. Its output shows where.
+      std::printf("Test worker %zu did not finish\n", i);
+      total.failed_tests += 1;
+    }
+    close(worker.summary_fd);
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      exit_status = 1;
+    }
+  }
+
+  handler.RunAllTestsEnd(total);
+  return exit_status;
+}
+
+}  // namespace unit_test
+}  // namespace pw
@@ -209,6 +209,8 @@ class Framework {
                            .disabled_tests = 0},
         exit_status_(0),
         event_handler_(nullptr),
+        shard_index_(0),
+        total_shards_(1),
         memory_pool_() {}
 
   static Framework& Get() { return framework_; }
@@ -237,6 +239,18 @@ class Framework {
   }
 #endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
 
+  // Splits the tests to run into total_shards shards and only runs the tests
+  // in shard shard_index during the next test run. Tests are assigned to
+  // shards round-robin, in the same way as GoogleTest's GTEST_SHARD_INDEX and
+  // GTEST_TOTAL_SHARDS, so running every shard runs every test exactly once.
+  void SetShard(size_t shard_index, size_t total_shards) {
+    shard_index_ = shard_index;
+    total_shards_ = total_shards;
+  }
+
+  size_t shard_index() const { return shard_index_; }
+  size_t total_shards() const { return total_shards_; }
+
   bool ShouldRunTest(const TestInfo& test_info) const;
 
   // Whether the current test is skipped.
@@ -363,6 +377,10 @@ class Framework {
   // Handler to which to dispatch test events.
   EventHandler* event_handler_;
 
+  // The shard of the tests to run; see SetShard().
+  size_t shard_index_;
+  size_t total_shards_;
+
 #if PW_CXX_STANDARD_IS_SUPPORTED(17)
   span<std::string_view> test_suites_to_run_;
 #else
@@ -488,6 +506,12 @@ inline void SetTestSuitesToRun(span<std::string_view> test_suites) {
 }
 #endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
 
+// Only runs the tests in shard shard_index of total_shards during the next test
+// run. shard_index must be less than total_shards.
+inline void SetShard(size_t shard_index, size_t total_shards) {
+  internal::Framework::Get().SetShard(shard_index, total_shards);
+}
+
 }  // namespace unit_test
 }  // namespace pw
 
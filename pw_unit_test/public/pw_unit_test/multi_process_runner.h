@@ -0,0 +1,46 @@
+// Copyright 2019 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_unit_test/event_handler.h"
+
+// Host-only support for running the tests of a light pw_unit_test binary in
+// several processes at once. This requires POSIX fork() and pipe().
+namespace pw {
+namespace unit_test {
+
+// Reads GoogleTest's GTEST_TOTAL_SHARDS and GTEST_SHARD_INDEX environment
+// variables and, if they are set, only runs that shard of the tests. If
+// GTEST_SHARD_STATUS_FILE is set, creates that file to tell the test runner
+// that sharding is supported. Returns false if the variables are invalid.
+bool SetShardFromEnvironment();
+
+// Returns the number of worker processes set by the PW_UNIT_TEST_WORKERS
+// environment variable, or the number of CPUs if it is not set.
+size_t WorkerCountFromEnvironment();
+
+// Runs all tests in the current shard, split among the given number of worker
+// processes that run concurrently. Returns 0 if all tests passed.
+//
+// Each worker runs tests from the same binary and reports them to its copy of
+// handler. The output of each worker is buffered and written to stdout when
+// it finishes, so the output of different workers is not interleaved. The
+// parent process reports the start of the test run to handler, and the end
+// of the test run with the results of all workers added together.
+int RunAllTestsInWorkerProcesses(EventHandler& handler, size_t workers);
+
+}  // namespace unit_test
+}  // namespace pw
@@ -17,6 +17,7 @@
 #include <limits>
 
 #include "pw_status/status_with_size.h"
+#include "pw_stream/buffered_stream.h"
 #include "pw_stream/stream.h"
 
 namespace pw {
@@ -46,5 +47,16 @@ StatusWithSize Read(stream::Reader& reader,
                     uint64_t* output,
                     size_t max_size = std::numeric_limits<size_t>::max());
 
+/// @brief Decodes a varint from a `pw::stream::BufferedReader`.
+///
+/// Behaves like the `pw::stream::Reader` overloads, but decodes a varint that
+/// is already buffered in one step instead of reading it a byte at a time.
+StatusWithSize Read(stream::BufferedReader& reader,
+                    int64_t* output,
+                    size_t max_size = std::numeric_limits<size_t>::max());
+StatusWithSize Read(stream::BufferedReader& reader,
+                    uint64_t* output,
+                    size_t max_size = std::numeric_limits<size_t>::max());
+
 }  // namespace varint
 }  // namespace pw
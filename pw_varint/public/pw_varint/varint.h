@@ -171,6 +171,24 @@ inline size_t Decode(const span<const std::byte>& input, uint64_t* value) {
   return pw_varint_Decode(input.data(), input.size(), value);
 }
 
+/// @brief Decodes consecutive unsigned varints, such as the contents of a
+/// packed repeated protobuf field.
+///
+/// Decoding stops when `output` is full, `input` is exhausted, or the rest of
+/// `input` does not start with a complete varint. This is equivalent to calling
+/// `Decode()` in a loop, without the per-call overhead.
+///
+/// @param input The encoded varints.
+/// @param output Where to store the decoded values.
+/// @param bytes_read Set to the number of input bytes that were decoded. If
+/// this is less than the size of `input` and `output` is not full, the rest of
+/// `input` is a truncated or invalid varint.
+///
+/// @returns The number of varints decoded.
+size_t DecodePacked(span<const std::byte> input,
+                    span<uint64_t> output,
+                    size_t* bytes_read);
+
 enum class Format {
   kZeroTerminatedLeastSignificant = PW_VARINT_ZERO_TERMINATED_LEAST_SIGNIFICANT,
   kZeroTerminatedMostSignificant = PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT,
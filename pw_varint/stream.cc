@@ -14,6 +14,7 @@
 
 #include "pw_varint/stream.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 
@@ -80,5 +81,40 @@ StatusWithSize Read(stream::Reader& reader, uint64_t* output, size_t max_size) {
   return StatusWithSize(count);
 }
 
+StatusWithSize Read(stream::BufferedReader& reader,
+                    int64_t* output,
+                    size_t max_size) {
+  uint64_t value = 0;
+  StatusWithSize count = Read(reader, &value, max_size);
+  if (!count.ok()) {
+    return count;
+  }
+
+  *output = ZigZagDecode(value);
+  return count;
+}
+
+StatusWithSize Read(stream::BufferedReader& reader,
+                    uint64_t* output,
+                    size_t max_size) {
+  if (max_size > 0) {
+    Result<ConstByteSpan> buffered = reader.Peek();
+    if (!buffered.ok()) {
+      return StatusWithSize(buffered.status(), 0);
+    }
+
+    const size_t count = Decode(
+        buffered->first(std::min(buffered->size(), max_size)), output);
+    if (count != 0) {
+      reader.Consume(count);
+      return StatusWithSize(count);
+    }
+  }
+
+  // The varint continues past the end of the buffer, or is invalid. Reading
+  // it a byte at a time refills the buffer as needed and reports errors.
+  return Read(static_cast<stream::Reader&>(reader), output, max_size);
+}
+
 }  // namespace varint
 }  // namespace pw
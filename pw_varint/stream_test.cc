@@ -21,6 +21,7 @@
 #include <limits>
 
 #include "gtest/gtest.h"
+#include "pw_stream/buffered_stream.h"
 #include "pw_stream/memory_stream.h"
 #include "pw_varint/varint.h"
 
@@ -300,4 +301,69 @@ TEST(VarintRead, SizeLimit) {
   }
 }
 
+TEST(VarintRead, BufferedReader) {
+  // 1, 300, -2 (ZigZag), and UINT64_MAX. With a 4-byte buffer, the last two
+  // varints span refills.
+  const auto data = MakeBuffer("\x01\xac\x02\x03\xff\xff\xff\xff\xff\xff");
+  std::array<std::byte, 4> buffer;
+  const std::array<std::byte, 10> last = {
+      std::byte{0xff},
+      std::byte{0xff},
+      std::byte{0xff},
+      std::byte{0xff},
+      std::byte{0xff},
+      std::byte{0xff},
+      std::byte{0xff},
+      std::byte{0xff},
+      std::byte{0xff},
+      std::byte{0x01},
+  };
+
+  stream::MemoryReader first(data);
+  stream::MemoryReader second(last);
+  stream::BufferedReader reader(first, buffer);
+
+  uint64_t value = 0;
+  auto sws = Read(reader, &value);
+  ASSERT_EQ(sws.status(), OkStatus());
+  EXPECT_EQ(sws.size(), 1u);
+  EXPECT_EQ(value, 1u);
+
+  sws = Read(reader, &value);
+  ASSERT_EQ(sws.status(), OkStatus());
+  EXPECT_EQ(sws.size(), 2u);
+  EXPECT_EQ(value, 300u);
+
+  int64_t signed_value = 0;
+  sws = Read(reader, &signed_value);
+  ASSERT_EQ(sws.status(), OkStatus());
+  EXPECT_EQ(sws.size(), 1u);
+  EXPECT_EQ(signed_value, -2);
+
+  // The rest of the first source is an unterminated varint.
+  sws = Read(reader, &value);
+  EXPECT_EQ(sws.status(), Status::DataLoss());
+
+  stream::BufferedReader split_reader(second, buffer);
+  sws = Read(split_reader, &value);
+  ASSERT_EQ(sws.status(), OkStatus());
+  EXPECT_EQ(sws.size(), 10u);
+  EXPECT_EQ(value, std::numeric_limits<uint64_t>::max());
+
+  sws = Read(split_reader, &value);
+  EXPECT_EQ(sws.status(), Status::OutOfRange());
+}
+
+TEST(VarintRead, BufferedReaderSizeLimit) {
+  const auto data = MakeBuffer("\xff\xff\xff\xff\x0f");
+  std::array<std::byte, 8> buffer;
+
+  stream::MemoryReader source(data);
+  stream::BufferedReader reader(source, buffer);
+  uint64_t value;
+  EXPECT_EQ(Read(reader, &value, 0).status(), Status::OutOfRange());
+  EXPECT_EQ(reader.buffered(), 0u);
+  EXPECT_EQ(Read(reader, &value, 4).status(), Status::DataLoss());
+}
+
 }  // namespace pw::varint
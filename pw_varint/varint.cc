@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 
 namespace pw {
 namespace varint {
@@ -29,6 +30,75 @@ inline bool LeastSignificant(pw_varint_Format format) {
   return (static_cast<unsigned>(format) & 0b01) == 0;
 }
 
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PW_VARINT_WORD_DECODE 1
+#else
+#define PW_VARINT_WORD_DECODE 0
+#endif  // __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+#if PW_VARINT_WORD_DECODE
+
+// Packs the low 7 bits of each byte in a little-endian word into the low 56
+// bits of the result.
+constexpr uint64_t CompactSevenBitGroups(uint64_t word) {
+  word &= 0x7f7f7f7f7f7f7f7fu;
+  word = ((word & 0x7f007f007f007f00u) >> 1) | (word & 0x007f007f007f007fu);
+  word = ((word & 0x3fff00003fff0000u) >> 2) | (word & 0x00003fff00003fffu);
+  return ((word & 0x0fffffff00000000u) >> 4) | (word & 0x000000000fffffffu);
+}
+
+#endif  // PW_VARINT_WORD_DECODE
+
+// Decodes a protobuf-style varint: zero terminated, with the continuation bit
+// in the most significant bit of each byte.
+//
+// When at least 8 bytes are available, they are loaded as a single word. The
+// first byte without a continuation bit is found with a count of trailing
+// zeros and the 7-bit groups are packed with a few shifts, so varints of up to
+// 8 bytes decode without a per-byte loop. Longer varints (values of 2^56 and
+// above) finish decoding one byte at a time.
+inline size_t DecodeLeb128(const std::byte* buffer,
+                           size_t input_size,
+                           uint64_t* output) {
+  uint64_t decoded_value = 0;
+  size_t count = 0;
+
+#if PW_VARINT_WORD_DECODE
+  if (input_size >= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, buffer, sizeof(word));
+
+    const uint64_t last_byte_bits = ~word & 0x8080808080808080u;
+    if (last_byte_bits != 0u) {
+      count = static_cast<size_t>(__builtin_ctzll(last_byte_bits) + 1) / 8;
+      if (count < sizeof(uint64_t)) {
+        word &= (uint64_t{1} << (8 * count)) - 1;
+      }
+      *output = CompactSevenBitGroups(word);
+      return count;
+    }
+
+    decoded_value = CompactSevenBitGroups(word);
+    count = sizeof(uint64_t);
+  }
+#endif  // PW_VARINT_WORD_DECODE
+
+  const size_t max_count = std::min(kMaxVarint64SizeBytes, input_size);
+
+  while (count < max_count) {
+    const uint64_t byte = static_cast<uint64_t>(buffer[count]);
+    decoded_value |= (byte & 0x7fu) << (7 * count);
+    count += 1;
+
+    if ((byte & 0x80u) == 0u) {
+      *output = decoded_value;
+      return count;
+    }
+  }
+
+  return 0;
+}
+
 }  // namespace
 
 extern "C" size_t pw_varint_EncodeCustom(uint64_t integer,
@@ -78,9 +148,14 @@ extern "C" size_t pw_varint_DecodeCustom(const void* input,
                                          size_t input_size,
                                          uint64_t* output,
                                          pw_varint_Format format) {
+  const std::byte* buffer = static_cast<const std::byte*>(input);
+
+  if (format == PW_VARINT_ZERO_TERMINATED_MOST_SIGNIFICANT) {
+    return DecodeLeb128(buffer, input_size, output);
+  }
+
   uint64_t decoded_value = 0;
   uint_fast8_t count = 0;
-  const std::byte* buffer = static_cast<const std::byte*>(input);
 
   // The largest 64-bit ints require 10 B.
   const size_t max_count = std::min(kMaxVarint64SizeBytes, input_size);
@@ -122,6 +197,26 @@ extern "C" size_t pw_varint_DecodeCustom(const void* input,
   return count;
 }
 
+size_t DecodePacked(span<const std::byte> input,
+                    span<uint64_t> output,
+                    size_t* bytes_read) {
+  size_t read = 0;
+  size_t decoded = 0;
+
+  while (decoded < output.size() && read < input.size()) {
+    const size_t size = DecodeLeb128(
+        input.data() + read, input.size() - read, &output[decoded]);
+    if (size == 0u) {
+      break;
+    }
+    read += size;
+    decoded += 1;
+  }
+
+  *bytes_read = read;
+  return decoded;
+}
+
 // TODO(frolv): Remove this deprecated alias.
 extern "C" size_t pw_VarintEncode(uint64_t integer,
                                   void* output,
@@ -0,0 +1,91 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+#include "pw_varint/varint.h"
+
+namespace pw::varint {
+namespace {
+
+constexpr size_t kValueCount = 64;
+
+// Encodes kValueCount values of the given size as a packed varint field.
+struct PackedVarints {
+  explicit PackedVarints(size_t size_bytes) {
+    const uint64_t value = size_bytes >= kMaxVarint64SizeBytes
+                               ? UINT64_MAX
+                               : (uint64_t{1} << (7 * size_bytes)) - 1;
+    for (size_t i = 0; i < kValueCount; ++i) {
+      size += Encode(value, span(data).subspan(size));
+    }
+  }
+
+  span<const std::byte> encoded() const { return span(data).first(size); }
+
+  std::array<std::byte, kValueCount * kMaxVarint64SizeBytes> data{};
+  size_t size = 0;
+};
+
+std::array<uint64_t, kValueCount> values;
+
+void EncodeTest(perf_test::State& state, size_t size_bytes) {
+  const PackedVarints packed(size_bytes);
+  size_t bytes_read = 0;
+  DecodePacked(packed.encoded(), values, &bytes_read);
+  std::array<std::byte, kValueCount * kMaxVarint64SizeBytes> buffer;
+  while (state.KeepRunning()) {
+    span<std::byte> output(buffer);
+    for (uint64_t value : values) {
+      output = output.subspan(Encode(value, output));
+    }
+  }
+}
+
+void DecodeTest(perf_test::State& state, size_t size_bytes) {
+  const PackedVarints packed(size_bytes);
+  while (state.KeepRunning()) {
+    span<const std::byte> data = packed.encoded();
+    for (uint64_t& value : values) {
+      data = data.subspan(Decode(data, &value));
+    }
+  }
+}
+
+void DecodePackedTest(perf_test::State& state, size_t size_bytes) {
+  const PackedVarints packed(size_bytes);
+  size_t bytes_read = 0;
+  while (state.KeepRunning()) {
+    DecodePacked(packed.encoded(), values, &bytes_read);
+  }
+}
+
+PW_PERF_TEST(EncodeOneByte, EncodeTest, 1);
+PW_PERF_TEST(EncodeThreeBytes, EncodeTest, 3);
+PW_PERF_TEST(EncodeTenBytes, EncodeTest, 10);
+
+PW_PERF_TEST(DecodeOneByte, DecodeTest, 1);
+PW_PERF_TEST(DecodeThreeBytes, DecodeTest, 3);
+PW_PERF_TEST(DecodeTenBytes, DecodeTest, 10);
+
+PW_PERF_TEST(DecodePackedOneByte, DecodePackedTest, 1);
+PW_PERF_TEST(DecodePackedThreeBytes, DecodePackedTest, 3);
+PW_PERF_TEST(DecodePackedTenBytes, DecodePackedTest, 10);
+
+}  // namespace
+}  // namespace pw::varint
@@ -14,6 +14,7 @@
 
 #include "pw_varint/varint.h"
 
+#include <array>
 #include <cinttypes>
 #include <cstdint>
 #include <cstring>
@@ -1067,6 +1068,83 @@ TEST(Varint, ZigZagEncodedSize) {
   EXPECT_EQ(ZigZagEncodedSize(std::numeric_limits<int64_t>::max()), 10u);
 }
 
+TEST(Varint, Decode_FollowedByOtherData) {
+  // Decode every varint size with enough trailing data for word loads.
+  for (size_t size = 1; size <= kMaxVarint64SizeBytes; ++size) {
+    const uint64_t expected = size == kMaxVarint64SizeBytes
+                                  ? std::numeric_limits<uint64_t>::max()
+                                  : (uint64_t{1} << (7 * size)) - 1;
+    std::array<std::byte, 2 * kMaxVarint64SizeBytes> buffer;
+    buffer.fill(std::byte{0xff});
+    ASSERT_EQ(Encode(expected, buffer), size);
+
+    uint64_t value = 0;
+    EXPECT_EQ(Decode(buffer, &value), size);
+    EXPECT_EQ(value, expected);
+
+    // The varint's last byte is not a continuation byte, so any data after it
+    // must be ignored.
+    buffer[size] = std::byte{0x01};
+    EXPECT_EQ(Decode(buffer, &value), size);
+    EXPECT_EQ(value, expected);
+  }
+}
+
+TEST(Varint, Decode_TooLong) {
+  std::array<std::byte, 16> buffer;
+  buffer.fill(std::byte{0x80});
+
+  uint64_t value = 1234;
+  EXPECT_EQ(Decode(buffer, &value), 0u);
+  EXPECT_EQ(value, 1234u);
+}
+
+TEST(Varint, DecodePacked) {
+  std::array<std::byte, 32> buffer;
+  size_t encoded = 0;
+  constexpr uint64_t kValues[] = {
+      0, 1, 127, 128, 300, 0xffffffff, std::numeric_limits<uint64_t>::max(), 2};
+  for (uint64_t value : kValues) {
+    encoded += Encode(value, span(buffer).subspan(encoded));
+  }
+
+  std::array<uint64_t, 10> output{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(DecodePacked(span(buffer).first(encoded), output, &bytes_read),
+            std::size(kValues));
+  EXPECT_EQ(bytes_read, encoded);
+  for (size_t i = 0; i < std::size(kValues); ++i) {
+    EXPECT_EQ(output[i], kValues[i]);
+  }
+}
+
+TEST(Varint, DecodePacked_OutputFull) {
+  const auto kData = MakeBuffer("\x01\x02\x83\x01\x04");
+  std::array<uint64_t, 2> output{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(DecodePacked(kData, output, &bytes_read), 2u);
+  EXPECT_EQ(bytes_read, 2u);
+  EXPECT_EQ(output[0], 1u);
+  EXPECT_EQ(output[1], 2u);
+}
+
+TEST(Varint, DecodePacked_Truncated) {
+  const auto kData = MakeBuffer("\x01\x83\x01\xff\xff");
+  std::array<uint64_t, 4> output{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(DecodePacked(kData, output, &bytes_read), 2u);
+  EXPECT_EQ(bytes_read, 3u);
+  EXPECT_EQ(output[0], 1u);
+  EXPECT_EQ(output[1], 131u);
+}
+
+TEST(Varint, DecodePacked_Empty) {
+  std::array<uint64_t, 4> output{};
+  size_t bytes_read = 1234;
+  EXPECT_EQ(DecodePacked(span<const std::byte>(), output, &bytes_read), 0u);
+  EXPECT_EQ(bytes_read, 0u);
+}
+
 constexpr uint64_t CalculateMaxValueInBytes(size_t bytes) {
   uint64_t value = 0;
   for (size_t i = 0; i < bytes; ++i) {
@@ -0,0 +1,123 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/deadline_work_queue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <optional>
+
+#include "pw_assert/check.h"
+
+namespace pw::work_queue {
+namespace {
+
+// Heap ordering that puts the earliest deadline, then the earliest push, at
+// the front.
+bool RunsAfter(const DeadlineWorkItem& lhs, const DeadlineWorkItem& rhs) {
+  if (lhs.deadline != rhs.deadline) {
+    return lhs.deadline > rhs.deadline;
+  }
+  return static_cast<int32_t>(lhs.sequence - rhs.sequence) > 0;
+}
+
+}  // namespace
+
+void DeadlineWorkQueue::RequestStop() {
+  std::lock_guard lock(lock_);
+  stop_requested_ = true;
+  work_notification_.release();
+}
+
+void DeadlineWorkQueue::Run() {
+  while (true) {
+    work_notification_.acquire();
+
+    // Drain the work queue, earliest deadline first.
+    bool stop_requested;
+    while (true) {
+      std::optional<DeadlineWorkItem> work_item;
+      {
+        std::lock_guard lock(lock_);
+        stop_requested = stop_requested_;
+        if (!heap_.empty()) {
+          std::pop_heap(heap_.begin(), heap_.end(), RunsAfter);
+          work_item.emplace(std::move(heap_.back()));
+          heap_.pop_back();
+        }
+      }
+      if (!work_item.has_value()) {
+        break;
+      }
+
+      const chrono::SystemClock::time_point now = chrono::SystemClock::now();
+      if (now > work_item->deadline) {
+        deadline_misses_.Increment();
+        const int64_t lateness_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                now - work_item->deadline)
+                .count();
+        const auto clamped = static_cast<uint32_t>(std::min<int64_t>(
+            lateness_us, std::numeric_limits<uint32_t>::max()));
+        if (clamped > max_lateness_us_.value()) {
+          max_lateness_us_.Set(clamped);
+        }
+      }
+
+      PW_CHECK(work_item->work_item != nullptr);
+      work_item->work_item();
+    }
+
+    // Queue was drained, return if we've been requested to stop.
+    if (stop_requested) {
+      return;
+    }
+  }
+}
+
+void DeadlineWorkQueue::CheckPushWork(
+    WorkItem&& work_item, chrono::SystemClock::time_point deadline) {
+  PW_CHECK_OK(PushWork(std::move(work_item), deadline),
+              "Failed to push work item into the deadline work queue");
+}
+
+Status DeadlineWorkQueue::PushWork(WorkItem&& work_item,
+                                   chrono::SystemClock::time_point deadline) {
+  std::lock_guard lock(lock_);
+
+  if (stop_requested_) {
+    // Entries are not permitted to be enqueued once stop has been requested.
+    return Status::FailedPrecondition();
+  }
+
+  if (heap_.full()) {
+    return Status::ResourceExhausted();
+  }
+
+  heap_.push_back(
+      DeadlineWorkItem{std::move(work_item), deadline, next_sequence_++});
+  std::push_heap(heap_.begin(), heap_.end(), RunsAfter);
+
+  const auto queue_entries = static_cast<uint32_t>(heap_.size());
+  if (queue_entries > max_queue_used_.value()) {
+    max_queue_used_.Set(queue_entries);
+  }
+
+  work_notification_.release();
+  return OkStatus();
+}
+
+}  // namespace pw::work_queue
@@ -0,0 +1,117 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/priority_work_queue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <optional>
+
+#include "pw_assert/check.h"
+
+namespace pw::work_queue {
+
+void PriorityWorkQueue::RequestStop() {
+  std::lock_guard lock(lock_);
+  stop_requested_ = true;
+  work_notification_.release();
+}
+
+void PriorityWorkQueue::Run() {
+  while (true) {
+    work_notification_.acquire();
+
+    // Drain the queues, highest priority first.
+    bool stop_requested;
+    while (true) {
+      std::optional<QueuedWorkItem> work_item;
+      bool top_priority = false;
+      {
+        std::lock_guard lock(lock_);
+        stop_requested = stop_requested_;
+        for (size_t i = 0; i < queues_.size(); ++i) {
+          InlineQueue<QueuedWorkItem>& queue = *queues_[i];
+          if (!queue.empty()) {
+            work_item.emplace(std::move(queue.front()));
+            queue.pop();
+            top_priority = i == 0;
+            break;
+          }
+        }
+      }
+      if (!work_item.has_value()) {
+        break;  // All queues are empty.
+      }
+
+      if (top_priority) {
+        const int64_t latency_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                chrono::SystemClock::now() - work_item->enqueue_time)
+                .count();
+        const auto clamped = static_cast<uint32_t>(std::clamp<int64_t>(
+            latency_us, 0, std::numeric_limits<uint32_t>::max()));
+        if (clamped > max_top_priority_latency_us_.value()) {
+          max_top_priority_latency_us_.Set(clamped);
+        }
+      }
+
+      PW_CHECK(work_item->work_item != nullptr);
+      work_item->work_item();
+    }
+
+    // Queues were drained, return if we've been requested to stop.
+    if (stop_requested) {
+      return;
+    }
+  }
+}
+
+void PriorityWorkQueue::CheckPushWork(WorkItem&& work_item, size_t priority) {
+  PW_CHECK_OK(PushWork(std::move(work_item), priority),
+              "Failed to push work item into the priority work queue");
+}
+
+Status PriorityWorkQueue::PushWork(WorkItem&& work_item, size_t priority) {
+  if (priority >= queues_.size()) {
+    return Status::InvalidArgument();
+  }
+  const chrono::SystemClock::time_point now = chrono::SystemClock::now();
+  std::lock_guard lock(lock_);
+
+  if (stop_requested_) {
+    // Entries are not permitted to be enqueued once stop has been requested.
+    return Status::FailedPrecondition();
+  }
+
+  InlineQueue<QueuedWorkItem>& queue = *queues_[priority];
+  if (queue.full()) {
+    return Status::ResourceExhausted();
+  }
+  queue.push(QueuedWorkItem{std::move(work_item), now});
+
+  uint32_t queue_entries = 0;
+  for (InlineQueue<QueuedWorkItem>* level : queues_) {
+    queue_entries += static_cast<uint32_t>(level->size());
+  }
+  if (queue_entries > max_queue_used_.value()) {
+    max_queue_used_.Set(queue_entries);
+  }
+
+  work_notification_.release();
+  return OkStatus();
+}
+
+}  // namespace pw::work_queue
@@ -0,0 +1,101 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_containers/vector.h"
+#include "pw_metric/metric.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread_core.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::work_queue {
+
+// A WorkItem waiting in a DeadlineWorkQueue.
+struct DeadlineWorkItem {
+  WorkItem work_item;
+  chrono::SystemClock::time_point deadline;
+  // Push order, which breaks ties between equal deadlines.
+  uint32_t sequence;
+};
+
+// A work queue that runs work earliest deadline first (EDF).
+//
+// Pending items are kept in a binary heap ordered by deadline, so pushing and
+// popping take O(log n) time. Items with equal deadlines run in the order they
+// were pushed. Items run as soon as the worker is free; the deadline only
+// orders them. An item that starts after its deadline counts as a deadline
+// miss in the metrics.
+//
+// The entire API is thread and interrupt safe.
+class DeadlineWorkQueue : public thread::ThreadCore {
+ public:
+  explicit DeadlineWorkQueue(Vector<DeadlineWorkItem>& heap)
+      : stop_requested_(false), heap_(heap) {}
+
+  // Enqueues a work_item that should start by deadline.
+  //
+  // Returns:
+  // Ok - Success, entry was enqueued for execution.
+  // FailedPrecondition - the work queue is shutting down, entries are no
+  //     longer permitted.
+  // ResourceExhausted - internal work queue is full, entry was not enqueued.
+  Status PushWork(WorkItem&& work_item,
+                  chrono::SystemClock::time_point deadline)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Queue work that should start by deadline. Crash if the work cannot be
+  // queued.
+  void CheckPushWork(WorkItem&& work_item,
+                     chrono::SystemClock::time_point deadline)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Prevents further work from being enqueued, finishes outstanding work, then
+  // shuts down the worker thread.
+  void RequestStop() PW_LOCKS_EXCLUDED(lock_);
+
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  void Run() override PW_LOCKS_EXCLUDED(lock_);
+
+  sync::InterruptSpinLock lock_;
+  bool stop_requested_ PW_GUARDED_BY(lock_);
+  uint32_t next_sequence_ PW_GUARDED_BY(lock_) = 0;
+  Vector<DeadlineWorkItem>& heap_ PW_GUARDED_BY(lock_);
+  sync::ThreadNotification work_notification_;
+
+  PW_METRIC_GROUP(metrics_, "pw::work_queue::DeadlineWorkQueue");
+  PW_METRIC(metrics_, max_queue_used_, "max_queue_used", 0u);
+  // Items that started after their deadline, and the latest such start.
+  PW_METRIC(metrics_, deadline_misses_, "deadline_misses", 0u);
+  PW_METRIC(metrics_, max_lateness_us_, "max_lateness_us", 0u);
+};
+
+template <size_t kWorkQueueEntries>
+class DeadlineWorkQueueWithBuffer : public DeadlineWorkQueue {
+ public:
+  DeadlineWorkQueueWithBuffer() : DeadlineWorkQueue(heap_) {}
+
+ private:
+  Vector<DeadlineWorkItem, kWorkQueueEntries> heap_;
+};
+
+}  // namespace pw::work_queue
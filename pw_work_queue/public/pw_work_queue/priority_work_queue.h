@@ -0,0 +1,107 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_containers/inline_queue.h"
+#include "pw_metric/metric.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread_core.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::work_queue {
+
+// A work queue with several priority levels, each a FIFO queue. The worker
+// always runs the oldest item of the highest priority level that has work, so
+// latency-critical work does not wait behind bulk work. Priority 0 is the
+// highest.
+//
+// Items are not preempted: a high-priority item still waits for the item that
+// is running when it is pushed.
+//
+// The entire API is thread and interrupt safe.
+class PriorityWorkQueue : public thread::ThreadCore {
+ public:
+  // Creates a work queue with one priority level per queue, highest first.
+  explicit PriorityWorkQueue(span<InlineQueue<QueuedWorkItem>* const> queues)
+      : stop_requested_(false), queues_(queues) {}
+
+  // Enqueues a work_item at the given priority level.
+  //
+  // Returns:
+  // Ok - Success, entry was enqueued for execution.
+  // InvalidArgument - there is no such priority level.
+  // FailedPrecondition - the work queue is shutting down, entries are no
+  //     longer permitted.
+  // ResourceExhausted - the priority level's queue is full, entry was not
+  //     enqueued.
+  Status PushWork(WorkItem&& work_item, size_t priority)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Queue work for execution at the given priority level. Crash if the work
+  // cannot be queued.
+  void CheckPushWork(WorkItem&& work_item, size_t priority)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Prevents further work from being enqueued, finishes outstanding work, then
+  // shuts down the worker thread.
+  void RequestStop() PW_LOCKS_EXCLUDED(lock_);
+
+  size_t num_priorities() const { return queues_.size(); }
+
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  void Run() override PW_LOCKS_EXCLUDED(lock_);
+
+  sync::InterruptSpinLock lock_;
+  bool stop_requested_ PW_GUARDED_BY(lock_);
+  const span<InlineQueue<QueuedWorkItem>* const> queues_;
+  sync::ThreadNotification work_notification_;
+
+  PW_METRIC_GROUP(metrics_, "pw::work_queue::PriorityWorkQueue");
+  // Most items queued at once, across all priority levels.
+  PW_METRIC(metrics_, max_queue_used_, "max_queue_used", 0u);
+  // Longest time from enqueueing a priority 0 item to starting it.
+  PW_METRIC(metrics_,
+            max_top_priority_latency_us_,
+            "max_top_priority_latency_us",
+            0u);
+};
+
+// A PriorityWorkQueue with kNumPriorities levels of kEntriesPerPriority items
+// each.
+template <size_t kNumPriorities, size_t kEntriesPerPriority>
+class PriorityWorkQueueWithBuffer : public PriorityWorkQueue {
+ public:
+  PriorityWorkQueueWithBuffer() : PriorityWorkQueue(queue_pointers_) {
+    for (size_t i = 0; i < kNumPriorities; ++i) {
+      queue_pointers_[i] = &queues_[i];
+    }
+  }
+
+ private:
+  std::array<InlineQueue<QueuedWorkItem, kEntriesPerPriority>, kNumPriorities>
+      queues_;
+  std::array<InlineQueue<QueuedWorkItem>*, kNumPriorities> queue_pointers_;
+};
+
+}  // namespace pw::work_queue
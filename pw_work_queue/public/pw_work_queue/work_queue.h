@@ -15,8 +15,11 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 
+#include "pw_alignment/alignment.h"
+#include "pw_chrono/system_clock.h"
 #include "pw_containers/inline_queue.h"
 #include "pw_function/function.h"
 #include "pw_metric/metric.h"
@@ -31,18 +34,55 @@ namespace pw::work_queue {
 
 using WorkItem = Function<void()>;
 
+// A WorkItem waiting in the queue, along with the time it was enqueued.
+struct QueuedWorkItem {
+  WorkItem work_item;
+  chrono::SystemClock::time_point enqueue_time;
+};
+
+// Storage for one entry of a lock-free WorkQueue.
+class LockFreeSlot {
+ public:
+  LockFreeSlot() = default;
+  LockFreeSlot(const LockFreeSlot&) = delete;
+  LockFreeSlot& operator=(const LockFreeSlot&) = delete;
+
+ private:
+  friend class WorkQueue;
+
+  // Ring position that may next use this slot, minus the slot's index, so
+  // that zero-initialized slots are empty. A producer may fill the slot when
+  // the position equals its own, and the worker may take the entry when the
+  // position is one past its own.
+  std::atomic<uint32_t> sequence_{0};
+  QueuedWorkItem entry_;
+};
+
 // The WorkQueue class enables threads and interrupts to enqueue work as a
 // pw::work_queue::WorkItem for execution by the work queue.
 //
 // The entire API is thread and interrupt safe.
+//
+// The queue is either guarded by an InterruptSpinLock, or, if constructed from
+// LockFreeSlots, is a lock-free multi-producer, single-consumer ring. In both
+// modes the worker runs every pending item each time it wakes.
 class WorkQueue : public thread::ThreadCore {
  public:
+  // Creates a work queue that guards `queue` with a spin lock.
+  //
   // Note: the ThreadNotification prevents this from being constexpr.
-  WorkQueue(InlineQueue<WorkItem>& queue, size_t queue_capacity)
-      : stop_requested_(false), queue_(queue) {
+  WorkQueue(InlineQueue<QueuedWorkItem>& queue, size_t queue_capacity)
+      : stop_requested_(false), queue_(&queue) {
     min_queue_remaining_.Set(static_cast<uint32_t>(queue_capacity));
   }
 
+  // Creates a lock-free work queue that stores entries in `slots`. Producers
+  // claim slots with compare-and-swap and never wait on each other. The
+  // number of slots must be a power of two no larger than 2^30.
+  //
+  // Pushing from interrupts requires lock-free 32-bit atomics on the target.
+  explicit WorkQueue(span<LockFreeSlot> slots);
+
   // Enqueues a work_item for execution by the work queue thread.
   //
   // Returns:
@@ -51,7 +91,23 @@ class WorkQueue : public thread::ThreadCore {
   //     longer permitted.
   // ResourceExhausted - internal work queue is full, entry was not enqueued.
   Status PushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_) {
-    return InternalPushWork(std::move(work_item));
+    return InternalPushWork(span(&work_item, 1));
+  }
+
+  // Enqueues all of work_items, in order, for execution by the work queue
+  // thread. The queue is locked or claimed and the worker woken once for the
+  // whole batch, rather than once per item.
+  //
+  // Either every item is enqueued and moved from, or none is.
+  //
+  // Returns:
+  // Ok - Success, all entries were enqueued for execution.
+  // FailedPrecondition - the work queue is shutting down, entries are no
+  //     longer permitted.
+  // ResourceExhausted - there is not room for all of the entries in the
+  //     internal work queue; none were enqueued.
+  Status PushWorkBatch(span<WorkItem> work_items) PW_LOCKS_EXCLUDED(lock_) {
+    return InternalPushWork(work_items);
   }
 
   // Queue work for execution. Crash if the work cannot be queued due to a
@@ -74,15 +130,44 @@ class WorkQueue : public thread::ThreadCore {
   // the thread has been joined.
   void RequestStop() PW_LOCKS_EXCLUDED(lock_);
 
+  metric::Group& metrics() { return metrics_; }
+
  private:
+  // lock_free_state_ holds the stop flag and the number of pushes in progress.
+  static constexpr uint32_t kStopped = uint32_t{1} << 31;
+  static constexpr uint32_t kPushersMask = kStopped - 1;
+
+  bool lock_free() const { return queue_ == nullptr; }
+
   void Run() override PW_LOCKS_EXCLUDED(lock_);
-  Status InternalPushWork(WorkItem&& work_item) PW_LOCKS_EXCLUDED(lock_);
+  Status InternalPushWork(span<WorkItem> work_items) PW_LOCKS_EXCLUDED(lock_);
+
+  void RunLocked() PW_LOCKS_EXCLUDED(lock_);
+  Status PushLocked(span<WorkItem> work_items) PW_LOCKS_EXCLUDED(lock_);
+
+  void RunLockFree();
+  Status PushLockFree(span<WorkItem> work_items);
+  Status ClaimAndFill(span<WorkItem> work_items);
+  void DrainLockFree();
+
+  void UpdateQueueWatermarks(uint32_t queue_entries, uint32_t queue_capacity);
+  void RunWorkItem(QueuedWorkItem& entry);
 
-  sync::InterruptSpinLock lock_;
+  // When PW_ALIGNMENT_CACHE_LINE_PADDING is enabled, the lock, the producers'
+  // ring state and the worker's state are on separate cache lines, so pushes
+  // from other cores do not invalidate the line the worker is using.
+  PW_CACHELINE_ALIGNED_IF_PADDED sync::InterruptSpinLock lock_;
   bool stop_requested_ PW_GUARDED_BY(lock_);
-  InlineQueue<WorkItem>& queue_ PW_GUARDED_BY(lock_);
+  InlineQueue<QueuedWorkItem>* const queue_ PW_PT_GUARDED_BY(lock_);
   sync::ThreadNotification work_notification_;
 
+  // Lock-free ring state. enqueue_position_ is claimed by producers;
+  // dequeue_position_ is only used by the worker.
+  span<LockFreeSlot> slots_;
+  PW_CACHELINE_ALIGNED_IF_PADDED std::atomic<uint32_t> lock_free_state_{0};
+  std::atomic<uint32_t> enqueue_position_{0};
+  PW_CACHELINE_ALIGNED_IF_PADDED uint32_t dequeue_position_ = 0;
+
   // TODO(ewout): The group and/or its name token should be passed as a ctor
   // arg instead. Depending on the approach here the group should be exposed
   // While doing this evaluate whether perhaps we should instead construct
@@ -93,6 +178,10 @@ class WorkQueue : public thread::ThreadCore {
   PW_METRIC_GROUP(metrics_, "pw::work_queue::WorkQueue");
   PW_METRIC(metrics_, max_queue_used_, "max_queue_used", 0u);
   PW_METRIC(metrics_, min_queue_remaining_, "min_queue_remaining", 0u);
+  // Time from enqueueing a work item to starting it. The average is an
+  // exponential moving average over roughly the last 16 items.
+  PW_METRIC(metrics_, max_queue_latency_us_, "max_queue_latency_us", 0u);
+  PW_METRIC(metrics_, avg_queue_latency_us_, "avg_queue_latency_us", 0u);
 };
 
 template <size_t kWorkQueueEntries>
@@ -101,7 +190,22 @@ class WorkQueueWithBuffer : public WorkQueue {
   constexpr WorkQueueWithBuffer() : WorkQueue(queue_, kWorkQueueEntries) {}
 
  private:
-  InlineQueue<WorkItem, kWorkQueueEntries> queue_;
+  InlineQueue<QueuedWorkItem, kWorkQueueEntries> queue_;
+};
+
+// A lock-free WorkQueue with storage for kWorkQueueEntries items.
+template <size_t kWorkQueueEntries>
+class LockFreeWorkQueueWithBuffer : public WorkQueue {
+ public:
+  static_assert(kWorkQueueEntries > 0 &&
+                    (kWorkQueueEntries & (kWorkQueueEntries - 1)) == 0 &&
+                    kWorkQueueEntries <= (size_t{1} << 30),
+                "Lock-free work queues must have a power of two entries");
+
+  LockFreeWorkQueueWithBuffer() : WorkQueue(slots_) {}
+
+ private:
+  std::array<LockFreeSlot, kWorkQueueEntries> slots_;
 };
 
 }  // namespace pw::work_queue
@@ -14,19 +14,54 @@
 
 #include "pw_work_queue/work_queue.h"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <mutex>
 
 #include "pw_assert/check.h"
 
 namespace pw::work_queue {
 
+WorkQueue::WorkQueue(span<LockFreeSlot> slots)
+    : stop_requested_(false), queue_(nullptr), slots_(slots) {
+  PW_CHECK(!slots.empty() && (slots.size() & (slots.size() - 1)) == 0 &&
+               slots.size() <= (size_t{1} << 30),
+           "Lock-free work queues must have a power of two entries");
+  min_queue_remaining_.Set(static_cast<uint32_t>(slots.size()));
+}
+
 void WorkQueue::RequestStop() {
-  std::lock_guard lock(lock_);
-  stop_requested_ = true;
+  if (lock_free()) {
+    lock_free_state_.fetch_or(kStopped, std::memory_order_acq_rel);
+  } else {
+    std::lock_guard lock(lock_);
+    stop_requested_ = true;
+  }
   work_notification_.release();
 }
 
 void WorkQueue::Run() {
+  if (lock_free()) {
+    RunLockFree();
+  } else {
+    RunLocked();
+  }
+}
+
+void WorkQueue::CheckPushWork(WorkItem&& work_item) {
+  PW_CHECK_OK(PushWork(std::move(work_item)),
+              "Failed to push work item into the work queue");
+}
+
+Status WorkQueue::InternalPushWork(span<WorkItem> work_items) {
+  if (work_items.empty()) {
+    return OkStatus();
+  }
+  return lock_free() ? PushLockFree(work_items) : PushLocked(work_items);
+}
+
+void WorkQueue::RunLocked() {
   while (true) {
     work_notification_.acquire();
 
@@ -34,22 +69,20 @@ void WorkQueue::Run() {
     bool stop_requested;
     bool work_remaining;
     do {
-      std::optional<WorkItem> possible_work_item;
+      std::optional<QueuedWorkItem> possible_work_item;
       {
         std::lock_guard lock(lock_);
-        if (!queue_.empty()) {
-          possible_work_item.emplace(std::move(queue_.front()));
-          queue_.pop();
+        if (!queue_->empty()) {
+          possible_work_item.emplace(std::move(queue_->front()));
+          queue_->pop();
         }
-        work_remaining = !queue_.empty();
+        work_remaining = !queue_->empty();
         stop_requested = stop_requested_;
       }
       if (!possible_work_item.has_value()) {
         continue;  // No work item to process.
       }
-      WorkItem& work_item = possible_work_item.value();
-      PW_CHECK(work_item != nullptr);
-      work_item();
+      RunWorkItem(possible_work_item.value());
     } while (work_remaining);
 
     // Queue was drained, return if we've been requested to stop.
@@ -59,12 +92,8 @@ void WorkQueue::Run() {
   }
 }
 
-void WorkQueue::CheckPushWork(WorkItem&& work_item) {
-  PW_CHECK_OK(InternalPushWork(std::move(work_item)),
-              "Failed to push work item into the work queue");
-}
-
-Status WorkQueue::InternalPushWork(WorkItem&& work_item) {
+Status WorkQueue::PushLocked(span<WorkItem> work_items) {
+  const chrono::SystemClock::time_point now = chrono::SystemClock::now();
   std::lock_guard lock(lock_);
 
   if (stop_requested_) {
@@ -72,24 +101,149 @@ Status WorkQueue::InternalPushWork(WorkItem&& work_item) {
     return Status::FailedPrecondition();
   }
 
-  if (queue_.full()) {
+  if (static_cast<size_t>(queue_->capacity() - queue_->size()) <
+      work_items.size()) {
+    return Status::ResourceExhausted();
+  }
+
+  for (WorkItem& work_item : work_items) {
+    queue_->push(QueuedWorkItem{std::move(work_item), now});
+  }
+
+  UpdateQueueWatermarks(static_cast<uint32_t>(queue_->size()),
+                        static_cast<uint32_t>(queue_->capacity()));
+
+  work_notification_.release();
+  return OkStatus();
+}
+
+void WorkQueue::RunLockFree() {
+  while (true) {
+    work_notification_.acquire();
+    DrainLockFree();
+
+    // Every push in progress releases the notification when it finishes, so
+    // once stop is requested and no pushes remain, the final drain sees all
+    // work that will ever be enqueued.
+    const uint32_t state = lock_free_state_.load(std::memory_order_acquire);
+    if ((state & kStopped) != 0 && (state & kPushersMask) == 0) {
+      DrainLockFree();
+      return;
+    }
+  }
+}
+
+Status WorkQueue::PushLockFree(span<WorkItem> work_items) {
+  // Count this push as in progress before checking for stop, so the worker
+  // will not exit until it completes.
+  const uint32_t state =
+      lock_free_state_.fetch_add(1, std::memory_order_acq_rel);
+  Status status = (state & kStopped) != 0 ? Status::FailedPrecondition()
+                                          : ClaimAndFill(work_items);
+  lock_free_state_.fetch_sub(1, std::memory_order_acq_rel);
+  work_notification_.release();
+  return status;
+}
+
+Status WorkQueue::ClaimAndFill(span<WorkItem> work_items) {
+  const uint32_t count = static_cast<uint32_t>(work_items.size());
+  const uint32_t mask = static_cast<uint32_t>(slots_.size() - 1);
+  if (work_items.size() > slots_.size()) {
     return Status::ResourceExhausted();
   }
 
-  queue_.emplace(std::move(work_item));
+  // Claim count consecutive positions with one compare-and-swap. The worker
+  // frees slots in order, so if the last slot of the batch has been freed for
+  // this round, all of the others have been too.
+  uint32_t position = enqueue_position_.load(std::memory_order_relaxed);
+  while (true) {
+    const uint32_t last = position + count - 1;
+    const size_t index = last & mask;
+    const LockFreeSlot& slot = slots_[index];
+    const uint32_t sequence = slot.sequence_.load(std::memory_order_acquire) +
+                              static_cast<uint32_t>(index);
+    const auto difference = static_cast<int32_t>(sequence - last);
+    if (difference < 0) {
+      return Status::ResourceExhausted();
+    }
+    if (difference > 0) {
+      // Another producer claimed these positions; try again further on.
+      position = enqueue_position_.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (enqueue_position_.compare_exchange_weak(position,
+                                                position + count,
+                                                std::memory_order_relaxed,
+                                                std::memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  const chrono::SystemClock::time_point now = chrono::SystemClock::now();
+  for (uint32_t i = 0; i < count; ++i) {
+    const size_t index = (position + i) & mask;
+    LockFreeSlot& slot = slots_[index];
+    slot.entry_.work_item = std::move(work_items[i]);
+    slot.entry_.enqueue_time = now;
+    slot.sequence_.store(position + i + 1 - static_cast<uint32_t>(index),
+                         std::memory_order_release);
+  }
+  return OkStatus();
+}
+
+void WorkQueue::DrainLockFree() {
+  const uint32_t mask = static_cast<uint32_t>(slots_.size() - 1);
+  const uint32_t queue_entries =
+      enqueue_position_.load(std::memory_order_relaxed) - dequeue_position_;
+  UpdateQueueWatermarks(
+      std::min(queue_entries, static_cast<uint32_t>(slots_.size())),
+      static_cast<uint32_t>(slots_.size()));
+
+  while (true) {
+    const size_t index = dequeue_position_ & mask;
+    LockFreeSlot& slot = slots_[index];
+    const uint32_t sequence = slot.sequence_.load(std::memory_order_acquire) +
+                              static_cast<uint32_t>(index);
+    if (sequence != dequeue_position_ + 1) {
+      return;  // Empty, or the next item is still being written.
+    }
 
-  // Update the watermarks for the queue.
-  const uint32_t queue_entries = queue_.size();
+    QueuedWorkItem entry = std::move(slot.entry_);
+    slot.entry_.work_item = nullptr;
+    slot.sequence_.store(dequeue_position_ + static_cast<uint32_t>(mask) + 1 -
+                             static_cast<uint32_t>(index),
+                         std::memory_order_release);
+    dequeue_position_ += 1;
+
+    RunWorkItem(entry);
+  }
+}
+
+void WorkQueue::UpdateQueueWatermarks(uint32_t queue_entries,
+                                      uint32_t queue_capacity) {
   if (queue_entries > max_queue_used_.value()) {
     max_queue_used_.Set(queue_entries);
   }
-  const uint32_t queue_remaining = queue_.capacity() - queue_entries;
+  const uint32_t queue_remaining = queue_capacity - queue_entries;
   if (queue_remaining < min_queue_remaining_.value()) {
-    min_queue_remaining_.Set(queue_entries);
+    min_queue_remaining_.Set(queue_remaining);
   }
+}
 
-  work_notification_.release();
-  return OkStatus();
+void WorkQueue::RunWorkItem(QueuedWorkItem& entry) {
+  const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+      chrono::SystemClock::now() - entry.enqueue_time);
+  const uint32_t latency_us = static_cast<uint32_t>(std::clamp<int64_t>(
+      latency.count(), 0, std::numeric_limits<uint32_t>::max()));
+  if (latency_us > max_queue_latency_us_.value()) {
+    max_queue_latency_us_.Set(latency_us);
+  }
+  const int64_t average = avg_queue_latency_us_.value();
+  avg_queue_latency_us_.Set(
+      static_cast<uint32_t>(average + (latency_us - average) / 16));
+
+  PW_CHECK(entry.work_item != nullptr);
+  entry.work_item();
 }
 
 }  // namespace pw::work_queue
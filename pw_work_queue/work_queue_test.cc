@@ -15,10 +15,14 @@
 #include "pw_work_queue/work_queue.h"
 
 #include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
 #include "pw_function/function.h"
+#include "pw_span/span.h"
 #include "pw_log/log.h"
 #include "pw_sync/thread_notification.h"
 #include "pw_thread/thread.h"
+#include "pw_work_queue/deadline_work_queue.h"
+#include "pw_work_queue/priority_work_queue.h"
 #include "pw_work_queue/test_thread.h"
 
 namespace pw::work_queue {
@@ -117,6 +121,169 @@ TEST(WorkQueue, PingPongTwoRequestTypesWithExtraRequests) {
   EXPECT_EQ(context_b.counter, kPingPongs);
 }
 
+TEST(WorkQueue, LockFreePingPong) {
+  struct {
+    int counter = 0;
+    sync::ThreadNotification worker_ping;
+  } context;
+
+  LockFreeWorkQueueWithBuffer<8> work_queue;
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+
+  // Pick a number bigger than the ring to ensure positions wrap around.
+  const int kPingPongs = 300;
+
+  for (int i = 0; i < kPingPongs; ++i) {
+    EXPECT_EQ(OkStatus(), work_queue.PushWork([&context] {
+      context.counter++;
+      context.worker_ping.release();
+    }));
+    EXPECT_EQ(OkStatus(), work_queue.PushWork([] {
+      PW_LOG_INFO("I'm a random task in the work queue; nothing to see here!");
+    }));
+    context.worker_ping.acquire();
+  }
+
+  work_queue.RequestStop();
+  work_thread.join();
+
+  EXPECT_EQ(context.counter, kPingPongs);
+}
+
+// Pushes batches to a work queue whose worker has not started, then checks
+// that the worker runs everything in order once it is started and stopped.
+void TestPushWorkBatch(WorkQueue& work_queue) {
+  int order[5] = {};
+  int next = 0;
+  auto record = [&order, &next](int value) { order[next++] = value; };
+
+  WorkItem first[] = {[&record] { record(1); }, [&record] { record(2); }};
+  ASSERT_EQ(OkStatus(), work_queue.PushWorkBatch(first));
+  EXPECT_EQ(first[0], nullptr);
+
+  // Only two of the four entries remain, so a batch of three is rejected
+  // without being moved from.
+  WorkItem too_many[] = {
+      [&record] { record(-1); }, [&record] { record(-2); }, [&record] {
+        record(-3);
+      }};
+  EXPECT_EQ(Status::ResourceExhausted(), work_queue.PushWorkBatch(too_many));
+  EXPECT_NE(too_many[0], nullptr);
+  EXPECT_NE(too_many[2], nullptr);
+
+  WorkItem second[] = {[&record] { record(3); }, [&record] { record(4); }};
+  ASSERT_EQ(OkStatus(), work_queue.PushWorkBatch(second));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            work_queue.PushWork([&record] { record(-4); }));
+
+  work_queue.RequestStop();
+  EXPECT_EQ(Status::FailedPrecondition(),
+            work_queue.PushWorkBatch(span(too_many, 1)));
+
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+  work_thread.join();
+
+  EXPECT_EQ(next, 4);
+  EXPECT_EQ(order[0], 1);
+  EXPECT_EQ(order[1], 2);
+  EXPECT_EQ(order[2], 3);
+  EXPECT_EQ(order[3], 4);
+}
+
+TEST(WorkQueue, PushWorkBatch) {
+  WorkQueueWithBuffer<4> work_queue;
+  TestPushWorkBatch(work_queue);
+}
+
+TEST(WorkQueue, LockFreePushWorkBatch) {
+  LockFreeWorkQueueWithBuffer<4> work_queue;
+  TestPushWorkBatch(work_queue);
+}
+
+TEST(WorkQueue, LockFreePushWhileDraining) {
+  struct {
+    int counter = 0;
+    sync::ThreadNotification done;
+  } context;
+
+  LockFreeWorkQueueWithBuffer<4> work_queue;
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+
+  // Push many more items than the ring holds, retrying while it is full, so
+  // that pushes race with the worker draining.
+  const int kItems = 1000;
+  for (int i = 0; i < kItems; ++i) {
+    while (work_queue.PushWork([&context] { context.counter++; }) !=
+           OkStatus()) {
+    }
+  }
+  while (work_queue.PushWork([&context] { context.done.release(); }) !=
+         OkStatus()) {
+  }
+  context.done.acquire();
+
+  work_queue.RequestStop();
+  work_thread.join();
+  EXPECT_EQ(context.counter, kItems);
+}
+
+TEST(PriorityWorkQueue, RunsHighestPriorityFirst) {
+  PriorityWorkQueueWithBuffer<3, 2> work_queue;
+  int order[4] = {};
+  int next = 0;
+  auto record = [&order, &next](int value) { order[next++] = value; };
+
+  EXPECT_EQ(OkStatus(), work_queue.PushWork([&record] { record(3); }, 2));
+  EXPECT_EQ(OkStatus(), work_queue.PushWork([&record] { record(2); }, 1));
+  EXPECT_EQ(OkStatus(), work_queue.PushWork([&record] { record(0); }, 0));
+  EXPECT_EQ(OkStatus(), work_queue.PushWork([&record] { record(1); }, 0));
+  EXPECT_EQ(Status::ResourceExhausted(), work_queue.PushWork([] {}, 0));
+  EXPECT_EQ(Status::InvalidArgument(), work_queue.PushWork([] {}, 3));
+
+  // The worker drains everything, then stops.
+  work_queue.RequestStop();
+  EXPECT_EQ(Status::FailedPrecondition(), work_queue.PushWork([] {}, 2));
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+  work_thread.join();
+
+  ASSERT_EQ(next, 4);
+  EXPECT_EQ(order[0], 0);
+  EXPECT_EQ(order[1], 1);
+  EXPECT_EQ(order[2], 2);
+  EXPECT_EQ(order[3], 3);
+}
+
+TEST(DeadlineWorkQueue, RunsEarliestDeadlineFirst) {
+  DeadlineWorkQueueWithBuffer<4> work_queue;
+  int order[4] = {};
+  int next = 0;
+  auto record = [&order, &next](int value) { order[next++] = value; };
+
+  const auto now = chrono::SystemClock::now();
+  const auto hour = std::chrono::hours(1);
+  EXPECT_EQ(OkStatus(),
+            work_queue.PushWork([&record] { record(3); }, now + 3 * hour));
+  EXPECT_EQ(OkStatus(),
+            work_queue.PushWork([&record] { record(1); }, now + hour));
+  EXPECT_EQ(OkStatus(),
+            work_queue.PushWork([&record] { record(0); }, now - hour));
+  // Equal deadlines run in push order.
+  EXPECT_EQ(OkStatus(),
+            work_queue.PushWork([&record] { record(2); }, now + hour));
+  EXPECT_EQ(Status::ResourceExhausted(), work_queue.PushWork([] {}, now));
+
+  work_queue.RequestStop();
+  EXPECT_EQ(Status::FailedPrecondition(), work_queue.PushWork([] {}, now));
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+  work_thread.join();
+
+  ASSERT_EQ(next, 4);
+  EXPECT_EQ(order[0], 0);
+  EXPECT_EQ(order[1], 1);
+  EXPECT_EQ(order[2], 2);
+  EXPECT_EQ(order[3], 3);
+}
+
 // TODO(ewout): Add unit tests for the metrics once they have been restructured.
 
 }  // namespace